@@ -15,23 +15,47 @@
 
 #pragma once
 
+#include "mlio/allocation_audit.h"                     // IWYU pragma: export
+#include "mlio/audio_reader.h"                         // IWYU pragma: export
+#include "mlio/avro_reader.h"                          // IWYU pragma: export
+#include "mlio/azure_blob_client.h"                    // IWYU pragma: export
+#include "mlio/caching_data_reader.h"                  // IWYU pragma: export
+#include "mlio/column_statistics.h"                    // IWYU pragma: export
+#include "mlio/composite_data_reader.h"                // IWYU pragma: export
+#include "mlio/columnar_reader.h"                      // IWYU pragma: export
+#include "mlio/columnar_writer.h"                      // IWYU pragma: export
 #include "mlio/config.h"                               // IWYU pragma: export
 #include "mlio/cpu_array.h"                            // IWYU pragma: export
 #include "mlio/csv_reader.h"                           // IWYU pragma: export
 #include "mlio/data_reader.h"                          // IWYU pragma: export
 #include "mlio/data_reader_base.h"                     // IWYU pragma: export
 #include "mlio/data_reader_error.h"                    // IWYU pragma: export
+#include "mlio/data_service.h"                         // IWYU pragma: export
+#include "mlio/data_stores/azure_blob.h"               // IWYU pragma: export
 #include "mlio/data_stores/compression.h"              // IWYU pragma: export
 #include "mlio/data_stores/data_store.h"               // IWYU pragma: export
 #include "mlio/data_stores/file.h"                     // IWYU pragma: export
+#include "mlio/data_stores/gcs_object.h"               // IWYU pragma: export
+#include "mlio/data_stores/http_object.h"              // IWYU pragma: export
 #include "mlio/data_stores/in_memory_store.h"          // IWYU pragma: export
+#include "mlio/data_stores/kafka_partition.h"          // IWYU pragma: export
+#include "mlio/data_stores/object_list_options.h"      // IWYU pragma: export
 #include "mlio/data_stores/s3_object.h"                // IWYU pragma: export
 #include "mlio/data_stores/sagemaker_pipe.h"           // IWYU pragma: export
+#include "mlio/data_stores/shared_store.h"             // IWYU pragma: export
+#include "mlio/data_stores/verified_store.h"           // IWYU pragma: export
+#include "mlio/data_stores/zip_member.h"               // IWYU pragma: export
 #include "mlio/data_type.h"                            // IWYU pragma: export
+#include "mlio/data_writer.h"                          // IWYU pragma: export
 #include "mlio/device.h"                               // IWYU pragma: export
 #include "mlio/device_array.h"                         // IWYU pragma: export
 #include "mlio/endian.h"                               // IWYU pragma: export
 #include "mlio/example.h"                              // IWYU pragma: export
+#include "mlio/example_batching.h"                     // IWYU pragma: export
+#include "mlio/example_conversion.h"                   // IWYU pragma: export
+#include "mlio/example_transform.h"                    // IWYU pragma: export
+#include "mlio/gcs_client.h"                           // IWYU pragma: export
+#include "mlio/http_client.h"                          // IWYU pragma: export
 #include "mlio/image_reader.h"                         // IWYU pragma: export
 #include "mlio/init.h"                                 // IWYU pragma: export
 #include "mlio/instance.h"                             // IWYU pragma: export
@@ -39,6 +63,9 @@
 #include "mlio/integ/dlpack.h"                         // IWYU pragma: export
 #include "mlio/intrusive_ptr.h"                        // IWYU pragma: export
 #include "mlio/intrusive_ref_counter.h"                // IWYU pragma: export
+#include "mlio/json_lines_reader.h"                    // IWYU pragma: export
+#include "mlio/kafka_client.h"                         // IWYU pragma: export
+#include "mlio/libsvm_reader.h"                        // IWYU pragma: export
 #include "mlio/logging.h"                              // IWYU pragma: export
 #include "mlio/memory/external_memory_block.h"         // IWYU pragma: export
 #include "mlio/memory/file_backed_memory_allocator.h"  // IWYU pragma: export
@@ -49,34 +76,63 @@
 #include "mlio/memory/memory_allocator.h"              // IWYU pragma: export
 #include "mlio/memory/memory_block.h"                  // IWYU pragma: export
 #include "mlio/memory/memory_slice.h"                  // IWYU pragma: export
+#include "mlio/memory/page_memory_block.h"             // IWYU pragma: export
+#include "mlio/memory/slab_memory_allocator.h"         // IWYU pragma: export
 #include "mlio/memory/util.h"                          // IWYU pragma: export
 #include "mlio/not_supported_error.h"                  // IWYU pragma: export
+#include "mlio/object_store_client.h"                  // IWYU pragma: export
+#include "mlio/orc_reader.h"                           // IWYU pragma: export
 #include "mlio/parallel_data_reader.h"                 // IWYU pragma: export
+#include "mlio/parquet_reader.h"                       // IWYU pragma: export
 #include "mlio/parser.h"                               // IWYU pragma: export
+#include "mlio/reader_stats.h"                         // IWYU pragma: export
 #include "mlio/record_readers/record.h"                // IWYU pragma: export
 #include "mlio/record_readers/record_error.h"          // IWYU pragma: export
 #include "mlio/record_readers/record_reader.h"         // IWYU pragma: export
 #include "mlio/record_readers/record_reader_base.h"    // IWYU pragma: export
 #include "mlio/record_readers/stream_record_reader.h"  // IWYU pragma: export
 #include "mlio/record_readers/text_record_reader.h"    // IWYU pragma: export
+#include "mlio/recordio_index.h"                       // IWYU pragma: export
 #include "mlio/recordio_protobuf_reader.h"             // IWYU pragma: export
+#include "mlio/recordio_protobuf_writer.h"             // IWYU pragma: export
 #include "mlio/s3_client.h"                            // IWYU pragma: export
+#include "mlio/s3_object_cache.h"                      // IWYU pragma: export
 #include "mlio/schema.h"                               // IWYU pragma: export
+#include "mlio/shared_memory_reader.h"                 // IWYU pragma: export
 #include "mlio/span.h"                                 // IWYU pragma: export
+#include "mlio/streams/async_chunk_reader.h"           // IWYU pragma: export
+#include "mlio/streams/bzip2_inflate_stream.h"         // IWYU pragma: export
 #include "mlio/streams/file_input_stream.h"            // IWYU pragma: export
 #include "mlio/streams/gzip_inflate_stream.h"          // IWYU pragma: export
 #include "mlio/streams/input_stream.h"                 // IWYU pragma: export
 #include "mlio/streams/input_stream_base.h"            // IWYU pragma: export
+#include "mlio/streams/lz4_inflate_stream.h"           // IWYU pragma: export
 #include "mlio/streams/memory_input_stream.h"          // IWYU pragma: export
+#include "mlio/streams/object_input_stream.h"          // IWYU pragma: export
+#include "mlio/streams/parallel_bzip2_inflate_stream.h"  // IWYU pragma: export
+#include "mlio/streams/parallel_gzip_inflate_stream.h"  // IWYU pragma: export
+#include "mlio/streams/prefetching_input_stream.h"     // IWYU pragma: export
 #include "mlio/streams/s3_input_stream.h"              // IWYU pragma: export
 #include "mlio/streams/sagemaker_pipe_input_stream.h"  // IWYU pragma: export
 #include "mlio/streams/stream_error.h"                 // IWYU pragma: export
 #include "mlio/streams/utf8_input_stream.h"            // IWYU pragma: export
+#include "mlio/streams/zip_inflate_stream.h"           // IWYU pragma: export
+#include "mlio/streams/zstd_inflate_stream.h"          // IWYU pragma: export
+#include "mlio/sync_decoder.h"                         // IWYU pragma: export
+#include "mlio/tar_shard.h"                            // IWYU pragma: export
 #include "mlio/tensor.h"                               // IWYU pragma: export
+#include "mlio/tensor_pool.h"                          // IWYU pragma: export
 #include "mlio/tensor_visitor.h"                       // IWYU pragma: export
 #include "mlio/text_encoding.h"                        // IWYU pragma: export
 #include "mlio/text_line_reader.h"                     // IWYU pragma: export
+#include "mlio/tf_example_reader.h"                    // IWYU pragma: export
+#include "mlio/thread_pool.h"                          // IWYU pragma: export
+#include "mlio/tracing.h"                              // IWYU pragma: export
 #include "mlio/type_traits.h"                          // IWYU pragma: export
 #include "mlio/util/cast.h"                            // IWYU pragma: export
+#include "mlio/util/datetime.h"                        // IWYU pragma: export
+#include "mlio/util/frequent_values_sketch.h"          // IWYU pragma: export
 #include "mlio/util/number.h"                          // IWYU pragma: export
+#include "mlio/util/quantile_sketch.h"                 // IWYU pragma: export
 #include "mlio/util/string.h"                          // IWYU pragma: export
+#include "mlio/video_reader.h"                         // IWYU pragma: export
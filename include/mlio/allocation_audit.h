@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup tracing Tracing
+/// @{
+
+/// Holds the number of allocations made in a stage of the pipeline,
+/// and their total size in bytes.
+struct MLIO_API Allocation_stats {
+    /// The memory blocks allocated through @ref memory_allocator().
+    std::uint64_t num_memory_blocks{};
+    std::uint64_t memory_block_bytes{};
+    /// The arrays allocated by @ref make_cpu_array() and @ref
+    /// make_cpu_arrays().
+    std::uint64_t num_cpu_arrays{};
+    std::uint64_t cpu_array_bytes{};
+    /// The calls to the global operator new; only counted if the library
+    /// is built with the MLIO_AUDIT_ALLOCATIONS option.
+    std::uint64_t num_heap_allocations{};
+    std::uint64_t heap_bytes{};
+};
+
+/// Holds the allocations counted since the call to @ref
+/// start_allocation_audit(), attributed to the pipeline stage that the
+/// allocating thread was running. A nested stage, e.g. the tokenization
+/// of a CSV row within the decoding of a batch, takes precedence.
+struct MLIO_API Allocation_audit {
+    /// Reading chunks from the data stores and inflating them.
+    Allocation_stats io{};
+    /// Framing the records and batching the data instances.
+    Allocation_stats framing{};
+    /// Buffering the data instances in the shuffle window.
+    Allocation_stats shuffle{};
+    /// Decoding the instance batches into examples.
+    Allocation_stats decode{};
+    /// Splitting the CSV rows into their fields.
+    Allocation_stats tokenize{};
+    /// Parsing RecordIO-protobuf records.
+    Allocation_stats protobuf{};
+    /// Running the example transforms.
+    Allocation_stats transform{};
+    /// The allocations made outside of the pipeline stages, e.g. by the
+    /// consumer of the examples.
+    Allocation_stats other{};
+
+    /// Indicates whether the library counts the calls to the global
+    /// operator new.
+    bool counts_heap_allocations{};
+};
+
+/// Starts counting the allocations made by the pipeline stages. Any
+/// previously counted allocation is discarded.
+///
+/// While the audit is stopped, which is the default, the overhead of
+/// an allocation is a single relaxed atomic load. Unlike tracing, the
+/// audit uses shared counters and is meant to be used in benchmarks
+/// and tests rather than in production.
+MLIO_API
+void start_allocation_audit() noexcept;
+
+/// Stops counting the allocations. The counted allocations are kept
+/// until the next call to @ref start_allocation_audit().
+MLIO_API
+void stop_allocation_audit() noexcept;
+
+/// Gets the allocations counted so far.
+MLIO_API
+Allocation_audit allocation_audit() noexcept;
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/parallel_data_reader.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Mel_spectrogram;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Specifies what the @ref Audio_reader outputs for a clip.
+enum class Audio_output {
+    /// The resampled waveform of shape (batch, samples).
+    waveform,
+    /// The log-mel spectrogram of shape (batch, mels, frames).
+    log_mel_spectrogram
+};
+
+/// Represents the optional parameters of an @ref Audio_reader object.
+struct MLIO_API Audio_reader_params {
+    /// The sample rate, in Hz, to which the clips are resampled.
+    std::size_t sample_rate = 16000;
+    /// The number of samples, at the target sample rate, read from the
+    /// beginning of each clip. Shorter clips are padded with zeros.
+    std::size_t num_samples = 160000;
+    /// See @ref Audio_output.
+    Audio_output output = Audio_output::waveform;
+    /// The size of the FFT; must be a power of two.
+    std::size_t fft_size = 512;
+    /// The size of the Hann window applied to each frame; must not be
+    /// greater than the FFT size.
+    std::size_t window_size = 400;
+    /// The number of samples between the centers of two consecutive
+    /// frames.
+    std::size_t hop_size = 160;
+    /// The number of mel bands.
+    std::size_t num_mels = 80;
+    /// The lowest frequency, in Hz, of the mel filter bank.
+    float min_frequency = 0.0F;
+    /// The highest frequency, in Hz, of the mel filter bank. Defaults to
+    /// the Nyquist frequency.
+    std::optional<float> max_frequency{};
+    /// The value added to the mel energies before taking their natural
+    /// logarithm.
+    float log_offset = 1e-6F;
+};
+
+/// Represents a @ref Data_reader for reading audio clips, one clip per
+/// data store.
+///
+/// The clips are demuxed and decoded with FFmpeg, so any container and
+/// codec supported by the FFmpeg build, such as WAV, FLAC, MP3, or
+/// Opus, can be read. The decoded samples are downmixed to mono and
+/// resampled by libswresample as they are decoded, and decoding stops
+/// once @ref Audio_reader_params::num_samples samples have been read.
+///
+/// The examples have a single "value" feature of type float32 whose
+/// shape depends on @ref Audio_reader_params::output.
+class MLIO_API Audio_reader final : public Parallel_data_reader {
+public:
+    explicit Audio_reader(Data_reader_params params, Audio_reader_params audio_params);
+
+    Audio_reader(const Audio_reader &) = delete;
+
+    Audio_reader &operator=(const Audio_reader &) = delete;
+
+    Audio_reader(Audio_reader &&) = delete;
+
+    Audio_reader &operator=(Audio_reader &&) = delete;
+
+    ~Audio_reader() final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    bool decode_clip(stdx::span<float> out,
+                     std::vector<float> &samples,
+                     const Instance &instance) const;
+
+    MLIO_HIDDEN
+    bool report_bad_clip(const Instance &instance, const std::string &error) const;
+
+    MLIO_HIDDEN
+    bool should_skip_example(const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    void warn_if_padded(const Instance_batch &batch, std::size_t num_instances_read) const;
+
+    Audio_reader_params params_;
+    bool error_bad_example_;
+    std::unique_ptr<detail::Mel_spectrogram> spectrogram_;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Avro_file_info;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+struct MLIO_API Avro_reader_params final {
+    /// The fields to read. If empty, all top-level fields of a supported
+    /// type are read. The values of the other fields are skipped without
+    /// being decoded.
+    std::unordered_set<std::string> use_columns{};
+};
+
+/// Represents a @ref Data_reader for reading Avro object container
+/// files.
+///
+/// Each data block of a file is treated as a data @ref Instance; this
+/// means the batch size specifies the number of blocks per @ref Example
+/// and the batch dimension of the tensors is the total number of
+/// objects in those blocks. As the blocks are delimited by sync markers
+/// and compressed independently, the blocks of a batch are decompressed
+/// and decoded in parallel.
+///
+/// The top-level fields of the record schema are read as columns.
+/// Fields of the boolean, int, long, float, double, string, bytes,
+/// fixed, and enum types, and unions of those with null, are supported;
+/// enum values are read as their symbols. Null values are read as zero,
+/// NaN for floating-point fields, or an empty string. The null,
+/// deflate, and zstandard codecs are supported.
+class MLIO_API Avro_reader final : public Parallel_data_reader {
+public:
+    explicit Avro_reader(Data_reader_params params, Avro_reader_params avro_params = {});
+
+    Avro_reader(const Avro_reader &) = delete;
+
+    Avro_reader &operator=(const Avro_reader &) = delete;
+
+    Avro_reader(Avro_reader &&) = delete;
+
+    Avro_reader &operator=(Avro_reader &&) = delete;
+
+    ~Avro_reader() final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Avro_file_info>
+    read_file_info(const Data_store &store, Input_stream &stream);
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Avro_file_info> get_file_info(const Data_store &store) const;
+
+    Avro_reader_params params_;
+    // The headers of the Avro files read so far. Populated by the record
+    // readers and used by the decode tasks.
+    mutable std::mutex file_info_mutex_{};
+    std::unordered_map<const Data_store *, std::shared_ptr<const detail::Avro_file_info>>
+        file_infos_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
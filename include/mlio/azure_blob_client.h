@@ -0,0 +1,112 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/object_store_client.h"
+#include "mlio/s3_object_cache.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Azure_native_client;
+
+}  // namespace detail
+
+/// Represents a client to access the blobs of an Azure storage account.
+///
+/// The blobs are addressed by URIs of the form "az://container/name".
+class MLIO_API Azure_blob_client final : public Object_store_client {
+public:
+    /// @param object_cache
+    ///     The local cache through which the blobs opened with this
+    ///     client are read. If null, the blobs are always read from
+    ///     Azure Blob Storage.
+    explicit Azure_blob_client(std::unique_ptr<detail::Azure_native_client> native_client,
+                               const Range_read_params &range_read_params = {},
+                               Intrusive_ptr<S3_object_cache> object_cache = {}) noexcept;
+
+    Azure_blob_client(const Azure_blob_client &) = delete;
+
+    Azure_blob_client &operator=(const Azure_blob_client &) = delete;
+
+    Azure_blob_client(Azure_blob_client &&) = delete;
+
+    Azure_blob_client &operator=(Azure_blob_client &&) = delete;
+
+    ~Azure_blob_client() final;
+
+    void list_objects(std::string_view bucket,
+                      std::string_view prefix,
+                      const List_callback &callback) const final;
+
+    std::size_t read_object(std::string_view bucket,
+                            std::string_view key,
+                            std::string_view version_id,
+                            std::size_t offset,
+                            Mutable_memory_span destination) const final;
+
+    Object_metadata read_object_metadata(std::string_view bucket,
+                                         std::string_view key,
+                                         std::string_view version_id) const final;
+
+    std::string_view uri_scheme() const noexcept final
+    {
+        return "az";
+    }
+
+private:
+    std::unique_ptr<detail::Azure_native_client> native_client_;
+};
+
+/// Holds the options for accessing an Azure storage account. Either a
+/// connection string or the name of the account has to be specified.
+struct MLIO_API Azure_blob_client_options {
+    /// The connection string of the storage account.
+    std::string_view connection_string{};
+    /// The URL of the Blob service of the storage account. If not
+    /// specified, "https://<account_name>.blob.core.windows.net" is used.
+    std::string_view account_url{};
+    /// The name and the access key of the storage account. If not
+    /// specified, the requests are authorized with @ref sas_token, or
+    /// sent anonymously.
+    std::string_view account_name{};
+    std::string_view account_key{};
+    /// A shared access signature that authorizes the requests.
+    std::string_view sas_token{};
+    Range_read_params range_read_params{};
+    Intrusive_ptr<S3_object_cache> object_cache{};
+    /// The timeout for establishing a connection. If zero, the default
+    /// of the Azure SDK is used.
+    std::chrono::milliseconds connect_timeout{};
+    /// The maximum number of attempts per request including the first
+    /// one. If zero, the default of the Azure SDK is used.
+    std::size_t max_attempts{};
+};
+
+MLIO_API
+Intrusive_ptr<Azure_blob_client> make_azure_blob_client(const Azure_blob_client_options &opts);
+
+}  // namespace abi_v1
+}  // namespace mlio
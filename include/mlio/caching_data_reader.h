@@ -0,0 +1,165 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/schema.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+struct MLIO_API Caching_params final {
+    /// The path of the cache file. If empty, the decoded examples are
+    /// cached in memory. The file should reside on local storage; it is
+    /// memory-mapped in the epochs that read from the cache.
+    std::string path{};
+    /// An optional string identifying the contents of the dataset, such
+    /// as the ETags or the modification times of its files. An existing
+    /// cache file is only used if it was written for the same schema,
+    /// the same data stores, and the same fingerprint.
+    std::string fingerprint{};
+    /// The number of instances per @ref Example read from the cache. If
+    /// zero, the batch size of the inner reader is used.
+    std::size_t batch_size{};
+    /// See @ref Last_example_handling. Applies to the epochs that read
+    /// from the cache.
+    Last_example_handling last_example_handling = Last_example_handling::none;
+    /// A boolean value indicating whether to shuffle the instances read
+    /// from the cache. The whole cache is shuffled at once.
+    bool shuffle_instances = false;
+    /// The seed that will be used for shuffling the instances. If not
+    /// specified, a random seed will be generated internally.
+    std::optional<std::uint_fast64_t> shuffle_seed{};
+    /// A boolean value indicating whether the instances should be
+    /// reshuffled in every epoch.
+    bool reshuffle_each_epoch = true;
+};
+
+/// Represents a @ref Data_reader that caches the examples decoded by
+/// another reader.
+///
+/// In the first epoch the examples of the inner reader are returned as
+/// is and their instances are written to the cache. Once the inner
+/// reader reaches the end of the dataset, the following epochs read the
+/// instances from the cache, optionally shuffled, instead of fetching
+/// and decoding the dataset again. If the reader is reset before the end
+/// of the first epoch, the partial cache is discarded.
+///
+/// @remark
+///     Only dense features of numeric data types can be cached.
+class MLIO_API Caching_data_reader final : public Data_reader {
+public:
+    explicit Caching_data_reader(Intrusive_ptr<Data_reader> inner, Caching_params params = {});
+
+    Caching_data_reader(const Caching_data_reader &) = delete;
+
+    Caching_data_reader &operator=(const Caching_data_reader &) = delete;
+
+    Caching_data_reader(Caching_data_reader &&) = delete;
+
+    Caching_data_reader &operator=(Caching_data_reader &&) = delete;
+
+    ~Caching_data_reader() final;
+
+    Intrusive_ptr<const Schema> read_schema() final;
+
+    Intrusive_ptr<Example> read_example() final;
+
+    Intrusive_ptr<Example> peek_example() final;
+
+    void reset() noexcept final;
+
+    std::size_t num_bytes_read() const noexcept final;
+
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+    /// Returns a boolean value indicating whether the examples are read
+    /// from the cache.
+    bool cached() const noexcept
+    {
+        return cache_ != nullptr;
+    }
+
+    /// Returns the number of instances in the cache.
+    std::size_t num_cached_instances() const noexcept
+    {
+        return num_instances_;
+    }
+
+private:
+    class Cache_writer;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_example_core();
+
+    MLIO_HIDDEN
+    void init_layout();
+
+    MLIO_HIDDEN
+    std::uint64_t compute_fingerprint() const;
+
+    MLIO_HIDDEN
+    bool try_open_cache_file();
+
+    MLIO_HIDDEN
+    void write_to_cache(const Example &example);
+
+    MLIO_HIDDEN
+    void finish_cache();
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_from_cache();
+
+    MLIO_HIDDEN
+    void shuffle_order();
+
+    Intrusive_ptr<Data_reader> inner_;
+    Caching_params params_;
+    Intrusive_ptr<const Schema> inner_schema_{};
+    Intrusive_ptr<const Schema> schema_{};
+    // The byte offset of each attribute within a cached instance.
+    std::vector<std::size_t> offsets_{};
+    std::size_t instance_size_{};
+    std::uint64_t fingerprint_{};
+    std::unique_ptr<Cache_writer> writer_{};
+    Intrusive_ptr<const Memory_block> cache_{};
+    std::size_t num_instances_{};
+    std::vector<std::size_t> order_{};
+    std::size_t pos_{};
+    std::size_t num_bytes_read_{};
+    std::uint_fast64_t seed_{};
+    std::mt19937_64 mt_{};
+    Intrusive_ptr<Example> peeked_example_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+#include "mlio/span.h"
+#include "mlio/tensor.h"
+#include "mlio/util/frequent_values_sketch.h"
+#include "mlio/util/quantile_sketch.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Contains the statistics of a column of a dataset.
+struct MLIO_API Column_statistics {
+    /// The name of the column.
+    std::string name{};
+    Data_type data_type{};
+    /// The number of values seen, excluding padding.
+    std::size_t num_values{};
+    /// The number of null values; NaN values, and for string columns
+    /// also empty, whitespace-only, and null-like values.
+    std::size_t num_nulls{};
+    /// The number of values that are numbers; for string columns the
+    /// number of values that can be parsed as floating-point numbers.
+    std::size_t num_numeric{};
+    /// The number of finite numbers. The numeric statistics below are
+    /// computed over these values.
+    std::size_t num_finite{};
+    double min = std::numeric_limits<double>::quiet_NaN();
+    double max = std::numeric_limits<double>::quiet_NaN();
+    double mean = std::numeric_limits<double>::quiet_NaN();
+    /// The population variance.
+    double variance = std::numeric_limits<double>::quiet_NaN();
+    /// The distribution of the finite numbers; see
+    /// @ref Quantile_sketch::quantile().
+    Quantile_sketch quantile_sketch{};
+    /// The minimum, maximum, and mean lengths, in bytes, of the values
+    /// of a string column.
+    std::size_t min_length{};
+    std::size_t max_length{};
+    double mean_length{};
+    /// The number of whitespace-separated words in the non-null values
+    /// of a string column.
+    std::size_t num_words{};
+    /// The estimated number of distinct values.
+    std::size_t approx_distinct_count{};
+    /// The estimated number of distinct words in the values of a string
+    /// column.
+    std::size_t approx_distinct_word_count{};
+    /// The most frequent values of a string column; only set if @ref
+    /// Column_statistics_params::frequent_values_sketch_size is greater
+    /// than zero.
+    std::optional<Frequent_values_sketch> frequent_values{};
+};
+
+struct MLIO_API Column_statistics_params {
+    /// The string values that are counted as null. The comparison is
+    /// case-insensitive and ignores leading and trailing whitespace.
+    std::vector<std::string> null_like_values{};
+    /// The precision of the HyperLogLog estimators used to estimate the
+    /// number of distinct values; each estimator has 2^precision
+    /// one-byte registers. Must be between 4 and 18.
+    std::uint8_t cardinality_precision = 12;
+    /// The size parameter of the sketches used to estimate the quantiles
+    /// of the numeric values; see @ref Quantile_sketch.
+    std::size_t quantile_sketch_size = 200;
+    /// If greater than zero, the most frequent values of the string
+    /// columns are tracked with sketches of this many counters; see
+    /// @ref Frequent_values_sketch.
+    std::size_t frequent_values_sketch_size{};
+};
+
+/// Holds the values of a single column for a run of consecutive rows,
+/// as returned by @ref Csv_reader::read_column_chunks().
+struct MLIO_API Column_chunk {
+    /// The name of the column.
+    std::string name{};
+    /// The values of the column; a @ref Dense_tensor of shape [number of
+    /// rows, 1] for a numeric column, or a @ref String_tensor holding the
+    /// values as offsets into a single byte buffer for a string column.
+    /// The tensor can have trailing padding rows.
+    Intrusive_ptr<Tensor> values{};
+    /// The number of rows of @ref values, excluding the padding.
+    std::size_t num_rows{};
+};
+
+/// Computes the statistics of the columns of the @ref Example "examples"
+/// added to it.
+///
+/// Each thread that adds an example aggregates into its own partial
+/// statistics, and the instances of a large example are aggregated in
+/// parallel; the partial statistics are merged, also in parallel, only
+/// when @ref statistics() is called. A collector can be passed to a
+/// data reader through @ref Data_reader_params::column_statistics to
+/// compute the statistics in the decode stage of its pipeline, in which
+/// case the statistics of a dataset are computed in the same parallel
+/// pass that reads it.
+///
+/// @remark
+///     For sparse tensors the statistics are computed over the stored
+///     values. String columns can be either dense tensors of strings or
+///     @ref String_tensor instances.
+class MLIO_API Column_statistics_collector
+    : public Intrusive_ref_counter<Column_statistics_collector> {
+public:
+    explicit Column_statistics_collector(Column_statistics_params params = {});
+
+    Column_statistics_collector(const Column_statistics_collector &) = delete;
+
+    Column_statistics_collector &operator=(const Column_statistics_collector &) = delete;
+
+    Column_statistics_collector(Column_statistics_collector &&) = delete;
+
+    Column_statistics_collector &operator=(Column_statistics_collector &&) = delete;
+
+    ~Column_statistics_collector();
+
+    /// Adds the instances of the specified example. All examples must
+    /// have the same attributes. Safe to call concurrently.
+    void add(const Example &example);
+
+    /// Adds the rows of the specified column chunks; one chunk per
+    /// column, in the same order in every call. The chunks of a call do
+    /// not have to have the same number of rows. Safe to call
+    /// concurrently.
+    void add(stdx::span<const Column_chunk> chunks);
+
+    /// Returns the statistics of the examples added so far.
+    std::vector<Column_statistics> statistics() const;
+
+    /// Discards the statistics of the examples added so far.
+    void reset();
+
+private:
+    MLIO_HIDDEN
+    void init_columns(const Schema &schema);
+
+    MLIO_HIDDEN
+    void init_columns(stdx::span<const Column_chunk> chunks);
+
+    MLIO_HIDDEN
+    void aggregate(const std::vector<detail::Column_values> &columns);
+
+    Column_statistics_params params_;
+    std::vector<std::string> null_like_values_{};
+    std::vector<std::string> names_{};
+    std::vector<Data_type> data_types_{};
+    std::unique_ptr<detail::Column_partials> partials_;
+    mutable std::shared_mutex mutex_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
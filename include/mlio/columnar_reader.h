@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Columnar_footer;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents a @ref Data_reader for reading datasets written by
+/// @ref Columnar_writer.
+///
+/// Each block of a columnar file, which holds the instances of one
+/// written @ref Example, is treated as a data @ref Instance; this means
+/// the batch size specifies the number of blocks per @ref Example and
+/// the batch dimension of the tensors is the total number of rows in
+/// those blocks. The column chunks are copied into the tensors as is,
+/// or decompressed if the file was written with compression; no
+/// per-value decoding takes place. Files should be read as memory-mapped
+/// @ref File "files" so that the blocks are not copied when read.
+class MLIO_API Columnar_reader final : public Parallel_data_reader {
+public:
+    explicit Columnar_reader(Data_reader_params params);
+
+    Columnar_reader(const Columnar_reader &) = delete;
+
+    Columnar_reader &operator=(const Columnar_reader &) = delete;
+
+    Columnar_reader(Columnar_reader &&) = delete;
+
+    Columnar_reader &operator=(Columnar_reader &&) = delete;
+
+    ~Columnar_reader() final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Columnar_footer>
+    read_footer(const Data_store &store, Input_stream &stream);
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Columnar_footer> get_footer(const Data_store &store) const;
+
+    // The footers of the columnar files read so far. Populated by the
+    // record readers and used by the decode tasks.
+    mutable std::mutex footer_mutex_{};
+    std::unordered_map<const Data_store *, std::shared_ptr<const detail::Columnar_footer>>
+        footers_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
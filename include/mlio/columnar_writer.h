@@ -0,0 +1,130 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/data_writer.h"
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Columnar_footer;
+
+}  // namespace detail
+
+/// @addtogroup data_writers Data Writers
+/// @{
+
+/// Specifies how the column chunks of a columnar file are compressed.
+enum class Columnar_compression {
+    none,
+    /// Requires MLIO to be built with Zstandard support. Trades the
+    /// ability to map the chunks directly for a smaller file.
+    zstd,
+};
+
+struct MLIO_API Columnar_writer_params final {
+    /// See @ref Columnar_compression.
+    Columnar_compression compression = Columnar_compression::none;
+    /// The Zstandard compression level.
+    int compression_level = 3;
+    /// The alignment, in bytes, of the column chunks within the file. It
+    /// must be a power of two.
+    std::size_t alignment = 64;
+};
+
+/// Represents a @ref Data_writer that writes a dataset in the native
+/// columnar format of MLIO, which can be read with @ref Columnar_reader.
+///
+/// Each written @ref Example becomes a block in which every feature is
+/// stored as a contiguous, aligned chunk holding the raw values of its
+/// rows. A footer at the end of the file contains the @ref Schema and the
+/// location of each chunk. Unlike text or protobuf based formats reading
+/// the file requires no per-value decoding; an uncompressed chunk is
+/// copied into its tensor with a single memory copy.
+///
+/// The file is written to a temporary file that is renamed once the
+/// writer is closed so that a partial file is never picked up.
+///
+/// @remark
+///     Only dense features of numeric data types can be written. The
+///     values are stored in the host byte order.
+class MLIO_API Columnar_writer final : public Data_writer {
+public:
+    explicit Columnar_writer(std::string path, Columnar_writer_params params = {});
+
+    Columnar_writer(const Columnar_writer &) = delete;
+
+    Columnar_writer &operator=(const Columnar_writer &) = delete;
+
+    Columnar_writer(Columnar_writer &&) = delete;
+
+    Columnar_writer &operator=(Columnar_writer &&) = delete;
+
+    ~Columnar_writer() final;
+
+    void write_example(const Example &example) final;
+
+    void close() final;
+
+    /// Returns the number of instances written so far.
+    std::size_t num_instances_written() const noexcept
+    {
+        return num_instances_;
+    }
+
+private:
+    MLIO_HIDDEN
+    void init_columns(const Example &example);
+
+    MLIO_HIDDEN
+    void write(const void *data, std::size_t size);
+
+    MLIO_HIDDEN
+    void write_padding();
+
+    MLIO_HIDDEN
+    void check_file() const;
+
+    std::string path_;
+    std::string tmp_path_;
+    Columnar_writer_params params_;
+    std::ofstream file_{};
+    std::unique_ptr<detail::Columnar_footer> footer_;
+    std::size_t offset_{};
+    std::size_t num_instances_{};
+    bool closed_{};
+};
+
+/// Writes all examples read from the specified @ref Data_reader to a
+/// columnar file. The reader is reset before the first example is read.
+MLIO_API
+void write_columnar_file(const std::string &path,
+                         Data_reader &reader,
+                         const Columnar_writer_params &params = {});
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
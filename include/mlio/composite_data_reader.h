@@ -0,0 +1,222 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/schema.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents an abstract helper base class for the data readers that
+/// combine the examples of other readers.
+///
+/// @remark
+///     The child readers keep prefetching in their own pipelines; the
+///     prefetch budget of the combined dataset is the sum of their @ref
+///     Data_reader_params::num_prefetched_examples, which should be
+///     split among them accordingly.
+class MLIO_API Composite_data_reader : public Data_reader {
+public:
+    Composite_data_reader(const Composite_data_reader &) = delete;
+
+    Composite_data_reader &operator=(const Composite_data_reader &) = delete;
+
+    Composite_data_reader(Composite_data_reader &&) = delete;
+
+    Composite_data_reader &operator=(Composite_data_reader &&) = delete;
+
+    ~Composite_data_reader() override;
+
+    Intrusive_ptr<const Schema> read_schema() final;
+
+    Intrusive_ptr<Example> read_example() final;
+
+    Intrusive_ptr<Example> peek_example() final;
+
+    /// Resets the child readers as well.
+    void reset() noexcept override;
+
+    /// Returns the total number of bytes read by the child readers.
+    std::size_t num_bytes_read() const noexcept final;
+
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+    const std::vector<Intrusive_ptr<Data_reader>> &children() const noexcept
+    {
+        return children_;
+    }
+
+protected:
+    explicit Composite_data_reader(std::vector<Intrusive_ptr<Data_reader>> children);
+
+    /// Returns the Schema as returned by @ref merge_schemas().
+    Intrusive_ptr<const Schema> schema() const noexcept
+    {
+        return schema_;
+    }
+
+private:
+    /// When implemented in a derived class, returns the Schema of the
+    /// combined dataset given the schemas of the child readers. A
+    /// schema is null if the dataset of its reader is empty.
+    virtual Intrusive_ptr<const Schema>
+    merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas) = 0;
+
+    /// When implemented in a derived class, returns the next @ref
+    /// Example of the combined dataset.
+    virtual Intrusive_ptr<Example> read_example_core() = 0;
+
+    MLIO_HIDDEN
+    void ensure_schema_merged();
+
+    std::vector<Intrusive_ptr<Data_reader>> children_;
+    bool schema_merged_{};
+    Intrusive_ptr<const Schema> schema_{};
+    Intrusive_ptr<Example> peeked_example_{};
+};
+
+/// Represents a @ref Data_reader that reads an example from each child
+/// reader and merges their features into a single @ref Example. The
+/// attribute names must be unique across the child readers, and the
+/// child readers must return the same number of instances per example.
+/// An epoch ends with the shortest child reader.
+class MLIO_API Zip_reader final : public Composite_data_reader {
+public:
+    explicit Zip_reader(std::vector<Intrusive_ptr<Data_reader>> children);
+
+    Zip_reader(const Zip_reader &) = delete;
+
+    Zip_reader &operator=(const Zip_reader &) = delete;
+
+    Zip_reader(Zip_reader &&) = delete;
+
+    Zip_reader &operator=(Zip_reader &&) = delete;
+
+    ~Zip_reader() final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema>
+    merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_example_core() final;
+};
+
+/// Represents a @ref Data_reader that reads the examples of its child
+/// readers one after another. The child readers must have the same
+/// Schema.
+class MLIO_API Concat_reader final : public Composite_data_reader {
+public:
+    explicit Concat_reader(std::vector<Intrusive_ptr<Data_reader>> children);
+
+    Concat_reader(const Concat_reader &) = delete;
+
+    Concat_reader &operator=(const Concat_reader &) = delete;
+
+    Concat_reader(Concat_reader &&) = delete;
+
+    Concat_reader &operator=(Concat_reader &&) = delete;
+
+    ~Concat_reader() final;
+
+    void reset() noexcept final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema>
+    merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_example_core() final;
+
+    std::size_t child_idx_{};
+};
+
+struct MLIO_API Mixture_params final {
+    /// The relative frequencies at which the examples of the child
+    /// readers are returned. If empty, the child readers are sampled
+    /// uniformly.
+    std::vector<double> weights{};
+    /// A boolean value indicating whether an epoch ends as soon as one
+    /// of the child readers reaches the end of its dataset. Otherwise
+    /// the remaining child readers are sampled until all are exhausted,
+    /// which skews the mixture toward the larger datasets at the end of
+    /// the epoch.
+    bool stop_on_first_exhausted = false;
+    /// The seed that will be used for sampling the child readers. If not
+    /// specified, a random seed will be generated internally.
+    std::optional<std::uint_fast64_t> seed{};
+};
+
+/// Represents a @ref Data_reader that returns the examples of randomly
+/// chosen child readers in the proportions of their weights; e.g. for
+/// multi-task training on several datasets. The child readers must have
+/// the same Schema.
+class MLIO_API Mixture_reader final : public Composite_data_reader {
+public:
+    explicit Mixture_reader(std::vector<Intrusive_ptr<Data_reader>> children,
+                            Mixture_params params = {});
+
+    Mixture_reader(const Mixture_reader &) = delete;
+
+    Mixture_reader &operator=(const Mixture_reader &) = delete;
+
+    Mixture_reader(Mixture_reader &&) = delete;
+
+    Mixture_reader &operator=(Mixture_reader &&) = delete;
+
+    ~Mixture_reader() final;
+
+    void reset() noexcept final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema>
+    merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_example_core() final;
+
+    MLIO_HIDDEN
+    void reset_distribution();
+
+    Mixture_params params_;
+    // The weights of the child readers that have not been exhausted in
+    // the current epoch.
+    std::vector<double> weights_{};
+    std::discrete_distribution<std::size_t> dist_{};
+    bool exhausted_{};
+    std::mt19937_64 mt_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
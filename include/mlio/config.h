@@ -39,10 +39,70 @@ inline namespace abi_v1 {
 MLIO_API
 bool supports_s3() noexcept;
 
+/// Returns a boolean value indicating whether the library was built
+/// with the Amazon S3 client of the AWS Common Runtime.
+MLIO_API
+bool supports_s3_crt() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with Google Cloud Storage support.
+MLIO_API
+bool supports_gcs() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with Azure Blob Storage support.
+MLIO_API
+bool supports_azure() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with HTTP(S) data store support.
+MLIO_API
+bool supports_http() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with Kafka data store support.
+MLIO_API
+bool supports_kafka() noexcept;
+
 /// Returns a boolean value indicating whether the library was built
 /// with image reader support.
 MLIO_API
 bool supports_image_reader() noexcept;
 
+/// Returns a boolean value indicating whether the library was built
+/// with bzip2 support.
+MLIO_API
+bool supports_bzip2() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with Zstandard support.
+MLIO_API
+bool supports_zstd() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with LZ4 support.
+MLIO_API
+bool supports_lz4() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with Intel ISA-L support for inflating gzip streams.
+MLIO_API
+bool supports_isal() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with native Parquet reader support.
+MLIO_API
+bool supports_parquet_reader() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with native ORC reader support.
+MLIO_API
+bool supports_orc_reader() noexcept;
+
+/// Returns a boolean value indicating whether the library was built
+/// with CUDA support.
+MLIO_API
+bool supports_cuda() noexcept;
+
 }  // namespace abi_v1
 }  // namespace mlio
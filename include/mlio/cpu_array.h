@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -26,6 +27,7 @@
 #include "mlio/device.h"
 #include "mlio/device_array.h"
 #include "mlio/memory/util.h"
+#include "mlio/span.h"
 #include "mlio/type_traits.h"
 
 namespace mlio {
@@ -147,6 +149,33 @@ inline std::unique_ptr<Device_array> wrap_cpu_array(Container &&container)
 MLIO_API
 std::unique_ptr<Device_array> make_cpu_array(Data_type dt, std::size_t size);
 
+/// Allocates a new @ref Cpu_array with the specified size for each of
+/// the specified data types. The arrays share a single memory block that
+/// is freed once all of them are destroyed, which saves an allocation
+/// per array for schemas with thousands of columns.
+///
+/// @remark
+///     Arrays of type @ref Data_type::string are allocated separately.
+MLIO_API
+std::vector<std::unique_ptr<Device_array>>
+make_cpu_arrays(stdx::span<const Data_type> dts, std::size_t size);
+
+/// Same as @ref make_cpu_arrays(), but the arrays share a @ref
+/// File_backed_memory_block created in @p directory instead of a heap
+/// buffer. The pages of the arrays are backed by the page cache and can
+/// be written back to the file under memory pressure, so an output that
+/// is larger than the physical memory can still be decoded and handed
+/// to the consumer without a copy.
+///
+/// @param directory
+///     The directory to create the backing file in; e.g. a fast local
+///     disk. If empty, defaults to /tmp.
+MLIO_API
+std::vector<std::unique_ptr<Device_array>>
+make_file_backed_cpu_arrays(stdx::span<const Data_type> dts,
+                            std::size_t size,
+                            const std::string &directory = {});
+
 /// @}
 
 }  // namespace abi_v1
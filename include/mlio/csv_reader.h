@@ -15,9 +15,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -59,6 +64,17 @@ struct MLIO_API Csv_params final {
     /// A boolean value indicating whether the dataset has a header row
     /// only in the first data store.
     bool has_single_header = false;
+    /// A boolean value indicating whether the columns of each data store
+    /// should be matched to the schema by the names in its header row
+    /// instead of by their positions. The header of each data store is
+    /// read once; its columns can be in a different order, the columns
+    /// that are not in the schema are skipped, and the columns that it
+    /// lacks are read as empty fields. The schema is taken from @ref
+    /// column_names, or else from the header of the first data store.
+    ///
+    /// @note
+    ///     Cannot be combined with @ref has_single_header.
+    bool map_columns_by_header = false;
     /// A boolean value indicating whether duplicate columns should be
     /// renamed. If true, duplicate columns 'X', ..., 'X' will be
     /// renamed to 'X', 'X_1', X_2', ...
@@ -83,10 +99,100 @@ struct MLIO_API Csv_params final {
     /// If not specified, the column data types will be inferred from
     /// the dataset.
     std::optional<Data_type> default_data_type{};
+    /// The number of rows to sample for inferring the column data types
+    /// if @ref default_data_type is not specified. Besides the first
+    /// instance, the rows are read from the beginning of the dataset,
+    /// possibly from several data stores, and are classified in parallel.
+    /// Each column gets the narrowest data type that can represent all
+    /// of its sampled values.
+    std::size_t num_type_inference_rows = 1;
     /// The mapping between columns and data types by name.
     std::unordered_map<std::string, Data_type> column_types{};
     /// The mapping between columns and data types by index.
     std::unordered_map<std::size_t, Data_type> column_types_by_index{};
+    /// The rules to narrow the inferred data types of the columns; e.g.
+    /// mapping int64 to int16 and float64 to float32 shrinks the tensors
+    /// of such columns 4x and 2x respectively. The rules are applied
+    /// before @ref column_types and @ref column_types_by_index. A value
+    /// that does not fit into the narrowed data type makes its row a bad
+    /// instance and is counted in @ref Reader_stats::num_overflows.
+    std::unordered_map<Data_type, Data_type> narrowed_types{};
+    /// The columns whose values should be dictionary-encoded. Instead of
+    /// being parsed, each distinct value of such a column is mapped to
+    /// an int32 code which is returned in place of the value; the codes
+    /// can be mapped back via @ref Csv_reader::dictionary(). This saves
+    /// memory and allocations for low-cardinality categorical columns.
+    ///
+    /// @remark
+    ///     The dictionary is shared across batches and epochs; a value
+    ///     keeps its code for the lifetime of the reader. As batches are
+    ///     decoded in parallel, the codes depend on the order in which
+    ///     the values are first seen and are not deterministic.
+    std::unordered_set<std::string> dictionary_encoded_columns{};
+    /// The columns, specified by index, whose values should be
+    /// dictionary-encoded. See @ref dictionary_encoded_columns.
+    std::unordered_set<std::size_t> dictionary_encoded_columns_by_index{};
+    /// The columns whose values should be hashed. Instead of being
+    /// parsed, the value of such a column is hashed with the 32-bit
+    /// MurmurHash3 and returned as its int64 bucket index in the range
+    /// [0, @ref num_hash_buckets). This is also known as the hashing
+    /// trick.
+    std::unordered_set<std::string> hashed_columns{};
+    /// The columns, specified by index, whose values should be hashed.
+    /// See @ref hashed_columns.
+    std::unordered_set<std::size_t> hashed_columns_by_index{};
+    /// The number of buckets of the hashed columns.
+    std::size_t num_hash_buckets = 1 << 20;
+    /// The seed of the hash function of the hashed columns.
+    std::uint32_t hash_seed = 0;
+    /// A boolean value indicating whether the columns should be read
+    /// into a single float32 tensor of shape [batch size, number of
+    /// columns] named @ref stacked_feature_name instead of a tensor per
+    /// column. The values of a row are written next to each other, which
+    /// suits wide numeric datasets that are consumed as a matrix.
+    ///
+    /// @note
+    ///     All columns that are read must be numeric; they are parsed as
+    ///     float32 regardless of their data types. Cannot be combined
+    ///     with dictionary-encoded or hashed columns.
+    bool stack_columns = false;
+    /// The name of the feature holding the stacked columns. See @ref
+    /// stack_columns.
+    std::string stacked_feature_name = "values";
+    /// A boolean value indicating whether the columns should be parsed
+    /// only when their features are first accessed. The decode stage
+    /// then only tokenizes the rows of a batch and keeps their fields;
+    /// each feature of the returned @ref Example is parsed on demand,
+    /// so the columns that are never accessed are never paid for. Suits
+    /// jobs that look at a few features of wide datasets.
+    ///
+    /// @note
+    ///     The rows with a wrong number of fields are handled as
+    ///     specified by @ref Data_reader_params::bad_example_handling.
+    ///     However a value that cannot be parsed is only found once its
+    ///     feature is accessed, when the example can no longer be
+    ///     skipped or padded; it raises an @ref Invalid_instance_error
+    ///     regardless of the bad example handling. Cannot be combined
+    ///     with @ref stack_columns.
+    bool lazy_decode = false;
+    /// A boolean value indicating whether to return the string columns
+    /// as @ref String_tensor instances instead of dense tensors of
+    /// strings. The decoder then only records where each value lies in
+    /// its row and copies the values of a column into a single buffer
+    /// once the batch is decoded, with no allocation per value. Has no
+    /// effect if @ref lazy_decode is specified.
+    bool arena_strings = false;
+    /// The path of a schema file written by @ref Csv_reader::save_schema().
+    /// If specified, the column names and data types are read from the
+    /// file instead of the dataset; no data store is opened until the
+    /// first example is read. It is the responsibility of the caller to
+    /// ensure that all data stores have the same columns.
+    ///
+    /// @note
+    ///     The column names in the file take precedence over @ref
+    ///     column_names, while @ref use_columns, @ref column_types, and
+    ///     their by-index variants are applied as usual.
+    std::string schema_path{};
     /// The delimiter character.
     char delimiter = ',';
     /// The character used for quoting field values.
@@ -96,7 +202,8 @@ struct MLIO_API Csv_params final {
     std::optional<char> comment_char = std::nullopt;
     /// A boolean value indicating whether quoted fields can be multi-
     /// line. Note that turning this flag on can slow down the reading
-    /// speed.
+    /// speed; large chunks are framed in parallel, but only if there is
+    /// no comment character.
     bool allow_quoted_new_lines = false;
     /// A boolean value indicating whether to skip empty lines.
     bool skip_blank_lines = true;
@@ -134,27 +241,98 @@ public:
 
     void reset() noexcept final;
 
+    void restore_state(const Data_reader_state &state) final;
+
+    /// Writes the column names and data types of the dataset to the
+    /// specified file so that subsequent readers can skip the schema
+    /// inference by setting @ref Csv_params::schema_path.
+    void save_schema(const std::string &path);
+
+    /// Returns the values of the specified dictionary-encoded column
+    /// ordered by their codes. See @ref
+    /// Csv_params::dictionary_encoded_columns.
+    ///
+    /// @param name
+    ///     The name of the column as in the schema.
+    std::vector<std::string> dictionary(const std::string &name);
+
+    /// Reads the next batch of rows and returns it as one chunk per
+    /// column that is read, in schema order, for column-oriented
+    /// consumers such as @ref Column_statistics_collector::add(). The
+    /// numeric columns are returned as their typed buffers and the
+    /// string columns as @ref String_tensor instances; set @ref
+    /// Csv_params::arena_strings to have the decoder build the latter
+    /// directly instead of converting the dense string tensors. Returns
+    /// an empty vector at the end of the dataset.
+    ///
+    /// @remark
+    ///     Reads from the same example queue as @ref read_example().
+    ///     Not supported if @ref Csv_params::stack_columns is set.
+    std::vector<Column_chunk> read_column_chunks();
+
 private:
     struct Decoder_state;
 
-    template<typename Col_iter>
     class Decoder;
 
+    struct Sampled_row;
+
+    struct Row_filter_state;
+
+    struct Lazy_context;
+
+    class Lazy_columns;
+
+    // Maps the fields of the rows of a data store to the columns of the
+    // schema; unmapped_column marks the fields that are not in it.
+    using Column_map = std::vector<std::size_t>;
+
+    static constexpr std::size_t unmapped_column = static_cast<std::size_t>(-1);
+
     MLIO_HIDDEN
     Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
 
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader>
+    make_counting_record_reader(const Data_store &store, std::size_t store_index) final;
+
+    MLIO_HIDDEN
+    void release_data_store(const Data_store &store) noexcept final;
+
     MLIO_HIDDEN
     void read_names_from_header(const Data_store &store, Record_reader &reader);
 
     MLIO_HIDDEN
     void skip_to_header_row(Record_reader &reader);
 
+    MLIO_HIDDEN
+    std::shared_ptr<const Column_map>
+    read_column_map(const Data_store &store, Record_reader &reader);
+
+    MLIO_HIDDEN
+    std::shared_ptr<const Column_map> find_column_map(const Data_store &store) const;
+
+    MLIO_HIDDEN
+    void load_schema();
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> restore_schema() final;
+
     MLIO_HIDDEN
     Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
 
     MLIO_HIDDEN
     void infer_column_types(const std::optional<Instance> &instance);
 
+    MLIO_HIDDEN
+    void remap_column_types(const Instance &instance);
+
+    MLIO_HIDDEN
+    void widen_column_types();
+
+    MLIO_HIDDEN
+    std::vector<Sampled_row> sample_rows();
+
     MLIO_HIDDEN
     void set_or_validate_column_names(const std::optional<Instance> &instance);
 
@@ -164,9 +342,23 @@ private:
     MLIO_HIDDEN
     Intrusive_ptr<const Schema> init_parsers_and_make_schema();
 
+    MLIO_HIDDEN
+    std::shared_ptr<const Lazy_context> make_lazy_context(const std::vector<Attribute> &attrs) const;
+
+    MLIO_HIDDEN
+    void resolve_row_filters();
+
+    MLIO_HIDDEN
+    bool matches_row_filters(const Instance &instance);
+
     MLIO_HIDDEN
     bool should_skip(std::size_t index, const std::string &name) const noexcept;
 
+    MLIO_HIDDEN
+    std::vector<bool> select_columns(const std::unordered_set<std::string> &names,
+                                     const std::unordered_set<std::size_t> &indices,
+                                     std::string_view action) const;
+
     MLIO_HIDDEN
     Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
 
@@ -180,15 +372,53 @@ private:
     std::optional<std::size_t> decode_prl(Decoder_state &state, const Instance_batch &batch) const;
 
     MLIO_HIDDEN
-    auto make_column_iterators() const noexcept;
+    void compact_rows(Decoder_state &state, stdx::span<const Row_state> row_states) const;
+
+    MLIO_HIDDEN
+    void clear_rows(Decoder_state &state, std::size_t begin, std::size_t end) const;
+
+    MLIO_HIDDEN
+    std::optional<std::size_t>
+    decode_lazy(Decoder_state &state, const Instance_batch &batch, Lazy_columns &columns) const;
+
+    MLIO_HIDDEN
+    std::unique_ptr<Decoder> acquire_decoder(Decoder_state &state) const;
+
+    MLIO_HIDDEN
+    void release_decoder(std::unique_ptr<Decoder> decoder) const noexcept;
 
 private:
     Csv_params params_;
     std::vector<std::string> column_names_;
     std::vector<Data_type> column_types_{};
     std::vector<int> column_ignores_{};
-    std::vector<Parser> column_parsers_{};
-    bool should_read_header = true;
+    std::vector<Column_parser> column_parsers_{};
+    // The number of columns up to and including the last column that is
+    // not ignored; the rest of a row is only counted, not tokenized.
+    std::size_t num_scanned_columns_{};
+    // The number of columns that are not ignored.
+    std::size_t num_read_columns_{};
+    // The dictionaries of the dictionary-encoded columns by attribute
+    // index; null for the other attributes. Shared with the lazily
+    // decoded examples.
+    std::vector<std::shared_ptr<detail::String_dictionary>> dictionaries_{};
+    // Indicates which attributes hold hashed columns.
+    std::vector<bool> hashed_attrs_{};
+    // See Csv_params::lazy_decode.
+    std::shared_ptr<const Lazy_context> lazy_context_{};
+    // Read by the data stores that are prefetched in the background.
+    std::atomic_bool should_read_header{true};
+    // The column maps of the data stores whose headers differ from the
+    // schema; see Csv_params::map_columns_by_header.
+    mutable std::mutex column_maps_mutex_{};
+    std::unordered_map<const Data_store *, std::shared_ptr<const Column_map>> column_maps_{};
+    // See Data_reader_params::row_filters; only accessed by the batching
+    // stage once the schema is inferred.
+    std::unique_ptr<Row_filter_state> row_filter_{};
+    // The idle decoders; kept so that their scratch buffers are reused
+    // by the next batches instead of being reallocated.
+    mutable std::mutex decoders_mutex_{};
+    mutable std::vector<std::unique_ptr<Decoder>> decoders_{};
 };
 
 /// @}
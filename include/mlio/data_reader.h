@@ -15,17 +15,26 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <map>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "mlio/column_statistics.h"
 #include "mlio/config.h"
 #include "mlio/data_stores/data_store.h"
+#include "mlio/device.h"
+#include "mlio/example_transform.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
 #include "mlio/intrusive_ref_counter.h"
+#include "mlio/reader_stats.h"
 #include "mlio/schema.h"
+#include "mlio/thread_pool.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -62,6 +71,12 @@ enum class Last_example_handling {
 
 /// Specifies how an Example that contains erroneous data should be
 /// handled.
+///
+/// @remark
+///     Unless set to @c error, the RecordIO framing of a dataset is read
+///     in a resilient mode as well: on a corrupt header, the reader
+///     scans forward to the next valid header and skips the corrupt byte
+///     range, which is logged with the *_warn variants.
 enum class Bad_example_handling {
     /// Throw exception.
     error,
@@ -76,6 +91,98 @@ enum class Bad_example_handling {
     pad_warn
 };
 
+/// Specifies how prefetched @ref Example "examples" should be handed
+/// over from the background thread to the reader.
+enum class Example_queue_handling {
+    /// Use a pair of queues guarded by a mutex.
+    locked,
+    /// Use a bounded lock-free ring buffer. The reader spins for a
+    /// short, adaptive period of time before parking when no example
+    /// is available. Reduces the handoff latency for small batches at
+    /// the cost of some extra CPU time.
+    lock_free
+};
+
+/// Specifies the order in which @ref Instance "data instances" read
+/// concurrently from multiple data stores should be interleaved.
+enum class Interleave_ordering {
+    /// Cycle through the data stores in a fixed order. The resulting
+    /// sequence of instances is deterministic.
+    round_robin,
+    /// Take the next instance from the first data store in the cycle
+    /// that has one available. Avoids stalling on slow data stores at
+    /// the cost of a non-deterministic order.
+    first_available
+};
+
+/// Specifies how the decoding of an @ref Instance_batch should be
+/// scheduled on the thread pool.
+enum class Decode_scheduling {
+    /// Decode each batch in a single task. Only batches that are large
+    /// enough to amortize the threading overhead get split further;
+    /// the threshold is derived from the measured decode cost of the
+    /// earlier batches of the dataset.
+    per_batch,
+    /// Split each batch into row-range tasks that idle worker threads
+    /// can steal. Useful when the batch size is large and @ref
+    /// Data_reader_params::num_parallel_reads is small.
+    row_range
+};
+
+/// Specifies the format of the tensors that hold sparse features.
+enum class Sparse_tensor_format {
+    /// Output a @ref Coo_tensor.
+    coo,
+    /// Output a @ref Csr_tensor. Since instances are appended row by
+    /// row, the index pointer array is built at no extra cost. Features
+    /// that have more than one dimension besides the batch dimension
+    /// cannot be represented in CSR format and are still output as a
+    /// @ref Coo_tensor.
+    csr
+};
+
+/// Specifies how the dataset should be split into shards.
+enum class Sharding_strategy {
+    /// Assign every num_shards'th @ref Instance to the shard. Each
+    /// shard still has to read and frame the whole dataset.
+    instance,
+    /// Split each data store into @ref Data_reader_params::num_shards
+    /// byte ranges and read only the records that start in the range
+    /// of the shard. Data stores that cannot be split (e.g. compressed
+    /// data stores) are assigned to the shards as a whole in a round-
+    /// robin fashion.
+    byte_range,
+    /// Assign whole data stores to the shards, balanced by their size
+    /// hints (see @ref Data_store::size_hint()). Each shard opens only
+    /// its own data stores. See also @ref
+    /// Data_reader_params::shard_seed.
+    data_store
+};
+
+/// Specifies the comparison of a @ref Row_filter.
+enum class Filter_op {
+    equal,
+    not_equal,
+    less,
+    less_equal,
+    greater,
+    greater_equal
+};
+
+/// Represents a comparison of the value of a named column with a
+/// constant. If the constant is a number, the value is compared
+/// numerically and a value that is not a number only satisfies @ref
+/// Filter_op::not_equal; otherwise the two are compared as strings, which also works for ISO
+/// 8601 dates.
+struct MLIO_API Row_filter {
+    /// The name of the column.
+    std::string column{};
+    /// The comparison of the value of the column with @ref value.
+    Filter_op op{};
+    /// The constant to compare the value of the column with.
+    std::string value{};
+};
+
 /// Contains the parameters that are common to all @ref Data_reader
 /// "data readers".
 struct MLIO_API Data_reader_params {
@@ -85,6 +192,31 @@ struct MLIO_API Data_reader_params {
     /// A number indicating how many @ref Instance "data instances"
     /// should be packed into a single @ref Example.
     std::size_t batch_size{};
+    /// The maximum total size, in bytes, of the records of the @ref
+    /// Instance "data instances" in an @ref Example. If greater than
+    /// zero, an example is closed once the next instance would exceed
+    /// it, and @ref batch_size only bounds the number of instances. An
+    /// instance larger than the budget forms an example of its own.
+    std::size_t max_batch_bytes{};
+    /// If greater than zero, the maximum time to wait for a batch to
+    /// fill up once its first @ref Instance "data instance" has been
+    /// read. When the time expires, the instances read so far are
+    /// returned as a smaller @ref Example, or as a padded one if @ref
+    /// last_example_handling is @ref Last_example_handling::pad. Meant
+    /// for streaming sources such as SageMaker pipes into which the
+    /// data trickles in; the instances are read on a background thread
+    /// so that a blocking read does not hold the batch back.
+    ///
+    /// @note
+    ///     Cannot be combined with @ref size_bucketing_lookahead.
+    std::chrono::milliseconds max_batch_latency{};
+    /// If greater than zero, @ref Instance "data instances" of similar
+    /// record size are grouped into the same @ref Example. At most this
+    /// number of instances are buffered while waiting for a group to
+    /// fill up; it must not be less than @ref batch_size. The grouping
+    /// only depends on the order in which the instances are read, so it
+    /// is deterministic if @ref shuffle_seed is specified.
+    std::size_t size_bucketing_lookahead{};
     /// The number of @ref Example "examples" to prefetch in background
     /// to accelerate reading. If zero, defaults to the number of
     /// processor cores.
@@ -94,12 +226,206 @@ struct MLIO_API Data_reader_params {
     /// should be prefetched, this parameter can be used to avoid
     /// thread oversubscription.
     std::size_t num_parallel_reads{};
+    /// A boolean value indicating whether to adjust the number of
+    /// parallel reads and prefetched examples at runtime based on how
+    /// long the consumer waits for examples and how long the reader
+    /// waits for the consumer. If set, @ref num_prefetched_examples
+    /// and @ref num_parallel_reads specify the upper bounds; if zero,
+    /// they default to four times and once the number of processor
+    /// cores respectively.
+    bool autotune = false;
+    /// The maximum number of bytes that the prefetched and in-flight
+    /// examples should occupy if @ref autotune is set. The size of the
+    /// examples is estimated from the dense tensors decoded so far. If
+    /// zero, the memory usage is not limited.
+    std::size_t autotune_memory_budget{};
+    /// The maximum number of bytes that the pipeline of the reader
+    /// should hold; this covers the instance batches being read and
+    /// decoded, the decoded examples not yet returned to the consumer,
+    /// and the shuffle buffer if @ref shuffle_window_bytes is set. The
+    /// size of an example is taken from its dense tensors. While over
+    /// the budget, the reader keeps a single batch in flight and stops
+    /// filling the example queue. The budget is a soft limit; a single
+    /// batch can exceed it. If zero, the memory usage is not limited,
+    /// but is still reported in @ref Reader_stats.
+    std::size_t memory_budget{};
+    /// The number of threads that decode the examples of the reader. If
+    /// greater than zero, or if @ref cpu_affinity or @ref numa_node is
+    /// specified, the reader runs its tasks, including the nested
+    /// parallel work of the decode functions, in a task arena of its own
+    /// instead of sharing the global TBB scheduler with the rest of the
+    /// process. If zero, defaults to the size of @ref cpu_affinity, or,
+    /// if the CPU quota of the cgroup of the process is smaller than the
+    /// number of processor cores, to the quota.
+    std::size_t num_threads{};
+    /// A boolean value indicating whether to read the instance batches
+    /// on a dedicated I/O thread instead of on the worker threads that
+    /// decode. Reads that block on slow data stores, such as S3 objects,
+    /// then do not hold worker threads that could decode the batches
+    /// read so far. The thread reads up to @ref num_parallel_reads
+    /// batches ahead.
+    bool dedicated_io_thread = false;
+    /// The ids of the processor cores to pin the threads of the reader
+    /// to. Cannot be specified along with @ref numa_node.
+    ///
+    /// @note
+    ///     Only supported on Linux.
+    std::vector<std::size_t> cpu_affinity{};
+    /// The NUMA node whose processor cores the threads of the reader
+    /// should be pinned to. The memory that the threads allocate, such
+    /// as the chunks read from the dataset and the decoded tensors, is
+    /// then also allocated on the node whenever possible.
+    ///
+    /// @note
+    ///     Only supported on Linux.
+    std::optional<std::size_t> numa_node{};
+    /// A boolean value indicating whether to pin the threads of the
+    /// reader to the NUMA node that @ref output_device is attached to
+    /// if neither @ref cpu_affinity nor @ref numa_node is specified. If
+    /// the node cannot be determined, for instance if the output device
+    /// is not a CUDA device or the machine has a single NUMA node, the
+    /// threads are not pinned.
+    ///
+    /// @note
+    ///     Only supported on Linux.
+    bool auto_numa_node{};
+    /// The thread pool to run the tasks of the data reader on. Readers
+    /// given the same pool share its threads. Cannot be specified along
+    /// with @ref num_threads, @ref cpu_affinity, @ref numa_node, or
+    /// @ref auto_numa_node.
+    Intrusive_ptr<Thread_pool> thread_pool{};
+    /// A boolean value indicating whether to start reading the next
+    /// epoch while the consumer finishes the current one. If set, the
+    /// background thread and the flow graph of the reader are kept
+    /// across @ref Data_reader::reset() calls; once all examples of an
+    /// epoch are queued, the reader resets the dataset, which also
+    /// reshuffles it, and prefetches the examples of the next epoch
+    /// right away. The reader runs at most one epoch ahead of the
+    /// consumer. As usual, @ref Data_reader::read_example() returns a
+    /// null pointer at the end of each epoch.
+    ///
+    /// @note
+    ///     If the reader is reset before the end of an epoch, the
+    ///     pipeline is restarted and an epoch that has already been
+    ///     started in background is skipped.
+    bool pipeline_epochs = false;
+    /// A boolean value indicating whether the examples should be
+    /// returned in the order their instances are read. If false, the
+    /// examples are queued as soon as they are decoded, so a batch that
+    /// is slow to read or decode does not hold back the ones after it.
+    /// If true, the batches waiting to be decoded are decoded in the
+    /// order of their indexes, so the batch that the example queue
+    /// waits for is decoded first.
+    ///
+    /// @note
+    ///     The state of a reader that does not preserve the order cannot
+    ///     be saved or restored.
+    bool deterministic = true;
+    /// A boolean value indicating whether to start the pipeline as soon
+    /// as the schema is inferred, for instance by @ref
+    /// Data_reader::read_schema(), instead of on the first call to @ref
+    /// Data_reader::read_example(). The first examples are then read
+    /// and decoded while the caller inspects the schema or builds its
+    /// model, which shortens the time to the first example of short
+    /// jobs and notebooks. See @ref Reader_stats::first_example_ns.
+    bool start_on_schema = false;
+    /// See @ref Example_queue_handling.
+    Example_queue_handling example_queue_handling = Example_queue_handling::locked;
+    /// See @ref Decode_scheduling.
+    Decode_scheduling decode_scheduling = Decode_scheduling::per_batch;
+    /// The maximum number of bytes of tensor buffers to keep for reuse.
+    /// If greater than zero, the buffers of the dense tensors of
+    /// dropped @ref Example "examples" are recycled for the next ones
+    /// with the same data type and size instead of being freed. The
+    /// value and index arrays of a sparse tensor are built into a single
+    /// buffer that is reused by the sparse tensors of similar sizes. See
+    /// also @ref Parallel_data_reader::tensor_pool_stats().
+    std::size_t tensor_pool_size{};
+    /// A boolean value indicating whether the large buffers of the
+    /// tensor pool should be backed by transparent huge pages. Large
+    /// images and dense tensors then take fewer page faults and TLB
+    /// misses to decode into. See @ref Tensor_pool.
+    ///
+    /// @note
+    ///     Only supported on Linux; elsewhere the buffers are backed by
+    ///     regular pages.
+    bool tensor_pool_huge_pages = false;
+    /// The directory in which to create the files that back the large
+    /// dense tensors of the @ref Example "examples". If specified, the
+    /// dense tensors of an example whose buffers take at least @ref
+    /// file_backed_output_threshold bytes are allocated as a memory map
+    /// of a file in the directory instead of on the heap; see @ref
+    /// make_file_backed_cpu_arrays(). Useful for readers that return a
+    /// whole dataset as a single example (e.g. to build an XGBoost
+    /// DMatrix), since the pages of the tensors can then be written
+    /// back to disk instead of exhausting the physical memory. The
+    /// files are deleted along with the tensors. An empty string
+    /// stands for /tmp.
+    std::optional<std::string> file_backed_output_directory{};
+    /// The minimum number of bytes of the dense tensor buffers of an
+    /// example for them to be backed by a file; see @ref
+    /// file_backed_output_directory.
+    std::size_t file_backed_output_threshold = 0x4000000;  // 64 MiB
+    /// A boolean value indicating whether the features of the dropped
+    /// @ref Example "examples" should be freed on a background thread.
+    /// Releasing the last reference to an Example then does not stall
+    /// the consumer on the deallocation of its tensors, which can take
+    /// long for sparse and string tensors. The examples dropped faster
+    /// than the background thread can free them are freed inline. See
+    /// @ref Example_reclaimer.
+    bool deferred_reclamation = false;
+    /// The device to which the dense tensors of the @ref Example
+    /// "examples" are copied before they are returned. If not
+    /// specified or a CPU device, the tensors are returned in host
+    /// memory. A CUDA device requires the library to be built with
+    /// CUDA support.
+    std::optional<Device> output_device{};
+    /// The devices, typically the GPUs of a single-process multi-device
+    /// training job, to which the examples are copied in turns. Each
+    /// batch is decoded on its own and copied to the device at index
+    /// (batch index % number of devices), using a dedicated stream and
+    /// pair of page-locked staging buffers per device; so the batch size
+    /// is the per-device batch size and no batch has to be split on the
+    /// host. If @ref deterministic is set, the examples of an epoch are
+    /// returned in device order; see @ref
+    /// Parallel_data_reader::read_device_examples(). A CPU device gets
+    /// its examples in host memory, and @ref
+    /// Parallel_data_reader::decode_buffer() copies to the first device.
+    /// Cannot be combined with @ref output_device.
+    std::vector<Device> output_devices{};
+    /// See @ref Sparse_tensor_format.
+    Sparse_tensor_format sparse_tensor_format = Sparse_tensor_format::coo;
+    /// The number of data stores to read concurrently. If greater than
+    /// one, each data store in the cycle gets its own record reader and
+    /// background prefetch, and their @ref Instance "data instances"
+    /// are interleaved as they are read. If zero or one, the data
+    /// stores are read one after another.
+    std::size_t interleave_cycle_length{};
+    /// The number of consecutive @ref Instance "data instances" to read
+    /// from a data store before moving to the next one in the cycle.
+    std::size_t interleave_block_length = 1;
+    /// See @ref Interleave_ordering.
+    Interleave_ordering interleave_ordering = Interleave_ordering::round_robin;
+    /// The number of data stores to open ahead of the one being read.
+    /// Their record readers are created (e.g. their headers are read)
+    /// and their first records are prefetched on background threads,
+    /// so that moving to the next data store does not stall the read
+    /// stage. Useful for datasets with many small, remote data stores.
+    /// Ignored if @ref interleave_cycle_length is greater than one.
+    ///
+    /// @note
+    ///     Only the data stores that are read as a whole are prefetched;
+    ///     not the blocks of a data store that is split by @ref
+    ///     shuffle_block_size or by byte-range sharding.
+    std::size_t num_prefetched_data_stores{};
     /// See @ref Last_example_handling.
     Last_example_handling last_example_handling = Last_example_handling::none;
     /// See @ref Bad_example_handling.
     Bad_example_handling bad_example_handling = Bad_example_handling::error;
     /// A boolean value indicating whether a warning will be output for
-    /// each bad Instance.
+    /// each bad Instance. In an epoch only the first few bad instances
+    /// are reported individually; the rest are summarized periodically
+    /// and counted in @ref Reader_stats.
     bool warn_bad_instances = false;
     /// The number of @ref Instance "data instances" to skip from the
     /// beginning of the dataset.
@@ -112,10 +438,51 @@ struct MLIO_API Data_reader_params {
     /// The number of shards the dataset should be split into. The
     /// reader will only read 1/num_shards of the dataset.
     std::size_t num_shards{};
+    /// See @ref Sharding_strategy.
+    ///
+    /// @note
+    ///     If set to @ref Sharding_strategy::byte_range or @ref
+    ///     Sharding_strategy::data_store, @ref num_instances_to_skip
+    ///     and @ref num_instances_to_read apply to the shard instead of
+    ///     the whole dataset.
+    Sharding_strategy sharding_strategy = Sharding_strategy::instance;
+    /// The seed that will be used for planning the assignment of the
+    /// data stores to the shards if @ref sharding_strategy is @ref
+    /// Sharding_strategy::data_store. If specified, the data stores
+    /// are reassigned after every @ref Data_reader::reset() call based
+    /// on the seed and the epoch number; all shards must use the same
+    /// seed. If not specified, the assignment never changes.
+    std::optional<std::uint_fast64_t> shard_seed{};
     /// A ratio between zero and one indicating how much of the dataset
-    /// should be read. The dataset will be sampled based on this
-    /// number.
+    /// should be read. Each @ref Instance "data instance" is selected
+    /// independently with this probability; the rejected ones are
+    /// skipped without being constructed, and if the dataset supports
+    /// it (see @ref recordio_indexes), without being read at all.
     std::optional<float> sample_ratio{};
+    /// The seed that will be used for sampling the dataset. If not
+    /// specified, a random seed will be generated internally. The same
+    /// sample is read in every epoch.
+    std::optional<std::uint_fast64_t> sample_seed{};
+    /// A boolean value indicating whether to drop the @ref Instance
+    /// "data instances" whose raw bytes are identical to those of an
+    /// instance read earlier in the same epoch. The instances are
+    /// compared by a 64-bit hash of their bytes, so a unique instance
+    /// is dropped only in the unlikely case of a hash collision.
+    ///
+    /// @note
+    ///     With @ref Sharding_strategy::data_store, the duplicates are
+    ///     only detected within a shard.
+    bool deduplicate_instances = false;
+    /// If greater than zero, the hashes of the @ref Instance "data
+    /// instances" read are kept in a Bloom filter of this many bytes
+    /// instead of an exact set whose size grows with the dataset. The
+    /// filter meets @ref dedup_false_positive_rate for up to about
+    /// 8 * ln(2)^2 / -ln(rate) instances per byte; a false positive
+    /// drops a unique instance.
+    std::size_t dedup_memory_budget{};
+    /// The target false positive rate of the Bloom filter; see @ref
+    /// dedup_memory_budget.
+    float dedup_false_positive_rate = 0.001F;
     /// A boolean value indicating whether to shuffle the @ref Instance
     /// "data instances" while reading from the dataset.
     bool shuffle_instances = false;
@@ -126,6 +493,58 @@ struct MLIO_API Data_reader_params {
     /// A value of zero means perfect shuffling and requires loading the
     /// whole dataset into memory first.
     std::size_t shuffle_window{};
+    /// If greater than zero, the raw data of the buffered @ref Instance
+    /// "data instances" is copied into a dedicated memory arena that
+    /// holds at most approximately this many bytes. This keeps the
+    /// memory usage of the shuffle buffer bounded regardless of the
+    /// instance sizes; if @ref shuffle_window is also specified, the
+    /// buffer is bounded by both limits. Only applicable if @ref
+    /// shuffle_instances is true.
+    ///
+    /// @note
+    ///     The actual occupancy of the buffer can be queried via @ref
+    ///     Parallel_data_reader::shuffle_buffer_size().
+    std::size_t shuffle_window_bytes{};
+    /// If not empty, and if @ref shuffle_window is zero, the dataset is
+    /// shuffled through the specified directory, typically on a fast
+    /// local disk, instead of being loaded into memory. During the
+    /// first epoch every @ref Instance "data instance" is spilled into
+    /// one of @ref num_shuffle_spill_buckets randomly chosen bucket
+    /// files while the instances are returned shuffled within a small
+    /// window; the subsequent epochs read the buckets in random order
+    /// and shuffle each of them in memory. The buckets are temporary
+    /// and are deleted along with the reader. Only applicable if @ref
+    /// shuffle_instances is true.
+    ///
+    /// @note
+    ///     The instances of the first epoch are returned in all
+    ///     subsequent epochs; @ref sample_ratio only applies to the
+    ///     first one. If the reader is reset before the end of the
+    ///     first epoch, the spilling starts over.
+    std::string shuffle_spill_directory{};
+    /// The number of bucket files to spill the dataset into; see @ref
+    /// shuffle_spill_directory. A bucket should fit into memory. If
+    /// zero, defaults to 64.
+    std::size_t num_shuffle_spill_buckets{};
+    /// If greater than zero, the @ref Instance "data instances" of the
+    /// first epoch are copied into memory as long as they fit into this
+    /// many bytes. If the whole epoch fits, the subsequent epochs are
+    /// served from memory without reading or framing the data stores
+    /// again; if @ref shuffle_instances is true, each of them is a
+    /// perfect shuffle of the first epoch, or its exact replay if @ref
+    /// reshuffle_each_epoch is false. If the epoch does not fit, the
+    /// copies are dropped and the dataset is streamed as usual. The
+    /// copies are bounded by this budget alone and do not count towards
+    /// @ref memory_budget.
+    ///
+    /// @note
+    ///     The instances of the first epoch are returned in all
+    ///     subsequent epochs; @ref sample_ratio only applies to the
+    ///     first one. If the reader is reset before the end of the
+    ///     first epoch, the materialization starts over. Ignored if
+    ///     @ref shard_seed reassigns the data stores of the shard in
+    ///     every epoch.
+    std::size_t materialize_memory_budget{};
     /// The seed that will be used for initializing the sampling
     /// distribution. If not specified, a random seed will be generated
     /// internally
@@ -133,6 +552,140 @@ struct MLIO_API Data_reader_params {
     /// A boolean value indicating whether the dataset should be
     /// reshuffled after every @ref Data_reader::reset() call.
     bool reshuffle_each_epoch = true;
+    /// A boolean value indicating whether to read the data stores in
+    /// random order before shuffling their @ref Instance "data
+    /// instances" within @ref shuffle_window. Only applicable if @ref
+    /// shuffle_instances is true.
+    bool shuffle_data_stores = false;
+    /// If greater than zero, the data stores are split into blocks of
+    /// approximately this many bytes that are read in random order
+    /// before their @ref Instance "data instances" get shuffled within
+    /// @ref shuffle_window. This way a much smaller window is enough
+    /// to shuffle datasets that are sorted. Only applicable if @ref
+    /// shuffle_instances is true.
+    ///
+    /// @note
+    ///     The number of blocks is derived from @ref
+    ///     Data_store::size_hint(). Data stores that cannot be split
+    ///     (see @ref Sharding_strategy::byte_range) are read as a
+    ///     whole. Ignored if @ref interleave_cycle_length is greater
+    ///     than one.
+    std::size_t shuffle_block_size{};
+    /// A list of @ref Data_store instances that contain the offset
+    /// indexes (see @ref build_recordio_index()) of the RecordIO data
+    /// stores in @ref dataset, in the same order. If specified, the
+    /// records are read by their offsets; this allows a perfect shuffle
+    /// regardless of @ref shuffle_window with only the indexes held in
+    /// memory. If @ref shuffle_seed is specified, the shards read
+    /// disjoint slices of a single permutation of the dataset, so with
+    /// @ref reshuffle_each_epoch a shard reads a different part of the
+    /// dataset in every epoch; in that case all shards must use the
+    /// same seed and must be reset together.
+    ///
+    /// @note
+    ///     Only applicable to RecordIO-based readers. The data stores
+    ///     must be seekable.
+    std::vector<Intrusive_ptr<Data_store>> recordio_indexes{};
+    /// The number of records to fetch ahead of the reader if @ref
+    /// recordio_indexes are specified. Since the order of an epoch is
+    /// planned up front from the indexes, the records can be fetched
+    /// concurrently by @ref num_parallel_reads threads (by default one
+    /// per processor core) and are put back into the planned order in
+    /// a reorder buffer of this size; so the order of the instances
+    /// does not depend on the number of threads or on the timing of
+    /// the data stores. If zero, the records are fetched one by one.
+    ///
+    /// @remark
+    ///     The records that are fetched ahead and then skipped due to
+    ///     @ref sample_ratio are read in vain.
+    std::size_t indexed_read_ahead{};
+    /// If set, each decoded @ref Example is added to the collector in
+    /// the decode stage of the pipeline; this way the statistics of a
+    /// dataset are computed in the same parallel pass that reads it.
+    /// The examples that are prefetched, but never read, are added as
+    /// well.
+    Intrusive_ptr<Column_statistics_collector> column_statistics{};
+    /// The transforms to run, in order, on each decoded @ref Example.
+    /// They run on the thread pool of the reader, so transforms of
+    /// different examples run in parallel unless limited by @ref
+    /// Example_transform::max_concurrency(); the examples still count
+    /// against the same prefetch limits.
+    ///
+    /// @note
+    ///     Only supported by @ref Parallel_data_reader "parallel data
+    ///     readers".
+    std::vector<Intrusive_ptr<Example_transform>> example_transforms{};
+    /// The minimum read throughput, in bytes per second, expected of a
+    /// data store. If greater than zero, a data store whose throughput
+    /// falls below it, once it has been read for at least a second, is
+    /// reported to @ref slow_store_handler; at most once per epoch.
+    std::size_t min_store_throughput{};
+    /// The function to call with the statistics of a data store that is
+    /// read slower than @ref min_store_throughput. If not set, a warning
+    /// is logged instead.
+    ///
+    /// @note
+    ///     The function is called from the pipeline of the reader and
+    ///     must not call back into the reader.
+    std::function<void(const Store_stats &stats)> slow_store_handler{};
+    /// The filters that an @ref Instance "data instance" has to pass to
+    /// be read. Only the filtered columns are tokenized and compared;
+    /// the instances that fail are dropped before they are batched, so
+    /// their remaining columns are never parsed and the examples still
+    /// have @ref batch_size instances. The dropped instances are counted
+    /// in @ref Reader_stats::num_filtered_instances.
+    ///
+    /// @note
+    ///     Only supported by @ref Csv_reader.
+    std::vector<Row_filter> row_filters{};
+    /// The name of the column that holds the class label of an @ref
+    /// Instance "data instance"; see @ref class_sample_ratios.
+    std::string class_column{};
+    /// The probabilities with which the @ref Instance "data instances"
+    /// of each class are selected, keyed by the value of @ref
+    /// class_column. To read class-balanced batches from an imbalanced
+    /// dataset, the ratio of a class can be set inversely proportional
+    /// to its frequency. Like @ref row_filters, only the instances are
+    /// tokenized up to the class column and the rejected ones are
+    /// dropped before they are batched. The selection is derived from
+    /// @ref sample_seed and the position of the instance, so the same
+    /// sample is read in every epoch.
+    ///
+    /// @note
+    ///     Only supported by @ref Csv_reader.
+    std::map<std::string, float, std::less<>> class_sample_ratios{};
+    /// The probability with which the @ref Instance "data instances"
+    /// whose class is not in @ref class_sample_ratios are selected.
+    float default_class_sample_ratio = 1.0F;
+};
+
+/// Represents the position of a @ref Data_reader within an epoch; see
+/// @ref Data_reader::save_state().
+struct MLIO_API Data_reader_state final {
+    /// The number of times the reader has been reset. The shuffling
+    /// and sampling of the previous epochs is replayed from the seeds
+    /// when the state is restored.
+    std::size_t epoch{};
+    /// The number of examples read in the epoch.
+    std::size_t num_examples_read{};
+    /// The number of instances read from the dataset to assemble those
+    /// examples.
+    std::size_t num_instances_read{};
+    /// The position in the dataset right after the last instance read.
+    /// It is only set if the reader can seek to it directly; otherwise
+    /// the instances are skipped one by one when the state is restored.
+    /// Its contents are specific to the reader.
+    std::vector<std::size_t> position{};
+};
+
+/// Holds the number of @ref Instance "data instances" in a dataset; see
+/// @ref Data_reader::estimate_num_instances().
+struct MLIO_API Instance_count final {
+    /// The number of instances.
+    std::size_t num_instances{};
+    /// A boolean value indicating whether @ref num_instances has been
+    /// counted exactly instead of being extrapolated from a sample.
+    bool exact{};
 };
 
 /// Represents an interface for classes that read @ref Example "examples"
@@ -180,6 +733,51 @@ public:
     ///     The returned number can be greater than expected as MLIO
     ///     can read ahead in background.
     virtual std::size_t num_bytes_read() const noexcept = 0;
+
+    /// Gets the number of bytes currently held by the shuffle buffer.
+    ///
+    /// @remark
+    ///     Only tracked if @ref Data_reader_params::shuffle_window_bytes
+    ///     is specified; otherwise returns zero.
+    virtual std::size_t shuffle_buffer_size() const noexcept = 0;
+
+    /// Returns the position of the reader within the current epoch,
+    /// which can be persisted along with a training checkpoint.
+    ///
+    /// @remark
+    ///     The state reflects the examples returned by @ref
+    ///     read_example(); the examples that have been prefetched in
+    ///     background, or peeked, are read again after a restore.
+    ///
+    /// @remark
+    ///     The default implementation throws @ref Not_supported_error.
+    virtual Data_reader_state save_state() const;
+
+    /// Moves the reader to the position described by the specified
+    /// state. The reader must have been constructed with the same
+    /// parameters as the reader that has saved the state.
+    ///
+    /// @remark
+    ///     The default implementation throws @ref Not_supported_error.
+    virtual void restore_state(const Data_reader_state &state);
+
+    /// Returns the number of instances in the dataset without decoding
+    /// them, e.g. to size a learning rate schedule before training.
+    ///
+    /// @param exact
+    ///     A boolean value indicating whether every record should be
+    ///     counted. If false, the count of a large data store is
+    ///     extrapolated from its size and from the average record size
+    ///     of a few chunks sampled across it.
+    ///
+    /// @remark
+    ///     The count covers the whole dataset; the sharding, sampling,
+    ///     skipping, and filtering parameters, as well as the bad
+    ///     instances, are not taken into account.
+    ///
+    /// @remark
+    ///     The default implementation throws @ref Not_supported_error.
+    virtual Instance_count estimate_num_instances(bool exact);
 };
 
 /// @}
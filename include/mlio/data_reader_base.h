@@ -50,14 +50,24 @@ protected:
         return warn_bad_instances_;
     }
 
+    bool has_peeked_example() const noexcept
+    {
+        return peeked_example_ != nullptr;
+    }
+
 private:
     /// When implemented in a derived class, returns the next @ref
     /// Example read from the dataset.
     virtual Intrusive_ptr<Example> read_example_core() = 0;
 
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_next_example();
+
     Data_reader_params params_;
     bool warn_bad_instances_{};
     Intrusive_ptr<Example> peeked_example_{};
+    // See Data_reader_params::deferred_reclamation.
+    Intrusive_ptr<Example_reclaimer> reclaimer_{};
 };
 
 /// @}
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/detail/file_descriptor.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/schema.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Data_service_connection;
+class Data_service_session;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Constructs the @ref Data_reader that reads the specified split of a
+/// dataset; see @ref Data_service_worker.
+using Data_reader_factory =
+    std::function<Intrusive_ptr<Data_reader>(std::size_t split_index, std::size_t num_splits)>;
+
+struct MLIO_API Data_service_worker_params final {
+    /// The host name or the address to listen on. If empty, listens on
+    /// all interfaces.
+    std::string host{};
+    /// The TCP port to listen on. If zero, an ephemeral port is chosen;
+    /// see @ref Data_service_worker::port().
+    std::uint16_t port{};
+};
+
+/// Represents a worker that runs the preprocessing pipeline of a
+/// dataset, typically on a CPU-only host, and streams the resulting
+/// @ref Example "examples" over TCP to the @ref Data_service_reader
+/// "data service readers" of the trainers.
+///
+/// A dataset is divided into splits. For each split assigned to it by
+/// a reader the worker calls the factory with the index of the split
+/// and the total number of splits, and sends the examples of the
+/// returned @ref Data_reader to the reader. Every connection is served
+/// by a thread of its own.
+///
+/// The examples are sent as a short header followed by the raw tensor
+/// buffers with a single gather write, so they are never copied into an
+/// intermediate message. A worker never runs ahead of a reader by more
+/// than the socket buffers since it blocks once they are full.
+///
+/// @remark
+///     Only dense, COO, and CSR features of numeric data types in host
+///     memory can be sent. The worker and the reader must have the
+///     same byte order.
+class MLIO_API Data_service_worker {
+public:
+    explicit Data_service_worker(Data_reader_factory factory,
+                                 Data_service_worker_params params = {});
+
+    Data_service_worker(const Data_service_worker &) = delete;
+
+    Data_service_worker &operator=(const Data_service_worker &) = delete;
+
+    Data_service_worker(Data_service_worker &&) = delete;
+
+    Data_service_worker &operator=(Data_service_worker &&) = delete;
+
+    ~Data_service_worker();
+
+    /// Stops the worker and closes all connections. The readers that
+    /// are connected to the worker get an error.
+    void stop() noexcept;
+
+    /// Returns the TCP port the worker listens on.
+    std::uint16_t port() const noexcept
+    {
+        return port_;
+    }
+
+private:
+    MLIO_HIDDEN
+    void accept_connections() noexcept;
+
+    MLIO_HIDDEN
+    void remove_closed_connections();
+
+    Data_reader_factory factory_;
+    detail::File_descriptor listener_{};
+    std::uint16_t port_;
+    std::atomic_bool stopped_{};
+    std::mutex mutex_{};
+    std::vector<std::unique_ptr<detail::Data_service_session>> sessions_{};
+    std::thread thread_{};
+};
+
+struct MLIO_API Data_service_params final {
+    /// The addresses of the @ref Data_service_worker "workers" in the
+    /// form of "host:port".
+    std::vector<std::string> workers{};
+    /// The number of splits into which the dataset is divided. If zero,
+    /// defaults to four times the number of workers.
+    std::size_t num_splits{};
+    /// The index of the trainer when several trainers share the same
+    /// workers. The trainer reads the splits whose index modulo @ref
+    /// num_shards equals to @ref shard_index.
+    std::size_t shard_index{};
+    /// The number of trainers that share the same workers.
+    std::size_t num_shards = 1;
+};
+
+/// Represents a @ref Data_reader that reads the @ref Example "examples"
+/// streamed by a set of @ref Data_service_worker "workers".
+///
+/// The splits of an epoch are assigned dynamically; a worker gets the
+/// next pending split as soon as it finishes its current one. This way
+/// a slow worker processes fewer splits instead of stalling the epoch.
+/// The examples are returned in the order they arrive.
+class MLIO_API Data_service_reader final : public Data_reader {
+public:
+    explicit Data_service_reader(Data_service_params params);
+
+    Data_service_reader(const Data_service_reader &) = delete;
+
+    Data_service_reader &operator=(const Data_service_reader &) = delete;
+
+    Data_service_reader(Data_service_reader &&) = delete;
+
+    Data_service_reader &operator=(Data_service_reader &&) = delete;
+
+    ~Data_service_reader() final;
+
+    Intrusive_ptr<const Schema> read_schema() final;
+
+    Intrusive_ptr<Example> read_example() final;
+
+    Intrusive_ptr<Example> peek_example() final;
+
+    void reset() noexcept final;
+
+    std::size_t num_bytes_read() const noexcept final;
+
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_example_core();
+
+    MLIO_HIDDEN
+    void start_epoch();
+
+    MLIO_HIDDEN
+    void assign_split(detail::Data_service_connection &conn);
+
+    MLIO_HIDDEN
+    detail::Data_service_connection &wait_for_busy_connection();
+
+    Data_service_params params_;
+    std::vector<std::unique_ptr<detail::Data_service_connection>> connections_{};
+    Intrusive_ptr<const Schema> schema_{};
+    std::deque<std::size_t> pending_splits_{};
+    bool epoch_started_{};
+    std::size_t next_connection_{};
+    std::size_t num_bytes_read_{};
+    Intrusive_ptr<Example> peeked_example_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/compression.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_stores/object_list_options.h"
+#include "mlio/azure_blob_client.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Represents a blob of an Azure storage account as a @ref Data_store.
+class MLIO_API Azure_blob final : public Data_store {
+public:
+    /// @param version_id
+    ///     The version of the blob to read. If empty, the current
+    ///     version is read.
+    /// @param compression
+    ///     The Compression type of the Azure blob. If set to @c infer,
+    ///     the Compression will be inferred from the URI.
+    /// @param range_read_params
+    ///     The parameters for reading the Azure blob with concurrent
+    ///     byte-range GET requests. If not specified, the parameters of
+    ///     @p client will be used.
+    /// @param size_hint
+    ///     The size of the Azure blob, if already known; @ref
+    ///     list_azure_blobs() sets it from the listing metadata.
+    explicit Azure_blob(Intrusive_ptr<const Azure_blob_client> client,
+                        std::string uri,
+                        std::string version_id = {},
+                        Compression compression = Compression::infer,
+                        std::optional<Range_read_params> range_read_params = {},
+                        std::optional<std::size_t> size_hint = {});
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final;
+
+    const std::string &id() const final;
+
+    std::optional<std::size_t> size_hint() const noexcept final
+    {
+        return size_hint_;
+    }
+
+private:
+    Intrusive_ptr<const Azure_blob_client> client_;
+    std::string uri_;
+    std::string version_id_;
+    Compression compression_;
+    std::optional<Range_read_params> range_read_params_;
+    std::optional<std::size_t> size_hint_;
+    mutable std::string id_{};
+};
+
+/// Lists all Azure blobs residing under the specified URIs.
+MLIO_API
+std::vector<Intrusive_ptr<Data_store>> list_azure_blobs(const Azure_blob_client &client,
+                                                        stdx::span<const std::string> uris,
+                                                        const Object_list_options &opts);
+
+MLIO_API
+std::vector<Intrusive_ptr<Data_store>> list_azure_blobs(const Azure_blob_client &client,
+                                                        const std::string &uri,
+                                                        std::string_view pattern = {});
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
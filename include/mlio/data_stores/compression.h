@@ -28,7 +28,7 @@ inline namespace abi_v1 {
 /// @{
 
 /// Specifies the compression type of a data store.
-enum class Compression { none, infer, gzip, bzip2, zip };
+enum class Compression { none, infer, gzip, bzip2, zip, zstd, lz4 };
 
 /// Constructs a new inflate stream by wrapping the specified input
 /// stream.
@@ -55,6 +55,12 @@ inline std::ostream &operator<<(std::ostream &s, Compression compression)
     case Compression::zip:
         s << "zip";
         break;
+    case Compression::zstd:
+        s << "zstd";
+        break;
+    case Compression::lz4:
+        s << "lz4";
+        break;
     }
     return s;
 }
@@ -15,8 +15,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <string>
 
 #include "mlio/config.h"
@@ -52,6 +54,21 @@ public:
 
     /// Returns a unique identifier for the data store.
     virtual const std::string &id() const = 0;
+
+    /// Returns the size of the data store in bytes if it is known
+    /// without opening it (e.g. from the metadata returned by @ref
+    /// list_files()).
+    virtual std::optional<std::size_t> size_hint() const;
+
+    /// Returns the number of data instances in the data store if it is
+    /// known without opening it (e.g. from the counts recorded in a
+    /// file manifest). The data readers use it to skip the data store
+    /// as a whole instead of reading and discarding its instances.
+    ///
+    /// @remark
+    ///     The count must match the number of instances the data reader
+    ///     returns from the data store, e.g. excluding a CSV header.
+    virtual std::optional<std::size_t> num_instances_hint() const;
 };
 
 MLIO_API
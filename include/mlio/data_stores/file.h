@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -43,9 +45,19 @@ public:
     /// @param compression
     ///     The compression type of the file. If set to @c infer, the
     ///     compression will be inferred from the filename.
+    ///
+    /// @param size_hint
+    ///     The size of the file, if already known; @ref list_files()
+    ///     sets it from the file system metadata.
+    ///
+    /// @param num_instances_hint
+    ///     The number of data instances in the file, if already known;
+    ///     see @ref Data_store::num_instances_hint().
     explicit File(std::string path,
                   bool memory_map = true,
-                  Compression compression = Compression::infer);
+                  Compression compression = Compression::infer,
+                  std::optional<std::size_t> size_hint = {},
+                  std::optional<std::size_t> num_instances_hint = {});
 
     Intrusive_ptr<Input_stream> open_read() const final;
 
@@ -56,10 +68,22 @@ public:
         return path_;
     }
 
+    std::optional<std::size_t> size_hint() const noexcept final
+    {
+        return size_hint_;
+    }
+
+    std::optional<std::size_t> num_instances_hint() const noexcept final
+    {
+        return num_instances_hint_;
+    }
+
 private:
     std::string path_;
     bool memory_map_;
     Compression compression_;
+    std::optional<std::size_t> size_hint_;
+    std::optional<std::size_t> num_instances_hint_;
 };
 
 struct MLIO_API File_list_options {
@@ -78,6 +102,12 @@ struct MLIO_API File_list_options {
 };
 
 /// Recursively lists all files residing under the specified paths.
+///
+/// The directories are traversed concurrently, one task per directory;
+/// the files are returned in natural sort order (see strverscmp(3))
+/// within each directory, and depth-first across directories. The
+/// predicate is called on the calling thread once the traversal has
+/// completed.
 MLIO_API
 std::vector<Intrusive_ptr<Data_store>>
 list_files(stdx::span<const std::string> paths, const File_list_options &opts = {});
@@ -86,6 +116,29 @@ MLIO_API
 std::vector<Intrusive_ptr<Data_store>>
 list_files(const std::string &path, const std::string_view pattern = {});
 
+/// Writes the paths and sizes of the specified files to a manifest
+/// file, so that later runs can skip the traversal of the file system
+/// by calling @ref read_file_manifest().
+///
+/// A manifest file is a UTF-8 text file whose first line reads
+/// 'mlio-file-manifest 1', followed by one line per file holding its
+/// size in bytes and its path separated by a tab character. If any of
+/// the files has a @ref Data_store::num_instances_hint(), the first
+/// line reads 'mlio-file-manifest 2' instead and the number of data
+/// instances, or an empty string if unknown, is written between the
+/// size and the path.
+///
+/// @remark
+///     All data stores must be @ref File instances.
+MLIO_API
+void write_file_manifest(const std::string &path, stdx::span<const Intrusive_ptr<Data_store>> stores);
+
+/// Reads the files listed in the specified manifest file. The pattern
+/// and the predicate of @p opts are applied to the listed paths.
+MLIO_API
+std::vector<Intrusive_ptr<Data_store>>
+read_file_manifest(const std::string &path, const File_list_options &opts = {});
+
 /// @}
 
 }  // namespace abi_v1
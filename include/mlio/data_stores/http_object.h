@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/compression.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/http_client.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Represents an object served over HTTP(S) as a @ref Data_store.
+///
+/// The object is read with concurrent byte-range GET requests over
+/// keep-alive connections; the returned stream supports positional
+/// reads for random-access formats such as Parquet.
+class MLIO_API Http_object final : public Data_store {
+public:
+    /// @param etag
+    ///     The ETag of the object to read. If specified, the requests
+    ///     fail once the object on the server no longer matches it.
+    /// @param compression
+    ///     The Compression type of the object. If set to @c infer, the
+    ///     Compression will be inferred from the path of the URI.
+    /// @param range_read_params
+    ///     The parameters for reading the object with concurrent
+    ///     byte-range GET requests. If not specified, the parameters of
+    ///     @p client will be used.
+    /// @param size_hint
+    ///     The size of the object, if already known; saves the HEAD
+    ///     request that is otherwise made when the object is opened.
+    explicit Http_object(Intrusive_ptr<const Http_client> client,
+                         std::string uri,
+                         std::string etag = {},
+                         Compression compression = Compression::infer,
+                         std::optional<Range_read_params> range_read_params = {},
+                         std::optional<std::size_t> size_hint = {});
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final;
+
+    const std::string &id() const final;
+
+    std::optional<std::size_t> size_hint() const noexcept final
+    {
+        return size_hint_;
+    }
+
+private:
+    Intrusive_ptr<const Http_client> client_;
+    std::string uri_;
+    std::string etag_;
+    Compression compression_;
+    std::optional<Range_read_params> range_read_params_;
+    std::optional<std::size_t> size_hint_;
+    mutable std::string id_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/kafka_client.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Represents a partition of a Kafka topic as a @ref Data_store.
+///
+/// The stream returned by @ref open_read() is the concatenation of the
+/// message payloads from @p start_offset up to @p end_offset, so that
+/// the payloads are parsed by the record reader of the data reader as
+/// if they were the contents of a file. Multiple partitions are read
+/// concurrently by passing them to a reader along with @ref
+/// Data_reader_params::interleave_cycle_length.
+///
+/// A partition is an append-only log; reopening it at the same offsets
+/// yields the same bytes. A reader over bounded partitions interleaved
+/// in the round-robin order can therefore restore a state saved by
+/// @ref Data_reader::save_state() exactly by fetching them again from
+/// their start offsets.
+class MLIO_API Kafka_partition final : public Data_store {
+public:
+    /// @param start_offset
+    ///     The offset of the first message to read, or @ref
+    ///     kafka_offset_beginning.
+    /// @param end_offset
+    ///     The offset right after the last message to read. If negative,
+    ///     the partition is followed until no new message arrives within
+    ///     the timeout of @p client; useful for continual training where
+    ///     each epoch picks up the messages produced meanwhile.
+    /// @param separator
+    ///     The bytes appended to each message payload, for instance a
+    ///     newline for CSV or JSON Lines messages without one.
+    explicit Kafka_partition(Intrusive_ptr<const Kafka_client> client,
+                             std::string topic,
+                             std::int32_t partition,
+                             std::int64_t start_offset = kafka_offset_beginning,
+                             std::int64_t end_offset = -1,
+                             std::string separator = {});
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final;
+
+    const std::string &id() const noexcept final
+    {
+        return id_;
+    }
+
+    const Intrusive_ptr<const Kafka_client> &client() const noexcept
+    {
+        return client_;
+    }
+
+    const std::string &topic() const noexcept
+    {
+        return topic_;
+    }
+
+    std::int32_t partition() const noexcept
+    {
+        return partition_;
+    }
+
+    std::int64_t start_offset() const noexcept
+    {
+        return start_offset_;
+    }
+
+    std::int64_t end_offset() const noexcept
+    {
+        return end_offset_;
+    }
+
+private:
+    Intrusive_ptr<const Kafka_client> client_;
+    std::string topic_;
+    std::int32_t partition_;
+    std::int64_t start_offset_;
+    std::int64_t end_offset_;
+    std::string separator_;
+    std::string id_;
+};
+
+/// Lists the partitions of a Kafka topic as data stores.
+///
+/// Each partition starts at the offset committed by the consumer group
+/// of @p client, or at its first retained message if there is none or
+/// the client has no group.
+///
+/// @param bounded
+///     A boolean value indicating whether the partitions end at their
+///     last message at the time of the call. If false, they are
+///     followed; see @ref Kafka_partition.
+MLIO_API
+std::vector<Intrusive_ptr<Data_store>>
+list_kafka_partitions(const Intrusive_ptr<const Kafka_client> &client,
+                      const std::string &topic,
+                      bool bounded = true,
+                      const std::string &separator = {});
+
+/// Commits the end offsets of the bounded Kafka partitions in @p
+/// dataset for the consumer group of their client, so that the next
+/// call to @ref list_kafka_partitions() picks up where they ended.
+/// Data stores other than bounded @ref Kafka_partition instances are
+/// ignored.
+MLIO_API
+void commit_kafka_partitions(const std::vector<Intrusive_ptr<Data_store>> &dataset);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/compression.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Holds the options for listing the objects of an object storage
+/// service such as Amazon S3, Google Cloud Storage, or Azure Blob
+/// Storage.
+struct MLIO_API Object_list_options {
+    using Predicate_callback = std::function<bool(const std::string &)>;
+
+    /// The pattern to match the objects against.
+    std::string_view pattern{};
+    /// The callback function for user-specific filtering.
+    const Predicate_callback *predicate{};
+    /// The Compression type of the objects. If set to @c infer, the
+    /// Compression will be inferred from the URIs.
+    Compression compression = Compression::infer;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
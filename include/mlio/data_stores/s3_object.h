@@ -15,13 +15,15 @@
 
 #pragma once
 
-#include <functional>
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "mlio/config.h"
 #include "mlio/data_stores/compression.h"
 #include "mlio/data_stores/data_store.h"
+#include "mlio/data_stores/object_list_options.h"
 #include "mlio/intrusive_ptr.h"
 #include "mlio/s3_client.h"
 #include "mlio/span.h"
@@ -38,10 +40,19 @@ public:
     /// @param compression
     ///     The Compression type of the S3 object. If set to @c infer,
     ///     the Compression will be inferred from the URI.
+    /// @param range_read_params
+    ///     The parameters for reading the S3 object with concurrent
+    ///     byte-range GET requests. If not specified, the parameters of
+    ///     @p client will be used.
+    /// @param size_hint
+    ///     The size of the S3 object, if already known; @ref
+    ///     list_s3_objects() sets it from the listing metadata.
     explicit S3_object(Intrusive_ptr<const S3_client> client,
                        std::string uri,
                        std::string version_id = {},
-                       Compression compression = Compression::infer);
+                       Compression compression = Compression::infer,
+                       std::optional<S3_range_read_params> range_read_params = {},
+                       std::optional<std::size_t> size_hint = {});
 
     Intrusive_ptr<Input_stream> open_read() const final;
 
@@ -49,25 +60,22 @@ public:
 
     const std::string &id() const final;
 
+    std::optional<std::size_t> size_hint() const noexcept final
+    {
+        return size_hint_;
+    }
+
 private:
     Intrusive_ptr<const S3_client> client_;
     std::string uri_;
     std::string version_id_;
     Compression compression_;
+    std::optional<S3_range_read_params> range_read_params_;
+    std::optional<std::size_t> size_hint_;
     mutable std::string id_{};
 };
 
-struct MLIO_API S3_object_list_options {
-    using Predicate_callback = std::function<bool(const std::string &)>;
-
-    /// The pattern to match the S3 objects against.
-    std::string_view pattern{};
-    /// The callback function for user-specific filtering.
-    const Predicate_callback *predicate{};
-    /// The Compression type of the S3 objects. If set to @c infer, the
-    /// Compression will be inferred from the URIs.
-    Compression compression = Compression::infer;
-};
+using S3_object_list_options = Object_list_options;
 
 /// Lists all S3 objects residing under the specified URIs.
 MLIO_API
@@ -17,6 +17,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -34,15 +35,26 @@ inline namespace abi_v1 {
 /// @{
 
 /// Represents an Amazon SageMaker pipe channel as a @ref Data_store.
+///
+/// Each call to @ref open_read() reads the next epoch of the channel.
+/// Multiple channels, for instance a training and an auxiliary channel,
+/// can be read concurrently by passing them to a reader along with
+/// @ref Data_reader_params::interleave_cycle_length.
 class MLIO_API Sagemaker_pipe final : public Data_store {
 public:
     explicit Sagemaker_pipe(std::string path,
                             std::chrono::seconds timeout = sagemaker_pipe_default_timeout,
                             std::optional<std::size_t> fifo_id = {},
-                            Compression compression = {});
+                            Compression compression = {},
+                            std::size_t pipe_buffer_size = sagemaker_pipe_default_buffer_size,
+                            bool open_next_fifo = true);
 
     Intrusive_ptr<Input_stream> open_read() const final;
 
+    /// Gets the I/O statistics accumulated over all the streams opened
+    /// from the channel.
+    Sagemaker_pipe_stats stats() const noexcept;
+
     std::string repr() const final;
 
     const std::string &id() const noexcept final
@@ -55,6 +67,9 @@ private:
     std::chrono::seconds timeout_;
     mutable std::optional<std::size_t> fifo_id_;
     Compression compression_;
+    std::size_t pipe_buffer_size_;
+    bool open_next_fifo_;
+    std::shared_ptr<detail::Sagemaker_pipe_counters> counters_;
 };
 
 /// @}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Shared_read_session;
+
+}  // namespace detail
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Holds the parameters for @ref Shared_read_group.
+struct MLIO_API Shared_read_params {
+    /// The number of readers that read the shared data stores
+    /// concurrently.
+    std::size_t num_consumers = 2;
+    /// The number of bytes to read from a data store at once.
+    std::size_t chunk_size = 0x10'0000;  // 1 MiB
+    /// The maximum number of bytes a data store buffers for the
+    /// consumers that lag behind. Once reached, the consumer that is
+    /// ahead waits for the others.
+    std::size_t max_buffer_size = 0x400'0000;  // 64 MiB
+    /// The maximum amount of time the consumer that is ahead waits for
+    /// a lagging one before it detaches it. A detached consumer opens
+    /// the data store on its own and continues reading where it left
+    /// off. If zero, consumers are never detached.
+    std::chrono::milliseconds detach_timeout{60'000};
+};
+
+/// Represents a group of readers that read the same dataset at the
+/// same time (e.g. a training and an evaluation reader) and share a
+/// single read of each data store. The data of a store is fetched and
+/// decompressed once and broadcast to all consumers of the group.
+///
+/// @remark
+///     The consumers should read the data stores in the same order;
+///     a consumer that falls behind by more than the buffer size holds
+///     back the others until it catches up or gets detached.
+class MLIO_API Shared_read_group : public Intrusive_ref_counter<Shared_read_group> {
+    friend class Shared_data_store;
+
+public:
+    explicit Shared_read_group(const Shared_read_params &params = {});
+
+    Shared_read_group(const Shared_read_group &) = delete;
+
+    Shared_read_group &operator=(const Shared_read_group &) = delete;
+
+    Shared_read_group(Shared_read_group &&) = delete;
+
+    Shared_read_group &operator=(Shared_read_group &&) = delete;
+
+    ~Shared_read_group();
+
+    /// Returns the data stores of @p dataset wrapped with @ref
+    /// Shared_data_store; the readers of the group should all be
+    /// constructed with the returned list.
+    std::vector<Intrusive_ptr<Data_store>>
+    share(const std::vector<Intrusive_ptr<Data_store>> &dataset);
+
+    const Shared_read_params &params() const noexcept
+    {
+        return params_;
+    }
+
+private:
+    MLIO_HIDDEN
+    std::pair<std::shared_ptr<detail::Shared_read_session>, std::size_t>
+    join_session(const Intrusive_ptr<Data_store> &store);
+
+    Shared_read_params params_;
+    std::mutex mutex_{};
+    std::unordered_map<std::string, std::shared_ptr<detail::Shared_read_session>> sessions_{};
+};
+
+/// Represents a @ref Data_store whose data is read once and shared by
+/// the consumers of a @ref Shared_read_group.
+class MLIO_API Shared_data_store final : public Data_store {
+public:
+    explicit Shared_data_store(Intrusive_ptr<Data_store> inner,
+                               Intrusive_ptr<Shared_read_group> group);
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final;
+
+    /// Returns the identifier of the underlying data store.
+    const std::string &id() const final;
+
+    std::optional<std::size_t> size_hint() const final;
+
+    std::optional<std::size_t> num_instances_hint() const final;
+
+    const Intrusive_ptr<Data_store> &inner() const noexcept
+    {
+        return inner_;
+    }
+
+private:
+    Intrusive_ptr<Data_store> inner_;
+    Intrusive_ptr<Shared_read_group> group_;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Specifies the algorithm of a @ref Checksum.
+enum class Checksum_algorithm {
+    /// The CRC32C (Castagnoli) checksum, as used by S3 and GCS. Computed
+    /// with the CRC32 instructions of the CPU when available.
+    crc32c,
+    sha256,
+};
+
+/// Holds the expected checksum of a data store.
+struct MLIO_API Checksum {
+    Checksum_algorithm algorithm{};
+    /// The checksum as a lowercase hexadecimal string; 8 digits for
+    /// CRC32C and 64 digits for SHA-256.
+    std::string value{};
+};
+
+/// Specifies how a checksum mismatch gets handled.
+enum class Checksum_mismatch_handling {
+    /// Throw a @ref Checksum_error.
+    error,
+    /// Log a warning naming the data store and carry on.
+    warn,
+};
+
+/// Represents a @ref Data_store whose data is checked against an
+/// expected checksum while it is read.
+///
+/// The checksum is computed on the chunks as they get read, in a task
+/// that runs in parallel with the decoding of the preceding chunks, so
+/// the verification does not lengthen the critical path of a reader.
+/// The mismatch is reported once the end of the stream is reached.
+///
+/// @remark
+///     The checksum covers the bytes returned by the underlying data
+///     store; for a compressed data store these are the decompressed
+///     bytes. A stream that is not read to its end, or that is seeked
+///     to a position other than its beginning, is not verified.
+class MLIO_API Verified_data_store final : public Data_store {
+public:
+    explicit Verified_data_store(
+        Intrusive_ptr<Data_store> inner,
+        Checksum checksum,
+        Checksum_mismatch_handling handling = Checksum_mismatch_handling::error);
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final;
+
+    /// Returns the identifier of the underlying data store.
+    const std::string &id() const final;
+
+    std::optional<std::size_t> size_hint() const final;
+
+    std::optional<std::size_t> num_instances_hint() const final;
+
+    const Intrusive_ptr<Data_store> &inner() const noexcept
+    {
+        return inner_;
+    }
+
+    const Checksum &checksum() const noexcept
+    {
+        return checksum_;
+    }
+
+private:
+    Intrusive_ptr<Data_store> inner_;
+    Checksum checksum_;
+    Checksum_mismatch_handling handling_;
+};
+
+/// Reads the specified data store to its end and returns its checksum.
+MLIO_API
+Checksum compute_checksum(const Data_store &store, Checksum_algorithm algorithm);
+
+/// Writes the checksums of the specified data stores to a manifest file
+/// that can be read back by calling @ref read_checksum_manifest(). The
+/// data stores are read in parallel.
+///
+/// A checksum manifest is a UTF-8 text file in the format of the
+/// sha256sum tool; each line holds a checksum in hexadecimal, two
+/// spaces, and the identifier of a data store.
+MLIO_API
+void write_checksum_manifest(const std::string &path,
+                             stdx::span<const Intrusive_ptr<Data_store>> stores,
+                             Checksum_algorithm algorithm = Checksum_algorithm::crc32c);
+
+/// Reads the checksums listed in the specified manifest file, keyed by
+/// the identifiers of their data stores. The algorithm of a checksum is
+/// inferred from its number of digits.
+MLIO_API
+std::unordered_map<std::string, Checksum> read_checksum_manifest(const std::string &path);
+
+/// Returns the data stores of @p dataset with the ones listed in @p
+/// checksums wrapped with @ref Verified_data_store; the others are
+/// returned as is.
+MLIO_API
+std::vector<Intrusive_ptr<Data_store>>
+verify_checksums(const std::vector<Intrusive_ptr<Data_store>> &dataset,
+                 const std::unordered_map<std::string, Checksum> &checksums,
+                 Checksum_mismatch_handling handling = Checksum_mismatch_handling::error);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
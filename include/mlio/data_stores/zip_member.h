@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Zip_entry;
+struct Zip_member_access;
+
+}  // namespace detail
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Represents a file member of a zip archive as a @ref Data_store.
+///
+/// The archive is memory-mapped and the member is inflated in full when
+/// the data store is opened. Since each member is a separate data store,
+/// the members of an archive can be shuffled and read in parallel like
+/// any other data store.
+class MLIO_API Zip_member final : public Data_store {
+    friend struct detail::Zip_member_access;
+
+public:
+    /// @param archive_path
+    ///     The path of the zip archive.
+    ///
+    /// @param name
+    ///     The name of the member as recorded in the archive.
+    explicit Zip_member(std::string archive_path, const std::string &name);
+
+    ~Zip_member() final;
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final;
+
+    /// Returns the path of the archive followed by '!/' and the name of
+    /// the member.
+    const std::string &id() const noexcept final
+    {
+        return id_;
+    }
+
+    std::optional<std::size_t> size_hint() const noexcept final;
+
+    const std::string &archive_path() const noexcept
+    {
+        return archive_path_;
+    }
+
+    const std::string &name() const noexcept;
+
+private:
+    explicit Zip_member(std::string archive_path, detail::Zip_entry &&entry);
+
+    std::string archive_path_;
+    std::unique_ptr<const detail::Zip_entry> entry_;
+    std::string id_;
+};
+
+/// Lists the file members of the specified zip archive in the order of
+/// its central directory. Only the central directory is read; the
+/// members are inflated when they are opened.
+MLIO_API
+std::vector<Intrusive_ptr<Data_store>> list_zip_members(const std::string &archive_path);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
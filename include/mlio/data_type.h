@@ -32,6 +32,19 @@ inline namespace abi_v1 {
 /// @{
 
 /// Specifies the data type of a @ref Tensor Instance.
+///
+/// @remark
+///     The half-precision types, @ref float16 and @ref bfloat16, are
+///     stored as their raw bits in a @c std::uint16_t. @ref bfloat16
+///     and the types that follow it are appended so that the values of
+///     the existing data types, which are persisted in schema and
+///     columnar files, do not change.
+///
+/// @remark
+///     A @ref timestamp holds the number of nanoseconds and a @ref date
+///     the number of milliseconds since the Unix epoch in UTC; they have
+///     the layouts of the NumPy datetime64[ns] and datetime64[ms] types
+///     and of the Arrow timestamp[ns] and date64 types.
 enum class Data_type {
     size,
     float16,
@@ -45,7 +58,10 @@ enum class Data_type {
     uint16,
     uint32,
     uint64,
-    string
+    string,
+    bfloat16,
+    timestamp,
+    date
 };
 
 // clang-format off
@@ -118,6 +134,21 @@ struct Data_type_traits<Data_type::string>  {
     using type = std::string;
 };
 
+template<>
+struct Data_type_traits<Data_type::bfloat16> {
+    using type = std::uint16_t;
+};
+
+template<>
+struct Data_type_traits<Data_type::timestamp> {
+    using type = std::int64_t;
+};
+
+template<>
+struct Data_type_traits<Data_type::date> {
+    using type = std::int64_t;
+};
+
 template<Data_type dt>
 using data_type_t = typename Data_type_traits<dt>::type;
 
@@ -152,6 +183,12 @@ dispatch(Data_type dt, Args &&...args)
         return Op<Data_type::uint64> ()(std::forward<Args>(args)...);
     case Data_type::string:
         return Op<Data_type::string> ()(std::forward<Args>(args)...);
+    case Data_type::bfloat16:
+        return Op<Data_type::bfloat16>()(std::forward<Args>(args)...);
+    case Data_type::timestamp:
+        return Op<Data_type::timestamp>()(std::forward<Args>(args)...);
+    case Data_type::date:
+        return Op<Data_type::date>   ()(std::forward<Args>(args)...);
     }
 
     throw std::invalid_argument{"The specified data type is not valid."};
@@ -209,6 +246,15 @@ inline std::ostream &operator<<(std::ostream &s, Data_type dt)
     case Data_type::string:
         s << "string";
         break;
+    case Data_type::bfloat16:
+        s << "bfloat16";
+        break;
+    case Data_type::timestamp:
+        s << "timestamp";
+        break;
+    case Data_type::date:
+        s << "date";
+        break;
     }
     return s;
 }
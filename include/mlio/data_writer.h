@@ -0,0 +1,64 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_writers Data Writers
+/// @{
+
+/// Represents an interface for writing @ref Example "examples" to a
+/// dataset.
+class MLIO_API Data_writer : public Intrusive_ref_counter<Data_writer> {
+public:
+    Data_writer() noexcept = default;
+
+    Data_writer(const Data_writer &) = delete;
+
+    Data_writer &operator=(const Data_writer &) = delete;
+
+    Data_writer(Data_writer &&) = delete;
+
+    Data_writer &operator=(Data_writer &&) = delete;
+
+    virtual ~Data_writer();
+
+    /// Writes the instances of the specified @ref Example. All examples
+    /// written by a writer must have the same @ref Schema, except for
+    /// the size of the batch dimension.
+    ///
+    /// @remark
+    ///     The padded instances of the @ref Example are not written.
+    virtual void write_example(const Example &example) = 0;
+
+    /// Flushes the buffered data and finalizes the dataset. No more
+    /// examples can be written afterwards.
+    ///
+    /// @remark
+    ///     If the writer is destructed without being closed, the partial
+    ///     dataset is discarded.
+    virtual void close() = 0;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
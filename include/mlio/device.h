@@ -36,6 +36,9 @@ public:
     /// A convenience function for the CPU Device kind.
     static Device_kind cpu() noexcept;
 
+    /// A convenience function for the CUDA Device kind.
+    static Device_kind cuda() noexcept;
+
     /// @param name
     ///     The name can be any arbitrary string, but it must be unique
     ///     among Device kinds.
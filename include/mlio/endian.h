@@ -15,9 +15,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "mlio/config.h"
+#include "mlio/span.h"
 
 #define MLIO_BYTE_ORDER_LITTLE __ORDER_LITTLE_ENDIAN__
 #define MLIO_BYTE_ORDER_BIG __ORDER_BIG_ENDIAN__
@@ -45,6 +48,19 @@ inline std::uint64_t reverse_bytes(std::uint64_t value) noexcept
     return __builtin_bswap64(value);
 }
 
+/// Copies the elements of @p source to @p destination while reversing
+/// the byte order of each element. @p element_size must be 2, 4, or 8.
+/// The spans neither need to be aligned nor to be distinct, but if they
+/// overlap they must start at the same address.
+///
+/// @remark
+///     Uses 16-byte shuffles (pshufb on SSSE3, vrev on NEON) if the
+///     library was built for a target that supports them.
+MLIO_API
+void reverse_bytes(Memory_span source,
+                   Mutable_memory_span destination,
+                   std::size_t element_size) noexcept;
+
 }  // namespace detail
 
 #if MLIO_BYTE_ORDER_HOST == MLIO_BYTE_ORDER_LITTLE
@@ -95,5 +111,37 @@ enum class Byte_order {
     host = MLIO_BYTE_ORDER_HOST
 };
 
+/// Copies the elements of @p source, stored in the specified byte
+/// order, to @p destination in the host byte order. The size of @p
+/// source must equal the size of @p destination in bytes.
+template<Byte_order order, typename T>
+MLIO_API
+inline void to_host_order(Memory_span source, stdx::span<T> destination) noexcept
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                  "The size of T must be 1, 2, 4, or 8.");
+
+    if constexpr (order == Byte_order::host || sizeof(T) == 1) {
+        std::memcpy(destination.data(), source.data(), source.size());
+    }
+    else {
+        detail::reverse_bytes(source, as_span<std::byte>(destination), sizeof(T));
+    }
+}
+
+template<typename T>
+MLIO_API
+inline void little_to_host_order(Memory_span source, stdx::span<T> destination) noexcept
+{
+    to_host_order<Byte_order::little>(source, destination);
+}
+
+template<typename T>
+MLIO_API
+inline void big_to_host_order(Memory_span source, stdx::span<T> destination) noexcept
+{
+    to_host_order<Byte_order::big>(source, destination);
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
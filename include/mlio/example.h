@@ -15,9 +15,15 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 #include "mlio/config.h"
@@ -32,6 +38,83 @@ inline namespace abi_v1 {
 /// @addtogroup data_readers Data Readers
 /// @{
 
+/// Represents the source of the features of an @ref Example that are
+/// materialized on first access; e.g. the tokenized rows of a batch
+/// read by a @ref Csv_reader with @ref Csv_params::lazy_decode.
+class MLIO_API Feature_source : public Intrusive_ref_counter<Feature_source> {
+public:
+    Feature_source() noexcept = default;
+
+    Feature_source(const Feature_source &) = delete;
+
+    Feature_source &operator=(const Feature_source &) = delete;
+
+    Feature_source(Feature_source &&) = delete;
+
+    Feature_source &operator=(Feature_source &&) = delete;
+
+    virtual ~Feature_source();
+
+    /// Materializes the feature at the specified index of the schema of
+    /// the Example. Might be called concurrently for different indices,
+    /// but only once for each index unless it throws.
+    virtual Intrusive_ptr<Tensor> materialize(std::size_t index) const = 0;
+
+    /// Returns the approximate memory footprint of the source in bytes.
+    virtual std::size_t size_bytes() const noexcept = 0;
+};
+
+/// Frees the features of dropped @ref Example "examples" on a
+/// background thread, so that the thread releasing the last reference
+/// to an Example does not pay for the deallocation of its tensors. See
+/// @ref Data_reader_params::deferred_reclamation.
+class MLIO_API Example_reclaimer final : public Intrusive_ref_counter<Example_reclaimer> {
+public:
+    /// @param max_pending
+    ///     The maximum number of examples waiting to be freed. The
+    ///     examples dropped while the reclaimer lags behind are freed
+    ///     inline.
+    explicit Example_reclaimer(std::size_t max_pending = 64) noexcept;
+
+    Example_reclaimer(const Example_reclaimer &) = delete;
+
+    Example_reclaimer &operator=(const Example_reclaimer &) = delete;
+
+    Example_reclaimer(Example_reclaimer &&) = delete;
+
+    Example_reclaimer &operator=(Example_reclaimer &&) = delete;
+
+    /// Frees the pending examples and stops the background thread.
+    ~Example_reclaimer();
+
+    /// Takes over the features of an Example that is being destroyed.
+    /// If the queue is full or the background thread cannot be started,
+    /// they are freed when the call returns.
+    void defer(std::vector<Intrusive_ptr<Tensor>> &&features,
+               Intrusive_ptr<const Feature_source> &&source) noexcept;
+
+    /// Gets the number of examples whose features were freed on the
+    /// background thread.
+    std::size_t num_reclaimed() const;
+
+private:
+    struct Item {
+        std::vector<Intrusive_ptr<Tensor>> features;
+        Intrusive_ptr<const Feature_source> source;
+    };
+
+    MLIO_HIDDEN
+    void run() noexcept;
+
+    std::size_t max_pending_;
+    mutable std::mutex mutex_{};
+    std::condition_variable condition_{};
+    std::deque<Item> items_{};
+    std::size_t num_reclaimed_{};
+    bool stopped_{};
+    std::thread thread_{};
+};
+
 /// Represents an Example that holds a @ref Schema and a set of
 /// features.
 ///
@@ -49,12 +132,33 @@ public:
     explicit Example(Intrusive_ptr<const Schema> schema,
                      std::vector<Intrusive_ptr<Tensor>> &&features);
 
+    /// @param schema
+    ///     The Schema that describes the features contained in the
+    ///     Example.
+    /// @param source
+    ///     The source from which each feature is materialized the first
+    ///     time it is accessed. The materialization is thread-safe.
+    explicit Example(Intrusive_ptr<const Schema> schema, Intrusive_ptr<const Feature_source> source);
+
+    Example(const Example &) = delete;
+
+    Example &operator=(const Example &) = delete;
+
+    Example(Example &&) = delete;
+
+    Example &operator=(Example &&) = delete;
+
+    ~Example();
+
+    /// Returns the feature at the specified index of the schema.
+    Intrusive_ptr<Tensor> feature(std::size_t index) const;
+
     /// Finds the feature that has the specified name.
     ///
     /// @return
     ///     The @ref Tensor Instance if the feature is found in the
     ///     Example; otherwise an @c std::nullptr.
-    Intrusive_ptr<Tensor> find_feature(const std::string &name) const noexcept;
+    Intrusive_ptr<Tensor> find_feature(std::string_view name) const;
 
     std::string repr() const;
 
@@ -63,9 +167,24 @@ public:
         return *schema_;
     }
 
-    const std::vector<Intrusive_ptr<Tensor>> &features() const noexcept
+    /// @remark
+    ///     Materializes the features that have not been accessed yet if
+    ///     the Example has a @ref Feature_source.
+    const std::vector<Intrusive_ptr<Tensor>> &features() const;
+
+    /// Returns the source of the lazily materialized features of the
+    /// Example, or a null pointer if its features are materialized
+    /// upfront.
+    const Intrusive_ptr<const Feature_source> &feature_source() const noexcept
+    {
+        return source_;
+    }
+
+    /// Makes the Example hand its features over to the specified
+    /// reclaimer instead of freeing them when it is destroyed.
+    void defer_reclamation(Intrusive_ptr<Example_reclaimer> reclaimer) noexcept
     {
-        return features_;
+        reclaimer_ = std::move(reclaimer);
     }
 
     /// @remark
@@ -78,7 +197,10 @@ public:
 
 private:
     Intrusive_ptr<const Schema> schema_;
-    std::vector<Intrusive_ptr<Tensor>> features_;
+    mutable std::vector<Intrusive_ptr<Tensor>> features_;
+    Intrusive_ptr<const Feature_source> source_{};
+    std::unique_ptr<std::once_flag[]> materialized_{};
+    Intrusive_ptr<Example_reclaimer> reclaimer_{};
 };
 
 MLIO_API
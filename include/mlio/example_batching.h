@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup tensors Tensors
+/// @{
+
+/// Returns an @ref Example that holds the instances in the range [@p
+/// begin, @p end) of the batch dimension of @p example.
+///
+/// The dense features and the data and index arrays of the CSR features
+/// of the returned Example are views that share the memory of the
+/// features of @p example; only the index pointer arrays of the CSR
+/// features and the COO features are copied.
+///
+/// @remark
+///     All features must reside in the host memory and must have the
+///     same batch dimension as their first dimension.
+MLIO_API
+Intrusive_ptr<Example> slice_example(const Example &example, std::size_t begin, std::size_t end);
+
+/// Returns an @ref Example whose features are the features of @p
+/// examples concatenated along the batch dimension.
+///
+/// Each feature is copied with a single memcpy per source Example into
+/// a buffer taken from @p pool, or into a newly allocated buffer if @p
+/// pool is null.
+///
+/// @remark
+///     The examples must have the same schema except for the batch
+///     dimension, their dense features must be in row-major order, and
+///     only the last one can have a padding.
+MLIO_API
+Intrusive_ptr<Example> concat_examples(stdx::span<const Intrusive_ptr<Example>> examples,
+                                       Tensor_pool *pool = nullptr);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
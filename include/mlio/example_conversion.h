@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/data_type.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup tensors Tensors
+/// @{
+
+/// Specifies how @ref convert_example() converts the features of an
+/// @ref Example before they are handed to a framework.
+struct MLIO_API Example_conversion_params {
+    /// The names of the features to return, in order. If empty, all
+    /// features are returned.
+    std::vector<std::string> features{};
+    /// The data types to cast the values of the features to, keyed by
+    /// feature name.
+    std::map<std::string, Data_type, std::less<>> data_types{};
+    /// The data type to cast the values of the numeric features that are
+    /// not listed in @ref data_types to. If not specified, they keep
+    /// their data type.
+    std::optional<Data_type> default_data_type{};
+    /// A boolean value indicating whether to lay out the dense features
+    /// in column-major order, e.g. for consumers that read a batch one
+    /// column at a time. The shapes of the features do not change.
+    bool column_major = false;
+    /// The format to convert the sparse features to. If not specified,
+    /// they keep their format. Only two-dimensional features can be
+    /// converted to CSR.
+    std::optional<Sparse_tensor_format> sparse_tensor_format{};
+};
+
+/// Returns an @ref Example whose features are the features of @p
+/// example converted as specified by @p params.
+///
+/// The features are converted in parallel by a @ref Tensor_visitor,
+/// and the values of large features are cast in parallel chunks. The
+/// features that need no conversion are shared with @p example instead
+/// of being copied.
+///
+/// @remark
+///     All features must reside in the host memory. The string features
+///     can be returned, but cannot be cast.
+MLIO_API
+Intrusive_ptr<Example>
+convert_example(const Example &example, const Example_conversion_params &params);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
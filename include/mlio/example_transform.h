@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents a per-example transform (e.g. a normalization or a
+/// feature cross) that a @ref Parallel_data_reader runs on its thread
+/// pool right after decoding. See @ref
+/// Data_reader_params::example_transforms.
+class MLIO_API Example_transform : public Intrusive_ref_counter<Example_transform> {
+public:
+    Example_transform() noexcept = default;
+
+    Example_transform(const Example_transform &) = delete;
+
+    Example_transform &operator=(const Example_transform &) = delete;
+
+    Example_transform(Example_transform &&) = delete;
+
+    Example_transform &operator=(Example_transform &&) = delete;
+
+    virtual ~Example_transform();
+
+    /// Transforms the specified @ref Example; the returned example can
+    /// be the same one modified in-place, or null to drop it.
+    ///
+    /// @remark
+    ///     The examples are passed in the order they finish decoding,
+    ///     which is not necessarily the order they are read in; the
+    ///     reader restores the order afterwards unless @ref
+    ///     Data_reader_params::deterministic is false.
+    virtual Intrusive_ptr<Example> transform(Intrusive_ptr<Example> example) = 0;
+
+    /// Returns the @ref Schema of the examples returned by @ref
+    /// transform() given the schema of the examples passed to it. The
+    /// default implementation returns @p schema as is.
+    virtual Intrusive_ptr<const Schema> transform_schema(Intrusive_ptr<const Schema> schema);
+
+    /// Returns the maximum number of concurrent calls to @ref
+    /// transform(), or zero if it is unlimited, which is the default.
+    virtual std::size_t max_concurrency() const noexcept;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
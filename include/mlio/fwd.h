@@ -19,34 +19,63 @@ namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
+class Bzip2_inflater;
 class Chunk_reader;
-class Coo_tensor_builder;
+class Column_partials;
+struct Column_values;
+class Cuda_transfer;
+class Decode_warning_log;
 class Iconv_desc;
+class Inflater;
 class Instance_batch_reader;
 class Instance_reader;
+class Io_uring_file_reader;
+class Isal_inflater;
+class Lz4_inflater;
+class Reader_task_arena;
+class Sparse_tensor_builder;
+class Store_metrics;
+class String_dictionary;
+class Unicode_transcoder;
+class Wordpiece_tokenizer;
 class Zlib_inflater;
+class Zstd_inflater;
 
 }  // namespace detail
 
 class Attribute;
+class Column_statistics_collector;
 class Coo_tensor;
 class Csr_tensor;
+class String_tensor;
 class Data_store;
 class Dense_tensor;
 class Example;
+class Example_reclaimer;
+class Example_transform;
 class Input_stream;
 class Instance;
 class Instance_batch;
+class Memory_block;
 class Memory_slice;
 class Mutable_memory_block;
+class Object_store_client;
 class Record;
 class Record_reader;
+class S3_client;
+class Schema;
 class Tensor;
+class Tensor_pool;
 class Tensor_visitor;
 class Text_encoding;
+class Thread_pool;
 
 struct Csv_params;
 struct Data_reader_params;
+struct Data_reader_state;
+struct Range_read_params;
+struct Text_line_params;
+struct Wordpiece_params;
 
 }  // namespace abi_v1
 }  // namespace mlio
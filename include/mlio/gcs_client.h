@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/object_store_client.h"
+#include "mlio/s3_object_cache.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Gcs_native_client;
+
+}  // namespace detail
+
+/// Represents a client to access Google Cloud Storage.
+///
+/// The objects are addressed by URIs of the form "gs://bucket/key" and
+/// their versions by their generation numbers.
+class MLIO_API Gcs_client final : public Object_store_client {
+public:
+    /// @param object_cache
+    ///     The local cache through which the objects opened with this
+    ///     client are read. If null, the objects are always read from
+    ///     Google Cloud Storage.
+    explicit Gcs_client(std::unique_ptr<detail::Gcs_native_client> native_client,
+                        const Range_read_params &range_read_params = {},
+                        Intrusive_ptr<S3_object_cache> object_cache = {}) noexcept;
+
+    Gcs_client(const Gcs_client &) = delete;
+
+    Gcs_client &operator=(const Gcs_client &) = delete;
+
+    Gcs_client(Gcs_client &&) = delete;
+
+    Gcs_client &operator=(Gcs_client &&) = delete;
+
+    ~Gcs_client() final;
+
+    void list_objects(std::string_view bucket,
+                      std::string_view prefix,
+                      const List_callback &callback) const final;
+
+    std::size_t read_object(std::string_view bucket,
+                            std::string_view key,
+                            std::string_view version_id,
+                            std::size_t offset,
+                            Mutable_memory_span destination) const final;
+
+    Object_metadata read_object_metadata(std::string_view bucket,
+                                         std::string_view key,
+                                         std::string_view version_id) const final;
+
+    std::string_view uri_scheme() const noexcept final
+    {
+        return "gs";
+    }
+
+private:
+    std::unique_ptr<detail::Gcs_native_client> native_client_;
+};
+
+struct MLIO_API Gcs_client_options {
+    /// The path to the JSON key file of a service account. If empty,
+    /// the Application Default Credentials are used.
+    std::string_view credentials_file{};
+    /// A boolean value indicating whether to send the requests without
+    /// credentials; for instance to read public buckets or to access an
+    /// emulator.
+    bool anonymous{};
+    Range_read_params range_read_params{};
+    Intrusive_ptr<S3_object_cache> object_cache{};
+    /// The maximum number of connections kept in the connection pool
+    /// of the client. If zero, the default of the Google Cloud C++
+    /// client library is used.
+    std::size_t max_connections{};
+    /// The time after which a transfer that makes no progress is
+    /// aborted and retried. If zero, the default of the Google Cloud
+    /// C++ client library is used.
+    std::chrono::milliseconds stall_timeout{};
+    /// The maximum number of attempts per request including the first
+    /// one. If zero, the default of the Google Cloud C++ client library
+    /// is used.
+    std::size_t max_attempts{};
+    /// The endpoint to use instead of the Google Cloud Storage endpoint;
+    /// for instance an emulator.
+    std::string_view endpoint_override{};
+};
+
+MLIO_API
+Intrusive_ptr<Gcs_client> make_gcs_client(const Gcs_client_options &opts = {});
+
+}  // namespace abi_v1
+}  // namespace mlio
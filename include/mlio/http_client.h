@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/object_store_client.h"
+#include "mlio/s3_object_cache.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Http_connection_pool;
+
+}  // namespace detail
+
+/// Represents a client to read objects from an HTTP server with
+/// byte-range GET requests.
+///
+/// The objects are addressed by URIs of the form "https://host/path".
+/// The host takes the place of the bucket and the path, including the
+/// query string, the place of the key. The version of an object is its
+/// ETag; if specified, every request is made conditional on it so that
+/// an object that changes while being read is not silently mixed up.
+class MLIO_API Http_client final : public Object_store_client {
+public:
+    /// @param object_cache
+    ///     The local cache through which the objects opened with this
+    ///     client are read. If null, the objects are always read from
+    ///     the server.
+    explicit Http_client(std::unique_ptr<detail::Http_connection_pool> pool,
+                         const Range_read_params &range_read_params = {},
+                         Intrusive_ptr<S3_object_cache> object_cache = {}) noexcept;
+
+    Http_client(const Http_client &) = delete;
+
+    Http_client &operator=(const Http_client &) = delete;
+
+    Http_client(Http_client &&) = delete;
+
+    Http_client &operator=(Http_client &&) = delete;
+
+    ~Http_client() final;
+
+    /// HTTP has no notion of listing; always throws Not_supported_error.
+    void list_objects(std::string_view bucket,
+                      std::string_view prefix,
+                      const List_callback &callback) const final;
+
+    std::size_t read_object(std::string_view bucket,
+                            std::string_view key,
+                            std::string_view version_id,
+                            std::size_t offset,
+                            Mutable_memory_span destination) const final;
+
+    Object_metadata read_object_metadata(std::string_view bucket,
+                                         std::string_view key,
+                                         std::string_view version_id) const final;
+
+    std::string_view uri_scheme() const noexcept final;
+
+private:
+    std::unique_ptr<detail::Http_connection_pool> pool_;
+};
+
+struct MLIO_API Http_client_options {
+    /// A boolean value indicating whether the objects are addressed by
+    /// "https://" or by "http://" URIs.
+    bool use_https = true;
+    /// The headers to send with each request such as
+    /// "Authorization: Bearer <token>".
+    std::vector<std::string> headers{};
+    Range_read_params range_read_params{};
+    Intrusive_ptr<S3_object_cache> object_cache{};
+    /// The maximum number of keep-alive connections. Each concurrent
+    /// request holds one connection, so it should be at least the
+    /// number of parallel ranges of all objects read at the same time.
+    /// Requests beyond that open short-lived connections.
+    std::size_t max_connections = 64;
+    /// The timeout for establishing a connection. If zero, the default
+    /// of libcurl is used.
+    std::chrono::milliseconds connect_timeout{};
+    /// The time after which a transfer that makes no progress is
+    /// aborted and retried. If zero, transfers are never aborted.
+    std::chrono::milliseconds stall_timeout{};
+    /// The maximum number of attempts per request including the first
+    /// one. Connection errors, timeouts, and the status codes 408, 429,
+    /// and 5xx are retried with exponential backoff.
+    std::size_t max_attempts = 3;
+    /// A boolean value indicating whether to verify the certificate of
+    /// the server.
+    bool verify_peer = true;
+};
+
+MLIO_API
+Intrusive_ptr<Http_client> make_http_client(const Http_client_options &opts = {});
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,9 +16,16 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <vector>
 
 #include "mlio/config.h"
+#include "mlio/data_type.h"
 #include "mlio/parallel_data_reader.h"
 #include "mlio/span.h"
 
@@ -30,14 +37,29 @@ class Mat;
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace detail {
+
+class Image_transformer;
+
+}  // namespace detail
 
 /// @addtogroup data_readers Data Readers
 /// @{
 
 /// Specifies the frame of an image.
 enum class Image_frame {
-    none,     ///< The image is contained in a regular File.
-    recordio  ///< The image is contained in an MXNet RecordIO Record.
+    none,      ///< The image is contained in a regular File.
+    recordio,  ///< The image is contained in an MXNet RecordIO Record.
+    /// The images are the members of a tar archive, such as a shard
+    /// written by @ref write_tar_shard() or a WebDataset shard. Members
+    /// whose extension is not that of a common image format are skipped.
+    tar
+};
+
+/// Specifies the memory layout of the images in the output tensor.
+enum class Image_layout {
+    nhwc,  ///< (batch, height, width, channels)
+    nchw   ///< (batch, channels, height, width)
 };
 
 struct MLIO_API Image_reader_params final {
@@ -51,6 +73,57 @@ struct MLIO_API Image_reader_params final {
     std::vector<std::size_t> image_dimensions{};
     /// A boolean value indicating whether to convert from BGR to RGB.
     bool to_rgb = false;
+    /// A boolean value indicating whether to crop a random area of the
+    /// image and scale it to the output dimensions instead of cropping
+    /// the center of the image.
+    bool random_resized_crop = false;
+    /// The lower and upper bounds of the area of the random crop as a
+    /// fraction of the area of the image.
+    std::array<float, 2> random_crop_scale{0.08F, 1.0F};
+    /// The lower and upper bounds of the aspect ratio (width / height)
+    /// of the random crop.
+    std::array<float, 2> random_crop_ratio{3.0F / 4.0F, 4.0F / 3.0F};
+    /// A boolean value indicating whether to flip the images
+    /// horizontally with a probability of 0.5.
+    bool random_horizontal_flip = false;
+    /// The per-channel mean, in pixel values, that will be subtracted
+    /// from the images. The channels are in output order.
+    std::vector<float> mean{};
+    /// The per-channel standard deviation, in pixel values, that the
+    /// images will be divided by after the mean subtraction.
+    std::vector<float> stddev{};
+    /// See @ref Image_layout.
+    Image_layout image_layout = Image_layout::nhwc;
+    /// The data type of the output tensor; must be uint8, float16, or
+    /// float32. Normalizing the images requires a floating-point type.
+    Data_type data_type = Data_type::uint8;
+    /// The seed that will be used for the random augmentations. If not
+    /// specified, a random seed will be generated internally.
+    std::optional<std::uint_fast64_t> augmentation_seed{};
+    /// A boolean value indicating whether to output the images in their
+    /// decoded (and optionally resized) dimensions instead of cropping
+    /// them. Only the number of channels is read from @ref
+    /// image_dimensions. The examples then have a "value" feature that
+    /// holds the images back-to-back in HWC layout, and a "shape"
+    /// feature of shape (batch, 3) that holds the height, width, and
+    /// number of channels of each image. Cannot be combined with the
+    /// random resized crop or with any option that requires the images
+    /// to be transformed.
+    bool variable_size = false;
+    /// If greater than zero, groups images with similar aspect ratios
+    /// into the same batch, looking ahead at most the specified number
+    /// of images. Must be greater than or equal to the batch size.
+    std::size_t bucketing_window{};
+    /// The boundaries, in ascending order, of the aspect ratio (width /
+    /// height) buckets used by @ref bucketing_window.
+    std::vector<float> aspect_ratio_boundaries{0.5F, 0.75F, 1.0F, 4.0F / 3.0F, 2.0F};
+    /// The number of threads OpenCV uses internally for operations such
+    /// as resizing. The images of a batch are already decoded in
+    /// parallel, so additional OpenCV threads only oversubscribe the
+    /// CPU. Note that the setting is process-wide; it is applied when
+    /// the reader gets constructed and is left unchanged if not
+    /// specified.
+    std::optional<int> opencv_num_threads = 1;
 };
 
 /// Represents a @ref Data_reader for reading image datasets.
@@ -68,7 +141,13 @@ public:
 
     ~Image_reader() final;
 
+    void reset() noexcept final;
+
 private:
+    // The reusable buffers and decoder contexts used to decode a single
+    // image.
+    struct Decode_scratch;
+
     MLIO_HIDDEN
     Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
 
@@ -78,20 +157,50 @@ private:
     MLIO_HIDDEN
     Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
 
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode_variable_size(const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    bool should_skip_example(const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    void warn_if_padded(const Instance_batch &batch, std::size_t num_instances_read) const;
+
     MLIO_HIDDEN
     Intrusive_ptr<Dense_tensor> make_tensor(std::size_t batch_size, std::size_t batch_stride) const;
 
     MLIO_HIDDEN
-    bool decode_core(stdx::span<std::uint8_t> out, const Instance &instance) const;
+    bool decode_core(Mutable_memory_span out,
+                     const Instance &instance,
+                     std::size_t seed,
+                     Decode_scratch &scratch) const;
+
+    MLIO_HIDDEN
+    std::unique_ptr<Decode_scratch> acquire_scratch() const;
+
+    MLIO_HIDDEN
+    void release_scratch(std::unique_ptr<Decode_scratch> scratch) const noexcept;
+
+    MLIO_HIDDEN
+    Memory_slice get_image_buffer(const Instance &instance) const;
+
+    MLIO_HIDDEN
+    bool load_image(const Instance &instance,
+                    cv::Mat &img,
+                    bool &is_rgb,
+                    Decode_scratch &scratch) const;
 
     MLIO_HIDDEN
     cv::Mat decode_image(const cv::Mat &buf, int mode, const Instance &instance) const;
 
     MLIO_HIDDEN
-    bool resize(cv::Mat &src, cv::Mat &dst, const Instance &instance) const;
+    bool decode_jpeg(Memory_span bits, cv::Mat &img, Decode_scratch &scratch) const;
+
+    MLIO_HIDDEN
+    bool decode_webp(Memory_span bits, cv::Mat &img) const;
 
     MLIO_HIDDEN
-    bool crop(cv::Mat &src, cv::Mat &dst, const Instance &instance) const;
+    std::size_t get_aspect_ratio_bucket(const Instance &instance) const;
 
     static constexpr std::size_t image_dimensions_size_ = 3;
     static constexpr std::size_t recordio_image_header_offset_ = 24;
@@ -99,6 +208,11 @@ private:
     Image_reader_params params_;
     std::array<int, image_dimensions_size_> img_dims_{};
     bool error_bad_example_;
+    std::unique_ptr<detail::Image_transformer> transformer_;
+    std::size_t augmentation_seed_{};
+    std::size_t epoch_{};
+    mutable std::mutex scratches_mutex_{};
+    mutable std::vector<std::unique_ptr<Decode_scratch>> scratches_{};
 };
 
 /// @}
@@ -31,6 +31,8 @@ inline namespace abi_v1 {
 
 /// Represents a data Instance read from a dataset.
 class MLIO_API Instance {
+    friend class Instance_batch;
+
 public:
     /// @param store
     ///     The data store that represents the Instance.
@@ -16,11 +16,18 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
 #include "mlio/config.h"
+#include "mlio/fwd.h"
 #include "mlio/instance.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -29,6 +36,13 @@ inline namespace abi_v1 {
 /// @{
 
 /// Represents a batch of @ref Instance "data instances".
+///
+/// The instances are stored as a structure of arrays: a reference to
+/// each distinct memory block the instances were read from, and the
+/// offset, size, and data store of each instance. Decoders that access
+/// the instances through @ref bits() and @ref data_store() therefore
+/// do not touch any reference counts. The list of @ref Instance objects
+/// returned by @ref instances() is constructed on first use.
 class MLIO_API Instance_batch {
 public:
     /// @param index
@@ -43,20 +57,57 @@ public:
     ///     In case this is the last batch of the dataset and the value
     ///     of the @ref last_batch_handling is @c pad, the size can be
     ///     greater than the number of data instances.
-    explicit Instance_batch(std::size_t index,
-                            std::vector<Instance> &&instances,
-                            std::size_t size) noexcept
-        : index_{index}, instances_{std::move(instances)}, size_{size}
-    {}
+    explicit Instance_batch(std::size_t index, std::vector<Instance> &&instances, std::size_t size);
 
     std::size_t index() const noexcept
     {
         return index_;
     }
 
-    const std::vector<Instance> &instances() const noexcept
+    const std::vector<Instance> &instances() const;
+
+    /// Returns the number of data instances in the batch.
+    std::size_t num_instances() const noexcept
+    {
+        return num_instances_;
+    }
+
+    /// Returns the raw data of the instance at the specified position.
+    Memory_span bits(std::size_t pos) const
+    {
+        if (entries_.empty()) {
+            return instances()[pos].bits();
+        }
+
+        const Entry &entry = entries_[pos];
+
+        const Intrusive_ptr<Memory_block> &chunk = chunks_[entry.chunk_idx];
+        if (chunk == nullptr) {
+            return {};
+        }
+
+        return Memory_span{*chunk}.subspan(entry.offset, entry.size);
+    }
+
+    /// Returns the data store of the instance at the specified position.
+    const Data_store &data_store(std::size_t pos) const noexcept
     {
-        return instances_;
+        if (entries_.empty()) {
+            return lazy_->instances[pos].data_store();
+        }
+
+        return *stores_[entries_[pos].store_idx];
+    }
+
+    /// Returns the position of the instance at the specified position
+    /// in its data store.
+    std::size_t instance_index(std::size_t pos) const noexcept
+    {
+        if (entries_.empty()) {
+            return lazy_->instances[pos].index();
+        }
+
+        return entries_[pos].index;
     }
 
     std::size_t size() const noexcept
@@ -67,9 +118,31 @@ public:
     std::size_t size_bytes() const;
 
 private:
+    struct Entry {
+        std::size_t index;
+        std::size_t offset;
+        std::size_t size;
+        std::uint32_t chunk_idx;
+        std::uint32_t store_idx;
+    };
+
+    struct Lazy_instances {
+        std::once_flag flag{};
+        std::vector<Instance> instances{};
+    };
+
+    MLIO_HIDDEN
+    bool compact(std::vector<Instance> &instances);
+
     std::size_t index_;
-    std::vector<Instance> instances_;
+    std::size_t num_instances_;
     std::size_t size_;
+    std::vector<Intrusive_ptr<Memory_block>> chunks_{};
+    std::vector<const Data_store *> stores_{};
+    std::vector<Entry> entries_{};
+    // Holds the instances if they could not be compacted, or once they
+    // are requested through instances().
+    std::unique_ptr<Lazy_instances> lazy_;
     mutable std::size_t size_bytes_{};
 };
 
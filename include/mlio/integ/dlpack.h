@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 
 #include "mlio/config.h"
 #include "mlio/fwd.h"
@@ -30,5 +31,17 @@ inline namespace abi_v1 {
 MLIO_API
 ::DLManagedTensor *as_dlpack(Tensor &tensor, std::size_t version = 020);
 
+/// Wraps the component arrays of the specified sparse @ref Tensor as
+/// one-dimensional DLManagedTensors without copying them. Each of them
+/// shares the ownership of the tensor. Index arrays of type @c size are
+/// exported as signed 64-bit integers.
+///
+/// @return
+///     For a @ref Coo_tensor the data followed by the indices of each
+///     dimension; for a @ref Csr_tensor the data, the indices, and the
+///     index pointers.
+MLIO_API
+std::vector<::DLManagedTensor *> as_dlpack_components(Tensor &tensor, std::size_t version = 020);
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 
 #include "mlio/config.h"
 
@@ -50,16 +51,26 @@ public:
         return ref_count_.load();
     }
 
+    /// Acquires @p n references with a single atomic operation.
     MLIO_API
-    friend inline void intrusive_ptr_inc_ref(const Intrusive_ref_counter *ptr) noexcept
+    friend inline void
+    intrusive_ptr_inc_ref(const Intrusive_ref_counter *ptr, std::size_t n = 1) noexcept
     {
-        ptr->ref_count_.fetch_add(1, std::memory_order_acq_rel);
+        // A new reference can only be made from an existing one, so the
+        // increment needs no ordering.
+        ptr->ref_count_.fetch_add(n, std::memory_order_relaxed);
     }
 
+    /// Releases @p n references with a single atomic operation.
     MLIO_API
-    friend inline void intrusive_ptr_dec_ref(const Intrusive_ref_counter *ptr) noexcept
+    friend inline void
+    intrusive_ptr_dec_ref(const Intrusive_ref_counter *ptr, std::size_t n = 1) noexcept
     {
-        if (ptr->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (ptr->ref_count_.fetch_sub(n, std::memory_order_release) == n) {
+            // Make sure that all writes made through the other references
+            // are visible before the object gets destructed.
+            std::atomic_thread_fence(std::memory_order_acquire);
+
             delete static_cast<const T *>(ptr);
         }
     }
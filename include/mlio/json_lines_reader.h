@@ -0,0 +1,127 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parallel_data_reader.h"
+#include "mlio/parser.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents the optional parameters of a @ref Json_lines_reader
+/// object.
+struct MLIO_API Json_lines_params final {
+    /// The top-level fields that should be read, in output order. If
+    /// empty, the fields found in the rows sampled for the type
+    /// inference are read in the order of their first appearance;
+    /// fields holding nested objects are left out in such case.
+    std::vector<std::string> fields{};
+    /// The number of rows to sample for inferring the data types of the
+    /// fields and the lengths of the array fields. Besides the first
+    /// instance, the rows are read from the beginning of the dataset,
+    /// possibly from several data stores.
+    std::size_t num_type_inference_rows = 100;
+    /// The data type of the numeric and boolean fields for which no
+    /// explicit data type is specified via @ref field_types, and of the
+    /// fields that hold no value in the sampled rows. If not specified,
+    /// int64 or float64 is inferred from the sampled values, and the
+    /// latter fields are read as float64.
+    std::optional<Data_type> number_data_type{};
+    /// The mapping between fields and data types. For an array field
+    /// specifies the data type of its elements.
+    std::unordered_map<std::string, Data_type> field_types{};
+    /// The mapping between array fields and their maximum lengths. If a
+    /// field is not specified, its maximum length is the length of its
+    /// longest sampled array. A longer array makes its row bad.
+    std::unordered_map<std::string, std::size_t> array_lengths{};
+};
+
+/// Represents a @ref Data_reader for reading JSON Lines datasets, which
+/// hold a JSON object per line.
+///
+/// Each field becomes a feature of the same name. Scalar fields are
+/// read into dense tensors of shape (batch size, 1); array fields are
+/// read into @ref Coo_tensor "COO tensors" of shape (batch size, maximum
+/// length). Missing and null values are read as zero or as an empty
+/// string, and booleans as one or zero.
+///
+/// The rows are parsed on demand, without building a document tree,
+/// and the fields that are not read are skipped. The rows of a batch are
+/// parsed in parallel.
+class MLIO_API Json_lines_reader final : public Parallel_data_reader {
+public:
+    explicit Json_lines_reader(Data_reader_params params, Json_lines_params json_params = {});
+
+    Json_lines_reader(const Json_lines_reader &) = delete;
+
+    Json_lines_reader &operator=(const Json_lines_reader &) = delete;
+
+    Json_lines_reader(Json_lines_reader &&) = delete;
+
+    Json_lines_reader &operator=(Json_lines_reader &&) = delete;
+
+    ~Json_lines_reader() final;
+
+private:
+    class Decoder;
+
+    struct Field {
+        std::string name;
+        Data_type data_type;
+        // The maximum length of an array field; zero for a scalar field.
+        std::size_t array_length;
+    };
+
+    struct Field_stats;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    std::vector<Memory_slice> sample_rows();
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    Json_lines_params params_;
+    std::vector<Field> fields_{};
+    std::vector<Parser> parsers_{};
+    // Maps the names of the fields to their indices; the keys view the
+    // names in fields_.
+    std::unordered_map<std::string_view, std::size_t> field_indices_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// The logical offset of the first message still retained in a Kafka
+/// partition.
+inline constexpr std::int64_t kafka_offset_beginning = -2;
+
+/// The logical offset right after the last message of a Kafka
+/// partition at the time it is opened.
+inline constexpr std::int64_t kafka_offset_end = -1;
+
+/// Holds the offset of a Kafka topic partition.
+struct MLIO_API Kafka_offset {
+    std::int32_t partition{};
+    std::int64_t offset{};
+};
+
+struct MLIO_API Kafka_client_options {
+    /// The comma-separated list of "host:port" pairs of the brokers to
+    /// bootstrap from.
+    std::string bootstrap_servers{};
+    /// The consumer group whose offsets are read by @ref
+    /// Kafka_client::committed_offsets() and written by @ref
+    /// Kafka_client::commit_offsets(). Reading partitions does not
+    /// require a group since the offsets are assigned explicitly.
+    std::string group_id{};
+    /// The maximum number of bytes a broker returns for one fetch
+    /// request across all the partitions it serves.
+    std::size_t fetch_max_bytes = 0x4000000;  // 64 MiB
+    /// The maximum number of bytes a broker returns per partition for
+    /// one fetch request. Large values let a partition stream arrive
+    /// in few round trips.
+    std::size_t partition_fetch_max_bytes = 0x800000;  // 8 MiB
+    /// The maximum number of bytes fetched ahead of the reader per
+    /// partition.
+    std::size_t prefetch_bytes = 0x4000000;  // 64 MiB
+    /// The time a broker waits for data to fill a fetch response.
+    std::chrono::milliseconds fetch_wait_max{100};
+    /// The time to wait for the metadata and offset requests as well as
+    /// for the messages of a partition. A partition that is read up to
+    /// its last message and receives no new message within this time
+    /// is considered ended; see @ref Kafka_partition.
+    std::chrono::milliseconds timeout{60000};
+    /// The additional librdkafka configuration properties such as
+    /// "security.protocol" or "sasl.mechanism". They take precedence
+    /// over the options above.
+    std::unordered_map<std::string, std::string> config{};
+};
+
+/// Represents a client to read the partitions of Kafka topics.
+///
+/// Each opened partition is consumed by a handle of its own that
+/// fetches message batches in the background; partitions opened by
+/// concurrent readers, for instance by an interleaved reader, are
+/// therefore fetched in parallel.
+class MLIO_API Kafka_client : public Intrusive_ref_counter<Kafka_client> {
+public:
+    explicit Kafka_client(Kafka_client_options opts);
+
+    Kafka_client(const Kafka_client &) = delete;
+
+    Kafka_client &operator=(const Kafka_client &) = delete;
+
+    Kafka_client(Kafka_client &&) = delete;
+
+    Kafka_client &operator=(Kafka_client &&) = delete;
+
+    ~Kafka_client();
+
+    /// Returns the number of partitions of @p topic.
+    std::size_t num_partitions(const std::string &topic) const;
+
+    /// Returns the offset of the first message still retained in the
+    /// partition and the offset right after its last message.
+    std::pair<std::int64_t, std::int64_t>
+    watermark_offsets(const std::string &topic, std::int32_t partition) const;
+
+    /// Returns the offsets committed by the consumer group for the
+    /// partitions of @p topic, indexed by partition. Partitions without
+    /// a committed offset are set to @ref kafka_offset_beginning.
+    std::vector<std::int64_t> committed_offsets(const std::string &topic) const;
+
+    /// Commits @p offsets, each one the offset of the next message to
+    /// consume, for the consumer group.
+    void commit_offsets(const std::string &topic, stdx::span<const Kafka_offset> offsets) const;
+
+    /// Opens a stream that concatenates the payloads of the messages
+    /// of the partition, each one followed by @p separator.
+    ///
+    /// @param end_offset
+    ///     The offset at which the stream ends. If negative, the stream
+    ///     follows the partition until no new message arrives within the
+    ///     timeout.
+    Intrusive_ptr<Input_stream> open_partition(const std::string &topic,
+                                               std::int32_t partition,
+                                               std::int64_t start_offset,
+                                               std::int64_t end_offset,
+                                               std::string separator) const;
+
+    const Kafka_client_options &options() const noexcept
+    {
+        return opts_;
+    }
+
+private:
+    struct Impl;
+
+    Kafka_client_options opts_;
+    std::unique_ptr<Impl> impl_;
+};
+
+MLIO_API
+Intrusive_ptr<Kafka_client> make_kafka_client(Kafka_client_options opts);
+
+}  // namespace abi_v1
+}  // namespace mlio
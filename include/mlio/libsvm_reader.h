@@ -0,0 +1,114 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents the optional parameters of a @ref Libsvm_reader object.
+struct MLIO_API Libsvm_params final {
+    /// The number of features, i.e. the second dimension of the "values"
+    /// feature. If zero, it is inferred from the largest feature index
+    /// found in the rows sampled from the beginning of the dataset. A
+    /// row with a larger index is a bad instance.
+    std::size_t num_features{};
+    /// The number of rows to sample for inferring the number of
+    /// features.
+    std::size_t num_feature_inference_rows = 1000;
+    /// A boolean value indicating whether the feature indices start from
+    /// zero instead of one.
+    bool zero_based = false;
+    /// The data type of the "label" feature; must be float32 or float64.
+    Data_type label_data_type = Data_type::float32;
+    /// The data type of the "values" feature; must be float32 or
+    /// float64.
+    Data_type data_type = Data_type::float32;
+};
+
+/// Represents a @ref Data_reader for reading datasets in the LibSVM
+/// (SVMlight) format, which hold a row per line in the form of "label
+/// index:value index:value ...".
+///
+/// The labels are read into a dense "label" feature of shape (batch
+/// size, 1), and the index/value pairs into a sparse "values" feature of
+/// shape (batch size, number of features) in the sparse tensor format
+/// specified in @ref Data_reader_params. "qid" pairs and trailing "#"
+/// comments are ignored.
+///
+/// The rows of a batch are parsed in parallel; each task builds the
+/// sparse tensor of its own row range, and the ranges are concatenated
+/// once all tasks are done.
+class MLIO_API Libsvm_reader final : public Parallel_data_reader {
+public:
+    explicit Libsvm_reader(Data_reader_params params, Libsvm_params libsvm_params = {});
+
+    Libsvm_reader(const Libsvm_reader &) = delete;
+
+    Libsvm_reader &operator=(const Libsvm_reader &) = delete;
+
+    Libsvm_reader(Libsvm_reader &&) = delete;
+
+    Libsvm_reader &operator=(Libsvm_reader &&) = delete;
+
+    ~Libsvm_reader() final;
+
+private:
+    class Decoder;
+
+    struct Row_range;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    std::vector<Memory_slice> sample_rows();
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    template<Data_type dt>
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode_batch(const Instance_batch &batch) const;
+
+    Libsvm_params libsvm_params_;
+    std::size_t num_features_{};
+    // The average number of values per row in the last decoded batch;
+    // used to presize the sparse tensor builders.
+    mutable std::atomic_size_t nnz_per_row_estimate_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
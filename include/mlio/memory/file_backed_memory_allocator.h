@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 
 #include "mlio/config.h"
 #include "mlio/fwd.h"
@@ -37,13 +38,19 @@ public:
     ///     a File-mapped memory region instead of the process heap.
     ///     If the threshold is zero, the actual threshold will be
     ///     determined dynamically based on the available physical
-    ///     memory of the system.
-    explicit File_backed_memory_allocator(std::size_t oversize_threshold = 0) noexcept;
+    ///     memory of the system, or the memory limit of the cgroup
+    ///     of the process if it is lower.
+    /// @param directory
+    ///     The directory to create the backing files in; e.g. a fast
+    ///     local disk. If empty, defaults to /tmp.
+    explicit File_backed_memory_allocator(std::size_t oversize_threshold = 0,
+                                          std::string directory = {}) noexcept;
 
     Intrusive_ptr<Mutable_memory_block> allocate(std::size_t size) final;
 
 private:
     std::size_t oversize_threshold_{};
+    std::string directory_;
 };
 
 /// @}
@@ -16,10 +16,12 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 
 #include "mlio/config.h"
 #include "mlio/detail/file_descriptor.h"
 #include "mlio/memory/memory_block.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -29,9 +31,26 @@ inline namespace abi_v1 {
 
 /// Represents a memory block backed by a temporary File instead of the
 /// process heap.
+///
+/// The block grows geometrically; the backing file and its memory map
+/// are extended to twice their size, and on Linux the map is moved
+/// with mremap() instead of being rebuilt. The disk space of the file
+/// is preallocated where supported so that running out of space is
+/// reported as an error instead of a bus error on first write.
 class MLIO_API File_backed_memory_block final : public Mutable_memory_block {
 public:
-    explicit File_backed_memory_block(size_type size);
+    /// @param directory
+    ///     The directory to create the backing file in; e.g. a fast
+    ///     local disk. If empty, defaults to /tmp.
+    explicit File_backed_memory_block(size_type size, const std::string &directory = {});
+
+    /// Constructs a block whose leading bytes are copied from @p data.
+    /// The bytes are written to the backing file directly instead of
+    /// through the memory map, so that the pages of the block do not
+    /// have to be faulted in one by one.
+    explicit File_backed_memory_block(size_type size,
+                                      Memory_span data,
+                                      const std::string &directory = {});
 
     File_backed_memory_block(const File_backed_memory_block &) = delete;
 
@@ -67,7 +86,16 @@ public:
 
 private:
     MLIO_HIDDEN
-    void make_temporary_file();
+    void make_temporary_file(const std::string &directory);
+
+    MLIO_HIDDEN
+    void write_data(Memory_span data);
+
+    MLIO_HIDDEN
+    void set_capacity(std::size_t capacity);
+
+    MLIO_HIDDEN
+    void extend_file(std::size_t capacity);
 
     MLIO_HIDDEN
     std::byte *init_memory_map(std::size_t size);
@@ -78,6 +106,8 @@ private:
     detail::File_descriptor fd_{};
     std::byte *data_{};
     std::size_t size_{};
+    // The size of the backing file and of its memory map.
+    std::size_t capacity_{};
 };
 
 /// @}
@@ -56,6 +56,9 @@ private:
     MLIO_HIDDEN
     void init_memory_map();
 
+    MLIO_HIDDEN
+    void *map_file(int fd) const noexcept;
+
     std::string path_;
     std::byte *data_{};
     std::size_t size_{};
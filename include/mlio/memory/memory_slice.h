@@ -47,6 +47,20 @@ public:
         static_assert(std::is_base_of<Memory_block, T>::value, "T must derive from Memory_block.");
     }
 
+    /// Constructs a slice of the range [@p first, @p last) of the
+    /// specified block. The slice takes over the reference held by
+    /// @p block; no reference count is changed.
+    explicit Memory_slice(Intrusive_ptr<Memory_block> block,
+                          Memory_block::iterator first,
+                          Memory_block::iterator last)
+        : block_{std::move(block)}, beg_{block_->begin()}, end_{block_->end()}
+    {
+        validate_range(first, last);
+
+        beg_ = first;
+        end_ = last;
+    }
+
     Memory_block::iterator begin() const noexcept
     {
         return beg_;
@@ -86,6 +100,12 @@ public:
         return beg_ == end_;
     }
 
+    /// Returns the memory block that the slice references.
+    const Intrusive_ptr<Memory_block> &block() const noexcept
+    {
+        return block_;
+    }
+
     Memory_slice subslice(Memory_block::size_type offset) const &
     {
         return subslice(beg_ + as_ssize(offset), end_);
@@ -178,6 +198,16 @@ public:
         return std::move(*this).subslice(from, end_);
     }
 
+    /// Drops the first @p count bytes of the slice in place. Unlike
+    /// assigning a subslice, this does not touch the reference count
+    /// of the block.
+    void remove_prefix(Memory_block::size_type count)
+    {
+        validate_range(beg_ + as_ssize(count), end_);
+
+        beg_ += as_ssize(count);
+    }
+
 private:
     void validate_range(Memory_block::iterator first, Memory_block::iterator last) const;
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "mlio/config.h"
+#include "mlio/memory/memory_block.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup memory Memory
+/// @{
+
+/// Represents a memory block mapped directly from the operating system
+/// instead of the process heap. The block starts at a page boundary.
+class MLIO_API Page_memory_block final : public Mutable_memory_block {
+public:
+    /// @param huge_pages
+    ///     A boolean value indicating whether the block should be backed
+    ///     by transparent huge pages. If set, a block of at least 2 MiB
+    ///     starts at a huge page boundary.
+    /// @param prefault
+    ///     A boolean value indicating whether the pages of the block
+    ///     should be faulted in right away instead of on first write.
+    ///
+    /// @note
+    ///     Huge pages are only supported on Linux.
+    explicit Page_memory_block(size_type size, bool huge_pages = false, bool prefault = false);
+
+    Page_memory_block(const Page_memory_block &) = delete;
+
+    Page_memory_block &operator=(const Page_memory_block &) = delete;
+
+    Page_memory_block(Page_memory_block &&) = delete;
+
+    Page_memory_block &operator=(Page_memory_block &&) = delete;
+
+    ~Page_memory_block() final;
+
+    void resize(size_type size) final;
+
+    pointer data() noexcept final
+    {
+        return data_;
+    }
+
+    const_pointer data() const noexcept final
+    {
+        return data_;
+    }
+
+    size_type size() const noexcept final
+    {
+        return size_;
+    }
+
+    bool resizable() const noexcept final
+    {
+        return true;
+    }
+
+private:
+    std::byte *data_{};
+    std::size_t size_{};
+    bool huge_pages_;
+    bool prefault_;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_allocator.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Slab_pool;
+
+}  // namespace detail
+
+/// @addtogroup memory Memory
+/// @{
+
+/// Holds the parameters for @ref Slab_memory_allocator.
+struct MLIO_API Slab_memory_allocator_params final {
+    /// The maximum total size, in bytes, of the freed blocks that are
+    /// kept for reuse. If @ref numa_aware is true, the limit applies
+    /// to each NUMA node separately.
+    std::size_t max_cached_size = 0x10000000;  // 256 MiB
+    /// The size of the largest size class. Larger blocks are allocated
+    /// and freed directly without being recycled.
+    std::size_t max_class_size = 0x4000000;  // 64 MiB
+    /// A boolean value indicating whether the blocks that are at least
+    /// as large as a huge page should be backed by transparent huge
+    /// pages if the platform supports them.
+    bool use_huge_pages = false;
+    /// A boolean value indicating whether the blocks should be placed
+    /// on, and recycled from, the NUMA node of the allocating thread.
+    bool numa_aware = false;
+};
+
+/// Holds the allocation statistics of a @ref Slab_memory_allocator.
+struct MLIO_API Slab_memory_allocator_stats final {
+    /// The number of allocations.
+    std::size_t num_allocations{};
+    /// The number of allocations that were served from a recycled
+    /// block.
+    std::size_t num_recycled{};
+    /// The total size, in bytes, of the blocks in use.
+    std::size_t num_bytes_in_use{};
+    /// The total size, in bytes, of the freed blocks kept for reuse.
+    std::size_t num_bytes_cached{};
+};
+
+/// Represents a memory allocator that rounds allocations up to power-
+/// of-two size classes and recycles freed blocks of the same class.
+/// This avoids the repeated allocation and page faulting of short-lived
+/// buffers such as the chunks read from data stores.
+///
+/// @remark
+///     The allocated blocks can outlive the allocator; they are freed
+///     once they get released.
+class MLIO_API Slab_memory_allocator final : public Memory_allocator {
+public:
+    explicit Slab_memory_allocator(const Slab_memory_allocator_params &params = {});
+
+    Slab_memory_allocator(const Slab_memory_allocator &) = delete;
+
+    Slab_memory_allocator &operator=(const Slab_memory_allocator &) = delete;
+
+    Slab_memory_allocator(Slab_memory_allocator &&) = delete;
+
+    Slab_memory_allocator &operator=(Slab_memory_allocator &&) = delete;
+
+    ~Slab_memory_allocator() final;
+
+    Intrusive_ptr<Mutable_memory_block> allocate(std::size_t size) final;
+
+    Slab_memory_allocator_stats stats() const noexcept;
+
+    /// Frees the blocks kept for reuse.
+    void trim() noexcept;
+
+private:
+    std::shared_ptr<detail::Slab_pool> pool_;
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+#include "mlio/s3_object_cache.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// Holds the parameters for reading objects with concurrent byte-range
+/// GET requests.
+struct MLIO_API Range_read_params {
+    /// The number of byte-range GET requests to keep in flight ahead of
+    /// the read position. If less than two, an object is read with one
+    /// request per read call.
+    std::size_t num_parallel_ranges{};
+    /// The size of each byte-range GET request. Sizes between 8 and 64
+    /// MiB usually saturate the network bandwidth of an instance.
+    std::size_t range_size = 0x100'0000;  // 16 MiB
+    /// A boolean value indicating whether to hedge slow byte-range
+    /// requests. If a range has not been fetched within the 95th
+    /// percentile of the latencies of the preceding ranges of the
+    /// object, a duplicate request is issued and the range is taken
+    /// from whichever request completes first. Requires @ref
+    /// num_parallel_ranges to be at least two.
+    bool hedge_requests{};
+    /// The maximum number of hedged requests as a fraction of the
+    /// ranges fetched; bounds the additional cost of the duplicate
+    /// requests.
+    double hedge_budget = 0.05;
+};
+
+/// Holds the metadata of an object as returned by a HEAD request.
+struct MLIO_API Object_metadata {
+    std::size_t size{};
+    std::string etag{};
+};
+
+/// Represents a client to access an object storage service such as
+/// Amazon S3, Google Cloud Storage, or Azure Blob Storage.
+///
+/// The objects are addressed by a bucket, or container, and a key. The
+/// streams, caches, and listings that read objects are shared by all
+/// services and only use the operations of this interface.
+class MLIO_API Object_store_client : public Intrusive_ref_counter<Object_store_client> {
+public:
+    using List_callback = std::function<void(std::string uri, std::size_t size)>;
+
+    Object_store_client(const Object_store_client &) = delete;
+
+    Object_store_client &operator=(const Object_store_client &) = delete;
+
+    Object_store_client(Object_store_client &&) = delete;
+
+    Object_store_client &operator=(Object_store_client &&) = delete;
+
+    virtual ~Object_store_client();
+
+    /// Lists the objects under the specified prefix and calls @p
+    /// callback with the URI and the size of each of them.
+    virtual void list_objects(std::string_view bucket,
+                              std::string_view prefix,
+                              const List_callback &callback) const = 0;
+
+    /// Reads the specified object starting at @p offset into @p
+    /// destination and returns the number of bytes read.
+    ///
+    /// @param version_id
+    ///     The version of the object to read. If empty, the latest
+    ///     version is read.
+    virtual std::size_t read_object(std::string_view bucket,
+                                    std::string_view key,
+                                    std::string_view version_id,
+                                    std::size_t offset,
+                                    Mutable_memory_span destination) const = 0;
+
+    virtual Object_metadata read_object_metadata(std::string_view bucket,
+                                                 std::string_view key,
+                                                 std::string_view version_id) const = 0;
+
+    std::size_t read_object_size(std::string_view bucket,
+                                 std::string_view key,
+                                 std::string_view version_id) const;
+
+    /// Gets the scheme of the object URIs such as "s3" for Amazon S3.
+    virtual std::string_view uri_scheme() const noexcept = 0;
+
+    /// Gets the range read parameters that are used by default for the
+    /// objects read through this client.
+    const Range_read_params &range_read_params() const noexcept
+    {
+        return range_read_params_;
+    }
+
+    /// Gets the local cache of the objects read through this client.
+    const Intrusive_ptr<S3_object_cache> &object_cache() const noexcept
+    {
+        return object_cache_;
+    }
+
+protected:
+    /// @param object_cache
+    ///     The local cache through which the objects opened with this
+    ///     client are read. If null, the objects are always read from
+    ///     the service.
+    explicit Object_store_client(const Range_read_params &range_read_params,
+                                 Intrusive_ptr<S3_object_cache> object_cache) noexcept;
+
+private:
+    Range_read_params range_read_params_;
+    Intrusive_ptr<S3_object_cache> object_cache_;
+};
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Orc_file_info;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+struct MLIO_API Orc_reader_params final {
+    /// The columns to read. If empty, all top-level columns of a
+    /// supported type are read. Only the streams of the specified
+    /// columns are fetched from the data stores.
+    std::unordered_set<std::string> use_columns{};
+};
+
+/// Represents a @ref Data_reader for reading ORC datasets.
+///
+/// The reader reads the file tails of the ORC files and fetches the
+/// streams of the selected columns with ranged reads. Each stripe is
+/// treated as a data @ref Instance; this means the batch size specifies
+/// the number of stripes per @ref Example and the batch dimension of
+/// the tensors is the total number of rows in those stripes. The
+/// stripes of a batch are decoded in parallel.
+///
+/// Top-level columns of the boolean, tinyint, smallint, int, bigint,
+/// float, double, string, varchar, char, and binary types are supported.
+/// Null values are read as zero, NaN for floating-point columns, or an
+/// empty string.
+class MLIO_API Orc_reader final : public Parallel_data_reader {
+public:
+    explicit Orc_reader(Data_reader_params params, Orc_reader_params orc_params = {});
+
+    Orc_reader(const Orc_reader &) = delete;
+
+    Orc_reader &operator=(const Orc_reader &) = delete;
+
+    Orc_reader(Orc_reader &&) = delete;
+
+    Orc_reader &operator=(Orc_reader &&) = delete;
+
+    ~Orc_reader() final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Orc_file_info>
+    read_file_info(const Data_store &store, Intrusive_ptr<Input_stream> stream);
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Orc_file_info> get_file_info(const Data_store &store) const;
+
+    Orc_reader_params params_;
+    // The file tails of the ORC files read so far. Populated by the
+    // record readers and used by the decode tasks.
+    mutable std::mutex file_info_mutex_{};
+    std::unordered_map<const Data_store *, std::shared_ptr<const detail::Orc_file_info>>
+        file_infos_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,19 +16,30 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <vector>
 
 #include "mlio/config.h"
 #include "mlio/data_reader.h"
 #include "mlio/data_reader_base.h"
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/reader_stats.h"
+#include "mlio/span.h"
+#include "mlio/tensor_pool.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -50,12 +61,93 @@ public:
 
     ~Parallel_data_reader() override;
 
+    /// @remark
+    ///     If @ref Data_reader_params::example_transforms is set, returns
+    ///     the schema of the transformed examples.
     Intrusive_ptr<const Schema> read_schema() final;
 
     void reset() noexcept override;
 
     std::size_t num_bytes_read() const noexcept final;
 
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+    /// @remark
+    ///     If the instances are not shuffled, the state holds the byte
+    ///     offset of the last instance read in its data store, and the
+    ///     reader seeks directly to it when the state is restored;
+    ///     otherwise the instances are skipped, but never decoded, up
+    ///     to the saved position.
+    ///
+    /// @remark
+    ///     Not supported if the instances are shuffled or sampled
+    ///     without a seed, or if they are bucketed by size.
+    Data_reader_state save_state() const override;
+
+    void restore_state(const Data_reader_state &state) override;
+
+    /// @remark
+    ///     The data stores are counted in parallel; a data store with a
+    ///     @ref Data_store::num_instances_hint(), or with a RecordIO
+    ///     index in @ref Data_reader_params::recordio_indexes, is not
+    ///     read at all. In exact mode a large data store that can be
+    ///     split into byte ranges is counted in parallel as well. Data
+    ///     stores that cannot be sampled, such as compressed ones, are
+    ///     always counted exactly.
+    ///
+    /// @remark
+    ///     Must not be called concurrently with the other member
+    ///     functions of the reader.
+    Instance_count estimate_num_instances(bool exact) override;
+
+    /// Reads the next Example of each device in @ref
+    /// Data_reader_params::output_devices; the i-th Example is on the
+    /// i-th device. Returns fewer examples, or none, at the end of the
+    /// dataset.
+    ///
+    /// @remark
+    ///     The examples are only guaranteed to be in device order if the
+    ///     reader is deterministic and every Example of the epoch is read
+    ///     through this function.
+    std::vector<Intrusive_ptr<Example>> read_device_examples();
+
+    /// Gets the usage statistics of the tensor pool of the reader. See
+    /// @ref Data_reader_params::tensor_pool_size.
+    Tensor_pool_stats tensor_pool_stats() const;
+
+    /// Gets the stage timings, queue occupancy, and throughput of the
+    /// reader. See @ref Reader_stats.
+    ///
+    /// @remark
+    ///     The window values and the throughput are measured since the
+    ///     previous call to this function.
+    Reader_stats stats() const;
+
+    /// Decodes the records in the specified buffer into a single @ref
+    /// Example on the calling thread, as if the buffer were a data store
+    /// of its own. Unlike @ref read_example() it does not start the
+    /// background pipeline, so it is meant for serving workloads that
+    /// already hold the serialized records in memory.
+    ///
+    /// @remark
+    ///     All records in the buffer end up in the returned Example;
+    ///     @ref Data_reader_params::batch_size, the shuffling, and the
+    ///     sharding parameters are ignored. The row filters, the example
+    ///     transforms, and the output device are honored.
+    ///
+    /// @remark
+    ///     If the schema has not been inferred yet, it is inferred from
+    ///     the first instance of the buffer.
+    ///
+    /// @return
+    ///     An Example, or null if the buffer contains no instance or if
+    ///     the instances are dropped by the filters or the transforms.
+    ///
+    /// @remark
+    ///     Must not be called concurrently with the other member
+    ///     functions of the reader.
+    Intrusive_ptr<Example> decode_buffer(Memory_slice buffer);
+
 protected:
     explicit Parallel_data_reader(Data_reader_params &&params);
 
@@ -64,6 +156,61 @@ protected:
     /// resources are properly disposed.
     void stop();
 
+    /// Returns a boolean value indicating whether a batch should be
+    /// split into row-range tasks for decoding.
+    bool should_decode_parallel(std::size_t num_instances,
+                                std::size_t num_values_per_instance) const noexcept;
+
+    /// Returns the minimum number of instances that a single row-range
+    /// decode task should handle.
+    std::size_t decode_grain_size(std::size_t num_values_per_instance) const noexcept;
+
+    /// Groups the instances that @p get_bucket maps to the same bucket
+    /// into the same batch, buffering at most @p lookahead instances
+    /// while waiting for a bucket to fill up. Must be called in the
+    /// constructor of the derived class.
+    void set_instance_bucketing(std::function<std::size_t(const Instance &)> get_bucket,
+                                std::size_t lookahead);
+
+    /// Drops the instances for which @p filter returns false before
+    /// they are batched, so that the batches still have exactly @ref
+    /// Data_reader_params::batch_size instances. Must be called in the
+    /// constructor of the derived class if the reader supports @ref
+    /// Data_reader_params::row_filters.
+    ///
+    /// @remark
+    ///     The filter is called concurrently with the decode function,
+    ///     but never concurrently with itself.
+    void set_instance_filter(std::function<bool(const Instance &)> filter);
+
+    /// Counts the problems that the decode tasks of a batch have
+    /// collected in @p log and logs their warnings. In an epoch only the
+    /// first few warnings are logged individually; the rest are
+    /// summarized periodically. Must be called before the batch is
+    /// released.
+    void report_decode_warnings(detail::Decode_warning_log &log) const;
+
+    /// Allocates a new @ref Cpu_array from the tensor pool of the reader,
+    /// or if the pool is disabled, via @ref make_cpu_array(). See @ref
+    /// Tensor_pool::make_cpu_array() for @p zero_fill. The arrays that
+    /// reach @ref Data_reader_params::file_backed_output_threshold are
+    /// backed by a file instead.
+    std::unique_ptr<Device_array>
+    make_pooled_cpu_array(Data_type dt, std::size_t size, bool zero_fill = true) const;
+
+    /// Allocates a new @ref Cpu_array with the specified size for each of
+    /// the specified data types from a single buffer; see @ref
+    /// make_cpu_arrays().
+    std::vector<std::unique_ptr<Device_array>>
+    make_pooled_cpu_arrays(stdx::span<const Data_type> dts, std::size_t size) const;
+
+    /// Gets the tensor pool of the reader, or null if the pool is
+    /// disabled. Used to build sparse tensors into pooled buffers.
+    Tensor_pool *tensor_pool() const noexcept
+    {
+        return tensor_pool_.get();
+    }
+
     Intrusive_ptr<const Schema> schema() const noexcept
     {
         return schema_;
@@ -74,10 +221,30 @@ private:
 
     struct Graph_data;
 
+    struct Stats_data;
+
+    struct Tuning_data;
+
     /// When implemented in a derived class, constructs a @ref
     /// Record_reader from the specified data store.
     virtual Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) = 0;
 
+    /// Constructs a @ref Record_reader that counts the instances of the
+    /// specified data store; see @ref estimate_num_instances(). Unlike
+    /// @ref make_record_reader() it must not change the state kept by
+    /// the derived class for the pipeline. The default implementation
+    /// calls @ref make_record_reader().
+    ///
+    /// @param store_index
+    ///     The index of @p store in @ref Data_reader_params::dataset.
+    virtual Intrusive_ptr<Record_reader>
+    make_counting_record_reader(const Data_store &store, std::size_t store_index);
+
+    /// When implemented in a derived class, discards any state kept for
+    /// the specified data store by @ref make_record_reader(). Called
+    /// once the transient store of @ref decode_buffer() is decoded.
+    virtual void release_data_store(const Data_store &store) noexcept;
+
     MLIO_HIDDEN
     Intrusive_ptr<Example> read_example_core() final;
 
@@ -91,7 +258,89 @@ private:
     void init_graph();
 
     MLIO_HIDDEN
-    void ensure_schema_inferred();
+    bool push_example(Intrusive_ptr<Example> example);
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> copy_to_output_device(Intrusive_ptr<Example> example,
+                                                 std::size_t batch_idx);
+
+    MLIO_HIDDEN
+    bool should_back_by_file(stdx::span<const Data_type> dts, std::size_t size) const;
+
+    MLIO_HIDDEN
+    bool start_next_epoch();
+
+    MLIO_HIDDEN
+    void record_first_example() noexcept;
+
+    MLIO_HIDDEN
+    bool is_stop_requested() const;
+
+    // Returns the number of epochs that the background thread has
+    // started past the one read by the consumer.
+    MLIO_HIDDEN
+    std::size_t reset_pipeline() noexcept;
+
+    MLIO_HIDDEN
+    void make_instance_readers();
+
+    MLIO_HIDDEN
+    void check_state_supported() const;
+
+    MLIO_HIDDEN
+    void pop_checkpoint();
+
+    MLIO_HIDDEN
+    void reset_stats() noexcept;
+
+    MLIO_HIDDEN
+    void ensure_schema_inferred(const std::optional<Instance> *instance = nullptr);
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode_store(const Data_store &store);
+
+    MLIO_HIDDEN
+    std::vector<Instance> read_buffer_instances(const Data_store &store);
+
+    MLIO_HIDDEN
+    Instance_count count_store_instances(std::size_t store_index, bool exact);
+
+    MLIO_HIDDEN
+    std::size_t count_shards_in_parallel(std::size_t store_index, std::size_t num_shards);
+
+    MLIO_HIDDEN
+    void record_decoded_batch(const Instance_batch &batch, const Example *example);
+
+    MLIO_HIDDEN
+    void autotune();
+
+    MLIO_HIDDEN
+    std::size_t release_parallel_reads() noexcept;
+
+    MLIO_HIDDEN
+    void charge_memory(std::size_t num_bytes) noexcept;
+
+    MLIO_HIDDEN
+    void release_memory(std::size_t num_bytes) noexcept;
+
+    MLIO_HIDDEN
+    std::size_t memory_usage() const noexcept;
+
+    MLIO_HIDDEN
+    bool is_over_memory_budget() const noexcept;
+
+    MLIO_HIDDEN
+    std::size_t get_queue_capacity(std::size_t num_prefetched_examples) const noexcept;
+
+    MLIO_HIDDEN
+    void record_decode_cost(std::size_t num_values,
+                            std::chrono::nanoseconds elapsed) const noexcept;
+
+    /// When implemented in a derived class, returns the Schema of the
+    /// dataset if it is known without reading the dataset; otherwise
+    /// returns null, in which case the Schema is inferred via @ref
+    /// infer_schema().
+    virtual Intrusive_ptr<const Schema> restore_schema();
 
     /// When implemented in a derived class, infers the Schema of the
     /// dataset from the specified data Instance.
@@ -109,17 +358,34 @@ private:
     Data_reader_params params_;
     std::unique_ptr<detail::Instance_reader> reader_;
     std::unique_ptr<detail::Instance_batch_reader> batch_reader_;
+    std::function<bool(const Instance &)> instance_filter_{};
     Run_state state_{};
-    std::unique_ptr<Graph_data> graph_;
+    std::shared_ptr<detail::Reader_task_arena> arena_;
+    std::unique_ptr<Graph_data> graph_{};
+    std::unique_ptr<Stats_data> stats_;
+    std::unique_ptr<Tuning_data> tuning_;
+    Intrusive_ptr<Tensor_pool> tensor_pool_{};
+    // The transfers of the output devices by device index; null for
+    // the CPU devices.
+    std::vector<std::unique_ptr<detail::Cuda_transfer>> transfers_{};
     std::thread thread_{};
     std::deque<Intrusive_ptr<Example>> fill_queue_{};
     std::deque<Intrusive_ptr<Example>> read_queue_{};
-    std::mutex queue_mutex_;
+    mutable std::mutex queue_mutex_;
     std::condition_variable fill_condition_{};
     std::condition_variable read_condition_{};
     std::exception_ptr exception_ptr_{};
     std::atomic_size_t num_bytes_read_{};
+    // The average time, in picoseconds, it takes to decode a single
+    // value in a serial decode; used to decide whether a batch should be
+    // decoded in parallel.
+    mutable std::atomic<std::uint64_t> decode_cost_ps_{};
     Intrusive_ptr<const Schema> schema_{};
+    // The schema of the examples returned by the example transforms.
+    Intrusive_ptr<const Schema> output_schema_{};
+    // The number of times the instance reader has been reset before
+    // the current epoch of the consumer.
+    std::size_t epoch_{};
 };
 
 /// @}
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Parquet_file_info;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Skips the row groups whose statistics show that none of their values
+/// in @ref column fall into [@ref min_value, @ref max_value].
+///
+/// @remark
+///     The filter is applied at row-group granularity only; the rows of
+///     the row groups that are read are not filtered.
+struct MLIO_API Parquet_row_group_filter final {
+    /// The dot-separated path of the column.
+    std::string column{};
+    std::optional<double> min_value{};
+    std::optional<double> max_value{};
+};
+
+struct MLIO_API Parquet_reader_params final {
+    /// The columns to read. If empty, all columns of a supported type
+    /// are read. Only the column chunks of the specified columns are
+    /// fetched from the data stores.
+    std::unordered_set<std::string> use_columns{};
+    /// See @ref Parquet_row_group_filter.
+    std::vector<Parquet_row_group_filter> row_group_filters{};
+};
+
+/// Represents a @ref Data_reader for reading Parquet datasets.
+///
+/// The reader reads the footers of the Parquet files and fetches the
+/// column chunks of the selected columns with ranged reads. Each row
+/// group is treated as a data @ref Instance; this means the batch size
+/// specifies the number of row groups per @ref Example and the batch
+/// dimension of the tensors is the total number of rows in those row
+/// groups. The column chunks of a batch are decoded in parallel.
+///
+/// @note
+///     Since the batch dimension of an @ref Example depends on how the
+///     rows of the files are split into row groups, the reader does not
+///     support the last example handling modes that drop or pad the
+///     last Example; @ref Data_reader_params::last_example_handling
+///     must be @ref Last_example_handling::none. For batches with a
+///     fixed number of rows, write the files with a fixed row group
+///     size and set the batch size to one.
+///
+/// Flat columns of the boolean, int32, int64, float, double, and
+/// (fixed-length) byte array physical types are supported. Null values
+/// are read as zero, NaN for floating-point columns, or an empty string.
+class MLIO_API Parquet_reader final : public Parallel_data_reader {
+public:
+    explicit Parquet_reader(Data_reader_params params, Parquet_reader_params pq_params = {});
+
+    Parquet_reader(const Parquet_reader &) = delete;
+
+    Parquet_reader &operator=(const Parquet_reader &) = delete;
+
+    Parquet_reader(Parquet_reader &&) = delete;
+
+    Parquet_reader &operator=(Parquet_reader &&) = delete;
+
+    ~Parquet_reader() final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Parquet_file_info>
+    read_file_info(const Data_store &store, Input_stream &stream);
+
+    MLIO_HIDDEN
+    std::shared_ptr<const detail::Parquet_file_info> get_file_info(const Data_store &store) const;
+
+    Parquet_reader_params params_;
+    // The metadata of the Parquet files read so far. Populated by the
+    // record readers and used by the decode tasks.
+    mutable std::mutex file_info_mutex_{};
+    std::unordered_map<const Data_store *, std::shared_ptr<const detail::Parquet_file_info>>
+        file_infos_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
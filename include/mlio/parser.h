@@ -24,6 +24,7 @@
 #include "mlio/config.h"
 #include "mlio/data_type.h"
 #include "mlio/device_array.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -37,6 +38,9 @@ struct MLIO_API Parser_options {
     /// For a number parse operation specifies the base of the number in
     /// its string representation.
     int base = 10;
+    /// For a timestamp or date parse operation specifies a strptime-like
+    /// format to use instead of ISO-8601; see @ref Datetime_format.
+    std::string datetime_format{};
 };
 
 /// Acts as a Parser for a specific data type.
@@ -60,5 +64,49 @@ using Parser =
 MLIO_API
 Parser make_parser(Data_type dt, const Parser_options &opts);
 
+/// Specifies the state of a row in a column parse operation.
+enum class Row_state : char {
+    good,         ///< The row has no bad fields so far.
+    bad,          ///< The row has a bad field and should be skipped.
+    parse_failed,  ///< The row has a field that failed to parse.
+    overflowed     ///< The row has a field that does not fit into its data type.
+};
+
+/// Acts as a Parser for a whole column of fields. Unlike a @ref Parser
+/// it is dispatched once per column instead of once per field which
+/// lets the compiler generate a tight loop for each data type.
+struct MLIO_API Column_parser {
+    /// Parses the fields at position `i * stride` and writes them into
+    /// the destination array at position `offset + i`. Rows that are
+    /// not in the `good` state are skipped; the ones that fail to parse
+    /// are marked as `parse_failed`, or as `overflowed` if their value
+    /// does not fit into the data type.
+    ///
+    /// @return
+    ///     The number of rows that failed to parse.
+    using Parse_fn = std::size_t (*)(stdx::span<const std::string_view> fields,
+                                     std::size_t stride,
+                                     stdx::span<Row_state> row_states,
+                                     Device_array_span arr,
+                                     std::size_t offset,
+                                     const Parser_options &opts);
+
+    /// Moves the values of the good rows written at position `offset + i`
+    /// towards @p offset so that they form a contiguous range.
+    using Compact_fn = void (*)(Device_array_span arr,
+                                std::size_t offset,
+                                stdx::span<const Row_state> row_states);
+
+    Parse_fn parse{};
+    Compact_fn compact{};
+};
+
+/// Constructs a Column_parser.
+///
+/// @param dt
+///     The data type for which to construct a Column_parser.
+MLIO_API
+Column_parser make_column_parser(Data_type dt);
+
 }  // namespace abi_v1
 }  // namespace mlio
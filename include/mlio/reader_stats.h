@@ -0,0 +1,167 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Holds the timings of a stage of the pipeline of a @ref
+/// Parallel_data_reader.
+///
+/// The window values cover the period since the previous call to @ref
+/// Parallel_data_reader::stats().
+struct MLIO_API Stage_stats {
+    /// The number of times the stage has run.
+    std::uint64_t num_calls{};
+    /// The total time, in nanoseconds, spent in the stage.
+    std::uint64_t total_ns{};
+    std::uint64_t window_num_calls{};
+    std::uint64_t window_ns{};
+};
+
+/// Holds the progress and the throughput of a data store.
+///
+/// The counters are cumulative within an epoch. A data store read by
+/// an index (see @ref Data_reader_params::recordio_indexes) only has
+/// @ref num_bytes_read.
+struct MLIO_API Store_stats {
+    /// The id of the data store.
+    std::string id{};
+    /// The number of bytes of the decoded instances.
+    std::size_t num_bytes_read{};
+    /// The number of records framed from the data store.
+    std::uint64_t num_records{};
+    /// The number of bytes of the payloads of the records.
+    std::uint64_t num_record_bytes{};
+    /// The total time, in nanoseconds, spent reading the records; this
+    /// includes the time blocked in I/O.
+    std::uint64_t read_ns{};
+    /// The number of times the data store has been opened, and the
+    /// total time, in nanoseconds, spent opening it.
+    std::uint64_t num_opens{};
+    std::uint64_t open_ns{};
+    /// The number of record bytes read per second of @ref read_ns.
+    double bytes_per_second{};
+};
+
+/// Holds the runtime statistics of a @ref Parallel_data_reader.
+///
+/// The statistics are reset along with the reader. Unless stated
+/// otherwise the counters are cumulative.
+struct MLIO_API Reader_stats {
+    /// Reading the data instances from the data stores and batching
+    /// them; this includes the I/O and the record framing.
+    Stage_stats read{};
+    /// Decoding the instance batches into examples.
+    Stage_stats decode{};
+    /// Running the example transforms; see @ref
+    /// Data_reader_params::example_transforms.
+    Stage_stats transform{};
+    /// Waiting for the preceding examples to be decoded and transformed
+    /// so that the examples are returned in order.
+    Stage_stats reorder{};
+    /// Waiting for room in the example queue; a high value means the
+    /// consumer cannot keep up with the reader.
+    Stage_stats enqueue{};
+    /// Waiting in @ref Data_reader::read_example() for an example; a
+    /// high value means the reader cannot keep up with the consumer.
+    Stage_stats consume{};
+
+    /// The number of examples waiting to be handed over to the
+    /// consumer at the time of the call.
+    std::size_t num_queued_examples{};
+    /// The maximum number of examples that can be queued.
+    std::size_t queue_capacity{};
+    /// The current number of parallel reads and prefetched examples;
+    /// these change over time if @ref Data_reader_params::autotune is
+    /// set.
+    std::size_t num_parallel_reads{};
+    std::size_t num_prefetched_examples{};
+    /// The approximate number of bytes held by the pipeline at the time
+    /// of the call, and the highest such value since the reader was
+    /// reset; see @ref Data_reader_params::memory_budget.
+    std::size_t memory_usage{};
+    std::size_t peak_memory_usage{};
+
+    /// The number of examples decoded.
+    std::uint64_t num_examples{};
+    /// The number of data instances in the decoded examples.
+    std::uint64_t num_instances{};
+    /// The number of bad data instances left out of padded examples.
+    std::uint64_t num_bad_instances{};
+    /// The number of examples skipped due to bad data instances.
+    std::uint64_t num_skipped_examples{};
+    /// The number of data instances dropped by @ref
+    /// Data_reader_params::row_filters or @ref
+    /// Data_reader_params::class_sample_ratios.
+    std::uint64_t num_filtered_instances{};
+
+    /// The number of problems found in the data instances, by kind. An
+    /// instance is typically counted once, under the first problem
+    /// found in it.
+    ///
+    /// Fields that cannot be parsed as the data type of their column.
+    std::uint64_t num_parse_errors{};
+    /// Instances that have fewer or more fields than expected.
+    std::uint64_t num_field_count_errors{};
+    /// Fields that exceed the maximum field length, whether they have
+    /// been truncated or treated as bad.
+    std::uint64_t num_long_fields{};
+    /// Instances that are not valid records.
+    std::uint64_t num_corrupt_records{};
+    /// Features that do not match their attribute in the schema.
+    std::uint64_t num_schema_mismatches{};
+    /// Values that do not fit into the narrowed data type of their
+    /// column or attribute.
+    std::uint64_t num_overflows{};
+    /// The number of warnings about data instances that have not been
+    /// logged individually due to the rate limit. See @ref
+    /// Data_reader_params::warn_bad_instances.
+    std::uint64_t num_suppressed_warnings{};
+
+    /// The time, in nanoseconds, spent inferring or restoring the schema
+    /// of the dataset; this includes opening the first data store and
+    /// reading its header and sampled rows.
+    std::uint64_t schema_ns{};
+    /// The time, in nanoseconds, from the construction of the reader
+    /// until its first example was returned, or zero if no example has
+    /// been returned yet. This is the cold-start latency of the reader;
+    /// unlike the other values it is not reset along with the reader.
+    std::uint64_t first_example_ns{};
+
+    /// The length, in seconds, of the window.
+    double window_seconds{};
+    double examples_per_second{};
+    double instances_per_second{};
+
+    /// The statistics of the data stores read so far in the epoch.
+    std::vector<Store_stats> stores{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -35,6 +35,19 @@ public:
 
     virtual std::optional<Record> read_record_core() = 0;
 
+protected:
+    bool has_peeked_record() const noexcept
+    {
+        return peeked_record_ != std::nullopt;
+    }
+
+    /// Discards the peeked record, if any; must be called when the
+    /// position of the reader changes.
+    void discard_peeked_record() noexcept
+    {
+        peeked_record_ = std::nullopt;
+    }
+
 private:
     std::optional<Record> peeked_record_{};
 };
@@ -24,6 +24,7 @@
 #include "mlio/intrusive_ptr.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/record_reader_base.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -54,9 +55,48 @@ public:
     ///     should read-ahead from the underlying @ref Input_stream.
     void set_record_size_hint(std::size_t value) noexcept;
 
+    /// Restricts the reader to the records that start within the
+    /// specified shard of the underlying @ref Input_stream.
+    ///
+    /// The stream is split into @p num_shards byte ranges of equal
+    /// size and both ends of the range at @p shard_index are moved
+    /// forward to the next record boundary. This way each record is
+    /// read from exactly one shard without the need to scan the
+    /// ranges of the other shards.
+    ///
+    /// @return
+    ///     false if the stream is not seekable or the record format
+    ///     cannot be split; in such case the reader is left unchanged.
+    bool set_shard(std::size_t shard_index, std::size_t num_shards);
+
+    /// Returns the size of the underlying @ref Input_stream, or @c
+    /// std::nullopt if the stream is not seekable.
+    std::optional<std::size_t> stream_size() const;
+
+    /// Returns the position in the underlying @ref Input_stream right
+    /// after the last record read, or @c std::nullopt if a record has
+    /// been peeked.
+    std::optional<std::size_t> position() const noexcept;
+
+    /// Moves the reader to the specified position, which must have been
+    /// returned by @ref position(). The end of the shard set by @ref
+    /// set_shard() is retained.
+    ///
+    /// @return
+    ///     false if the stream is not seekable; in such case the reader
+    ///     is left unchanged.
+    bool seek(std::size_t position);
+
 protected:
     explicit Stream_record_reader(Intrusive_ptr<Input_stream> stream);
 
+    /// Returns the position in the underlying @ref Input_stream of the
+    /// chunk passed to @ref decode_record().
+    std::size_t chunk_position() const noexcept
+    {
+        return position_;
+    }
+
 private:
     MLIO_HIDDEN
     std::optional<Record> read_record_core() final;
@@ -72,8 +112,35 @@ private:
     ///     reader should throw an exception with a descriptive message.
     virtual std::optional<Record> decode_record(Memory_slice &chunk, bool ignore_leftover) = 0;
 
+    /// When implemented in a derived class, indicates whether the
+    /// reader can find a record boundary at an arbitrary position of
+    /// the stream.
+    virtual bool is_splittable() const noexcept;
+
+    /// When implemented in a derived class, returns the position of
+    /// the first record that starts at or after the specified position
+    /// of the stream.
+    ///
+    /// @param bits
+    ///     A memory span that holds the contents of the stream starting
+    ///     at the byte that precedes @p position.
+    /// @param position
+    ///     The position in the stream to search from.
+    /// @param ignore_leftover
+    ///     A boolean value indicating whether more bits can be read
+    ///     from the stream. If false and @p bits do not contain a
+    ///     record boundary, the reader should return the end of the
+    ///     stream.
+    virtual std::optional<std::size_t>
+    find_record_boundary(Memory_span bits, std::size_t position, bool ignore_leftover);
+
+    MLIO_HIDDEN
+    std::size_t find_record_boundary_at(std::size_t position, std::size_t size);
+
     std::unique_ptr<detail::Chunk_reader> chunk_reader_;
     Memory_slice chunk_{};
+    std::size_t position_{};
+    std::optional<std::size_t> end_{};
 };
 
 /// @}
@@ -15,12 +15,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
 
 #include "mlio/config.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
 #include "mlio/record_readers/stream_record_reader.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -50,6 +52,15 @@ private:
     ///     reader should throw an exception with a descriptive message.
     virtual std::optional<Record> decode_text_record(Memory_slice &chunk, bool ignore_leftover) = 0;
 
+    MLIO_HIDDEN
+    bool is_splittable() const noexcept override;
+
+    /// Returns the position of the first line that starts at or after
+    /// the specified position.
+    MLIO_HIDDEN
+    std::optional<std::size_t>
+    find_record_boundary(Memory_span bits, std::size_t position, bool ignore_leftover) final;
+
     MLIO_HIDDEN
     static bool skip_utf8_bom(Memory_slice &chunk, bool ignore_leftover) noexcept;
 };
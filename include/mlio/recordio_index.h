@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Holds the location of a RecordIO record in its data store.
+struct MLIO_API Recordio_index_entry {
+    /// The byte offset of the record header.
+    std::size_t offset{};
+    /// The size of the record in bytes including its header and
+    /// padding. For a split record this covers all of its parts.
+    std::size_t size{};
+};
+
+/// Scans the specified RecordIO data store and returns the location of
+/// each record in it.
+MLIO_API
+std::vector<Recordio_index_entry> build_recordio_index(const Data_store &store);
+
+/// Writes the specified index to a file.
+///
+/// An index file, conventionally stored next to its data store with an
+/// additional '.idx' extension, starts with the four bytes 'RIDX', a
+/// 32-bit version number, and a 64-bit entry count, followed by the
+/// offset and size of each record as 64-bit integers. All integers are
+/// stored in little-endian byte order.
+MLIO_API
+void write_recordio_index(const std::string &path, stdx::span<const Recordio_index_entry> entries);
+
+/// Reads the index stored in the specified data store.
+MLIO_API
+std::vector<Recordio_index_entry> read_recordio_index(const Data_store &store);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
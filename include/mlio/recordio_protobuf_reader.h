@@ -15,7 +15,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "mlio/config.h"
 #include "mlio/data_type.h"
@@ -36,11 +42,39 @@ inline namespace abi_v1 {
 /// @addtogroup data_readers Data Readers
 /// @{
 
+struct MLIO_API Recordio_protobuf_params final {
+    /// The data type of the features stored as float32 tensors. Can be
+    /// float32, float16, or bfloat16. Narrowing halves the size of the
+    /// examples and is done in bulk while the values are copied.
+    Data_type float32_data_type = Data_type::float32;
+    /// The data types of specific features keyed by their attribute
+    /// names; take precedence over @ref float32_data_type. Note that the
+    /// attribute names of the labels have the "label_" prefix. float32
+    /// features can be narrowed to float16 or bfloat16, float64 features
+    /// to float32, float16, or bfloat16, and int32 features to int8 or
+    /// int16. A value that does not fit into the narrowed data type
+    /// makes its instance a bad instance and is counted in @ref
+    /// Reader_stats::num_overflows.
+    std::unordered_map<std::string, Data_type> data_types{};
+    /// The dimensions to hash specific sparse features into, keyed by
+    /// their attribute names. The keys of such a feature are folded
+    /// modulo the dimension while the instances are decoded, and the
+    /// feature is output as a @ref Csr_tensor with int32 column indices
+    /// and index pointers regardless of @ref
+    /// Data_reader_params::sparse_tensor_format. The shape in the
+    /// RecordIO-protobuf messages is ignored, so features whose shape
+    /// does not fit into 64 bits can be read as well. Colliding keys
+    /// of an instance are kept as separate values. A dimension must be
+    /// between 1 and 2^31.
+    std::unordered_map<std::string, std::size_t> hash_dimensions{};
+};
+
 /// Represents a @ref Data_reader for reading Amazon SageMaker
 /// RecordIO-protobuf datasets.
 class MLIO_API Recordio_protobuf_reader final : public Parallel_data_reader {
 public:
-    explicit Recordio_protobuf_reader(Data_reader_params params);
+    explicit Recordio_protobuf_reader(Data_reader_params params,
+                                      Recordio_protobuf_params rp_params = {});
 
     Recordio_protobuf_reader(const Recordio_protobuf_reader &) = delete;
 
@@ -91,11 +125,51 @@ private:
     std::optional<std::size_t>
     decode_parallel(Decoder_state &state, const Instance_batch &batch) const;
 
+    MLIO_HIDDEN
+    void init_attribute_indices(const Schema &schema, std::size_t num_labels);
+
+    MLIO_HIDDEN
+    std::optional<std::size_t> get_attribute_index(std::string_view name, bool label) const;
+
+    MLIO_HIDDEN
+    static std::size_t hash_attribute_name(std::string_view name, bool label) noexcept;
+
+    MLIO_HIDDEN
+    std::size_t estimate_nnz(std::size_t attr_idx, std::size_t num_rows) const;
+
+    MLIO_HIDDEN
+    void update_nnz_estimate(std::size_t attr_idx,
+                             const detail::Sparse_tensor_builder &builder) const;
+
     MLIO_HIDDEN
     static const aialgs::data::Record *parse_proto(const Instance &instance);
 
+    Recordio_protobuf_params rp_params_;
+    // The data types of the features in the RecordIO-protobuf messages
+    // by attribute index; differ from the data types of the attributes
+    // if the features are narrowed.
+    std::vector<Data_type> source_data_types_{};
+    // The hash dimensions of the sparse features by attribute index;
+    // zero if the feature is not hashed.
+    std::vector<std::size_t> hash_dimensions_{};
     bool has_sparse_feature_{};
     std::size_t num_values_per_instance_{};
+    // An open-addressing hash table with linear probing of the schema
+    // indices of the labels and features keyed by their names in the
+    // RecordIO-protobuf message. The keys are views into the attribute
+    // names of the schema, so the map keys of a message are resolved
+    // without building any string.
+    struct Attribute_slot {
+        std::string_view name{};
+        std::size_t hash{};
+        // The schema index plus one; zero marks an empty slot.
+        std::size_t index{};
+        bool label{};
+    };
+    std::vector<Attribute_slot> attr_slots_{};
+    // The number of non-zero values per row of the sparse features in
+    // the last decoded batch; used to presize the sparse tensor builders.
+    mutable std::vector<std::atomic_size_t> nnz_per_row_estimates_{};
 };
 
 /// @}
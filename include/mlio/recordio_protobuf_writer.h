@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/data_writer.h"
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_writers Data Writers
+/// @{
+
+struct MLIO_API Recordio_protobuf_writer_params final {
+    /// The number of encoded bytes buffered before they are written to
+    /// the file.
+    std::size_t write_buffer_size = 0x40'0000;  // 4 MiB
+};
+
+/// Represents a @ref Data_writer that writes Amazon SageMaker
+/// RecordIO-protobuf datasets, which can be read with
+/// @ref Recordio_protobuf_reader.
+///
+/// Each instance of a written @ref Example becomes a record. The
+/// features whose names start with "label_" are written, without the
+/// prefix, to the label map of the record; this mirrors the naming used
+/// by @ref Recordio_protobuf_reader. The records of an @ref Example are
+/// encoded in parallel into a single buffer that is written to the file
+/// in large blocks.
+///
+/// @remark
+///     Dense tensors and @ref Coo_tensor "COO tensors" of the float32,
+///     float64, and int32 data types are supported.
+class MLIO_API Recordio_protobuf_writer final : public Data_writer {
+public:
+    explicit Recordio_protobuf_writer(std::string path,
+                                      Recordio_protobuf_writer_params params = {});
+
+    Recordio_protobuf_writer(const Recordio_protobuf_writer &) = delete;
+
+    Recordio_protobuf_writer &operator=(const Recordio_protobuf_writer &) = delete;
+
+    Recordio_protobuf_writer(Recordio_protobuf_writer &&) = delete;
+
+    Recordio_protobuf_writer &operator=(Recordio_protobuf_writer &&) = delete;
+
+    ~Recordio_protobuf_writer() final;
+
+    void write_example(const Example &example) final;
+
+    void close() final;
+
+    /// Returns the number of records written so far.
+    std::size_t num_records_written() const noexcept
+    {
+        return num_records_;
+    }
+
+private:
+    MLIO_HIDDEN
+    void flush();
+
+    MLIO_HIDDEN
+    void check_file() const;
+
+    std::string path_;
+    std::string tmp_path_;
+    Recordio_protobuf_writer_params params_;
+    std::ofstream file_{};
+    std::vector<std::byte> buffer_{};
+    std::size_t num_records_{};
+    bool closed_{};
+};
+
+/// Writes all examples read from the specified @ref Data_reader to a
+/// RecordIO-protobuf file. The reader is reset before the first example
+/// is read.
+MLIO_API
+void write_recordio_protobuf_file(const std::string &path,
+                                  Data_reader &reader,
+                                  const Recordio_protobuf_writer_params &params = {});
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -15,15 +15,16 @@
 
 #pragma once
 
-#include <functional>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <string_view>
-#include <utility>
-#include <vector>
 
+#include "mlio/config.h"
 #include "mlio/intrusive_ptr.h"
-#include "mlio/intrusive_ref_counter.h"
+#include "mlio/object_store_client.h"
+#include "mlio/s3_object_cache.h"
 #include "mlio/span.h"
 
 namespace Aws::S3 {
@@ -32,13 +33,54 @@ class S3Client;
 
 }  // namespace Aws::S3
 
+namespace Aws::S3Crt {
+
+class S3CrtClient;
+
+}  // namespace Aws::S3Crt
+
 namespace mlio {
 inline namespace abi_v1 {
 
+/// Holds the parameters for reading S3 objects with concurrent
+/// byte-range GET requests.
+using S3_range_read_params = Range_read_params;
+
+/// Holds the metadata of an S3 object as returned by a HEAD request.
+using S3_object_metadata = Object_metadata;
+
+/// Specifies how failed S3 requests are retried.
+enum class S3_retry_mode {
+    /// The default retry strategy of the AWS SDK.
+    legacy,
+    /// Exponential backoff with jitter, bounded by a retry quota.
+    standard,
+    /// Like @ref S3_retry_mode::standard, but additionally slows down
+    /// the client when S3 throttles its requests.
+    adaptive,
+};
+
 /// Represents a client to access Amazon S3.
-class MLIO_API S3_client : public Intrusive_ref_counter<S3_client> {
+///
+/// If no access key is specified, the credentials are looked up through
+/// the default credentials provider chain of the AWS SDK and refreshed
+/// in background before they expire, so that temporary credentials of
+/// long-running jobs never expire in the middle of a read.
+class MLIO_API S3_client final : public Object_store_client {
 public:
-    explicit S3_client(std::unique_ptr<Aws::S3::S3Client> native_client) noexcept;
+    /// @param object_cache
+    ///     The local cache through which the S3 objects opened with this
+    ///     client are read. If null, the objects are always read from S3.
+    explicit S3_client(std::unique_ptr<Aws::S3::S3Client> native_client,
+                       const S3_range_read_params &range_read_params = {},
+                       Intrusive_ptr<S3_object_cache> object_cache = {}) noexcept;
+
+    /// Constructs a client that accesses S3 through the AWS Common
+    /// Runtime, which splits each GET request into concurrent part
+    /// requests.
+    explicit S3_client(std::unique_ptr<Aws::S3Crt::S3CrtClient> native_client,
+                       const S3_range_read_params &range_read_params = {},
+                       Intrusive_ptr<S3_object_cache> object_cache = {}) noexcept;
 
     S3_client(const S3_client &) = delete;
 
@@ -48,24 +90,41 @@ public:
 
     S3_client &operator=(S3_client &&) = delete;
 
-    ~S3_client();
+    ~S3_client() final;
 
     void list_objects(std::string_view bucket,
                       std::string_view prefix,
-                      const std::function<void(std::string uri)> &callback) const;
+                      const List_callback &callback) const final;
 
     std::size_t read_object(std::string_view bucket,
                             std::string_view key,
                             std::string_view version_id,
                             std::size_t offset,
-                            Mutable_memory_span destination) const;
-
-    std::size_t read_object_size(std::string_view bucket,
-                                 std::string_view key,
-                                 std::string_view version_id) const;
+                            Mutable_memory_span destination) const final;
+
+    S3_object_metadata read_object_metadata(std::string_view bucket,
+                                            std::string_view key,
+                                            std::string_view version_id) const final;
+
+    std::string_view uri_scheme() const noexcept final
+    {
+        return "s3";
+    }
+
+    /// Opens the specified number of connections to the endpoint of
+    /// @p bucket ahead of time, so that the first byte-range requests
+    /// of a job do not pay for the TCP and TLS handshakes. The requests
+    /// are made concurrently and their errors are ignored.
+    ///
+    /// @param num_connections
+    ///     The number of connections to open; typically the number of
+    ///     parallel ranges of all objects that are read at the same
+    ///     time. It is bounded by @ref S3_client_options::max_connections.
+    void warm_up_connections(std::string_view bucket, std::size_t num_connections) const;
 
 private:
-    std::unique_ptr<Aws::S3::S3Client> native_client_;
+    std::unique_ptr<Aws::S3::S3Client> native_client_{};
+    std::unique_ptr<Aws::S3Crt::S3CrtClient> native_crt_client_{};
 };
 
 struct MLIO_API S3_client_options {
@@ -75,6 +134,36 @@ struct MLIO_API S3_client_options {
     std::string_view profile{};
     std::string_view region{};
     bool use_https{true};
+    S3_range_read_params range_read_params{};
+    Intrusive_ptr<S3_object_cache> object_cache{};
+    /// The maximum number of concurrent connections to S3. If zero, the
+    /// default of the AWS SDK is used, which is 25 for the classic
+    /// client.
+    std::size_t max_connections{};
+    /// The timeouts for establishing a connection and for receiving the
+    /// response of a request. If zero, the defaults of the AWS SDK are
+    /// used.
+    std::chrono::milliseconds connect_timeout{};
+    std::chrono::milliseconds request_timeout{};
+    /// See @ref S3_retry_mode.
+    S3_retry_mode retry_mode = S3_retry_mode::legacy;
+    /// The maximum number of attempts per request including the first
+    /// one. If zero, the default of the retry mode is used.
+    std::size_t max_attempts{};
+    /// The endpoint to use instead of the regional Amazon S3 endpoint;
+    /// for instance an S3-compatible storage service.
+    std::string_view endpoint_override{};
+    /// A boolean value indicating whether to address buckets as part of
+    /// the host name. Most S3-compatible services require path-style
+    /// addressing.
+    bool use_virtual_addressing{true};
+    /// A boolean value indicating whether to use the client of the AWS
+    /// Common Runtime instead of the classic client. Requires the
+    /// library to be built with S3 CRT support.
+    bool use_crt{};
+    /// The target throughput, in gigabits per second, that the CRT
+    /// client sizes its connection pool for.
+    double target_throughput_gbps = 10.0;
 };
 
 MLIO_API
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class S3_object_cache_fill;
+
+}  // namespace detail
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Represents a least-recently-used cache of S3 objects, or objects of
+/// any other @ref Object_store_client, on local disk.
+///
+/// The objects are keyed by their bucket, key, version, and ETag; an
+/// object that has been modified in the service is therefore never
+/// served from a stale copy. An object that is not in the cache is read
+/// from the service and written to the cache as it is being read; if it
+/// is read to the end, subsequent reads are served from the
+/// memory-mapped local file.
+class MLIO_API S3_object_cache : public Intrusive_ref_counter<S3_object_cache> {
+    friend class detail::S3_object_cache_fill;
+
+public:
+    /// @param directory
+    ///     The directory in which the objects are stored. It is created
+    ///     if it does not exist; objects cached by a previous process are
+    ///     reused.
+    /// @param max_size
+    ///     The maximum total size, in bytes, of the cached objects. Once
+    ///     exceeded, the least recently used objects are evicted.
+    explicit S3_object_cache(std::string directory, std::size_t max_size);
+
+    S3_object_cache(const S3_object_cache &) = delete;
+
+    S3_object_cache &operator=(const S3_object_cache &) = delete;
+
+    S3_object_cache(S3_object_cache &&) = delete;
+
+    S3_object_cache &operator=(S3_object_cache &&) = delete;
+
+    ~S3_object_cache();
+
+    /// Opens the specified object either from the cache or, if it is not
+    /// cached yet, through @p client.
+    Intrusive_ptr<Input_stream> open_read(const Intrusive_ptr<const Object_store_client> &client,
+                                          const std::string &uri,
+                                          const std::string &version_id,
+                                          const Range_read_params &range_read_params);
+
+    /// Gets the total size, in bytes, of the cached objects.
+    std::size_t size() const;
+
+    const std::string &directory() const noexcept
+    {
+        return directory_;
+    }
+
+    std::size_t max_size() const noexcept
+    {
+        return max_size_;
+    }
+
+private:
+    struct Entry {
+        std::size_t size{};
+        std::list<std::string>::iterator lru_pos{};
+    };
+
+    MLIO_HIDDEN
+    void load_entries();
+
+    MLIO_HIDDEN
+    void insert_entry(const std::string &name, std::size_t size);
+
+    MLIO_HIDDEN
+    void evict_entries();
+
+    MLIO_HIDDEN
+    void commit_fill(const std::string &name, const std::string &tmp_path, std::size_t size);
+
+    MLIO_HIDDEN
+    void abandon_fill(const std::string &name) noexcept;
+
+    MLIO_HIDDEN
+    std::string get_path(const std::string &name) const;
+
+    std::string directory_;
+    std::size_t max_size_;
+    std::size_t size_{};
+    // The names of the cached objects; the most recently used first.
+    std::list<std::string> lru_{};
+    std::unordered_map<std::string, Entry> entries_{};
+    // The names of the objects that are being written to the cache.
+    std::unordered_set<std::string> pending_{};
+    mutable std::mutex mutex_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -20,7 +20,7 @@
 #include <iostream>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 #include "mlio/config.h"
@@ -104,7 +104,12 @@ public:
     explicit Schema(std::vector<Attribute> attrs);
 
     /// Returns the index of the Attribute with the specified name.
-    std::optional<std::size_t> get_index(const std::string &name) const noexcept;
+    ///
+    /// @remark
+    ///     The name table is built once when the schema is constructed;
+    ///     the lookup neither allocates nor rehashes the attributes, so
+    ///     decoders can resolve names per instance.
+    std::optional<std::size_t> get_index(std::string_view name) const noexcept;
 
     std::string repr() const;
 
@@ -113,9 +118,28 @@ public:
         return attributes_;
     }
 
+    /// Returns the hash of the attributes, computed once when the schema
+    /// is constructed.
+    std::size_t hash() const noexcept
+    {
+        return hash_;
+    }
+
 private:
+    struct Name_slot {
+        std::size_t hash{};
+        // The index of the attribute plus one; zero marks an empty slot.
+        std::size_t index{};
+    };
+
+    MLIO_HIDDEN
+    void init_name_slots();
+
     std::vector<Attribute> attributes_;
-    std::unordered_map<std::string, std::size_t> name_index_map_;
+    // An open-addressing hash table with linear probing whose size is a
+    // power of two at least twice the number of attributes.
+    std::vector<Name_slot> name_slots_{};
+    std::size_t hash_{};
 };
 
 MLIO_API
@@ -149,7 +173,7 @@ template<>
 struct MLIO_API hash<mlio::Schema> {
     inline size_t operator()(const mlio::Schema &schema) const noexcept
     {
-        return mlio::detail::hash_range(schema.attributes());
+        return schema.hash();
     }
 };
 
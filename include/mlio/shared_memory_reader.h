@@ -0,0 +1,195 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/schema.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Shared_memory_segment;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Specifies how a @ref Shared_memory_reader_server should distribute
+/// the @ref Example "examples" among its clients.
+enum class Shared_memory_distribution {
+    /// Assign every num_clients'th @ref Example to the client. Each
+    /// client reads a fixed, disjoint shard of the dataset.
+    shard,
+    /// Hand out each @ref Example to the first client that asks for
+    /// one. Balances the load among clients of different speed at the
+    /// cost of a non-deterministic assignment.
+    first_available
+};
+
+struct MLIO_API Shared_memory_server_params final {
+    /// The number of client processes that will attach to the server.
+    std::size_t num_clients = 1;
+    /// The number of @ref Example "examples" that can be published at
+    /// the same time; this includes the ones held by the clients. If
+    /// zero, defaults to four times @ref num_clients.
+    std::size_t num_slots{};
+    /// The maximum size, in bytes, of a published @ref Example. If
+    /// zero, defaults to twice the size of the first example.
+    std::size_t slot_size{};
+    /// See @ref Shared_memory_distribution.
+    Shared_memory_distribution distribution = Shared_memory_distribution::shard;
+};
+
+/// Represents a server that reads the @ref Example "examples" of a @ref
+/// Data_reader in background and publishes them into a named POSIX
+/// shared memory segment. This way several processes on the same host,
+/// such as the workers of a data loader or the processes of a multi-GPU
+/// training job, can consume a dataset that is fetched and decoded only
+/// once. The clients attach via @ref Shared_memory_reader.
+///
+/// Each epoch of the inner reader is published once; the server starts
+/// the next epoch once every attached client has called @ref
+/// Data_reader::reset(). The segment is removed when the server is
+/// destroyed.
+///
+/// @remark
+///     Only dense features of numeric data types can be published.
+class MLIO_API Shared_memory_reader_server {
+public:
+    explicit Shared_memory_reader_server(Intrusive_ptr<Data_reader> reader,
+                                         std::string name,
+                                         Shared_memory_server_params params = {});
+
+    Shared_memory_reader_server(const Shared_memory_reader_server &) = delete;
+
+    Shared_memory_reader_server &operator=(const Shared_memory_reader_server &) = delete;
+
+    Shared_memory_reader_server(Shared_memory_reader_server &&) = delete;
+
+    Shared_memory_reader_server &operator=(Shared_memory_reader_server &&) = delete;
+
+    ~Shared_memory_reader_server();
+
+    /// Stops the server. The clients that are waiting for an @ref
+    /// Example get an error; the examples that are already held by the
+    /// clients remain valid.
+    void stop() noexcept;
+
+    const std::string &name() const noexcept
+    {
+        return name_;
+    }
+
+private:
+    MLIO_HIDDEN
+    void run() noexcept;
+
+    MLIO_HIDDEN
+    bool run_epoch(std::uint64_t epoch);
+
+    MLIO_HIDDEN
+    bool publish(const Example &example, std::uint64_t epoch, std::uint64_t sequence);
+
+    MLIO_HIDDEN
+    std::optional<std::size_t>
+    acquire_slot(std::unique_lock<detail::Shared_memory_segment> &lock);
+
+    MLIO_HIDDEN
+    bool epoch_abandoned(std::uint64_t epoch);
+
+    Intrusive_ptr<Data_reader> reader_;
+    std::string name_;
+    Shared_memory_server_params params_;
+    Intrusive_ptr<detail::Shared_memory_segment> segment_;
+    std::thread thread_{};
+};
+
+/// Represents a @ref Data_reader that reads the @ref Example "examples"
+/// published by a @ref Shared_memory_reader_server, possibly running in
+/// another process.
+///
+/// The tensors of the returned examples point directly into the shared
+/// memory segment; the slot of an example is handed back to the server
+/// once all of its tensors are destroyed. Holding on to more examples
+/// than the server has slots stalls the server.
+class MLIO_API Shared_memory_reader final : public Data_reader {
+public:
+    /// @param name
+    ///     The name of the server.
+    /// @param client_index
+    ///     The index of the client between zero and the number of
+    ///     clients of the server. Each client process must use a
+    ///     distinct index.
+    explicit Shared_memory_reader(std::string name, std::size_t client_index = 0);
+
+    Shared_memory_reader(const Shared_memory_reader &) = delete;
+
+    Shared_memory_reader &operator=(const Shared_memory_reader &) = delete;
+
+    Shared_memory_reader(Shared_memory_reader &&) = delete;
+
+    Shared_memory_reader &operator=(Shared_memory_reader &&) = delete;
+
+    ~Shared_memory_reader() final;
+
+    Intrusive_ptr<const Schema> read_schema() final;
+
+    Intrusive_ptr<Example> read_example() final;
+
+    Intrusive_ptr<Example> peek_example() final;
+
+    void reset() noexcept final;
+
+    std::size_t num_bytes_read() const noexcept final;
+
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+    std::size_t client_index() const noexcept
+    {
+        return client_index_;
+    }
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> read_example_core();
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> make_example(std::size_t slot_index, std::size_t size);
+
+    Intrusive_ptr<detail::Shared_memory_segment> segment_;
+    std::size_t client_index_;
+    Intrusive_ptr<const Schema> schema_{};
+    std::uint64_t epoch_{};
+    std::size_t num_bytes_read_{};
+    Intrusive_ptr<Example> peeked_example_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
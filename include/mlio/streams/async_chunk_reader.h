@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Represents a chunk read by an @ref Async_chunk_reader.
+struct MLIO_API Async_chunk {
+    /// The index of the stream the chunk has been read from.
+    std::size_t stream_idx{};
+    Memory_slice data{};
+};
+
+/// Reads a set of input streams in chunks with a single thread by
+/// keeping one @ref Input_stream::read_async() call in flight on each
+/// stream, and returns the chunks in the order their reads complete.
+///
+/// Only the streams that support asynchronous reads, such as S3 objects
+/// read with concurrent byte-range requests and files read through
+/// io_uring, are read concurrently; the others are read inline when
+/// their next read is started.
+class MLIO_API Async_chunk_reader {
+public:
+    explicit Async_chunk_reader(std::vector<Intrusive_ptr<Input_stream>> streams,
+                                std::size_t chunk_size = 0x10'0000);  // 1 MiB
+
+    Async_chunk_reader(const Async_chunk_reader &) = delete;
+
+    Async_chunk_reader &operator=(const Async_chunk_reader &) = delete;
+
+    Async_chunk_reader(Async_chunk_reader &&) = delete;
+
+    Async_chunk_reader &operator=(Async_chunk_reader &&) = delete;
+
+    /// Waits for the reads that are still in flight.
+    ~Async_chunk_reader();
+
+    /// Returns the next chunk read from any of the streams, or an empty
+    /// optional once all streams have reached their end. If a read has
+    /// failed, its exception is rethrown.
+    std::optional<Async_chunk> read_chunk();
+
+private:
+    struct Completion {
+        std::size_t stream_idx{};
+        Intrusive_ptr<Mutable_memory_block> block{};
+        std::size_t num_bytes_read{};
+        std::exception_ptr error{};
+    };
+
+    MLIO_HIDDEN
+    void start_read(std::size_t stream_idx);
+
+    std::vector<Intrusive_ptr<Input_stream>> streams_;
+    std::size_t chunk_size_;
+    bool started_{};
+    // The number of streams that have not reached their end.
+    std::size_t num_active_streams_;
+    std::size_t num_in_flight_{};
+    std::deque<Completion> completions_{};
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,10 +16,12 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 #include "mlio/config.h"
 #include "mlio/detail/file_descriptor.h"
+#include "mlio/fwd.h"
 #include "mlio/span.h"
 #include "mlio/streams/input_stream_base.h"
 
@@ -29,14 +31,64 @@ inline namespace abi_v1 {
 /// @addtogroup streams Streams
 /// @{
 
+/// Holds the I/O parameters for @ref File_input_stream.
+struct MLIO_API File_io_params {
+    /// A boolean value indicating whether the file should be read via
+    /// io_uring with multiple outstanding reads. If the kernel does not
+    /// support io_uring, the stream falls back to regular reads.
+    bool use_io_uring = false;
+    /// The number of reads to keep in flight when using io_uring.
+    std::size_t queue_depth = 8;
+    /// The size of each read when using io_uring. Rounded up to a
+    /// multiple of the page size.
+    std::size_t block_size = 0x10'0000;  // 1 MiB
+    /// A boolean value indicating whether the file should be opened
+    /// with @c O_DIRECT to bypass the page cache. Only applies when
+    /// using io_uring; ignored if the file system does not support it.
+    bool direct_io = false;
+};
+
+/// Gets the I/O parameters that are used by default for file streams.
+MLIO_API
+const File_io_params &default_file_io_params() noexcept;
+
+/// Sets the I/O parameters that are used by default for file streams.
+///
+/// @remark
+///     This function is not thread-safe and should be called before
+///     any file is opened.
+MLIO_API
+void set_default_file_io_params(const File_io_params &params) noexcept;
+
 class MLIO_API File_input_stream final : public Input_stream_base {
 public:
-    explicit File_input_stream(std::string path);
+    explicit File_input_stream(std::string path,
+                               const File_io_params &params = default_file_io_params());
+
+    File_input_stream(const File_input_stream &) = delete;
+
+    File_input_stream &operator=(const File_input_stream &) = delete;
+
+    File_input_stream(File_input_stream &&) = delete;
+
+    File_input_stream &operator=(File_input_stream &&) = delete;
+
+    ~File_input_stream() final;
 
     using Input_stream_base::read;
 
     std::size_t read(Mutable_memory_span destination) final;
 
+    /// If the file is read through io_uring, the read completes on a
+    /// background thread that is shared by all files of the process.
+    void read_async(Mutable_memory_span destination, Read_completion_handler handler) final;
+
+    using Input_stream_base::read_at;
+
+    /// Reads with pread(2), so neither the position of the stream nor
+    /// the reads in flight through io_uring are affected.
+    std::size_t read_at(std::size_t offset, Mutable_memory_span destination) final;
+
     void seek(std::size_t position) final;
 
     void close() noexcept final;
@@ -55,6 +107,16 @@ public:
         return true;
     }
 
+    bool supports_async_read() const noexcept final
+    {
+        return uring_reader_ != nullptr;
+    }
+
+    bool supports_read_at() const noexcept final
+    {
+        return true;
+    }
+
 private:
     MLIO_HIDDEN
     void check_if_closed() const;
@@ -62,6 +124,7 @@ private:
     std::string path_;
     detail::File_descriptor fd_{};
     mutable std::size_t size_{};
+    std::unique_ptr<detail::Io_uring_file_reader> uring_reader_{};
 };
 
 /// @}
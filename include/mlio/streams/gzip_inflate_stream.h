@@ -32,11 +32,47 @@ inline namespace abi_v1 {
 /// @addtogroup streams Streams
 /// @{
 
+/// Specifies the library that inflates gzip streams.
+enum class Inflate_backend {
+    /// Intel ISA-L if the library was built with it; otherwise zlib.
+    automatic,
+    zlib,
+    /// Intel ISA-L; requires @ref supports_isal().
+    isal,
+};
+
+/// Holds the parameters for @ref Gzip_inflate_stream.
+struct MLIO_API Gzip_inflate_params {
+    /// The library that inflates the stream.
+    Inflate_backend backend = Inflate_backend::automatic;
+    /// The number of compressed bytes to read from the underlying
+    /// stream at once. If zero, it is chosen based on the underlying
+    /// stream; streams that can be read without copying, like
+    /// memory-mapped files, and streams that read ahead asynchronously,
+    /// like S3 objects read with concurrent ranges, are read in larger
+    /// pieces.
+    std::size_t input_buffer_size{};
+};
+
+/// Gets the parameters that are used by default for gzip streams.
+MLIO_API
+const Gzip_inflate_params &default_gzip_inflate_params() noexcept;
+
+/// Sets the parameters that are used by default for gzip streams.
+///
+/// @remark
+///     This function is not thread-safe and should be called before
+///     any gzip stream is opened.
+MLIO_API
+void set_default_gzip_inflate_params(const Gzip_inflate_params &params) noexcept;
+
 /// Represents an @ref Input_stream that inflates an underlying
 /// stream that was deflated with gzip or zlib.
 class MLIO_API Gzip_inflate_stream final : public Input_stream_base {
 public:
-    explicit Gzip_inflate_stream(Intrusive_ptr<Input_stream> inner);
+    explicit Gzip_inflate_stream(
+        Intrusive_ptr<Input_stream> inner,
+        const Gzip_inflate_params &params = default_gzip_inflate_params());
 
     Gzip_inflate_stream(const Gzip_inflate_stream &) = delete;
 
@@ -50,6 +86,7 @@ public:
 
     using Input_stream_base::read;
 
+    /// Inflates directly into @p destination.
     std::size_t read(Mutable_memory_span destination) final;
 
     void close() noexcept final;
@@ -61,7 +98,8 @@ private:
     void check_if_closed() const;
 
     Intrusive_ptr<Input_stream> inner_;
-    std::unique_ptr<detail::Zlib_inflater> inflater_;
+    std::unique_ptr<detail::Inflater> inflater_{};
+    std::size_t input_buffer_size_;
     Memory_slice buffer_{};
     Memory_block::iterator buffer_pos_ = buffer_.begin();
 };
@@ -16,6 +16,9 @@
 #pragma once
 
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
 
 #include "mlio/config.h"
 #include "mlio/intrusive_ref_counter.h"
@@ -28,6 +31,13 @@ inline namespace abi_v1 {
 /// @addtogroup streams Streams
 /// @{
 
+/// The function that is called once an asynchronous read completes. If
+/// the read has failed, @p error holds its exception; otherwise it is
+/// null and @p num_bytes_read holds the number of bytes read, zero
+/// meaning the end of the stream.
+using Read_completion_handler =
+    std::function<void(std::size_t num_bytes_read, std::exception_ptr error)>;
+
 /// Represents an input stream of bytes.
 class MLIO_API Input_stream : public Intrusive_ref_counter<Input_stream> {
 public:
@@ -47,6 +57,35 @@ public:
 
     virtual Memory_slice read(std::size_t size) = 0;
 
+    /// Starts reading into @p destination and returns without waiting
+    /// for the data.
+    ///
+    /// @p handler is called exactly once; either from within this call
+    /// if the data is already available, or later from a background
+    /// thread of the stream. Until then @p destination must stay valid
+    /// and the stream must not be used. Streams that do not support
+    /// asynchronous reads perform a regular read and call @p handler
+    /// before returning; see @ref supports_async_read().
+    virtual void read_async(Mutable_memory_span destination, Read_completion_handler handler);
+
+    /// Reads up to the size of @p destination bytes starting at @p
+    /// offset, without using or changing the position of the stream.
+    /// Unlike the other read functions, it can be called concurrently
+    /// from multiple threads; this way independent parts of a stream,
+    /// e.g. the column chunks of a Parquet file, can be read in
+    /// parallel. Returns zero if @p offset is at or beyond the end of
+    /// the stream.
+    ///
+    /// Streams that do not support positional reads throw @ref
+    /// Not_supported_error; see @ref supports_read_at().
+    virtual std::size_t read_at(std::size_t offset, Mutable_memory_span destination);
+
+    /// Reads @p size bytes starting at @p offset; fewer only if the end
+    /// of the stream is reached. Streams that support zero-copy reading
+    /// return a slice of their data. See the other overload for the
+    /// details.
+    virtual Memory_slice read_at(std::size_t offset, std::size_t size);
+
     virtual void seek(std::size_t position) = 0;
 
     virtual void close() noexcept = 0;
@@ -60,8 +99,26 @@ public:
     virtual bool seekable() const noexcept = 0;
 
     virtual bool supports_zero_copy() const noexcept = 0;
+
+    /// Indicates whether @ref read_async() can return before the data
+    /// is read.
+    virtual bool supports_async_read() const noexcept
+    {
+        return false;
+    }
+
+    /// Indicates whether the stream supports @ref read_at().
+    virtual bool supports_read_at() const noexcept
+    {
+        return false;
+    }
 };
 
+/// Starts an asynchronous read on @p stream and returns a future that
+/// holds the number of bytes read once it completes.
+MLIO_API
+std::future<std::size_t> read_async(Input_stream &stream, Mutable_memory_span destination);
+
 /// @}
 
 }  // namespace abi_v1
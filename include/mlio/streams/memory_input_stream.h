@@ -40,6 +40,10 @@ public:
 
     Memory_slice read(std::size_t size) final;
 
+    std::size_t read_at(std::size_t offset, Mutable_memory_span destination) final;
+
+    Memory_slice read_at(std::size_t offset, std::size_t size) final;
+
     void seek(std::size_t position) final;
 
     void close() noexcept final;
@@ -63,6 +67,11 @@ public:
         return true;
     }
 
+    bool supports_read_at() const noexcept final
+    {
+        return true;
+    }
+
 private:
     MLIO_HIDDEN
     void advance_position(std::size_t distance) noexcept;
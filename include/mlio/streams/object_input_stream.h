@@ -0,0 +1,259 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/object_store_client.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Object_input_stream_access;
+
+}  // namespace detail
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Reads an object through an @ref Object_store_client, optionally with
+/// concurrent byte-range GET requests issued by background threads.
+class MLIO_API Object_input_stream final : public Input_stream_base {
+    friend struct detail::Object_input_stream_access;
+
+public:
+    Object_input_stream(const Object_input_stream &) = delete;
+
+    Object_input_stream &operator=(const Object_input_stream &) = delete;
+
+    Object_input_stream(Object_input_stream &&) = delete;
+
+    Object_input_stream &operator=(Object_input_stream &&) = delete;
+
+    ~Object_input_stream() final;
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    /// If the object is read with concurrent byte-range requests, the
+    /// read completes on the background thread that fetches the range
+    /// at the current position.
+    void read_async(Mutable_memory_span destination, Read_completion_handler handler) final;
+
+    using Input_stream_base::read_at;
+
+    /// Reads with a byte-range GET request of its own, independently of
+    /// the ranges that are fetched in background.
+    std::size_t read_at(std::size_t offset, Mutable_memory_span destination) final;
+
+    void seek(std::size_t position) final;
+
+    void close() noexcept final;
+
+    std::size_t size() const final
+    {
+        return size_;
+    }
+
+    std::size_t position() const final
+    {
+        return position_;
+    }
+
+    bool closed() const noexcept final
+    {
+        return closed_;
+    }
+
+    bool seekable() const noexcept final
+    {
+        return true;
+    }
+
+    bool supports_async_read() const noexcept final
+    {
+        return num_parallel_ranges_ > 1;
+    }
+
+    bool supports_read_at() const noexcept final
+    {
+        return true;
+    }
+
+private:
+    using Fetch_clock = std::chrono::steady_clock;
+
+    // Represents a byte range of the object that is fetched by one of
+    // the background threads.
+    struct Range {
+        std::unique_ptr<std::byte[]> data{};
+        std::size_t offset{};
+        std::size_t size{};
+        bool ready{};
+        std::exception_ptr exception_ptr{};
+        // Incremented every time the range is reissued so that a late
+        // request of a previous issue can be told apart.
+        std::uint64_t generation{};
+        // The number of requests, including a hedge, fetching the range.
+        std::size_t num_requests{};
+        bool hedged{};
+        std::optional<Fetch_clock::time_point> started_at{};
+    };
+
+    // Represents a request for a range that is made by a background
+    // thread.
+    struct Range_request {
+        std::size_t range_idx{};
+        std::uint64_t generation{};
+        std::size_t offset{};
+        std::size_t size{};
+        std::unique_ptr<std::byte[]> data{};
+        bool is_hedge{};
+        Fetch_clock::time_point started_at{};
+    };
+
+    struct Pending_read {
+        Mutable_memory_span destination{};
+        Read_completion_handler handler{};
+    };
+
+    explicit Object_input_stream(Intrusive_ptr<const Object_store_client> client,
+                                 std::string bucket,
+                                 std::string key,
+                                 std::string version_id,
+                                 const Range_read_params &range_read_params);
+
+    MLIO_HIDDEN
+    void fetch_size();
+
+    MLIO_HIDDEN
+    std::size_t read_ranges(Mutable_memory_span destination);
+
+    MLIO_HIDDEN
+    std::size_t
+    consume_front_range(std::unique_lock<std::mutex> &lock, Mutable_memory_span destination);
+
+    MLIO_HIDDEN
+    void complete_read(std::unique_lock<std::mutex> &lock,
+                       Mutable_memory_span destination,
+                       const Read_completion_handler &handler);
+
+    MLIO_HIDDEN
+    void issue_ranges();
+
+    MLIO_HIDDEN
+    void run_fetch();
+
+    MLIO_HIDDEN
+    void run_hedge();
+
+    MLIO_HIDDEN
+    std::optional<std::size_t> find_range_to_hedge(Fetch_clock::time_point now,
+                                                   Fetch_clock::time_point &next_check);
+
+    MLIO_HIDDEN
+    Range_request make_request(std::size_t range_idx, bool is_hedge);
+
+    MLIO_HIDDEN
+    std::exception_ptr fetch_range(Range_request &request);
+
+    MLIO_HIDDEN
+    void complete_request(Range_request &request, std::exception_ptr exception_ptr);
+
+    MLIO_HIDDEN
+    void record_latency(Fetch_clock::duration latency);
+
+    MLIO_HIDDEN
+    void cancel_ranges();
+
+    MLIO_HIDDEN
+    void stop() noexcept;
+
+    MLIO_HIDDEN
+    void check_if_closed() const;
+
+    Intrusive_ptr<const Object_store_client> client_;
+    std::string bucket_;
+    std::string key_;
+    std::string version_id_;
+    bool closed_{};
+    std::size_t size_{};
+    std::size_t position_{};
+
+    std::size_t num_parallel_ranges_;
+    std::size_t range_size_;
+    bool hedge_requests_;
+    double hedge_budget_;
+    std::vector<Range> ranges_{};
+    std::vector<std::thread> threads_{};
+    std::deque<std::size_t> window_{};
+    std::deque<std::size_t> fetch_queue_{};
+    std::deque<std::size_t> free_ranges_{};
+    std::size_t next_range_offset_{};
+    std::size_t num_in_flight_{};
+    // The latencies of the most recent range requests, excluding the
+    // hedges, from which the hedge delay is derived.
+    std::vector<Fetch_clock::duration> latencies_{};
+    std::size_t latency_pos_{};
+    std::optional<Fetch_clock::duration> hedge_delay_{};
+    std::size_t num_fetched_ranges_{};
+    std::size_t num_hedges_{};
+    std::mutex mutex_{};
+    std::condition_variable fetch_condition_{};
+    std::condition_variable hedge_condition_{};
+    std::condition_variable read_condition_{};
+    // The asynchronous read waiting for the range at the front of the
+    // window to be fetched.
+    std::optional<Pending_read> pending_read_{};
+    bool stopping_{};
+};
+
+/// @param range_read_params
+///     The parameters for reading the object with concurrent byte-range
+///     GET requests. If not specified, the parameters of @p client are
+///     used.
+/// @param size
+///     The size of the object, if already known, for instance from a
+///     listing. If not specified, it is retrieved with a HEAD request.
+MLIO_API
+Intrusive_ptr<Object_input_stream>
+make_object_input_stream(Intrusive_ptr<const Object_store_client> client,
+                         const std::string &uri,
+                         std::string version_id = {},
+                         const std::optional<Range_read_params> &range_read_params = {},
+                         std::optional<std::size_t> size = {});
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
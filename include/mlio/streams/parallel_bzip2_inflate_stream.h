@@ -0,0 +1,124 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream_base.h"
+#include "mlio/streams/parallel_gzip_inflate_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Bzip2_blocks;
+struct Bzip2_task;
+class Inflate_task_scheduler;
+
+}  // namespace detail
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Represents an @ref Input_stream that inflates a bzip2 stream by
+/// splitting it at its block boundaries and inflating the blocks as
+/// parallel tasks.
+///
+/// Unlike deflate, bzip2 compresses each block independently, so every
+/// block can be inflated on its own. Since the block markers are not
+/// aligned to a byte boundary and can also occur by chance within the
+/// compressed data, a task is only used if it starts exactly where the
+/// preceding one ended; otherwise the stream inflates the block itself.
+/// The checksum of each stream is verified as the stream is read.
+///
+/// @remark
+///     The underlying stream must support zero-copy reading (e.g. a
+///     memory-mapped file).
+class MLIO_API Parallel_bzip2_inflate_stream final : public Input_stream_base {
+public:
+    explicit Parallel_bzip2_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                           const Parallel_inflate_params &params = {});
+
+    Parallel_bzip2_inflate_stream(const Parallel_bzip2_inflate_stream &) = delete;
+
+    Parallel_bzip2_inflate_stream &operator=(const Parallel_bzip2_inflate_stream &) = delete;
+
+    Parallel_bzip2_inflate_stream(Parallel_bzip2_inflate_stream &&) = delete;
+
+    Parallel_bzip2_inflate_stream &operator=(Parallel_bzip2_inflate_stream &&) = delete;
+
+    ~Parallel_bzip2_inflate_stream() final;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    Memory_slice read(std::size_t size) final;
+
+    void close() noexcept final;
+
+    bool closed() const noexcept final;
+
+private:
+    MLIO_HIDDEN
+    bool next_chunk();
+
+    MLIO_HIDDEN
+    bool next_task_blocks();
+
+    MLIO_HIDDEN
+    void next_serial_block();
+
+    MLIO_HIDDEN
+    void append_blocks(detail::Bzip2_blocks &blocks);
+
+    MLIO_HIDDEN
+    void schedule_tasks();
+
+    MLIO_HIDDEN
+    std::size_t find_block(std::size_t first) const noexcept;
+
+    MLIO_HIDDEN
+    void cancel_tasks() noexcept;
+
+    MLIO_HIDDEN
+    void check_if_closed() const;
+
+    Intrusive_ptr<Input_stream> inner_;
+    Memory_slice input_;
+    std::size_t chunk_size_;
+    std::size_t max_num_tasks_;
+    std::unique_ptr<detail::Inflate_task_scheduler> scheduler_;
+    std::deque<std::shared_ptr<detail::Bzip2_task>> tasks_{};
+    // The positions below are in bits.
+    std::size_t pos_{};
+    std::size_t scan_pos_{};
+    std::uint32_t crc_{};
+    bool eof_{};
+    std::deque<Memory_slice> blocks_{};
+    Memory_slice chunk_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
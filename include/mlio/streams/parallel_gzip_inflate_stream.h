@@ -0,0 +1,143 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Gzip_decoder;
+struct Gzip_task;
+class Inflate_task_scheduler;
+
+}  // namespace detail
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Holds the parameters for @ref Parallel_gzip_inflate_stream and
+/// @ref Parallel_bzip2_inflate_stream.
+struct MLIO_API Parallel_inflate_params {
+    /// The approximate number of compressed bytes to inflate in a single
+    /// task.
+    std::size_t chunk_size = 0x40'0000;  // 4 MiB
+    /// The maximum number of tasks to keep in flight. If zero, the
+    /// concurrency of the TBB thread pool is used.
+    std::size_t max_num_tasks{};
+};
+
+/// Represents an @ref Input_stream that inflates a gzip stream by
+/// splitting it at its sync points and inflating the parts as parallel
+/// tasks. A sync point is either the start of a gzip member, which
+/// covers multi-member and BGZF files, or a deflate block following a
+/// full flush as emitted by tools like pigz.
+///
+/// Since a flush marker found in the compressed data can be a false
+/// positive, a part is only used if the inflation of the preceding
+/// part ends exactly at its start; otherwise the stream inflates the
+/// data itself. If the speculation keeps failing (e.g. a pigz stream
+/// whose blocks reference each other), the stream falls back to serial
+/// inflation.
+///
+/// @remark
+///     The underlying stream must support zero-copy reading (e.g. a
+///     memory-mapped file).
+class MLIO_API Parallel_gzip_inflate_stream final : public Input_stream_base {
+public:
+    explicit Parallel_gzip_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                          const Parallel_inflate_params &params = {});
+
+    Parallel_gzip_inflate_stream(const Parallel_gzip_inflate_stream &) = delete;
+
+    Parallel_gzip_inflate_stream &operator=(const Parallel_gzip_inflate_stream &) = delete;
+
+    Parallel_gzip_inflate_stream(Parallel_gzip_inflate_stream &&) = delete;
+
+    Parallel_gzip_inflate_stream &operator=(Parallel_gzip_inflate_stream &&) = delete;
+
+    ~Parallel_gzip_inflate_stream() final;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    Memory_slice read(std::size_t size) final;
+
+    void close() noexcept final;
+
+    bool closed() const noexcept final;
+
+private:
+    MLIO_HIDDEN
+    bool next_chunk();
+
+    MLIO_HIDDEN
+    bool next_task_chunk();
+
+    MLIO_HIDDEN
+    bool next_serial_chunk();
+
+    MLIO_HIDDEN
+    void schedule_tasks();
+
+    MLIO_HIDDEN
+    void discard_task();
+
+    MLIO_HIDDEN
+    void append_to_window(Memory_span data);
+
+    MLIO_HIDDEN
+    void cancel_tasks() noexcept;
+
+    MLIO_HIDDEN
+    void check_if_closed() const;
+
+    Intrusive_ptr<Input_stream> inner_;
+    Memory_slice input_;
+    std::size_t chunk_size_;
+    std::size_t max_num_tasks_;
+    std::unique_ptr<detail::Inflate_task_scheduler> scheduler_;
+    std::deque<std::shared_ptr<detail::Gzip_task>> tasks_{};
+    std::optional<std::size_t> next_task_start_{};
+    std::size_t scan_pos_{};
+    std::size_t num_failures_{};
+    bool speculate_ = true;
+    std::size_t pos_{};
+    std::uint32_t crc_{};
+    std::uint64_t crc_size_{};
+    bool eof_{};
+    std::unique_ptr<detail::Gzip_decoder> decoder_{};
+    std::size_t decoder_stop_{};
+    std::vector<std::byte> window_{};
+    Memory_slice chunk_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
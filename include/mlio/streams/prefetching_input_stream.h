@@ -0,0 +1,146 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "mlio/config.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Holds the parameters for @ref Prefetching_input_stream.
+struct MLIO_API Prefetch_params {
+    /// The number of bytes to read from the underlying stream at once.
+    std::size_t chunk_size = 0x10'0000;  // 1 MiB
+    /// The number of chunks to keep in flight. If zero, data stores
+    /// won't wrap the streams they open with a prefetcher.
+    std::size_t depth{};
+};
+
+/// Represents an @ref Input_stream that reads ahead an underlying
+/// stream on a background thread so that I/O and decompression
+/// latency overlap with the consumption of the data.
+class MLIO_API Prefetching_input_stream final : public Input_stream_base {
+public:
+    explicit Prefetching_input_stream(Intrusive_ptr<Input_stream> inner,
+                                      const Prefetch_params &params = {});
+
+    Prefetching_input_stream(const Prefetching_input_stream &) = delete;
+
+    Prefetching_input_stream &operator=(const Prefetching_input_stream &) = delete;
+
+    Prefetching_input_stream(Prefetching_input_stream &&) = delete;
+
+    Prefetching_input_stream &operator=(Prefetching_input_stream &&) = delete;
+
+    ~Prefetching_input_stream() final;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    Memory_slice read(std::size_t size) final;
+
+    /// Reads directly from the underlying stream; the prefetched chunks
+    /// are not affected.
+    std::size_t read_at(std::size_t offset, Mutable_memory_span destination) final;
+
+    Memory_slice read_at(std::size_t offset, std::size_t size) final;
+
+    void seek(std::size_t position) final;
+
+    void close() noexcept final;
+
+    std::size_t size() const final;
+
+    std::size_t position() const final;
+
+    bool closed() const noexcept final;
+
+    bool seekable() const noexcept final
+    {
+        return inner_->seekable();
+    }
+
+    bool supports_read_at() const noexcept final
+    {
+        return inner_->supports_read_at();
+    }
+
+private:
+    MLIO_HIDDEN
+    bool next_chunk();
+
+    MLIO_HIDDEN
+    void run_prefetch();
+
+    MLIO_HIDDEN
+    void stop() noexcept;
+
+    MLIO_HIDDEN
+    void check_if_closed() const;
+
+    Intrusive_ptr<Input_stream> inner_;
+    std::size_t chunk_size_;
+    std::size_t depth_;
+    std::thread thread_{};
+    std::deque<Memory_slice> chunks_{};
+    std::mutex mutex_;
+    std::condition_variable fill_condition_{};
+    std::condition_variable read_condition_{};
+    std::exception_ptr exception_ptr_{};
+    bool eof_{};
+    bool stopping_{};
+    Memory_slice chunk_{};
+    std::size_t position_{};
+};
+
+/// Wraps the specified stream with a @ref Prefetching_input_stream
+/// unless @p params disables prefetching or the stream can already be
+/// read without copying (e.g. a memory-mapped file).
+MLIO_API
+Intrusive_ptr<Input_stream>
+make_prefetching_stream(Intrusive_ptr<Input_stream> &&stream, const Prefetch_params &params);
+
+/// Gets the prefetch parameters that data stores use for the streams
+/// they open.
+MLIO_API
+const Prefetch_params &default_prefetch_params() noexcept;
+
+/// Sets the prefetch parameters that data stores use for the streams
+/// they open.
+///
+/// @remark
+///     This function is not thread-safe and should be called before
+///     any data store is opened.
+MLIO_API
+void set_default_prefetch_params(const Prefetch_params &params) noexcept;
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -17,6 +17,8 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -31,12 +33,26 @@ inline namespace abi_v1 {
 namespace detail {
 
 struct Sagemaker_pipe_input_stream_access;
+struct Sagemaker_pipe_counters;
 
 }  // namespace detail
 
 /// @addtogroup streams Streams
 /// @{
 
+/// Holds the I/O statistics of a SageMaker pipe channel.
+struct MLIO_API Sagemaker_pipe_stats {
+    std::uint64_t num_bytes_read{};
+    /// The number of read calls that returned data.
+    std::uint64_t num_reads{};
+    /// The number of times the reader found the FIFO empty and had to
+    /// wait for SageMaker to write more data; a high value means the
+    /// channel cannot keep up with the reader.
+    std::uint64_t num_stalls{};
+    /// The total time, in nanoseconds, spent waiting for data.
+    std::uint64_t stall_ns{};
+};
+
 class MLIO_API Sagemaker_pipe_input_stream final : public Input_stream_base {
     friend struct detail::Sagemaker_pipe_input_stream_access;
 
@@ -62,14 +78,28 @@ public:
         return !fifo_fd_.is_open();
     }
 
+    /// Gets the I/O statistics of the channel. If the stream has been
+    /// opened by a @ref Sagemaker_pipe, they cover all the streams that
+    /// the data store has opened.
+    Sagemaker_pipe_stats stats() const noexcept;
+
 private:
     explicit Sagemaker_pipe_input_stream(std::string &&path,
                                          std::chrono::seconds timeout,
-                                         std::optional<std::size_t> fifo_id);
+                                         std::optional<std::size_t> fifo_id,
+                                         std::size_t pipe_buffer_size,
+                                         bool open_next_fifo,
+                                         std::shared_ptr<detail::Sagemaker_pipe_counters> counters);
 
     MLIO_HIDDEN
     void open_fifo();
 
+    MLIO_HIDDEN
+    void open_next_fifo() noexcept;
+
+    MLIO_HIDDEN
+    void resize_fifo_buffer(int fd, std::ptrdiff_t fifo_id) const noexcept;
+
     MLIO_HIDDEN
     static void sleep() noexcept;
 
@@ -82,16 +112,47 @@ private:
     std::string path_;
     std::ptrdiff_t fifo_id_ = -1;
     detail::File_descriptor fifo_fd_{};
+    // The FIFO of the next epoch, opened once this one has been read to
+    // the end.
+    detail::File_descriptor next_fifo_fd_{};
+    bool owns_channel_{};
     std::chrono::seconds timeout_;
+    std::size_t pipe_buffer_size_;
+    bool open_next_fifo_;
+    std::shared_ptr<detail::Sagemaker_pipe_counters> counters_;
 };
 
 inline constexpr std::chrono::seconds sagemaker_pipe_default_timeout{60};
 
+/// The FIFO capacity requested by default. Linux limits unprivileged
+/// processes to /proc/sys/fs/pipe-max-size, which defaults to 1 MiB.
+inline constexpr std::size_t sagemaker_pipe_default_buffer_size = 0x10'0000;  // 1 MiB
+
+/// @param pipe_buffer_size
+///     The capacity, in bytes, to which the buffer of each FIFO is
+///     raised with F_SETPIPE_SZ. A larger buffer lets SageMaker write
+///     further ahead of the reader and reduces the number of context
+///     switches. It is clamped to the limit of the system; if zero, the
+///     default capacity of 64 KiB is kept.
+/// @param open_next_fifo
+///     A boolean value indicating whether to open the FIFO of the next
+///     epoch as soon as the current FIFO reaches its end. SageMaker
+///     starts writing to a FIFO only once its read end is open; opening
+///     it early lets SageMaker fill its buffer while the data of the
+///     current epoch is still being processed, instead of leaving a gap
+///     at each epoch boundary. The next stream opened for the channel
+///     takes over the FIFO.
+/// @param counters
+///     The counters to update; if null, the stream keeps its own.
 MLIO_API
 Intrusive_ptr<Sagemaker_pipe_input_stream>
-make_sagemaker_pipe_input_stream(std::string path,
-                                 std::chrono::seconds timeout = sagemaker_pipe_default_timeout,
-                                 std::optional<std::size_t> fifo_id = {});
+make_sagemaker_pipe_input_stream(
+    std::string path,
+    std::chrono::seconds timeout = sagemaker_pipe_default_timeout,
+    std::optional<std::size_t> fifo_id = {},
+    std::size_t pipe_buffer_size = sagemaker_pipe_default_buffer_size,
+    bool open_next_fifo = true,
+    std::shared_ptr<detail::Sagemaker_pipe_counters> counters = {});
 
 /// @}
 
@@ -54,6 +54,23 @@ public:
     ~Inflate_error() override;
 };
 
+/// Thrown when the data read from a data store does not match its
+/// expected checksum.
+class MLIO_API Checksum_error : public Stream_error {
+public:
+    using Stream_error::Stream_error;
+
+    Checksum_error(const Checksum_error &) = default;
+
+    Checksum_error &operator=(const Checksum_error &) = default;
+
+    Checksum_error(Checksum_error &&) = default;
+
+    Checksum_error &operator=(Checksum_error &&) = default;
+
+    ~Checksum_error() override;
+};
+
 /// @}
 
 }  // namespace abi_v1
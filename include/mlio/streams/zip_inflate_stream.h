@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream_base.h"
+#include "mlio/streams/parallel_gzip_inflate_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Inflate_task_scheduler;
+struct Zip_entry;
+struct Zip_task;
+
+}  // namespace detail
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Represents an @ref Input_stream that reads the file members of a zip
+/// archive, in the order of its central directory, as a single stream.
+///
+/// The members are inflated as parallel tasks ahead of the reader; only
+/// the @c max_num_tasks field of the parameters is used. To read each
+/// member as a separate data store use @ref list_zip_members instead.
+///
+/// @remark
+///     The underlying stream must be seekable. Unless it supports
+///     zero-copy reading, the archive is read into memory in full.
+class MLIO_API Zip_inflate_stream final : public Input_stream_base {
+public:
+    explicit Zip_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                const Parallel_inflate_params &params = {});
+
+    Zip_inflate_stream(const Zip_inflate_stream &) = delete;
+
+    Zip_inflate_stream &operator=(const Zip_inflate_stream &) = delete;
+
+    Zip_inflate_stream(Zip_inflate_stream &&) = delete;
+
+    Zip_inflate_stream &operator=(Zip_inflate_stream &&) = delete;
+
+    ~Zip_inflate_stream() final;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    Memory_slice read(std::size_t size) final;
+
+    void close() noexcept final;
+
+    bool closed() const noexcept final;
+
+private:
+    MLIO_HIDDEN
+    bool next_chunk();
+
+    MLIO_HIDDEN
+    void schedule_tasks();
+
+    MLIO_HIDDEN
+    void cancel_tasks() noexcept;
+
+    MLIO_HIDDEN
+    void check_if_closed() const;
+
+    Intrusive_ptr<Input_stream> inner_;
+    std::size_t max_num_tasks_;
+    Memory_slice archive_{};
+    std::unique_ptr<std::vector<detail::Zip_entry>> entries_;
+    std::size_t entry_idx_{};
+    std::unique_ptr<detail::Inflate_task_scheduler> scheduler_;
+    std::deque<std::shared_ptr<detail::Zip_task>> tasks_{};
+    Memory_slice chunk_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup streams Streams
+/// @{
+
+/// Represents an @ref Input_stream that inflates an underlying
+/// stream that was compressed with Zstandard.
+///
+/// If the underlying stream is seekable and ends with a seek table as
+/// described in the Zstandard seekable format, the stream is seekable
+/// as well; a seek starts inflating at the frame that contains the
+/// requested position instead of at the beginning of the stream.
+class MLIO_API Zstd_inflate_stream final : public Input_stream_base {
+public:
+    explicit Zstd_inflate_stream(Intrusive_ptr<Input_stream> inner);
+
+    Zstd_inflate_stream(const Zstd_inflate_stream &) = delete;
+
+    Zstd_inflate_stream &operator=(const Zstd_inflate_stream &) = delete;
+
+    Zstd_inflate_stream(Zstd_inflate_stream &&) = delete;
+
+    Zstd_inflate_stream &operator=(Zstd_inflate_stream &&) = delete;
+
+    ~Zstd_inflate_stream() final;
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    void seek(std::size_t position) final;
+
+    void close() noexcept final;
+
+    std::size_t size() const final;
+
+    std::size_t position() const final;
+
+    bool closed() const noexcept final;
+
+    bool seekable() const noexcept final
+    {
+        return !frames_.empty();
+    }
+
+private:
+    struct Frame {
+        std::size_t compressed_offset;
+        std::size_t offset;
+    };
+
+    MLIO_HIDDEN
+    void read_seek_table();
+
+    MLIO_HIDDEN
+    std::size_t inflate(Mutable_memory_span destination);
+
+    MLIO_HIDDEN
+    void check_if_closed() const;
+
+    Intrusive_ptr<Input_stream> inner_;
+    std::unique_ptr<detail::Zstd_inflater> inflater_;
+    std::vector<Frame> frames_{};
+    std::size_t size_{};
+    std::size_t pos_{};
+    std::size_t num_bytes_to_skip_{};
+    Memory_slice buffer_{};
+    Memory_block::iterator buffer_pos_ = buffer_.begin();
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
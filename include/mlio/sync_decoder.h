@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Decodes in-memory request payloads with the parsers and decoders of
+/// a @ref Parallel_data_reader on the calling thread. Meant for online
+/// serving where each request is decoded on its own; the background
+/// thread and the flow graph of the reader are never started.
+///
+/// @remark
+///     The member functions can be called concurrently; the calls are
+///     serialized. The reader must not be read via @ref
+///     Data_reader::read_example() while it is used by the decoder.
+class MLIO_API Sync_decoder {
+public:
+    /// @param reader
+    ///     The reader whose schema, parameters, and decoders are used.
+    ///     Its batch size, shuffling, and sharding parameters are
+    ///     ignored; see @ref Parallel_data_reader::decode_buffer().
+    explicit Sync_decoder(Intrusive_ptr<Parallel_data_reader> reader);
+
+    Sync_decoder(const Sync_decoder &) = delete;
+
+    Sync_decoder &operator=(const Sync_decoder &) = delete;
+
+    Sync_decoder(Sync_decoder &&) = delete;
+
+    Sync_decoder &operator=(Sync_decoder &&) = delete;
+
+    ~Sync_decoder();
+
+    /// Decodes the records in the specified buffer into a single @ref
+    /// Example.
+    ///
+    /// @return
+    ///     An Example, or null if the buffer contains no instance.
+    Intrusive_ptr<Example> decode(Memory_slice buffer);
+
+    /// Decodes the records in the specified buffer into @p example,
+    /// replacing the Example it holds.
+    ///
+    /// @remark
+    ///     The previous Example is released before the buffer is decoded,
+    ///     so if @ref Data_reader_params::tensor_pool_size is set and the
+    ///     caller holds no other reference to it, the new Example is
+    ///     decoded into its tensor buffers instead of newly allocated
+    ///     ones.
+    ///
+    /// @return
+    ///     A boolean value indicating whether the buffer contained an
+    ///     instance; if false, @p example is set to null.
+    bool decode(Memory_slice buffer, Intrusive_ptr<Example> &example);
+
+    /// Returns the schema of the decoded examples, or null if no
+    /// instance has been decoded yet.
+    Intrusive_ptr<const Schema> schema() const;
+
+    const Parallel_data_reader &reader() const noexcept
+    {
+        return *reader_;
+    }
+
+private:
+    Intrusive_ptr<Parallel_data_reader> reader_;
+    Intrusive_ptr<const Schema> schema_{};
+    mutable std::mutex mutex_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
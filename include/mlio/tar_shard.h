@@ -0,0 +1,43 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <string>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_stores Data Stores
+/// @{
+
+/// Packs the specified data stores into a tar archive with one regular
+/// file per data store, named after the last component of its id.
+///
+/// Datasets of many small files, such as images, are read considerably
+/// faster as a few such shards with @ref Image_frame::tar than as one
+/// @ref File or @ref S3_object per image; the shards are read with large
+/// sequential reads instead of opening each file separately.
+MLIO_API
+void write_tar_shard(const std::string &path, stdx::span<const Intrusive_ptr<Data_store>> stores);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
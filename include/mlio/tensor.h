@@ -19,6 +19,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -223,6 +224,55 @@ private:
     std::unique_ptr<Device_array> indptr_;
 };
 
+/// Represents a Tensor of strings whose bytes are stored back to back in
+/// a single buffer.
+///
+/// Unlike a @ref Dense_tensor of @c std::string elements, a String_tensor
+/// takes two allocations regardless of the number of strings it holds,
+/// which makes it cheap to construct and to release.
+class MLIO_API String_tensor final : public Tensor {
+public:
+    /// @param data
+    ///     A @c uint8 @ref Device_array that holds the bytes of all
+    ///     strings back to back.
+    /// @param offsets
+    ///     An @c int64 @ref Device_array with one more element than the
+    ///     Tensor. The i-th string spans [offsets[i], offsets[i + 1]) of
+    ///     the data array.
+    explicit String_tensor(Size_vector shape,
+                           std::unique_ptr<Device_array> &&data,
+                           std::unique_ptr<Device_array> &&offsets);
+
+    std::string repr() const final;
+
+    Device_array_view data() const noexcept
+    {
+        return Device_array_view{*data_};
+    }
+
+    Device_array_view offsets() const noexcept
+    {
+        return Device_array_view{*offsets_};
+    }
+
+    /// Gets the number of strings in the Tensor.
+    std::size_t size() const noexcept
+    {
+        return offsets_->size() - 1;
+    }
+
+    /// Gets the string at the specified flat index.
+    std::string_view value(std::size_t index) const noexcept;
+
+    void accept(Tensor_visitor &visitor) final;
+
+    void accept(Tensor_visitor &visitor) const final;
+
+private:
+    std::unique_ptr<Device_array> data_;
+    std::unique_ptr<Device_array> offsets_;
+};
+
 /// @}
 
 }  // namespace abi_v1
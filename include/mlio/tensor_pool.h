@@ -0,0 +1,144 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+template<typename T>
+class Pooled_buffer;
+
+}  // namespace detail
+
+/// @addtogroup tensors Tensors
+/// @{
+
+/// Holds the usage statistics of a @ref Tensor_pool.
+struct MLIO_API Tensor_pool_stats {
+    /// The number of arrays whose buffers were taken from the pool.
+    std::size_t num_hits{};
+    /// The number of arrays for which a new buffer was allocated.
+    std::size_t num_misses{};
+    /// The total size, in bytes, of the buffers held in the pool.
+    std::size_t num_cached_bytes{};
+};
+
+/// Represents a pool of recycled buffers for @ref Cpu_array instances.
+/// The buffer of an array allocated from the pool is returned to it
+/// once the array is destroyed, and is reused for the next array with
+/// the same data type and size.
+///
+/// The buffers of 64 KiB or larger are mapped directly from the
+/// operating system as @ref Page_memory_block "page memory blocks" and
+/// are faulted in when allocated, so that the decode functions writing
+/// into them do not stall on page faults. Since the buffers are
+/// recycled, the cost of faulting them in is paid only once.
+///
+/// @remark
+///     Arrays of type @ref Data_type::string are not pooled.
+class MLIO_API Tensor_pool final : public Intrusive_ref_counter<Tensor_pool> {
+    template<typename>
+    friend class detail::Pooled_buffer;
+
+public:
+    /// @param capacity
+    ///     The maximum total size, in bytes, of the buffers held in the
+    ///     pool. Buffers returned once the pool is full get freed.
+    /// @param huge_pages
+    ///     A boolean value indicating whether the large buffers should be
+    ///     backed by transparent huge pages.
+    explicit Tensor_pool(std::size_t capacity, bool huge_pages = false) noexcept;
+
+    Tensor_pool(const Tensor_pool &) = delete;
+
+    Tensor_pool &operator=(const Tensor_pool &) = delete;
+
+    Tensor_pool(Tensor_pool &&) = delete;
+
+    Tensor_pool &operator=(Tensor_pool &&) = delete;
+
+    ~Tensor_pool();
+
+    /// Same as @ref make_cpu_array(), but takes the buffer of the array
+    /// from the pool if one is available.
+    ///
+    /// @param zero_fill
+    ///     A boolean value indicating whether the array should be
+    ///     zero-initialized. If false, a recycled buffer keeps the values
+    ///     of its previous array; meant for callers that overwrite all
+    ///     elements anyways.
+    std::unique_ptr<Device_array>
+    make_cpu_array(Data_type dt, std::size_t size, bool zero_fill = true);
+
+    /// Same as @ref make_cpu_arrays(), but takes the shared buffer of the
+    /// arrays from the pool if one is available.
+    std::vector<std::unique_ptr<Device_array>>
+    make_cpu_arrays(stdx::span<const Data_type> dts, std::size_t size);
+
+    /// Same as above, but the arrays can have different sizes. Meant for
+    /// the value and index arrays of sparse tensors whose number of
+    /// non-zero values varies from batch to batch; the shared buffer is
+    /// rounded up to a size class so that it can be reused by groups of
+    /// similar total sizes. The arrays are not zero-initialized.
+    std::vector<std::unique_ptr<Device_array>>
+    make_cpu_arrays(stdx::span<const Data_type> dts, stdx::span<const std::size_t> sizes);
+
+    Tensor_pool_stats stats() const;
+
+    /// Frees the buffers held in the pool.
+    void clear() noexcept;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Mutable_memory_block>
+    acquire(Data_type dt, std::size_t num_bytes, bool &zero_filled);
+
+    MLIO_HIDDEN
+    void release(Data_type dt,
+                 std::size_t num_bytes,
+                 Intrusive_ptr<Mutable_memory_block> &&block) noexcept;
+
+    std::size_t capacity_;
+    bool huge_pages_;
+    mutable std::mutex mutex_{};
+    std::map<std::pair<Data_type, std::size_t>, std::vector<Intrusive_ptr<Mutable_memory_block>>>
+        buffers_{};
+    std::size_t num_cached_bytes_{};
+    std::atomic_size_t num_hits_{};
+    std::atomic_size_t num_misses_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -55,6 +55,10 @@ public:
     virtual void visit(Csr_tensor &tensor);
 
     virtual void visit(const Csr_tensor &tensor);
+
+    virtual void visit(String_tensor &tensor);
+
+    virtual void visit(const String_tensor &tensor);
 };
 
 // @}
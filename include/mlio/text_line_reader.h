@@ -16,6 +16,9 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "mlio/config.h"
@@ -29,10 +32,73 @@ inline namespace abi_v1 {
 /// @addtogroup data_readers Data Readers
 /// @{
 
+/// Specifies how @ref Text_line_reader tokenizes lines with a WordPiece
+/// vocabulary, as used by BERT models.
+///
+/// A line is split at whitespace and ASCII punctuation characters, and
+/// each word is split into the longest matching vocabulary entries;
+/// continuation pieces are looked up with a "##" prefix.
+struct MLIO_API Wordpiece_params final {
+    /// The path of the vocabulary file. It contains one token per line;
+    /// the id of a token is its zero-based line number.
+    std::string vocab_path{};
+    /// A boolean value indicating whether to lower-case ASCII letters
+    /// before the lookup.
+    bool lowercase = true;
+    /// The token used for words that cannot be split into vocabulary
+    /// entries. It must be in the vocabulary.
+    std::string unknown_token = "[UNK]";
+    /// The tokens added to the beginning and to the end of each
+    /// sequence. Either can be empty to add no token.
+    std::string begin_token = "[CLS]";
+    std::string end_token = "[SEP]";
+    /// The token used for padding. If empty, padding uses id 0.
+    std::string padding_token = "[PAD]";
+    /// The length of the output sequences. Longer sequences are
+    /// truncated, keeping the begin and end tokens.
+    std::size_t max_sequence_length = 128;
+    /// Words longer than this, in bytes, are mapped to the unknown
+    /// token.
+    std::size_t max_chars_per_word = 100;
+    /// A boolean value indicating whether to pack as many sequences as
+    /// fit into each row instead of one sequence per row. In such case
+    /// the attention mask holds the one-based index of the sequence
+    /// within its row instead of 1, and the unused rows of a batch are
+    /// reported as padding.
+    bool pack_sequences = false;
+};
+
+struct MLIO_API Text_line_params final {
+    /// A boolean value indicating whether to verify that each line is a
+    /// valid UTF-8 string. The check is done while the line ends are
+    /// scanned and is nearly free for ASCII text. A line that fails the
+    /// check causes a @ref Corrupt_record_error.
+    bool validate_utf8 = false;
+    /// A boolean value indicating whether to return the lines of a batch
+    /// packed into two features instead of a string tensor: "value", a
+    /// one-dimensional uint8 tensor holding the bytes of all lines back
+    /// to back, and "value_offsets", an int64 tensor of size batch size
+    /// + 1 where line i spans the bytes [offsets[i], offsets[i + 1]).
+    /// The layout matches Arrow's LargeString array. Since the size of
+    /// "value" varies by batch, its attribute has a shape of {0}.
+    bool pack_lines = false;
+    /// A boolean value indicating whether to return the "value" feature
+    /// as a @ref String_tensor instead of a dense tensor of strings.
+    /// The lines of a batch are then copied into a single buffer with no
+    /// allocation per line. Cannot be combined with @ref pack_lines or
+    /// @ref wordpiece.
+    bool arena_strings = false;
+    /// If specified, each line is tokenized and the batches contain an
+    /// int32 "input_ids" feature and an int32 "attention_mask" feature,
+    /// both of shape {batch size, max sequence length}. Lines are
+    /// tokenized in parallel.
+    std::optional<Wordpiece_params> wordpiece{};
+};
+
 /// Represents a @ref Data_reader for reading simple text-based datasets.
 class MLIO_API Text_line_reader final : public Parallel_data_reader {
 public:
-    explicit Text_line_reader(Data_reader_params params);
+    explicit Text_line_reader(Data_reader_params params, Text_line_params text_params = {});
 
     Text_line_reader(const Text_line_reader &) = delete;
 
@@ -51,7 +117,19 @@ private:
 
     Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
 
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode_packed(const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode_arena(const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode_tokenized(const Instance_batch &batch) const;
+
     static Intrusive_ptr<Dense_tensor> make_tensor(std::size_t batch_size);
+
+    Text_line_params text_params_;
+    std::unique_ptr<detail::Wordpiece_tokenizer> tokenizer_{};
 };
 
 /// @}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/parallel_data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents the optional parameters of a @ref Tf_example_reader
+/// object.
+struct MLIO_API Tf_example_params final {
+    /// A boolean value indicating whether to verify the CRC32C checksums
+    /// of the TFRecord framing. Skipping the verification saves a pass
+    /// over each record, but should only be done for trusted data as a
+    /// corrupt record is then only detected if its message is malformed.
+    bool verify_checksums = true;
+    /// The features that should be read. If empty, the features of the
+    /// first record are read.
+    std::unordered_set<std::string> use_features{};
+    /// The features that should be read as sparse tensors keyed by their
+    /// maximum number of values. A record can omit a sparse feature; a
+    /// feature with more values makes its record a bad instance.
+    std::unordered_map<std::string, std::size_t> sparse_features{};
+    /// The data types of specific features. The data type of a feature
+    /// must be float32 for a float list, int64 for an int64 list, and
+    /// string for a bytes list. Required for the features that are not
+    /// found in the first record.
+    std::unordered_map<std::string, Data_type> data_types{};
+};
+
+/// Represents a @ref Data_reader for reading TFRecord datasets of
+/// tf.train.Example messages.
+///
+/// A dense feature has the shape (batch size, number of values) where
+/// the number of values is taken from the first record. The messages are
+/// scanned straight from their wire representation; only the features
+/// in the schema get decoded.
+class MLIO_API Tf_example_reader final : public Parallel_data_reader {
+public:
+    explicit Tf_example_reader(Data_reader_params params, Tf_example_params tf_params = {});
+
+    Tf_example_reader(const Tf_example_reader &) = delete;
+
+    Tf_example_reader &operator=(const Tf_example_reader &) = delete;
+
+    Tf_example_reader(Tf_example_reader &&) = delete;
+
+    Tf_example_reader &operator=(Tf_example_reader &&) = delete;
+
+    ~Tf_example_reader() final;
+
+private:
+    class Decoder_state;
+    class Decoder;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Attribute make_attribute(const std::string &name,
+                             std::optional<Data_type> dt,
+                             std::size_t num_values) const;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    std::optional<std::size_t>
+    decode_serial(Decoder_state &state, const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    std::optional<std::size_t>
+    decode_parallel(Decoder_state &state, const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    std::optional<std::size_t> get_attribute_index(std::string_view name) const;
+
+    MLIO_HIDDEN
+    std::size_t estimate_nnz(std::size_t attr_idx, std::size_t num_rows) const;
+
+    MLIO_HIDDEN
+    void update_nnz_estimate(std::size_t attr_idx,
+                             const detail::Sparse_tensor_builder &builder) const;
+
+    Tf_example_params tf_params_;
+    bool has_sparse_feature_{};
+    std::size_t num_values_per_instance_{};
+    // The keys are views into the attribute names of the schema.
+    std::unordered_map<std::string_view, std::size_t> attr_indices_{};
+    // The number of values per row of the sparse features in the last
+    // decoded batch; used to presize the sparse tensor builders.
+    mutable std::vector<std::atomic_size_t> nnz_per_row_estimates_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
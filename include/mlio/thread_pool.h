@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Thread_pool_access;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Represents a pool of worker threads that data readers run their
+/// tasks on, including the nested parallel work of their decoders.
+///
+/// By default each reader that sets @ref Data_reader_params::num_threads
+/// gets a task arena of its own, and the others share the global TBB
+/// scheduler that is sized to all processor cores. Readers that are
+/// given the same pool, for instance a training and a validation
+/// reader, share its threads instead, so that together they occupy a
+/// fixed number of cores next to the thread pools of a deep learning
+/// framework.
+class MLIO_API Thread_pool : public Intrusive_ref_counter<Thread_pool> {
+    friend struct detail::Thread_pool_access;
+
+public:
+    /// @param num_threads
+    ///     The number of threads, including the thread that waits for
+    ///     a task, that can run tasks concurrently. If zero, defaults to
+    ///     the size of @p cpu_affinity, or to the number of processor
+    ///     cores available to the process.
+    /// @param cpu_affinity
+    ///     The ids of the processor cores to pin the threads to.
+    /// @param numa_node
+    ///     The NUMA node whose processor cores the threads should be
+    ///     pinned to. Cannot be specified along with @p cpu_affinity.
+    explicit Thread_pool(std::size_t num_threads = 0,
+                         std::vector<std::size_t> cpu_affinity = {},
+                         std::optional<std::size_t> numa_node = {});
+
+    Thread_pool(const Thread_pool &) = delete;
+
+    Thread_pool &operator=(const Thread_pool &) = delete;
+
+    Thread_pool(Thread_pool &&) = delete;
+
+    Thread_pool &operator=(Thread_pool &&) = delete;
+
+    ~Thread_pool();
+
+    /// Runs @p func on the calling thread as part of the pool so that
+    /// any TBB parallel work that it starts uses the threads of the
+    /// pool; e.g. a preprocessing step of the caller that should not
+    /// exceed the cores set aside for the readers.
+    void execute(const std::function<void()> &func) const;
+
+    /// Returns the number of threads that can run tasks concurrently.
+    std::size_t num_threads() const noexcept;
+
+private:
+    std::shared_ptr<detail::Reader_task_arena> arena_;
+};
+
+/// Limits the number of threads that run TBB tasks across the whole
+/// process, including the global scheduler, the task arenas of the
+/// readers, and the thread pools; for instance to the cores left over
+/// by the intra-op and inter-op pools of a deep learning framework.
+///
+/// @param value
+///     The maximum number of threads. If zero, the limit is lifted.
+MLIO_API
+void set_max_num_threads(std::size_t value);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// @addtogroup tracing Tracing
+/// @{
+
+/// Starts recording the timelines of the pipeline stages; e.g. reading
+/// chunks, inflating gzip streams, reading S3 objects, reading instance
+/// batches, and decoding examples. Each thread records its spans into a
+/// ring buffer of its own, so only the most recent spans of a thread are
+/// kept. Any previously recorded span is discarded.
+///
+/// While tracing is stopped, which is the default, the overhead of a
+/// span is a single relaxed atomic load.
+///
+/// @param max_spans_per_thread
+///     The capacity of the ring buffer of a thread.
+MLIO_API
+void start_tracing(std::size_t max_spans_per_thread = 0x10000);
+
+/// Stops recording spans. The spans recorded so far are kept until the
+/// next call to @ref start_tracing().
+MLIO_API
+void stop_tracing() noexcept;
+
+/// Writes the recorded spans to the specified file in the Chrome trace
+/// event format that can be opened in Perfetto (ui.perfetto.dev) or in
+/// chrome://tracing. The spans that are recorded while the trace gets
+/// written might be left out.
+MLIO_API
+void write_trace(const std::string &path);
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/parser.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+class Datetime_format;
+
+namespace detail {
+
+struct Datetime_fields;
+
+}  // namespace detail
+
+struct MLIO_API Datetime_parse_options {
+    /// If specified, used instead of the ISO-8601 format.
+    const Datetime_format *format{};
+};
+
+/// Parses a timestamp as the number of nanoseconds since the Unix epoch
+/// in UTC, i.e. as a NumPy datetime64[ns] or an Arrow timestamp[ns]
+/// value.
+///
+/// Unless a format is specified the timestamp has to be in the form of
+/// "YYYY-MM-DD[(T| )hh:mm[:ss[.f...]]][Z|(+|-)hh[[:]mm]]"; a timestamp
+/// without a UTC offset is treated as UTC. The fixed-width date and
+/// time parts are validated and converted a word at a time.
+MLIO_API
+Parse_result try_parse_timestamp(std::string_view s,
+                                 std::int64_t &result,
+                                 const Datetime_parse_options &opts = {}) noexcept;
+
+/// Parses a date as the number of milliseconds since the Unix epoch to
+/// the midnight of that date, i.e. as a NumPy datetime64[ms] or an Arrow
+/// date64 value.
+///
+/// Unless a format is specified the date has to be in the form of
+/// "YYYY-MM-DD". The time of day and the UTC offset that a format might
+/// read are ignored.
+MLIO_API
+Parse_result try_parse_date(std::string_view s,
+                            std::int64_t &result,
+                            const Datetime_parse_options &opts = {}) noexcept;
+
+/// Represents a strptime-like format of dates and timestamps that is
+/// compiled once instead of being interpreted for each field.
+///
+/// The supported directives are %Y (four-digit year), %y (two-digit
+/// year; 69-99 are 19xx, 00-68 are 20xx), %m, %d, %H, %M, %S (one
+/// or two digits), %b (English abbreviated month name), %f (one to
+/// nine digits of a fractional second), %z ("Z" or a UTC offset), and
+/// %%. Any other character has to match itself.
+class MLIO_API Datetime_format {
+    friend MLIO_API Parse_result
+    try_parse_timestamp(std::string_view, std::int64_t &, const Datetime_parse_options &) noexcept;
+
+    friend MLIO_API Parse_result
+    try_parse_date(std::string_view, std::int64_t &, const Datetime_parse_options &) noexcept;
+
+public:
+    Datetime_format() noexcept = default;
+
+    /// @throw std::invalid_argument
+    ///     If @p fmt has an unsupported directive.
+    explicit Datetime_format(std::string_view fmt);
+
+    bool empty() const noexcept
+    {
+        return tokens_.empty();
+    }
+
+private:
+    bool parse_fields(std::string_view s, detail::Datetime_fields &fields) const noexcept;
+
+    // A directive such as 'Y', or '\0' for a literal character.
+    struct Token {
+        char directive;
+        char literal;
+    };
+
+    std::vector<Token> tokens_{};
+};
+
+}  // namespace abi_v1
+}  // namespace mlio
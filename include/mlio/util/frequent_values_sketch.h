@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// Tracks the most frequent values of a stream of strings in bounded
+/// memory using the Space-Saving algorithm of Metwally et al.
+///
+/// The sketch keeps at most @p capacity counters. A value that is not
+/// tracked takes over the counter with the lowest count; as a result
+/// every value that occurs more than n / capacity times in a stream of
+/// n values is guaranteed to be tracked. Sketches can be merged as
+/// described in "Mergeable Summaries" by Agarwal et al., which allows
+/// each thread or shard to maintain its own sketch.
+class MLIO_API Frequent_values_sketch {
+public:
+    struct Entry {
+        std::string value;
+        /// An upper bound of the number of occurrences of the value.
+        std::size_t count;
+        /// The maximum overestimation of @ref count; count - error is a
+        /// lower bound of the number of occurrences.
+        std::size_t error;
+    };
+
+    explicit Frequent_values_sketch(std::size_t capacity = 1024);
+
+    Frequent_values_sketch(const Frequent_values_sketch &other);
+
+    Frequent_values_sketch &operator=(const Frequent_values_sketch &other);
+
+    Frequent_values_sketch(Frequent_values_sketch &&other) noexcept;
+
+    Frequent_values_sketch &operator=(Frequent_values_sketch &&other) noexcept;
+
+    ~Frequent_values_sketch();
+
+    void add(std::string_view value);
+
+    void merge(const Frequent_values_sketch &other);
+
+    /// Returns up to @p k tracked values ordered by their count in
+    /// descending order.
+    std::vector<Entry> top(std::size_t k) const;
+
+    /// Returns the number of values added to the sketch.
+    std::size_t count() const noexcept
+    {
+        return count_;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+private:
+    struct Counter {
+        std::string value{};
+        std::size_t count{};
+        std::size_t error{};
+        // The position of the counter in the heap.
+        std::size_t heap_pos{};
+    };
+
+    MLIO_HIDDEN
+    void assign(std::vector<Entry> &&entries);
+
+    MLIO_HIDDEN
+    void sift_up(std::size_t pos) noexcept;
+
+    MLIO_HIDDEN
+    void sift_down(std::size_t pos) noexcept;
+
+    MLIO_HIDDEN
+    void swap_heap_entries(std::size_t a, std::size_t b) noexcept;
+
+    MLIO_HIDDEN
+    std::size_t min_count() const noexcept;
+
+    std::size_t capacity_;
+    std::size_t count_{};
+    // The counters never get reallocated; the keys of the index point
+    // to their values.
+    std::vector<Counter> counters_{};
+    // A min-heap of counter indices ordered by count.
+    std::vector<std::size_t> heap_{};
+    std::unordered_map<std::string_view, std::size_t> index_{};
+};
+
+}  // namespace abi_v1
+}  // namespace mlio
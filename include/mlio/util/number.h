@@ -15,11 +15,13 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 #include <string_view>
 #include <unordered_set>
+#include <vector>
 
 #include "mlio/config.h"
 #include "mlio/parser.h"
@@ -27,8 +29,52 @@
 namespace mlio {
 inline namespace abi_v1 {
 
+/// Matches strings against a set of NaN markers (e.g. "NA", "null")
+/// that is compiled once, so that a check costs a length test and a
+/// few word compares instead of a hash lookup.
+class MLIO_API Nan_value_matcher {
+public:
+    Nan_value_matcher() noexcept = default;
+
+    /// @param nan_values
+    ///     The strings that should be treated as NaN. The ones that can
+    ///     be parsed as a number are ignored since a number is never
+    ///     treated as NaN.
+    explicit Nan_value_matcher(const std::unordered_set<std::string> &nan_values);
+
+    /// Returns whether @p s is one of the NaN values. Whitespace is not
+    /// trimmed.
+    bool matches(std::string_view s) const noexcept;
+
+    bool empty() const noexcept
+    {
+        return length_mask_ == 0 && long_values_.empty();
+    }
+
+private:
+    static constexpr std::size_t max_short_size = 16;
+
+    // A value of up to 16 characters padded with zeros.
+    struct Short_value {
+        std::uint64_t lo;
+        std::uint64_t hi;
+    };
+
+    static Short_value make_short_value(std::string_view s) noexcept;
+
+    // The bit n is set if there is a short value of length n.
+    std::uint32_t length_mask_{};
+    // The short values sorted by length; the ones of length n are in
+    // [offsets_[n], offsets_[n + 1]).
+    std::vector<Short_value> short_values_{};
+    std::array<std::uint16_t, max_short_size + 2> offsets_{};
+    std::vector<std::string> long_values_{};
+};
+
 struct MLIO_API Float_parse_options {
     const std::unordered_set<std::string> *nan_values{};
+    /// If specified, used instead of @ref nan_values.
+    const Nan_value_matcher *nan_matcher{};
 };
 
 template<typename T>
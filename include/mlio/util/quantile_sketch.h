@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+/// Estimates the quantiles of a stream of numbers in bounded memory
+/// using the KLL sketch of Karnin, Lang, and Liberty.
+///
+/// The sketch keeps a hierarchy of compactors; whenever a compactor
+/// gets full, its items are sorted and every other one is promoted to
+/// the next level with twice the weight. Sketches with the same size
+/// parameter can be merged, which allows each thread to maintain its
+/// own sketch. The rank error is roughly 1.7 / @p k.
+class MLIO_API Quantile_sketch {
+public:
+    explicit Quantile_sketch(std::size_t k = 200);
+
+    /// Adds a value; NaN values are ignored.
+    void add(double value);
+
+    void merge(const Quantile_sketch &other);
+
+    /// Returns the estimated value at the specified quantile, which
+    /// must be between 0 and 1, or NaN if the sketch is empty.
+    double quantile(double q) const;
+
+    /// Returns the number of values added to the sketch.
+    std::size_t count() const noexcept
+    {
+        return count_;
+    }
+
+    /// Returns the number of items retained by the sketch.
+    std::size_t num_retained() const noexcept
+    {
+        return num_retained_;
+    }
+
+private:
+    MLIO_HIDDEN
+    void compress();
+
+    MLIO_HIDDEN
+    void grow();
+
+    MLIO_HIDDEN
+    std::size_t capacity(std::size_t level) const noexcept;
+
+    std::size_t k_;
+    std::vector<std::vector<double>> compactors_{};
+    std::size_t num_retained_{};
+    std::size_t max_retained_{};
+    std::size_t count_{};
+    double min_ = std::numeric_limits<double>::quiet_NaN();
+    double max_ = std::numeric_limits<double>::quiet_NaN();
+    std::uint_fast32_t rng_state_ = 0x9e37'79b9;
+};
+
+}  // namespace abi_v1
+}  // namespace mlio
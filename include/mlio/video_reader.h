@@ -0,0 +1,125 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "mlio/config.h"
+#include "mlio/image_reader.h"
+#include "mlio/parallel_data_reader.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Image_transformer;
+
+}  // namespace detail
+
+/// @addtogroup data_readers Data Readers
+/// @{
+
+/// Specifies how the frames of a video clip are sampled.
+enum class Frame_sampling {
+    /// Samples frames spread evenly across the whole clip.
+    uniform,
+    /// Samples consecutive frames, @ref Video_reader_params::frame_stride
+    /// frames apart, starting at a random position in the clip.
+    random
+};
+
+/// Represents the optional parameters of a @ref Video_reader object.
+struct MLIO_API Video_reader_params {
+    /// The number of frames to sample from each clip.
+    std::size_t num_frames = 8;
+    /// See @ref Frame_sampling.
+    Frame_sampling frame_sampling = Frame_sampling::uniform;
+    /// The distance, in frames, between two consecutive frames sampled
+    /// with @ref Frame_sampling::random. If the clip is too short, its
+    /// last frame is repeated.
+    std::size_t frame_stride = 1;
+    /// The parameters of the resize, crop, and normalization pipeline
+    /// that is applied to each sampled frame. The same random
+    /// augmentations are applied to all frames of a clip. The image
+    /// frame, variable-size, and bucketing options are not supported.
+    Image_reader_params image_params{};
+};
+
+/// Represents a @ref Data_reader for reading video clips, one clip per
+/// data store.
+///
+/// The clips are demuxed and decoded with FFmpeg, so any container and
+/// codec supported by the FFmpeg build, such as H.264, H.265, or AV1 in
+/// MP4, can be read. To avoid decoding the whole clip, the reader seeks
+/// to the keyframe preceding a sampled frame if it is not reachable by
+/// decoding forward from the current position.
+///
+/// The examples have a single "value" feature of shape (batch, frames,
+/// channels, height, width) or (batch, frames, height, width, channels)
+/// depending on @ref Image_reader_params::image_layout.
+class MLIO_API Video_reader final : public Parallel_data_reader {
+public:
+    explicit Video_reader(Data_reader_params params, Video_reader_params video_params);
+
+    Video_reader(const Video_reader &) = delete;
+
+    Video_reader &operator=(const Video_reader &) = delete;
+
+    Video_reader(Video_reader &&) = delete;
+
+    Video_reader &operator=(Video_reader &&) = delete;
+
+    ~Video_reader() final;
+
+    void reset() noexcept final;
+
+private:
+    MLIO_HIDDEN
+    Intrusive_ptr<Record_reader> make_record_reader(const Data_store &store) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<const Schema> infer_schema(const std::optional<Instance> &instance) final;
+
+    MLIO_HIDDEN
+    Intrusive_ptr<Example> decode(const Instance_batch &batch) const final;
+
+    MLIO_HIDDEN
+    bool decode_clip(Mutable_memory_span out, const Instance &instance, std::size_t seed) const;
+
+    MLIO_HIDDEN
+    bool report_bad_clip(const Instance &instance, const std::string &error) const;
+
+    MLIO_HIDDEN
+    bool should_skip_example(const Instance_batch &batch) const;
+
+    MLIO_HIDDEN
+    void warn_if_padded(const Instance_batch &batch, std::size_t num_instances_read) const;
+
+    Video_reader_params params_;
+    bool error_bad_example_;
+    std::unique_ptr<detail::Image_transformer> transformer_;
+    std::size_t augmentation_seed_{};
+    std::size_t epoch_{};
+};
+
+/// @}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -18,122 +18,398 @@ import pkg_resources
 import mlio._core
 
 from mlio._core import\
+    AllocationAudit,\
+    AllocationStats,\
     Attribute,\
+    AudioOutput,\
+    AudioReader,\
+    AudioReaderParams,\
+    AvroReader,\
+    AvroReaderParams,\
+    AzureBlob,\
+    AzureBlobClient,\
     BadExampleHandling,\
+    CachingDataReader,\
+    CachingParams,\
+    Checksum,\
+    ChecksumAlgorithm,\
+    ChecksumError,\
+    ChecksumMismatchHandling,\
+    ColumnStatistics,\
+    ColumnStatisticsCollector,\
+    ColumnStatisticsParams,\
+    ColumnarCompression,\
+    ColumnarReader,\
+    ColumnarWriter,\
+    ColumnarWriterParams,\
+    CompositeDataReader,\
     Compression,\
+    ConcatReader,\
     CooTensor,\
     CorruptFooterError,\
     CorruptHeaderError,\
     CorruptRecordError,\
     CsvParams,\
+    CsrTensor,\
     CsvReader,\
     DataReader,\
     DataReaderError,\
     DataReaderParams,\
+    DataReaderState,\
+    DataServiceParams,\
+    DataServiceReader,\
+    DataServiceWorker,\
+    DataWriter,\
     DataStore,\
     DataType,\
+    DecodeScheduling,\
     DenseTensor,\
     Device,\
     DeviceArray,\
     DeviceKind,\
     Example,\
+    ExampleConversionParams,\
+    ExampleQueueHandling,\
+    ExampleTransform,\
     File,\
+    FileIoParams,\
+    FileObjectStore,\
+    FilterOp,\
+    FrameSampling,\
+    GcsClient,\
+    GcsObject,\
+    GzipInflateParams,\
+    HttpClient,\
+    HttpObject,\
     ImageFrame,\
+    ImageLayout,\
     ImageReader,\
     ImageReaderParams,\
     InMemoryStore,\
+    InflateBackend,\
     InflateError,\
     InputStream,\
+    InstanceCount,\
+    InterleaveOrdering,\
     InvalidInstanceError,\
+    JsonLinesParams,\
+    JsonLinesReader,\
+    KafkaClient,\
+    KafkaPartition,\
+    LibsvmParams,\
+    LibsvmReader,\
     LastExampleHandling,\
     LogLevel,\
     MLIOError,\
     MaxFieldLengthHandling,\
     MemorySlice,\
+    MixtureParams,\
+    MixtureReader,\
     NotSupportedError,\
+    OrcReader,\
+    OrcReaderParams,\
+    ParallelDataReader,\
+    ParquetReader,\
+    ParquetReaderParams,\
     ParquetRecordReader,\
+    ParquetRowGroupFilter,\
     ParserParams,\
+    PrefetchParams,\
+    RangeReadParams,\
+    ReaderStats,\
     Record,\
     RecordError,\
+    RecordIOIndexEntry,\
     RecordIOProtobufReader,\
+    RecordIOProtobufWriter,\
+    RecordIOProtobufWriterParams,\
     RecordKind,\
     RecordReader,\
     RecordTooLargeError,\
+    RowFilter,\
     S3Client,\
     S3Object,\
+    S3ObjectCache,\
+    S3RangeReadParams,\
+    S3RetryMode,\
     SageMakerPipe,\
+    SageMakerPipeStats,\
     Schema,\
     SchemaError,\
+    ShardingStrategy,\
+    SharedDataStore,\
+    SharedMemoryDistribution,\
+    SharedMemoryReader,\
+    SharedMemoryReaderServer,\
+    SharedMemoryServerParams,\
+    SharedReadGroup,\
+    SparseTensorFormat,\
+    StageStats,\
+    StoreStats,\
     StreamError,\
+    StringTensor,\
+    SyncDecoder,\
     Tensor,\
+    TensorPool,\
+    TensorPoolStats,\
     TextLineReader,\
+    TfExampleParams,\
+    TfExampleReader,\
+    ThreadPool,\
+    VideoReader,\
+    VideoReaderParams,\
+    VerifiedDataStore,\
+    WordpieceParams,\
+    ZipMember,\
+    ZipReader,\
+    allocation_audit,\
+    build_recordio_index,\
+    concat_examples,\
+    commit_kafka_partitions,\
+    compute_checksum,\
+    convert_example,\
     deallocate_aws_sdk,\
     initialize_aws_sdk,\
     list_files,\
+    list_azure_blobs,\
+    list_gcs_objects,\
+    list_kafka_partitions,\
     list_s3_objects,\
+    list_zip_members,\
+    read_checksum_manifest,\
+    read_file_manifest,\
+    read_recordio_index,\
+    set_default_file_io_params,\
+    set_default_gzip_inflate_params,\
+    set_default_prefetch_params,\
+    set_max_num_threads,\
+    slice_example,\
+    start_allocation_audit,\
+    start_tracing,\
+    stop_allocation_audit,\
+    stop_tracing,\
+    supports_cuda,\
+    supports_azure,\
+    supports_gcs,\
+    supports_http,\
+    supports_kafka,\
     supports_image_reader,\
-    supports_s3
+    supports_isal,\
+    supports_lz4,\
+    supports_orc_reader,\
+    supports_parquet_reader,\
+    supports_s3,\
+    supports_s3_crt,\
+    supports_bzip2,\
+    supports_zstd,\
+    verify_checksums,\
+    wrap_file_object,\
+    write_checksum_manifest,\
+    write_columnar_file,\
+    write_recordio_protobuf_file,\
+    write_file_manifest,\
+    write_tar_shard,\
+    write_trace,\
+    write_recordio_index
 
 
 __version__ = pkg_resources.get_distribution("mlio").version
 
 
 __all__ = [
+    'AllocationAudit',
+    'AllocationStats',
     'Attribute',
+    'AudioOutput',
+    'AudioReader',
+    'AudioReaderParams',
+    'AvroReader',
+    'AvroReaderParams',
+    'AzureBlob',
+    'AzureBlobClient',
     'BadExampleHandling',
+    'CachingDataReader',
+    'CachingParams',
+    'Checksum',
+    'ChecksumAlgorithm',
+    'ChecksumError',
+    'ChecksumMismatchHandling',
+    'ColumnStatistics',
+    'ColumnStatisticsCollector',
+    'ColumnStatisticsParams',
+    'ColumnarCompression',
+    'ColumnarReader',
+    'ColumnarWriter',
+    'ColumnarWriterParams',
+    'CompositeDataReader',
     'Compression',
+    'ConcatReader',
     'CooTensor',
     'CorruptFooterError',
     'CorruptHeaderError',
     'CorruptRecordError',
+    'CsrTensor',
     'CsvReader',
     'CsvParams',
     'DataReader',
     'DataReaderError',
     'DataReaderParams',
+    'DataReaderState',
+    'DataServiceParams',
+    'DataServiceReader',
+    'DataServiceWorker',
+    'DataWriter',
     'DataStore',
     'DataType',
+    'DecodeScheduling',
     'DenseTensor',
     'Device',
     'DeviceArray',
     'DeviceKind',
     'Example',
+    'ExampleConversionParams',
+    'ExampleQueueHandling',
+    'ExampleTransform',
     'File',
+    'FileIoParams',
+    'FileObjectStore',
+    'FilterOp',
+    'FrameSampling',
+    'GcsClient',
+    'GcsObject',
+    'GzipInflateParams',
+    'HttpClient',
+    'HttpObject',
     'ImageFrame',
+    'ImageLayout',
     'ImageReader',
     'ImageReaderParams',
     'InMemoryStore',
+    'InflateBackend',
     'InflateError',
     'InputStream',
+    'InstanceCount',
+    'InterleaveOrdering',
     'InvalidInstanceError',
+    'JsonLinesParams',
+    'JsonLinesReader',
+    'KafkaClient',
+    'KafkaPartition',
+    'LibsvmParams',
+    'LibsvmReader',
     'LastExampleHandling',
     'LogLevel',
     'MLIOError',
     'MaxFieldLengthHandling',
     'MemorySlice',
+    'MixtureParams',
+    'MixtureReader',
     'NotSupportedError',
+    'OrcReader',
+    'OrcReaderParams',
+    'ParallelDataReader',
+    'ParquetReader',
+    'ParquetReaderParams',
     'ParquetRecordReader',
+    'ParquetRowGroupFilter',
     'ParserParams',
+    'PrefetchParams',
+    'RangeReadParams',
+    'ReaderStats',
     'Record',
     'RecordError',
+    'RecordIOIndexEntry',
     'RecordIOProtobufReader',
+    'RecordIOProtobufWriter',
+    'RecordIOProtobufWriterParams',
     'RecordKind',
     'RecordReader',
     'RecordTooLargeError',
+    'RowFilter',
     'S3Client',
     'S3Object',
+    'S3ObjectCache',
+    'S3RangeReadParams',
+    'S3RetryMode',
     'SageMakerPipe',
+    'SageMakerPipeStats',
     'Schema',
     'SchemaError',
+    'ShardingStrategy',
+    'SharedDataStore',
+    'SharedMemoryDistribution',
+    'SharedMemoryReader',
+    'SharedMemoryReaderServer',
+    'SharedMemoryServerParams',
+    'SharedReadGroup',
+    'SparseTensorFormat',
+    'StageStats',
+    'StoreStats',
     'StreamError',
+    'StringTensor',
+    'SyncDecoder',
     'Tensor',
+    'TensorPool',
+    'TensorPoolStats',
     'TextLineReader',
+    'TfExampleParams',
+    'TfExampleReader',
+    'ThreadPool',
+    'VideoReader',
+    'VideoReaderParams',
+    'VerifiedDataStore',
+    'WordpieceParams',
+    'ZipMember',
+    'ZipReader',
+    'allocation_audit',
+    'build_recordio_index',
+    'concat_examples',
+    'commit_kafka_partitions',
+    'compute_checksum',
+    'convert_example',
     'deallocate_aws_sdk',
     'initialize_aws_sdk',
     'list_files',
+    'list_azure_blobs',
+    'list_gcs_objects',
+    'list_kafka_partitions',
     'list_s3_objects',
+    'list_zip_members',
+    'read_checksum_manifest',
+    'read_file_manifest',
+    'read_recordio_index',
+    'set_default_file_io_params',
+    'set_default_gzip_inflate_params',
+    'set_default_prefetch_params',
+    'set_max_num_threads',
+    'slice_example',
+    'start_allocation_audit',
+    'start_tracing',
+    'stop_allocation_audit',
+    'stop_tracing',
+    'supports_cuda',
+    'supports_azure',
+    'supports_gcs',
+    'supports_http',
+    'supports_kafka',
     'supports_image_reader',
-    'supports_s3']
+    'supports_isal',
+    'supports_lz4',
+    'supports_orc_reader',
+    'supports_parquet_reader',
+    'supports_s3',
+    'supports_s3_crt',
+    'supports_bzip2',
+    'supports_zstd',
+    'verify_checksums',
+    'wrap_file_object',
+    'write_checksum_manifest',
+    'write_columnar_file',
+    'write_recordio_protobuf_file',
+    'write_file_manifest',
+    'write_tar_shard',
+    'write_trace',
+    'write_recordio_index']
 
 
 _logger = logging.getLogger("mlio")
@@ -0,0 +1,335 @@
+# Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"). You
+# may not use this file except in compliance with the License. A copy of
+# the License is located at
+#
+#      http://aws.amazon.com/apache2.0/
+#
+# or in the "license" file accompanying this file. This file is
+# distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+# ANY KIND, either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+
+"""
+Runs a number of batches of a dataset through one of the framework
+integrations and reports where the time went:
+
+    $ python -m mlio.bench --reader csv --integration as_torch data.csv
+
+The native stages come from the statistics of the reader; the time spent
+converting the examples and waiting for the GIL is measured in Python.
+"""
+
+import argparse
+import json
+import sys
+import time
+
+import mlio
+
+
+def _make_csv_reader(prm, args):
+    return mlio.CsvReader(prm)
+
+
+def _make_recordio_protobuf_reader(prm, args):
+    return mlio.RecordIOProtobufReader(prm)
+
+
+def _make_text_line_reader(prm, args):
+    return mlio.TextLineReader(prm)
+
+
+def _make_image_reader(prm, args):
+    if args.image_dimensions is None:
+        raise ValueError("The image reader requires --image-dimensions.")
+
+    img_prm = mlio.ImageReaderParams(
+        image_frame=mlio.ImageFrame.RECORDIO,
+        image_dimensions=args.image_dimensions,
+        resize=args.image_dimensions[1],
+        to_rgb=args.image_dimensions[0] == 3)
+
+    return mlio.ImageReader(prm, img_prm)
+
+
+_readers = {
+    'csv': _make_csv_reader,
+    'recordio_protobuf': _make_recordio_protobuf_reader,
+    'text_line': _make_text_line_reader,
+    'image': _make_image_reader,
+}
+
+
+def _make_numpy_converter():
+    from mlio.integ.numpy import as_numpy
+    from mlio.integ.scipy import to_coo_matrix
+
+    def convert(tensor):
+        if isinstance(tensor, mlio.DenseTensor):
+            return as_numpy(tensor)
+        return to_coo_matrix(tensor)
+
+    return convert
+
+
+def _make_torch_converter():
+    from mlio.integ.torch import as_torch, as_torch_sparse
+
+    def convert(tensor):
+        if isinstance(tensor, mlio.DenseTensor):
+            return as_torch(tensor)
+        return as_torch_sparse(tensor)
+
+    return convert
+
+
+_converters = {
+    'as_numpy': _make_numpy_converter,
+    'as_torch': _make_torch_converter,
+}
+
+
+class _Timings:
+    def __init__(self):
+        self.num_batches = 0
+        self.read_seconds = 0.0
+        self.convert_seconds = 0.0
+        self.total_seconds = 0.0
+
+
+def _run_converter(reader, features, convert, num_batches):
+    """
+    Reads the examples and converts their features one by one so that
+    the time spent in ``read_example()`` and in the conversion can be
+    told apart.
+    """
+    t = _Timings()
+
+    start = time.perf_counter()
+
+    while num_batches == 0 or t.num_batches < num_batches:
+        read_start = time.perf_counter()
+
+        example = reader.read_example()
+
+        convert_start = time.perf_counter()
+
+        t.read_seconds += convert_start - read_start
+
+        if example is None:
+            break
+
+        names = features or [a.name for a in example.schema.attributes]
+        for name in names:
+            convert(example[name])
+
+        t.convert_seconds += time.perf_counter() - convert_start
+
+        t.num_batches += 1
+
+    t.total_seconds = time.perf_counter() - start
+
+    return t
+
+
+def _run_tf_dataset(reader, features, num_batches):
+    import tensorflow as tf
+
+    from mlio.integ.numpy import as_numpy
+    from mlio.integ.tensorflow import make_tf_dataset
+
+    # The dtypes of the dataset are inferred from the first example.
+    example = reader.peek_example()
+    if example is None:
+        return _Timings()
+
+    features = features or [a.name for a in example.schema.attributes]
+
+    dtypes = [tf.as_dtype(as_numpy(example[name]).dtype) for name in features]
+
+    dataset = make_tf_dataset(reader, features, dtypes)
+    if num_batches > 0:
+        dataset = dataset.take(num_batches)
+
+    t = _Timings()
+
+    start = time.perf_counter()
+
+    for _ in dataset:
+        t.num_batches += 1
+
+    # The reads happen inside the generator of the dataset; everything
+    # that is not spent in the native reader is counted as conversion.
+    t.total_seconds = time.perf_counter() - start
+
+    return t
+
+
+def _stage_seconds(stage):
+    return stage.total_ns / 1e9
+
+
+def run(args):
+    """
+    Runs the benchmark described by the specified command line arguments
+    and returns its report as a dictionary.
+    """
+    compression = mlio.Compression.GZIP if args.gzip else \
+        mlio.Compression.INFER
+
+    prm = mlio.DataReaderParams(
+        dataset=[mlio.File(p, compression=compression) for p in args.paths],
+        batch_size=args.batch_size,
+        num_parallel_reads=args.num_parallel_reads,
+        num_prefetched_examples=args.num_prefetched_examples,
+        shuffle_instances=args.shuffle_window > 0,
+        shuffle_window=args.shuffle_window)
+
+    reader = _readers[args.reader](prm, args)
+
+    if args.integration == 'make_tf_dataset':
+        t = _run_tf_dataset(reader, args.features, args.num_batches)
+    else:
+        convert = _converters[args.integration]()
+
+        t = _run_converter(reader, args.features, convert,
+                           args.num_batches)
+
+    stats = reader.stats()
+
+    native_read = _stage_seconds(stats.read)
+    native_decode = _stage_seconds(stats.decode)
+    native_transform = _stage_seconds(stats.transform)
+
+    # The time the consumer has waited for the reader to produce an
+    # example.
+    consume = _stage_seconds(stats.consume)
+
+    if args.integration == 'make_tf_dataset':
+        gil_wait = None
+        convert_seconds = max(t.total_seconds - consume, 0.0)
+    else:
+        # read_example() releases the GIL while it waits; the time it
+        # takes beyond the native wait is spent reacquiring the GIL and
+        # crossing the binding.
+        gil_wait = max(t.read_seconds - consume, 0.0)
+        convert_seconds = t.convert_seconds
+
+    if consume > convert_seconds:
+        bottleneck = 'mlio'
+    else:
+        bottleneck = 'consumer'
+
+    report = {
+        'reader': args.reader,
+        'integration': args.integration,
+        'batch_size': args.batch_size,
+        'num_parallel_reads': stats.num_parallel_reads,
+        'num_batches': t.num_batches,
+        'num_instances': stats.num_instances,
+        'seconds': t.total_seconds,
+        'batches_per_second':
+            t.num_batches / t.total_seconds if t.total_seconds > 0 else 0.0,
+        'wait_for_mlio_seconds': consume,
+        'convert_seconds': convert_seconds,
+        'gil_wait_seconds': gil_wait,
+        'native_read_seconds': native_read,
+        'native_decode_seconds': native_decode,
+        'native_transform_seconds': native_transform,
+        'peak_memory_usage': stats.peak_memory_usage,
+        'bottleneck': bottleneck,
+    }
+
+    return report
+
+
+def _print_report(report, file):
+    def line(label, seconds):
+        if seconds is None:
+            print('  {:<24}{:>12}'.format(label, 'n/a'), file=file)
+            return
+
+        share = seconds / report['seconds'] * 100 if report['seconds'] else 0
+
+        print('  {:<24}{:>10.3f} s {:>5.1f}%'.format(label, seconds, share),
+              file=file)
+
+    print('{reader} via {integration}: {num_batches} batches of '
+          '{batch_size} in {seconds:.3f} s '
+          '({batches_per_second:.1f} batches/s)'.format(**report), file=file)
+
+    print('Consumer thread:', file=file)
+    line('waiting for mlio', report['wait_for_mlio_seconds'])
+    line('conversion', report['convert_seconds'])
+    line('GIL wait', report['gil_wait_seconds'])
+
+    # The native stages run on the background threads of the reader and
+    # overlap with the consumer; their sum can exceed the wall time.
+    print('Reader threads (cumulative):', file=file)
+    line('read', report['native_read_seconds'])
+    line('decode', report['native_decode_seconds'])
+    line('transform', report['native_transform_seconds'])
+
+    if report['bottleneck'] == 'mlio':
+        print('The consumer mostly waits for mlio; consider raising '
+              '--num-parallel-reads.', file=file)
+    else:
+        print('mlio keeps up with the consumer; the time goes into the '
+              'conversion and the consuming code.', file=file)
+
+
+def _parse_dimensions(s):
+    return [int(v) for v in s.split(',')]
+
+
+def parse_args(args):
+    parser = argparse.ArgumentParser(
+        prog='python -m mlio.bench',
+        description='Reads a dataset through a framework integration and '
+                    'reports whether mlio or the consumer is the '
+                    'bottleneck.')
+
+    parser.add_argument('paths', nargs='+',
+                        help='The files of the dataset.')
+    parser.add_argument('--reader', choices=list(_readers), default='csv')
+    parser.add_argument('--integration',
+                        choices=list(_converters) + ['make_tf_dataset'],
+                        default='as_numpy')
+    parser.add_argument('--features', type=lambda s: s.split(','),
+                        help='The comma-separated names of the features to '
+                             'convert; by default all of them.')
+    parser.add_argument('--batch-size', type=int, default=256)
+    parser.add_argument('--num-batches', type=int, default=0,
+                        help='The number of batches to read; zero means '
+                             'the whole dataset.')
+    parser.add_argument('--num-parallel-reads', type=int, default=0)
+    parser.add_argument('--num-prefetched-examples', type=int, default=0)
+    parser.add_argument('--shuffle-window', type=int, default=0)
+    parser.add_argument('--gzip', action='store_true',
+                        help='Treat the files as gzip-compressed regardless '
+                             'of their extension.')
+    parser.add_argument('--image-dimensions', type=_parse_dimensions,
+                        help='The channels,height,width of the images.')
+    parser.add_argument('--json', action='store_true',
+                        help='Print the report as JSON.')
+
+    return parser.parse_args(args)
+
+
+def main(args=None):
+    args = parse_args(sys.argv[1:] if args is None else args)
+
+    report = run(args)
+
+    if args.json:
+        json.dump(report, sys.stdout, indent=2)
+
+        sys.stdout.write('\n')
+    else:
+        _print_report(report, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -16,16 +16,49 @@
 #include "column_analyzer.h"
 
 #include <cmath>
-#include <iostream>
-#include <sstream>
+#include <cstring>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "utils.h"
 
 namespace pymlio {
 
-static constexpr int max_sample_size = 10000;
+static constexpr std::size_t max_word_batch_size = 1024;
+
+namespace {
+
+// Splits the specified string on spaces the same way std::getline does;
+// memchr is vectorized by the C library, which makes this considerably
+// faster than going through a string stream.
+std::size_t split_words(std::string_view s, std::vector<std::string_view> &words)
+{
+    std::size_t num_words = 0;
+
+    std::size_t pos = 0;
+    while (pos < s.size()) {
+        const void *space = std::memchr(s.data() + pos, ' ', s.size() - pos);
+
+        std::size_t end{};
+        if (space == nullptr) {
+            end = s.size();
+        }
+        else {
+            end = static_cast<std::size_t>(static_cast<const char *>(space) - s.data());
+        }
+
+        words.emplace_back(s.substr(pos, end - pos));
+
+        num_words++;
+
+        pos = end + 1;
+    }
+
+    return num_words;
+}
+
+}  // namespace
 
 Column_analyzer::Column_analyzer(std::vector<Column_analysis> &columns,
                                  const std::vector<std::string> &null_like_values,
@@ -41,6 +74,8 @@ void Column_analyzer::analyze(const mlio::Example &example) const
 {
     std::size_t feature_idx = 0;
 
+    std::vector<std::string_view> words{};
+
     for (auto pos = example.features().begin(); pos < example.features().end();
          ++pos, feature_idx++) {
         const auto &tensor = example.features()[feature_idx];
@@ -84,11 +119,14 @@ void Column_analyzer::analyze(const mlio::Example &example) const
 
             stats.str_cardinality_estimator_.add(cell);
 
-            std::istringstream iss(cell);
-            std::string token;
-            while (std::getline(iss, token, ' ')) {
-                stats.str_vocab_cardinality_estimator_.add(token);
-                stats.str_num_words++;
+            stats.str_num_words += split_words(cell, words);
+
+            // Hash the words in batches; the views remain valid as long
+            // as the example.
+            if (words.size() >= max_word_batch_size) {
+                stats.str_vocab_cardinality_estimator_.add(words.data(), words.size());
+
+                words.clear();
             }
 
             if (mlio::is_whitespace_only(cell)) {
@@ -116,9 +154,7 @@ void Column_analyzer::analyze(const mlio::Example &example) const
                     numeric_column_sum += as_float;
                     numeric_column_count++;
 
-                    if (stats.numeric_column_sample_.size() < max_sample_size) {
-                        stats.numeric_column_sample_.push_back(as_float);
-                    }
+                    stats.numeric_quantile_sketch_.add(as_float);
 
                     if ((std::abs(std::round(as_float) - as_float) <= 1.0e-5)) {
                         stats.numeric_int_count++;
@@ -137,6 +173,12 @@ void Column_analyzer::analyze(const mlio::Example &example) const
 
             auto should_capture = capture_columns_->find(feature_idx) != capture_columns_->end();
 
+            // Unlike the captured values, the sketch keeps tracking the
+            // most frequent values once the limit is reached.
+            if (should_capture) {
+                stats.str_frequent_values_sketch_.add(cell);
+            }
+
             // Capture the values if specified.
             if (should_capture && !stats.str_captured_unique_values_overflowed) {
                 if (stats.str_captured_unique_values.size() < max_capture_count_) {
@@ -152,6 +194,10 @@ void Column_analyzer::analyze(const mlio::Example &example) const
             }
         }
 
+        stats.str_vocab_cardinality_estimator_.add(words.data(), words.size());
+
+        words.clear();
+
         // Update the mean of numeric values based on the entire range of values.
         auto ncc = static_cast<double>(numeric_column_count);
         auto nfc = static_cast<double>(stats.numeric_finite_count);
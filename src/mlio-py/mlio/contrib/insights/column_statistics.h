@@ -25,6 +25,7 @@
 #include <vector>
 
 #include <hyperloglog.h>
+#include <mlio.h>
 
 namespace pymlio {
 
@@ -35,10 +36,11 @@ private:
     static constexpr uint8_t cardinality_hill_size = 16;
 
 public:
-    explicit Column_analysis(std::string name)
+    explicit Column_analysis(std::string name, std::size_t max_frequent_values = 1000)
         : column_name{std::move(name)}
         , str_cardinality_estimator_{cardinality_hill_size}
         , str_vocab_cardinality_estimator_{cardinality_hill_size}
+        , str_frequent_values_sketch_{max_frequent_values}
     {}
 
     std::size_t estimate_string_cardinality() const
@@ -48,15 +50,23 @@ public:
 
     double estimate_median_approx() const
     {
-        if (numeric_column_sample_.empty()) {
-            return std::numeric_limits<double>::quiet_NaN();
-        }
+        return numeric_quantile_sketch_.quantile(0.5);
+    }
 
-        std::size_t n = numeric_column_sample_.size() / 2;
-        std::nth_element(numeric_column_sample_.begin(),
-                         numeric_column_sample_.begin() + static_cast<std::ptrdiff_t>(n),
-                         numeric_column_sample_.end());
-        return numeric_column_sample_[n];
+    double estimate_quantile_approx(double q) const
+    {
+        return numeric_quantile_sketch_.quantile(q);
+    }
+
+    /// Returns up to k of the most frequent values of a captured column
+    /// along with their estimated counts.
+    std::vector<std::pair<std::string, std::size_t>> estimate_top_values(std::size_t k) const
+    {
+        std::vector<std::pair<std::string, std::size_t>> result{};
+        for (auto &entry : str_frequent_values_sketch_.top(k)) {
+            result.emplace_back(std::move(entry.value), entry.count);
+        }
+        return result;
     }
 
     std::size_t estimate_string_vocab_cardinality() const
@@ -91,7 +101,8 @@ public:
 private:
     hll::HyperLogLog str_cardinality_estimator_;
     hll::HyperLogLog str_vocab_cardinality_estimator_;
-    mutable std::vector<double> numeric_column_sample_{};
+    mlio::Quantile_sketch numeric_quantile_sketch_{};
+    mlio::Frequent_values_sketch str_frequent_values_sketch_;
 };
 
 struct data_analysis {
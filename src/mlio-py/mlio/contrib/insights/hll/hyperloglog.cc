@@ -32,6 +32,17 @@
 
 namespace hll {
 
+namespace {
+
+// XXH3 is considerably faster than XXH32 on the short strings, such as
+// words, that make up most of the values added to the estimator.
+inline uint32_t hash_value(const std::string_view &str)
+{
+    return static_cast<uint32_t>(XXH3_64bits_withSeed(str.data(), str.size(), HLL_HASH_SEED));
+}
+
+}  // namespace
+
 HyperLogLog::HyperLogLog(uint8_t b) : b_(b), m_(1 << b), M_(m_, 0)
 {
     if (b < 4 || 30 < b) {
@@ -58,17 +69,24 @@ HyperLogLog::HyperLogLog(uint8_t b) : b_(b), m_(1 << b), M_(m_, 0)
 
 void HyperLogLog::add(const std::string_view &str)
 {
-    // Hash the value to add.
-    uint32_t hash;
-    hash = XXH32(str.begin(), str.size(), HLL_HASH_SEED);
-    // Determine the register that this belongs to.
-    // (e.g. use the first b_ bits as an index).
-    uint32_t index = hash >> (32 - b_);
-    // Get the number of leading zeros.
-    uint8_t rank = _GET_CLZ((hash << b_), 32 - b_);
-    // Update the register if there are more leading zeros.
-    if (rank > M_[index]) {
-        M_[index] = rank;
+    add_hash(hash_value(str));
+}
+
+void HyperLogLog::add(const std::string_view *strs, std::size_t size)
+{
+    constexpr std::size_t batch_size = 64;
+
+    uint32_t hashes[batch_size];
+
+    for (std::size_t offset = 0; offset < size; offset += batch_size) {
+        std::size_t n = std::min(batch_size, size - offset);
+
+        for (std::size_t i = 0; i < n; i++) {
+            hashes[i] = hash_value(strs[offset + i]);
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            add_hash(hashes[i]);
+        }
     }
 }
 
@@ -26,9 +26,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #pragma GCC diagnostic push
@@ -82,6 +84,11 @@ public:
     /// Adds a string-value to the estimator.
     void add(const std::string_view &str);
 
+    /// Adds the specified string-values to the estimator. The values are
+    /// hashed in batches ahead of the register updates, which keeps the
+    /// hash loop free of dependent loads and stores.
+    void add(const std::string_view *strs, std::size_t size);
+
     /// Estimates the cardinality.
     double estimate() const;
 
@@ -95,6 +102,19 @@ public:
     uint32_t register_size() const;
 
 protected:
+    void add_hash(uint32_t hash)
+    {
+        // Determine the register that this belongs to.
+        // (e.g. use the first b_ bits as an index).
+        uint32_t index = hash >> (32 - b_);
+        // Get the number of leading zeros.
+        uint8_t rank = _GET_CLZ((hash << b_), 32 - b_);
+        // Update the register if there are more leading zeros.
+        if (rank > M_[index]) {
+            M_[index] = rank;
+        }
+    }
+
     /// register bit width
     uint8_t b_;
     /// register size
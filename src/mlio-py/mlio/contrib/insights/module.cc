@@ -13,6 +13,7 @@
  * language governing permissions and limitations under the License.
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <limits>
@@ -58,7 +59,7 @@ data_analysis analyze_dataset(mlio::Data_reader &reader,
             throw std::runtime_error("Data insights only works with dense string tensors.");
         }
 
-        column_stats.emplace_back(attr.name());
+        column_stats.emplace_back(attr.name(), std::max(max_capture_count, std::size_t{1}));
     }
 
     std::vector<std::string> null_like_list{null_like_values.begin(), null_like_values.end()};
@@ -136,6 +137,8 @@ PYBIND11_MODULE(insights, m)
     ca_class.def("estimate_string_cardinality", &Column_analysis::estimate_string_cardinality);
     ca_class.def("estimate_string_vocab_cardinality",
                  &Column_analysis::estimate_string_vocab_cardinality);
+    ca_class.def("estimate_quantile_approx", &Column_analysis::estimate_quantile_approx, "q"_a);
+    ca_class.def("estimate_top_values", &Column_analysis::estimate_top_values, "k"_a);
 
     ca_class.def("to_dict", [=](const Column_analysis &self) {
         py::dict result{};
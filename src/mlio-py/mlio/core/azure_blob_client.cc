@@ -0,0 +1,100 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+namespace {
+
+Intrusive_ptr<Azure_blob_client>
+py_make_azure_blob_client(const std::string &connection_string,
+                          const std::string &account_url,
+                          const std::string &account_name,
+                          const std::string &account_key,
+                          const std::string &sas_token,
+                          const Range_read_params &range_read_params,
+                          Intrusive_ptr<S3_object_cache> object_cache,
+                          std::size_t connect_timeout_ms,
+                          std::size_t max_attempts)
+{
+    Azure_blob_client_options opts{};
+    opts.connection_string = connection_string;
+    opts.account_url = account_url;
+    opts.account_name = account_name;
+    opts.account_key = account_key;
+    opts.sas_token = sas_token;
+    opts.range_read_params = range_read_params;
+    opts.object_cache = std::move(object_cache);
+    opts.connect_timeout = std::chrono::milliseconds{connect_timeout_ms};
+    opts.max_attempts = max_attempts;
+
+    return make_azure_blob_client(opts);
+}
+
+}  // namespace
+
+void register_azure_blob_client(py::module &m)
+{
+    py::class_<Azure_blob_client, Intrusive_ptr<Azure_blob_client>>(
+        m,
+        "AzureBlobClient",
+        "Represents a client to access the blobs of an Azure storage account.")
+        .def(py::init<>(&py_make_azure_blob_client),
+             "connection_string"_a = "",
+             "account_url"_a = "",
+             "account_name"_a = "",
+             "account_key"_a = "",
+             "sas_token"_a = "",
+             "range_read_params"_a = Range_read_params{},
+             "object_cache"_a = nullptr,
+             "connect_timeout_ms"_a = 0,
+             "max_attempts"_a = 0,
+             R"(
+            Parameters
+            ----------
+            connection_string : str, optional
+                The connection string of the storage account.
+            account_url : str, optional
+                The URL of the Blob service of the storage account. If not
+                specified, it is derived from the account name.
+            account_name : str, optional
+                The name of the storage account.
+            account_key : str, optional
+                The access key of the storage account.
+            sas_token : str, optional
+                A shared access signature that authorizes the requests.
+            range_read_params : RangeReadParams
+                The parameters for reading the blobs with concurrent
+                byte-range GET requests.
+            object_cache : S3ObjectCache, optional
+                The local cache through which the blobs are read.
+            connect_timeout_ms : int
+                The timeout for establishing a connection.
+            max_attempts : int
+                The maximum number of attempts per request.
+            )");
+}
+
+}  // namespace pymlio
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+namespace {
+
+Column_statistics_params make_column_statistics_params(std::vector<std::string> null_like_values,
+                                                       std::uint8_t cardinality_precision,
+                                                       std::size_t quantile_sketch_size,
+                                                       std::size_t frequent_values_sketch_size)
+{
+    Column_statistics_params params{};
+
+    params.null_like_values = std::move(null_like_values);
+    params.cardinality_precision = cardinality_precision;
+    params.quantile_sketch_size = quantile_sketch_size;
+    params.frequent_values_sketch_size = frequent_values_sketch_size;
+
+    return params;
+}
+
+Intrusive_ptr<Column_statistics_collector>
+make_column_statistics_collector(Column_statistics_params params)
+{
+    return make_intrusive<Column_statistics_collector>(std::move(params));
+}
+
+}  // namespace
+
+void register_column_statistics(py::module &m)
+{
+    py::class_<Column_statistics>(m, "ColumnStatistics", "Contains the statistics of a column.")
+        .def_readonly("name", &Column_statistics::name)
+        .def_readonly("data_type", &Column_statistics::data_type)
+        .def_readonly("num_values", &Column_statistics::num_values)
+        .def_readonly("num_nulls", &Column_statistics::num_nulls)
+        .def_readonly("num_numeric", &Column_statistics::num_numeric)
+        .def_readonly("num_finite", &Column_statistics::num_finite)
+        .def_readonly("min", &Column_statistics::min)
+        .def_readonly("max", &Column_statistics::max)
+        .def_readonly("mean", &Column_statistics::mean)
+        .def_readonly("variance", &Column_statistics::variance)
+        .def_readonly("min_length", &Column_statistics::min_length)
+        .def_readonly("max_length", &Column_statistics::max_length)
+        .def_readonly("mean_length", &Column_statistics::mean_length)
+        .def_readonly("num_words", &Column_statistics::num_words)
+        .def_readonly("approx_distinct_count", &Column_statistics::approx_distinct_count)
+        .def_readonly("approx_distinct_word_count",
+                      &Column_statistics::approx_distinct_word_count)
+        .def(
+            "quantile",
+            [](const Column_statistics &self, double q) {
+                return self.quantile_sketch.quantile(q);
+            },
+            "q"_a,
+            R"(
+            Return the estimated value at the specified quantile of the
+            finite numbers, or NaN if there are none.
+
+            Parameters
+            ----------
+            q : float
+                The quantile, between 0 and 1.
+            )")
+        .def(
+            "top_values",
+            [](const Column_statistics &self, std::size_t k) {
+                std::vector<std::tuple<std::string, std::size_t, std::size_t>> result{};
+                if (self.frequent_values) {
+                    for (auto &entry : self.frequent_values->top(k)) {
+                        result.emplace_back(std::move(entry.value), entry.count, entry.error);
+                    }
+                }
+                return result;
+            },
+            "k"_a,
+            R"(
+            Return up to `k` of the most frequent values of a string column
+            as a list of (value, count, error) tuples ordered by count. The
+            count is an upper bound of the number of occurrences of the
+            value, and count - error a lower bound. Empty unless
+            `frequent_values_sketch_size` is greater than zero.
+
+            Parameters
+            ----------
+            k : int
+                The maximum number of values to return.
+            )")
+        .def("__repr__", [](const Column_statistics &self) {
+            return "<ColumnStatistics name='" + self.name + "'>";
+        });
+
+    py::class_<Column_chunk>(m,
+                             "ColumnChunk",
+                             "Holds the values of a single column for a run of consecutive rows.")
+        .def_readonly("name", &Column_chunk::name, "The name of the column.")
+        .def_readonly("values",
+                      &Column_chunk::values,
+                      R"(
+            The values of the column; a ``DenseTensor`` of shape (number of
+            rows, 1) for a numeric column, or a ``StringTensor`` for a
+            string column. The tensor can have trailing padding rows.)")
+        .def_readonly("num_rows",
+                      &Column_chunk::num_rows,
+                      "The number of rows of ``values``, excluding the padding.")
+        .def("__repr__", [](const Column_chunk &self) {
+            return "<ColumnChunk name='" + self.name + "'>";
+        });
+
+    py::class_<Column_statistics_params>(m,
+                                         "ColumnStatisticsParams",
+                                         "Represents the optional parameters of a "
+                                         "``ColumnStatisticsCollector`` object.")
+        .def(py::init(&make_column_statistics_params),
+             "null_like_values"_a = std::vector<std::string>{},
+             "cardinality_precision"_a = 12,
+             "quantile_sketch_size"_a = 200,
+             "frequent_values_sketch_size"_a = 0,
+             R"(
+            Parameters
+            ----------
+            null_like_values : list of strs, optional
+                The string values that are counted as null. The comparison
+                is case-insensitive and ignores leading and trailing
+                whitespace.
+            cardinality_precision : int, optional
+                The precision of the HyperLogLog estimators used to
+                estimate the number of distinct values; each estimator has
+                2^precision one-byte registers. Must be between 4 and 18.
+            quantile_sketch_size : int, optional
+                The size parameter of the KLL sketches used to estimate the
+                quantiles of the numeric values; the rank error is roughly
+                1.7 divided by the size.
+            frequent_values_sketch_size : int, optional
+                If greater than zero, the most frequent values of the string
+                columns are tracked with Space-Saving sketches of this many
+                counters.
+            )")
+        .def_readwrite("null_like_values", &Column_statistics_params::null_like_values)
+        .def_readwrite("cardinality_precision", &Column_statistics_params::cardinality_precision)
+        .def_readwrite("quantile_sketch_size", &Column_statistics_params::quantile_sketch_size)
+        .def_readwrite("frequent_values_sketch_size",
+                       &Column_statistics_params::frequent_values_sketch_size);
+
+    py::class_<Column_statistics_collector, Intrusive_ptr<Column_statistics_collector>>(
+        m,
+        "ColumnStatisticsCollector",
+        R"(
+        Computes the statistics of the columns of the examples added to
+        it. Each thread aggregates into its own partial statistics which
+        are merged in parallel when ``statistics()`` is called. Can be
+        passed to a data reader through
+        ``DataReaderParams.column_statistics``.)")
+        .def(py::init<>(&make_column_statistics_collector),
+             "column_statistics_params"_a = Column_statistics_params{},
+             R"(
+            Parameters
+            ----------
+            column_statistics_params : ColumnStatisticsParams, optional
+                See ``ColumnStatisticsParams``.
+            )")
+        .def("add",
+             py::overload_cast<const Example &>(&Column_statistics_collector::add),
+             "example"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             "Add the instances of the specified example.")
+        .def(
+            "add",
+            [](Column_statistics_collector &self, const std::vector<Column_chunk> &chunks) {
+                self.add(chunks);
+            },
+            "chunks"_a,
+            py::call_guard<py::gil_scoped_release>(),
+            R"(
+            Add the rows of the specified column chunks; one chunk per
+            column, in the same order in every call. See
+            ``CsvReader.read_column_chunks()``.)")
+        .def("statistics",
+             &Column_statistics_collector::statistics,
+             py::call_guard<py::gil_scoped_release>(),
+             "Return the statistics of the examples added so far.")
+        .def("reset",
+             &Column_statistics_collector::reset,
+             py::call_guard<py::gil_scoped_release>(),
+             "Discard the statistics of the examples added so far.");
+}
+
+}  // namespace pymlio
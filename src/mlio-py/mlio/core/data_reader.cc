@@ -19,6 +19,8 @@
 
 #include <exception>
 
+#include "py_memory_block.h"
+
 namespace py = pybind11;
 
 using namespace mlio;
@@ -55,6 +57,26 @@ private:
     py::object parent_;
 };
 
+Intrusive_ptr<Example> decode_buffer(Parallel_data_reader &reader, const py::buffer &buf)
+{
+    // The block must outlive the released GIL; its destructor releases
+    // the Python buffer.
+    auto block = make_intrusive<Py_memory_block>(buf);
+
+    py::gil_scoped_release rel_gil;
+
+    return reader.decode_buffer(Memory_slice{block});
+}
+
+Intrusive_ptr<Example> sync_decode(Sync_decoder &decoder, const py::buffer &buf)
+{
+    auto block = make_intrusive<Py_memory_block>(buf);
+
+    py::gil_scoped_release rel_gil;
+
+    return decoder.decode(Memory_slice{block});
+}
+
 class Py_data_reader : public Data_reader {
 public:
     Intrusive_ptr<Example> read_example() override;
@@ -67,6 +89,8 @@ public:
 
 public:
     std::size_t num_bytes_read() const noexcept override;
+
+    std::size_t shuffle_buffer_size() const noexcept override;
 };
 
 Intrusive_ptr<Example> Py_data_reader::read_example()
@@ -109,6 +133,26 @@ std::size_t Py_data_reader::num_bytes_read() const noexcept
     }
 }
 
+std::size_t Py_data_reader::shuffle_buffer_size() const noexcept
+{
+    try {
+        // NOLINTNEXTLINE
+        PYBIND11_OVERLOAD_PURE(std::size_t, Data_reader, shuffle_buffer_size, )
+    }
+    catch (...) {
+        std::terminate();
+    }
+}
+
+Row_filter make_row_filter(std::string column, Filter_op op, std::string value)
+{
+    Row_filter filter{};
+    filter.column = std::move(column);
+    filter.op = op;
+    filter.value = std::move(value);
+    return filter;
+}
+
 Data_reader_params make_data_reader_params(std::vector<Intrusive_ptr<Data_store>> dataset,
                                            std::size_t batch_size,
                                            std::size_t num_prefetched_examples,
@@ -124,14 +168,94 @@ Data_reader_params make_data_reader_params(std::vector<Intrusive_ptr<Data_store>
                                            bool shuffle_instances,
                                            std::size_t shuffle_window,
                                            std::optional<std::size_t> shuffle_seed,
-                                           bool reshuffle_each_epoch)
+                                           bool reshuffle_each_epoch,
+                                           std::size_t max_batch_latency_ms,
+                                           bool autotune,
+                                           std::size_t autotune_memory_budget,
+                                           std::size_t memory_budget,
+                                           std::size_t num_threads,
+                                           bool dedicated_io_thread,
+                                           std::vector<std::size_t> cpu_affinity,
+                                           std::optional<std::size_t> numa_node,
+                                           bool auto_numa_node,
+                                           Intrusive_ptr<Thread_pool> thread_pool,
+                                           bool pipeline_epochs,
+                                           bool deterministic,
+                                           bool start_on_schema,
+                                           Example_queue_handling example_queue_handling,
+                                           Decode_scheduling decode_scheduling,
+                                           std::size_t tensor_pool_size,
+                                           bool tensor_pool_huge_pages,
+                                           std::optional<std::string> file_backed_output_directory,
+                                           std::size_t file_backed_output_threshold,
+                                           bool deferred_reclamation,
+                                           std::optional<Device> output_device,
+                                           std::vector<Device> output_devices,
+                                           Sparse_tensor_format sparse_tensor_format,
+                                           std::size_t interleave_cycle_length,
+                                           std::size_t interleave_block_length,
+                                           Interleave_ordering interleave_ordering,
+                                           std::size_t num_prefetched_data_stores,
+                                           Sharding_strategy sharding_strategy,
+                                           std::optional<std::size_t> shard_seed,
+                                           std::optional<std::size_t> sample_seed,
+                                           bool deduplicate_instances,
+                                           std::size_t dedup_memory_budget,
+                                           float dedup_false_positive_rate,
+                                           std::size_t shuffle_window_bytes,
+                                           std::string shuffle_spill_directory,
+                                           std::size_t num_shuffle_spill_buckets,
+                                           std::size_t materialize_memory_budget,
+                                           std::size_t max_batch_bytes,
+                                           std::size_t size_bucketing_lookahead,
+                                           bool shuffle_data_stores,
+                                           std::size_t shuffle_block_size,
+                                           std::vector<Intrusive_ptr<Data_store>> recordio_indexes,
+                                           std::size_t indexed_read_ahead,
+                                           Intrusive_ptr<Column_statistics_collector> column_statistics,
+                                           std::size_t min_store_throughput,
+                                           std::function<void(const Store_stats &)> slow_store_handler,
+                                           std::vector<Row_filter> row_filters,
+                                           std::string class_column,
+                                           std::map<std::string, float, std::less<>> class_sample_ratios,
+                                           float default_class_sample_ratio,
+                                           std::vector<Intrusive_ptr<Example_transform>> example_transforms)
 {
     Data_reader_params params{};
 
     params.dataset = std::move(dataset);
     params.batch_size = batch_size;
+    params.max_batch_bytes = max_batch_bytes;
+    params.max_batch_latency = std::chrono::milliseconds{max_batch_latency_ms};
+    params.size_bucketing_lookahead = size_bucketing_lookahead;
     params.num_prefetched_examples = num_prefetched_examples;
     params.num_parallel_reads = num_parallel_reads;
+    params.autotune = autotune;
+    params.autotune_memory_budget = autotune_memory_budget;
+    params.memory_budget = memory_budget;
+    params.num_threads = num_threads;
+    params.dedicated_io_thread = dedicated_io_thread;
+    params.cpu_affinity = std::move(cpu_affinity);
+    params.numa_node = numa_node;
+    params.auto_numa_node = auto_numa_node;
+    params.thread_pool = std::move(thread_pool);
+    params.pipeline_epochs = pipeline_epochs;
+    params.deterministic = deterministic;
+    params.start_on_schema = start_on_schema;
+    params.example_queue_handling = example_queue_handling;
+    params.decode_scheduling = decode_scheduling;
+    params.tensor_pool_size = tensor_pool_size;
+    params.tensor_pool_huge_pages = tensor_pool_huge_pages;
+    params.file_backed_output_directory = std::move(file_backed_output_directory);
+    params.file_backed_output_threshold = file_backed_output_threshold;
+    params.deferred_reclamation = deferred_reclamation;
+    params.output_device = output_device;
+    params.output_devices = std::move(output_devices);
+    params.sparse_tensor_format = sparse_tensor_format;
+    params.interleave_cycle_length = interleave_cycle_length;
+    params.interleave_block_length = interleave_block_length;
+    params.interleave_ordering = interleave_ordering;
+    params.num_prefetched_data_stores = num_prefetched_data_stores;
     params.last_example_handling = last_example_handling;
     params.bad_example_handling = bad_example_handling;
     params.warn_bad_instances = warn_bad_instances;
@@ -139,11 +263,33 @@ Data_reader_params make_data_reader_params(std::vector<Intrusive_ptr<Data_store>
     params.num_instances_to_read = num_instances_to_read;
     params.shard_index = shard_index;
     params.num_shards = num_shards;
+    params.sharding_strategy = sharding_strategy;
+    params.shard_seed = shard_seed;
     params.sample_ratio = sample_ratio;
+    params.sample_seed = sample_seed;
+    params.deduplicate_instances = deduplicate_instances;
+    params.dedup_memory_budget = dedup_memory_budget;
+    params.dedup_false_positive_rate = dedup_false_positive_rate;
     params.shuffle_instances = shuffle_instances;
     params.shuffle_window = shuffle_window;
+    params.shuffle_window_bytes = shuffle_window_bytes;
+    params.shuffle_spill_directory = std::move(shuffle_spill_directory);
+    params.num_shuffle_spill_buckets = num_shuffle_spill_buckets;
+    params.materialize_memory_budget = materialize_memory_budget;
     params.shuffle_seed = shuffle_seed;
     params.reshuffle_each_epoch = reshuffle_each_epoch;
+    params.shuffle_data_stores = shuffle_data_stores;
+    params.shuffle_block_size = shuffle_block_size;
+    params.recordio_indexes = std::move(recordio_indexes);
+    params.indexed_read_ahead = indexed_read_ahead;
+    params.column_statistics = std::move(column_statistics);
+    params.min_store_throughput = min_store_throughput;
+    params.slow_store_handler = std::move(slow_store_handler);
+    params.row_filters = std::move(row_filters);
+    params.class_column = std::move(class_column);
+    params.class_sample_ratios = std::move(class_sample_ratios);
+    params.default_class_sample_ratio = default_class_sample_ratio;
+    params.example_transforms = std::move(example_transforms);
 
     return params;
 }
@@ -167,7 +313,21 @@ Csv_params make_csv_reader_params(std::vector<std::string> column_names,
                                   std::optional<std::size_t> max_field_length,
                                   Max_field_length_handling max_field_length_handling,
                                   std::optional<std::size_t> max_line_length,
-                                  std::optional<Parser_options> parser_options)
+                                  std::optional<Parser_options> parser_options,
+                                  std::size_t num_type_inference_rows,
+                                  std::unordered_map<Data_type, Data_type> narrowed_types,
+                                  std::unordered_set<std::string> dictionary_encoded_columns,
+                                  std::unordered_set<std::size_t> dictionary_encoded_columns_by_index,
+                                  std::unordered_set<std::string> hashed_columns,
+                                  std::unordered_set<std::size_t> hashed_columns_by_index,
+                                  std::size_t num_hash_buckets,
+                                  std::uint32_t hash_seed,
+                                  bool stack_columns,
+                                  std::string stacked_feature_name,
+                                  bool lazy_decode,
+                                  bool arena_strings,
+                                  std::string schema_path,
+                                  bool map_columns_by_header)
 {
     Csv_params csv_params{};
 
@@ -176,10 +336,24 @@ Csv_params make_csv_reader_params(std::vector<std::string> column_names,
     csv_params.use_columns = std::move(use_columns);
     csv_params.use_columns_by_index = std::move(use_columns_by_index);
     csv_params.default_data_type = default_data_type;
+    csv_params.num_type_inference_rows = num_type_inference_rows;
     csv_params.column_types = std::move(column_types);
     csv_params.column_types_by_index = std::move(column_types_by_index);
+    csv_params.narrowed_types = std::move(narrowed_types);
+    csv_params.dictionary_encoded_columns = std::move(dictionary_encoded_columns);
+    csv_params.dictionary_encoded_columns_by_index = std::move(dictionary_encoded_columns_by_index);
+    csv_params.hashed_columns = std::move(hashed_columns);
+    csv_params.hashed_columns_by_index = std::move(hashed_columns_by_index);
+    csv_params.num_hash_buckets = num_hash_buckets;
+    csv_params.hash_seed = hash_seed;
+    csv_params.stack_columns = stack_columns;
+    csv_params.stacked_feature_name = std::move(stacked_feature_name);
+    csv_params.lazy_decode = lazy_decode;
+    csv_params.arena_strings = arena_strings;
+    csv_params.schema_path = std::move(schema_path);
     csv_params.header_row_index = header_row_index;
     csv_params.has_single_header = has_single_header;
+    csv_params.map_columns_by_header = map_columns_by_header;
     csv_params.dedupe_column_names = dedupe_column_names;
     csv_params.delimiter = delimiter;
     csv_params.quote_char = quote_char;
@@ -202,26 +376,325 @@ Csv_params make_csv_reader_params(std::vector<std::string> column_names,
 Image_reader_params make_image_reader_params(Image_frame image_frame,
                                              std::optional<size_t> resize,
                                              std::vector<std::size_t> image_dimensions,
-                                             bool to_rgb)
+                                             bool to_rgb,
+                                             bool random_resized_crop,
+                                             std::array<float, 2> random_crop_scale,
+                                             std::array<float, 2> random_crop_ratio,
+                                             bool random_horizontal_flip,
+                                             std::vector<float> mean,
+                                             std::vector<float> stddev,
+                                             Image_layout image_layout,
+                                             Data_type data_type,
+                                             std::optional<std::uint_fast64_t> augmentation_seed,
+                                             bool variable_size,
+                                             std::size_t bucketing_window,
+                                             std::vector<float> aspect_ratio_boundaries,
+                                             std::optional<int> opencv_num_threads)
 {
     Image_reader_params img_params{};
     img_params.image_frame = image_frame;
     img_params.resize = resize;
     img_params.image_dimensions = std::move(image_dimensions);
     img_params.to_rgb = to_rgb;
+    img_params.random_resized_crop = random_resized_crop;
+    img_params.random_crop_scale = random_crop_scale;
+    img_params.random_crop_ratio = random_crop_ratio;
+    img_params.random_horizontal_flip = random_horizontal_flip;
+    img_params.mean = std::move(mean);
+    img_params.stddev = std::move(stddev);
+    img_params.image_layout = image_layout;
+    img_params.data_type = data_type;
+    img_params.augmentation_seed = augmentation_seed;
+    img_params.variable_size = variable_size;
+    img_params.bucketing_window = bucketing_window;
+    img_params.aspect_ratio_boundaries = std::move(aspect_ratio_boundaries);
+    img_params.opencv_num_threads = opencv_num_threads;
     return img_params;
 }
 
-Parser_options make_parser_options(std::unordered_set<std::string> nan_values, int base)
+Audio_reader_params make_audio_reader_params(std::size_t sample_rate,
+                                             std::size_t num_samples,
+                                             Audio_output output,
+                                             std::size_t fft_size,
+                                             std::size_t window_size,
+                                             std::size_t hop_size,
+                                             std::size_t num_mels,
+                                             float min_frequency,
+                                             std::optional<float> max_frequency,
+                                             float log_offset)
+{
+    Audio_reader_params audio_params{};
+    audio_params.sample_rate = sample_rate;
+    audio_params.num_samples = num_samples;
+    audio_params.output = output;
+    audio_params.fft_size = fft_size;
+    audio_params.window_size = window_size;
+    audio_params.hop_size = hop_size;
+    audio_params.num_mels = num_mels;
+    audio_params.min_frequency = min_frequency;
+    audio_params.max_frequency = max_frequency;
+    audio_params.log_offset = log_offset;
+    return audio_params;
+}
+
+Json_lines_params make_json_lines_params(std::vector<std::string> fields,
+                                         std::size_t num_type_inference_rows,
+                                         std::optional<Data_type> number_data_type,
+                                         std::unordered_map<std::string, Data_type> field_types,
+                                         std::unordered_map<std::string, std::size_t> array_lengths)
+{
+    Json_lines_params json_params{};
+    json_params.fields = std::move(fields);
+    json_params.num_type_inference_rows = num_type_inference_rows;
+    json_params.number_data_type = number_data_type;
+    json_params.field_types = std::move(field_types);
+    json_params.array_lengths = std::move(array_lengths);
+    return json_params;
+}
+
+Libsvm_params make_libsvm_params(std::size_t num_features,
+                                 std::size_t num_feature_inference_rows,
+                                 bool zero_based,
+                                 Data_type label_data_type,
+                                 Data_type data_type)
+{
+    Libsvm_params libsvm_params{};
+    libsvm_params.num_features = num_features;
+    libsvm_params.num_feature_inference_rows = num_feature_inference_rows;
+    libsvm_params.zero_based = zero_based;
+    libsvm_params.label_data_type = label_data_type;
+    libsvm_params.data_type = data_type;
+    return libsvm_params;
+}
+
+Tf_example_params
+make_tf_example_params(bool verify_checksums,
+                       std::unordered_set<std::string> use_features,
+                       std::unordered_map<std::string, std::size_t> sparse_features,
+                       std::unordered_map<std::string, Data_type> data_types)
+{
+    Tf_example_params tf_params{};
+    tf_params.verify_checksums = verify_checksums;
+    tf_params.use_features = std::move(use_features);
+    tf_params.sparse_features = std::move(sparse_features);
+    tf_params.data_types = std::move(data_types);
+    return tf_params;
+}
+
+Video_reader_params make_video_reader_params(std::size_t num_frames,
+                                             Frame_sampling frame_sampling,
+                                             std::size_t frame_stride,
+                                             std::optional<Image_reader_params> image_params)
+{
+    Video_reader_params video_params{};
+    video_params.num_frames = num_frames;
+    video_params.frame_sampling = frame_sampling;
+    video_params.frame_stride = frame_stride;
+    if (image_params) {
+        video_params.image_params = std::move(*image_params);
+    }
+    return video_params;
+}
+
+Parquet_row_group_filter make_parquet_row_group_filter(std::string column,
+                                                       std::optional<double> min_value,
+                                                       std::optional<double> max_value)
+{
+    Parquet_row_group_filter filter{};
+    filter.column = std::move(column);
+    filter.min_value = min_value;
+    filter.max_value = max_value;
+    return filter;
+}
+
+Parquet_reader_params
+make_parquet_reader_params(std::unordered_set<std::string> use_columns,
+                           std::vector<Parquet_row_group_filter> row_group_filters)
+{
+    Parquet_reader_params pq_params{};
+    pq_params.use_columns = std::move(use_columns);
+    pq_params.row_group_filters = std::move(row_group_filters);
+    return pq_params;
+}
+
+Avro_reader_params make_avro_reader_params(std::unordered_set<std::string> use_columns)
+{
+    Avro_reader_params avro_params{};
+    avro_params.use_columns = std::move(use_columns);
+    return avro_params;
+}
+
+Orc_reader_params make_orc_reader_params(std::unordered_set<std::string> use_columns)
+{
+    Orc_reader_params orc_params{};
+    orc_params.use_columns = std::move(use_columns);
+    return orc_params;
+}
+
+Parser_options make_parser_options(std::unordered_set<std::string> nan_values,
+                                   int base,
+                                   std::string datetime_format)
 {
     Parser_options parser_options{};
 
     parser_options.nan_values = std::move(nan_values);
     parser_options.base = base;
+    parser_options.datetime_format = std::move(datetime_format);
 
     return parser_options;
 }
 
+Caching_params make_caching_params(std::string path,
+                                   std::string fingerprint,
+                                   std::size_t batch_size,
+                                   Last_example_handling last_example_handling,
+                                   bool shuffle_instances,
+                                   std::optional<std::size_t> shuffle_seed,
+                                   bool reshuffle_each_epoch)
+{
+    Caching_params params{};
+
+    params.path = std::move(path);
+    params.fingerprint = std::move(fingerprint);
+    params.batch_size = batch_size;
+    params.last_example_handling = last_example_handling;
+    params.shuffle_instances = shuffle_instances;
+    params.shuffle_seed = shuffle_seed;
+    params.reshuffle_each_epoch = reshuffle_each_epoch;
+
+    return params;
+}
+
+Intrusive_ptr<Caching_data_reader>
+make_caching_data_reader(Intrusive_ptr<Data_reader> inner, Caching_params params)
+{
+    return make_intrusive<Caching_data_reader>(std::move(inner), std::move(params));
+}
+
+Intrusive_ptr<Zip_reader> make_zip_reader(std::vector<Intrusive_ptr<Data_reader>> children)
+{
+    return make_intrusive<Zip_reader>(std::move(children));
+}
+
+Intrusive_ptr<Concat_reader> make_concat_reader(std::vector<Intrusive_ptr<Data_reader>> children)
+{
+    return make_intrusive<Concat_reader>(std::move(children));
+}
+
+Mixture_params make_mixture_params(std::vector<double> weights,
+                                   bool stop_on_first_exhausted,
+                                   std::optional<std::size_t> seed)
+{
+    Mixture_params params{};
+
+    params.weights = std::move(weights);
+    params.stop_on_first_exhausted = stop_on_first_exhausted;
+    params.seed = seed;
+
+    return params;
+}
+
+Intrusive_ptr<Mixture_reader>
+make_mixture_reader(std::vector<Intrusive_ptr<Data_reader>> children, Mixture_params params)
+{
+    return make_intrusive<Mixture_reader>(std::move(children), std::move(params));
+}
+
+Shared_memory_server_params make_shared_memory_server_params(
+    std::size_t num_clients,
+    std::size_t num_slots,
+    std::size_t slot_size,
+    Shared_memory_distribution distribution)
+{
+    Shared_memory_server_params params{};
+
+    params.num_clients = num_clients;
+    params.num_slots = num_slots;
+    params.slot_size = slot_size;
+    params.distribution = distribution;
+
+    return params;
+}
+
+std::unique_ptr<Shared_memory_reader_server>
+make_shared_memory_reader_server(Intrusive_ptr<Data_reader> reader,
+                                 std::string name,
+                                 Shared_memory_server_params params)
+{
+    return std::make_unique<Shared_memory_reader_server>(
+        std::move(reader), std::move(name), std::move(params));
+}
+
+Intrusive_ptr<Shared_memory_reader>
+make_shared_memory_reader(std::string name, std::size_t client_index)
+{
+    return make_intrusive<Shared_memory_reader>(std::move(name), client_index);
+}
+
+struct Data_service_worker_deleter {
+    void operator()(Data_service_worker *worker) const
+    {
+        // The sessions of the worker might be waiting for the GIL to call
+        // the Python factory.
+        py::gil_scoped_release rel_gil;
+
+        delete worker;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+};
+
+using Data_service_worker_ptr = std::unique_ptr<Data_service_worker, Data_service_worker_deleter>;
+
+Data_service_worker_ptr
+make_data_service_worker(Data_reader_factory factory, std::string host, std::uint16_t port)
+{
+    Data_service_worker_params params{};
+
+    params.host = std::move(host);
+    params.port = port;
+
+    return Data_service_worker_ptr{new Data_service_worker(std::move(factory), std::move(params))};
+}
+
+Data_reader_state make_data_reader_state(std::size_t epoch,
+                                          std::size_t num_examples_read,
+                                          std::size_t num_instances_read,
+                                          std::vector<std::size_t> position)
+{
+    Data_reader_state state{};
+
+    state.epoch = epoch;
+    state.num_examples_read = num_examples_read;
+    state.num_instances_read = num_instances_read;
+    state.position = std::move(position);
+
+    return state;
+}
+
+Data_service_params make_data_service_params(std::vector<std::string> workers,
+                                              std::size_t num_splits,
+                                              std::size_t shard_index,
+                                              std::size_t num_shards)
+{
+    Data_service_params params{};
+
+    params.workers = std::move(workers);
+    params.num_splits = num_splits;
+    params.shard_index = shard_index;
+    params.num_shards = num_shards;
+
+    return params;
+}
+
+Intrusive_ptr<Data_service_reader> make_data_service_reader(Data_service_params params)
+{
+    return make_intrusive<Data_service_reader>(std::move(params));
+}
+
+Intrusive_ptr<Columnar_reader> make_columnar_reader(Data_reader_params params)
+{
+    return make_intrusive<Columnar_reader>(std::move(params));
+}
+
 Intrusive_ptr<Csv_reader>
 make_csv_reader(Data_reader_params params, std::optional<Csv_params> csv_params)
 {
@@ -238,14 +711,117 @@ make_image_reader(Data_reader_params params, Image_reader_params img_params)
     return make_intrusive<Image_reader>(std::move(params), std::move(img_params));
 }
 
-Intrusive_ptr<Recordio_protobuf_reader> make_recordio_protobuf_reader(Data_reader_params params)
+Intrusive_ptr<Video_reader>
+make_video_reader(Data_reader_params params, Video_reader_params video_params)
+{
+    return make_intrusive<Video_reader>(std::move(params), std::move(video_params));
+}
+
+Intrusive_ptr<Audio_reader>
+make_audio_reader(Data_reader_params params, Audio_reader_params audio_params)
+{
+    return make_intrusive<Audio_reader>(std::move(params), std::move(audio_params));
+}
+
+Intrusive_ptr<Json_lines_reader>
+make_json_lines_reader(Data_reader_params params, std::optional<Json_lines_params> json_params)
+{
+    if (json_params) {
+        return make_intrusive<Json_lines_reader>(std::move(params), std::move(*json_params));
+    }
+
+    return make_intrusive<Json_lines_reader>(std::move(params));
+}
+
+Intrusive_ptr<Libsvm_reader>
+make_libsvm_reader(Data_reader_params params, std::optional<Libsvm_params> libsvm_params)
+{
+    if (libsvm_params) {
+        return make_intrusive<Libsvm_reader>(std::move(params), std::move(*libsvm_params));
+    }
+
+    return make_intrusive<Libsvm_reader>(std::move(params));
+}
+
+Intrusive_ptr<Tf_example_reader>
+make_tf_example_reader(Data_reader_params params, std::optional<Tf_example_params> tf_params)
+{
+    if (tf_params) {
+        return make_intrusive<Tf_example_reader>(std::move(params), std::move(*tf_params));
+    }
+
+    return make_intrusive<Tf_example_reader>(std::move(params));
+}
+
+Intrusive_ptr<Parquet_reader>
+make_parquet_reader(Data_reader_params params, Parquet_reader_params pq_params)
+{
+    return make_intrusive<Parquet_reader>(std::move(params), std::move(pq_params));
+}
+
+Intrusive_ptr<Avro_reader>
+make_avro_reader(Data_reader_params params, Avro_reader_params avro_params)
 {
-    return make_intrusive<Recordio_protobuf_reader>(std::move(params));
+    return make_intrusive<Avro_reader>(std::move(params), std::move(avro_params));
 }
 
-Intrusive_ptr<Text_line_reader> make_text_line_reader(Data_reader_params params)
+Intrusive_ptr<Orc_reader> make_orc_reader(Data_reader_params params, Orc_reader_params orc_params)
 {
-    return make_intrusive<Text_line_reader>(std::move(params));
+    return make_intrusive<Orc_reader>(std::move(params), std::move(orc_params));
+}
+
+Intrusive_ptr<Recordio_protobuf_reader>
+make_recordio_protobuf_reader(Data_reader_params params,
+                              Data_type float32_data_type,
+                              std::unordered_map<std::string, Data_type> data_types,
+                              std::unordered_map<std::string, std::size_t> hash_dimensions)
+{
+    Recordio_protobuf_params rp_params{};
+    rp_params.float32_data_type = float32_data_type;
+    rp_params.data_types = std::move(data_types);
+    rp_params.hash_dimensions = std::move(hash_dimensions);
+
+    return make_intrusive<Recordio_protobuf_reader>(std::move(params), std::move(rp_params));
+}
+
+Wordpiece_params make_wordpiece_params(std::string vocab_path,
+                                       bool lowercase,
+                                       std::string unknown_token,
+                                       std::string begin_token,
+                                       std::string end_token,
+                                       std::string padding_token,
+                                       std::size_t max_sequence_length,
+                                       std::size_t max_chars_per_word,
+                                       bool pack_sequences)
+{
+    Wordpiece_params params{};
+    params.vocab_path = std::move(vocab_path);
+    params.lowercase = lowercase;
+    params.unknown_token = std::move(unknown_token);
+    params.begin_token = std::move(begin_token);
+    params.end_token = std::move(end_token);
+    params.padding_token = std::move(padding_token);
+    params.max_sequence_length = max_sequence_length;
+    params.max_chars_per_word = max_chars_per_word;
+    params.pack_sequences = pack_sequences;
+
+    return params;
+}
+
+Intrusive_ptr<Text_line_reader>
+make_text_line_reader(Data_reader_params params,
+                      bool validate_utf8,
+                      bool pack_lines,
+                      bool arena_strings,
+                      std::optional<Wordpiece_params> wordpiece)
+{
+    Text_line_params text_params{};
+    text_params.validate_utf8 = validate_utf8;
+    text_params.pack_lines = pack_lines;
+    text_params.arena_strings = arena_strings;
+    text_params.wordpiece = std::move(wordpiece);
+
+    return make_intrusive<Text_line_reader>(std::move(params), text_params);
 }
 
 }  // namespace
@@ -273,6 +849,68 @@ void register_data_readers(py::module &m)
                "Pad the feature tensors with zero so that the size of the batch "
                "dimension equals the requested batch size and warn.");
 
+    py::enum_<Example_queue_handling>(
+        m,
+        "ExampleQueueHandling",
+        "Specifies how prefetched ``Example`` instances should be handed over "
+        "from the background thread to the reader.")
+        .value("LOCKED", Example_queue_handling::locked, "Use a pair of queues guarded by a mutex.")
+        .value("LOCK_FREE",
+               Example_queue_handling::lock_free,
+               "Use a bounded lock-free ring buffer. Reduces the handoff "
+               "latency for small batches at the cost of some extra CPU time.");
+
+    py::enum_<Decode_scheduling>(
+        m,
+        "DecodeScheduling",
+        "Specifies how the decoding of a batch should be scheduled on the "
+        "thread pool.")
+        .value("PER_BATCH",
+               Decode_scheduling::per_batch,
+               "Decode each batch in a single task. Only batches that are large "
+               "enough to amortize the threading overhead get split further.")
+        .value("ROW_RANGE",
+               Decode_scheduling::row_range,
+               "Split each batch into row-range tasks that idle worker threads "
+               "can steal.");
+
+    py::enum_<Sparse_tensor_format>(
+        m, "SparseTensorFormat", "Specifies the format of the tensors that hold sparse features.")
+        .value("COO", Sparse_tensor_format::coo, "Output a ``CooTensor``.")
+        .value("CSR",
+               Sparse_tensor_format::csr,
+               "Output a ``CsrTensor``. Features that have more than one "
+               "dimension besides the batch dimension are still output as a "
+               "``CooTensor``.");
+
+    py::enum_<Interleave_ordering>(
+        m,
+        "InterleaveOrdering",
+        "Specifies the order in which data instances read concurrently from "
+        "multiple data stores should be interleaved.")
+        .value("ROUND_ROBIN",
+               Interleave_ordering::round_robin,
+               "Cycle through the data stores in a fixed order.")
+        .value("FIRST_AVAILABLE",
+               Interleave_ordering::first_available,
+               "Take the next instance from the first data store in the cycle "
+               "that has one available.");
+
+    py::enum_<Sharding_strategy>(
+        m, "ShardingStrategy", "Specifies how the dataset should be split into shards.")
+        .value("INSTANCE",
+               Sharding_strategy::instance,
+               "Assign every num_shards'th data instance to the shard.")
+        .value("BYTE_RANGE",
+               Sharding_strategy::byte_range,
+               "Split each data store into byte ranges and read only the records "
+               "that start in the range of the shard. Data stores that cannot be "
+               "split are assigned to the shards as a whole.")
+        .value("DATA_STORE",
+               Sharding_strategy::data_store,
+               "Assign whole data stores to the shards, balanced by their size "
+               "hints.");
+
     py::enum_<Bad_example_handling>(
         m,
         "BadExampleHandling",
@@ -302,7 +940,134 @@ void register_data_readers(py::module &m)
 
     py::enum_<Image_frame>(m, "ImageFrame", "Specifies the Image_frame parameter value")
         .value("NONE", Image_frame::none, "none.")
-        .value("RECORDIO", Image_frame::recordio, "For recordio files.");
+        .value("RECORDIO", Image_frame::recordio, "For recordio files.")
+        .value("TAR", Image_frame::tar, "For tar archives such as WebDataset shards.");
+
+    py::enum_<Image_layout>(
+        m, "ImageLayout", "Specifies the memory layout of the images in the output tensor.")
+        .value("NHWC", Image_layout::nhwc, "(batch, height, width, channels)")
+        .value("NCHW", Image_layout::nchw, "(batch, channels, height, width)");
+
+    py::enum_<Audio_output>(
+        m, "AudioOutput", "Specifies what the ``AudioReader`` outputs for a clip.")
+        .value("WAVEFORM", Audio_output::waveform, "The resampled waveform.")
+        .value("LOG_MEL_SPECTROGRAM",
+               Audio_output::log_mel_spectrogram,
+               "The log-mel spectrogram of the resampled waveform.");
+
+    py::enum_<Frame_sampling>(
+        m, "FrameSampling", "Specifies how the frames of a video clip are sampled.")
+        .value("UNIFORM",
+               Frame_sampling::uniform,
+               "Sample frames spread evenly across the whole clip.")
+        .value("RANDOM",
+               Frame_sampling::random,
+               "Sample consecutive frames, ``frame_stride`` frames apart, starting at a random "
+               "position in the clip.");
+
+    py::enum_<Filter_op>(m, "FilterOp", "Specifies the comparison of a ``RowFilter``.")
+        .value("EQUAL", Filter_op::equal, "value == constant")
+        .value("NOT_EQUAL", Filter_op::not_equal, "value != constant")
+        .value("LESS", Filter_op::less, "value < constant")
+        .value("LESS_EQUAL", Filter_op::less_equal, "value <= constant")
+        .value("GREATER", Filter_op::greater, "value > constant")
+        .value("GREATER_EQUAL", Filter_op::greater_equal, "value >= constant");
+
+    py::class_<Row_filter>(
+        m,
+        "RowFilter",
+        "Represents a comparison of the value of a named column with a constant.")
+        .def(py::init(&make_row_filter),
+             "column"_a,
+             "op"_a,
+             "value"_a,
+             R"(
+            Parameters
+            ----------
+            column : str
+                The name of the column.
+            op : FilterOp
+                The comparison of the value of the column with `value`.
+            value : str
+                The constant to compare with. If it is a number, the values
+                are compared numerically and a value that is not a number
+                only satisfies ``FilterOp.NOT_EQUAL``; otherwise the two are
+                compared as strings.
+            )")
+        .def_readwrite("column", &Row_filter::column)
+        .def_readwrite("op", &Row_filter::op)
+        .def_readwrite("value", &Row_filter::value);
+
+    py::class_<Example_transform, Intrusive_ptr<Example_transform>>(
+        m,
+        "ExampleTransform",
+        "Represents a per-example transform implemented in C++ that a "
+        "``ParallelDataReader`` runs on its thread pool right after decoding.")
+        .def("transform",
+             &Example_transform::transform,
+             py::call_guard<py::gil_scoped_release>(),
+             "example"_a,
+             "Returns the transformed ``Example``, or None to drop it.")
+        .def("transform_schema",
+             &Example_transform::transform_schema,
+             "schema"_a,
+             "Returns the ``Schema`` of the transformed examples given the "
+             "schema of the examples passed to ``transform()``.")
+        .def_property_readonly("max_concurrency",
+                               &Example_transform::max_concurrency,
+                               "The maximum number of concurrent calls to ``transform()``, "
+                               "or zero if it is unlimited.");
+
+    py::class_<Thread_pool, Intrusive_ptr<Thread_pool>>(
+        m,
+        "ThreadPool",
+        "Represents a pool of worker threads that data readers run their "
+        "tasks on. Readers given the same pool, for instance a training and "
+        "a validation reader, share its threads so that together they occupy "
+        "a fixed number of cores next to the thread pools of a deep learning "
+        "framework.")
+        .def(py::init<std::size_t, std::vector<std::size_t>, std::optional<std::size_t>>(),
+             "num_threads"_a = 0,
+             "cpu_affinity"_a = std::vector<std::size_t>{},
+             "numa_node"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            num_threads : int, optional
+                The number of threads that can run tasks concurrently. If
+                zero, defaults to the size of `cpu_affinity`, or to the
+                number of processor cores available to the process.
+            cpu_affinity : list of ints, optional
+                The ids of the processor cores to pin the threads to. Only
+                supported on Linux.
+            numa_node : int, optional
+                The NUMA node whose processor cores the threads should be
+                pinned to. Only supported on Linux.
+            )")
+        .def("execute",
+             &Thread_pool::execute,
+             py::call_guard<py::gil_scoped_release>(),
+             "func"_a,
+             "Runs the specified function as part of the pool so that the "
+             "parallel work that it starts in native code uses the threads of "
+             "the pool.")
+        .def_property_readonly("num_threads",
+                               &Thread_pool::num_threads,
+                               "The number of threads that can run tasks concurrently.");
+
+    m.def("set_max_num_threads",
+          &set_max_num_threads,
+          "value"_a,
+          R"(
+        Limit the number of threads that run the tasks of the data readers
+        across the whole process, for instance to the cores left over by
+        the intra-op and inter-op pools of a deep learning framework.
+
+        Parameters
+        ----------
+        value : int
+            The maximum number of threads. If zero, the limit is lifted.
+        )");
 
     py::class_<Py_data_iterator>(m, "DataIterator")
         .def("__iter__",
@@ -330,6 +1095,57 @@ void register_data_readers(py::module &m)
              "shuffle_window"_a = 0,
              "shuffle_seed"_a = std::nullopt,
              "reshuffle_each_epoch"_a = true,
+             "max_batch_latency_ms"_a = 0,
+             "autotune"_a = false,
+             "autotune_memory_budget"_a = 0,
+             "memory_budget"_a = 0,
+             "num_threads"_a = 0,
+             "dedicated_io_thread"_a = false,
+             "cpu_affinity"_a = std::vector<std::size_t>{},
+             "numa_node"_a = std::nullopt,
+             "auto_numa_node"_a = false,
+             "thread_pool"_a = nullptr,
+             "pipeline_epochs"_a = false,
+             "deterministic"_a = true,
+             "start_on_schema"_a = false,
+             "example_queue_handling"_a = Example_queue_handling::locked,
+             "decode_scheduling"_a = Decode_scheduling::per_batch,
+             "tensor_pool_size"_a = 0,
+             "tensor_pool_huge_pages"_a = false,
+             "file_backed_output_directory"_a = std::nullopt,
+             "file_backed_output_threshold"_a = 0x4000000,
+             "deferred_reclamation"_a = false,
+             "output_device"_a = std::nullopt,
+             "output_devices"_a = std::vector<Device>{},
+             "sparse_tensor_format"_a = Sparse_tensor_format::coo,
+             "interleave_cycle_length"_a = 0,
+             "interleave_block_length"_a = 1,
+             "interleave_ordering"_a = Interleave_ordering::round_robin,
+             "num_prefetched_data_stores"_a = 0,
+             "sharding_strategy"_a = Sharding_strategy::instance,
+             "shard_seed"_a = std::nullopt,
+             "sample_seed"_a = std::nullopt,
+             "deduplicate_instances"_a = false,
+             "dedup_memory_budget"_a = 0,
+             "dedup_false_positive_rate"_a = 0.001F,
+             "shuffle_window_bytes"_a = 0,
+             "shuffle_spill_directory"_a = "",
+             "num_shuffle_spill_buckets"_a = 0,
+             "materialize_memory_budget"_a = 0,
+             "max_batch_bytes"_a = 0,
+             "size_bucketing_lookahead"_a = 0,
+             "shuffle_data_stores"_a = false,
+             "shuffle_block_size"_a = 0,
+             "recordio_indexes"_a = std::vector<Intrusive_ptr<Data_store>>{},
+             "indexed_read_ahead"_a = 0,
+             "column_statistics"_a = nullptr,
+             "min_store_throughput"_a = 0,
+             "slow_store_handler"_a = nullptr,
+             "row_filters"_a = std::vector<Row_filter>{},
+             "class_column"_a = "",
+             "class_sample_ratios"_a = std::map<std::string, float, std::less<>>{},
+             "default_class_sample_ratio"_a = 1.0F,
+             "example_transforms"_a = std::vector<Intrusive_ptr<Example_transform>>{},
              R"(
             Parameters
             ----------
@@ -367,8 +1183,10 @@ void register_data_readers(py::module &m)
                 reader will only read 1/num_shards of the dataset.
             sample_ratio : float, optional
                 A ratio between zero and one indicating how much of the dataset
-                should be read. The dataset will be sampled based on this
-                number.
+                should be read. Each data instance is selected independently
+                with this probability; the rejected ones are skipped without
+                being constructed, and if the dataset supports it (see
+                `recordio_indexes`), without being read at all.
             shuffle_instances : bool
                 A boolean value indicating whether to shuffle the data instances
                 while reading from the dataset.
@@ -386,22 +1204,337 @@ void register_data_readers(py::module &m)
             reshuffle_each_epoch : bool, optional
                 A boolean value indicating whether the dataset should be
                 reshuffled after every `Data_reader.reset()` call.
+            max_batch_latency_ms : int, optional
+                If greater than zero, the maximum time, in milliseconds, to
+                wait for an ``Example`` to fill up once its first instance
+                has been read. When it expires, the instances read so far are
+                returned as a smaller example, or as a padded one if
+                `last_example_handling` is ``PAD``.
+            autotune : bool, optional
+                A boolean value indicating whether to adjust the number of
+                parallel reads and prefetched examples at runtime. If set,
+                `num_prefetched_examples` and `num_parallel_reads` specify
+                the upper bounds.
+            autotune_memory_budget : int, optional
+                The maximum number of bytes that the prefetched and
+                in-flight examples should occupy if `autotune` is set. If
+                zero, the memory usage is not limited.
+            memory_budget : int, optional
+                The maximum number of bytes that the batches being read and
+                decoded, the examples not yet returned, and the shuffle
+                buffer should occupy. While over the budget, the reader
+                keeps a single batch in flight and stops filling the
+                example queue. If zero, the memory usage is not limited.
+            num_threads : int, optional
+                The number of threads that decode the examples. If greater
+                than zero, or if `cpu_affinity` or `numa_node` is specified,
+                the reader runs in a thread pool of its own instead of
+                sharing the global one with the rest of the process. If
+                zero, defaults to the length of `cpu_affinity`, or, if the
+                CPU quota of the container is smaller than the number of
+                processor cores, to the quota.
+            dedicated_io_thread : bool, optional
+                A boolean value indicating whether to read the instance
+                batches on a dedicated I/O thread so that reads blocking on
+                slow data stores do not hold the threads that decode.
+            cpu_affinity : list of ints, optional
+                The ids of the processor cores to pin the threads of the
+                reader to. Only supported on Linux.
+            numa_node : int, optional
+                The NUMA node whose processor cores the threads of the
+                reader should be pinned to. The memory allocated by the
+                threads is then also allocated on the node whenever
+                possible. Only supported on Linux.
+            auto_numa_node : bool, optional
+                A boolean value indicating whether to pin the threads of
+                the reader to the NUMA node that `output_device` is
+                attached to if neither `cpu_affinity` nor `numa_node` is
+                specified. If the node cannot be determined, the threads
+                are not pinned. Only supported on Linux.
+            thread_pool : ThreadPool, optional
+                The thread pool to run the tasks of the reader on. Readers
+                given the same pool share its threads. Cannot be specified
+                along with `num_threads`, `cpu_affinity`, `numa_node`, or
+                `auto_numa_node`.
+            pipeline_epochs : bool, optional
+                A boolean value indicating whether to start reading the next
+                epoch in background while the consumer finishes the current
+                one. If set, the background thread is kept across ``reset()``
+                calls.
+            deterministic : bool, optional
+                A boolean value indicating whether the examples should be
+                returned in the order their instances are read. If false,
+                the examples are returned as soon as they are decoded, so a
+                batch that is slow to read or decode does not hold back the
+                ones after it. The state of such a reader cannot be saved.
+            start_on_schema : bool, optional
+                A boolean value indicating whether to start reading and
+                decoding the first examples as soon as the schema is
+                inferred, e.g. by ``read_schema()``, instead of on the first
+                call to ``read_example()``.
+            example_queue_handling : ExampleQueueHandling
+                See ``ExampleQueueHandling``.
+            decode_scheduling : DecodeScheduling
+                See ``DecodeScheduling``.
+            tensor_pool_size : int, optional
+                The maximum number of bytes of tensor buffers to keep for
+                reuse. If greater than zero, the buffers of the dense tensors
+                of dropped examples are recycled for the next ones with the
+                same data type and size instead of being freed. The value and
+                index arrays of a sparse tensor share a single buffer that is
+                reused by the sparse tensors of similar sizes.
+            tensor_pool_huge_pages : bool, optional
+                A boolean value indicating whether the large buffers of the
+                tensor pool should be backed by transparent huge pages.
+            file_backed_output_directory : str, optional
+                The directory in which to create the files that back the
+                large dense tensors of the examples. If specified, the dense
+                tensors of an example whose buffers take at least
+                `file_backed_output_threshold` bytes are memory maps of a
+                file instead of heap buffers, so that a whole dataset read
+                as a single example can exceed the physical memory. An
+                empty string stands for /tmp.
+            file_backed_output_threshold : int, optional
+                The minimum number of bytes of the dense tensor buffers of
+                an example for them to be backed by a file.
+            deferred_reclamation : bool, optional
+                A boolean value indicating whether the tensors of dropped
+                examples should be freed on a background thread instead of
+                on the thread that drops the last reference to them.
+            output_device : Device, optional
+                The device to which the dense tensors of the examples are
+                copied before they are returned. If not specified, the
+                tensors are returned in host memory. A CUDA device requires
+                ``supports_cuda()``.
+            output_devices : list of Devices, optional
+                The devices to which the examples are copied in turns, each
+                with its own CUDA stream and staging buffers. The batch size
+                is the per-device batch size; see
+                ``ParallelDataReader.read_device_examples()``. Cannot be
+                combined with `output_device`.
+            sparse_tensor_format : SparseTensorFormat
+                See ``SparseTensorFormat``.
+            interleave_cycle_length : int, optional
+                The number of data stores to read concurrently. If greater
+                than one, the data instances of the data stores in the cycle
+                are interleaved as they are read.
+            interleave_block_length : int, optional
+                The number of consecutive data instances to read from a data
+                store before moving to the next one in the cycle.
+            interleave_ordering : InterleaveOrdering
+                See ``InterleaveOrdering``.
+            num_prefetched_data_stores : int, optional
+                The number of data stores to open ahead of the one being
+                read. Their headers and first records are read on
+                background threads so that moving to the next data store
+                does not stall the reader. Ignored if
+                `interleave_cycle_length` is greater than one.
+            sharding_strategy : ShardingStrategy
+                See ``ShardingStrategy``.
+            shard_seed : int, optional
+                The seed that will be used for planning the assignment of the
+                data stores to the shards if `sharding_strategy` is
+                ``ShardingStrategy.DATA_STORE``. If specified, the data stores
+                are reassigned after every `Data_reader.reset()` call based on
+                the seed and the epoch number; all shards must use the same
+                seed.
+            sample_seed : int, optional
+                The seed that will be used for sampling the dataset. If not
+                specified, a random seed will be generated internally. The same
+                sample is read in every epoch.
+            deduplicate_instances : bool, optional
+                A boolean value indicating whether to drop the data instances
+                whose raw bytes are identical to those of an instance read
+                earlier in the same epoch. The instances are compared by a
+                64-bit hash of their bytes.
+            dedup_memory_budget : int, optional
+                If greater than zero, the hashes of the data instances read
+                are kept in a Bloom filter of this many bytes instead of an
+                exact set whose size grows with the dataset.
+            dedup_false_positive_rate : float, optional
+                The target false positive rate of the Bloom filter; a false
+                positive drops a unique instance.
+            shuffle_window_bytes : int
+                If greater than zero, the raw data of the buffered data
+                instances is copied into a dedicated memory arena that holds at
+                most approximately this many bytes. This keeps the memory usage
+                of the shuffle buffer bounded regardless of the instance sizes;
+                if `shuffle_window` is also specified, the buffer is bounded by
+                both limits. Only applicable if `shuffle_instances` is true.
+            shuffle_spill_directory : str, optional
+                If not empty, and if `shuffle_window` is zero, the dataset is
+                shuffled through bucket files in the specified directory
+                instead of being loaded into memory. The first epoch spills
+                the data instances into randomly chosen buckets while
+                returning them shuffled within a small window; the later
+                epochs read the buckets in random order and shuffle each of
+                them in memory.
+            num_shuffle_spill_buckets : int, optional
+                The number of bucket files to spill the dataset into. A
+                bucket should fit into memory. If zero, defaults to 64.
+            materialize_memory_budget : int, optional
+                If greater than zero, the data instances of the first epoch
+                are copied into memory as long as they fit into this many
+                bytes. If the whole epoch fits, the subsequent epochs are
+                served from memory without reading the data stores again;
+                with `shuffle_instances` each of them is a perfect shuffle
+                of the first epoch. Otherwise the dataset is streamed as
+                usual.
+            max_batch_bytes : int, optional
+                The maximum total size, in bytes, of the records of the data
+                instances in an ``Example``. If greater than zero, an example
+                is closed once the next instance would exceed it, and
+                `batch_size` only bounds the number of instances.
+            size_bucketing_lookahead : int, optional
+                If greater than zero, data instances of similar record size
+                are grouped into the same ``Example``. At most this number of
+                instances are buffered while waiting for a group to fill up.
+            shuffle_data_stores : bool, optional
+                A boolean value indicating whether to read the data stores in
+                random order before shuffling their data instances within
+                `shuffle_window`.
+            shuffle_block_size : int, optional
+                If greater than zero, the data stores are split into blocks of
+                approximately this many bytes that are read in random order
+                before their data instances get shuffled within
+                `shuffle_window`. This way a much smaller window is enough to
+                shuffle datasets that are sorted.
+            recordio_indexes : list of DataStores, optional
+                A list of ``DataStore`` instances that contain the offset
+                indexes (see `build_recordio_index()`) of the RecordIO data
+                stores in `dataset`, in the same order. If specified, the
+                records are read by their offsets; this allows a perfect
+                shuffle regardless of `shuffle_window` with only the indexes
+                held in memory. If `shuffle_seed` is specified, the shards
+                read disjoint slices of a single permutation of the dataset,
+                so with `reshuffle_each_epoch` a shard reads a different part
+                of the dataset in every epoch; in that case all shards must
+                use the same seed and must be reset together.
+            indexed_read_ahead : int, optional
+                The number of records to fetch ahead of the reader if
+                `recordio_indexes` are specified. Since the order of an epoch
+                is planned up front from the indexes, the records are fetched
+                concurrently by `num_parallel_reads` threads and put back into
+                the planned order in a reorder buffer of this size; so the
+                order does not depend on the number of threads. If zero, the
+                records are fetched one by one.
+            column_statistics : ColumnStatisticsCollector, optional
+                If specified, each decoded example is added to the collector
+                in the decode stage of the pipeline; this way the statistics
+                of a dataset are computed in the same parallel pass that
+                reads it.
+            min_store_throughput : int
+                The minimum read throughput, in bytes per second, expected of
+                a data store. If greater than zero, a data store whose
+                throughput falls below it, once it has been read for at least
+                a second, is reported to `slow_store_handler`; at most once
+                per epoch.
+            slow_store_handler : callable, optional
+                The function to call with the ``StoreStats`` of a data store
+                that is read slower than `min_store_throughput`. If not
+                specified, a warning is logged instead. The function must not
+                call back into the reader.
+            row_filters : list of RowFilters, optional
+                The filters that a data instance must satisfy to be read.
+                Only the filtered columns are compared; the instances that
+                fail are dropped before they are batched, so their other
+                columns are never parsed and an ``Example`` still holds
+                `batch_size` instances. Only supported by ``CsvReader``.
+            class_column : str, optional
+                The name of the column that holds the class label of a data
+                instance; see `class_sample_ratios`.
+            class_sample_ratios : dict of str to float, optional
+                The probabilities with which the data instances of each
+                class are selected, keyed by the value of `class_column`;
+                e.g. inversely proportional to the class frequencies to
+                read class-balanced batches. Like `row_filters`, only the
+                class column is parsed and the rejected instances are
+                dropped before they are batched. The same sample, derived
+                from `sample_seed`, is read in every epoch. Only supported
+                by ``CsvReader``.
+            default_class_sample_ratio : float, optional
+                The probability with which the data instances whose class
+                is not in `class_sample_ratios` are selected.
+            example_transforms : list of ExampleTransforms, optional
+                The transforms to run, in order, on each decoded ``Example``
+                in the pipeline of a ``ParallelDataReader``. They run in
+                parallel on the thread pool of the reader unless limited by
+                their `max_concurrency`; the examples are still returned in
+                order.
             )")
         .def_readwrite("dataset", &Data_reader_params::dataset)
         .def_readwrite("batch_size", &Data_reader_params::batch_size)
+        .def_readwrite("max_batch_bytes", &Data_reader_params::max_batch_bytes)
+        .def_readwrite("max_batch_latency", &Data_reader_params::max_batch_latency)
+        .def_readwrite("size_bucketing_lookahead", &Data_reader_params::size_bucketing_lookahead)
         .def_readwrite("num_prefetched_examples", &Data_reader_params::num_prefetched_examples)
         .def_readwrite("num_parallel_reads", &Data_reader_params::num_parallel_reads)
+        .def_readwrite("example_queue_handling", &Data_reader_params::example_queue_handling)
+        .def_readwrite("autotune", &Data_reader_params::autotune)
+        .def_readwrite("autotune_memory_budget", &Data_reader_params::autotune_memory_budget)
+        .def_readwrite("memory_budget", &Data_reader_params::memory_budget)
+        .def_readwrite("num_threads", &Data_reader_params::num_threads)
+        .def_readwrite("dedicated_io_thread", &Data_reader_params::dedicated_io_thread)
+        .def_readwrite("cpu_affinity", &Data_reader_params::cpu_affinity)
+        .def_readwrite("numa_node", &Data_reader_params::numa_node)
+        .def_readwrite("auto_numa_node", &Data_reader_params::auto_numa_node)
+        .def_readwrite("thread_pool", &Data_reader_params::thread_pool)
+        .def_readwrite("pipeline_epochs", &Data_reader_params::pipeline_epochs)
+        .def_readwrite("deterministic", &Data_reader_params::deterministic)
+        .def_readwrite("start_on_schema", &Data_reader_params::start_on_schema)
+        .def_readwrite("decode_scheduling", &Data_reader_params::decode_scheduling)
+        .def_readwrite("tensor_pool_size", &Data_reader_params::tensor_pool_size)
+        .def_readwrite("tensor_pool_huge_pages", &Data_reader_params::tensor_pool_huge_pages)
+        .def_readwrite("file_backed_output_directory",
+                       &Data_reader_params::file_backed_output_directory)
+        .def_readwrite("file_backed_output_threshold",
+                       &Data_reader_params::file_backed_output_threshold)
+        .def_readwrite("deferred_reclamation", &Data_reader_params::deferred_reclamation)
+        .def_readwrite("output_device", &Data_reader_params::output_device)
+        .def_readwrite("output_devices", &Data_reader_params::output_devices)
+        .def_readwrite("sparse_tensor_format", &Data_reader_params::sparse_tensor_format)
+        .def_readwrite("interleave_cycle_length", &Data_reader_params::interleave_cycle_length)
+        .def_readwrite("interleave_block_length", &Data_reader_params::interleave_block_length)
+        .def_readwrite("num_prefetched_data_stores",
+                       &Data_reader_params::num_prefetched_data_stores)
+        .def_readwrite("interleave_ordering", &Data_reader_params::interleave_ordering)
         .def_readwrite("last_example_handling", &Data_reader_params::last_example_handling)
         .def_readwrite("bad_example_handling", &Data_reader_params::bad_example_handling)
         .def_readwrite("num_instances_to_skip", &Data_reader_params::num_instances_to_skip)
         .def_readwrite("num_instances_to_read", &Data_reader_params::num_instances_to_read)
         .def_readwrite("shard_index", &Data_reader_params::shard_index)
         .def_readwrite("num_shards", &Data_reader_params::num_shards)
+        .def_readwrite("sharding_strategy", &Data_reader_params::sharding_strategy)
+        .def_readwrite("shard_seed", &Data_reader_params::shard_seed)
         .def_readwrite("sample_ratio", &Data_reader_params::sample_ratio)
+        .def_readwrite("sample_seed", &Data_reader_params::sample_seed)
+        .def_readwrite("deduplicate_instances", &Data_reader_params::deduplicate_instances)
+        .def_readwrite("dedup_memory_budget", &Data_reader_params::dedup_memory_budget)
+        .def_readwrite("dedup_false_positive_rate",
+                       &Data_reader_params::dedup_false_positive_rate)
         .def_readwrite("shuffle_instances", &Data_reader_params::shuffle_instances)
         .def_readwrite("shuffle_window", &Data_reader_params::shuffle_window)
+        .def_readwrite("shuffle_window_bytes", &Data_reader_params::shuffle_window_bytes)
+        .def_readwrite("shuffle_spill_directory", &Data_reader_params::shuffle_spill_directory)
+        .def_readwrite("num_shuffle_spill_buckets",
+                       &Data_reader_params::num_shuffle_spill_buckets)
+        .def_readwrite("materialize_memory_budget",
+                       &Data_reader_params::materialize_memory_budget)
         .def_readwrite("shuffle_seed", &Data_reader_params::shuffle_seed)
-        .def_readwrite("reshuffle_each_epoch", &Data_reader_params::reshuffle_each_epoch);
+        .def_readwrite("reshuffle_each_epoch", &Data_reader_params::reshuffle_each_epoch)
+        .def_readwrite("shuffle_data_stores", &Data_reader_params::shuffle_data_stores)
+        .def_readwrite("shuffle_block_size", &Data_reader_params::shuffle_block_size)
+        .def_readwrite("recordio_indexes", &Data_reader_params::recordio_indexes)
+        .def_readwrite("indexed_read_ahead", &Data_reader_params::indexed_read_ahead)
+        .def_readwrite("column_statistics", &Data_reader_params::column_statistics)
+        .def_readwrite("min_store_throughput", &Data_reader_params::min_store_throughput)
+        .def_readwrite("slow_store_handler", &Data_reader_params::slow_store_handler)
+        .def_readwrite("row_filters", &Data_reader_params::row_filters)
+        .def_readwrite("class_column", &Data_reader_params::class_column)
+        .def_readwrite("class_sample_ratios", &Data_reader_params::class_sample_ratios)
+        .def_readwrite("default_class_sample_ratio",
+                       &Data_reader_params::default_class_sample_ratio)
+        .def_readwrite("example_transforms", &Data_reader_params::example_transforms);
 
     py::class_<Csv_params>(
         m, "CsvParams", "Represents the optional parameters of a ``CsvReader`` object.")
@@ -426,6 +1559,20 @@ void register_data_readers(py::module &m)
              "max_field_length_handling"_a = Max_field_length_handling::treat_as_bad,
              "max_line_length"_a = std::nullopt,
              "parser_options"_a = std::nullopt,
+             "num_type_inference_rows"_a = 1,
+             "narrowed_types"_a = std::unordered_map<Data_type, Data_type>{},
+             "dictionary_encoded_columns"_a = std::unordered_set<std::string>{},
+             "dictionary_encoded_columns_by_index"_a = std::unordered_set<std::size_t>{},
+             "hashed_columns"_a = std::unordered_set<std::string>{},
+             "hashed_columns_by_index"_a = std::unordered_set<std::size_t>{},
+             "num_hash_buckets"_a = 1 << 20,
+             "hash_seed"_a = 0,
+             "stack_columns"_a = false,
+             "stacked_feature_name"_a = "values",
+             "lazy_decode"_a = false,
+             "arena_strings"_a = false,
+             "schema_path"_a = "",
+             "map_columns_by_header"_a = false,
              R"(
             Parameters
             ----------
@@ -484,10 +1631,6 @@ void register_data_readers(py::module &m)
             has_single_header : bool, optional
                 A boolean value indicating whether the dataset has a header row
                 only in the first data store.
-            dedupe_column_names: bool, optional
-                A boolean value indicating whether duplicate columns should be
-                renamed. If true, duplicate columns 'X', ..., 'X' will be
-                renamed to 'X', 'X_1', X_2', ...
             delimiter : char
                 The delimiter character.
             quote_char : char
@@ -516,16 +1659,111 @@ void register_data_readers(py::module &m)
                 specified size, an error will be raised.
             parser_options : ParserParams, optional
                 See ``ParserParams``.
+            num_type_inference_rows : int, optional
+                The number of rows to sample for inferring the column data
+                types. Each column gets the narrowest data type that can
+                represent all of its sampled values.
+            narrowed_types : map of DataType/DataType
+                The rules to narrow the inferred data types of the columns
+                (e.g. INT64 to INT16, FLOAT64 to FLOAT32). Applied before
+                `column_types` and `column_types_by_index`. A value that
+                does not fit into the narrowed data type makes its row a
+                bad instance.
+            dictionary_encoded_columns : list of strs
+                The columns whose values should be dictionary-encoded. Each
+                distinct value of such a column is returned as an int32 code
+                that can be mapped back via ``CsvReader.dictionary()``.
+
+                Due to a shortcoming in pybind11, values cannot be added to
+                container types, and updates must instead be made via
+                assignment.
+            dictionary_encoded_columns_by_index : list of ints
+                The columns, specified by index, whose values should be
+                dictionary-encoded.
+
+                Due to a shortcoming in pybind11, values cannot be added to
+                container types, and updates must instead be made via
+                assignment.
+            hashed_columns : list of strs
+                The columns whose values should be hashed. Each value of such
+                a column is hashed with the 32-bit MurmurHash3 and returned as
+                its int64 bucket index in the range [0, `num_hash_buckets`).
+
+                Due to a shortcoming in pybind11, values cannot be added to
+                container types, and updates must instead be made via
+                assignment.
+            hashed_columns_by_index : list of ints
+                The columns, specified by index, whose values should be
+                hashed.
+
+                Due to a shortcoming in pybind11, values cannot be added to
+                container types, and updates must instead be made via
+                assignment.
+            num_hash_buckets : int, optional
+                The number of buckets of the hashed columns.
+            hash_seed : int, optional
+                The seed of the hash function of the hashed columns.
+            stack_columns : bool, optional
+                A boolean value indicating whether the columns should be read
+                into a single float32 tensor of shape [batch size, number of
+                columns] named `stacked_feature_name`. All columns that are
+                read must be numeric.
+            stacked_feature_name : str, optional
+                The name of the feature holding the stacked columns.
+            lazy_decode : bool, optional
+                A boolean value indicating whether the columns should be
+                parsed only when their features are first accessed. The
+                columns that are never accessed are never parsed. A value
+                that cannot be parsed raises an error on access regardless
+                of `bad_example_handling`.
+            arena_strings : bool, optional
+                A boolean value indicating whether the string columns should
+                be returned as ``StringTensor`` instances that hold the values
+                of a column in a single buffer instead of one Python-visible
+                string object per value. Has no effect if `lazy_decode` is
+                specified.
+            schema_path : str, optional
+                The path of a schema file written by ``CsvReader.save_schema()``.
+                If specified, the column names and data types are read from
+                the file instead of the dataset, and no data store is opened
+                until the first example is read. The data stores are assumed
+                to have the same columns.
+            map_columns_by_header : bool, optional
+                A boolean value indicating whether the columns of each data
+                store should be matched to the schema by the names in its
+                header row instead of by their positions. The columns can be
+                in a different order, the columns that are not in the schema
+                are skipped, and the columns that a data store lacks are read
+                as empty fields. Cannot be combined with `has_single_header`.
+            dedupe_column_names: bool, optional
+                A boolean value indicating whether duplicate columns should be
+                renamed. If true, duplicate columns 'X', ..., 'X' will be
+                renamed to 'X', 'X_1', X_2', ...
             )")
         .def_readwrite("column_names", &Csv_params::column_names)
         .def_readwrite("name_prefix", &Csv_params::name_prefix)
         .def_readwrite("use_columns", &Csv_params::use_columns)
         .def_readwrite("use_columns_by_index", &Csv_params::use_columns_by_index)
         .def_readwrite("default_data_type", &Csv_params::default_data_type)
+        .def_readwrite("num_type_inference_rows", &Csv_params::num_type_inference_rows)
         .def_readwrite("column_types", &Csv_params::column_types)
         .def_readwrite("column_types_by_index", &Csv_params::column_types_by_index)
+        .def_readwrite("narrowed_types", &Csv_params::narrowed_types)
+        .def_readwrite("dictionary_encoded_columns", &Csv_params::dictionary_encoded_columns)
+        .def_readwrite("dictionary_encoded_columns_by_index",
+                       &Csv_params::dictionary_encoded_columns_by_index)
+        .def_readwrite("hashed_columns", &Csv_params::hashed_columns)
+        .def_readwrite("hashed_columns_by_index", &Csv_params::hashed_columns_by_index)
+        .def_readwrite("num_hash_buckets", &Csv_params::num_hash_buckets)
+        .def_readwrite("hash_seed", &Csv_params::hash_seed)
+        .def_readwrite("stack_columns", &Csv_params::stack_columns)
+        .def_readwrite("lazy_decode", &Csv_params::lazy_decode)
+        .def_readwrite("arena_strings", &Csv_params::arena_strings)
+        .def_readwrite("stacked_feature_name", &Csv_params::stacked_feature_name)
+        .def_readwrite("schema_path", &Csv_params::schema_path)
         .def_readwrite("header_row_index", &Csv_params::header_row_index)
         .def_readwrite("has_single_header", &Csv_params::has_single_header)
+        .def_readwrite("map_columns_by_header", &Csv_params::map_columns_by_header)
         .def_readwrite("dedupe_column_names", &Csv_params::dedupe_column_names)
         .def_readwrite("delimiter", &Csv_params::delimiter)
         .def_readwrite("quote_char", &Csv_params::quote_char)
@@ -545,12 +1783,26 @@ void register_data_readers(py::module &m)
              "resize"_a = std::nullopt,
              "image_dimensions"_a = std::nullopt,
              "to_rgb"_a = false,
+             "random_resized_crop"_a = false,
+             "random_crop_scale"_a = std::array<float, 2>{0.08F, 1.0F},
+             "random_crop_ratio"_a = std::array<float, 2>{3.0F / 4.0F, 4.0F / 3.0F},
+             "random_horizontal_flip"_a = false,
+             "mean"_a = std::vector<float>{},
+             "stddev"_a = std::vector<float>{},
+             "image_layout"_a = Image_layout::nhwc,
+             "data_type"_a = Data_type::uint8,
+             "augmentation_seed"_a = std::nullopt,
+             "variable_size"_a = false,
+             "bucketing_window"_a = 0,
+             "aspect_ratio_boundaries"_a =
+                 std::vector<float>{0.5F, 0.75F, 1.0F, 4.0F / 3.0F, 2.0F},
+             "opencv_num_threads"_a = 1,
              R"(
             Parameters
             ----------
-            image_frame : enum {NONE, RECORDIO}
-                Selects the image frame to NONE(for raw image files) or
-                RECORDIO(for recordio files).
+            image_frame : enum {NONE, RECORDIO, TAR}
+                Selects the image frame to NONE(for raw image files),
+                RECORDIO(for recordio files), or TAR(for tar archives).
             resize : int, optional
                 Scales the shorter edge to a new size before applying other
                 augmentations.
@@ -559,16 +1811,242 @@ void register_data_readers(py::module &m)
                 format.
             to_rgb : boolean
                 Converts from BGR (OpenCV default) to RGB, if set to true.
+            random_resized_crop : boolean
+                Crops a random area of the image and scales it to the
+                output dimensions instead of cropping the center.
+            random_crop_scale : tuple of floats
+                The bounds of the area of the random crop as a fraction of
+                the image area.
+            random_crop_ratio : tuple of floats
+                The bounds of the aspect ratio (width / height) of the
+                random crop.
+            random_horizontal_flip : boolean
+                Flips the images horizontally with a probability of 0.5.
+            mean : list of floats
+                The per-channel mean, in pixel values, to subtract from
+                the images.
+            stddev : list of floats
+                The per-channel standard deviation, in pixel values, to
+                divide the images by.
+            image_layout : ImageLayout
+                See ``ImageLayout``.
+            data_type : DataType
+                The data type of the output tensor; UINT8, FLOAT16, or
+                FLOAT32.
+            augmentation_seed : int, optional
+                The seed for the random augmentations.
+            variable_size : boolean
+                Outputs the images in their decoded dimensions; packed
+                back-to-back in a "value" feature along with their
+                (height, width, channels) in a "shape" feature.
+            bucketing_window : int
+                If greater than zero, groups images with similar aspect
+                ratios into the same batch, looking ahead at most this
+                many images.
+            aspect_ratio_boundaries : list of floats
+                The boundaries of the aspect ratio buckets.
+            opencv_num_threads : int, optional
+                The process-wide number of threads OpenCV uses internally.
+                The images of a batch are already decoded in parallel; if
+                None, the OpenCV setting is left unchanged.
             )")
         .def_readwrite("image_frame", &Image_reader_params::image_frame)
         .def_readwrite("resize", &Image_reader_params::resize)
         .def_readwrite("image_dimensions", &Image_reader_params::image_dimensions)
-        .def_readwrite("to_rgb", &Image_reader_params::to_rgb);
+        .def_readwrite("to_rgb", &Image_reader_params::to_rgb)
+        .def_readwrite("random_resized_crop", &Image_reader_params::random_resized_crop)
+        .def_readwrite("random_crop_scale", &Image_reader_params::random_crop_scale)
+        .def_readwrite("random_crop_ratio", &Image_reader_params::random_crop_ratio)
+        .def_readwrite("random_horizontal_flip", &Image_reader_params::random_horizontal_flip)
+        .def_readwrite("mean", &Image_reader_params::mean)
+        .def_readwrite("stddev", &Image_reader_params::stddev)
+        .def_readwrite("image_layout", &Image_reader_params::image_layout)
+        .def_readwrite("data_type", &Image_reader_params::data_type)
+        .def_readwrite("augmentation_seed", &Image_reader_params::augmentation_seed)
+        .def_readwrite("variable_size", &Image_reader_params::variable_size)
+        .def_readwrite("bucketing_window", &Image_reader_params::bucketing_window)
+        .def_readwrite("aspect_ratio_boundaries", &Image_reader_params::aspect_ratio_boundaries)
+        .def_readwrite("opencv_num_threads", &Image_reader_params::opencv_num_threads);
+
+    py::class_<Audio_reader_params>(
+        m, "AudioReaderParams", "Represents the optional parameters of an ``AudioReader`` object.")
+        .def(py::init(&make_audio_reader_params),
+             "sample_rate"_a = 16000,
+             "num_samples"_a = 160000,
+             "output"_a = Audio_output::waveform,
+             "fft_size"_a = 512,
+             "window_size"_a = 400,
+             "hop_size"_a = 160,
+             "num_mels"_a = 80,
+             "min_frequency"_a = 0.0F,
+             "max_frequency"_a = std::nullopt,
+             "log_offset"_a = 1e-6F,
+             R"(
+            Parameters
+            ----------
+            sample_rate : int
+                The sample rate, in Hz, to which the clips are resampled.
+            num_samples : int
+                The number of samples, at the target sample rate, read from
+                the beginning of each clip. Shorter clips are padded with
+                zeros.
+            output : AudioOutput
+                See ``AudioOutput``.
+            fft_size : int
+                The size of the FFT; must be a power of two.
+            window_size : int
+                The size of the Hann window applied to each frame.
+            hop_size : int
+                The number of samples between two consecutive frames.
+            num_mels : int
+                The number of mel bands.
+            min_frequency : float
+                The lowest frequency, in Hz, of the mel filter bank.
+            max_frequency : float, optional
+                The highest frequency, in Hz, of the mel filter bank.
+                Defaults to the Nyquist frequency.
+            log_offset : float
+                The value added to the mel energies before taking their
+                natural logarithm.
+            )")
+        .def_readwrite("sample_rate", &Audio_reader_params::sample_rate)
+        .def_readwrite("num_samples", &Audio_reader_params::num_samples)
+        .def_readwrite("output", &Audio_reader_params::output)
+        .def_readwrite("fft_size", &Audio_reader_params::fft_size)
+        .def_readwrite("window_size", &Audio_reader_params::window_size)
+        .def_readwrite("hop_size", &Audio_reader_params::hop_size)
+        .def_readwrite("num_mels", &Audio_reader_params::num_mels)
+        .def_readwrite("min_frequency", &Audio_reader_params::min_frequency)
+        .def_readwrite("max_frequency", &Audio_reader_params::max_frequency)
+        .def_readwrite("log_offset", &Audio_reader_params::log_offset);
+
+    py::class_<Json_lines_params>(
+        m, "JsonLinesParams", "Represents the optional parameters of a ``JsonLinesReader`` object.")
+        .def(py::init(&make_json_lines_params),
+             "fields"_a = std::vector<std::string>{},
+             "num_type_inference_rows"_a = 100,
+             "number_data_type"_a = std::nullopt,
+             "field_types"_a = std::unordered_map<std::string, Data_type>{},
+             "array_lengths"_a = std::unordered_map<std::string, std::size_t>{},
+             R"(
+            Parameters
+            ----------
+            fields : list of strs
+                The top-level fields that should be read, in output order.
+                If empty, the fields found in the sampled rows are read in
+                the order of their first appearance; fields holding nested
+                objects are left out in such case.
+            num_type_inference_rows : int
+                The number of rows to sample for inferring the data types
+                of the fields and the lengths of the array fields.
+            number_data_type : DataType, optional
+                The data type of the numeric and boolean fields for which
+                no data type is specified in ``field_types``.
+            field_types : map of str and DataType
+                The mapping between fields and data types. For an array
+                field specifies the data type of its elements.
+            array_lengths : map of str and int
+                The mapping between array fields and their maximum
+                lengths.
+            )")
+        .def_readwrite("fields", &Json_lines_params::fields)
+        .def_readwrite("num_type_inference_rows", &Json_lines_params::num_type_inference_rows)
+        .def_readwrite("number_data_type", &Json_lines_params::number_data_type)
+        .def_readwrite("field_types", &Json_lines_params::field_types)
+        .def_readwrite("array_lengths", &Json_lines_params::array_lengths);
+
+    py::class_<Libsvm_params>(
+        m, "LibsvmParams", "Represents the optional parameters of a ``LibsvmReader`` object.")
+        .def(py::init(&make_libsvm_params),
+             "num_features"_a = 0,
+             "num_feature_inference_rows"_a = 1000,
+             "zero_based"_a = false,
+             "label_data_type"_a = Data_type::float32,
+             "data_type"_a = Data_type::float32,
+             R"(
+            Parameters
+            ----------
+            num_features : int
+                The number of features. If zero, it is inferred from the
+                largest feature index found in the sampled rows.
+            num_feature_inference_rows : int
+                The number of rows to sample for inferring the number of
+                features.
+            zero_based : bool
+                A boolean value indicating whether the feature indices
+                start from zero instead of one.
+            label_data_type : DataType
+                The data type of the labels; FLOAT32 or FLOAT64.
+            data_type : DataType
+                The data type of the values; FLOAT32 or FLOAT64.
+            )")
+        .def_readwrite("num_features", &Libsvm_params::num_features)
+        .def_readwrite("num_feature_inference_rows", &Libsvm_params::num_feature_inference_rows)
+        .def_readwrite("zero_based", &Libsvm_params::zero_based)
+        .def_readwrite("label_data_type", &Libsvm_params::label_data_type)
+        .def_readwrite("data_type", &Libsvm_params::data_type);
+
+    py::class_<Tf_example_params>(
+        m, "TfExampleParams", "Represents the optional parameters of a ``TfExampleReader`` object.")
+        .def(py::init(&make_tf_example_params),
+             "verify_checksums"_a = true,
+             "use_features"_a = std::unordered_set<std::string>{},
+             "sparse_features"_a = std::unordered_map<std::string, std::size_t>{},
+             "data_types"_a = std::unordered_map<std::string, Data_type>{},
+             R"(
+            Parameters
+            ----------
+            verify_checksums : bool
+                A boolean value indicating whether the masked CRC32C
+                checksums of the TFRecord framing should be verified.
+            use_features : list of strs
+                The features that should be read. If empty, the features
+                of the first record are read.
+            sparse_features : map of str and int
+                The mapping between variable-length features and their
+                maximum numbers of values. Such features are returned as
+                sparse tensors.
+            data_types : map of str and DataType
+                The mapping between features and data types. Must be
+                specified for the features that are missing in the first
+                record.
+            )")
+        .def_readwrite("verify_checksums", &Tf_example_params::verify_checksums)
+        .def_readwrite("use_features", &Tf_example_params::use_features)
+        .def_readwrite("sparse_features", &Tf_example_params::sparse_features)
+        .def_readwrite("data_types", &Tf_example_params::data_types);
+
+    py::class_<Video_reader_params>(
+        m, "VideoReaderParams", "Represents the optional parameters of a ``VideoReader`` object.")
+        .def(py::init(&make_video_reader_params),
+             "num_frames"_a = 8,
+             "frame_sampling"_a = Frame_sampling::uniform,
+             "frame_stride"_a = 1,
+             "image_params"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            num_frames : int
+                The number of frames to sample from each clip.
+            frame_sampling : FrameSampling
+                See ``FrameSampling``.
+            frame_stride : int
+                The distance, in frames, between two consecutive frames
+                sampled with ``FrameSampling.RANDOM``.
+            image_params : ImageReaderParams, optional
+                The resize, crop, and normalization pipeline applied to
+                each frame.
+            )")
+        .def_readwrite("num_frames", &Video_reader_params::num_frames)
+        .def_readwrite("frame_sampling", &Video_reader_params::frame_sampling)
+        .def_readwrite("frame_stride", &Video_reader_params::frame_stride)
+        .def_readwrite("image_params", &Video_reader_params::image_params);
 
     py::class_<Parser_options>(m, "ParserParams")
         .def(py::init(&make_parser_options),
              "nan_values"_a = std::unordered_set<std::string>{},
              "number_base"_a = 10,
+             "datetime_format"_a = "",
              R"(
             Parameters
             ----------
@@ -582,9 +2060,64 @@ void register_data_readers(py::module &m)
             number_base : int
                 For a number parse operation specifies the base of the number
                 in its string representation.
+            datetime_format : str
+                For a timestamp or date parse operation specifies a
+                strptime-like format, e.g. '%d/%m/%Y %H:%M', to use instead
+                of ISO-8601.
              )")
         .def_readwrite("nan_values", &Parser_options::nan_values)
-        .def_readwrite("number_base", &Parser_options::base);
+        .def_readwrite("number_base", &Parser_options::base)
+        .def_readwrite("datetime_format", &Parser_options::datetime_format);
+
+    py::class_<Data_reader_state>(
+        m,
+        "DataReaderState",
+        "Represents the position of a reader in a dataset as returned by "
+        "``DataReader.save_state()``.")
+        .def(py::init(&make_data_reader_state),
+             "epoch"_a = 0,
+             "num_examples_read"_a = 0,
+             "num_instances_read"_a = 0,
+             "position"_a = std::vector<std::size_t>{},
+             R"(
+            Parameters
+            ----------
+            epoch : int
+                The number of epochs that preceded the current one.
+            num_examples_read : int
+                The number of examples read in the current epoch.
+            num_instances_read : int
+                The number of instances read in the current epoch.
+            position : list of ints
+                The opaque position of the instance reader; if empty, the
+                instances are skipped on restore.
+            )")
+        .def_readwrite("epoch", &Data_reader_state::epoch)
+        .def_readwrite("num_examples_read", &Data_reader_state::num_examples_read)
+        .def_readwrite("num_instances_read", &Data_reader_state::num_instances_read)
+        .def_readwrite("position", &Data_reader_state::position)
+        .def(py::pickle(
+            [](const Data_reader_state &state) {
+                return py::make_tuple(
+                    state.epoch, state.num_examples_read, state.num_instances_read, state.position);
+            },
+            [](const py::tuple &t) {
+                return make_data_reader_state(t[0].cast<std::size_t>(),
+                                              t[1].cast<std::size_t>(),
+                                              t[2].cast<std::size_t>(),
+                                              t[3].cast<std::vector<std::size_t>>());
+            }));
+
+    py::class_<Instance_count>(
+        m,
+        "InstanceCount",
+        "Holds the number of instances in a dataset as returned by "
+        "``DataReader.estimate_num_instances()``.")
+        .def_readonly("num_instances", &Instance_count::num_instances, "The number of instances.")
+        .def_readonly("exact",
+                      &Instance_count::exact,
+                      "A boolean value indicating whether the instances have been "
+                      "counted exactly instead of being extrapolated from a sample.");
 
     py::class_<Data_reader, Py_data_reader, Intrusive_ptr<Data_reader>>(
         m,
@@ -610,6 +2143,31 @@ void register_data_readers(py::module &m)
              &Data_reader::reset,
              "Resets the state of the reader. Calling ``read_example()`` the "
              "next time will start reading from the beginning of the dataset.")
+        .def("save_state",
+             &Data_reader::save_state,
+             "Returns the position of the reader right after the last example "
+             "returned by ``read_example()``.")
+        .def("restore_state",
+             &Data_reader::restore_state,
+             "state"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             "Resets the reader to the position described by the specified "
+             "``DataReaderState``, seeking directly to it where possible.")
+        .def("estimate_num_instances",
+             &Data_reader::estimate_num_instances,
+             "exact"_a = false,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Returns the number of instances in the dataset without decoding
+            them.
+
+            Parameters
+            ----------
+            exact : bool
+                A boolean value indicating whether every record should be
+                counted. If false, the count of a large data store is
+                extrapolated from its size and from a few sampled chunks.
+            )")
         .def("__iter__",
              [](py::object &reader) {
                  return Py_data_iterator(reader.cast<Data_reader &>(), reader);
@@ -623,9 +2181,600 @@ void register_data_readers(py::module &m)
              parts of the dataset such as comment blocks.
 
              The returned number can be greater than expected as MLIO
-             reads ahead the dataset in background.)");
+             reads ahead the dataset in background.)")
+        .def_property_readonly("shuffle_buffer_size",
+                               &Data_reader::shuffle_buffer_size,
+                               R"(
+             Gets the number of bytes currently held by the shuffle
+             buffer.
+
+             Only tracked if ``shuffle_window_bytes`` is specified;
+             otherwise returns zero.)");
+
+    py::class_<Tensor_pool_stats>(
+        m, "TensorPoolStats", "Holds the usage statistics of the tensor pool of a reader.")
+        .def_readonly("num_hits",
+                      &Tensor_pool_stats::num_hits,
+                      "The number of arrays whose buffers were taken from the pool.")
+        .def_readonly("num_misses",
+                      &Tensor_pool_stats::num_misses,
+                      "The number of arrays for which a new buffer was allocated.")
+        .def_readonly("num_cached_bytes",
+                      &Tensor_pool_stats::num_cached_bytes,
+                      "The total size, in bytes, of the buffers held in the pool.");
+
+    py::class_<Stage_stats>(
+        m, "StageStats", "Holds the timings of a stage of the pipeline of a reader.")
+        .def_readonly(
+            "num_calls", &Stage_stats::num_calls, "The number of times the stage has run.")
+        .def_readonly("total_ns",
+                      &Stage_stats::total_ns,
+                      "The total time, in nanoseconds, spent in the stage.")
+        .def_readonly("window_num_calls",
+                      &Stage_stats::window_num_calls,
+                      "The number of times the stage has run within the window.")
+        .def_readonly("window_ns",
+                      &Stage_stats::window_ns,
+                      "The time, in nanoseconds, spent in the stage within the window.");
+
+    py::class_<Store_stats>(
+        m, "StoreStats", "Holds the progress and the throughput of a data store.")
+        .def_readonly("id", &Store_stats::id, "The id of the data store.")
+        .def_readonly("num_bytes_read",
+                      &Store_stats::num_bytes_read,
+                      "The number of bytes of the decoded instances.")
+        .def_readonly("num_records",
+                      &Store_stats::num_records,
+                      "The number of records framed from the data store.")
+        .def_readonly("num_record_bytes",
+                      &Store_stats::num_record_bytes,
+                      "The number of bytes of the payloads of the records.")
+        .def_readonly("read_ns",
+                      &Store_stats::read_ns,
+                      "The total time, in nanoseconds, spent reading the records.")
+        .def_readonly("num_opens",
+                      &Store_stats::num_opens,
+                      "The number of times the data store has been opened.")
+        .def_readonly("open_ns",
+                      &Store_stats::open_ns,
+                      "The total time, in nanoseconds, spent opening the data store.")
+        .def_readonly("bytes_per_second",
+                      &Store_stats::bytes_per_second,
+                      "The number of record bytes read per second of ``read_ns``.");
+
+    py::class_<Reader_stats>(m, "ReaderStats", "Holds the runtime statistics of a reader.")
+        .def_readonly("read",
+                      &Reader_stats::read,
+                      "Reading the data instances from the data stores and batching them.")
+        .def_readonly(
+            "decode", &Reader_stats::decode, "Decoding the instance batches into examples.")
+        .def_readonly("transform", &Reader_stats::transform, "Running the example transforms.")
+        .def_readonly("reorder",
+                      &Reader_stats::reorder,
+                      "Waiting for the preceding examples to be decoded and transformed.")
+        .def_readonly("enqueue",
+                      &Reader_stats::enqueue,
+                      "Waiting for room in the example queue; a high value means the "
+                      "consumer cannot keep up with the reader.")
+        .def_readonly("consume",
+                      &Reader_stats::consume,
+                      "Waiting in ``read_example()`` for an example; a high value means "
+                      "the reader cannot keep up with the consumer.")
+        .def_readonly("num_queued_examples",
+                      &Reader_stats::num_queued_examples,
+                      "The number of examples waiting to be handed over to the consumer.")
+        .def_readonly("queue_capacity",
+                      &Reader_stats::queue_capacity,
+                      "The maximum number of examples that can be queued.")
+        .def_readonly("num_parallel_reads",
+                      &Reader_stats::num_parallel_reads,
+                      "The current number of parallel reads.")
+        .def_readonly("num_prefetched_examples",
+                      &Reader_stats::num_prefetched_examples,
+                      "The current number of prefetched examples.")
+        .def_readonly("memory_usage",
+                      &Reader_stats::memory_usage,
+                      "The approximate number of bytes held by the pipeline.")
+        .def_readonly("peak_memory_usage",
+                      &Reader_stats::peak_memory_usage,
+                      "The highest memory usage since the reader was reset.")
+        .def_readonly(
+            "num_examples", &Reader_stats::num_examples, "The number of examples decoded.")
+        .def_readonly("num_instances",
+                      &Reader_stats::num_instances,
+                      "The number of data instances in the decoded examples.")
+        .def_readonly("num_bad_instances",
+                      &Reader_stats::num_bad_instances,
+                      "The number of bad data instances left out of padded examples.")
+        .def_readonly("num_skipped_examples",
+                      &Reader_stats::num_skipped_examples,
+                      "The number of examples skipped due to bad data instances.")
+        .def_readonly("num_filtered_instances",
+                      &Reader_stats::num_filtered_instances,
+                      "The number of data instances dropped by the row filters or by class "
+                      "sampling.")
+        .def_readonly("num_parse_errors",
+                      &Reader_stats::num_parse_errors,
+                      "The number of fields that cannot be parsed as the data type of their "
+                      "column.")
+        .def_readonly("num_field_count_errors",
+                      &Reader_stats::num_field_count_errors,
+                      "The number of instances that have fewer or more fields than expected.")
+        .def_readonly("num_long_fields",
+                      &Reader_stats::num_long_fields,
+                      "The number of fields that exceed the maximum field length.")
+        .def_readonly("num_corrupt_records",
+                      &Reader_stats::num_corrupt_records,
+                      "The number of instances that are not valid records.")
+        .def_readonly("num_schema_mismatches",
+                      &Reader_stats::num_schema_mismatches,
+                      "The number of features that do not match their attribute in the schema.")
+        .def_readonly("num_overflows",
+                      &Reader_stats::num_overflows,
+                      "The number of values that do not fit into the narrowed data type of "
+                      "their column or attribute.")
+        .def_readonly("num_suppressed_warnings",
+                      &Reader_stats::num_suppressed_warnings,
+                      "The number of warnings about data instances that have not been logged "
+                      "individually due to the rate limit.")
+        .def_readonly("schema_ns",
+                      &Reader_stats::schema_ns,
+                      "The time, in nanoseconds, spent inferring or restoring the schema.")
+        .def_readonly("first_example_ns",
+                      &Reader_stats::first_example_ns,
+                      "The time, in nanoseconds, from the construction of the reader until its "
+                      "first example was returned, or zero if none has been returned yet.")
+        .def_readonly("window_seconds",
+                      &Reader_stats::window_seconds,
+                      "The length, in seconds, of the window.")
+        .def_readonly("examples_per_second", &Reader_stats::examples_per_second)
+        .def_readonly("instances_per_second", &Reader_stats::instances_per_second)
+        .def_readonly("stores",
+                      &Reader_stats::stores,
+                      "The number of bytes of the decoded instances per data store.");
+
+    py::class_<Parallel_data_reader, Data_reader, Intrusive_ptr<Parallel_data_reader>>(
+        m,
+        "ParallelDataReader",
+        "Represents an abstract base class for data readers that support multi-threading.")
+        .def_property_readonly("tensor_pool_stats",
+                               &Parallel_data_reader::tensor_pool_stats,
+                               R"(
+             Gets the usage statistics of the tensor pool of the reader.
+             See the ``tensor_pool_size`` parameter of
+             ``DataReaderParams``.)")
+        .def("stats",
+             &Parallel_data_reader::stats,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+             Return the stage timings, queue occupancy, and throughput of
+             the reader as a ``ReaderStats``.
 
-    py::class_<Csv_reader, Data_reader, Intrusive_ptr<Csv_reader>>(
+             The window values and the throughput are measured since the
+             previous call to this function.)")
+        .def("read_device_examples",
+             &Parallel_data_reader::read_device_examples,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+             Read the next example of each device in the ``output_devices``
+             parameter of ``DataReaderParams``; the i-th example is on the
+             i-th device. Returns fewer examples at the end of the dataset.)")
+        .def("decode_buffer",
+             &decode_buffer,
+             "buf"_a,
+             R"(
+             Decode the records in the specified buffer into a single
+             ``Example`` on the calling thread without starting the
+             background pipeline.
+
+             All records in the buffer end up in the returned example; the
+             batch size, the shuffling, and the sharding parameters are
+             ignored. Returns None if the buffer contains no instance.)");
+
+    py::class_<Sync_decoder>(m,
+                             "SyncDecoder",
+                             "Decodes in-memory request payloads with the decoders of a "
+                             "``ParallelDataReader`` on the calling thread.")
+        .def(py::init<Intrusive_ptr<Parallel_data_reader>>(),
+             "reader"_a,
+             R"(
+            Parameters
+            ----------
+            reader : ParallelDataReader
+                The reader whose schema, parameters, and decoders are used.
+                Its batch size, shuffling, and sharding parameters are
+                ignored.
+            )")
+        .def("decode",
+             &sync_decode,
+             "buf"_a,
+             R"(
+             Decode the records in the specified buffer into a single
+             ``Example``, or return None if the buffer contains no
+             instance. Concurrent calls are serialized.)")
+        .def_property_readonly("schema",
+                               &Sync_decoder::schema,
+                               "Gets the schema of the decoded examples, or None if no instance "
+                               "has been decoded yet.");
+
+    py::class_<Caching_params>(
+        m, "CachingParams", "Represents the optional parameters of a ``CachingDataReader`` object.")
+        .def(py::init(&make_caching_params),
+             "path"_a = "",
+             "fingerprint"_a = "",
+             "batch_size"_a = 0,
+             "last_example_handling"_a = Last_example_handling::none,
+             "shuffle_instances"_a = false,
+             "shuffle_seed"_a = std::nullopt,
+             "reshuffle_each_epoch"_a = true,
+             R"(
+            Parameters
+            ----------
+            path : str, optional
+                The path of the cache file. If empty, the decoded examples
+                are cached in memory. The file should reside on local
+                storage; it is memory-mapped in the epochs that read from
+                the cache.
+            fingerprint : str, optional
+                A string identifying the contents of the dataset, such as
+                the ETags or the modification times of its files. An
+                existing cache file is only used if it was written for the
+                same schema, the same data stores, and the same
+                fingerprint.
+            batch_size : int, optional
+                The number of instances per example read from the cache.
+                If zero, the batch size of the inner reader is used.
+            last_example_handling : LastExampleHandling
+                See ``LastExampleHandling``. Applies to the epochs that
+                read from the cache.
+            shuffle_instances : bool, optional
+                A boolean value indicating whether to shuffle the
+                instances read from the cache.
+            shuffle_seed : int, optional
+                The seed that will be used for shuffling the instances.
+            reshuffle_each_epoch : bool, optional
+                A boolean value indicating whether the instances should be
+                reshuffled in every epoch.
+            )")
+        .def_readwrite("path", &Caching_params::path)
+        .def_readwrite("fingerprint", &Caching_params::fingerprint)
+        .def_readwrite("batch_size", &Caching_params::batch_size)
+        .def_readwrite("last_example_handling", &Caching_params::last_example_handling)
+        .def_readwrite("shuffle_instances", &Caching_params::shuffle_instances)
+        .def_readwrite("shuffle_seed", &Caching_params::shuffle_seed)
+        .def_readwrite("reshuffle_each_epoch", &Caching_params::reshuffle_each_epoch);
+
+    py::class_<Caching_data_reader, Data_reader, Intrusive_ptr<Caching_data_reader>>(
+        m,
+        "CachingDataReader",
+        R"(
+        Represents a ``DataReader`` that caches the examples decoded by
+        another reader. The first epoch returns the examples of the inner
+        reader and writes their instances to the cache; the following
+        epochs read the instances from the cache instead of decoding the
+        dataset again. Only dense features of numeric data types can be
+        cached.)")
+        .def(py::init<>(&make_caching_data_reader),
+             "inner"_a,
+             "caching_params"_a = Caching_params{},
+             R"(
+            Parameters
+            ----------
+            inner : DataReader
+                The reader whose examples should be cached.
+            caching_params : CachingParams, optional
+                See ``CachingParams``.
+            )")
+        .def_property_readonly("cached",
+                               &Caching_data_reader::cached,
+                               "Gets a boolean value indicating whether the examples are "
+                               "read from the cache.")
+        .def_property_readonly("num_cached_instances",
+                               &Caching_data_reader::num_cached_instances,
+                               "Gets the number of instances in the cache.");
+
+    py::class_<Composite_data_reader, Data_reader, Intrusive_ptr<Composite_data_reader>>(
+        m,
+        "CompositeDataReader",
+        "Represents an abstract base class for the readers that combine the "
+        "examples of other readers.")
+        .def_property_readonly(
+            "children", &Composite_data_reader::children, "Gets the child readers.");
+
+    py::class_<Zip_reader, Composite_data_reader, Intrusive_ptr<Zip_reader>>(
+        m,
+        "ZipReader",
+        R"(
+        Represents a ``DataReader`` that reads an example from each child
+        reader and merges their features into a single ``Example``. The
+        attribute names must be unique across the child readers, and the
+        child readers must return the same number of instances per
+        example. An epoch ends with the shortest child reader.)")
+        .def(py::init<>(&make_zip_reader),
+             "children"_a,
+             R"(
+            Parameters
+            ----------
+            children : list of DataReaders
+                The readers whose examples should be zipped.
+            )");
+
+    py::class_<Concat_reader, Composite_data_reader, Intrusive_ptr<Concat_reader>>(
+        m,
+        "ConcatReader",
+        "Represents a ``DataReader`` that reads the examples of its child "
+        "readers one after another. The child readers must have the same "
+        "schema.")
+        .def(py::init<>(&make_concat_reader),
+             "children"_a,
+             R"(
+            Parameters
+            ----------
+            children : list of DataReaders
+                The readers whose examples should be concatenated.
+            )");
+
+    py::class_<Mixture_params>(
+        m, "MixtureParams", "Represents the optional parameters of a ``MixtureReader`` object.")
+        .def(py::init(&make_mixture_params),
+             "weights"_a = std::vector<double>{},
+             "stop_on_first_exhausted"_a = false,
+             "seed"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            weights : list of floats, optional
+                The relative frequencies at which the examples of the
+                child readers are returned. If empty, the child readers
+                are sampled uniformly.
+            stop_on_first_exhausted : bool, optional
+                A boolean value indicating whether an epoch ends as soon as
+                one of the child readers reaches the end of its dataset.
+            seed : int, optional
+                The seed that will be used for sampling the child readers.
+            )")
+        .def_readwrite("weights", &Mixture_params::weights)
+        .def_readwrite("stop_on_first_exhausted", &Mixture_params::stop_on_first_exhausted)
+        .def_readwrite("seed", &Mixture_params::seed);
+
+    py::class_<Mixture_reader, Composite_data_reader, Intrusive_ptr<Mixture_reader>>(
+        m,
+        "MixtureReader",
+        "Represents a ``DataReader`` that returns the examples of randomly "
+        "chosen child readers in the proportions of their weights. The child "
+        "readers must have the same schema.")
+        .def(py::init<>(&make_mixture_reader),
+             "children"_a,
+             "mixture_params"_a = Mixture_params{},
+             R"(
+            Parameters
+            ----------
+            children : list of DataReaders
+                The readers whose examples should be mixed.
+            mixture_params : MixtureParams, optional
+                See ``MixtureParams``.
+            )");
+
+    py::enum_<Shared_memory_distribution>(
+        m,
+        "SharedMemoryDistribution",
+        "Specifies how a ``SharedMemoryReaderServer`` should distribute the "
+        "examples among its clients.")
+        .value("SHARD",
+               Shared_memory_distribution::shard,
+               "Assign every num_clients'th example to the client.")
+        .value("FIRST_AVAILABLE",
+               Shared_memory_distribution::first_available,
+               "Hand out each example to the first client that asks for one.");
+
+    py::class_<Shared_memory_server_params>(
+        m,
+        "SharedMemoryServerParams",
+        "Represents the optional parameters of a ``SharedMemoryReaderServer`` object.")
+        .def(py::init(&make_shared_memory_server_params),
+             "num_clients"_a = 1,
+             "num_slots"_a = 0,
+             "slot_size"_a = 0,
+             "distribution"_a = Shared_memory_distribution::shard,
+             R"(
+            Parameters
+            ----------
+            num_clients : int, optional
+                The number of client processes that will attach to the
+                server.
+            num_slots : int, optional
+                The number of examples that can be published at the same
+                time; this includes the ones held by the clients. If zero,
+                defaults to four times `num_clients`.
+            slot_size : int, optional
+                The maximum size, in bytes, of a published example. If
+                zero, defaults to twice the size of the first example.
+            distribution : SharedMemoryDistribution, optional
+                See ``SharedMemoryDistribution``.
+            )")
+        .def_readwrite("num_clients", &Shared_memory_server_params::num_clients)
+        .def_readwrite("num_slots", &Shared_memory_server_params::num_slots)
+        .def_readwrite("slot_size", &Shared_memory_server_params::slot_size)
+        .def_readwrite("distribution", &Shared_memory_server_params::distribution);
+
+    py::class_<Shared_memory_reader_server>(
+        m,
+        "SharedMemoryReaderServer",
+        R"(
+        Represents a server that reads the examples of a ``DataReader`` in
+        background and publishes them into a named shared memory segment,
+        so that several processes on the same host can consume a dataset
+        that is fetched and decoded only once. The clients attach via
+        ``SharedMemoryReader``. The server starts the next epoch once every
+        attached client has been reset. Only dense features of numeric
+        data types can be published.)")
+        .def(py::init<>(&make_shared_memory_reader_server),
+             "reader"_a,
+             "name"_a,
+             "server_params"_a = Shared_memory_server_params{},
+             R"(
+            Parameters
+            ----------
+            reader : DataReader
+                The reader whose examples should be published.
+            name : str
+                The name of the shared memory segment.
+            server_params : SharedMemoryServerParams, optional
+                See ``SharedMemoryServerParams``.
+            )")
+        .def("__enter__",
+             [](Shared_memory_reader_server &self) -> Shared_memory_reader_server & {
+                 return self;
+             })
+        .def("__exit__",
+             [](Shared_memory_reader_server &self, const py::args &) {
+                 py::gil_scoped_release rel_gil;
+
+                 self.stop();
+             })
+        .def("stop",
+             &Shared_memory_reader_server::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stops the server. The clients that are waiting for an example get an error.")
+        .def_property_readonly(
+            "name", &Shared_memory_reader_server::name, "Gets the name of the server.");
+
+    py::class_<Shared_memory_reader, Data_reader, Intrusive_ptr<Shared_memory_reader>>(
+        m,
+        "SharedMemoryReader",
+        R"(
+        Represents a ``DataReader`` that reads the examples published by a
+        ``SharedMemoryReaderServer``, possibly running in another process.
+        The tensors of the returned examples point directly into the shared
+        memory segment; their slot is handed back to the server once they
+        are destroyed.)")
+        .def(py::init<>(&make_shared_memory_reader),
+             "name"_a,
+             "client_index"_a = 0,
+             R"(
+            Parameters
+            ----------
+            name : str
+                The name of the server.
+            client_index : int, optional
+                The index of the client between zero and the number of
+                clients of the server. Each client process must use a
+                distinct index, such as the id of a data loader worker.
+            )")
+        .def_property_readonly("client_index",
+                               &Shared_memory_reader::client_index,
+                               "Gets the index of the client.");
+
+    py::class_<Data_service_worker, Data_service_worker_ptr>(
+        m,
+        "DataServiceWorker",
+        R"(
+        Represents a worker that runs the preprocessing pipeline of a
+        dataset, typically on a CPU-only host, and streams the resulting
+        examples over TCP to the ``DataServiceReader`` objects of the
+        trainers. For each split assigned to it the worker calls `factory`
+        with the index of the split and the total number of splits, and
+        sends the examples of the returned ``DataReader``. Only dense, COO,
+        and CSR features of numeric data types can be sent.)")
+        .def(py::init<>(&make_data_service_worker),
+             "factory"_a,
+             "host"_a = "",
+             "port"_a = 0,
+             R"(
+            Parameters
+            ----------
+            factory : callable
+                A callable that accepts the index of a split and the number
+                of splits, and returns the ``DataReader`` of the split.
+            host : str, optional
+                The host name or the address to listen on. If empty, listens
+                on all interfaces.
+            port : int, optional
+                The TCP port to listen on. If zero, an ephemeral port is
+                chosen.
+            )")
+        .def("__enter__",
+             [](Data_service_worker &self) -> Data_service_worker & {
+                 return self;
+             })
+        .def("__exit__",
+             [](Data_service_worker &self, const py::args &) {
+                 py::gil_scoped_release rel_gil;
+
+                 self.stop();
+             })
+        .def("stop",
+             &Data_service_worker::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stops the worker and closes all connections.")
+        .def_property_readonly(
+            "port", &Data_service_worker::port, "Gets the TCP port the worker listens on.");
+
+    py::class_<Data_service_params>(
+        m, "DataServiceParams", "Represents the parameters of a ``DataServiceReader`` object.")
+        .def(py::init(&make_data_service_params),
+             "workers"_a,
+             "num_splits"_a = 0,
+             "shard_index"_a = 0,
+             "num_shards"_a = 1,
+             R"(
+            Parameters
+            ----------
+            workers : list of strs
+                The addresses of the workers in the form of "host:port".
+            num_splits : int, optional
+                The number of splits into which the dataset is divided. If
+                zero, defaults to four times the number of workers.
+            shard_index : int, optional
+                The index of the trainer when several trainers share the
+                same workers.
+            num_shards : int, optional
+                The number of trainers that share the same workers.
+            )")
+        .def_readwrite("workers", &Data_service_params::workers)
+        .def_readwrite("num_splits", &Data_service_params::num_splits)
+        .def_readwrite("shard_index", &Data_service_params::shard_index)
+        .def_readwrite("num_shards", &Data_service_params::num_shards);
+
+    py::class_<Data_service_reader, Data_reader, Intrusive_ptr<Data_service_reader>>(
+        m,
+        "DataServiceReader",
+        R"(
+        Represents a ``DataReader`` that reads the examples streamed by a
+        set of ``DataServiceWorker`` objects. The splits of an epoch are
+        assigned dynamically so that a slow worker processes fewer splits
+        instead of stalling the epoch.)")
+        .def(py::init<>(&make_data_service_reader),
+             "params"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Parameters
+            ----------
+            params : DataServiceParams
+                See ``DataServiceParams``.
+            )")
+        .def("reset",
+             &Data_service_reader::reset,
+             py::call_guard<py::gil_scoped_release>(),
+             "Resets the state of the reader. Calling ``read_example()`` the "
+             "next time will start reading from the beginning of the dataset.");
+
+    py::class_<Columnar_reader, Parallel_data_reader, Intrusive_ptr<Columnar_reader>>(
+        m,
+        "ColumnarReader",
+        "Represents a ``DataReader`` for reading datasets written by ``ColumnarWriter``. "
+        "Each block, which holds the instances of one written example, is treated as an "
+        "instance; ``batch_size`` specifies the number of blocks per example.")
+        .def(py::init<>(&make_columnar_reader),
+             "data_reader_params"_a,
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            )");
+
+    py::class_<Csv_reader, Parallel_data_reader, Intrusive_ptr<Csv_reader>>(
         m, "CsvReader", "Represents a ``Data_reader`` for reading CSV datasets.")
         .def(py::init<>(&make_csv_reader),
              "data_reader_params"_a,
@@ -637,9 +2786,47 @@ void register_data_readers(py::module &m)
                 See ``DataReaderParams``.
             csv_reader_params : CsvReaderParams, optional
                 See ``CsvReaderParams``.
+            )")
+        .def("save_schema",
+             &Csv_reader::save_schema,
+             "path"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Write the column names and data types of the dataset to the
+            specified file so that subsequent readers can skip the schema
+            inference by setting the ``schema_path`` parameter of
+            ``CsvParams``.
+
+            Parameters
+            ----------
+            path : str
+                The path of the schema file.
+            )")
+        .def("dictionary",
+             &Csv_reader::dictionary,
+             "name"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Return the values of the specified dictionary-encoded column
+            ordered by their codes.
+
+            Parameters
+            ----------
+            name : str
+                The name of the column as in the schema.
+            )")
+        .def("read_column_chunks",
+             &Csv_reader::read_column_chunks,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Read the next batch of rows and return it as a list of
+            ``ColumnChunk`` objects, one per column that is read. The
+            string columns are returned as ``StringTensor`` objects; set
+            `arena_strings` to have them built by the decoder. Returns an
+            empty list at the end of the dataset.
             )");
 
-    py::class_<Image_reader, Data_reader, Intrusive_ptr<Image_reader>>(
+    py::class_<Image_reader, Parallel_data_reader, Intrusive_ptr<Image_reader>>(
         m, "ImageReader", "Represents a ``Data_reader`` for reading Image datasets.")
         .def(py::init<>(&make_image_reader),
              "data_reader_params"_a,
@@ -653,25 +2840,383 @@ void register_data_readers(py::module &m)
                 See ``ImageReaderParams``.
             )");
 
-    py::class_<Recordio_protobuf_reader, Data_reader, Intrusive_ptr<Recordio_protobuf_reader>>(
-        m, "RecordIOProtobufReader")
+    py::class_<Json_lines_reader, Parallel_data_reader, Intrusive_ptr<Json_lines_reader>>(
+        m,
+        "JsonLinesReader",
+        "Represents a ``Data_reader`` for reading JSON Lines datasets.")
+        .def(py::init<>(&make_json_lines_reader),
+             "data_reader_params"_a,
+             "json_lines_params"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            json_lines_params : JsonLinesParams, optional
+                See ``JsonLinesParams``.
+            )");
+
+    py::class_<Libsvm_reader, Parallel_data_reader, Intrusive_ptr<Libsvm_reader>>(
+        m,
+        "LibsvmReader",
+        "Represents a ``Data_reader`` for reading LibSVM (SVMlight) datasets.")
+        .def(py::init<>(&make_libsvm_reader),
+             "data_reader_params"_a,
+             "libsvm_params"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            libsvm_params : LibsvmParams, optional
+                See ``LibsvmParams``.
+            )");
+
+    py::class_<Tf_example_reader, Parallel_data_reader, Intrusive_ptr<Tf_example_reader>>(
+        m,
+        "TfExampleReader",
+        "Represents a ``Data_reader`` for reading TFRecord files of tf.train.Example messages.")
+        .def(py::init<>(&make_tf_example_reader),
+             "data_reader_params"_a,
+             "tf_example_params"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            tf_example_params : TfExampleParams, optional
+                See ``TfExampleParams``.
+            )");
+
+    py::class_<Audio_reader, Parallel_data_reader, Intrusive_ptr<Audio_reader>>(
+        m, "AudioReader", "Represents a ``Data_reader`` for reading audio clips.")
+        .def(py::init<>(&make_audio_reader),
+             "data_reader_params"_a,
+             "audio_reader_params"_a,
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            audio_reader_params : AudioReaderParams
+                See ``AudioReaderParams``.
+            )");
+
+    py::class_<Video_reader, Parallel_data_reader, Intrusive_ptr<Video_reader>>(
+        m, "VideoReader", "Represents a ``Data_reader`` for reading video clips.")
+        .def(py::init<>(&make_video_reader),
+             "data_reader_params"_a,
+             "video_reader_params"_a,
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            video_reader_params : VideoReaderParams
+                See ``VideoReaderParams``.
+            )");
+
+    py::class_<Parquet_row_group_filter>(
+        m,
+        "ParquetRowGroupFilter",
+        "Skips the row groups whose statistics show that none of their values in "
+        "``column`` fall into [``min_value``, ``max_value``].")
+        .def(py::init(&make_parquet_row_group_filter),
+             "column"_a,
+             "min_value"_a = std::nullopt,
+             "max_value"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            column : str
+                The dot-separated path of the column.
+            min_value : float, optional
+                The inclusive lower bound of the values to read.
+            max_value : float, optional
+                The inclusive upper bound of the values to read.
+            )")
+        .def_readwrite("column", &Parquet_row_group_filter::column)
+        .def_readwrite("min_value", &Parquet_row_group_filter::min_value)
+        .def_readwrite("max_value", &Parquet_row_group_filter::max_value);
+
+    py::class_<Parquet_reader_params>(
+        m, "ParquetReaderParams", "Represents the optional parameters of a ``ParquetReader`` object.")
+        .def(py::init(&make_parquet_reader_params),
+             "use_columns"_a = std::unordered_set<std::string>{},
+             "row_group_filters"_a = std::vector<Parquet_row_group_filter>{},
+             R"(
+            Parameters
+            ----------
+            use_columns : list of strs
+                The columns to read. If empty, all columns of a supported
+                type are read. Only the column chunks of the specified
+                columns are fetched from the data stores.
+            row_group_filters : list of ParquetRowGroupFilter
+                The filters to skip row groups by their statistics. The
+                rows of the row groups that are read are not filtered.
+            )")
+        .def_readwrite("use_columns", &Parquet_reader_params::use_columns)
+        .def_readwrite("row_group_filters", &Parquet_reader_params::row_group_filters);
+
+    py::class_<Parquet_reader, Parallel_data_reader, Intrusive_ptr<Parquet_reader>>(
+        m,
+        "ParquetReader",
+        "Represents a ``DataReader`` for reading Parquet datasets. Each row group is "
+        "treated as an instance; ``batch_size`` specifies the number of row groups per "
+        "example, and ``last_example_handling`` must be ``NONE``.")
+        .def(py::init<>(&make_parquet_reader),
+             "data_reader_params"_a,
+             "parquet_reader_params"_a = Parquet_reader_params{},
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            parquet_reader_params : ParquetReaderParams, optional
+                See ``ParquetReaderParams``.
+            )");
+
+    py::class_<Avro_reader_params>(
+        m, "AvroReaderParams", "Represents the optional parameters of an ``AvroReader`` object.")
+        .def(py::init(&make_avro_reader_params),
+             "use_columns"_a = std::unordered_set<std::string>{},
+             R"(
+            Parameters
+            ----------
+            use_columns : list of strs
+                The fields to read. If empty, all top-level fields of a
+                supported type are read. The values of the other fields
+                are skipped without being decoded.
+            )")
+        .def_readwrite("use_columns", &Avro_reader_params::use_columns);
+
+    py::class_<Avro_reader, Parallel_data_reader, Intrusive_ptr<Avro_reader>>(
+        m,
+        "AvroReader",
+        "Represents a ``DataReader`` for reading Avro object container files. Each "
+        "block is treated as an instance; ``batch_size`` specifies the number of "
+        "blocks per example.")
+        .def(py::init<>(&make_avro_reader),
+             "data_reader_params"_a,
+             "avro_reader_params"_a = Avro_reader_params{},
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            avro_reader_params : AvroReaderParams, optional
+                See ``AvroReaderParams``.
+            )");
+
+    py::class_<Orc_reader_params>(
+        m, "OrcReaderParams", "Represents the optional parameters of an ``OrcReader`` object.")
+        .def(py::init(&make_orc_reader_params),
+             "use_columns"_a = std::unordered_set<std::string>{},
+             R"(
+            Parameters
+            ----------
+            use_columns : list of strs
+                The columns to read. If empty, all top-level columns of a
+                supported type are read. Only the streams of the
+                specified columns are fetched from the data stores.
+            )")
+        .def_readwrite("use_columns", &Orc_reader_params::use_columns);
+
+    py::class_<Orc_reader, Parallel_data_reader, Intrusive_ptr<Orc_reader>>(
+        m,
+        "OrcReader",
+        "Represents a ``DataReader`` for reading ORC datasets. Each stripe is "
+        "treated as an instance; ``batch_size`` specifies the number of stripes per "
+        "example.")
+        .def(py::init<>(&make_orc_reader),
+             "data_reader_params"_a,
+             "orc_reader_params"_a = Orc_reader_params{},
+             R"(
+            Parameters
+            ----------
+            data_reader_params : DataReaderParams
+                See ``DataReaderParams``.
+            orc_reader_params : OrcReaderParams, optional
+                See ``OrcReaderParams``.
+            )");
+
+    py::class_<Recordio_protobuf_reader,
+               Parallel_data_reader,
+               Intrusive_ptr<Recordio_protobuf_reader>>(m, "RecordIOProtobufReader")
         .def(py::init<>(&make_recordio_protobuf_reader),
              "data_reader_params"_a,
+             "float32_data_type"_a = Data_type::float32,
+             "data_types"_a = std::unordered_map<std::string, Data_type>{},
+             "hash_dimensions"_a = std::unordered_map<std::string, std::size_t>{},
              R"(
             Parameters
             ----------
             data_reader_params : DataReaderParams
                 See ``DataReaderParams``.
+            float32_data_type : DataType, optional
+                The data type of the features stored as float32 tensors;
+                either FLOAT32, FLOAT16, or BFLOAT16. Narrowing halves
+                the size of the examples.
+            data_types : map of str/DataType
+                The data types of specific features keyed by their
+                attribute names (labels have the "label_" prefix); take
+                precedence over `float32_data_type`. FLOAT32 features can
+                be narrowed to FLOAT16 or BFLOAT16, FLOAT64 features to
+                FLOAT32, FLOAT16, or BFLOAT16, and INT32 features to INT8
+                or INT16. A value that does not fit into the narrowed
+                data type makes its instance a bad instance.
+            hash_dimensions : map of str/int
+                The dimensions to hash specific sparse features into,
+                keyed by their attribute names. The keys are folded
+                modulo the dimension during decoding, and the feature is
+                returned as a ``CsrTensor`` with INT32 indices and index
+                pointers regardless of `sparse_tensor_format`. The
+                dimensions must be between 1 and 2^31.
             )");
 
-    py::class_<Text_line_reader, Data_reader, Intrusive_ptr<Text_line_reader>>(m, "TextLineReader")
+    py::class_<Recordio_index_entry>(
+        m, "RecordIOIndexEntry", "Holds the location of a RecordIO record in its data store.")
+        .def(py::init<>())
+        .def_readwrite(
+            "offset", &Recordio_index_entry::offset, "The byte offset of the record header.")
+        .def_readwrite("size",
+                       &Recordio_index_entry::size,
+                       "The size of the record in bytes including its header and padding.");
+
+    m.def("build_recordio_index",
+          &build_recordio_index,
+          "store"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+        Scan the specified RecordIO data store and return the location of
+        each record in it.
+
+        Parameters
+        ----------
+        store : DataStore
+            The RecordIO data store to scan.
+        )");
+
+    m.def(
+        "write_recordio_index",
+        [](const std::string &path, const std::vector<Recordio_index_entry> &entries) {
+            write_recordio_index(path, entries);
+        },
+        "path"_a,
+        "entries"_a,
+        py::call_guard<py::gil_scoped_release>(),
+        R"(
+        Write the specified index to a file, conventionally named after
+        its data store with an additional '.idx' extension.
+
+        Parameters
+        ----------
+        path : str
+            The path of the index file.
+        entries : list of RecordIOIndexEntry
+            The index entries as returned by `build_recordio_index()`.
+        )");
+
+    m.def("read_recordio_index",
+          &read_recordio_index,
+          "store"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+        Read the index stored in the specified data store.
+
+        Parameters
+        ----------
+        store : DataStore
+            The data store that contains the index.
+        )");
+
+    py::class_<Wordpiece_params>(
+        m,
+        "WordpieceParams",
+        "Specifies how ``TextLineReader`` tokenizes lines with a WordPiece "
+        "vocabulary.")
+        .def(py::init(&make_wordpiece_params),
+             "vocab_path"_a,
+             "lowercase"_a = true,
+             "unknown_token"_a = "[UNK]",
+             "begin_token"_a = "[CLS]",
+             "end_token"_a = "[SEP]",
+             "padding_token"_a = "[PAD]",
+             "max_sequence_length"_a = 128,
+             "max_chars_per_word"_a = 100,
+             "pack_sequences"_a = false,
+             R"(
+            Parameters
+            ----------
+            vocab_path : str
+                The path of the vocabulary file. It contains one token per
+                line; the id of a token is its zero-based line number.
+            lowercase : bool
+                A boolean value indicating whether to lower-case ASCII
+                letters before the lookup.
+            unknown_token : str
+                The token used for words that cannot be split into
+                vocabulary entries.
+            begin_token : str
+                The token added to the beginning of each sequence. If empty,
+                no token is added.
+            end_token : str
+                The token added to the end of each sequence. If empty, no
+                token is added.
+            padding_token : str
+                The token used for padding. If empty, padding uses id 0.
+            max_sequence_length : int
+                The length of the output sequences. Longer sequences are
+                truncated.
+            max_chars_per_word : int
+                Words longer than this, in bytes, are mapped to the unknown
+                token.
+            pack_sequences : bool
+                A boolean value indicating whether to pack as many sequences
+                as fit into each row. In such case the attention mask holds
+                the one-based index of the sequence within its row.
+            )")
+        .def_readwrite("vocab_path", &Wordpiece_params::vocab_path)
+        .def_readwrite("lowercase", &Wordpiece_params::lowercase)
+        .def_readwrite("unknown_token", &Wordpiece_params::unknown_token)
+        .def_readwrite("begin_token", &Wordpiece_params::begin_token)
+        .def_readwrite("end_token", &Wordpiece_params::end_token)
+        .def_readwrite("padding_token", &Wordpiece_params::padding_token)
+        .def_readwrite("max_sequence_length", &Wordpiece_params::max_sequence_length)
+        .def_readwrite("max_chars_per_word", &Wordpiece_params::max_chars_per_word)
+        .def_readwrite("pack_sequences", &Wordpiece_params::pack_sequences);
+
+    py::class_<Text_line_reader, Parallel_data_reader, Intrusive_ptr<Text_line_reader>>(
+        m, "TextLineReader")
         .def(py::init<>(&make_text_line_reader),
              "data_reader_params"_a,
+             "validate_utf8"_a = false,
+             "pack_lines"_a = false,
+             "arena_strings"_a = false,
+             "wordpiece"_a = std::nullopt,
              R"(
             Parameters
             ----------
             data_reader_params : DataReaderParams
                 See ``DataReaderParams``.
+            validate_utf8 : bool
+                A boolean value indicating whether to verify that each line
+                is a valid UTF-8 string.
+            pack_lines : bool
+                A boolean value indicating whether to return the lines of a
+                batch as a "value" uint8 tensor holding their bytes back to
+                back and a "value_offsets" int64 tensor of size batch size
+                + 1, instead of a string tensor. The pair can be wrapped
+                without copying as a ``pyarrow.LargeStringArray`` via
+                ``from_buffers``.
+            arena_strings : bool
+                A boolean value indicating whether to return the "value"
+                feature as a ``StringTensor`` that holds the lines of a batch
+                in a single buffer. Cannot be combined with `pack_lines` or
+                `wordpiece`.
+            wordpiece : WordpieceParams, optional
+                If specified, the lines are tokenized and the batches
+                contain "input_ids" and "attention_mask" int32 tensors.
             )");
 }
 
@@ -16,8 +16,16 @@
 #include "module.h"
 
 #include <chrono>
+#include <cstdint>
 #include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
 
+#include <fmt/format.h>
+
+#include "py_file_object.h"
 #include "py_memory_block.h"
 
 namespace py = pybind11;
@@ -36,6 +44,12 @@ public:
 
 public:
     const std::string &id() const noexcept override;
+
+private:
+    std::string get_py_id() const;
+
+    mutable std::once_flag id_flag_{};
+    mutable std::string id_{};
 };
 
 Intrusive_ptr<Input_stream> Py_data_store::open_read() const
@@ -55,13 +69,97 @@ std::string Py_data_store::repr() const
 
 const std::string &Py_data_store::id() const noexcept
 {
+    // The id of a data store never changes; it is queried by the
+    // pipeline for every store, so we acquire the GIL only once.
     try {
-        // NOLINTNEXTLINE
-        PYBIND11_OVERLOAD_PURE(const std::string &, Data_store, id, )
+        std::call_once(id_flag_, [this] {
+            id_ = get_py_id();
+        });
     }
     catch (...) {
         std::terminate();
     }
+
+    return id_;
+}
+
+std::string Py_data_store::get_py_id() const
+{
+    // NOLINTNEXTLINE
+    PYBIND11_OVERLOAD_PURE_NAME(std::string, Data_store, "id", id, )
+}
+
+// Represents a Python file object, such as an fsspec file, as a data
+// store; see make_file_object_stream().
+class Py_file_object_store final : public Data_store {
+public:
+    explicit Py_file_object_store(std::string id,
+                                  py::function opener,
+                                  std::optional<std::size_t> size_hint,
+                                  std::size_t block_size,
+                                  std::size_t prefetch_depth)
+        : id_{std::move(id)}
+        , opener_{std::move(opener)}
+        , size_hint_{size_hint}
+        , block_size_{block_size}
+        , prefetch_depth_{prefetch_depth}
+    {}
+
+    Py_file_object_store(const Py_file_object_store &) = delete;
+
+    Py_file_object_store &operator=(const Py_file_object_store &) = delete;
+
+    Py_file_object_store(Py_file_object_store &&) = delete;
+
+    Py_file_object_store &operator=(Py_file_object_store &&) = delete;
+
+    ~Py_file_object_store() final;
+
+    Intrusive_ptr<Input_stream> open_read() const final;
+
+    std::string repr() const final
+    {
+        return fmt::format("<FileObjectStore id='{0}'>", id_);
+    }
+
+    const std::string &id() const noexcept final
+    {
+        return id_;
+    }
+
+    std::optional<std::size_t> size_hint() const noexcept final
+    {
+        return size_hint_;
+    }
+
+private:
+    std::string id_;
+    py::function opener_;
+    std::optional<std::size_t> size_hint_;
+    std::size_t block_size_;
+    std::size_t prefetch_depth_;
+};
+
+Py_file_object_store::~Py_file_object_store()
+{
+    if (::Py_IsInitialized() == 0) {
+        opener_.release();
+
+        return;
+    }
+
+    // The data store can be released by the last pipeline thread that
+    // refers to it.
+    py::gil_scoped_acquire acq_gil{};
+
+    opener_ = {};
+}
+
+Intrusive_ptr<Input_stream> Py_file_object_store::open_read() const
+{
+    py::gil_scoped_acquire acq_gil{};
+
+    return make_file_object_stream(opener_(), block_size_, prefetch_depth_);
 }
 
 Intrusive_ptr<In_memory_store> make_in_memory_store(const py::buffer &buf, Compression compression)
@@ -69,6 +167,20 @@ Intrusive_ptr<In_memory_store> make_in_memory_store(const py::buffer &buf, Compr
     return make_intrusive<In_memory_store>(make_intrusive<Py_memory_block>(buf), compression);
 }
 
+Intrusive_ptr<Shared_read_group> make_shared_read_group(std::size_t num_consumers,
+                                                       std::size_t chunk_size,
+                                                       std::size_t max_buffer_size,
+                                                       std::chrono::milliseconds detach_timeout)
+{
+    Shared_read_params params{};
+    params.num_consumers = num_consumers;
+    params.chunk_size = chunk_size;
+    params.max_buffer_size = max_buffer_size;
+    params.detach_timeout = detach_timeout;
+
+    return make_intrusive<Shared_read_group>(params);
+}
+
 std::vector<Intrusive_ptr<Data_store>>
 py_list_files(const std::vector<std::string> &paths,
               const std::string &pattern,
@@ -79,6 +191,35 @@ py_list_files(const std::vector<std::string> &paths,
     return list_files(paths, {pattern, &predicate, memory_map, compression});
 }
 
+void py_write_file_manifest(const std::string &path,
+                            const std::vector<Intrusive_ptr<Data_store>> &stores)
+{
+    write_file_manifest(path, stores);
+}
+
+void py_write_checksum_manifest(const std::string &path,
+                                const std::vector<Intrusive_ptr<Data_store>> &stores,
+                                Checksum_algorithm algorithm)
+{
+    write_checksum_manifest(path, stores, algorithm);
+}
+
+void py_write_tar_shard(const std::string &path,
+                        const std::vector<Intrusive_ptr<Data_store>> &stores)
+{
+    write_tar_shard(path, stores);
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+py_read_file_manifest(const std::string &path,
+                      const std::string &pattern,
+                      File_list_options::Predicate_callback &predicate,
+                      bool memory_map,
+                      Compression compression)
+{
+    return read_file_manifest(path, {pattern, &predicate, memory_map, compression});
+}
+
 std::vector<Intrusive_ptr<Data_store>>
 py_list_s3_objects(const S3_client &client,
                    const std::vector<std::string> &uris,
@@ -89,6 +230,35 @@ py_list_s3_objects(const S3_client &client,
     return list_s3_objects(client, uris, {pattern, &predicate, compression});
 }
 
+std::vector<Intrusive_ptr<Data_store>>
+py_list_gcs_objects(const Gcs_client &client,
+                    const std::vector<std::string> &uris,
+                    const std::string &pattern,
+                    Object_list_options::Predicate_callback &predicate,
+                    Compression compression)
+{
+    return list_gcs_objects(client, uris, {pattern, &predicate, compression});
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+py_list_azure_blobs(const Azure_blob_client &client,
+                    const std::vector<std::string> &uris,
+                    const std::string &pattern,
+                    Object_list_options::Predicate_callback &predicate,
+                    Compression compression)
+{
+    return list_azure_blobs(client, uris, {pattern, &predicate, compression});
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+py_list_kafka_partitions(Intrusive_ptr<Kafka_client> client,
+                         const std::string &topic,
+                         bool bounded,
+                         const std::string &separator)
+{
+    return list_kafka_partitions(std::move(client), topic, bounded, separator);
+}
+
 }  // namespace
 
 void register_data_stores(py::module &m)
@@ -98,7 +268,9 @@ void register_data_stores(py::module &m)
         .value("INFER", Compression::infer)
         .value("GZIP", Compression::gzip)
         .value("BZIP2", Compression::bzip2)
-        .value("ZIP", Compression::zip);
+        .value("ZIP", Compression::zip)
+        .value("ZSTD", Compression::zstd)
+        .value("LZ4", Compression::lz4);
 
     py::class_<Data_store, Py_data_store, Intrusive_ptr<Data_store>>(
         m, "DataStore", "Represents a repository of data.")
@@ -117,14 +289,28 @@ void register_data_stores(py::module &m)
              })
         .def("__repr__", &Data_store::repr)
         .def_property_readonly(
-            "id", &Data_store::id, "Returns a unique identifier for the data store.");
+            "id", &Data_store::id, "Returns a unique identifier for the data store.")
+        .def_property_readonly("size_hint",
+                               &Data_store::size_hint,
+                               "Returns the size of the data store in bytes if it is known "
+                               "without opening it.")
+        .def_property_readonly("num_instances_hint",
+                               &Data_store::num_instances_hint,
+                               "Returns the number of data instances in the data store if it "
+                               "is known without opening it.");
 
     py::class_<File, Data_store, Intrusive_ptr<File>>(
         m, "File", "Represents a File as a ``DataStore``.")
-        .def(py::init<std::string, bool, Compression>(),
+        .def(py::init<std::string,
+                      bool,
+                      Compression,
+                      std::optional<std::size_t>,
+                      std::optional<std::size_t>>(),
              "path"_a,
              "memory_map"_a = true,
              "compression"_a = Compression::infer,
+             "size_hint"_a = std::nullopt,
+             "num_instances_hint"_a = std::nullopt,
              R"(
             Parameters
             ----------
@@ -136,6 +322,11 @@ void register_data_stores(py::module &m)
             compression : compression
                 The compression type of the File. If set to `INFER`, the
                 compression will be inferred from the filename.
+            size_hint : int, optional
+                The size of the File in bytes, if already known.
+            num_instances_hint : int, optional
+                The number of data instances in the File, if already
+                known. Lets the data readers skip the File as a whole.
             )");
 
     py::class_<In_memory_store, Data_store, Intrusive_ptr<In_memory_store>>(
@@ -152,13 +343,51 @@ void register_data_stores(py::module &m)
                 The compression type of the data.
             )");
 
+    py::class_<Py_file_object_store, Data_store, Intrusive_ptr<Py_file_object_store>>(
+        m,
+        "FileObjectStore",
+        "Represents a Python file object, such as an fsspec file, as a "
+        "``DataStore``.")
+        .def(py::init<std::string,
+                      py::function,
+                      std::optional<std::size_t>,
+                      std::size_t,
+                      std::size_t>(),
+             "id"_a,
+             "opener"_a,
+             "size_hint"_a = std::nullopt,
+             "block_size"_a = 0x40'0000,
+             "prefetch_depth"_a = 2,
+             R"(
+            Parameters
+            ----------
+            id : str
+                The unique identifier of the data store, e.g. its URL.
+            opener : callable
+                The function that returns a new binary file object each
+                time the data store is opened.
+            size_hint : int, optional
+                The size of the data in bytes, if already known.
+            block_size : int
+                The number of bytes to read from the file object at once.
+            prefetch_depth : int
+                The number of blocks to read ahead on a dedicated thread.
+                If zero, the file object is read on the thread that reads
+                from the stream, with the GIL acquired for each read.
+            )");
+
     py::class_<S3_object, Data_store, Intrusive_ptr<S3_object>>(
         m, "S3Object", "Represents an S3 object as a ``DataStore``.")
-        .def(py::init<Intrusive_ptr<S3_client>, std::string, std::string, Compression>(),
+        .def(py::init<Intrusive_ptr<S3_client>,
+                      std::string,
+                      std::string,
+                      Compression,
+                      std::optional<S3_range_read_params>>(),
              "client"_a,
              "uri"_a,
              "version_id"_a = "",
              "compression"_a = Compression::infer,
+             "range_read_params"_a = std::nullopt,
              R"(
             Parameters
             ----------
@@ -171,15 +400,176 @@ void register_data_stores(py::module &m)
             compression : compression
                 The compression type of the S3 object. If set to `INFER`, the
                 compression will be inferred from the URI.
+            range_read_params : S3RangeReadParams, optional
+                The parameters for reading the S3 object with concurrent
+                byte-range GET requests. If not specified, the parameters of
+                the client will be used.
+            )");
+
+    py::class_<Gcs_object, Data_store, Intrusive_ptr<Gcs_object>>(
+        m, "GcsObject", "Represents a Google Cloud Storage object as a ``DataStore``.")
+        .def(py::init<Intrusive_ptr<Gcs_client>,
+                      std::string,
+                      std::string,
+                      Compression,
+                      std::optional<Range_read_params>>(),
+             "client"_a,
+             "uri"_a,
+             "generation"_a = "",
+             "compression"_a = Compression::infer,
+             "range_read_params"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            client : GcsClient
+                The `GcsClient` to use.
+            uri : str
+                The URI of the Google Cloud Storage object.
+            generation : str
+                The generation of the object to read.
+            compression : compression
+                The compression type of the object. If set to `INFER`, the
+                compression will be inferred from the URI.
+            range_read_params : RangeReadParams, optional
+                The parameters for reading the object with concurrent
+                byte-range GET requests. If not specified, the parameters of
+                the client will be used.
+            )");
+
+    py::class_<Http_object, Data_store, Intrusive_ptr<Http_object>>(
+        m, "HttpObject", "Represents an object served over HTTP(S) as a ``DataStore``.")
+        .def(py::init<Intrusive_ptr<Http_client>,
+                      std::string,
+                      std::string,
+                      Compression,
+                      std::optional<Range_read_params>,
+                      std::optional<std::size_t>>(),
+             "client"_a,
+             "uri"_a,
+             "etag"_a = "",
+             "compression"_a = Compression::infer,
+             "range_read_params"_a = std::nullopt,
+             "size_hint"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            client : HttpClient
+                The `HttpClient` to use.
+            uri : str
+                The URI of the object.
+            etag : str
+                The ETag of the object. If specified, reading fails once
+                the object on the server no longer matches it.
+            compression : compression
+                The compression type of the object. If set to `INFER`, the
+                compression will be inferred from the URI.
+            range_read_params : RangeReadParams, optional
+                The parameters for reading the object with concurrent
+                byte-range GET requests. If not specified, the parameters of
+                the client will be used.
+            size_hint : int, optional
+                The size of the object, if already known; saves a request
+                when the object is opened.
+            )");
+
+    py::class_<Azure_blob, Data_store, Intrusive_ptr<Azure_blob>>(
+        m, "AzureBlob", "Represents an Azure blob as a ``DataStore``.")
+        .def(py::init<Intrusive_ptr<Azure_blob_client>,
+                      std::string,
+                      std::string,
+                      Compression,
+                      std::optional<Range_read_params>>(),
+             "client"_a,
+             "uri"_a,
+             "version_id"_a = "",
+             "compression"_a = Compression::infer,
+             "range_read_params"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            client : AzureBlobClient
+                The `AzureBlobClient` to use.
+            uri : str
+                The URI of the Azure blob.
+            version_id : str
+                The version of the blob to read.
+            compression : compression
+                The compression type of the object. If set to `INFER`, the
+                compression will be inferred from the URI.
+            range_read_params : RangeReadParams, optional
+                The parameters for reading the object with concurrent
+                byte-range GET requests. If not specified, the parameters of
+                the client will be used.
             )");
 
+    py::class_<Kafka_partition, Data_store, Intrusive_ptr<Kafka_partition>>(
+        m, "KafkaPartition", "Represents a partition of a Kafka topic as a ``DataStore``.")
+        .def(py::init<Intrusive_ptr<Kafka_client>,
+                      std::string,
+                      std::int32_t,
+                      std::int64_t,
+                      std::int64_t,
+                      std::string>(),
+             "client"_a,
+             "topic"_a,
+             "partition"_a,
+             "start_offset"_a = kafka_offset_beginning,
+             "end_offset"_a = -1,
+             "separator"_a = "",
+             R"(
+            Parameters
+            ----------
+            client : KafkaClient
+                The `KafkaClient` to use.
+            topic : str
+                The topic of the partition.
+            partition : int
+                The partition to read.
+            start_offset : int, optional
+                The offset of the first message to read; if -2, the first
+                retained message.
+            end_offset : int, optional
+                The offset right after the last message to read. If
+                negative, the partition is followed until no new message
+                arrives within the timeout of the client.
+            separator : str, optional
+                The string appended to each message payload, for instance a
+                newline for CSV or JSON Lines messages without one.
+            )")
+        .def_property_readonly("topic", &Kafka_partition::topic)
+        .def_property_readonly("partition", &Kafka_partition::partition)
+        .def_property_readonly("start_offset", &Kafka_partition::start_offset)
+        .def_property_readonly("end_offset", &Kafka_partition::end_offset);
+
+    py::class_<Sagemaker_pipe_stats>(
+        m, "SageMakerPipeStats", "Holds the I/O statistics of a SageMaker pipe channel.")
+        .def_readonly("num_bytes_read",
+                      &Sagemaker_pipe_stats::num_bytes_read,
+                      "The number of bytes read from the channel.")
+        .def_readonly("num_reads",
+                      &Sagemaker_pipe_stats::num_reads,
+                      "The number of read calls that returned data.")
+        .def_readonly("num_stalls",
+                      &Sagemaker_pipe_stats::num_stalls,
+                      "The number of times the reader had to wait for data.")
+        .def_readonly("stall_ns",
+                      &Sagemaker_pipe_stats::stall_ns,
+                      "The total time, in nanoseconds, spent waiting for data.");
+
     py::class_<Sagemaker_pipe, Data_store, Intrusive_ptr<Sagemaker_pipe>>(
         m, "SageMakerPipe", "Represents an Amazon SageMaker pipe channel as a ``DataStore``.")
-        .def(py::init<std::string, std::chrono::seconds, std::optional<std::size_t>, Compression>(),
+        .def(py::init<std::string,
+                      std::chrono::seconds,
+                      std::optional<std::size_t>,
+                      Compression,
+                      std::size_t,
+                      bool>(),
              "path"_a,
              "timeout"_a = sagemaker_pipe_default_timeout,
              "fifo_id"_a = std::nullopt,
              "compression"_a = Compression::none,
+             "pipe_buffer_size"_a = sagemaker_pipe_default_buffer_size,
+             "open_next_fifo"_a = true,
              R"(
             Parameters
             ----------
@@ -192,7 +582,147 @@ void register_data_stores(py::module &m)
                 The FIFO suffix of the SageMaker pipe channel.
             compression : compression, optional
                 The compression type of the data.
-            )");
+            pipe_buffer_size : int, optional
+                The capacity, in bytes, to which the buffer of each FIFO is
+                raised. It is clamped to the limit of the system; if zero,
+                the default capacity is kept.
+            open_next_fifo : bool, optional
+                A boolean value indicating whether to open the FIFO of the
+                next epoch as soon as the current one reaches its end so
+                that SageMaker can start filling it while the current epoch
+                is still being processed.
+            )")
+        .def("stats",
+             &Sagemaker_pipe::stats,
+             "Gets the I/O statistics accumulated over all the streams opened "
+             "from the channel.");
+
+    py::class_<Zip_member, Data_store, Intrusive_ptr<Zip_member>>(
+        m, "ZipMember", "Represents a file member of a zip archive as a ``DataStore``.")
+        .def(py::init<std::string, const std::string &>(),
+             "archive_path"_a,
+             "name"_a,
+             R"(
+            Parameters
+            ----------
+            archive_path : str
+                The path of the zip archive.
+            name : str
+                The name of the member as recorded in the archive.
+            )")
+        .def_property_readonly(
+            "archive_path", &Zip_member::archive_path, "Gets the path of the zip archive.")
+        .def_property_readonly("name", &Zip_member::name, "Gets the name of the member.");
+
+    py::class_<Shared_read_group, Intrusive_ptr<Shared_read_group>>(
+        m,
+        "SharedReadGroup",
+        "Represents a group of readers that read the same dataset at the same "
+        "time and share a single read of each data store.")
+        .def(py::init(&make_shared_read_group),
+             "num_consumers"_a = 2,
+             "chunk_size"_a = 0x10'0000,
+             "max_buffer_size"_a = 0x400'0000,
+             "detach_timeout"_a = std::chrono::milliseconds{60'000},
+             R"(
+            Parameters
+            ----------
+            num_consumers : int
+                The number of readers that read the shared data stores
+                concurrently.
+            chunk_size : int
+                The number of bytes to read from a data store at once.
+            max_buffer_size : int
+                The maximum number of bytes a data store buffers for the
+                consumers that lag behind. Once reached, the consumer that
+                is ahead waits for the others.
+            detach_timeout : datetime.timedelta
+                The maximum amount of time the consumer that is ahead waits
+                for a lagging one before it detaches it. A detached consumer
+                reads the data store on its own. If zero, consumers are
+                never detached.
+            )")
+        .def("share",
+             &Shared_read_group::share,
+             "dataset"_a,
+             "Returns the data stores of the dataset wrapped as "
+             "``SharedDataStore``; pass the returned list to all readers "
+             "of the group.");
+
+    py::class_<Shared_data_store, Data_store, Intrusive_ptr<Shared_data_store>>(
+        m,
+        "SharedDataStore",
+        "Represents a ``DataStore`` whose data is read once and shared by the "
+        "consumers of a ``SharedReadGroup``.")
+        .def(py::init<Intrusive_ptr<Data_store>, Intrusive_ptr<Shared_read_group>>(),
+             "inner"_a,
+             "group"_a,
+             R"(
+            Parameters
+            ----------
+            inner : DataStore
+                The data store to share.
+            group : SharedReadGroup
+                The group whose readers share the data store.
+            )")
+        .def_property_readonly(
+            "inner", &Shared_data_store::inner, "Gets the underlying data store.");
+
+    py::enum_<Checksum_algorithm>(
+        m, "ChecksumAlgorithm", "Specifies the algorithm of a checksum.")
+        .value("CRC32C", Checksum_algorithm::crc32c)
+        .value("SHA256", Checksum_algorithm::sha256);
+
+    py::enum_<Checksum_mismatch_handling>(
+        m, "ChecksumMismatchHandling", "Specifies how a checksum mismatch gets handled.")
+        .value("ERROR", Checksum_mismatch_handling::error)
+        .value("WARN", Checksum_mismatch_handling::warn);
+
+    py::class_<Checksum>(m, "Checksum", "Holds the expected checksum of a data store.")
+        .def(py::init<>([](Checksum_algorithm algorithm, std::string value) {
+                 return Checksum{algorithm, std::move(value)};
+             }),
+             "algorithm"_a,
+             "value"_a,
+             R"(
+            Parameters
+            ----------
+            algorithm : ChecksumAlgorithm
+                The algorithm of the checksum.
+            value : str
+                The checksum as a hexadecimal string.
+            )")
+        .def("__repr__",
+             [](const Checksum &self) {
+                 return fmt::format("Checksum(value='{0}')", self.value);
+             })
+        .def_readwrite("algorithm", &Checksum::algorithm)
+        .def_readwrite("value", &Checksum::value);
+
+    py::class_<Verified_data_store, Data_store, Intrusive_ptr<Verified_data_store>>(
+        m,
+        "VerifiedDataStore",
+        "Represents a ``DataStore`` whose data is checked against an expected "
+        "checksum while it is read.")
+        .def(py::init<Intrusive_ptr<Data_store>, Checksum, Checksum_mismatch_handling>(),
+             "inner"_a,
+             "checksum"_a,
+             "handling"_a = Checksum_mismatch_handling::error,
+             R"(
+            Parameters
+            ----------
+            inner : DataStore
+                The data store to verify.
+            checksum : Checksum
+                The expected checksum of the data store.
+            handling : ChecksumMismatchHandling
+                Whether a mismatch raises a `ChecksumError` or logs a
+                warning.
+            )")
+        .def_property_readonly(
+            "inner", &Verified_data_store::inner, "Gets the underlying data store.")
+        .def_property_readonly(
+            "checksum", &Verified_data_store::checksum, "Gets the expected checksum.");
 
     m.def("list_files",
           &py_list_files,
@@ -235,6 +765,150 @@ void register_data_stores(py::module &m)
             The pattern to match the filenames against.
         )");
 
+    m.def("list_zip_members",
+          &list_zip_members,
+          "archive_path"_a,
+          R"(
+        List the file members of the specified zip archive in the order of
+        its central directory. Each member is a separate data store that
+        is inflated when it is opened.
+
+        Parameters
+        ----------
+        archive_path : str
+            The path of the zip archive.
+        )");
+
+    m.def("write_file_manifest",
+          &py_write_file_manifest,
+          "path"_a,
+          "stores"_a,
+          R"(
+        Write the paths and sizes of the specified files to a manifest
+        file so that later runs can skip the traversal of the file system.
+
+        Parameters
+        ----------
+        path : str
+            The path of the manifest file.
+        stores : list of Files
+            The files to list, typically as returned by `list_files`.
+        )");
+
+    m.def("compute_checksum",
+          &compute_checksum,
+          "store"_a,
+          "algorithm"_a = Checksum_algorithm::crc32c,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+        Read the specified data store to its end and return its checksum.
+
+        Parameters
+        ----------
+        store : DataStore
+            The data store to read.
+        algorithm : ChecksumAlgorithm
+            The checksum algorithm.
+        )");
+
+    m.def("write_checksum_manifest",
+          &py_write_checksum_manifest,
+          "path"_a,
+          "stores"_a,
+          "algorithm"_a = Checksum_algorithm::crc32c,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+        Write the checksums of the specified data stores to a manifest
+        file in the format of the sha256sum tool. The data stores are
+        read in parallel.
+
+        Parameters
+        ----------
+        path : str
+            The path of the manifest file.
+        stores : list of DataStores
+            The data stores to checksum.
+        algorithm : ChecksumAlgorithm
+            The checksum algorithm.
+        )");
+
+    m.def("read_checksum_manifest",
+          &read_checksum_manifest,
+          "path"_a,
+          R"(
+        Read the checksums listed in the specified manifest file as a
+        dictionary keyed by the ids of their data stores.
+
+        Parameters
+        ----------
+        path : str
+            The path of the manifest file.
+        )");
+
+    m.def("verify_checksums",
+          &verify_checksums,
+          "dataset"_a,
+          "checksums"_a,
+          "handling"_a = Checksum_mismatch_handling::error,
+          R"(
+        Return the data stores of the dataset with the ones listed in
+        `checksums` wrapped as ``VerifiedDataStore``.
+
+        Parameters
+        ----------
+        dataset : list of DataStores
+            The data stores to verify.
+        checksums : dict of str to Checksum
+            The expected checksums keyed by the ids of the data stores,
+            typically as returned by `read_checksum_manifest`.
+        handling : ChecksumMismatchHandling
+            Whether a mismatch raises a `ChecksumError` or logs a
+            warning.
+        )");
+
+    m.def("write_tar_shard",
+          &py_write_tar_shard,
+          "path"_a,
+          "stores"_a,
+          R"(
+        Pack the specified data stores into a tar archive with one file
+        per data store. The archive can be read with
+        `ImageFrame.TAR`.
+
+        Parameters
+        ----------
+        path : str
+            The path of the tar archive.
+        stores : list of DataStores
+            The data stores to pack.
+        )");
+
+    m.def("read_file_manifest",
+          &py_read_file_manifest,
+          "path"_a,
+          "pattern"_a = "",
+          "predicate"_a = nullptr,
+          "memory_map"_a = true,
+          "compression"_a = Compression::infer,
+          R"(
+        Read the files listed in the specified manifest file.
+
+        Parameters
+        ----------
+        path : str
+            The path of the manifest file.
+        pattern : str, optional
+            The pattern to match the filenames against.
+        predicate : callable
+            The callback function for user-specific filtering.
+        memory_map : bool
+            A boolean value indicating whether the files should be
+            memory-mapped.
+        compression : compression
+            The compression type of the files. If set to `INFER`, the
+            compression will be inferred from the filenames.
+        )");
+
     m.def("list_s3_objects",
           &py_list_s3_objects,
           "client"_a,
@@ -278,6 +952,134 @@ void register_data_stores(py::module &m)
         pattern : str, optional
             The pattern to match the S3 objects against.
         )");
+
+    m.def("list_gcs_objects",
+          &py_list_gcs_objects,
+          "client"_a,
+          "uris"_a,
+          "pattern"_a = "",
+          "predicate"_a = nullptr,
+          "compression"_a = Compression::infer,
+          R"(
+        List all GCS objects residing under the specified URIs.
+
+        Parameters
+        ----------
+        client : GcsClient
+            The client to use.
+        uris : list of strs
+            The list of URIs to traverse.
+        pattern : str, optional
+            The pattern to match the GCS objects against.
+        predicate : callable
+            The callback function for user-specific filtering.
+        compression : compression
+            The compression type of the GCS objects. If set to `INFER`, the
+            compression will be inferred from the URIs.
+        )");
+
+    m.def("list_gcs_objects",
+          py::overload_cast<const Gcs_client &, const std::string &, std::string_view>(
+              &list_gcs_objects),
+          "client"_a,
+          "uri"_a,
+          "pattern"_a = "",
+          R"(
+        List all GCS objects residing under the specified URI.
+
+        Parameters
+        ----------
+        client : GcsClient
+            The client to use.
+        uri : str
+            The URI to traverse.
+        pattern : str, optional
+            The pattern to match the GCS objects against.
+        )");
+
+    m.def("list_kafka_partitions",
+          &py_list_kafka_partitions,
+          py::call_guard<py::gil_scoped_release>(),
+          "client"_a,
+          "topic"_a,
+          "bounded"_a = true,
+          "separator"_a = "",
+          R"(
+        List the partitions of a Kafka topic as data stores, each starting
+        at the offset committed by the consumer group of the client.
+
+        Parameters
+        ----------
+        client : KafkaClient
+            The client to use.
+        topic : str
+            The topic to list.
+        bounded : bool, optional
+            A boolean value indicating whether the partitions end at their
+            last message at the time of the call. If false, they are
+            followed until no new message arrives within the timeout.
+        separator : str, optional
+            The string appended to each message payload.
+        )");
+
+    m.def("commit_kafka_partitions",
+          &commit_kafka_partitions,
+          py::call_guard<py::gil_scoped_release>(),
+          "dataset"_a,
+          R"(
+        Commit the end offsets of the bounded Kafka partitions in the
+        dataset for the consumer group of their client.
+
+        Parameters
+        ----------
+        dataset : list of DataStores
+            The data stores whose Kafka partitions to commit; other data
+            stores are ignored.
+        )");
+
+    m.def("list_azure_blobs",
+          &py_list_azure_blobs,
+          "client"_a,
+          "uris"_a,
+          "pattern"_a = "",
+          "predicate"_a = nullptr,
+          "compression"_a = Compression::infer,
+          R"(
+        List all Azure blobs residing under the specified URIs.
+
+        Parameters
+        ----------
+        client : AzureBlobClient
+            The client to use.
+        uris : list of strs
+            The list of URIs to traverse.
+        pattern : str, optional
+            The pattern to match the Azure blobs against.
+        predicate : callable
+            The callback function for user-specific filtering.
+        compression : compression
+            The compression type of the Azure blobs. If set to `INFER`, the
+            compression will be inferred from the URIs.
+        )");
+
+    m.def("list_azure_blobs",
+          py::overload_cast<const Azure_blob_client &, const std::string &, std::string_view>(
+              &list_azure_blobs),
+          "client"_a,
+          "uri"_a,
+          "pattern"_a = "",
+          R"(
+        List all Azure blobs residing under the specified URI.
+
+        Parameters
+        ----------
+        client : AzureBlobClient
+            The client to use.
+        uri : str
+            The URI to traverse.
+        pattern : str, optional
+            The pattern to match the Azure blobs against.
+        )");
 }
 
 }  // namespace pymlio
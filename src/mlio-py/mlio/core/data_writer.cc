@@ -0,0 +1,233 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+namespace {
+
+Columnar_writer_params make_columnar_writer_params(Columnar_compression compression,
+                                                   int compression_level,
+                                                   std::size_t alignment)
+{
+    Columnar_writer_params params{};
+
+    params.compression = compression;
+    params.compression_level = compression_level;
+    params.alignment = alignment;
+
+    return params;
+}
+
+Intrusive_ptr<Columnar_writer>
+make_columnar_writer(std::string path, Columnar_writer_params params)
+{
+    return make_intrusive<Columnar_writer>(std::move(path), params);
+}
+
+Recordio_protobuf_writer_params make_recordio_protobuf_writer_params(std::size_t write_buffer_size)
+{
+    Recordio_protobuf_writer_params params{};
+
+    params.write_buffer_size = write_buffer_size;
+
+    return params;
+}
+
+Intrusive_ptr<Recordio_protobuf_writer>
+make_recordio_protobuf_writer(std::string path, Recordio_protobuf_writer_params params)
+{
+    return make_intrusive<Recordio_protobuf_writer>(std::move(path), params);
+}
+
+// Closes the writer when used as a context manager; if the block raises
+// an exception the partial file is discarded when the writer is
+// destructed.
+void py_exit(Data_writer &writer, const py::object &exc_type, const py::object &, const py::object &)
+{
+    if (exc_type.is_none()) {
+        writer.close();
+    }
+}
+
+}  // namespace
+
+void register_data_writers(py::module &m)
+{
+    py::enum_<Columnar_compression>(
+        m,
+        "ColumnarCompression",
+        "Specifies how the column chunks of a columnar file are compressed.")
+        .value("NONE", Columnar_compression::none)
+        .value("ZSTD",
+               Columnar_compression::zstd,
+               "Requires the library to be built with Zstandard support.");
+
+    py::class_<Data_writer, Intrusive_ptr<Data_writer>>(
+        m, "DataWriter", "Represents an interface for writing examples to a dataset.")
+        .def("__enter__",
+             [](Data_writer &self) -> Data_writer & {
+                 return self;
+             })
+        .def("__exit__", &py_exit)
+        .def("write_example",
+             &Data_writer::write_example,
+             "example"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Write the instances of the specified example. All examples
+            must have the same schema, except for the size of the batch
+            dimension. Padded instances are not written.
+            )")
+        .def("close",
+             &Data_writer::close,
+             py::call_guard<py::gil_scoped_release>(),
+             "Flush the buffered data and finalize the dataset.");
+
+    py::class_<Columnar_writer_params>(m,
+                                       "ColumnarWriterParams",
+                                       "Represents the optional parameters of a "
+                                       "``ColumnarWriter`` object.")
+        .def(py::init(&make_columnar_writer_params),
+             "compression"_a = Columnar_compression::none,
+             "compression_level"_a = 3,
+             "alignment"_a = 64,
+             R"(
+            Parameters
+            ----------
+            compression : ColumnarCompression, optional
+                See ``ColumnarCompression``.
+            compression_level : int, optional
+                The Zstandard compression level.
+            alignment : int, optional
+                The alignment, in bytes, of the column chunks within the
+                file. It must be a power of two.
+            )")
+        .def_readwrite("compression", &Columnar_writer_params::compression)
+        .def_readwrite("compression_level", &Columnar_writer_params::compression_level)
+        .def_readwrite("alignment", &Columnar_writer_params::alignment);
+
+    py::class_<Columnar_writer, Data_writer, Intrusive_ptr<Columnar_writer>>(
+        m,
+        "ColumnarWriter",
+        R"(
+        Represents a ``DataWriter`` that writes a dataset in the native
+        columnar format of MLIO, which can be read with
+        ``ColumnarReader``. Each written example becomes a block in which
+        every feature is stored as a contiguous, aligned chunk; only dense
+        features of numeric data types can be written.)")
+        .def(py::init<>(&make_columnar_writer),
+             "path"_a,
+             "columnar_writer_params"_a = Columnar_writer_params{},
+             R"(
+            Parameters
+            ----------
+            path : str
+                The path of the columnar file.
+            columnar_writer_params : ColumnarWriterParams, optional
+                See ``ColumnarWriterParams``.
+            )")
+        .def_property_readonly("num_instances_written",
+                               &Columnar_writer::num_instances_written,
+                               "Gets the number of instances written so far.");
+
+    m.def("write_columnar_file",
+          &write_columnar_file,
+          "path"_a,
+          "reader"_a,
+          "columnar_writer_params"_a = Columnar_writer_params{},
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+        Write all examples read from the specified reader to a columnar
+        file. The reader is reset before the first example is read.
+
+        Parameters
+        ----------
+        path : str
+            The path of the columnar file.
+        reader : DataReader
+            The reader whose examples should be written.
+        columnar_writer_params : ColumnarWriterParams, optional
+            See ``ColumnarWriterParams``.
+        )");
+
+    py::class_<Recordio_protobuf_writer_params>(m,
+                                                "RecordIOProtobufWriterParams",
+                                                "Represents the optional parameters of a "
+                                                "``RecordIOProtobufWriter`` object.")
+        .def(py::init(&make_recordio_protobuf_writer_params),
+             "write_buffer_size"_a = 0x40'0000,
+             R"(
+            Parameters
+            ----------
+            write_buffer_size : int, optional
+                The number of encoded bytes buffered before they are
+                written to the file.
+            )")
+        .def_readwrite("write_buffer_size", &Recordio_protobuf_writer_params::write_buffer_size);
+
+    py::class_<Recordio_protobuf_writer, Data_writer, Intrusive_ptr<Recordio_protobuf_writer>>(
+        m,
+        "RecordIOProtobufWriter",
+        R"(
+        Represents a ``DataWriter`` that writes an Amazon SageMaker
+        RecordIO-protobuf dataset, which can be read with
+        ``RecordIOProtobufReader``. Each written instance becomes a
+        record; the features whose names start with "label_" are written
+        to the label map of the record. Dense and COO tensors of the
+        float32, float64, and int32 data types can be written.)")
+        .def(py::init<>(&make_recordio_protobuf_writer),
+             "path"_a,
+             "recordio_protobuf_writer_params"_a = Recordio_protobuf_writer_params{},
+             R"(
+            Parameters
+            ----------
+            path : str
+                The path of the RecordIO-protobuf file.
+            recordio_protobuf_writer_params : RecordIOProtobufWriterParams, optional
+                See ``RecordIOProtobufWriterParams``.
+            )")
+        .def_property_readonly("num_records_written",
+                               &Recordio_protobuf_writer::num_records_written,
+                               "Gets the number of records written so far.");
+
+    m.def("write_recordio_protobuf_file",
+          &write_recordio_protobuf_file,
+          "path"_a,
+          "reader"_a,
+          "recordio_protobuf_writer_params"_a = Recordio_protobuf_writer_params{},
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+        Write all examples read from the specified reader to a
+        RecordIO-protobuf file. The reader is reset before the first
+        example is read.
+
+        Parameters
+        ----------
+        path : str
+            The path of the RecordIO-protobuf file.
+        reader : DataReader
+            The reader whose examples should be written.
+        recordio_protobuf_writer_params : RecordIOProtobufWriterParams, optional
+            See ``RecordIOProtobufWriterParams``.
+        )");
+}
+
+}  // namespace pymlio
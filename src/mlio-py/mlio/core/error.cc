@@ -94,6 +94,9 @@ void throw_nested_error(const std::exception &exc, const py::object &py_exc)
     catch (const Inflate_error &e) {
         set_nested_error(py_exc, e, "InflateError");
     }
+    catch (const Checksum_error &e) {
+        set_nested_error(py_exc, e, "ChecksumError");
+    }
     catch (const Stream_error &e) {
         set_nested_error(py_exc, e, "StreamError");
     }
@@ -138,6 +141,8 @@ void register_exceptions(py::module &m)
         m, "StreamError", py_mlio_error);
     register_exception<Inflate_error>(
         m, "InflateError", py_stream_error);
+    register_exception<Checksum_error>(
+        m, "ChecksumError", py_stream_error);
 
     PyObject *py_record_error = register_exception<Record_error>(
         m, "RecordError", py_mlio_error);
@@ -202,6 +207,9 @@ void register_exceptions(py::module &m)
         catch (const Inflate_error &e) {
             set_error(e, "InflateError");
         }
+        catch (const Checksum_error &e) {
+            set_error(e, "ChecksumError");
+        }
         catch (const Stream_error &e) {
             set_error(e, "StreamError");
         }
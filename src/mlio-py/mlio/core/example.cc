@@ -17,6 +17,12 @@
 
 #include <pybind11/stl_bind.h>
 
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace py = pybind11;
 
 using namespace mlio;
@@ -25,7 +31,7 @@ using namespace pybind11::literals;
 namespace pymlio {
 namespace {
 
-Intrusive_ptr<Tensor> get_feature(Example &example, const std::string &name)
+Intrusive_ptr<Tensor> get_feature(Example &example, std::string_view name)
 {
     Intrusive_ptr<Tensor> tensor = example.find_feature(name);
     if (tensor == nullptr) {
@@ -37,11 +43,45 @@ Intrusive_ptr<Tensor> get_feature(Example &example, const std::string &name)
 
 Intrusive_ptr<Tensor> get_feature(Example &example, std::size_t index)
 {
-    if (index >= example.features().size()) {
+    if (index >= example.schema().attributes().size()) {
         throw py::key_error{"The index is out of range."};
     }
 
-    return example.features()[index];
+    return example.feature(index);
+}
+
+Intrusive_ptr<Example>
+py_concat_examples(const std::vector<Intrusive_ptr<Example>> &examples, Tensor_pool *pool)
+{
+    py::gil_scoped_release rel_gil;
+
+    return concat_examples(examples, pool);
+}
+
+Example_conversion_params
+make_example_conversion_params(std::vector<std::string> features,
+                               std::map<std::string, Data_type, std::less<>> data_types,
+                               std::optional<Data_type> default_data_type,
+                               bool column_major,
+                               std::optional<Sparse_tensor_format> sparse_tensor_format)
+{
+    Example_conversion_params params{};
+
+    params.features = std::move(features);
+    params.data_types = std::move(data_types);
+    params.default_data_type = default_data_type;
+    params.column_major = column_major;
+    params.sparse_tensor_format = sparse_tensor_format;
+
+    return params;
+}
+
+Intrusive_ptr<Example>
+py_convert_example(const Example &example, const Example_conversion_params &params)
+{
+    py::gil_scoped_release rel_gil;
+
+    return convert_example(example, params);
 }
 
 }  // namespace
@@ -64,17 +104,17 @@ void register_example(py::module &m)
             )")
         .def("__len__",
              [](Example &self) {
-                 return self.features().size();
+                 return self.schema().attributes().size();
              })
-        .def("__getitem__", py::overload_cast<Example &, const std::string &>(&get_feature))
+        .def("__getitem__", py::overload_cast<Example &, std::string_view>(&get_feature))
         .def("__getitem__", py::overload_cast<Example &, std::size_t>(&get_feature))
         .def("__contains__",
-             [](Example &self, const std::string &name) {
+             [](Example &self, std::string_view name) {
                  return self.schema().get_index(name) != std::nullopt;
              })
         .def("__contains__",
              [](Example &self, std::size_t index) {
-                 return index < self.features().size();
+                 return index < self.schema().attributes().size();
              })
         .def("__iter__",
              [](Example &self) {
@@ -91,6 +131,104 @@ void register_example(py::module &m)
             batch read from a dataset if the size of the dataset is not
             evenly divisible by the batch size.
             )");
+
+    py::class_<Tensor_pool, Intrusive_ptr<Tensor_pool>>(
+        m, "TensorPool", "Represents a pool of recycled buffers for tensors.")
+        .def(py::init<std::size_t, bool>(),
+             "capacity"_a,
+             "huge_pages"_a = false,
+             R"(
+            Parameters
+            ----------
+            capacity : int
+                The maximum total size, in bytes, of the buffers held in
+                the pool.
+            huge_pages : bool, optional
+                A boolean value indicating whether the large buffers
+                should be backed by transparent huge pages.
+            )")
+        .def("stats", &Tensor_pool::stats, "Returns the usage statistics of the pool.")
+        .def("clear", &Tensor_pool::clear, "Frees the buffers held in the pool.");
+
+    py::class_<Example_conversion_params>(
+        m,
+        "ExampleConversionParams",
+        "Specifies how ``convert_example()`` converts the features of an example.")
+        .def(py::init(&make_example_conversion_params),
+             "features"_a = std::vector<std::string>{},
+             "data_types"_a = std::map<std::string, Data_type, std::less<>>{},
+             "default_data_type"_a = std::nullopt,
+             "column_major"_a = false,
+             "sparse_tensor_format"_a = std::nullopt,
+             R"(
+            Parameters
+            ----------
+            features : list of strs, optional
+                The names of the features to return, in order. If empty,
+                all features are returned.
+            data_types : map of str and DataType, optional
+                The data types to cast the values of the features to, keyed
+                by feature name.
+            default_data_type : DataType, optional
+                The data type to cast the values of the numeric features
+                that are not listed in `data_types` to.
+            column_major : bool, optional
+                A boolean value indicating whether to lay out the dense
+                features in column-major order.
+            sparse_tensor_format : SparseTensorFormat, optional
+                The format to convert the sparse features to. Only
+                two-dimensional features can be converted to CSR.
+            )")
+        .def_readwrite("features", &Example_conversion_params::features)
+        .def_readwrite("data_types", &Example_conversion_params::data_types)
+        .def_readwrite("default_data_type", &Example_conversion_params::default_data_type)
+        .def_readwrite("column_major", &Example_conversion_params::column_major)
+        .def_readwrite("sparse_tensor_format", &Example_conversion_params::sparse_tensor_format);
+
+    m.def("convert_example",
+          &py_convert_example,
+          "example"_a,
+          "params"_a,
+          R"(
+        Returns an example whose features are the features of `example`
+        cast, laid out, and formatted as specified by `params`.
+
+        The features are converted in parallel in native code without
+        holding the GIL. The features that need no conversion are shared
+        with `example` instead of being copied.
+        )");
+
+    m.def("slice_example",
+          &slice_example,
+          "example"_a,
+          "begin"_a,
+          "end"_a,
+          R"(
+        Returns an example that holds the instances in the range [`begin`,
+        `end`) of the batch dimension of `example`.
+
+        The dense features and the data and index arrays of the CSR
+        features of the returned example share the memory of the features
+        of `example`.
+        )");
+
+    m.def("concat_examples",
+          &py_concat_examples,
+          "examples"_a,
+          "pool"_a = nullptr,
+          R"(
+        Returns an example whose features are the features of `examples`
+        concatenated along the batch dimension.
+
+        Parameters
+        ----------
+        examples : list of examples
+            The examples to concatenate; they must have the same schema
+            except for the batch dimension and only the last one can have
+            a padding.
+        pool : TensorPool, optional
+            The pool from which the buffers of the features are taken.
+        )");
 }
 
 }  // namespace pymlio
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+namespace {
+
+Intrusive_ptr<Gcs_client> py_make_gcs_client(const std::string &credentials_file,
+                                             bool anonymous,
+                                             const Range_read_params &range_read_params,
+                                             Intrusive_ptr<S3_object_cache> object_cache,
+                                             std::size_t max_connections,
+                                             std::size_t stall_timeout_ms,
+                                             std::size_t max_attempts,
+                                             const std::string &endpoint_override)
+{
+    Gcs_client_options opts{};
+    opts.credentials_file = credentials_file;
+    opts.anonymous = anonymous;
+    opts.range_read_params = range_read_params;
+    opts.object_cache = std::move(object_cache);
+    opts.max_connections = max_connections;
+    opts.stall_timeout = std::chrono::milliseconds{stall_timeout_ms};
+    opts.max_attempts = max_attempts;
+    opts.endpoint_override = endpoint_override;
+
+    return make_gcs_client(opts);
+}
+
+}  // namespace
+
+void register_gcs_client(py::module &m)
+{
+    py::class_<Gcs_client, Intrusive_ptr<Gcs_client>>(
+        m, "GcsClient", "Represents a client to access Google Cloud Storage.")
+        .def(py::init<>(&py_make_gcs_client),
+             "credentials_file"_a = "",
+             "anonymous"_a = false,
+             "range_read_params"_a = Range_read_params{},
+             "object_cache"_a = nullptr,
+             "max_connections"_a = 0,
+             "stall_timeout_ms"_a = 0,
+             "max_attempts"_a = 0,
+             "endpoint_override"_a = "",
+             R"(
+            Parameters
+            ----------
+            credentials_file : str, optional
+                The path to the JSON key file of a service account. If not
+                specified, the Application Default Credentials are used.
+            anonymous : bool
+                A boolean value indicating whether to send the requests
+                without credentials.
+            range_read_params : RangeReadParams
+                The parameters for reading the objects with concurrent
+                byte-range GET requests.
+            object_cache : S3ObjectCache, optional
+                The local cache through which the objects are read.
+            max_connections : int
+                The maximum number of pooled connections. If zero, the
+                default of the Google Cloud C++ client library is used.
+            stall_timeout_ms : int
+                The time after which a transfer that makes no progress is
+                retried.
+            max_attempts : int
+                The maximum number of attempts per request.
+            endpoint_override : str, optional
+                The endpoint to use instead of Google Cloud Storage.
+            )");
+}
+
+}  // namespace pymlio
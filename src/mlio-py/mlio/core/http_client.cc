@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+namespace {
+
+Intrusive_ptr<Http_client> py_make_http_client(bool use_https,
+                                               std::vector<std::string> headers,
+                                               const Range_read_params &range_read_params,
+                                               Intrusive_ptr<S3_object_cache> object_cache,
+                                               std::size_t max_connections,
+                                               std::size_t connect_timeout_ms,
+                                               std::size_t stall_timeout_ms,
+                                               std::size_t max_attempts,
+                                               bool verify_peer)
+{
+    Http_client_options opts{};
+    opts.use_https = use_https;
+    opts.headers = std::move(headers);
+    opts.range_read_params = range_read_params;
+    opts.object_cache = std::move(object_cache);
+    opts.max_connections = max_connections;
+    opts.connect_timeout = std::chrono::milliseconds{connect_timeout_ms};
+    opts.stall_timeout = std::chrono::milliseconds{stall_timeout_ms};
+    opts.max_attempts = max_attempts;
+    opts.verify_peer = verify_peer;
+
+    return make_http_client(opts);
+}
+
+}  // namespace
+
+void register_http_client(py::module &m)
+{
+    py::class_<Http_client, Intrusive_ptr<Http_client>>(
+        m, "HttpClient", "Represents a client to read objects from an HTTP server.")
+        .def(py::init<>(&py_make_http_client),
+             "use_https"_a = true,
+             "headers"_a = std::vector<std::string>{},
+             "range_read_params"_a = Range_read_params{},
+             "object_cache"_a = nullptr,
+             "max_connections"_a = 64,
+             "connect_timeout_ms"_a = 0,
+             "stall_timeout_ms"_a = 0,
+             "max_attempts"_a = 3,
+             "verify_peer"_a = true,
+             R"(
+            Parameters
+            ----------
+            use_https : bool
+                A boolean value indicating whether the objects are addressed
+                by "https://" or by "http://" URIs.
+            headers : list of strs, optional
+                The headers to send with each request such as
+                "Authorization: Bearer <token>".
+            range_read_params : RangeReadParams
+                The parameters for reading the objects with concurrent
+                byte-range GET requests.
+            object_cache : S3ObjectCache, optional
+                The local cache through which the objects are read.
+            max_connections : int
+                The maximum number of keep-alive connections.
+            connect_timeout_ms : int
+                The timeout for establishing a connection.
+            stall_timeout_ms : int
+                The time after which a transfer that makes no progress is
+                retried.
+            max_attempts : int
+                The maximum number of attempts per request.
+            verify_peer : bool
+                A boolean value indicating whether to verify the certificate
+                of the server.
+            )");
+}
+
+}  // namespace pymlio
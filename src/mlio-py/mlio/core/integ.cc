@@ -15,6 +15,12 @@
 
 #include "module.h"
 
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <dlpack/dlpack.h>
 
 namespace py = pybind11;
@@ -25,10 +31,8 @@ using namespace pybind11::literals;
 namespace pymlio {
 namespace {
 
-py::capsule to_dlpack_capsule(Tensor &tensor, std::size_t version)
+py::capsule wrap_dlpack_capsule(::DLManagedTensor *managed_tensor)
 {
-    const void *managed_tensor = as_dlpack(tensor, version);
-
     return py::capsule(managed_tensor, "dltensor", [](::PyObject *obj) {
         auto *ptr = ::PyCapsule_GetPointer(obj, "dltensor");
         if (ptr != nullptr) {
@@ -44,6 +48,130 @@ py::capsule to_dlpack_capsule(Tensor &tensor, std::size_t version)
     });
 }
 
+py::capsule to_dlpack_capsule(Tensor &tensor, std::size_t version)
+{
+    return wrap_dlpack_capsule(as_dlpack(tensor, version));
+}
+
+struct Dlpack_deleter {
+    void operator()(::DLManagedTensor *managed_tensor) const noexcept
+    {
+        managed_tensor->deleter(managed_tensor);
+    }
+};
+
+using Dlpack_ptr = std::unique_ptr<::DLManagedTensor, Dlpack_deleter>;
+
+py::list to_dlpack_component_capsules(Tensor &tensor, std::size_t version)
+{
+    std::vector<Dlpack_ptr> managed_tensors{};
+    for (::DLManagedTensor *managed_tensor : as_dlpack_components(tensor, version)) {
+        managed_tensors.emplace_back(managed_tensor);
+    }
+
+    py::list capsules{};
+    for (Dlpack_ptr &managed_tensor : managed_tensors) {
+        capsules.append(wrap_dlpack_capsule(managed_tensor.get()));
+
+        // The capsule owns the tensor from now on.
+        managed_tensor.release();
+    }
+    return capsules;
+}
+
+// Reads examples from a data reader and converts their features to
+// DLPack capsules. Everything up to the construction of the capsules,
+// including the optional conversion of the features, is done without
+// holding the GIL, which is then acquired only once per example instead
+// of once per feature.
+class Py_dlpack_iterator {
+public:
+    explicit Py_dlpack_iterator(Data_reader &reader,
+                                py::object parent,
+                                std::optional<std::vector<std::string>> features,
+                                std::size_t version,
+                                std::optional<Example_conversion_params> conversion)
+        : reader_{&reader}
+        , parent_{std::move(parent)}
+        , features_{std::move(features)}
+        , version_{version}
+        , conversion_{std::move(conversion)}
+    {}
+
+public:
+    py::dict next()
+    {
+        std::vector<std::pair<std::string, Dlpack_ptr>> tensors{};
+
+        bool has_example = false;
+        {
+            py::gil_scoped_release rel_gil;
+
+            Intrusive_ptr<Example> example = reader_->read_example();
+            if (example != nullptr) {
+                has_example = true;
+
+                if (conversion_) {
+                    example = convert_example(*example, *conversion_);
+                }
+
+                tensors = as_dlpack_tensors(*example);
+            }
+        }
+
+        if (!has_example) {
+            throw py::stop_iteration();
+        }
+
+        py::dict dct{};
+        for (auto &[name, managed_tensor] : tensors) {
+            dct[py::str(name)] = wrap_dlpack_capsule(managed_tensor.get());
+
+            // The capsule owns the tensor from now on.
+            managed_tensor.release();
+        }
+        return dct;
+    }
+
+private:
+    std::vector<std::pair<std::string, Dlpack_ptr>> as_dlpack_tensors(const Example &example) const
+    {
+        std::vector<std::pair<std::string, Dlpack_ptr>> tensors{};
+
+        if (features_ == std::nullopt) {
+            const std::vector<Attribute> &attrs = example.schema().attributes();
+
+            tensors.reserve(attrs.size());
+
+            for (std::size_t i = 0; i < attrs.size(); i++) {
+                tensors.emplace_back(attrs[i].name(),
+                                     Dlpack_ptr{as_dlpack(*example.features()[i], version_)});
+            }
+        }
+        else {
+            tensors.reserve(features_->size());
+
+            for (const std::string &name : *features_) {
+                Intrusive_ptr<Tensor> tensor = example.find_feature(name);
+                if (tensor == nullptr) {
+                    throw std::invalid_argument{"The example has no feature named '" + name +
+                                                "'."};
+                }
+
+                tensors.emplace_back(name, Dlpack_ptr{as_dlpack(*tensor, version_)});
+            }
+        }
+
+        return tensors;
+    }
+
+    Data_reader *reader_;
+    py::object parent_;
+    std::optional<std::vector<std::string>> features_;
+    std::size_t version_;
+    std::optional<Example_conversion_params> conversion_;
+};
+
 }  // namespace
 
 void register_integ(py::module &m)
@@ -53,6 +181,39 @@ void register_integ(py::module &m)
           "tensor"_a,
           "version"_a,
           "Wraps the specified ``Tensor`` as a DLManagedTensor.");
+
+    m.def("as_dlpack_components",
+          &to_dlpack_component_capsules,
+          "tensor"_a,
+          "version"_a,
+          "Wraps the component arrays of the specified sparse ``Tensor`` as "
+          "one-dimensional DLManagedTensors without copying them.");
+
+    py::class_<Py_dlpack_iterator>(m, "DLPackIterator")
+        .def("__iter__",
+             [](Py_dlpack_iterator &it) -> Py_dlpack_iterator & {
+                 return it;
+             })
+        .def("__next__", &Py_dlpack_iterator::next);
+
+    m.def(
+        "iter_dlpack",
+        [](py::object &reader,
+           std::optional<std::vector<std::string>> features,
+           std::size_t version,
+           std::optional<Example_conversion_params> conversion) {
+            return Py_dlpack_iterator(reader.cast<Data_reader &>(),
+                                      reader,
+                                      std::move(features),
+                                      version,
+                                      std::move(conversion));
+        },
+        "data_reader"_a,
+        "features"_a = std::nullopt,
+        "version"_a = DLPACK_VERSION,
+        "conversion"_a = std::nullopt,
+        "Returns an iterator that reads the examples from the specified "
+        "``DataReader`` as dictionaries of DLManagedTensors.");
 }
 
 }  // namespace pymlio
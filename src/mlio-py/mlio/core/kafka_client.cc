@@ -0,0 +1,150 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+namespace {
+
+Intrusive_ptr<Kafka_client>
+py_make_kafka_client(std::string bootstrap_servers,
+                     std::string group_id,
+                     std::size_t fetch_max_bytes,
+                     std::size_t partition_fetch_max_bytes,
+                     std::size_t prefetch_bytes,
+                     std::size_t fetch_wait_max_ms,
+                     std::size_t timeout_ms,
+                     std::unordered_map<std::string, std::string> config)
+{
+    Kafka_client_options opts{};
+    opts.bootstrap_servers = std::move(bootstrap_servers);
+    opts.group_id = std::move(group_id);
+    opts.fetch_max_bytes = fetch_max_bytes;
+    opts.partition_fetch_max_bytes = partition_fetch_max_bytes;
+    opts.prefetch_bytes = prefetch_bytes;
+    opts.fetch_wait_max = std::chrono::milliseconds{fetch_wait_max_ms};
+    opts.timeout = std::chrono::milliseconds{timeout_ms};
+    opts.config = std::move(config);
+
+    return make_kafka_client(std::move(opts));
+}
+
+void py_commit_offsets(const Kafka_client &client,
+                       const std::string &topic,
+                       const std::map<std::int32_t, std::int64_t> &offsets)
+{
+    std::vector<Kafka_offset> v{};
+    v.reserve(offsets.size());
+
+    for (auto [partition, offset] : offsets) {
+        v.push_back(Kafka_offset{partition, offset});
+    }
+
+    py::gil_scoped_release no_gil{};
+
+    client.commit_offsets(topic, v);
+}
+
+}  // namespace
+
+void register_kafka_client(py::module &m)
+{
+    py::class_<Kafka_client, Intrusive_ptr<Kafka_client>>(
+        m, "KafkaClient", "Represents a client to read the partitions of Kafka topics.")
+        .def(py::init<>(&py_make_kafka_client),
+             "bootstrap_servers"_a,
+             "group_id"_a = "",
+             "fetch_max_bytes"_a = 0x4000000,
+             "partition_fetch_max_bytes"_a = 0x800000,
+             "prefetch_bytes"_a = 0x4000000,
+             "fetch_wait_max_ms"_a = 100,
+             "timeout_ms"_a = 60000,
+             "config"_a = std::unordered_map<std::string, std::string>{},
+             R"(
+            Parameters
+            ----------
+            bootstrap_servers : str
+                The comma-separated list of "host:port" pairs of the brokers
+                to bootstrap from.
+            group_id : str, optional
+                The consumer group whose offsets are read and committed.
+            fetch_max_bytes : int
+                The maximum number of bytes a broker returns for one fetch
+                request.
+            partition_fetch_max_bytes : int
+                The maximum number of bytes a broker returns per partition
+                for one fetch request.
+            prefetch_bytes : int
+                The maximum number of bytes fetched ahead of the reader per
+                partition.
+            fetch_wait_max_ms : int
+                The time a broker waits for data to fill a fetch response.
+            timeout_ms : int
+                The time to wait for the metadata and offset requests and
+                for the messages of a partition. A followed partition that
+                receives no new message within this time is considered
+                ended.
+            config : dict of strs, optional
+                The additional librdkafka configuration properties.
+            )")
+        .def("num_partitions",
+             &Kafka_client::num_partitions,
+             py::call_guard<py::gil_scoped_release>(),
+             "topic"_a,
+             "Returns the number of partitions of the topic.")
+        .def("watermark_offsets",
+             &Kafka_client::watermark_offsets,
+             py::call_guard<py::gil_scoped_release>(),
+             "topic"_a,
+             "partition"_a,
+             "Returns the offset of the first retained message of the partition and "
+             "the offset right after its last message.")
+        .def("committed_offsets",
+             &Kafka_client::committed_offsets,
+             py::call_guard<py::gil_scoped_release>(),
+             "topic"_a,
+             "Returns the offsets committed by the consumer group, indexed by partition.")
+        .def("commit_offsets",
+             &py_commit_offsets,
+             "topic"_a,
+             "offsets"_a,
+             R"(
+            Commits the offsets for the consumer group.
+
+            Parameters
+            ----------
+            topic : str
+                The topic of the partitions.
+            offsets : dict of ints
+                The offset of the next message to consume, keyed by
+                partition.
+            )");
+}
+
+}  // namespace pymlio
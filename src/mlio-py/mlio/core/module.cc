@@ -28,14 +28,79 @@ PYBIND11_MODULE(_core, m)
         &mlio::supports_s3,
         "Return a boolean value indicating whether the library was built with Amazon S3 support.");
 
+    m.def("supports_s3_crt",
+          &mlio::supports_s3_crt,
+          "Return a boolean value indicating whether the library was built with the Amazon S3 "
+          "client of the AWS Common Runtime.");
+
+    m.def("supports_gcs",
+          &mlio::supports_gcs,
+          "Return a boolean value indicating whether the library was built with Google Cloud "
+          "Storage support.");
+
+    m.def("supports_azure",
+          &mlio::supports_azure,
+          "Return a boolean value indicating whether the library was built with Azure Blob "
+          "Storage support.");
+
+    m.def("supports_http",
+          &mlio::supports_http,
+          "Return a boolean value indicating whether the library was built with HTTP(S) data "
+          "store support.");
+
+    m.def("supports_kafka",
+          &mlio::supports_kafka,
+          "Return a boolean value indicating whether the library was built with Kafka data store "
+          "support.");
+
     m.def(
         "supports_image_reader",
         &mlio::supports_image_reader,
         "Return a boolean value indicating whether the library was built with image reader support.");
 
+    m.def(
+        "supports_bzip2",
+        &mlio::supports_bzip2,
+        "Return a boolean value indicating whether the library was built with bzip2 support.");
+
+    m.def(
+        "supports_zstd",
+        &mlio::supports_zstd,
+        "Return a boolean value indicating whether the library was built with Zstandard support.");
+
+    m.def(
+        "supports_lz4",
+        &mlio::supports_lz4,
+        "Return a boolean value indicating whether the library was built with LZ4 support.");
+
+    m.def(
+        "supports_isal",
+        &mlio::supports_isal,
+        "Return a boolean value indicating whether the library was built with Intel ISA-L support.");
+
+    m.def(
+        "supports_parquet_reader",
+        &mlio::supports_parquet_reader,
+        "Return a boolean value indicating whether the library was built with native Parquet reader support.");
+
+    m.def(
+        "supports_orc_reader",
+        &mlio::supports_orc_reader,
+        "Return a boolean value indicating whether the library was built with native ORC reader support.");
+
+    m.def(
+        "supports_cuda",
+        &mlio::supports_cuda,
+        "Return a boolean value indicating whether the library was built with CUDA support.");
+
     register_exceptions(m);
     register_logging(m);
+    register_tracing(m);
     register_s3_client(m);
+    register_gcs_client(m);
+    register_azure_blob_client(m);
+    register_http_client(m);
+    register_kafka_client(m);
     register_memory_slice(m);
     register_device_array(m);
     register_tensors(m);
@@ -45,7 +110,9 @@ PYBIND11_MODULE(_core, m)
     register_record_readers(m);
     register_schema(m);
     register_example(m);
+    register_column_statistics(m);
     register_data_readers(m);
+    register_data_writers(m);
 }
 
 }  // namespace pymlio
@@ -34,8 +34,18 @@ void register_exceptions(pybind11::module &m);
 
 void register_logging(pybind11::module &m);
 
+void register_tracing(pybind11::module &m);
+
 void register_s3_client(pybind11::module &m);
 
+void register_gcs_client(pybind11::module &m);
+
+void register_azure_blob_client(pybind11::module &m);
+
+void register_http_client(pybind11::module &m);
+
+void register_kafka_client(pybind11::module &m);
+
 void register_memory_slice(pybind11::module &m);
 
 void register_device_array(pybind11::module &m);
@@ -54,6 +64,10 @@ void register_schema(pybind11::module &m);
 
 void register_example(pybind11::module &m);
 
+void register_column_statistics(pybind11::module &m);
+
 void register_data_readers(pybind11::module &m);
 
+void register_data_writers(pybind11::module &m);
+
 }  // namespace pymlio
@@ -15,6 +15,7 @@
 
 #include "py_device_array.h"
 
+#include <stdexcept>
 #include <string>
 
 #include "module.h"
@@ -67,6 +68,13 @@ namespace {
 
 py::buffer_info to_py_buffer(Py_device_array &arr)
 {
+    // The buffer protocol requires the data to be accessible from the
+    // host; device tensors should be consumed through DLPack.
+    if (arr.device().kind() != Device_kind::cpu()) {
+        throw std::invalid_argument{
+            "The array is not stored in host memory. Use DLPack to access it."};
+    }
+
     auto size = static_cast<py::ssize_t>(arr.size());
 
     std::size_t item_size{};
@@ -131,6 +139,19 @@ py::buffer_info to_py_buffer(Py_device_array &arr)
         item_size = sizeof(PyObject *);
         fmt = "O";
         break;
+    case Data_type::bfloat16:
+        // The buffer protocol has no bfloat16 format; expose the raw
+        // bits that can be reinterpreted, e.g. with ml_dtypes.bfloat16.
+        item_size = sizeof(std::uint16_t);
+        fmt = "H";
+        break;
+    case Data_type::timestamp:
+    case Data_type::date:
+        // The buffer protocol has no datetime format either; the values
+        // are viewed as datetime64 by mlio.integ.numpy.
+        item_size = sizeof(std::int64_t);
+        fmt = "q";
+        break;
     }
 
     auto is = static_cast<py::ssize_t>(item_size);
@@ -161,6 +182,12 @@ void register_device_array(py::module &m)
                 return Device_kind::cpu();
             },
             "Gets an Instance for the CPU Device kind.")
+        .def_property_readonly_static(
+            "cuda",
+            [](py::object &) {
+                return Device_kind::cuda();
+            },
+            "Gets an Instance for the CUDA Device kind.")
         .def_property_readonly("name", &Device_kind::name, "Gets the name of the Device kind.");
 
     py::class_<Device>(
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "py_file_object.h"
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace py = pybind11;
+
+using namespace mlio;
+
+namespace pymlio {
+namespace {
+
+// Reads from a Python file object. Each read acquires the GIL once and
+// fills the whole destination; this way the size of the reads of the
+// caller determines how often we contend for the GIL.
+class Py_file_object_reader final : public Input_stream_base {
+public:
+    explicit Py_file_object_reader(py::object file);
+
+    Py_file_object_reader(const Py_file_object_reader &) = delete;
+
+    Py_file_object_reader &operator=(const Py_file_object_reader &) = delete;
+
+    Py_file_object_reader(Py_file_object_reader &&) = delete;
+
+    Py_file_object_reader &operator=(Py_file_object_reader &&) = delete;
+
+    ~Py_file_object_reader() final;
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    void seek(std::size_t position) final;
+
+    void close() noexcept final;
+
+    std::size_t size() const final;
+
+    std::size_t position() const final;
+
+    bool closed() const noexcept final
+    {
+        return closed_;
+    }
+
+    bool seekable() const noexcept final
+    {
+        return seekable_;
+    }
+
+private:
+    std::size_t read_into(stdx::span<char> bits);
+
+    std::size_t read_copy(stdx::span<char> bits);
+
+    void check_if_closed() const;
+
+    py::object file_;
+    // The readinto() method of the file object if it has one; it lets
+    // native file objects (e.g. io.BufferedReader) write directly into
+    // our buffer, and with the GIL released while they wait for I/O.
+    py::object readinto_{};
+    py::object read_{};
+    bool seekable_{};
+    mutable std::optional<std::size_t> size_{};
+    std::size_t position_{};
+    bool closed_{};
+};
+
+Py_file_object_reader::Py_file_object_reader(py::object file) : file_{std::move(file)}
+{
+    if (py::hasattr(file_, "readinto")) {
+        readinto_ = file_.attr("readinto");
+    }
+    else {
+        read_ = file_.attr("read");
+    }
+
+    if (py::hasattr(file_, "seekable")) {
+        seekable_ = file_.attr("seekable")().cast<bool>();
+    }
+
+    if (seekable_) {
+        position_ = file_.attr("tell")().cast<std::size_t>();
+    }
+}
+
+Py_file_object_reader::~Py_file_object_reader()
+{
+    // The interpreter might have already been finalized if the stream
+    // is destroyed at exit.
+    if (::Py_IsInitialized() == 0) {
+        readinto_.release();
+        read_.release();
+        file_.release();
+
+        return;
+    }
+
+    // The stream can be destroyed on any thread of the pipeline.
+    py::gil_scoped_acquire acq_gil{};
+
+    readinto_ = {};
+    read_ = {};
+    file_ = {};
+}
+
+std::size_t Py_file_object_reader::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    auto bits = as_span<char>(destination);
+    if (bits.empty()) {
+        return 0;
+    }
+
+    py::gil_scoped_acquire acq_gil{};
+
+    std::size_t num_bytes_read = 0;
+
+    // Unlike a regular file, a file object can return fewer bytes than
+    // requested before reaching its end; keep reading while we hold
+    // the GIL.
+    while (num_bytes_read < bits.size()) {
+        auto remaining = bits.subspan(num_bytes_read);
+
+        std::size_t num_bytes = readinto_ ? read_into(remaining) : read_copy(remaining);
+        if (num_bytes == 0) {
+            break;
+        }
+
+        num_bytes_read += num_bytes;
+    }
+
+    position_ += num_bytes_read;
+
+    return num_bytes_read;
+}
+
+std::size_t Py_file_object_reader::read_into(stdx::span<char> bits)
+{
+    ::PyObject *view =
+        ::PyMemoryView_FromMemory(bits.data(), static_cast<py::ssize_t>(bits.size()), PyBUF_WRITE);
+    if (view == nullptr) {
+        throw py::error_already_set();
+    }
+
+    auto holder = py::reinterpret_steal<py::object>(view);
+
+    py::object result = readinto_(holder);
+
+    // Make sure that the file object cannot write into the buffer once
+    // we return.
+    holder.attr("release")();
+
+    // A non-blocking file object returns None if no data is available.
+    if (result.is_none()) {
+        throw Stream_error{"The file object has no data available to read."};
+    }
+
+    auto num_bytes_read = result.cast<std::size_t>();
+    if (num_bytes_read > bits.size()) {
+        throw Stream_error{fmt::format(
+            "The file object has returned {0:n} bytes while {1:n} bytes were requested.",
+            num_bytes_read,
+            bits.size())};
+    }
+
+    return num_bytes_read;
+}
+
+std::size_t Py_file_object_reader::read_copy(stdx::span<char> bits)
+{
+    py::object result = read_(bits.size());
+    if (result.is_none()) {
+        throw Stream_error{"The file object has no data available to read."};
+    }
+
+    py::buffer_info info = py::reinterpret_borrow<py::buffer>(result).request();
+
+    auto num_bytes_read = static_cast<std::size_t>(info.size * info.itemsize);
+    if (num_bytes_read > bits.size()) {
+        throw Stream_error{fmt::format(
+            "The file object has returned {0:n} bytes while {1:n} bytes were requested.",
+            num_bytes_read,
+            bits.size())};
+    }
+
+    std::memcpy(bits.data(), info.ptr, num_bytes_read);
+
+    return num_bytes_read;
+}
+
+void Py_file_object_reader::seek(std::size_t position)
+{
+    check_if_closed();
+
+    if (!seekable_) {
+        throw Not_supported_error{"The input stream is not seekable."};
+    }
+
+    py::gil_scoped_acquire acq_gil{};
+
+    file_.attr("seek")(position);
+
+    position_ = position;
+}
+
+void Py_file_object_reader::close() noexcept
+{
+    if (closed_) {
+        return;
+    }
+
+    closed_ = true;
+
+    if (::Py_IsInitialized() == 0) {
+        return;
+    }
+
+    py::gil_scoped_acquire acq_gil{};
+
+    try {
+        file_.attr("close")();
+    }
+    catch (const py::error_already_set &) {
+        ::PyErr_Clear();
+    }
+}
+
+std::size_t Py_file_object_reader::size() const
+{
+    check_if_closed();
+
+    if (!seekable_) {
+        return Input_stream_base::size();
+    }
+
+    if (size_ == std::nullopt) {
+        py::gil_scoped_acquire acq_gil{};
+
+        // Seek to the end and back; file objects have no size attribute.
+        auto size = file_.attr("seek")(0, 2).cast<std::size_t>();
+
+        file_.attr("seek")(position_);
+
+        size_ = size;
+    }
+
+    return *size_;
+}
+
+std::size_t Py_file_object_reader::position() const
+{
+    check_if_closed();
+
+    if (!seekable_) {
+        return Input_stream_base::position();
+    }
+
+    return position_;
+}
+
+void Py_file_object_reader::check_if_closed() const
+{
+    if (closed_) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+// Reads ahead a Py_file_object_reader on a dedicated thread. The thread
+// might wait for the GIL inside the file object, so we release the GIL,
+// if held, before stopping it.
+// The prefetching thread acquires the GIL to read from the file object;
+// a call that waits for that thread must not hold the GIL.
+class Gil_release_if_held {
+public:
+    Gil_release_if_held()
+    {
+        if (::Py_IsInitialized() != 0 && ::PyGILState_Check() != 0) {
+            rel_gil_.emplace();
+        }
+    }
+
+private:
+    std::optional<py::gil_scoped_release> rel_gil_{};
+};
+
+class Py_file_object_stream final : public Input_stream {
+public:
+    explicit Py_file_object_stream(Intrusive_ptr<Input_stream> inner) noexcept
+        : inner_{std::move(inner)}
+    {}
+
+    Py_file_object_stream(const Py_file_object_stream &) = delete;
+
+    Py_file_object_stream &operator=(const Py_file_object_stream &) = delete;
+
+    Py_file_object_stream(Py_file_object_stream &&) = delete;
+
+    Py_file_object_stream &operator=(Py_file_object_stream &&) = delete;
+
+    ~Py_file_object_stream() final;
+
+    std::size_t read(Mutable_memory_span destination) final
+    {
+        Gil_release_if_held rel_gil{};
+
+        return inner_->read(destination);
+    }
+
+    Memory_slice read(std::size_t size) final
+    {
+        Gil_release_if_held rel_gil{};
+
+        return inner_->read(size);
+    }
+
+    void seek(std::size_t position) final
+    {
+        Gil_release_if_held rel_gil{};
+
+        inner_->seek(position);
+    }
+
+    void close() noexcept final;
+
+    std::size_t size() const final
+    {
+        Gil_release_if_held rel_gil{};
+
+        return inner_->size();
+    }
+
+    std::size_t position() const final
+    {
+        Gil_release_if_held rel_gil{};
+
+        return inner_->position();
+    }
+
+    bool closed() const noexcept final
+    {
+        return inner_->closed();
+    }
+
+    bool seekable() const noexcept final
+    {
+        return inner_->seekable();
+    }
+
+    bool supports_zero_copy() const noexcept final
+    {
+        return false;
+    }
+
+private:
+    Intrusive_ptr<Input_stream> inner_;
+};
+
+Py_file_object_stream::~Py_file_object_stream()
+{
+    Gil_release_if_held rel_gil{};
+
+    inner_ = {};
+}
+
+void Py_file_object_stream::close() noexcept
+{
+    Gil_release_if_held rel_gil{};
+
+    inner_->close();
+}
+
+}  // namespace
+
+Intrusive_ptr<Input_stream>
+make_file_object_stream(py::object file, std::size_t block_size, std::size_t prefetch_depth)
+{
+    auto stream = make_intrusive<Py_file_object_reader>(std::move(file));
+    if (prefetch_depth == 0) {
+        return std::move(stream);
+    }
+
+    Prefetch_params params{};
+    params.chunk_size = block_size;
+    params.depth = prefetch_depth;
+
+    auto prefetcher = make_intrusive<Prefetching_input_stream>(std::move(stream), params);
+
+    return make_intrusive<Py_file_object_stream>(std::move(prefetcher));
+}
+
+}  // namespace pymlio
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <pybind11/pybind11.h>
+
+#include <mlio.h>
+
+namespace pymlio {
+
+// Wraps the specified Python file object (e.g. an fsspec file) as an
+// input stream. If prefetch_depth is greater than zero, the file object
+// is read in blocks of block_size bytes on a dedicated thread so that
+// the pipeline acquires the GIL once per block instead of once per
+// read; otherwise it is read on the calling thread. Must be called with
+// the GIL held.
+mlio::Intrusive_ptr<mlio::Input_stream> make_file_object_stream(pybind11::object file,
+                                                                std::size_t block_size,
+                                                                std::size_t prefetch_depth);
+
+}  // namespace pymlio
@@ -15,7 +15,10 @@
 
 #include "module.h"
 
+#include <chrono>
+#include <cstddef>
 #include <string>
+#include <utility>
 
 namespace py = pybind11;
 
@@ -30,9 +33,38 @@ Intrusive_ptr<S3_client> py_make_s3_client(const std::string &access_key_id,
                                            const std::string &session_token,
                                            const std::string &profile,
                                            const std::string &region,
-                                           bool use_https)
+                                           bool use_https,
+                                           const S3_range_read_params &range_read_params,
+                                           Intrusive_ptr<S3_object_cache> object_cache,
+                                           std::size_t max_connections,
+                                           std::size_t connect_timeout_ms,
+                                           std::size_t request_timeout_ms,
+                                           S3_retry_mode retry_mode,
+                                           std::size_t max_attempts,
+                                           const std::string &endpoint_override,
+                                           bool use_virtual_addressing,
+                                           bool use_crt,
+                                           double target_throughput_gbps)
 {
-    S3_client_options opts{access_key_id, secret_key, session_token, profile, region, use_https};
+    S3_client_options opts{access_key_id,
+                           secret_key,
+                           session_token,
+                           profile,
+                           region,
+                           use_https,
+                           range_read_params,
+                           std::move(object_cache)};
+
+    opts.max_connections = max_connections;
+    opts.connect_timeout = std::chrono::milliseconds{connect_timeout_ms};
+    opts.request_timeout = std::chrono::milliseconds{request_timeout_ms};
+    opts.retry_mode = retry_mode;
+    opts.max_attempts = max_attempts;
+    opts.endpoint_override = endpoint_override;
+    opts.use_virtual_addressing = use_virtual_addressing;
+    opts.use_crt = use_crt;
+    opts.target_throughput_gbps = target_throughput_gbps;
+
     return make_s3_client(opts);
 }
 
@@ -40,6 +72,63 @@ Intrusive_ptr<S3_client> py_make_s3_client(const std::string &access_key_id,
 
 void register_s3_client(py::module &m)
 {
+    py::enum_<S3_retry_mode>(m, "S3RetryMode", "Specifies how failed S3 requests are retried.")
+        .value("LEGACY", S3_retry_mode::legacy, "Use the default retry strategy of the AWS SDK.")
+        .value("STANDARD",
+               S3_retry_mode::standard,
+               "Use exponential backoff with jitter, bounded by a retry quota.")
+        .value("ADAPTIVE",
+               S3_retry_mode::adaptive,
+               "Like ``STANDARD``, but additionally slow down the client when S3 throttles its "
+               "requests.");
+
+    py::class_<Range_read_params>(m,
+                                  "RangeReadParams",
+                                  "Represents the parameters for reading S3, GCS, or Azure "
+                                  "objects with concurrent byte-range GET requests.")
+        .def(py::init<>())
+        .def_readwrite("num_parallel_ranges",
+                       &Range_read_params::num_parallel_ranges,
+                       "The number of byte-range GET requests to keep in flight ahead of the "
+                       "read position. If less than two, an object is read with one request "
+                       "per read call.")
+        .def_readwrite("range_size",
+                       &Range_read_params::range_size,
+                       "The size of each byte-range GET request.")
+        .def_readwrite("hedge_requests",
+                       &Range_read_params::hedge_requests,
+                       "A boolean value indicating whether to issue a duplicate request for a "
+                       "range that has not been fetched within the 95th percentile of the "
+                       "latencies of the preceding ranges, and take whichever completes first.")
+        .def_readwrite("hedge_budget",
+                       &Range_read_params::hedge_budget,
+                       "The maximum number of hedged requests as a fraction of the ranges "
+                       "fetched.");
+
+    // The parameters predate the GCS and Azure clients.
+    m.attr("S3RangeReadParams") = m.attr("RangeReadParams");
+
+    py::class_<S3_object_cache, Intrusive_ptr<S3_object_cache>>(
+        m,
+        "S3ObjectCache",
+        "Represents a least-recently-used cache of S3, GCS, or Azure objects on local disk.")
+        .def(py::init<std::string, std::size_t>(),
+             "directory"_a,
+             "max_size"_a,
+             R"(
+            Parameters
+            ----------
+            directory : str
+                The directory in which the objects are stored. Objects
+                cached by a previous process are reused.
+            max_size : int
+                The maximum total size, in bytes, of the cached objects.
+            )")
+        .def_property_readonly("directory", &S3_object_cache::directory)
+        .def_property_readonly("max_size", &S3_object_cache::max_size)
+        .def_property_readonly(
+            "size", &S3_object_cache::size, "Gets the total size of the cached objects.");
+
     py::class_<S3_client, Intrusive_ptr<S3_client>>(
         m, "S3Client", "Represents a client to access Amazon S3.")
         .def(py::init<>(&py_make_s3_client),
@@ -48,7 +137,36 @@ void register_s3_client(py::module &m)
              "session_token"_a = "",
              "profile"_a = "",
              "region"_a = "",
-             "use_https"_a = true);
+             "use_https"_a = true,
+             "range_read_params"_a = S3_range_read_params{},
+             "object_cache"_a = nullptr,
+             "max_connections"_a = 0,
+             "connect_timeout_ms"_a = 0,
+             "request_timeout_ms"_a = 0,
+             "retry_mode"_a = S3_retry_mode::legacy,
+             "max_attempts"_a = 0,
+             "endpoint_override"_a = "",
+             "use_virtual_addressing"_a = true,
+             "use_crt"_a = false,
+             "target_throughput_gbps"_a = 10.0)
+        .def("warm_up_connections",
+             &S3_client::warm_up_connections,
+             "bucket"_a,
+             "num_connections"_a,
+             py::call_guard<py::gil_scoped_release>(),
+             R"(
+            Open the specified number of connections to the endpoint of the
+            bucket ahead of time, so that the first reads of a job do not
+            pay for the TCP and TLS handshakes.
+
+            Parameters
+            ----------
+            bucket : str
+                The bucket whose endpoint to connect to.
+            num_connections : int
+                The number of connections to open; typically the number of
+                parallel ranges of all objects read at the same time.
+            )");
 
     m.def("initialize_aws_sdk", initialize_aws_sdk, "Initialize AWS C++ SDK");
     m.def("deallocate_aws_sdk",
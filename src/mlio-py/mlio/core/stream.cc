@@ -17,6 +17,7 @@
 
 #include <exception>
 
+#include "py_file_object.h"
 #include "py_memory_block.h"
 
 namespace py = pybind11;
@@ -58,7 +59,7 @@ std::size_t Py_input_stream::read(Mutable_memory_span destination)
 
     auto size = static_cast<py::ssize_t>(bits.size());
 
-    py::gil_scoped_release acq_gil{};
+    py::gil_scoped_acquire acq_gil{};
 
     ::PyObject *buf = ::PyMemoryView_FromMemory(bits.data(), size, PyBUF_WRITE);
     if (buf == nullptr) {
@@ -141,6 +142,15 @@ std::size_t read_input_stream(Input_stream &stream, const py::buffer &buf)
     return stream.read(block);
 }
 
+std::size_t read_input_stream_at(Input_stream &stream, std::size_t offset, const py::buffer &buf)
+{
+    py_mutable_memory_block block{buf};
+
+    py::gil_scoped_release rel_gil{};
+
+    return stream.read_at(offset, block);
+}
+
 }  // namespace
 
 void register_streams(py::module &m)
@@ -153,6 +163,12 @@ void register_streams(py::module &m)
              "buf"_a,
              "Fills the specified buffer with data read from the stream.")
         .def("read", py::overload_cast<std::size_t>(&Input_stream::read), "size"_a)
+        .def("read_at",
+             &read_input_stream_at,
+             "offset"_a,
+             "buf"_a,
+             "Fills the specified buffer with data read from the specified offset "
+             "without changing the position of the stream.")
         .def("seek",
              &Input_stream::seek,
              "position"_a,
@@ -176,9 +192,103 @@ void register_streams(py::module &m)
                                &Input_stream::supports_zero_copy,
                                "Gets a boolean value indicating whether the stream supports "
                                "zero-copy reading.")
+        .def_property_readonly("supports_read_at",
+                               &Input_stream::supports_read_at,
+                               "Gets a boolean value indicating whether the stream supports "
+                               "positional reads.")
         .def_property_readonly("closed",
                                &Input_stream::closed,
                                "Gets a boolean value indicating whether the stream is closed.");
+
+    m.def("wrap_file_object",
+          &make_file_object_stream,
+          "file"_a,
+          "block_size"_a = 0x40'0000,
+          "prefetch_depth"_a = 2,
+          R"(
+        Wraps a Python file object, such as an fsspec file, as an
+        ``InputStream``.
+
+        Parameters
+        ----------
+        file : file object
+            The binary file object to read from. If it has a ``readinto``
+            method, the data is read directly into the buffers of the
+            stream.
+        block_size : int
+            The number of bytes to read from the file object at once.
+        prefetch_depth : int
+            The number of blocks to read ahead on a dedicated thread. If
+            zero, the file object is read on the thread that reads from
+            the stream, with the GIL acquired for each read.
+        )");
+
+    py::class_<File_io_params>(m,
+                               "FileIoParams",
+                               "Represents the I/O parameters of the streams opened for local "
+                               "files.")
+        .def(py::init<>())
+        .def_readwrite("use_io_uring",
+                       &File_io_params::use_io_uring,
+                       "A boolean value indicating whether the file should be read via "
+                       "io_uring with multiple outstanding reads.")
+        .def_readwrite("queue_depth",
+                       &File_io_params::queue_depth,
+                       "The number of reads to keep in flight when using io_uring.")
+        .def_readwrite("block_size",
+                       &File_io_params::block_size,
+                       "The size of each read when using io_uring.")
+        .def_readwrite("direct_io",
+                       &File_io_params::direct_io,
+                       "A boolean value indicating whether the file should be opened with "
+                       "O_DIRECT to bypass the page cache.");
+
+    m.def("set_default_file_io_params",
+          &set_default_file_io_params,
+          "params"_a,
+          "Sets the I/O parameters that are used by default for file streams.");
+
+    py::class_<Prefetch_params>(m,
+                                "PrefetchParams",
+                                "Represents the parameters of the background read-ahead that "
+                                "data stores apply to the streams they open.")
+        .def(py::init<>())
+        .def_readwrite("chunk_size",
+                       &Prefetch_params::chunk_size,
+                       "The number of bytes to read from the underlying stream at once.")
+        .def_readwrite("depth",
+                       &Prefetch_params::depth,
+                       "The number of chunks to keep in flight. If zero, prefetching is "
+                       "disabled.");
+
+    m.def("set_default_prefetch_params",
+          &set_default_prefetch_params,
+          "params"_a,
+          "Sets the prefetch parameters that data stores use for the streams they open.");
+
+    py::enum_<Inflate_backend>(
+        m, "InflateBackend", "Specifies the library that inflates gzip streams.")
+        .value("AUTOMATIC",
+               Inflate_backend::automatic,
+               "Intel ISA-L if the library was built with it; otherwise zlib.")
+        .value("ZLIB", Inflate_backend::zlib)
+        .value("ISAL", Inflate_backend::isal, "Intel ISA-L; requires ``supports_isal()``.");
+
+    py::class_<Gzip_inflate_params>(
+        m, "GzipInflateParams", "Represents the parameters of the streams that inflate gzip data.")
+        .def(py::init<>())
+        .def_readwrite("backend",
+                       &Gzip_inflate_params::backend,
+                       "The library that inflates the stream.")
+        .def_readwrite("input_buffer_size",
+                       &Gzip_inflate_params::input_buffer_size,
+                       "The number of compressed bytes to read from the underlying stream at "
+                       "once. If zero, it is chosen based on the underlying stream.");
+
+    m.def("set_default_gzip_inflate_params",
+          &set_default_gzip_inflate_params,
+          "params"_a,
+          "Sets the parameters that are used by default for gzip streams.");
 }
 
 }  // namespace pymlio
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "py_buffer.h"
@@ -60,6 +61,37 @@ make_coo_tensor(Size_vector shape, py::buffer &data, std::vector<py::buffer> &co
     return make_intrusive<Coo_tensor>(std::move(shape), std::move(arr), std::move(coordinates));
 }
 
+Intrusive_ptr<Csr_tensor> make_csr_tensor(
+    Size_vector shape, py::buffer &data, py::buffer &indices, py::buffer &indptr, bool cpy)
+{
+    std::unique_ptr<Device_array> arr = make_device_array(data, cpy);
+
+    return make_intrusive<Csr_tensor>(std::move(shape),
+                                      std::move(arr),
+                                      make_device_array(indices, cpy),
+                                      make_device_array(indptr, cpy));
+}
+
+Intrusive_ptr<String_tensor>
+make_string_tensor(Size_vector shape, py::buffer &data, py::buffer &offsets, bool cpy)
+{
+    std::unique_ptr<Device_array> arr = make_device_array(data, cpy);
+
+    return make_intrusive<String_tensor>(
+        std::move(shape), std::move(arr), make_device_array(offsets, cpy));
+}
+
+py::str get_string(const String_tensor &tensor, std::size_t index)
+{
+    if (index >= tensor.size()) {
+        throw py::index_error{"The index is out of range."};
+    }
+
+    std::string_view value = tensor.value(index);
+
+    return py::str{value.data(), value.size()};
+}
+
 py::buffer_info to_py_buffer(Dense_tensor &tensor)
 {
     auto buf = py::cast(tensor).attr("data").cast<py::buffer>();
@@ -90,6 +122,7 @@ void register_tensors(py::module &m)
     py::enum_<Data_type>(m, "DataType")
         .value("SIZE", Data_type::size)
         .value("FLOAT16", Data_type::float16)
+        .value("BFLOAT16", Data_type::bfloat16)
         .value("FLOAT32", Data_type::float32)
         .value("FLOAT64", Data_type::float64)
         .value("INT8", Data_type::int8)
@@ -100,7 +133,9 @@ void register_tensors(py::module &m)
         .value("UINT16", Data_type::uint16)
         .value("UINT32", Data_type::uint32)
         .value("UINT64", Data_type::uint64)
-        .value("STRING", Data_type::string);
+        .value("STRING", Data_type::string)
+        .value("TIMESTAMP", Data_type::timestamp)
+        .value("DATE", Data_type::date);
 
     py::class_<Tensor, Intrusive_ptr<Tensor>>(m,
                                               "Tensor",
@@ -161,6 +196,57 @@ void register_tensors(py::module &m)
             },
             "dim"_a,
             "Gets the indices for the specified dimension.");
+
+    py::class_<Csr_tensor, Tensor, Intrusive_ptr<Csr_tensor>>(
+        m,
+        "CsrTensor",
+        "Represents a Tensor that stores its data in compressed sparse row format.")
+        .def(py::init<>(&make_csr_tensor),
+             "shape"_a,
+             "data"_a,
+             "indices"_a,
+             "indptr"_a,
+             "copy"_a = true)
+        .def_property_readonly(
+            "data",
+            [](Csr_tensor &self) {
+                return Py_device_array{wrap_intrusive(&self), self.data()};
+            },
+            "Gets the data of the Tensor.")
+        .def_property_readonly(
+            "indices",
+            [](Csr_tensor &self) {
+                return Py_device_array{wrap_intrusive(&self), self.indices()};
+            },
+            "Gets the column indices of the Tensor.")
+        .def_property_readonly(
+            "indptr",
+            [](Csr_tensor &self) {
+                return Py_device_array{wrap_intrusive(&self), self.indptr()};
+            },
+            "Gets the index pointer array of the Tensor.");
+
+    py::class_<String_tensor, Tensor, Intrusive_ptr<String_tensor>>(
+        m,
+        "StringTensor",
+        "Represents a Tensor of strings whose bytes are stored back to back "
+        "in a single buffer.")
+        .def(py::init<>(&make_string_tensor), "shape"_a, "data"_a, "offsets"_a, "copy"_a = true)
+        .def("__len__", &String_tensor::size)
+        .def("__getitem__", &get_string, "index"_a)
+        .def_property_readonly(
+            "data",
+            [](String_tensor &self) {
+                return Py_device_array{wrap_intrusive(&self), self.data()};
+            },
+            "Gets the bytes of the strings as a uint8 array.")
+        .def_property_readonly(
+            "offsets",
+            [](String_tensor &self) {
+                return Py_device_array{wrap_intrusive(&self), self.offsets()};
+            },
+            "Gets the int64 offsets of the strings; the string at index i "
+            "spans [offsets[i], offsets[i + 1]) of the data.");
 }
 
 }  // namespace pymlio
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "module.h"
+
+namespace py = pybind11;
+
+using namespace mlio;
+using namespace pybind11::literals;
+
+namespace pymlio {
+
+void register_tracing(py::module &m)
+{
+    m.def("start_tracing",
+          &start_tracing,
+          "max_spans_per_thread"_a = 0x10000,
+          "Starts recording the timelines of the pipeline stages.");
+
+    m.def("stop_tracing", &stop_tracing, "Stops recording the timelines of the pipeline stages.");
+
+    m.def("write_trace",
+          &write_trace,
+          py::call_guard<py::gil_scoped_release>(),
+          "path"_a,
+          "Writes the recorded spans in the Chrome trace event format.");
+
+    py::class_<Allocation_stats>(
+        m,
+        "AllocationStats",
+        "Holds the number of allocations made in a stage of the pipeline.")
+        .def_readonly("num_memory_blocks",
+                      &Allocation_stats::num_memory_blocks,
+                      "The number of memory blocks allocated by the memory allocator.")
+        .def_readonly("memory_block_bytes",
+                      &Allocation_stats::memory_block_bytes,
+                      "The total size of the memory blocks.")
+        .def_readonly("num_cpu_arrays",
+                      &Allocation_stats::num_cpu_arrays,
+                      "The number of tensor arrays allocated.")
+        .def_readonly("cpu_array_bytes",
+                      &Allocation_stats::cpu_array_bytes,
+                      "The total size of the tensor arrays.")
+        .def_readonly("num_heap_allocations",
+                      &Allocation_stats::num_heap_allocations,
+                      "The number of calls to the global operator new.")
+        .def_readonly("heap_bytes",
+                      &Allocation_stats::heap_bytes,
+                      "The total size of the heap allocations.");
+
+    py::class_<Allocation_audit>(
+        m,
+        "AllocationAudit",
+        "Holds the allocations counted since the audit was started by pipeline stage.")
+        .def_readonly("io", &Allocation_audit::io)
+        .def_readonly("framing", &Allocation_audit::framing)
+        .def_readonly("shuffle", &Allocation_audit::shuffle)
+        .def_readonly("decode", &Allocation_audit::decode)
+        .def_readonly("tokenize", &Allocation_audit::tokenize)
+        .def_readonly("protobuf", &Allocation_audit::protobuf)
+        .def_readonly("transform", &Allocation_audit::transform)
+        .def_readonly("other", &Allocation_audit::other)
+        .def_readonly("counts_heap_allocations", &Allocation_audit::counts_heap_allocations);
+
+    m.def("start_allocation_audit",
+          &start_allocation_audit,
+          "Starts counting the allocations made by the pipeline stages.");
+
+    m.def("stop_allocation_audit", &stop_allocation_audit, "Stops counting the allocations.");
+
+    m.def("allocation_audit", &allocation_audit, "Gets the allocations counted so far.");
+}
+
+}  // namespace pymlio
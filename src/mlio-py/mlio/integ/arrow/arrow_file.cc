@@ -64,6 +64,59 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> Arrow_file::Read(std::int64_t nbyt
     });
 }
 
+// If the stream supports positional reads, the calls are not serialized
+// through the cursor of the stream, so Arrow can read the column chunks
+// of a file in parallel.
+arrow::Result<std::int64_t>
+Arrow_file::ReadAt(std::int64_t position, std::int64_t nbytes, void *out) noexcept
+{
+    RETURN_NOT_OK(check_if_closed());
+
+    if (!stream_->supports_read_at()) {
+        return arrow::io::RandomAccessFile::ReadAt(position, nbytes, out);
+    }
+
+    return arrow_boundary<std::int64_t>([=]() {
+        auto offset = static_cast<std::size_t>(position);
+
+        auto size = static_cast<std::size_t>(nbytes);
+
+        Mutable_memory_span destination{static_cast<std::byte *>(out), size};
+
+        std::size_t num_bytes_read = 0;
+        while (!destination.empty()) {
+            std::size_t n = stream_->read_at(offset + num_bytes_read, destination);
+            if (n == 0) {
+                break;
+            }
+
+            num_bytes_read += n;
+
+            destination = destination.subspan(n);
+        }
+
+        return static_cast<std::int64_t>(num_bytes_read);
+    });
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+Arrow_file::ReadAt(std::int64_t position, std::int64_t nbytes) noexcept
+{
+    RETURN_NOT_OK(check_if_closed());
+
+    if (!stream_->supports_read_at()) {
+        return arrow::io::RandomAccessFile::ReadAt(position, nbytes);
+    }
+
+    return arrow_boundary<std::shared_ptr<arrow::Buffer>>([=]() {
+        auto offset = static_cast<std::size_t>(position);
+
+        auto size = static_cast<std::size_t>(nbytes);
+
+        return std::make_shared<Arrow_buffer>(stream_->read_at(offset, size));
+    });
+}
+
 arrow::Status Arrow_file::Seek(std::int64_t position) noexcept
 {
     RETURN_NOT_OK(check_if_closed());
@@ -45,6 +45,12 @@ public:
 
     arrow::Result<std::shared_ptr<arrow::Buffer>> Read(std::int64_t nbytes) noexcept final;
 
+    arrow::Result<std::int64_t>
+    ReadAt(std::int64_t position, std::int64_t nbytes, void *out) noexcept final;
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>>
+    ReadAt(std::int64_t position, std::int64_t nbytes) noexcept final;
+
     arrow::Status Seek(std::int64_t position) noexcept final;
 
     arrow::Status Close() noexcept final;
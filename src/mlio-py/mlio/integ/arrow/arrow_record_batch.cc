@@ -0,0 +1,263 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "arrow_record_batch.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <mlio/data_type.h>
+#include <mlio/device_array.h>
+#include <mlio/intrusive_ptr.h>
+#include <mlio/not_supported_error.h>
+#include <mlio/schema.h>
+#include <mlio/span.h>
+#include <mlio/tensor.h>
+
+#include "arrow_util.h"
+
+using namespace mlio;
+
+namespace pymlio {
+namespace {
+
+// Keeps the tensor alive as long as Arrow references its data.
+class Arrow_tensor_buffer final : public arrow::Buffer {
+public:
+    explicit Arrow_tensor_buffer(Intrusive_ptr<Tensor> tensor,
+                                 Device_array_view arr,
+                                 std::int64_t size) noexcept
+        : arrow::Buffer{static_cast<const std::uint8_t *>(arr.data()), size}
+        , tensor_{std::move(tensor)}
+    {}
+
+    Arrow_tensor_buffer(const Arrow_tensor_buffer &) = delete;
+
+    Arrow_tensor_buffer(Arrow_tensor_buffer &&) = delete;
+
+    ~Arrow_tensor_buffer() final = default;
+
+public:
+    Arrow_tensor_buffer &operator=(const Arrow_tensor_buffer &) = delete;
+
+    Arrow_tensor_buffer &operator=(Arrow_tensor_buffer &&) = delete;
+
+private:
+    Intrusive_ptr<Tensor> tensor_;
+};
+
+std::shared_ptr<arrow::DataType> get_arrow_type(Data_type dt)
+{
+    switch (dt) {
+    case Data_type::size:
+        return arrow::uint64();
+    case Data_type::float16:
+        return arrow::float16();
+    case Data_type::float32:
+        return arrow::float32();
+    case Data_type::float64:
+        return arrow::float64();
+    case Data_type::int8:
+        return arrow::int8();
+    case Data_type::int16:
+        return arrow::int16();
+    case Data_type::int32:
+        return arrow::int32();
+    case Data_type::int64:
+        return arrow::int64();
+    case Data_type::uint8:
+        return arrow::uint8();
+    case Data_type::uint16:
+        return arrow::uint16();
+    case Data_type::uint32:
+        return arrow::uint32();
+    case Data_type::uint64:
+        return arrow::uint64();
+    case Data_type::string:
+        return arrow::utf8();
+    case Data_type::bfloat16:
+        throw Not_supported_error{"The bfloat16 data type is not supported by Arrow."};
+    case Data_type::timestamp:
+        return arrow::timestamp(arrow::TimeUnit::NANO, "UTC");
+    case Data_type::date:
+        return arrow::date64();
+    }
+
+    throw Not_supported_error{"The tensor has an unknown data type."};
+}
+
+std::shared_ptr<arrow::Array>
+make_numeric_array(Intrusive_ptr<Dense_tensor> tensor, std::int64_t num_rows)
+{
+    std::shared_ptr<arrow::DataType> type = get_arrow_type(tensor->data_type());
+
+    int bit_width = static_cast<const arrow::FixedWidthType &>(*type).bit_width();
+
+    Device_array_view arr = tensor->data();
+
+    auto buffer =
+        std::make_shared<Arrow_tensor_buffer>(std::move(tensor), arr, num_rows * bit_width / 8);
+
+    auto data = arrow::ArrayData::Make(std::move(type), num_rows, {nullptr, std::move(buffer)}, 0);
+
+    return arrow::MakeArray(data);
+}
+
+template<typename Offset>
+std::shared_ptr<arrow::Array>
+make_string_array(stdx::span<const std::string> strings, std::int64_t data_size)
+{
+    using Array_type = std::conditional_t<std::is_same_v<Offset, std::int32_t>,
+                                          arrow::StringArray,
+                                          arrow::LargeStringArray>;
+
+    auto num_rows = static_cast<std::int64_t>(strings.size());
+
+    std::shared_ptr<arrow::Buffer> offsets =
+        get_or_throw(arrow::AllocateBuffer((num_rows + 1) * std::int64_t{sizeof(Offset)}));
+
+    std::shared_ptr<arrow::Buffer> data = get_or_throw(arrow::AllocateBuffer(data_size));
+
+    auto *offset_pos = reinterpret_cast<Offset *>(offsets->mutable_data());
+
+    std::uint8_t *data_pos = data->mutable_data();
+
+    Offset offset = 0;
+
+    *offset_pos++ = offset;
+
+    for (const std::string &s : strings) {
+        data_pos = std::copy(s.begin(), s.end(), data_pos);
+
+        offset += static_cast<Offset>(s.size());
+
+        *offset_pos++ = offset;
+    }
+
+    return std::make_shared<Array_type>(num_rows, std::move(offsets), std::move(data));
+}
+
+std::shared_ptr<arrow::Array> make_string_array(const Dense_tensor &tensor, std::int64_t num_rows)
+{
+    auto strings = as_span<const std::string>(tensor.data()).first(static_cast<std::size_t>(num_rows));
+
+    std::int64_t data_size = 0;
+    for (const std::string &s : strings) {
+        data_size += static_cast<std::int64_t>(s.size());
+    }
+
+    // Fall back to 64-bit offsets only if the column does not fit into
+    // a regular string array.
+    if (data_size > std::numeric_limits<std::int32_t>::max()) {
+        return make_string_array<std::int64_t>(strings, data_size);
+    }
+    return make_string_array<std::int32_t>(strings, data_size);
+}
+
+// A string tensor has the layout of a LargeString array, so Arrow can
+// reference its buffers without copying.
+std::shared_ptr<arrow::Array> make_string_array(Intrusive_ptr<String_tensor> tensor,
+                                                std::int64_t num_rows)
+{
+    Device_array_view offsets_arr = tensor->offsets();
+    Device_array_view data_arr = tensor->data();
+
+    auto offsets = std::make_shared<Arrow_tensor_buffer>(
+        tensor, offsets_arr, (num_rows + 1) * std::int64_t{sizeof(std::int64_t)});
+
+    auto data = std::make_shared<Arrow_tensor_buffer>(
+        std::move(tensor), data_arr, static_cast<std::int64_t>(data_arr.size()));
+
+    return std::make_shared<arrow::LargeStringArray>(num_rows, std::move(offsets), std::move(data));
+}
+
+std::shared_ptr<arrow::Array> make_array(const Attribute &attr, Tensor &tensor, std::int64_t num_rows)
+{
+    if (auto *strings = dynamic_cast<String_tensor *>(&tensor); strings != nullptr) {
+        const Size_vector &shape = strings->shape();
+        if (shape.size() > 2 || (shape.size() == 2 && shape[1] != 1)) {
+            throw std::invalid_argument{"The feature '" + attr.name() +
+                                        "' must have a single value per row to be converted to "
+                                        "an Arrow array."};
+        }
+
+        return make_string_array(wrap_intrusive(strings), num_rows);
+    }
+
+    auto *dense = dynamic_cast<Dense_tensor *>(&tensor);
+    if (dense == nullptr) {
+        throw Not_supported_error{"The feature '" + attr.name() +
+                                  "' is sparse and cannot be converted to an Arrow array."};
+    }
+
+    const Size_vector &shape = dense->shape();
+
+    // Each row of the tensor must hold a single contiguous value.
+    bool has_single_value = shape.size() == 1 || (shape.size() == 2 && shape[1] == 1);
+    if (!has_single_value || dense->strides()[0] != 1) {
+        throw std::invalid_argument{"The feature '" + attr.name() +
+                                    "' must have a single value per row to be converted to an "
+                                    "Arrow array."};
+    }
+
+    if (dense->data_type() == Data_type::string) {
+        return make_string_array(*dense, num_rows);
+    }
+
+    return make_numeric_array(wrap_intrusive(dense), num_rows);
+}
+
+}  // namespace
+
+std::shared_ptr<arrow::RecordBatch> make_record_batch(const Example &example)
+{
+    const std::vector<Attribute> &attrs = example.schema().attributes();
+
+    // The last example of a dataset can have a smaller batch size than
+    // the one declared in the schema.
+    std::int64_t num_rows = 0;
+    if (!attrs.empty()) {
+        num_rows = static_cast<std::int64_t>(example.features()[0]->shape()[0] - example.padding);
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> fields{};
+    fields.reserve(attrs.size());
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays{};
+    arrays.reserve(attrs.size());
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        std::shared_ptr<arrow::Array> array = make_array(attrs[i], *example.features()[i], num_rows);
+
+        fields.emplace_back(arrow::field(attrs[i].name(), array->type(), false));
+
+        arrays.emplace_back(std::move(array));
+    }
+
+    return arrow::RecordBatch::Make(arrow::schema(std::move(fields)), num_rows, std::move(arrays));
+}
+
+}  // namespace pymlio
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <arrow/type_fwd.h>
+#include <mlio/example.h>
+
+namespace pymlio {
+
+/// Converts the specified example to an Arrow record batch with one
+/// column per feature.
+///
+/// The numeric columns share their data with the dense tensors of the
+/// example; the string columns are packed into Arrow offset and data
+/// buffers. Each feature must hold a single value per row, and the
+/// padded rows of the example, if any, are not part of the batch.
+std::shared_ptr<arrow::RecordBatch> make_record_batch(const mlio::Example &example);
+
+}  // namespace pymlio
@@ -56,6 +56,33 @@ inline arrow::Status convert_exception()
 
 }  // namespace detail
 
+inline void throw_if_error(const arrow::Status &status)
+{
+    if (status.ok()) {
+        return;
+    }
+
+    if (status.IsOutOfMemory()) {
+        throw std::bad_alloc{};
+    }
+    if (status.IsInvalid()) {
+        throw std::invalid_argument{status.ToString()};
+    }
+    if (status.IsNotImplemented()) {
+        throw mlio::Not_supported_error{status.ToString()};
+    }
+
+    throw std::runtime_error{status.ToString()};
+}
+
+template<typename T>
+T get_or_throw(arrow::Result<T> &&result)
+{
+    throw_if_error(result.status());
+
+    return std::move(result).ValueOrDie();
+}
+
 template<typename Function, typename... Args>
 arrow::Status arrow_boundary(Function &&f, Args &&... args) noexcept
 {
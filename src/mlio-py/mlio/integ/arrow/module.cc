@@ -15,16 +15,25 @@
 
 #include <pybind11/pybind11.h>
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 
+#include <arrow/c/abi.h>
+#include <arrow/c/bridge.h>
 #include <arrow/io/interfaces.h>
+#include <arrow/record_batch.h>
+#include <mlio/data_reader.h>
 #include <mlio/data_stores/data_store.h>
+#include <mlio/example.h>
 #include <mlio/intrusive_ptr.h>
 #include <mlio/record_readers/record.h>
 #include <mlio/streams/input_stream.h>
 #include <mlio/streams/memory_input_stream.h>
 
 #include "arrow_file.h"
+#include "arrow_record_batch.h"
+#include "arrow_util.h"
 
 PYBIND11_DECLARE_HOLDER_TYPE(T, mlio::Intrusive_ptr<T>, true);
 
@@ -80,11 +89,111 @@ static py::object as_arrow_file(const Record &record)
     return make_py_arrow_native_file(std::move(stream));
 }
 
+// Hands the specified record batch over to pyarrow through the Arrow C
+// data interface.
+static py::object to_py_record_batch(const arrow::RecordBatch &batch)
+{
+    ::ArrowArray c_array{};
+    ::ArrowSchema c_schema{};
+
+    throw_if_error(arrow::ExportRecordBatch(batch, &c_array, &c_schema));
+
+    try {
+        auto rb_type = py::module::import("pyarrow").attr("RecordBatch");
+
+        return rb_type.attr("_import_from_c")(reinterpret_cast<std::uintptr_t>(&c_array),
+                                              reinterpret_cast<std::uintptr_t>(&c_schema));
+    }
+    catch (...) {
+        // pyarrow moves the structs only if the import succeeds.
+        if (c_array.release != nullptr) {
+            c_array.release(&c_array);
+        }
+        if (c_schema.release != nullptr) {
+            c_schema.release(&c_schema);
+        }
+        throw;
+    }
+}
+
+static py::object to_arrow(const Example &example)
+{
+    std::shared_ptr<arrow::RecordBatch> batch{};
+    {
+        py::gil_scoped_release rel_gil;
+
+        batch = make_record_batch(example);
+    }
+
+    return to_py_record_batch(*batch);
+}
+
+// Reads the examples of a data reader as Arrow record batches. Both the
+// decoding and the conversion to Arrow happen without holding the GIL.
+class Py_arrow_reader {
+public:
+    explicit Py_arrow_reader(py::object reader)
+        : parent_{std::move(reader)}, reader_{&parent_.cast<Data_reader &>()}
+    {}
+
+public:
+    py::object read_next_batch()
+    {
+        std::shared_ptr<arrow::RecordBatch> batch{};
+        {
+            py::gil_scoped_release rel_gil;
+
+            Intrusive_ptr<Example> example = reader_->read_example();
+            if (example != nullptr) {
+                batch = make_record_batch(*example);
+            }
+        }
+
+        if (batch == nullptr) {
+            return py::none();
+        }
+
+        return to_py_record_batch(*batch);
+    }
+
+    py::object next()
+    {
+        py::object batch = read_next_batch();
+        if (batch.is_none()) {
+            throw py::stop_iteration();
+        }
+
+        return batch;
+    }
+
+private:
+    py::object parent_;
+    Data_reader *reader_;
+};
+
 PYBIND11_MODULE(arrow, m)
 {
     m.def("as_arrow_file", py::overload_cast<const Data_store &>(&as_arrow_file), "store"_a);
 
     m.def("as_arrow_file", py::overload_cast<const Record &>(&as_arrow_file), "record"_a);
+
+    m.def("to_arrow",
+          &to_arrow,
+          "example"_a,
+          "Converts the specified ``Example`` to a ``pyarrow.RecordBatch``. "
+          "Numeric features are not copied.");
+
+    py::class_<Py_arrow_reader>(
+        m, "ArrowReader", "Reads the examples of a ``DataReader`` as ``pyarrow.RecordBatch``es.")
+        .def(py::init<py::object>(), "data_reader"_a)
+        .def("read_next_batch",
+             &Py_arrow_reader::read_next_batch,
+             "Returns the next record batch, or None if the end of the data is reached.")
+        .def("__iter__",
+             [](Py_arrow_reader &rdr) -> Py_arrow_reader & {
+                 return rdr;
+             })
+        .def("__next__", &Py_arrow_reader::next);
 }
 
 }  // namespace pymlio
@@ -23,3 +23,44 @@ def as_dlpack(tensor, version=0x10):
         A Python capsule Instance.
     """
     return mlio._core.as_dlpack(tensor, version)
+
+
+def as_dlpack_components(tensor, version=0x10):
+    """
+    Wraps the component arrays of the specified sparse Tensor as
+    one-dimensional DLPack structures without copying them. Each of
+    them keeps the Tensor alive.
+
+    Returns
+    -------
+        A list of Python capsule Instances; for a CooTensor the data
+        followed by the indices of each dimension, for a CsrTensor the
+        data, the indices, and the index pointers.
+    """
+    return mlio._core.as_dlpack_components(tensor, version)
+
+
+def iter_dlpack(data_reader, features=None, version=0x10, conversion=None):
+    """
+    Returns an iterator that reads the examples from the specified
+    DataReader as dictionaries of DLPack structures keyed by feature
+    name.
+
+    Reading an example and wrapping its features is done in native code
+    without holding the GIL; the GIL is acquired only once per example
+    to build the dictionary.
+
+    Parameters
+    ----------
+    data_reader : DataReader
+        The data reader to read from.
+    features : list of strs, optional
+        The names of the features to return. If not specified, all
+        features are returned.
+    version : int
+        The DLPack specification version.
+    conversion : ExampleConversionParams, optional
+        The conversion to apply to each example before its features are
+        wrapped. The conversion is done in parallel in native code.
+    """
+    return mlio._core.iter_dlpack(data_reader, features, version, conversion)
@@ -13,29 +13,61 @@
 
 import numpy as np
 
-from mlio._core import DenseTensor
+from mlio._core import DataType, DenseTensor, StringTensor
+
+# The buffer protocol has no datetime formats; the timestamps and dates
+# are exposed as int64 values and viewed as datetime64 without a copy.
+_datetime_dtypes = {
+    DataType.TIMESTAMP: np.dtype('datetime64[ns]'),
+    DataType.DATE: np.dtype('datetime64[ms]'),
+}
+
+
+def _as_datetime(tensor, arr):
+    dtype = _datetime_dtypes.get(tensor.data_type)
+    if dtype is None:
+        return arr
+
+    return arr.view(dtype)
+
+
+def _strings_to_numpy(tensor):
+    arr = np.empty(len(tensor), dtype=object)
+    for i in range(len(tensor)):
+        arr[i] = tensor[i]
+
+    return arr.reshape(tensor.shape)
 
 
 def as_numpy(tensor):
     """
     Wraps the specified Tensor as a NumPy array.
+
+    A StringTensor has no NumPy equivalent; it is converted to an object
+    array of ``str``.
     """
+    if isinstance(tensor, StringTensor):
+        return _strings_to_numpy(tensor)
+
     if not isinstance(tensor, DenseTensor):
         raise ValueError("Only dense tensors can be converted to a NumPy "
                          "array.")
 
-    return np.array(tensor, copy=False)
+    return _as_datetime(tensor, np.array(tensor, copy=False))
 
 
 def to_numpy(tensor):
     """
     Converts the specified Tensor to a NumPy array.
     """
+    if isinstance(tensor, StringTensor):
+        return _strings_to_numpy(tensor)
+
     if not isinstance(tensor, DenseTensor):
         raise ValueError("Only dense tensors can be converted to a NumPy "
                          "array.")
 
-    return np.array(tensor)
+    return _as_datetime(tensor, np.array(tensor))
 
 
 def as_tensor(arr):
@@ -13,13 +13,17 @@
 
 import numpy as np
 
-from mlio._core import CooTensor
-from scipy.sparse import coo_matrix
+from mlio._core import CooTensor, CsrTensor
+from scipy.sparse import coo_matrix, csr_matrix
 
 
-def to_coo_matrix(tensor):
+def to_coo_matrix(tensor, copy=True):
     """
     Converts the specified Tensor to a ``coo_matrix``.
+
+    If `copy` is false, the matrix wraps the arrays of the Tensor and
+    keeps it alive. SciPy may still copy the indices if it chooses a
+    narrower index type.
     """
 
     if not isinstance(tensor, CooTensor):
@@ -38,7 +42,35 @@ def to_coo_matrix(tensor):
     rows = np.array(tensor.indices(0), copy=False)
     cols = np.array(tensor.indices(1), copy=False)
 
-    return coo_matrix((data, (rows, cols)), s, copy=True)
+    return coo_matrix((data, (rows, cols)), s, copy=copy)
+
+
+def to_csr_matrix(tensor, copy=True):
+    """
+    Converts the specified Tensor to a ``csr_matrix``.
+
+    If `copy` is false and the Tensor is a CsrTensor, the matrix wraps
+    the arrays of the Tensor and keeps it alive. SciPy may still copy
+    the indices if it chooses a narrower index type.
+    """
+
+    if isinstance(tensor, CooTensor):
+        return to_coo_matrix(tensor, copy=False).tocsr()
+
+    if not isinstance(tensor, CsrTensor):
+        raise ValueError("The Tensor must be an Instance of CooTensor or "
+                         "CsrTensor.")
+
+    s = tensor.shape
+
+    if len(s) == 1:
+        s = (1,) + s
+
+    data = np.array(tensor.data, copy=False)
+    indices = np.array(tensor.indices, copy=False)
+    indptr = np.array(tensor.indptr, copy=False)
+
+    return csr_matrix((data, indices, indptr), s, copy=copy)
 
 
 def to_tensor(mtx):
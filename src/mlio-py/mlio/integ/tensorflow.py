@@ -15,15 +15,16 @@ import numpy as np
 import tensorflow as tf
 
 from mlio import DenseTensor
+from mlio.integ.dlpack import iter_dlpack
 from mlio.integ.numpy import as_numpy
-from mlio.integ.scipy import to_coo_matrix
+from mlio.integ.scipy import to_csr_matrix
 
 
 def to_tf(tensor):
     if isinstance(tensor, DenseTensor):
         return tf.convert_to_tensor(as_numpy(tensor))
 
-    mtx = to_coo_matrix(tensor).tocsr()
+    mtx = to_csr_matrix(tensor)
 
     non_zero_row_col = mtx.nonzero()
     indices = np.asmatrix([non_zero_row_col[0], non_zero_row_col[1]])
@@ -32,13 +33,17 @@ def to_tf(tensor):
     return tf.SparseTensor(indices, mtx.data, mtx.shape)
 
 
-def make_tf_dataset(data_reader, features, dtypes):
+def make_tf_dataset(data_reader, features, dtypes, conversion=None):
+    # The features are read and wrapped as DLPack tensors in native code
+    # with a single GIL acquisition per example; TensorFlow then adopts
+    # them without copying them to NumPy arrays first.
     def generator():
-        for example in data_reader:
-            feature_tensor_dict = {}
-            for feature in features:
-                feature_tensor_dict[feature] = example[feature]
-            yield feature_tensor_dict
+        data_reader.reset()
+
+        for capsules in iter_dlpack(data_reader, features,
+                                    conversion=conversion):
+            yield {name: tf.experimental.dlpack.from_dlpack(capsule)
+                   for name, capsule in capsules.items()}
 
     output_types = {k: l for (k, l) in zip(features, dtypes)}
     return tf.data.Dataset.from_generator(generator, output_types)
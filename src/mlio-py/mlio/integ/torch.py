@@ -11,9 +11,11 @@
 # ANY KIND, either express or implied. See the License for the specific
 # language governing permissions and limitations under the License.
 
+import torch.utils.data
 import torch.utils.dlpack
 
-from mlio.integ.dlpack import as_dlpack
+from mlio._core import CooTensor, CsrTensor
+from mlio.integ.dlpack import as_dlpack, as_dlpack_components, iter_dlpack
 
 
 def as_torch(tensor):
@@ -21,3 +23,67 @@ def as_torch(tensor):
     Wraps the specified Tensor as a PyTorch Tensor.
     """
     return torch.utils.dlpack.from_dlpack(as_dlpack(tensor))
+
+
+def as_torch_sparse(tensor):
+    """
+    Wraps the specified CooTensor or CsrTensor as a sparse PyTorch
+    Tensor. The values, and for a CsrTensor also the indices, share
+    their data with the Tensor; the indices of a CooTensor are stacked
+    into a single index tensor, which requires a copy.
+    """
+    if not isinstance(tensor, (CooTensor, CsrTensor)):
+        raise ValueError("The Tensor must be an Instance of CooTensor or "
+                         "CsrTensor.")
+
+    components = [torch.utils.dlpack.from_dlpack(capsule)
+                  for capsule in as_dlpack_components(tensor)]
+
+    if isinstance(tensor, CooTensor):
+        values, *indices = components
+
+        return torch.sparse_coo_tensor(torch.stack(indices), values,
+                                       tensor.shape)
+
+    values, indices, indptr = components
+
+    return torch.sparse_csr_tensor(indptr, indices, values, tensor.shape)
+
+
+def iter_torch(data_reader, features=None, conversion=None):
+    """
+    Returns an iterator that reads the examples from the specified
+    DataReader as dictionaries of PyTorch Tensors keyed by feature name.
+    The tensors share their data with the examples. If `conversion` is
+    specified, the examples are first converted as described by the
+    ExampleConversionParams in native code.
+    """
+    for capsules in iter_dlpack(data_reader, features,
+                                conversion=conversion):
+        yield {name: torch.utils.dlpack.from_dlpack(capsule)
+               for name, capsule in capsules.items()}
+
+
+class IterableDataset(torch.utils.data.IterableDataset):
+    """
+    Wraps a DataReader as a PyTorch IterableDataset.
+
+    Each iteration resets the reader and yields its examples as
+    dictionaries of PyTorch Tensors. The examples are already batched
+    and prefetched by the reader; the dataset should be used with a
+    DataLoader that has automatic batching disabled (batch_size=None)
+    and no worker processes.
+    """
+
+    def __init__(self, data_reader, features=None, conversion=None):
+        super().__init__()
+
+        self._data_reader = data_reader
+        self._features = features
+        self._conversion = conversion
+
+    def __iter__(self):
+        self._data_reader.reset()
+
+        return iter_torch(self._data_reader, self._features,
+                          self._conversion)
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/allocation_audit.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef MLIO_AUDIT_ALLOCATIONS
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#endif
+
+#include "mlio/detail/allocation_audit.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+std::atomic_bool allocation_audit_enabled{};
+
+thread_local Allocation_stage current_allocation_stage{};
+
+namespace {
+
+constexpr std::size_t num_stages = static_cast<std::size_t>(Allocation_stage::transform) + 1;
+constexpr std::size_t num_sources = static_cast<std::size_t>(Allocation_source::heap) + 1;
+
+struct Allocation_counter {
+    std::atomic<std::uint64_t> num_allocations{};
+    std::atomic<std::uint64_t> num_bytes{};
+};
+
+// The counters are constant-initialized so that they can be used by the
+// global operator new before any dynamic initialization.
+Allocation_counter counters_[num_stages][num_sources]{};
+
+Allocation_stats get_stats(Allocation_stage stage) noexcept
+{
+    const auto &stage_counters = counters_[static_cast<std::size_t>(stage)];
+
+    auto load = [&stage_counters](Allocation_source source, bool bytes) {
+        const Allocation_counter &counter = stage_counters[static_cast<std::size_t>(source)];
+        if (bytes) {
+            return counter.num_bytes.load(std::memory_order_relaxed);
+        }
+        return counter.num_allocations.load(std::memory_order_relaxed);
+    };
+
+    Allocation_stats stats{};
+
+    stats.num_memory_blocks = load(Allocation_source::memory_block, false);
+    stats.memory_block_bytes = load(Allocation_source::memory_block, true);
+    stats.num_cpu_arrays = load(Allocation_source::cpu_array, false);
+    stats.cpu_array_bytes = load(Allocation_source::cpu_array, true);
+    stats.num_heap_allocations = load(Allocation_source::heap, false);
+    stats.heap_bytes = load(Allocation_source::heap, true);
+
+    return stats;
+}
+
+}  // namespace
+
+void count_allocation(Allocation_source source, std::size_t size) noexcept
+{
+    auto stage_idx = static_cast<std::size_t>(current_allocation_stage);
+    auto source_idx = static_cast<std::size_t>(source);
+
+    Allocation_counter &counter = counters_[stage_idx][source_idx];
+
+    counter.num_allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.num_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+void start_allocation_audit() noexcept
+{
+    detail::allocation_audit_enabled = false;
+
+    for (auto &stage_counters : detail::counters_) {
+        for (auto &counter : stage_counters) {
+            counter.num_allocations.store(0, std::memory_order_relaxed);
+            counter.num_bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    detail::allocation_audit_enabled = true;
+}
+
+void stop_allocation_audit() noexcept
+{
+    detail::allocation_audit_enabled = false;
+}
+
+Allocation_audit allocation_audit() noexcept
+{
+    using detail::Allocation_stage;
+
+    Allocation_audit audit{};
+
+    audit.io = detail::get_stats(Allocation_stage::io);
+    audit.framing = detail::get_stats(Allocation_stage::framing);
+    audit.shuffle = detail::get_stats(Allocation_stage::shuffle);
+    audit.decode = detail::get_stats(Allocation_stage::decode);
+    audit.tokenize = detail::get_stats(Allocation_stage::tokenize);
+    audit.protobuf = detail::get_stats(Allocation_stage::protobuf);
+    audit.transform = detail::get_stats(Allocation_stage::transform);
+    audit.other = detail::get_stats(Allocation_stage::other);
+
+#ifdef MLIO_AUDIT_ALLOCATIONS
+    audit.counts_heap_allocations = true;
+#endif
+
+    return audit;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#ifdef MLIO_AUDIT_ALLOCATIONS
+
+// Replaces the global allocation functions of the process so that the
+// heap allocations of the pipeline stages can be counted as well.
+
+namespace {
+
+void *allocate_or_null(std::size_t size) noexcept
+{
+    mlio::detail::record_allocation(mlio::detail::Allocation_source::heap, size);
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocate_or_null(std::size_t size, std::align_val_t alignment) noexcept
+{
+    mlio::detail::record_allocation(mlio::detail::Allocation_source::heap, size);
+
+    auto align = static_cast<std::size_t>(alignment);
+
+    // The size passed to aligned_alloc() must be a nonzero multiple of
+    // the alignment.
+    std::size_t padded_size = (std::max(size, std::size_t{1}) + align - 1) / align * align;
+
+    return std::aligned_alloc(align, padded_size);
+}
+
+template<typename... Args>
+void *allocate_or_throw(std::size_t size, Args... args)
+{
+    void *ptr = allocate_or_null(size, args...);
+    if (ptr == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return ptr;
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+
+MLIO_API void *operator new(std::size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+MLIO_API void *operator new[](std::size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+MLIO_API void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size);
+}
+
+MLIO_API void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size);
+}
+
+MLIO_API void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, alignment);
+}
+
+MLIO_API void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, alignment);
+}
+
+MLIO_API void *
+operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size, alignment);
+}
+
+MLIO_API void *
+operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size, alignment);
+}
+
+MLIO_API void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+MLIO_API void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+// NOLINTEND(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+
+#endif
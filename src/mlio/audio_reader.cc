@@ -0,0 +1,486 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/audio_reader.h"
+
+#include "mlio/mel_spectrogram.h"
+
+#ifdef MLIO_BUILD_AUDIO_READER
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+extern "C" {
+#include <libavutil/channel_layout.h>
+#include <libavutil/error.h>
+#include <libavutil/samplefmt.h>
+#include <libswresample/swresample.h>
+}
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/ffmpeg_input.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/logger.h"
+#include "mlio/record_readers/record_reader.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace {
+
+// Decodes an audio clip held in memory with FFmpeg, and downmixes and
+// resamples it to mono float samples as it is decoded.
+class Clip_decoder {
+public:
+    explicit Clip_decoder(Memory_slice bits) noexcept : input_{std::move(bits)}
+    {}
+
+    Clip_decoder(const Clip_decoder &) = delete;
+
+    Clip_decoder &operator=(const Clip_decoder &) = delete;
+
+    Clip_decoder(Clip_decoder &&) = delete;
+
+    Clip_decoder &operator=(Clip_decoder &&) = delete;
+
+    ~Clip_decoder();
+
+    // Opens the clip and its best audio stream. Returns false and sets
+    // the error message if the clip cannot be decoded.
+    bool open();
+
+    // Fills the output buffer with the samples of the clip at the
+    // specified sample rate, and pads it with zeros if the clip is too
+    // short. Stops decoding once the buffer is full.
+    bool read(stdx::span<float> out, int sample_rate);
+
+    const std::string &error() const noexcept
+    {
+        return input_.error();
+    }
+
+private:
+    bool init_resampler(const ::AVFrame &frame, int sample_rate);
+
+    detail::Ffmpeg_input input_;
+    ::AVFrame *frame_{};
+    ::SwrContext *swr_ctx_{};
+};
+
+Clip_decoder::~Clip_decoder()
+{
+    ::swr_free(&swr_ctx_);
+
+    ::av_frame_free(&frame_);
+}
+
+bool Clip_decoder::open()
+{
+    if (!input_.open(AVMEDIA_TYPE_AUDIO)) {
+        return false;
+    }
+
+    frame_ = ::av_frame_alloc();
+    if (frame_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    return true;
+}
+
+bool Clip_decoder::read(stdx::span<float> out, int sample_rate)
+{
+    std::size_t num_samples_read = 0;
+
+    auto convert = [this, &out, &num_samples_read](const std::uint8_t **src, int src_size) {
+        auto *dst = reinterpret_cast<std::uint8_t *>(out.data() + num_samples_read);
+
+        std::size_t dst_size = std::min(out.size() - num_samples_read,
+                                        std::size_t{std::numeric_limits<int>::max()});
+
+        // Samples that do not fit into the output buffer are buffered
+        // by the resampler and discarded along with it.
+        int num_converted =
+            ::swr_convert(swr_ctx_, &dst, static_cast<int>(dst_size), src, src_size);
+        if (num_converted < 0) {
+            return input_.fail("resample the audio stream", num_converted);
+        }
+
+        num_samples_read += static_cast<std::size_t>(num_converted);
+
+        return true;
+    };
+
+    while (num_samples_read < out.size()) {
+        int err = input_.read_frame(*frame_);
+        if (err == AVERROR_EOF) {
+            break;
+        }
+        if (err < 0) {
+            return input_.fail("decode a frame", err);
+        }
+
+        if (swr_ctx_ == nullptr && !init_resampler(*frame_, sample_rate)) {
+            return false;
+        }
+
+        bool converted = convert(const_cast<const std::uint8_t **>(frame_->extended_data),
+                                 frame_->nb_samples);
+
+        ::av_frame_unref(frame_);
+
+        if (!converted) {
+            return false;
+        }
+    }
+
+    if (swr_ctx_ == nullptr) {
+        return input_.fail("The audio stream does not contain any samples.");
+    }
+
+    // Flush the samples still buffered in the resampler.
+    if (num_samples_read < out.size()) {
+        if (!convert(nullptr, 0)) {
+            return false;
+        }
+    }
+
+    std::fill(out.begin() + as_ssize(num_samples_read), out.end(), 0.0F);
+
+    return true;
+}
+
+bool Clip_decoder::init_resampler(const ::AVFrame &frame, int sample_rate)
+{
+    ::AVChannelLayout in_layout{};
+
+    // Some containers, such as WAV, might not specify the order of the
+    // channels; assume the default order in that case.
+    if (frame.ch_layout.order == AV_CHANNEL_ORDER_UNSPEC) {
+        ::av_channel_layout_default(&in_layout, frame.ch_layout.nb_channels);
+    }
+    else if (::av_channel_layout_copy(&in_layout, &frame.ch_layout) < 0) {
+        throw std::bad_alloc{};
+    }
+
+    ::AVChannelLayout out_layout = AV_CHANNEL_LAYOUT_MONO;
+
+    int err = ::swr_alloc_set_opts2(&swr_ctx_,
+                                    &out_layout,
+                                    AV_SAMPLE_FMT_FLT,
+                                    sample_rate,
+                                    &in_layout,
+                                    static_cast<::AVSampleFormat>(frame.format),
+                                    frame.sample_rate,
+                                    0,
+                                    nullptr);
+
+    ::av_channel_layout_uninit(&in_layout);
+
+    if (err >= 0) {
+        err = ::swr_init(swr_ctx_);
+    }
+    if (err < 0) {
+        ::swr_free(&swr_ctx_);
+
+        return input_.fail("initialize the resampler", err);
+    }
+
+    return true;
+}
+
+}  // namespace
+
+Audio_reader::Audio_reader(Data_reader_params params, Audio_reader_params audio_params)
+    : Parallel_data_reader{std::move(params)}, params_{std::move(audio_params)}
+{
+    if (params_.sample_rate == 0 ||
+        params_.sample_rate > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        throw std::invalid_argument{"The sample rate must be greater than zero."};
+    }
+
+    if (params_.num_samples == 0) {
+        throw std::invalid_argument{"The number of samples must be greater than zero."};
+    }
+
+    if (params_.output == Audio_output::log_mel_spectrogram) {
+        spectrogram_ = std::make_unique<detail::Mel_spectrogram>(params_);
+    }
+
+    error_bad_example_ = this->params().bad_example_handling == Bad_example_handling::error;
+}
+
+Audio_reader::~Audio_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Audio_reader::make_record_reader(const Data_store &)
+{
+    // Each data store holds a single clip.
+    return nullptr;
+}
+
+Intrusive_ptr<const Schema> Audio_reader::infer_schema(const std::optional<Instance> &)
+{
+    Size_vector shape{};
+    if (spectrogram_ == nullptr) {
+        shape = {params().batch_size, params_.num_samples};
+    }
+    else {
+        shape = {
+            params().batch_size, params_.num_mels, spectrogram_->num_frames(params_.num_samples)};
+    }
+
+    std::vector<Attribute> attrs{};
+    attrs.emplace_back("value", Data_type::float32, std::move(shape));
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Audio_reader::decode(const Instance_batch &batch) const
+{
+    const Attribute &attr = schema()->attributes()[0];
+
+    auto batch_stride = as_size(attr.strides()[0]);
+
+    Size_vector shape = attr.shape();
+
+    shape[0] = batch.size();
+
+    auto arr = make_pooled_cpu_array(Data_type::float32, batch.size() * batch_stride);
+
+    auto tensor = make_intrusive<Dense_tensor>(std::move(shape), std::move(arr));
+
+    auto values = tensor->data().as<float>();
+
+    stdx::span<const Instance> instances = batch.instances();
+
+    std::size_t num_instances = instances.size();
+
+    // Each clip is decoded into its own slot in the tensor; the slots of
+    // the bad clips are compacted away afterwards.
+    std::vector<char> loaded(num_instances);
+
+    bool skip_bad_example = params().bad_example_handling == Bad_example_handling::skip ||
+                            params().bad_example_handling == Bad_example_handling::skip_warn;
+
+    std::atomic_bool skip_example{};
+
+    auto worker = [this, batch_stride, &instances, &loaded, &values, skip_bad_example, &skip_example](
+                      const tbb::blocked_range<std::size_t> &range) {
+        // The waveform buffer used to compute the spectrograms.
+        std::vector<float> samples{};
+
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            if (skip_example.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            stdx::span<float> out = values.subspan(i * batch_stride, batch_stride);
+
+            if (decode_clip(out, samples, instances[i])) {
+                loaded[i] = 1;
+            }
+            else if (skip_bad_example) {
+                skip_example = true;
+            }
+        }
+    };
+
+    // Decoding a clip is expensive enough for a task of its own.
+    tbb::parallel_for(tbb::blocked_range<std::size_t>{0, num_instances, 1}, worker);
+
+    std::size_t num_instances_read = 0;
+
+    for (std::size_t i = 0; i < num_instances; i++) {
+        if (loaded[i] == 0) {
+            continue;
+        }
+
+        if (i != num_instances_read) {
+            std::memmove(values.data() + num_instances_read * batch_stride,
+                         values.data() + i * batch_stride,
+                         batch_stride * sizeof(float));
+        }
+
+        num_instances_read++;
+    }
+
+    if (num_instances_read != num_instances) {
+        if (should_skip_example(batch)) {
+            return {};
+        }
+
+        // A bad clip might have been partially written to its slot.
+        std::fill(values.begin() + as_ssize(num_instances_read * batch_stride),
+                  values.begin() + as_ssize(num_instances * batch_stride),
+                  0.0F);
+    }
+
+    warn_if_padded(batch, num_instances_read);
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.emplace_back(std::move(tensor));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - num_instances_read;
+
+    return example;
+}
+
+bool Audio_reader::decode_clip(stdx::span<float> out,
+                               std::vector<float> &samples,
+                               const Instance &instance) const
+{
+    Clip_decoder decoder{instance.bits()};
+
+    if (!decoder.open()) {
+        return report_bad_clip(instance, decoder.error());
+    }
+
+    auto sample_rate = static_cast<int>(params_.sample_rate);
+
+    // The waveform is resampled directly into the output tensor.
+    if (spectrogram_ == nullptr) {
+        if (!decoder.read(out, sample_rate)) {
+            return report_bad_clip(instance, decoder.error());
+        }
+
+        return true;
+    }
+
+    samples.resize(params_.num_samples);
+
+    if (!decoder.read(samples, sample_rate)) {
+        return report_bad_clip(instance, decoder.error());
+    }
+
+    spectrogram_->compute(samples, out);
+
+    return true;
+}
+
+bool Audio_reader::report_bad_clip(const Instance &instance, const std::string &error) const
+{
+    if (warn_bad_instances() || error_bad_example_) {
+        auto msg = fmt::format(
+            "The audio decode operation failed for the clip #{1:n} in the data store '{0}' with the following error: {2}",
+            instance.data_store().id(),
+            instance.index(),
+            error);
+
+        if (warn_bad_instances()) {
+            logger::warn(msg);
+        }
+
+        if (error_bad_example_) {
+            throw Invalid_instance_error{msg};
+        }
+    }
+
+    return false;
+}
+
+bool Audio_reader::should_skip_example(const Instance_batch &batch) const
+{
+    if (params().bad_example_handling == Bad_example_handling::skip) {
+        return true;
+    }
+    if (params().bad_example_handling == Bad_example_handling::skip_warn) {
+        logger::warn("The example #{0:n} has been skipped as it had at least one bad clip.",
+                     batch.index());
+
+        return true;
+    }
+    if (params().bad_example_handling != Bad_example_handling::pad &&
+        params().bad_example_handling != Bad_example_handling::pad_warn) {
+        throw std::invalid_argument{"The specified bad example handling is invalid."};
+    }
+
+    return false;
+}
+
+void Audio_reader::warn_if_padded(const Instance_batch &batch, std::size_t num_instances_read) const
+{
+    if (batch.instances().size() != num_instances_read) {
+        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
+            logger::warn("The example #{0:n} has been padded as it had {1:n} bad clip(s).",
+                         batch.index(),
+                         batch.instances().size() - num_instances_read);
+        }
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+Audio_reader::Audio_reader(Data_reader_params params, Audio_reader_params)
+    : Parallel_data_reader{std::move(params)}, params_{}, error_bad_example_{}
+{
+    throw Not_supported_error{"MLIO was not built with audio reader support."};
+}
+
+Audio_reader::~Audio_reader() = default;
+
+Intrusive_ptr<Record_reader> Audio_reader::make_record_reader(const Data_store &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<const Schema> Audio_reader::infer_schema(const std::optional<Instance> &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<Example> Audio_reader::decode(const Instance_batch &) const
+{
+    return nullptr;
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
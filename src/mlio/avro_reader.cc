@@ -0,0 +1,706 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/avro_reader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/avro.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/avro_record_reader.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// A top-level field of the record schema.
+struct Avro_field {
+    // The type of the field.
+    std::size_t node_idx{};
+    // The type of the non-null values of the field.
+    std::size_t value_node_idx{};
+    // Indicates whether the field is a union; the value is then prefixed
+    // by the index of its branch.
+    bool is_union{};
+    std::size_t num_branches{};
+    // The index of the null branch if the field is a nullable union.
+    std::optional<std::size_t> null_branch{};
+    // The position of the column the field is read into, or
+    // std::nullopt if the field is skipped.
+    std::optional<std::size_t> column{};
+};
+
+struct Avro_file_info {
+    Avro_schema schema{};
+    Avro_codec codec{};
+    std::array<std::byte, 16> sync_marker{};
+    std::size_t header_size{};
+    std::vector<Avro_field> fields{};
+    // The names and data types of the columns to read.
+    std::vector<std::string> column_names{};
+    std::vector<Data_type> column_types{};
+};
+
+namespace {
+
+// The header is read in increments of this size until it can be parsed.
+constexpr std::size_t header_read_size = 0x1000;  // 4 KiB
+
+constexpr std::size_t max_header_size = 0x4000000;  // 64 MiB
+
+struct Avro_header {
+    std::string schema{};
+    std::string codec{};
+    std::array<std::byte, 16> sync_marker{};
+    std::size_t size{};
+};
+
+// Parses the header of an object container file. Returns false if the
+// specified bits do not contain the entire header.
+bool parse_header(Memory_span bits, Avro_header &header)
+{
+    Avro_cursor cursor{bits};
+
+    std::string_view magic{};
+    if (!cursor.read_fixed(4, magic)) {
+        return false;
+    }
+
+    if (magic != std::string_view{"Obj\x01", 4}) {
+        throw Corrupt_header_error{"The data store is not a valid Avro object container file."};
+    }
+
+    // The metadata is a map of bytes.
+    std::int64_t count{};
+    while (cursor.read_long(count) && count != 0) {
+        if (count < 0) {
+            std::int64_t size{};
+            if (!cursor.read_long(size)) {
+                return false;
+            }
+            count = -count;
+        }
+
+        for (std::int64_t i = 0; i < count; i++) {
+            std::string_view key{};
+            std::string_view value{};
+            if (!cursor.read_bytes(key) || !cursor.read_bytes(value)) {
+                return false;
+            }
+
+            if (key == "avro.schema") {
+                header.schema = value;
+            }
+            else if (key == "avro.codec") {
+                header.codec = value;
+            }
+        }
+    }
+
+    if (count != 0) {
+        return false;
+    }
+
+    std::string_view sync_marker{};
+    if (!cursor.read_fixed(header.sync_marker.size(), sync_marker)) {
+        return false;
+    }
+
+    std::memcpy(header.sync_marker.data(), sync_marker.data(), sync_marker.size());
+
+    header.size = bits.size() - cursor.remaining();
+
+    return true;
+}
+
+Avro_header read_header(Input_stream &stream)
+{
+    Avro_header header{};
+
+    std::vector<std::byte> buffer{};
+
+    std::size_t size = 0;
+
+    while (true) {
+        buffer.resize(size + header_read_size);
+
+        std::size_t num_bytes_read = stream.read(Mutable_memory_span{buffer}.subspan(size));
+
+        size += num_bytes_read;
+
+        if (parse_header(Memory_span{buffer}.first(size), header)) {
+            return header;
+        }
+
+        if (num_bytes_read == 0 || size > max_header_size) {
+            throw Corrupt_header_error{"The Avro file header is truncated or malformed."};
+        }
+    }
+}
+
+void skip_header(Input_stream &stream, std::size_t header_size)
+{
+    if (stream.seekable()) {
+        stream.seek(header_size);
+
+        return;
+    }
+
+    std::vector<std::byte> buffer(std::min(header_size, header_read_size));
+
+    while (header_size > 0) {
+        auto bits = Mutable_memory_span{buffer}.first(std::min(header_size, buffer.size()));
+
+        std::size_t num_bytes_read = stream.read(bits);
+        if (num_bytes_read == 0) {
+            throw Corrupt_header_error{"The Avro file header is truncated."};
+        }
+
+        header_size -= num_bytes_read;
+    }
+}
+
+Avro_codec get_codec(const std::string &name, const Data_store &store)
+{
+    if (name.empty() || name == "null") {
+        return Avro_codec::null;
+    }
+    if (name == "deflate") {
+        return Avro_codec::deflate;
+    }
+    if (name == "zstandard") {
+        return Avro_codec::zstandard;
+    }
+
+    throw Not_supported_error{fmt::format(
+        "The Avro file in the data store '{0}' uses the '{1}' codec, which is not supported.",
+        store.id(),
+        name)};
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+std::optional<Data_type> get_data_type(Avro_kind kind) noexcept
+{
+    switch (kind) {
+    case Avro_kind::boolean:
+        return Data_type::uint8;
+    case Avro_kind::int_:
+        return Data_type::int32;
+    case Avro_kind::long_:
+        return Data_type::int64;
+    case Avro_kind::float_:
+        return Data_type::float32;
+    case Avro_kind::double_:
+        return Data_type::float64;
+    case Avro_kind::bytes:
+    case Avro_kind::string:
+    case Avro_kind::fixed:
+    case Avro_kind::enum_:
+        return Data_type::string;
+    default:
+        return {};
+    }
+}
+
+#pragma GCC diagnostic pop
+
+// Resolves the type of a field to a data type. A union is supported if
+// it has a single non-null branch.
+std::optional<Data_type> resolve_field(const Avro_schema &schema, Avro_field &field)
+{
+    const Avro_node &node = schema.node(field.node_idx);
+
+    field.value_node_idx = field.node_idx;
+
+    if (node.kind == Avro_kind::union_) {
+        field.is_union = true;
+        field.num_branches = node.children.size();
+
+        std::optional<std::size_t> value_branch{};
+
+        for (std::size_t i = 0; i < node.children.size(); i++) {
+            if (schema.node(node.children[i]).kind == Avro_kind::null) {
+                if (field.null_branch) {
+                    return {};
+                }
+                field.null_branch = i;
+            }
+            else {
+                if (value_branch) {
+                    return {};
+                }
+                value_branch = i;
+            }
+        }
+
+        if (value_branch == std::nullopt) {
+            return {};
+        }
+
+        field.value_node_idx = node.children[*value_branch];
+    }
+
+    return get_data_type(schema.node(field.value_node_idx).kind);
+}
+
+template<typename T>
+T get_null_value() noexcept
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    else {
+        return T{};
+    }
+}
+
+template<typename T>
+inline void set_value(Device_array_span arr, std::size_t row, T value)
+{
+    arr.as<T>()[row] = std::move(value);
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+void set_null_value(Device_array_span arr, Data_type dt, std::size_t row)
+{
+    switch (dt) {
+    case Data_type::uint8:
+        set_value(arr, row, get_null_value<std::uint8_t>());
+        break;
+    case Data_type::int32:
+        set_value(arr, row, get_null_value<std::int32_t>());
+        break;
+    case Data_type::int64:
+        set_value(arr, row, get_null_value<std::int64_t>());
+        break;
+    case Data_type::float32:
+        set_value(arr, row, get_null_value<float>());
+        break;
+    case Data_type::float64:
+        set_value(arr, row, get_null_value<double>());
+        break;
+    default:
+        set_value(arr, row, std::string{});
+        break;
+    }
+}
+
+// Decodes a non-null value into the specified row of the column.
+bool decode_value(Avro_cursor &cursor,
+                  const Avro_node &node,
+                  Device_array_span arr,
+                  std::size_t row)
+{
+    switch (node.kind) {
+    case Avro_kind::boolean: {
+        std::uint8_t value{};
+        if (!cursor.read_boolean(value)) {
+            return false;
+        }
+        set_value(arr, row, value);
+        return true;
+    }
+    case Avro_kind::int_: {
+        std::int32_t value{};
+        if (!cursor.read_int(value)) {
+            return false;
+        }
+        set_value(arr, row, value);
+        return true;
+    }
+    case Avro_kind::long_: {
+        std::int64_t value{};
+        if (!cursor.read_long(value)) {
+            return false;
+        }
+        set_value(arr, row, value);
+        return true;
+    }
+    case Avro_kind::float_: {
+        float value{};
+        if (!cursor.read_float(value)) {
+            return false;
+        }
+        set_value(arr, row, value);
+        return true;
+    }
+    case Avro_kind::double_: {
+        double value{};
+        if (!cursor.read_double(value)) {
+            return false;
+        }
+        set_value(arr, row, value);
+        return true;
+    }
+    case Avro_kind::bytes:
+    case Avro_kind::string: {
+        std::string_view value{};
+        if (!cursor.read_bytes(value)) {
+            return false;
+        }
+        set_value(arr, row, std::string{value});
+        return true;
+    }
+    case Avro_kind::fixed: {
+        std::string_view value{};
+        if (!cursor.read_fixed(node.size, value)) {
+            return false;
+        }
+        set_value(arr, row, std::string{value});
+        return true;
+    }
+    case Avro_kind::enum_: {
+        std::int64_t value{};
+        if (!cursor.read_long(value) || value < 0 ||
+            static_cast<std::uint64_t>(value) >= node.symbols.size()) {
+            return false;
+        }
+        set_value(arr, row, node.symbols[static_cast<std::size_t>(value)]);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+struct Avro_block {
+    std::shared_ptr<const Avro_file_info> info{};
+    Memory_span data{};
+    std::size_t row_offset{};
+    std::size_t num_rows{};
+};
+
+// Decodes the objects of a block into the rows of the tensors. Returns
+// false if the block is malformed.
+bool decode_block(const Avro_block &block,
+                  std::vector<std::byte> &buffer,
+                  std::vector<Intrusive_ptr<Dense_tensor>> &tensors)
+{
+    const Avro_file_info &info = *block.info;
+
+    Memory_span data = block.data;
+    if (info.codec != Avro_codec::null) {
+        decompress_avro_block(info.codec, data, buffer);
+
+        data = buffer;
+    }
+
+    Avro_cursor cursor{data};
+
+    for (std::size_t row = block.row_offset; row < block.row_offset + block.num_rows; row++) {
+        for (const Avro_field &field : info.fields) {
+            if (field.column == std::nullopt) {
+                if (!cursor.skip(info.schema, field.node_idx)) {
+                    return false;
+                }
+                continue;
+            }
+
+            Device_array_span arr = tensors[*field.column]->data();
+
+            if (field.is_union) {
+                std::int64_t branch{};
+                if (!cursor.read_long(branch) || branch < 0 ||
+                    static_cast<std::uint64_t>(branch) >= field.num_branches) {
+                    return false;
+                }
+
+                if (static_cast<std::size_t>(branch) == field.null_branch) {
+                    set_null_value(arr, info.column_types[*field.column], row);
+
+                    continue;
+                }
+            }
+
+            if (!decode_value(cursor, info.schema.node(field.value_node_idx), arr, row)) {
+                return false;
+            }
+        }
+    }
+
+    return cursor.eof();
+}
+
+}  // namespace
+}  // namespace detail
+
+Avro_reader::Avro_reader(Data_reader_params params, Avro_reader_params avro_params)
+    : Parallel_data_reader{std::move(params)}, params_{std::move(avro_params)}
+{}
+
+Avro_reader::~Avro_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Avro_reader::make_record_reader(const Data_store &store)
+{
+    auto stream = store.open_read();
+
+    std::shared_ptr<const detail::Avro_file_info> info = read_file_info(store, *stream);
+
+    // The header is read in increments, so the stream is most likely
+    // past its end by now.
+    if (!stream->seekable()) {
+        stream = store.open_read();
+    }
+
+    detail::skip_header(*stream, info->header_size);
+
+    return make_intrusive<detail::Avro_record_reader>(std::move(stream), info->sync_marker);
+}
+
+std::shared_ptr<const detail::Avro_file_info>
+Avro_reader::read_file_info(const Data_store &store, Input_stream &stream)
+{
+    detail::Avro_header header{};
+    try {
+        header = detail::read_header(stream);
+    }
+    catch (const Corrupt_header_error &) {
+        throw Corrupt_header_error{fmt::format(
+            "The data store '{0}' is not a valid Avro object container file.", store.id())};
+    }
+
+    auto info = std::make_shared<detail::Avro_file_info>();
+
+    info->codec = detail::get_codec(header.codec, store);
+    info->sync_marker = header.sync_marker;
+    info->header_size = header.size;
+
+    try {
+        info->schema = detail::Avro_schema::parse(header.schema);
+    }
+    catch (const Schema_error &e) {
+        throw Schema_error{fmt::format(
+            "The schema of the Avro file in the data store '{0}' cannot be parsed: {1}",
+            store.id(),
+            e.what())};
+    }
+
+    const detail::Avro_node &root = info->schema.root();
+    if (root.kind != detail::Avro_kind::record) {
+        throw Not_supported_error{fmt::format(
+            "The Avro file in the data store '{0}' does not have a record schema.", store.id())};
+    }
+
+    for (std::size_t i = 0; i < root.children.size(); i++) {
+        detail::Avro_field &field = info->fields.emplace_back();
+
+        field.node_idx = root.children[i];
+
+        const std::string &name = root.field_names[i];
+
+        if (!params_.use_columns.empty() && params_.use_columns.count(name) == 0) {
+            continue;
+        }
+
+        std::optional<Data_type> dt = detail::resolve_field(info->schema, field);
+        if (dt == std::nullopt) {
+            if (params_.use_columns.empty()) {
+                continue;
+            }
+
+            throw Not_supported_error{fmt::format(
+                "The field '{0}' in the data store '{1}' is of an unsupported type.",
+                name,
+                store.id())};
+        }
+
+        field.column = info->column_names.size();
+
+        info->column_names.emplace_back(name);
+        info->column_types.emplace_back(*dt);
+    }
+
+    if (!params_.use_columns.empty() && info->column_names.size() != params_.use_columns.size()) {
+        for (const std::string &name : params_.use_columns) {
+            auto pos = std::find(info->column_names.begin(), info->column_names.end(), name);
+            if (pos == info->column_names.end()) {
+                throw Schema_error{fmt::format(
+                    "The data store '{0}' does not have a field named '{1}'.", store.id(), name)};
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock{file_info_mutex_};
+
+    file_infos_[&store] = info;
+
+    return info;
+}
+
+std::shared_ptr<const detail::Avro_file_info>
+Avro_reader::get_file_info(const Data_store &store) const
+{
+    std::unique_lock<std::mutex> lock{file_info_mutex_};
+
+    auto pos = file_infos_.find(&store);
+    if (pos == file_infos_.end()) {
+        throw std::logic_error{"The header of the Avro file has not been read."};
+    }
+
+    return pos->second;
+}
+
+Intrusive_ptr<const Schema> Avro_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    std::vector<Attribute> attrs{};
+
+    if (instance) {
+        std::shared_ptr<const detail::Avro_file_info> info = get_file_info(instance->data_store());
+
+        // The number of rows in an example depends on the blocks it
+        // contains.
+        for (std::size_t i = 0; i < info->column_names.size(); i++) {
+            attrs.emplace_back(info->column_names[i], info->column_types[i], Size_vector{0, 1});
+        }
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Avro_reader::decode(const Instance_batch &batch) const
+{
+    const std::vector<Attribute> &attrs = schema()->attributes();
+
+    std::vector<detail::Avro_block> blocks{};
+    blocks.reserve(batch.num_instances());
+
+    std::size_t num_rows = 0;
+
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        const Data_store &store = batch.data_store(i);
+
+        detail::Avro_block &block = blocks.emplace_back();
+
+        block.info = get_file_info(store);
+
+        detail::Avro_cursor cursor{batch.bits(i)};
+
+        std::int64_t num_objects{};
+        std::int64_t size{};
+        if (!cursor.read_long(num_objects) || !cursor.read_long(size) || num_objects < 0 ||
+            static_cast<std::uint64_t>(size) != cursor.remaining()) {
+            throw Invalid_instance_error{
+                fmt::format("The block #{1:n} in the data store '{0}' is malformed.",
+                            store.id(),
+                            batch.instance_index(i))};
+        }
+
+        const detail::Avro_file_info &info = *block.info;
+
+        bool matches_schema = info.column_names.size() == attrs.size();
+        for (std::size_t j = 0; j < attrs.size() && matches_schema; j++) {
+            matches_schema = info.column_names[j] == attrs[j].name() &&
+                             info.column_types[j] == attrs[j].data_type();
+        }
+
+        if (!matches_schema) {
+            throw Schema_error{fmt::format(
+                "The fields of the Avro file in the data store '{0}' do not match the schema of the dataset.",
+                store.id())};
+        }
+
+        block.data = batch.bits(i).last(cursor.remaining());
+        block.row_offset = num_rows;
+        block.num_rows = static_cast<std::size_t>(num_objects);
+
+        num_rows += block.num_rows;
+    }
+
+    std::vector<Intrusive_ptr<Dense_tensor>> tensors{};
+    tensors.reserve(attrs.size());
+
+    for (const Attribute &attr : attrs) {
+        auto arr = make_pooled_cpu_array(attr.data_type(), num_rows);
+
+        tensors.emplace_back(
+            make_intrusive<Dense_tensor>(Size_vector{num_rows, 1}, std::move(arr)));
+    }
+
+    // Each block of the batch is decoded by a separate task.
+    auto worker = [&](const tbb::blocked_range<std::size_t> &range) {
+        std::vector<std::byte> buffer{};
+
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            bool is_valid{};
+            try {
+                is_valid = detail::decode_block(blocks[i], buffer, tensors);
+            }
+            catch (const std::exception &e) {
+                throw Invalid_instance_error{
+                    fmt::format("The block #{1:n} in the data store '{0}' cannot be decoded: {2}",
+                                batch.data_store(i).id(),
+                                batch.instance_index(i),
+                                e.what())};
+            }
+
+            if (!is_valid) {
+                throw Invalid_instance_error{
+                    fmt::format("The block #{1:n} in the data store '{0}' is malformed.",
+                                batch.data_store(i).id(),
+                                batch.instance_index(i))};
+            }
+        }
+    };
+
+    tbb::blocked_range<std::size_t> range{0, blocks.size()};
+
+    if (blocks.size() > 1 && should_decode_parallel(num_rows, attrs.size())) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(range);
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> features{tensors.begin(), tensors.end()};
+
+    return make_intrusive<Example>(schema(), std::move(features));
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
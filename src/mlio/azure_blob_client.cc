@@ -0,0 +1,348 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/azure_blob_client.h"
+
+#ifdef MLIO_BUILD_AZURE
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <azure/core/exception.hpp>
+#include <azure/core/http/curl_transport.hpp>
+#include <azure/core/http/http.hpp>
+#include <azure/core/http/transport.hpp>
+#include <azure/storage/blobs.hpp>
+#include <azure/storage/common/storage_credential.hpp>
+#include <azure/storage/common/storage_exception.hpp>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/object_listing.h"
+#include "mlio/detail/tracing.h"
+#include "mlio/util/cast.h"
+
+namespace blobs = Azure::Storage::Blobs;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Azure_native_client {
+    blobs::BlobServiceClient client;
+};
+
+namespace {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+[[noreturn]] void throw_azure_error(Azure::Core::Http::HttpStatusCode status_code)
+{
+    std::error_code ec;
+
+    switch (status_code) {
+    case Azure::Core::Http::HttpStatusCode::ServiceUnavailable:
+        ec = std::make_error_code(std::errc::host_unreachable);
+        break;
+    case Azure::Core::Http::HttpStatusCode::Unauthorized:
+    case Azure::Core::Http::HttpStatusCode::Forbidden:
+        ec = std::make_error_code(std::errc::permission_denied);
+        break;
+    case Azure::Core::Http::HttpStatusCode::NotFound:
+        ec = std::make_error_code(std::errc::no_such_file_or_directory);
+        break;
+    case Azure::Core::Http::HttpStatusCode::RequestTimeout:
+        ec = std::make_error_code(std::errc::timed_out);
+        break;
+    default:
+        ec = std::make_error_code(std::errc::io_error);
+        break;
+    }
+
+    throw std::system_error{ec, "The Azure blob cannot be accessed."};
+}
+
+#pragma GCC diagnostic pop
+
+// Calls the specified function and translates the exceptions of the
+// Azure SDK to system errors.
+template<typename Func>
+decltype(auto) call_azure(Func &&func)
+{
+    try {
+        return func();
+    }
+    catch (const Azure::Core::RequestFailedException &e) {
+        throw_azure_error(e.StatusCode);
+    }
+    catch (const Azure::Core::Http::TransportException &) {
+        throw std::system_error{std::make_error_code(std::errc::host_unreachable),
+                                "The Azure blob cannot be accessed."};
+    }
+}
+
+blobs::BlobClient make_blob_client(const blobs::BlobServiceClient &client,
+                                   std::string_view container,
+                                   std::string_view name,
+                                   std::string_view version_id)
+{
+    blobs::BlobClient blob = client.GetBlobContainerClient(std::string{container})
+                                 .GetBlobClient(std::string{name});
+
+    if (!version_id.empty()) {
+        return blob.WithVersionId(std::string{version_id});
+    }
+    return blob;
+}
+
+void list_prefix(const blobs::BlobServiceClient &client,
+                 std::string_view container,
+                 std::string_view prefix,
+                 std::string_view delimiter,
+                 Object_listing &listing)
+{
+    blobs::BlobContainerClient container_client =
+        client.GetBlobContainerClient(std::string{container});
+
+    blobs::ListBlobsOptions opts{};
+    if (!prefix.empty()) {
+        opts.Prefix = std::string{prefix};
+    }
+
+    if (delimiter.empty()) {
+        for (auto page = container_client.ListBlobs(opts); page.HasPage(); page.MoveToNextPage()) {
+            for (const auto &blob : page.Blobs) {
+                listing.objects.emplace_back(blob.Name, as_size(blob.BlobSize));
+            }
+        }
+
+        return;
+    }
+
+    for (auto page = container_client.ListBlobsByHierarchy(std::string{delimiter}, opts);
+         page.HasPage();
+         page.MoveToNextPage()) {
+        for (const auto &blob : page.Blobs) {
+            listing.objects.emplace_back(blob.Name, as_size(blob.BlobSize));
+        }
+
+        for (const auto &blob_prefix : page.BlobPrefixes) {
+            listing.common_prefixes.emplace_back(blob_prefix);
+        }
+    }
+}
+
+blobs::BlobServiceClient make_service_client(const Azure_blob_client_options &opts)
+{
+    blobs::BlobClientOptions client_opts{};
+
+    if (opts.max_attempts > 0) {
+        client_opts.Retry.MaxRetries = static_cast<std::int32_t>(opts.max_attempts - 1);
+    }
+
+    if (opts.connect_timeout.count() > 0) {
+        Azure::Core::Http::CurlTransportOptions transport_opts{};
+        transport_opts.ConnectionTimeout = opts.connect_timeout;
+
+        client_opts.Transport.Transport =
+            std::make_shared<Azure::Core::Http::CurlTransport>(transport_opts);
+    }
+
+    if (!opts.connection_string.empty()) {
+        return blobs::BlobServiceClient::CreateFromConnectionString(
+            std::string{opts.connection_string}, client_opts);
+    }
+
+    std::string url{};
+    if (!opts.account_url.empty()) {
+        url = opts.account_url;
+    }
+    else if (!opts.account_name.empty()) {
+        url = fmt::format("https://{0}.blob.core.windows.net", opts.account_name);
+    }
+    else {
+        throw std::invalid_argument{
+            "Either the connection string or the name of the storage account must be specified."};
+    }
+
+    if (!opts.account_key.empty()) {
+        auto credential = std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+            std::string{opts.account_name}, std::string{opts.account_key});
+
+        return blobs::BlobServiceClient{url, std::move(credential), client_opts};
+    }
+
+    if (!opts.sas_token.empty()) {
+        std::string_view token = opts.sas_token;
+        if (token.front() == '?') {
+            token.remove_prefix(1);
+        }
+
+        url += '?';
+        url += token;
+    }
+
+    return blobs::BlobServiceClient{url, client_opts};
+}
+
+}  // namespace
+}  // namespace detail
+
+Azure_blob_client::Azure_blob_client(std::unique_ptr<detail::Azure_native_client> native_client,
+                                     const Range_read_params &range_read_params,
+                                     Intrusive_ptr<S3_object_cache> object_cache) noexcept
+    : Object_store_client{range_read_params, std::move(object_cache)}
+    , native_client_{std::move(native_client)}
+{}
+
+Azure_blob_client::~Azure_blob_client() = default;
+
+void Azure_blob_client::list_objects(std::string_view bucket,
+                                     std::string_view prefix,
+                                     const List_callback &callback) const
+{
+    const blobs::BlobServiceClient &client = native_client_->client;
+
+    auto list_prefix = [&client, bucket](std::string_view pfx,
+                                         std::string_view delimiter,
+                                         detail::Object_listing &listing) {
+        detail::call_azure([&]() {
+            detail::list_prefix(client, bucket, pfx, delimiter, listing);
+        });
+    };
+
+    detail::list_objects_in_parallel(list_prefix, "az", bucket, prefix, callback);
+}
+
+std::size_t Azure_blob_client::read_object(std::string_view bucket,
+                                           std::string_view key,
+                                           std::string_view version_id,
+                                           std::size_t offset,
+                                           Mutable_memory_span destination) const
+{
+    detail::Trace_span span{"azure_read_blob"};
+    detail::Allocation_scope scope{detail::Allocation_stage::io};
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    blobs::BlobClient blob =
+        detail::make_blob_client(native_client_->client, bucket, key, version_id);
+
+    blobs::DownloadBlobOptions opts{};
+    opts.Range = Azure::Core::Http::HttpRange{};
+    opts.Range->Offset = static_cast<std::int64_t>(offset);
+    opts.Range->Length = static_cast<std::int64_t>(destination.size());
+
+    return detail::call_azure([&]() {
+        auto response = blob.Download(opts);
+
+        auto bytes = as_span<std::uint8_t>(destination);
+
+        return response.Value.BodyStream->ReadToCount(bytes.data(), bytes.size());
+    });
+}
+
+Object_metadata Azure_blob_client::read_object_metadata(std::string_view bucket,
+                                                        std::string_view key,
+                                                        std::string_view version_id) const
+{
+    blobs::BlobClient blob =
+        detail::make_blob_client(native_client_->client, bucket, key, version_id);
+
+    return detail::call_azure([&]() {
+        auto properties = blob.GetProperties();
+
+        return Object_metadata{as_size(properties.Value.BlobSize),
+                               properties.Value.ETag.ToString()};
+    });
+}
+
+Intrusive_ptr<Azure_blob_client> make_azure_blob_client(const Azure_blob_client_options &opts)
+{
+    auto native_client = std::make_unique<detail::Azure_native_client>(
+        detail::Azure_native_client{detail::make_service_client(opts)});
+
+    return make_intrusive<Azure_blob_client>(
+        std::move(native_client), opts.range_read_params, opts.object_cache);
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Azure_native_client {};
+
+}  // namespace detail
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+Azure_blob_client::Azure_blob_client(std::unique_ptr<detail::Azure_native_client>,
+                                     const Range_read_params &,
+                                     Intrusive_ptr<S3_object_cache>) noexcept
+    : Object_store_client{{}, {}}
+{}
+
+Azure_blob_client::~Azure_blob_client() = default;
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Azure_blob_client::list_objects(std::string_view,
+                                     std::string_view,
+                                     const List_callback &) const
+{}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::size_t Azure_blob_client::read_object(std::string_view,
+                                           std::string_view,
+                                           std::string_view,
+                                           std::size_t,
+                                           Mutable_memory_span) const
+{
+    return 0;
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+Object_metadata
+Azure_blob_client::read_object_metadata(std::string_view, std::string_view, std::string_view) const
+{
+    return {};
+}
+
+Intrusive_ptr<Azure_blob_client> make_azure_blob_client(const Azure_blob_client_options &)
+{
+    throw Not_supported_error{"MLIO was not built with Azure Blob Storage support."};
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
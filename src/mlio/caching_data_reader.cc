@@ -0,0 +1,623 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/caching_data_reader.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_reader_base.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/error.h"
+#include "mlio/detail/file_descriptor.h"
+#include "mlio/example.h"
+#include "mlio/logger.h"
+#include "mlio/memory/file_mapped_memory_block.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/util.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The cache starts with a fixed-size header followed by the instances.
+// Each instance holds the rows of all features back to back in the
+// order of the schema. We assume the cache is read on the machine that
+// wrote it, hence the host byte order.
+struct Cache_header {
+    std::array<char, 8> magic{};
+    std::uint64_t fingerprint{};
+    std::uint64_t instance_size{};
+    std::uint64_t num_instances{};
+};
+
+constexpr std::array<char, 8> cache_magic{'M', 'L', 'I', 'O', 'C', 'A', 'C', '1'};
+
+constexpr std::size_t header_size = sizeof(Cache_header);
+
+// The number of bytes buffered before they are written to the cache
+// file.
+constexpr std::size_t write_buffer_size = 0x10'0000;  // 1 MiB
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+// FNV-1a; unlike std::hash the value is stable across builds.
+class Fingerprint_hasher {
+public:
+    void add(std::string_view s) noexcept
+    {
+        for (char chr : s) {
+            value_ ^= static_cast<unsigned char>(chr);
+            value_ *= 0x100'0000'01b3;
+        }
+
+        // Separate the fields so that ("ab", "c") and ("a", "bc") hash
+        // differently.
+        value_ ^= 0xFF;
+        value_ *= 0x100'0000'01b3;
+    }
+
+    void add(std::uint64_t value)
+    {
+        add(std::to_string(value));
+    }
+
+    std::uint64_t value() const noexcept
+    {
+        return value_;
+    }
+
+private:
+    std::uint64_t value_ = 0xcbf2'9ce4'8422'2325;
+};
+
+bool is_row_major(const Dense_tensor &tensor) noexcept
+{
+    const Size_vector &shape = tensor.shape();
+    const Ssize_vector &strides = tensor.strides();
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = shape.size(); i > 0; i--) {
+        if (shape[i - 1] > 1 && strides[i - 1] != stride) {
+            return false;
+        }
+        stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+    }
+    return true;
+}
+
+}  // namespace
+}  // namespace detail
+
+// Writes the instances to a memory block or to a temporary file next to
+// the cache file; the latter is renamed to the cache file once complete
+// so that a partial cache is never picked up.
+class Caching_data_reader::Cache_writer {
+public:
+    explicit Cache_writer(const std::string &path) : path_{path}
+    {
+        if (path_.empty()) {
+            block_ = memory_allocator().allocate(detail::write_buffer_size);
+
+            size_ = detail::header_size;
+
+            return;
+        }
+
+        tmp_path_ = path_ + ".tmp";
+
+        fd_ = ::open(tmp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_.get() == -1) {
+            throw std::system_error{detail::current_error_code(),
+                                    fmt::format("The cache file '{0}' cannot be created.", path_)};
+        }
+
+        buffer_.reserve(detail::write_buffer_size);
+
+        // Leave room for the header.
+        buffer_.resize(detail::header_size);
+    }
+
+    Cache_writer(const Cache_writer &) = delete;
+
+    Cache_writer &operator=(const Cache_writer &) = delete;
+
+    Cache_writer(Cache_writer &&) = delete;
+
+    Cache_writer &operator=(Cache_writer &&) = delete;
+
+    ~Cache_writer()
+    {
+        if (fd_.is_open()) {
+            ::unlink(tmp_path_.c_str());
+        }
+    }
+
+    void append(const std::byte *data, std::size_t size)
+    {
+        if (block_ != nullptr) {
+            if (size_ + size > block_->size()) {
+                block_ = resize_memory_block(block_, std::max(size_ + size, block_->size() * 2));
+            }
+
+            std::copy_n(data, size, block_->data() + size_);
+
+            size_ += size;
+
+            return;
+        }
+
+        buffer_.insert(buffer_.end(), data, data + size);
+
+        if (buffer_.size() >= detail::write_buffer_size) {
+            flush();
+        }
+    }
+
+    // Writes the header and returns the cache.
+    Intrusive_ptr<const Memory_block>
+    finish(std::uint64_t fingerprint, std::size_t instance_size, std::size_t num_instances)
+    {
+        detail::Cache_header hdr{detail::cache_magic, fingerprint, instance_size, num_instances};
+
+        if (block_ != nullptr) {
+            std::memcpy(block_->data(), &hdr, sizeof(hdr));
+
+            return resize_memory_block(block_, size_);
+        }
+
+        flush();
+
+        if (::pwrite(fd_.get(), &hdr, sizeof(hdr), 0) != static_cast<::ssize_t>(sizeof(hdr))) {
+            throw_write_error();
+        }
+
+        fd_ = {};
+
+        if (::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+            ::unlink(tmp_path_.c_str());
+
+            throw_write_error();
+        }
+
+        return make_intrusive<File_mapped_memory_block>(path_);
+    }
+
+private:
+    void flush()
+    {
+        const std::byte *pos = buffer_.data();
+        const std::byte *end = pos + buffer_.size();
+
+        while (pos < end) {
+            ::ssize_t num_bytes_written = ::write(fd_.get(), pos, as_size(end - pos));
+            if (num_bytes_written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_write_error();
+            }
+            pos += num_bytes_written;
+        }
+
+        buffer_.clear();
+    }
+
+    [[noreturn]] void throw_write_error() const
+    {
+        throw std::system_error{detail::current_error_code(),
+                                fmt::format("The cache file '{0}' cannot be written.", path_)};
+    }
+
+    std::string path_;
+    std::string tmp_path_{};
+    detail::File_descriptor fd_{};
+    std::vector<std::byte> buffer_{};
+    Intrusive_ptr<Mutable_memory_block> block_{};
+    std::size_t size_{};
+};
+
+Caching_data_reader::Caching_data_reader(Intrusive_ptr<Data_reader> inner, Caching_params params)
+    : inner_{std::move(inner)}, params_{std::move(params)}
+{
+    inner_schema_ = inner_->read_schema();
+
+    init_layout();
+
+    fingerprint_ = compute_fingerprint();
+
+    if (params_.shuffle_seed) {
+        seed_ = *params_.shuffle_seed;
+    }
+    else {
+        seed_ = std::random_device{}();
+    }
+
+    mt_.seed(seed_);
+
+    try_open_cache_file();
+}
+
+Caching_data_reader::~Caching_data_reader() = default;
+
+void Caching_data_reader::init_layout()
+{
+    std::vector<Attribute> attrs{};
+
+    for (const Attribute &attr : inner_schema_->attributes()) {
+        if (attr.sparse() || attr.data_type() == Data_type::string) {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be cached. Only dense features of numeric data types are supported.",
+                attr.name())};
+        }
+
+        const Size_vector &shape = attr.shape();
+
+        std::size_t row_size = std::accumulate(
+            shape.begin() + 1, shape.end(), std::size_t{1}, std::multiplies<>{});
+
+        offsets_.emplace_back(instance_size_);
+
+        instance_size_ += row_size * dispatch<detail::Element_size_op>(attr.data_type());
+
+        Size_vector cached_shape = shape;
+        if (params_.batch_size > 0) {
+            cached_shape[0] = params_.batch_size;
+        }
+
+        attrs.emplace_back(attr.name(), attr.data_type(), std::move(cached_shape));
+    }
+
+    schema_ = make_intrusive<Schema>(std::move(attrs));
+}
+
+std::uint64_t Caching_data_reader::compute_fingerprint() const
+{
+    detail::Fingerprint_hasher hasher{};
+
+    for (const Attribute &attr : inner_schema_->attributes()) {
+        hasher.add(attr.name());
+        hasher.add(static_cast<std::uint64_t>(attr.data_type()));
+
+        // The batch dimension does not affect the cache.
+        for (auto pos = attr.shape().begin() + 1; pos < attr.shape().end(); ++pos) {
+            hasher.add(*pos);
+        }
+    }
+
+    // If the inner reader reads a dataset, take the data stores and the
+    // parameters that select the instances into account.
+    auto *base = dynamic_cast<const Data_reader_base *>(inner_.get());
+    if (base != nullptr) {
+        const Data_reader_params &prm = base->params();
+
+        for (const Intrusive_ptr<Data_store> &store : prm.dataset) {
+            hasher.add(store->id());
+            hasher.add(store->size_hint().value_or(0));
+        }
+
+        hasher.add(prm.num_instances_to_skip);
+        hasher.add(prm.num_instances_to_read.value_or(0));
+        hasher.add(prm.shard_index);
+        hasher.add(prm.num_shards);
+        hasher.add(static_cast<std::uint64_t>(prm.sharding_strategy));
+        hasher.add(fmt::format("{0}", prm.sample_ratio.value_or(1.0F)));
+        hasher.add(prm.sample_seed.value_or(0));
+        // Only added if set so that the existing caches stay valid.
+        if (prm.deduplicate_instances) {
+            hasher.add(fmt::format("dedup:{0}:{1}",
+                                   prm.dedup_memory_budget,
+                                   prm.dedup_false_positive_rate));
+        }
+    }
+
+    hasher.add(params_.fingerprint);
+
+    return hasher.value();
+}
+
+bool Caching_data_reader::try_open_cache_file()
+{
+    if (params_.path.empty()) {
+        return false;
+    }
+
+    struct ::stat buf {};
+    if (::stat(params_.path.c_str(), &buf) != 0) {
+        return false;
+    }
+
+    auto block = make_intrusive<File_mapped_memory_block>(params_.path);
+
+    detail::Cache_header hdr{};
+    if (block->size() >= sizeof(hdr)) {
+        std::memcpy(&hdr, block->data(), sizeof(hdr));
+    }
+
+    if (hdr.magic != detail::cache_magic || hdr.fingerprint != fingerprint_ ||
+        hdr.instance_size != instance_size_ ||
+        block->size() != detail::header_size + hdr.num_instances * instance_size_) {
+
+        logger::info("The cache file '{0}' does not match the dataset and will be rebuilt.",
+                     params_.path);
+
+        return false;
+    }
+
+    cache_ = std::move(block);
+
+    num_instances_ = hdr.num_instances;
+
+    shuffle_order();
+
+    return true;
+}
+
+Intrusive_ptr<const Schema> Caching_data_reader::read_schema()
+{
+    if (cache_ != nullptr) {
+        return schema_;
+    }
+    return inner_schema_;
+}
+
+Intrusive_ptr<Example> Caching_data_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+    return read_example_core();
+}
+
+Intrusive_ptr<Example> Caching_data_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+Intrusive_ptr<Example> Caching_data_reader::read_example_core()
+{
+    if (cache_ != nullptr) {
+        return read_from_cache();
+    }
+
+    if (writer_ == nullptr) {
+        writer_ = std::make_unique<Cache_writer>(params_.path);
+    }
+
+    Intrusive_ptr<Example> example = inner_->read_example();
+    if (example == nullptr) {
+        finish_cache();
+    }
+    else {
+        write_to_cache(*example);
+    }
+
+    return example;
+}
+
+void Caching_data_reader::write_to_cache(const Example &example)
+{
+    const std::vector<Intrusive_ptr<Tensor>> &features = example.features();
+
+    std::vector<const std::byte *> rows(features.size());
+    std::vector<std::size_t> row_sizes(features.size());
+
+    std::size_t num_rows{};
+
+    for (std::size_t i = 0; i < features.size(); i++) {
+        auto *tensor = dynamic_cast<const Dense_tensor *>(features[i].get());
+        if (tensor == nullptr || !detail::is_row_major(*tensor)) {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be cached as it is not a contiguous dense tensor.",
+                example.schema().attributes()[i].name())};
+        }
+
+        num_rows = tensor->shape()[0] - example.padding;
+
+        rows[i] = static_cast<const std::byte *>(tensor->data().data());
+
+        std::size_t next_offset = i + 1 < offsets_.size() ? offsets_[i + 1] : instance_size_;
+
+        row_sizes[i] = next_offset - offsets_[i];
+    }
+
+    for (std::size_t r = 0; r < num_rows; r++) {
+        for (std::size_t i = 0; i < features.size(); i++) {
+            writer_->append(rows[i] + r * row_sizes[i], row_sizes[i]);
+        }
+    }
+
+    num_instances_ += num_rows;
+}
+
+void Caching_data_reader::finish_cache()
+{
+    cache_ = writer_->finish(fingerprint_, instance_size_, num_instances_);
+
+    writer_ = nullptr;
+
+    logger::info("{0:n} instance(s) have been cached.", num_instances_);
+
+    // The next epoch reads from the cache; the inner reader will not be
+    // used anymore.
+    shuffle_order();
+}
+
+void Caching_data_reader::shuffle_order()
+{
+    order_.resize(num_instances_);
+
+    std::iota(order_.begin(), order_.end(), 0);
+
+    if (params_.shuffle_instances) {
+        std::shuffle(order_.begin(), order_.end(), mt_);
+    }
+
+    pos_ = 0;
+}
+
+Intrusive_ptr<Example> Caching_data_reader::read_from_cache()
+{
+    std::size_t batch_size = schema_->attributes()[0].shape()[0];
+
+    std::size_t num_rows = std::min(batch_size, num_instances_ - pos_);
+    if (num_rows == 0) {
+        return {};
+    }
+
+    std::size_t size = num_rows;
+
+    if (num_rows != batch_size) {
+        switch (params_.last_example_handling) {
+        case Last_example_handling::drop_warn:
+            logger::warn(
+                "The last example has been dropped as it had only {0:n} instance(s) while the batch size is {1:n}.",
+                num_rows,
+                batch_size);
+            [[fallthrough]];
+        case Last_example_handling::drop:
+            pos_ = num_instances_;
+
+            return {};
+        case Last_example_handling::pad_warn:
+            logger::warn(
+                "The last example has been padded as it had only {0:n} instance(s) while the batch size is {1:n}.",
+                num_rows,
+                batch_size);
+            [[fallthrough]];
+        case Last_example_handling::pad:
+            size = batch_size;
+            break;
+        case Last_example_handling::none:
+            break;
+        }
+    }
+
+    const std::byte *data = cache_->data() + detail::header_size;
+
+    std::vector<Intrusive_ptr<Tensor>> features{};
+
+    const std::vector<Attribute> &attrs = schema_->attributes();
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        std::size_t next_offset = i + 1 < offsets_.size() ? offsets_[i + 1] : instance_size_;
+
+        std::size_t row_size = next_offset - offsets_[i];
+
+        Size_vector shape = attrs[i].shape();
+
+        std::size_t num_elements = std::accumulate(
+            shape.begin() + 1, shape.end(), size, std::multiplies<>{});
+
+        // The padded rows are left zero-initialized.
+        std::unique_ptr<Device_array> arr = make_cpu_array(attrs[i].data_type(), num_elements);
+
+        auto *dst = static_cast<std::byte *>(arr->data());
+
+        for (std::size_t r = 0; r < num_rows; r++, dst += row_size) {
+            const std::byte *src = data + order_[pos_ + r] * instance_size_ + offsets_[i];
+
+            std::copy_n(src, row_size, dst);
+        }
+
+        shape[0] = size;
+
+        features.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(arr)));
+    }
+
+    pos_ += num_rows;
+
+    num_bytes_read_ += num_rows * instance_size_;
+
+    auto example = make_intrusive<Example>(schema_, std::move(features));
+
+    example->padding = size - num_rows;
+
+    return example;
+}
+
+void Caching_data_reader::reset() noexcept
+{
+    peeked_example_ = nullptr;
+
+    num_bytes_read_ = 0;
+
+    if (cache_ != nullptr) {
+        // Make sure that we reset the random number generator engine to
+        // its initial state if reshuffling is not requested.
+        if (!params_.reshuffle_each_epoch) {
+            mt_.seed(seed_);
+        }
+
+        shuffle_order();
+
+        return;
+    }
+
+    // The first epoch has not been completed; discard the partial cache.
+    writer_ = nullptr;
+
+    num_instances_ = 0;
+
+    inner_->reset();
+}
+
+std::size_t Caching_data_reader::num_bytes_read() const noexcept
+{
+    if (cache_ != nullptr) {
+        return num_bytes_read_;
+    }
+    return inner_->num_bytes_read();
+}
+
+std::size_t Caching_data_reader::shuffle_buffer_size() const noexcept
+{
+    if (cache_ != nullptr) {
+        return 0;
+    }
+    return inner_->shuffle_buffer_size();
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
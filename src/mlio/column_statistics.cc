@@ -0,0 +1,659 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/column_statistics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/detail/half.h"
+#include "mlio/detail/hyperloglog.h"
+#include "mlio/detail/murmur_hash.h"
+#include "mlio/device.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/number.h"
+#include "mlio/util/string.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The minimum number of values aggregated by a single task.
+constexpr std::size_t grain_size = 0x4000;  // 16Ki
+
+// Holds the statistics of a column aggregated by a single thread.
+struct Column_aggregate {
+    explicit Column_aggregate(const Column_statistics_params &params, bool is_string)
+        : sketch{params.quantile_sketch_size}
+        , values{params.cardinality_precision}
+        , words{is_string ? params.cardinality_precision : std::uint8_t{4}}
+    {
+        if (is_string && params.frequent_values_sketch_size > 0) {
+            frequent.emplace(params.frequent_values_sketch_size);
+        }
+    }
+
+    std::size_t num_values{};
+    std::size_t num_nulls{};
+    std::size_t num_numeric{};
+    std::size_t num_finite{};
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    // The running mean and sum of squared deviations; see Welford's
+    // online algorithm.
+    double mean{};
+    double m2{};
+    Quantile_sketch sketch;
+    std::size_t min_length = std::numeric_limits<std::size_t>::max();
+    std::size_t max_length{};
+    std::size_t sum_length{};
+    std::size_t num_words{};
+    Hyper_log_log values;
+    Hyper_log_log words;
+    std::optional<Frequent_values_sketch> frequent{};
+};
+
+inline std::uint32_t hash_value(std::string_view s) noexcept
+{
+    return murmur_hash3_32(s, 0);
+}
+
+inline std::uint32_t hash_value(double value) noexcept
+{
+    // Make sure that 0.0 and -0.0 are counted as the same value; adding
+    // a positive zero turns a negative zero into a positive one.
+    value += 0.0;
+
+    return hash_value(std::string_view{reinterpret_cast<const char *>(&value), sizeof(double)});
+}
+
+void add_finite(Column_aggregate &agg, double value) noexcept
+{
+    agg.num_finite++;
+
+    agg.min = std::min(agg.min, value);
+    agg.max = std::max(agg.max, value);
+
+    double delta = value - agg.mean;
+
+    agg.mean += delta / static_cast<double>(agg.num_finite);
+    agg.m2 += delta * (value - agg.mean);
+
+    agg.sketch.add(value);
+}
+
+void add_number(Column_aggregate &agg, double value) noexcept
+{
+    agg.num_values++;
+
+    agg.values.add(hash_value(value));
+
+    if (std::isnan(value)) {
+        agg.num_nulls++;
+
+        return;
+    }
+
+    agg.num_numeric++;
+
+    if (std::isfinite(value)) {
+        add_finite(agg, value);
+    }
+}
+
+bool is_null_like(std::string_view s, const std::vector<std::string> &null_like_values) noexcept
+{
+    s = trim(s);
+
+    return std::any_of(
+        null_like_values.begin(), null_like_values.end(), [s](const std::string &value) {
+            return std::equal(value.begin(), value.end(), s.begin(), s.end(), [](char a, char b) {
+                return a == std::tolower(static_cast<unsigned char>(b));
+            });
+        });
+}
+
+void add_words(Column_aggregate &agg, std::string_view s) noexcept
+{
+    auto is_space = [](char chr) {
+        return std::isspace(static_cast<unsigned char>(chr)) != 0;
+    };
+
+    auto pos = s.begin();
+    while (true) {
+        auto word_beg = std::find_if_not(pos, s.end(), is_space);
+        if (word_beg == s.end()) {
+            break;
+        }
+
+        pos = std::find_if(word_beg, s.end(), is_space);
+
+        agg.num_words++;
+
+        agg.words.add(hash_value(std::string_view{&*word_beg, as_size(pos - word_beg)}));
+    }
+}
+
+void add_string(Column_aggregate &agg,
+                std::string_view s,
+                const std::vector<std::string> &null_like_values) noexcept
+{
+    agg.num_values++;
+
+    agg.min_length = std::min(agg.min_length, s.size());
+    agg.max_length = std::max(agg.max_length, s.size());
+    agg.sum_length += s.size();
+
+    agg.values.add(hash_value(s));
+
+    if (agg.frequent) {
+        agg.frequent->add(s);
+    }
+
+    if (is_whitespace_only(s)) {
+        agg.num_nulls++;
+
+        return;
+    }
+
+    if (is_null_like(s, null_like_values)) {
+        agg.num_nulls++;
+
+        return;
+    }
+
+    add_words(agg, s);
+
+    double value{};
+    if (try_parse_float(s, value) != Parse_result::ok) {
+        return;
+    }
+
+    if (std::isnan(value)) {
+        agg.num_nulls++;
+
+        return;
+    }
+
+    agg.num_numeric++;
+
+    if (std::isfinite(value)) {
+        add_finite(agg, value);
+    }
+}
+
+template<Data_type dt>
+struct Aggregate_op {
+    void operator()(Column_aggregate &agg,
+                    Device_array_view arr,
+                    std::size_t begin,
+                    std::size_t end,
+                    const std::vector<std::string> &) const noexcept
+    {
+        auto values = arr.as<data_type_t<dt>>();
+
+        for (std::size_t i = begin; i < end; i++) {
+            add_number(agg, static_cast<double>(values[i]));
+        }
+    }
+};
+
+template<>
+struct Aggregate_op<Data_type::float16> {
+    void operator()(Column_aggregate &agg,
+                    Device_array_view arr,
+                    std::size_t begin,
+                    std::size_t end,
+                    const std::vector<std::string> &) const noexcept
+    {
+        auto values = arr.as<std::uint16_t>();
+
+        for (std::size_t i = begin; i < end; i++) {
+            add_number(agg, static_cast<double>(half_to_float(values[i])));
+        }
+    }
+};
+
+template<>
+struct Aggregate_op<Data_type::bfloat16> {
+    void operator()(Column_aggregate &agg,
+                    Device_array_view arr,
+                    std::size_t begin,
+                    std::size_t end,
+                    const std::vector<std::string> &) const noexcept
+    {
+        auto values = arr.as<std::uint16_t>();
+
+        for (std::size_t i = begin; i < end; i++) {
+            add_number(agg, static_cast<double>(bfloat16_to_float(values[i])));
+        }
+    }
+};
+
+template<>
+struct Aggregate_op<Data_type::string> {
+    void operator()(Column_aggregate &agg,
+                    Device_array_view arr,
+                    std::size_t begin,
+                    std::size_t end,
+                    const std::vector<std::string> &null_like_values) const noexcept
+    {
+        auto values = arr.as<std::string>();
+
+        for (std::size_t i = begin; i < end; i++) {
+            add_string(agg, values[i], null_like_values);
+        }
+    }
+};
+
+void merge(Column_aggregate &agg, const Column_aggregate &other)
+{
+    if (other.num_finite > 0) {
+        auto n_a = static_cast<double>(agg.num_finite);
+        auto n_b = static_cast<double>(other.num_finite);
+        auto n = n_a + n_b;
+
+        // See the parallel algorithm of Chan et al.
+        double delta = other.mean - agg.mean;
+
+        agg.mean += delta * n_b / n;
+        agg.m2 += other.m2 + delta * delta * n_a * n_b / n;
+
+        agg.min = std::min(agg.min, other.min);
+        agg.max = std::max(agg.max, other.max);
+    }
+
+    agg.num_values += other.num_values;
+    agg.num_nulls += other.num_nulls;
+    agg.num_numeric += other.num_numeric;
+    agg.num_finite += other.num_finite;
+
+    agg.min_length = std::min(agg.min_length, other.min_length);
+    agg.max_length = std::max(agg.max_length, other.max_length);
+    agg.sum_length += other.sum_length;
+
+    agg.num_words += other.num_words;
+
+    agg.sketch.merge(other.sketch);
+
+    if (agg.frequent) {
+        agg.frequent->merge(*other.frequent);
+    }
+
+    agg.values.merge(other.values);
+    agg.words.merge(other.words);
+}
+
+bool is_row_major(const Dense_tensor &tensor) noexcept
+{
+    const Size_vector &shape = tensor.shape();
+    const Ssize_vector &strides = tensor.strides();
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = shape.size(); i > 0; i--) {
+        if (shape[i - 1] > 1 && strides[i - 1] != stride) {
+            return false;
+        }
+        stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+    }
+    return true;
+}
+
+}  // namespace
+
+// Describes the values of a feature that should be aggregated.
+struct Column_values {
+    std::size_t column_idx;
+    Device_array_view data;
+    std::size_t num_values;
+    // Set if the values are held by a String_tensor, in which case
+    // data refers to its offsets.
+    const String_tensor *strings{};
+};
+
+namespace {
+
+Column_values get_column_values(const Tensor &tensor,
+                                const std::string &name,
+                                std::size_t column_idx,
+                                std::size_t padding)
+{
+    if (auto *dense = dynamic_cast<const Dense_tensor *>(&tensor)) {
+        if (!is_row_major(*dense)) {
+            throw Not_supported_error{fmt::format(
+                "The statistics of the feature '{0}' cannot be computed as it is not a contiguous "
+                "dense tensor.",
+                name)};
+        }
+
+        const Size_vector &shape = dense->shape();
+
+        // The padded instances are at the end of the batch.
+        std::size_t num_values = shape.empty() ? 1 : shape[0] - padding;
+        for (std::size_t dim = 1; dim < shape.size(); dim++) {
+            num_values *= shape[dim];
+        }
+
+        return {column_idx, dense->data(), num_values};
+    }
+    if (auto *strings = dynamic_cast<const String_tensor *>(&tensor)) {
+        // A String_tensor holds a single value per instance.
+        return {column_idx, strings->offsets(), strings->size() - padding, strings};
+    }
+    if (auto *coo = dynamic_cast<const Coo_tensor *>(&tensor)) {
+        return {column_idx, coo->data(), coo->data().size()};
+    }
+    if (auto *csr = dynamic_cast<const Csr_tensor *>(&tensor)) {
+        return {column_idx, csr->data(), csr->data().size()};
+    }
+
+    throw Not_supported_error{fmt::format(
+        "The statistics of the feature '{0}' cannot be computed as its tensor type is not "
+        "supported.",
+        name)};
+}
+
+void aggregate_values(Column_aggregate &agg,
+                      const Column_values &values,
+                      std::size_t begin,
+                      std::size_t end,
+                      const std::vector<std::string> &null_like_values)
+{
+    if (values.strings != nullptr) {
+        for (std::size_t i = begin; i < end; i++) {
+            add_string(agg, values.strings->value(i), null_like_values);
+        }
+    }
+    else {
+        dispatch<Aggregate_op>(
+            values.data.data_type(), agg, values.data, begin, end, null_like_values);
+    }
+}
+
+}  // namespace
+
+class Column_partials {
+public:
+    tbb::enumerable_thread_specific<std::vector<Column_aggregate>> locals{};
+};
+
+}  // namespace detail
+
+Column_statistics_collector::Column_statistics_collector(Column_statistics_params params)
+    : params_{std::move(params)}, partials_{std::make_unique<detail::Column_partials>()}
+{
+    // Validate the parameters early.
+    detail::Column_aggregate{params_, true};
+
+    null_like_values_.reserve(params_.null_like_values.size());
+
+    // Lowercase and trim the null-like values once instead of for every
+    // string.
+    for (const std::string &value : params_.null_like_values) {
+        std::string s{trim(value)};
+
+        std::transform(s.begin(), s.end(), s.begin(), [](char chr) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(chr)));
+        });
+
+        null_like_values_.emplace_back(std::move(s));
+    }
+}
+
+Column_statistics_collector::~Column_statistics_collector() = default;
+
+void Column_statistics_collector::add(const Example &example)
+{
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+
+    if (names_.empty()) {
+        lock.unlock();
+
+        {
+            std::unique_lock<std::shared_mutex> init_lock{mutex_};
+
+            if (names_.empty()) {
+                init_columns(example.schema());
+            }
+        }
+
+        lock.lock();
+    }
+
+    const std::vector<Attribute> &attrs = example.schema().attributes();
+
+    if (attrs.size() != names_.size()) {
+        throw std::invalid_argument{
+            "The example has a different number of features than the previous examples."};
+    }
+
+    std::vector<detail::Column_values> columns{};
+    columns.reserve(attrs.size());
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        if (attrs[i].name() != names_[i] || attrs[i].data_type() != data_types_[i]) {
+            throw std::invalid_argument{fmt::format(
+                "The feature '{0}' does not match the attribute of the previous examples.",
+                attrs[i].name())};
+        }
+
+        columns.emplace_back(detail::get_column_values(
+            *example.features()[i], attrs[i].name(), i, example.padding));
+    }
+
+    aggregate(columns);
+}
+
+void Column_statistics_collector::add(stdx::span<const Column_chunk> chunks)
+{
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+
+    if (names_.empty()) {
+        lock.unlock();
+
+        {
+            std::unique_lock<std::shared_mutex> init_lock{mutex_};
+
+            if (names_.empty()) {
+                init_columns(chunks);
+            }
+        }
+
+        lock.lock();
+    }
+
+    if (chunks.size() != names_.size()) {
+        throw std::invalid_argument{
+            "The number of column chunks is different than in the previous calls."};
+    }
+
+    std::vector<detail::Column_values> columns{};
+    columns.reserve(chunks.size());
+
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        const Column_chunk &chunk = chunks[i];
+
+        if (chunk.values == nullptr) {
+            throw std::invalid_argument{
+                fmt::format("The column chunk '{0}' has no values.", chunk.name)};
+        }
+
+        if (chunk.name != names_[i] || chunk.values->data_type() != data_types_[i]) {
+            throw std::invalid_argument{fmt::format(
+                "The column chunk '{0}' does not match the column of the previous calls.",
+                chunk.name)};
+        }
+
+        const Size_vector &shape = chunk.values->shape();
+        if (shape.empty() || chunk.num_rows > shape[0]) {
+            throw std::invalid_argument{fmt::format(
+                "The column chunk '{0}' has more rows than its values.", chunk.name)};
+        }
+
+        columns.emplace_back(
+            detail::get_column_values(*chunk.values, chunk.name, i, shape[0] - chunk.num_rows));
+    }
+
+    aggregate(columns);
+}
+
+void Column_statistics_collector::aggregate(const std::vector<detail::Column_values> &columns)
+{
+    for (const detail::Column_values &values : columns) {
+        if (values.data.device().kind() != Device_kind::cpu()) {
+            throw Not_supported_error{
+                "The statistics can only be computed for examples that reside in CPU memory."};
+        }
+    }
+
+    // Split the columns into tasks of roughly the grain size; small
+    // examples are therefore aggregated on the calling thread.
+    std::vector<std::pair<std::size_t, std::size_t>> tasks{};
+    for (std::size_t i = 0; i < columns.size(); i++) {
+        for (std::size_t begin = 0; begin < columns[i].num_values; begin += detail::grain_size) {
+            tasks.emplace_back(i, begin);
+        }
+    }
+
+    auto aggregate = [this, &columns, &tasks](std::size_t task_idx) {
+        std::vector<detail::Column_aggregate> &aggs = partials_->locals.local();
+        if (aggs.empty()) {
+            aggs.reserve(data_types_.size());
+
+            for (Data_type dt : data_types_) {
+                aggs.emplace_back(params_, dt == Data_type::string);
+            }
+        }
+
+        auto [column_idx, begin] = tasks[task_idx];
+
+        const detail::Column_values &values = columns[column_idx];
+
+        std::size_t end = std::min(begin + detail::grain_size, values.num_values);
+
+        detail::aggregate_values(aggs[column_idx], values, begin, end, null_like_values_);
+    };
+
+    if (tasks.size() == 1) {
+        aggregate(0);
+    }
+    else {
+        tbb::parallel_for(std::size_t{0}, tasks.size(), aggregate);
+    }
+}
+
+void Column_statistics_collector::init_columns(const Schema &schema)
+{
+    for (const Attribute &attr : schema.attributes()) {
+        names_.emplace_back(attr.name());
+
+        data_types_.emplace_back(attr.data_type());
+    }
+}
+
+void Column_statistics_collector::init_columns(stdx::span<const Column_chunk> chunks)
+{
+    for (const Column_chunk &chunk : chunks) {
+        if (chunk.values == nullptr) {
+            throw std::invalid_argument{
+                fmt::format("The column chunk '{0}' has no values.", chunk.name)};
+        }
+    }
+
+    for (const Column_chunk &chunk : chunks) {
+        names_.emplace_back(chunk.name);
+
+        data_types_.emplace_back(chunk.values->data_type());
+    }
+}
+
+std::vector<Column_statistics> Column_statistics_collector::statistics() const
+{
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+
+    std::vector<Column_statistics> result(names_.size());
+
+    // Merge the partial statistics of the threads one column per task.
+    tbb::parallel_for(std::size_t{0}, names_.size(), [this, &result](std::size_t i) {
+        detail::Column_aggregate agg{params_, data_types_[i] == Data_type::string};
+
+        for (const std::vector<detail::Column_aggregate> &aggs : partials_->locals) {
+            if (!aggs.empty()) {
+                detail::merge(agg, aggs[i]);
+            }
+        }
+
+        Column_statistics &stats = result[i];
+
+        stats.name = names_[i];
+        stats.data_type = data_types_[i];
+        stats.num_values = agg.num_values;
+        stats.num_nulls = agg.num_nulls;
+        stats.num_numeric = agg.num_numeric;
+        stats.num_finite = agg.num_finite;
+
+        if (agg.num_finite > 0) {
+            stats.min = agg.min;
+            stats.max = agg.max;
+            stats.mean = agg.mean;
+            stats.variance = agg.m2 / static_cast<double>(agg.num_finite);
+            stats.quantile_sketch = std::move(agg.sketch);
+        }
+
+        if (data_types_[i] == Data_type::string && agg.num_values > 0) {
+            stats.min_length = agg.min_length;
+            stats.max_length = agg.max_length;
+            stats.mean_length =
+                static_cast<double>(agg.sum_length) / static_cast<double>(agg.num_values);
+
+            stats.num_words = agg.num_words;
+
+            stats.approx_distinct_word_count =
+                static_cast<std::size_t>(std::llround(agg.words.estimate()));
+        }
+
+        stats.approx_distinct_count = static_cast<std::size_t>(std::llround(agg.values.estimate()));
+
+        stats.frequent_values = std::move(agg.frequent);
+    });
+
+    return result;
+}
+
+void Column_statistics_collector::reset()
+{
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+
+    partials_->locals.clear();
+
+    names_.clear();
+    data_types_.clear();
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,448 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/columnar_reader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/columnar_format.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/record_readers/record_reader_base.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+#include "mlio/streams/detail/zstd.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+std::size_t get_row_size(const Columnar_column &column)
+{
+    std::size_t size = dispatch<Element_size_op>(column.data_type);
+    for (std::size_t dim : column.shape) {
+        size *= dim;
+    }
+    return size;
+}
+
+void read_fully(Input_stream &stream, Mutable_memory_span destination)
+{
+    while (!destination.empty()) {
+        std::size_t num_bytes_read = stream.read(destination);
+        if (num_bytes_read == 0) {
+            throw Corrupt_record_error{"The columnar file ends unexpectedly."};
+        }
+
+        destination = destination.subspan(num_bytes_read);
+    }
+}
+
+// Returns the byte range of the specified block within the file.
+std::pair<std::uint64_t, std::uint64_t> get_block_range(const Columnar_block &block) noexcept
+{
+    const Columnar_chunk &last = block.chunks.back();
+
+    return {block.chunks.front().offset, last.offset + last.stored_size};
+}
+
+// Verifies that the chunks of the blocks are in order, do not overlap,
+// and lie within the data section of the file.
+bool is_valid_footer(const Columnar_footer &footer, std::uint64_t data_size)
+{
+    if (footer.columns.empty() && !footer.blocks.empty()) {
+        return false;
+    }
+
+    std::vector<std::size_t> row_sizes{};
+    row_sizes.reserve(footer.columns.size());
+
+    for (const Columnar_column &column : footer.columns) {
+        row_sizes.emplace_back(get_row_size(column));
+    }
+
+    std::uint64_t end = columnar_magic.size();
+
+    for (const Columnar_block &block : footer.blocks) {
+        for (std::size_t i = 0; i < block.chunks.size(); i++) {
+            const Columnar_chunk &chunk = block.chunks[i];
+
+            if (chunk.offset < end || chunk.offset > data_size ||
+                chunk.stored_size > data_size - chunk.offset) {
+                return false;
+            }
+
+            // The division guards against an overflowing product.
+            if (block.num_rows == 0 || chunk.size / block.num_rows != row_sizes[i] ||
+                chunk.size % block.num_rows != 0) {
+                return false;
+            }
+
+            if (footer.columns[i].compression == Columnar_compression::none &&
+                chunk.stored_size != chunk.size) {
+                return false;
+            }
+
+            end = chunk.offset + chunk.stored_size;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+class Columnar_block_reader final : public Record_reader_base {
+public:
+    explicit Columnar_block_reader(Intrusive_ptr<Input_stream> stream,
+                                   std::shared_ptr<const Columnar_footer> footer)
+        : stream_{std::move(stream)}, footer_{std::move(footer)}
+    {}
+
+private:
+    std::optional<Record> read_record_core() final;
+
+    Intrusive_ptr<Input_stream> stream_;
+    std::shared_ptr<const Columnar_footer> footer_;
+    std::size_t block_pos_{};
+};
+
+std::optional<Record> Columnar_block_reader::read_record_core()
+{
+    if (block_pos_ == footer_->blocks.size()) {
+        return {};
+    }
+
+    auto [begin, end] = get_block_range(footer_->blocks[block_pos_++]);
+
+    std::size_t size = end - begin;
+
+    stream_->seek(begin);
+
+    // A memory-mapped file hands out the block without copying it.
+    if (stream_->supports_zero_copy()) {
+        Memory_slice bits = stream_->read(size);
+        if (bits.size() != size) {
+            throw Corrupt_record_error{"The columnar file ends unexpectedly."};
+        }
+
+        return Record{std::move(bits)};
+    }
+
+    auto block = memory_allocator().allocate(size);
+
+    read_fully(*stream_, *block);
+
+    return Record{Memory_slice{std::move(block)}};
+}
+
+}  // namespace detail
+
+Columnar_reader::Columnar_reader(Data_reader_params params)
+    : Parallel_data_reader{std::move(params)}
+{}
+
+Columnar_reader::~Columnar_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Columnar_reader::make_record_reader(const Data_store &store)
+{
+    auto stream = store.open_read();
+
+    std::shared_ptr<const detail::Columnar_footer> footer = read_footer(store, *stream);
+
+    return make_intrusive<detail::Columnar_block_reader>(std::move(stream), std::move(footer));
+}
+
+std::shared_ptr<const detail::Columnar_footer>
+Columnar_reader::read_footer(const Data_store &store, Input_stream &stream)
+{
+    if (!stream.seekable()) {
+        throw Not_supported_error{fmt::format(
+            "The data store '{0}' is not seekable. Columnar files cannot be read from compressed or streamed data stores.",
+            store.id())};
+    }
+
+    std::size_t file_size = stream.size();
+    if (file_size < detail::columnar_magic.size() + detail::columnar_trailer_size) {
+        throw Corrupt_footer_error{
+            fmt::format("The data store '{0}' is not a valid columnar file.", store.id())};
+    }
+
+    std::array<std::byte, detail::columnar_trailer_size> trailer{};
+
+    stream.seek(file_size - trailer.size());
+
+    detail::read_fully(stream, trailer);
+
+    if (std::memcmp(trailer.data() + sizeof(std::uint64_t),
+                    detail::columnar_magic.data(),
+                    detail::columnar_magic.size()) != 0) {
+        throw Corrupt_footer_error{
+            fmt::format("The data store '{0}' is not a valid columnar file.", store.id())};
+    }
+
+    std::uint64_t footer_size{};
+    std::memcpy(&footer_size, trailer.data(), sizeof(footer_size));
+
+    std::size_t data_size = file_size - trailer.size();
+
+    if (footer_size > data_size - detail::columnar_magic.size()) {
+        throw Corrupt_footer_error{fmt::format(
+            "The columnar file in the data store '{0}' has an invalid footer size.", store.id())};
+    }
+
+    data_size -= footer_size;
+
+    std::vector<std::byte> footer_bits(footer_size);
+
+    stream.seek(data_size);
+
+    detail::read_fully(stream, footer_bits);
+
+    auto footer = std::make_shared<detail::Columnar_footer>();
+
+    try {
+        *footer = detail::decode_columnar_footer(footer_bits);
+    }
+    catch (const std::invalid_argument &e) {
+        throw Corrupt_footer_error{fmt::format(
+            "The footer of the columnar file in the data store '{0}' cannot be parsed: {1}",
+            store.id(),
+            e.what())};
+    }
+
+    if (!detail::is_valid_footer(*footer, data_size)) {
+        throw Corrupt_footer_error{fmt::format(
+            "The footer of the columnar file in the data store '{0}' has invalid block offsets.",
+            store.id())};
+    }
+
+    std::unique_lock<std::mutex> lock{footer_mutex_};
+
+    footers_[&store] = footer;
+
+    return footer;
+}
+
+std::shared_ptr<const detail::Columnar_footer>
+Columnar_reader::get_footer(const Data_store &store) const
+{
+    std::unique_lock<std::mutex> lock{footer_mutex_};
+
+    auto pos = footers_.find(&store);
+    if (pos == footers_.end()) {
+        throw std::logic_error{"The footer of the columnar file has not been read."};
+    }
+
+    return pos->second;
+}
+
+Intrusive_ptr<const Schema> Columnar_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    std::vector<Attribute> attrs{};
+
+    if (instance) {
+        std::shared_ptr<const detail::Columnar_footer> footer = get_footer(instance->data_store());
+
+        for (const detail::Columnar_column &column : footer->columns) {
+            // The number of rows in an example depends on the blocks it
+            // contains.
+            Size_vector shape{0};
+            shape.insert(shape.end(), column.shape.begin(), column.shape.end());
+
+            attrs.emplace_back(column.name, column.data_type, std::move(shape));
+        }
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Columnar_reader::decode(const Instance_batch &batch) const
+{
+    const std::vector<Attribute> &attrs = schema()->attributes();
+
+    struct Block_ref {
+        const Instance *instance;
+        const detail::Columnar_block *block;
+        std::size_t row_offset;
+        std::shared_ptr<const detail::Columnar_footer> footer;
+    };
+
+    std::vector<Block_ref> blocks{};
+    blocks.reserve(batch.instances().size());
+
+    std::size_t num_rows = 0;
+
+    for (const Instance &instance : batch.instances()) {
+        std::shared_ptr<const detail::Columnar_footer> footer = get_footer(instance.data_store());
+
+        bool matches_schema = footer->columns.size() == attrs.size();
+        for (std::size_t i = 0; i < attrs.size() && matches_schema; i++) {
+            const detail::Columnar_column &column = footer->columns[i];
+
+            const Size_vector &shape = attrs[i].shape();
+
+            matches_schema = column.name == attrs[i].name() &&
+                             column.data_type == attrs[i].data_type() &&
+                             std::equal(shape.begin() + 1,
+                                        shape.end(),
+                                        column.shape.begin(),
+                                        column.shape.end());
+        }
+
+        if (!matches_schema) {
+            throw Schema_error{fmt::format(
+                "The columns of the columnar file in the data store '{0}' do not match the schema of the dataset.",
+                instance.data_store().id())};
+        }
+
+        // The record readers do not skip blocks; the index of an
+        // instance is therefore the index of its block.
+        if (instance.index() >= footer->blocks.size()) {
+            throw Invalid_instance_error{fmt::format(
+                "The block #{1:n} does not exist in the data store '{0}'.",
+                instance.data_store().id(),
+                instance.index())};
+        }
+
+        const detail::Columnar_block &block = footer->blocks[instance.index()];
+
+        blocks.push_back({&instance, &block, num_rows, std::move(footer)});
+
+        num_rows += static_cast<std::size_t>(block.num_rows);
+    }
+
+    std::vector<Intrusive_ptr<Dense_tensor>> tensors{};
+    tensors.reserve(attrs.size());
+
+    std::vector<std::size_t> row_sizes{};
+    row_sizes.reserve(attrs.size());
+
+    for (const Attribute &attr : attrs) {
+        Size_vector shape = attr.shape();
+
+        shape[0] = num_rows;
+
+        std::size_t num_elements = 1;
+        for (std::size_t dim : shape) {
+            num_elements *= dim;
+        }
+
+        std::size_t row_size = dispatch<detail::Element_size_op>(attr.data_type());
+        for (auto pos = shape.begin() + 1; pos < shape.end(); ++pos) {
+            row_size *= *pos;
+        }
+
+        row_sizes.emplace_back(row_size);
+
+        auto arr = make_pooled_cpu_array(attr.data_type(), num_elements);
+
+        tensors.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(arr)));
+    }
+
+    // Each column chunk of the batch is copied or decompressed by a
+    // separate task.
+    std::size_t num_tasks = blocks.size() * attrs.size();
+
+    auto worker = [&](const tbb::blocked_range<std::size_t> &range) {
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            const Block_ref &ref = blocks[i / attrs.size()];
+
+            std::size_t column = i % attrs.size();
+
+            const detail::Columnar_chunk &chunk = ref.block->chunks[column];
+
+            Memory_span bits = ref.instance->bits();
+
+            bits = bits.subspan(chunk.offset - ref.block->chunks[0].offset,
+                                static_cast<std::size_t>(chunk.stored_size));
+
+            auto *data = static_cast<std::byte *>(tensors[column]->data().data());
+
+            Mutable_memory_span destination{data + ref.row_offset * row_sizes[column],
+                                            static_cast<std::size_t>(chunk.size)};
+
+            if (ref.footer->columns[column].compression == Columnar_compression::none) {
+                std::memcpy(destination.data(), bits.data(), bits.size());
+
+                continue;
+            }
+
+            try {
+                detail::zstd_decompress(bits, destination);
+            }
+            catch (const std::exception &e) {
+                throw Invalid_instance_error{fmt::format(
+                    "The column '{2}' of the block #{1:n} in the data store '{0}' cannot be decompressed: {3}",
+                    ref.instance->data_store().id(),
+                    ref.instance->index(),
+                    attrs[column].name(),
+                    e.what())};
+            }
+        }
+    };
+
+    tbb::blocked_range<std::size_t> range{0, num_tasks};
+
+    if (num_tasks > 1 && should_decode_parallel(num_rows, attrs.size())) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(range);
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> features{tensors.begin(), tensors.end()};
+
+    return make_intrusive<Example>(schema(), std::move(features));
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,320 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/columnar_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/config.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/columnar_format.h"
+#include "mlio/detail/error.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/detail/util.h"
+#include "mlio/streams/detail/zstd.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+bool is_row_major(const Dense_tensor &tensor) noexcept
+{
+    const Size_vector &shape = tensor.shape();
+    const Ssize_vector &strides = tensor.strides();
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = shape.size(); i > 0; i--) {
+        if (shape[i - 1] > 1 && strides[i - 1] != stride) {
+            return false;
+        }
+        stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+    }
+    return true;
+}
+
+const Dense_tensor &get_dense_tensor(const Example &example, std::size_t idx)
+{
+    const Attribute &attr = example.schema().attributes()[idx];
+
+    auto *tensor = dynamic_cast<const Dense_tensor *>(example.features()[idx].get());
+    if (tensor == nullptr || !is_row_major(*tensor) || tensor->shape().empty()) {
+        throw Not_supported_error{fmt::format(
+            "The feature '{0}' cannot be written as it is not a contiguous dense tensor.",
+            attr.name())};
+    }
+
+    if (tensor->data_type() == Data_type::string) {
+        throw Not_supported_error{fmt::format(
+            "The feature '{0}' cannot be written as it is of the string data type.", attr.name())};
+    }
+
+    return *tensor;
+}
+
+}  // namespace
+}  // namespace detail
+
+Columnar_writer::Columnar_writer(std::string path, Columnar_writer_params params)
+    : path_{std::move(path)}
+    , tmp_path_{path_ + ".tmp"}
+    , params_{params}
+    , footer_{std::make_unique<detail::Columnar_footer>()}
+{
+    std::size_t alignment = params_.alignment;
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument{"The alignment must be a power of two."};
+    }
+
+    if (params_.compression == Columnar_compression::zstd && !supports_zstd()) {
+        throw Not_supported_error{"MLIO was not built with Zstandard support."};
+    }
+
+    footer_->alignment = alignment;
+
+    file_.open(tmp_path_, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The columnar file '{0}' cannot be created.", path_)};
+    }
+
+    write(detail::columnar_magic.data(), detail::columnar_magic.size());
+
+    write_padding();
+}
+
+Columnar_writer::~Columnar_writer()
+{
+    if (!closed_) {
+        file_.close();
+
+        std::remove(tmp_path_.c_str());
+    }
+}
+
+void Columnar_writer::write_example(const Example &example)
+{
+    if (closed_) {
+        throw std::logic_error{"The columnar writer is already closed."};
+    }
+
+    if (footer_->blocks.empty()) {
+        init_columns(example);
+    }
+
+    const std::vector<detail::Columnar_column> &columns = footer_->columns;
+
+    const std::vector<Attribute> &attrs = example.schema().attributes();
+    if (attrs.size() != columns.size()) {
+        throw std::invalid_argument{
+            "The example does not match the schema of the previously written examples."};
+    }
+
+    std::vector<Memory_span> chunks{};
+    chunks.reserve(columns.size());
+
+    std::size_t num_rows{};
+
+    for (std::size_t i = 0; i < columns.size(); i++) {
+        const Dense_tensor &tensor = detail::get_dense_tensor(example, i);
+
+        const Size_vector &shape = tensor.shape();
+
+        bool matches_column = attrs[i].name() == columns[i].name &&
+                              tensor.data_type() == columns[i].data_type &&
+                              std::equal(shape.begin() + 1,
+                                         shape.end(),
+                                         columns[i].shape.begin(),
+                                         columns[i].shape.end());
+        if (!matches_column) {
+            throw std::invalid_argument{fmt::format(
+                "The feature '{0}' does not match the schema of the previously written examples.",
+                attrs[i].name())};
+        }
+
+        num_rows = shape[0] - example.padding;
+
+        std::size_t row_size = dispatch<detail::Element_size_op>(tensor.data_type());
+        for (std::size_t dim : columns[i].shape) {
+            row_size *= dim;
+        }
+
+        const auto *data = static_cast<const std::byte *>(tensor.data().data());
+
+        chunks.emplace_back(data, num_rows * row_size);
+    }
+
+    if (num_rows == 0) {
+        return;
+    }
+
+    detail::Columnar_block &block = footer_->blocks.emplace_back();
+
+    block.num_rows = num_rows;
+    block.chunks.resize(columns.size());
+
+    if (params_.compression == Columnar_compression::none) {
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            block.chunks[i] = {offset_, chunks[i].size(), chunks[i].size()};
+
+            write(chunks[i].data(), chunks[i].size());
+
+            write_padding();
+        }
+    }
+    else {
+        std::vector<std::vector<std::byte>> compressed(chunks.size());
+
+        // Compressing is by far the most expensive part of writing; the
+        // chunks are compressed in parallel.
+        tbb::parallel_for(std::size_t{0}, chunks.size(), [&](std::size_t i) {
+            std::vector<std::byte> &bits = compressed[i];
+
+            bits.resize(detail::zstd_compress_bound(chunks[i].size()));
+
+            bits.resize(detail::zstd_compress(chunks[i], bits, params_.compression_level));
+        });
+
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            block.chunks[i] = {offset_, compressed[i].size(), chunks[i].size()};
+
+            write(compressed[i].data(), compressed[i].size());
+
+            write_padding();
+        }
+    }
+
+    check_file();
+
+    num_instances_ += num_rows;
+}
+
+void Columnar_writer::init_columns(const Example &example)
+{
+    std::vector<detail::Columnar_column> columns{};
+
+    const std::vector<Attribute> &attrs = example.schema().attributes();
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        const Dense_tensor &tensor = detail::get_dense_tensor(example, i);
+
+        detail::Columnar_column &column = columns.emplace_back();
+
+        column.name = attrs[i].name();
+        column.data_type = tensor.data_type();
+        column.shape.assign(tensor.shape().begin() + 1, tensor.shape().end());
+        column.compression = params_.compression;
+    }
+
+    footer_->columns = std::move(columns);
+}
+
+void Columnar_writer::close()
+{
+    if (closed_) {
+        return;
+    }
+
+    std::vector<std::byte> footer = detail::encode_columnar_footer(*footer_);
+
+    std::uint64_t footer_size = footer.size();
+
+    write(footer.data(), footer.size());
+    write(&footer_size, sizeof(footer_size));
+    write(detail::columnar_magic.data(), detail::columnar_magic.size());
+
+    file_.close();
+
+    check_file();
+
+    if (std::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The columnar file '{0}' cannot be written.", path_)};
+    }
+
+    closed_ = true;
+}
+
+void Columnar_writer::write(const void *data, std::size_t size)
+{
+    file_.write(static_cast<const char *>(data), as_ssize(size));
+
+    offset_ += size;
+}
+
+void Columnar_writer::write_padding()
+{
+    static constexpr std::array<char, 64> zeros{};
+
+    std::size_t size = detail::align(offset_, params_.alignment) - offset_;
+    while (size > 0) {
+        std::size_t n = std::min(size, zeros.size());
+
+        write(zeros.data(), n);
+
+        size -= n;
+    }
+}
+
+void Columnar_writer::check_file() const
+{
+    if (!file_) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The columnar file '{0}' cannot be written.", path_)};
+    }
+}
+
+void write_columnar_file(const std::string &path,
+                         Data_reader &reader,
+                         const Columnar_writer_params &params)
+{
+    Columnar_writer writer{path, params};
+
+    reader.reset();
+
+    Intrusive_ptr<Example> example{};
+    while ((example = reader.read_example()) != nullptr) {
+        writer.write_example(*example);
+    }
+
+    writer.close();
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
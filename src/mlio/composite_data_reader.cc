@@ -0,0 +1,342 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/composite_data_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/example.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// Returns the schema that the non-empty child readers share.
+Intrusive_ptr<const Schema>
+get_common_schema(const std::vector<Intrusive_ptr<const Schema>> &schemas)
+{
+    Intrusive_ptr<const Schema> common{};
+
+    for (const Intrusive_ptr<const Schema> &schema : schemas) {
+        if (schema == nullptr) {
+            continue;
+        }
+
+        if (common == nullptr) {
+            common = schema;
+        }
+        else if (*schema != *common) {
+            throw Schema_error{"The child readers must have the same schema."};
+        }
+    }
+
+    return common;
+}
+
+}  // namespace
+}  // namespace detail
+
+Composite_data_reader::Composite_data_reader(std::vector<Intrusive_ptr<Data_reader>> children)
+    : children_{std::move(children)}
+{
+    if (children_.empty()) {
+        throw std::invalid_argument{"At least one child reader must be specified."};
+    }
+
+    for (const Intrusive_ptr<Data_reader> &child : children_) {
+        if (child == nullptr) {
+            throw std::invalid_argument{"The child readers must not be null."};
+        }
+    }
+}
+
+Composite_data_reader::~Composite_data_reader() = default;
+
+Intrusive_ptr<const Schema> Composite_data_reader::read_schema()
+{
+    ensure_schema_merged();
+
+    return schema_;
+}
+
+Intrusive_ptr<Example> Composite_data_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+
+    ensure_schema_merged();
+
+    return read_example_core();
+}
+
+Intrusive_ptr<Example> Composite_data_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        ensure_schema_merged();
+
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+void Composite_data_reader::reset() noexcept
+{
+    peeked_example_ = nullptr;
+
+    for (const Intrusive_ptr<Data_reader> &child : children_) {
+        child->reset();
+    }
+}
+
+std::size_t Composite_data_reader::num_bytes_read() const noexcept
+{
+    std::size_t num_bytes_read = 0;
+    for (const Intrusive_ptr<Data_reader> &child : children_) {
+        num_bytes_read += child->num_bytes_read();
+    }
+    return num_bytes_read;
+}
+
+std::size_t Composite_data_reader::shuffle_buffer_size() const noexcept
+{
+    std::size_t size = 0;
+    for (const Intrusive_ptr<Data_reader> &child : children_) {
+        size += child->shuffle_buffer_size();
+    }
+    return size;
+}
+
+void Composite_data_reader::ensure_schema_merged()
+{
+    if (schema_merged_) {
+        return;
+    }
+
+    std::vector<Intrusive_ptr<const Schema>> schemas{};
+    schemas.reserve(children_.size());
+
+    for (const Intrusive_ptr<Data_reader> &child : children_) {
+        schemas.emplace_back(child->read_schema());
+    }
+
+    schema_ = merge_schemas(schemas);
+
+    schema_merged_ = true;
+}
+
+Zip_reader::Zip_reader(std::vector<Intrusive_ptr<Data_reader>> children)
+    : Composite_data_reader{std::move(children)}
+{}
+
+Zip_reader::~Zip_reader() = default;
+
+Intrusive_ptr<const Schema>
+Zip_reader::merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas)
+{
+    std::vector<Attribute> attrs{};
+
+    std::unordered_set<std::string_view> names{};
+
+    for (const Intrusive_ptr<const Schema> &schema : schemas) {
+        // If any of the datasets is empty, so is the zipped one.
+        if (schema == nullptr) {
+            return {};
+        }
+
+        for (const Attribute &attr : schema->attributes()) {
+            if (!names.emplace(attr.name()).second) {
+                throw Schema_error{fmt::format(
+                    "The attribute '{0}' is returned by more than one child reader.", attr.name())};
+            }
+
+            attrs.emplace_back(attr);
+        }
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Zip_reader::read_example_core()
+{
+    if (schema() == nullptr) {
+        return {};
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> features{};
+    features.reserve(schema()->attributes().size());
+
+    std::optional<std::size_t> batch_size{};
+
+    std::size_t padding = 0;
+
+    for (const Intrusive_ptr<Data_reader> &child : children()) {
+        Intrusive_ptr<Example> example = child->read_example();
+        if (example == nullptr) {
+            return {};
+        }
+
+        for (const Intrusive_ptr<Tensor> &feature : example->features()) {
+            std::size_t size = feature->shape()[0];
+            if (batch_size == std::nullopt) {
+                batch_size = size;
+            }
+            else if (size != *batch_size) {
+                throw Data_reader_error{fmt::format(
+                    "The child readers have returned examples of {0:n} and {1:n} instance(s).",
+                    *batch_size,
+                    size)};
+            }
+
+            features.emplace_back(feature);
+        }
+
+        padding = std::max(padding, example->padding);
+    }
+
+    auto example = make_intrusive<Example>(schema(), std::move(features));
+
+    example->padding = padding;
+
+    return example;
+}
+
+Concat_reader::Concat_reader(std::vector<Intrusive_ptr<Data_reader>> children)
+    : Composite_data_reader{std::move(children)}
+{}
+
+Concat_reader::~Concat_reader() = default;
+
+void Concat_reader::reset() noexcept
+{
+    Composite_data_reader::reset();
+
+    child_idx_ = 0;
+}
+
+Intrusive_ptr<const Schema>
+Concat_reader::merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas)
+{
+    return detail::get_common_schema(schemas);
+}
+
+Intrusive_ptr<Example> Concat_reader::read_example_core()
+{
+    for (; child_idx_ < children().size(); child_idx_++) {
+        Intrusive_ptr<Example> example = children()[child_idx_]->read_example();
+        if (example != nullptr) {
+            return example;
+        }
+    }
+    return {};
+}
+
+Mixture_reader::Mixture_reader(std::vector<Intrusive_ptr<Data_reader>> children,
+                               Mixture_params params)
+    : Composite_data_reader{std::move(children)}, params_{std::move(params)}
+{
+    std::vector<double> &weights = params_.weights;
+
+    if (weights.empty()) {
+        weights.resize(this->children().size(), 1.0);
+    }
+    else if (weights.size() != this->children().size()) {
+        throw std::invalid_argument{
+            "The number of weights must match the number of child readers."};
+    }
+
+    for (double weight : weights) {
+        if (!std::isfinite(weight) || weight < 0) {
+            throw std::invalid_argument{"The weights must be finite and non-negative."};
+        }
+    }
+
+    if (std::accumulate(weights.begin(), weights.end(), 0.0) <= 0) {
+        throw std::invalid_argument{"At least one weight must be greater than zero."};
+    }
+
+    if (params_.seed) {
+        mt_.seed(*params_.seed);
+    }
+    else {
+        mt_.seed(std::random_device{}());
+    }
+
+    reset_distribution();
+}
+
+Mixture_reader::~Mixture_reader() = default;
+
+void Mixture_reader::reset() noexcept
+{
+    Composite_data_reader::reset();
+
+    reset_distribution();
+}
+
+void Mixture_reader::reset_distribution()
+{
+    weights_ = params_.weights;
+
+    dist_ = std::discrete_distribution<std::size_t>(weights_.begin(), weights_.end());
+
+    exhausted_ = false;
+}
+
+Intrusive_ptr<const Schema>
+Mixture_reader::merge_schemas(const std::vector<Intrusive_ptr<const Schema>> &schemas)
+{
+    return detail::get_common_schema(schemas);
+}
+
+Intrusive_ptr<Example> Mixture_reader::read_example_core()
+{
+    while (!exhausted_) {
+        std::size_t child_idx = dist_(mt_);
+
+        Intrusive_ptr<Example> example = children()[child_idx]->read_example();
+        if (example != nullptr) {
+            return example;
+        }
+
+        weights_[child_idx] = 0;
+
+        if (params_.stop_on_first_exhausted ||
+            std::all_of(weights_.begin(), weights_.end(), [](double weight) {
+                return weight <= 0;
+            })) {
+            exhausted_ = true;
+        }
+        else {
+            dist_ = std::discrete_distribution<std::size_t>(weights_.begin(), weights_.end());
+        }
+    }
+    return {};
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
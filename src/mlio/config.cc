@@ -27,6 +27,51 @@ bool supports_s3() noexcept
 #endif
 }
 
+bool supports_s3_crt() noexcept
+{
+#ifdef MLIO_BUILD_S3_CRT
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_gcs() noexcept
+{
+#ifdef MLIO_BUILD_GCS
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_azure() noexcept
+{
+#ifdef MLIO_BUILD_AZURE
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_http() noexcept
+{
+#ifdef MLIO_BUILD_HTTP
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_kafka() noexcept
+{
+#ifdef MLIO_BUILD_KAFKA
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool supports_image_reader() noexcept
 {
 #ifdef MLIO_BUILD_IMAGE_READER
@@ -36,5 +81,68 @@ bool supports_image_reader() noexcept
 #endif
 }
 
+bool supports_bzip2() noexcept
+{
+#ifdef MLIO_BUILD_BZIP2
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_zstd() noexcept
+{
+#ifdef MLIO_BUILD_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_lz4() noexcept
+{
+#ifdef MLIO_BUILD_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_isal() noexcept
+{
+#ifdef MLIO_BUILD_ISAL
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_parquet_reader() noexcept
+{
+#ifdef MLIO_BUILD_PARQUET_READER
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_orc_reader() noexcept
+{
+#ifdef MLIO_BUILD_ORC_READER
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool supports_cuda() noexcept
+{
+#ifdef MLIO_BUILD_CUDA
+    return true;
+#else
+    return false;
+#endif
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
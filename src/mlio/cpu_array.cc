@@ -15,6 +15,14 @@
 
 #include "mlio/cpu_array.h"
 
+#include <algorithm>
+#include <cstddef>
+
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/array_group.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/file_backed_memory_block.h"
+
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
@@ -24,6 +32,8 @@ template<Data_type dt>
 struct make_cpu_array_op {
     std::unique_ptr<Device_array> operator()(std::size_t size)
     {
+        record_allocation(Allocation_source::cpu_array, size * sizeof(data_type_t<dt>));
+
         return Cpu_array_access::wrap(dt, std::vector<data_type_t<dt>>(size));
     }
 };
@@ -36,5 +46,39 @@ std::unique_ptr<Device_array> make_cpu_array(Data_type dt, std::size_t size)
     return dispatch<detail::make_cpu_array_op>(dt, size);
 }
 
+std::vector<std::unique_ptr<Device_array>>
+make_cpu_arrays(stdx::span<const Data_type> dts, std::size_t size)
+{
+    std::vector<std::size_t> offsets = detail::layout_array_group(dts, size);
+
+    detail::record_allocation(detail::Allocation_source::cpu_array, offsets.back());
+
+    auto block = std::make_shared<std::vector<std::byte>>(offsets.back());
+
+    return detail::carve_array_group(block, block->data(), dts, offsets, size);
+}
+
+std::vector<std::unique_ptr<Device_array>>
+make_file_backed_cpu_arrays(stdx::span<const Data_type> dts,
+                            std::size_t size,
+                            const std::string &directory)
+{
+    std::vector<std::size_t> offsets = detail::layout_array_group(dts, size);
+
+    // A zero-sized memory map is not allowed.
+    auto block = make_intrusive<File_backed_memory_block>(std::max(offsets.back(), std::size_t{1}),
+                                                          directory);
+
+    std::byte *data = block->data();
+
+    // The block is kept alive by the arrays through the deleter of the
+    // owner; the pages of a fresh backing file read as zeros.
+    std::shared_ptr<void> owner{data, [block](void *) mutable {
+                                    block = {};
+                                }};
+
+    return detail::carve_array_group(owner, data, dts, offsets, size);
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -16,12 +16,25 @@
 
 #include "mlio/csv_reader.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <string_view>
+#include <system_error>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 
 #include <fmt/format.h>
 #include <tbb/tbb.h>
@@ -31,11 +44,20 @@
 #include "mlio/data_reader.h"
 #include "mlio/data_reader_error.h"
 #include "mlio/data_stores/data_store.h"
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/class_sampler.h"
+#include "mlio/detail/decode_warning_log.h"
+#include "mlio/detail/error.h"
+#include "mlio/detail/murmur_hash.h"
+#include "mlio/detail/row_predicate.h"
+#include "mlio/detail/string_dictionary.h"
+#include "mlio/detail/string_tensor.h"
 #include "mlio/example.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/logger.h"
 #include "mlio/memory/memory_slice.h"
+#include "mlio/not_supported_error.h"
 #include "mlio/record_readers/csv_record_reader.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/record_readers/record_error.h"
@@ -44,6 +66,9 @@
 #include "mlio/streams/input_stream.h"
 #include "mlio/streams/utf8_input_stream.h"
 #include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/datetime.h"
+#include "mlio/util/string.h"
 
 using mlio::detail::Csv_record_reader;
 using mlio::detail::Csv_record_tokenizer;
@@ -54,35 +79,229 @@ inline namespace abi_v1 {
 struct Csv_reader::Decoder_state {
     explicit Decoder_state(const Csv_reader &r, std::vector<Intrusive_ptr<Tensor>> &t) noexcept;
 
+    // Copies a field that cannot be referenced in-place in its instance
+    // so that it outlives the tile of its decoder.
+    std::string_view copy_string_field(std::string_view value);
+
     const Csv_reader *reader;
     std::vector<Intrusive_ptr<Tensor>> *tensors;
     bool warn_bad_instance;
     bool error_bad_example;
+    detail::Decode_warning_log warnings{};
+    // The values of the string columns by attribute index, or empty for
+    // the other attributes; see Csv_params::arena_strings.
+    std::vector<std::vector<std::string_view>> string_fields{};
+    std::mutex string_copies_mutex{};
+    std::deque<std::string> string_copies{};
 };
 
-template<typename Col_iter>
 class Csv_reader::Decoder {
 public:
-    explicit Decoder(Decoder_state &state,
-                     Csv_record_tokenizer &tokenizer,
-                     Col_iter col_beg,
-                     Col_iter col_end)
-        : state_{&state}, tokenizer_{&tokenizer}, col_beg_{col_beg}, col_end_{col_end}
-    {}
+    explicit Decoder(Decoder_state &state);
+
+    // Prepares a pooled decoder for the next batch; the scratch buffers
+    // keep their capacity.
+    void reset(Decoder_state &state) noexcept;
+
+    std::optional<std::size_t> decode(std::size_t row_idx, stdx::span<const Instance> instances);
 
-    bool decode(std::size_t row_idx, const Instance &instance);
+    // Tokenizes the rows and appends the fields of the good ones to
+    // columns without parsing them; see Csv_params::lazy_decode.
+    std::optional<std::size_t>
+    tokenize_rows(stdx::span<const Instance> instances, Lazy_columns &columns);
 
 private:
+    // The tokenizers of the common dialects compare against constants
+    // and never truncate; any other dialect uses the generic one.
+    using Tokenizer = std::variant<Csv_record_tokenizer,
+                                   detail::Comma_csv_record_tokenizer,
+                                   detail::Tab_csv_record_tokenizer>;
+
+    static Tokenizer make_tokenizer(const Csv_params &params);
+
+    bool tokenize(std::string_view *fields, const Instance &instance);
+
+    template<typename Tokenizer_type>
+    bool tokenize(Tokenizer_type &tokenizer, std::string_view *fields, const Instance &instance);
+
+    template<typename Tokenizer_type>
+    bool tokenize_mapped(Tokenizer_type &tokenizer,
+                         const Column_map &column_map,
+                         std::string_view *fields,
+                         const Instance &instance);
+
+    bool handle_truncated_field(std::string_view field,
+                                const Instance &instance,
+                                std::size_t col_idx);
+
+    bool check_field_count(const Instance &instance,
+                           std::size_t num_actual_cols,
+                           std::size_t num_columns);
+
+    const Column_map *find_column_map(const Instance &instance);
+
+    void report_parse_failures(std::size_t col_idx,
+                               std::size_t field_idx,
+                               stdx::span<const Instance> instances);
+
+    template<typename Format_fn>
+    void report_bad_instance(detail::Decode_warning_kind kind,
+                             const Instance &instance,
+                             std::size_t col_idx,
+                             Format_fn &&format_message) const;
+
+    bool should_pad() const;
+
+    std::string_view copy_field(std::string_view value);
+
+    void stage_strings(stdx::span<const Instance> tile, std::size_t field_idx, std::size_t offset);
+
+    std::optional<std::size_t> parse_stacked(stdx::span<const Instance> tile, std::size_t offset);
+
     Decoder_state *state_;
-    Csv_record_tokenizer *tokenizer_;
-    Col_iter col_beg_;
-    Col_iter col_end_;
+    Tokenizer tokenizer_;
+    std::size_t num_fields_;
+    std::size_t max_num_rows_;
+    std::vector<std::string_view> fields_{};
+    std::vector<Row_state> row_states_{};
+    // Holds the values of a tile in column-major order before they are
+    // transposed into the stacked tensor; see Csv_params::stack_columns.
+    std::unique_ptr<Device_array> stacked_tile_{};
+    // Holds the fields that cannot be referenced in-place in their
+    // instances (e.g. quoted fields with escaped quotes). The strings
+    // past num_field_copies_ are unused and are only kept for their
+    // capacity.
+    std::deque<std::string> field_copies_{};
+    std::size_t num_field_copies_{};
+    // The offsets of the schema columns within the fields of a row, or
+    // unmapped_column for the ignored columns; only used with column
+    // maps.
+    std::vector<std::size_t> field_slots_{};
+    // The column map of the data store of the last decoded row.
+    const Data_store *mapped_store_{};
+    std::shared_ptr<const Column_map> column_map_{};
+};
+
+struct Csv_reader::Lazy_context {
+    // By attribute index.
+    std::vector<Data_type> data_types{};
+    std::vector<Column_parser> parsers{};
+    std::vector<std::shared_ptr<detail::String_dictionary>> dictionaries{};
+    std::vector<bool> hashed{};
+    std::vector<std::string> column_names{};
+    std::vector<Data_type> column_types{};
+    Parser_options parser_options{};
+    std::size_t num_hash_buckets{};
+    std::uint32_t hash_seed{};
+};
+
+// Holds the tokenized rows of a batch and parses a column the first time
+// its feature is accessed. Only refers to the shared Lazy_context, so
+// it can outlive the reader.
+class Csv_reader::Lazy_columns final : public Feature_source {
+public:
+    explicit Lazy_columns(std::shared_ptr<const Lazy_context> context,
+                          std::size_t batch_size) noexcept;
+
+    void append_row(const Instance &instance, stdx::span<const std::string_view> fields);
+
+    Intrusive_ptr<Tensor> materialize(std::size_t index) const final;
+
+    std::size_t size_bytes() const noexcept final
+    {
+        return num_bytes_;
+    }
+
+private:
+    [[noreturn]] void throw_parse_failure(std::size_t index,
+                                          stdx::span<const Row_state> row_states) const;
+
+    struct Row_info {
+        std::size_t index{};
+        std::size_t store_idx{};
+    };
+
+    std::shared_ptr<const Lazy_context> context_;
+    std::size_t batch_size_;
+    std::size_t num_fields_;
+    // The fields of the rows in row-major order; either views into the
+    // rows or into field_copies_.
+    std::vector<std::string_view> fields_{};
+    // Holds the fields that the decoder had to copy (e.g. quoted fields
+    // with escaped quotes); a deque never moves its elements.
+    std::deque<std::string> field_copies_{};
+    // Keeps the memory of the rows alive.
+    std::vector<Memory_slice> rows_{};
+    // Used in the error messages.
+    std::vector<Row_info> row_infos_{};
+    std::vector<std::string> store_ids_{};
+    const Data_store *last_store_{};
+    std::size_t num_bytes_{};
+};
+
+struct Csv_reader::Sampled_row {
+    Memory_slice bits;
+    std::shared_ptr<const Column_map> column_map;
+};
+
+struct Csv_reader::Row_filter_state {
+    explicit Row_filter_state(const Csv_params &params) noexcept : tokenizer{params}
+    {}
+
+    // The predicates paired with the indices of their columns.
+    std::vector<std::pair<std::size_t, detail::Row_predicate>> predicates{};
+    // See Data_reader_params::class_sample_ratios.
+    std::optional<detail::Class_sampler> class_sampler{};
+    std::size_t class_column_index{};
+    // The value of the class column of the last filtered row; copied
+    // since the tokenizer might reuse its buffer for the next field.
+    std::string label{};
+    Csv_record_tokenizer tokenizer;
+    // The predicates ordered by the indices of their fields in the rows
+    // of the last filtered data store; the columns that the data store
+    // lacks have unmapped_column and are compared as empty fields. The
+    // class column has a null predicate.
+    const Data_store *store{};
+    std::uint64_t store_key{};
+    std::vector<std::pair<std::size_t, const detail::Row_predicate *>> fields{};
 };
 
 Csv_reader::Csv_reader(Data_reader_params params, Csv_params csv_params)
     : Parallel_data_reader{std::move(params)}, params_{std::move(csv_params)}
 {
+    if (params_.map_columns_by_header &&
+        (params_.header_row_index == std::nullopt || params_.has_single_header)) {
+        throw std::invalid_argument{
+            "The columns can be mapped by header only if each data store has a header row."};
+    }
+
+    if (params_.lazy_decode && params_.stack_columns) {
+        throw std::invalid_argument{"The columns cannot be both stacked and lazily decoded."};
+    }
+
+    // Report an invalid datetime format now instead of when the first
+    // batch gets decoded.
+    if (!params_.parser_options.datetime_format.empty()) {
+        static_cast<void>(Datetime_format{params_.parser_options.datetime_format});
+    }
+
     column_names_ = params_.column_names;
+
+    if (!params_.schema_path.empty()) {
+        load_schema();
+    }
+
+    if (!this->params().row_filters.empty() || !this->params().class_sample_ratios.empty()) {
+        row_filter_ = std::make_unique<Row_filter_state>(params_);
+
+        if (!this->params().class_sample_ratios.empty()) {
+            row_filter_->class_sampler.emplace(this->params());
+        }
+
+        set_instance_filter([this](const Instance &instance) {
+            return matches_row_filters(instance);
+        });
+    }
 }
 
 Csv_reader::~Csv_reader()
@@ -97,6 +316,28 @@ void Csv_reader::reset() noexcept
     should_read_header = true;
 }
 
+void Csv_reader::restore_state(const Data_reader_state &state)
+{
+    // Inferring the schema opens the first file; make sure that its
+    // header gets discarded again when the instance readers are rebuilt.
+    read_schema();
+
+    should_read_header = true;
+
+    // Only the first file has a header if has_single_header is set, so
+    // seeking directly into another file would leave us unable to tell
+    // whether its first row is a header; fall back to skipping.
+    if (params_.header_row_index && params_.has_single_header && !state.position.empty()) {
+        Data_reader_state skip_state = state;
+        skip_state.position.clear();
+
+        Parallel_data_reader::restore_state(skip_state);
+    }
+    else {
+        Parallel_data_reader::restore_state(state);
+    }
+}
+
 Intrusive_ptr<Record_reader> Csv_reader::make_record_reader(const Data_store &store)
 {
     auto stream = make_utf8_stream(store.open_read(), params_.encoding);
@@ -109,6 +350,18 @@ Intrusive_ptr<Record_reader> Csv_reader::make_record_reader(const Data_store &st
         if (column_names_.empty()) {
             read_names_from_header(store, *reader);
         }
+        else if (params_.map_columns_by_header) {
+            std::shared_ptr<const Column_map> column_map = read_column_map(store, *reader);
+
+            std::unique_lock<std::mutex> lock{column_maps_mutex_};
+
+            if (column_map == nullptr) {
+                column_maps_.erase(&store);
+            }
+            else {
+                column_maps_.insert_or_assign(&store, std::move(column_map));
+            }
+        }
         else if (should_read_header || !params_.has_single_header) {
             skip_to_header_row(*reader);
 
@@ -122,6 +375,25 @@ Intrusive_ptr<Record_reader> Csv_reader::make_record_reader(const Data_store &st
     return std::move(reader);
 }
 
+Intrusive_ptr<Record_reader>
+Csv_reader::make_counting_record_reader(const Data_store &store, std::size_t store_index)
+{
+    auto stream = make_utf8_stream(store.open_read(), params_.encoding);
+
+    auto reader = make_intrusive<Csv_record_reader>(std::move(stream), params_);
+
+    // Unlike make_record_reader(), we neither read the column names nor
+    // touch should_read_header as the pipeline might be using them.
+    if (params_.header_row_index && (store_index == 0 || !params_.has_single_header)) {
+        skip_to_header_row(*reader);
+
+        // Discard the header row.
+        reader->read_record();
+    }
+
+    return std::move(reader);
+}
+
 void Csv_reader::read_names_from_header(const Data_store &store, Record_reader &reader)
 {
     skip_to_header_row(reader);
@@ -134,13 +406,8 @@ void Csv_reader::read_names_from_header(const Data_store &store, Record_reader &
 
         Csv_record_tokenizer tokenizer{params_, hdr->payload()};
         while (tokenizer.next()) {
-            std::string name;
-            if (params_.name_prefix.empty()) {
-                name = tokenizer.value();
-            }
-            else {
-                name = params_.name_prefix + tokenizer.value();
-            }
+            std::string name = params_.name_prefix;
+            name += tokenizer.value();
             column_names_.emplace_back(std::move(name));
         }
     }
@@ -168,6 +435,321 @@ void Csv_reader::skip_to_header_row(Record_reader &reader)
     }
 }
 
+std::shared_ptr<const Csv_reader::Column_map>
+Csv_reader::read_column_map(const Data_store &store, Record_reader &reader)
+{
+    skip_to_header_row(reader);
+
+    std::vector<std::string> names{};
+
+    try {
+        std::optional<Record> hdr = reader.read_record();
+        if (hdr == std::nullopt) {
+            return {};
+        }
+
+        Csv_record_tokenizer tokenizer{params_, hdr->payload()};
+        while (tokenizer.next()) {
+            std::string name = params_.name_prefix;
+            name += tokenizer.value();
+            names.emplace_back(std::move(name));
+        }
+    }
+    catch (const Corrupt_record_error &) {
+        std::throw_with_nested(Schema_error{fmt::format(
+            "The header row of the data store '{0}' cannot be read. See nested exception for details.",
+            store.id())});
+    }
+
+    if (names == column_names_) {
+        return {};
+    }
+
+    // Duplicate names are matched in the order they appear.
+    std::unordered_map<std::string_view, std::vector<std::size_t>> columns{};
+    for (std::size_t i = column_names_.size(); i > 0; i--) {
+        columns[column_names_[i - 1]].emplace_back(i - 1);
+    }
+
+    auto column_map = std::make_shared<Column_map>();
+    column_map->reserve(names.size());
+
+    std::size_t num_skipped = 0;
+
+    for (const std::string &name : names) {
+        auto pos = columns.find(name);
+        if (pos == columns.end() || pos->second.empty()) {
+            column_map->emplace_back(unmapped_column);
+
+            num_skipped++;
+        }
+        else {
+            column_map->emplace_back(pos->second.back());
+
+            pos->second.pop_back();
+        }
+    }
+
+    std::size_t num_missing = column_names_.size() - (names.size() - num_skipped);
+
+    logger::info(
+        "The columns of the data store '{0}' are mapped to the schema by their header; {1:n} column(s) are skipped and {2:n} column(s) are missing.",
+        store.id(),
+        num_skipped,
+        num_missing);
+
+    return column_map;
+}
+
+void Csv_reader::release_data_store(const Data_store &store) noexcept
+{
+    std::unique_lock<std::mutex> lock{column_maps_mutex_};
+
+    column_maps_.erase(&store);
+}
+
+std::shared_ptr<const Csv_reader::Column_map>
+Csv_reader::find_column_map(const Data_store &store) const
+{
+    std::unique_lock<std::mutex> lock{column_maps_mutex_};
+
+    auto pos = column_maps_.find(&store);
+    if (pos == column_maps_.end()) {
+        return {};
+    }
+    return pos->second;
+}
+
+namespace detail {
+namespace {
+
+constexpr std::array<char, 8> schema_magic{'M', 'L', 'I', 'O', 'C', 'S', 'V', '1'};
+
+template<typename T>
+void append_value(std::string &bits, T value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    bits.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool consume_value(std::string_view &bits, T &value) noexcept
+{
+    if (bits.size() < sizeof(T)) {
+        return false;
+    }
+
+    std::memcpy(&value, bits.data(), sizeof(T));
+
+    bits.remove_prefix(sizeof(T));
+
+    return true;
+}
+
+}  // namespace
+}  // namespace detail
+
+namespace detail {
+namespace {
+
+// Copies enough of a field to show its first 64 characters in a
+// warning message, even if they are multi-byte UTF-8 sequences.
+std::string copy_field_prefix(std::string_view value)
+{
+    constexpr std::size_t max_num_bytes = 64 * 4;
+
+    return std::string{value.substr(0, max_num_bytes)};
+}
+
+// Maps the fields of the good rows to their hash buckets.
+void hash_column(stdx::span<const std::string_view> fields,
+                 std::size_t stride,
+                 stdx::span<const Row_state> row_states,
+                 std::int64_t *indices,
+                 std::size_t num_buckets,
+                 std::uint32_t seed) noexcept
+{
+    for (std::size_t i = 0; i < row_states.size(); i++) {
+        if (row_states[i] == Row_state::good) {
+            std::uint32_t hash = murmur_hash3_32(fields[i * stride], seed);
+
+            indices[i] = static_cast<std::int64_t>(hash % num_buckets);
+        }
+    }
+}
+
+template<Data_type dt>
+struct Clear_values_op {
+    void operator()(Device_array_span arr, std::size_t begin, std::size_t end) const
+    {
+        auto *values = arr.as<data_type_t<dt>>().data();
+
+        std::fill(values + begin, values + end, data_type_t<dt>{});
+    }
+};
+
+// Returns the narrowest of the types returned by infer_data_type() that
+// can represent the values of both types.
+Data_type widen_data_type(Data_type lhs, Data_type rhs) noexcept
+{
+    if (lhs == rhs) {
+        return lhs;
+    }
+    if (lhs == Data_type::string || rhs == Data_type::string) {
+        return Data_type::string;
+    }
+    return Data_type::float64;
+}
+
+}  // namespace
+}  // namespace detail
+
+std::vector<std::string> Csv_reader::dictionary(const std::string &name)
+{
+    Intrusive_ptr<const Schema> schema = read_schema();
+    if (schema != nullptr) {
+        std::optional<std::size_t> attr_idx = schema->get_index(name);
+        if (attr_idx && dictionaries_[*attr_idx] != nullptr) {
+            return dictionaries_[*attr_idx]->values();
+        }
+    }
+
+    throw std::invalid_argument{
+        fmt::format("The column '{0}' is not dictionary-encoded.", name)};
+}
+
+std::vector<Column_chunk> Csv_reader::read_column_chunks()
+{
+    if (params_.stack_columns) {
+        throw Not_supported_error{
+            "The column chunks cannot be read as the columns are stacked into a single tensor."};
+    }
+
+    Intrusive_ptr<Example> example = read_example();
+    if (example == nullptr) {
+        return {};
+    }
+
+    const std::vector<Attribute> &attrs = example->schema().attributes();
+
+    std::vector<Column_chunk> chunks{};
+    chunks.reserve(attrs.size());
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        Intrusive_ptr<Tensor> values = example->feature(i);
+
+        // Without arena strings the string columns are decoded into dense
+        // tensors of std::string; pack them into a single buffer.
+        if (auto *dense = dynamic_cast<Dense_tensor *>(values.get());
+            dense != nullptr && dense->data_type() == Data_type::string) {
+            auto strings = dense->data().as<std::string>();
+
+            std::vector<std::string_view> views(strings.begin(), strings.end());
+
+            values = detail::make_string_tensor(dense->shape(), views);
+        }
+
+        std::size_t num_rows = values->shape().empty() ? 1 : values->shape()[0];
+
+        num_rows -= std::min(example->padding, num_rows);
+
+        chunks.push_back(Column_chunk{attrs[i].name(), std::move(values), num_rows});
+    }
+
+    return chunks;
+}
+
+void Csv_reader::save_schema(const std::string &path)
+{
+    if (read_schema() == nullptr) {
+        throw Schema_error{"The schema cannot be saved as it cannot be inferred from the dataset."};
+    }
+
+    // The file holds the column names and data types before applying
+    // the column filters and the deduplication of names; they are
+    // applied again when the file is loaded.
+    std::string bits{detail::schema_magic.data(), detail::schema_magic.size()};
+
+    detail::append_value<std::uint64_t>(bits, column_names_.size());
+
+    for (std::size_t i = 0; i < column_names_.size(); i++) {
+        detail::append_value(bits, static_cast<std::uint8_t>(column_types_[i]));
+        detail::append_value<std::uint64_t>(bits, column_names_[i].size());
+
+        bits += column_names_[i];
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (file) {
+        file.write(bits.data(), as_ssize(bits.size()));
+    }
+
+    if (!file) {
+        throw std::system_error{detail::current_error_code(),
+                                fmt::format("The schema file '{0}' cannot be written.", path)};
+    }
+}
+
+void Csv_reader::load_schema()
+{
+    std::ifstream file{params_.schema_path, std::ios::binary};
+    if (!file) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The schema file '{0}' cannot be opened.", params_.schema_path)};
+    }
+
+    std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    std::string_view bits = content;
+
+    auto throw_invalid_file = [this]() {
+        throw Schema_error{
+            fmt::format("The schema file '{0}' is not valid.", params_.schema_path)};
+    };
+
+    std::array<char, 8> magic{};
+    if (!detail::consume_value(bits, magic) || magic != detail::schema_magic) {
+        throw_invalid_file();
+    }
+
+    std::uint64_t num_columns{};
+    if (!detail::consume_value(bits, num_columns)) {
+        throw_invalid_file();
+    }
+
+    column_names_.clear();
+
+    for (std::uint64_t i = 0; i < num_columns; i++) {
+        std::uint8_t dt{};
+        std::uint64_t size{};
+        if (!detail::consume_value(bits, dt) || !detail::consume_value(bits, size) ||
+            dt > static_cast<std::uint8_t>(Data_type::date) || bits.size() < size) {
+            throw_invalid_file();
+        }
+
+        column_types_.emplace_back(static_cast<Data_type>(dt));
+        column_names_.emplace_back(bits.substr(0, size));
+
+        bits.remove_prefix(size);
+    }
+
+    if (column_names_.empty() || !bits.empty()) {
+        throw_invalid_file();
+    }
+}
+
+Intrusive_ptr<const Schema> Csv_reader::restore_schema()
+{
+    if (params_.schema_path.empty()) {
+        return {};
+    }
+
+    apply_column_type_overrides();
+
+    return init_parsers_and_make_schema();
+}
+
 Intrusive_ptr<const Schema> Csv_reader::infer_schema(const std::optional<Instance> &instance)
 {
     // If we don't have any data rows and if the store has no header or
@@ -216,6 +798,14 @@ void Csv_reader::infer_column_types(const std::optional<Instance> &instance)
                 }
                 column_types_.emplace_back(dt);
             }
+
+            if (params_.map_columns_by_header) {
+                remap_column_types(*instance);
+            }
+
+            if (params_.default_data_type == std::nullopt && params_.num_type_inference_rows > 1) {
+                widen_column_types();
+            }
         }
         catch (const Corrupt_record_error &) {
             std::throw_with_nested(Schema_error{fmt::format(
@@ -225,28 +815,159 @@ void Csv_reader::infer_column_types(const std::optional<Instance> &instance)
     }
 }
 
-void Csv_reader::set_or_validate_column_names(const std::optional<Instance> &instance)
+void Csv_reader::remap_column_types(const Instance &instance)
 {
-    if (column_names_.empty()) {
-        column_names_.reserve(column_types_.size());
+    std::shared_ptr<const Column_map> column_map = find_column_map(instance.data_store());
+    if (column_map == nullptr) {
+        return;
+    }
 
-        for (std::size_t idx = 1; idx <= column_types_.size(); idx++) {
-            std::string name{};
-            if (params_.name_prefix.empty()) {
-                name = fmt::to_string(idx);
-            }
-            else {
-                name = params_.name_prefix + fmt::to_string(idx);
-            }
-            column_names_.emplace_back(std::move(name));
-        }
+    // Let the validation of the column names report the mismatch.
+    if (column_types_.size() != column_map->size()) {
+        return;
+    }
+
+    // The columns that the data store lacks are read as empty fields.
+    Data_type missing_type{};
+    if (params_.default_data_type == std::nullopt) {
+        missing_type = infer_data_type({});
     }
     else {
-        if (column_names_.size() != column_types_.size()) {
-            throw Schema_error{fmt::format(
-                "The number of columns ({3:n}) read from the row #{1:n} in the data store '{0}' does not match the number of headers ({2:n}).",
-                instance->data_store().id(),
-                instance->index(),
+        missing_type = *params_.default_data_type;
+    }
+
+    std::vector<Data_type> column_types(column_names_.size(), missing_type);
+
+    for (std::size_t i = 0; i < column_map->size(); i++) {
+        std::size_t col_idx = (*column_map)[i];
+        if (col_idx != unmapped_column) {
+            column_types[col_idx] = column_types_[i];
+        }
+    }
+
+    column_types_ = std::move(column_types);
+}
+
+void Csv_reader::widen_column_types()
+{
+    std::vector<Sampled_row> rows = sample_rows();
+
+    std::size_t num_columns = column_types_.size();
+
+    std::vector<std::vector<Data_type>> row_types(rows.size());
+
+    tbb::blocked_range<std::size_t> range{0, rows.size()};
+
+    tbb::parallel_for(range, [this, &rows, &row_types, num_columns](const auto &sub_range) {
+        for (std::size_t i = sub_range.begin(); i < sub_range.end(); i++) {
+            std::vector<Data_type> &types = row_types[i];
+
+            types.reserve(num_columns);
+
+            Csv_record_tokenizer tokenizer{params_, rows[i].bits};
+            while (tokenizer.next()) {
+                types.emplace_back(infer_data_type(tokenizer.value()));
+            }
+        }
+    });
+
+    // The rows whose number of fields does not match the first instance
+    // would be bad instances anyways; leave them out.
+    for (std::size_t row_idx = 0; row_idx < rows.size(); row_idx++) {
+        const std::vector<Data_type> &types = row_types[row_idx];
+
+        const Column_map *column_map = rows[row_idx].column_map.get();
+        if (column_map == nullptr) {
+            if (types.size() != num_columns) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < num_columns; i++) {
+                column_types_[i] = detail::widen_data_type(column_types_[i], types[i]);
+            }
+        }
+        else {
+            if (types.size() != column_map->size()) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < types.size(); i++) {
+                std::size_t col_idx = (*column_map)[i];
+                if (col_idx != unmapped_column) {
+                    column_types_[col_idx] = detail::widen_data_type(column_types_[col_idx], types[i]);
+                }
+            }
+        }
+    }
+
+    logger::info("The column data types have been inferred from {0:n} row(s).", rows.size() + 1);
+}
+
+std::vector<Csv_reader::Sampled_row> Csv_reader::sample_rows()
+{
+    std::size_t num_rows = params_.num_type_inference_rows - 1;
+
+    std::vector<Sampled_row> rows{};
+    rows.reserve(num_rows);
+
+    // Read the rows from the beginning of the dataset; unless it is
+    // shuffled, this includes the row of the first instance, which
+    // does not affect the result.
+    const std::vector<Intrusive_ptr<Data_store>> &dataset = params().dataset;
+
+    for (auto pos = dataset.begin(); pos < dataset.end() && rows.size() < num_rows; ++pos) {
+        auto stream = make_utf8_stream((*pos)->open_read(), params_.encoding);
+
+        Csv_record_reader reader{std::move(stream), params_};
+
+        std::shared_ptr<const Column_map> column_map{};
+
+        if (params_.header_row_index) {
+            if (params_.map_columns_by_header) {
+                column_map = read_column_map(**pos, reader);
+            }
+            else if (pos == dataset.begin() || !params_.has_single_header) {
+                skip_to_header_row(reader);
+
+                reader.read_record();
+            }
+        }
+
+        while (rows.size() < num_rows) {
+            std::optional<Record> record = reader.read_record();
+            if (record == std::nullopt) {
+                break;
+            }
+
+            rows.emplace_back(Sampled_row{record->payload(), column_map});
+        }
+    }
+
+    return rows;
+}
+
+void Csv_reader::set_or_validate_column_names(const std::optional<Instance> &instance)
+{
+    if (column_names_.empty()) {
+        column_names_.reserve(column_types_.size());
+
+        for (std::size_t idx = 1; idx <= column_types_.size(); idx++) {
+            std::string name{};
+            if (params_.name_prefix.empty()) {
+                name = fmt::to_string(idx);
+            }
+            else {
+                name = params_.name_prefix + fmt::to_string(idx);
+            }
+            column_names_.emplace_back(std::move(name));
+        }
+    }
+    else {
+        if (column_names_.size() != column_types_.size()) {
+            throw Schema_error{fmt::format(
+                "The number of columns ({3:n}) read from the row #{1:n} in the data store '{0}' does not match the number of headers ({2:n}).",
+                instance->data_store().id(),
+                instance->index(),
                 column_names_.size(),
                 column_types_.size())};
         }
@@ -255,6 +976,15 @@ void Csv_reader::set_or_validate_column_names(const std::optional<Instance> &ins
 
 void Csv_reader::apply_column_type_overrides()
 {
+    // Narrow the inferred types first so that the explicit overrides
+    // take precedence.
+    for (Data_type &dt : column_types_) {
+        auto pos = params_.narrowed_types.find(dt);
+        if (pos != params_.narrowed_types.end()) {
+            dt = pos->second;
+        }
+    }
+
     std::size_t num_columns = column_names_.size();
 
     auto idx_beg = tbb::counting_iterator<std::size_t>(0);
@@ -333,6 +1063,29 @@ Intrusive_ptr<const Schema> Csv_reader::init_parsers_and_make_schema()
     column_ignores_.reserve(num_columns);
     column_parsers_.reserve(num_columns);
 
+    num_scanned_columns_ = 0;
+
+    std::vector<bool> dictionary_encoded =
+        select_columns(params_.dictionary_encoded_columns,
+                       params_.dictionary_encoded_columns_by_index,
+                       "dictionary-encoded");
+
+    std::vector<bool> hashed =
+        select_columns(params_.hashed_columns, params_.hashed_columns_by_index, "hashed");
+
+    if (params_.num_hash_buckets == 0 &&
+        std::find(hashed.begin(), hashed.end(), true) != hashed.end()) {
+        throw std::invalid_argument{"The number of hash buckets must be greater than zero."};
+    }
+
+    if (params_.stack_columns &&
+        (std::find(dictionary_encoded.begin(), dictionary_encoded.end(), true) !=
+             dictionary_encoded.end() ||
+         std::find(hashed.begin(), hashed.end(), true) != hashed.end())) {
+        throw std::invalid_argument{
+            "The columns cannot be stacked if some of them are dictionary-encoded or hashed."};
+    }
+
     auto idx_beg = tbb::counting_iterator<std::size_t>(0);
     auto idx_end = tbb::counting_iterator<std::size_t>(num_columns);
 
@@ -352,15 +1105,57 @@ Intrusive_ptr<const Schema> Csv_reader::init_parsers_and_make_schema()
 
         if (should_skip(std::get<0>(*col_pos), name)) {
             column_ignores_.emplace_back(1);
-            column_parsers_.emplace_back(nullptr);
+            column_parsers_.emplace_back();
 
             continue;
         }
 
         Data_type dt = std::get<2>(*col_pos);
 
+        std::size_t idx = std::get<0>(*col_pos);
+
+        if (dictionary_encoded[idx] && hashed[idx]) {
+            throw std::invalid_argument{fmt::format(
+                "The column '{0}' cannot be both dictionary-encoded and hashed.", name)};
+        }
+
+        // The values of dictionary-encoded and hashed columns are not
+        // parsed; the parser is only used to compact the codes.
+        if (dictionary_encoded[idx]) {
+            dt = Data_type::int32;
+
+            dictionaries_.emplace_back(std::make_shared<detail::String_dictionary>());
+        }
+        else {
+            dictionaries_.emplace_back();
+        }
+
+        if (hashed[idx]) {
+            dt = Data_type::int64;
+        }
+
+        hashed_attrs_.emplace_back(hashed[idx]);
+
+        // The stacked columns are all parsed as float32.
+        if (params_.stack_columns) {
+            if (dt == Data_type::string) {
+                throw Schema_error{fmt::format(
+                    "The column '{0}' cannot be stacked as it is not numeric.", name)};
+            }
+
+            dt = Data_type::float32;
+        }
+
         column_ignores_.emplace_back(0);
-        column_parsers_.emplace_back(make_parser(dt, params_.parser_options));
+        column_parsers_.emplace_back(make_column_parser(dt));
+
+        num_scanned_columns_ = idx + 1;
+
+        num_read_columns_++;
+
+        if (params_.stack_columns) {
+            continue;
+        }
 
         if (params_.dedupe_column_names) {
             // Keep count of column names. If the key already exists,
@@ -378,6 +1173,18 @@ Intrusive_ptr<const Schema> Csv_reader::init_parsers_and_make_schema()
         attrs.emplace_back(std::move(name), dt, Size_vector{batch_size, 1});
     }
 
+    if (params_.stack_columns) {
+        attrs.emplace_back(params_.stacked_feature_name,
+                           Data_type::float32,
+                           Size_vector{batch_size, num_read_columns_});
+    }
+
+    resolve_row_filters();
+
+    if (params_.lazy_decode) {
+        lazy_context_ = make_lazy_context(attrs);
+    }
+
     try {
         return make_intrusive<Schema>(attrs);
     }
@@ -394,6 +1201,216 @@ Intrusive_ptr<const Schema> Csv_reader::init_parsers_and_make_schema()
     }
 }
 
+std::shared_ptr<const Csv_reader::Lazy_context>
+Csv_reader::make_lazy_context(const std::vector<Attribute> &attrs) const
+{
+    auto context = std::make_shared<Lazy_context>();
+
+    for (const Attribute &attr : attrs) {
+        context->data_types.emplace_back(attr.data_type());
+    }
+
+    for (std::size_t col_idx = 0; col_idx < column_parsers_.size(); col_idx++) {
+        if (column_ignores_[col_idx] != 0) {
+            continue;
+        }
+
+        context->parsers.emplace_back(column_parsers_[col_idx]);
+        context->column_names.emplace_back(column_names_[col_idx]);
+        context->column_types.emplace_back(column_types_[col_idx]);
+    }
+
+    context->dictionaries = dictionaries_;
+    context->hashed = hashed_attrs_;
+    context->parser_options = params_.parser_options;
+    context->num_hash_buckets = params_.num_hash_buckets;
+    context->hash_seed = params_.hash_seed;
+
+    return context;
+}
+
+std::vector<bool> Csv_reader::select_columns(const std::unordered_set<std::string> &names,
+                                             const std::unordered_set<std::size_t> &indices,
+                                             std::string_view action) const
+{
+    std::size_t num_columns = column_names_.size();
+
+    std::vector<bool> selected(num_columns);
+
+    std::vector<std::size_t> leftover_indices{};
+    for (std::size_t idx : indices) {
+        if (idx < num_columns) {
+            selected[idx] = true;
+        }
+        else {
+            leftover_indices.emplace_back(idx);
+        }
+    }
+
+    if (!leftover_indices.empty()) {
+        throw std::invalid_argument{fmt::format(
+            "The columns cannot be {0}. The following column indices are out of range: {1}",
+            action,
+            fmt::join(leftover_indices, ", "))};
+    }
+
+    auto leftover_names = names;
+
+    for (std::size_t idx = 0; idx < num_columns; idx++) {
+        auto pos = leftover_names.find(column_names_[idx]);
+        if (pos != leftover_names.end()) {
+            selected[idx] = true;
+
+            leftover_names.erase(pos);
+        }
+    }
+
+    if (!leftover_names.empty()) {
+        throw std::invalid_argument{fmt::format(
+            "The columns cannot be {0}. The following columns are not found in the dataset: {1}",
+            action,
+            fmt::join(leftover_names, ", "))};
+    }
+
+    return selected;
+}
+
+void Csv_reader::resolve_row_filters()
+{
+    if (row_filter_ == nullptr) {
+        return;
+    }
+
+    row_filter_->predicates.clear();
+
+    // A filter can also refer to a column that is not read.
+    auto get_column_index = [this](const std::string &name, const char *kind) {
+        auto pos = std::find(column_names_.begin(), column_names_.end(), name);
+        if (pos == column_names_.end()) {
+            throw std::invalid_argument{fmt::format(
+                "The {0} refers to the column '{1}' that is not in the dataset.", kind, name)};
+        }
+
+        return as_size(pos - column_names_.begin());
+    };
+
+    for (const Row_filter &filter : params().row_filters) {
+        std::size_t idx = get_column_index(filter.column, "row filter");
+
+        row_filter_->predicates.emplace_back(idx, detail::Row_predicate{filter});
+    }
+
+    if (row_filter_->class_sampler) {
+        row_filter_->class_column_index = get_column_index(params().class_column,
+                                                           "class column");
+    }
+
+    row_filter_->store = nullptr;
+}
+
+bool Csv_reader::matches_row_filters(const Instance &instance)
+{
+    Row_filter_state &state = *row_filter_;
+
+    // Order the predicates by the position of their fields in the rows
+    // of the data store so that each row is tokenized only up to the
+    // last filtered field.
+    if (&instance.data_store() != state.store) {
+        std::shared_ptr<const Column_map> column_map{};
+        if (params_.map_columns_by_header) {
+            column_map = find_column_map(instance.data_store());
+        }
+
+        auto get_field_index = [&column_map](std::size_t col_idx) {
+            if (column_map == nullptr) {
+                return col_idx;
+            }
+
+            auto pos = std::find(column_map->begin(), column_map->end(), col_idx);
+            if (pos == column_map->end()) {
+                return unmapped_column;
+            }
+            return as_size(pos - column_map->begin());
+        };
+
+        state.fields.clear();
+
+        for (const auto &[col_idx, predicate] : state.predicates) {
+            state.fields.emplace_back(get_field_index(col_idx), &predicate);
+        }
+
+        if (state.class_sampler) {
+            state.fields.emplace_back(get_field_index(state.class_column_index), nullptr);
+
+            state.store_key = detail::Class_sampler::make_store_key(instance.data_store());
+        }
+
+        std::stable_sort(state.fields.begin(), state.fields.end(), [](auto &a, auto &b) {
+            return a.first < b.first;
+        });
+
+        state.store = &instance.data_store();
+    }
+
+    Csv_record_tokenizer &tokenizer = state.tokenizer;
+
+    tokenizer.reset(instance.bits());
+
+    // The number of fields read so far.
+    std::size_t num_fields = 0;
+
+    bool has_field = true;
+
+    std::string_view value{};
+
+    state.label.clear();
+
+    try {
+        for (const auto &[field_idx, predicate] : state.fields) {
+            if (field_idx == unmapped_column) {
+                value = {};
+            }
+            // Two predicates on the same column share its field.
+            else if (num_fields != field_idx + 1) {
+                for (; has_field && num_fields < field_idx; num_fields++) {
+                    has_field = tokenizer.skip();
+                }
+
+                value = {};
+
+                // A row that lacks the field is reported by the decoder.
+                if (has_field) {
+                    has_field = tokenizer.next();
+                    if (has_field) {
+                        value = tokenizer.value();
+
+                        num_fields++;
+                    }
+                }
+            }
+
+            if (predicate == nullptr) {
+                state.label.assign(value);
+            }
+            else if (!(*predicate)(value)) {
+                return false;
+            }
+        }
+    }
+    catch (const Corrupt_record_error &) {
+        // Let the decoder report the row.
+        return true;
+    }
+
+    if (state.class_sampler) {
+        std::uint64_t key = detail::Class_sampler::make_key(state.store_key, instance.index());
+
+        return (*state.class_sampler)(state.label, key);
+    }
+
+    return true;
+}
+
 bool Csv_reader::should_skip(std::size_t index, const std::string &name) const noexcept
 {
     auto uci = params_.use_columns_by_index;
@@ -415,34 +1432,48 @@ bool Csv_reader::should_skip(std::size_t index, const std::string &name) const n
 
 Intrusive_ptr<Example> Csv_reader::decode(const Instance_batch &batch) const
 {
-    auto tensors = make_tensors(batch.size());
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+
+    Intrusive_ptr<Lazy_columns> lazy_columns{};
+    if (params_.lazy_decode) {
+        lazy_columns = make_intrusive<Lazy_columns>(lazy_context_, batch.size());
+    }
+    else {
+        tensors = make_tensors(batch.size());
+    }
 
     Decoder_state state{*this, tensors};
 
-    std::size_t num_instances = batch.instances().size();
+    bool use_arena_strings = params_.arena_strings && lazy_columns == nullptr;
+    if (use_arena_strings) {
+        const std::vector<Attribute> &attrs = schema()->attributes();
+
+        state.string_fields.resize(attrs.size());
+
+        for (std::size_t i = 0; i < attrs.size(); i++) {
+            if (attrs[i].data_type() == Data_type::string) {
+                state.string_fields[i].resize(batch.size());
+            }
+        }
+    }
 
-    constexpr std::size_t cut_off = 10'000'000;
+    std::size_t num_instances = batch.instances().size();
 
-    bool should_run_serial =
-        // If bad example handling mode is pad, we cannot parallelize
-        // decoding as good records must be stacked together without
-        // any gap in between.
-        params().bad_example_handling == Bad_example_handling::pad ||
-        params().bad_example_handling == Bad_example_handling::pad_warn ||
-        // If the number of values (e.g. integers, floating-points) we
-        // need to decode is below the cut-off threshold, avoid parallel
-        // execution; otherwise the threading overhead will potentially
-        // slow down the performance.
-        column_names_.size() * num_instances < cut_off;
+    bool should_run_serial = !should_decode_parallel(num_instances, column_names_.size());
 
     std::optional<std::size_t> num_instances_read{};
-    if (should_run_serial) {
+    if (lazy_columns != nullptr) {
+        num_instances_read = decode_lazy(state, batch, *lazy_columns);
+    }
+    else if (should_run_serial) {
         num_instances_read = decode_ser(state, batch);
     }
     else {
         num_instances_read = decode_prl(state, batch);
     }
 
+    report_decode_warnings(state.warnings);
+
     // Check if we failed to decode the example and return a null
     // pointer if that is the case.
     if (num_instances_read == std::nullopt) {
@@ -455,6 +1486,13 @@ Intrusive_ptr<Example> Csv_reader::decode(const Instance_batch &batch) const
     }
 
     if (num_instances != *num_instances_read) {
+        // The rows left behind by the compaction depend on how the batch
+        // was split; clear them so that the output is the same however
+        // many threads decoded it.
+        if (lazy_columns == nullptr) {
+            clear_rows(state, *num_instances_read, num_instances);
+        }
+
         if (params().bad_example_handling == Bad_example_handling::pad_warn) {
             logger::warn("The example #{0:n} has been padded as it had {1:n} bad instance(s).",
                          batch.index(),
@@ -462,7 +1500,27 @@ Intrusive_ptr<Example> Csv_reader::decode(const Instance_batch &batch) const
         }
     }
 
-    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+    if (use_arena_strings) {
+        for (std::size_t i = 0; i < state.string_fields.size(); i++) {
+            std::vector<std::string_view> &values = state.string_fields[i];
+            if (values.empty()) {
+                continue;
+            }
+
+            // The padding rows are empty strings.
+            std::fill(values.begin() + as_ssize(*num_instances_read), values.end(), "");
+
+            tensors[i] = detail::make_string_tensor(Size_vector{batch.size(), 1}, values);
+        }
+    }
+
+    Intrusive_ptr<Example> example{};
+    if (lazy_columns != nullptr) {
+        example = make_intrusive<Example>(schema(), std::move(lazy_columns));
+    }
+    else {
+        example = make_intrusive<Example>(schema(), std::move(tensors));
+    }
 
     example->padding = batch.size() - *num_instances_read;
 
@@ -471,148 +1529,260 @@ Intrusive_ptr<Example> Csv_reader::decode(const Instance_batch &batch) const
 
 std::vector<Intrusive_ptr<Tensor>> Csv_reader::make_tensors(std::size_t batch_size) const
 {
+    const std::vector<Attribute> &attrs = schema()->attributes();
+
     std::vector<Intrusive_ptr<Tensor>> tensors{};
-    tensors.reserve(column_types_.size() - column_ignores_.size());
+    tensors.reserve(attrs.size());
 
-    auto type_beg = column_types_.begin();
-    auto type_end = column_types_.end();
+    if (params_.stack_columns) {
+        std::unique_ptr<Device_array> arr =
+            make_pooled_cpu_array(Data_type::float32, batch_size * num_read_columns_);
+
+        tensors.emplace_back(make_intrusive<Dense_tensor>(
+            Size_vector{batch_size, num_read_columns_}, std::move(arr)));
 
-    auto ignore_beg = column_ignores_.begin();
-    auto ignore_end = column_ignores_.end();
+        return tensors;
+    }
+
+    // With arena strings the string columns are only built once the
+    // batch is decoded; their slots are left empty until then.
+    auto is_arena_string = [this](const Attribute &attr) {
+        return params_.arena_strings && !params_.lazy_decode &&
+               attr.data_type() == Data_type::string;
+    };
 
-    auto col_beg = tbb::make_zip_iterator(type_beg, ignore_beg);
-    auto col_end = tbb::make_zip_iterator(type_end, ignore_end);
+    // The data type of an attribute differs from the type of its column
+    // if the column is dictionary-encoded.
+    std::vector<Data_type> dts{};
+    dts.reserve(attrs.size());
+
+    for (const Attribute &attr : attrs) {
+        if (!is_arena_string(attr)) {
+            dts.emplace_back(attr.data_type());
+        }
+    }
+
+    // Wide datasets can have thousands of columns; instead of allocating
+    // each column separately, we carve them out of a single buffer.
+    std::vector<std::unique_ptr<Device_array>> arrays = make_pooled_cpu_arrays(dts, batch_size);
+
+    auto arr_pos = arrays.begin();
+
+    for (const Attribute &attr : attrs) {
+        if (is_arena_string(attr)) {
+            tensors.emplace_back();
 
-    for (auto col_pos = col_beg; col_pos < col_end; ++col_pos) {
-        // Check if we should skip this column.
-        if (std::get<1>(*col_pos) != 0) {
             continue;
         }
 
         Size_vector shape{batch_size, 1};
 
-        Data_type dt = std::get<0>(*col_pos);
+        tensors.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(*arr_pos)));
 
-        std::unique_ptr<Device_array> arr = make_cpu_array(dt, batch_size);
-
-        tensors.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(arr)));
+        ++arr_pos;
     }
 
     return tensors;
 }
 
-auto Csv_reader::make_column_iterators() const noexcept
+std::optional<std::size_t>
+Csv_reader::decode_ser(Decoder_state &state, const Instance_batch &batch) const
 {
-    std::size_t num_columns = column_names_.size();
+    std::unique_ptr<Decoder> decoder = acquire_decoder(state);
 
-    auto col_idx_beg = tbb::counting_iterator<std::size_t>(0);
-    auto col_idx_end = tbb::counting_iterator<std::size_t>(num_columns);
-
-    auto name_beg = column_names_.begin();
-    auto name_end = column_names_.end();
+    std::optional<std::size_t> num_instances_read = decoder->decode(0, batch.instances());
 
-    auto type_beg = column_types_.begin();
-    auto type_end = column_types_.end();
+    release_decoder(std::move(decoder));
 
-    auto ignore_beg = column_ignores_.begin();
-    auto ignore_end = column_ignores_.end();
+    return num_instances_read;
+}
 
-    auto parser_beg = column_parsers_.begin();
-    auto parser_end = column_parsers_.end();
+std::optional<std::size_t>
+Csv_reader::decode_prl(Decoder_state &state, const Instance_batch &batch) const
+{
+    std::atomic_bool skip_example{};
 
-    auto col_beg = tbb::make_zip_iterator(col_idx_beg, name_beg, type_beg, ignore_beg, parser_beg);
-    auto col_end = tbb::make_zip_iterator(col_idx_end, name_end, type_end, ignore_end, parser_end);
+    std::size_t num_instances = batch.instances().size();
 
-    return std::make_pair(col_beg, col_end);
-}
+    stdx::span<const Instance> instances = batch.instances();
 
-std::optional<std::size_t>
-Csv_reader::decode_ser(Decoder_state &state, const Instance_batch &batch) const
-{
-    std::size_t row_idx = 0;
+    // If the bad rows are padded, each range compacts its good rows
+    // towards its own beginning; the row states record where they are
+    // so that the ranges can be stitched together afterwards.
+    std::vector<Row_state> row_states(num_instances, Row_state::bad);
 
-    Csv_record_tokenizer tokenizer{params_};
+    std::atomic_size_t num_instances_read{};
 
-    auto [col_beg, col_end] = make_column_iterators();
+    tbb::blocked_range<std::size_t> range{
+        0, num_instances, decode_grain_size(column_names_.size())};
 
-    for (const Instance &instance : batch.instances()) {
-        Decoder<decltype(col_beg)> decoder{state, tokenizer, col_beg, col_end};
-        if (decoder.decode(row_idx, instance)) {
-            row_idx++;
+    auto worker = [&](auto &sub_range) {
+        std::unique_ptr<Decoder> decoder = acquire_decoder(state);
+
+        auto sub_instances = instances.subspan(sub_range.begin(), sub_range.size());
+
+        std::optional<std::size_t> num_read = decoder->decode(sub_range.begin(), sub_instances);
+        if (num_read == std::nullopt) {
+            // If we failed to decode an instance, we can terminate the
+            // task right away and skip this example.
+            skip_example = true;
         }
         else {
-            // If the user requested to skip the example in case of an
-            // error, shortcut the loop and return immediately.
-            if (params().bad_example_handling == Bad_example_handling::skip ||
-                params().bad_example_handling == Bad_example_handling::skip_warn) {
-                return {};
+            auto first = row_states.begin() + as_ssize(sub_range.begin());
+
+            std::fill_n(first, *num_read, Row_state::good);
+
+            num_instances_read += *num_read;
+        }
+
+        release_decoder(std::move(decoder));
+    };
+
+    tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+
+    if (skip_example) {
+        return {};
+    }
+
+    if (num_instances_read != num_instances) {
+        compact_rows(state, row_states);
+    }
+
+    return num_instances_read.load();
+}
+
+void Csv_reader::compact_rows(Decoder_state &state, stdx::span<const Row_state> row_states) const
+{
+    std::vector<Intrusive_ptr<Tensor>> &tensors = *state.tensors;
+
+    if (params_.stack_columns) {
+        auto &tensor = static_cast<Dense_tensor &>(*tensors.front());
+
+        float *values = tensor.data().as<float>().data();
+
+        // The rows only move towards the beginning, so they can be
+        // moved in order.
+        std::size_t num_rows = 0;
+        for (std::size_t row = 0; row < row_states.size(); row++) {
+            if (row_states[row] != Row_state::good) {
+                continue;
             }
-            if (params().bad_example_handling != Bad_example_handling::pad &&
-                params().bad_example_handling != Bad_example_handling::pad_warn) {
-                throw std::invalid_argument{"The specified bad example handling is invalid."};
+
+            if (num_rows != row) {
+                std::copy_n(values + row * num_read_columns_,
+                            num_read_columns_,
+                            values + num_rows * num_read_columns_);
             }
+
+            num_rows++;
         }
+
+        return;
     }
 
-    return row_idx;
+    std::vector<std::size_t> col_indices{};
+    col_indices.reserve(tensors.size());
+
+    for (std::size_t col_idx = 0; col_idx < column_parsers_.size(); col_idx++) {
+        if (column_ignores_[col_idx] == 0) {
+            col_indices.emplace_back(col_idx);
+        }
+    }
+
+    // The columns are independent of each other.
+    tbb::parallel_for(std::size_t{0}, tensors.size(), [&](std::size_t field_idx) {
+        if (tensors[field_idx] == nullptr) {
+            std::string_view *first = state.string_fields[field_idx].data();
+
+            std::string_view *pos = first;
+            for (Row_state row_state : row_states) {
+                if (row_state == Row_state::good) {
+                    *pos++ = *first;
+                }
+                ++first;
+            }
+
+            return;
+        }
+
+        auto &dense_tensor = static_cast<Dense_tensor &>(*tensors[field_idx]);
+
+        column_parsers_[col_indices[field_idx]].compact(dense_tensor.data(), 0, row_states);
+    });
 }
 
-std::optional<std::size_t>
-Csv_reader::decode_prl(Decoder_state &state, const Instance_batch &batch) const
+void Csv_reader::clear_rows(Decoder_state &state, std::size_t begin, std::size_t end) const
 {
-    std::atomic_bool skip_example{};
+    std::vector<Intrusive_ptr<Tensor>> &tensors = *state.tensors;
 
-    std::size_t num_instances = batch.instances().size();
+    if (params_.stack_columns) {
+        auto &tensor = static_cast<Dense_tensor &>(*tensors.front());
 
-    auto row_idx_beg = tbb::counting_iterator<std::size_t>(0);
-    auto row_idx_end = tbb::counting_iterator<std::size_t>(num_instances);
+        dispatch<detail::Clear_values_op>(
+            Data_type::float32, tensor.data(), begin * num_read_columns_, end * num_read_columns_);
 
-    auto instance_beg = batch.instances().begin();
-    auto instance_end = batch.instances().end();
+        return;
+    }
 
-    auto range_beg = tbb::make_zip_iterator(row_idx_beg, instance_beg);
-    auto range_end = tbb::make_zip_iterator(row_idx_end, instance_end);
+    for (Intrusive_ptr<Tensor> &tensor : tensors) {
+        // The string tensors are built after the rows are cleared.
+        if (tensor == nullptr) {
+            continue;
+        }
 
-    tbb::blocked_range<decltype(range_beg)> range{range_beg, range_end};
+        auto &dense_tensor = static_cast<Dense_tensor &>(*tensor);
 
-    auto worker = [this, &state, &skip_example](auto &sub_range) {
-        Csv_record_tokenizer tokenizer{params_};
+        dispatch<detail::Clear_values_op>(
+            dense_tensor.data_type(), dense_tensor.data(), begin, end);
+    }
+}
 
-        // Both GCC and clang have trouble handling structured bindings
-        // in lambdas.
-        auto iter_pair = make_column_iterators();
+std::optional<std::size_t> Csv_reader::decode_lazy(Decoder_state &state,
+                                                   const Instance_batch &batch,
+                                                   Lazy_columns &columns) const
+{
+    // Tokenizing is cheap compared to parsing, which is deferred to the
+    // consumer; so the rows are tokenized serially.
+    std::unique_ptr<Decoder> decoder = acquire_decoder(state);
 
-        using Col_iter = std::remove_reference_t<decltype(std::get<0>(iter_pair))>;
+    std::optional<std::size_t> num_instances_read =
+        decoder->tokenize_rows(batch.instances(), columns);
 
-        Col_iter col_beg = std::get<0>(iter_pair);
-        Col_iter col_end = std::get<1>(iter_pair);
+    release_decoder(std::move(decoder));
 
-        for (auto instance_zip : sub_range) {
-            // Both GCC and clang have a bug that prevents using class
-            // template argument deduction (CTAD) with nested types.
-            Decoder<Col_iter> decoder{state, tokenizer, col_beg, col_end};
-            if (!decoder.decode(std::get<0>(instance_zip), std::get<1>(instance_zip))) {
-                // If we failed to decode the instance, we can terminate
-                // the task right away and skip this example.
-                if (params().bad_example_handling == Bad_example_handling::skip ||
-                    params().bad_example_handling == Bad_example_handling::skip_warn) {
-                    skip_example = true;
+    return num_instances_read;
+}
 
-                    return;
-                }
+std::unique_ptr<Csv_reader::Decoder> Csv_reader::acquire_decoder(Decoder_state &state) const
+{
+    {
+        std::unique_lock<std::mutex> lock{decoders_mutex_};
 
-                throw std::invalid_argument{"The specified bad example handling is invalid."};
-            }
-        }
-    };
+        if (!decoders_.empty()) {
+            std::unique_ptr<Decoder> decoder = std::move(decoders_.back());
 
-    tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+            decoders_.pop_back();
 
-    if (skip_example) {
-        return {};
+            lock.unlock();
+
+            decoder->reset(state);
+
+            return decoder;
+        }
     }
 
-    return num_instances;
+    return std::make_unique<Decoder>(state);
+}
+
+void Csv_reader::release_decoder(std::unique_ptr<Decoder> decoder) const noexcept
+{
+    std::unique_lock<std::mutex> lock{decoders_mutex_};
+
+    try {
+        decoders_.emplace_back(std::move(decoder));
+    }
+    catch (const std::bad_alloc &) {
+    }
 }
 
 Csv_reader::Decoder_state::Decoder_state(const Csv_reader &r,
@@ -623,136 +1793,780 @@ Csv_reader::Decoder_state::Decoder_state(const Csv_reader &r,
     , error_bad_example{r.params().bad_example_handling == Bad_example_handling::error}
 {}
 
-template<typename Col_iter>
-bool Csv_reader::Decoder<Col_iter>::decode(std::size_t row_idx, const Instance &instance)
+std::string_view Csv_reader::Decoder_state::copy_string_field(std::string_view value)
+{
+    std::unique_lock<std::mutex> lock{string_copies_mutex};
+
+    return string_copies.emplace_back(value);
+}
+
+Csv_reader::Decoder::Decoder(Decoder_state &state)
+    : state_{&state}
+    , tokenizer_{make_tokenizer(state.reader->params_)}
+    , num_fields_{state.reader->num_read_columns_}
 {
-    auto col_pos = col_beg_;
+    // We decode the instances in tiles that are small enough to keep
+    // their field views in the cache while we parse them column by
+    // column.
+    constexpr std::size_t max_tile_num_fields = 0x4000;
 
-    auto tsr_pos = state_->tensors->begin();
+    max_num_rows_ = std::max(max_tile_num_fields / std::max(num_fields_, std::size_t{1}),
+                             std::size_t{1});
 
-    tokenizer_->reset(instance.bits());
+    const Csv_reader &reader = *state.reader;
 
-    while (tokenizer_->next()) {
-        if (col_pos == col_end_) {
-            break;
+    if (reader.params_.map_columns_by_header) {
+        field_slots_.reserve(reader.column_ignores_.size());
+
+        std::size_t field_idx = 0;
+        for (int ignored : reader.column_ignores_) {
+            if (ignored != 0) {
+                field_slots_.emplace_back(unmapped_column);
+            }
+            else {
+                field_slots_.emplace_back(field_idx++);
+            }
         }
+    }
+}
 
-        // Check if we should skip this column.
-        if (std::get<3>(*col_pos) != 0) {
-            ++col_pos;
+void Csv_reader::Decoder::reset(Decoder_state &state) noexcept
+{
+    state_ = &state;
+
+    // The store of the last decoded row might have been destroyed since
+    // then and another one allocated at the same address.
+    mapped_store_ = nullptr;
+
+    column_map_ = nullptr;
+}
+
+std::optional<std::size_t>
+Csv_reader::Decoder::decode(std::size_t row_idx, stdx::span<const Instance> instances)
+{
+    const Csv_reader &reader = *state_->reader;
+
+    std::size_t num_rows_read = 0;
+
+    for (std::size_t tile_pos = 0; tile_pos < instances.size(); tile_pos += max_num_rows_) {
+        auto tile = instances.subspan(tile_pos, std::min(max_num_rows_, instances.size() - tile_pos));
+
+        fields_.resize(tile.size() * num_fields_);
+
+        row_states_.assign(tile.size(), Row_state::good);
+
+        num_field_copies_ = 0;
+
+        std::size_t num_bad_rows = 0;
+
+        // Tokenize the whole tile first.
+        for (std::size_t i = 0; i < tile.size(); i++) {
+            if (tokenize(fields_.data() + i * num_fields_, tile[i])) {
+                continue;
+            }
+
+            if (!should_pad()) {
+                return {};
+            }
+
+            row_states_[i] = Row_state::bad;
+
+            num_bad_rows++;
+        }
+
+        // Good rows are stacked together without any gap in between.
+        std::size_t offset = row_idx + num_rows_read;
+
+        if (reader.params_.stack_columns) {
+            std::optional<std::size_t> num_failed = parse_stacked(tile, offset);
+            if (num_failed == std::nullopt) {
+                return {};
+            }
+
+            num_rows_read += tile.size() - num_bad_rows - *num_failed;
 
             continue;
         }
 
-        // Check if we truncated the field.
-        if (tokenizer_->truncated()) {
-            auto h = state_->reader->params_.max_field_length_handling;
-
-            if (h == Max_field_length_handling::treat_as_bad ||
-                h == Max_field_length_handling::truncate_warn) {
-                const std::string &name = std::get<1>(*col_pos);
-
-                auto msg = fmt::format(
-                    "The column '{2}' of the row #{1:n} in the data store '{0}' is too long. Its truncated value is '{3:.64}'.",
-                    instance.data_store().id(),
-                    instance.index(),
-                    name,
-                    tokenizer_->value());
-
-                if (h == Max_field_length_handling::truncate_warn) {
-                    logger::warn(msg);
+        // Then parse it column by column.
+        auto tsr_pos = state_->tensors->begin();
+
+        std::size_t field_idx = 0;
+
+        for (std::size_t col_idx = 0; col_idx < reader.column_parsers_.size(); col_idx++) {
+            // Check if we should skip this column.
+            if (reader.column_ignores_[col_idx] != 0) {
+                continue;
+            }
+
+            if (!state_->string_fields.empty() && !state_->string_fields[field_idx].empty()) {
+                stage_strings(tile, field_idx, offset);
+
+                ++tsr_pos;
+
+                field_idx++;
+
+                continue;
+            }
+
+            const Column_parser &parser = reader.column_parsers_[col_idx];
+
+            auto &dense_tensor = static_cast<Dense_tensor &>(**tsr_pos);
+
+            stdx::span<const std::string_view> col_fields{fields_};
+
+            std::size_t num_failed = 0;
+
+            detail::String_dictionary *dictionary = reader.dictionaries_[field_idx].get();
+            if (dictionary != nullptr) {
+                dictionary->encode(col_fields.subspan(field_idx),
+                                   num_fields_,
+                                   row_states_,
+                                   dense_tensor.data().as<std::int32_t>().data() + offset);
+            }
+            else if (reader.hashed_attrs_[field_idx]) {
+                detail::hash_column(col_fields.subspan(field_idx),
+                                    num_fields_,
+                                    row_states_,
+                                    dense_tensor.data().as<std::int64_t>().data() + offset,
+                                    reader.params_.num_hash_buckets,
+                                    reader.params_.hash_seed);
+            }
+            else {
+                num_failed = parser.parse(col_fields.subspan(field_idx),
+                                          num_fields_,
+                                          row_states_,
+                                          dense_tensor.data(),
+                                          offset,
+                                          reader.params_.parser_options);
+            }
+
+            if (num_failed > 0) {
+                report_parse_failures(col_idx, field_idx, tile);
+
+                if (!should_pad()) {
+                    return {};
                 }
-                else {
-                    if (state_->warn_bad_instance || state_->error_bad_example) {
-                        if (state_->warn_bad_instance) {
-                            logger::warn(msg);
-                        }
 
-                        if (state_->error_bad_example) {
-                            throw Invalid_instance_error{msg};
+                num_bad_rows += num_failed;
+            }
+
+            ++tsr_pos;
+
+            field_idx++;
+        }
+
+        if (num_bad_rows > 0) {
+            tsr_pos = state_->tensors->begin();
+
+            field_idx = 0;
+
+            for (std::size_t col_idx = 0; col_idx < reader.column_parsers_.size(); col_idx++) {
+                if (reader.column_ignores_[col_idx] != 0) {
+                    continue;
+                }
+
+                if (*tsr_pos == nullptr) {
+                    std::string_view *first = state_->string_fields[field_idx].data() + offset;
+
+                    std::string_view *pos = first;
+                    for (Row_state row_state : row_states_) {
+                        if (row_state == Row_state::good) {
+                            *pos++ = *first;
                         }
+                        ++first;
                     }
+                }
+                else {
+                    auto &dense_tensor = static_cast<Dense_tensor &>(**tsr_pos);
 
-                    return false;
+                    reader.column_parsers_[col_idx].compact(
+                        dense_tensor.data(), offset, row_states_);
                 }
+
+                ++tsr_pos;
+
+                field_idx++;
             }
-            else if (h != Max_field_length_handling::truncate) {
-                throw std::invalid_argument{
-                    "The specified maximum field length handling is invalid."};
+        }
+
+        num_rows_read += tile.size() - num_bad_rows;
+    }
+
+    return num_rows_read;
+}
+
+std::optional<std::size_t>
+Csv_reader::Decoder::tokenize_rows(stdx::span<const Instance> instances, Lazy_columns &columns)
+{
+    fields_.resize(num_fields_);
+
+    std::size_t num_rows_read = 0;
+
+    for (const Instance &instance : instances) {
+        num_field_copies_ = 0;
+
+        if (!tokenize(fields_.data(), instance)) {
+            if (!should_pad()) {
+                return {};
             }
+            continue;
         }
 
-        const Parser &parser = std::get<4>(*col_pos);
+        columns.append_row(instance, fields_);
+
+        num_rows_read++;
+    }
 
-        auto &dense_tensor = static_cast<Dense_tensor &>(**tsr_pos);
+    return num_rows_read;
+}
 
-        Parse_result r = parser(tokenizer_->value(), dense_tensor.data(), row_idx);
-        if (r == Parse_result::ok) {
-            ++col_pos;
-            ++tsr_pos;
+std::optional<std::size_t>
+Csv_reader::Decoder::parse_stacked(stdx::span<const Instance> tile, std::size_t offset)
+{
+    const Csv_reader &reader = *state_->reader;
+
+    std::size_t num_rows = tile.size();
+
+    // Writing each parsed value straight into the stacked tensor would
+    // touch a different cache line per row; instead we parse the tile
+    // column by column into a scratch buffer that fits into the cache
+    // and then transpose its good rows into the tensor.
+    if (stacked_tile_ == nullptr) {
+        stacked_tile_ = make_cpu_array(Data_type::float32, max_num_rows_ * num_fields_);
+    }
 
+    stdx::span<const std::string_view> fields{fields_};
+
+    std::size_t num_failed = 0;
+
+    std::size_t field_idx = 0;
+
+    for (std::size_t col_idx = 0; col_idx < reader.column_parsers_.size(); col_idx++) {
+        if (reader.column_ignores_[col_idx] != 0) {
             continue;
         }
 
-        if (state_->warn_bad_instance || state_->error_bad_example) {
-            const std::string &name = std::get<1>(*col_pos);
+        std::size_t num_col_failed =
+            reader.column_parsers_[col_idx].parse(fields.subspan(field_idx),
+                                                  num_fields_,
+                                                  row_states_,
+                                                  *stacked_tile_,
+                                                  field_idx * num_rows,
+                                                  reader.params_.parser_options);
+
+        if (num_col_failed > 0) {
+            report_parse_failures(col_idx, field_idx, tile);
+
+            if (!should_pad()) {
+                return {};
+            }
+
+            num_failed += num_col_failed;
+        }
+
+        field_idx++;
+    }
+
+    auto &tensor = static_cast<Dense_tensor &>(*state_->tensors->front());
+
+    const float *src = as_span<const float>(*stacked_tile_).data();
+
+    float *dst = tensor.data().as<float>().data() + offset * num_fields_;
+
+    for (std::size_t row = 0; row < num_rows; row++) {
+        if (row_states_[row] != Row_state::good) {
+            continue;
+        }
+
+        for (std::size_t col = 0; col < num_fields_; col++) {
+            dst[col] = src[col * num_rows + row];
+        }
+
+        dst += num_fields_;
+    }
+
+    return num_failed;
+}
+
+Csv_reader::Decoder::Tokenizer Csv_reader::Decoder::make_tokenizer(const Csv_params &params)
+{
+    using Comma_dialect = detail::Static_csv_dialect<',', '"'>;
+    using Tab_dialect = detail::Static_csv_dialect<'\t', '"'>;
+
+    if (Comma_dialect::matches(params)) {
+        return Tokenizer{std::in_place_type<detail::Comma_csv_record_tokenizer>, params};
+    }
+    if (Tab_dialect::matches(params)) {
+        return Tokenizer{std::in_place_type<detail::Tab_csv_record_tokenizer>, params};
+    }
+    return Tokenizer{std::in_place_type<Csv_record_tokenizer>, params};
+}
+
+bool Csv_reader::Decoder::tokenize(std::string_view *fields, const Instance &instance)
+{
+    detail::Allocation_scope scope{detail::Allocation_stage::tokenize};
+
+    const Column_map *column_map = find_column_map(instance);
+    if (column_map != nullptr) {
+        return std::visit(
+            [this, column_map, fields, &instance](auto &tokenizer) {
+                return tokenize_mapped(tokenizer, *column_map, fields, instance);
+            },
+            tokenizer_);
+    }
+
+    return std::visit(
+        [this, fields, &instance](auto &tokenizer) {
+            return tokenize(tokenizer, fields, instance);
+        },
+        tokenizer_);
+}
+
+const Csv_reader::Column_map *Csv_reader::Decoder::find_column_map(const Instance &instance)
+{
+    if (field_slots_.empty()) {
+        return nullptr;
+    }
+
+    // The rows of a batch mostly come from the same data store; avoid
+    // locking the map for every row.
+    const Data_store *store = &instance.data_store();
+    if (store != mapped_store_) {
+        column_map_ = state_->reader->find_column_map(*store);
+
+        mapped_store_ = store;
+    }
+
+    return column_map_.get();
+}
+
+template<typename Tokenizer_type>
+bool Csv_reader::Decoder::tokenize(Tokenizer_type &tokenizer,
+                                   std::string_view *fields,
+                                   const Instance &instance)
+{
+    const Csv_reader &reader = *state_->reader;
 
-            Data_type dt = std::get<2>(*col_pos);
+    std::size_t num_columns = reader.column_names_.size();
 
-            auto msg = fmt::format(
-                "The column '{2}' of the row #{1:n} in the data store '{0}' cannot be parsed as {3}. Its string value is '{4:.64}'.",
-                instance.data_store().id(),
-                instance.index(),
-                name,
-                dt,
-                tokenizer_->value());
+    std::size_t col_idx = 0;
 
-            if (state_->warn_bad_instance) {
-                logger::warn(msg);
+    tokenizer.reset(instance.bits());
+
+    // Past the last used column we only need to count the fields.
+    for (; col_idx < reader.num_scanned_columns_; col_idx++) {
+        // Check if we should skip this column; skipping a field does
+        // not copy or unescape it.
+        if (reader.column_ignores_[col_idx] != 0) {
+            if (!tokenizer.skip()) {
+                break;
             }
 
-            if (state_->error_bad_example) {
-                throw Invalid_instance_error{msg};
+            continue;
+        }
+
+        if (!tokenizer.next()) {
+            break;
+        }
+
+        // Check if we truncated the field.
+        if (tokenizer.truncated() && !handle_truncated_field(tokenizer.value(), instance, col_idx)) {
+            return false;
+        }
+
+        std::string_view value = tokenizer.value();
+
+        // If the tokenizer had to copy the field into its own buffer, we
+        // have to preserve it as it will be overwritten by the next one.
+        if (tokenizer.buffered()) {
+            value = copy_field(value);
+        }
+
+        *fields++ = value;
+    }
+
+    // Make sure the row has neither fewer nor more columns than expected.
+    std::size_t num_actual_cols = col_idx;
+    if (col_idx == reader.num_scanned_columns_) {
+        num_actual_cols += tokenizer.skip_rest();
+    }
+
+    return check_field_count(instance, num_actual_cols, num_columns);
+}
+
+template<typename Tokenizer_type>
+bool Csv_reader::Decoder::tokenize_mapped(Tokenizer_type &tokenizer,
+                                          const Column_map &column_map,
+                                          std::string_view *fields,
+                                          const Instance &instance)
+{
+    // The columns that the data store lacks are read as empty fields.
+    std::fill(fields, fields + num_fields_, std::string_view{});
+
+    tokenizer.reset(instance.bits());
+
+    std::size_t num_columns = column_map.size();
+
+    std::size_t num_actual_cols = 0;
+
+    for (; num_actual_cols < num_columns; num_actual_cols++) {
+        std::size_t col_idx = column_map[num_actual_cols];
+
+        std::size_t field_idx = unmapped_column;
+        if (col_idx != unmapped_column) {
+            field_idx = field_slots_[col_idx];
+        }
+
+        if (field_idx == unmapped_column) {
+            if (!tokenizer.skip()) {
+                break;
             }
+
+            continue;
         }
 
-        return false;
+        if (!tokenizer.next()) {
+            break;
+        }
+
+        if (tokenizer.truncated() && !handle_truncated_field(tokenizer.value(), instance, col_idx)) {
+            return false;
+        }
+
+        std::string_view value = tokenizer.value();
+
+        if (tokenizer.buffered()) {
+            value = copy_field(value);
+        }
+
+        fields[field_idx] = value;
     }
 
-    // Make sure we read all columns and there are no remaining fields.
-    if (col_pos == col_end_ && tokenizer_->eof()) {
-        return true;
+    if (num_actual_cols == num_columns) {
+        num_actual_cols += tokenizer.skip_rest();
     }
 
-    if (state_->warn_bad_instance || state_->error_bad_example) {
-        std::size_t num_columns = state_->reader->column_names_.size();
+    return check_field_count(instance, num_actual_cols, num_columns);
+}
 
-        std::size_t num_actual_cols = std::get<0>(*col_pos);
-        while (tokenizer_->next()) {
-            num_actual_cols++;
+bool Csv_reader::Decoder::handle_truncated_field(std::string_view field,
+                                                 const Instance &instance,
+                                                 std::size_t col_idx)
+{
+    const Csv_reader &reader = *state_->reader;
+
+    auto h = reader.params_.max_field_length_handling;
+
+    if (h == Max_field_length_handling::treat_as_bad ||
+        h == Max_field_length_handling::truncate_warn) {
+        auto format_message = [r = &reader,
+                               i = &instance,
+                               col_idx,
+                               value = detail::copy_field_prefix(field)]() {
+            return fmt::format(
+                "The column '{2}' of the row #{1:n} in the data store '{0}' is too long. Its truncated value is '{3:.64}'.",
+                i->data_store().id(),
+                i->index(),
+                r->column_names_[col_idx],
+                value);
+        };
+
+        if (h == Max_field_length_handling::truncate_warn) {
+            // A truncated field does not make the row bad.
+            state_->warnings.add(
+                detail::Decode_warning{detail::Decode_warning_kind::long_field,
+                                       &instance,
+                                       col_idx,
+                                       std::move(format_message)});
         }
-        if (col_pos == col_end_) {
-            num_actual_cols++;
+        else {
+            report_bad_instance(
+                detail::Decode_warning_kind::long_field, instance, col_idx, format_message);
+
+            return false;
         }
+    }
+    else if (h != Max_field_length_handling::truncate) {
+        throw std::invalid_argument{"The specified maximum field length handling is invalid."};
+    }
 
-        auto msg = fmt::format(
-            "The row #{1:n} in the data store '{0}' has {2:n} column(s) while it is expected to have {3:n} column(s).",
-            instance.data_store().id(),
-            instance.index(),
-            num_actual_cols,
-            num_columns);
+    return true;
+}
 
-        if (state_->warn_bad_instance) {
-            logger::warn(msg);
+bool Csv_reader::Decoder::check_field_count(const Instance &instance,
+                                            std::size_t num_actual_cols,
+                                            std::size_t num_columns)
+{
+    if (num_actual_cols == num_columns) {
+        return true;
+    }
+
+    report_bad_instance(detail::Decode_warning_kind::field_count_mismatch,
+                        instance,
+                        detail::Decode_warning::no_column,
+                        [i = &instance, num_actual_cols, num_columns]() {
+                            return fmt::format(
+                                "The row #{1:n} in the data store '{0}' has {2:n} column(s) while it is expected to have {3:n} column(s).",
+                                i->data_store().id(),
+                                i->index(),
+                                num_actual_cols,
+                                num_columns);
+                        });
+
+    return false;
+}
+
+void Csv_reader::Decoder::report_parse_failures(std::size_t col_idx,
+                                                std::size_t field_idx,
+                                                stdx::span<const Instance> instances)
+{
+    const Csv_reader &reader = *state_->reader;
+
+    for (std::size_t i = 0; i < row_states_.size(); i++) {
+        Row_state state = row_states_[i];
+        if (state != Row_state::parse_failed && state != Row_state::overflowed) {
+            continue;
         }
 
-        if (state_->error_bad_example) {
-            throw Invalid_instance_error{msg};
+        row_states_[i] = Row_state::bad;
+
+        const Instance &instance = instances[i];
+
+        std::string value{};
+        if (state_->warn_bad_instance || state_->error_bad_example) {
+            value = detail::copy_field_prefix(fields_[i * num_fields_ + field_idx]);
+        }
+
+        if (state == Row_state::overflowed) {
+            report_bad_instance(detail::Decode_warning_kind::overflow,
+                                instance,
+                                col_idx,
+                                [r = &reader, i = &instance, col_idx, value = std::move(value)]() {
+                                    return fmt::format(
+                                        "The column '{2}' of the row #{1:n} in the data store '{0}' has a value that does not fit into {3}. Its string value is '{4:.64}'.",
+                                        i->data_store().id(),
+                                        i->index(),
+                                        r->column_names_[col_idx],
+                                        r->column_types_[col_idx],
+                                        value);
+                                });
+        }
+        else {
+            report_bad_instance(detail::Decode_warning_kind::parse_error,
+                                instance,
+                                col_idx,
+                                [r = &reader, i = &instance, col_idx, value = std::move(value)]() {
+                                    return fmt::format(
+                                        "The column '{2}' of the row #{1:n} in the data store '{0}' cannot be parsed as {3}. Its string value is '{4:.64}'.",
+                                        i->data_store().id(),
+                                        i->index(),
+                                        r->column_names_[col_idx],
+                                        r->column_types_[col_idx],
+                                        value);
+                                });
+        }
+
+        // Unless we pad the example, there is no need to go further.
+        if (!should_pad()) {
+            return;
         }
     }
+}
+
+template<typename Format_fn>
+void Csv_reader::Decoder::report_bad_instance(detail::Decode_warning_kind kind,
+                                              const Instance &instance,
+                                              std::size_t col_idx,
+                                              Format_fn &&format_message) const
+{
+    if (state_->error_bad_example) {
+        throw Invalid_instance_error{format_message()};
+    }
+
+    // The message is formatted later, outside of the decode loop, and
+    // only if it gets logged.
+    detail::Decode_warning warning{kind, &instance, col_idx};
+    if (state_->warn_bad_instance) {
+        warning.format_message = std::forward<Format_fn>(format_message);
+    }
+
+    state_->warnings.add(std::move(warning));
+}
+
+bool Csv_reader::Decoder::should_pad() const
+{
+    Bad_example_handling h = state_->reader->params().bad_example_handling;
+
+    if (h == Bad_example_handling::pad || h == Bad_example_handling::pad_warn) {
+        return true;
+    }
+
+    if (h != Bad_example_handling::skip && h != Bad_example_handling::skip_warn) {
+        throw std::invalid_argument{"The specified bad example handling is invalid."};
+    }
 
     return false;
 }
 
+void Csv_reader::Decoder::stage_strings(stdx::span<const Instance> tile,
+                                        std::size_t field_idx,
+                                        std::size_t offset)
+{
+    std::string_view *values = state_->string_fields[field_idx].data() + offset;
+
+    for (std::size_t i = 0; i < tile.size(); i++) {
+        if (row_states_[i] != Row_state::good) {
+            values[i] = {};
+
+            continue;
+        }
+
+        std::string_view field = fields_[i * num_fields_ + field_idx];
+
+        // Most fields refer to their rows, which are kept alive by the
+        // batch; the others refer to field_copies_ that gets reused by
+        // the next tile.
+        std::string_view row = as_string_view(tile[i].bits());
+        if (!field.empty() &&
+            (field.data() < row.data() || field.data() + field.size() > row.data() + row.size())) {
+            field = state_->copy_string_field(field);
+        }
+
+        values[i] = field;
+    }
+}
+
+std::string_view Csv_reader::Decoder::copy_field(std::string_view value)
+{
+    if (num_field_copies_ == field_copies_.size()) {
+        field_copies_.emplace_back();
+    }
+
+    std::string &copy = field_copies_[num_field_copies_++];
+
+    copy.assign(value);
+
+    return copy;
+}
+
+Csv_reader::Lazy_columns::Lazy_columns(std::shared_ptr<const Lazy_context> context,
+                                       std::size_t batch_size) noexcept
+    : context_{std::move(context)}, batch_size_{batch_size}, num_fields_{context_->parsers.size()}
+{}
+
+void Csv_reader::Lazy_columns::append_row(const Instance &instance,
+                                          stdx::span<const std::string_view> fields)
+{
+    const Memory_slice &bits = instance.bits();
+
+    auto chars = as_span<const char>(bits);
+
+    std::less<const char *> less{};
+
+    for (std::string_view field : fields) {
+        if (field.empty()) {
+            fields_.emplace_back();
+
+            continue;
+        }
+
+        // The copies made by the decoder get reused for the next row.
+        if (less(field.data(), chars.data()) ||
+            less(chars.data() + chars.size(), field.data() + field.size())) {
+            field = field_copies_.emplace_back(field);
+
+            num_bytes_ += field.size();
+        }
+
+        fields_.emplace_back(field);
+    }
+
+    const Data_store *store = &instance.data_store();
+    if (store != last_store_) {
+        store_ids_.emplace_back(store->id());
+
+        last_store_ = store;
+    }
+
+    row_infos_.push_back(Row_info{instance.index(), store_ids_.size() - 1});
+
+    rows_.emplace_back(bits);
+
+    num_bytes_ += bits.size() + fields.size() * sizeof(std::string_view);
+}
+
+Intrusive_ptr<Tensor> Csv_reader::Lazy_columns::materialize(std::size_t index) const
+{
+    const Lazy_context &context = *context_;
+
+    // The padding rows are left zero-initialized.
+    std::unique_ptr<Device_array> arr = make_cpu_array(context.data_types[index], batch_size_);
+
+    std::size_t num_rows = rows_.size();
+    if (num_rows > 0) {
+        std::vector<Row_state> row_states(num_rows, Row_state::good);
+
+        auto fields = stdx::span<const std::string_view>{fields_}.subspan(index);
+
+        detail::String_dictionary *dictionary = context.dictionaries[index].get();
+        if (dictionary != nullptr) {
+            dictionary->encode(fields, num_fields_, row_states, as_span<std::int32_t>(*arr).data());
+        }
+        else if (context.hashed[index]) {
+            detail::hash_column(fields,
+                                num_fields_,
+                                row_states,
+                                as_span<std::int64_t>(*arr).data(),
+                                context.num_hash_buckets,
+                                context.hash_seed);
+        }
+        else {
+            std::size_t num_failed = context.parsers[index].parse(
+                fields, num_fields_, row_states, *arr, 0, context.parser_options);
+
+            if (num_failed > 0) {
+                throw_parse_failure(index, row_states);
+            }
+        }
+    }
+
+    return make_intrusive<Dense_tensor>(Size_vector{batch_size_, 1}, std::move(arr));
+}
+
+void Csv_reader::Lazy_columns::throw_parse_failure(std::size_t index,
+                                                   stdx::span<const Row_state> row_states) const
+{
+    const Lazy_context &context = *context_;
+
+    auto pos = std::find_if(row_states.begin(), row_states.end(), [](Row_state state) {
+        return state == Row_state::parse_failed || state == Row_state::overflowed;
+    });
+
+    auto row = as_size(pos - row_states.begin());
+
+    const Row_info &info = row_infos_[row];
+
+    std::string value = detail::copy_field_prefix(fields_[row * num_fields_ + index]);
+
+    if (*pos == Row_state::overflowed) {
+        throw Invalid_instance_error{fmt::format(
+            "The column '{2}' of the row #{1:n} in the data store '{0}' has a value that does not fit into {3}. Its string value is '{4:.64}'.",
+            store_ids_[info.store_idx],
+            info.index,
+            context.column_names[index],
+            context.column_types[index],
+            value)};
+    }
+
+    throw Invalid_instance_error{fmt::format(
+        "The column '{2}' of the row #{1:n} in the data store '{0}' cannot be parsed as {3}. Its string value is '{4:.64}'.",
+        store_ids_[info.store_idx],
+        info.index,
+        context.column_names[index],
+        context.column_types[index],
+        value)};
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
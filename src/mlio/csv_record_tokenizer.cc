@@ -15,15 +15,41 @@
 
 #include "mlio/csv_record_tokenizer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "mlio/record_readers/record_error.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
+
+inline const char *find_char(const char *first, const char *last, char chr) noexcept
+{
+    if (first == last) {
+        return last;
+    }
+
+    // memchr is vectorized by the C runtime using the widest instruction
+    // set available on the host (e.g. AVX2, SSE2, or NEON) and scans a
+    // field considerably faster than a char-by-char loop.
+    const void *pos = std::memchr(first, chr, as_size(last - first));
+    if (pos == nullptr) {
+        return last;
+    }
+    return static_cast<const char *>(pos);
+}
+
+}  // namespace
 
-bool Csv_record_tokenizer::next()
+template<typename Dialect>
+bool Basic_csv_record_tokenizer<Dialect>::next()
 {
-    value_.clear();
+    value_ = {};
+
+    buffered_ = false;
 
     truncated_ = false;
 
@@ -33,115 +59,209 @@ bool Csv_record_tokenizer::next()
         return false;
     }
 
-    char chr{};
-
-    // Start of a new field.
-    Parser_state state = Parser_state::new_field;
+    const char *pos = text_pos_;
 
-    if (!try_get_next_char(chr)) {
-        goto end_line;  // NOLINT
-    }
-
-    if (chr == delimiter_) {
-        goto end_field;  // NOLINT
-    }
-    else if (chr == quote_char_) {
-        goto in_quoted_field;  // NOLINT
+    if (pos != text_.end() && *pos == dialect_.quote_char()) {
+        read_quoted_field(pos + 1);
     }
     else {
-        push_char(chr);
-        goto in_field;  // NOLINT
+        read_field(pos);
     }
 
-in_field:
-    state = Parser_state::in_field;
+    // A constant in the static dialects; the check is compiled away.
+    std::optional<std::size_t> max_field_length = dialect_.max_field_length();
+    if (max_field_length && value_.size() > *max_field_length) {
+        value_ = value_.substr(0, *max_field_length);
 
-    if (!try_get_next_char(chr)) {
-        goto end_line;  // NOLINT
+        truncated_ = true;
     }
 
-    if (chr == delimiter_) {
-        goto end_field;  // NOLINT
-    }
-    else {
-        push_char(chr);
-        goto in_field;  // NOLINT
-    }
+    return true;
+}
 
-in_quoted_field:
-    state = Parser_state::in_quoted_field;
+template<typename Dialect>
+bool Basic_csv_record_tokenizer<Dialect>::skip()
+{
+    value_ = {};
 
-    if (!try_get_next_char(chr)) {
-        goto end_line;  // NOLINT
+    buffered_ = false;
+
+    truncated_ = false;
+
+    if (finished_) {
+        eof_ = true;
+
+        return false;
     }
 
-    if (chr == quote_char_) {
-        goto quote_in_quoted_field;  // NOLINT
+    const char *pos = text_pos_;
+
+    if (pos != text_.end() && *pos == dialect_.quote_char()) {
+        skip_quoted_field(pos + 1);
     }
     else {
-        push_char(chr);
-        goto in_quoted_field;  // NOLINT
+        end_field(find_char(pos, text_.end(), dialect_.delimiter()));
     }
 
-quote_in_quoted_field:
-    state = Parser_state::quote_in_quoted_field;
+    return true;
+}
 
-    if (!try_get_next_char(chr)) {
-        goto end_line;  // NOLINT
+template<typename Dialect>
+std::size_t Basic_csv_record_tokenizer<Dialect>::skip_rest()
+{
+    std::size_t num_fields = 0;
+
+    if (!finished_) {
+        const char *pos = text_pos_;
+
+        // Without quotes every delimiter separates two fields.
+        if (find_char(pos, text_.end(), dialect_.quote_char()) == text_.end()) {
+            num_fields = as_size(std::count(pos, text_.end(), dialect_.delimiter())) + 1;
+
+            end_field(text_.end());
+        }
+        else {
+            while (skip()) {
+                num_fields++;
+            }
+        }
     }
 
-    if (chr == delimiter_) {
-        goto end_field;  // NOLINT
-    }
-    else if (chr == quote_char_) {
-        push_char(chr);
-        goto in_quoted_field;  // NOLINT
-    }
-    else {
-        push_char(chr);
-        goto in_field;  // NOLINT
-    }
+    value_ = {};
 
-end_line:
-    switch (state) {
-    case Parser_state::new_field:
-    case Parser_state::in_field:
-    case Parser_state::quote_in_quoted_field:
-        finished_ = true;
-        break;
+    eof_ = true;
+
+    return num_fields;
+}
+
+template<typename Dialect>
+inline void Basic_csv_record_tokenizer<Dialect>::read_field(const char *first) noexcept
+{
+    const char *last = find_char(first, text_.end(), dialect_.delimiter());
+
+    // An unquoted field never needs to be copied; we can simply return a
+    // view of the underlying text.
+    value_ = std::string_view{first, as_size(last - first)};
+
+    end_field(last);
+}
+
+template<typename Dialect>
+void Basic_csv_record_tokenizer<Dialect>::read_quoted_field(const char *first)
+{
+    const char *pos = first;
+
+    for (;;) {
+        const char *quote_pos = find_char(pos, text_.end(), dialect_.quote_char());
+        if (quote_pos == text_.end()) {
+            throw Corrupt_record_error{"EOF reached inside a quoted field."};
+        }
+
+        append(pos, quote_pos);
+
+        pos = quote_pos + 1;
+
+        if (pos == text_.end() || *pos == dialect_.delimiter()) {
+            end_field(pos);
 
-    case Parser_state::in_quoted_field:
-        throw Corrupt_record_error{"EOF reached inside a quoted field."};
+            return;
+        }
+
+        // An escaped quote; keep the second quote char and continue with
+        // the quoted field.
+        if (*pos == dialect_.quote_char()) {
+            append(pos, pos + 1);
+
+            ++pos;
+
+            continue;
+        }
+
+        // Any characters following the closing quote are treated as part
+        // of an unquoted field.
+        const char *last = find_char(pos, text_.end(), dialect_.delimiter());
+
+        append(pos, last);
+
+        end_field(last);
+
+        return;
     }
+}
 
-end_field:
-    return true;
+template<typename Dialect>
+void Basic_csv_record_tokenizer<Dialect>::skip_quoted_field(const char *first)
+{
+    const char *pos = first;
+
+    for (;;) {
+        const char *quote_pos = find_char(pos, text_.end(), dialect_.quote_char());
+        if (quote_pos == text_.end()) {
+            throw Corrupt_record_error{"EOF reached inside a quoted field."};
+        }
+
+        pos = quote_pos + 1;
+
+        if (pos == text_.end() || *pos == dialect_.delimiter()) {
+            end_field(pos);
+
+            return;
+        }
+
+        // An escaped quote.
+        if (*pos == dialect_.quote_char()) {
+            ++pos;
+
+            continue;
+        }
+
+        end_field(find_char(pos, text_.end(), dialect_.delimiter()));
+
+        return;
+    }
 }
 
-inline bool Csv_record_tokenizer::try_get_next_char(char &chr) noexcept
+template<typename Dialect>
+inline void Basic_csv_record_tokenizer<Dialect>::append(const char *first, const char *last)
 {
-    if (text_pos_ == text_.end()) {
-        return false;
+    if (first == last) {
+        return;
     }
 
-    chr = *text_pos_;
+    // As long as the field consists of a single contiguous segment we
+    // avoid copying it into the internal buffer.
+    if (!buffered_) {
+        if (value_.empty()) {
+            value_ = std::string_view{first, as_size(last - first)};
 
-    ++text_pos_;
+            return;
+        }
 
-    return true;
+        buffer_.assign(value_.data(), value_.size());
+
+        buffered_ = true;
+    }
+
+    buffer_.append(first, last);
+
+    value_ = buffer_;
 }
 
-inline void Csv_record_tokenizer::push_char(char chr) noexcept
+template<typename Dialect>
+inline void Basic_csv_record_tokenizer<Dialect>::end_field(const char *pos) noexcept
 {
-    if (max_field_length_ && value_.size() == *max_field_length_) {
-        truncated_ = true;
+    if (pos == text_.end()) {
+        text_pos_ = pos;
+
+        finished_ = true;
     }
     else {
-        value_.push_back(chr);
+        text_pos_ = pos + 1;
     }
 }
 
-void Csv_record_tokenizer::reset(Memory_span blob)
+template<typename Dialect>
+void Basic_csv_record_tokenizer<Dialect>::reset(Memory_span blob)
 {
     text_ = as_span<const char>(blob);
 
@@ -152,6 +272,10 @@ void Csv_record_tokenizer::reset(Memory_span blob)
     eof_ = false;
 }
 
+template class Basic_csv_record_tokenizer<Runtime_csv_dialect>;
+template class Basic_csv_record_tokenizer<Static_csv_dialect<',', '"'>>;
+template class Basic_csv_record_tokenizer<Static_csv_dialect<'\t', '"'>>;
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
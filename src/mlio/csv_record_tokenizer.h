@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "mlio/csv_reader.h"
 #include "mlio/span.h"
@@ -26,28 +27,111 @@ namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
-class Csv_record_tokenizer {
+// Describes a CSV dialect whose parameters are only known at runtime.
+class Runtime_csv_dialect {
 public:
-    explicit Csv_record_tokenizer(const Csv_params &params) noexcept
-        : Csv_record_tokenizer{params, {}}
-    {}
-
-    explicit Csv_record_tokenizer(const Csv_params &params, Memory_span blob) noexcept
-        : text_{as_span<const char>(blob)}
-        , delimiter_{params.delimiter}
+    explicit Runtime_csv_dialect(const Csv_params &params) noexcept
+        : delimiter_{params.delimiter}
         , quote_char_{params.quote_char}
         , max_field_length_{params.max_field_length}
     {}
 
+    char delimiter() const noexcept
+    {
+        return delimiter_;
+    }
+
+    char quote_char() const noexcept
+    {
+        return quote_char_;
+    }
+
+    std::optional<std::size_t> max_field_length() const noexcept
+    {
+        return max_field_length_;
+    }
+
+private:
+    char delimiter_;
+    char quote_char_;
+    std::optional<std::size_t> max_field_length_;
+};
+
+// Describes a common CSV dialect at compile time. The tokenizer compares
+// against constants and drops the field truncation check altogether.
+template<char Delimiter, char Quote_char>
+class Static_csv_dialect {
+public:
+    explicit Static_csv_dialect(const Csv_params &) noexcept
+    {}
+
+    /// Indicates whether the dialect can tokenize text with the
+    /// specified parameters.
+    static bool matches(const Csv_params &params) noexcept
+    {
+        return params.delimiter == Delimiter && params.quote_char == Quote_char &&
+               !params.max_field_length;
+    }
+
+    static constexpr char delimiter() noexcept
+    {
+        return Delimiter;
+    }
+
+    static constexpr char quote_char() noexcept
+    {
+        return Quote_char;
+    }
+
+    static constexpr std::optional<std::size_t> max_field_length() noexcept
+    {
+        return {};
+    }
+};
+
+template<typename Dialect>
+class Basic_csv_record_tokenizer {
+public:
+    explicit Basic_csv_record_tokenizer(const Csv_params &params) noexcept
+        : Basic_csv_record_tokenizer{params, {}}
+    {}
+
+    explicit Basic_csv_record_tokenizer(const Csv_params &params, Memory_span blob) noexcept
+        : text_{as_span<const char>(blob)}, dialect_{params}
+    {}
+
     bool next();
 
+    /// Moves past the current field without reading its value; the
+    /// delimiters and quotes are still honored.
+    ///
+    /// @return
+    ///     False if there are no more fields, similar to @ref next().
+    bool skip();
+
+    /// Moves to the end of the text and returns the number of fields
+    /// skipped. If the remaining text has no quotes, this is a single
+    /// scan for the delimiter.
+    std::size_t skip_rest();
+
     void reset(Memory_span blob);
 
-    const std::string &value() const noexcept
+    /// Returns the value of the current field. If the field contains no
+    /// escaped quotes, the returned view points directly into the blob
+    /// passed to the constructor or to @ref reset().
+    std::string_view value() const noexcept
     {
         return value_;
     }
 
+    /// Indicates whether the value of the current field had to be copied
+    /// into an internal buffer, in which case it will be overwritten by
+    /// the next call to @ref next().
+    bool buffered() const noexcept
+    {
+        return buffered_;
+    }
+
     bool truncated() const noexcept
     {
         return truncated_;
@@ -59,23 +143,38 @@ public:
     }
 
 private:
-    enum class Parser_state { new_field, in_field, in_quoted_field, quote_in_quoted_field };
+    void read_field(const char *first) noexcept;
+
+    void read_quoted_field(const char *first);
 
-    bool try_get_next_char(char &chr) noexcept;
+    void skip_quoted_field(const char *first);
 
-    void push_char(char chr) noexcept;
+    void append(const char *first, const char *last);
+
+    void end_field(const char *pos) noexcept;
 
     stdx::span<const char> text_{};
     stdx::span<const char>::iterator text_pos_ = text_.begin();
-    char delimiter_;
-    char quote_char_;
-    std::optional<std::size_t> max_field_length_{};
-    std::string value_{};
+    Dialect dialect_;
+    std::string_view value_{};
+    std::string buffer_{};
+    bool buffered_{};
     bool truncated_{};
     bool finished_{};
     bool eof_{};
 };
 
+using Csv_record_tokenizer = Basic_csv_record_tokenizer<Runtime_csv_dialect>;
+
+// The tokenizers of the dialects that Csv_reader specializes its
+// decoder for.
+using Comma_csv_record_tokenizer = Basic_csv_record_tokenizer<Static_csv_dialect<',', '"'>>;
+using Tab_csv_record_tokenizer = Basic_csv_record_tokenizer<Static_csv_dialect<'\t', '"'>>;
+
+extern template class Basic_csv_record_tokenizer<Runtime_csv_dialect>;
+extern template class Basic_csv_record_tokenizer<Static_csv_dialect<',', '"'>>;
+extern template class Basic_csv_record_tokenizer<Static_csv_dialect<'\t', '"'>>;
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
@@ -15,10 +15,27 @@
 
 #include "mlio/data_reader.h"
 
+#include "mlio/not_supported_error.h"
+
 namespace mlio {
 inline namespace abi_v1 {
 
 Data_reader::~Data_reader() = default;
 
+Data_reader_state Data_reader::save_state() const
+{
+    throw Not_supported_error{"The data reader does not support saving its state."};
+}
+
+void Data_reader::restore_state(const Data_reader_state &)
+{
+    throw Not_supported_error{"The data reader does not support restoring its state."};
+}
+
+Instance_count Data_reader::estimate_num_instances(bool)
+{
+    throw Not_supported_error{"The data reader does not support counting its instances."};
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
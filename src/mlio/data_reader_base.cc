@@ -27,17 +27,32 @@ Intrusive_ptr<Example> Data_reader_base::read_example()
     if (peeked_example_) {
         return std::exchange(peeked_example_, nullptr);
     }
-    return read_example_core();
+    return read_next_example();
 }
 
 Intrusive_ptr<Example> Data_reader_base::peek_example()
 {
     if (peeked_example_ == nullptr) {
-        peeked_example_ = read_example_core();
+        peeked_example_ = read_next_example();
     }
     return peeked_example_;
 }
 
+Intrusive_ptr<Example> Data_reader_base::read_next_example()
+{
+    Intrusive_ptr<Example> example = read_example_core();
+
+    if (params_.deferred_reclamation && example != nullptr) {
+        if (reclaimer_ == nullptr) {
+            reclaimer_ = make_intrusive<Example_reclaimer>();
+        }
+
+        example->defer_reclamation(reclaimer_);
+    }
+
+    return example;
+}
+
 void Data_reader_base::reset() noexcept
 {
     peeked_example_ = nullptr;
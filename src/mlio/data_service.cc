@@ -0,0 +1,786 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_service.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/detail/error.h"
+#include "mlio/detail/example_codec.h"
+#include "mlio/detail/socket.h"
+#include "mlio/detail/thread.h"
+#include "mlio/example.h"
+#include "mlio/logger.h"
+#include "mlio/span.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+using namespace std::chrono_literals;
+
+// How often the worker checks whether it has been stopped while
+// waiting for new connections.
+constexpr auto accept_interval = 100ms;
+
+constexpr std::uint32_t message_magic = 0x4d4c494f;  // "MLIO"
+
+enum class Message_type : std::uint32_t {
+    // reader -> worker
+    hello,
+    start_split,
+    stop_split,
+    // worker -> reader
+    schema,
+    example,
+    split_done,
+    error,
+};
+
+struct Message_header {
+    std::uint32_t magic;
+    Message_type type;
+    std::uint64_t size;
+};
+
+[[noreturn]] void throw_protocol_error()
+{
+    throw Data_reader_error{"The data service peer has sent an unexpected message."};
+}
+
+Memory_span as_memory_span(const void *data, std::size_t size) noexcept
+{
+    return Memory_span{static_cast<const std::byte *>(data), size};
+}
+
+void send_message(int fd,
+                  Message_type type,
+                  stdx::span<const std::uint64_t> words = {},
+                  stdx::span<const Memory_span> buffers = {})
+{
+    std::uint64_t num_words = words.size();
+
+    Message_header hdr{message_magic, type, 0};
+
+    std::vector<Memory_span> payload{};
+    payload.reserve(buffers.size() + 3);
+
+    payload.emplace_back(as_memory_span(&hdr, sizeof(hdr)));
+
+    // The examples are prefixed with the number of words so that the
+    // receiver can tell the words apart from the tensor buffers.
+    if (type == Message_type::example) {
+        payload.emplace_back(as_memory_span(&num_words, sizeof(num_words)));
+    }
+
+    payload.emplace_back(as_memory_span(words.data(), words.size_bytes()));
+
+    payload.insert(payload.end(), buffers.begin(), buffers.end());
+
+    for (auto pos = payload.begin() + 1; pos < payload.end(); ++pos) {
+        hdr.size += pos->size();
+    }
+
+    send_all(fd, payload);
+}
+
+void send_error(int fd, std::string_view msg)
+{
+    Message_header hdr{message_magic, Message_type::error, msg.size()};
+
+    std::array<Memory_span, 2> payload{as_memory_span(&hdr, sizeof(hdr)),
+                                       as_memory_span(msg.data(), msg.size())};
+
+    send_all(fd, payload);
+}
+
+bool recv_header(int fd, Message_header &hdr)
+{
+    if (!recv_all(fd, &hdr, sizeof(hdr))) {
+        return false;
+    }
+
+    if (hdr.magic != message_magic) {
+        throw_protocol_error();
+    }
+
+    return true;
+}
+
+std::uint64_t recv_word(int fd, const Message_header &hdr)
+{
+    std::uint64_t value{};
+    if (hdr.size != sizeof(value) || !recv_all(fd, &value, sizeof(value))) {
+        throw_protocol_error();
+    }
+    return value;
+}
+
+}  // namespace
+
+// Serves the requests of a single reader in a background thread.
+class Data_service_session {
+public:
+    explicit Data_service_session(File_descriptor fd, const Data_reader_factory &factory)
+        : fd_{std::move(fd)}, factory_{&factory}, thread_{start_thread(&Data_service_session::run, this)}
+    {}
+
+    Data_service_session(const Data_service_session &) = delete;
+
+    Data_service_session &operator=(const Data_service_session &) = delete;
+
+    Data_service_session(Data_service_session &&) = delete;
+
+    Data_service_session &operator=(Data_service_session &&) = delete;
+
+    ~Data_service_session()
+    {
+        shutdown();
+
+        thread_.join();
+    }
+
+    // Wakes up the thread if it is blocked on the socket.
+    void shutdown() noexcept
+    {
+        ::shutdown(fd_.get(), SHUT_RDWR);
+    }
+
+    bool closed() const noexcept
+    {
+        return closed_;
+    }
+
+private:
+    void run() noexcept
+    {
+        try {
+            Message_header hdr{};
+            while (recv_header(fd_.get(), hdr)) {
+                // The message type is read from the peer and is not
+                // necessarily a valid enumerator.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+                switch (hdr.type) {
+                case Message_type::hello:
+                    num_splits_ = recv_word(fd_.get(), hdr);
+
+                    send_schema();
+                    break;
+
+                case Message_type::start_split:
+                    serve_split(recv_word(fd_.get(), hdr));
+                    break;
+
+                case Message_type::stop_split:
+                    // The split has already been completed.
+                    recv_word(fd_.get(), hdr);
+                    break;
+
+                default:
+                    throw_protocol_error();
+                }
+
+#pragma GCC diagnostic pop
+            }
+        }
+        catch (const std::exception &e) {
+            logger::warn("The data service connection has been closed: {0}", e.what());
+        }
+
+        closed_ = true;
+    }
+
+    void send_schema()
+    {
+        std::vector<std::uint64_t> words{};
+        try {
+            Intrusive_ptr<Data_reader> reader = (*factory_)(0, num_splits_);
+
+            words = encode_schema(*reader->read_schema());
+        }
+        catch (const std::exception &e) {
+            send_error(fd_.get(), e.what());
+
+            return;
+        }
+
+        send_message(fd_.get(), Message_type::schema, words);
+    }
+
+    void serve_split(std::size_t split_index)
+    {
+        try {
+            Intrusive_ptr<Data_reader> reader = (*factory_)(split_index, num_splits_);
+
+            while (!is_readable(fd_.get())) {
+                Intrusive_ptr<Example> example = reader->read_example();
+                if (example == nullptr) {
+                    break;
+                }
+
+                Encoded_example encoded = encode_example(*example);
+
+                send_message(fd_.get(), Message_type::example, encoded.words, encoded.buffers);
+            }
+        }
+        catch (const std::exception &e) {
+            // If the socket itself has failed, this throws as well and
+            // closes the session.
+            send_error(fd_.get(), e.what());
+
+            return;
+        }
+
+        // If the loop has been interrupted, the pending message is the
+        // stop request of the reader; it is consumed by run().
+        send_message(fd_.get(), Message_type::split_done);
+    }
+
+    File_descriptor fd_;
+    const Data_reader_factory *factory_;
+    std::size_t num_splits_{};
+    std::atomic_bool closed_{};
+    std::thread thread_;
+};
+
+// Represents the connection of a reader to a worker.
+class Data_service_connection {
+public:
+    explicit Data_service_connection(std::string address)
+        : address_{std::move(address)}, fd_{connect_tcp(address_)}
+    {}
+
+    void send(Message_type type, std::uint64_t value)
+    {
+        guard([this, type, value] {
+            send_message(fd_.get(), type, stdx::span<const std::uint64_t>{&value, 1});
+        });
+    }
+
+    bool read_header(Message_header &hdr)
+    {
+        return guard([this, &hdr] {
+            return recv_header(fd_.get(), hdr);
+        });
+    }
+
+    void read(void *data, std::size_t size)
+    {
+        guard([this, data, size] {
+            if (!recv_all(fd_.get(), data, size)) {
+                throw Data_reader_error{
+                    fmt::format("The data service worker '{0}' has closed the connection.", address_)};
+            }
+        });
+    }
+
+    void skip(std::size_t size)
+    {
+        std::array<std::byte, 0x10000> buf{};
+
+        while (size > 0) {
+            std::size_t chunk_size = std::min(size, buf.size());
+
+            read(buf.data(), chunk_size);
+
+            size -= chunk_size;
+        }
+    }
+
+    std::string read_error(const Message_header &hdr)
+    {
+        std::string msg(hdr.size, '\0');
+
+        read(msg.data(), msg.size());
+
+        return msg;
+    }
+
+    // Closes the connection; used when the message stream is no longer
+    // in sync.
+    void close() noexcept
+    {
+        fd_ = File_descriptor{};
+
+        busy = false;
+    }
+
+    const std::string &address() const noexcept
+    {
+        return address_;
+    }
+
+    int fd() const noexcept
+    {
+        return fd_.get();
+    }
+
+    bool is_open() const noexcept
+    {
+        return fd_.is_open();
+    }
+
+    bool busy{};
+
+private:
+    template<typename Func>
+    auto guard(Func &&f) -> decltype(f())
+    {
+        if (!fd_.is_open()) {
+            throw Data_reader_error{
+                fmt::format("The connection to the data service worker '{0}' has been lost.", address_)};
+        }
+
+        try {
+            return f();
+        }
+        catch (...) {
+            close();
+
+            throw;
+        }
+    }
+
+    std::string address_;
+    File_descriptor fd_;
+};
+
+}  // namespace detail
+
+Data_service_worker::Data_service_worker(Data_reader_factory factory, Data_service_worker_params params)
+    : factory_{std::move(factory)}, port_{params.port}
+{
+    if (factory_ == nullptr) {
+        throw std::invalid_argument{"The data reader factory must be specified."};
+    }
+
+    listener_ = detail::listen_tcp(params.host, port_);
+
+    thread_ = detail::start_thread(&Data_service_worker::accept_connections, this);
+}
+
+Data_service_worker::~Data_service_worker()
+{
+    stop();
+}
+
+void Data_service_worker::stop() noexcept
+{
+    stopped_ = true;
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // Shut down all sessions before joining them one by one.
+    for (auto &session : sessions_) {
+        session->shutdown();
+    }
+
+    sessions_.clear();
+}
+
+void Data_service_worker::accept_connections() noexcept
+{
+    ::pollfd pfd{listener_.get(), POLLIN, 0};
+
+    auto timeout = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(detail::accept_interval).count());
+
+    while (!stopped_) {
+        int r = ::poll(&pfd, 1, timeout);
+        if (r == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            logger::warn("The data service worker cannot accept new connections: {0}",
+                          detail::current_error_code().message());
+
+            return;
+        }
+
+        if (r == 0) {
+            continue;
+        }
+
+        detail::File_descriptor fd = ::accept(listener_.get(), nullptr, nullptr);
+        if (!fd.is_open()) {
+            // The peer might have closed the connection before it was
+            // accepted.
+            continue;
+        }
+
+        try {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            remove_closed_connections();
+
+            sessions_.emplace_back(std::make_unique<detail::Data_service_session>(std::move(fd), factory_));
+        }
+        catch (const std::exception &e) {
+            logger::warn("The data service worker cannot accept a new connection: {0}", e.what());
+        }
+    }
+}
+
+void Data_service_worker::remove_closed_connections()
+{
+    auto pos = std::remove_if(sessions_.begin(), sessions_.end(), [](const auto &session) {
+        return session->closed();
+    });
+
+    sessions_.erase(pos, sessions_.end());
+}
+
+Data_service_reader::Data_service_reader(Data_service_params params) : params_{std::move(params)}
+{
+    if (params_.workers.empty()) {
+        throw std::invalid_argument{"The list of workers must contain at least one address."};
+    }
+
+    if (params_.num_shards == 0) {
+        throw std::invalid_argument{"The number of shards must be greater than zero."};
+    }
+
+    if (params_.shard_index >= params_.num_shards) {
+        throw std::invalid_argument{"The shard index must be less than the number of shards."};
+    }
+
+    if (params_.num_splits == 0) {
+        params_.num_splits = params_.workers.size() * 4;
+    }
+
+    connections_.reserve(params_.workers.size());
+
+    for (const std::string &address : params_.workers) {
+        auto conn = std::make_unique<detail::Data_service_connection>(address);
+
+        conn->send(detail::Message_type::hello, params_.num_splits);
+
+        detail::Message_header hdr{};
+        if (!conn->read_header(hdr)) {
+            throw Data_reader_error{
+                fmt::format("The data service worker '{0}' has closed the connection.", address)};
+        }
+
+        if (hdr.type == detail::Message_type::error) {
+            throw Data_reader_error{fmt::format(
+                "The data service worker '{0}' has failed: {1}", address, conn->read_error(hdr))};
+        }
+
+        if (hdr.type != detail::Message_type::schema || hdr.size % sizeof(std::uint64_t) != 0) {
+            detail::throw_protocol_error();
+        }
+
+        std::vector<std::uint64_t> words(hdr.size / sizeof(std::uint64_t));
+
+        conn->read(words.data(), hdr.size);
+
+        auto schema = detail::decode_schema(reinterpret_cast<const std::byte *>(words.data()), hdr.size);
+
+        if (schema_ == nullptr) {
+            schema_ = std::move(schema);
+        }
+        else if (*schema != *schema_) {
+            throw Data_reader_error{fmt::format(
+                "The schema of the data service worker '{0}' differs from the schema of the worker '{1}'.",
+                address,
+                params_.workers.front())};
+        }
+
+        connections_.emplace_back(std::move(conn));
+    }
+}
+
+Data_service_reader::~Data_service_reader() = default;
+
+Intrusive_ptr<const Schema> Data_service_reader::read_schema()
+{
+    return schema_;
+}
+
+Intrusive_ptr<Example> Data_service_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+    return read_example_core();
+}
+
+Intrusive_ptr<Example> Data_service_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+Intrusive_ptr<Example> Data_service_reader::read_example_core()
+{
+    if (!epoch_started_) {
+        start_epoch();
+    }
+
+    while (std::any_of(connections_.begin(), connections_.end(), [](const auto &conn) {
+        return conn->busy;
+    })) {
+        detail::Data_service_connection &conn = wait_for_busy_connection();
+
+        detail::Message_header hdr{};
+        if (!conn.read_header(hdr)) {
+            conn.close();
+
+            throw Data_reader_error{fmt::format(
+                "The data service worker '{0}' has closed the connection.", conn.address())};
+        }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+        switch (hdr.type) {
+        case detail::Message_type::example: {
+            std::uint64_t num_words{};
+            if (hdr.size < sizeof(num_words)) {
+                detail::throw_protocol_error();
+            }
+
+            conn.read(&num_words, sizeof(num_words));
+
+            std::size_t remaining = hdr.size - sizeof(num_words);
+            if (num_words > remaining / sizeof(std::uint64_t)) {
+                conn.close();
+
+                detail::Word_reader::throw_corrupt();
+            }
+
+            std::vector<std::uint64_t> words(num_words);
+
+            conn.read(words.data(), num_words * sizeof(std::uint64_t));
+
+            remaining -= num_words * sizeof(std::uint64_t);
+
+            detail::Word_reader reader{reinterpret_cast<const std::byte *>(words.data()),
+                                       num_words * sizeof(std::uint64_t)};
+
+            // The tensor buffers are received directly into the arrays
+            // of the returned example.
+            auto read_buffer = [&conn, &remaining](void *data, std::size_t size) {
+                if (size > remaining) {
+                    detail::Word_reader::throw_corrupt();
+                }
+
+                conn.read(data, size);
+
+                remaining -= size;
+            };
+
+            Intrusive_ptr<Example> example{};
+            try {
+                example = detail::decode_example(schema_, reader, read_buffer);
+            }
+            catch (const Data_reader_error &) {
+                conn.close();
+
+                throw;
+            }
+
+            if (remaining != 0) {
+                conn.close();
+
+                detail::Word_reader::throw_corrupt();
+            }
+
+            num_bytes_read_ += hdr.size;
+
+            return example;
+        }
+
+        case detail::Message_type::split_done:
+            conn.busy = false;
+
+            assign_split(conn);
+            break;
+
+        case detail::Message_type::error: {
+            conn.busy = false;
+
+            throw Data_reader_error{fmt::format(
+                "The data service worker '{0}' has failed: {1}", conn.address(), conn.read_error(hdr))};
+        }
+
+        default:
+            conn.close();
+
+            detail::throw_protocol_error();
+        }
+
+#pragma GCC diagnostic pop
+    }
+
+    return {};
+}
+
+void Data_service_reader::start_epoch()
+{
+    if (std::none_of(connections_.begin(), connections_.end(), [](const auto &conn) {
+            return conn->is_open();
+        })) {
+        throw Data_reader_error{"The connections to all data service workers have been lost."};
+    }
+
+    for (std::size_t i = params_.shard_index; i < params_.num_splits; i += params_.num_shards) {
+        pending_splits_.emplace_back(i);
+    }
+
+    epoch_started_ = true;
+
+    for (auto &conn : connections_) {
+        if (conn->is_open()) {
+            assign_split(*conn);
+        }
+    }
+}
+
+void Data_service_reader::assign_split(detail::Data_service_connection &conn)
+{
+    if (pending_splits_.empty()) {
+        return;
+    }
+
+    conn.send(detail::Message_type::start_split, pending_splits_.front());
+
+    pending_splits_.pop_front();
+
+    conn.busy = true;
+}
+
+detail::Data_service_connection &Data_service_reader::wait_for_busy_connection()
+{
+    std::vector<::pollfd> pfds{};
+    std::vector<detail::Data_service_connection *> busy_conns{};
+
+    // Start with the connection after the one that was read last so
+    // that a fast worker cannot starve the others.
+    for (std::size_t i = 0; i < connections_.size(); i++) {
+        auto &conn = connections_[(next_connection_ + i) % connections_.size()];
+        if (conn->busy) {
+            pfds.push_back(::pollfd{conn->fd(), POLLIN, 0});
+
+            busy_conns.emplace_back(conn.get());
+        }
+    }
+
+    while (true) {
+        int r = ::poll(pfds.data(), pfds.size(), -1);
+        if (r == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{detail::current_error_code(), "The data service workers cannot be polled."};
+        }
+
+        for (std::size_t i = 0; i < pfds.size(); i++) {
+            if (pfds[i].revents != 0) {
+                auto pos = std::find_if(connections_.begin(), connections_.end(), [&](const auto &conn) {
+                    return conn.get() == busy_conns[i];
+                });
+
+                next_connection_ = as_size(pos - connections_.begin()) + 1;
+
+                return *busy_conns[i];
+            }
+        }
+    }
+}
+
+void Data_service_reader::reset() noexcept
+{
+    peeked_example_ = nullptr;
+
+    num_bytes_read_ = 0;
+
+    // Ask the busy workers to stop and discard the messages that they
+    // have sent in the meantime.
+    for (auto &conn : connections_) {
+        if (!conn->busy) {
+            continue;
+        }
+
+        try {
+            conn->send(detail::Message_type::stop_split, 0);
+
+            while (true) {
+                detail::Message_header hdr{};
+                if (!conn->read_header(hdr)) {
+                    conn->close();
+
+                    break;
+                }
+
+                conn->skip(hdr.size);
+
+                if (hdr.type == detail::Message_type::split_done ||
+                    hdr.type == detail::Message_type::error) {
+                    break;
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            logger::warn("The data service worker '{0}' cannot be stopped: {1}",
+                         conn->address(),
+                         e.what());
+        }
+
+        conn->busy = false;
+    }
+
+    pending_splits_.clear();
+
+    epoch_started_ = false;
+}
+
+std::size_t Data_service_reader::num_bytes_read() const noexcept
+{
+    return num_bytes_read_;
+}
+
+std::size_t Data_service_reader::shuffle_buffer_size() const noexcept
+{
+    return 0;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
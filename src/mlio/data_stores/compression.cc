@@ -15,15 +15,66 @@
 
 #include "mlio/data_stores/compression.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <utility>
 
-#include "mlio/not_supported_error.h"
+#include "mlio/config.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/streams/bzip2_inflate_stream.h"
+#include "mlio/streams/detail/gzip_decoder.h"
 #include "mlio/streams/gzip_inflate_stream.h"
 #include "mlio/streams/input_stream.h"
+#include "mlio/streams/lz4_inflate_stream.h"
+#include "mlio/streams/parallel_bzip2_inflate_stream.h"
+#include "mlio/streams/parallel_gzip_inflate_stream.h"
+#include "mlio/streams/zip_inflate_stream.h"
+#include "mlio/streams/zstd_inflate_stream.h"
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// Checks whether the specified gzip stream has sync points at which it
+// can be split for parallel inflation.
+bool is_splittable_gzip_stream(Input_stream &stream)
+{
+    if (!stream.supports_zero_copy()) {
+        return false;
+    }
+
+    Parallel_inflate_params params{};
+
+    std::size_t size = stream.size();
+    if (size < params.chunk_size * 2) {
+        return false;
+    }
+
+    Memory_slice data = stream.read(size);
+
+    stream.seek(0);
+
+    std::size_t last = std::min(size, params.chunk_size * 4);
+
+    return find_gzip_sync_point(data, params.chunk_size, last) != last;
+}
+
+// Every bzip2 stream can be split at its block boundaries; we only have
+// to make sure that it is large enough to be worth it.
+bool is_splittable_bzip2_stream(Input_stream &stream)
+{
+    if (!supports_bzip2() || !stream.supports_zero_copy()) {
+        return false;
+    }
+
+    Parallel_inflate_params params{};
+
+    return stream.size() >= params.chunk_size * 2;
+}
+
+}  // namespace
+}  // namespace detail
 
 Intrusive_ptr<Input_stream>
 make_inflate_stream(Intrusive_ptr<Input_stream> &&stream, Compression compression)
@@ -34,11 +85,25 @@ make_inflate_stream(Intrusive_ptr<Input_stream> &&stream, Compression compressio
         return std::move(stream);
 
     case Compression::gzip:
+        if (detail::is_splittable_gzip_stream(*stream)) {
+            return make_intrusive<Parallel_gzip_inflate_stream>(std::move(stream));
+        }
         return make_intrusive<Gzip_inflate_stream>(std::move(stream));
 
+    case Compression::zstd:
+        return make_intrusive<Zstd_inflate_stream>(std::move(stream));
+
+    case Compression::lz4:
+        return make_intrusive<Lz4_inflate_stream>(std::move(stream));
+
     case Compression::bzip2:
+        if (detail::is_splittable_bzip2_stream(*stream)) {
+            return make_intrusive<Parallel_bzip2_inflate_stream>(std::move(stream));
+        }
+        return make_intrusive<Bzip2_inflate_stream>(std::move(stream));
+
     case Compression::zip:
-        throw Not_supported_error{"bzip2 and zip compressions are not supported yet."};
+        return make_intrusive<Zip_inflate_stream>(std::move(stream));
     }
 
     throw std::invalid_argument{"The specified compression is not supported."};
@@ -20,5 +20,15 @@ inline namespace abi_v1 {
 
 Data_store::~Data_store() = default;
 
+std::optional<std::size_t> Data_store::size_hint() const
+{
+    return {};
+}
+
+std::optional<std::size_t> Data_store::num_instances_hint() const
+{
+    return {};
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
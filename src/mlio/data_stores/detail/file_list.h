@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mlio/data_stores/file.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Returns a boolean value indicating whether the specified path
+/// matches the glob pattern. An empty pattern matches all paths.
+bool match_file_pattern(const std::string &pattern, const std::string &path);
+
+/// Returns a boolean value indicating whether the specified path is
+/// accepted by the predicate of @p opts, if any.
+bool match_file_predicate(const File_list_options &opts, const std::string &path);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
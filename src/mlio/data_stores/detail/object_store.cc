@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/detail/object_store.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fnmatch.h>
+
+#include <strnatcmp.h>
+
+#include "mlio/detail/object_uri.h"
+#include "mlio/s3_object_cache.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/object_input_stream.h"
+#include "mlio/streams/prefetching_input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Intrusive_ptr<Input_stream>
+open_object_read(const Intrusive_ptr<const Object_store_client> &client,
+                 const std::string &uri,
+                 const std::string &version_id,
+                 Compression compression,
+                 const std::optional<Range_read_params> &range_read_params,
+                 std::optional<std::size_t> size_hint)
+{
+    Intrusive_ptr<Input_stream> stream{};
+
+    const Intrusive_ptr<S3_object_cache> &cache = client->object_cache();
+    if (cache != nullptr) {
+        stream = cache->open_read(
+            client, uri, version_id, range_read_params.value_or(client->range_read_params()));
+    }
+    else {
+        // The size reported by the listing saves us a HEAD request.
+        stream = make_object_input_stream(client, uri, version_id, range_read_params, size_hint);
+    }
+
+    if (compression != Compression::none) {
+        stream = make_inflate_stream(std::move(stream), compression);
+    }
+
+    return make_prefetching_stream(std::move(stream), default_prefetch_params());
+}
+
+std::vector<std::pair<std::string, std::size_t>>
+list_object_uris(const Object_store_client &client,
+                 stdx::span<const std::string> uris,
+                 const Object_list_options &opts)
+{
+    std::vector<std::pair<std::string, std::size_t>> objects{};
+
+    std::string pattern{opts.pattern};
+
+    for (const std::string &uri : uris) {
+        auto [bucket, prefix] = split_object_uri_to_bucket_and_prefix(uri, client.uri_scheme());
+
+        client.list_objects(bucket, prefix, [&](std::string object_uri, std::size_t size) {
+            // Pattern match.
+            if (!pattern.empty()) {
+                int r = ::fnmatch(pattern.c_str(), object_uri.c_str(), 0);
+                if (r == FNM_NOMATCH) {
+                    return;
+                }
+                if (r != 0) {
+                    throw std::invalid_argument{"The pattern cannot be used for comparison."};
+                }
+            }
+
+            // Predicate match.
+            const auto *predicate = opts.predicate;
+            if (predicate != nullptr && *predicate != nullptr) {
+                if (!(*predicate)(object_uri)) {
+                    return;
+                }
+            }
+
+            objects.emplace_back(std::move(object_uri), size);
+        });
+    }
+
+    std::sort(objects.begin(), objects.end(), [](const auto &a, const auto &b) {
+        return ::strnatcmp(a.first.c_str(), b.first.c_str()) < 0;
+    });
+
+    return objects;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mlio/data_stores/compression.h"
+#include "mlio/data_stores/object_list_options.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/object_store_client.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Opens the specified object through the cache of the client, if any,
+// and wraps it in an inflate and a prefetching stream.
+Intrusive_ptr<Input_stream>
+open_object_read(const Intrusive_ptr<const Object_store_client> &client,
+                 const std::string &uri,
+                 const std::string &version_id,
+                 Compression compression,
+                 const std::optional<Range_read_params> &range_read_params,
+                 std::optional<std::size_t> size_hint);
+
+// Lists the objects residing under the specified URIs in natural order
+// and returns their URIs along with their sizes.
+std::vector<std::pair<std::string, std::size_t>>
+list_object_uris(const Object_store_client &client,
+                 stdx::span<const std::string> uris,
+                 const Object_list_options &opts);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -40,6 +40,14 @@ Compression infer_compression(std::string_view path) noexcept
         if (path[len - 3] == 'z' && path[len - 2] == 'i' && path[len - 1] == 'p') {
             return Compression::zip;
         }
+
+        if (path[len - 3] == 'z' && path[len - 2] == 's' && path[len - 1] == 't') {
+            return Compression::zstd;
+        }
+
+        if (path[len - 3] == 'l' && path[len - 2] == 'z' && path[len - 1] == '4') {
+            return Compression::lz4;
+        }
     }
 
     return Compression::none;
@@ -26,12 +26,21 @@
 #include "mlio/streams/file_input_stream.h"
 #include "mlio/streams/input_stream.h"
 #include "mlio/streams/memory_input_stream.h"
+#include "mlio/streams/prefetching_input_stream.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 
-File::File(std::string path, bool memory_map, Compression compression)
-    : path_{std::move(path)}, memory_map_{memory_map}, compression_{compression}
+File::File(std::string path,
+           bool memory_map,
+           Compression compression,
+           std::optional<std::size_t> size_hint,
+           std::optional<std::size_t> num_instances_hint)
+    : path_{std::move(path)}
+    , memory_map_{memory_map}
+    , compression_{compression}
+    , size_hint_{size_hint}
+    , num_instances_hint_{num_instances_hint}
 {
     detail::validate_file_path(path_);
 
@@ -53,10 +62,11 @@ Intrusive_ptr<Input_stream> File::open_read() const
         stream = make_intrusive<File_input_stream>(path_);
     }
 
-    if (compression_ == Compression::none) {
-        return stream;
+    if (compression_ != Compression::none) {
+        stream = make_inflate_stream(std::move(stream), compression_);
     }
-    return make_inflate_stream(std::move(stream), compression_);
+
+    return make_prefetching_stream(std::move(stream), default_prefetch_params());
 }
 
 std::string File::repr() const
@@ -17,19 +17,22 @@
 
 #include <algorithm>
 #include <cerrno>
-#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <system_error>
+#include <utility>
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <fnmatch.h>
-#include <fts.h>
 #include <sys/stat.h>
 
 #include <fmt/format.h>
 #include <strnatcmp.h>
+#include <tbb/task_group.h>
 
 #include "mlio/data_stores/data_store.h"
+#include "mlio/data_stores/detail/file_list.h"
 #include "mlio/detail/error.h"
 #include "mlio/intrusive_ptr.h"
 
@@ -40,106 +43,303 @@ inline namespace abi_v1 {
 namespace detail {
 namespace {
 
-struct Fts_deleter {
-    void operator()(::FTS *fts)
+struct Dir_deleter {
+    void operator()(::DIR *dir)
     {
-        if (fts != nullptr) {
-            ::fts_close(fts);
+        if (dir != nullptr) {
+            ::closedir(dir);
         }
     }
 };
 
-std::vector<const char *> get_path_c_strs(stdx::span<const std::string> paths)
-{
-    std::vector<const char *> c_strs{};
-
-    std::transform(
-        paths.begin(), paths.end(), std::back_inserter(c_strs), [](const std::string &path) {
-            return path.c_str();
-        });
+struct Dir_node;
 
-    c_strs.push_back(nullptr);
+struct Dir_entry {
+    std::string name{};
+    std::string path{};
+    std::size_t size{};
+    // Set if the entry is a directory.
+    std::unique_ptr<Dir_node> dir{};
+};
 
-    return c_strs;
-}
+struct Dir_node {
+    std::string path{};
+    // The directories from the root down to this one; used to detect
+    // symbolic links that point to an ancestor.
+    std::vector<std::pair<::dev_t, ::ino_t>> ancestors{};
+    std::vector<Dir_entry> entries{};
+};
 
-inline int natural_sort(const ::FTSENT **a, const ::FTSENT **b)
+[[noreturn]] void throw_cannot_open(const std::string &path)
 {
-    return ::strnatcmp((*a)->fts_name, (*b)->fts_name);
+    std::error_code err = current_error_code();
+    throw std::system_error{err, fmt::format("The file or directory '{0}' cannot be opened.", path)};
 }
 
-auto make_fts(stdx::span<const std::string> paths)
+bool is_symlink(int dir_fd, const char *name) noexcept
 {
-    std::vector<const char *> c_strs = get_path_c_strs(paths);
+    int err = errno;
 
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-    auto path_argv = const_cast<char *const *>(c_strs.data());
+    struct ::stat buf {};
+    bool r = ::fstatat(dir_fd, name, &buf, AT_SYMLINK_NOFOLLOW) == 0 && S_ISLNK(buf.st_mode);
 
-    ::FTS *fts = ::fts_open(path_argv, FTS_LOGICAL | FTS_NOCHDIR, natural_sort);
-    if (fts == nullptr) {
-        throw std::system_error{current_error_code(), "The specified paths cannot be traversed."};
-    }
+    errno = err;
 
-    return std::unique_ptr<::FTS, detail::Fts_deleter>(fts);
+    return r;
 }
 
-}  // namespace
-}  // namespace detail
-
-std::vector<Intrusive_ptr<Data_store>>
-list_files(stdx::span<const std::string> paths, const File_list_options &opts)
+inline bool is_listable_file(const struct ::stat &buf) noexcept
 {
-    auto fts = detail::make_fts(paths);
+    // We ignore anything but regular and block files.
+    return S_ISREG(buf.st_mode) || S_ISBLK(buf.st_mode);
+}
 
-    std::string pattern{opts.pattern};
+// Walks a directory tree with one task per directory. Like fts(3) with
+// FTS_LOGICAL, symbolic links are followed, and the entries of each
+// directory are sorted in natural order; the final list is assembled
+// from the per-directory results in a single depth-first pass, so it is
+// identical to that of a serial traversal.
+class File_walker {
+public:
+    explicit File_walker(std::string_view pattern) : pattern_{pattern}
+    {}
+
+    void add_root(std::string path)
+    {
+        struct ::stat buf {};
+        if (::stat(path.c_str(), &buf) != 0) {
+            throw_cannot_open(path);
+        }
 
-    std::vector<Intrusive_ptr<Data_store>> result{};
+        Dir_entry &entry = roots_.emplace_back();
+
+        entry.name = path;
+        entry.path = std::move(path);
+        entry.size = static_cast<std::size_t>(buf.st_size);
 
-    ::FTSENT *e{};
-    while ((e = ::fts_read(fts.get())) != nullptr) {
-        if (e->fts_info == FTS_ERR || e->fts_info == FTS_DNR || e->fts_info == FTS_NS) {
-            std::error_code err = current_error_code();
-            throw std::system_error{
-                err, fmt::format("The file or directory '{0}' cannot be opened.", e->fts_accpath)};
+        if (S_ISDIR(buf.st_mode)) {
+            entry.dir = std::make_unique<Dir_node>();
+
+            entry.dir->path = entry.path;
+            entry.dir->ancestors.emplace_back(buf.st_dev, buf.st_ino);
+        }
+        else if (!is_listable_file(buf) || !matches(entry.path)) {
+            roots_.pop_back();
         }
+    }
 
-        if (e->fts_info != FTS_F) {
-            continue;
+    void walk()
+    {
+        sort_entries(roots_);
+
+        for (Dir_entry &root : roots_) {
+            if (root.dir != nullptr) {
+                Dir_node *node = root.dir.get();
+
+                tasks_.run([this, node]() {
+                    walk(*node);
+                });
+            }
         }
 
-        // We ignore anything but regular and block files.
-        if (!S_ISREG(e->fts_statp->st_mode) && !S_ISBLK(e->fts_statp->st_mode)) {
-            continue;
+        // Rethrows the first exception raised by a task.
+        tasks_.wait();
+    }
+
+    template<typename Func>
+    void visit(Func &func) const
+    {
+        visit(roots_, func);
+    }
+
+private:
+    void walk(Dir_node &node)
+    {
+        std::unique_ptr<::DIR, Dir_deleter> dir{::opendir(node.path.c_str())};
+        if (dir == nullptr) {
+            throw_cannot_open(node.path);
         }
 
-        // Pattern match.
-        if (!pattern.empty()) {
-            int r = ::fnmatch(pattern.c_str(), e->fts_accpath, 0);
-            if (r == FNM_NOMATCH) {
+        int dir_fd = ::dirfd(dir.get());
+
+        while (true) {
+            errno = 0;
+
+            ::dirent *e = ::readdir(dir.get());
+            if (e == nullptr) {
+                if (errno != 0) {
+                    throw_cannot_open(node.path);
+                }
+                break;
+            }
+
+            std::string_view name = e->d_name;
+            if (name == "." || name == "..") {
                 continue;
             }
-            if (r != 0) {
-                throw std::invalid_argument{"The pattern cannot be used for comparison."};
+
+            // The lookup relative to the directory descriptor saves the
+            // kernel from resolving the full path of every entry.
+            struct ::stat buf {};
+            if (::fstatat(dir_fd, e->d_name, &buf, 0) != 0) {
+                // Like fts(3), we skip dangling symbolic links.
+                if (errno == ENOENT && is_symlink(dir_fd, e->d_name)) {
+                    continue;
+                }
+                throw_cannot_open(join(node.path, name));
             }
-        }
 
-        // Predicate match.
-        const auto *predicate = opts.predicate;
-        if (predicate != nullptr && *predicate != nullptr) {
-            if (!(*predicate)(e->fts_accpath)) {
+            if (S_ISDIR(buf.st_mode)) {
+                std::pair<::dev_t, ::ino_t> id{buf.st_dev, buf.st_ino};
+
+                // Skip a symbolic link that forms a cycle.
+                if (std::find(node.ancestors.begin(), node.ancestors.end(), id) !=
+                    node.ancestors.end()) {
+                    continue;
+                }
+
+                Dir_entry &entry = node.entries.emplace_back();
+
+                entry.name = name;
+                entry.path = join(node.path, name);
+                entry.dir = std::make_unique<Dir_node>();
+
+                entry.dir->path = entry.path;
+                entry.dir->ancestors = node.ancestors;
+                entry.dir->ancestors.emplace_back(id);
+
+                continue;
+            }
+
+            if (!is_listable_file(buf)) {
+                continue;
+            }
+
+            std::string path = join(node.path, name);
+            if (!matches(path)) {
                 continue;
             }
+
+            Dir_entry &entry = node.entries.emplace_back();
+
+            entry.name = name;
+            entry.path = std::move(path);
+            entry.size = static_cast<std::size_t>(buf.st_size);
         }
 
-        auto file = make_intrusive<File>(e->fts_accpath, opts.memory_map, opts.compression);
+        dir = {};
 
-        result.emplace_back(std::move(file));
+        sort_entries(node.entries);
+
+        for (Dir_entry &entry : node.entries) {
+            if (entry.dir != nullptr) {
+                Dir_node *child = entry.dir.get();
+
+                tasks_.run([this, child]() {
+                    walk(*child);
+                });
+            }
+        }
+    }
+
+    bool matches(const std::string &path) const
+    {
+        return match_file_pattern(pattern_, path);
+    }
+
+    template<typename Func>
+    static void visit(const std::vector<Dir_entry> &entries, Func &func)
+    {
+        for (const Dir_entry &entry : entries) {
+            if (entry.dir != nullptr) {
+                visit(entry.dir->entries, func);
+            }
+            else {
+                func(entry.path, entry.size);
+            }
+        }
+    }
+
+    static void sort_entries(std::vector<Dir_entry> &entries)
+    {
+        std::sort(entries.begin(), entries.end(), [](const Dir_entry &a, const Dir_entry &b) {
+            return ::strnatcmp(a.name.c_str(), b.name.c_str()) < 0;
+        });
     }
 
-    if (errno != 0) {
-        throw std::system_error{current_error_code(), "The specified paths cannot be traversed."};
+    static std::string join(const std::string &path, std::string_view name)
+    {
+        std::string s = path;
+        if (s.empty() || s.back() != '/') {
+            s += '/';
+        }
+        s += name;
+
+        return s;
+    }
+
+    std::string pattern_;
+    std::vector<Dir_entry> roots_{};
+    tbb::task_group tasks_{};
+};
+
+}  // namespace
+
+bool match_file_pattern(const std::string &pattern, const std::string &path)
+{
+    if (pattern.empty()) {
+        return true;
     }
 
+    int r = ::fnmatch(pattern.c_str(), path.c_str(), 0);
+    if (r == FNM_NOMATCH) {
+        return false;
+    }
+    if (r != 0) {
+        throw std::invalid_argument{"The pattern cannot be used for comparison."};
+    }
+    return true;
+}
+
+bool match_file_predicate(const File_list_options &opts, const std::string &path)
+{
+    const auto *predicate = opts.predicate;
+    if (predicate != nullptr && *predicate != nullptr) {
+        return (*predicate)(path);
+    }
+    return true;
+}
+
+}  // namespace detail
+
+std::vector<Intrusive_ptr<Data_store>>
+list_files(stdx::span<const std::string> paths, const File_list_options &opts)
+{
+    detail::File_walker walker{opts.pattern};
+
+    for (const std::string &path : paths) {
+        walker.add_root(path);
+    }
+
+    walker.walk();
+
+    std::vector<Intrusive_ptr<Data_store>> result{};
+
+    // The predicate might not be safe to call concurrently, for instance
+    // if it is a Python callable; we therefore call it only after the
+    // walk has completed.
+    auto add_file = [&opts, &result](const std::string &path, std::size_t size) {
+        if (!detail::match_file_predicate(opts, path)) {
+            return;
+        }
+
+        auto file = make_intrusive<File>(path, opts.memory_map, opts.compression, size);
+
+        result.emplace_back(std::move(file));
+    };
+
+    walker.visit(add_file);
+
     return result;
 }
 
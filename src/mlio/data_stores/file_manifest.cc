@@ -0,0 +1,221 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/file.h"  // IWYU pragma: associated
+
+#include <charconv>
+#include <cstddef>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include <fmt/format.h>
+
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_stores/detail/file_list.h"
+#include "mlio/detail/error.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::current_error_code;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::string_view manifest_header = "mlio-file-manifest 1";
+
+// The second version adds the number of instances of each file.
+constexpr std::string_view manifest_header_v2 = "mlio-file-manifest 2";
+
+std::size_t get_file_size(const File &file)
+{
+    if (std::optional<std::size_t> size = file.size_hint()) {
+        return *size;
+    }
+
+    struct ::stat buf {};
+    if (::stat(file.id().c_str(), &buf) != 0) {
+        std::error_code err = current_error_code();
+        throw std::system_error{
+            err, fmt::format("The file or directory '{0}' cannot be opened.", file.id())};
+    }
+
+    return static_cast<std::size_t>(buf.st_size);
+}
+
+bool parse_size(std::string_view text, std::size_t &value) noexcept
+{
+    const char *first = text.data();
+    const char *last = text.data() + text.size();
+
+    auto [ptr, ec] = std::from_chars(first, last, value);
+
+    return ec == std::errc() && ptr == last;
+}
+
+}  // namespace
+}  // namespace detail
+
+void write_file_manifest(const std::string &path, stdx::span<const Intrusive_ptr<Data_store>> stores)
+{
+    bool has_instance_counts = false;
+
+    for (const Intrusive_ptr<Data_store> &store : stores) {
+        if (dynamic_cast<const File *>(store.get()) == nullptr) {
+            throw std::invalid_argument{"A file manifest can only list File instances."};
+        }
+
+        if (store->num_instances_hint()) {
+            has_instance_counts = true;
+        }
+    }
+
+    // Stick to the first version if possible so that older readers can
+    // still read the manifest.
+    std::string text{has_instance_counts ? detail::manifest_header_v2 : detail::manifest_header};
+    text += '\n';
+
+    for (const Intrusive_ptr<Data_store> &store : stores) {
+        const auto *file = static_cast<const File *>(store.get());
+
+        if (file->id().find('\n') != std::string::npos) {
+            throw std::invalid_argument{fmt::format(
+                "The path '{0}' contains a line break and cannot be written to a file manifest.",
+                file->id())};
+        }
+
+        if (has_instance_counts) {
+            std::optional<std::size_t> num_instances = file->num_instances_hint();
+
+            text += fmt::format("{0}\t{1}\t{2}\n",
+                                detail::get_file_size(*file),
+                                num_instances ? std::to_string(*num_instances) : std::string{},
+                                file->id());
+        }
+        else {
+            text += fmt::format("{0}\t{1}\n", detail::get_file_size(*file), file->id());
+        }
+    }
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (out) {
+        out.write(text.data(), as_ssize(text.size()));
+    }
+
+    if (!out) {
+        throw std::system_error{current_error_code(), "The manifest file cannot be written."};
+    }
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+read_file_manifest(const std::string &path, const File_list_options &opts)
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The manifest file '{0}' cannot be opened.", path)};
+    }
+
+    auto make_error = [&path]() {
+        return std::invalid_argument{
+            fmt::format("The file '{0}' is not a valid file manifest.", path)};
+    };
+
+    std::string line{};
+    if (!std::getline(in, line)) {
+        throw make_error();
+    }
+
+    bool has_instance_counts{};
+    if (line == detail::manifest_header) {
+        has_instance_counts = false;
+    }
+    else if (line == detail::manifest_header_v2) {
+        has_instance_counts = true;
+    }
+    else {
+        throw make_error();
+    }
+
+    std::string pattern{opts.pattern};
+
+    std::vector<Intrusive_ptr<Data_store>> result{};
+
+    while (std::getline(in, line)) {
+        std::size_t tab_pos = line.find('\t');
+        if (tab_pos == std::string::npos) {
+            throw make_error();
+        }
+
+        std::size_t size{};
+        if (!detail::parse_size(std::string_view{line}.substr(0, tab_pos), size)) {
+            throw make_error();
+        }
+
+        std::optional<std::size_t> num_instances{};
+
+        if (has_instance_counts) {
+            std::size_t count_pos = tab_pos + 1;
+
+            tab_pos = line.find('\t', count_pos);
+            if (tab_pos == std::string::npos) {
+                throw make_error();
+            }
+
+            // An empty count means that the number of instances is not
+            // known.
+            if (tab_pos != count_pos) {
+                std::size_t count{};
+                if (!detail::parse_size(
+                        std::string_view{line}.substr(count_pos, tab_pos - count_pos), count)) {
+                    throw make_error();
+                }
+                num_instances = count;
+            }
+        }
+
+        std::string file_path = line.substr(tab_pos + 1);
+
+        if (!detail::match_file_pattern(pattern, file_path) ||
+            !detail::match_file_predicate(opts, file_path)) {
+            continue;
+        }
+
+        auto file = make_intrusive<File>(
+            std::move(file_path), opts.memory_map, opts.compression, size, num_instances);
+
+        result.emplace_back(std::move(file));
+    }
+
+    if (in.bad()) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The manifest file '{0}' cannot be read.", path)};
+    }
+
+    return result;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
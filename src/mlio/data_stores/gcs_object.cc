@@ -0,0 +1,110 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/gcs_object.h"
+
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_stores/detail/object_store.h"
+#include "mlio/data_stores/detail/util.h"
+#include "mlio/detail/object_uri.h"
+#include "mlio/logger.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Gcs_object::Gcs_object(Intrusive_ptr<const Gcs_client> client,
+                       std::string uri,
+                       std::string version_id,
+                       Compression compression,
+                       std::optional<Range_read_params> range_read_params,
+                       std::optional<std::size_t> size_hint)
+    : client_{std::move(client)}
+    , uri_{std::move(uri)}
+    , version_id_{std::move(version_id)}
+    , compression_{compression}
+    , range_read_params_{range_read_params}
+    , size_hint_{size_hint}
+{
+    detail::validate_object_uri(uri_, "gs");
+
+    if (compression_ == Compression::infer) {
+        compression_ = detail::infer_compression(uri_);
+    }
+}
+
+Intrusive_ptr<Input_stream> Gcs_object::open_read() const
+{
+    if (logger::is_enabled_for(Log_level::info)) {
+        logger::info("The GCS object '{0}' is being opened.", id());
+    }
+
+    return detail::open_object_read(
+        client_, uri_, version_id_, compression_, range_read_params_, size_hint_);
+}
+
+const std::string &Gcs_object::id() const
+{
+    if (id_.empty()) {
+        if (version_id_.empty()) {
+            return uri_;
+        }
+
+        id_ = uri_ + "@" + version_id_;
+    }
+
+    return id_;
+}
+
+std::string Gcs_object::repr() const
+{
+    return fmt::format("<Gcs_object uri='{0}' generation='{1}' compression='{2}'>",
+                       uri_,
+                       version_id_,
+                       compression_);
+}
+
+std::vector<Intrusive_ptr<Data_store>> list_gcs_objects(const Gcs_client &client,
+                                                        stdx::span<const std::string> uris,
+                                                        const Object_list_options &opts)
+{
+    auto objects = detail::list_object_uris(client, uris, opts);
+
+    auto clt = wrap_intrusive(&client);
+
+    std::vector<Intrusive_ptr<Data_store>> stores{};
+    stores.reserve(objects.size());
+
+    for (const auto &[uri, size] : objects) {
+        stores.emplace_back(make_intrusive<Gcs_object>(
+            clt, uri, std::string{}, opts.compression, std::nullopt, size));
+    }
+
+    return stores;
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+list_gcs_objects(const Gcs_client &client, const std::string &uri, std::string_view pattern)
+{
+    stdx::span<const std::string> uris{&uri, 1};
+
+    return list_gcs_objects(client, uris, {pattern});
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
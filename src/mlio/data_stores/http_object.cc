@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/http_object.h"
+
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_stores/detail/object_store.h"
+#include "mlio/data_stores/detail/util.h"
+#include "mlio/detail/object_uri.h"
+#include "mlio/logger.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Http_object::Http_object(Intrusive_ptr<const Http_client> client,
+                         std::string uri,
+                         std::string etag,
+                         Compression compression,
+                         std::optional<Range_read_params> range_read_params,
+                         std::optional<std::size_t> size_hint)
+    : client_{std::move(client)}
+    , uri_{std::move(uri)}
+    , etag_{std::move(etag)}
+    , compression_{compression}
+    , range_read_params_{range_read_params}
+    , size_hint_{size_hint}
+{
+    detail::validate_object_uri(uri_, client_->uri_scheme());
+
+    if (compression_ == Compression::infer) {
+        // Leave out the query string, e.g. a signature, when looking at
+        // the extension.
+        std::string_view path = uri_;
+        path = path.substr(0, path.find_first_of("?#"));
+
+        compression_ = detail::infer_compression(path);
+    }
+}
+
+Intrusive_ptr<Input_stream> Http_object::open_read() const
+{
+    if (logger::is_enabled_for(Log_level::info)) {
+        logger::info("The HTTP object '{0}' is being opened.", id());
+    }
+
+    return detail::open_object_read(
+        client_, uri_, etag_, compression_, range_read_params_, size_hint_);
+}
+
+const std::string &Http_object::id() const
+{
+    if (id_.empty()) {
+        if (etag_.empty()) {
+            return uri_;
+        }
+
+        id_ = uri_ + "@" + etag_;
+    }
+
+    return id_;
+}
+
+std::string Http_object::repr() const
+{
+    return fmt::format(
+        "<Http_object uri='{0}' etag='{1}' compression='{2}'>", uri_, etag_, compression_);
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/kafka_partition.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/logger.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Kafka_partition::Kafka_partition(Intrusive_ptr<const Kafka_client> client,
+                                 std::string topic,
+                                 std::int32_t partition,
+                                 std::int64_t start_offset,
+                                 std::int64_t end_offset,
+                                 std::string separator)
+    : client_{std::move(client)}
+    , topic_{std::move(topic)}
+    , partition_{partition}
+    , start_offset_{start_offset}
+    , end_offset_{end_offset}
+    , separator_{std::move(separator)}
+{
+    if (client_ == nullptr) {
+        throw std::invalid_argument{"The Kafka client must not be null."};
+    }
+
+    if (topic_.empty()) {
+        throw std::invalid_argument{"The topic must be specified."};
+    }
+
+    if (partition_ < 0) {
+        throw std::invalid_argument{"The partition must be non-negative."};
+    }
+
+    if (start_offset_ < 0 && start_offset_ != kafka_offset_beginning) {
+        throw std::invalid_argument{
+            "The start offset must be non-negative or kafka_offset_beginning."};
+    }
+
+    if (end_offset_ >= 0 && start_offset_ >= 0 && end_offset_ < start_offset_) {
+        throw std::invalid_argument{"The end offset must not be less than the start offset."};
+    }
+
+    // The offsets are part of the identity of the data store; the same
+    // partition read over different ranges holds different data.
+    if (end_offset_ < 0) {
+        id_ = fmt::format("kafka://{0}/{1}@{2}", topic_, partition_, start_offset_);
+    }
+    else {
+        id_ = fmt::format(
+            "kafka://{0}/{1}@{2}-{3}", topic_, partition_, start_offset_, end_offset_);
+    }
+}
+
+Intrusive_ptr<Input_stream> Kafka_partition::open_read() const
+{
+    if (logger::is_enabled_for(Log_level::info)) {
+        logger::info("The Kafka partition '{0}' is being opened.", id_);
+    }
+
+    return client_->open_partition(topic_, partition_, start_offset_, end_offset_, separator_);
+}
+
+std::string Kafka_partition::repr() const
+{
+    return fmt::format("<Kafka_partition topic='{0}' partition='{1}' start_offset='{2}' "
+                       "end_offset='{3}'>",
+                       topic_,
+                       partition_,
+                       start_offset_,
+                       end_offset_);
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+list_kafka_partitions(const Intrusive_ptr<const Kafka_client> &client,
+                      const std::string &topic,
+                      bool bounded,
+                      const std::string &separator)
+{
+    if (client == nullptr) {
+        throw std::invalid_argument{"The Kafka client must not be null."};
+    }
+
+    std::size_t num_partitions = client->num_partitions(topic);
+
+    std::vector<std::int64_t> start_offsets{};
+    if (client->options().group_id.empty()) {
+        start_offsets.resize(num_partitions, kafka_offset_beginning);
+    }
+    else {
+        start_offsets = client->committed_offsets(topic);
+    }
+
+    std::vector<Intrusive_ptr<Data_store>> stores{};
+    stores.reserve(num_partitions);
+
+    for (std::size_t i = 0; i < num_partitions; i++) {
+        auto partition = static_cast<std::int32_t>(i);
+
+        std::int64_t start_offset = start_offsets[i];
+
+        std::int64_t end_offset = -1;
+        if (bounded) {
+            auto [low, high] = client->watermark_offsets(topic, partition);
+
+            // Resolve the start offset so that the range, and with it
+            // the identity of the data store, stays fixed even if older
+            // messages get deleted meanwhile.
+            if (start_offset < low) {
+                start_offset = low;
+            }
+
+            end_offset = std::max(high, start_offset);
+        }
+
+        stores.emplace_back(make_intrusive<Kafka_partition>(
+            client, topic, partition, start_offset, end_offset, separator));
+    }
+
+    return stores;
+}
+
+void commit_kafka_partitions(const std::vector<Intrusive_ptr<Data_store>> &dataset)
+{
+    std::vector<std::pair<const Kafka_partition *, Kafka_offset>> offsets{};
+
+    for (const Intrusive_ptr<Data_store> &store : dataset) {
+        auto *partition = dynamic_cast<const Kafka_partition *>(store.get());
+        if (partition == nullptr || partition->end_offset() < 0) {
+            continue;
+        }
+
+        offsets.emplace_back(partition,
+                             Kafka_offset{partition->partition(), partition->end_offset()});
+    }
+
+    // Commit the offsets of each topic and client in one request.
+    while (!offsets.empty()) {
+        const Kafka_partition *first = offsets.front().first;
+
+        std::vector<Kafka_offset> batch{};
+
+        auto pos = std::stable_partition(offsets.begin(), offsets.end(), [first](const auto &p) {
+            return p.first->client().get() != first->client().get() ||
+                   p.first->topic() != first->topic();
+        });
+
+        std::transform(pos, offsets.end(), std::back_inserter(batch), [](const auto &p) {
+            return p.second;
+        });
+
+        first->client()->commit_offsets(first->topic(), batch);
+
+        offsets.erase(pos, offsets.end());
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
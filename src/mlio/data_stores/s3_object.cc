@@ -15,20 +15,15 @@
 
 #include "mlio/data_stores/s3_object.h"
 
-#include <algorithm>
-#include <stdexcept>
 #include <utility>
 
-#include <fnmatch.h>
-
 #include <fmt/format.h>
-#include <strnatcmp.h>
 
+#include "mlio/data_stores/detail/object_store.h"
 #include "mlio/data_stores/detail/util.h"
-#include "mlio/detail/s3_utils.h"
+#include "mlio/detail/object_uri.h"
 #include "mlio/logger.h"
 #include "mlio/streams/input_stream.h"
-#include "mlio/streams/s3_input_stream.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -36,13 +31,17 @@ inline namespace abi_v1 {
 S3_object::S3_object(Intrusive_ptr<const S3_client> client,
                      std::string uri,
                      std::string version_id,
-                     Compression compression)
+                     Compression compression,
+                     std::optional<S3_range_read_params> range_read_params,
+                     std::optional<std::size_t> size_hint)
     : client_{std::move(client)}
     , uri_{std::move(uri)}
     , version_id_{std::move(version_id)}
     , compression_{compression}
+    , range_read_params_{range_read_params}
+    , size_hint_{size_hint}
 {
-    detail::validate_s3_object_uri(uri_);
+    detail::validate_object_uri(uri_, "s3");
 
     if (compression_ == Compression::infer) {
         compression_ = detail::infer_compression(uri_);
@@ -55,12 +54,8 @@ Intrusive_ptr<Input_stream> S3_object::open_read() const
         logger::info("The S3 object '{0}' is being opened.", id());
     }
 
-    Intrusive_ptr<Input_stream> stream = make_s3_input_stream(client_, uri_, version_id_);
-
-    if (compression_ == Compression::none) {
-        return stream;
-    }
-    return make_inflate_stream(std::move(stream), compression_);
+    return detail::open_object_read(
+        client_, uri_, version_id_, compression_, range_read_params_, size_hint_);
 }
 
 const std::string &S3_object::id() const
@@ -82,65 +77,20 @@ std::string S3_object::repr() const
         "<S3_object uri='{0}' version='{1}' compression='{2}'>", uri_, version_id_, compression_);
 }
 
-namespace detail {
-namespace {
-
-void list_s3_objects(const S3_client &client,
-                     const std::string &uri,
-                     const S3_object_list_options &opts,
-                     std::vector<std::string> &object_uris)
-{
-    auto [bucket, prefix] = detail::split_s3_uri_to_bucket_and_prefix(uri);
-
-    client.list_objects(bucket, prefix, [&](std::string object_uri) {
-        // Pattern match.
-        std::string pattern{opts.pattern};
-        if (!pattern.empty()) {
-            int r = ::fnmatch(pattern.c_str(), object_uri.c_str(), 0);
-            if (r == FNM_NOMATCH) {
-                return;
-            }
-            if (r != 0) {
-                throw std::invalid_argument{"The pattern cannot be used for comparison."};
-            }
-        }
-
-        // Predicate match.
-        const auto *predicate = opts.predicate;
-        if (predicate != nullptr && *predicate != nullptr) {
-            if (!(*predicate)(object_uri)) {
-                return;
-            }
-        }
-
-        object_uris.emplace_back(std::move(object_uri));
-    });
-}
-
-}  // namespace
-}  // namespace detail
-
 std::vector<Intrusive_ptr<Data_store>> list_s3_objects(const S3_client &client,
                                                        stdx::span<const std::string> uris,
                                                        const S3_object_list_options &opts)
 {
-    std::vector<std::string> object_uris{};
-
-    for (const std::string &uri : uris) {
-        detail::list_s3_objects(client, uri, opts, object_uris);
-    }
-
-    std::sort(object_uris.begin(), object_uris.end(), [](const auto &a, const auto &b) {
-        return ::strnatcmp(a.c_str(), b.c_str()) < 0;
-    });
+    auto objects = detail::list_object_uris(client, uris, opts);
 
     auto clt = wrap_intrusive(&client);
 
     std::vector<Intrusive_ptr<Data_store>> stores{};
-    stores.reserve(object_uris.size());
+    stores.reserve(objects.size());
 
-    for (const std::string &uri : object_uris) {
-        stores.emplace_back(make_intrusive<S3_object>(clt, uri, std::string{}, opts.compression));
+    for (const auto &[uri, size] : objects) {
+        stores.emplace_back(make_intrusive<S3_object>(
+            clt, uri, std::string{}, opts.compression, std::nullopt, size));
     }
 
     return stores;
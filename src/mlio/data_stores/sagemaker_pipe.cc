@@ -15,6 +15,7 @@
 
 #include "mlio/data_stores/sagemaker_pipe.h"
 
+#include <memory>
 #include <utility>
 
 #include <fmt/format.h>
@@ -23,6 +24,8 @@
 #include "mlio/logger.h"
 #include "mlio/not_supported_error.h"
 #include "mlio/streams/input_stream.h"
+#include "mlio/streams/detail/sagemaker_pipe_counters.h"
+#include "mlio/streams/prefetching_input_stream.h"
 #include "mlio/streams/sagemaker_pipe_input_stream.h"
 
 namespace mlio {
@@ -31,8 +34,16 @@ inline namespace abi_v1 {
 Sagemaker_pipe::Sagemaker_pipe(std::string path,
                                std::chrono::seconds timeout,
                                std::optional<std::size_t> fifo_id,  // NOLINT
-                               Compression compression)
-    : path_{std::move(path)}, timeout_{timeout}, fifo_id_{fifo_id}, compression_{compression}
+                               Compression compression,
+                               std::size_t pipe_buffer_size,
+                               bool open_next_fifo)
+    : path_{std::move(path)}
+    , timeout_{timeout}
+    , fifo_id_{fifo_id}
+    , compression_{compression}
+    , pipe_buffer_size_{pipe_buffer_size}
+    , open_next_fifo_{open_next_fifo}
+    , counters_{std::make_shared<detail::Sagemaker_pipe_counters>()}
 {
     detail::validate_file_path(path_);
 
@@ -46,13 +57,24 @@ Intrusive_ptr<Input_stream> Sagemaker_pipe::open_read() const
 {
     logger::info("The SageMaker pipe '{0}' is being opened.", path_);
 
-    auto stream =
-        make_sagemaker_pipe_input_stream(path_, timeout_, std::exchange(fifo_id_, std::nullopt));
+    Intrusive_ptr<Input_stream> stream =
+        make_sagemaker_pipe_input_stream(path_,
+                                         timeout_,
+                                         std::exchange(fifo_id_, std::nullopt),
+                                         pipe_buffer_size_,
+                                         open_next_fifo_,
+                                         counters_);
 
-    if (compression_ == Compression::none) {
-        return std::move(stream);
+    if (compression_ != Compression::none) {
+        stream = make_inflate_stream(std::move(stream), compression_);
     }
-    return make_inflate_stream(std::move(stream), compression_);
+
+    return make_prefetching_stream(std::move(stream), default_prefetch_params());
+}
+
+Sagemaker_pipe_stats Sagemaker_pipe::stats() const noexcept
+{
+    return counters_->load();
 }
 
 std::string Sagemaker_pipe::repr() const
@@ -0,0 +1,626 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/shared_store.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <fmt/format.h>
+
+#include "mlio/logger.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/input_stream_base.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Holds the chunks of a single read of a data store that have not been
+// received by all of its consumers yet.
+class Shared_read_session {
+public:
+    explicit Shared_read_session(Intrusive_ptr<Data_store> store, const Shared_read_params &params)
+        : store_{std::move(store)}, params_{params}
+    {}
+
+    // Registers a new consumer that starts reading at the beginning of
+    // the data store; returns false if the first chunk is already gone
+    // or all expected consumers have joined.
+    bool try_join(std::size_t &consumer_id);
+
+    // Returns the data that follows the specified offset. An empty
+    // slice means the end of the data store; an empty optional means
+    // the consumer has been detached.
+    std::optional<Memory_slice> read(std::size_t consumer_id, std::size_t offset);
+
+    void leave(std::size_t consumer_id) noexcept;
+
+    const Intrusive_ptr<Data_store> &store() const noexcept
+    {
+        return store_;
+    }
+
+private:
+    bool joinable() const noexcept;
+
+    Memory_slice find_chunk(std::size_t offset) const;
+
+    bool evict();
+
+    void detach_laggards(std::size_t consumer_id);
+
+    void fetch_chunk(std::unique_lock<std::mutex> &lock);
+
+    Intrusive_ptr<Data_store> store_;
+    Shared_read_params params_;
+    Intrusive_ptr<Input_stream> inner_{};
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+    std::deque<Memory_slice> chunks_{};
+    std::size_t base_offset_{};
+    std::size_t end_offset_{};
+    std::size_t num_bytes_buffered_{};
+    // The offset of the first byte each consumer has not received yet.
+    std::unordered_map<std::size_t, std::size_t> cursors_{};
+    std::unordered_set<std::size_t> detached_{};
+    std::size_t num_joined_{};
+    std::size_t next_consumer_id_{};
+    bool fetching_{};
+    bool eof_{};
+    bool closed_{};
+    std::exception_ptr exception_ptr_{};
+};
+
+bool Shared_read_session::try_join(std::size_t &consumer_id)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (!joinable()) {
+        return false;
+    }
+
+    consumer_id = next_consumer_id_++;
+
+    cursors_.emplace(consumer_id, 0);
+
+    num_joined_++;
+
+    return true;
+}
+
+std::optional<Memory_slice> Shared_read_session::read(std::size_t consumer_id, std::size_t offset)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    auto pos = cursors_.find(consumer_id);
+    if (pos == cursors_.end()) {
+        return {};
+    }
+
+    pos->second = offset;
+
+    if (evict()) {
+        condition_.notify_all();
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> deadline{};
+
+    for (;;) {
+        if (detached_.find(consumer_id) != detached_.end()) {
+            return {};
+        }
+
+        if (offset < end_offset_) {
+            return find_chunk(offset);
+        }
+
+        if (exception_ptr_) {
+            std::rethrow_exception(exception_ptr_);
+        }
+
+        if (eof_) {
+            return Memory_slice{};
+        }
+
+        // Another consumer is already reading the next chunk.
+        if (fetching_) {
+            condition_.wait(lock);
+
+            continue;
+        }
+
+        evict();
+
+        // Wait for the lagging consumers if the buffer is full.
+        if (!chunks_.empty() &&
+            num_bytes_buffered_ + params_.chunk_size > params_.max_buffer_size) {
+
+            if (params_.detach_timeout.count() == 0) {
+                condition_.wait(lock);
+
+                continue;
+            }
+
+            if (!deadline) {
+                deadline = std::chrono::steady_clock::now() + params_.detach_timeout;
+            }
+
+            if (condition_.wait_until(lock, *deadline) == std::cv_status::timeout) {
+                detach_laggards(consumer_id);
+
+                deadline = {};
+            }
+
+            continue;
+        }
+
+        deadline = {};
+
+        fetch_chunk(lock);
+    }
+}
+
+void Shared_read_session::leave(std::size_t consumer_id) noexcept
+{
+    Intrusive_ptr<Input_stream> inner{};
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        auto pos = cursors_.find(consumer_id);
+        if (pos != cursors_.end()) {
+            // A consumer that stops before the end (e.g. after inferring
+            // the schema) gives its place to the next one.
+            if (!eof_ || pos->second < end_offset_) {
+                num_joined_--;
+            }
+
+            cursors_.erase(pos);
+        }
+
+        detached_.erase(consumer_id);
+
+        // The consumers that join later start a new session; there is
+        // no reason to hold on to the data once nobody reads it.
+        if (cursors_.empty() && !fetching_) {
+            closed_ = true;
+
+            chunks_.clear();
+
+            num_bytes_buffered_ = 0;
+
+            inner = std::move(inner_);
+        }
+        else {
+            evict();
+        }
+    }
+
+    condition_.notify_all();
+
+    if (inner != nullptr) {
+        inner->close();
+    }
+}
+
+bool Shared_read_session::joinable() const noexcept
+{
+    return !closed_ && base_offset_ == 0 && num_joined_ < params_.num_consumers &&
+           exception_ptr_ == nullptr;
+}
+
+Memory_slice Shared_read_session::find_chunk(std::size_t offset) const
+{
+    std::size_t chunk_offset = base_offset_;
+
+    for (const Memory_slice &chunk : chunks_) {
+        if (offset < chunk_offset + chunk.size()) {
+            return chunk.subslice(offset - chunk_offset);
+        }
+        chunk_offset += chunk.size();
+    }
+
+    throw std::logic_error{"The shared chunk has already been released."};
+}
+
+bool Shared_read_session::evict()
+{
+    bool evicted = false;
+
+    while (!chunks_.empty()) {
+        std::size_t chunk_end = base_offset_ + chunks_.front().size();
+
+        bool needed = std::any_of(cursors_.begin(), cursors_.end(), [chunk_end](const auto &c) {
+            return c.second < chunk_end;
+        });
+        if (needed) {
+            break;
+        }
+
+        // Keep the data for the consumers that have not joined yet as
+        // long as the buffer has room for it.
+        if (joinable() && num_bytes_buffered_ + params_.chunk_size <= params_.max_buffer_size) {
+            break;
+        }
+
+        num_bytes_buffered_ -= chunks_.front().size();
+
+        base_offset_ = chunk_end;
+
+        chunks_.pop_front();
+
+        evicted = true;
+    }
+
+    return evicted;
+}
+
+void Shared_read_session::detach_laggards(std::size_t consumer_id)
+{
+    if (chunks_.empty()) {
+        return;
+    }
+
+    std::size_t chunk_end = base_offset_ + chunks_.front().size();
+
+    for (auto pos = cursors_.begin(); pos != cursors_.end();) {
+        if (pos->first != consumer_id && pos->second < chunk_end) {
+            logger::info("A lagging consumer of the shared data store '{0}' has been detached.",
+                         store_->id());
+
+            detached_.emplace(pos->first);
+
+            pos = cursors_.erase(pos);
+        }
+        else {
+            ++pos;
+        }
+    }
+
+    // A consumer that joins now could not catch up either.
+    num_joined_ = params_.num_consumers;
+
+    evict();
+
+    condition_.notify_all();
+}
+
+void Shared_read_session::fetch_chunk(std::unique_lock<std::mutex> &lock)
+{
+    fetching_ = true;
+
+    lock.unlock();
+
+    Memory_slice chunk{};
+
+    std::exception_ptr exception_ptr{};
+    try {
+        if (inner_ == nullptr) {
+            inner_ = store_->open_read();
+        }
+
+        chunk = inner_->read(params_.chunk_size);
+
+        if (chunk.empty()) {
+            inner_->close();
+        }
+    }
+    catch (...) {
+        exception_ptr = std::current_exception();
+    }
+
+    lock.lock();
+
+    fetching_ = false;
+
+    if (exception_ptr) {
+        exception_ptr_ = std::move(exception_ptr);
+    }
+    else if (chunk.empty()) {
+        eof_ = true;
+    }
+    else {
+        end_offset_ += chunk.size();
+
+        num_bytes_buffered_ += chunk.size();
+
+        chunks_.emplace_back(std::move(chunk));
+    }
+
+    condition_.notify_all();
+}
+
+namespace {
+
+// Reads a data store through a shared session; falls back to reading
+// the data store on its own once the session detaches it.
+class Shared_input_stream final : public Input_stream_base {
+public:
+    explicit Shared_input_stream(std::shared_ptr<Shared_read_session> session,
+                                 std::size_t consumer_id,
+                                 std::size_t chunk_size)
+        : session_{std::move(session)}, consumer_id_{consumer_id}, chunk_size_{chunk_size}
+    {}
+
+    Shared_input_stream(const Shared_input_stream &) = delete;
+
+    Shared_input_stream &operator=(const Shared_input_stream &) = delete;
+
+    Shared_input_stream(Shared_input_stream &&) = delete;
+
+    Shared_input_stream &operator=(Shared_input_stream &&) = delete;
+
+    ~Shared_input_stream() final
+    {
+        close();
+    }
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    Memory_slice read(std::size_t size) final;
+
+    void close() noexcept final;
+
+    std::size_t position() const final
+    {
+        check_if_closed();
+
+        return position_;
+    }
+
+    bool closed() const noexcept final
+    {
+        return closed_;
+    }
+
+private:
+    bool next_chunk();
+
+    void open_fallback();
+
+    void check_if_closed() const;
+
+    std::shared_ptr<Shared_read_session> session_;
+    std::size_t consumer_id_;
+    std::size_t chunk_size_;
+    Intrusive_ptr<Input_stream> fallback_{};
+    Memory_slice chunk_{};
+    std::size_t position_{};
+    bool closed_{};
+};
+
+std::size_t Shared_input_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return 0;
+    }
+
+    std::size_t num_bytes_read = std::min(destination.size(), chunk_.size());
+
+    auto pos = chunk_.begin();
+
+    std::copy(pos, pos + as_ssize(num_bytes_read), destination.begin());
+
+    chunk_ = chunk_.subslice(num_bytes_read);
+
+    position_ += num_bytes_read;
+
+    return num_bytes_read;
+}
+
+Memory_slice Shared_input_stream::read(std::size_t size)
+{
+    check_if_closed();
+
+    if (size == 0) {
+        return {};
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return {};
+    }
+
+    // The chunks are shared with the other consumers and never written
+    // to; so we can hand out slices of them.
+    if (size <= chunk_.size()) {
+        Memory_slice slice = chunk_.subslice(0, size);
+
+        chunk_ = chunk_.subslice(size);
+
+        position_ += size;
+
+        return slice;
+    }
+
+    return Input_stream_base::read(size);
+}
+
+void Shared_input_stream::close() noexcept
+{
+    if (closed_) {
+        return;
+    }
+
+    closed_ = true;
+
+    chunk_ = {};
+
+    session_->leave(consumer_id_);
+
+    if (fallback_ != nullptr) {
+        fallback_->close();
+    }
+}
+
+bool Shared_input_stream::next_chunk()
+{
+    if (fallback_ == nullptr) {
+        std::optional<Memory_slice> chunk = session_->read(consumer_id_, position_);
+        if (chunk) {
+            chunk_ = std::move(*chunk);
+
+            return !chunk_.empty();
+        }
+
+        open_fallback();
+    }
+
+    chunk_ = fallback_->read(chunk_size_);
+
+    return !chunk_.empty();
+}
+
+void Shared_input_stream::open_fallback()
+{
+    fallback_ = session_->store()->open_read();
+
+    if (fallback_->seekable()) {
+        fallback_->seek(position_);
+
+        return;
+    }
+
+    // Skip the data that we have already received from the session.
+    for (std::size_t num_bytes_left = position_; num_bytes_left > 0;) {
+        Memory_slice chunk = fallback_->read(std::min(num_bytes_left, chunk_size_));
+        if (chunk.empty()) {
+            throw Stream_error{fmt::format(
+                "The data store '{0}' has changed while it was being read.",
+                session_->store()->id())};
+        }
+        num_bytes_left -= chunk.size();
+    }
+}
+
+void Shared_input_stream::check_if_closed() const
+{
+    if (closed_) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+}  // namespace
+}  // namespace detail
+
+Shared_read_group::Shared_read_group(const Shared_read_params &params) : params_{params}
+{
+    if (params_.num_consumers == 0) {
+        throw std::invalid_argument{"The number of consumers must be greater than zero."};
+    }
+
+    if (params_.chunk_size == 0) {
+        throw std::invalid_argument{"The chunk size must be greater than zero."};
+    }
+
+    if (params_.max_buffer_size < params_.chunk_size) {
+        throw std::invalid_argument{
+            "The maximum buffer size must be greater than or equal to the chunk size."};
+    }
+}
+
+Shared_read_group::~Shared_read_group() = default;
+
+std::vector<Intrusive_ptr<Data_store>>
+Shared_read_group::share(const std::vector<Intrusive_ptr<Data_store>> &dataset)
+{
+    std::vector<Intrusive_ptr<Data_store>> shared_dataset{};
+    shared_dataset.reserve(dataset.size());
+
+    auto self = wrap_intrusive(this);
+
+    for (const Intrusive_ptr<Data_store> &store : dataset) {
+        shared_dataset.emplace_back(make_intrusive<Shared_data_store>(store, self));
+    }
+
+    return shared_dataset;
+}
+
+std::pair<std::shared_ptr<detail::Shared_read_session>, std::size_t>
+Shared_read_group::join_session(const Intrusive_ptr<Data_store> &store)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    std::shared_ptr<detail::Shared_read_session> &session = sessions_[store->id()];
+
+    std::size_t consumer_id{};
+
+    // If the current session of the data store cannot be joined, the
+    // consumer is either too late or starts a new epoch; in both cases
+    // it starts a new session that the others can join.
+    if (session == nullptr || !session->try_join(consumer_id)) {
+        session = std::make_shared<detail::Shared_read_session>(store, params_);
+
+        session->try_join(consumer_id);
+    }
+
+    return {session, consumer_id};
+}
+
+Shared_data_store::Shared_data_store(Intrusive_ptr<Data_store> inner,
+                                     Intrusive_ptr<Shared_read_group> group)
+    : inner_{std::move(inner)}, group_{std::move(group)}
+{
+    if (inner_ == nullptr || group_ == nullptr) {
+        throw std::invalid_argument{"The data store and the read group must be specified."};
+    }
+}
+
+Intrusive_ptr<Input_stream> Shared_data_store::open_read() const
+{
+    auto [session, consumer_id] = group_->join_session(inner_);
+
+    return make_intrusive<detail::Shared_input_stream>(
+        std::move(session), consumer_id, group_->params().chunk_size);
+}
+
+std::string Shared_data_store::repr() const
+{
+    return fmt::format("<Shared_data_store inner={0}>", inner_->repr());
+}
+
+const std::string &Shared_data_store::id() const
+{
+    return inner_->id();
+}
+
+std::optional<std::size_t> Shared_data_store::size_hint() const
+{
+    return inner_->size_hint();
+}
+
+std::optional<std::size_t> Shared_data_store::num_instances_hint() const
+{
+    return inner_->num_instances_hint();
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
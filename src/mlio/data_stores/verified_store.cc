@@ -0,0 +1,631 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/verified_store.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+
+#include "mlio/detail/crc32c.h"
+#include "mlio/detail/error.h"
+#include "mlio/detail/sha256.h"
+#include "mlio/logger.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/input_stream_base.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::current_error_code;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The reads smaller than this are gathered into a staging buffer
+// instead of getting hashed one by one.
+constexpr std::size_t staging_size = 0x4'0000;  // 256 KiB
+
+// The maximum number of bytes waiting to be hashed; bounds the memory
+// held by a reader that outpaces the hashing task.
+constexpr std::size_t max_pending_size = 0x100'0000;  // 16 MiB
+
+constexpr std::size_t read_size = 0x10'0000;  // 1 MiB
+
+std::string_view algorithm_name(Checksum_algorithm algorithm) noexcept
+{
+    return algorithm == Checksum_algorithm::crc32c ? "CRC32C" : "SHA-256";
+}
+
+class Hasher {
+public:
+    explicit Hasher(Checksum_algorithm algorithm) noexcept : algorithm_{algorithm}
+    {}
+
+    void update(Memory_span bits) noexcept
+    {
+        if (algorithm_ == Checksum_algorithm::crc32c) {
+            crc_ = crc32c(crc_, bits);
+        }
+        else {
+            sha_.update(bits);
+        }
+    }
+
+    std::string finish()
+    {
+        if (algorithm_ == Checksum_algorithm::crc32c) {
+            return fmt::format("{0:08x}", crc_);
+        }
+
+        std::array<std::byte, 32> digest = sha_.finish();
+
+        std::string s{};
+        s.reserve(digest.size() * 2);
+
+        for (std::byte b : digest) {
+            fmt::format_to(std::back_inserter(s), "{0:02x}", std::to_integer<unsigned>(b));
+        }
+        return s;
+    }
+
+    void reset() noexcept
+    {
+        crc_ = 0;
+
+        sha_.reset();
+    }
+
+private:
+    Checksum_algorithm algorithm_;
+    std::uint32_t crc_{};
+    Sha256 sha_{};
+};
+
+// Hashes the data read from the underlying stream in a task of its own
+// and compares the result to the expected checksum at the end of the
+// stream.
+class Verifying_input_stream final : public Input_stream_base {
+public:
+    explicit Verifying_input_stream(Intrusive_ptr<Input_stream> inner,
+                                    const Data_store &store,
+                                    const Checksum &checksum,
+                                    Checksum_mismatch_handling handling)
+        : inner_{std::move(inner)}
+        , store_id_{store.id()}
+        , checksum_{checksum}
+        , handling_{handling}
+        , hasher_{checksum.algorithm}
+    {}
+
+    Verifying_input_stream(const Verifying_input_stream &) = delete;
+
+    Verifying_input_stream &operator=(const Verifying_input_stream &) = delete;
+
+    Verifying_input_stream(Verifying_input_stream &&) = delete;
+
+    Verifying_input_stream &operator=(Verifying_input_stream &&) = delete;
+
+    ~Verifying_input_stream() final
+    {
+        close();
+    }
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    Memory_slice read(std::size_t size) final;
+
+    std::size_t read_at(std::size_t offset, Mutable_memory_span destination) final
+    {
+        return inner_->read_at(offset, destination);
+    }
+
+    Memory_slice read_at(std::size_t offset, std::size_t size) final
+    {
+        return inner_->read_at(offset, size);
+    }
+
+    void seek(std::size_t position) final;
+
+    void close() noexcept final;
+
+    std::size_t size() const final
+    {
+        return inner_->size();
+    }
+
+    std::size_t position() const final
+    {
+        return inner_->position();
+    }
+
+    bool closed() const noexcept final
+    {
+        return inner_->closed();
+    }
+
+    bool seekable() const noexcept final
+    {
+        return inner_->seekable();
+    }
+
+    bool supports_zero_copy() const noexcept final
+    {
+        return inner_->supports_zero_copy();
+    }
+
+    bool supports_read_at() const noexcept final
+    {
+        return inner_->supports_read_at();
+    }
+
+private:
+    void append(Memory_span bits);
+
+    void flush_staging();
+
+    void enqueue(Memory_slice slice);
+
+    void drain() noexcept;
+
+    void wait_for_drain() noexcept;
+
+    void verify();
+
+    Intrusive_ptr<Input_stream> inner_;
+    std::string store_id_;
+    Checksum checksum_;
+    Checksum_mismatch_handling handling_;
+    Hasher hasher_;
+    // Verifying means that every byte up to the current position has
+    // been handed to the hasher.
+    bool verifying_ = true;
+    Intrusive_ptr<Mutable_memory_block> staging_{};
+    std::size_t staging_pos_{};
+    std::mutex mutex_{};
+    std::deque<Memory_slice> pending_{};
+    std::size_t pending_size_{};
+    bool draining_{};
+    // Held by pointer since the destructor of a task group can throw.
+    std::unique_ptr<tbb::task_group> tasks_ = std::make_unique<tbb::task_group>();
+};
+
+std::size_t Verifying_input_stream::read(Mutable_memory_span destination)
+{
+    std::size_t num_bytes_read = inner_->read(destination);
+
+    if (!verifying_) {
+        return num_bytes_read;
+    }
+
+    if (num_bytes_read == 0) {
+        if (!destination.empty()) {
+            verify();
+        }
+    }
+    else {
+        // The destination belongs to the caller and gets overwritten by
+        // the next read; therefore it must be copied.
+        append(destination.first(num_bytes_read));
+    }
+
+    return num_bytes_read;
+}
+
+Memory_slice Verifying_input_stream::read(std::size_t size)
+{
+    Memory_slice slice = inner_->read(size);
+
+    if (!verifying_) {
+        return slice;
+    }
+
+    if (slice.empty()) {
+        if (size != 0) {
+            verify();
+        }
+    }
+    // The slice is never written to; so we can hash it in place.
+    else if (slice.size() >= staging_size) {
+        flush_staging();
+
+        enqueue(slice);
+    }
+    else {
+        append(slice);
+    }
+
+    return slice;
+}
+
+void Verifying_input_stream::seek(std::size_t position)
+{
+    if (verifying_ && position != inner_->position()) {
+        wait_for_drain();
+
+        if (position == 0) {
+            staging_pos_ = 0;
+
+            hasher_.reset();
+        }
+        else {
+            verifying_ = false;
+        }
+    }
+
+    inner_->seek(position);
+}
+
+void Verifying_input_stream::close() noexcept
+{
+    verifying_ = false;
+
+    wait_for_drain();
+
+    inner_->close();
+}
+
+void Verifying_input_stream::append(Memory_span bits)
+{
+    while (!bits.empty()) {
+        if (staging_ == nullptr) {
+            staging_ = memory_allocator().allocate(staging_size);
+
+            staging_pos_ = 0;
+        }
+
+        std::size_t n = std::min(bits.size(), staging_size - staging_pos_);
+
+        auto pos = staging_->begin() + as_ssize(staging_pos_);
+
+        std::copy(bits.begin(), bits.begin() + as_ssize(n), pos);
+
+        staging_pos_ += n;
+
+        bits = bits.subspan(n);
+
+        if (staging_pos_ == staging_size) {
+            flush_staging();
+        }
+    }
+}
+
+void Verifying_input_stream::flush_staging()
+{
+    if (staging_ == nullptr || staging_pos_ == 0) {
+        return;
+    }
+
+    // The staging buffer is handed over to the hashing task; the next
+    // read allocates a new one.
+    Memory_slice slice{std::move(staging_)};
+
+    enqueue(std::move(slice).subslice(0, staging_pos_));
+
+    staging_pos_ = 0;
+}
+
+void Verifying_input_stream::enqueue(Memory_slice slice)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // If the hashing task lags behind, wait for it. Waiting on the task
+    // group instead of a condition variable runs the task on this thread
+    // if no worker thread has picked it up yet.
+    if (pending_size_ >= max_pending_size) {
+        lock.unlock();
+
+        wait_for_drain();
+
+        lock.lock();
+    }
+
+    pending_size_ += slice.size();
+
+    pending_.emplace_back(std::move(slice));
+
+    if (draining_) {
+        return;
+    }
+
+    draining_ = true;
+
+    lock.unlock();
+
+    // A single task hashes the slices so that they are hashed in order.
+    tasks_->run([this]() {
+        drain();
+    });
+}
+
+void Verifying_input_stream::drain() noexcept
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    while (!pending_.empty()) {
+        Memory_slice slice = std::move(pending_.front());
+
+        pending_.pop_front();
+
+        lock.unlock();
+
+        hasher_.update(slice);
+
+        lock.lock();
+
+        pending_size_ -= slice.size();
+    }
+
+    draining_ = false;
+}
+
+void Verifying_input_stream::wait_for_drain() noexcept
+{
+    try {
+        tasks_->wait();
+    }
+    catch (...) {
+    }
+}
+
+void Verifying_input_stream::verify()
+{
+    verifying_ = false;
+
+    flush_staging();
+
+    wait_for_drain();
+
+    std::string actual = hasher_.finish();
+    if (actual == checksum_.value) {
+        return;
+    }
+
+    std::string msg = fmt::format(
+        "The {0} checksum of the data store '{1}' is '{2}', but '{3}' was expected.",
+        algorithm_name(checksum_.algorithm),
+        store_id_,
+        actual,
+        checksum_.value);
+
+    if (handling_ == Checksum_mismatch_handling::error) {
+        throw Checksum_error{msg};
+    }
+
+    logger::warn(msg);
+}
+
+Checksum make_checksum(const Data_store &store, Checksum_algorithm algorithm)
+{
+    Hasher hasher{algorithm};
+
+    Intrusive_ptr<Input_stream> stream = store.open_read();
+
+    for (;;) {
+        Memory_slice slice = stream->read(read_size);
+        if (slice.empty()) {
+            break;
+        }
+
+        hasher.update(slice);
+    }
+
+    return Checksum{algorithm, hasher.finish()};
+}
+
+bool is_hex(std::string_view s) noexcept
+{
+    return std::all_of(s.begin(), s.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    });
+}
+
+}  // namespace
+}  // namespace detail
+
+Verified_data_store::Verified_data_store(Intrusive_ptr<Data_store> inner,
+                                         Checksum checksum,
+                                         Checksum_mismatch_handling handling)
+    : inner_{std::move(inner)}, checksum_{std::move(checksum)}, handling_{handling}
+{
+    if (inner_ == nullptr) {
+        throw std::invalid_argument{"The data store must be specified."};
+    }
+
+    std::size_t num_digits = checksum_.algorithm == Checksum_algorithm::crc32c ? 8 : 64;
+
+    std::string &value = checksum_.value;
+
+    std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+        return c >= 'A' && c <= 'F' ? static_cast<char>(c - 'A' + 'a') : c;
+    });
+
+    if (value.size() != num_digits || !detail::is_hex(value)) {
+        throw std::invalid_argument{fmt::format(
+            "The {0} checksum must be a hexadecimal string of {1} digits.",
+            detail::algorithm_name(checksum_.algorithm),
+            num_digits)};
+    }
+}
+
+Intrusive_ptr<Input_stream> Verified_data_store::open_read() const
+{
+    return make_intrusive<detail::Verifying_input_stream>(
+        inner_->open_read(), *inner_, checksum_, handling_);
+}
+
+std::string Verified_data_store::repr() const
+{
+    return fmt::format(
+        "<Verified_data_store inner={0} checksum='{1}'>", inner_->repr(), checksum_.value);
+}
+
+const std::string &Verified_data_store::id() const
+{
+    return inner_->id();
+}
+
+std::optional<std::size_t> Verified_data_store::size_hint() const
+{
+    return inner_->size_hint();
+}
+
+std::optional<std::size_t> Verified_data_store::num_instances_hint() const
+{
+    return inner_->num_instances_hint();
+}
+
+Checksum compute_checksum(const Data_store &store, Checksum_algorithm algorithm)
+{
+    return detail::make_checksum(store, algorithm);
+}
+
+void write_checksum_manifest(const std::string &path,
+                             stdx::span<const Intrusive_ptr<Data_store>> stores,
+                             Checksum_algorithm algorithm)
+{
+    for (const Intrusive_ptr<Data_store> &store : stores) {
+        if (store->id().find('\n') != std::string::npos) {
+            throw std::invalid_argument{fmt::format(
+                "The identifier '{0}' contains a line break and cannot be written to a checksum "
+                "manifest.",
+                store->id())};
+        }
+    }
+
+    std::vector<Checksum> checksums(stores.size());
+
+    tbb::parallel_for(std::size_t{}, stores.size(), [&](std::size_t i) {
+        checksums[i] = compute_checksum(*stores[i], algorithm);
+    });
+
+    std::string text{};
+    for (std::size_t i = 0; i < stores.size(); i++) {
+        text += fmt::format("{0}  {1}\n", checksums[i].value, stores[i]->id());
+    }
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (out) {
+        out.write(text.data(), as_ssize(text.size()));
+    }
+
+    if (!out) {
+        throw std::system_error{current_error_code(), "The checksum manifest cannot be written."};
+    }
+}
+
+std::unordered_map<std::string, Checksum> read_checksum_manifest(const std::string &path)
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The checksum manifest '{0}' cannot be opened.", path)};
+    }
+
+    auto make_error = [&path]() {
+        return std::invalid_argument{
+            fmt::format("The file '{0}' is not a valid checksum manifest.", path)};
+    };
+
+    std::unordered_map<std::string, Checksum> result{};
+
+    std::string line{};
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::size_t sep_pos = line.find(' ');
+        if (sep_pos == std::string::npos || line.size() < sep_pos + 3) {
+            throw make_error();
+        }
+
+        Checksum checksum{};
+        if (sep_pos == 8) {
+            checksum.algorithm = Checksum_algorithm::crc32c;
+        }
+        else if (sep_pos == 64) {
+            checksum.algorithm = Checksum_algorithm::sha256;
+        }
+        else {
+            throw make_error();
+        }
+
+        checksum.value = line.substr(0, sep_pos);
+        if (!detail::is_hex(checksum.value)) {
+            throw make_error();
+        }
+
+        // The sha256sum tool marks the files it has read in binary mode
+        // with an asterisk instead of a second space.
+        char mode = line[sep_pos + 1];
+        if (mode != ' ' && mode != '*') {
+            throw make_error();
+        }
+
+        result.insert_or_assign(line.substr(sep_pos + 2), std::move(checksum));
+    }
+
+    if (!in.eof()) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The checksum manifest '{0}' cannot be read.", path)};
+    }
+
+    return result;
+}
+
+std::vector<Intrusive_ptr<Data_store>>
+verify_checksums(const std::vector<Intrusive_ptr<Data_store>> &dataset,
+                 const std::unordered_map<std::string, Checksum> &checksums,
+                 Checksum_mismatch_handling handling)
+{
+    std::vector<Intrusive_ptr<Data_store>> result{};
+    result.reserve(dataset.size());
+
+    for (const Intrusive_ptr<Data_store> &store : dataset) {
+        auto pos = checksums.find(store->id());
+        if (pos == checksums.end()) {
+            result.emplace_back(store);
+        }
+        else {
+            result.emplace_back(make_intrusive<Verified_data_store>(store, pos->second, handling));
+        }
+    }
+
+    return result;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/data_stores/zip_member.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/path.h"
+#include "mlio/logger.h"
+#include "mlio/memory/file_mapped_memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/streams/detail/zip_archive.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/memory_input_stream.h"
+
+using mlio::detail::Zip_entry;
+using mlio::detail::Zip_member_access;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Zip_member_access {
+    static inline Intrusive_ptr<Zip_member> make(const std::string &archive_path, Zip_entry &&entry)
+    {
+        return wrap_intrusive(new Zip_member{archive_path, std::move(entry)});
+    }
+};
+
+}  // namespace detail
+
+Zip_member::Zip_member(std::string archive_path, const std::string &name)
+    : archive_path_{std::move(archive_path)}
+{
+    detail::validate_file_path(archive_path_);
+
+    auto block = make_intrusive<File_mapped_memory_block>(archive_path_);
+
+    for (Zip_entry &entry : detail::read_zip_entries(*block)) {
+        if (entry.name == name) {
+            entry_ = std::make_unique<const Zip_entry>(std::move(entry));
+
+            break;
+        }
+    }
+
+    if (entry_ == nullptr) {
+        throw std::invalid_argument{fmt::format(
+            "The zip archive '{0}' does not have a member named '{1}'.", archive_path_, name)};
+    }
+
+    id_ = archive_path_ + "!/" + entry_->name;
+}
+
+Zip_member::Zip_member(std::string archive_path, Zip_entry &&entry)
+    : archive_path_{std::move(archive_path)}
+    , entry_{std::make_unique<const Zip_entry>(std::move(entry))}
+    , id_{archive_path_ + "!/" + entry_->name}
+{}
+
+Zip_member::~Zip_member() = default;
+
+Intrusive_ptr<Input_stream> Zip_member::open_read() const
+{
+    logger::info("The zip member '{0}' is being opened.", id_);
+
+    Memory_slice archive = make_intrusive<File_mapped_memory_block>(archive_path_);
+
+    return make_intrusive<Memory_input_stream>(detail::inflate_zip_entry(archive, *entry_));
+}
+
+std::string Zip_member::repr() const
+{
+    return fmt::format("<Zip_member archive_path='{0}' name='{1}'>", archive_path_, entry_->name);
+}
+
+std::optional<std::size_t> Zip_member::size_hint() const noexcept
+{
+    return entry_->size;
+}
+
+const std::string &Zip_member::name() const noexcept
+{
+    return entry_->name;
+}
+
+std::vector<Intrusive_ptr<Data_store>> list_zip_members(const std::string &archive_path)
+{
+    detail::validate_file_path(archive_path);
+
+    auto block = make_intrusive<File_mapped_memory_block>(archive_path);
+
+    std::vector<Intrusive_ptr<Data_store>> result{};
+
+    for (Zip_entry &entry : detail::read_zip_entries(*block)) {
+        result.emplace_back(Zip_member_access::make(archive_path, std::move(entry)));
+    }
+
+    return result;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+enum class Allocation_stage {
+    other,
+    io,
+    framing,
+    shuffle,
+    decode,
+    tokenize,
+    protobuf,
+    transform,
+};
+
+enum class Allocation_source { memory_block, cpu_array, heap };
+
+// The symbols below are exported since the chunk readers, which are also
+// compiled into the benchmarks, use them.
+
+MLIO_API
+extern std::atomic_bool allocation_audit_enabled;
+
+MLIO_API
+extern thread_local Allocation_stage current_allocation_stage;
+
+MLIO_API
+void count_allocation(Allocation_source source, std::size_t size) noexcept;
+
+inline void record_allocation(Allocation_source source, std::size_t size) noexcept
+{
+    if (allocation_audit_enabled.load(std::memory_order_relaxed)) {
+        count_allocation(source, size);
+    }
+}
+
+// Attributes the allocations made by the current thread during the
+// lifetime of the scope to the specified stage; see
+// start_allocation_audit().
+class Allocation_scope {
+public:
+    explicit Allocation_scope(Allocation_stage stage) noexcept
+        : previous_stage_{current_allocation_stage}
+    {
+        current_allocation_stage = stage;
+    }
+
+    Allocation_scope(const Allocation_scope &) = delete;
+
+    Allocation_scope &operator=(const Allocation_scope &) = delete;
+
+    Allocation_scope(Allocation_scope &&) = delete;
+
+    Allocation_scope &operator=(Allocation_scope &&) = delete;
+
+    ~Allocation_scope()
+    {
+        current_allocation_stage = previous_stage_;
+    }
+
+private:
+    Allocation_stage previous_stage_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
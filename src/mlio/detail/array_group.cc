@@ -0,0 +1,120 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/array_group.h"
+
+#include <type_traits>
+
+#include "mlio/cpu_array.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::size_t cache_line_size = 64;
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()()
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+template<Data_type dt>
+struct Carve_array_op {
+    std::unique_ptr<Device_array>
+    operator()(const std::shared_ptr<void> &owner, std::byte *data, std::size_t size)
+    {
+        using T = data_type_t<dt>;
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            return Cpu_array_access::wrap(
+                dt, Array_group_slice<T>{owner, reinterpret_cast<T *>(data), size});
+        }
+        else {
+            return make_cpu_array(dt, size);
+        }
+    }
+};
+
+}  // namespace
+
+std::vector<std::size_t> layout_array_group(stdx::span<const Data_type> dts, std::size_t size)
+{
+    std::vector<std::size_t> sizes(dts.size(), size);
+
+    return layout_array_group(dts, sizes);
+}
+
+std::vector<std::size_t>
+layout_array_group(stdx::span<const Data_type> dts, stdx::span<const std::size_t> sizes)
+{
+    std::vector<std::size_t> offsets{};
+    offsets.reserve(dts.size() + 1);
+
+    std::size_t offset = 0;
+
+    for (std::size_t i = 0; i < dts.size(); i++) {
+        offsets.emplace_back(offset);
+
+        if (dts[i] == Data_type::string) {
+            continue;
+        }
+
+        std::size_t num_bytes = dispatch<Element_size_op>(dts[i]) * sizes[i];
+
+        offset += (num_bytes + cache_line_size - 1) & ~(cache_line_size - 1);
+    }
+
+    offsets.emplace_back(offset);
+
+    return offsets;
+}
+
+std::vector<std::unique_ptr<Device_array>>
+carve_array_group(const std::shared_ptr<void> &owner,
+                  std::byte *data,
+                  stdx::span<const Data_type> dts,
+                  stdx::span<const std::size_t> offsets,
+                  std::size_t size)
+{
+    std::vector<std::size_t> sizes(dts.size(), size);
+
+    return carve_array_group(owner, data, dts, offsets, sizes);
+}
+
+std::vector<std::unique_ptr<Device_array>>
+carve_array_group(const std::shared_ptr<void> &owner,
+                  std::byte *data,
+                  stdx::span<const Data_type> dts,
+                  stdx::span<const std::size_t> offsets,
+                  stdx::span<const std::size_t> sizes)
+{
+    std::vector<std::unique_ptr<Device_array>> arrays{};
+    arrays.reserve(dts.size());
+
+    for (std::size_t i = 0; i < dts.size(); i++) {
+        arrays.emplace_back(
+            dispatch<Carve_array_op>(dts[i], owner, data + offsets[i], sizes[i]));
+    }
+
+    return arrays;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Exposes a region of a memory block that is shared by a group of
+// arrays as a sequence container so that it can be wrapped by a
+// Cpu_array. The block is kept alive until all arrays of the group
+// are destroyed.
+template<typename T>
+class Array_group_slice {
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    explicit Array_group_slice(std::shared_ptr<void> owner, T *data, std::size_t size) noexcept
+        : owner_{std::move(owner)}, data_{data}, size_{size}
+    {}
+
+    T *data() noexcept
+    {
+        return data_;
+    }
+
+    const T *data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    T *begin() noexcept
+    {
+        return data_;
+    }
+
+    T *end() noexcept
+    {
+        return data_ + size_;
+    }
+
+    const T *begin() const noexcept
+    {
+        return data_;
+    }
+
+    const T *end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+private:
+    std::shared_ptr<void> owner_;
+    T *data_;
+    std::size_t size_;
+};
+
+// Returns the byte offset of each array of the group in the shared
+// memory block. The offsets are cache line aligned so that the arrays
+// can be written by different threads without false sharing. The last
+// offset is the total size of the block.
+std::vector<std::size_t>
+layout_array_group(stdx::span<const Data_type> dts, std::size_t size);
+
+// Same as above, but the arrays can have different sizes, such as the
+// value and index arrays of a sparse tensor.
+std::vector<std::size_t>
+layout_array_group(stdx::span<const Data_type> dts, stdx::span<const std::size_t> sizes);
+
+// Carves the arrays of the group out of the specified memory block that
+// must have the layout returned by layout_array_group(). The arrays of
+// type Data_type::string are allocated separately.
+std::vector<std::unique_ptr<Device_array>>
+carve_array_group(const std::shared_ptr<void> &owner,
+                  std::byte *data,
+                  stdx::span<const Data_type> dts,
+                  stdx::span<const std::size_t> offsets,
+                  std::size_t size);
+
+std::vector<std::unique_ptr<Device_array>>
+carve_array_group(const std::shared_ptr<void> &owner,
+                  std::byte *data,
+                  stdx::span<const Data_type> dts,
+                  stdx::span<const std::size_t> offsets,
+                  stdx::span<const std::size_t> sizes);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,542 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/avro.h"
+
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/detail/json_parser.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/streams/detail/zlib.h"
+#include "mlio/streams/detail/zstd.h"
+#include "mlio/util/number.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+std::optional<Avro_kind> get_primitive_kind(std::string_view name) noexcept
+{
+    if (name == "null") {
+        return Avro_kind::null;
+    }
+    if (name == "boolean") {
+        return Avro_kind::boolean;
+    }
+    if (name == "int") {
+        return Avro_kind::int_;
+    }
+    if (name == "long") {
+        return Avro_kind::long_;
+    }
+    if (name == "float") {
+        return Avro_kind::float_;
+    }
+    if (name == "double") {
+        return Avro_kind::double_;
+    }
+    if (name == "bytes") {
+        return Avro_kind::bytes;
+    }
+    if (name == "string") {
+        return Avro_kind::string;
+    }
+    return {};
+}
+
+// Inflates the data of a block whose uncompressed size is not known in
+// advance.
+template<typename Inflater>
+void inflate_block(Inflater &inflater, Memory_span bits, std::vector<std::byte> &buffer)
+{
+    buffer.resize(std::max(buffer.capacity(), bits.size() * 4));
+
+    std::size_t size = 0;
+
+    do {
+        if (size == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+
+        Mutable_memory_span out{buffer.data() + size, buffer.size() - size};
+
+        std::size_t out_size = out.size();
+
+        inflater.inflate(bits, out);
+
+        size += out_size - out.size();
+
+        if (bits.empty() && !out.empty() && !inflater.eof()) {
+            throw Corrupt_record_error{"The compressed data of the Avro block ends unexpectedly."};
+        }
+    } while (!inflater.eof());
+
+    buffer.resize(size);
+}
+
+}  // namespace
+
+class Avro_schema::Parser {
+public:
+    explicit Parser(Avro_schema &schema, std::string_view json) noexcept
+        : schema_{&schema}, parser_{json}
+    {}
+
+    std::size_t parse_type(const std::string &ns);
+
+    bool at_end() noexcept
+    {
+        return parser_.at_end();
+    }
+
+private:
+    std::size_t parse_union(const std::string &ns);
+
+    std::size_t parse_object(const std::string &ns);
+
+    void parse_fields(const std::string &ns, Avro_node &node);
+
+    std::size_t resolve_name(std::string_view name, const std::string &ns) const;
+
+    std::string read_string();
+
+    std::size_t add_node(Avro_node &&node);
+
+    std::size_t add_named_node(Avro_node &&node, const std::string &name, const std::string &ns);
+
+    [[noreturn]] static void fail(const std::string &message)
+    {
+        throw Schema_error{fmt::format("The Avro schema is invalid. {0}", message)};
+    }
+
+    Avro_schema *schema_;
+    Json_parser parser_;
+    std::unordered_map<std::string, std::size_t> named_types_{};
+    std::string scratch_{};
+};
+
+Avro_schema Avro_schema::parse(std::string_view json)
+{
+    Avro_schema schema{};
+
+    Parser parser{schema, json};
+
+    schema.root_ = parser.parse_type({});
+
+    if (!parser.at_end()) {
+        throw Schema_error{"The Avro schema is invalid. It has trailing characters."};
+    }
+
+    return schema;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+std::size_t Avro_schema::Parser::parse_type(const std::string &ns)
+{
+    switch (parser_.peek()) {
+    case Json_kind::string: {
+        std::string name = read_string();
+
+        std::optional<Avro_kind> kind = get_primitive_kind(name);
+        if (kind) {
+            return add_node(Avro_node{*kind});
+        }
+        return resolve_name(name, ns);
+    }
+    case Json_kind::array:
+        return parse_union(ns);
+    case Json_kind::object:
+        return parse_object(ns);
+    default:
+        fail("A type must be a string, an array, or an object.");
+    }
+}
+
+#pragma GCC diagnostic pop
+
+std::size_t Avro_schema::Parser::parse_union(const std::string &ns)
+{
+    Avro_node node{Avro_kind::union_};
+
+    parser_.begin_array();
+    while (parser_.next_element()) {
+        node.children.emplace_back(parse_type(ns));
+    }
+
+    if (parser_.failed()) {
+        fail("A union is not a valid JSON array.");
+    }
+
+    return add_node(std::move(node));
+}
+
+std::size_t Avro_schema::Parser::parse_object(const std::string &ns)
+{
+    Avro_node node{};
+
+    std::string type_name{};
+    std::optional<std::size_t> type_idx{};
+
+    std::string name{};
+    std::string object_ns = ns;
+
+    std::optional<std::size_t> item_idx{};
+
+    bool has_fields = false;
+    bool has_size = false;
+
+    std::string_view key{};
+    std::string key_scratch{};
+
+    parser_.begin_object();
+    while (parser_.next_member(key, key_scratch)) {
+        if (key == "type") {
+            if (parser_.peek() == Json_kind::string) {
+                type_name = read_string();
+            }
+            else {
+                type_idx = parse_type(object_ns);
+            }
+        }
+        else if (key == "name") {
+            name = read_string();
+        }
+        else if (key == "namespace") {
+            object_ns = read_string();
+        }
+        else if (key == "fields") {
+            parse_fields(object_ns, node);
+
+            has_fields = true;
+        }
+        else if (key == "items" || key == "values") {
+            item_idx = parse_type(object_ns);
+        }
+        else if (key == "symbols") {
+            parser_.begin_array();
+            while (parser_.next_element()) {
+                node.symbols.emplace_back(read_string());
+            }
+        }
+        else if (key == "size") {
+            std::string_view token{};
+            if (!parser_.read_number(token) ||
+                try_parse_size_t(token, node.size) != Parse_result::ok) {
+                fail("The size of a fixed must be a non-negative integer.");
+            }
+
+            has_size = true;
+        }
+        else if (!parser_.skip_value()) {
+            break;
+        }
+    }
+
+    if (parser_.failed()) {
+        fail("A type is not a valid JSON object.");
+    }
+
+    // A type wrapped in an object, e.g. {"type": ["null", "int"]}.
+    if (type_idx) {
+        return *type_idx;
+    }
+
+    if (type_name == "record" || type_name == "error") {
+        if (!has_fields) {
+            fail(fmt::format("The record '{0}' has no fields.", name));
+        }
+        node.kind = Avro_kind::record;
+    }
+    else if (type_name == "enum") {
+        node.kind = Avro_kind::enum_;
+    }
+    else if (type_name == "array" || type_name == "map") {
+        if (item_idx == std::nullopt) {
+            fail(fmt::format("The {0} has no item type.", type_name));
+        }
+
+        node.kind = type_name == "array" ? Avro_kind::array : Avro_kind::map;
+
+        node.children.emplace_back(*item_idx);
+
+        return add_node(std::move(node));
+    }
+    else if (type_name == "fixed") {
+        if (!has_size) {
+            fail(fmt::format("The fixed '{0}' has no size.", name));
+        }
+        node.kind = Avro_kind::fixed;
+    }
+    else {
+        // A primitive type with attributes such as a logical type, or a
+        // reference to a named type.
+        std::optional<Avro_kind> kind = get_primitive_kind(type_name);
+        if (kind) {
+            return add_node(Avro_node{*kind});
+        }
+        return resolve_name(type_name, object_ns);
+    }
+
+    if (name.empty()) {
+        fail(fmt::format("The {0} has no name.", type_name));
+    }
+
+    return add_named_node(std::move(node), name, object_ns);
+}
+
+void Avro_schema::Parser::parse_fields(const std::string &ns, Avro_node &node)
+{
+    parser_.begin_array();
+    while (parser_.next_element()) {
+        std::string name{};
+        std::optional<std::size_t> type_idx{};
+
+        std::string_view key{};
+        std::string key_scratch{};
+
+        parser_.begin_object();
+        while (parser_.next_member(key, key_scratch)) {
+            if (key == "name") {
+                name = read_string();
+            }
+            else if (key == "type") {
+                type_idx = parse_type(ns);
+            }
+            else if (!parser_.skip_value()) {
+                break;
+            }
+        }
+
+        if (parser_.failed() || name.empty() || type_idx == std::nullopt) {
+            fail("A record field must have a name and a type.");
+        }
+
+        node.field_names.emplace_back(std::move(name));
+        node.children.emplace_back(*type_idx);
+    }
+}
+
+std::size_t Avro_schema::Parser::resolve_name(std::string_view name, const std::string &ns) const
+{
+    if (name.find('.') == std::string_view::npos && !ns.empty()) {
+        auto pos = named_types_.find(fmt::format("{0}.{1}", ns, name));
+        if (pos != named_types_.end()) {
+            return pos->second;
+        }
+    }
+
+    auto pos = named_types_.find(std::string{name});
+    if (pos == named_types_.end()) {
+        fail(fmt::format("The type '{0}' is not defined.", name));
+    }
+    return pos->second;
+}
+
+std::string Avro_schema::Parser::read_string()
+{
+    std::string_view value{};
+    if (!parser_.read_string(value, scratch_)) {
+        fail("A name or a symbol is not a valid JSON string.");
+    }
+    return std::string{value};
+}
+
+std::size_t Avro_schema::Parser::add_node(Avro_node &&node)
+{
+    schema_->nodes_.emplace_back(std::move(node));
+
+    return schema_->nodes_.size() - 1;
+}
+
+std::size_t Avro_schema::Parser::add_named_node(Avro_node &&node,
+                                                const std::string &name,
+                                                const std::string &ns)
+{
+    std::string full_name = name;
+    if (name.find('.') == std::string::npos && !ns.empty()) {
+        full_name = fmt::format("{0}.{1}", ns, name);
+    }
+
+    node.name = full_name;
+
+    std::size_t idx = add_node(std::move(node));
+
+    if (!named_types_.emplace(full_name, idx).second) {
+        fail(fmt::format("The type '{0}' is defined more than once.", full_name));
+    }
+
+    return idx;
+}
+
+bool Avro_cursor::read_int(std::int32_t &value) noexcept
+{
+    std::int64_t long_value{};
+    if (!read_long(long_value)) {
+        return false;
+    }
+
+    if (long_value < std::numeric_limits<std::int32_t>::min() ||
+        long_value > std::numeric_limits<std::int32_t>::max()) {
+        return false;
+    }
+
+    value = static_cast<std::int32_t>(long_value);
+
+    return true;
+}
+
+bool Avro_cursor::read_bytes(std::string_view &value) noexcept
+{
+    std::int64_t size{};
+    if (!read_long(size) || size < 0) {
+        return false;
+    }
+
+    return read_fixed(static_cast<std::size_t>(size), value);
+}
+
+bool Avro_cursor::read_fixed(std::size_t size, std::string_view &value) noexcept
+{
+    if (static_cast<std::size_t>(end_ - pos_) < size) {
+        return false;
+    }
+
+    value = std::string_view{reinterpret_cast<const char *>(pos_), size};
+
+    pos_ += size;
+
+    return true;
+}
+
+bool Avro_cursor::skip(const Avro_schema &schema, std::size_t node_idx) noexcept
+{
+    const Avro_node &node = schema.node(node_idx);
+
+    std::int64_t value{};
+
+    switch (node.kind) {
+    case Avro_kind::null:
+        return true;
+    case Avro_kind::boolean:
+        return skip_bytes(1);
+    case Avro_kind::int_:
+    case Avro_kind::long_:
+    case Avro_kind::enum_:
+        return read_long(value);
+    case Avro_kind::float_:
+        return skip_bytes(sizeof(float));
+    case Avro_kind::double_:
+        return skip_bytes(sizeof(double));
+    case Avro_kind::bytes:
+    case Avro_kind::string:
+        return read_long(value) && value >= 0 && skip_bytes(value);
+    case Avro_kind::fixed:
+        return skip_bytes(static_cast<std::int64_t>(node.size));
+    case Avro_kind::record:
+        for (std::size_t child_idx : node.children) {
+            if (!skip(schema, child_idx)) {
+                return false;
+            }
+        }
+        return true;
+    case Avro_kind::array:
+    case Avro_kind::map:
+        return skip_blocks(schema, node);
+    case Avro_kind::union_:
+        if (!read_long(value) || value < 0 ||
+            static_cast<std::size_t>(value) >= node.children.size()) {
+            return false;
+        }
+        return skip(schema, node.children[static_cast<std::size_t>(value)]);
+    }
+
+    return false;
+}
+
+bool Avro_cursor::skip_bytes(std::int64_t size) noexcept
+{
+    if (size < 0 || static_cast<std::uint64_t>(end_ - pos_) < static_cast<std::uint64_t>(size)) {
+        return false;
+    }
+
+    pos_ += size;
+
+    return true;
+}
+
+bool Avro_cursor::skip_blocks(const Avro_schema &schema, const Avro_node &node) noexcept
+{
+    std::int64_t count{};
+    while (read_long(count) && count != 0) {
+        // A negative count is followed by the size of the block in bytes,
+        // which allows the block to be skipped without decoding it.
+        if (count < 0) {
+            std::int64_t size{};
+            if (!read_long(size) || !skip_bytes(size)) {
+                return false;
+            }
+            continue;
+        }
+
+        for (std::int64_t i = 0; i < count; i++) {
+            if (node.kind == Avro_kind::map) {
+                std::string_view key{};
+                if (!read_bytes(key)) {
+                    return false;
+                }
+            }
+
+            if (!skip(schema, node.children[0])) {
+                return false;
+            }
+        }
+    }
+
+    return count == 0;
+}
+
+void decompress_avro_block(Avro_codec codec, Memory_span bits, std::vector<std::byte> &buffer)
+{
+    switch (codec) {
+    case Avro_codec::null:
+        buffer.assign(bits.begin(), bits.end());
+        break;
+    case Avro_codec::deflate: {
+        Zlib_inflater inflater{true};
+
+        inflate_block(inflater, bits, buffer);
+        break;
+    }
+    case Avro_codec::zstandard: {
+        Zstd_inflater inflater{};
+
+        inflate_block(inflater, bits, buffer);
+        break;
+    }
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
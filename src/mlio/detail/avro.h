@@ -0,0 +1,212 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/endian.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// The types of the Avro specification; the ones that are C++ keywords
+// have a trailing underscore.
+enum class Avro_kind {
+    null,
+    boolean,
+    int_,
+    long_,
+    float_,
+    double_,
+    bytes,
+    string,
+    record,
+    enum_,
+    array,
+    map,
+    union_,
+    fixed,
+};
+
+struct Avro_node {
+    Avro_kind kind{};
+    // The full name of a record, enum, or fixed.
+    std::string name{};
+    // The field types of a record, the branches of a union, or the item
+    // type of an array or a map.
+    std::vector<std::size_t> children{};
+    // The field names of a record.
+    std::vector<std::string> field_names{};
+    // The symbols of an enum.
+    std::vector<std::string> symbols{};
+    // The size of a fixed.
+    std::size_t size{};
+};
+
+// Represents a parsed Avro schema. The nodes are stored in a flat list
+// and refer to each other by index; a named type has a single node no
+// matter how many times it is referenced.
+class Avro_schema {
+public:
+    // Parses the JSON representation of a schema. Throws Schema_error if
+    // the schema is invalid.
+    static Avro_schema parse(std::string_view json);
+
+    const Avro_node &root() const noexcept
+    {
+        return nodes_[root_];
+    }
+
+    const Avro_node &node(std::size_t idx) const noexcept
+    {
+        return nodes_[idx];
+    }
+
+private:
+    class Parser;
+
+    std::vector<Avro_node> nodes_{};
+    std::size_t root_{};
+};
+
+// Reads the values of the Avro binary encoding. The functions return
+// false if the data ends prematurely or is malformed.
+class Avro_cursor {
+public:
+    explicit Avro_cursor(Memory_span bits) noexcept
+        : pos_{bits.data()}, end_{bits.data() + bits.size()}
+    {}
+
+    // Reads a zig-zag encoded variable-length integer.
+    bool read_long(std::int64_t &value) noexcept
+    {
+        std::uint64_t raw = 0;
+        for (unsigned shift = 0; shift < 64 && pos_ != end_; shift += 7) {
+            auto b = std::to_integer<std::uint64_t>(*pos_++);
+
+            raw |= (b & 0x7f) << shift;
+
+            if ((b & 0x80) == 0) {
+                value = static_cast<std::int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool read_int(std::int32_t &value) noexcept;
+
+    bool read_boolean(std::uint8_t &value) noexcept
+    {
+        if (pos_ == end_) {
+            return false;
+        }
+
+        value = std::to_integer<std::uint8_t>(*pos_++);
+
+        return value <= 1;
+    }
+
+    bool read_float(float &value) noexcept
+    {
+        std::uint32_t bits{};
+        if (!read_raw(bits)) {
+            return false;
+        }
+
+        bits = little_to_host_order(bits);
+
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return true;
+    }
+
+    bool read_double(double &value) noexcept
+    {
+        std::uint64_t bits{};
+        if (!read_raw(bits)) {
+            return false;
+        }
+
+        bits = little_to_host_order(bits);
+
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return true;
+    }
+
+    // Reads the length-prefixed value of a bytes or a string.
+    bool read_bytes(std::string_view &value) noexcept;
+
+    bool read_fixed(std::size_t size, std::string_view &value) noexcept;
+
+    // Skips a value of the specified type.
+    bool skip(const Avro_schema &schema, std::size_t node_idx) noexcept;
+
+    bool eof() const noexcept
+    {
+        return pos_ == end_;
+    }
+
+    // Returns the number of bytes left to read.
+    std::size_t remaining() const noexcept
+    {
+        return static_cast<std::size_t>(end_ - pos_);
+    }
+
+private:
+    template<typename T>
+    bool read_raw(T &value) noexcept
+    {
+        if (static_cast<std::size_t>(end_ - pos_) < sizeof(T)) {
+            return false;
+        }
+
+        std::memcpy(&value, pos_, sizeof(T));
+
+        pos_ += sizeof(T);
+
+        return true;
+    }
+
+    bool skip_bytes(std::int64_t size) noexcept;
+
+    bool skip_blocks(const Avro_schema &schema, const Avro_node &node) noexcept;
+
+    const std::byte *pos_;
+    const std::byte *end_;
+};
+
+// The compression codecs of the blocks of an Avro object container
+// file that can be read.
+enum class Avro_codec { null, deflate, zstandard };
+
+// Decompresses the data of an Avro block into the specified buffer.
+MLIO_HIDDEN
+void decompress_avro_block(Avro_codec codec, Memory_span bits, std::vector<std::byte> &buffer);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "mlio/detail/random.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Bloom_filter::Bloom_filter(std::size_t num_bytes, double false_positive_rate)
+{
+    if (num_bytes == 0) {
+        throw std::invalid_argument{"The size of the Bloom filter must be greater than zero."};
+    }
+
+    if (false_positive_rate <= 0.0 || false_positive_rate >= 1.0) {
+        throw std::invalid_argument{
+            "The false positive rate must be greater than 0 and less than 1."};
+    }
+
+    std::size_t num_words = (num_bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    num_bits_ = num_words * 64;
+
+    // The optimal number of hash functions for the target rate.
+    auto num_hashes = static_cast<std::size_t>(std::ceil(-std::log2(false_positive_rate)));
+
+    num_hashes_ = std::clamp<std::size_t>(num_hashes, 1, 32);
+
+    words_ = std::make_unique<std::atomic<std::uint64_t>[]>(num_words);
+
+    clear();
+}
+
+bool Bloom_filter::insert(std::uint64_t hash) noexcept
+{
+    // Derive the hash functions from two base hashes by double hashing;
+    // the second one is odd so that the probes do not collapse.
+    std::uint64_t h1 = hash;
+    std::uint64_t h2 = mix64(hash) | 1U;
+
+    bool present = true;
+
+    for (std::size_t i = 0; i < num_hashes_; i++) {
+        std::uint64_t bit = (h1 + i * h2) % num_bits_;
+
+        std::uint64_t mask = std::uint64_t{1} << (bit % 64);
+
+        std::uint64_t word = words_[bit / 64].fetch_or(mask, std::memory_order_relaxed);
+        if ((word & mask) == 0) {
+            present = false;
+        }
+    }
+
+    return present;
+}
+
+void Bloom_filter::clear() noexcept
+{
+    for (std::size_t i = 0; i < num_bits_ / 64; i++) {
+        words_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
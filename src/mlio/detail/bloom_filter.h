@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// A Bloom filter of 64-bit hash values. The bits are set atomically, so
+// the filter can be shared by multiple threads without locking.
+class Bloom_filter {
+public:
+    // The number of hash functions is derived from the target false
+    // positive rate; the rate is met until the filter holds about
+    // num_bytes * 8 * ln(2)^2 / -ln(false_positive_rate) values.
+    explicit Bloom_filter(std::size_t num_bytes, double false_positive_rate);
+
+    // Adds the specified hash to the filter. Returns true if the hash
+    // was possibly added before.
+    bool insert(std::uint64_t hash) noexcept;
+
+    void clear() noexcept;
+
+private:
+    std::size_t num_bits_;
+    std::size_t num_hashes_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
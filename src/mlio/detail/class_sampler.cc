@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/class_sampler.h"
+
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "mlio/data_reader.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/random.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Class_sampler::Class_sampler(const Data_reader_params &params)
+    : default_threshold_{get_threshold(params.default_class_sample_ratio)}
+{
+    if (params.class_column.empty()) {
+        throw std::invalid_argument{
+            "The class column must be specified if class sample ratios are specified."};
+    }
+
+    for (const auto &[label, ratio] : params.class_sample_ratios) {
+        thresholds_.emplace(label, get_threshold(ratio));
+    }
+
+    if (params.sample_seed) {
+        seed_ = *params.sample_seed;
+    }
+    else {
+        std::random_device rd{};
+
+        seed_ = (std::uint64_t{rd()} << 32U) | rd();
+    }
+}
+
+std::uint64_t Class_sampler::get_threshold(float ratio)
+{
+    if (ratio < 0.0F || ratio > 1.0F) {
+        throw std::invalid_argument{"The class sample ratios must be between 0 and 1."};
+    }
+
+    if (ratio >= 1.0F) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    // 2^64 times the ratio; fits since the ratio is less than one.
+    return static_cast<std::uint64_t>(static_cast<double>(ratio) * 0x1p64);
+}
+
+std::uint64_t Class_sampler::make_key(std::uint64_t store_key, std::size_t index) noexcept
+{
+    return mix64(store_key ^ mix64(index));
+}
+
+std::uint64_t Class_sampler::make_store_key(const Data_store &store) noexcept
+{
+    return std::hash<std::string>{}(store.id());
+}
+
+bool Class_sampler::operator()(std::string_view label, std::uint64_t key) const noexcept
+{
+    std::uint64_t threshold = default_threshold_;
+
+    auto pos = thresholds_.find(label);
+    if (pos != thresholds_.end()) {
+        threshold = pos->second;
+    }
+
+    if (threshold == std::numeric_limits<std::uint64_t>::max()) {
+        return true;
+    }
+
+    return mix64(key ^ seed_) < threshold;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "mlio/config.h"
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Decides whether to select an instance based on its class label; see
+// Data_reader_params::class_sample_ratios.
+//
+// Instead of drawing a random number per call, the decision is a hash
+// of the seed and the position of the instance. This way the sampler
+// has no state to reset, and the same instances are selected in every
+// epoch regardless of how far ahead of the consumer the pipeline runs.
+class Class_sampler {
+public:
+    explicit Class_sampler(const Data_reader_params &params);
+
+    // Returns a key that identifies the instance at the specified index
+    // of the specified data store.
+    static std::uint64_t make_key(std::uint64_t store_key, std::size_t index) noexcept;
+
+    // Returns a key that identifies the specified data store.
+    static std::uint64_t make_store_key(const Data_store &store) noexcept;
+
+    bool operator()(std::string_view label, std::uint64_t key) const noexcept;
+
+private:
+    static std::uint64_t get_threshold(float ratio);
+
+    std::uint64_t seed_;
+    // The probability of each class scaled to the range of a 64-bit
+    // hash value.
+    std::map<std::string, std::uint64_t, std::less<>> thresholds_{};
+    std::uint64_t default_threshold_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
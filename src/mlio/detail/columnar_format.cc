@@ -0,0 +1,216 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/columnar_format.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// Checks whether the value is one of the currently supported data
+// types; anything else indicates a file written by a newer version or
+// a corrupt file.
+constexpr bool is_supported_data_type(std::uint64_t dt) noexcept
+{
+    return dt < static_cast<std::uint64_t>(Data_type::string) ||
+           (dt > static_cast<std::uint64_t>(Data_type::string) &&
+            dt <= static_cast<std::uint64_t>(Data_type::date));
+}
+
+class Footer_encoder {
+public:
+    void write(std::uint64_t value)
+    {
+        const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+
+        bits_.insert(bits_.end(), bytes, bytes + sizeof(value));
+    }
+
+    void write(std::string_view s)
+    {
+        write(s.size());
+
+        const auto *bytes = reinterpret_cast<const std::byte *>(s.data());
+
+        bits_.insert(bits_.end(), bytes, bytes + s.size());
+    }
+
+    std::vector<std::byte> &bits() noexcept
+    {
+        return bits_;
+    }
+
+private:
+    std::vector<std::byte> bits_{};
+};
+
+class Footer_decoder {
+public:
+    explicit Footer_decoder(Memory_span bits) noexcept : bits_{bits}
+    {}
+
+    std::uint64_t read_uint64()
+    {
+        std::uint64_t value{};
+
+        std::memcpy(&value, take(sizeof(value)).data(), sizeof(value));
+
+        return value;
+    }
+
+    // Reads a count and verifies that at least that many items of the
+    // specified size can follow; protects against huge allocations.
+    std::size_t read_count(std::size_t item_size)
+    {
+        std::uint64_t count = read_uint64();
+        if (count > bits_.size() / item_size) {
+            throw std::invalid_argument{"The footer has an invalid item count."};
+        }
+        return count;
+    }
+
+    std::string read_string()
+    {
+        std::size_t size = read_count(1);
+
+        auto chars = as_span<const char>(take(size));
+
+        return std::string(chars.data(), chars.size());
+    }
+
+    bool empty() const noexcept
+    {
+        return bits_.empty();
+    }
+
+private:
+    Memory_span take(std::size_t size)
+    {
+        if (size > bits_.size()) {
+            throw std::invalid_argument{"The footer ends unexpectedly."};
+        }
+
+        Memory_span s = bits_.first(size);
+
+        bits_ = bits_.subspan(size);
+
+        return s;
+    }
+
+    Memory_span bits_;
+};
+
+}  // namespace
+
+std::vector<std::byte> encode_columnar_footer(const Columnar_footer &footer)
+{
+    Footer_encoder enc{};
+
+    enc.write(footer.alignment);
+
+    enc.write(footer.columns.size());
+    for (const Columnar_column &column : footer.columns) {
+        enc.write(column.name);
+        enc.write(static_cast<std::uint64_t>(column.data_type));
+        enc.write(static_cast<std::uint64_t>(column.compression));
+
+        enc.write(column.shape.size());
+        for (std::size_t dim : column.shape) {
+            enc.write(dim);
+        }
+    }
+
+    enc.write(footer.blocks.size());
+    for (const Columnar_block &block : footer.blocks) {
+        enc.write(block.num_rows);
+
+        for (const Columnar_chunk &chunk : block.chunks) {
+            enc.write(chunk.offset);
+            enc.write(chunk.stored_size);
+            enc.write(chunk.size);
+        }
+    }
+
+    return std::move(enc.bits());
+}
+
+Columnar_footer decode_columnar_footer(Memory_span bits)
+{
+    Footer_decoder dec{bits};
+
+    Columnar_footer footer{};
+
+    footer.alignment = dec.read_uint64();
+
+    std::size_t num_columns = dec.read_count(sizeof(std::uint64_t) * 4);
+
+    footer.columns.resize(num_columns);
+    for (Columnar_column &column : footer.columns) {
+        column.name = dec.read_string();
+
+        std::uint64_t dt = dec.read_uint64();
+        if (!is_supported_data_type(dt)) {
+            throw std::invalid_argument{"The footer has a column of an unsupported data type."};
+        }
+        column.data_type = static_cast<Data_type>(dt);
+
+        std::uint64_t compression = dec.read_uint64();
+        if (compression > static_cast<std::uint64_t>(Columnar_compression::zstd)) {
+            throw std::invalid_argument{"The footer has a column of an unsupported compression."};
+        }
+        column.compression = static_cast<Columnar_compression>(compression);
+
+        std::size_t num_dims = dec.read_count(sizeof(std::uint64_t));
+
+        column.shape.resize(num_dims);
+        for (std::size_t &dim : column.shape) {
+            dim = dec.read_uint64();
+        }
+    }
+
+    std::size_t chunk_size = sizeof(std::uint64_t) * 3;
+
+    std::size_t num_blocks = dec.read_count(sizeof(std::uint64_t) + num_columns * chunk_size);
+
+    footer.blocks.resize(num_blocks);
+    for (Columnar_block &block : footer.blocks) {
+        block.num_rows = dec.read_uint64();
+
+        block.chunks.resize(num_columns);
+        for (Columnar_chunk &chunk : block.chunks) {
+            chunk.offset = dec.read_uint64();
+            chunk.stored_size = dec.read_uint64();
+            chunk.size = dec.read_uint64();
+        }
+    }
+
+    if (!dec.empty()) {
+        throw std::invalid_argument{"The footer has trailing data."};
+    }
+
+    return footer;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mlio/columnar_writer.h"
+#include "mlio/data_type.h"
+#include "mlio/span.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// A columnar file starts with the magic number, padded to the alignment,
+// followed by the blocks. Each block holds the rows of one written
+// example with one contiguous and aligned chunk per column. The file
+// ends with the footer, the size of the footer as a 64-bit integer, and
+// the magic number again. Like the instance cache, all integers and the
+// values themselves are stored in the host byte order.
+inline constexpr std::array<char, 8> columnar_magic{'M', 'L', 'I', 'O', 'C', 'O', 'L', '1'};
+
+inline constexpr std::size_t columnar_trailer_size = sizeof(std::uint64_t) + columnar_magic.size();
+
+struct Columnar_column {
+    std::string name{};
+    Data_type data_type{};
+    // The shape of a single row; the batch dimension is not included.
+    Size_vector shape{};
+    Columnar_compression compression{};
+};
+
+struct Columnar_chunk {
+    std::uint64_t offset{};
+    // The number of bytes stored in the file.
+    std::uint64_t stored_size{};
+    // The number of bytes after decompression.
+    std::uint64_t size{};
+};
+
+struct Columnar_block {
+    std::uint64_t num_rows{};
+    std::vector<Columnar_chunk> chunks{};
+};
+
+struct Columnar_footer {
+    std::uint64_t alignment{};
+    std::vector<Columnar_column> columns{};
+    std::vector<Columnar_block> blocks{};
+};
+
+std::vector<std::byte> encode_columnar_footer(const Columnar_footer &footer);
+
+// Throws std::invalid_argument if the footer is malformed.
+Columnar_footer decode_columnar_footer(Memory_span bits);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
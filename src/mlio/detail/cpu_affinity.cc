@@ -0,0 +1,173 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/cpu_affinity.h"
+
+#include "mlio/config.h"
+#include "mlio/not_supported_error.h"
+
+#if defined(MLIO_PLATFORM_LINUX)
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mlio/util/number.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+std::size_t parse_cpu_id(std::string_view s, const std::string &path)
+{
+    std::uint64_t id{};
+    if (try_parse_int(s, id) != Parse_result::ok) {
+        throw std::runtime_error{fmt::format("The CPU list in '{0}' cannot be parsed.", path)};
+    }
+    return id;
+}
+
+}  // namespace
+
+bool supports_cpu_affinity() noexcept
+{
+    return true;
+}
+
+std::vector<std::size_t> get_numa_node_cpus(std::size_t node)
+{
+    std::string path = fmt::format("/sys/devices/system/node/node{0}/cpulist", node);
+
+    std::ifstream file{path};
+    if (!file) {
+        throw std::invalid_argument{
+            fmt::format("The NUMA node {0} does not exist on this machine.", node)};
+    }
+
+    std::string list{};
+    std::getline(file, list);
+
+    // The list has the form "0-3,8-11".
+    std::vector<std::size_t> cpus{};
+
+    std::string_view remaining = list;
+    while (!remaining.empty()) {
+        std::size_t pos = remaining.find(',');
+
+        std::string_view range = remaining.substr(0, pos);
+
+        std::size_t dash = range.find('-');
+        if (dash == std::string_view::npos) {
+            cpus.emplace_back(parse_cpu_id(range, path));
+        }
+        else {
+            std::size_t first = parse_cpu_id(range.substr(0, dash), path);
+            std::size_t last = parse_cpu_id(range.substr(dash + 1), path);
+
+            for (std::size_t id = first; id <= last; id++) {
+                cpus.emplace_back(id);
+            }
+        }
+
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        remaining = remaining.substr(pos + 1);
+    }
+
+    if (cpus.empty()) {
+        throw std::invalid_argument{
+            fmt::format("The NUMA node {0} has no processor cores.", node)};
+    }
+
+    return cpus;
+}
+
+bool set_thread_affinity(const std::vector<std::size_t> &cpus) noexcept
+{
+    ::cpu_set_t set{};
+    CPU_ZERO(&set);
+
+    for (std::size_t id : cpus) {
+        if (id >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(id, &set);
+    }
+
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool set_thread_numa_node(std::size_t node) noexcept
+{
+    // Same as MPOL_PREFERRED in <numaif.h>; we call set_mempolicy
+    // directly to avoid a dependency on libnuma.
+    constexpr int mpol_preferred = 1;
+
+    constexpr std::size_t max_num_nodes = sizeof(unsigned long) * 8;
+
+    if (node >= max_num_nodes) {
+        return false;
+    }
+
+    unsigned long mask = 1UL << node;
+
+    return ::syscall(SYS_set_mempolicy, mpol_preferred, &mask, max_num_nodes + 1) == 0;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+bool supports_cpu_affinity() noexcept
+{
+    return false;
+}
+
+std::vector<std::size_t> get_numa_node_cpus(std::size_t)
+{
+    throw Not_supported_error{"NUMA nodes are not supported on this platform."};
+}
+
+bool set_thread_affinity(const std::vector<std::size_t> &) noexcept
+{
+    return false;
+}
+
+bool set_thread_numa_node(std::size_t) noexcept
+{
+    return false;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
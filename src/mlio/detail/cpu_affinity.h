@@ -0,0 +1,43 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Returns a boolean value indicating whether threads can be pinned to
+/// processor cores on this platform.
+bool supports_cpu_affinity() noexcept;
+
+/// Returns the ids of the processor cores of the specified NUMA node.
+std::vector<std::size_t> get_numa_node_cpus(std::size_t node);
+
+/// Pins the calling thread to the specified processor cores. Returns
+/// false if the affinity of the thread cannot be set.
+bool set_thread_affinity(const std::vector<std::size_t> &cpus) noexcept;
+
+/// Makes the memory allocated by the calling thread come from the
+/// specified NUMA node whenever possible. Returns false if the memory
+/// policy of the thread cannot be set.
+bool set_thread_numa_node(std::size_t node) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
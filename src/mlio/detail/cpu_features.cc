@@ -0,0 +1,64 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/cpu_features.h"
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+Cpu_features detect_cpu_features() noexcept
+{
+    Cpu_features features{};
+
+#ifdef MLIO_X86_DISPATCH
+    __builtin_cpu_init();
+
+    features.ssse3 = __builtin_cpu_supports("ssse3") != 0;
+    features.sse42 = __builtin_cpu_supports("sse4.2") != 0;
+    features.avx2 = __builtin_cpu_supports("avx2") != 0;
+    features.avx512bw = __builtin_cpu_supports("avx512bw") != 0;
+#ifdef __clang__
+    features.f16c = features.avx2;
+#else
+    features.f16c = __builtin_cpu_supports("f16c") != 0;
+#endif
+#elif defined(__aarch64__) && defined(__linux__)
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+    features.sve = (::getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#endif
+
+    return features;
+}
+
+}  // namespace
+
+const Cpu_features &cpu_features() noexcept
+{
+    static const Cpu_features features = detect_cpu_features();
+
+    return features;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
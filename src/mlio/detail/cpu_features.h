@@ -0,0 +1,49 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "mlio/config.h"
+
+// The x86 kernels that are dispatched at runtime are compiled with the
+// target attribute, which requires GCC or Clang.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MLIO_X86_DISPATCH
+#define MLIO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Holds the instruction set extensions of the processor that the hot
+// kernels can use in addition to the ones the library is compiled for.
+// NEON is part of the baseline of AArch64 and is always used there.
+struct Cpu_features {
+    bool ssse3{};
+    bool sse42{};
+    bool avx2{};
+    bool f16c{};
+    bool avx512bw{};
+    bool sve{};
+};
+
+// Returns the features of the processor, detected once at first call.
+MLIO_HIDDEN
+const Cpu_features &cpu_features() noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/crc32c.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "mlio/detail/cpu_features.h"
+
+#if defined(MLIO_X86_DISPATCH)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+using Crc32c_fn = std::uint32_t (*)(std::uint32_t, const std::byte *, std::size_t) noexcept;
+
+// The reversed Castagnoli polynomial.
+constexpr std::uint32_t crc32c_polynomial = 0x82F63B78U;
+
+// The slicing-by-8 tables; the first one is the classic byte-wise table
+// and each further one advances the checksum by another zero byte.
+using Crc32c_tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+Crc32c_tables make_crc32c_tables() noexcept
+{
+    Crc32c_tables tables{};
+
+    for (std::uint32_t i = 0; i < 256; i++) {
+        std::uint32_t crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1U) ^ ((crc & 1U) != 0 ? crc32c_polynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+
+    for (std::size_t t = 1; t < tables.size(); t++) {
+        for (std::size_t i = 0; i < 256; i++) {
+            std::uint32_t crc = tables[t - 1][i];
+
+            tables[t][i] = (crc >> 8U) ^ tables[0][crc & 0xFFU];
+        }
+    }
+
+    return tables;
+}
+
+inline std::uint64_t load_uint64(const std::byte *pos) noexcept
+{
+    std::uint64_t value{};
+    std::memcpy(&value, pos, sizeof(value));
+    return value;
+}
+
+std::uint32_t crc32c_sw(std::uint32_t crc, const std::byte *pos, std::size_t size) noexcept
+{
+    static const Crc32c_tables tables = make_crc32c_tables();
+
+    for (; size >= 8; pos += 8, size -= 8) {
+        // The tables assume the little-endian byte order of the word.
+        std::uint64_t word{};
+        for (std::size_t i = 0; i < 8; i++) {
+            word |= std::uint64_t{std::to_integer<std::uint8_t>(pos[i])} << (8 * i);
+        }
+
+        word ^= crc;
+
+        crc = tables[7][word & 0xFFU] ^ tables[6][(word >> 8U) & 0xFFU] ^
+              tables[5][(word >> 16U) & 0xFFU] ^ tables[4][(word >> 24U) & 0xFFU] ^
+              tables[3][(word >> 32U) & 0xFFU] ^ tables[2][(word >> 40U) & 0xFFU] ^
+              tables[1][(word >> 48U) & 0xFFU] ^ tables[0][word >> 56U];
+    }
+
+    for (; size > 0; pos++, size--) {
+        crc = (crc >> 8U) ^ tables[0][(crc ^ std::to_integer<std::uint32_t>(*pos)) & 0xFFU];
+    }
+
+    return crc;
+}
+
+#if defined(MLIO_X86_DISPATCH)
+
+MLIO_TARGET("sse4.2")
+std::uint32_t crc32c_sse42(std::uint32_t crc, const std::byte *pos, std::size_t size) noexcept
+{
+#if defined(__x86_64__)
+    std::uint64_t crc64 = crc;
+    for (; size >= 8; pos += 8, size -= 8) {
+        crc64 = _mm_crc32_u64(crc64, load_uint64(pos));
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+#endif
+
+    for (; size > 0; pos++, size--) {
+        crc = _mm_crc32_u8(crc, std::to_integer<std::uint8_t>(*pos));
+    }
+
+    return crc;
+}
+
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+std::uint32_t crc32c_arm(std::uint32_t crc, const std::byte *pos, std::size_t size) noexcept
+{
+    for (; size >= 8; pos += 8, size -= 8) {
+        crc = __crc32cd(crc, load_uint64(pos));
+    }
+
+    for (; size > 0; pos++, size--) {
+        crc = __crc32cb(crc, std::to_integer<std::uint8_t>(*pos));
+    }
+
+    return crc;
+}
+
+#endif
+
+// Picks the CRC32 instructions if the processor supports them; on ARM
+// they are only used if the library is compiled for them.
+Crc32c_fn select_crc32c() noexcept
+{
+#if defined(MLIO_X86_DISPATCH)
+    if (cpu_features().sse42) {
+        return crc32c_sse42;
+    }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    return crc32c_arm;
+#endif
+
+    return crc32c_sw;
+}
+
+}  // namespace
+
+std::uint32_t crc32c(std::uint32_t crc, Memory_span bits) noexcept
+{
+    static const Crc32c_fn crc32c_impl = select_crc32c();
+
+    return ~crc32c_impl(~crc, bits.data(), bits.size());
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mlio/config.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Extends the CRC32C (Castagnoli) checksum @p crc with the specified
+// bits. Uses the CRC32 instructions of SSE4.2 or ARMv8 when available.
+MLIO_HIDDEN
+std::uint32_t crc32c(std::uint32_t crc, Memory_span bits) noexcept;
+
+// Returns the masked CRC32C checksum of the specified bits as stored in
+// TFRecord files. The mask keeps checksums of data that holds checksums
+// itself from being trivially correlated.
+inline std::uint32_t masked_crc32c(Memory_span bits) noexcept
+{
+    std::uint32_t crc = crc32c(0, bits);
+
+    return ((crc >> 15U) | (crc << 17U)) + 0xA282EAD8U;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
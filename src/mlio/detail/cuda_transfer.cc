@@ -0,0 +1,336 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/cuda_transfer.h"
+
+#ifdef MLIO_BUILD_CUDA
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <cuda_runtime_api.h>
+#include <fmt/format.h>
+
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/mlio_error.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The size of each of the two staging buffers.
+constexpr std::size_t staging_buffer_size = 0x40'0000;  // 4 MiB
+
+void check_cuda(::cudaError_t err, const char *msg)
+{
+    if (err != ::cudaSuccess) {
+        throw Mlio_error{fmt::format("{0} The CUDA error is '{1}'.", msg, ::cudaGetErrorString(err))};
+    }
+}
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+// Represents a memory region allocated on a CUDA device.
+class Cuda_array final : public Device_array {
+public:
+    explicit Cuda_array(Device device, Data_type dt, std::size_t size)
+        : device_{device}, data_type_{dt}, size_{size}
+    {
+        if (size_ > 0) {
+            check_cuda(::cudaMalloc(&data_, size_bytes()),
+                       "The device memory cannot be allocated.");
+        }
+    }
+
+    Cuda_array(const Cuda_array &) = delete;
+
+    Cuda_array &operator=(const Cuda_array &) = delete;
+
+    Cuda_array(Cuda_array &&) = delete;
+
+    Cuda_array &operator=(Cuda_array &&) = delete;
+
+    ~Cuda_array() final
+    {
+        if (data_ != nullptr) {
+            ::cudaFree(data_);
+        }
+    }
+
+    std::unique_ptr<Device_array> clone() const final
+    {
+        auto cpy = std::make_unique<Cuda_array>(device_, data_type_, size_);
+
+        if (size_ > 0) {
+            check_cuda(::cudaMemcpy(cpy->data_, data_, size_bytes(), ::cudaMemcpyDeviceToDevice),
+                       "The device array cannot be copied.");
+        }
+
+        return cpy;
+    }
+
+    void *data() noexcept final
+    {
+        return data_;
+    }
+
+    const void *data() const noexcept final
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept final
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept final
+    {
+        return size_ == 0;
+    }
+
+    Data_type data_type() const noexcept final
+    {
+        return data_type_;
+    }
+
+    Device device() const noexcept final
+    {
+        return device_;
+    }
+
+    std::size_t size_bytes() const noexcept
+    {
+        return size_ * dispatch<Element_size_op>(data_type_);
+    }
+
+private:
+    Device device_;
+    Data_type data_type_;
+    std::size_t size_;
+    void *data_{};
+};
+
+}  // namespace
+
+Cuda_transfer::Cuda_transfer(Device device) : device_{device}
+{
+    if (device_.kind() != Device_kind::cuda()) {
+        throw Not_supported_error{"The device is not a CUDA device."};
+    }
+
+    check_cuda(::cudaSetDevice(static_cast<int>(device_.id())),
+               "The CUDA device cannot be selected.");
+
+    try {
+        check_cuda(::cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking),
+                   "The CUDA stream cannot be created.");
+
+        for (Staging_buffer &buffer : buffers_) {
+            check_cuda(::cudaMallocHost(&buffer.data, staging_buffer_size),
+                       "The staging buffer cannot be allocated.");
+
+            check_cuda(::cudaEventCreateWithFlags(&buffer.event, cudaEventDisableTiming),
+                       "The CUDA event cannot be created.");
+        }
+    }
+    catch (...) {
+        release();
+
+        throw;
+    }
+}
+
+Cuda_transfer::~Cuda_transfer()
+{
+    release();
+}
+
+void Cuda_transfer::release() noexcept
+{
+    if (stream_ != nullptr) {
+        ::cudaStreamSynchronize(stream_);
+    }
+
+    for (Staging_buffer &buffer : buffers_) {
+        if (buffer.event != nullptr) {
+            ::cudaEventDestroy(buffer.event);
+
+            buffer.event = nullptr;
+        }
+        if (buffer.data != nullptr) {
+            ::cudaFreeHost(buffer.data);
+
+            buffer.data = nullptr;
+        }
+    }
+
+    if (stream_ != nullptr) {
+        ::cudaStreamDestroy(stream_);
+
+        stream_ = nullptr;
+    }
+}
+
+Intrusive_ptr<Example> Cuda_transfer::copy(const Example &example)
+{
+    // The examples are copied on the threads of the reader, which do
+    // not necessarily have the device selected.
+    check_cuda(::cudaSetDevice(static_cast<int>(device_.id())),
+               "The CUDA device cannot be selected.");
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.reserve(example.features().size());
+
+    for (const Intrusive_ptr<Tensor> &tensor : example.features()) {
+        tensors.emplace_back(copy(*tensor));
+    }
+
+    check_cuda(::cudaStreamSynchronize(stream_), "The copy to the CUDA device has failed.");
+
+    auto cpy = make_intrusive<Example>(wrap_intrusive(&example.schema()), std::move(tensors));
+
+    cpy->padding = example.padding;
+
+    return cpy;
+}
+
+Intrusive_ptr<Tensor> Cuda_transfer::copy(Tensor &tensor)
+{
+    auto *dense = dynamic_cast<Dense_tensor *>(&tensor);
+    if (dense == nullptr || dense->data_type() == Data_type::string ||
+        dense->data().device().kind() != Device_kind::cpu()) {
+
+        return wrap_intrusive(&tensor);
+    }
+
+    auto arr = std::make_unique<Cuda_array>(device_, dense->data_type(), dense->data().size());
+
+    copy_to_device(dense->data().data(), arr->data(), arr->size_bytes());
+
+    return make_intrusive<Dense_tensor>(dense->shape(), std::move(arr), dense->strides());
+}
+
+void Cuda_transfer::copy_to_device(const void *src, void *dst, std::size_t size)
+{
+    auto src_pos = static_cast<const std::byte *>(src);
+    auto dst_pos = static_cast<std::byte *>(dst);
+
+    while (size > 0) {
+        Staging_buffer &buffer = buffers_[buffer_idx_];
+
+        // Wait for the previous copy from this buffer; meanwhile the
+        // other buffer is being copied to the device.
+        check_cuda(::cudaEventSynchronize(buffer.event), "The copy to the CUDA device has failed.");
+
+        std::size_t chunk_size = std::min(size, staging_buffer_size);
+
+        std::memcpy(buffer.data, src_pos, chunk_size);
+
+        check_cuda(::cudaMemcpyAsync(
+                       dst_pos, buffer.data, chunk_size, ::cudaMemcpyHostToDevice, stream_),
+                   "The copy to the CUDA device cannot be issued.");
+
+        check_cuda(::cudaEventRecord(buffer.event, stream_),
+                   "The copy to the CUDA device cannot be issued.");
+
+        buffer_idx_ ^= 1;
+
+        src_pos += chunk_size;
+        dst_pos += chunk_size;
+
+        size -= chunk_size;
+    }
+}
+
+std::optional<std::string> get_cuda_device_pci_bus_id(std::size_t device_id)
+{
+    std::array<char, 32> bus_id{};
+
+    ::cudaError_t err = ::cudaDeviceGetPCIBusId(
+        bus_id.data(), static_cast<int>(bus_id.size()), static_cast<int>(device_id));
+    if (err != ::cudaSuccess) {
+        return {};
+    }
+
+    return std::string{bus_id.data()};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+Cuda_transfer::Cuda_transfer(Device device) : device_{device}
+{
+    throw Not_supported_error{"MLIO was not built with CUDA support."};
+}
+
+Cuda_transfer::~Cuda_transfer() = default;
+
+Intrusive_ptr<Example> Cuda_transfer::copy(const Example &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<Tensor> Cuda_transfer::copy(Tensor &)
+{
+    return nullptr;
+}
+
+void Cuda_transfer::copy_to_device(const void *, void *, std::size_t)
+{}
+
+void Cuda_transfer::release() noexcept
+{}
+
+#pragma GCC diagnostic pop
+
+std::optional<std::string> get_cuda_device_pci_bus_id(std::size_t)
+{
+    return {};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
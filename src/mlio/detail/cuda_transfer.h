@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "mlio/device.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+
+struct CUevent_st;
+struct CUstream_st;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Copies the dense tensors of examples to a CUDA device.
+//
+// The tensors are staged in two page-locked host buffers that are used
+// in turns: while the DMA engine copies one buffer to the device on a
+// dedicated stream, the next part of the tensor is copied into the
+// other. The stream is synchronized before an example is returned, so
+// the returned tensors are ready to be consumed on any stream. Sparse
+// and string tensors are returned as is.
+//
+// Not thread-safe; examples must be copied one at a time.
+class Cuda_transfer {
+public:
+    explicit Cuda_transfer(Device device);
+
+    Cuda_transfer(const Cuda_transfer &) = delete;
+
+    Cuda_transfer &operator=(const Cuda_transfer &) = delete;
+
+    Cuda_transfer(Cuda_transfer &&) = delete;
+
+    Cuda_transfer &operator=(Cuda_transfer &&) = delete;
+
+    ~Cuda_transfer();
+
+    Intrusive_ptr<Example> copy(const Example &example);
+
+private:
+    struct Staging_buffer {
+        void *data{};
+        // Recorded once the copy from the buffer has been issued.
+        ::CUevent_st *event{};
+    };
+
+    Intrusive_ptr<Tensor> copy(Tensor &tensor);
+
+    void copy_to_device(const void *src, void *dst, std::size_t size);
+
+    void release() noexcept;
+
+    Device device_;
+    ::CUstream_st *stream_{};
+    std::array<Staging_buffer, 2> buffers_{};
+    std::size_t buffer_idx_{};
+};
+
+// Returns the PCI bus id of the specified CUDA device, or std::nullopt if
+// it cannot be determined.
+std::optional<std::string> get_cuda_device_pci_bus_id(std::size_t device_id);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mlio/fwd.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Specifies the kind of problem found in a data instance.
+enum class Decode_warning_kind {
+    /// A field cannot be parsed as the data type of its column.
+    parse_error,
+    /// The instance has fewer or more fields than expected.
+    field_count_mismatch,
+    /// A field exceeds the maximum field length.
+    long_field,
+    /// The instance is not a valid record.
+    corrupt_record,
+    /// A feature does not match its attribute in the schema.
+    schema_mismatch,
+    /// A value does not fit into the narrowed data type of its column
+    /// or attribute.
+    overflow,
+};
+
+inline constexpr std::size_t num_decode_warning_kinds = 6;
+
+/// Describes a problem found in a data instance while decoding.
+struct Decode_warning {
+    static constexpr std::size_t no_column = std::numeric_limits<std::size_t>::max();
+
+    Decode_warning_kind kind;
+    /// The instance must outlive the log; in practice the log is
+    /// reported before the decoded batch is released.
+    const Instance *instance;
+    /// The index of the column or attribute if the problem is specific
+    /// to one.
+    std::size_t column_idx = no_column;
+    /// Formats the warning message. Empty if the warning should only be
+    /// counted; the message is formatted outside of the decode loop and
+    /// only if it is actually logged.
+    std::function<std::string()> format_message{};
+};
+
+/// Collects the warnings of the decode tasks of a batch.
+class Decode_warning_log {
+public:
+    void add(Decode_warning &&warning)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        warnings_.emplace_back(std::move(warning));
+    }
+
+    std::vector<Decode_warning> &warnings() noexcept
+    {
+        return warnings_;
+    }
+
+private:
+    std::mutex mutex_{};
+    std::vector<Decode_warning> warnings_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/example_codec.h"
+
+#include <memory>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_type.h"
+#include "mlio/device.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+enum class Tensor_kind : std::uint64_t { dense, coo, csr };
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+void put_array(Word_writer &writer, std::vector<Memory_span> &buffers, Device_array_view arr)
+{
+    if (arr.device().kind() != Device_kind::cpu()) {
+        throw Not_supported_error{"Only tensors in host memory can be serialized."};
+    }
+
+    std::size_t size = arr.size() * dispatch<Element_size_op>(arr.data_type());
+
+    writer.put(static_cast<std::uint64_t>(arr.data_type()));
+    writer.put(arr.size());
+
+    buffers.emplace_back(static_cast<const std::byte *>(arr.data()), size);
+}
+
+std::unique_ptr<Device_array>
+get_array(Word_reader &reader, const std::function<void(void *, std::size_t)> &read_buffer)
+{
+    std::uint64_t value = reader.get();
+    // The strings cannot be sent as raw buffers.
+    if (value == static_cast<std::uint64_t>(Data_type::string) ||
+        value > static_cast<std::uint64_t>(Data_type::date)) {
+        Word_reader::throw_corrupt();
+    }
+
+    auto dt = static_cast<Data_type>(value);
+
+    std::size_t size = reader.get();
+
+    std::unique_ptr<Device_array> arr = make_cpu_array(dt, size);
+
+    read_buffer(arr->data(), size * dispatch<Element_size_op>(dt));
+
+    return arr;
+}
+
+}  // namespace
+
+std::vector<std::uint64_t> encode_schema(const Schema &schema)
+{
+    Word_writer writer{};
+
+    writer.put(schema.attributes().size());
+
+    for (const Attribute &attr : schema.attributes()) {
+        writer.put(attr.name());
+        writer.put(static_cast<std::uint64_t>(attr.data_type()));
+        writer.put(static_cast<std::uint64_t>(attr.sparse()));
+        writer.put(attr.shape().size());
+
+        for (std::size_t dim : attr.shape()) {
+            writer.put(dim);
+        }
+    }
+
+    return std::move(writer.words());
+}
+
+Intrusive_ptr<const Schema> decode_schema(const std::byte *data, std::size_t size)
+{
+    Word_reader reader{data, size};
+
+    std::vector<Attribute> attrs{};
+
+    std::size_t num_attrs = reader.get();
+    for (std::size_t i = 0; i < num_attrs; i++) {
+        std::string name = reader.get_string();
+
+        auto dt = static_cast<Data_type>(reader.get());
+
+        bool sparse = reader.get() != 0;
+
+        Size_vector shape(reader.get());
+        for (std::size_t &dim : shape) {
+            dim = reader.get();
+        }
+
+        attrs.emplace_back(std::move(name), dt, std::move(shape), Ssize_vector{}, sparse);
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+bool is_row_major(const Dense_tensor &tensor) noexcept
+{
+    const Size_vector &shape = tensor.shape();
+    const Ssize_vector &strides = tensor.strides();
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = shape.size(); i > 0; i--) {
+        if (shape[i - 1] > 1 && strides[i - 1] != stride) {
+            return false;
+        }
+        stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+    }
+    return true;
+}
+
+Encoded_example encode_example(const Example &example)
+{
+    Encoded_example encoded{};
+
+    Word_writer writer{};
+
+    const std::vector<Intrusive_ptr<Tensor>> &features = example.features();
+
+    writer.put(features.size());
+    writer.put(example.padding);
+
+    for (std::size_t i = 0; i < features.size(); i++) {
+        const Tensor &tensor = *features[i];
+
+        if (tensor.data_type() == Data_type::string) {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be serialized as it has the string data type.",
+                example.schema().attributes()[i].name())};
+        }
+
+        if (auto *dense = dynamic_cast<const Dense_tensor *>(&tensor); dense != nullptr) {
+            if (!is_row_major(*dense)) {
+                throw Not_supported_error{fmt::format(
+                    "The feature '{0}' cannot be serialized as it is not a contiguous dense tensor.",
+                    example.schema().attributes()[i].name())};
+            }
+
+            writer.put(static_cast<std::uint64_t>(Tensor_kind::dense));
+        }
+        else if (dynamic_cast<const Coo_tensor *>(&tensor) != nullptr) {
+            writer.put(static_cast<std::uint64_t>(Tensor_kind::coo));
+        }
+        else if (dynamic_cast<const Csr_tensor *>(&tensor) != nullptr) {
+            writer.put(static_cast<std::uint64_t>(Tensor_kind::csr));
+        }
+        else {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be serialized as its tensor type is not supported.",
+                example.schema().attributes()[i].name())};
+        }
+
+        writer.put(tensor.shape().size());
+        for (std::size_t dim : tensor.shape()) {
+            writer.put(dim);
+        }
+
+        if (auto *dense = dynamic_cast<const Dense_tensor *>(&tensor); dense != nullptr) {
+            put_array(writer, encoded.buffers, dense->data());
+        }
+        else if (auto *coo = dynamic_cast<const Coo_tensor *>(&tensor); coo != nullptr) {
+            put_array(writer, encoded.buffers, coo->data());
+
+            for (std::size_t dim = 0; dim < tensor.shape().size(); dim++) {
+                put_array(writer, encoded.buffers, coo->indices(dim));
+            }
+        }
+        else {
+            auto &csr = static_cast<const Csr_tensor &>(tensor);
+
+            put_array(writer, encoded.buffers, csr.data());
+            put_array(writer, encoded.buffers, csr.indices());
+            put_array(writer, encoded.buffers, csr.indptr());
+        }
+    }
+
+    encoded.words = std::move(writer.words());
+
+    return encoded;
+}
+
+Intrusive_ptr<Example> decode_example(Intrusive_ptr<const Schema> schema,
+                                      Word_reader &reader,
+                                      const std::function<void(void *, std::size_t)> &read_buffer)
+{
+    if (reader.get() != schema->attributes().size()) {
+        Word_reader::throw_corrupt();
+    }
+
+    std::size_t padding = reader.get();
+
+    std::vector<Intrusive_ptr<Tensor>> features{};
+    features.reserve(schema->attributes().size());
+
+    for (std::size_t i = 0; i < schema->attributes().size(); i++) {
+        auto kind = static_cast<Tensor_kind>(reader.get());
+
+        Size_vector shape(reader.get());
+        for (std::size_t &dim : shape) {
+            dim = reader.get();
+        }
+
+        std::unique_ptr<Device_array> data = get_array(reader, read_buffer);
+
+        switch (kind) {
+        case Tensor_kind::dense:
+            features.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(data)));
+            break;
+
+        case Tensor_kind::coo: {
+            std::vector<std::unique_ptr<Device_array>> coords(shape.size());
+            for (auto &coord : coords) {
+                coord = get_array(reader, read_buffer);
+            }
+
+            features.emplace_back(
+                make_intrusive<Coo_tensor>(std::move(shape), std::move(data), std::move(coords)));
+            break;
+        }
+
+        case Tensor_kind::csr: {
+            std::unique_ptr<Device_array> indices = get_array(reader, read_buffer);
+            std::unique_ptr<Device_array> indptr = get_array(reader, read_buffer);
+
+            features.emplace_back(make_intrusive<Csr_tensor>(
+                std::move(shape), std::move(data), std::move(indices), std::move(indptr)));
+            break;
+        }
+
+        default:
+            Word_reader::throw_corrupt();
+        }
+    }
+
+    auto example = make_intrusive<Example>(std::move(schema), std::move(features));
+
+    example->padding = padding;
+
+    return example;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Schemas and examples are serialized as sequences of 64-bit words in
+// host byte order followed by the raw tensor buffers; the peers must
+// therefore have the same byte order.
+class Word_writer {
+public:
+    void put(std::uint64_t value)
+    {
+        words_.emplace_back(value);
+    }
+
+    void put(std::string_view s)
+    {
+        put(s.size());
+
+        std::size_t pos = words_.size();
+
+        words_.resize(pos + (s.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+
+        std::memcpy(words_.data() + pos, s.data(), s.size());
+    }
+
+    const std::vector<std::uint64_t> &words() const noexcept
+    {
+        return words_;
+    }
+
+    std::vector<std::uint64_t> &words() noexcept
+    {
+        return words_;
+    }
+
+private:
+    std::vector<std::uint64_t> words_{};
+};
+
+class Word_reader {
+public:
+    explicit Word_reader(const std::byte *data, std::size_t size) noexcept
+        : pos_{reinterpret_cast<const std::uint64_t *>(data)}
+        , end_{pos_ + size / sizeof(std::uint64_t)}
+    {}
+
+    std::uint64_t get()
+    {
+        if (pos_ == end_) {
+            throw_corrupt();
+        }
+        return *pos_++;
+    }
+
+    std::string get_string()
+    {
+        std::size_t size = get();
+
+        std::size_t num_words = (size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+        if (num_words > static_cast<std::size_t>(end_ - pos_)) {
+            throw_corrupt();
+        }
+
+        std::string s(reinterpret_cast<const char *>(pos_), size);
+
+        pos_ += num_words;
+
+        return s;
+    }
+
+    [[noreturn]] static void throw_corrupt()
+    {
+        throw Data_reader_error{"The serialized example or schema is corrupt."};
+    }
+
+private:
+    const std::uint64_t *pos_;
+    const std::uint64_t *end_;
+};
+
+std::vector<std::uint64_t> encode_schema(const Schema &schema);
+
+Intrusive_ptr<const Schema> decode_schema(const std::byte *data, std::size_t size);
+
+bool is_row_major(const Dense_tensor &tensor) noexcept;
+
+// Represents an example as a list of words describing its tensors and
+// the buffers of the tensors, which are referenced rather than copied.
+struct Encoded_example {
+    std::vector<std::uint64_t> words{};
+    std::vector<Memory_span> buffers{};
+};
+
+// Supports dense, COO, and CSR tensors of numeric data types in host
+// memory.
+Encoded_example encode_example(const Example &example);
+
+// Reconstructs an example; read_buffer is called to fill each tensor
+// buffer in the order of Encoded_example::buffers.
+Intrusive_ptr<Example> decode_example(Intrusive_ptr<const Schema> schema,
+                                      Word_reader &reader,
+                                      const std::function<void(void *, std::size_t)> &read_buffer);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/half.h"
+
+#include "mlio/detail/cpu_features.h"
+
+#if defined(MLIO_X86_DISPATCH) && !defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+#if defined(MLIO_X86_DISPATCH) || defined(__F16C__)
+
+#ifdef MLIO_X86_DISPATCH
+MLIO_TARGET("avx,f16c")
+#endif
+std::size_t float_to_half_f16c(const float *src, std::uint16_t *dst, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256 values = _mm256_loadu_ps(src + i);
+
+        __m128i halves = _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), halves);
+    }
+    return i;
+}
+
+#endif
+
+}  // namespace
+
+void float_to_half(const float *src, std::uint16_t *dst, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(__F16C__)
+    i = float_to_half_f16c(src, dst, size);
+#elif defined(MLIO_X86_DISPATCH)
+    if (cpu_features().f16c) {
+        i = float_to_half_f16c(src, dst, size);
+    }
+#endif
+
+    for (; i < size; i++) {
+        dst[i] = float_to_half(src[i]);
+    }
+}
+
+void float_to_bfloat16(const float *src, std::uint16_t *dst, std::size_t size) noexcept
+{
+    // The loop is branch-free except for the NaN check, which the
+    // compiler turns into a blend; it vectorizes without intrinsics.
+    for (std::size_t i = 0; i < size; i++) {
+        dst[i] = float_to_bfloat16(src[i]);
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Converts a single-precision value to half-precision rounding to the
+// nearest even value.
+inline std::uint16_t float_to_half(float value) noexcept
+{
+#ifdef __F16C__
+    return static_cast<std::uint16_t>(_cvtss_sh(value, 0));
+#else
+    constexpr std::uint32_t f32_infinity = 255U << 23;
+    constexpr std::uint32_t f16_max = (127U + 16) << 23;
+    constexpr std::uint32_t f16_min_normal = 113U << 23;
+    constexpr std::uint32_t denorm_magic = ((127U - 15) + (23 - 10) + 1) << 23;
+
+    std::uint32_t bits{};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    std::uint32_t sign = bits & 0x8000'0000U;
+
+    bits ^= sign;
+
+    std::uint32_t half{};
+    if (bits >= f16_max) {
+        // Infinity or NaN.
+        half = bits > f32_infinity ? 0x7E00U : 0x7C00U;
+    }
+    else if (bits < f16_min_normal) {
+        // Subnormal or zero; let the FPU do the rounding.
+        float magic{};
+        std::memcpy(&magic, &denorm_magic, sizeof(magic));
+
+        float f{};
+        std::memcpy(&f, &bits, sizeof(f));
+        f += magic;
+        std::memcpy(&bits, &f, sizeof(bits));
+
+        half = bits - denorm_magic;
+    }
+    else {
+        std::uint32_t mantissa_odd = (bits >> 13) & 1U;
+
+        // Rebias the exponent and round.
+        bits += ((15U - 127U) << 23) + 0xFFFU + mantissa_odd;
+
+        half = bits >> 13;
+    }
+
+    return static_cast<std::uint16_t>(half | (sign >> 16));
+#endif
+}
+
+// Converts a half-precision value to single-precision; the conversion
+// is exact.
+inline float half_to_float(std::uint16_t value) noexcept
+{
+#ifdef __F16C__
+    return _cvtsh_ss(value);
+#else
+    constexpr std::uint32_t shifted_exp = 0x7C00U << 13;
+
+    std::uint32_t bits = (value & 0x7FFFU) << 13;
+
+    std::uint32_t exp = bits & shifted_exp;
+
+    // Rebias the exponent.
+    bits += (127U - 15U) << 23;
+
+    if (exp == shifted_exp) {
+        // Infinity or NaN.
+        bits += (128U - 16U) << 23;
+    }
+    else if (exp == 0) {
+        // Subnormal or zero; let the FPU renormalize.
+        constexpr std::uint32_t magic_bits = 113U << 23;
+
+        float magic{};
+        std::memcpy(&magic, &magic_bits, sizeof(magic));
+
+        bits += 1U << 23;
+
+        float f{};
+        std::memcpy(&f, &bits, sizeof(f));
+        f -= magic;
+        std::memcpy(&bits, &f, sizeof(bits));
+    }
+
+    bits |= (value & 0x8000U) << 16;
+
+    float result{};
+    std::memcpy(&result, &bits, sizeof(result));
+
+    return result;
+#endif
+}
+
+// Converts a single-precision value to bfloat16 rounding to the nearest
+// even value.
+inline std::uint16_t float_to_bfloat16(float value) noexcept
+{
+    std::uint32_t bits{};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    // Keep NaNs quiet; rounding could turn them into infinity.
+    if ((bits & 0x7FFF'FFFFU) > 0x7F80'0000U) {
+        return static_cast<std::uint16_t>((bits >> 16) | 0x40U);
+    }
+
+    bits += 0x7FFFU + ((bits >> 16) & 1U);
+
+    return static_cast<std::uint16_t>(bits >> 16);
+}
+
+// Converts a bfloat16 value to single-precision; the conversion is
+// exact.
+inline float bfloat16_to_float(std::uint16_t value) noexcept
+{
+    auto bits = static_cast<std::uint32_t>(value) << 16;
+
+    float result{};
+    std::memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+// Narrows the specified single-precision values to half-precision;
+// uses the F16C instructions eight values at a time if the processor
+// supports them, even if the library is not compiled for them.
+void float_to_half(const float *src, std::uint16_t *dst, std::size_t size) noexcept;
+
+// Narrows the specified single-precision values to bfloat16.
+void float_to_bfloat16(const float *src, std::uint16_t *dst, std::size_t size) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
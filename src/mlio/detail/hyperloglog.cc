@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/hyperloglog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Hyper_log_log::Hyper_log_log(std::uint8_t precision)
+    : precision_{precision}, registers_(std::size_t{1} << precision)
+{
+    if (precision < 4 || precision > 18) {
+        throw std::invalid_argument{"The precision must be between 4 and 18."};
+    }
+}
+
+void Hyper_log_log::merge(const Hyper_log_log &other)
+{
+    if (precision_ != other.precision_) {
+        throw std::invalid_argument{"The estimators must have the same precision."};
+    }
+
+    std::transform(registers_.begin(),
+                   registers_.end(),
+                   other.registers_.begin(),
+                   registers_.begin(),
+                   [](std::uint8_t a, std::uint8_t b) {
+                       return std::max(a, b);
+                   });
+}
+
+double Hyper_log_log::estimate() const noexcept
+{
+    auto m = static_cast<double>(registers_.size());
+
+    double alpha{};
+    switch (registers_.size()) {
+    case 16:
+        alpha = 0.673;
+        break;
+    case 32:
+        alpha = 0.697;
+        break;
+    case 64:
+        alpha = 0.709;
+        break;
+    default:
+        alpha = 0.7213 / (1.0 + 1.079 / m);
+        break;
+    }
+
+    double sum = 0.0;
+
+    std::size_t num_zeros = 0;
+    for (std::uint8_t r : registers_) {
+        sum += std::ldexp(1.0, -r);
+
+        if (r == 0) {
+            num_zeros++;
+        }
+    }
+
+    double estimate = alpha * m * m / sum;
+
+    // See the small and large range corrections of the original paper.
+    constexpr double pow_2_32 = 4294967296.0;
+
+    if (estimate <= 2.5 * m) {
+        if (num_zeros != 0) {
+            estimate = m * std::log(m / static_cast<double>(num_zeros));
+        }
+    }
+    else if (estimate > pow_2_32 / 30.0) {
+        estimate = -pow_2_32 * std::log(1.0 - estimate / pow_2_32);
+    }
+
+    return estimate;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
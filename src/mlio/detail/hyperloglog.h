@@ -0,0 +1,60 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Estimates the number of distinct 32-bit hash values added to it. The
+// estimators of the same precision can be merged; this allows each
+// thread to maintain its own estimator.
+class Hyper_log_log {
+public:
+    // The number of registers is 2^precision.
+    explicit Hyper_log_log(std::uint8_t precision);
+
+    void add(std::uint32_t hash) noexcept
+    {
+        std::uint32_t idx = hash >> (32U - precision_);
+
+        std::uint32_t rest = hash << precision_;
+
+        // The position of the leftmost one bit in the remaining bits.
+        auto rank = static_cast<std::uint8_t>(
+            rest == 0 ? 33U - precision_ : static_cast<unsigned>(__builtin_clz(rest)) + 1U);
+
+        if (rank > registers_[idx]) {
+            registers_[idx] = rank;
+        }
+    }
+
+    void merge(const Hyper_log_log &other);
+
+    double estimate() const noexcept;
+
+private:
+    std::uint8_t precision_;
+    std::vector<std::uint8_t> registers_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
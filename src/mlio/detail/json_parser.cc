@@ -0,0 +1,599 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/json_parser.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "mlio/detail/cpu_features.h"
+
+#if defined(MLIO_X86_DISPATCH) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The kernels below return the offset of the first vector or word of the
+// data that contains a quote or a backslash, or at which too few
+// characters remain; the caller scans the rest one character at a time.
+using Skip_string_chars_fn = std::size_t (*)(const char *, std::size_t) noexcept;
+
+#if !defined(MLIO_X86_DISPATCH) && !defined(__SSE2__) && !defined(__ARM_NEON)
+
+constexpr std::uint64_t low_bits = 0x0101'0101'0101'0101;
+constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080;
+
+inline std::uint64_t has_byte(std::uint64_t word, std::uint64_t pattern) noexcept
+{
+    std::uint64_t x = word ^ pattern;
+
+    return (x - low_bits) & ~x & high_bits;
+}
+
+std::size_t skip_string_chars_swar(const char *data, std::size_t size) noexcept
+{
+    constexpr std::uint64_t quote_pattern = low_bits * '"';
+    constexpr std::uint64_t backslash_pattern = low_bits * '\\';
+
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word{};
+        std::memcpy(&word, data + i, sizeof(word));
+
+        if ((has_byte(word, quote_pattern) | has_byte(word, backslash_pattern)) != 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(MLIO_X86_DISPATCH) || defined(__SSE2__)
+
+std::size_t skip_string_chars_sse2(const char *data, std::size_t size) noexcept
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    std::size_t i = 0;
+    for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        if (_mm_movemask_epi8(eq) != 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(MLIO_X86_DISPATCH)
+
+MLIO_TARGET("avx2")
+std::size_t skip_string_chars_avx2(const char *data, std::size_t size) noexcept
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    std::size_t i = 0;
+    for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+
+        __m256i eq =
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash));
+        if (_mm256_movemask_epi8(eq) != 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+#elif defined(__ARM_NEON)
+
+std::size_t skip_string_chars_neon(const char *data, std::size_t size) noexcept
+{
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(data + i));
+
+        uint8x16_t eq = vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash));
+        if (vmaxvq_u8(eq) != 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+// Picks the widest kernel the processor supports.
+Skip_string_chars_fn select_skip_string_chars() noexcept
+{
+#if defined(MLIO_X86_DISPATCH)
+    if (cpu_features().avx2) {
+        return skip_string_chars_avx2;
+    }
+#endif
+
+#if defined(MLIO_X86_DISPATCH) || defined(__SSE2__)
+    return skip_string_chars_sse2;
+#elif defined(__ARM_NEON)
+    return skip_string_chars_neon;
+#else
+    return skip_string_chars_swar;
+#endif
+}
+
+inline bool is_whitespace(char chr) noexcept
+{
+    return chr == ' ' || chr == '\t' || chr == '\n' || chr == '\r';
+}
+
+inline bool is_number_char(char chr) noexcept
+{
+    return (chr >= '0' && chr <= '9') || chr == '-' || chr == '+' || chr == '.' || chr == 'e' ||
+           chr == 'E';
+}
+
+int hex_value(char chr) noexcept
+{
+    if (chr >= '0' && chr <= '9') {
+        return chr - '0';
+    }
+    if (chr >= 'a' && chr <= 'f') {
+        return chr - 'a' + 10;
+    }
+    if (chr >= 'A' && chr <= 'F') {
+        return chr - 'A' + 10;
+    }
+    return -1;
+}
+
+bool read_hex4(std::string_view raw, std::size_t pos, std::uint32_t &value) noexcept
+{
+    if (pos + 4 > raw.size()) {
+        return false;
+    }
+
+    value = 0;
+    for (std::size_t i = pos; i < pos + 4; i++) {
+        int digit = hex_value(raw[i]);
+        if (digit < 0) {
+            return false;
+        }
+        value = (value << 4) | static_cast<std::uint32_t>(digit);
+    }
+
+    return true;
+}
+
+void append_utf8(std::string &out, std::uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+}  // namespace
+
+Json_kind Json_parser::peek() noexcept
+{
+    skip_whitespace();
+
+    if (pos_ == text_.size()) {
+        return Json_kind::invalid;
+    }
+
+    char chr = text_[pos_];
+    switch (chr) {
+    case '{':
+        return Json_kind::object;
+    case '[':
+        return Json_kind::array;
+    case '"':
+        return Json_kind::string;
+    case 't':
+    case 'f':
+        return Json_kind::boolean;
+    case 'n':
+        return Json_kind::null;
+    default:
+        if (chr == '-' || (chr >= '0' && chr <= '9')) {
+            return Json_kind::number;
+        }
+        return Json_kind::invalid;
+    }
+}
+
+bool Json_parser::begin_object() noexcept
+{
+    if (peek() != Json_kind::object) {
+        return fail();
+    }
+
+    pos_++;
+
+    first_ = true;
+
+    return true;
+}
+
+bool Json_parser::begin_array() noexcept
+{
+    if (peek() != Json_kind::array) {
+        return fail();
+    }
+
+    pos_++;
+
+    first_ = true;
+
+    return true;
+}
+
+bool Json_parser::next(char close) noexcept
+{
+    skip_whitespace();
+
+    if (pos_ == text_.size()) {
+        return fail();
+    }
+
+    if (text_[pos_] == close) {
+        pos_++;
+
+        // The enclosing object or array has at least one member now.
+        first_ = false;
+
+        return false;
+    }
+
+    if (first_) {
+        first_ = false;
+    }
+    else {
+        if (text_[pos_] != ',') {
+            return fail();
+        }
+
+        pos_++;
+    }
+
+    return true;
+}
+
+bool Json_parser::next_member(std::string_view &key, std::string &scratch)
+{
+    if (!next('}')) {
+        return false;
+    }
+
+    skip_whitespace();
+
+    if (pos_ == text_.size() || text_[pos_] != '"') {
+        return fail();
+    }
+
+    if (!read_string(key, scratch)) {
+        return false;
+    }
+
+    skip_whitespace();
+
+    if (pos_ == text_.size() || text_[pos_] != ':') {
+        return fail();
+    }
+
+    pos_++;
+
+    return true;
+}
+
+bool Json_parser::next_element() noexcept
+{
+    return next(']');
+}
+
+bool Json_parser::read_null() noexcept
+{
+    skip_whitespace();
+
+    return consume_literal("null");
+}
+
+bool Json_parser::read_bool(bool &value) noexcept
+{
+    skip_whitespace();
+
+    if (pos_ < text_.size() && text_[pos_] == 't') {
+        value = true;
+
+        return consume_literal("true");
+    }
+
+    value = false;
+
+    return consume_literal("false");
+}
+
+bool Json_parser::read_number(std::string_view &token) noexcept
+{
+    skip_whitespace();
+
+    std::size_t start = pos_;
+    while (pos_ < text_.size() && is_number_char(text_[pos_])) {
+        pos_++;
+    }
+
+    if (pos_ == start) {
+        return fail();
+    }
+
+    // The token is validated when it is converted.
+    token = text_.substr(start, pos_ - start);
+
+    return true;
+}
+
+bool Json_parser::read_string(std::string_view &value, std::string &scratch)
+{
+    skip_whitespace();
+
+    std::string_view raw{};
+
+    bool has_escapes{};
+    if (!scan_string(raw, has_escapes)) {
+        return false;
+    }
+
+    if (!has_escapes) {
+        value = raw;
+
+        return true;
+    }
+
+    if (!unescape(raw, scratch)) {
+        return fail();
+    }
+
+    value = scratch;
+
+    return true;
+}
+
+bool Json_parser::skip_value() noexcept
+{
+    std::string_view token{};
+
+    bool has_escapes{};
+
+    switch (peek()) {
+    case Json_kind::null:
+        return read_null();
+    case Json_kind::boolean: {
+        bool value{};
+        return read_bool(value);
+    }
+    case Json_kind::number:
+        return read_number(token);
+    case Json_kind::string:
+        return scan_string(token, has_escapes);
+    case Json_kind::object:
+    case Json_kind::array:
+        break;
+    case Json_kind::invalid:
+        return fail();
+    }
+
+    // Skip the nested values by tracking the depth; the strings have to
+    // be scanned so that their brackets are ignored.
+    std::size_t depth = 0;
+
+    while (pos_ < text_.size()) {
+        char chr = text_[pos_];
+        if (chr == '"') {
+            if (!scan_string(token, has_escapes)) {
+                return false;
+            }
+            continue;
+        }
+
+        if (chr == '{' || chr == '[') {
+            depth++;
+        }
+        else if (chr == '}' || chr == ']') {
+            if (--depth == 0) {
+                pos_++;
+
+                first_ = false;
+
+                return true;
+            }
+        }
+
+        pos_++;
+    }
+
+    return fail();
+}
+
+bool Json_parser::at_end() noexcept
+{
+    skip_whitespace();
+
+    return pos_ == text_.size();
+}
+
+void Json_parser::skip_whitespace() noexcept
+{
+    while (pos_ < text_.size() && is_whitespace(text_[pos_])) {
+        pos_++;
+    }
+}
+
+bool Json_parser::consume_literal(std::string_view literal) noexcept
+{
+    if (text_.substr(pos_, literal.size()) != literal) {
+        return fail();
+    }
+
+    pos_ += literal.size();
+
+    return true;
+}
+
+bool Json_parser::scan_string(std::string_view &raw, bool &has_escapes) noexcept
+{
+    static const Skip_string_chars_fn skip_string_chars = select_skip_string_chars();
+
+    // Skip the opening quote.
+    std::size_t start = ++pos_;
+
+    has_escapes = false;
+
+    while (true) {
+        pos_ += skip_string_chars(text_.data() + pos_, text_.size() - pos_);
+
+        while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\') {
+            pos_++;
+        }
+
+        if (pos_ == text_.size()) {
+            return fail();
+        }
+
+        if (text_[pos_] == '"') {
+            break;
+        }
+
+        has_escapes = true;
+
+        // Skip the escaped character.
+        pos_ += 2;
+        if (pos_ > text_.size()) {
+            return fail();
+        }
+    }
+
+    raw = text_.substr(start, pos_ - start);
+
+    // Skip the closing quote.
+    pos_++;
+
+    return true;
+}
+
+bool Json_parser::unescape(std::string_view raw, std::string &out)
+{
+    out.clear();
+
+    for (std::size_t i = 0; i < raw.size(); i++) {
+        char chr = raw[i];
+        if (chr != '\\') {
+            out.push_back(chr);
+
+            continue;
+        }
+
+        i++;
+
+        switch (raw[i]) {
+        case '"':
+        case '\\':
+        case '/':
+            out.push_back(raw[i]);
+            break;
+        case 'b':
+            out.push_back('\b');
+            break;
+        case 'f':
+            out.push_back('\f');
+            break;
+        case 'n':
+            out.push_back('\n');
+            break;
+        case 'r':
+            out.push_back('\r');
+            break;
+        case 't':
+            out.push_back('\t');
+            break;
+        case 'u': {
+            std::uint32_t code_point{};
+            if (!read_hex4(raw, i + 1, code_point)) {
+                return false;
+            }
+            i += 4;
+
+            // Combine a surrogate pair into a single code point.
+            if (code_point >= 0xD800 && code_point < 0xDC00) {
+                std::uint32_t low{};
+                if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' ||
+                    !read_hex4(raw, i + 3, low) || low < 0xDC00 || low >= 0xE000) {
+                    return false;
+                }
+                i += 6;
+
+                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (code_point >= 0xDC00 && code_point < 0xE000) {
+                return false;
+            }
+
+            append_utf8(out, code_point);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
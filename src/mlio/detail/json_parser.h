@@ -0,0 +1,112 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Specifies the kind of a JSON value.
+enum class Json_kind { null, boolean, number, string, array, object, invalid };
+
+// Parses a JSON text on demand without building a document tree; the
+// caller walks the values it needs and skips the rest. The strings are
+// scanned with SIMD instructions when available.
+//
+// The functions return false if the text is not valid JSON, in which
+// case failed() returns true, or for next_member() and next_element()
+// also at the end of the current object or array.
+class Json_parser {
+public:
+    explicit Json_parser(std::string_view text) noexcept : text_{text}
+    {}
+
+    // Returns the kind of the next value.
+    Json_kind peek() noexcept;
+
+    bool begin_object() noexcept;
+
+    bool begin_array() noexcept;
+
+    // Moves to the next member of the current object and reads its key.
+    // An escaped key is decoded into the scratch string.
+    bool next_member(std::string_view &key, std::string &scratch);
+
+    // Moves to the next element of the current array.
+    bool next_element() noexcept;
+
+    bool read_null() noexcept;
+
+    bool read_bool(bool &value) noexcept;
+
+    // Reads the token of a number without converting it.
+    bool read_number(std::string_view &token) noexcept;
+
+    // Reads a string. An escaped string is decoded into the scratch
+    // string.
+    bool read_string(std::string_view &value, std::string &scratch);
+
+    bool skip_value() noexcept;
+
+    // Returns a boolean value indicating whether only whitespace is left.
+    bool at_end() noexcept;
+
+    bool failed() const noexcept
+    {
+        return failed_;
+    }
+
+    // Returns the offset of the parser in the text.
+    std::size_t position() const noexcept
+    {
+        return pos_;
+    }
+
+private:
+    bool fail() noexcept
+    {
+        failed_ = true;
+
+        return false;
+    }
+
+    void skip_whitespace() noexcept;
+
+    bool next(char close) noexcept;
+
+    bool consume_literal(std::string_view literal) noexcept;
+
+    // Moves past the closing quote of the string that starts at the
+    // current position, and returns its raw characters.
+    bool scan_string(std::string_view &raw, bool &has_escapes) noexcept;
+
+    bool unescape(std::string_view raw, std::string &out);
+
+    std::string_view text_;
+    std::size_t pos_{};
+    // Indicates whether no member or element of the current object or
+    // array has been read yet.
+    bool first_{};
+    bool failed_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/murmur_hash.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::uint32_t c1 = 0xcc9e'2d51;
+constexpr std::uint32_t c2 = 0x1b87'3593;
+
+inline std::uint32_t rotl(std::uint32_t x, int r) noexcept
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+inline std::uint32_t mix_block(std::uint32_t k) noexcept
+{
+    k *= c1;
+    k = rotl(k, 15);
+    k *= c2;
+
+    return k;
+}
+
+}  // namespace
+
+std::uint32_t murmur_hash3_32(std::string_view s, std::uint32_t seed) noexcept
+{
+    std::uint32_t h = seed;
+
+    std::size_t num_blocks = s.size() / 4;
+
+    for (std::size_t i = 0; i < num_blocks; i++) {
+        std::uint32_t k{};
+        std::memcpy(&k, s.data() + i * 4, sizeof(k));
+
+        h ^= mix_block(k);
+        h = rotl(h, 13);
+        h = h * 5 + 0xe654'6b64;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto *tail = reinterpret_cast<const unsigned char *>(s.data() + num_blocks * 4);
+
+    std::uint32_t k = 0;
+
+    switch (s.size() & 3) {
+    case 3:
+        k ^= static_cast<std::uint32_t>(tail[2]) << 16;
+        [[fallthrough]];
+    case 2:
+        k ^= static_cast<std::uint32_t>(tail[1]) << 8;
+        [[fallthrough]];
+    case 1:
+        k ^= static_cast<std::uint32_t>(tail[0]);
+
+        h ^= mix_block(k);
+        break;
+    default:
+        break;
+    }
+
+    h ^= static_cast<std::uint32_t>(s.size());
+
+    h ^= h >> 16;
+    h *= 0x85eb'ca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2'ae35;
+    h ^= h >> 16;
+
+    return h;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
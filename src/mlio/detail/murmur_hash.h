@@ -15,19 +15,17 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string_view>
-#include <utility>
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
-std::pair<std::string_view, std::string_view>
-split_s3_uri_to_bucket_and_prefix(std::string_view uri);
-
-std::pair<std::string_view, std::string_view> split_s3_uri_to_bucket_and_key(std::string_view uri);
-
-void validate_s3_object_uri(std::string_view uri);
+/// Computes the 32-bit MurmurHash3 (x86) of the specified string. The
+/// value matches the reference implementation on little-endian platforms
+/// and therefore the feature hashers of common ML libraries.
+std::uint32_t murmur_hash3_32(std::string_view s, std::uint32_t seed) noexcept;
 
 }  // namespace detail
 }  // namespace abi_v1
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "mlio/data_type.h"
+#include "mlio/detail/half.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Indicates whether the values of the data type @p src can be narrowed
+// to the data type @p dst by narrow_values().
+constexpr bool can_narrow(Data_type src, Data_type dst) noexcept
+{
+    switch (src) {
+    case Data_type::float32:
+        return dst == Data_type::float16 || dst == Data_type::bfloat16;
+    case Data_type::float64:
+        return dst == Data_type::float32 || dst == Data_type::float16 ||
+               dst == Data_type::bfloat16;
+    case Data_type::int32:
+        return dst == Data_type::int8 || dst == Data_type::int16;
+    case Data_type::size:
+    case Data_type::float16:
+    case Data_type::int8:
+    case Data_type::int16:
+    case Data_type::int64:
+    case Data_type::uint8:
+    case Data_type::uint16:
+    case Data_type::uint32:
+    case Data_type::uint64:
+    case Data_type::string:
+    case Data_type::bfloat16:
+    case Data_type::timestamp:
+    case Data_type::date:
+        return false;
+    }
+
+    return false;
+}
+
+// Narrows the specified values to the data type dt. The loops have no
+// branches so that the compiler can vectorize them.
+//
+// @return
+//     false if one or more values do not fit into dt; the narrowed
+//     values of such elements are unspecified.
+template<Data_type dt, typename T>
+bool narrow_values(const T *src, data_type_t<dt> *dst, std::size_t size) noexcept
+{
+    using U = data_type_t<dt>;
+
+    bool fits = true;
+
+    if constexpr (dt == Data_type::float16 || dt == Data_type::bfloat16) {
+        const float *values{};
+        if constexpr (std::is_same_v<T, float>) {
+            values = src;
+        }
+        else {
+            thread_local std::vector<float> buffer{};
+
+            buffer.resize(size);
+            for (std::size_t i = 0; i < size; i++) {
+                buffer[i] = static_cast<float>(src[i]);
+            }
+
+            values = buffer.data();
+        }
+
+        std::uint16_t inf_bits{};
+        if constexpr (dt == Data_type::float16) {
+            float_to_half(values, dst, size);
+
+            inf_bits = 0x7C00U;
+        }
+        else {
+            float_to_bfloat16(values, dst, size);
+
+            inf_bits = 0x7F80U;
+        }
+
+        // A finite value that became infinity has overflowed.
+        for (std::size_t i = 0; i < size; i++) {
+            bool is_inf = (dst[i] & 0x7FFFU) == inf_bits;
+
+            fits &= !is_inf | !std::isfinite(src[i]);
+        }
+    }
+    else if constexpr (std::is_floating_point_v<U>) {
+        for (std::size_t i = 0; i < size; i++) {
+            dst[i] = static_cast<U>(src[i]);
+
+            fits &= !std::isinf(dst[i]) | !std::isfinite(src[i]);
+        }
+    }
+    else {
+        for (std::size_t i = 0; i < size; i++) {
+            T value = src[i];
+
+            fits &= (value >= std::numeric_limits<U>::min()) &
+                    (value <= std::numeric_limits<U>::max());
+
+            dst[i] = static_cast<U>(value);
+        }
+    }
+
+    return fits;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
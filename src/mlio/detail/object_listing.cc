@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/object_listing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <thread>
+
+#include "mlio/detail/thread.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The maximum number of prefixes listed concurrently.
+constexpr std::size_t max_parallel_listings = 16;
+
+// Lists the specified prefixes on a set of threads. The prefixes are
+// disjoint, so their listings can simply be concatenated.
+void list_prefixes(const List_prefix_function &list_prefix,
+                   const std::vector<std::string> &prefixes,
+                   Object_listing &listing)
+{
+    std::vector<Object_listing> listings(prefixes.size());
+    std::vector<std::exception_ptr> errors(prefixes.size());
+
+    std::atomic_size_t next_idx{};
+
+    auto run = [&]() {
+        std::size_t idx{};
+        while ((idx = next_idx.fetch_add(1)) < prefixes.size()) {
+            try {
+                list_prefix(prefixes[idx], {}, listings[idx]);
+            }
+            catch (...) {
+                errors[idx] = std::current_exception();
+            }
+        }
+    };
+
+    std::size_t num_threads = std::min(prefixes.size(), max_parallel_listings);
+
+    std::vector<std::thread> threads{};
+    threads.reserve(num_threads);
+
+    try {
+        for (std::size_t i = 1; i < num_threads; i++) {
+            threads.emplace_back(start_thread(run));
+        }
+    }
+    catch (...) {
+        next_idx = prefixes.size();
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        throw;
+    }
+
+    // The calling thread takes part in the listing as well.
+    run();
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (Object_listing &l : listings) {
+        std::move(l.objects.begin(), l.objects.end(), std::back_inserter(listing.objects));
+    }
+}
+
+}  // namespace
+
+void list_objects_in_parallel(const List_prefix_function &list_prefix,
+                              std::string_view scheme,
+                              std::string_view bucket,
+                              std::string_view prefix,
+                              const List_objects_callback &callback)
+{
+    // A single list request returns a page of at most a few thousand
+    // keys, and the pages of a prefix can only be requested one after
+    // another. We therefore list the first level of the prefix with a
+    // delimiter and the resulting common prefixes in parallel. If there
+    // is only one common prefix, we descend into it.
+    Object_listing listing{};
+
+    std::string partition_prefix{prefix};
+    while (true) {
+        Object_listing level{};
+        list_prefix(partition_prefix, "/", level);
+
+        std::move(level.objects.begin(), level.objects.end(), std::back_inserter(listing.objects));
+
+        if (level.common_prefixes.size() == 1) {
+            partition_prefix = std::move(level.common_prefixes.front());
+
+            continue;
+        }
+
+        list_prefixes(list_prefix, level.common_prefixes, listing);
+
+        break;
+    }
+
+    // Report the objects in the order in which the service lists them.
+    std::sort(listing.objects.begin(), listing.objects.end());
+
+    std::string base_uri = std::string{scheme} + "://" + std::string{bucket} + "/";
+
+    for (auto &[key, size] : listing.objects) {
+        callback(base_uri + key, size);
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Object_listing {
+    std::vector<std::pair<std::string, std::size_t>> objects{};
+    std::vector<std::string> common_prefixes{};
+};
+
+// Lists the objects under the specified prefix. If a delimiter is
+// specified, the keys that contain it after the prefix are rolled up
+// into common prefixes instead.
+using List_prefix_function =
+    std::function<void(std::string_view prefix, std::string_view delimiter, Object_listing &)>;
+
+using List_objects_callback = std::function<void(std::string uri, std::size_t size)>;
+
+// Lists the objects under the specified prefix and calls the callback
+// with their URIs in key order. The listing of a prefix is paginated,
+// so the first levels of the prefix are listed with a delimiter and
+// the resulting common prefixes in parallel.
+void list_objects_in_parallel(const List_prefix_function &list_prefix,
+                              std::string_view scheme,
+                              std::string_view bucket,
+                              std::string_view prefix,
+                              const List_objects_callback &callback);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
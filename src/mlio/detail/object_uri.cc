@@ -13,26 +13,32 @@
  * language governing permissions and limitations under the License.
  */
 
-#include "mlio/detail/s3_utils.h"
+#include "mlio/detail/object_uri.h"
 
 #include <stdexcept>
 
+#include <fmt/format.h>
+
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
 std::pair<std::string_view, std::string_view>
-split_s3_uri_to_bucket_and_prefix(std::string_view uri)
+split_object_uri_to_bucket_and_prefix(std::string_view uri, std::string_view scheme)
 {
     if (uri.empty()) {
         throw std::invalid_argument{"The URI cannot be an empty string."};
     }
 
-    if (uri.size() < 5 || uri.substr(0, 5) != "s3://") {
-        throw std::invalid_argument{"The URI must start with the S3 scheme."};
+    std::size_t scheme_size = scheme.size() + 3;
+
+    if (uri.size() < scheme_size || uri.substr(0, scheme.size()) != scheme ||
+        uri.substr(scheme.size(), 3) != "://") {
+        throw std::invalid_argument{
+            fmt::format("The URI must start with the '{0}://' scheme.", scheme)};
     }
 
-    uri = uri.substr(5);
+    uri = uri.substr(scheme_size);
 
     if (uri.empty()) {
         throw std::invalid_argument{"The URI cannot be an empty string."};
@@ -49,9 +55,10 @@ split_s3_uri_to_bucket_and_prefix(std::string_view uri)
     return std::make_pair(uri.substr(0, pos), uri.substr(pos + 1));
 }
 
-std::pair<std::string_view, std::string_view> split_s3_uri_to_bucket_and_key(std::string_view uri)
+std::pair<std::string_view, std::string_view>
+split_object_uri_to_bucket_and_key(std::string_view uri, std::string_view scheme)
 {
-    auto bp = split_s3_uri_to_bucket_and_prefix(uri);
+    auto bp = split_object_uri_to_bucket_and_prefix(uri, scheme);
 
     if (bp.second.empty()) {
         throw std::invalid_argument{"The URI does not contain a key."};
@@ -60,9 +67,9 @@ std::pair<std::string_view, std::string_view> split_s3_uri_to_bucket_and_key(std
     return bp;
 }
 
-void validate_s3_object_uri(std::string_view uri)
+void validate_object_uri(std::string_view uri, std::string_view scheme)
 {
-    split_s3_uri_to_bucket_and_key(uri);
+    split_object_uri_to_bucket_and_key(uri, scheme);
 }
 
 }  // namespace detail
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/protobuf_wire.h"
+
+#include <cstring>
+#include <limits>
+
+#include "mlio/endian.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+bool Wire_reader::read_varint(std::uint64_t &value) noexcept
+{
+    value = 0;
+
+    for (std::size_t i = 0; i < max_varint_size; i++) {
+        if (pos_ == end_) {
+            return false;
+        }
+
+        std::byte b = *pos_++;
+
+        value |= (std::to_integer<std::uint64_t>(b) & 0x7F) << (7 * i);
+
+        if (!has_continuation_bit(b)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Wire_reader::read_tag(std::uint32_t &field_number, Wire_type &wire_type) noexcept
+{
+    std::uint64_t tag{};
+    if (!read_varint(tag) || tag > std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+
+    field_number = static_cast<std::uint32_t>(tag >> 3);
+    if (field_number == 0) {
+        return false;
+    }
+
+    wire_type = static_cast<Wire_type>(tag & 0x07);
+
+    return true;
+}
+
+bool Wire_reader::read_fixed32(std::uint32_t &value) noexcept
+{
+    if (end_ - pos_ < static_cast<std::ptrdiff_t>(sizeof(value))) {
+        return false;
+    }
+
+    std::memcpy(&value, pos_, sizeof(value));
+
+    value = little_to_host_order(value);
+
+    pos_ += sizeof(value);
+
+    return true;
+}
+
+bool Wire_reader::read_length_delimited(Memory_span &bits) noexcept
+{
+    std::uint64_t size{};
+    if (!read_varint(size)) {
+        return false;
+    }
+
+    const std::byte *beg = pos_;
+    if (!skip_bytes(size)) {
+        return false;
+    }
+
+    bits = Memory_span{beg, size};
+
+    return true;
+}
+
+bool Wire_reader::skip(Wire_type wire_type) noexcept
+{
+    std::uint64_t value{};
+
+    switch (wire_type) {
+    case Wire_type::varint:
+        return read_varint(value);
+
+    case Wire_type::fixed64:
+        return skip_bytes(8);
+
+    case Wire_type::length_delimited:
+        if (!read_varint(value)) {
+            return false;
+        }
+        return skip_bytes(value);
+
+    case Wire_type::fixed32:
+        return skip_bytes(4);
+
+    // Groups are deprecated and never used by the messages we scan;
+    // we let the full parser deal with them.
+    case Wire_type::start_group:
+    case Wire_type::end_group:
+        break;
+    }
+
+    return false;
+}
+
+bool Wire_reader::skip_bytes(std::uint64_t size) noexcept
+{
+    if (size > static_cast<std::uint64_t>(end_ - pos_)) {
+        return false;
+    }
+
+    pos_ += size;
+
+    return true;
+}
+
+bool count_varints(Memory_span bits, std::ptrdiff_t &count) noexcept
+{
+    count = 0;
+
+    std::size_t num_bytes = 0;
+
+    for (std::byte b : bits) {
+        if (++num_bytes > max_varint_size) {
+            return false;
+        }
+
+        if (!has_continuation_bit(b)) {
+            count++;
+
+            num_bytes = 0;
+        }
+    }
+
+    // The last varint must be terminated.
+    return num_bytes == 0;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mlio/config.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// The primitives of the protobuf wire format shared by the scanners that
+// read the fields of a message straight from its wire representation.
+
+enum class Wire_type : std::uint32_t {
+    varint = 0,
+    fixed64 = 1,
+    length_delimited = 2,
+    start_group = 3,
+    end_group = 4,
+    fixed32 = 5,
+};
+
+inline constexpr std::size_t max_varint_size = 10;
+
+inline bool has_continuation_bit(std::byte b) noexcept
+{
+    return (b & std::byte{0x80}) != std::byte{};
+}
+
+class Wire_reader {
+public:
+    explicit Wire_reader(Memory_span bits) noexcept
+        : pos_{bits.data()}, end_{bits.data() + bits.size()}
+    {}
+
+    bool read_varint(std::uint64_t &value) noexcept;
+
+    bool read_tag(std::uint32_t &field_number, Wire_type &wire_type) noexcept;
+
+    bool read_fixed32(std::uint32_t &value) noexcept;
+
+    bool read_length_delimited(Memory_span &bits) noexcept;
+
+    bool skip(Wire_type wire_type) noexcept;
+
+    bool eof() const noexcept
+    {
+        return pos_ == end_;
+    }
+
+private:
+    bool skip_bytes(std::uint64_t size) noexcept;
+
+    const std::byte *pos_;
+    const std::byte *end_;
+};
+
+// Validates the specified packed varint field and counts its values.
+MLIO_HIDDEN
+bool count_varints(Memory_span bits, std::ptrdiff_t &count) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
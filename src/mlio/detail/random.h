@@ -0,0 +1,211 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Returns a 64-bit value whose bits depend on all bits of the input;
+// the finalizer of the splitmix64 generator.
+inline std::uint64_t mix64(std::uint64_t x) noexcept
+{
+    x = (x ^ (x >> 30U)) * 0xbf58'476d'1ce4'e5b9;
+    x = (x ^ (x >> 27U)) * 0x94d0'49bb'1331'11eb;
+
+    return x ^ (x >> 31U);
+}
+
+// Advances the state of a splitmix64 generator and returns its next
+// output.
+inline std::uint64_t splitmix64(std::uint64_t &state) noexcept
+{
+    state += 0x9e37'79b9'7f4a'7c15;
+
+    return mix64(state);
+}
+
+// A xoshiro256++ generator. It is considerably faster than mt19937_64
+// and has a state of only 32 bytes, while its output passes the usual
+// statistical test suites. Meets the UniformRandomBitGenerator
+// requirements.
+class Xoshiro256pp {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256pp(std::uint64_t seed = 0) noexcept
+    {
+        this->seed(seed);
+    }
+
+    // Expands the seed into the state with splitmix64 as recommended by
+    // the authors of the generator.
+    void seed(std::uint64_t seed) noexcept
+    {
+        for (std::uint64_t &s : state_) {
+            s = splitmix64(seed);
+        }
+    }
+
+    result_type operator()() noexcept
+    {
+        std::uint64_t result = rotl(state_[0] + state_[3], 23) + state_[0];
+
+        std::uint64_t t = state_[1] << 17U;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+
+        state_[2] ^= t;
+
+        state_[3] = rotl(state_[3], 45);
+
+        return result;
+    }
+
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, unsigned k) noexcept
+    {
+        return (x << k) | (x >> (64U - k));
+    }
+
+    std::uint64_t state_[4]{};
+};
+
+// Returns a uniformly distributed random integer in [0, bound) using
+// Lemire's nearly divisionless method; a division is only needed in
+// the rare case of a rejection.
+inline std::uint64_t bounded_random(Xoshiro256pp &engine, std::uint64_t bound) noexcept
+{
+    using uint128 = unsigned __int128;
+
+    uint128 m = static_cast<uint128>(engine()) * bound;
+
+    auto low = static_cast<std::uint64_t>(m);
+    if (low < bound) {
+        std::uint64_t threshold = -bound % bound;
+
+        while (low < threshold) {
+            m = static_cast<uint128>(engine()) * bound;
+
+            low = static_cast<std::uint64_t>(m);
+        }
+    }
+
+    return static_cast<std::uint64_t>(m >> 64U);
+}
+
+// Shuffles the range with the Fisher-Yates algorithm; a faster
+// equivalent of std::shuffle().
+template<typename It>
+void random_shuffle(It first, It last, Xoshiro256pp &engine) noexcept
+{
+    auto size = static_cast<std::uint64_t>(std::distance(first, last));
+
+    for (std::uint64_t i = size; i > 1; i--) {
+        std::uint64_t j = bounded_random(engine, i);
+
+        using std::swap;
+
+        swap(first[static_cast<std::ptrdiff_t>(i - 1)], first[static_cast<std::ptrdiff_t>(j)]);
+    }
+}
+
+// A pseudorandom permutation of [0, size) whose elements are computed
+// one at a time in constant memory, so that independent workers that
+// share the key can each evaluate their own part of the same
+// permutation. It is a balanced Feistel network over the smallest
+// power-of-four domain that covers the size; the values that fall
+// outside of the range are walked back into it by re-encrypting them,
+// which takes less than four rounds on average.
+class Random_permutation {
+    static constexpr std::size_t num_rounds = 4;
+
+public:
+    Random_permutation() noexcept = default;
+
+    explicit Random_permutation(std::uint64_t size, std::uint64_t key) noexcept : size_{size}
+    {
+        while (half_bits_ < 32 && (std::uint64_t{1} << (2 * half_bits_)) < size) {
+            half_bits_++;
+        }
+
+        half_mask_ = (std::uint64_t{1} << half_bits_) - 1;
+
+        for (std::uint64_t &k : keys_) {
+            k = splitmix64(key);
+        }
+    }
+
+    // Returns the element at the specified position; the position must
+    // be less than the size.
+    std::uint64_t operator()(std::uint64_t idx) const noexcept
+    {
+        do {
+            idx = encrypt(idx);
+        } while (idx >= size_);
+
+        return idx;
+    }
+
+    std::uint64_t size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    std::uint64_t encrypt(std::uint64_t x) const noexcept
+    {
+        std::uint64_t left = x >> half_bits_;
+        std::uint64_t right = x & half_mask_;
+
+        for (std::uint64_t k : keys_) {
+            std::uint64_t tmp = left ^ (mix64(right ^ k) & half_mask_);
+
+            left = right;
+            right = tmp;
+        }
+
+        return (left << half_bits_) | right;
+    }
+
+    std::uint64_t size_{};
+    unsigned half_bits_ = 1;
+    std::uint64_t half_mask_ = 1;
+    std::uint64_t keys_[num_rounds]{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
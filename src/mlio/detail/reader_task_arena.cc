@@ -0,0 +1,233 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/reader_task_arena.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <tbb/global_control.h>
+#include <tbb/task_scheduler_init.h>
+#include <tbb/task_scheduler_observer.h>
+
+#include "mlio/detail/cpu_affinity.h"
+#include "mlio/detail/cuda_transfer.h"
+#include "mlio/detail/system_info.h"
+#include "mlio/device.h"
+#include "mlio/logger.h"
+#include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Pins the worker threads to the processor cores of the arena as they
+// join it.
+class Reader_task_arena::Pinning_observer final : public tbb::task_scheduler_observer {
+public:
+    explicit Pinning_observer(tbb::task_arena &arena, const Reader_task_arena &owner)
+        : tbb::task_scheduler_observer{arena}, owner_{&owner}
+    {
+        observe(true);
+    }
+
+    Pinning_observer(const Pinning_observer &) = delete;
+
+    Pinning_observer &operator=(const Pinning_observer &) = delete;
+
+    Pinning_observer(Pinning_observer &&) = delete;
+
+    Pinning_observer &operator=(Pinning_observer &&) = delete;
+
+    ~Pinning_observer() final
+    {
+        observe(false);
+    }
+
+    void on_scheduler_entry(bool is_worker) final
+    {
+        // External threads, such as the consumer thread that constructs
+        // the flow graph, should keep their affinity.
+        if (!is_worker) {
+            return;
+        }
+
+        if (!owner_->pin_thread() && !warned_.exchange(true)) {
+            logger::warn("The worker threads of the data reader cannot be pinned to the "
+                         "specified processor cores.");
+        }
+    }
+
+private:
+    const Reader_task_arena *owner_;
+    std::atomic_bool warned_{};
+};
+
+namespace {
+
+std::optional<std::size_t> get_output_device_numa_node(const Data_reader_params &params)
+{
+    const std::optional<Device> &device = params.output_device;
+    if (!device || device->kind() != Device_kind::cuda()) {
+        return {};
+    }
+
+    if (!supports_cpu_affinity() || get_num_numa_nodes() == 1) {
+        return {};
+    }
+
+    std::optional<std::string> bus_id = get_cuda_device_pci_bus_id(device->id());
+    if (bus_id == std::nullopt) {
+        return {};
+    }
+
+    return get_pci_device_numa_node(*bus_id);
+}
+
+}  // namespace
+
+Reader_task_arena::Reader_task_arena(const Data_reader_params &params)
+{
+    if (params.numa_node) {
+        if (!params.cpu_affinity.empty()) {
+            throw std::invalid_argument{
+                "The CPU affinity and the NUMA node cannot be both specified."};
+        }
+
+        numa_node_ = params.numa_node;
+    }
+    else if (params.auto_numa_node && params.cpu_affinity.empty()) {
+        numa_node_ = get_output_device_numa_node(params);
+        if (numa_node_) {
+            logger::info("The threads of the data reader are pinned to the NUMA node {0} of "
+                         "the output device.",
+                         *numa_node_);
+        }
+    }
+
+    if (numa_node_) {
+        cpus_ = get_numa_node_cpus(*numa_node_);
+    }
+    else {
+        cpus_ = params.cpu_affinity;
+    }
+
+    if (!cpus_.empty() && !supports_cpu_affinity()) {
+        throw Not_supported_error{
+            "Pinning threads to processor cores is not supported on this platform."};
+    }
+
+    std::size_t num_threads = params.num_threads;
+    if (num_threads == 0) {
+        num_threads = cpus_.size();
+    }
+
+    // TBB sizes the global scheduler from the processor cores of the host
+    // even if the CPU quota of the container is much lower; in that case
+    // do not oversubscribe the quota with worker threads.
+    if (num_threads == 0) {
+        std::size_t num_cpus = get_num_cpus();
+        if (num_cpus < static_cast<std::size_t>(tbb::task_scheduler_init::default_num_threads())) {
+            logger::debug("The data reader uses {0} threads as limited by the CPU quota.",
+                          num_cpus);
+
+            num_threads = num_cpus;
+        }
+    }
+
+    // Share the global scheduler.
+    if (num_threads == 0) {
+        return;
+    }
+
+    arena_ = std::make_unique<tbb::task_arena>(static_cast<int>(num_threads));
+
+    arena_->initialize();
+
+    if (!cpus_.empty()) {
+        observer_ = std::make_unique<Pinning_observer>(*arena_, *this);
+    }
+}
+
+Reader_task_arena::~Reader_task_arena() = default;
+
+void Reader_task_arena::pin_current_thread() const noexcept
+{
+    if (cpus_.empty()) {
+        return;
+    }
+
+    if (!pin_thread()) {
+        logger::warn("The background thread of the data reader cannot be pinned to the "
+                     "specified processor cores.");
+    }
+}
+
+bool Reader_task_arena::pin_thread() const noexcept
+{
+    if (!set_thread_affinity(cpus_)) {
+        return false;
+    }
+
+    // The memory policy is only a hint; if it cannot be set, the pages
+    // are still placed on the node of the thread on first touch.
+    if (numa_node_) {
+        set_thread_numa_node(*numa_node_);
+    }
+
+    return true;
+}
+
+std::size_t Reader_task_arena::max_concurrency() const noexcept
+{
+    std::size_t value{};
+    if (arena_ == nullptr) {
+        value = static_cast<std::size_t>(tbb::task_scheduler_init::default_num_threads());
+    }
+    else {
+        value = static_cast<std::size_t>(arena_->max_concurrency());
+    }
+
+    // A process-wide limit set via set_max_num_threads() caps the arena
+    // regardless of its own size.
+    std::size_t limit =
+        tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+    if (limit > 0 && limit < value) {
+        return limit;
+    }
+    return value;
+}
+
+std::shared_ptr<Reader_task_arena> make_reader_task_arena(const Data_reader_params &params)
+{
+    if (params.thread_pool == nullptr) {
+        return std::make_shared<Reader_task_arena>(params);
+    }
+
+    if (params.num_threads != 0 || !params.cpu_affinity.empty() || params.numa_node ||
+        params.auto_numa_node) {
+        throw std::invalid_argument{
+            "The number of threads, the CPU affinity, and the NUMA node cannot be specified "
+            "along with a thread pool; they are properties of the pool."};
+    }
+
+    return Thread_pool_access::arena(*params.thread_pool);
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <tbb/task_arena.h>
+
+#include "mlio/data_reader.h"
+#include "mlio/thread_pool.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Runs the tasks of a data reader either in the global TBB scheduler or,
+/// if the reader parameters ask for it, in a task arena of its own whose
+/// worker threads are optionally pinned to a set of processor cores.
+///
+/// The TBB flow graph runs its tasks in the arena that it was constructed
+/// (or last reset) in; therefore the graph must be constructed, reset,
+/// and waited for inside @ref execute().
+class Reader_task_arena {
+    class Pinning_observer;
+
+public:
+    explicit Reader_task_arena(const Data_reader_params &params);
+
+    Reader_task_arena(const Reader_task_arena &) = delete;
+
+    Reader_task_arena &operator=(const Reader_task_arena &) = delete;
+
+    Reader_task_arena(Reader_task_arena &&) = delete;
+
+    Reader_task_arena &operator=(Reader_task_arena &&) = delete;
+
+    ~Reader_task_arena();
+
+    template<typename Func>
+    void execute(const Func &func)
+    {
+        if (arena_ == nullptr) {
+            func();
+        }
+        else {
+            arena_->execute(func);
+        }
+    }
+
+    /// Pins the calling thread to the processor cores, and the NUMA node
+    /// if one was specified, of the arena. Used for the background thread
+    /// of the reader that joins the arena as its master thread; the worker
+    /// threads are pinned as they join.
+    void pin_current_thread() const noexcept;
+
+    /// Returns the number of threads that can run the tasks of the
+    /// reader concurrently.
+    std::size_t max_concurrency() const noexcept;
+
+private:
+    bool pin_thread() const noexcept;
+
+    std::vector<std::size_t> cpus_{};
+    std::optional<std::size_t> numa_node_{};
+    std::unique_ptr<tbb::task_arena> arena_{};
+    std::unique_ptr<Pinning_observer> observer_{};
+};
+
+struct Thread_pool_access {
+    static const std::shared_ptr<Reader_task_arena> &arena(const Thread_pool &pool) noexcept
+    {
+        return pool.arena_;
+    }
+};
+
+/// Returns the arena of the thread pool of @p params if there is one;
+/// otherwise a new arena as specified by @p params.
+std::shared_ptr<Reader_task_arena> make_reader_task_arena(const Data_reader_params &params);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Acquires a number of references to a reference-counted object with a
+// single atomic operation and hands them out one at a time. The ones
+// that are not handed out are released together on destruction.
+//
+// This is meant for hot loops that make many short-lived pointers to
+// the same object, such as the records sliced from a single chunk.
+template<typename T>
+class Ref_batch {
+public:
+    Ref_batch() noexcept = default;
+
+    explicit Ref_batch(T *ptr, std::size_t n) noexcept : ptr_{ptr}, num_refs_{n}
+    {
+        if (ptr_ != nullptr && num_refs_ > 0) {
+            intrusive_ptr_inc_ref(ptr_, num_refs_);
+        }
+    }
+
+    Ref_batch(const Ref_batch &) = delete;
+
+    Ref_batch &operator=(const Ref_batch &) = delete;
+
+    Ref_batch(Ref_batch &&other) noexcept
+        : ptr_{std::exchange(other.ptr_, nullptr)}, num_refs_{std::exchange(other.num_refs_, 0)}
+    {}
+
+    Ref_batch &operator=(Ref_batch &&other) noexcept
+    {
+        if (this != &other) {
+            release();
+
+            ptr_ = std::exchange(other.ptr_, nullptr);
+            num_refs_ = std::exchange(other.num_refs_, 0);
+        }
+        return *this;
+    }
+
+    ~Ref_batch()
+    {
+        release();
+    }
+
+    // Hands out one of the acquired references; falls back to acquiring
+    // a new one if all of them have already been handed out.
+    Intrusive_ptr<T> take() noexcept
+    {
+        if (num_refs_ == 0) {
+            return Intrusive_ptr<T>{ptr_};
+        }
+
+        num_refs_--;
+
+        return Intrusive_ptr<T>{ptr_, false};
+    }
+
+    void release() noexcept
+    {
+        if (ptr_ != nullptr && num_refs_ > 0) {
+            intrusive_ptr_dec_ref(ptr_, num_refs_);
+        }
+
+        ptr_ = nullptr;
+
+        num_refs_ = 0;
+    }
+
+private:
+    T *ptr_{};
+    std::size_t num_refs_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Waits for a condition by first busy-spinning, then yielding the
+// processor, and finally parking the calling thread on a condition
+// variable. The spin budget adapts to the observed wait times; it
+// grows when spinning pays off and shrinks when the thread ends up
+// parking anyway.
+class Spin_then_park_waiter {
+    static constexpr int min_spin_count_ = 16;
+    static constexpr int max_spin_count_ = 8192;
+    static constexpr int yield_count_ = 16;
+
+public:
+    template<typename Pred>
+    void wait(std::mutex &mtx, std::condition_variable &cond, Pred pred)
+    {
+        for (int i = 0; i < spin_count_; i++) {
+            if (pred()) {
+                spin_count_ = std::min(spin_count_ * 2, max_spin_count_);
+
+                return;
+            }
+            cpu_relax();
+        }
+
+        for (int i = 0; i < yield_count_; i++) {
+            if (pred()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        spin_count_ = std::max(spin_count_ / 2, min_spin_count_);
+
+        std::unique_lock<std::mutex> lock{mtx};
+
+        parked_.store(true);
+
+        // Pairs with the fence in notify() so that either this thread
+        // observes the update or the notifier observes the flag.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        cond.wait(lock, pred);
+
+        parked_.store(false, std::memory_order_relaxed);
+    }
+
+    // Wakes up the waiting thread if it is parked. It must be called
+    // after the state observed by the wait predicate has been updated.
+    void notify(std::mutex &mtx, std::condition_variable &cond)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (parked_.load(std::memory_order_relaxed)) {
+            {
+                std::unique_lock<std::mutex> lock{mtx};
+            }
+
+            cond.notify_one();
+        }
+    }
+
+private:
+    int spin_count_ = min_spin_count_;
+    std::atomic_bool parked_{};
+};
+
+// Represents a bounded single-producer single-consumer queue that
+// hands items over without taking a lock unless one of the sides has
+// to park.
+template<typename T>
+class Ring_buffer {
+public:
+    explicit Ring_buffer(std::size_t capacity)
+        : capacity_{std::max(capacity, std::size_t{1})}, slots_(capacity_), limit_{capacity_}
+    {}
+
+    Ring_buffer(const Ring_buffer &) = delete;
+
+    Ring_buffer &operator=(const Ring_buffer &) = delete;
+
+    Ring_buffer(Ring_buffer &&) = delete;
+
+    Ring_buffer &operator=(Ring_buffer &&) = delete;
+
+    ~Ring_buffer() = default;
+
+    // Pushes the specified item to the buffer. Blocks while the buffer
+    // is full; returns false without pushing if @p cancelled returns
+    // true in the meantime.
+    template<typename Pred>
+    bool push(T item, Pred cancelled)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+        auto has_room = [this, tail] {
+            return tail - head_.load(std::memory_order_acquire) <
+                   limit_.load(std::memory_order_relaxed);
+        };
+
+        if (!has_room()) {
+            producer_.wait(mutex_, producer_condition_, [&has_room, &cancelled] {
+                return has_room() || cancelled();
+            });
+        }
+
+        if (cancelled()) {
+            return false;
+        }
+
+        slots_[tail % capacity_] = std::move(item);
+
+        tail_.store(tail + 1);
+
+        consumer_.notify(mutex_, consumer_condition_);
+
+        return true;
+    }
+
+    // Pops the next item from the buffer. Blocks while the buffer is
+    // empty; returns an empty optional once the buffer is empty and
+    // closed.
+    std::optional<T> pop()
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+
+        auto has_item = [this, head] {
+            return tail_.load(std::memory_order_acquire) != head;
+        };
+
+        if (!has_item()) {
+            consumer_.wait(mutex_, consumer_condition_, [this, &has_item] {
+                return has_item() || closed_.load(std::memory_order_acquire);
+            });
+
+            if (!has_item()) {
+                return {};
+            }
+        }
+
+        std::optional<T> item = std::move(slots_[head % capacity_]);
+
+        slots_[head % capacity_] = T{};
+
+        head_.store(head + 1);
+
+        producer_.notify(mutex_, producer_condition_);
+
+        return item;
+    }
+
+    // Marks the buffer as closed; the consumer will drain the remaining
+    // items and then stop waiting for new ones.
+    void close()
+    {
+        closed_.store(true);
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+        }
+
+        consumer_condition_.notify_one();
+    }
+
+    // Wakes up the producer so that it can re-evaluate its cancellation
+    // predicate.
+    void interrupt()
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+        }
+
+        producer_condition_.notify_one();
+    }
+
+    // Discards the items in the buffer. Must be called from the
+    // consumer side.
+    void clear()
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+
+        for (; head != tail; head++) {
+            slots_[head % capacity_] = T{};
+        }
+
+        head_.store(head);
+
+        interrupt();
+    }
+
+    // Limits the number of items the buffer can hold to @p limit
+    // without reallocating it. The limit is clamped to the capacity.
+    void set_limit(std::size_t limit)
+    {
+        limit_.store(std::clamp(limit, std::size_t{1}, capacity_), std::memory_order_relaxed);
+
+        interrupt();
+    }
+
+    // Returns the number of items in the buffer. The value is only a
+    // snapshot when called while either side is active.
+    std::size_t size() const noexcept
+    {
+        std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+
+        return tail - head;
+    }
+
+    // Resets the buffer to its initial state. Must be called while
+    // neither side is active.
+    void reset() noexcept
+    {
+        std::fill(slots_.begin(), slots_.end(), T{});
+
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+
+        closed_.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t cache_line_size_ = 64;
+
+    const std::size_t capacity_;
+    std::vector<T> slots_;
+    std::atomic_size_t limit_;
+    alignas(cache_line_size_) std::atomic_size_t head_{};
+    Spin_then_park_waiter consumer_{};
+    alignas(cache_line_size_) std::atomic_size_t tail_{};
+    Spin_then_park_waiter producer_{};
+    alignas(cache_line_size_) std::atomic_bool closed_{};
+    std::mutex mutex_{};
+    std::condition_variable producer_condition_{};
+    std::condition_variable consumer_condition_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
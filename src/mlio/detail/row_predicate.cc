@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/row_predicate.h"
+
+#include <stdexcept>
+
+#include "mlio/util/number.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Row_predicate::Row_predicate(const Row_filter &filter) : op_{filter.op}, value_{filter.value}
+{
+    switch (op_) {
+    case Filter_op::equal:
+    case Filter_op::not_equal:
+    case Filter_op::less:
+    case Filter_op::less_equal:
+    case Filter_op::greater:
+    case Filter_op::greater_equal:
+        break;
+
+    default:
+        throw std::invalid_argument{"The specified filter operator is invalid."};
+    }
+
+    double number{};
+    if (try_parse_float(value_, number) == Parse_result::ok) {
+        number_ = number;
+    }
+}
+
+bool Row_predicate::operator()(std::string_view value) const noexcept
+{
+    if (number_) {
+        double number{};
+        // A field that is not a number only differs from the constant.
+        if (try_parse_float(value, number) != Parse_result::ok) {
+            return op_ == Filter_op::not_equal;
+        }
+        return compare(number, *number_);
+    }
+    return compare(value, std::string_view{value_});
+}
+
+// The equal and not-equal filters are meant to match the numeric fields
+// that parse to exactly the specified constant.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+
+template<typename T>
+inline bool Row_predicate::compare(const T &lhs, const T &rhs) const noexcept
+{
+    switch (op_) {
+    case Filter_op::equal:
+        return lhs == rhs;
+    case Filter_op::not_equal:
+        return lhs != rhs;
+    case Filter_op::less:
+        return lhs < rhs;
+    case Filter_op::less_equal:
+        return lhs <= rhs;
+    case Filter_op::greater:
+        return lhs > rhs;
+    case Filter_op::greater_equal:
+        return lhs >= rhs;
+    }
+    return false;
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Evaluates a Row_filter on the string value of a field.
+class Row_predicate {
+public:
+    explicit Row_predicate(const Row_filter &filter);
+
+    bool operator()(std::string_view value) const noexcept;
+
+private:
+    template<typename T>
+    bool compare(const T &lhs, const T &rhs) const noexcept;
+
+    Filter_op op_;
+    std::string value_;
+    // Set if the constant is a number.
+    std::optional<double> number_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::array<std::uint32_t, 64> round_constants{
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U,
+    0xab1c5ed5U, 0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU,
+    0x9bdc06a7U, 0xc19bf174U, 0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU,
+    0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU, 0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U,
+    0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U, 0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU,
+    0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U, 0xa2bfe8a1U, 0xa81a664bU,
+    0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U, 0x19a4c116U,
+    0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+    0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U,
+    0xc67178f2U,
+};
+
+constexpr std::array<std::uint32_t, 8> initial_state{
+    0x6a09e667U,
+    0xbb67ae85U,
+    0x3c6ef372U,
+    0xa54ff53aU,
+    0x510e527fU,
+    0x9b05688cU,
+    0x1f83d9abU,
+    0x5be0cd19U,
+};
+
+inline std::uint32_t rotr(std::uint32_t x, unsigned n) noexcept
+{
+    return (x >> n) | (x << (32U - n));
+}
+
+inline std::uint32_t load_be32(const std::byte *p) noexcept
+{
+    return (std::to_integer<std::uint32_t>(p[0]) << 24U) |
+           (std::to_integer<std::uint32_t>(p[1]) << 16U) |
+           (std::to_integer<std::uint32_t>(p[2]) << 8U) | std::to_integer<std::uint32_t>(p[3]);
+}
+
+inline void store_be32(std::byte *p, std::uint32_t x) noexcept
+{
+    p[0] = static_cast<std::byte>(x >> 24U);
+    p[1] = static_cast<std::byte>(x >> 16U);
+    p[2] = static_cast<std::byte>(x >> 8U);
+    p[3] = static_cast<std::byte>(x);
+}
+
+}  // namespace
+
+Sha256::Sha256() noexcept
+{
+    reset();
+}
+
+void Sha256::reset() noexcept
+{
+    state_ = initial_state;
+
+    buffer_size_ = 0;
+
+    num_bytes_ = 0;
+}
+
+void Sha256::update(Memory_span bits) noexcept
+{
+    const std::byte *pos = bits.data();
+    const std::byte *end = bits.data() + bits.size();
+
+    num_bytes_ += bits.size();
+
+    if (buffer_size_ > 0) {
+        std::size_t n = std::min(buffer_.size() - buffer_size_, bits.size());
+
+        std::memcpy(buffer_.data() + buffer_size_, pos, n);
+
+        buffer_size_ += n;
+
+        pos += n;
+
+        if (buffer_size_ < buffer_.size()) {
+            return;
+        }
+
+        compress(buffer_.data());
+
+        buffer_size_ = 0;
+    }
+
+    // Compress the full blocks in place without buffering them.
+    for (; end - pos >= 64; pos += 64) {
+        compress(pos);
+    }
+
+    buffer_size_ = static_cast<std::size_t>(end - pos);
+
+    std::memcpy(buffer_.data(), pos, buffer_size_);
+}
+
+std::array<std::byte, 32> Sha256::finish() noexcept
+{
+    std::uint64_t num_bits = num_bytes_ * 8;
+
+    buffer_[buffer_size_++] = std::byte{0x80};
+
+    auto pad = buffer_.begin() + static_cast<std::ptrdiff_t>(buffer_size_);
+
+    if (buffer_size_ > 56) {
+        std::fill(pad, buffer_.end(), std::byte{});
+
+        compress(buffer_.data());
+
+        pad = buffer_.begin();
+    }
+
+    std::fill(pad, buffer_.begin() + 56, std::byte{});
+
+    store_be32(buffer_.data() + 56, static_cast<std::uint32_t>(num_bits >> 32U));
+    store_be32(buffer_.data() + 60, static_cast<std::uint32_t>(num_bits));
+
+    compress(buffer_.data());
+
+    std::array<std::byte, 32> digest{};
+    for (std::size_t i = 0; i < state_.size(); i++) {
+        store_be32(digest.data() + i * 4, state_[i]);
+    }
+
+    return digest;
+}
+
+void Sha256::compress(const std::byte *block) noexcept
+{
+    std::array<std::uint32_t, 64> w{};
+
+    for (std::size_t i = 0; i < 16; i++) {
+        w[i] = load_be32(block + i * 4);
+    }
+
+    for (std::size_t i = 16; i < 64; i++) {
+        std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3U);
+        std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10U);
+
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state_;
+
+    for (std::size_t i = 0; i < 64; i++) {
+        std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        std::uint32_t ch = (e & f) ^ (~e & g);
+        std::uint32_t t1 = h + s1 + ch + round_constants[i] + w[i];
+        std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        std::uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "mlio/config.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Computes the SHA-256 digest of a byte sequence fed in pieces.
+class MLIO_HIDDEN Sha256 {
+public:
+    Sha256() noexcept;
+
+    void update(Memory_span bits) noexcept;
+
+    // Returns the digest of the bytes fed so far; the instance must be
+    // reset before it can be fed again.
+    std::array<std::byte, 32> finish() noexcept;
+
+    void reset() noexcept;
+
+private:
+    void compress(const std::byte *block) noexcept;
+
+    std::array<std::uint32_t, 8> state_{};
+    std::array<std::byte, 64> buffer_{};
+    std::size_t buffer_size_{};
+    std::uint64_t num_bytes_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,320 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/shared_memory_segment.h"
+
+#include <cerrno>
+#include <ctime>
+#include <new>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fmt/format.h>
+
+#include "mlio/config.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/detail/error.h"
+#include "mlio/detail/file_descriptor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::size_t cache_line_size = 64;
+constexpr std::size_t page_size = 4096;
+
+constexpr std::size_t align(std::size_t value, std::size_t alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+[[noreturn]] void throw_system_error(const std::string &name, std::string_view action)
+{
+    throw std::system_error{
+        current_error_code(),
+        fmt::format("The shared memory segment '{0}' cannot be {1}.", name, action)};
+}
+
+void check_pthread_call(int r)
+{
+    if (r != 0) {
+        throw std::system_error{r, std::generic_category()};
+    }
+}
+
+// Returns the process id of the server that created the specified
+// segment, or zero if the segment has not been initialized.
+::pid_t read_server_pid(const std::string &name) noexcept
+{
+    File_descriptor fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (!fd.is_open()) {
+        return 0;
+    }
+
+    struct ::stat buf {};
+    if (::fstat(fd.get(), &buf) != 0 ||
+        static_cast<std::size_t>(buf.st_size) < sizeof(Segment_header)) {
+        return 0;
+    }
+
+    void *addr = ::mmap(nullptr, sizeof(Segment_header), PROT_READ, MAP_SHARED, fd.get(), 0);
+    if (addr == MAP_FAILED) {
+        return 0;
+    }
+
+    const auto *hdr = static_cast<const Segment_header *>(addr);
+
+    ::pid_t pid = 0;
+    if (hdr->magic.load(std::memory_order_acquire) == segment_magic) {
+        pid = hdr->server_pid;
+    }
+
+    ::munmap(addr, sizeof(Segment_header));
+
+    return pid;
+}
+
+}  // namespace
+
+Shared_memory_segment::Shared_memory_segment(std::string name, bool owner)
+    : name_{std::move(name)}, owner_{owner}
+{}
+
+Shared_memory_segment::~Shared_memory_segment()
+{
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+Intrusive_ptr<Shared_memory_segment> Shared_memory_segment::create(const std::string &name,
+                                                                   std::size_t num_clients,
+                                                                   std::size_t num_slots,
+                                                                   std::size_t slot_size,
+                                                                   std::size_t schema_size)
+{
+    File_descriptor fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (!fd.is_open() && errno == EEXIST) {
+        ::pid_t pid = read_server_pid(name);
+        if (pid != 0 && is_process_alive(pid)) {
+            throw Data_reader_error{fmt::format(
+                "The shared memory segment '{0}' is already in use by the process {1}.", name, pid)};
+        }
+
+        // The segment was left over by a server that did not exit
+        // cleanly.
+        ::shm_unlink(name.c_str());
+
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (!fd.is_open()) {
+        throw_system_error(name, "created");
+    }
+
+    auto segment = wrap_intrusive(new Shared_memory_segment{name, true});
+
+    segment->init_layout(num_clients, num_slots, slot_size, schema_size);
+
+    std::size_t size = segment->data_offset_ + num_slots * slot_size;
+
+    if (::ftruncate(fd.get(), static_cast<::off_t>(size)) != 0) {
+        throw_system_error(name, "resized");
+    }
+
+    segment->map(fd.get(), size);
+
+    segment->init_header(num_clients, num_slots, slot_size, schema_size);
+
+    return segment;
+}
+
+Intrusive_ptr<Shared_memory_segment> Shared_memory_segment::open(const std::string &name)
+{
+    File_descriptor fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (!fd.is_open()) {
+        throw_system_error(name, "opened");
+    }
+
+    struct ::stat buf {};
+    if (::fstat(fd.get(), &buf) != 0) {
+        throw_system_error(name, "opened");
+    }
+
+    auto size = static_cast<std::size_t>(buf.st_size);
+    if (size < sizeof(Segment_header)) {
+        throw Data_reader_error{
+            fmt::format("The shared memory segment '{0}' has not been initialized.", name)};
+    }
+
+    auto segment = wrap_intrusive(new Shared_memory_segment{name, false});
+
+    segment->map(fd.get(), size);
+
+    Segment_header &hdr = segment->header();
+    if (hdr.magic.load(std::memory_order_acquire) != segment_magic) {
+        throw Data_reader_error{
+            fmt::format("The shared memory segment '{0}' has not been initialized.", name)};
+    }
+
+    segment->init_layout(hdr.num_clients, hdr.num_slots, hdr.slot_size, hdr.schema_size);
+
+    if (size < segment->data_offset_ + hdr.num_slots * hdr.slot_size) {
+        throw Data_reader_error{
+            fmt::format("The shared memory segment '{0}' is truncated.", name)};
+    }
+
+    return segment;
+}
+
+void Shared_memory_segment::map(int fd, std::size_t size)
+{
+    void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        throw_system_error(name_, "mapped");
+    }
+
+    data_ = static_cast<std::byte *>(addr);
+    size_ = size;
+}
+
+void Shared_memory_segment::init_layout(std::size_t num_clients,
+                                        std::size_t num_slots,
+                                        std::size_t slot_size,
+                                        std::size_t schema_size) noexcept
+{
+    clients_offset_ = align(sizeof(Segment_header), cache_line_size);
+
+    slots_offset_ = align(clients_offset_ + num_clients * sizeof(Client_state), cache_line_size);
+
+    schema_offset_ = align(slots_offset_ + num_slots * sizeof(Slot_header), cache_line_size);
+
+    // Each slot starts on a page boundary.
+    data_offset_ = align(schema_offset_ + schema_size, page_size);
+
+    slot_size_ = slot_size;
+}
+
+void Shared_memory_segment::init_header(std::size_t num_clients,
+                                        std::size_t num_slots,
+                                        std::size_t slot_size,
+                                        std::size_t schema_size)
+{
+    auto *hdr = new (data_) Segment_header{};
+
+    hdr->num_clients = num_clients;
+    hdr->num_slots = num_slots;
+    hdr->slot_size = slot_size;
+    hdr->schema_size = schema_size;
+    hdr->server_pid = ::getpid();
+
+    ::pthread_mutexattr_t mutex_attr{};
+    check_pthread_call(::pthread_mutexattr_init(&mutex_attr));
+    check_pthread_call(::pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED));
+#ifdef MLIO_PLATFORM_LINUX
+    // Lets the other processes recover the mutex if its owner dies.
+    check_pthread_call(::pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST));
+#endif
+    check_pthread_call(::pthread_mutex_init(&hdr->mutex, &mutex_attr));
+    ::pthread_mutexattr_destroy(&mutex_attr);
+
+    ::pthread_condattr_t cond_attr{};
+    check_pthread_call(::pthread_condattr_init(&cond_attr));
+    check_pthread_call(::pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED));
+    check_pthread_call(::pthread_cond_init(&hdr->cond, &cond_attr));
+    ::pthread_condattr_destroy(&cond_attr);
+
+    for (std::size_t i = 0; i < num_clients; i++) {
+        new (&client(i)) Client_state{};
+    }
+    for (std::size_t i = 0; i < num_slots; i++) {
+        new (&slot(i)) Slot_header{};
+    }
+}
+
+void Shared_memory_segment::publish() noexcept
+{
+    header().magic.store(segment_magic, std::memory_order_release);
+}
+
+void Shared_memory_segment::lock()
+{
+    int r = ::pthread_mutex_lock(&header().mutex);
+#ifdef MLIO_PLATFORM_LINUX
+    if (r == EOWNERDEAD) {
+        // The state guarded by the mutex is updated in small steps that
+        // leave it consistent; the dead process might have only held a
+        // slot, which gets reclaimed.
+        r = ::pthread_mutex_consistent(&header().mutex);
+    }
+#endif
+    check_pthread_call(r);
+}
+
+void Shared_memory_segment::unlock() noexcept
+{
+    ::pthread_mutex_unlock(&header().mutex);
+}
+
+bool Shared_memory_segment::wait_for(std::unique_lock<Shared_memory_segment> & /*lock*/,
+                                     std::chrono::milliseconds timeout)
+{
+    // Process-shared condition variables use the realtime clock unless
+    // configured otherwise, which is not portable.
+    ::timespec deadline{};
+    ::clock_gettime(CLOCK_REALTIME, &deadline);
+
+    auto ns = deadline.tv_nsec + std::chrono::nanoseconds{timeout}.count();
+
+    deadline.tv_sec += ns / 1'000'000'000;
+    deadline.tv_nsec = ns % 1'000'000'000;
+
+    int r = ::pthread_cond_timedwait(&header().cond, &header().mutex, &deadline);
+#ifdef MLIO_PLATFORM_LINUX
+    if (r == EOWNERDEAD) {
+        r = ::pthread_mutex_consistent(&header().mutex);
+    }
+#endif
+    if (r == ETIMEDOUT) {
+        return false;
+    }
+    check_pthread_call(r);
+
+    return true;
+}
+
+void Shared_memory_segment::notify_all() noexcept
+{
+    ::pthread_cond_broadcast(&header().cond);
+}
+
+bool is_process_alive(::pid_t pid) noexcept
+{
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// The shared memory segment of a reader server consists of a header,
+// the state of each client, the state of each slot, the serialized
+// schema, and the slots that hold the serialized examples. All fields
+// except the immutable ones are guarded by the mutex in the header.
+enum class Slot_state : std::uint32_t {
+    free,
+    // The server is copying an example into the slot.
+    writing,
+    ready,
+    // The example is held by a client.
+    in_use
+};
+
+struct Segment_header {
+    // Written last by the server; a client only uses a segment whose
+    // magic number is set.
+    std::atomic<std::uint64_t> magic{};
+    std::uint64_t num_clients{};
+    std::uint64_t num_slots{};
+    std::uint64_t slot_size{};
+    std::uint64_t schema_size{};
+    std::uint64_t distribution{};
+    ::pid_t server_pid{};
+    ::pthread_mutex_t mutex{};
+    ::pthread_cond_t cond{};
+    // The epoch the server is reading.
+    std::uint64_t epoch{};
+    // Indicates whether all examples of the epoch have been published.
+    bool epoch_complete{};
+    bool stopped{};
+    // The error message of the server if it has failed.
+    std::array<char, 512> error{};
+};
+
+struct Client_state {
+    static constexpr std::uint64_t no_epoch = std::numeric_limits<std::uint64_t>::max();
+
+    ::pid_t pid{};
+    bool attached{};
+    std::uint64_t epoch{};
+};
+
+struct Slot_header {
+    Slot_state state{};
+    ::pid_t owner_pid{};
+    std::uint64_t client{};
+    std::uint64_t epoch{};
+    std::uint64_t sequence{};
+    std::uint64_t size{};
+};
+
+inline constexpr std::uint64_t segment_magic = 0x314d'4853'4f49'4c4d;  // "MLIOSHM1"
+
+// Represents a POSIX shared memory segment mapped into the address space
+// of the process. The segment satisfies the BasicLockable requirements
+// so that it can be locked via std::unique_lock.
+class Shared_memory_segment : public Intrusive_ref_counter<Shared_memory_segment> {
+public:
+    // Creates a segment that will be unlinked once the returned object
+    // gets destroyed. If a segment with the same name was left over by a
+    // process that no longer exists, it is replaced.
+    static Intrusive_ptr<Shared_memory_segment> create(const std::string &name,
+                                                       std::size_t num_clients,
+                                                       std::size_t num_slots,
+                                                       std::size_t slot_size,
+                                                       std::size_t schema_size);
+
+    // Attaches to a segment created by another process.
+    static Intrusive_ptr<Shared_memory_segment> open(const std::string &name);
+
+    Shared_memory_segment(const Shared_memory_segment &) = delete;
+
+    Shared_memory_segment &operator=(const Shared_memory_segment &) = delete;
+
+    Shared_memory_segment(Shared_memory_segment &&) = delete;
+
+    Shared_memory_segment &operator=(Shared_memory_segment &&) = delete;
+
+    ~Shared_memory_segment();
+
+    // Marks the segment as ready to be opened by clients.
+    void publish() noexcept;
+
+    void lock();
+
+    void unlock() noexcept;
+
+    // Returns false if the timeout has expired.
+    bool wait_for(std::unique_lock<Shared_memory_segment> &lock, std::chrono::milliseconds timeout);
+
+    void notify_all() noexcept;
+
+    Segment_header &header() noexcept
+    {
+        return *reinterpret_cast<Segment_header *>(data_);
+    }
+
+    Client_state &client(std::size_t index) noexcept
+    {
+        return reinterpret_cast<Client_state *>(data_ + clients_offset_)[index];
+    }
+
+    Slot_header &slot(std::size_t index) noexcept
+    {
+        return reinterpret_cast<Slot_header *>(data_ + slots_offset_)[index];
+    }
+
+    std::byte *slot_data(std::size_t index) noexcept
+    {
+        return data_ + data_offset_ + index * slot_size_;
+    }
+
+    std::byte *schema_data() noexcept
+    {
+        return data_ + schema_offset_;
+    }
+
+    const std::string &name() const noexcept
+    {
+        return name_;
+    }
+
+private:
+    explicit Shared_memory_segment(std::string name, bool owner);
+
+    void map(int fd, std::size_t size);
+
+    void init_layout(std::size_t num_clients,
+                     std::size_t num_slots,
+                     std::size_t slot_size,
+                     std::size_t schema_size) noexcept;
+
+    void init_header(std::size_t num_clients,
+                     std::size_t num_slots,
+                     std::size_t slot_size,
+                     std::size_t schema_size);
+
+    std::string name_;
+    bool owner_;
+    std::byte *data_{};
+    std::size_t size_{};
+    std::size_t clients_offset_{};
+    std::size_t slots_offset_{};
+    std::size_t schema_offset_{};
+    std::size_t data_offset_{};
+    std::size_t slot_size_{};
+};
+
+// Returns a boolean value indicating whether the specified process is
+// still running.
+bool is_process_alive(::pid_t pid) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
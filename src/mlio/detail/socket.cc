@@ -0,0 +1,271 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/socket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <fmt/format.h>
+
+#include "mlio/config.h"
+#include "mlio/detail/error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0;
+#endif
+
+#ifdef SOCK_CLOEXEC
+constexpr int socket_flags = SOCK_CLOEXEC;
+#else
+constexpr int socket_flags = 0;
+#endif
+
+// The maximum number of buffers passed to a single sendmsg() call.
+constexpr std::size_t max_iov_count = 64;
+
+struct Addrinfo_deleter {
+    void operator()(::addrinfo *info) const noexcept
+    {
+        ::freeaddrinfo(info);
+    }
+};
+
+using Addrinfo_ptr = std::unique_ptr<::addrinfo, Addrinfo_deleter>;
+
+Addrinfo_ptr resolve(const std::string &host, const std::string &port, int flags)
+{
+    ::addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = flags;
+
+    ::addrinfo *info{};
+
+    int r = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &info);
+    if (r != 0) {
+        throw std::invalid_argument{
+            fmt::format("The address '{0}:{1}' cannot be resolved: {2}", host, port, ::gai_strerror(r))};
+    }
+
+    return Addrinfo_ptr{info};
+}
+
+void configure_socket(int fd) noexcept
+{
+    int one = 1;
+
+    // The examples are sent as a whole; do not delay the last segment.
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+#ifdef SO_NOSIGPIPE
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+}  // namespace
+
+File_descriptor connect_tcp(const std::string &address)
+{
+    auto pos = address.rfind(':');
+    if (pos == std::string::npos) {
+        throw std::invalid_argument{
+            fmt::format("The address '{0}' must be in the form of 'host:port'.", address)};
+    }
+
+    std::string host = address.substr(0, pos);
+
+    // Strip the brackets of an IPv6 address.
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    Addrinfo_ptr info = resolve(host, address.substr(pos + 1), 0);
+
+    std::error_code err{};
+
+    for (::addrinfo *ai = info.get(); ai != nullptr; ai = ai->ai_next) {
+        File_descriptor fd = ::socket(ai->ai_family, ai->ai_socktype | socket_flags, ai->ai_protocol);
+        if (!fd.is_open()) {
+            err = current_error_code();
+
+            continue;
+        }
+
+        int r{};
+        do {
+            r = ::connect(fd.get(), ai->ai_addr, ai->ai_addrlen);
+        } while (r == -1 && errno == EINTR);
+
+        if (r == 0) {
+            configure_socket(fd.get());
+
+            return fd;
+        }
+
+        err = current_error_code();
+    }
+
+    throw std::system_error{err, fmt::format("The address '{0}' cannot be connected.", address)};
+}
+
+File_descriptor listen_tcp(const std::string &host, std::uint16_t &port)
+{
+    Addrinfo_ptr info = resolve(host, std::to_string(port), AI_PASSIVE);
+
+    std::error_code err{};
+
+    for (::addrinfo *ai = info.get(); ai != nullptr; ai = ai->ai_next) {
+        File_descriptor fd = ::socket(ai->ai_family, ai->ai_socktype | socket_flags, ai->ai_protocol);
+        if (!fd.is_open()) {
+            err = current_error_code();
+
+            continue;
+        }
+
+        int one = 1;
+        ::setsockopt(fd.get(), SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (::bind(fd.get(), ai->ai_addr, ai->ai_addrlen) != 0 || ::listen(fd.get(), SOMAXCONN) != 0) {
+            err = current_error_code();
+
+            continue;
+        }
+
+        ::sockaddr_storage addr{};
+        ::socklen_t addr_len = sizeof(addr);
+        if (::getsockname(fd.get(), reinterpret_cast<::sockaddr *>(&addr), &addr_len) == 0) {
+            if (addr.ss_family == AF_INET) {
+                port = ntohs(reinterpret_cast<::sockaddr_in *>(&addr)->sin_port);
+            }
+            else if (addr.ss_family == AF_INET6) {
+                port = ntohs(reinterpret_cast<::sockaddr_in6 *>(&addr)->sin6_port);
+            }
+        }
+
+        return fd;
+    }
+
+    throw std::system_error{err, fmt::format("The port {0} cannot be listened on.", port)};
+}
+
+void send_all(int fd, stdx::span<const Memory_span> buffers)
+{
+    std::vector<::iovec> iov{};
+    iov.reserve(buffers.size());
+
+    for (const Memory_span &buf : buffers) {
+        if (!buf.empty()) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            iov.push_back(::iovec{const_cast<std::byte *>(buf.data()), buf.size()});
+        }
+    }
+
+    auto pos = iov.begin();
+
+    while (pos != iov.end()) {
+        ::msghdr msg{};
+        msg.msg_iov = &*pos;
+        msg.msg_iovlen = std::min(as_size(iov.end() - pos), max_iov_count);
+
+        ::ssize_t num_bytes_sent = ::sendmsg(fd, &msg, send_flags);
+        if (num_bytes_sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{current_error_code(), "The data cannot be sent."};
+        }
+
+        // Skip the buffers that have been sent completely and adjust the
+        // one that has been sent partially.
+        auto remaining = as_size(num_bytes_sent);
+        while (pos != iov.end() && remaining >= pos->iov_len) {
+            remaining -= pos->iov_len;
+
+            ++pos;
+        }
+        if (remaining > 0) {
+            pos->iov_base = static_cast<std::byte *>(pos->iov_base) + remaining;
+            pos->iov_len -= remaining;
+        }
+    }
+}
+
+bool recv_all(int fd, void *data, std::size_t size)
+{
+    auto *pos = static_cast<std::byte *>(data);
+    auto *end = pos + size;
+
+    while (pos < end) {
+        ::ssize_t num_bytes_read = ::recv(fd, pos, as_size(end - pos), 0);
+        if (num_bytes_read == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{current_error_code(), "The data cannot be received."};
+        }
+
+        if (num_bytes_read == 0) {
+            if (pos == static_cast<std::byte *>(data)) {
+                return false;
+            }
+            throw std::system_error{std::make_error_code(std::errc::connection_reset),
+                                    "The connection has been closed in the middle of a message."};
+        }
+
+        pos += num_bytes_read;
+    }
+
+    return true;
+}
+
+bool is_readable(int fd)
+{
+    ::pollfd pfd{fd, POLLIN, 0};
+
+    int r{};
+    do {
+        r = ::poll(&pfd, 1, 0);
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1) {
+        throw std::system_error{current_error_code(), "The socket cannot be polled."};
+    }
+
+    return r > 0;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
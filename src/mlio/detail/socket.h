@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mlio/detail/file_descriptor.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Connects to the specified TCP address in the form of "host:port".
+File_descriptor connect_tcp(const std::string &address);
+
+// Listens on the specified host and port; if the port is zero, an
+// ephemeral port is chosen and stored in port.
+File_descriptor listen_tcp(const std::string &host, std::uint16_t &port);
+
+// Sends the specified buffers with a single gather write where
+// possible, so that the tensor buffers do not have to be copied into a
+// contiguous message.
+void send_all(int fd, stdx::span<const Memory_span> buffers);
+
+// Returns false if the peer has closed the connection before the first
+// byte was received.
+bool recv_all(int fd, void *data, std::size_t size);
+
+// Returns a boolean value indicating whether the socket has data to
+// read, or has been closed by the peer, without blocking.
+bool is_readable(int fd);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/store_metrics.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#include "mlio/data_stores/data_store.h"
+#include "mlio/instance_batch.h"
+#include "mlio/logger.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// A data store has to be read for at least this long before its
+// throughput is evaluated; otherwise a few slow requests at the start
+// would be enough to report it.
+constexpr std::uint64_t min_evaluation_ns = 1'000'000'000;
+
+}  // namespace
+
+Store_metrics::Store_metrics(const Data_reader_params &params) : params_{&params}
+{}
+
+void Store_metrics::add_reads(const Data_store &store, const Read_counters &counters)
+{
+    std::optional<Store_stats> slow_stats{};
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        Entry &entry = entries_[&store];
+
+        entry.reads.num_records += counters.num_records;
+        entry.reads.num_record_bytes += counters.num_record_bytes;
+        entry.reads.read_ns += counters.read_ns;
+
+        if (params_->min_store_throughput == 0 || entry.is_reported_slow ||
+            entry.reads.read_ns < min_evaluation_ns) {
+            return;
+        }
+
+        Store_stats stats = make_stats(store, entry);
+        if (stats.bytes_per_second >= static_cast<double>(params_->min_store_throughput)) {
+            return;
+        }
+
+        entry.is_reported_slow = true;
+
+        slow_stats = std::move(stats);
+    }
+
+    // The handler is called without holding the lock so that it can
+    // query the statistics of the reader.
+    report_slow_store(*slow_stats);
+}
+
+void Store_metrics::add_open(const Data_store &store, std::uint64_t open_ns)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    Entry &entry = entries_[&store];
+
+    entry.num_opens++;
+    entry.open_ns += open_ns;
+}
+
+void Store_metrics::add_decoded_batch(const Instance_batch &batch)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        entries_[&batch.data_store(i)].num_bytes_read += batch.bits(i).size();
+    }
+}
+
+std::vector<Store_stats> Store_metrics::stats() const
+{
+    std::vector<Store_stats> stats{};
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        stats.reserve(entries_.size());
+
+        for (auto &[store, entry] : entries_) {
+            stats.emplace_back(make_stats(*store, entry));
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const auto &a, const auto &b) {
+        return a.id < b.id;
+    });
+
+    return stats;
+}
+
+void Store_metrics::reset() noexcept
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    entries_.clear();
+}
+
+Store_stats Store_metrics::make_stats(const Data_store &store, const Entry &entry)
+{
+    Store_stats stats{};
+
+    stats.id = store.id();
+    stats.num_bytes_read = entry.num_bytes_read;
+    stats.num_records = entry.reads.num_records;
+    stats.num_record_bytes = entry.reads.num_record_bytes;
+    stats.read_ns = entry.reads.read_ns;
+    stats.num_opens = entry.num_opens;
+    stats.open_ns = entry.open_ns;
+
+    if (stats.read_ns > 0) {
+        stats.bytes_per_second = static_cast<double>(stats.num_record_bytes) * 1e9 /
+                                 static_cast<double>(stats.read_ns);
+    }
+
+    return stats;
+}
+
+void Store_metrics::report_slow_store(const Store_stats &stats) const
+{
+    if (params_->slow_store_handler) {
+        params_->slow_store_handler(stats);
+    }
+    else {
+        logger::warn(
+            "The data store '{0}' is read at {1:.0f} bytes per second which is below the minimum of {2:n} bytes per second.",
+            stats.id,
+            stats.bytes_per_second,
+            params_->min_store_throughput);
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
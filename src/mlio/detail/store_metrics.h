@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/reader_stats.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Collects the progress and the throughput of the data stores read by
+// a data reader, and reports the data stores that are read slower than
+// Data_reader_params::min_store_throughput. Safe to call from any
+// thread.
+class Store_metrics {
+public:
+    // Holds the counters that a reader accumulates locally before it
+    // adds them in one go.
+    struct Read_counters {
+        std::uint64_t num_records{};
+        std::uint64_t num_record_bytes{};
+        std::uint64_t read_ns{};
+    };
+
+private:
+    struct Entry {
+        std::size_t num_bytes_read{};
+        Read_counters reads{};
+        std::uint64_t num_opens{};
+        std::uint64_t open_ns{};
+        bool is_reported_slow{};
+    };
+
+public:
+    explicit Store_metrics(const Data_reader_params &params);
+
+    void add_reads(const Data_store &store, const Read_counters &counters);
+
+    void add_open(const Data_store &store, std::uint64_t open_ns);
+
+    void add_decoded_batch(const Instance_batch &batch);
+
+    // Returns the statistics of the data stores sorted by their ids.
+    std::vector<Store_stats> stats() const;
+
+    void reset() noexcept;
+
+private:
+    static Store_stats make_stats(const Data_store &store, const Entry &entry);
+
+    void report_slow_store(const Store_stats &stats) const;
+
+    const Data_reader_params *params_;
+    mutable std::mutex mutex_{};
+    std::unordered_map<const Data_store *, Entry> entries_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
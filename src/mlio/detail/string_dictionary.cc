@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/string_dictionary.h"
+
+#include <limits>
+#include <mutex>
+
+#include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+void String_dictionary::encode(stdx::span<const std::string_view> fields,
+                               std::size_t stride,
+                               stdx::span<const Row_state> row_states,
+                               std::int32_t *codes)
+{
+    // The values of a categorical column are mostly found in the
+    // dictionary; therefore we look all of them up under a shared lock
+    // first and only take the exclusive lock for the missing ones.
+    std::vector<std::size_t> missing_rows{};
+
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+
+        for (std::size_t i = 0; i < row_states.size(); i++) {
+            if (row_states[i] != Row_state::good) {
+                continue;
+            }
+
+            auto pos = codes_.find(fields[i * stride]);
+            if (pos == codes_.end()) {
+                missing_rows.emplace_back(i);
+            }
+            else {
+                codes[i] = pos->second;
+            }
+        }
+    }
+
+    if (missing_rows.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+
+    for (std::size_t i : missing_rows) {
+        std::string_view field = fields[i * stride];
+
+        // Another task might have added the value in the meantime.
+        auto pos = codes_.find(field);
+        if (pos != codes_.end()) {
+            codes[i] = pos->second;
+
+            continue;
+        }
+
+        if (values_.size() == std::numeric_limits<std::int32_t>::max()) {
+            throw Not_supported_error{
+                "The dictionary of the column cannot hold more than 2^31 - 1 values."};
+        }
+
+        auto code = static_cast<std::int32_t>(values_.size());
+
+        codes_.emplace(values_.emplace_back(field), code);
+
+        codes[i] = code;
+    }
+}
+
+std::vector<std::string> String_dictionary::values() const
+{
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+
+    return {values_.begin(), values_.end()};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
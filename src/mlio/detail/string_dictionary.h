@@ -0,0 +1,59 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/parser.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Maps the distinct values of a column to consecutive int32 codes. The
+/// dictionary is shared by the decode tasks of all batches; a value
+/// keeps its code for the lifetime of the dictionary.
+class String_dictionary {
+public:
+    /// Encodes the fields at position `i * stride` of the rows in the
+    /// `good` state and writes their codes to `codes[i]`.
+    void encode(stdx::span<const std::string_view> fields,
+                std::size_t stride,
+                stdx::span<const Row_state> row_states,
+                std::int32_t *codes);
+
+    /// Returns the values of the dictionary ordered by their codes.
+    std::vector<std::string> values() const;
+
+private:
+    mutable std::shared_mutex mutex_{};
+    std::unordered_map<std::string_view, std::int32_t> codes_{};
+    // Owns the keys of the map; unlike a vector a deque never moves its
+    // elements.
+    std::deque<std::string> values_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
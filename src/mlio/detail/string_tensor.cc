@@ -0,0 +1,64 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/detail/string_tensor.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_type.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Intrusive_ptr<String_tensor>
+make_string_tensor(Size_vector shape, stdx::span<const std::string_view> values)
+{
+    std::size_t num_bytes = 0;
+    for (std::string_view value : values) {
+        num_bytes += value.size();
+    }
+
+    std::vector<std::uint8_t> bytes(num_bytes);
+
+    std::vector<std::int64_t> offsets{};
+    offsets.reserve(values.size() + 1);
+
+    std::size_t offset = 0;
+    for (std::string_view value : values) {
+        offsets.emplace_back(as_ssize(offset));
+
+        if (!value.empty()) {
+            std::memcpy(bytes.data() + offset, value.data(), value.size());
+        }
+
+        offset += value.size();
+    }
+
+    offsets.emplace_back(as_ssize(offset));
+
+    return make_intrusive<String_tensor>(std::move(shape),
+                                         wrap_cpu_array<Data_type::uint8>(std::move(bytes)),
+                                         wrap_cpu_array<Data_type::int64>(std::move(offsets)));
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
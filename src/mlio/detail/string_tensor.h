@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include "mlio/intrusive_ptr.h"
+#include "mlio/span.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Copies the specified strings into a @ref String_tensor. The total
+/// size is computed upfront, so the bytes are written in a single pass
+/// into one allocation.
+Intrusive_ptr<String_tensor>
+make_string_tensor(Size_vector shape, stdx::span<const std::string_view> values);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
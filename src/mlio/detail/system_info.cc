@@ -19,21 +19,306 @@
 
 #if defined(MLIO_PLATFORM_LINUX)
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <thread>
+
 // IWYU pragma: no_include <linux/sysinfo.h>
 
+#include <fmt/format.h>
+#include <sched.h>
+#include <sys/syscall.h>
 #include <sys/sysinfo.h>
+#include <unistd.h>
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
 
-std::size_t get_total_ram() noexcept
+// The same limit as the node mask of the memory policy calls.
+constexpr std::size_t max_num_numa_nodes = sizeof(unsigned long) * 8;
+
+constexpr std::string_view cgroup_root = "/sys/fs/cgroup";
+
+bool is_cgroup_v2()
+{
+    return ::access("/sys/fs/cgroup/cgroup.controllers", F_OK) == 0;
+}
+
+// Returns the path of the cgroup of the process in the hierarchy of the
+// specified cgroup v1 controller, or in the unified cgroup v2 hierarchy
+// if the controller is empty.
+std::optional<std::string> get_cgroup_path(std::string_view controller)
+{
+    std::ifstream file{"/proc/self/cgroup"};
+
+    // Each line has the form "<hierarchy-id>:<controllers>:<path>".
+    std::string line{};
+    while (std::getline(file, line)) {
+        std::size_t first = line.find(':');
+        std::size_t second = line.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos) {
+            continue;
+        }
+
+        std::string_view controllers{line.data() + first + 1, second - first - 1};
+
+        if (controller.empty()) {
+            if (controllers.empty()) {
+                return line.substr(second + 1);
+            }
+            continue;
+        }
+
+        std::stringstream strm{std::string{controllers}};
+        std::string name{};
+        while (std::getline(strm, name, ',')) {
+            if (name == controller) {
+                return line.substr(second + 1);
+            }
+        }
+    }
+
+    return {};
+}
+
+// Calls the specified function with each directory from the cgroup of the
+// process up to the root of the hierarchy, since the limits of all
+// ancestors apply. Inside a container the cgroup namespace usually maps
+// the cgroup of the process to the root of the mount.
+template<typename Func>
+void for_each_cgroup_dir(std::string_view controller, const Func &func)
+{
+    std::string root{cgroup_root};
+    if (!controller.empty()) {
+        root += '/';
+        root += controller;
+    }
+
+    std::optional<std::string> path = get_cgroup_path(controller);
+    if (path == std::nullopt) {
+        path = "/";
+    }
+
+    while (true) {
+        std::string dir = root + *path;
+        if (::access(dir.c_str(), F_OK) == 0) {
+            func(dir);
+        }
+
+        std::size_t pos = path->find_last_of('/');
+        if (pos == std::string::npos || *path == "/") {
+            break;
+        }
+        path->resize(pos == 0 ? 1 : pos);
+    }
+}
+
+// Returns the memory limit of the cgroup of the process, or std::nullopt
+// if the cgroup has no memory limit.
+std::optional<std::size_t> get_cgroup_memory_limit()
+{
+    std::optional<std::size_t> limit{};
+
+    auto update_limit = [&limit](std::uint64_t value) {
+        if (value > std::numeric_limits<std::size_t>::max()) {
+            return;
+        }
+
+        if (limit == std::nullopt || value < *limit) {
+            limit = value;
+        }
+    };
+
+    if (is_cgroup_v2()) {
+        for_each_cgroup_dir("", [&update_limit](const std::string &dir) {
+            // The file contains either "max" or the limit in bytes.
+            std::ifstream file{dir + "/memory.max"};
+
+            std::uint64_t value{};
+            if (file >> value) {
+                update_limit(value);
+            }
+        });
+    }
+    else {
+        for_each_cgroup_dir("memory", [&update_limit](const std::string &dir) {
+            // An unlimited cgroup reports a value close to the maximum of
+            // int64_t that exceeds the installed memory anyways.
+            std::ifstream file{dir + "/memory.limit_in_bytes"};
+
+            std::uint64_t value{};
+            if (file >> value) {
+                update_limit(value);
+            }
+        });
+    }
+
+    return limit;
+}
+
+// Returns the CPU quota of the cgroup of the process in number of
+// processor cores rounded up, or std::nullopt if the cgroup has no CPU
+// quota.
+std::optional<std::size_t> get_cgroup_cpu_quota()
+{
+    std::optional<std::size_t> quota{};
+
+    auto update_quota = [&quota](std::int64_t value, std::int64_t period) {
+        if (value <= 0 || period <= 0) {
+            return;
+        }
+
+        auto num_cpus = static_cast<std::size_t>((value + period - 1) / period);
+        if (quota == std::nullopt || num_cpus < *quota) {
+            quota = num_cpus;
+        }
+    };
+
+    if (is_cgroup_v2()) {
+        for_each_cgroup_dir("", [&update_quota](const std::string &dir) {
+            // The file contains "<quota> <period>" where the quota is
+            // "max" if there is no limit.
+            std::ifstream file{dir + "/cpu.max"};
+
+            std::int64_t value{};
+            std::int64_t period{};
+            if (file >> value >> period) {
+                update_quota(value, period);
+            }
+        });
+    }
+    else {
+        for_each_cgroup_dir("cpu", [&update_quota](const std::string &dir) {
+            // The quota is -1 if there is no limit.
+            std::ifstream quota_file{dir + "/cpu.cfs_quota_us"};
+            std::ifstream period_file{dir + "/cpu.cfs_period_us"};
+
+            std::int64_t value{};
+            std::int64_t period{};
+            if (quota_file >> value && period_file >> period) {
+                update_quota(value, period);
+            }
+        });
+    }
+
+    return quota;
+}
+
+std::size_t get_installed_ram() noexcept
 {
     struct ::sysinfo info {};
     if (::sysinfo(&info) == -1) {
         return 0;
     }
-    return info.totalram;
+    return info.totalram * info.mem_unit;
+}
+
+std::size_t get_num_available_cpus() noexcept
+{
+    ::cpu_set_t set{};
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+        auto num_cpus = static_cast<std::size_t>(CPU_COUNT(&set));
+        if (num_cpus > 0) {
+            return num_cpus;
+        }
+    }
+
+    return std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+}
+
+}  // namespace
+
+std::size_t get_total_ram() noexcept
+{
+    // The limits are read once; a process is rarely moved to another
+    // cgroup.
+    static const std::size_t total_ram = []() noexcept {
+        std::size_t ram = get_installed_ram();
+
+        std::optional<std::size_t> limit{};
+        try {
+            limit = get_cgroup_memory_limit();
+        }
+        catch (...) {
+        }
+
+        if (limit && (ram == 0 || *limit < ram)) {
+            return *limit;
+        }
+        return ram;
+    }();
+
+    return total_ram;
+}
+
+std::size_t get_num_cpus() noexcept
+{
+    static const std::size_t num_cpus = []() noexcept {
+        std::size_t cpus = get_num_available_cpus();
+
+        std::optional<std::size_t> quota{};
+        try {
+            quota = get_cgroup_cpu_quota();
+        }
+        catch (...) {
+        }
+
+        if (quota) {
+            return std::max(std::min(*quota, cpus), std::size_t{1});
+        }
+        return cpus;
+    }();
+
+    return num_cpus;
+}
+
+std::size_t get_num_numa_nodes() noexcept
+{
+    std::size_t num_nodes = 0;
+    for (; num_nodes < max_num_numa_nodes; num_nodes++) {
+        std::string path = "/sys/devices/system/node/node" + std::to_string(num_nodes);
+        if (::access(path.c_str(), F_OK) != 0) {
+            break;
+        }
+    }
+
+    return std::max(num_nodes, std::size_t{1});
+}
+
+std::size_t get_current_numa_node() noexcept
+{
+    unsigned int cpu{};
+    unsigned int node{};
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+    }
+
+    return 0;
+}
+
+std::optional<std::size_t> get_pci_device_numa_node(const std::string &bus_id)
+{
+    // The sysfs entries use lowercase hexadecimal digits.
+    std::string id = bus_id;
+    std::transform(id.begin(), id.end(), id.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+
+    std::ifstream file{fmt::format("/sys/bus/pci/devices/{0}/numa_node", id)};
+
+    int node = -1;
+    if (!(file >> node) || node < 0) {
+        return {};
+    }
+
+    return static_cast<std::size_t>(node);
 }
 
 }  // namespace detail
@@ -42,7 +327,9 @@ std::size_t get_total_ram() noexcept
 
 #elif defined(MLIO_PLATFORM_MACOS)
 
+#include <algorithm>
 #include <array>
+#include <thread>
 
 #include <sys/sysctl.h>
 #include <sys/types.h>
@@ -65,6 +352,26 @@ std::size_t get_total_ram() noexcept
     return data;
 }
 
+std::size_t get_num_cpus() noexcept
+{
+    return std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+}
+
+std::size_t get_num_numa_nodes() noexcept
+{
+    return 1;
+}
+
+std::size_t get_current_numa_node() noexcept
+{
+    return 0;
+}
+
+std::optional<std::size_t> get_pci_device_numa_node(const std::string &)
+{
+    return {};
+}
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
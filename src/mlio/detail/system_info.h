@@ -16,13 +16,35 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
+#include <string>
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
+/// Returns the amount of physical memory available to the process; the
+/// smaller of the installed memory and the memory limit of the cgroup
+/// of the process. Returns zero if it cannot be determined.
 std::size_t get_total_ram() noexcept;
 
+/// Returns the number of processor cores available to the process,
+/// taking its CPU affinity mask and the CPU quota of its cgroup into
+/// account; at least one.
+std::size_t get_num_cpus() noexcept;
+
+/// Returns the number of NUMA nodes of the machine; at least one.
+std::size_t get_num_numa_nodes() noexcept;
+
+/// Returns the NUMA node of the processor core that the calling thread
+/// runs on.
+std::size_t get_current_numa_node() noexcept;
+
+/// Returns the NUMA node that the PCI device with the specified bus id
+/// (e.g. "0000:3b:00.0") is attached to, or std::nullopt if the device
+/// is not associated with a node.
+std::optional<std::size_t> get_pci_device_numa_node(const std::string &bus_id);
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
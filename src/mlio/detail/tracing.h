@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "mlio/config.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// The symbols below are exported since the chunk readers, which are also
+// compiled into the benchmarks, use them.
+
+MLIO_API
+extern std::atomic_bool tracing_enabled;
+
+MLIO_API
+std::int64_t trace_clock_now() noexcept;
+
+MLIO_API
+void record_trace_span(const char *name, std::int64_t start_ns, std::int64_t end_ns) noexcept;
+
+// Records the lifetime of the span as a trace event; see start_tracing().
+// The name must have static storage duration, typically a literal.
+class Trace_span {
+public:
+    explicit Trace_span(const char *name) noexcept : name_{name}
+    {
+        if (tracing_enabled.load(std::memory_order_relaxed)) {
+            start_ns_ = trace_clock_now();
+        }
+    }
+
+    Trace_span(const Trace_span &) = delete;
+
+    Trace_span &operator=(const Trace_span &) = delete;
+
+    Trace_span(Trace_span &&) = delete;
+
+    Trace_span &operator=(Trace_span &&) = delete;
+
+    ~Trace_span()
+    {
+        if (start_ns_ >= 0) {
+            record_trace_span(name_, start_ns_, trace_clock_now());
+        }
+    }
+
+private:
+    const char *name_;
+    std::int64_t start_ns_ = -1;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
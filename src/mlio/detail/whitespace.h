@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+inline bool is_ascii_space(char chr) noexcept
+{
+    return chr == ' ' || (chr >= '\t' && chr <= '\r');
+}
+
+// The leading and trailing whitespace of a field is mostly either absent
+// or a run of spaces that pads a number to a fixed width; so the helpers
+// below skip the spaces a word at a time before they check the rest of
+// the whitespace characters one by one.
+
+constexpr std::uint64_t space_word = 0x2020'2020'2020'2020;
+
+inline bool is_space_word(const char *chars) noexcept
+{
+    std::uint64_t word{};
+    std::memcpy(&word, chars, sizeof(word));
+
+    return word == space_word;
+}
+
+inline std::size_t count_leading_spaces(std::string_view s) noexcept
+{
+    std::size_t i = 0;
+
+    while (i + sizeof(std::uint64_t) <= s.size() && is_space_word(s.data() + i)) {
+        i += sizeof(std::uint64_t);
+    }
+
+    while (i < s.size() && is_ascii_space(s[i])) {
+        i++;
+    }
+
+    return i;
+}
+
+inline std::size_t count_trailing_spaces(std::string_view s) noexcept
+{
+    std::size_t i = s.size();
+
+    while (i >= sizeof(std::uint64_t) && is_space_word(s.data() + i - sizeof(std::uint64_t))) {
+        i -= sizeof(std::uint64_t);
+    }
+
+    while (i > 0 && is_ascii_space(s[i - 1])) {
+        i--;
+    }
+
+    return s.size() - i;
+}
+
+inline std::string_view trim_ascii(std::string_view s) noexcept
+{
+    // Most fields are not padded; check that before anything else.
+    if (s.empty() || (!is_ascii_space(s.front()) && !is_ascii_space(s.back()))) {
+        return s;
+    }
+
+    s.remove_prefix(count_leading_spaces(s));
+    s.remove_suffix(count_trailing_spaces(s));
+
+    return s;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
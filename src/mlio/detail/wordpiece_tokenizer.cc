@@ -0,0 +1,242 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#include "mlio/detail/wordpiece_tokenizer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+inline bool is_space(char chr) noexcept
+{
+    return chr == ' ' || chr == '\t' || chr == '\n' || chr == '\r' || chr == '\v' || chr == '\f';
+}
+
+inline bool is_punctuation(char chr) noexcept
+{
+    return (chr >= '!' && chr <= '/') || (chr >= ':' && chr <= '@') ||
+           (chr >= '[' && chr <= '`') || (chr >= '{' && chr <= '~');
+}
+
+inline bool is_continuation_byte(char chr) noexcept
+{
+    return (static_cast<unsigned char>(chr) & 0xC0) == 0x80;
+}
+
+}  // namespace
+
+Wordpiece_tokenizer::Wordpiece_tokenizer(const Wordpiece_params &params) : params_{params}
+{
+    load_vocab();
+
+    unknown_id_ = get_special_id(params_.unknown_token);
+
+    std::size_t num_special_tokens = 0;
+
+    if (!params_.begin_token.empty()) {
+        begin_id_ = get_special_id(params_.begin_token);
+
+        num_special_tokens++;
+    }
+
+    if (!params_.end_token.empty()) {
+        end_id_ = get_special_id(params_.end_token);
+
+        num_special_tokens++;
+    }
+
+    if (!params_.padding_token.empty()) {
+        padding_id_ = get_special_id(params_.padding_token);
+    }
+
+    if (params_.max_sequence_length <= num_special_tokens) {
+        throw std::invalid_argument{
+            "The maximum sequence length must be greater than the number of special tokens."};
+    }
+}
+
+void Wordpiece_tokenizer::load_vocab()
+{
+    std::ifstream file{params_.vocab_path, std::ios::binary};
+    if (!file) {
+        throw std::system_error{
+            current_error_code(),
+            fmt::format("The vocabulary file '{0}' cannot be opened.", params_.vocab_path)};
+    }
+
+    std::string token{};
+    while (std::getline(file, token)) {
+        if (!token.empty() && token.back() == '\r') {
+            token.pop_back();
+        }
+
+        tokens_.emplace_back(std::move(token));
+    }
+
+    if (tokens_.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+        throw std::invalid_argument{fmt::format(
+            "The vocabulary file '{0}' has too many tokens.", params_.vocab_path)};
+    }
+
+    // The map refers to the strings of the vector; it must not be
+    // modified from now on.
+    ids_.reserve(tokens_.size());
+
+    for (std::size_t i = 0; i < tokens_.size(); i++) {
+        if (!tokens_[i].empty()) {
+            ids_.emplace(tokens_[i], static_cast<std::int32_t>(i));
+        }
+    }
+}
+
+std::int32_t Wordpiece_tokenizer::get_special_id(const std::string &token) const
+{
+    std::optional<std::int32_t> id = find_id(token);
+    if (id == std::nullopt) {
+        throw std::invalid_argument{fmt::format(
+            "The token '{0}' is not in the vocabulary file '{1}'.", token, params_.vocab_path)};
+    }
+
+    return *id;
+}
+
+inline std::optional<std::int32_t> Wordpiece_tokenizer::find_id(std::string_view token) const
+{
+    auto pos = ids_.find(token);
+    if (pos == ids_.end()) {
+        return {};
+    }
+
+    return pos->second;
+}
+
+std::size_t Wordpiece_tokenizer::encode(std::string_view text, stdx::span<std::int32_t> ids) const
+{
+    thread_local std::string word{};
+    thread_local std::vector<std::int32_t> pieces{};
+
+    std::size_t size = 0;
+
+    std::size_t max_size = ids.size();
+    if (end_id_) {
+        max_size--;
+    }
+
+    if (begin_id_) {
+        ids[size++] = *begin_id_;
+    }
+
+    std::size_t i = 0;
+    while (i < text.size() && size < max_size) {
+        if (is_space(text[i])) {
+            i++;
+
+            continue;
+        }
+
+        std::size_t word_end = i + 1;
+        if (!is_punctuation(text[i])) {
+            while (word_end < text.size() && !is_space(text[word_end]) &&
+                   !is_punctuation(text[word_end])) {
+                word_end++;
+            }
+        }
+
+        word.assign(text.substr(i, word_end - i));
+
+        i = word_end;
+
+        if (params_.lowercase) {
+            std::transform(word.begin(), word.end(), word.begin(), [](char chr) {
+                return chr >= 'A' && chr <= 'Z' ? static_cast<char>(chr - 'A' + 'a') : chr;
+            });
+        }
+
+        pieces.clear();
+
+        if (word.size() > params_.max_chars_per_word || !split_word(word, pieces)) {
+            pieces.assign(1, unknown_id_);
+        }
+
+        std::size_t num_pieces = std::min(pieces.size(), max_size - size);
+
+        std::copy_n(pieces.begin(), num_pieces, ids.begin() + as_ssize(size));
+
+        size += num_pieces;
+    }
+
+    if (end_id_) {
+        ids[size++] = *end_id_;
+    }
+
+    return size;
+}
+
+bool Wordpiece_tokenizer::split_word(std::string_view word, std::vector<std::int32_t> &pieces) const
+{
+    thread_local std::string key{};
+
+    std::size_t start = 0;
+    while (start < word.size()) {
+        std::optional<std::int32_t> id{};
+
+        std::size_t end = word.size();
+        while (end > start) {
+            if (start == 0) {
+                id = find_id(word.substr(0, end));
+            }
+            else {
+                key.assign("##");
+                key.append(word.substr(start, end - start));
+
+                id = find_id(key);
+            }
+
+            if (id) {
+                break;
+            }
+
+            // Never split a multi-byte UTF-8 character.
+            do {
+                end--;
+            } while (end > start && is_continuation_byte(word[end]));
+        }
+
+        if (id == std::nullopt) {
+            return false;
+        }
+
+        pieces.push_back(*id);
+
+        start = end;
+    }
+
+    return true;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
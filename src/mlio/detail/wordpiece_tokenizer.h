@@ -0,0 +1,70 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/span.h"
+#include "mlio/text_line_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Splits text into the ids of a WordPiece vocabulary. A tokenizer is
+/// immutable once constructed and can be used by several threads.
+class Wordpiece_tokenizer {
+public:
+    explicit Wordpiece_tokenizer(const Wordpiece_params &params);
+
+    /// Writes the ids of the specified text, enclosed in the begin and
+    /// end tokens, to @p ids and returns their number. The content is
+    /// truncated if it does not fit.
+    std::size_t encode(std::string_view text, stdx::span<std::int32_t> ids) const;
+
+    std::int32_t padding_id() const noexcept
+    {
+        return padding_id_;
+    }
+
+private:
+    void load_vocab();
+
+    std::int32_t get_special_id(const std::string &token) const;
+
+    std::optional<std::int32_t> find_id(std::string_view token) const;
+
+    // Appends the pieces of the word to the pieces; returns false if the
+    // word cannot be split into vocabulary entries.
+    bool split_word(std::string_view word, std::vector<std::int32_t> &pieces) const;
+
+    Wordpiece_params params_;
+    std::vector<std::string> tokens_{};
+    std::unordered_map<std::string_view, std::int32_t> ids_{};
+    std::int32_t unknown_id_{};
+    std::optional<std::int32_t> begin_id_{};
+    std::optional<std::int32_t> end_id_{};
+    std::int32_t padding_id_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
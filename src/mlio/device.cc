@@ -30,6 +30,13 @@ Device_kind Device_kind::cpu() noexcept
     return Device_kind{name};
 }
 
+Device_kind Device_kind::cuda() noexcept
+{
+    static std::string name = "CUDA";
+
+    return Device_kind{name};
+}
+
 std::string Device_kind::repr() const
 {
     return fmt::format("<Device_kind name='{0}'>", name_);
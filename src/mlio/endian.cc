@@ -0,0 +1,192 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/endian.h"
+
+#include "mlio/detail/cpu_features.h"
+
+#if defined(MLIO_X86_DISPATCH)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+template<typename T>
+void reverse_bytes_scalar(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    for (std::size_t i = 0; i < num_bytes; i += sizeof(T)) {
+        T value{};
+        std::memcpy(&value, src + i, sizeof(T));
+        value = reverse_bytes(value);
+        std::memcpy(dst + i, &value, sizeof(T));
+    }
+}
+
+#if defined(MLIO_X86_DISPATCH) || defined(__SSSE3__)
+
+// The shuffle mask that reverses each element of a 16-byte lane.
+template<typename T>
+constexpr char reverse_mask[16] = {};
+
+template<>
+constexpr char reverse_mask<std::uint16_t>[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+
+template<>
+constexpr char reverse_mask<std::uint32_t>[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+
+template<>
+constexpr char reverse_mask<std::uint64_t>[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+template<typename T>
+#ifdef MLIO_X86_DISPATCH
+MLIO_TARGET("ssse3")
+#endif
+std::size_t reverse_bytes_ssse3(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(reverse_mask<T>));
+
+    std::size_t i = 0;
+    for (; i + sizeof(__m128i) <= num_bytes; i += sizeof(__m128i)) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        v = _mm_shuffle_epi8(v, mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+    }
+    return i;
+}
+
+#endif
+
+#if defined(MLIO_X86_DISPATCH)
+
+template<typename T>
+MLIO_TARGET("avx2")
+std::size_t reverse_bytes_avx2(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    __m256i mask = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(reverse_mask<T>)));
+
+    std::size_t i = 0;
+    for (; i + sizeof(__m256i) <= num_bytes; i += sizeof(__m256i)) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        v = _mm256_shuffle_epi8(v, mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+    }
+    return i;
+}
+
+// The kernel is selected at runtime so that a portable build still uses
+// the widest shuffle the processor supports.
+template<typename T>
+std::size_t reverse_bytes_vector(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    const Cpu_features &features = cpu_features();
+    if (features.avx2) {
+        return reverse_bytes_avx2<T>(src, dst, num_bytes);
+    }
+    if (features.ssse3) {
+        return reverse_bytes_ssse3<T>(src, dst, num_bytes);
+    }
+    return 0;
+}
+
+#elif defined(__SSSE3__)
+
+template<typename T>
+std::size_t reverse_bytes_vector(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    return reverse_bytes_ssse3<T>(src, dst, num_bytes);
+}
+
+#elif defined(__ARM_NEON)
+
+template<typename T>
+std::size_t reverse_bytes_vector(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 16 <= num_bytes; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(src + i));
+        if constexpr (sizeof(T) == 2) {
+            v = vrev16q_u8(v);
+        }
+        else if constexpr (sizeof(T) == 4) {
+            v = vrev32q_u8(v);
+        }
+        else {
+            v = vrev64q_u8(v);
+        }
+        vst1q_u8(reinterpret_cast<std::uint8_t *>(dst + i), v);
+    }
+    return i;
+}
+
+#else
+
+template<typename T>
+std::size_t reverse_bytes_vector(const std::byte *, std::byte *, std::size_t) noexcept
+{
+    return 0;
+}
+
+#endif
+
+template<typename T>
+void reverse_bytes(const std::byte *src, std::byte *dst, std::size_t num_bytes) noexcept
+{
+    std::size_t offset = reverse_bytes_vector<T>(src, dst, num_bytes);
+
+    // Handle the remaining elements that do not fill a vector.
+    reverse_bytes_scalar<T>(src + offset, dst + offset, num_bytes - offset);
+}
+
+}  // namespace
+
+void reverse_bytes(Memory_span source,
+                   Mutable_memory_span destination,
+                   std::size_t element_size) noexcept
+{
+    const std::byte *src = source.data();
+    std::byte *dst = destination.data();
+
+    std::size_t num_bytes = source.size();
+
+    switch (element_size) {
+    case 2:
+        reverse_bytes<std::uint16_t>(src, dst, num_bytes);
+        break;
+
+    case 4:
+        reverse_bytes<std::uint32_t>(src, dst, num_bytes);
+        break;
+
+    case 8:
+        reverse_bytes<std::uint64_t>(src, dst, num_bytes);
+        break;
+
+    default:
+        std::memmove(dst, src, num_bytes);
+        break;
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -15,6 +15,7 @@
 
 #include "mlio/example.h"
 
+#include <exception>
 #include <optional>
 #include <stdexcept>
 #include <tuple>
@@ -24,11 +25,96 @@
 #include <fmt/ostream.h>
 #include <tbb/iterators.h>
 
+#include "mlio/detail/thread.h"
 #include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 
+Feature_source::~Feature_source() = default;
+
+Example_reclaimer::Example_reclaimer(std::size_t max_pending) noexcept : max_pending_{max_pending}
+{}
+
+Example_reclaimer::~Example_reclaimer()
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        stopped_ = true;
+    }
+
+    condition_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Example_reclaimer::defer(std::vector<Intrusive_ptr<Tensor>> &&features,
+                              Intrusive_ptr<const Feature_source> &&source) noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        if (stopped_ || items_.size() >= max_pending_) {
+            return;
+        }
+
+        try {
+            if (!thread_.joinable()) {
+                thread_ = detail::start_thread(&Example_reclaimer::run, this);
+            }
+
+            items_.push_back(Item{std::move(features), std::move(source)});
+        }
+        catch (const std::exception &) {
+            // Free the features inline.
+            return;
+        }
+    }
+
+    condition_.notify_one();
+}
+
+std::size_t Example_reclaimer::num_reclaimed() const
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    return num_reclaimed_;
+}
+
+void Example_reclaimer::run() noexcept
+{
+    std::deque<Item> items{};
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    while (true) {
+        condition_.wait(lock, [this] {
+            return stopped_ || !items_.empty();
+        });
+
+        if (items_.empty()) {
+            return;
+        }
+
+        std::swap(items, items_);
+
+        std::size_t num_items = items.size();
+
+        // The features are freed outside of the lock so that the
+        // consumer never waits for the deallocation.
+        lock.unlock();
+
+        items.clear();
+
+        lock.lock();
+
+        num_reclaimed_ += num_items;
+    }
+}
+
 Example::Example(Intrusive_ptr<const Schema> schema, std::vector<Intrusive_ptr<Tensor>> &&features)
     : schema_{std::move(schema)}, features_{std::move(features)}
 {
@@ -38,13 +124,60 @@ Example::Example(Intrusive_ptr<const Schema> schema, std::vector<Intrusive_ptr<T
     }
 }
 
-Intrusive_ptr<Tensor> Example::find_feature(const std::string &name) const noexcept
+Example::Example(Intrusive_ptr<const Schema> schema, Intrusive_ptr<const Feature_source> source)
+    : schema_{std::move(schema)}, source_{std::move(source)}
+{
+    if (source_ == nullptr) {
+        throw std::invalid_argument{"The feature source must not be null."};
+    }
+
+    std::size_t num_features = schema_->attributes().size();
+
+    features_.resize(num_features);
+
+    materialized_ = std::make_unique<std::once_flag[]>(num_features);
+}
+
+Example::~Example()
+{
+    if (reclaimer_ != nullptr) {
+        reclaimer_->defer(std::move(features_), std::move(source_));
+    }
+}
+
+Intrusive_ptr<Tensor> Example::feature(std::size_t index) const
+{
+    if (index >= features_.size()) {
+        throw std::out_of_range{"The feature index is out of range."};
+    }
+
+    if (source_ != nullptr) {
+        std::call_once(materialized_[index], [this, index]() {
+            features_[index] = source_->materialize(index);
+        });
+    }
+
+    return features_[index];
+}
+
+Intrusive_ptr<Tensor> Example::find_feature(std::string_view name) const
 {
     std::optional<std::size_t> idx = schema_->get_index(name);
     if (idx == std::nullopt) {
         return {};
     }
-    return features_[*idx];
+    return feature(*idx);
+}
+
+const std::vector<Intrusive_ptr<Tensor>> &Example::features() const
+{
+    if (source_ != nullptr) {
+        for (std::size_t i = 0; i < features_.size(); i++) {
+            feature(i);
+        }
+    }
+
+    return features_;
 }
 
 std::string Example::repr() const
@@ -52,8 +185,8 @@ std::string Example::repr() const
     auto dsc_beg = schema_->attributes().begin();
     auto dsc_end = schema_->attributes().end();
 
-    auto ftr_beg = features_.begin();
-    auto ftr_end = features_.end();
+    auto ftr_beg = features().begin();
+    auto ftr_end = features().end();
 
     auto pair_beg = tbb::make_zip_iterator(dsc_beg, ftr_beg);
     auto pair_end = tbb::make_zip_iterator(dsc_end, ftr_end);
@@ -0,0 +1,709 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/example_batching.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/array_group.h"
+#include "mlio/detail/example_codec.h"
+#include "mlio/device.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_pool.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace {
+
+constexpr bool is_index_type(Data_type dt) noexcept
+{
+    switch (dt) {
+    case Data_type::size:
+    case Data_type::int8:
+    case Data_type::int16:
+    case Data_type::int32:
+    case Data_type::int64:
+    case Data_type::uint8:
+    case Data_type::uint16:
+    case Data_type::uint32:
+    case Data_type::uint64:
+        return true;
+    case Data_type::float16:
+    case Data_type::float32:
+    case Data_type::float64:
+    case Data_type::string:
+    case Data_type::bfloat16:
+    case Data_type::timestamp:
+    case Data_type::date:
+        return false;
+    }
+
+    return false;
+}
+
+void check_index_array(Device_array_view arr)
+{
+    if (!is_index_type(arr.data_type())) {
+        throw std::invalid_argument{"The index arrays of a sparse feature must be of integer type."};
+    }
+}
+
+std::unique_ptr<Device_array> allocate_array(Tensor_pool *pool, Data_type dt, std::size_t size)
+{
+    if (pool == nullptr) {
+        return make_cpu_array(dt, size);
+    }
+    return pool->make_cpu_array(dt, size, false);
+}
+
+// Wraps a range of the specified array as an array that shares its
+// memory. Like the arrays of an array group, the view aliases the
+// memory of the source array.
+template<Data_type dt>
+struct View_array_op {
+    std::unique_ptr<Device_array> operator()(const std::shared_ptr<void> &owner,
+                                             Device_array_view arr,
+                                             std::size_t offset,
+                                             std::size_t size)
+    {
+        using T = data_type_t<dt>;
+
+        auto *data = static_cast<T *>(const_cast<void *>(arr.data())) + offset;
+
+        return detail::Cpu_array_access::wrap(dt, detail::Array_group_slice<T>{owner, data, size});
+    }
+};
+
+struct Array_range {
+    Device_array_view arr;
+    std::size_t first;
+    std::size_t size;
+};
+
+// Copies the specified ranges back to back into the destination array;
+// a single memcpy per range for the non-string data types.
+template<Data_type dt>
+struct Concat_array_op {
+    void operator()(const std::vector<Array_range> &ranges, Device_array &dst)
+    {
+        using T = data_type_t<dt>;
+
+        T *out = static_cast<T *>(dst.data());
+        for (const Array_range &range : ranges) {
+            auto src = range.arr.as<T>().subspan(range.first, range.size);
+
+            out = std::copy(src.begin(), src.end(), out);
+        }
+    }
+};
+
+// Copies the elements at the specified positions into a new array.
+template<Data_type dt>
+struct Gather_array_op {
+    std::unique_ptr<Device_array>
+    operator()(Device_array_view arr, const std::vector<std::size_t> &positions)
+    {
+        using T = data_type_t<dt>;
+
+        auto src = arr.as<T>();
+
+        std::unique_ptr<Device_array> out = make_cpu_array(dt, positions.size());
+
+        auto dst = as_span<T>(*out);
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            dst[i] = src[positions[i]];
+        }
+        return out;
+    }
+};
+
+template<Data_type dt>
+struct Index_at_op {
+    std::size_t operator()(Device_array_view arr, std::size_t idx)
+    {
+        if constexpr (is_index_type(dt)) {
+            return static_cast<std::size_t>(arr.as<data_type_t<dt>>()[idx]);
+        }
+        else {
+            return 0;
+        }
+    }
+};
+
+// Subtracts base from and adds offset to the indices in the range
+// [first, first + size) of the specified array.
+template<Data_type dt>
+struct Rebase_index_op {
+    void operator()(Device_array &arr,
+                    std::size_t first,
+                    std::size_t size,
+                    std::size_t base,
+                    std::size_t offset)
+    {
+        if constexpr (is_index_type(dt)) {
+            using T = data_type_t<dt>;
+
+            auto idx = as_span<T>(arr).subspan(first, size);
+            for (T &i : idx) {
+                i = static_cast<T>(static_cast<std::size_t>(i) - base + offset);
+            }
+        }
+    }
+};
+
+// Returns the positions of the entries whose index falls in the range
+// [begin, end).
+template<Data_type dt>
+struct Find_indices_op {
+    std::vector<std::size_t>
+    operator()(Device_array_view arr, std::size_t begin, std::size_t end)
+    {
+        std::vector<std::size_t> positions{};
+
+        if constexpr (is_index_type(dt)) {
+            auto idx = arr.as<data_type_t<dt>>();
+            for (std::size_t i = 0; i < idx.size(); i++) {
+                auto row = static_cast<std::size_t>(idx[i]);
+                if (row >= begin && row < end) {
+                    positions.emplace_back(i);
+                }
+            }
+        }
+        return positions;
+    }
+};
+
+std::size_t index_at(Device_array_view arr, std::size_t idx)
+{
+    return dispatch<Index_at_op>(arr.data_type(), arr, idx);
+}
+
+void rebase_indices(Device_array &arr,
+                    std::size_t first,
+                    std::size_t size,
+                    std::size_t base,
+                    std::size_t offset)
+{
+    dispatch<Rebase_index_op>(arr.data_type(), arr, first, size, base, offset);
+}
+
+std::unique_ptr<Device_array>
+concat_arrays(Tensor_pool *pool, Data_type dt, const std::vector<Array_range> &ranges)
+{
+    std::size_t size = 0;
+    for (const Array_range &range : ranges) {
+        size += range.size;
+    }
+
+    std::unique_ptr<Device_array> arr = allocate_array(pool, dt, size);
+
+    dispatch<Concat_array_op>(dt, ranges, *arr);
+
+    return arr;
+}
+
+void check_cpu_array(Device_array_view arr)
+{
+    if (arr.device().kind() != Device_kind::cpu()) {
+        throw Not_supported_error{"Only the features residing in the host memory are supported."};
+    }
+}
+
+Intrusive_ptr<const Schema> make_batch_schema(const Schema &schema, std::size_t batch_size)
+{
+    std::vector<Attribute> attrs{};
+    attrs.reserve(schema.attributes().size());
+
+    for (const Attribute &attr : schema.attributes()) {
+        Size_vector shape = attr.shape();
+        if (!shape.empty()) {
+            shape[0] = batch_size;
+        }
+
+        attrs.emplace_back(attr.name(), attr.data_type(), std::move(shape), attr.strides(),
+                           attr.sparse());
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+// Returns the size of the batch dimension that all features of the
+// example must share.
+std::size_t get_batch_size(const std::vector<Intrusive_ptr<Tensor>> &features)
+{
+    if (features.empty()) {
+        throw std::invalid_argument{"The example must have at least one feature."};
+    }
+
+    std::size_t batch_size{};
+
+    for (auto pos = features.begin(); pos < features.end(); ++pos) {
+        const Size_vector &shape = (*pos)->shape();
+        if (shape.empty()) {
+            throw std::invalid_argument{"The features of the example must have a batch dimension."};
+        }
+
+        if (pos == features.begin()) {
+            batch_size = shape[0];
+        }
+        else if (shape[0] != batch_size) {
+            throw std::invalid_argument{
+                "The features of the example must have the same batch dimension."};
+        }
+    }
+
+    return batch_size;
+}
+
+Intrusive_ptr<Tensor> slice_dense(const std::shared_ptr<void> &owner,
+                                  const Dense_tensor &tensor,
+                                  std::size_t begin,
+                                  std::size_t end)
+{
+    Device_array_view data = tensor.data();
+
+    check_cpu_array(data);
+
+    const Ssize_vector &strides = tensor.strides();
+    if (std::any_of(strides.begin(), strides.end(), [](auto stride) {
+            return stride < 0;
+        })) {
+        throw Not_supported_error{"The dense features with negative strides cannot be sliced."};
+    }
+
+    std::size_t offset = std::min(begin * as_size(strides[0]), data.size());
+
+    auto arr = dispatch<View_array_op>(data.data_type(), owner, data, offset, data.size() - offset);
+
+    Size_vector shape = tensor.shape();
+    shape[0] = end - begin;
+
+    return make_intrusive<Dense_tensor>(std::move(shape), std::move(arr), strides);
+}
+
+Intrusive_ptr<Tensor> slice_csr(const std::shared_ptr<void> &owner,
+                                const Csr_tensor &tensor,
+                                std::size_t begin,
+                                std::size_t end)
+{
+    Device_array_view data = tensor.data();
+    Device_array_view indices = tensor.indices();
+    Device_array_view indptr = tensor.indptr();
+
+    check_cpu_array(data);
+
+    check_index_array(indptr);
+
+    std::size_t first = index_at(indptr, begin);
+    std::size_t last = index_at(indptr, end);
+
+    auto new_data = dispatch<View_array_op>(data.data_type(), owner, data, first, last - first);
+
+    auto new_indices =
+        dispatch<View_array_op>(indices.data_type(), owner, indices, first, last - first);
+
+    // Unlike the data and index arrays, the index pointer array has to
+    // be copied since its entries are offsets into them.
+    std::unique_ptr<Device_array> new_indptr =
+        concat_arrays(nullptr, indptr.data_type(), {Array_range{indptr, begin, end - begin + 1}});
+
+    rebase_indices(*new_indptr, 0, new_indptr->size(), first, 0);
+
+    Size_vector shape = tensor.shape();
+    shape[0] = end - begin;
+
+    return make_intrusive<Csr_tensor>(
+        std::move(shape), std::move(new_data), std::move(new_indices), std::move(new_indptr));
+}
+
+Intrusive_ptr<Tensor> slice_coo(const Coo_tensor &tensor, std::size_t begin, std::size_t end)
+{
+    Device_array_view data = tensor.data();
+
+    check_cpu_array(data);
+
+    Device_array_view rows = tensor.indices(0);
+
+    check_index_array(rows);
+
+    // The entries of a COO tensor are not necessarily sorted by row, so
+    // the ones in the range have to be gathered.
+    std::vector<std::size_t> positions =
+        dispatch<Find_indices_op>(rows.data_type(), rows, begin, end);
+
+    auto new_data = dispatch<Gather_array_op>(data.data_type(), data, positions);
+
+    std::vector<std::unique_ptr<Device_array>> coordinates{};
+    coordinates.reserve(tensor.shape().size());
+
+    for (std::size_t dim = 0; dim < tensor.shape().size(); dim++) {
+        Device_array_view idx = tensor.indices(dim);
+
+        coordinates.emplace_back(dispatch<Gather_array_op>(idx.data_type(), idx, positions));
+    }
+
+    rebase_indices(*coordinates.front(), 0, positions.size(), begin, 0);
+
+    Size_vector shape = tensor.shape();
+    shape[0] = end - begin;
+
+    return make_intrusive<Coo_tensor>(std::move(shape), std::move(new_data), std::move(coordinates));
+}
+
+Intrusive_ptr<Tensor>
+slice_tensor(const Intrusive_ptr<Tensor> &tensor, std::size_t begin, std::size_t end)
+{
+    // Keeps the source tensor, and therefore its arrays, alive as long as
+    // any of the views created from it.
+    std::shared_ptr<void> owner{nullptr, [tensor](void *) {}};
+
+    if (auto *dense = dynamic_cast<const Dense_tensor *>(tensor.get()); dense != nullptr) {
+        return slice_dense(owner, *dense, begin, end);
+    }
+    if (auto *csr = dynamic_cast<const Csr_tensor *>(tensor.get()); csr != nullptr) {
+        return slice_csr(owner, *csr, begin, end);
+    }
+    if (auto *coo = dynamic_cast<const Coo_tensor *>(tensor.get()); coo != nullptr) {
+        return slice_coo(*coo, begin, end);
+    }
+
+    throw Not_supported_error{"The example has a feature of an unsupported tensor type."};
+}
+
+void check_compatible_schemas(const Schema &lhs, const Schema &rhs)
+{
+    const std::vector<Attribute> &lhs_attrs = lhs.attributes();
+    const std::vector<Attribute> &rhs_attrs = rhs.attributes();
+
+    bool compatible = lhs_attrs.size() == rhs_attrs.size();
+
+    for (std::size_t i = 0; compatible && i < lhs_attrs.size(); i++) {
+        const Attribute &l = lhs_attrs[i];
+        const Attribute &r = rhs_attrs[i];
+
+        compatible = l.name() == r.name() && l.data_type() == r.data_type() &&
+                     l.sparse() == r.sparse() && l.shape().size() == r.shape().size() &&
+                     (l.shape().empty() ||
+                      std::equal(l.shape().begin() + 1, l.shape().end(), r.shape().begin() + 1));
+    }
+
+    if (!compatible) {
+        throw std::invalid_argument{
+            "The examples must have the same schema except for the batch dimension."};
+    }
+}
+
+template<typename T>
+std::vector<const T *> cast_tensors(const std::vector<const Tensor *> &tensors)
+{
+    std::vector<const T *> casted{};
+    casted.reserve(tensors.size());
+
+    const Size_vector &front_shape = tensors.front()->shape();
+
+    for (const Tensor *tsr : tensors) {
+        auto *t = dynamic_cast<const T *>(tsr);
+        if (t == nullptr) {
+            throw std::invalid_argument{
+                "The features of the examples must have the same tensor type."};
+        }
+
+        check_cpu_array(t->data());
+
+        const Size_vector &shape = t->shape();
+        if (shape.size() != front_shape.size() ||
+            !std::equal(shape.begin() + 1, shape.end(), front_shape.begin() + 1)) {
+            throw std::invalid_argument{
+                "The features of the examples must have the same shape except for the batch "
+                "dimension."};
+        }
+
+        casted.emplace_back(t);
+    }
+
+    return casted;
+}
+
+void check_same_data_type(Device_array_view lhs, Device_array_view rhs)
+{
+    if (lhs.data_type() != rhs.data_type()) {
+        throw std::invalid_argument{
+            "The arrays of the features of the examples must have the same data type."};
+    }
+}
+
+Intrusive_ptr<Tensor> concat_dense(const std::vector<const Tensor *> &tensors,
+                                   std::size_t batch_size,
+                                   Tensor_pool *pool)
+{
+    std::vector<const Dense_tensor *> denses = cast_tensors<Dense_tensor>(tensors);
+
+    std::vector<Array_range> ranges{};
+    ranges.reserve(denses.size());
+
+    for (const Dense_tensor *dense : denses) {
+        if (!detail::is_row_major(*dense)) {
+            throw Not_supported_error{
+                "Only the dense features in row-major order can be concatenated."};
+        }
+
+        check_same_data_type(denses.front()->data(), dense->data());
+
+        std::size_t size = 1;
+        for (std::size_t dim : dense->shape()) {
+            size *= dim;
+        }
+
+        ranges.push_back(Array_range{dense->data(), 0, size});
+    }
+
+    Size_vector shape = denses.front()->shape();
+    shape[0] = batch_size;
+
+    Data_type dt = denses.front()->data().data_type();
+
+    return make_intrusive<Dense_tensor>(std::move(shape), concat_arrays(pool, dt, ranges));
+}
+
+Intrusive_ptr<Tensor> concat_csr(const std::vector<const Tensor *> &tensors,
+                                 std::size_t batch_size,
+                                 Tensor_pool *pool)
+{
+    std::vector<const Csr_tensor *> csrs = cast_tensors<Csr_tensor>(tensors);
+
+    const Csr_tensor &front = *csrs.front();
+
+    std::vector<Array_range> data_ranges{};
+    std::vector<Array_range> indices_ranges{};
+    std::vector<Array_range> indptr_ranges{};
+
+    // Holds the first offset of each index pointer array.
+    std::vector<std::size_t> bases{};
+
+    for (const Csr_tensor *csr : csrs) {
+        check_index_array(csr->indptr());
+
+        check_same_data_type(front.data(), csr->data());
+        check_same_data_type(front.indices(), csr->indices());
+        check_same_data_type(front.indptr(), csr->indptr());
+
+        std::size_t num_rows = csr->shape()[0];
+
+        std::size_t first = index_at(csr->indptr(), 0);
+        std::size_t last = index_at(csr->indptr(), num_rows);
+
+        data_ranges.push_back(Array_range{csr->data(), first, last - first});
+        indices_ranges.push_back(Array_range{csr->indices(), first, last - first});
+
+        indptr_ranges.push_back(Array_range{csr->indptr(), 0, num_rows});
+
+        bases.emplace_back(first);
+    }
+
+    // The closing offset is taken from the last tensor.
+    indptr_ranges.back().size++;
+
+    auto data = concat_arrays(pool, front.data().data_type(), data_ranges);
+    auto indices = concat_arrays(pool, front.indices().data_type(), indices_ranges);
+    auto indptr = concat_arrays(pool, front.indptr().data_type(), indptr_ranges);
+
+    // Shift the offsets of each tensor by the number of values before it.
+    std::size_t pos = 0;
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < csrs.size(); i++) {
+        rebase_indices(*indptr, pos, indptr_ranges[i].size, bases[i], offset);
+
+        pos += indptr_ranges[i].size;
+
+        offset += data_ranges[i].size;
+    }
+
+    Size_vector shape = front.shape();
+    shape[0] = batch_size;
+
+    return make_intrusive<Csr_tensor>(
+        std::move(shape), std::move(data), std::move(indices), std::move(indptr));
+}
+
+Intrusive_ptr<Tensor> concat_coo(const std::vector<const Tensor *> &tensors,
+                                 std::size_t batch_size,
+                                 Tensor_pool *pool)
+{
+    std::vector<const Coo_tensor *> coos = cast_tensors<Coo_tensor>(tensors);
+
+    const Coo_tensor &front = *coos.front();
+
+    std::size_t rank = front.shape().size();
+
+    std::vector<Array_range> data_ranges{};
+    std::vector<std::vector<Array_range>> coordinate_ranges(rank);
+
+    for (const Coo_tensor *coo : coos) {
+        check_index_array(coo->indices(0));
+
+        check_same_data_type(front.data(), coo->data());
+
+        data_ranges.push_back(Array_range{coo->data(), 0, coo->data().size()});
+
+        for (std::size_t dim = 0; dim < rank; dim++) {
+            check_same_data_type(front.indices(dim), coo->indices(dim));
+
+            coordinate_ranges[dim].push_back(
+                Array_range{coo->indices(dim), 0, coo->indices(dim).size()});
+        }
+    }
+
+    auto data = concat_arrays(pool, front.data().data_type(), data_ranges);
+
+    std::vector<std::unique_ptr<Device_array>> coordinates{};
+    coordinates.reserve(rank);
+
+    for (std::size_t dim = 0; dim < rank; dim++) {
+        coordinates.emplace_back(
+            concat_arrays(pool, front.indices(dim).data_type(), coordinate_ranges[dim]));
+    }
+
+    // Shift the row indices of each tensor by the number of rows before it.
+    std::size_t pos = 0;
+    std::size_t row_offset = 0;
+    for (std::size_t i = 0; i < coos.size(); i++) {
+        std::size_t size = coordinate_ranges[0][i].size;
+
+        rebase_indices(*coordinates.front(), pos, size, 0, row_offset);
+
+        pos += size;
+
+        row_offset += coos[i]->shape()[0];
+    }
+
+    Size_vector shape = front.shape();
+    shape[0] = batch_size;
+
+    return make_intrusive<Coo_tensor>(std::move(shape), std::move(data), std::move(coordinates));
+}
+
+Intrusive_ptr<Tensor> concat_tensors(const std::vector<const Tensor *> &tensors,
+                                     std::size_t batch_size,
+                                     Tensor_pool *pool)
+{
+    const Tensor *front = tensors.front();
+
+    if (dynamic_cast<const Dense_tensor *>(front) != nullptr) {
+        return concat_dense(tensors, batch_size, pool);
+    }
+    if (dynamic_cast<const Csr_tensor *>(front) != nullptr) {
+        return concat_csr(tensors, batch_size, pool);
+    }
+    if (dynamic_cast<const Coo_tensor *>(front) != nullptr) {
+        return concat_coo(tensors, batch_size, pool);
+    }
+
+    throw Not_supported_error{"The examples have a feature of an unsupported tensor type."};
+}
+
+}  // namespace
+
+Intrusive_ptr<Example> slice_example(const Example &example, std::size_t begin, std::size_t end)
+{
+    const std::vector<Intrusive_ptr<Tensor>> &features = example.features();
+
+    std::size_t batch_size = get_batch_size(features);
+
+    if (begin >= end || end > batch_size) {
+        throw std::invalid_argument{
+            "The slice must be a non-empty range within the batch dimension of the example."};
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.reserve(features.size());
+
+    for (const Intrusive_ptr<Tensor> &feature : features) {
+        tensors.emplace_back(slice_tensor(feature, begin, end));
+    }
+
+    auto sliced = make_intrusive<Example>(make_batch_schema(example.schema(), end - begin),
+                                          std::move(tensors));
+
+    // The padded instances are always at the end of the batch.
+    std::size_t padding_begin = batch_size - std::min(example.padding, batch_size);
+    if (end > padding_begin) {
+        sliced->padding = end - std::max(begin, padding_begin);
+    }
+
+    return sliced;
+}
+
+Intrusive_ptr<Example>
+concat_examples(stdx::span<const Intrusive_ptr<Example>> examples, Tensor_pool *pool)
+{
+    if (examples.empty()) {
+        throw std::invalid_argument{"At least one example must be specified."};
+    }
+
+    const Example &front = *examples[0];
+
+    std::size_t batch_size = 0;
+
+    for (std::size_t i = 0; i < examples.size(); i++) {
+        const Example &example = *examples[i];
+
+        if (i > 0) {
+            check_compatible_schemas(front.schema(), example.schema());
+        }
+
+        if (example.padding > 0 && i < examples.size() - 1) {
+            throw std::invalid_argument{"Only the last example can have a padding."};
+        }
+
+        batch_size += get_batch_size(example.features());
+    }
+
+    std::size_t num_features = front.features().size();
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.reserve(num_features);
+
+    std::vector<const Tensor *> sources(examples.size());
+
+    for (std::size_t i = 0; i < num_features; i++) {
+        for (std::size_t j = 0; j < examples.size(); j++) {
+            sources[j] = examples[j]->features()[i].get();
+        }
+
+        tensors.emplace_back(concat_tensors(sources, batch_size, pool));
+    }
+
+    auto concatenated =
+        make_intrusive<Example>(make_batch_schema(front.schema(), batch_size), std::move(tensors));
+
+    concatenated->padding = examples[examples.size() - 1]->padding;
+
+    return concatenated;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,638 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/example_conversion.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/detail/example_codec.h"
+#include "mlio/detail/half.h"
+#include "mlio/device.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_visitor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace {
+
+// The minimum number of elements that a task casts; smaller arrays are
+// cast on the calling thread.
+constexpr std::size_t min_cast_grain_size = 0x1'0000;
+
+constexpr bool is_index_type(Data_type dt) noexcept
+{
+    switch (dt) {
+    case Data_type::size:
+    case Data_type::int8:
+    case Data_type::int16:
+    case Data_type::int32:
+    case Data_type::int64:
+    case Data_type::uint8:
+    case Data_type::uint16:
+    case Data_type::uint32:
+    case Data_type::uint64:
+        return true;
+    case Data_type::float16:
+    case Data_type::float32:
+    case Data_type::float64:
+    case Data_type::string:
+    case Data_type::bfloat16:
+    case Data_type::timestamp:
+    case Data_type::date:
+        return false;
+    }
+
+    return false;
+}
+
+constexpr bool is_numeric_type(Data_type dt) noexcept
+{
+    return dt != Data_type::string && dt != Data_type::timestamp && dt != Data_type::date;
+}
+
+// Converts a value between two data types; the half-precision types
+// are converted via float.
+template<Data_type src_dt, Data_type dst_dt>
+inline data_type_t<dst_dt> cast_value(const data_type_t<src_dt> &value)
+{
+    if constexpr (src_dt == dst_dt) {
+        return value;
+    }
+    else if constexpr (src_dt == Data_type::string || dst_dt == Data_type::string) {
+        // Rejected by check_cast() before dispatching.
+        return data_type_t<dst_dt>{};
+    }
+    else if constexpr (src_dt == Data_type::float16) {
+        return cast_value<Data_type::float32, dst_dt>(detail::half_to_float(value));
+    }
+    else if constexpr (src_dt == Data_type::bfloat16) {
+        return cast_value<Data_type::float32, dst_dt>(detail::bfloat16_to_float(value));
+    }
+    else if constexpr (dst_dt == Data_type::float16) {
+        return detail::float_to_half(static_cast<float>(value));
+    }
+    else if constexpr (dst_dt == Data_type::bfloat16) {
+        return detail::float_to_bfloat16(static_cast<float>(value));
+    }
+    else {
+        return static_cast<data_type_t<dst_dt>>(value);
+    }
+}
+
+// Describes which source element each element of the destination array
+// is taken from. By default element i is taken from offset + i.
+struct Element_mapping {
+    std::size_t offset{};
+    // If set, element i is taken from (*positions)[i].
+    const std::vector<std::size_t> *positions{};
+    // If set, the elements are copied between the strided layouts of a
+    // dense tensor of the specified shape.
+    const Size_vector *shape{};
+    const Ssize_vector *src_strides{};
+    const Ssize_vector *dst_strides{};
+};
+
+template<Data_type src_dt, Data_type dst_dt>
+void copy_strided(const data_type_t<src_dt> *src,
+                  data_type_t<dst_dt> *dst,
+                  const Element_mapping &mapping)
+{
+    const Size_vector &shape = *mapping.shape;
+    const Ssize_vector &src_strides = *mapping.src_strides;
+    const Ssize_vector &dst_strides = *mapping.dst_strides;
+
+    std::size_t rank = shape.size();
+
+    // Each task walks the elements of a range of the outermost dimension
+    // with an odometer over the remaining dimensions.
+    auto copy_rows = [&](const tbb::blocked_range<std::size_t> &range) {
+        std::vector<std::size_t> idx(rank);
+
+        for (std::size_t row = range.begin(); row < range.end(); row++) {
+            std::ptrdiff_t src_pos = static_cast<std::ptrdiff_t>(row) * src_strides[0];
+            std::ptrdiff_t dst_pos = static_cast<std::ptrdiff_t>(row) * dst_strides[0];
+
+            std::fill(idx.begin(), idx.end(), 0);
+
+            while (true) {
+                dst[dst_pos] = cast_value<src_dt, dst_dt>(src[src_pos]);
+
+                std::size_t dim = rank - 1;
+                for (; dim > 0; dim--) {
+                    if (++idx[dim] < shape[dim]) {
+                        src_pos += src_strides[dim];
+                        dst_pos += dst_strides[dim];
+
+                        break;
+                    }
+
+                    idx[dim] = 0;
+
+                    auto count = static_cast<std::ptrdiff_t>(shape[dim] - 1);
+
+                    src_pos -= count * src_strides[dim];
+                    dst_pos -= count * dst_strides[dim];
+                }
+
+                if (dim == 0) {
+                    break;
+                }
+            }
+        }
+    };
+
+    std::size_t row_size = 1;
+    for (std::size_t dim = 1; dim < rank; dim++) {
+        row_size *= shape[dim];
+    }
+
+    std::size_t grain_size = std::max(min_cast_grain_size / std::max(row_size, std::size_t{1}),
+                                      std::size_t{1});
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>{0, shape[0], grain_size}, copy_rows);
+}
+
+template<Data_type src_dt>
+struct Cast_array_op {
+    template<Data_type dst_dt>
+    struct Into {
+        void operator()(Device_array_view src,
+                        Device_array &dst,
+                        const Element_mapping &mapping)
+        {
+            auto *src_data = src.as<data_type_t<src_dt>>().data();
+            auto *dst_data = as_span<data_type_t<dst_dt>>(dst).data();
+
+            if (mapping.shape != nullptr) {
+                copy_strided<src_dt, dst_dt>(src_data, dst_data, mapping);
+
+                return;
+            }
+
+            auto cast_range = [&](const tbb::blocked_range<std::size_t> &range) {
+                if (mapping.positions != nullptr) {
+                    const std::vector<std::size_t> &positions = *mapping.positions;
+                    for (std::size_t i = range.begin(); i < range.end(); i++) {
+                        dst_data[i] = cast_value<src_dt, dst_dt>(src_data[positions[i]]);
+                    }
+                }
+                else {
+                    const auto *values = src_data + mapping.offset;
+                    for (std::size_t i = range.begin(); i < range.end(); i++) {
+                        dst_data[i] = cast_value<src_dt, dst_dt>(values[i]);
+                    }
+                }
+            };
+
+            tbb::blocked_range<std::size_t> range{0, dst.size(), min_cast_grain_size};
+            if (dst.size() > min_cast_grain_size) {
+                tbb::parallel_for(range, cast_range);
+            }
+            else {
+                cast_range(range);
+            }
+        }
+    };
+
+    void operator()(Device_array_view src, Device_array &dst, const Element_mapping &mapping)
+    {
+        dispatch<Into>(dst.data_type(), src, dst, mapping);
+    }
+};
+
+template<Data_type dt>
+struct Read_indices_op {
+    std::vector<std::size_t> operator()(Device_array_view arr, std::size_t offset, std::size_t size)
+    {
+        std::vector<std::size_t> indices(size);
+
+        if constexpr (is_index_type(dt)) {
+            auto idx = arr.as<data_type_t<dt>>().subspan(offset, size);
+
+            std::transform(idx.begin(), idx.end(), indices.begin(), [](auto i) {
+                return static_cast<std::size_t>(i);
+            });
+        }
+
+        return indices;
+    }
+};
+
+void check_cpu_array(Device_array_view arr)
+{
+    if (arr.device().kind() != Device_kind::cpu()) {
+        throw Not_supported_error{"Only the features residing in the host memory are supported."};
+    }
+}
+
+void check_cast(Data_type src, Data_type dst)
+{
+    if (src != dst && (src == Data_type::string || dst == Data_type::string)) {
+        throw std::invalid_argument{"The string features cannot be cast to another data type."};
+    }
+}
+
+std::unique_ptr<Device_array>
+cast_array(Device_array_view src, Data_type dt, std::size_t size, const Element_mapping &mapping)
+{
+    check_cpu_array(src);
+
+    check_cast(src.data_type(), dt);
+
+    std::unique_ptr<Device_array> dst = make_cpu_array(dt, size);
+
+    dispatch<Cast_array_op>(src.data_type(), src, *dst, mapping);
+
+    return dst;
+}
+
+std::vector<std::size_t> read_indices(Device_array_view arr, std::size_t offset, std::size_t size)
+{
+    check_cpu_array(arr);
+
+    if (!is_index_type(arr.data_type())) {
+        throw std::invalid_argument{
+            "The index arrays of a sparse feature must be of integer type."};
+    }
+
+    return dispatch<Read_indices_op>(arr.data_type(), arr, offset, size);
+}
+
+std::unique_ptr<Device_array> make_index_array(const std::vector<std::size_t> &indices)
+{
+    std::unique_ptr<Device_array> arr = make_cpu_array(Data_type::size, indices.size());
+
+    std::copy(indices.begin(), indices.end(), as_span<std::size_t>(*arr).begin());
+
+    return arr;
+}
+
+Ssize_vector row_major_strides(const Size_vector &shape)
+{
+    Ssize_vector strides(shape.size());
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = shape.size(); i > 0; i--) {
+        strides[i - 1] = stride;
+
+        stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+    }
+    return strides;
+}
+
+Ssize_vector column_major_strides(const Size_vector &shape)
+{
+    Ssize_vector strides(shape.size());
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = 0; i < shape.size(); i++) {
+        strides[i] = stride;
+
+        stride *= static_cast<std::ptrdiff_t>(shape[i]);
+    }
+    return strides;
+}
+
+std::size_t num_elements(const Size_vector &shape) noexcept
+{
+    std::size_t size = 1;
+    for (std::size_t dim : shape) {
+        size *= dim;
+    }
+    return size;
+}
+
+// Converts a single feature; the tensor is returned as is if it needs
+// no conversion.
+class Tensor_converter final : public Tensor_visitor {
+public:
+    explicit Tensor_converter(const Intrusive_ptr<Tensor> &tensor,
+                              Data_type dt,
+                              const Example_conversion_params &params) noexcept
+        : tensor_{&tensor}, data_type_{dt}, params_{&params}
+    {}
+
+    using Tensor_visitor::visit;
+
+    void visit(const Dense_tensor &tensor) final;
+
+    void visit(const Coo_tensor &tensor) final;
+
+    void visit(const Csr_tensor &tensor) final;
+
+    void visit(const String_tensor &tensor) final;
+
+    Intrusive_ptr<Tensor> &result() noexcept
+    {
+        return result_;
+    }
+
+private:
+    Intrusive_ptr<Tensor> coo_to_csr(const Coo_tensor &tensor) const;
+
+    Intrusive_ptr<Tensor> csr_to_coo(const Csr_tensor &tensor) const;
+
+    const Intrusive_ptr<Tensor> *tensor_;
+    Data_type data_type_;
+    const Example_conversion_params *params_;
+    Intrusive_ptr<Tensor> result_{};
+};
+
+void Tensor_converter::visit(const Dense_tensor &tensor)
+{
+    Device_array_view data = tensor.data();
+
+    const Size_vector &shape = tensor.shape();
+
+    bool column_major = params_->column_major && shape.size() >= 2;
+
+    Ssize_vector strides =
+        column_major ? column_major_strides(shape) : row_major_strides(shape);
+
+    bool same_layout = column_major ? tensor.strides() == strides : true;
+
+    if (data.data_type() == data_type_ && same_layout) {
+        result_ = *tensor_;
+
+        return;
+    }
+
+    Element_mapping mapping{};
+
+    // Row-major source tensors are cast as flat arrays.
+    if (column_major || !detail::is_row_major(tensor)) {
+        mapping.shape = &shape;
+        mapping.src_strides = &tensor.strides();
+        mapping.dst_strides = &strides;
+    }
+
+    std::size_t size = num_elements(shape);
+
+    std::unique_ptr<Device_array> arr{};
+    if (size == 0) {
+        check_cast(data.data_type(), data_type_);
+
+        arr = make_cpu_array(data_type_, 0);
+    }
+    else {
+        arr = cast_array(data, data_type_, size, mapping);
+    }
+
+    result_ = make_intrusive<Dense_tensor>(shape, std::move(arr), std::move(strides));
+}
+
+void Tensor_converter::visit(const Coo_tensor &tensor)
+{
+    if (params_->sparse_tensor_format == Sparse_tensor_format::csr) {
+        result_ = coo_to_csr(tensor);
+
+        return;
+    }
+
+    if (tensor.data().data_type() == data_type_) {
+        result_ = *tensor_;
+
+        return;
+    }
+
+    auto data = cast_array(tensor.data(), data_type_, tensor.data().size(), {});
+
+    std::vector<std::unique_ptr<Device_array>> coordinates{};
+    coordinates.reserve(tensor.shape().size());
+
+    for (std::size_t dim = 0; dim < tensor.shape().size(); dim++) {
+        Device_array_view indices = tensor.indices(dim);
+
+        coordinates.emplace_back(cast_array(indices, indices.data_type(), indices.size(), {}));
+    }
+
+    result_ = make_intrusive<Coo_tensor>(tensor.shape(), std::move(data), std::move(coordinates));
+}
+
+void Tensor_converter::visit(const Csr_tensor &tensor)
+{
+    if (params_->sparse_tensor_format == Sparse_tensor_format::coo) {
+        result_ = csr_to_coo(tensor);
+
+        return;
+    }
+
+    if (tensor.data().data_type() == data_type_) {
+        result_ = *tensor_;
+
+        return;
+    }
+
+    Device_array_view indices = tensor.indices();
+    Device_array_view indptr = tensor.indptr();
+
+    auto data = cast_array(tensor.data(), data_type_, tensor.data().size(), {});
+
+    result_ = make_intrusive<Csr_tensor>(
+        tensor.shape(),
+        std::move(data),
+        cast_array(indices, indices.data_type(), indices.size(), {}),
+        cast_array(indptr, indptr.data_type(), indptr.size(), {}));
+}
+
+void Tensor_converter::visit(const String_tensor &tensor)
+{
+    check_cast(tensor.data_type(), data_type_);
+
+    result_ = *tensor_;
+}
+
+Intrusive_ptr<Tensor> Tensor_converter::coo_to_csr(const Coo_tensor &tensor) const
+{
+    const Size_vector &shape = tensor.shape();
+    if (shape.size() != 2) {
+        throw Not_supported_error{"Only two-dimensional sparse features can be converted to CSR."};
+    }
+
+    std::size_t nnz = tensor.data().size();
+
+    std::vector<std::size_t> rows = read_indices(tensor.indices(0), 0, nnz);
+
+    // Count the values of each row; the counts become the index pointers.
+    std::vector<std::size_t> indptr(shape[0] + 1);
+    for (std::size_t row : rows) {
+        if (row >= shape[0]) {
+            throw std::invalid_argument{"The row indices of the sparse feature are out of range."};
+        }
+        indptr[row + 1]++;
+    }
+
+    std::partial_sum(indptr.begin(), indptr.end(), indptr.begin());
+
+    Element_mapping mapping{};
+
+    // Unless the values are already sorted by row, which is the case for
+    // the tensors built by the readers, order them with a counting sort.
+    std::vector<std::size_t> positions{};
+    if (!std::is_sorted(rows.begin(), rows.end())) {
+        positions.resize(nnz);
+
+        std::vector<std::size_t> next(indptr.begin(), indptr.end() - 1);
+        for (std::size_t i = 0; i < nnz; i++) {
+            positions[next[rows[i]]++] = i;
+        }
+
+        mapping.positions = &positions;
+    }
+
+    Device_array_view cols = tensor.indices(1);
+
+    auto data = cast_array(tensor.data(), data_type_, nnz, mapping);
+    auto indices = cast_array(cols, cols.data_type(), nnz, mapping);
+
+    return make_intrusive<Csr_tensor>(
+        shape, std::move(data), std::move(indices), make_index_array(indptr));
+}
+
+Intrusive_ptr<Tensor> Tensor_converter::csr_to_coo(const Csr_tensor &tensor) const
+{
+    const Size_vector &shape = tensor.shape();
+
+    std::vector<std::size_t> indptr = read_indices(tensor.indptr(), 0, shape[0] + 1);
+
+    // The values of a sliced tensor do not necessarily start at the
+    // beginning of its arrays.
+    std::size_t first = indptr.front();
+    std::size_t nnz = indptr.back() - first;
+
+    std::vector<std::size_t> rows(nnz);
+    for (std::size_t row = 0; row < shape[0]; row++) {
+        std::fill(rows.begin() + as_ssize(indptr[row] - first),
+                  rows.begin() + as_ssize(indptr[row + 1] - first),
+                  row);
+    }
+
+    Element_mapping mapping{};
+    mapping.offset = first;
+
+    Device_array_view cols = tensor.indices();
+
+    std::vector<std::unique_ptr<Device_array>> coordinates{};
+    coordinates.reserve(2);
+
+    coordinates.emplace_back(make_index_array(rows));
+    coordinates.emplace_back(cast_array(cols, cols.data_type(), nnz, mapping));
+
+    auto data = cast_array(tensor.data(), data_type_, nnz, mapping);
+
+    return make_intrusive<Coo_tensor>(shape, std::move(data), std::move(coordinates));
+}
+
+}  // namespace
+
+Intrusive_ptr<Example>
+convert_example(const Example &example, const Example_conversion_params &params)
+{
+    const std::vector<Attribute> &attrs = example.schema().attributes();
+
+    std::vector<std::size_t> indices{};
+    if (params.features.empty()) {
+        indices.resize(attrs.size());
+
+        std::iota(indices.begin(), indices.end(), 0);
+    }
+    else {
+        indices.reserve(params.features.size());
+
+        for (const std::string &name : params.features) {
+            std::optional<std::size_t> idx = example.schema().get_index(name);
+            if (idx == std::nullopt) {
+                throw std::invalid_argument{"The example has no feature named '" + name + "'."};
+            }
+
+            indices.emplace_back(*idx);
+        }
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> tensors(indices.size());
+
+    auto convert_feature = [&](std::size_t i) {
+        const Attribute &attr = attrs[indices[i]];
+
+        Data_type dt = attr.data_type();
+        if (auto pos = params.data_types.find(attr.name()); pos != params.data_types.end()) {
+            dt = pos->second;
+        }
+        else if (params.default_data_type && is_numeric_type(dt)) {
+            dt = *params.default_data_type;
+        }
+
+        const Intrusive_ptr<Tensor> &tensor = example.features()[indices[i]];
+
+        Tensor_converter converter{tensor, dt, params};
+
+        static_cast<const Tensor &>(*tensor).accept(converter);
+
+        tensors[i] = std::move(converter.result());
+    };
+
+    // Only a few features are typically converted; each of them casts
+    // its values in parallel as well.
+    if (indices.size() > 1) {
+        tbb::parallel_for(std::size_t{0}, indices.size(), convert_feature);
+    }
+    else if (indices.size() == 1) {
+        convert_feature(0);
+    }
+
+    std::vector<Attribute> new_attrs{};
+    new_attrs.reserve(indices.size());
+
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        const Attribute &attr = attrs[indices[i]];
+
+        const Tensor &tensor = *tensors[i];
+
+        Ssize_vector strides = attr.strides();
+        if (!attr.sparse()) {
+            strides = tensor.strides();
+        }
+
+        new_attrs.emplace_back(
+            attr.name(), tensor.data_type(), attr.shape(), std::move(strides), attr.sparse());
+    }
+
+    auto converted = make_intrusive<Example>(make_intrusive<Schema>(std::move(new_attrs)),
+                                             std::move(tensors));
+
+    converted->padding = example.padding;
+
+    return converted;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/example_transform.h"
+
+#include "mlio/schema.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Example_transform::~Example_transform() = default;
+
+Intrusive_ptr<const Schema> Example_transform::transform_schema(Intrusive_ptr<const Schema> schema)
+{
+    return schema;
+}
+
+std::size_t Example_transform::max_concurrency() const noexcept
+{
+    return 0;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
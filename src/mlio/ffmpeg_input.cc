@@ -0,0 +1,248 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#if defined(MLIO_BUILD_VIDEO_READER) || defined(MLIO_BUILD_AUDIO_READER)
+
+#include "mlio/ffmpeg_input.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <fmt/format.h>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+}
+
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr int io_buffer_size = 0x10000;
+
+}  // namespace
+
+Ffmpeg_input::~Ffmpeg_input()
+{
+    ::av_packet_free(&packet_);
+
+    ::avcodec_free_context(&codec_ctx_);
+
+    ::avformat_close_input(&fmt_ctx_);
+
+    // The format context does not own a custom I/O context.
+    if (io_ctx_ != nullptr) {
+        ::av_freep(&io_ctx_->buffer);
+        ::avio_context_free(&io_ctx_);
+    }
+}
+
+bool Ffmpeg_input::open(::AVMediaType media_type)
+{
+    auto *buffer = static_cast<unsigned char *>(::av_malloc(io_buffer_size));
+    if (buffer == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    io_ctx_ = ::avio_alloc_context(
+        buffer, io_buffer_size, 0, this, &read_packet, nullptr, &seek_packet);
+    if (io_ctx_ == nullptr) {
+        ::av_free(buffer);
+
+        throw std::bad_alloc{};
+    }
+
+    fmt_ctx_ = ::avformat_alloc_context();
+    if (fmt_ctx_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    fmt_ctx_->pb = io_ctx_;
+    fmt_ctx_->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    // On failure avformat_open_input() frees the format context.
+    int err = ::avformat_open_input(&fmt_ctx_, nullptr, nullptr, nullptr);
+    if (err < 0) {
+        return fail("open the container", err);
+    }
+
+    err = ::avformat_find_stream_info(fmt_ctx_, nullptr);
+    if (err < 0) {
+        return fail("read the stream information", err);
+    }
+
+    const ::AVCodec *codec{};
+
+    int stream_idx = ::av_find_best_stream(fmt_ctx_, media_type, -1, -1, &codec, 0);
+    if (stream_idx < 0) {
+        return fail("find a stream to decode", stream_idx);
+    }
+
+    stream_ = fmt_ctx_->streams[stream_idx];
+
+    codec_ctx_ = ::avcodec_alloc_context3(codec);
+    if (codec_ctx_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    err = ::avcodec_parameters_to_context(codec_ctx_, stream_->codecpar);
+    if (err < 0) {
+        return fail("read the codec parameters", err);
+    }
+
+    // The files of a batch are already decoded in parallel.
+    codec_ctx_->thread_count = 1;
+
+    err = ::avcodec_open2(codec_ctx_, codec, nullptr);
+    if (err < 0) {
+        return fail("open the decoder", err);
+    }
+
+    packet_ = ::av_packet_alloc();
+    if (packet_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    return true;
+}
+
+int Ffmpeg_input::read_frame(::AVFrame &frame)
+{
+    while (true) {
+        int err = ::avcodec_receive_frame(codec_ctx_, &frame);
+        if (err != AVERROR(EAGAIN)) {
+            return err;
+        }
+
+        err = ::av_read_frame(fmt_ctx_, packet_);
+        if (err == AVERROR_EOF) {
+            // Drain the frames buffered in the decoder.
+            err = ::avcodec_send_packet(codec_ctx_, nullptr);
+            if (err < 0 && err != AVERROR_EOF) {
+                return err;
+            }
+
+            continue;
+        }
+        if (err < 0) {
+            return err;
+        }
+
+        if (packet_->stream_index == stream_->index) {
+            err = ::avcodec_send_packet(codec_ctx_, packet_);
+        }
+
+        ::av_packet_unref(packet_);
+
+        if (err < 0) {
+            return err;
+        }
+    }
+}
+
+int Ffmpeg_input::seek(std::int64_t ts)
+{
+    int err = ::av_seek_frame(fmt_ctx_, stream_->index, ts, AVSEEK_FLAG_BACKWARD);
+    if (err < 0) {
+        return err;
+    }
+
+    ::avcodec_flush_buffers(codec_ctx_);
+
+    return 0;
+}
+
+bool Ffmpeg_input::fail(std::string_view operation, int err)
+{
+    std::array<char, AV_ERROR_MAX_STRING_SIZE> buf{};
+
+    ::av_strerror(err, buf.data(), buf.size());
+
+    return fail(fmt::format("FFmpeg failed to {0}: {1}", operation, buf.data()));
+}
+
+bool Ffmpeg_input::fail(std::string msg)
+{
+    error_ = std::move(msg);
+
+    return false;
+}
+
+int Ffmpeg_input::read_packet(void *opaque, std::uint8_t *buf, int buf_size) noexcept
+{
+    auto *input = static_cast<Ffmpeg_input *>(opaque);
+
+    std::size_t size = input->bits_.size() - input->pos_;
+    if (size == 0) {
+        return AVERROR_EOF;
+    }
+
+    size = std::min(size, static_cast<std::size_t>(buf_size));
+
+    std::memcpy(buf, input->bits_.data() + input->pos_, size);
+
+    input->pos_ += size;
+
+    return static_cast<int>(size);
+}
+
+std::int64_t Ffmpeg_input::seek_packet(void *opaque, std::int64_t offset, int whence) noexcept
+{
+    auto *input = static_cast<Ffmpeg_input *>(opaque);
+
+    auto size = as_ssize(input->bits_.size());
+
+    if (whence == AVSEEK_SIZE) {
+        return size;
+    }
+
+    std::int64_t pos{};
+
+    switch (whence & ~AVSEEK_FORCE) {
+    case SEEK_SET:
+        pos = offset;
+        break;
+    case SEEK_CUR:
+        pos = as_ssize(input->pos_) + offset;
+        break;
+    case SEEK_END:
+        pos = size + offset;
+        break;
+    default:
+        return -1;
+    }
+
+    if (pos < 0 || pos > size) {
+        return -1;
+    }
+
+    input->pos_ = static_cast<std::size_t>(pos);
+
+    return pos;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
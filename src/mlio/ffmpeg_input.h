@@ -0,0 +1,109 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include "mlio/memory/memory_slice.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Demuxes and decodes the best stream of a given media type from a
+// media file held in memory. Shared by the readers that use FFmpeg.
+class Ffmpeg_input {
+public:
+    explicit Ffmpeg_input(Memory_slice bits) noexcept : bits_{std::move(bits)}
+    {}
+
+    Ffmpeg_input(const Ffmpeg_input &) = delete;
+
+    Ffmpeg_input &operator=(const Ffmpeg_input &) = delete;
+
+    Ffmpeg_input(Ffmpeg_input &&) = delete;
+
+    Ffmpeg_input &operator=(Ffmpeg_input &&) = delete;
+
+    ~Ffmpeg_input();
+
+    // Opens the container, and the decoder of its best stream of the
+    // specified media type. Returns false and sets the error message if
+    // the file cannot be decoded.
+    bool open(::AVMediaType media_type);
+
+    // Decodes the next frame of the stream. Returns zero on success,
+    // AVERROR_EOF once the decoder is drained, or a negative error code.
+    int read_frame(::AVFrame &frame);
+
+    // Seeks to the keyframe at or before the specified timestamp and
+    // flushes the decoder.
+    int seek(std::int64_t ts);
+
+    // Sets the error message to describe the specified FFmpeg error and
+    // returns false.
+    bool fail(std::string_view operation, int err);
+
+    // Sets the error message and returns false.
+    bool fail(std::string msg);
+
+    ::AVFormatContext *format_context() noexcept
+    {
+        return fmt_ctx_;
+    }
+
+    ::AVCodecContext *codec_context() noexcept
+    {
+        return codec_ctx_;
+    }
+
+    ::AVStream *stream() noexcept
+    {
+        return stream_;
+    }
+
+    const std::string &error() const noexcept
+    {
+        return error_;
+    }
+
+private:
+    static int read_packet(void *opaque, std::uint8_t *buf, int buf_size) noexcept;
+
+    static std::int64_t seek_packet(void *opaque, std::int64_t offset, int whence) noexcept;
+
+    Memory_slice bits_;
+    std::size_t pos_{};
+    ::AVIOContext *io_ctx_{};
+    ::AVFormatContext *fmt_ctx_{};
+    ::AVCodecContext *codec_ctx_{};
+    ::AVStream *stream_{};
+    ::AVPacket *packet_{};
+    std::string error_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,337 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/gcs_client.h"
+
+#ifdef MLIO_BUILD_GCS
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <absl/types/variant.h>
+#include <google/cloud/credentials.h>
+#include <google/cloud/options.h>
+#include <google/cloud/status.h>
+#include <google/cloud/storage/client.h>
+
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/error.h"
+#include "mlio/detail/object_listing.h"
+#include "mlio/detail/tracing.h"
+#include "mlio/util/cast.h"
+
+namespace gcs = google::cloud::storage;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Gcs_native_client {
+    gcs::Client client;
+};
+
+namespace {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+[[noreturn]] void throw_gcs_error(const google::cloud::Status &status)
+{
+    std::error_code ec;
+
+    switch (status.code()) {
+    case google::cloud::StatusCode::kUnavailable:
+        ec = std::make_error_code(std::errc::host_unreachable);
+        break;
+    case google::cloud::StatusCode::kPermissionDenied:
+    case google::cloud::StatusCode::kUnauthenticated:
+        ec = std::make_error_code(std::errc::permission_denied);
+        break;
+    case google::cloud::StatusCode::kNotFound:
+        ec = std::make_error_code(std::errc::no_such_file_or_directory);
+        break;
+    case google::cloud::StatusCode::kDeadlineExceeded:
+        ec = std::make_error_code(std::errc::timed_out);
+        break;
+    default:
+        ec = std::make_error_code(std::errc::io_error);
+        break;
+    }
+
+    throw std::system_error{ec, "The GCS object cannot be accessed."};
+}
+
+#pragma GCC diagnostic pop
+
+// The version of a GCS object is its generation number.
+gcs::Generation make_generation(std::string_view version_id)
+{
+    if (version_id.empty()) {
+        return gcs::Generation{};
+    }
+
+    std::int64_t generation{};
+
+    auto [end, ec] =
+        std::from_chars(version_id.data(), version_id.data() + version_id.size(), generation);
+    if (ec != std::errc{} || end != version_id.data() + version_id.size()) {
+        throw std::invalid_argument{"The version of a GCS object must be its generation number."};
+    }
+
+    return gcs::Generation{generation};
+}
+
+void list_prefix(const gcs::Client &client,
+                 std::string_view bucket,
+                 std::string_view prefix,
+                 std::string_view delimiter,
+                 Object_listing &listing)
+{
+    // The listing functions are not const-qualified, but the client is
+    // a handle to a thread-safe connection.
+    gcs::Client clt = client;
+
+    std::string bucket_name{bucket};
+
+    if (delimiter.empty()) {
+        for (auto &&meta : clt.ListObjects(bucket_name, gcs::Prefix{std::string{prefix}})) {
+            if (!meta) {
+                throw_gcs_error(meta.status());
+            }
+
+            listing.objects.emplace_back(meta->name(), as_size(meta->size()));
+        }
+
+        return;
+    }
+
+    auto items = clt.ListObjectsAndPrefixes(
+        bucket_name, gcs::Prefix{std::string{prefix}}, gcs::Delimiter{std::string{delimiter}});
+
+    for (auto &&item : items) {
+        if (!item) {
+            throw_gcs_error(item.status());
+        }
+
+        if (const auto *meta = absl::get_if<gcs::ObjectMetadata>(&*item)) {
+            listing.objects.emplace_back(meta->name(), as_size(meta->size()));
+        }
+        else {
+            listing.common_prefixes.emplace_back(absl::get<std::string>(*item));
+        }
+    }
+}
+
+std::string read_text_file(std::string_view path)
+{
+    std::ifstream file{std::string{path}};
+    if (!file) {
+        throw std::system_error{current_error_code(),
+                                "The credentials file cannot be opened."};
+    }
+
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+google::cloud::Options make_client_options(const Gcs_client_options &opts)
+{
+    google::cloud::Options options{};
+
+    if (opts.anonymous) {
+        options.set<google::cloud::UnifiedCredentialsOption>(
+            google::cloud::MakeInsecureCredentials());
+    }
+    else if (!opts.credentials_file.empty()) {
+        options.set<google::cloud::UnifiedCredentialsOption>(
+            google::cloud::MakeServiceAccountCredentials(read_text_file(opts.credentials_file)));
+    }
+    else {
+        options.set<google::cloud::UnifiedCredentialsOption>(
+            google::cloud::MakeGoogleDefaultCredentials());
+    }
+
+    if (opts.max_connections > 0) {
+        options.set<gcs::ConnectionPoolSizeOption>(opts.max_connections);
+    }
+    if (opts.stall_timeout.count() > 0) {
+        auto timeout = std::chrono::duration_cast<std::chrono::seconds>(opts.stall_timeout);
+
+        options.set<gcs::TransferStallTimeoutOption>(std::max(timeout, std::chrono::seconds{1}));
+        options.set<gcs::DownloadStallTimeoutOption>(std::max(timeout, std::chrono::seconds{1}));
+    }
+    if (opts.max_attempts > 0) {
+        auto max_failures = static_cast<int>(opts.max_attempts - 1);
+
+        options.set<gcs::RetryPolicyOption>(
+            gcs::LimitedErrorCountRetryPolicy{max_failures}.clone());
+    }
+    if (!opts.endpoint_override.empty()) {
+        options.set<gcs::RestEndpointOption>(std::string{opts.endpoint_override});
+    }
+
+    return options;
+}
+
+}  // namespace
+}  // namespace detail
+
+Gcs_client::Gcs_client(std::unique_ptr<detail::Gcs_native_client> native_client,
+                       const Range_read_params &range_read_params,
+                       Intrusive_ptr<S3_object_cache> object_cache) noexcept
+    : Object_store_client{range_read_params, std::move(object_cache)}
+    , native_client_{std::move(native_client)}
+{}
+
+Gcs_client::~Gcs_client() = default;
+
+void Gcs_client::list_objects(std::string_view bucket,
+                              std::string_view prefix,
+                              const List_callback &callback) const
+{
+    const gcs::Client &client = native_client_->client;
+
+    auto list_prefix = [&client, bucket](std::string_view pfx,
+                                         std::string_view delimiter,
+                                         detail::Object_listing &listing) {
+        detail::list_prefix(client, bucket, pfx, delimiter, listing);
+    };
+
+    detail::list_objects_in_parallel(list_prefix, "gs", bucket, prefix, callback);
+}
+
+std::size_t Gcs_client::read_object(std::string_view bucket,
+                                    std::string_view key,
+                                    std::string_view version_id,
+                                    std::size_t offset,
+                                    Mutable_memory_span destination) const
+{
+    detail::Trace_span span{"gcs_read_object"};
+    detail::Allocation_scope scope{detail::Allocation_stage::io};
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    gcs::Client client = native_client_->client;
+
+    auto begin = static_cast<std::int64_t>(offset);
+    auto end = static_cast<std::int64_t>(offset + destination.size());
+
+    auto reader = client.ReadObject(std::string{bucket},
+                                    std::string{key},
+                                    gcs::ReadRange{begin, end},
+                                    detail::make_generation(version_id));
+
+    auto chars = as_span<char>(destination);
+
+    reader.read(chars.data(), static_cast<std::streamsize>(chars.size()));
+
+    if (!reader.status().ok()) {
+        detail::throw_gcs_error(reader.status());
+    }
+
+    return static_cast<std::size_t>(reader.gcount()) * sizeof(char);
+}
+
+Object_metadata Gcs_client::read_object_metadata(std::string_view bucket,
+                                                 std::string_view key,
+                                                 std::string_view version_id) const
+{
+    gcs::Client client = native_client_->client;
+
+    auto meta = client.GetObjectMetadata(
+        std::string{bucket}, std::string{key}, detail::make_generation(version_id));
+    if (!meta) {
+        detail::throw_gcs_error(meta.status());
+    }
+
+    return {as_size(meta->size()), meta->etag()};
+}
+
+Intrusive_ptr<Gcs_client> make_gcs_client(const Gcs_client_options &opts)
+{
+    auto native_client = std::make_unique<detail::Gcs_native_client>(
+        detail::Gcs_native_client{gcs::Client{detail::make_client_options(opts)}});
+
+    return make_intrusive<Gcs_client>(
+        std::move(native_client), opts.range_read_params, opts.object_cache);
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Gcs_native_client {};
+
+}  // namespace detail
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+Gcs_client::Gcs_client(std::unique_ptr<detail::Gcs_native_client>,
+                       const Range_read_params &,
+                       Intrusive_ptr<S3_object_cache>) noexcept
+    : Object_store_client{{}, {}}
+{}
+
+Gcs_client::~Gcs_client() = default;
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Gcs_client::list_objects(std::string_view, std::string_view, const List_callback &) const
+{}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::size_t Gcs_client::read_object(std::string_view,
+                                    std::string_view,
+                                    std::string_view,
+                                    std::size_t,
+                                    Mutable_memory_span) const
+{
+    return 0;
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+Object_metadata
+Gcs_client::read_object_metadata(std::string_view, std::string_view, std::string_view) const
+{
+    return {};
+}
+
+Intrusive_ptr<Gcs_client> make_gcs_client(const Gcs_client_options &)
+{
+    throw Not_supported_error{"MLIO was not built with Google Cloud Storage support."};
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,688 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/http_client.h"
+
+#include "mlio/not_supported_error.h"
+
+#ifdef MLIO_BUILD_HTTP
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <curl/curl.h>
+#include <fmt/format.h>
+
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/tracing.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+struct Curl_easy_deleter {
+    void operator()(CURL *handle) const noexcept
+    {
+        ::curl_easy_cleanup(handle);
+    }
+};
+
+struct Curl_share_deleter {
+    void operator()(CURLSH *share) const noexcept
+    {
+        ::curl_share_cleanup(share);
+    }
+};
+
+struct Curl_slist_deleter {
+    void operator()(curl_slist *list) const noexcept
+    {
+        ::curl_slist_free_all(list);
+    }
+};
+
+using Curl_easy_ptr = std::unique_ptr<CURL, Curl_easy_deleter>;
+using Curl_share_ptr = std::unique_ptr<CURLSH, Curl_share_deleter>;
+using Curl_slist_ptr = std::unique_ptr<curl_slist, Curl_slist_deleter>;
+
+}  // namespace
+
+// Holds the easy handles of libcurl that are idle. An easy handle keeps
+// its connections open after a transfer, so reusing the handles reuses
+// the connections. The DNS cache and the TLS sessions are shared by all
+// handles of the pool.
+struct Http_connection_pool {
+    std::string scheme{};
+    std::vector<std::string> headers{};
+    std::size_t max_connections{};
+    long connect_timeout_ms{};
+    long stall_timeout_s{};
+    std::size_t max_attempts{};
+    bool verify_peer{};
+
+    Curl_share_ptr share{};
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> share_mutexes{};
+
+    std::mutex mutex{};
+    std::vector<Curl_easy_ptr> idle_handles{};
+};
+
+namespace {
+
+void lock_share(CURL *, curl_lock_data data, curl_lock_access, void *userptr) noexcept
+{
+    static_cast<Http_connection_pool *>(userptr)->share_mutexes[data].lock();
+}
+
+void unlock_share(CURL *, curl_lock_data data, void *userptr) noexcept
+{
+    static_cast<Http_connection_pool *>(userptr)->share_mutexes[data].unlock();
+}
+
+// Leases an easy handle from the pool for the duration of a request.
+class Curl_handle_lease {
+public:
+    explicit Curl_handle_lease(Http_connection_pool &pool) : pool_{&pool}
+    {
+        {
+            std::unique_lock<std::mutex> lock{pool_->mutex};
+
+            if (!pool_->idle_handles.empty()) {
+                handle_ = std::move(pool_->idle_handles.back());
+
+                pool_->idle_handles.pop_back();
+            }
+        }
+
+        if (handle_) {
+            // Resets the options, but keeps the open connections.
+            ::curl_easy_reset(handle_.get());
+        }
+        else {
+            handle_.reset(::curl_easy_init());
+            if (handle_ == nullptr) {
+                throw std::bad_alloc{};
+            }
+        }
+    }
+
+    Curl_handle_lease(const Curl_handle_lease &) = delete;
+
+    Curl_handle_lease &operator=(const Curl_handle_lease &) = delete;
+
+    Curl_handle_lease(Curl_handle_lease &&) = delete;
+
+    Curl_handle_lease &operator=(Curl_handle_lease &&) = delete;
+
+    ~Curl_handle_lease()
+    {
+        std::unique_lock<std::mutex> lock{pool_->mutex};
+
+        if (pool_->idle_handles.size() < pool_->max_connections) {
+            try {
+                pool_->idle_handles.emplace_back(std::move(handle_));
+            }
+            catch (...) {
+            }
+        }
+    }
+
+    CURL *get() const noexcept
+    {
+        return handle_.get();
+    }
+
+private:
+    Http_connection_pool *pool_;
+    Curl_easy_ptr handle_{};
+};
+
+// Holds the state of a single request; the body is written directly
+// into the destination buffer.
+struct Http_transfer {
+    CURL *handle{};
+    std::byte *data{};
+    std::size_t size{};
+    std::size_t offset{};
+    long status{};
+    std::size_t num_bytes_to_skip{};
+    std::size_t num_bytes_read{};
+    bool is_full{};
+    std::string etag{};
+    std::optional<std::size_t> total_size{};
+    std::optional<std::size_t> content_length{};
+};
+
+std::optional<std::size_t> parse_size(std::string_view s) noexcept
+{
+    std::size_t value{};
+
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec != std::errc{} || end != s.data() + s.size()) {
+        return {};
+    }
+
+    return value;
+}
+
+std::string_view trim(std::string_view s) noexcept
+{
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())) != 0) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())) != 0) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+bool starts_with_header(std::string_view line, std::string_view name) noexcept
+{
+    if (line.size() <= name.size() || line[name.size()] != ':') {
+        return false;
+    }
+
+    // Header names are case-insensitive; the name we look for is in
+    // lower case.
+    return std::equal(name.begin(), name.end(), line.begin(), [](char a, char b) {
+        return a == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+std::size_t write_header(char *buffer, std::size_t size, std::size_t count, void *userdata)
+{
+    auto &transfer = *static_cast<Http_transfer *>(userdata);
+
+    std::string_view line{buffer, size * count};
+
+    // A redirect or an interim response starts a new set of headers.
+    if (line.substr(0, 5) == "HTTP/") {
+        transfer.etag.clear();
+        transfer.total_size = std::nullopt;
+        transfer.content_length = std::nullopt;
+    }
+    else if (starts_with_header(line, "etag")) {
+        transfer.etag = trim(line.substr(5));
+    }
+    else if (starts_with_header(line, "content-range")) {
+        // Either "bytes <first>-<last>/<total>" or "bytes */<total>".
+        std::string_view value = trim(line.substr(14));
+
+        auto pos = value.find('/');
+        if (pos != std::string_view::npos) {
+            transfer.total_size = parse_size(value.substr(pos + 1));
+        }
+    }
+    else if (starts_with_header(line, "content-length")) {
+        transfer.content_length = parse_size(trim(line.substr(15)));
+    }
+
+    return size * count;
+}
+
+std::size_t write_body(char *buffer, std::size_t size, std::size_t count, void *userdata)
+{
+    auto &transfer = *static_cast<Http_transfer *>(userdata);
+
+    std::size_t num_bytes = size * count;
+
+    if (transfer.status == 0) {
+        ::curl_easy_getinfo(transfer.handle, CURLINFO_RESPONSE_CODE, &transfer.status);
+
+        // The server ignored the Range header and sends the whole
+        // object.
+        if (transfer.status == 200) {
+            transfer.num_bytes_to_skip = transfer.offset;
+        }
+    }
+
+    // The body of an error response is not of interest.
+    if (transfer.status != 200 && transfer.status != 206) {
+        return num_bytes;
+    }
+
+    std::size_t num_bytes_to_skip = std::min(transfer.num_bytes_to_skip, num_bytes);
+
+    transfer.num_bytes_to_skip -= num_bytes_to_skip;
+
+    buffer += num_bytes_to_skip;
+
+    std::size_t num_bytes_left = num_bytes - num_bytes_to_skip;
+
+    std::size_t num_bytes_to_copy =
+        std::min(num_bytes_left, transfer.size - transfer.num_bytes_read);
+
+    std::memcpy(transfer.data + transfer.num_bytes_read, buffer, num_bytes_to_copy);
+
+    transfer.num_bytes_read += num_bytes_to_copy;
+
+    // Abort the transfer once the destination is full; the rest of the
+    // object is not needed.
+    if (num_bytes_to_copy < num_bytes_left) {
+        transfer.is_full = true;
+
+        return 0;
+    }
+
+    return num_bytes;
+}
+
+[[noreturn]] void throw_http_error(long status)
+{
+    std::error_code ec;
+
+    switch (status) {
+    case 401:
+    case 403:
+        ec = std::make_error_code(std::errc::permission_denied);
+        break;
+    case 404:
+    case 410:
+        ec = std::make_error_code(std::errc::no_such_file_or_directory);
+        break;
+    case 408:
+    case 504:
+        ec = std::make_error_code(std::errc::timed_out);
+        break;
+    case 503:
+        ec = std::make_error_code(std::errc::host_unreachable);
+        break;
+    case 412:
+        throw std::system_error{std::make_error_code(std::errc::io_error),
+                                "The HTTP object has been modified while being read."};
+    default:
+        ec = std::make_error_code(std::errc::io_error);
+        break;
+    }
+
+    throw std::system_error{
+        ec, fmt::format("The HTTP object cannot be accessed. The server returned {0}.", status)};
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+[[noreturn]] void throw_curl_error(CURLcode code)
+{
+    std::error_code ec;
+
+    switch (code) {
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_COULDNT_CONNECT:
+        ec = std::make_error_code(std::errc::host_unreachable);
+        break;
+    case CURLE_OPERATION_TIMEDOUT:
+        ec = std::make_error_code(std::errc::timed_out);
+        break;
+    default:
+        ec = std::make_error_code(std::errc::io_error);
+        break;
+    }
+
+    throw std::system_error{
+        ec, fmt::format("The HTTP object cannot be accessed: {0}", ::curl_easy_strerror(code))};
+}
+
+bool is_transient_error(CURLcode code) noexcept
+{
+    switch (code) {
+    case CURLE_COULDNT_CONNECT:
+    case CURLE_OPERATION_TIMEDOUT:
+    case CURLE_GOT_NOTHING:
+    case CURLE_PARTIAL_FILE:
+    case CURLE_SEND_ERROR:
+    case CURLE_RECV_ERROR:
+    case CURLE_SSL_CONNECT_ERROR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+bool is_transient_status(long status) noexcept
+{
+    return status == 408 || status == 429 || status >= 500;
+}
+
+void append_header(Curl_slist_ptr &headers, const std::string &header)
+{
+    curl_slist *list = ::curl_slist_append(headers.get(), header.c_str());
+    if (list == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    // The list is extended in place unless it was empty.
+    static_cast<void>(headers.release());
+
+    headers.reset(list);
+}
+
+void set_common_options(const Http_connection_pool &pool,
+                        CURL *handle,
+                        const std::string &url,
+                        curl_slist *headers,
+                        Http_transfer &transfer)
+{
+    ::curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    ::curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+    ::curl_easy_setopt(handle, CURLOPT_SHARE, pool.share.get());
+    ::curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    ::curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    ::curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+
+    if (!pool.verify_peer) {
+        ::curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+        ::curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+    }
+
+    if (pool.connect_timeout_ms > 0) {
+        ::curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, pool.connect_timeout_ms);
+    }
+
+    if (pool.stall_timeout_s > 0) {
+        ::curl_easy_setopt(handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        ::curl_easy_setopt(handle, CURLOPT_LOW_SPEED_TIME, pool.stall_timeout_s);
+    }
+
+    ::curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &write_header);
+    ::curl_easy_setopt(handle, CURLOPT_HEADERDATA, &transfer);
+    ::curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &write_body);
+    ::curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer);
+}
+
+// Requests the specified byte range of the object and writes the body
+// into @p destination. Transient errors are retried with exponential
+// backoff. Returns the status code of the response.
+long perform_range_request(Http_connection_pool &pool,
+                           std::string_view bucket,
+                           std::string_view key,
+                           std::string_view etag,
+                           std::size_t offset,
+                           Mutable_memory_span destination,
+                           Http_transfer &transfer)
+{
+    std::string url = fmt::format("{0}://{1}/{2}", pool.scheme, bucket, key);
+
+    Curl_slist_ptr headers{};
+    for (const std::string &header : pool.headers) {
+        append_header(headers, header);
+    }
+
+    append_header(headers,
+                  fmt::format("Range: bytes={0}-{1}", offset, offset + destination.size() - 1));
+
+    if (!etag.empty()) {
+        append_header(headers, fmt::format("If-Match: {0}", etag));
+    }
+
+    Curl_handle_lease lease{pool};
+
+    auto backoff = std::chrono::milliseconds{100};
+
+    for (std::size_t attempt = 1;; attempt++) {
+        transfer = Http_transfer{};
+        transfer.handle = lease.get();
+        transfer.data = destination.data();
+        transfer.size = destination.size();
+        transfer.offset = offset;
+
+        set_common_options(pool, lease.get(), url, headers.get(), transfer);
+
+        CURLcode code = ::curl_easy_perform(lease.get());
+        if (code == CURLE_WRITE_ERROR && transfer.is_full) {
+            code = CURLE_OK;
+        }
+
+        long status = 0;
+        if (code == CURLE_OK) {
+            ::curl_easy_getinfo(lease.get(), CURLINFO_RESPONSE_CODE, &status);
+
+            if (!is_transient_status(status)) {
+                return status;
+            }
+        }
+        else if (!is_transient_error(code)) {
+            throw_curl_error(code);
+        }
+
+        if (attempt >= pool.max_attempts) {
+            if (code != CURLE_OK) {
+                throw_curl_error(code);
+            }
+            throw_http_error(status);
+        }
+
+        std::this_thread::sleep_for(backoff);
+
+        backoff = std::min(backoff * 2, std::chrono::milliseconds{5000});
+    }
+}
+
+}  // namespace
+}  // namespace detail
+
+Http_client::Http_client(std::unique_ptr<detail::Http_connection_pool> pool,
+                         const Range_read_params &range_read_params,
+                         Intrusive_ptr<S3_object_cache> object_cache) noexcept
+    : Object_store_client{range_read_params, std::move(object_cache)}, pool_{std::move(pool)}
+{}
+
+Http_client::~Http_client() = default;
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Http_client::list_objects(std::string_view, std::string_view, const List_callback &) const
+{
+    throw Not_supported_error{"HTTP servers do not support listing objects."};
+}
+
+std::size_t Http_client::read_object(std::string_view bucket,
+                                     std::string_view key,
+                                     std::string_view version_id,
+                                     std::size_t offset,
+                                     Mutable_memory_span destination) const
+{
+    detail::Trace_span span{"http_read_object"};
+    detail::Allocation_scope scope{detail::Allocation_stage::io};
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    detail::Http_transfer transfer{};
+
+    long status = detail::perform_range_request(
+        *pool_, bucket, key, version_id, offset, destination, transfer);
+
+    switch (status) {
+    case 200:
+    case 206:
+        return transfer.num_bytes_read;
+    // The offset is at or past the end of the object.
+    case 416:
+        return 0;
+    default:
+        detail::throw_http_error(status);
+    }
+}
+
+Object_metadata Http_client::read_object_metadata(std::string_view bucket,
+                                                  std::string_view key,
+                                                  std::string_view version_id) const
+{
+    // Instead of a HEAD request, which is often not permitted by signed
+    // URLs, we request the first byte and take the size from the
+    // Content-Range header of the response.
+    std::byte first_byte{};
+
+    detail::Http_transfer transfer{};
+
+    long status = detail::perform_range_request(
+        *pool_, bucket, key, version_id, 0, Mutable_memory_span{&first_byte, 1}, transfer);
+
+    std::optional<std::size_t> size{};
+
+    switch (status) {
+    case 206:
+    // An empty object has no range to satisfy.
+    case 416:
+        size = transfer.total_size;
+        break;
+    case 200:
+        size = transfer.content_length;
+        break;
+    default:
+        detail::throw_http_error(status);
+    }
+
+    if (!size) {
+        throw std::system_error{std::make_error_code(std::errc::io_error),
+                                "The size of the HTTP object cannot be determined."};
+    }
+
+    return Object_metadata{*size, std::move(transfer.etag)};
+}
+
+std::string_view Http_client::uri_scheme() const noexcept
+{
+    return pool_->scheme;
+}
+
+Intrusive_ptr<Http_client> make_http_client(const Http_client_options &opts)
+{
+    static std::once_flag init_flag{};
+
+    std::call_once(init_flag, []() {
+        if (::curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
+            throw std::runtime_error{"libcurl cannot be initialized."};
+        }
+    });
+
+    auto pool = std::make_unique<detail::Http_connection_pool>();
+
+    pool->scheme = opts.use_https ? "https" : "http";
+    pool->headers = opts.headers;
+    pool->max_connections = opts.max_connections;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuseless-cast"
+#endif
+
+    // The representation of the durations is not long on all platforms.
+    pool->connect_timeout_ms = static_cast<long>(opts.connect_timeout.count());
+    pool->stall_timeout_s = static_cast<long>(
+        std::chrono::ceil<std::chrono::seconds>(opts.stall_timeout).count());
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+    pool->max_attempts = std::max(opts.max_attempts, std::size_t{1});
+    pool->verify_peer = opts.verify_peer;
+
+    pool->share.reset(::curl_share_init());
+    if (pool->share == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    CURLSH *share = pool->share.get();
+
+    ::curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &detail::lock_share);
+    ::curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &detail::unlock_share);
+    ::curl_share_setopt(share, CURLSHOPT_USERDATA, pool.get());
+    ::curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    ::curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    return make_intrusive<Http_client>(
+        std::move(pool), opts.range_read_params, opts.object_cache);
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Http_connection_pool {};
+
+}  // namespace detail
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+Http_client::Http_client(std::unique_ptr<detail::Http_connection_pool>,
+                         const Range_read_params &,
+                         Intrusive_ptr<S3_object_cache>) noexcept
+    : Object_store_client{{}, {}}
+{}
+
+Http_client::~Http_client() = default;
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Http_client::list_objects(std::string_view, std::string_view, const List_callback &) const
+{}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::size_t Http_client::read_object(std::string_view,
+                                     std::string_view,
+                                     std::string_view,
+                                     std::size_t,
+                                     Mutable_memory_span) const
+{
+    return 0;
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+Object_metadata
+Http_client::read_object_metadata(std::string_view, std::string_view, std::string_view) const
+{
+    return {};
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::string_view Http_client::uri_scheme() const noexcept
+{
+    return "https";
+}
+
+Intrusive_ptr<Http_client> make_http_client(const Http_client_options &)
+{
+    throw Not_supported_error{"MLIO was not built with HTTP support."};
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -17,33 +17,86 @@
 
 #ifdef MLIO_BUILD_IMAGE_READER
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include <fmt/format.h>
+#include <opencv2/core/utility.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
+#include <tbb/tbb.h>
 
 #include "mlio/cpu_array.h"
 #include "mlio/data_reader_error.h"
 #include "mlio/data_stores/data_store.h"
 #include "mlio/data_type.h"
+#include "mlio/image_size.h"
+#include "mlio/image_transformer.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/jpeg_decoder.h"
 #include "mlio/logger.h"
 #include "mlio/parallel_data_reader.h"
 #include "mlio/record_readers/recordio_record_reader.h"
+#include "mlio/record_readers/tar_record_reader.h"
 #include "mlio/schema.h"
 #include "mlio/util/cast.h"
+#include "mlio/util/hash.h"
+#include "mlio/webp_decoder.h"
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace {
+
+// WebDataset shards store the labels and other metadata of a sample as
+// separate members next to the image.
+bool is_image_file_name(std::string_view name) noexcept
+{
+    std::size_t pos = name.rfind('.');
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+
+    std::string ext{name.substr(pos + 1)};
+
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char chr) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(chr)));
+    });
+
+    for (std::string_view image_ext :
+         {"jpg", "jpeg", "png", "bmp", "tif", "tiff", "webp", "ppm", "pgm", "pbm"}) {
+        if (ext == image_ext) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+struct Image_reader::Decode_scratch {
+    cv::Mat image{};
+#ifdef MLIO_BUILD_JPEG_TURBO
+    std::unique_ptr<detail::Jpeg_decoder> jpeg_decoder{};
+#endif
+};
 
 Image_reader::Image_reader(Data_reader_params params, Image_reader_params img_params)
     : Parallel_data_reader{std::move(params)}, params_{std::move(img_params)}
 {
-    if (params_.image_dimensions.size() != image_dimensions_size_) {
+    std::size_t num_dims = params_.image_dimensions.size();
+
+    // Variable-size images need only the number of channels.
+    if (num_dims != image_dimensions_size_ && !(params_.variable_size && num_dims == 1)) {
         throw std::invalid_argument{
             "The dimensions of the output image must be entered in (channels, height, width) format."};
     }
@@ -51,6 +104,64 @@ Image_reader::Image_reader(Data_reader_params params, Image_reader_params img_pa
     std::copy(params_.image_dimensions.begin(), params_.image_dimensions.end(), img_dims_.begin());
 
     error_bad_example_ = this->params().bad_example_handling == Bad_example_handling::error;
+
+    transformer_ = std::make_unique<detail::Image_transformer>(
+        params_, warn_bad_instances(), error_bad_example_);
+
+    if (params_.augmentation_seed) {
+        augmentation_seed_ = *params_.augmentation_seed;
+    }
+    else {
+        augmentation_seed_ = std::random_device{}();
+    }
+
+    if (params_.variable_size && (transformer_->needs_transform() || params_.random_resized_crop)) {
+        throw std::invalid_argument{
+            "Variable-size images can only be read as uint8 images in NHWC layout without augmentations."};
+    }
+
+    if (params_.bucketing_window > 0) {
+        const std::vector<float> &boundaries = params_.aspect_ratio_boundaries;
+        if (!std::is_sorted(boundaries.begin(), boundaries.end())) {
+            throw std::invalid_argument{
+                "The aspect ratio boundaries must be specified in ascending order."};
+        }
+
+        set_instance_bucketing(
+            [this](const Instance &instance) {
+                return get_aspect_ratio_bucket(instance);
+            },
+            params_.bucketing_window);
+    }
+
+    if (params_.opencv_num_threads) {
+        cv::setNumThreads(*params_.opencv_num_threads);
+    }
+}
+
+std::size_t Image_reader::get_aspect_ratio_bucket(const Instance &instance) const
+{
+    const std::vector<float> &boundaries = params_.aspect_ratio_boundaries;
+
+    // Images whose dimensions cannot be read from their headers are put
+    // into their own bucket.
+    std::size_t unknown_bucket = boundaries.size() + 1;
+
+    if (params_.image_frame == Image_frame::recordio &&
+        instance.bits().size() < recordio_image_header_offset_) {
+        return unknown_bucket;
+    }
+
+    std::size_t width{};
+    std::size_t height{};
+    if (!detail::read_image_size(get_image_buffer(instance), width, height) || height == 0) {
+        return unknown_bucket;
+    }
+
+    float ratio = static_cast<float>(width) / static_cast<float>(height);
+
+    return as_size(std::upper_bound(boundaries.begin(), boundaries.end(), ratio) -
+                   boundaries.begin());
 }
 
 Image_reader::~Image_reader()
@@ -58,13 +169,24 @@ Image_reader::~Image_reader()
     stop();
 }
 
+void Image_reader::reset() noexcept
+{
+    Parallel_data_reader::reset();
+
+    // Sample different augmentations in the next epoch.
+    epoch_++;
+}
+
 Intrusive_ptr<Record_reader> Image_reader::make_record_reader(const Data_store &store)
 {
     switch (params_.image_frame) {
     case Image_frame::none:
         return nullptr;
     case Image_frame::recordio:
-        return make_intrusive<detail::Recordio_record_reader>(store.open_read());
+        return make_intrusive<detail::Recordio_record_reader>(
+            store.open_read(), params().bad_example_handling, store.id());
+    case Image_frame::tar:
+        return make_intrusive<detail::Tar_record_reader>(store.open_read(), is_image_file_name);
     }
 
     throw std::invalid_argument{"The specified image frame is invalid."};
@@ -73,63 +195,143 @@ Intrusive_ptr<Record_reader> Image_reader::make_record_reader(const Data_store &
 Intrusive_ptr<const Schema> Image_reader::infer_schema(const std::optional<Instance> &)
 {
     std::vector<Attribute> attrs{};
-    // The schema follows the NHWC convention.
-    attrs.emplace_back("value",
-                       Data_type::uint8,
-                       Size_vector{params().batch_size,
-                                   params_.image_dimensions[1],
-                                   params_.image_dimensions[2],
-                                   params_.image_dimensions[0]});
+
+    if (params_.variable_size) {
+        // The size of the packed image buffer varies from batch to batch.
+        attrs.emplace_back("value", Data_type::uint8, Size_vector{0});
+        attrs.emplace_back("shape", Data_type::int64, Size_vector{params().batch_size, 3});
+
+        return make_intrusive<Schema>(std::move(attrs));
+    }
+
+    Size_vector shape{};
+    if (params_.image_layout == Image_layout::nchw) {
+        shape = {params().batch_size,
+                 params_.image_dimensions[0],
+                 params_.image_dimensions[1],
+                 params_.image_dimensions[2]};
+    }
+    else {
+        shape = {params().batch_size,
+                 params_.image_dimensions[1],
+                 params_.image_dimensions[2],
+                 params_.image_dimensions[0]};
+    }
+
+    attrs.emplace_back("value", params_.data_type, std::move(shape));
 
     return make_intrusive<Schema>(std::move(attrs));
 }
 
 Intrusive_ptr<Example> Image_reader::decode(const Instance_batch &batch) const
 {
-    // The stride of the batch dimension corresponds to the byte size
-    // of the images contained in the example.
+    if (params_.variable_size) {
+        return decode_variable_size(batch);
+    }
+
+    // The stride of the batch dimension corresponds to the number of
+    // elements in the images contained in the example.
     auto batch_stride = as_size(schema()->attributes()[0].strides()[0]);
 
     auto tensor = make_tensor(batch.size(), batch_stride);
 
-    auto bits = tensor->data().as<std::uint8_t>();
+    std::size_t element_size = detail::get_image_element_size(params_.data_type);
 
-    std::size_t num_instances_read = 0;
+    Mutable_memory_span bits{static_cast<std::byte *>(tensor->data().data()),
+                             tensor->data().size() * element_size};
 
-    for (const Instance &instance : batch.instances()) {
-        if (decode_core(bits, instance)) {
-            bits = bits.subspan(batch_stride);
+    std::size_t instance_size = batch_stride * element_size;
 
-            num_instances_read++;
-        }
-        else {
-            // If the user requested to skip the example in case of an
-            // error, shortcut the loop and return immediately.
-            if (params().bad_example_handling == Bad_example_handling::skip) {
-                return {};
+    stdx::span<const Instance> instances = batch.instances();
+
+    std::size_t num_instances = instances.size();
+
+    // Each image is decoded into its own slot in the tensor so that the
+    // images can be decoded in parallel; the slots of the bad images are
+    // compacted away afterwards.
+    std::vector<char> loaded(num_instances);
+
+    bool skip_bad_example = params().bad_example_handling == Bad_example_handling::skip ||
+                            params().bad_example_handling == Bad_example_handling::skip_warn;
+
+    std::atomic_bool skip_example{};
+
+    auto worker = [this,
+                   &batch,
+                   &bits,
+                   instance_size,
+                   &instances,
+                   &loaded,
+                   skip_bad_example,
+                   &skip_example](const tbb::blocked_range<std::size_t> &range) {
+        std::unique_ptr<Decode_scratch> scratch = acquire_scratch();
+
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            // If the example will be skipped anyways, there is no need to
+            // decode the rest of the images.
+            if (skip_example.load(std::memory_order_relaxed)) {
+                break;
             }
-            if (params().bad_example_handling == Bad_example_handling::skip_warn) {
-                logger::warn(
-                    "The example #{0:n} has been skipped as it had at least one bad instance.",
-                    batch.index());
 
-                return {};
+            // Derive the seed of the random augmentations from the
+            // position of the instance so that they do not depend on
+            // which thread decodes the image.
+            std::size_t seed = augmentation_seed_;
+            detail::hash_combine(seed, epoch_);
+            detail::hash_combine(seed, batch.index());
+            detail::hash_combine(seed, i);
+
+            Mutable_memory_span out = bits.subspan(i * instance_size, instance_size);
+
+            if (decode_core(out, instances[i], seed, *scratch)) {
+                loaded[i] = 1;
             }
-            if (params().bad_example_handling != Bad_example_handling::pad &&
-                params().bad_example_handling != Bad_example_handling::pad_warn) {
-                throw std::invalid_argument{"The specified bad example handling is invalid."};
+            else if (skip_bad_example) {
+                skip_example = true;
             }
         }
+
+        release_scratch(std::move(scratch));
+    };
+
+    tbb::blocked_range<std::size_t> range{0, num_instances, decode_grain_size(batch_stride)};
+
+    if (should_decode_parallel(num_instances, batch_stride)) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(range);
+    }
+
+    std::size_t num_instances_read = 0;
+
+    for (std::size_t i = 0; i < num_instances; i++) {
+        if (loaded[i] == 0) {
+            continue;
+        }
+
+        if (i != num_instances_read) {
+            std::memmove(bits.data() + num_instances_read * instance_size,
+                         bits.data() + i * instance_size,
+                         instance_size);
+        }
+
+        num_instances_read++;
     }
 
-    if (batch.instances().size() != num_instances_read) {
-        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
-            logger::warn("The example #{0:n} has been padded as it had {1:n} bad instance(s).",
-                         batch.index(),
-                         batch.instances().size() - num_instances_read);
+    if (num_instances_read != num_instances) {
+        if (should_skip_example(batch)) {
+            return {};
         }
+
+        // A bad image might have been partially written to its slot.
+        std::fill(bits.data() + num_instances_read * instance_size,
+                  bits.data() + num_instances * instance_size,
+                  std::byte{});
     }
 
+    warn_if_padded(batch, num_instances_read);
+
     std::vector<Intrusive_ptr<Tensor>> tensors{};
     tensors.emplace_back(std::move(tensor));
 
@@ -140,53 +342,195 @@ Intrusive_ptr<Example> Image_reader::decode(const Instance_batch &batch) const
     return example;
 }
 
+Intrusive_ptr<Example> Image_reader::decode_variable_size(const Instance_batch &batch) const
+{
+    std::vector<cv::Mat> images{};
+    images.reserve(batch.instances().size());
+
+    std::size_t num_bytes = 0;
+
+    std::unique_ptr<Decode_scratch> scratch = acquire_scratch();
+
+    for (const Instance &instance : batch.instances()) {
+        cv::Mat img{};
+
+        bool is_rgb = false;
+
+        bool loaded = load_image(instance, img, is_rgb, *scratch);
+        if (loaded && params_.to_rgb && !is_rgb && img.channels() != 1) {
+            loaded = transformer_->convert_to_rgb(img, instance);
+        }
+
+        if (loaded) {
+            num_bytes += img.total() * img.elemSize();
+
+            images.emplace_back(std::move(img));
+        }
+        else if (should_skip_example(batch)) {
+            return {};
+        }
+    }
+
+    release_scratch(std::move(scratch));
+
+    warn_if_padded(batch, images.size());
+
+    constexpr std::size_t num_shape_dims = 3;
+
+    auto value_arr = make_pooled_cpu_array(Data_type::uint8, num_bytes);
+    auto shape_arr = make_pooled_cpu_array(Data_type::int64, batch.size() * num_shape_dims);
+
+    auto bits = as_span<std::uint8_t>(*value_arr);
+
+    // The shapes of the padded instances are left zero-initialized.
+    auto shape_pos = as_span<std::int64_t>(*shape_arr).begin();
+
+    for (const cv::Mat &img : images) {
+        cv::Mat dst{img.rows, img.cols, img.type(), bits.data()};
+
+        img.copyTo(dst);
+
+        bits = bits.subspan(img.total() * img.elemSize());
+
+        *shape_pos++ = img.rows;
+        *shape_pos++ = img.cols;
+        *shape_pos++ = img.channels();
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.emplace_back(make_intrusive<Dense_tensor>(Size_vector{num_bytes}, std::move(value_arr)));
+    tensors.emplace_back(make_intrusive<Dense_tensor>(Size_vector{batch.size(), num_shape_dims},
+                                                      std::move(shape_arr)));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - images.size();
+
+    return example;
+}
+
+bool Image_reader::should_skip_example(const Instance_batch &batch) const
+{
+    // If the user requested to skip the example in case of an error,
+    // shortcut the decoding.
+    if (params().bad_example_handling == Bad_example_handling::skip) {
+        return true;
+    }
+    if (params().bad_example_handling == Bad_example_handling::skip_warn) {
+        logger::warn("The example #{0:n} has been skipped as it had at least one bad instance.",
+                     batch.index());
+
+        return true;
+    }
+    if (params().bad_example_handling != Bad_example_handling::pad &&
+        params().bad_example_handling != Bad_example_handling::pad_warn) {
+        throw std::invalid_argument{"The specified bad example handling is invalid."};
+    }
+
+    return false;
+}
+
+void Image_reader::warn_if_padded(const Instance_batch &batch, std::size_t num_instances_read) const
+{
+    if (batch.instances().size() != num_instances_read) {
+        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
+            logger::warn("The example #{0:n} has been padded as it had {1:n} bad instance(s).",
+                         batch.index(),
+                         batch.instances().size() - num_instances_read);
+        }
+    }
+}
+
 Intrusive_ptr<Dense_tensor>
 Image_reader::make_tensor(std::size_t batch_size, std::size_t batch_stride) const
 {
-    Size_vector shape{batch_size,
-                      params_.image_dimensions[1],
-                      params_.image_dimensions[2],
-                      params_.image_dimensions[0]};
+    Size_vector shape = schema()->attributes()[0].shape();
 
-    auto arr = make_cpu_array(Data_type::uint8, batch_size * batch_stride);
+    shape[0] = batch_size;
+
+    auto arr = make_pooled_cpu_array(params_.data_type, batch_size * batch_stride);
 
     return make_intrusive<Dense_tensor>(std::move(shape), std::move(arr));
 }
 
-bool Image_reader::decode_core(stdx::span<std::uint8_t> out, const Instance &instance) const
+bool Image_reader::decode_core(Mutable_memory_span out,
+                               const Instance &instance,
+                               std::size_t seed,
+                               Decode_scratch &scratch) const
+{
+    // The buffer of the scratch image gets reused if the image has the
+    // same dimensions as the previous one.
+    cv::Mat &tmp = scratch.image;
+
+    bool is_rgb = false;
+
+    if (!load_image(instance, tmp, is_rgb, scratch)) {
+        return false;
+    }
+
+    return transformer_->apply(tmp, is_rgb, out, seed, instance);
+}
+
+std::unique_ptr<Image_reader::Decode_scratch> Image_reader::acquire_scratch() const
+{
+    {
+        std::unique_lock<std::mutex> lock{scratches_mutex_};
+
+        if (!scratches_.empty()) {
+            std::unique_ptr<Decode_scratch> scratch = std::move(scratches_.back());
+
+            scratches_.pop_back();
+
+            return scratch;
+        }
+    }
+
+    return std::make_unique<Decode_scratch>();
+}
+
+void Image_reader::release_scratch(std::unique_ptr<Decode_scratch> scratch) const noexcept
+{
+    std::unique_lock<std::mutex> lock{scratches_mutex_};
+
+    try {
+        scratches_.emplace_back(std::move(scratch));
+    }
+    catch (const std::bad_alloc &) {
+    }
+}
+
+Memory_slice Image_reader::get_image_buffer(const Instance &instance) const
 {
-    Memory_slice img_buf{};
     if (params_.image_frame == Image_frame::recordio) {
         // Skip the 24-byte header defined in image_recordio.h in the
         // MXNet GitHub repository. This header contains metadata and
-        // is not relevant in our implementation.
-        img_buf = instance.bits().subslice(recordio_image_header_offset_);
-    }
-    else {
-        img_buf = instance.bits();
+        // is not relevant in our implementation. The slice still refers
+        // to the payload of the record; the image is never copied before
+        // it is decoded.
+        return instance.bits().subslice(recordio_image_header_offset_);
     }
 
-    cv::Mat mat{1,
-                static_cast<int>(img_buf.size()),
-                CV_8U,
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-                static_cast<void *>(const_cast<std::byte *>(img_buf.data()))};
+    return instance.bits();
+}
+
+bool Image_reader::load_image(const Instance &instance,
+                              cv::Mat &img,
+                              bool &is_rgb,
+                              Decode_scratch &scratch) const
+{
+    Memory_slice img_buf = get_image_buffer(instance);
 
     cv::ImreadModes mode{};
-    int type{};
 
     switch (img_dims_[0]) {
     case 1:
         mode = cv::ImreadModes::IMREAD_GRAYSCALE;
-        type = CV_8UC1;
         break;
     case 3:
         mode = cv::ImreadModes::IMREAD_COLOR;
-        type = CV_8UC3;
         break;
     case 4:
         mode = cv::ImreadModes::IMREAD_UNCHANGED;
-        type = CV_8UC4;
         break;
     default:
         throw std::invalid_argument{fmt::format(
@@ -194,45 +538,44 @@ bool Image_reader::decode_core(stdx::span<std::uint8_t> out, const Instance &ins
             img_dims_[0])};
     }
 
-    cv::Mat tmp = decode_image(mat, mode, instance);
-    if (tmp.empty()) {
-        return false;
+    // Dispatch on the magic bytes of the image to the native decoder of
+    // its format if there is one. The native decoders output the
+    // channels in the requested order.
+    bool decoded = false;
+
+    switch (detail::detect_image_format(img_buf)) {
+    case detail::Image_format::jpeg:
+        decoded = decode_jpeg(img_buf, img, scratch);
+        break;
+    case detail::Image_format::webp:
+        decoded = decode_webp(img_buf, img);
+        break;
+    default:
+        break;
     }
 
-    if (params_.resize) {
-        if (!resize(tmp, tmp, instance)) {
+    is_rgb = decoded && params_.to_rgb;
+
+    if (!decoded) {
+        cv::Mat mat{1,
+                    static_cast<int>(img_buf.size()),
+                    CV_8U,
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+                    static_cast<void *>(const_cast<std::byte *>(img_buf.data()))};
+
+        img = decode_image(mat, mode, instance);
+        if (img.empty()) {
             return false;
         }
     }
 
-    if (params_.to_rgb && tmp.channels() != 1) {
-        try {
-            cv::cvtColor(tmp, tmp, cv::COLOR_BGR2RGB);
-        }
-        catch (const cv::Exception &e) {
-            if (warn_bad_instances() || error_bad_example_) {
-                auto msg = fmt::format(
-                    "The BGR2RGB operation failed for the image #{1:n} in the data store '{0}' with the following exception: {2}",
-                    instance.data_store().id(),
-                    instance.index(),
-                    e.what());
-
-                if (warn_bad_instances()) {
-                    logger::warn(msg);
-                }
-
-                if (error_bad_example_) {
-                    throw Invalid_instance_error{msg};
-                }
-            }
-
+    if (params_.resize) {
+        if (!transformer_->resize(img, img, instance)) {
             return false;
         }
     }
 
-    cv::Mat dst{img_dims_[1], img_dims_[2], type, out.data()};
-
-    return crop(tmp, dst, instance);
+    return true;
 }
 
 cv::Mat Image_reader::decode_image(const cv::Mat &buf, int mode, const Instance &instance) const
@@ -291,104 +634,165 @@ cv::Mat Image_reader::decode_image(const cv::Mat &buf, int mode, const Instance
     return decoded_img;
 }
 
-bool Image_reader::resize(cv::Mat &src, cv::Mat &dst, const Instance &instance) const
-{
-    int new_cols{};
-    int new_rows{};
+#ifdef MLIO_BUILD_JPEG_TURBO
 
-    int resize_value = static_cast<int>(*params_.resize);
+bool Image_reader::decode_jpeg(Memory_span bits, cv::Mat &img, Decode_scratch &scratch) const
+{
+    // Four-channel images are never JPEG encoded in practice.
+    if (img_dims_[0] == 4) {
+        return false;
+    }
 
-    if (src.rows > src.cols) {
-        new_cols = resize_value * src.rows / src.cols;
-        new_rows = resize_value;
+    if (scratch.jpeg_decoder == nullptr) {
+        scratch.jpeg_decoder = std::make_unique<detail::Jpeg_decoder>();
     }
-    else {
-        new_cols = resize_value;
-        new_rows = resize_value * src.cols / src.rows;
+
+    detail::Jpeg_decoder &decoder = *scratch.jpeg_decoder;
+
+    detail::Jpeg_info info{};
+    if (!decoder.read_header(bits, info)) {
+        return false;
     }
 
-    try {
-        cv::resize(src, dst, cv::Size{new_rows, new_cols}, 0, 0);
+    // OpenCV rotates the image based on its EXIF orientation; leave such
+    // images to it.
+    if (info.orientation != 1) {
+        return false;
     }
-    catch (const cv::Exception &e) {
-        if (warn_bad_instances() || error_bad_example_) {
-            auto msg = fmt::format(
-                "The image resize operation failed for the image #{2:n} in the data store '{0}' with the following exception: {2}",
-                instance.data_store().id(),
-                instance.index(),
-                e.what());
 
-            if (warn_bad_instances()) {
-                logger::warn(msg);
-            }
+    unsigned int scale_denom = 1;
 
-            if (error_bad_example_) {
-                throw Invalid_instance_error{msg};
+    detail::Jpeg_region region{};
+
+    if (params_.resize) {
+        // Perform the inverse DCT at the smallest scale that still keeps
+        // the shorter edge at least as long as the resize value; the
+        // remaining downscale is done by Image_transformer::resize().
+        std::size_t shorter_edge = std::min(info.width, info.height);
+
+        for (unsigned int denom : {8U, 4U, 2U}) {
+            if (detail::scale_jpeg_dimension(shorter_edge, denom) >= *params_.resize) {
+                scale_denom = denom;
+                break;
             }
         }
 
-        return false;
+        region.width = detail::scale_jpeg_dimension(info.width, scale_denom);
+        region.height = detail::scale_jpeg_dimension(info.height, scale_denom);
+    }
+    else if (params_.random_resized_crop || params_.variable_size) {
+        region.width = info.width;
+        region.height = info.height;
     }
+    else {
+        auto rows = static_cast<std::size_t>(img_dims_[1]);
+        auto cols = static_cast<std::size_t>(img_dims_[2]);
 
-    return true;
+        // Let the transformer report images that are too small.
+        if (info.height < rows || info.width < cols) {
+            return false;
+        }
+
+        // Decode only the center region that the transformer would crop.
+        region.x = (info.width - cols) / 2;
+        region.y = (info.height - rows) / 2;
+        region.width = cols;
+        region.height = rows;
+    }
+
+    detail::Jpeg_color_space color_space{};
+    if (img_dims_[0] == 1) {
+        color_space = detail::Jpeg_color_space::grayscale;
+    }
+    else if (params_.to_rgb) {
+        color_space = detail::Jpeg_color_space::rgb;
+    }
+    else {
+        color_space = detail::Jpeg_color_space::bgr;
+    }
+
+    img.create(static_cast<int>(region.height),
+               static_cast<int>(region.width),
+               img_dims_[0] == 1 ? CV_8UC1 : CV_8UC3);
+
+    stdx::span<std::uint8_t> img_bits{img.data, img.total() * img.elemSize()};
+
+    if (decoder.decode(color_space, scale_denom, region, img_bits, img.step)) {
+        return true;
+    }
+
+    // Fall back to OpenCV, which reports the error.
+    img.release();
+
+    return false;
 }
 
-bool Image_reader::crop(cv::Mat &src, cv::Mat &dst, const Instance &instance) const
+#else
+
+bool Image_reader::decode_jpeg(Memory_span, cv::Mat &, Decode_scratch &) const
 {
-    if (src.rows < img_dims_[1] || src.cols < img_dims_[2]) {
-        if (warn_bad_instances() || error_bad_example_) {
-            auto msg = fmt::format(
-                "The input image dimensions (rows: {2:n}, cols: {3:n}) are smaller than the output image dimensions (rows: {4:n}, cols: {5:n}) for the image #{1:n} in the data store '{0}'.",
-                instance.data_store().id(),
-                instance.index(),
-                src.rows,
-                src.cols,
-                img_dims_[1],
-                img_dims_[2]);
+    return false;
+}
 
-            if (warn_bad_instances()) {
-                logger::warn(msg);
-            }
+#endif
 
-            if (error_bad_example_) {
-                throw std::invalid_argument{msg};
-            }
-        }
+#ifdef MLIO_BUILD_WEBP
+
+bool Image_reader::decode_webp(Memory_span bits, cv::Mat &img) const
+{
+    // OpenCV decodes grayscale images as BGR and converts them; leave
+    // such images to it.
+    if (img_dims_[0] == 1) {
+        return false;
+    }
 
+    detail::Webp_info info{};
+    if (!detail::read_webp_header(bits, info) || info.is_animated) {
         return false;
     }
 
-    // Crop from the center.
-    int y = (src.rows - img_dims_[1]) / 2;
-    int x = (src.cols - img_dims_[2]) / 2;
+    bool has_alpha = img_dims_[0] == 4;
 
-    try {
-        cv::Rect roi{x, y, img_dims_[2], img_dims_[1]};
-        src(roi).copyTo(dst);
+    // Let decode_image() report the missing alpha channel.
+    if (has_alpha && !info.has_alpha) {
+        return false;
     }
-    catch (const cv::Exception &e) {
-        if (warn_bad_instances() || error_bad_example_) {
-            auto msg = fmt::format(
-                "The image crop operation failed for the image #{1:n} in the data store '{0}' with the following exception: {2}",
-                instance.data_store().id(),
-                instance.index(),
-                e.what());
 
-            if (warn_bad_instances()) {
-                logger::warn(msg);
-            }
+    detail::Webp_color_space color_space{};
+    if (has_alpha) {
+        color_space = params_.to_rgb ? detail::Webp_color_space::rgba
+                                     : detail::Webp_color_space::bgra;
+    }
+    else {
+        color_space = params_.to_rgb ? detail::Webp_color_space::rgb
+                                     : detail::Webp_color_space::bgr;
+    }
 
-            if (error_bad_example_) {
-                throw Invalid_instance_error{msg};
-            }
-        }
+    img.create(static_cast<int>(info.height),
+               static_cast<int>(info.width),
+               has_alpha ? CV_8UC4 : CV_8UC3);
 
-        return false;
+    stdx::span<std::uint8_t> img_bits{img.data, img.total() * img.elemSize()};
+
+    if (detail::decode_webp(bits, color_space, img_bits, img.step)) {
+        return true;
     }
 
-    return true;
+    // Fall back to OpenCV, which reports the error.
+    img.release();
+
+    return false;
 }
 
+#else
+
+bool Image_reader::decode_webp(Memory_span, cv::Mat &) const
+{
+    return false;
+}
+
+#endif
+
 }  // namespace abi_v1
 }  // namespace mlio
 
@@ -405,6 +809,13 @@ class Mat {};
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace detail {
+
+class Image_transformer {};
+
+}  // namespace detail
+
+struct Image_reader::Decode_scratch {};
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-noreturn"
@@ -418,6 +829,9 @@ Image_reader::Image_reader(Data_reader_params params, Image_reader_params)
 
 Image_reader::~Image_reader() = default;
 
+void Image_reader::reset() noexcept
+{}
+
 Intrusive_ptr<Record_reader> Image_reader::make_record_reader(const Data_store &)
 {
     return nullptr;
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/image_size.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::array<std::uint8_t, 8> png_signature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+inline std::size_t read_uint16_be(const std::byte *pos) noexcept
+{
+    return (std::to_integer<std::size_t>(pos[0]) << 8) | std::to_integer<std::size_t>(pos[1]);
+}
+
+inline std::size_t read_uint32_be(const std::byte *pos) noexcept
+{
+    return (read_uint16_be(pos) << 16) | read_uint16_be(pos + 2);
+}
+
+bool read_png_size(Memory_span bits, std::size_t &width, std::size_t &height) noexcept
+{
+    // The signature is followed by the IHDR chunk which starts with the
+    // width and the height of the image.
+    constexpr std::size_t ihdr_type_offset = 12;
+    constexpr std::size_t ihdr_data_offset = 16;
+
+    if (bits.size() < ihdr_data_offset + 8) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < png_signature.size(); i++) {
+        if (std::to_integer<std::uint8_t>(bits[i]) != png_signature[i]) {
+            return false;
+        }
+    }
+
+    const std::byte *type = bits.data() + ihdr_type_offset;
+    if (type[0] != std::byte{'I'} || type[1] != std::byte{'H'} || type[2] != std::byte{'D'} ||
+        type[3] != std::byte{'R'}) {
+        return false;
+    }
+
+    width = read_uint32_be(bits.data() + ihdr_data_offset);
+    height = read_uint32_be(bits.data() + ihdr_data_offset + 4);
+
+    return true;
+}
+
+inline bool is_jpeg_sof_marker(std::uint8_t marker) noexcept
+{
+    // DHT, JPG, and DAC share the range of the SOF markers.
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+           marker != 0xCC;
+}
+
+bool read_jpeg_size(Memory_span bits, std::size_t &width, std::size_t &height) noexcept
+{
+    if (bits.size() < 2 || bits[0] != std::byte{0xFF} || bits[1] != std::byte{0xD8}) {
+        return false;
+    }
+
+    std::size_t pos = 2;
+
+    while (pos < bits.size()) {
+        if (bits[pos] != std::byte{0xFF}) {
+            return false;
+        }
+
+        // Skip the fill bytes.
+        while (pos < bits.size() && bits[pos] == std::byte{0xFF}) {
+            pos++;
+        }
+
+        if (pos == bits.size()) {
+            return false;
+        }
+
+        auto marker = std::to_integer<std::uint8_t>(bits[pos++]);
+
+        // TEM and RSTn have no payload.
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            continue;
+        }
+
+        // Reaching EOI or SOS means that there is no frame header.
+        if (marker == 0xD9 || marker == 0xDA) {
+            return false;
+        }
+
+        if (bits.size() - pos < 2) {
+            return false;
+        }
+
+        std::size_t segment_size = read_uint16_be(bits.data() + pos);
+        if (segment_size < 2 || segment_size > bits.size() - pos) {
+            return false;
+        }
+
+        if (is_jpeg_sof_marker(marker)) {
+            // The segment size is followed by the sample precision, the
+            // number of lines, and the number of samples per line.
+            if (segment_size < 7) {
+                return false;
+            }
+
+            height = read_uint16_be(bits.data() + pos + 3);
+            width = read_uint16_be(bits.data() + pos + 5);
+
+            return true;
+        }
+
+        pos += segment_size;
+    }
+
+    return false;
+}
+
+}  // namespace
+
+Image_format detect_image_format(Memory_span bits) noexcept
+{
+    auto starts_with = [bits](std::size_t offset, std::string_view magic) {
+        if (bits.size() < offset + magic.size()) {
+            return false;
+        }
+        return std::memcmp(bits.data() + offset, magic.data(), magic.size()) == 0;
+    };
+
+    if (starts_with(0, "\xFF\xD8\xFF")) {
+        return Image_format::jpeg;
+    }
+    if (starts_with(0, "\x89PNG\r\n\x1A\n")) {
+        return Image_format::png;
+    }
+    if (starts_with(0, "RIFF") && starts_with(8, "WEBP")) {
+        return Image_format::webp;
+    }
+    // An AVIF image is an ISO base media file whose "ftyp" box has the
+    // "avif" or "avis" major brand.
+    if (starts_with(4, "ftypavi")) {
+        return Image_format::avif;
+    }
+    if (starts_with(0, "GIF8")) {
+        return Image_format::gif;
+    }
+    if (starts_with(0, "BM")) {
+        return Image_format::bmp;
+    }
+    if (starts_with(0, std::string_view{"II*\0", 4}) ||
+        starts_with(0, std::string_view{"MM\0*", 4})) {
+        return Image_format::tiff;
+    }
+    return Image_format::unknown;
+}
+
+bool read_image_size(Memory_span bits, std::size_t &width, std::size_t &height) noexcept
+{
+    return read_jpeg_size(bits, width, height) || read_png_size(bits, width, height);
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
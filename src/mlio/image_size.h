@@ -0,0 +1,38 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+enum class Image_format { unknown, jpeg, png, webp, avif, gif, bmp, tiff };
+
+/// Detects the format of an encoded image from its magic bytes.
+Image_format detect_image_format(Memory_span bits) noexcept;
+
+/// Reads the dimensions of a JPEG or PNG image from its header without
+/// decoding it. Returns false if the image format is not recognized or
+/// if the header is malformed.
+bool read_image_size(Memory_span bits, std::size_t &width, std::size_t &height) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
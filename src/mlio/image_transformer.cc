@@ -0,0 +1,493 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/image_transformer.h"
+
+#ifdef MLIO_BUILD_IMAGE_READER
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/half.h"
+#include "mlio/logger.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+struct Pixel_transform {
+    Image_layout layout{};
+    bool flip{};
+    std::array<std::size_t, 4> channels{};
+    const std::array<float, 4> *scale{};
+    const std::array<float, 4> *bias{};
+};
+
+template<typename T>
+inline T convert_pixel(float value) noexcept
+{
+    if constexpr (std::is_same_v<T, std::uint16_t>) {
+        return detail::float_to_half(value);
+    }
+    else {
+        return static_cast<T>(value);
+    }
+}
+
+// Normalizes, flips, and transposes the specified image in a single
+// pass while converting it to the output data type. The inner loops are
+// kept trivial so that they can be vectorized by the compiler.
+template<typename T>
+void transform_image(const cv::Mat &src, const Pixel_transform &t, stdx::span<T> out)
+{
+    auto num_rows = static_cast<std::size_t>(src.rows);
+    auto num_cols = static_cast<std::size_t>(src.cols);
+    auto num_channels = static_cast<std::size_t>(src.channels());
+
+    std::ptrdiff_t first_col{};
+    std::ptrdiff_t col_step = as_ssize(num_channels);
+    if (t.flip) {
+        first_col = as_ssize((num_cols - 1) * num_channels);
+        col_step = -col_step;
+    }
+
+    T *dst = out.data();
+
+    if (t.layout == Image_layout::nchw) {
+        for (std::size_t c = 0; c < num_channels; c++) {
+            float scale = (*t.scale)[c];
+            float bias = (*t.bias)[c];
+
+            for (std::size_t y = 0; y < num_rows; y++) {
+                const std::uint8_t *pixel =
+                    src.ptr<std::uint8_t>(static_cast<int>(y)) + first_col + t.channels[c];
+
+                for (std::size_t x = 0; x < num_cols; x++, pixel += col_step) {
+                    *dst++ = convert_pixel<T>(static_cast<float>(*pixel) * scale + bias);
+                }
+            }
+        }
+    }
+    else {
+        for (std::size_t y = 0; y < num_rows; y++) {
+            const std::uint8_t *pixel = src.ptr<std::uint8_t>(static_cast<int>(y)) + first_col;
+
+            for (std::size_t x = 0; x < num_cols; x++, pixel += col_step) {
+                for (std::size_t c = 0; c < num_channels; c++) {
+                    *dst++ = convert_pixel<T>(static_cast<float>(pixel[t.channels[c]]) *
+                                                  (*t.scale)[c] +
+                                              (*t.bias)[c]);
+                }
+            }
+        }
+    }
+}
+
+// Samples the area of a random resized crop as described in "Going
+// Deeper with Convolutions" (Szegedy et al.).
+cv::Rect sample_random_crop(int rows, int cols, const Image_reader_params &prm, std::mt19937_64 &engine)
+{
+    constexpr int max_num_attempts = 10;
+
+    double area = static_cast<double>(rows) * static_cast<double>(cols);
+
+    std::uniform_real_distribution<double> scale_dist{prm.random_crop_scale[0],
+                                                      prm.random_crop_scale[1]};
+
+    std::uniform_real_distribution<double> log_ratio_dist{std::log(prm.random_crop_ratio[0]),
+                                                          std::log(prm.random_crop_ratio[1])};
+
+    for (int i = 0; i < max_num_attempts; i++) {
+        double target_area = area * scale_dist(engine);
+        double ratio = std::exp(log_ratio_dist(engine));
+
+        auto width = static_cast<int>(std::lround(std::sqrt(target_area * ratio)));
+        auto height = static_cast<int>(std::lround(std::sqrt(target_area / ratio)));
+
+        if (width > 0 && width <= cols && height > 0 && height <= rows) {
+            int x = std::uniform_int_distribution<int>{0, cols - width}(engine);
+            int y = std::uniform_int_distribution<int>{0, rows - height}(engine);
+
+            return cv::Rect{x, y, width, height};
+        }
+    }
+
+    // Fall back to a center crop with the closest allowed aspect ratio.
+    int width = cols;
+    int height = rows;
+
+    double ratio = static_cast<double>(cols) / static_cast<double>(rows);
+    if (ratio < prm.random_crop_ratio[0]) {
+        height = std::max(1, static_cast<int>(std::lround(cols / prm.random_crop_ratio[0])));
+    }
+    else if (ratio > prm.random_crop_ratio[1]) {
+        width = std::max(1, static_cast<int>(std::lround(rows * prm.random_crop_ratio[1])));
+    }
+
+    return cv::Rect{(cols - width) / 2, (rows - height) / 2, width, height};
+}
+
+}  // namespace
+
+std::size_t get_image_element_size(Data_type dt)
+{
+    switch (dt) {
+    case Data_type::uint8:
+        return sizeof(std::uint8_t);
+    case Data_type::float16:
+        return sizeof(std::uint16_t);
+    case Data_type::float32:
+        return sizeof(float);
+    default:
+        throw std::invalid_argument{
+            "The data type of the output images must be uint8, float16, or float32."};
+    }
+}
+
+Image_transformer::Image_transformer(const Image_reader_params &params,
+                                     bool warn_bad_instances,
+                                     bool error_bad_example)
+    : params_{params}
+    , warn_bad_instances_{warn_bad_instances}
+    , error_bad_example_{error_bad_example}
+{
+    std::copy_n(params_.image_dimensions.begin(),
+                std::min(params_.image_dimensions.size(), img_dims_.size()),
+                img_dims_.begin());
+
+    validate_params();
+
+    needs_transform_ = params_.data_type != Data_type::uint8 ||
+                       params_.image_layout != Image_layout::nhwc ||
+                       params_.random_horizontal_flip || !params_.mean.empty() ||
+                       !params_.stddev.empty();
+
+    // (x - mean) / stddev is computed as x * scale + bias.
+    for (std::size_t c = 0; c < max_num_channels_; c++) {
+        float mean = c < params_.mean.size() ? params_.mean[c] : 0.0F;
+        float stddev = c < params_.stddev.size() ? params_.stddev[c] : 1.0F;
+
+        pixel_scale_[c] = 1.0F / stddev;
+        pixel_bias_[c] = -mean / stddev;
+    }
+}
+
+bool Image_transformer::apply(cv::Mat &img,
+                              bool is_rgb,
+                              Mutable_memory_span out,
+                              std::size_t seed,
+                              const Instance &instance) const
+{
+    // If the image goes through transform(), the channels are swapped
+    // there.
+    bool swap_channels = params_.to_rgb && !is_rgb && img.channels() != 1;
+
+    if (swap_channels && !needs_transform_) {
+        swap_channels = false;
+
+        if (!convert_to_rgb(img, instance)) {
+            return false;
+        }
+    }
+
+    std::mt19937_64 engine{seed};
+
+    cv::Mat dst{};
+    if (!needs_transform_) {
+        dst = cv::Mat{img_dims_[1], img_dims_[2], CV_8UC(img_dims_[0]), out.data()};
+    }
+
+    if (params_.random_resized_crop) {
+        if (!random_resized_crop(img, dst, engine, instance)) {
+            return false;
+        }
+    }
+    else {
+        if (!crop(img, dst, instance)) {
+            return false;
+        }
+    }
+
+    if (needs_transform_) {
+        bool flip = params_.random_horizontal_flip && std::bernoulli_distribution{}(engine);
+
+        transform(dst, flip, swap_channels, out);
+    }
+
+    return true;
+}
+
+void Image_transformer::validate_params() const
+{
+    // Throws if the data type is not supported.
+    get_image_element_size(params_.data_type);
+
+    auto num_channels = params_.image_dimensions[0];
+
+    if (!params_.mean.empty() && params_.mean.size() != num_channels) {
+        throw std::invalid_argument{fmt::format(
+            "The number of mean values ({0:n}) must match the number of channels ({1:n}).",
+            params_.mean.size(),
+            num_channels)};
+    }
+
+    if (!params_.stddev.empty() && params_.stddev.size() != num_channels) {
+        throw std::invalid_argument{fmt::format(
+            "The number of standard deviation values ({0:n}) must match the number of channels ({1:n}).",
+            params_.stddev.size(),
+            num_channels)};
+    }
+
+    if (std::any_of(params_.stddev.begin(), params_.stddev.end(), [](float v) {
+            return !(v > 0.0F);
+        })) {
+        throw std::invalid_argument{"The standard deviation values must be greater than zero."};
+    }
+
+    if ((!params_.mean.empty() || !params_.stddev.empty()) &&
+        params_.data_type == Data_type::uint8) {
+        throw std::invalid_argument{
+            "The data type of the output images must be float16 or float32 when normalizing."};
+    }
+
+    const auto &scale = params_.random_crop_scale;
+    if (!(scale[0] > 0.0F && scale[0] <= scale[1] && scale[1] <= 1.0F)) {
+        throw std::invalid_argument{
+            "The bounds of the random crop scale must be in the range (0, 1] and ordered."};
+    }
+
+    const auto &ratio = params_.random_crop_ratio;
+    if (!(ratio[0] > 0.0F && ratio[0] <= ratio[1])) {
+        throw std::invalid_argument{
+            "The bounds of the random crop aspect ratio must be greater than zero and ordered."};
+    }
+}
+
+bool Image_transformer::resize(cv::Mat &src, cv::Mat &dst, const Instance &instance) const
+{
+    int new_cols{};
+    int new_rows{};
+
+    int resize_value = static_cast<int>(*params_.resize);
+
+    if (src.rows > src.cols) {
+        new_cols = resize_value * src.rows / src.cols;
+        new_rows = resize_value;
+    }
+    else {
+        new_cols = resize_value;
+        new_rows = resize_value * src.cols / src.rows;
+    }
+
+    try {
+        cv::resize(src, dst, cv::Size{new_rows, new_cols}, 0, 0);
+    }
+    catch (const cv::Exception &e) {
+        if (warn_bad_instances_ || error_bad_example_) {
+            auto msg = fmt::format(
+                "The image resize operation failed for the image #{2:n} in the data store '{0}' with the following exception: {2}",
+                instance.data_store().id(),
+                instance.index(),
+                e.what());
+
+            if (warn_bad_instances_) {
+                logger::warn(msg);
+            }
+
+            if (error_bad_example_) {
+                throw Invalid_instance_error{msg};
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool Image_transformer::convert_to_rgb(cv::Mat &img, const Instance &instance) const
+{
+    try {
+        cv::cvtColor(img, img, cv::COLOR_BGR2RGB);
+    }
+    catch (const cv::Exception &e) {
+        if (warn_bad_instances_ || error_bad_example_) {
+            auto msg = fmt::format(
+                "The BGR2RGB operation failed for the image #{1:n} in the data store '{0}' with the following exception: {2}",
+                instance.data_store().id(),
+                instance.index(),
+                e.what());
+
+            if (warn_bad_instances_) {
+                logger::warn(msg);
+            }
+
+            if (error_bad_example_) {
+                throw Invalid_instance_error{msg};
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool Image_transformer::crop(cv::Mat &src, cv::Mat &dst, const Instance &instance) const
+{
+    if (src.rows < img_dims_[1] || src.cols < img_dims_[2]) {
+        if (warn_bad_instances_ || error_bad_example_) {
+            auto msg = fmt::format(
+                "The input image dimensions (rows: {2:n}, cols: {3:n}) are smaller than the output image dimensions (rows: {4:n}, cols: {5:n}) for the image #{1:n} in the data store '{0}'.",
+                instance.data_store().id(),
+                instance.index(),
+                src.rows,
+                src.cols,
+                img_dims_[1],
+                img_dims_[2]);
+
+            if (warn_bad_instances_) {
+                logger::warn(msg);
+            }
+
+            if (error_bad_example_) {
+                throw std::invalid_argument{msg};
+            }
+        }
+
+        return false;
+    }
+
+    // Crop from the center.
+    int y = (src.rows - img_dims_[1]) / 2;
+    int x = (src.cols - img_dims_[2]) / 2;
+
+    try {
+        cv::Rect roi{x, y, img_dims_[2], img_dims_[1]};
+        if (dst.empty()) {
+            dst = src(roi);
+        }
+        else {
+            src(roi).copyTo(dst);
+        }
+    }
+    catch (const cv::Exception &e) {
+        if (warn_bad_instances_ || error_bad_example_) {
+            auto msg = fmt::format(
+                "The image crop operation failed for the image #{1:n} in the data store '{0}' with the following exception: {2}",
+                instance.data_store().id(),
+                instance.index(),
+                e.what());
+
+            if (warn_bad_instances_) {
+                logger::warn(msg);
+            }
+
+            if (error_bad_example_) {
+                throw Invalid_instance_error{msg};
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool Image_transformer::random_resized_crop(cv::Mat &src,
+                                            cv::Mat &dst,
+                                            std::mt19937_64 &engine,
+                                            const Instance &instance) const
+{
+    cv::Rect roi = sample_random_crop(src.rows, src.cols, params_, engine);
+
+    try {
+        cv::resize(src(roi), dst, cv::Size{img_dims_[2], img_dims_[1]}, 0, 0, cv::INTER_LINEAR);
+    }
+    catch (const cv::Exception &e) {
+        if (warn_bad_instances_ || error_bad_example_) {
+            auto msg = fmt::format(
+                "The random resized crop operation failed for the image #{1:n} in the data store '{0}' with the following exception: {2}",
+                instance.data_store().id(),
+                instance.index(),
+                e.what());
+
+            if (warn_bad_instances_) {
+                logger::warn(msg);
+            }
+
+            if (error_bad_example_) {
+                throw Invalid_instance_error{msg};
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+void Image_transformer::transform(const cv::Mat &src,
+                                  bool flip,
+                                  bool swap_channels,
+                                  Mutable_memory_span out) const
+{
+    Pixel_transform t{};
+    t.layout = params_.image_layout;
+    t.flip = flip;
+    t.scale = &pixel_scale_;
+    t.bias = &pixel_bias_;
+
+    for (std::size_t c = 0; c < t.channels.size(); c++) {
+        t.channels[c] = c;
+    }
+
+    // Convert from BGR(A) to RGB(A).
+    if (swap_channels) {
+        std::swap(t.channels[0], t.channels[2]);
+    }
+
+    switch (params_.data_type) {
+    case Data_type::uint8:
+        transform_image(src, t, as_span<std::uint8_t>(out));
+        break;
+    case Data_type::float16:
+        transform_image(src, t, as_span<std::uint16_t>(out));
+        break;
+    case Data_type::float32:
+        transform_image(src, t, as_span<float>(out));
+        break;
+    default:
+        throw std::invalid_argument{
+            "The data type of the output images must be uint8, float16, or float32."};
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <random>
+
+#include <opencv2/core.hpp>
+
+#include "mlio/data_type.h"
+#include "mlio/image_reader.h"
+#include "mlio/instance.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Returns the size of an element of an output image; throws if the
+// data type is not supported.
+std::size_t get_image_element_size(Data_type dt);
+
+// Crops, augments, and transforms decoded images into an output tensor
+// as specified by an Image_reader_params. Shared by the readers that
+// output images.
+class Image_transformer {
+public:
+    explicit Image_transformer(const Image_reader_params &params,
+                               bool warn_bad_instances,
+                               bool error_bad_example);
+
+    // Scales the shorter edge of the image to Image_reader_params::resize.
+    bool resize(cv::Mat &src, cv::Mat &dst, const Instance &instance) const;
+
+    bool convert_to_rgb(cv::Mat &img, const Instance &instance) const;
+
+    // Crops and augments the image, and writes it to the output buffer
+    // in the requested layout and data type. The random augmentations
+    // are derived from the seed; @p is_rgb indicates whether the image
+    // has already been decoded in RGB order. The image might be
+    // modified in place.
+    bool apply(cv::Mat &img,
+               bool is_rgb,
+               Mutable_memory_span out,
+               std::size_t seed,
+               const Instance &instance) const;
+
+    // Indicates whether the images have to go through transform()
+    // instead of being copied as is into the output buffer.
+    bool needs_transform() const noexcept
+    {
+        return needs_transform_;
+    }
+
+private:
+    void validate_params() const;
+
+    bool crop(cv::Mat &src, cv::Mat &dst, const Instance &instance) const;
+
+    bool random_resized_crop(cv::Mat &src,
+                             cv::Mat &dst,
+                             std::mt19937_64 &engine,
+                             const Instance &instance) const;
+
+    void transform(const cv::Mat &src,
+                   bool flip,
+                   bool swap_channels,
+                   Mutable_memory_span out) const;
+
+    static constexpr std::size_t max_num_channels_ = 4;
+
+    Image_reader_params params_;
+    std::array<int, 3> img_dims_{};
+    bool warn_bad_instances_;
+    bool error_bad_example_;
+    bool needs_transform_{};
+    std::array<float, max_num_channels_> pixel_scale_{};
+    std::array<float, max_num_channels_> pixel_bias_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
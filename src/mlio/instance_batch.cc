@@ -15,14 +15,105 @@
 
 #include "mlio/instance_batch.h"
 
+#include <optional>
+#include <utility>
+
+#include "mlio/memory/memory_slice.h"
+
 namespace mlio {
 inline namespace abi_v1 {
 
+Instance_batch::Instance_batch(std::size_t index,
+                               std::vector<Instance> &&instances,
+                               std::size_t size)
+    : index_{index}
+    , num_instances_{instances.size()}
+    , size_{size}
+    , lazy_{std::make_unique<Lazy_instances>()}
+{
+    if (compact(instances)) {
+        return;
+    }
+
+    lazy_->instances = std::move(instances);
+
+    std::call_once(lazy_->flag, [] {});
+}
+
+bool Instance_batch::compact(std::vector<Instance> &instances)
+{
+    entries_.reserve(instances.size());
+
+    for (const Instance &instance : instances) {
+        // An instance without bits represents a whole data store that
+        // is read on first access; we keep such batches as they are.
+        if (instance.bits_ == std::nullopt) {
+            entries_.clear();
+
+            chunks_.clear();
+            stores_.clear();
+
+            return false;
+        }
+
+        const Memory_slice &bits = *instance.bits_;
+
+        const Intrusive_ptr<Memory_block> &block = bits.block();
+
+        // The instances of a batch are usually read from one or two
+        // chunks, so comparing with the last one suffices.
+        if (chunks_.empty() || chunks_.back() != block) {
+            chunks_.emplace_back(block);
+        }
+
+        if (stores_.empty() || stores_.back() != &instance.data_store()) {
+            stores_.emplace_back(&instance.data_store());
+        }
+
+        std::size_t offset = 0;
+        if (block != nullptr) {
+            offset = static_cast<std::size_t>(bits.begin() - block->begin());
+        }
+
+        entries_.push_back(Entry{instance.index(),
+                                 offset,
+                                 bits.size(),
+                                 static_cast<std::uint32_t>(chunks_.size() - 1),
+                                 static_cast<std::uint32_t>(stores_.size() - 1)});
+    }
+
+    instances.clear();
+
+    return true;
+}
+
+const std::vector<Instance> &Instance_batch::instances() const
+{
+    std::call_once(lazy_->flag, [this] {
+        std::vector<Instance> &instances = lazy_->instances;
+
+        instances.reserve(entries_.size());
+
+        for (const Entry &entry : entries_) {
+            Memory_slice bits{};
+
+            const Intrusive_ptr<Memory_block> &chunk = chunks_[entry.chunk_idx];
+            if (chunk != nullptr) {
+                bits = Memory_slice{chunk}.subslice(entry.offset, entry.size);
+            }
+
+            instances.emplace_back(*stores_[entry.store_idx], entry.index, std::move(bits));
+        }
+    });
+
+    return lazy_->instances;
+}
+
 std::size_t Instance_batch::size_bytes() const
 {
     if (size_bytes_ == 0) {
-        for (const Instance &instance : instances_) {
-            size_bytes_ += instance.bits().size();
+        for (std::size_t i = 0; i < num_instances_; i++) {
+            size_bytes_ += bits(i).size();
         }
     }
 
@@ -15,9 +15,20 @@
 
 #include "mlio/instance_batch_reader.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "mlio/detail/thread.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/instance_readers/instance_reader.h"
@@ -27,6 +38,156 @@ namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
+std::size_t get_record_size_bucket(const Instance &instance) noexcept
+{
+    std::size_t size = instance.bits().size();
+    if (size < 16) {
+        return size;
+    }
+
+    // The index of the most significant bit followed by the next two
+    // bits of the size.
+    std::size_t msb = 0;
+    for (std::size_t s = size; s > 1; s >>= 1) {
+        msb++;
+    }
+
+    return msb * 4 + ((size >> (msb - 2)) & 3);
+}
+
+// Reads the instances of an Instance_reader on a background thread, so
+// that the batch reader can wait for them with a deadline even though
+// the underlying reader blocks until the next record arrives.
+class Instance_feed {
+    using Clock = std::chrono::steady_clock;
+
+public:
+    explicit Instance_feed(Instance_reader &reader, std::size_t capacity)
+        : reader_{&reader}, capacity_{capacity}
+    {
+        thread_ = start_thread(&Instance_feed::run, this);
+    }
+
+    Instance_feed(const Instance_feed &) = delete;
+
+    Instance_feed &operator=(const Instance_feed &) = delete;
+
+    Instance_feed(Instance_feed &&) = delete;
+
+    Instance_feed &operator=(Instance_feed &&) = delete;
+
+    // Waits for the read in flight, if any, to complete.
+    ~Instance_feed()
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            stopped_ = true;
+        }
+
+        space_condition_.notify_one();
+
+        thread_.join();
+    }
+
+    // Returns false if the deadline expires before an instance is read;
+    // otherwise @p instance is empty at the end of the dataset.
+    bool pop(std::optional<Instance> &instance, std::optional<Clock::time_point> deadline)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        auto is_ready = [this] {
+            return !instances_.empty() || end_of_data_;
+        };
+
+        if (deadline) {
+            if (!data_condition_.wait_until(lock, *deadline, is_ready)) {
+                return false;
+            }
+        }
+        else {
+            data_condition_.wait(lock, is_ready);
+        }
+
+        if (instances_.empty()) {
+            if (exception_ptr_) {
+                std::rethrow_exception(std::exchange(exception_ptr_, nullptr));
+            }
+
+            instance = std::nullopt;
+
+            return true;
+        }
+
+        instance = std::move(instances_.front());
+
+        instances_.pop_front();
+
+        lock.unlock();
+
+        space_condition_.notify_one();
+
+        return true;
+    }
+
+private:
+    void run() noexcept
+    {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+
+                space_condition_.wait(lock, [this] {
+                    return instances_.size() < capacity_ || stopped_;
+                });
+
+                if (stopped_) {
+                    return;
+                }
+            }
+
+            std::optional<Instance> instance{};
+            std::exception_ptr exception_ptr{};
+            try {
+                instance = reader_->read_instance();
+            }
+            catch (...) {
+                exception_ptr = std::current_exception();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+
+                if (instance) {
+                    instances_.emplace_back(std::move(*instance));
+                }
+                else {
+                    exception_ptr_ = exception_ptr;
+
+                    end_of_data_ = true;
+                }
+            }
+
+            data_condition_.notify_one();
+
+            if (instance == std::nullopt) {
+                return;
+            }
+        }
+    }
+
+    Instance_reader *reader_;
+    std::size_t capacity_;
+    std::mutex mutex_{};
+    std::condition_variable data_condition_{};
+    std::condition_variable space_condition_{};
+    std::deque<Instance> instances_{};
+    std::exception_ptr exception_ptr_{};
+    bool end_of_data_{};
+    bool stopped_{};
+    std::thread thread_{};
+};
+
 Instance_batch_reader::Instance_batch_reader(const Data_reader_params &params,
                                              Instance_reader &reader)
     : params_{&params}, reader_{&reader}
@@ -34,27 +195,35 @@ Instance_batch_reader::Instance_batch_reader(const Data_reader_params &params,
     if (params_->batch_size == 0) {
         throw std::invalid_argument{"The batch size must be greater than zero."};
     }
+
+    if (params_->max_batch_latency.count() < 0) {
+        throw std::invalid_argument{"The maximum batch latency must not be negative."};
+    }
 }
 
+Instance_batch_reader::~Instance_batch_reader() = default;
+
 std::optional<Instance_batch> Instance_batch_reader::read_instance_batch()
 {
-    std::vector<Instance> instances{};
-    instances.reserve(params_->batch_size);
+    budget_reached_ = false;
 
-    for (std::size_t i = 0; i < params_->batch_size; i++) {
-        std::optional<Instance> instance = reader_->read_instance();
-        if (instance == std::nullopt) {
-            break;
-        }
+    timed_out_ = false;
 
-        instances.emplace_back(std::move(*instance));
+    std::vector<Instance> instances{};
+    if (get_bucket_) {
+        instances = read_bucketed_instances();
+    }
+    else {
+        instances = read_instances();
     }
 
     if (instances.empty()) {
         return {};
     }
 
-    if (instances.size() != params_->batch_size) {
+    // A batch that was closed because of the byte budget or the batch
+    // latency is not the last one.
+    if (instances.size() != params_->batch_size && !budget_reached_ && !timed_out_) {
         if (params_->last_example_handling == Last_example_handling::drop) {
             return {};
         }
@@ -85,11 +254,252 @@ std::optional<Instance_batch> Instance_batch_reader::read_instance_batch()
     return Instance_batch{batch_idx_++, std::move(instances), size};
 }
 
+std::optional<Instance>
+Instance_batch_reader::read_instance(std::optional<Clock::time_point> deadline)
+{
+    for (;;) {
+        std::optional<Instance> instance{};
+        if (params_->max_batch_latency.count() > 0) {
+            if (feed_ == nullptr) {
+                feed_ = std::make_unique<Instance_feed>(*reader_, params_->batch_size);
+            }
+
+            if (!feed_->pop(instance, deadline)) {
+                timed_out_ = true;
+
+                return {};
+            }
+        }
+        else {
+            instance = reader_->read_instance();
+        }
+
+        if (instance == std::nullopt || filter_ == nullptr || filter_(*instance)) {
+            return instance;
+        }
+
+        num_filtered_instances_++;
+    }
+}
+
+std::vector<Instance> Instance_batch_reader::read_instances()
+{
+    std::vector<Instance> instances{};
+    instances.reserve(params_->batch_size);
+
+    std::size_t num_bytes = 0;
+
+    // The latency of a batch is measured from its first instance, so
+    // that an idle stream does not produce empty batches.
+    std::optional<Clock::time_point> deadline{};
+
+    while (instances.size() < params_->batch_size) {
+        std::optional<Instance> instance = std::move(pending_instance_);
+
+        pending_instance_ = std::nullopt;
+
+        if (instance == std::nullopt) {
+            instance = read_instance(deadline);
+            if (instance == std::nullopt) {
+                break;
+            }
+        }
+
+        if (!fits(instances.size(), num_bytes, *instance)) {
+            pending_instance_ = std::move(instance);
+
+            budget_reached_ = true;
+
+            break;
+        }
+
+        num_bytes += instance->bits().size();
+
+        instances.emplace_back(std::move(*instance));
+
+        if (params_->max_batch_latency.count() > 0 && deadline == std::nullopt) {
+            deadline = Clock::now() + params_->max_batch_latency;
+        }
+    }
+
+    return instances;
+}
+
+std::vector<Instance> Instance_batch_reader::read_bucketed_instances()
+{
+    while (reader_has_instance_ && num_buffered_instances_ < lookahead_) {
+        std::optional<Instance> instance = read_instance();
+        if (instance == std::nullopt) {
+            reader_has_instance_ = false;
+
+            break;
+        }
+
+        Bucket &bucket = buckets_[get_bucket_(*instance)];
+
+        std::size_t size = instance->bits().size();
+
+        // If the instance does not fit into the byte budget, the bucket
+        // is returned and the instance starts it over.
+        if (!fits(bucket.instances.size(), bucket.num_bytes, *instance)) {
+            std::vector<Instance> instances = std::move(bucket.instances);
+
+            bucket.instances.clear();
+            bucket.instances.emplace_back(std::move(*instance));
+
+            bucket.num_bytes = size;
+
+            num_buffered_instances_ -= instances.size() - 1;
+
+            budget_reached_ = true;
+
+            return instances;
+        }
+
+        bucket.instances.emplace_back(std::move(*instance));
+
+        bucket.num_bytes += size;
+
+        num_buffered_instances_++;
+
+        if (bucket.instances.size() == params_->batch_size) {
+            std::vector<Instance> instances = std::move(bucket.instances);
+
+            bucket.instances.clear();
+
+            bucket.num_bytes = 0;
+
+            num_buffered_instances_ -= instances.size();
+
+            return instances;
+        }
+    }
+
+    // Either the lookahead buffer is full or we reached the end of the
+    // dataset without filling up any bucket.
+    return take_from_buckets();
+}
+
+std::vector<Instance> Instance_batch_reader::take_from_buckets()
+{
+    auto largest = std::max_element(buckets_.begin(), buckets_.end(), [](auto &a, auto &b) {
+        return a.second.instances.size() < b.second.instances.size();
+    });
+
+    if (largest == buckets_.end() || largest->second.instances.empty()) {
+        return {};
+    }
+
+    std::vector<Instance> instances = std::move(largest->second.instances);
+
+    std::size_t num_bytes = largest->second.num_bytes;
+
+    largest->second.instances.clear();
+
+    largest->second.num_bytes = 0;
+
+    // Top up the batch starting with the closest buckets.
+    auto lower = std::make_reverse_iterator(largest);
+    auto upper = std::next(largest);
+
+    while (instances.size() < params_->batch_size && !budget_reached_) {
+        bool has_lower = lower != buckets_.rend();
+        bool has_upper = upper != buckets_.end();
+        if (!has_lower && !has_upper) {
+            break;
+        }
+
+        Bucket *bucket{};
+        if (has_lower &&
+            (!has_upper || largest->first - lower->first <= upper->first - largest->first)) {
+            bucket = &(lower++)->second;
+        }
+        else {
+            bucket = &(upper++)->second;
+        }
+
+        while (!bucket->instances.empty() && instances.size() < params_->batch_size) {
+            Instance &instance = bucket->instances.back();
+
+            if (!fits(instances.size(), num_bytes, instance)) {
+                budget_reached_ = true;
+
+                break;
+            }
+
+            std::size_t size = instance.bits().size();
+
+            num_bytes += size;
+
+            bucket->num_bytes -= size;
+
+            instances.emplace_back(std::move(instance));
+
+            bucket->instances.pop_back();
+        }
+    }
+
+    num_buffered_instances_ -= instances.size();
+
+    return instances;
+}
+
+bool Instance_batch_reader::fits(std::size_t num_instances,
+                                 std::size_t num_bytes,
+                                 const Instance &instance) const noexcept
+{
+    if (num_instances == 0) {
+        return true;
+    }
+
+    if (num_instances >= params_->batch_size) {
+        return false;
+    }
+
+    std::size_t budget = params_->max_batch_bytes;
+
+    return budget == 0 || num_bytes + instance.bits().size() <= budget;
+}
+
 void Instance_batch_reader::reset() noexcept
 {
+    // The feed must not read while the underlying reader is reset.
+    feed_ = nullptr;
+
     reader_->reset();
 
     batch_idx_ = 0;
+
+    pending_instance_ = std::nullopt;
+
+    budget_reached_ = false;
+
+    timed_out_ = false;
+
+    buckets_.clear();
+
+    num_buffered_instances_ = 0;
+
+    reader_has_instance_ = true;
+
+    num_filtered_instances_ = 0;
+}
+
+void Instance_batch_reader::set_bucketing(Bucket_fn get_bucket, std::size_t lookahead)
+{
+    if (params_->max_batch_latency.count() > 0) {
+        throw std::invalid_argument{
+            "The instances cannot be bucketed if a maximum batch latency is specified."};
+    }
+
+    if (lookahead < params_->batch_size) {
+        throw std::invalid_argument{
+            "The bucketing lookahead must be greater than or equal to the batch size."};
+    }
+
+    get_bucket_ = std::move(get_bucket);
+
+    lookahead_ = lookahead;
 }
 
 }  // namespace detail
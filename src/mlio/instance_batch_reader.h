@@ -15,28 +15,132 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "mlio/data_reader.h"
 #include "mlio/fwd.h"
+#include "mlio/instance.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
+using Bucket_fn = std::function<std::size_t(const Instance &)>;
+
+using Filter_fn = std::function<bool(const Instance &)>;
+
+// Maps the record size of an instance to a bucket; sizes that differ by
+// less than a quarter of an octave fall into the same bucket.
+std::size_t get_record_size_bucket(const Instance &instance) noexcept;
+
+class Instance_feed;
+
 class Instance_batch_reader {
 public:
     explicit Instance_batch_reader(const Data_reader_params &params, Instance_reader &reader);
 
+    Instance_batch_reader(const Instance_batch_reader &) = delete;
+
+    Instance_batch_reader &operator=(const Instance_batch_reader &) = delete;
+
+    Instance_batch_reader(Instance_batch_reader &&) = delete;
+
+    Instance_batch_reader &operator=(Instance_batch_reader &&) = delete;
+
+    ~Instance_batch_reader();
+
     std::optional<Instance_batch> read_instance_batch();
 
     void reset() noexcept;
 
+    // Groups the instances that fall into the same bucket into the same
+    // batch. At most @p lookahead instances are buffered while waiting
+    // for a bucket to fill up; once the buffer is full, the largest
+    // bucket is topped up with instances from its neighbouring buckets.
+    void set_bucketing(Bucket_fn get_bucket, std::size_t lookahead);
+
+    bool has_bucketing() const noexcept
+    {
+        return get_bucket_ != nullptr;
+    }
+
+    // Drops the instances for which @p filter returns false before they
+    // are batched.
+    void set_filter(Filter_fn filter) noexcept
+    {
+        filter_ = std::move(filter);
+    }
+
+    bool has_filter() const noexcept
+    {
+        return filter_ != nullptr;
+    }
+
+    // Returns the number of instances dropped by the filter since the
+    // last call.
+    std::size_t take_num_filtered_instances() noexcept
+    {
+        return std::exchange(num_filtered_instances_, 0);
+    }
+
+    // Returns a boolean value indicating whether an instance has been
+    // read from the underlying reader, but has not been batched yet.
+    // With a batch latency the underlying reader runs ahead on its own
+    // thread, so this is always the case.
+    bool has_pending_instance() const noexcept
+    {
+        return pending_instance_ != std::nullopt || feed_ != nullptr;
+    }
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // Returns the next instance that passes the filter, or an empty
+    // optional at the end of the dataset or once the deadline expires.
+    std::optional<Instance> read_instance(std::optional<Clock::time_point> deadline = {});
+
+    std::vector<Instance> read_instances();
+
+    std::vector<Instance> read_bucketed_instances();
+
+    std::vector<Instance> take_from_buckets();
+
+    // Returns a boolean value indicating whether the instance can be
+    // added to a batch of the specified number of instances and bytes.
+    bool fits(std::size_t num_instances, std::size_t num_bytes, const Instance &instance)
+        const noexcept;
+
+    struct Bucket {
+        std::vector<Instance> instances{};
+        std::size_t num_bytes{};
+    };
+
     const Data_reader_params *params_;
     Instance_reader *reader_;
     std::size_t batch_idx_{};
+    // The instance that did not fit into the byte budget of the last
+    // batch.
+    std::optional<Instance> pending_instance_{};
+    // Set if the last batch was closed because of the byte budget.
+    bool budget_reached_{};
+    // Set if the last batch was closed because of the batch latency.
+    bool timed_out_{};
+    // Reads the instances ahead if a batch latency is specified.
+    std::unique_ptr<Instance_feed> feed_{};
+    Bucket_fn get_bucket_{};
+    std::size_t lookahead_{};
+    std::map<std::size_t, Bucket> buckets_{};
+    std::size_t num_buffered_instances_{};
+    bool reader_has_instance_ = true;
+    Filter_fn filter_{};
+    std::size_t num_filtered_instances_{};
 };
 
 }  // namespace detail
@@ -15,7 +15,10 @@
 
 #include "mlio/instance_readers/core_instance_reader.h"
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
+#include <functional>
 #include <system_error>
 #include <utility>
 
@@ -23,6 +26,7 @@
 
 #include "mlio/data_reader.h"
 #include "mlio/data_reader_error.h"
+#include "mlio/detail/thread.h"
 #include "mlio/instance.h"
 #include "mlio/memory/memory_allocator.h"
 #include "mlio/memory/memory_block.h"
@@ -30,17 +34,119 @@
 #include "mlio/not_supported_error.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/record_readers/record_error.h"
+#include "mlio/record_readers/stream_record_reader.h"
 #include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
 Core_instance_reader::Core_instance_reader(const Data_reader_params &params,
-                                           Record_reader_factory &&factory)
-    : params_{&params}, record_reader_factory_{std::move(factory)}
+                                           Record_reader_factory &&factory,
+                                           Store_metrics *metrics)
+    : Core_instance_reader{params,
+                           params.dataset,
+                           std::move(factory),
+                           metrics,
+                           params.shuffle_instances &&
+                               (params.shuffle_data_stores || params.shuffle_block_size > 0)}
+{}
+
+Core_instance_reader::Core_instance_reader(const Data_reader_params &params,
+                                           stdx::span<const Intrusive_ptr<Data_store>> stores,
+                                           Record_reader_factory &&factory,
+                                           Store_metrics *metrics)
+    : Core_instance_reader{params, stores, std::move(factory), metrics, false}
+{}
+
+Core_instance_reader::Core_instance_reader(const Data_reader_params &params,
+                                           stdx::span<const Intrusive_ptr<Data_store>> stores,
+                                           Record_reader_factory &&factory,
+                                           Store_metrics *metrics,
+                                           bool should_shuffle_plan)
+    : params_{&params}
+    , stores_{stores}
+    , first_store_idx_{as_size(stores.data() - params.dataset.data())}
+    , should_shuffle_plan_{should_shuffle_plan}
+    , record_reader_factory_{std::move(factory)}
+    , metrics_{metrics}
+{
+    if (params_->num_shards > 1 &&
+        params_->sharding_strategy == Sharding_strategy::byte_range) {
+        shard_index_ = params_->shard_index;
+        num_shards_ = params_->num_shards;
+    }
+
+    init_plan();
+}
+
+Core_instance_reader::~Core_instance_reader()
 {
-    store_iter_ = params_->dataset.begin();
+    clear_prefetched_stores();
+}
+
+void Core_instance_reader::init_plan()
+{
+    for (std::size_t store_idx = 0; store_idx < stores_.size(); store_idx++) {
+        if (stores_[store_idx]->num_instances_hint()) {
+            has_instance_counts_ = true;
+        }
+
+        // The number of blocks each shard reads from the data store.
+        std::size_t num_blocks = 1;
+
+        if (should_shuffle_plan_ && params_->shuffle_block_size > 0) {
+            std::optional<std::size_t> size = stores_[store_idx]->size_hint();
+            if (size) {
+                std::size_t block_size = params_->shuffle_block_size * std::max(num_shards_, std::size_t{1});
+
+                num_blocks = std::max((*size + block_size - 1) / block_size, std::size_t{1});
+            }
+        }
+
+        if (num_shards_ == 0) {
+            for (std::size_t i = 0; i < num_blocks; i++) {
+                plan_.push_back(Store_piece{store_idx, i, num_blocks});
+            }
+        }
+        else {
+            for (std::size_t i = 0; i < num_blocks; i++) {
+                std::size_t index = shard_index_ * num_blocks + i;
+
+                plan_.push_back(Store_piece{store_idx, index, num_shards_ * num_blocks});
+            }
+        }
+    }
+
+    is_unsplittable_.resize(stores_.size());
+    is_whole_read_.resize(stores_.size());
+
+    if (should_shuffle_plan_) {
+        if (params_->shuffle_seed) {
+            seed_ = *params_->shuffle_seed;
+        }
+        else {
+            seed_ = std::random_device{}();
+        }
+
+        mt_.seed(seed_);
+
+        shuffle_plan();
+    }
+
+    plan_iter_ = plan_.begin();
+}
+
+void Core_instance_reader::shuffle_plan()
+{
+    // Bring the plan back to its initial order so that the same seed
+    // always produces the same permutation.
+    std::sort(plan_.begin(), plan_.end(), [](const Store_piece &a, const Store_piece &b) {
+        return a.store_idx < b.store_idx || (a.store_idx == b.store_idx && a.index < b.index);
+    });
+
+    std::shuffle(plan_.begin(), plan_.end(), mt_);
 }
 
 std::optional<Instance> Core_instance_reader::read_instance_core()
@@ -67,6 +173,115 @@ std::optional<Instance> Core_instance_reader::read_instance_core()
     return Instance{*store_, instance_idx_++, std::move(*payload)};
 }
 
+std::size_t Core_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    std::size_t num_instances_skipped = 0;
+
+    try {
+        while (num_instances_skipped < num_instances) {
+            // Once the current data store is exhausted, skip the next ones
+            // as a whole if we know their number of instances.
+            if (has_instance_counts_ &&
+                (record_reader_ == nullptr || record_reader_->peek_record() == std::nullopt)) {
+                num_instances_skipped += skip_data_stores(num_instances - num_instances_skipped);
+                if (num_instances_skipped == num_instances) {
+                    break;
+                }
+            }
+
+            if (!skip_record_payload()) {
+                // Same as in read_instance_core(); the data store itself
+                // is an instance, but we never have to read it.
+                if (store_ == nullptr) {
+                    break;
+                }
+            }
+
+            num_instances_skipped++;
+        }
+    }
+    catch (const std::exception &) {
+        handle_errors();
+    }
+
+    return num_instances_skipped;
+}
+
+std::optional<std::vector<std::size_t>> Core_instance_reader::position_core() const
+{
+    // A data store that cannot be split is read as a whole in the
+    // first piece that gets to it; a seek would lose track of it.
+    if (std::find(is_unsplittable_.begin(), is_unsplittable_.end(), true) !=
+        is_unsplittable_.end()) {
+        return {};
+    }
+
+    auto plan_pos = as_size(plan_iter_ - plan_.begin());
+
+    // Between two data stores the position is the next piece in the
+    // plan; otherwise it is the position in the current piece whose
+    // record reader has already been created.
+    if (record_reader_ == nullptr) {
+        return std::vector<std::size_t>{plan_pos};
+    }
+
+    auto *reader = dynamic_cast<const Stream_record_reader *>(record_reader_.get());
+    if (reader == nullptr) {
+        return {};
+    }
+
+    std::optional<std::size_t> offset = reader->position();
+    if (offset == std::nullopt) {
+        return {};
+    }
+
+    return std::vector<std::size_t>{plan_pos, *offset, instance_idx_, record_idx_};
+}
+
+bool Core_instance_reader::seek_core(const std::vector<std::size_t> &position)
+{
+    if (position.empty() || position[0] > plan_.size()) {
+        return false;
+    }
+
+    if (position.size() == 1) {
+        plan_iter_ = plan_.begin() + as_ssize(position[0]);
+
+        return true;
+    }
+
+    if (position.size() != 4 || position[0] == 0) {
+        return false;
+    }
+
+    plan_iter_ = plan_.begin() + as_ssize(position[0] - 1);
+
+    try {
+        if (!init_next_record_reader()) {
+            return false;
+        }
+    }
+    catch (const std::exception &) {
+        handle_errors();
+    }
+
+    // The piece must have been opened as is; see position_core().
+    if (as_size(plan_iter_ - plan_.begin()) != position[0]) {
+        return false;
+    }
+
+    auto *reader = dynamic_cast<Stream_record_reader *>(record_reader_.get());
+    if (reader == nullptr || !reader->seek(position[1])) {
+        return false;
+    }
+
+    instance_idx_ = position[2];
+
+    record_idx_ = position[3];
+
+    return true;
+}
+
 void Core_instance_reader::handle_errors()
 {
     try {
@@ -122,7 +337,9 @@ std::optional<Memory_slice> Core_instance_reader::read_record_payload()
 std::optional<Memory_slice>
 Core_instance_reader::read_split_record_payload(std::optional<Record> record)
 {
-    std::vector<Record> records{};
+    // The pieces are slices of the chunks of the record reader, so the
+    // merged payload below is the only copy made of them.
+    split_records_.clear();
 
     std::size_t payload_size = 0;
 
@@ -130,7 +347,7 @@ Core_instance_reader::read_split_record_payload(std::optional<Record> record)
     if (record->kind() == Record_kind::begin) {
         payload_size += record->payload().size();
 
-        records.emplace_back(std::move(*record));
+        split_records_.emplace_back(std::move(*record));
     }
     else {
         throw_corrupt_split_record_error();
@@ -140,31 +357,68 @@ Core_instance_reader::read_split_record_payload(std::optional<Record> record)
     while ((record = read_record()) && record->kind() == Record_kind::middle) {
         payload_size += record->payload().size();
 
-        records.emplace_back(std::move(*record));
+        split_records_.emplace_back(std::move(*record));
     }
 
     // and end with an 'end' record.
     if (record && record->kind() == Record_kind::end) {
         payload_size += record->payload().size();
 
-        records.emplace_back(std::move(*record));
+        split_records_.emplace_back(std::move(*record));
     }
     else {
         throw_corrupt_split_record_error();
     }
 
     // Once we have collected all records we merge their payloads in a
-    // single buffer.
+    // single buffer. If the default memory allocator is a slab
+    // allocator, the buffer is recycled once the instance is decoded.
     auto payload = memory_allocator().allocate(payload_size);
 
     auto pos = payload->begin();
-    for (const Record &r : records) {
+    for (const Record &r : split_records_) {
         pos = std::copy(r.payload().begin(), r.payload().end(), pos);
     }
 
+    // Release the chunks, but keep the capacity for the next instance.
+    split_records_.clear();
+
     return std::move(payload);
 }
 
+bool Core_instance_reader::skip_record_payload()
+{
+    if (has_corrupt_split_record_) {
+        throw_corrupt_split_record_error();
+    }
+
+    std::optional<Record> record = read_record();
+    if (record == std::nullopt) {
+        return false;
+    }
+
+    instance_idx_++;
+
+    if (record->kind() == Record_kind::complete) {
+        return true;
+    }
+
+    // Unlike read_split_record_payload() we only validate the sequence
+    // of records without merging their payloads.
+    if (record->kind() != Record_kind::begin) {
+        throw_corrupt_split_record_error();
+    }
+
+    while ((record = read_record()) && record->kind() == Record_kind::middle) {
+    }
+
+    if (record == std::nullopt || record->kind() != Record_kind::end) {
+        throw_corrupt_split_record_error();
+    }
+
+    return true;
+}
+
 void Core_instance_reader::throw_corrupt_split_record_error()
 {
     has_corrupt_split_record_ = true;
@@ -182,7 +436,7 @@ std::optional<Record> Core_instance_reader::read_record()
 
     std::optional<Record> record{};
 
-    while ((record = record_reader_->read_record()) == std::nullopt) {
+    while ((record = read_timed_record()) == std::nullopt) {
         if (!init_next_record_reader()) {
             return {};
         }
@@ -193,50 +447,273 @@ std::optional<Record> Core_instance_reader::read_record()
     return record;
 }
 
+std::optional<Record> Core_instance_reader::read_timed_record()
+{
+    if (metrics_ == nullptr) {
+        return record_reader_->read_record();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::optional<Record> record = record_reader_->read_record();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    read_counters_.read_ns += as_size(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+    if (record) {
+        read_counters_.num_records++;
+        read_counters_.num_record_bytes += record->payload().size();
+
+        // Flush periodically so that the statistics of a large data
+        // store are kept up to date.
+        if (read_counters_.num_records % 1024 == 0) {
+            flush_read_counters();
+        }
+    }
+
+    return record;
+}
+
+void Core_instance_reader::flush_read_counters() noexcept
+{
+    if (metrics_ == nullptr || store_ == nullptr || read_counters_.read_ns == 0) {
+        return;
+    }
+
+    try {
+        metrics_->add_reads(*store_, read_counters_);
+    }
+    catch (...) {
+        // The statistics are best-effort; an error, e.g. raised by the
+        // slow store handler, must not fail the reader.
+    }
+
+    read_counters_ = {};
+}
+
 bool Core_instance_reader::init_next_record_reader()
 {
+    flush_read_counters();
+
     instance_idx_ = 0;
 
     record_idx_ = 0;
 
-    if (store_iter_ == params_->dataset.end()) {
-        store_ = nullptr;
+    while (true) {
+        if (plan_iter_ == plan_.end()) {
+            store_ = nullptr;
 
-        record_reader_ = nullptr;
+            record_reader_ = nullptr;
 
-        return false;
+            return false;
+        }
+
+        const Store_piece &piece = *plan_iter_;
+
+        // We already know that the data store cannot be split; skip its
+        // pieces without opening it if it has been or should not be
+        // read.
+        if (is_unsplittable_[piece.store_idx]) {
+            std::size_t store_idx = first_store_idx_ + piece.store_idx;
+
+            bool is_owned = num_shards_ == 0 || store_idx % num_shards_ == shard_index_;
+            if (is_whole_read_[piece.store_idx] || !is_owned) {
+                ++plan_iter_;
+
+                continue;
+            }
+        }
+
+        store_ = stores_[piece.store_idx].get();
+
+        try {
+            record_reader_ = make_record_reader(piece);
+        }
+        catch (const std::system_error &e) {
+            if (e.code() == std::errc::no_such_file_or_directory) {
+                throw Data_reader_error{
+                    fmt::format("The data store '{0}' does not exist.", store_->id())};
+            }
+
+            if (e.code() == std::errc::permission_denied) {
+                throw Data_reader_error{fmt::format(
+                    "The permission to read the data store '{0}' is denied.", store_->id())};
+            }
+
+            throw;
+        }
+
+        // Move to the next piece only after we get the record reader;
+        // otherwise we might break the class invariant if the factory
+        // throws an exception.
+        ++plan_iter_;
+
+        if (select_piece(piece)) {
+            break;
+        }
     }
 
-    store_ = store_iter_->get();
+    if (params_->num_prefetched_data_stores > 0) {
+        prefetch_next_stores();
+    }
 
-    try {
-        record_reader_ = record_reader_factory_(*store_);
+    return record_reader_ != nullptr;
+}
+
+Intrusive_ptr<Record_reader> Core_instance_reader::make_record_reader(const Store_piece &piece)
+{
+    auto plan_pos = as_size(plan_iter_ - plan_.begin());
+
+    // Discard the prefetched data stores that have been skipped.
+    while (!prefetched_stores_.empty() && prefetched_stores_.front().plan_pos < plan_pos) {
+        prefetched_stores_.front().thread.join();
+
+        prefetched_stores_.pop_front();
     }
-    catch (const std::system_error &e) {
-        if (e.code() == std::errc::no_such_file_or_directory) {
-            throw Data_reader_error{
-                fmt::format("The data store '{0}' does not exist.", store_->id())};
+
+    if (prefetched_stores_.empty() || prefetched_stores_.front().plan_pos != plan_pos) {
+        return record_reader_factory_(*stores_[piece.store_idx]);
+    }
+
+    Prefetched_store prefetched = std::move(prefetched_stores_.front());
+
+    prefetched_stores_.pop_front();
+
+    prefetched.thread.join();
+
+    // Rethrows the exception, if any, of the background thread.
+    return prefetched.record_reader.get();
+}
+
+void Core_instance_reader::prefetch_next_stores()
+{
+    auto plan_pos = as_size(plan_iter_ - plan_.begin());
+
+    if (!prefetched_stores_.empty()) {
+        plan_pos = std::max(plan_pos, prefetched_stores_.back().plan_pos + 1);
+    }
+
+    for (; plan_pos < plan_.size(); plan_pos++) {
+        if (prefetched_stores_.size() >= params_->num_prefetched_data_stores) {
+            break;
         }
 
-        if (e.code() == std::errc::permission_denied) {
-            throw Data_reader_error{fmt::format(
-                "The permission to read the data store '{0}' is denied.", store_->id())};
+        const Store_piece &piece = plan_[plan_pos];
+
+        // A piece of a split data store needs its byte range set before
+        // any record is read; see select_piece().
+        if (piece.count != 1) {
+            continue;
         }
 
-        throw;
+        Data_store *store = stores_[piece.store_idx].get();
+
+        std::packaged_task<Intrusive_ptr<Record_reader>()> task{[this, store]() {
+            Intrusive_ptr<Record_reader> reader = record_reader_factory_(*store);
+
+            // Read the first chunk of the data store.
+            reader->peek_record();
+
+            return reader;
+        }};
+
+        std::future<Intrusive_ptr<Record_reader>> future = task.get_future();
+
+        std::thread thread = start_thread(std::move(task));
+
+        prefetched_stores_.push_back(
+            Prefetched_store{plan_pos, std::move(future), std::move(thread)});
     }
+}
 
-    // Move to the next data store only after we get the record reader;
-    // otherwise we might break the class invariant if the factory
-    // throws an exception.
-    ++store_iter_;
+void Core_instance_reader::clear_prefetched_stores() noexcept
+{
+    for (Prefetched_store &prefetched : prefetched_stores_) {
+        prefetched.thread.join();
+    }
 
-    return record_reader_ != nullptr;
+    prefetched_stores_.clear();
+}
+
+std::size_t Core_instance_reader::skip_data_stores(std::size_t num_instances)
+{
+    std::size_t num_instances_skipped = 0;
+
+    for (; plan_iter_ != plan_.end(); ++plan_iter_) {
+        // Only whole data stores can be skipped by their instance counts;
+        // the pieces of a split data store have no such count.
+        if (plan_iter_->count != 1) {
+            break;
+        }
+
+        std::optional<std::size_t> n = stores_[plan_iter_->store_idx]->num_instances_hint();
+        if (n == std::nullopt || *n > num_instances - num_instances_skipped) {
+            break;
+        }
+
+        num_instances_skipped += *n;
+    }
+
+    return num_instances_skipped;
+}
+
+bool Core_instance_reader::select_piece(const Store_piece &piece)
+{
+    if (piece.count == 1) {
+        return true;
+    }
+
+    if (!is_unsplittable_[piece.store_idx]) {
+        // If possible, read only the byte range of the piece.
+        auto *reader = dynamic_cast<Stream_record_reader *>(record_reader_.get());
+        if (reader != nullptr && reader->set_shard(piece.index, piece.count)) {
+            return true;
+        }
+
+        is_unsplittable_[piece.store_idx] = true;
+    }
+
+    // Otherwise fall back to reading the whole data store once, in the
+    // shard it is assigned to.
+    std::size_t store_idx = first_store_idx_ + piece.store_idx;
+
+    if (num_shards_ > 0 && store_idx % num_shards_ != shard_index_) {
+        return false;
+    }
+
+    if (is_whole_read_[piece.store_idx]) {
+        return false;
+    }
+
+    is_whole_read_[piece.store_idx] = true;
+
+    return true;
 }
 
 void Core_instance_reader::reset_core() noexcept
 {
-    store_iter_ = params_->dataset.begin();
+    // The prefetched data stores refer to the positions of the current
+    // plan; discard them before it gets reshuffled.
+    clear_prefetched_stores();
+
+    if (should_shuffle_plan_) {
+        // Make sure that we reset the random number generator engine to
+        // its initial state if reshuffling is not requested.
+        if (!params_->reshuffle_each_epoch) {
+            mt_.seed(seed_);
+        }
+
+        shuffle_plan();
+    }
+
+    plan_iter_ = plan_.begin();
+
+    std::fill(is_whole_read_.begin(), is_whole_read_.end(), false);
+
+    // The statistics are reset along with the epoch.
+    read_counters_ = {};
 
     store_ = nullptr;
 
@@ -16,50 +16,149 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
 #include <optional>
+#include <random>
+#include <thread>
 #include <vector>
 
 #include "mlio/data_stores/data_store.h"
+#include "mlio/detail/store_metrics.h"
 #include "mlio/fwd.h"
 #include "mlio/instance_readers/instance_reader.h"
 #include "mlio/instance_readers/instance_reader_base.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/record.h"
 #include "mlio/record_readers/record_reader.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
 class Core_instance_reader final : public Instance_reader_base {
+    // Represents the part of a data store that should be read; a data
+    // store is split into byte-range pieces for sharding and block
+    // shuffling.
+    struct Store_piece {
+        std::size_t store_idx;
+        std::size_t index;
+        std::size_t count;
+    };
+
+    // Represents a record reader that is being created on a background
+    // thread; see Data_reader_params::num_prefetched_data_stores.
+    struct Prefetched_store {
+        // The position of the piece in the plan.
+        std::size_t plan_pos;
+        std::future<Intrusive_ptr<Record_reader>> record_reader;
+        std::thread thread;
+    };
+
 public:
+    // The metrics, if not null, receive the read counters of the data
+    // stores.
+    explicit Core_instance_reader(const Data_reader_params &params,
+                                  Record_reader_factory &&factory,
+                                  Store_metrics *metrics);
+
+    // Reads only from the specified subset of the dataset.
     explicit Core_instance_reader(const Data_reader_params &params,
-                                  Record_reader_factory &&factory);
+                                  stdx::span<const Intrusive_ptr<Data_store>> stores,
+                                  Record_reader_factory &&factory,
+                                  Store_metrics *metrics);
+
+    Core_instance_reader(const Core_instance_reader &) = delete;
+
+    Core_instance_reader &operator=(const Core_instance_reader &) = delete;
+
+    Core_instance_reader(Core_instance_reader &&) = delete;
+
+    Core_instance_reader &operator=(Core_instance_reader &&) = delete;
+
+    ~Core_instance_reader() final;
 
 private:
+    explicit Core_instance_reader(const Data_reader_params &params,
+                                  stdx::span<const Intrusive_ptr<Data_store>> stores,
+                                  Record_reader_factory &&factory,
+                                  Store_metrics *metrics,
+                                  bool should_shuffle_plan);
+
     std::optional<Instance> read_instance_core() final;
 
+    std::size_t skip_instances_core(std::size_t num_instances) final;
+
+    std::optional<std::vector<std::size_t>> position_core() const final;
+
+    bool seek_core(const std::vector<std::size_t> &position) final;
+
     [[noreturn]] void handle_errors();
 
     std::optional<Memory_slice> read_record_payload();
 
     std::optional<Memory_slice> read_split_record_payload(std::optional<Record> record);
 
+    bool skip_record_payload();
+
+    // Skips, without opening them, the next data stores whose number of
+    // instances is known, up to the specified number of instances;
+    // returns the number of skipped instances.
+    std::size_t skip_data_stores(std::size_t num_instances);
+
     [[noreturn]] void throw_corrupt_split_record_error();
 
     std::optional<Record> read_record();
 
+    std::optional<Record> read_timed_record();
+
+    void flush_read_counters() noexcept;
+
     bool init_next_record_reader();
 
+    Intrusive_ptr<Record_reader> make_record_reader(const Store_piece &piece);
+
+    // Starts creating the record readers of the next data stores in the
+    // plan on background threads.
+    void prefetch_next_stores();
+
+    void clear_prefetched_stores() noexcept;
+
+    bool select_piece(const Store_piece &piece);
+
+    void init_plan();
+
+    void shuffle_plan();
+
     void reset_core() noexcept final;
 
     const Data_reader_params *params_;
+    stdx::span<const Intrusive_ptr<Data_store>> stores_;
+    std::size_t first_store_idx_;
+    std::size_t shard_index_{};
+    std::size_t num_shards_{};
+    bool should_shuffle_plan_;
     Record_reader_factory record_reader_factory_;
-    std::vector<Intrusive_ptr<Data_store>>::const_iterator store_iter_{};
+    std::vector<Store_piece> plan_{};
+    std::vector<Store_piece>::iterator plan_iter_{};
+    std::vector<bool> is_unsplittable_{};
+    std::vector<bool> is_whole_read_{};
+    bool has_instance_counts_{};
+    std::uint_fast64_t seed_{};
+    std::mt19937_64 mt_{};
     Data_store *store_{};
     Intrusive_ptr<Record_reader> record_reader_{};
     std::size_t instance_idx_{};
     std::size_t record_idx_{};
     bool has_corrupt_split_record_{};
+    // The pieces of the split record being read; kept across instances
+    // to reuse its capacity.
+    std::vector<Record> split_records_{};
+    Store_metrics *metrics_;
+    Store_metrics::Read_counters read_counters_{};
+    std::deque<Prefetched_store> prefetched_stores_{};
 };
 
 }  // namespace detail
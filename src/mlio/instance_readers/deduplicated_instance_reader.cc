@@ -0,0 +1,76 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/deduplicated_instance_reader.h"
+
+#include <functional>
+#include <string_view>
+#include <utility>
+
+#include "mlio/data_reader.h"
+#include "mlio/util/string.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Deduplicated_instance_reader::Deduplicated_instance_reader(
+    const Data_reader_params &params, std::unique_ptr<Instance_reader> &&inner)
+    : inner_{std::move(inner)}
+{
+    if (params.dedup_memory_budget > 0) {
+        filter_.emplace(params.dedup_memory_budget, params.dedup_false_positive_rate);
+    }
+}
+
+std::optional<Instance> Deduplicated_instance_reader::read_instance_core()
+{
+    std::optional<Instance> instance{};
+    while ((instance = inner_->read_instance()) != std::nullopt) {
+        if (!is_duplicate(*instance)) {
+            break;
+        }
+    }
+
+    return instance;
+}
+
+bool Deduplicated_instance_reader::is_duplicate(const Instance &instance)
+{
+    std::uint64_t hash = std::hash<std::string_view>{}(as_string_view(instance.bits()));
+
+    if (filter_) {
+        return filter_->insert(hash);
+    }
+
+    return !hashes_.insert(hash).second;
+}
+
+void Deduplicated_instance_reader::reset_core() noexcept
+{
+    inner_->reset();
+
+    // Every epoch drops the same duplicates.
+    if (filter_) {
+        filter_->clear();
+    }
+    else {
+        hashes_.clear();
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
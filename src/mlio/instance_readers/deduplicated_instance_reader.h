@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+
+#include "mlio/detail/bloom_filter.h"
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/instance_readers/instance_reader.h"
+#include "mlio/instance_readers/instance_reader_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Drops the instances whose bytes hash to the same value as those of
+// an instance read earlier in the epoch; see
+// Data_reader_params::deduplicate_instances.
+class Deduplicated_instance_reader final : public Instance_reader_base {
+public:
+    explicit Deduplicated_instance_reader(const Data_reader_params &params,
+                                          std::unique_ptr<Instance_reader> &&inner);
+
+private:
+    std::optional<Instance> read_instance_core() final;
+
+    void reset_core() noexcept final;
+
+    bool is_duplicate(const Instance &instance);
+
+    std::unique_ptr<Instance_reader> inner_;
+    // Holds the hashes if no memory budget is specified.
+    std::unordered_set<std::uint64_t> hashes_{};
+    std::optional<Bloom_filter> filter_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,603 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/indexed_instance_reader.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/detail/system_info.h"
+#include "mlio/detail/thread.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/detail/recordio_header.h"
+#include "mlio/record_readers/detail/util.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The maximum number of data stores to keep open at the same time.
+constexpr std::size_t max_num_open_streams = 64;
+
+// Reads the specified number of bytes from the current position of the
+// stream; fewer only if the end of the stream is reached.
+Memory_slice read_exactly(Input_stream &stream, std::size_t size)
+{
+    if (stream.supports_zero_copy()) {
+        return stream.read(size);
+    }
+
+    auto block = memory_allocator().allocate(size);
+
+    Mutable_memory_span remaining_bits{*block};
+    while (!remaining_bits.empty()) {
+        std::size_t num_bytes_read = stream.read(remaining_bits);
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        remaining_bits = remaining_bits.subspan(num_bytes_read);
+    }
+
+    return Memory_slice{std::move(block)}.first(size - remaining_bits.size());
+}
+
+}  // namespace
+
+Indexed_instance_reader::Indexed_instance_reader(const Data_reader_params &params)
+    : params_{&params}
+{
+    cache_.streams.resize(params_->dataset.size());
+
+    if (params_->recordio_indexes.size() != params_->dataset.size()) {
+        throw std::invalid_argument{
+            "The number of RecordIO indexes must match the number of data stores in the dataset."};
+    }
+
+    if (params_->num_shards > 1 && params_->shard_index >= params_->num_shards) {
+        throw std::invalid_argument{"The shard index must be less than the number of shards."};
+    }
+
+    if (params_->shuffle_seed != std::nullopt) {
+        seed_ = *params_->shuffle_seed;
+    }
+}
+
+Indexed_instance_reader::~Indexed_instance_reader()
+{
+    stop_fetching();
+}
+
+std::optional<Instance> Indexed_instance_reader::read_instance_core()
+{
+    ensure_order();
+
+    if (instance_idx_ == num_instances_) {
+        return {};
+    }
+
+    if (params_->indexed_read_ahead > 0) {
+        return read_fetched_instance();
+    }
+
+    auto [store_idx, record_idx] = locate_record(get_record_id(instance_idx_++));
+
+    Memory_slice payload{};
+    try {
+        payload = fetch_record(cache_, store_idx, record_idx);
+    }
+    catch (const std::exception &) {
+        handle_errors(store_idx, record_idx);
+    }
+
+    return Instance{*params_->dataset[store_idx], record_idx, std::move(payload)};
+}
+
+std::optional<Instance> Indexed_instance_reader::read_fetched_instance()
+{
+    ensure_fetching();
+
+    std::size_t idx = instance_idx_;
+
+    Memory_slice payload{};
+
+    std::exception_ptr exception_ptr{};
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        Fetch_slot &slot = fetch_slots_[idx % fetch_slots_.size()];
+
+        read_condition_.wait(lock, [&slot, idx] {
+            return slot.ready && slot.instance_idx == idx;
+        });
+
+        payload = std::move(slot.payload);
+
+        exception_ptr = std::move(slot.exception_ptr);
+
+        slot = {};
+
+        instance_idx_++;
+    }
+
+    fetch_condition_.notify_one();
+
+    auto [store_idx, record_idx] = locate_record(get_record_id(idx));
+
+    if (exception_ptr) {
+        try {
+            std::rethrow_exception(exception_ptr);
+        }
+        catch (const std::exception &) {
+            handle_errors(store_idx, record_idx);
+        }
+    }
+
+    return Instance{*params_->dataset[store_idx], record_idx, std::move(payload)};
+}
+
+std::size_t Indexed_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    ensure_order();
+
+    // Since we know the offset of every record, skipping is simply a
+    // matter of moving forward in the order.
+    std::size_t num_instances_skipped = std::min(num_instances, num_instances_ - instance_idx_);
+
+    if (fetch_threads_.empty()) {
+        instance_idx_ += num_instances_skipped;
+    }
+    else {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            instance_idx_ += num_instances_skipped;
+
+            // The records that are being fetched for the skipped
+            // positions are discarded once they arrive.
+            next_fetch_idx_ = std::max(next_fetch_idx_, instance_idx_);
+        }
+
+        fetch_condition_.notify_all();
+    }
+
+    return num_instances_skipped;
+}
+
+void Indexed_instance_reader::ensure_order()
+{
+    if (has_order_) {
+        return;
+    }
+
+    if (indexes_.empty()) {
+        load_indexes();
+    }
+
+    init_order();
+
+    has_order_ = true;
+}
+
+void Indexed_instance_reader::load_indexes()
+{
+    std::vector<std::vector<Recordio_index_entry>> indexes{};
+    indexes.reserve(params_->recordio_indexes.size());
+
+    std::vector<std::size_t> store_offsets{};
+    store_offsets.reserve(params_->recordio_indexes.size());
+
+    std::size_t num_records = 0;
+
+    for (const Intrusive_ptr<Data_store> &store : params_->recordio_indexes) {
+        store_offsets.push_back(num_records);
+
+        num_records += indexes.emplace_back(read_recordio_index(*store)).size();
+    }
+
+    indexes_ = std::move(indexes);
+
+    store_offsets_ = std::move(store_offsets);
+}
+
+void Indexed_instance_reader::init_order()
+{
+    std::size_t num_records = 0;
+    if (!indexes_.empty()) {
+        num_records = store_offsets_.back() + indexes_.back().size();
+    }
+
+    std::size_t first = std::min(params_->num_instances_to_skip, num_records);
+
+    std::size_t last = num_records;
+    if (params_->num_instances_to_read) {
+        last = std::min(last, first + *params_->num_instances_to_read);
+    }
+
+    std::size_t num_selected = last - first;
+
+    first_record_id_ = first;
+
+    if (params_->num_shards > 1) {
+        shard_index_ = params_->shard_index;
+
+        num_shards_ = params_->num_shards;
+    }
+
+    // The shard reads every n-th position of the order.
+    num_instances_ = 0;
+    if (shard_index_ < num_selected) {
+        num_instances_ = (num_selected - shard_index_ + num_shards_ - 1) / num_shards_;
+    }
+
+    if (params_->shuffle_instances) {
+        std::uint64_t key = seed_ ^ mix64(epoch_);
+
+        // If the seed is specified, we assume that all shards share it,
+        // so they can read disjoint slices of the same permutation of
+        // the dataset; this way a shard gets a different part of the
+        // dataset in every epoch. Otherwise we can only shuffle the
+        // records that are assigned to the shard.
+        is_global_permutation_ = params_->shuffle_seed != std::nullopt;
+
+        if (is_global_permutation_) {
+            permutation_ = Random_permutation{num_selected, key};
+        }
+        else {
+            permutation_ = Random_permutation{num_instances_, key};
+        }
+    }
+
+    instance_idx_ = 0;
+}
+
+std::size_t Indexed_instance_reader::get_record_id(std::size_t idx) const noexcept
+{
+    if (!params_->shuffle_instances) {
+        return first_record_id_ + shard_index_ + idx * num_shards_;
+    }
+
+    if (is_global_permutation_) {
+        return first_record_id_ + permutation_(shard_index_ + idx * num_shards_);
+    }
+
+    return first_record_id_ + shard_index_ + permutation_(idx) * num_shards_;
+}
+
+std::pair<std::size_t, std::size_t>
+Indexed_instance_reader::locate_record(std::size_t record_id) const noexcept
+{
+    auto pos = std::upper_bound(store_offsets_.begin(), store_offsets_.end(), record_id);
+
+    auto store_idx = static_cast<std::size_t>(pos - store_offsets_.begin() - 1);
+
+    return {store_idx, record_id - store_offsets_[store_idx]};
+}
+
+Memory_slice Indexed_instance_reader::fetch_record(Stream_cache &cache,
+                                                   std::size_t store_idx,
+                                                   std::size_t record_idx)
+{
+    return decode_payload(read_record(cache, store_idx, indexes_[store_idx][record_idx]));
+}
+
+Memory_slice Indexed_instance_reader::read_record(Stream_cache &cache,
+                                                  std::size_t store_idx,
+                                                  const Recordio_index_entry &entry)
+{
+    Input_stream &stream = open_stream(cache, store_idx);
+
+    // Positional reads do not move the stream, so they spare the seek
+    // system call for every record.
+    Memory_slice bits{};
+    if (stream.supports_read_at()) {
+        bits = stream.read_at(entry.offset, entry.size);
+    }
+    else {
+        stream.seek(entry.offset);
+
+        bits = read_exactly(stream, entry.size);
+    }
+
+    if (bits.size() != entry.size) {
+        throw Corrupt_record_error{"The record extends beyond the end of the data store."};
+    }
+
+    return bits;
+}
+
+Input_stream &Indexed_instance_reader::open_stream(Stream_cache &cache, std::size_t store_idx)
+{
+    Intrusive_ptr<Input_stream> &stream = cache.streams[store_idx];
+    if (stream != nullptr) {
+        return *stream;
+    }
+
+    if (cache.open_streams.size() == max_num_open_streams) {
+        cache.streams[cache.open_streams.front()] = nullptr;
+
+        cache.open_streams.pop_front();
+    }
+
+    const Data_store &store = *params_->dataset[store_idx];
+
+    Intrusive_ptr<Input_stream> s = store.open_read();
+    if (!s->seekable()) {
+        throw Data_reader_error{fmt::format(
+            "The data store '{0}' is not seekable and cannot be read using its RecordIO index.",
+            store.id())};
+    }
+
+    stream = std::move(s);
+
+    cache.open_streams.push_back(store_idx);
+
+    return *stream;
+}
+
+Memory_slice Indexed_instance_reader::decode_payload(Memory_slice bits) const
+{
+    std::vector<Memory_slice> parts{};
+
+    std::size_t payload_size = 0;
+
+    bool has_end = false;
+
+    while (!has_end) {
+        if (bits.empty()) {
+            throw Corrupt_record_error{"The RecordIO index does not match the data store."};
+        }
+
+        auto header = detail::decode_recordio_header(bits);
+        if (header == std::nullopt) {
+            throw Corrupt_header_error{"The record does not have a valid RecordIO header."};
+        }
+
+        std::size_t part_size = header->payload_size();
+
+        // The MXNet RecordIO format requires records to be on 4-byte
+        // boundary.
+        std::size_t record_size =
+            header->size() + detail::align(part_size, detail::Recordio_header::alignment);
+
+        if (record_size > bits.size()) {
+            throw Corrupt_header_error{fmt::format(
+                "The record payload has a size of {0:n} byte(s) while the size specified in the RecordIO header is {1:n} byte(s).",
+                bits.size() - header->size(),
+                record_size - header->size())};
+        }
+
+        Record_kind kind = header->record_kind();
+
+        // A record is either complete, or starts with a 'begin' record,
+        // continues with zero or more 'middle' records, and ends with
+        // an 'end' record.
+        bool is_valid{};
+        if (parts.empty()) {
+            is_valid = kind == Record_kind::complete || kind == Record_kind::begin;
+        }
+        else {
+            is_valid = kind == Record_kind::middle || kind == Record_kind::end;
+        }
+
+        if (!is_valid) {
+            throw Corrupt_record_error{"Corrupt split Record encountered."};
+        }
+
+        parts.emplace_back(bits.subslice(header->size(), part_size));
+
+        payload_size += part_size;
+
+        bits = bits.subslice(record_size);
+
+        has_end = kind == Record_kind::complete || kind == Record_kind::end;
+    }
+
+    if (!bits.empty()) {
+        throw Corrupt_record_error{"The RecordIO index does not match the data store."};
+    }
+
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+
+    // Merge the payloads of a split record in a single buffer.
+    auto payload = memory_allocator().allocate(payload_size);
+
+    auto pos = payload->begin();
+    for (const Memory_slice &part : parts) {
+        pos = std::copy(part.begin(), part.end(), pos);
+    }
+
+    return std::move(payload);
+}
+
+void Indexed_instance_reader::handle_errors(std::size_t store_idx, std::size_t record_idx)
+{
+    const Data_store &store = *params_->dataset[store_idx];
+
+    try {
+        throw;
+    }
+    catch (const Record_too_large_error &) {
+        std::throw_with_nested(Data_reader_error{fmt::format(
+            "The record #{1:n} in the data store '{0}' is too large. See nested exception for details.",
+            store.id(),
+            record_idx)});
+    }
+    catch (const Corrupt_record_error &) {
+        std::throw_with_nested(Data_reader_error{fmt::format(
+            "The record #{1:n} in the data store '{0}' is corrupt. See nested exception for details.",
+            store.id(),
+            record_idx)});
+    }
+    catch (const Stream_error &) {
+        std::throw_with_nested(Data_reader_error{fmt::format(
+            "The data store '{0}' contains corrupt data. See nested exception for details.",
+            store.id())});
+    }
+    catch (const Not_supported_error &) {
+        std::throw_with_nested(Data_reader_error{
+            fmt::format("The data store '{0}' cannot be read. See nested exception for details.",
+                        store.id())});
+    }
+    catch (const std::system_error &) {
+        std::throw_with_nested(Data_reader_error{fmt::format(
+            "A system error occurred while trying to read from the data store '{0}'. See nested exception for details.",
+            store.id())});
+    }
+}
+
+void Indexed_instance_reader::ensure_fetching()
+{
+    if (!fetch_threads_.empty()) {
+        return;
+    }
+
+    std::size_t read_ahead = params_->indexed_read_ahead;
+
+    std::size_t num_threads = params_->num_parallel_reads;
+    if (num_threads == 0) {
+        num_threads = get_num_cpus();
+    }
+    num_threads = std::min(num_threads, read_ahead);
+
+    fetch_slots_ = std::vector<Fetch_slot>(read_ahead);
+
+    next_fetch_idx_ = instance_idx_;
+
+    stopping_ = false;
+
+    fetch_threads_.reserve(num_threads);
+
+    try {
+        for (std::size_t i = 0; i < num_threads; i++) {
+            fetch_threads_.emplace_back(start_thread(&Indexed_instance_reader::run_fetch, this));
+        }
+    }
+    catch (...) {
+        stop_fetching();
+
+        throw;
+    }
+}
+
+void Indexed_instance_reader::run_fetch()
+{
+    // Each thread opens its own streams since the streams are not
+    // required to support concurrent reads.
+    Stream_cache cache{};
+    cache.streams.resize(params_->dataset.size());
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    for (;;) {
+        // The number of records fetched ahead is bounded by the size of
+        // the reorder buffer.
+        fetch_condition_.wait(lock, [this] {
+            return stopping_ || (next_fetch_idx_ < num_instances_ &&
+                                 next_fetch_idx_ < instance_idx_ + fetch_slots_.size());
+        });
+
+        if (stopping_) {
+            return;
+        }
+
+        std::size_t idx = next_fetch_idx_++;
+
+        lock.unlock();
+
+        Memory_slice payload{};
+
+        std::exception_ptr exception_ptr{};
+        try {
+            auto [store_idx, record_idx] = locate_record(get_record_id(idx));
+
+            payload = fetch_record(cache, store_idx, record_idx);
+        }
+        catch (...) {
+            exception_ptr = std::current_exception();
+        }
+
+        lock.lock();
+
+        // The position has been skipped in the meantime.
+        if (idx < instance_idx_) {
+            continue;
+        }
+
+        Fetch_slot &slot = fetch_slots_[idx % fetch_slots_.size()];
+
+        slot.instance_idx = idx;
+        slot.ready = true;
+        slot.payload = std::move(payload);
+        slot.exception_ptr = std::move(exception_ptr);
+
+        read_condition_.notify_one();
+    }
+}
+
+void Indexed_instance_reader::stop_fetching() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        stopping_ = true;
+    }
+
+    fetch_condition_.notify_all();
+
+    for (std::thread &thread : fetch_threads_) {
+        thread.join();
+    }
+
+    fetch_threads_.clear();
+
+    fetch_slots_.clear();
+}
+
+void Indexed_instance_reader::reset_core() noexcept
+{
+    stop_fetching();
+
+    has_order_ = false;
+
+    instance_idx_ = 0;
+
+    // The permutation of an epoch is derived from the seed and the
+    // epoch number, so the shards move to the next epoch in lockstep.
+    if (params_->reshuffle_each_epoch) {
+        epoch_++;
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mlio/detail/random.h"
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/instance_readers/instance_reader.h"
+#include "mlio/instance_readers/instance_reader_base.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/recordio_index.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Reads the RecordIO records of a dataset in random order using their
+// offset indexes. Since the indexes tell where each record is, the
+// reader applies the range and shard parameters itself, and visits the
+// remaining records in the order of a pseudorandom permutation; a
+// perfect shuffle that only requires the indexes, and not the dataset,
+// to be held in memory. If read-ahead is enabled, background threads
+// fetch the records of the planned order concurrently into a reorder
+// buffer.
+class Indexed_instance_reader final : public Instance_reader_base {
+    // The data stores opened by a single thread.
+    struct Stream_cache {
+        std::vector<Intrusive_ptr<Input_stream>> streams{};
+        std::deque<std::size_t> open_streams{};
+    };
+
+    // A record fetched ahead of the reader.
+    struct Fetch_slot {
+        std::size_t instance_idx{};
+        bool ready{};
+        Memory_slice payload{};
+        std::exception_ptr exception_ptr{};
+    };
+
+public:
+    explicit Indexed_instance_reader(const Data_reader_params &params);
+
+    Indexed_instance_reader(const Indexed_instance_reader &) = delete;
+
+    Indexed_instance_reader &operator=(const Indexed_instance_reader &) = delete;
+
+    Indexed_instance_reader(Indexed_instance_reader &&) = delete;
+
+    Indexed_instance_reader &operator=(Indexed_instance_reader &&) = delete;
+
+    ~Indexed_instance_reader() final;
+
+private:
+    std::optional<Instance> read_instance_core() final;
+
+    std::optional<Instance> read_fetched_instance();
+
+    std::size_t skip_instances_core(std::size_t num_instances) final;
+
+    void ensure_order();
+
+    void load_indexes();
+
+    void init_order();
+
+    std::size_t get_record_id(std::size_t idx) const noexcept;
+
+    std::pair<std::size_t, std::size_t> locate_record(std::size_t record_id) const noexcept;
+
+    Memory_slice fetch_record(Stream_cache &cache, std::size_t store_idx, std::size_t record_idx);
+
+    Memory_slice
+    read_record(Stream_cache &cache, std::size_t store_idx, const Recordio_index_entry &entry);
+
+    Input_stream &open_stream(Stream_cache &cache, std::size_t store_idx);
+
+    Memory_slice decode_payload(Memory_slice bits) const;
+
+    [[noreturn]] void handle_errors(std::size_t store_idx, std::size_t record_idx);
+
+    void ensure_fetching();
+
+    void run_fetch();
+
+    void stop_fetching() noexcept;
+
+    void reset_core() noexcept final;
+
+    const Data_reader_params *params_;
+    std::vector<std::vector<Recordio_index_entry>> indexes_{};
+    std::vector<std::size_t> store_offsets_{};
+    std::size_t first_record_id_{};
+    std::size_t shard_index_{};
+    std::size_t num_shards_ = 1;
+    std::size_t num_instances_{};
+    std::size_t instance_idx_{};
+    Random_permutation permutation_{};
+    bool is_global_permutation_{};
+    bool has_order_{};
+    Stream_cache cache_{};
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    std::size_t epoch_{};
+    std::vector<std::thread> fetch_threads_{};
+    std::vector<Fetch_slot> fetch_slots_{};
+    std::size_t next_fetch_idx_{};
+    bool stopping_{};
+    std::mutex mutex_{};
+    std::condition_variable fetch_condition_{};
+    std::condition_variable read_condition_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/instance_arena.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "mlio/data_stores/data_store.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::size_t min_segment_size = 0x10000;    // 64 KiB
+constexpr std::size_t max_segment_size = 0x4000000;  // 64 MiB
+constexpr std::size_t instance_alignment = 8;
+
+inline std::size_t align(std::size_t size) noexcept
+{
+    return (size + instance_alignment - 1) & ~(instance_alignment - 1);
+}
+
+}  // namespace
+
+Instance_arena::Instance_arena(std::size_t capacity) noexcept
+    : capacity_{capacity}
+    , segment_size_{std::clamp(capacity / 8, min_segment_size, max_segment_size)}
+{}
+
+Instance_arena::~Instance_arena() = default;
+
+Instance Instance_arena::copy(const Instance &instance)
+{
+    const Memory_slice &bits = instance.bits();
+
+    return Instance{instance.data_store(), instance.index(), copy_bits(bits)};
+}
+
+Memory_slice Instance_arena::copy_bits(const Memory_slice &bits)
+{
+    std::size_t size = bits.size();
+
+    if (!segments_.empty()) {
+        Segment &tail = segments_.back();
+
+        // If the tail segment has no live instances and is not
+        // referenced outside of the arena, we can start over.
+        if (tail.num_bytes_live == 0) {
+            if (tail.block->use_count() == 1 && size <= tail.block->size()) {
+                tail.num_bytes_used = 0;
+            }
+            else {
+                allocated_size_ -= tail.block->size();
+
+                segments_.pop_back();
+            }
+        }
+    }
+
+    if (segments_.empty() || segments_.back().block->size() - segments_.back().num_bytes_used < size) {
+        Segment &segment = segments_.emplace_back();
+
+        segment.block = memory_allocator().allocate(std::max(size, segment_size_));
+
+        allocated_size_ += segment.block->size();
+    }
+
+    Segment &tail = segments_.back();
+
+    auto pos = tail.block->begin() + as_ssize(tail.num_bytes_used);
+
+    std::copy(bits.begin(), bits.end(), pos);
+
+    Memory_slice copy = Memory_slice{tail.block}.subslice(tail.num_bytes_used, size);
+
+    tail.num_bytes_used = std::min(tail.num_bytes_used + align(size), tail.block->size());
+    tail.num_bytes_live += size;
+
+    size_ += size;
+
+    return copy;
+}
+
+void Instance_arena::release(const Instance &instance) noexcept
+{
+    const Memory_slice &bits = instance.bits();
+
+    auto pos = find_segment(bits);
+    if (pos == segments_.end()) {
+        return;
+    }
+
+    pos->num_bytes_live -= bits.size();
+
+    size_ -= bits.size();
+
+    // The tail segment is kept around so that it can be reused.
+    if (pos->num_bytes_live == 0 && pos != segments_.end() - 1) {
+        allocated_size_ -= pos->block->size();
+
+        segments_.erase(pos);
+    }
+}
+
+std::vector<Instance_arena::Segment>::iterator
+Instance_arena::find_segment(const Memory_slice &bits) noexcept
+{
+    std::less<const std::byte *> less{};
+
+    return std::find_if(segments_.begin(), segments_.end(), [&bits, &less](const Segment &segment) {
+        const std::byte *data = segment.block->data();
+
+        return !less(bits.data(), data) && less(bits.data(), data + segment.block->size());
+    });
+}
+
+void Instance_arena::compact(stdx::span<Instance> instances)
+{
+    // Each pass frees at most one segment; bound the number of passes
+    // so that we never keep moving the same instances around.
+    for (std::size_t i = segments_.size(); i > 0 && should_compact(); i--) {
+        auto victim = std::min_element(
+            segments_.begin(), segments_.end() - 1, [](const Segment &a, const Segment &b) {
+                return static_cast<double>(a.num_bytes_live) / static_cast<double>(a.block->size()) <
+                       static_cast<double>(b.num_bytes_live) / static_cast<double>(b.block->size());
+            });
+
+        if (victim->num_bytes_live == victim->block->size()) {
+            break;
+        }
+
+        // Moving the instances can reallocate the segment list, so we
+        // identify the victim by its address range.
+        const std::byte *first = victim->block->data();
+        const std::byte *last = first + victim->block->size();
+
+        std::less<const std::byte *> less{};
+
+        for (Instance &instance : instances) {
+            const std::byte *data = instance.bits().data();
+            if (less(data, first) || !less(data, last)) {
+                continue;
+            }
+
+            Instance moved = copy(instance);
+
+            release(instance);
+
+            instance = std::move(moved);
+        }
+    }
+}
+
+bool Instance_arena::should_compact() const noexcept
+{
+    // Tolerate some fragmentation; compacting too eagerly would cost
+    // more than the memory it saves.
+    return segments_.size() > 1 && allocated_size_ > capacity_ + capacity_ / 4 + segment_size_;
+}
+
+void Instance_arena::clear() noexcept
+{
+    segments_.clear();
+
+    size_ = 0;
+
+    allocated_size_ = 0;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Holds copies of the raw bits of data instances in a set of large
+// memory blocks. As opposed to keeping the instances themselves, this
+// avoids pinning the chunks from which they were read, so the memory
+// held by the arena is bounded by the size of the copied instances.
+class Instance_arena {
+public:
+    explicit Instance_arena(std::size_t capacity) noexcept;
+
+    Instance_arena(const Instance_arena &) = delete;
+
+    Instance_arena &operator=(const Instance_arena &) = delete;
+
+    Instance_arena(Instance_arena &&) = delete;
+
+    Instance_arena &operator=(Instance_arena &&) = delete;
+
+    ~Instance_arena();
+
+    // Returns a boolean value indicating whether an instance of the
+    // specified size can be copied without exceeding the capacity. An
+    // empty arena always has room for one instance.
+    bool has_room(std::size_t size) const noexcept
+    {
+        return size_ == 0 || size_ + size <= capacity_;
+    }
+
+    // Copies the bits of the specified instance into the arena and
+    // returns an instance that refers to the copy.
+    Instance copy(const Instance &instance);
+
+    // Marks the bits of an instance previously returned by copy() as no
+    // longer needed by the arena. The memory is freed once all
+    // instances of its block are released and no longer referenced.
+    void release(const Instance &instance) noexcept;
+
+    // Moves the instances out of the sparsely used blocks if the arena
+    // holds considerably more memory than its live instances need.
+    // @p instances must contain every unreleased instance.
+    void compact(stdx::span<Instance> instances);
+
+    void clear() noexcept;
+
+    // Returns the total size of the unreleased instances.
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    // Returns the total size of the memory blocks held by the arena.
+    std::size_t allocated_size() const noexcept
+    {
+        return allocated_size_;
+    }
+
+private:
+    struct Segment {
+        Intrusive_ptr<Mutable_memory_block> block{};
+        std::size_t num_bytes_used{};
+        std::size_t num_bytes_live{};
+    };
+
+    Memory_slice copy_bits(const Memory_slice &bits);
+
+    std::vector<Segment>::iterator find_segment(const Memory_slice &bits) noexcept;
+
+    bool should_compact() const noexcept;
+
+    std::size_t capacity_;
+    std::size_t segment_size_;
+    std::vector<Segment> segments_{};
+    std::size_t size_{};
+    std::size_t allocated_size_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -17,10 +17,16 @@
 
 #include "mlio/data_reader.h"
 #include "mlio/instance_readers/core_instance_reader.h"
+#include "mlio/instance_readers/deduplicated_instance_reader.h"
+#include "mlio/instance_readers/indexed_instance_reader.h"
+#include "mlio/instance_readers/interleaved_instance_reader.h"
+#include "mlio/instance_readers/materialized_instance_reader.h"
 #include "mlio/instance_readers/ranged_instance_reader.h"
 #include "mlio/instance_readers/sampled_instance_reader.h"
 #include "mlio/instance_readers/sharded_instance_reader.h"
 #include "mlio/instance_readers/shuffled_instance_reader.h"
+#include "mlio/instance_readers/spilled_instance_reader.h"
+#include "mlio/instance_readers/store_sharded_instance_reader.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -28,27 +34,110 @@ namespace detail {
 
 Instance_reader::~Instance_reader() = default;
 
-std::unique_ptr<Instance_reader>
-make_instance_reader(const Data_reader_params &params, Record_reader_factory &&factory)
+std::optional<std::vector<std::size_t>> Instance_reader::position() const
+{
+    return {};
+}
+
+bool Instance_reader::seek(const std::vector<std::size_t> &)
+{
+    return false;
+}
+
+std::size_t Instance_reader::shuffle_buffer_size() const noexcept
+{
+    return 0;
+}
+
+namespace {
+
+std::unique_ptr<Instance_reader> make_instance_reader_core(const Data_reader_params &params,
+                                                           Record_reader_factory &&factory,
+                                                           Store_metrics *metrics)
 {
     std::unique_ptr<Instance_reader> reader{};
 
-    reader = std::make_unique<Core_instance_reader>(params, std::move(factory));
+    // The indexed reader selects and shuffles the records itself before
+    // reading them, so it needs no decorators other than deduplication
+    // and sampling.
+    if (!params.recordio_indexes.empty()) {
+        reader = std::make_unique<Indexed_instance_reader>(params);
+
+        if (params.deduplicate_instances) {
+            reader = std::make_unique<Deduplicated_instance_reader>(params, std::move(reader));
+        }
+
+        if (params.sample_ratio) {
+            reader = std::make_unique<Sampled_instance_reader>(params, std::move(reader));
+        }
+
+        return reader;
+    }
+
+    // The data stores of the shard are read by an inner reader that is
+    // constructed with the rest of the decorators.
+    if (params.num_shards > 1 && params.sharding_strategy == Sharding_strategy::data_store) {
+        return std::make_unique<Store_sharded_instance_reader>(params, std::move(factory), metrics);
+    }
+
+    if (params.interleave_cycle_length > 1 && params.dataset.size() > 1) {
+        reader = std::make_unique<Interleaved_instance_reader>(params, std::move(factory), metrics);
+    }
+    else {
+        reader = std::make_unique<Core_instance_reader>(params, std::move(factory), metrics);
+    }
 
     if (params.num_instances_to_skip > 0 || params.num_instances_to_read) {
         reader = std::make_unique<Ranged_instance_reader>(params, std::move(reader));
     }
 
-    if (params.num_shards > 1) {
+    // In byte-range mode the core reader shards the data stores while
+    // reading them.
+    if (params.num_shards > 1 && params.sharding_strategy == Sharding_strategy::instance) {
         reader = std::make_unique<Sharded_instance_reader>(params, std::move(reader));
     }
 
+    // Deduplicate before sampling so that the duplicates of a rejected
+    // instance are not read in its place.
+    if (params.deduplicate_instances) {
+        reader = std::make_unique<Deduplicated_instance_reader>(params, std::move(reader));
+    }
+
     if (params.sample_ratio) {
         reader = std::make_unique<Sampled_instance_reader>(params, std::move(reader));
     }
 
     if (params.shuffle_instances) {
-        reader = std::make_unique<Shuffled_instance_reader>(params, std::move(reader));
+        if (params.shuffle_window == 0 && !params.shuffle_spill_directory.empty()) {
+            reader = std::make_unique<Spilled_instance_reader>(params, std::move(reader));
+        }
+        else {
+            reader = std::make_unique<Shuffled_instance_reader>(params, std::move(reader));
+        }
+    }
+
+    return reader;
+}
+
+}  // namespace
+
+std::unique_ptr<Instance_reader> make_instance_reader(const Data_reader_params &params,
+                                                      Record_reader_factory &&factory,
+                                                      Store_metrics *metrics)
+{
+    std::unique_ptr<Instance_reader> reader =
+        make_instance_reader_core(params, std::move(factory), metrics);
+
+    // The materialized instances are the output of all other readers;
+    // the later epochs only replay or reshuffle them. A shard seed
+    // assigns different data stores to the shard in every epoch, which
+    // rules out materializing the first one.
+    bool reshards_each_epoch = params.num_shards > 1 &&
+                               params.sharding_strategy == Sharding_strategy::data_store &&
+                               params.shard_seed != std::nullopt;
+
+    if (params.materialize_memory_budget > 0 && !reshards_each_epoch) {
+        reader = std::make_unique<Materialized_instance_reader>(params, std::move(reader));
     }
 
     return reader;
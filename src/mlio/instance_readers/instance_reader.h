@@ -15,9 +15,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
@@ -45,13 +47,36 @@ public:
 
     virtual std::optional<Instance> peek_instance() = 0;
 
+    // Skips the specified number of instances without constructing
+    // them where possible. Returns the number of skipped instances,
+    // which is less than requested only if the end of the dataset has
+    // been reached.
+    virtual std::size_t skip_instances(std::size_t num_instances) = 0;
+
     virtual void reset() noexcept = 0;
+
+    // Returns the position of the reader right after the last instance
+    // read, if the reader can later seek to it directly.
+    virtual std::optional<std::vector<std::size_t>> position() const;
+
+    // Moves the reader to the specified position returned by position().
+    // Must be called right after the reader has been constructed or
+    // reset. Returns false if the reader cannot seek; in such case it
+    // has to be reset before it can be used again.
+    virtual bool seek(const std::vector<std::size_t> &position);
+
+    // Returns the number of bytes currently held by the shuffle buffer
+    // of the reader. Safe to call from any thread.
+    virtual std::size_t shuffle_buffer_size() const noexcept;
 };
 
 using Record_reader_factory = std::function<Intrusive_ptr<Record_reader>(const Data_store &store)>;
 
-std::unique_ptr<Instance_reader>
-make_instance_reader(const Data_reader_params &params, Record_reader_factory &&factory);
+// The metrics, if not null, receive the read counters of the data
+// stores.
+std::unique_ptr<Instance_reader> make_instance_reader(const Data_reader_params &params,
+                                                      Record_reader_factory &&factory,
+                                                      Store_metrics *metrics);
 
 }  // namespace detail
 }  // namespace abi_v1
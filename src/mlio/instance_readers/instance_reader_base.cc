@@ -36,6 +36,56 @@ std::optional<Instance> Instance_reader_base::peek_instance()
     return peeked_instance_;
 }
 
+std::size_t Instance_reader_base::skip_instances(std::size_t num_instances)
+{
+    if (num_instances == 0) {
+        return 0;
+    }
+
+    if (peeked_instance_) {
+        peeked_instance_ = {};
+
+        return skip_instances_core(num_instances - 1) + 1;
+    }
+    return skip_instances_core(num_instances);
+}
+
+std::size_t Instance_reader_base::skip_instances_core(std::size_t num_instances)
+{
+    for (std::size_t i = 0; i < num_instances; i++) {
+        if (read_instance_core() == std::nullopt) {
+            return i;
+        }
+    }
+    return num_instances;
+}
+
+std::optional<std::vector<std::size_t>> Instance_reader_base::position() const
+{
+    // The peeked instance has already been read from the dataset.
+    if (peeked_instance_) {
+        return {};
+    }
+    return position_core();
+}
+
+bool Instance_reader_base::seek(const std::vector<std::size_t> &position)
+{
+    peeked_instance_ = {};
+
+    return seek_core(position);
+}
+
+std::optional<std::vector<std::size_t>> Instance_reader_base::position_core() const
+{
+    return {};
+}
+
+bool Instance_reader_base::seek_core(const std::vector<std::size_t> &)
+{
+    return false;
+}
+
 void Instance_reader_base::reset() noexcept
 {
     reset_core();
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <optional>
+#include <vector>
 
 #include "mlio/instance.h"
 #include "mlio/instance_readers/instance_reader.h"
@@ -31,11 +32,25 @@ public:
 
     std::optional<Instance> peek_instance() final;
 
+    std::size_t skip_instances(std::size_t num_instances) final;
+
     void reset() noexcept final;
 
+    std::optional<std::vector<std::size_t>> position() const final;
+
+    bool seek(const std::vector<std::size_t> &position) final;
+
 private:
     virtual std::optional<Instance> read_instance_core() = 0;
 
+    // The default implementation reads and discards the instances.
+    virtual std::size_t skip_instances_core(std::size_t num_instances);
+
+    // The default implementations do not support seeking.
+    virtual std::optional<std::vector<std::size_t>> position_core() const;
+
+    virtual bool seek_core(const std::vector<std::size_t> &position);
+
     virtual void reset_core() noexcept = 0;
 
     std::optional<Instance> peeked_instance_{};
@@ -0,0 +1,336 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/interleaved_instance_reader.h"
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mlio/data_reader.h"
+#include "mlio/detail/thread.h"
+#include "mlio/instance_readers/core_instance_reader.h"
+#include "mlio/record_readers/record_reader.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The maximum number of instances a slot buffers ahead of the reader.
+constexpr std::size_t max_num_buffered_instances = 1024;
+
+// The number of instances a slot reads before handing them over.
+constexpr std::size_t num_instances_per_handover = 64;
+
+}  // namespace
+
+struct Interleaved_instance_reader::Slot {
+    // An item holding neither an instance nor an exception marks the
+    // end of the data store.
+    struct Item {
+        std::optional<Instance> instance{};
+        std::exception_ptr exception_ptr{};
+    };
+
+    std::thread thread{};
+    std::unique_ptr<Core_instance_reader> pending_reader{};
+    std::deque<Item> queue{};
+    std::condition_variable fill_condition{};
+    bool active{};
+};
+
+Interleaved_instance_reader::Interleaved_instance_reader(const Data_reader_params &params,
+                                                         Record_reader_factory &&factory,
+                                                         Store_metrics *metrics)
+    : params_{&params}
+    , record_reader_factory_{std::move(factory)}
+    , metrics_{metrics}
+    , cycle_length_{std::min(params_->interleave_cycle_length, params_->dataset.size())}
+    , block_length_{std::max(params_->interleave_block_length, std::size_t{1})}
+{}
+
+Interleaved_instance_reader::~Interleaved_instance_reader()
+{
+    stop();
+}
+
+std::optional<Instance> Interleaved_instance_reader::read_instance_core()
+{
+    ensure_slots_running();
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    Slot *slot{};
+    while ((slot = next_slot(lock)) != nullptr) {
+        Slot::Item &item = slot->queue.front();
+
+        // We keep the failed item at the front of the queue so that
+        // subsequent calls keep reporting the same error.
+        if (item.exception_ptr) {
+            std::rethrow_exception(item.exception_ptr);
+        }
+
+        if (item.instance == std::nullopt) {
+            slot->queue.pop_front();
+
+            assign_next_store(*slot, lock);
+
+            move_to_next_slot();
+
+            continue;
+        }
+
+        Instance instance = std::move(*item.instance);
+
+        slot->queue.pop_front();
+
+        slot->fill_condition.notify_one();
+
+        if (++block_pos_ == block_length_) {
+            move_to_next_slot();
+        }
+
+        return instance;
+    }
+
+    return {};
+}
+
+void Interleaved_instance_reader::ensure_slots_running()
+{
+    if (!slots_.empty()) {
+        return;
+    }
+
+    slots_.reserve(cycle_length_);
+
+    for (std::size_t i = 0; i < cycle_length_; i++) {
+        slots_.emplace_back(std::make_unique<Slot>());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        for (auto &slot : slots_) {
+            assign_next_store(*slot, lock);
+        }
+    }
+
+    for (auto &slot : slots_) {
+        slot->thread =
+            start_thread(&Interleaved_instance_reader::run_slot, this, std::ref(*slot));
+    }
+}
+
+Interleaved_instance_reader::Slot *
+Interleaved_instance_reader::next_slot(std::unique_lock<std::mutex> &lock)
+{
+    bool first_available = params_->interleave_ordering == Interleave_ordering::first_available;
+
+    for (;;) {
+        bool has_active_slot = false;
+
+        for (std::size_t i = 0; i < slots_.size(); i++) {
+            std::size_t idx = (slot_idx_ + i) % slots_.size();
+
+            Slot &slot = *slots_[idx];
+            if (!slot.active) {
+                continue;
+            }
+
+            has_active_slot = true;
+
+            if (!slot.queue.empty()) {
+                if (idx != slot_idx_) {
+                    slot_idx_ = idx;
+
+                    block_pos_ = 0;
+                }
+
+                return &slot;
+            }
+
+            // In round-robin mode we have to wait for the current slot
+            // to preserve the order.
+            if (!first_available) {
+                break;
+            }
+        }
+
+        if (!has_active_slot) {
+            return nullptr;
+        }
+
+        read_condition_.wait(lock);
+    }
+}
+
+void Interleaved_instance_reader::assign_next_store(Slot &slot,
+                                                    std::unique_lock<std::mutex> &lock)
+{
+    if (store_idx_ == params_->dataset.size()) {
+        slot.active = false;
+
+        return;
+    }
+
+    auto stores = stdx::span<const Intrusive_ptr<Data_store>>{params_->dataset}.subspan(
+        store_idx_++, 1);
+
+    // The record readers are constructed on the calling thread and in
+    // dataset order since the factory is not required to be thread-safe
+    // (e.g. CSV readers infer the header from the first data store).
+    lock.unlock();
+
+    Intrusive_ptr<Record_reader> record_reader{};
+
+    std::exception_ptr exception_ptr{};
+    try {
+        record_reader = record_reader_factory_(*stores[0]);
+    }
+    catch (...) {
+        // Let the instance reader translate the error in the slot.
+        exception_ptr = std::current_exception();
+    }
+
+    auto factory = [record_reader = std::move(record_reader), exception_ptr](const Data_store &) {
+        if (exception_ptr) {
+            std::rethrow_exception(exception_ptr);
+        }
+        return record_reader;
+    };
+
+    auto reader = std::make_unique<Core_instance_reader>(
+        *params_, stores, std::move(factory), metrics_);
+
+    lock.lock();
+
+    slot.pending_reader = std::move(reader);
+
+    slot.active = true;
+
+    slot.fill_condition.notify_one();
+}
+
+void Interleaved_instance_reader::move_to_next_slot() noexcept
+{
+    slot_idx_ = (slot_idx_ + 1) % slots_.size();
+
+    block_pos_ = 0;
+}
+
+void Interleaved_instance_reader::run_slot(Slot &slot)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    for (;;) {
+        slot.fill_condition.wait(lock, [this, &slot] {
+            return stopping_ || slot.pending_reader != nullptr;
+        });
+
+        if (stopping_) {
+            return;
+        }
+
+        std::unique_ptr<Core_instance_reader> reader = std::move(slot.pending_reader);
+
+        bool has_more = true;
+        while (has_more) {
+            lock.unlock();
+
+            std::vector<Slot::Item> items{};
+            items.reserve(num_instances_per_handover);
+
+            try {
+                while (items.size() < num_instances_per_handover) {
+                    std::optional<Instance> instance = reader->read_instance();
+                    if (instance == std::nullopt) {
+                        has_more = false;
+
+                        items.emplace_back();
+
+                        break;
+                    }
+
+                    items.push_back(Slot::Item{std::move(instance), {}});
+                }
+            }
+            catch (...) {
+                has_more = false;
+
+                items.push_back(Slot::Item{{}, std::current_exception()});
+            }
+
+            lock.lock();
+
+            slot.fill_condition.wait(lock, [this, &slot] {
+                return stopping_ || slot.queue.size() < max_num_buffered_instances;
+            });
+
+            if (stopping_) {
+                return;
+            }
+
+            std::move(items.begin(), items.end(), std::back_inserter(slot.queue));
+
+            read_condition_.notify_one();
+        }
+    }
+}
+
+void Interleaved_instance_reader::stop() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        stopping_ = true;
+    }
+
+    for (auto &slot : slots_) {
+        slot->fill_condition.notify_one();
+    }
+
+    for (auto &slot : slots_) {
+        if (slot->thread.joinable()) {
+            slot->thread.join();
+        }
+    }
+}
+
+void Interleaved_instance_reader::reset_core() noexcept
+{
+    stop();
+
+    slots_.clear();
+
+    slot_idx_ = 0;
+
+    block_pos_ = 0;
+
+    store_idx_ = 0;
+
+    stopping_ = false;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
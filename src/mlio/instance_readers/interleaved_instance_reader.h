@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/instance_readers/instance_reader.h"
+#include "mlio/instance_readers/instance_reader_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Reads multiple data stores concurrently and interleaves their
+// instances. Each slot of the cycle owns a background thread that
+// reads the data store currently assigned to it into a bounded queue.
+class Interleaved_instance_reader final : public Instance_reader_base {
+    struct Slot;
+
+public:
+    explicit Interleaved_instance_reader(const Data_reader_params &params,
+                                         Record_reader_factory &&factory,
+                                         Store_metrics *metrics);
+
+    Interleaved_instance_reader(const Interleaved_instance_reader &) = delete;
+
+    Interleaved_instance_reader &operator=(const Interleaved_instance_reader &) = delete;
+
+    Interleaved_instance_reader(Interleaved_instance_reader &&) = delete;
+
+    Interleaved_instance_reader &operator=(Interleaved_instance_reader &&) = delete;
+
+    ~Interleaved_instance_reader() final;
+
+private:
+    std::optional<Instance> read_instance_core() final;
+
+    void ensure_slots_running();
+
+    Slot *next_slot(std::unique_lock<std::mutex> &lock);
+
+    void assign_next_store(Slot &slot, std::unique_lock<std::mutex> &lock);
+
+    void move_to_next_slot() noexcept;
+
+    void run_slot(Slot &slot);
+
+    void stop() noexcept;
+
+    void reset_core() noexcept final;
+
+    const Data_reader_params *params_;
+    Record_reader_factory record_reader_factory_;
+    Store_metrics *metrics_;
+    std::size_t cycle_length_;
+    std::size_t block_length_;
+    std::vector<std::unique_ptr<Slot>> slots_{};
+    std::size_t slot_idx_{};
+    std::size_t block_pos_{};
+    std::size_t store_idx_{};
+    std::size_t num_active_slots_{};
+    bool stopping_{};
+    std::mutex mutex_{};
+    std::condition_variable read_condition_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
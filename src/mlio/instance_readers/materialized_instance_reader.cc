@@ -0,0 +1,173 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/materialized_instance_reader.h"
+
+#include <numeric>
+#include <utility>
+
+#include "mlio/data_reader.h"
+#include "mlio/logger.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Materialized_instance_reader::Materialized_instance_reader(
+    const Data_reader_params &params, std::unique_ptr<Instance_reader> &&inner)
+    : params_{&params}, inner_{std::move(inner)}, arena_{params.materialize_memory_budget}
+{
+    if (params_->shuffle_seed != std::nullopt) {
+        seed_ = *params_->shuffle_seed;
+
+        engine_.seed(seed_);
+    }
+}
+
+std::size_t Materialized_instance_reader::shuffle_buffer_size() const noexcept
+{
+    if (materialized_) {
+        return 0;
+    }
+    return inner_->shuffle_buffer_size();
+}
+
+std::optional<Instance> Materialized_instance_reader::read_instance_core()
+{
+    if (!materialized_) {
+        return read_and_materialize();
+    }
+
+    if (next_instance_ == order_.size()) {
+        return {};
+    }
+
+    return instances_[order_[next_instance_++]];
+}
+
+std::optional<Instance> Materialized_instance_reader::read_and_materialize()
+{
+    std::optional<Instance> instance = inner_->read_instance();
+    if (instance == std::nullopt) {
+        inner_has_instance_ = false;
+
+        return {};
+    }
+
+    if (skip_epoch_) {
+        return instance;
+    }
+
+    std::size_t size = instance->bits().size();
+
+    // The arena always has room for a single instance; make sure that
+    // it cannot exceed the budget either.
+    if (!arena_.has_room(size) || size > params_->materialize_memory_budget) {
+        logger::info("The dataset does not fit into the materialize memory budget of {0:n} "
+                     "bytes and will be read from its data stores in every epoch.",
+                     params_->materialize_memory_budget);
+
+        over_budget_ = true;
+
+        skip_epoch_ = true;
+
+        drop_instances();
+
+        return instance;
+    }
+
+    // The copy does not pin the chunk the instance was read from, so the
+    // memory held is bounded by the size of the instances.
+    Instance copy = arena_.copy(*instance);
+
+    instances_.emplace_back(copy);
+
+    return copy;
+}
+
+std::optional<std::vector<std::size_t>> Materialized_instance_reader::position_core() const
+{
+    if (materialized_) {
+        return {};
+    }
+    return inner_->position();
+}
+
+bool Materialized_instance_reader::seek_core(const std::vector<std::size_t> &position)
+{
+    if (materialized_) {
+        return false;
+    }
+
+    // An epoch that does not start from the beginning of the dataset
+    // cannot be materialized.
+    skip_epoch_ = true;
+
+    drop_instances();
+
+    return inner_->seek(position);
+}
+
+void Materialized_instance_reader::reset_core() noexcept
+{
+    if (!materialized_) {
+        // If the first epoch has been read to its end, we hold the whole
+        // dataset; otherwise we start over.
+        if (!skip_epoch_ && !inner_has_instance_) {
+            materialized_ = true;
+
+            order_.resize(instances_.size());
+
+            std::iota(order_.begin(), order_.end(), 0);
+
+            logger::info("The dataset has been materialized; {0:n} instance(s) are held in memory.",
+                         instances_.size());
+        }
+        else {
+            drop_instances();
+
+            inner_->reset();
+
+            inner_has_instance_ = true;
+
+            skip_epoch_ = over_budget_;
+
+            return;
+        }
+    }
+
+    next_instance_ = 0;
+
+    if (!params_->shuffle_instances) {
+        return;
+    }
+
+    // Without reshuffling every epoch returns the instances in the order
+    // of the first one.
+    if (params_->reshuffle_each_epoch) {
+        random_shuffle(order_.begin(), order_.end(), engine_);
+    }
+}
+
+void Materialized_instance_reader::drop_instances() noexcept
+{
+    std::vector<Instance>{}.swap(instances_);
+
+    arena_.clear();
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "mlio/detail/random.h"
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/instance_readers/instance_arena.h"
+#include "mlio/instance_readers/instance_reader.h"
+#include "mlio/instance_readers/instance_reader_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Keeps a copy of the instances of the first epoch in memory as long as
+// they fit into Data_reader_params::materialize_memory_budget. If the
+// whole epoch fits, the later epochs are served from memory without
+// touching the inner reader; otherwise the copies are dropped and every
+// epoch is read from the inner reader.
+class Materialized_instance_reader final : public Instance_reader_base {
+public:
+    explicit Materialized_instance_reader(const Data_reader_params &params,
+                                          std::unique_ptr<Instance_reader> &&inner);
+
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+private:
+    std::optional<Instance> read_instance_core() final;
+
+    std::optional<Instance> read_and_materialize();
+
+    std::optional<std::vector<std::size_t>> position_core() const final;
+
+    bool seek_core(const std::vector<std::size_t> &position) final;
+
+    void reset_core() noexcept final;
+
+    void drop_instances() noexcept;
+
+    const Data_reader_params *params_;
+    std::unique_ptr<Instance_reader> inner_;
+    Instance_arena arena_;
+    std::vector<Instance> instances_{};
+    // The order in which the materialized instances are returned.
+    std::vector<std::size_t> order_{};
+    std::size_t next_instance_{};
+    bool materialized_{};
+    // Set if the current epoch cannot be materialized; either since it
+    // did not fit into the budget, or since it did not start from the
+    // beginning of the dataset.
+    bool skip_epoch_{};
+    bool over_budget_{};
+    bool inner_has_instance_ = true;
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    Xoshiro256pp engine_{seed_};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
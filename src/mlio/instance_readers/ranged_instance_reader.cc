@@ -15,6 +15,7 @@
 
 #include "mlio/instance_readers/ranged_instance_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mlio/data_reader.h"
@@ -31,15 +32,8 @@ Ranged_instance_reader::Ranged_instance_reader(const Data_reader_params &params,
 
 std::optional<Instance> Ranged_instance_reader::read_instance_core()
 {
-    if (first_read_) {
-        first_read_ = false;
-
-        for (std::size_t i = 0; i < params_->num_instances_to_skip; i++) {
-            std::optional<Instance> instance = inner_->read_instance();
-            if (instance == std::nullopt) {
-                return {};
-            }
-        }
+    if (!skip_to_first_instance()) {
+        return {};
     }
 
     if (should_stop_reading()) {
@@ -56,6 +50,35 @@ std::optional<Instance> Ranged_instance_reader::read_instance_core()
     return instance;
 }
 
+std::size_t Ranged_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    if (!skip_to_first_instance()) {
+        return 0;
+    }
+
+    if (params_->num_instances_to_read) {
+        num_instances = std::min(num_instances, *params_->num_instances_to_read - num_instances_read_);
+    }
+
+    std::size_t num_instances_skipped = inner_->skip_instances(num_instances);
+
+    num_instances_read_ += num_instances_skipped;
+
+    return num_instances_skipped;
+}
+
+bool Ranged_instance_reader::skip_to_first_instance()
+{
+    if (first_read_) {
+        first_read_ = false;
+
+        std::size_t num_instances_to_skip = params_->num_instances_to_skip;
+
+        return inner_->skip_instances(num_instances_to_skip) == num_instances_to_skip;
+    }
+    return true;
+}
+
 inline bool Ranged_instance_reader::should_stop_reading() const noexcept
 {
     if (params_->num_instances_to_read == std::nullopt) {
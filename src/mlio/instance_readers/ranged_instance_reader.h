@@ -35,6 +35,10 @@ public:
 private:
     std::optional<Instance> read_instance_core() final;
 
+    std::size_t skip_instances_core(std::size_t num_instances) final;
+
+    bool skip_to_first_instance();
+
     bool should_stop_reading() const noexcept;
 
     void reset_core() noexcept final;
@@ -15,6 +15,7 @@
 
 #include "mlio/instance_readers/sampled_instance_reader.h"
 
+#include <stdexcept>
 #include <utility>
 
 #include "mlio/data_reader.h"
@@ -31,54 +32,37 @@ Sampled_instance_reader::Sampled_instance_reader(const Data_reader_params &param
         throw std::invalid_argument{"The sample ratio must be greater than 0 and less than 1."};
     }
 
-    buffer_.reserve(num_instances_to_read_);
+    // The number of instances rejected before the next selected one
+    // follows a geometric distribution; this lets us skip them at once
+    // instead of flipping a coin for each.
+    dist_ = std::geometric_distribution<std::size_t>{*params_->sample_ratio};
 
-    buffer_pos_ = buffer_.end();
-}
+    if (params_->sample_seed != std::nullopt) {
+        seed_ = *params_->sample_seed;
 
-std::optional<Instance> Sampled_instance_reader::read_instance_core()
-{
-    if (buffer_pos_ == buffer_.end()) {
-        fill_buffer_from_inner();
+        mt_.seed(seed_);
     }
-
-    if (buffer_.empty()) {
-        return {};
-    }
-
-    return std::exchange(*buffer_pos_++, {});
 }
 
-void Sampled_instance_reader::fill_buffer_from_inner()
+std::optional<Instance> Sampled_instance_reader::read_instance_core()
 {
-    buffer_.clear();
-
-    while (buffer_.size() < num_instances_to_read_) {
-        std::optional<Instance> instance = inner_->read_instance();
-        if (instance == std::nullopt) {
-            break;
-        }
-
-        buffer_.emplace_back(std::move(instance));
-    }
-
-    if (!buffer_.empty()) {
-        auto num_keep = static_cast<std::ptrdiff_t>(*params_->sample_ratio *
-                                                    static_cast<float>(buffer_.size()));
+    std::size_t num_instances_to_skip = dist_(mt_);
 
-        buffer_.erase(buffer_.begin() + num_keep, buffer_.end());
+    if (inner_->skip_instances(num_instances_to_skip) < num_instances_to_skip) {
+        return {};
     }
 
-    buffer_pos_ = buffer_.begin();
+    return inner_->read_instance();
 }
 
 void Sampled_instance_reader::reset_core() noexcept
 {
     inner_->reset();
 
-    buffer_.clear();
+    // Make sure that we read the same sample in every epoch.
+    mt_.seed(seed_);
 
-    buffer_pos_ = buffer_.end();
+    dist_.reset();
 }
 
 }  // namespace detail
@@ -16,9 +16,10 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
-#include <vector>
+#include <random>
 
 #include "mlio/fwd.h"
 #include "mlio/instance.h"
@@ -37,16 +38,14 @@ public:
 private:
     std::optional<Instance> read_instance_core() final;
 
-    void fill_buffer_from_inner();
-
     void reset_core() noexcept final;
 
-    static constexpr std::size_t num_instances_to_read_ = 100;
-
     const Data_reader_params *params_;
     std::unique_ptr<Instance_reader> inner_;
-    std::vector<std::optional<Instance>> buffer_{};
-    std::vector<std::optional<Instance>>::iterator buffer_pos_{};
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    std::mt19937_64 mt_{seed_};
+    std::geometric_distribution<std::size_t> dist_;
 };
 
 }  // namespace detail
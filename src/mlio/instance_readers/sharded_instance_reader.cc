@@ -46,16 +46,39 @@ std::optional<Instance> Sharded_instance_reader::read_instance_core()
         num_instances_to_skip = params_->num_shards - 1;
     }
 
-    for (std::size_t i = 0; i < num_instances_to_skip; i++) {
-        std::optional<Instance> instance = inner_->read_instance();
-        if (instance == std::nullopt) {
-            return {};
-        }
+    if (inner_->skip_instances(num_instances_to_skip) < num_instances_to_skip) {
+        return {};
     }
 
     return inner_->read_instance();
 }
 
+std::size_t Sharded_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    if (num_instances == 0) {
+        return 0;
+    }
+
+    // Each instance of the shard is preceded by the instances of the
+    // other shards; except the first one which is preceded only by the
+    // instances of the shards with a lower index.
+    std::size_t offset = 0;
+
+    if (first_read_) {
+        first_read_ = false;
+
+        offset = params_->num_shards - params_->shard_index - 1;
+    }
+
+    std::size_t num_inner_instances = num_instances * params_->num_shards - offset;
+
+    std::size_t num_skipped = inner_->skip_instances(num_inner_instances);
+    if (num_skipped == num_inner_instances) {
+        return num_instances;
+    }
+    return (num_skipped + offset) / params_->num_shards;
+}
+
 void Sharded_instance_reader::reset_core() noexcept
 {
     inner_->reset();
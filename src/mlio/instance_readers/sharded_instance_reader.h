@@ -35,6 +35,8 @@ public:
 private:
     std::optional<Instance> read_instance_core() final;
 
+    std::size_t skip_instances_core(std::size_t num_instances) final;
+
     void reset_core() noexcept final;
 
     const Data_reader_params *params_;
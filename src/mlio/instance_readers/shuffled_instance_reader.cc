@@ -15,11 +15,11 @@
 
 #include "mlio/instance_readers/shuffled_instance_reader.h"
 
-#include <algorithm>
 #include <limits>
 #include <utility>
 
 #include "mlio/data_reader.h"
+#include "mlio/detail/allocation_audit.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -30,7 +30,6 @@ Shuffled_instance_reader::Shuffled_instance_reader(const Data_reader_params &par
     : params_{&params}
     , inner_{std::move(inner)}
     , shuffle_window_{params_->shuffle_window}
-    , dist_{0, shuffle_window_ - 1}
 {
     if (shuffle_window_ == 1) {
         return;
@@ -42,10 +41,14 @@ Shuffled_instance_reader::Shuffled_instance_reader(const Data_reader_params &par
         buffer_.reserve(shuffle_window_);
     }
 
+    if (params_->shuffle_window_bytes > 0) {
+        arena_.emplace(params_->shuffle_window_bytes);
+    }
+
     if (params_->shuffle_seed != std::nullopt) {
         seed_ = *params_->shuffle_seed;
 
-        mt_.seed(seed_);
+        engine_.seed(seed_);
     }
 }
 
@@ -57,40 +60,53 @@ std::optional<Instance> Shuffled_instance_reader::read_instance_core()
 
     fill_buffer_from_inner();
 
-    if (buffer_.empty()) {
-        return {};
-    }
-
-    if (inner_has_instance_) {
-        return pop_random_instance_from_buffer();
-    }
-
-    Instance instance = std::move(buffer_.back());
-
-    buffer_.pop_back();
-
-    return std::move(instance);
+    // Once the inner reader is exhausted, we keep popping random
+    // instances; this drains the buffer in a uniformly random order
+    // without shuffling it up front.
+    return pop_random_instance_from_buffer();
 }
 
 void Shuffled_instance_reader::fill_buffer_from_inner()
 {
     while (inner_has_instance_ && buffer_.size() < shuffle_window_) {
-        std::optional<Instance> instance = inner_->read_instance();
+        std::optional<Instance> instance = std::exchange(pending_instance_, std::nullopt);
+        if (instance == std::nullopt) {
+            instance = inner_->read_instance();
+        }
         if (instance == std::nullopt) {
             inner_has_instance_ = false;
 
-            std::shuffle(buffer_.begin(), buffer_.end(), mt_);
-
             break;
         }
 
-        buffer_.emplace_back(std::move(*instance));
+        Allocation_scope scope{Allocation_stage::shuffle};
+
+        if (arena_) {
+            // Keep the instance for later if the arena has no room for
+            // it; we will try again once we hand out an instance.
+            if (!arena_->has_room(instance->bits().size())) {
+                pending_instance_ = std::move(instance);
+
+                break;
+            }
+
+            buffer_.emplace_back(arena_->copy(*instance));
+
+            buffer_size_ = arena_->allocated_size();
+        }
+        else {
+            buffer_.emplace_back(std::move(*instance));
+        }
     }
 }
 
 std::optional<Instance> Shuffled_instance_reader::pop_random_instance_from_buffer()
 {
-    std::size_t random_idx = dist_(mt_);
+    if (buffer_.empty()) {
+        return {};
+    }
+
+    std::size_t random_idx = bounded_random(engine_, buffer_.size());
 
     Instance instance = std::move(buffer_[random_idx]);
 
@@ -100,21 +116,47 @@ std::optional<Instance> Shuffled_instance_reader::pop_random_instance_from_buffe
 
     buffer_.pop_back();
 
+    return release_from_buffer(std::move(instance));
+}
+
+Instance Shuffled_instance_reader::release_from_buffer(Instance &&instance)
+{
+    if (arena_) {
+        arena_->release(instance);
+
+        arena_->compact(buffer_);
+
+        buffer_size_ = arena_->allocated_size();
+    }
+
     return std::move(instance);
 }
 
+std::size_t Shuffled_instance_reader::shuffle_buffer_size() const noexcept
+{
+    return buffer_size_.load(std::memory_order_relaxed);
+}
+
 void Shuffled_instance_reader::reset_core() noexcept
 {
     inner_->reset();
 
     buffer_.clear();
 
+    if (arena_) {
+        arena_->clear();
+    }
+
+    pending_instance_ = {};
+
+    buffer_size_ = 0;
+
     inner_has_instance_ = true;
 
     // Make sure that we reset the random number generator engine to
     // its initial state if reshuffling is not requested.
     if (!params_->reshuffle_each_epoch) {
-        mt_.seed(seed_);
+        engine_.seed(seed_);
     }
 }
 
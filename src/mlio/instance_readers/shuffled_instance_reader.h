@@ -15,14 +15,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <optional>
 #include <random>
 #include <vector>
 
+#include "mlio/detail/random.h"
 #include "mlio/fwd.h"
 #include "mlio/instance.h"
+#include "mlio/instance_readers/instance_arena.h"
 #include "mlio/instance_readers/instance_reader.h"
 #include "mlio/instance_readers/instance_reader_base.h"
 
@@ -35,6 +38,8 @@ public:
     explicit Shuffled_instance_reader(const Data_reader_params &params,
                                       std::unique_ptr<Instance_reader> &&inner);
 
+    std::size_t shuffle_buffer_size() const noexcept final;
+
 private:
     std::optional<Instance> read_instance_core() final;
 
@@ -42,17 +47,21 @@ private:
 
     std::optional<Instance> pop_random_instance_from_buffer();
 
+    Instance release_from_buffer(Instance &&instance);
+
     void reset_core() noexcept final;
 
     const Data_reader_params *params_;
     std::unique_ptr<Instance_reader> inner_;
     std::size_t shuffle_window_;
     std::vector<Instance> buffer_{};
+    std::optional<Instance_arena> arena_{};
+    std::optional<Instance> pending_instance_{};
+    std::atomic_size_t buffer_size_{};
     bool inner_has_instance_ = true;
     std::random_device rd_{};
     std::uint_fast64_t seed_{rd_()};
-    std::mt19937_64 mt_{seed_};
-    std::uniform_int_distribution<std::size_t> dist_;
+    Xoshiro256pp engine_{seed_};
 };
 
 }  // namespace detail
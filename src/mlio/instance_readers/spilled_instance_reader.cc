@@ -0,0 +1,252 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/spilled_instance_reader.h"
+
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+#include <sys/mman.h>
+
+#include "mlio/data_reader.h"
+#include "mlio/logger.h"
+#include "mlio/memory/file_backed_memory_block.h"
+#include "mlio/memory/memory_slice.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The number of instances the first epoch is shuffled within while it
+// gets spilled.
+constexpr std::size_t first_epoch_window = 0x2000;
+
+constexpr std::size_t default_num_buckets = 64;
+
+// Precedes the bits of an instance in a bucket. The bits are padded so
+// that the next header is aligned.
+struct Spilled_instance_header {
+    std::uint64_t store_id;
+    std::uint64_t index;
+    std::uint64_t size;
+};
+
+std::size_t get_padded_size(std::size_t size) noexcept
+{
+    constexpr std::size_t alignment = alignof(Spilled_instance_header);
+
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+Spilled_instance_reader::Spilled_instance_reader(const Data_reader_params &params,
+                                                 std::unique_ptr<Instance_reader> &&inner)
+    : params_{&params}, inner_{std::move(inner)}
+{
+    std::size_t num_buckets = params_->num_shuffle_spill_buckets;
+    if (num_buckets == 0) {
+        num_buckets = default_num_buckets;
+    }
+
+    buckets_.reserve(num_buckets);
+    for (std::size_t i = 0; i < num_buckets; i++) {
+        buckets_.emplace_back(make_intrusive<File_backed_memory_block>(
+            std::size_t{0}, params_->shuffle_spill_directory));
+    }
+
+    buffer_.reserve(first_epoch_window);
+
+    if (params_->shuffle_seed != std::nullopt) {
+        seed_ = *params_->shuffle_seed;
+
+        engine_.seed(seed_);
+    }
+}
+
+std::optional<Instance> Spilled_instance_reader::read_instance_core()
+{
+    if (spilled_) {
+        return read_from_buckets();
+    }
+    return read_and_spill();
+}
+
+std::optional<Instance> Spilled_instance_reader::read_and_spill()
+{
+    while (inner_has_instance_ && buffer_.size() < first_epoch_window) {
+        std::optional<Instance> instance = inner_->read_instance();
+        if (instance == std::nullopt) {
+            inner_has_instance_ = false;
+
+            break;
+        }
+
+        spill(*instance);
+
+        buffer_.emplace_back(std::move(*instance));
+    }
+
+    if (buffer_.empty()) {
+        return {};
+    }
+
+    std::size_t random_idx = bounded_random(engine_, buffer_.size());
+
+    std::swap(buffer_[random_idx], buffer_.back());
+
+    Instance instance = std::move(buffer_.back());
+
+    buffer_.pop_back();
+
+    return instance;
+}
+
+void Spilled_instance_reader::spill(const Instance &instance)
+{
+    const Data_store *store = &instance.data_store();
+
+    auto [pos, inserted] = store_ids_.try_emplace(store, stores_.size());
+    if (inserted) {
+        stores_.emplace_back(store);
+    }
+
+    const Memory_slice &bits = instance.bits();
+
+    Spilled_instance_header hdr{pos->second, instance.index(), bits.size()};
+
+    std::size_t bucket_idx = bounded_random(engine_, buckets_.size());
+
+    Mutable_memory_block &bucket = *buckets_[bucket_idx];
+
+    std::size_t offset = bucket.size();
+
+    // The block grows geometrically, so appending is amortized.
+    bucket.resize(offset + sizeof(hdr) + get_padded_size(bits.size()));
+
+    std::memcpy(bucket.data() + offset, &hdr, sizeof(hdr));
+    if (!bits.empty()) {
+        std::memcpy(bucket.data() + offset + sizeof(hdr), bits.data(), bits.size());
+    }
+}
+
+std::optional<Instance> Spilled_instance_reader::read_from_buckets()
+{
+    if (buffer_.empty() && !load_next_bucket()) {
+        return {};
+    }
+
+    Instance instance = std::move(buffer_.back());
+
+    buffer_.pop_back();
+
+    return instance;
+}
+
+bool Spilled_instance_reader::load_next_bucket()
+{
+    if (bucket_order_.empty()) {
+        bucket_order_.resize(buckets_.size());
+
+        std::iota(bucket_order_.begin(), bucket_order_.end(), 0);
+
+        random_shuffle(bucket_order_.begin(), bucket_order_.end(), engine_);
+    }
+
+    while (next_bucket_ < bucket_order_.size()) {
+        const Intrusive_ptr<Mutable_memory_block> &bucket = buckets_[bucket_order_[next_bucket_++]];
+        if (bucket->size() == 0) {
+            continue;
+        }
+
+        // The bucket is read as a whole; let the kernel read it ahead.
+        ::madvise(bucket->data(), bucket->size(), MADV_WILLNEED);
+
+        Memory_slice bits{bucket};
+
+        while (!bits.empty()) {
+            Spilled_instance_header hdr{};
+
+            std::memcpy(&hdr, bits.data(), sizeof(hdr));
+
+            bits = std::move(bits).subslice(sizeof(hdr));
+
+            buffer_.emplace_back(*stores_[hdr.store_id], hdr.index, bits.subslice(0, hdr.size));
+
+            bits = std::move(bits).subslice(get_padded_size(hdr.size));
+        }
+
+        random_shuffle(buffer_.begin(), buffer_.end(), engine_);
+
+        return true;
+    }
+
+    return false;
+}
+
+void Spilled_instance_reader::clear_buckets() noexcept
+{
+    for (auto &bucket : buckets_) {
+        try {
+            bucket->resize(0);
+        }
+        catch (const std::exception &e) {
+            logger::warn("A shuffle spill bucket cannot be cleared: {0}", e.what());
+        }
+    }
+
+    stores_.clear();
+
+    store_ids_.clear();
+}
+
+void Spilled_instance_reader::reset_core() noexcept
+{
+    buffer_.clear();
+
+    if (!spilled_) {
+        // If the first epoch has been read to its end, the buckets hold
+        // the whole dataset; otherwise we start over.
+        if (inner_has_instance_) {
+            clear_buckets();
+
+            inner_->reset();
+        }
+        else {
+            spilled_ = true;
+
+            logger::info("The dataset has been spilled into {0:n} shuffle bucket(s).",
+                         buckets_.size());
+        }
+    }
+
+    inner_has_instance_ = true;
+
+    bucket_order_.clear();
+
+    next_bucket_ = 0;
+
+    // Make sure that we reset the random number generator engine to
+    // its initial state if reshuffling is not requested.
+    if (!params_->reshuffle_each_epoch) {
+        engine_.seed(seed_);
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "mlio/detail/random.h"
+#include "mlio/fwd.h"
+#include "mlio/instance.h"
+#include "mlio/instance_readers/instance_reader.h"
+#include "mlio/instance_readers/instance_reader_base.h"
+#include "mlio/intrusive_ptr.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Shuffles the whole dataset without holding it in memory. During the
+// first epoch the instances are spilled into randomly chosen bucket
+// files while being served through a small shuffle window; the later
+// epochs read the buckets in random order and shuffle each of them in
+// memory.
+class Spilled_instance_reader final : public Instance_reader_base {
+public:
+    explicit Spilled_instance_reader(const Data_reader_params &params,
+                                     std::unique_ptr<Instance_reader> &&inner);
+
+private:
+    std::optional<Instance> read_instance_core() final;
+
+    std::optional<Instance> read_and_spill();
+
+    void spill(const Instance &instance);
+
+    std::optional<Instance> read_from_buckets();
+
+    bool load_next_bucket();
+
+    void clear_buckets() noexcept;
+
+    void reset_core() noexcept final;
+
+    const Data_reader_params *params_;
+    std::unique_ptr<Instance_reader> inner_;
+    std::vector<Intrusive_ptr<Mutable_memory_block>> buckets_{};
+    // The data stores of the spilled instances; the buckets refer to
+    // them by their position.
+    std::vector<const Data_store *> stores_{};
+    std::unordered_map<const Data_store *, std::uint64_t> store_ids_{};
+    // Holds the shuffle window during the first epoch, and the rest of
+    // the current bucket afterwards.
+    std::vector<Instance> buffer_{};
+    std::vector<std::size_t> bucket_order_{};
+    std::size_t next_bucket_{};
+    bool spilled_{};
+    bool inner_has_instance_ = true;
+    std::random_device rd_{};
+    std::uint_fast64_t seed_{rd_()};
+    Xoshiro256pp engine_{seed_};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
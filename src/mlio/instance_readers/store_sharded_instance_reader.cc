@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/instance_readers/store_sharded_instance_reader.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/data_stores/data_store.h"
+#include "mlio/instance.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Store_sharded_instance_reader::Store_sharded_instance_reader(const Data_reader_params &params,
+                                                             Record_reader_factory &&factory,
+                                                             Store_metrics *metrics)
+    : params_{&params}, record_reader_factory_{std::move(factory)}, metrics_{metrics}
+{
+    if (params_->shard_index >= params_->num_shards) {
+        throw std::invalid_argument{"The shard index must be less than the number of shards."};
+    }
+
+    std::size_t total_size = 0;
+    std::size_t num_known_sizes = 0;
+
+    store_weights_.reserve(params_->dataset.size());
+
+    for (const Intrusive_ptr<Data_store> &store : params_->dataset) {
+        std::optional<std::size_t> size = store->size_hint();
+        if (size) {
+            total_size += *size;
+
+            num_known_sizes++;
+        }
+        store_weights_.emplace_back(size.value_or(0));
+    }
+
+    // Data stores with an unknown size are assumed to be of average
+    // size; if no size is known at all, we balance by store count.
+    std::size_t default_weight = 1;
+    if (num_known_sizes > 0) {
+        default_weight = std::max(total_size / num_known_sizes, std::size_t{1});
+    }
+
+    for (std::size_t i = 0; i < store_weights_.size(); i++) {
+        if (!params_->dataset[i]->size_hint()) {
+            store_weights_[i] = default_weight;
+        }
+    }
+}
+
+std::optional<Instance> Store_sharded_instance_reader::read_instance_core()
+{
+    if (inner_ == nullptr) {
+        init_inner();
+    }
+
+    return inner_->read_instance();
+}
+
+std::size_t Store_sharded_instance_reader::skip_instances_core(std::size_t num_instances)
+{
+    if (inner_ == nullptr) {
+        init_inner();
+    }
+
+    return inner_->skip_instances(num_instances);
+}
+
+void Store_sharded_instance_reader::reset_core() noexcept
+{
+    // Without a seed the plan never changes; there is no need to
+    // construct a new inner reader.
+    if (params_->shard_seed == std::nullopt) {
+        if (inner_ != nullptr) {
+            inner_->reset();
+        }
+        return;
+    }
+
+    inner_view_ = nullptr;
+
+    inner_ = nullptr;
+
+    epoch_++;
+}
+
+void Store_sharded_instance_reader::init_inner()
+{
+    inner_params_ = *params_;
+
+    inner_params_.dataset.clear();
+
+    for (std::size_t store_idx : plan_shard()) {
+        inner_params_.dataset.emplace_back(params_->dataset[store_idx]);
+    }
+
+    inner_params_.num_shards = 0;
+    inner_params_.shard_index = 0;
+
+    // The instances are materialized on top of this reader, if at all.
+    inner_params_.materialize_memory_budget = 0;
+
+    // Since the inner reader is constructed from scratch each epoch,
+    // derive a new shuffle seed to keep reshuffling the instances.
+    if (params_->shuffle_seed && params_->reshuffle_each_epoch) {
+        inner_params_.shuffle_seed = *params_->shuffle_seed + epoch_;
+    }
+
+    Record_reader_factory factory = record_reader_factory_;
+
+    inner_ = make_instance_reader(inner_params_, std::move(factory), metrics_);
+
+    inner_view_ = inner_.get();
+}
+
+std::size_t Store_sharded_instance_reader::shuffle_buffer_size() const noexcept
+{
+    const Instance_reader *inner = inner_view_.load();
+    if (inner == nullptr) {
+        return 0;
+    }
+    return inner->shuffle_buffer_size();
+}
+
+std::vector<std::size_t> Store_sharded_instance_reader::plan_shard() const
+{
+    std::vector<std::size_t> order(store_weights_.size());
+
+    std::iota(order.begin(), order.end(), 0);
+
+    if (params_->shard_seed == std::nullopt) {
+        // Assigning the largest data stores first gives the best
+        // balance for a fixed plan.
+        std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+            return store_weights_[a] > store_weights_[b];
+        });
+    }
+    else {
+        // Use our own Fisher-Yates shuffle instead of std::shuffle; its
+        // algorithm is implementation-defined and all shards must come
+        // up with the same plan.
+        std::mt19937_64 mt{*params_->shard_seed + epoch_ * 0x9e37'79b9'7f4a'7c15};
+
+        for (std::size_t i = order.size(); i > 1; i--) {
+            std::swap(order[i - 1], order[mt() % i]);
+        }
+    }
+
+    // Greedily assign each data store to the least loaded shard; ties
+    // are broken by the shard index.
+    using Shard_load = std::pair<std::size_t, std::size_t>;
+
+    std::priority_queue<Shard_load, std::vector<Shard_load>, std::greater<>> loads{};
+    for (std::size_t i = 0; i < params_->num_shards; i++) {
+        loads.emplace(0, i);
+    }
+
+    std::vector<std::size_t> store_idxs{};
+
+    for (std::size_t store_idx : order) {
+        auto [load, shard_index] = loads.top();
+
+        loads.pop();
+
+        if (shard_index == params_->shard_index) {
+            store_idxs.emplace_back(store_idx);
+        }
+
+        loads.emplace(load + store_weights_[store_idx], shard_index);
+    }
+
+    // Read the data stores of the shard in dataset order.
+    std::sort(store_idxs.begin(), store_idxs.end());
+
+    return store_idxs;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "mlio/data_reader.h"
+#include "mlio/fwd.h"
+#include "mlio/instance_readers/instance_reader.h"
+#include "mlio/instance_readers/instance_reader_base.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Assigns whole data stores to shards, balanced by their size hints,
+// so that each shard opens only its own data stores. If a shard seed
+// is specified, the assignment is re-planned for every epoch; since the
+// plan depends only on the seed and the epoch number, all shards agree
+// on it without any coordination.
+class Store_sharded_instance_reader final : public Instance_reader_base {
+public:
+    explicit Store_sharded_instance_reader(const Data_reader_params &params,
+                                           Record_reader_factory &&factory,
+                                           Store_metrics *metrics);
+
+    std::size_t shuffle_buffer_size() const noexcept final;
+
+private:
+    std::optional<Instance> read_instance_core() final;
+
+    std::size_t skip_instances_core(std::size_t num_instances) final;
+
+    void reset_core() noexcept final;
+
+    void init_inner();
+
+    std::vector<std::size_t> plan_shard() const;
+
+    const Data_reader_params *params_;
+    Record_reader_factory record_reader_factory_;
+    Store_metrics *metrics_;
+    std::vector<std::size_t> store_weights_{};
+    Data_reader_params inner_params_{};
+    std::unique_ptr<Instance_reader> inner_{};
+    std::atomic<const Instance_reader *> inner_view_{};
+    std::size_t epoch_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
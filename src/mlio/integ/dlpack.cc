@@ -19,6 +19,8 @@
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <dlpack/dlpack.h>
 
@@ -38,6 +40,9 @@ inline ::DLDeviceType as_dl_device(Device_kind knd)
     if (knd == Device_kind::cpu()) {
         return ::kDLCPU;
     }
+    if (knd == Device_kind::cuda()) {
+        return ::kDLGPU;
+    }
 
     throw Not_supported_error{"The device kind is not supported by DLPack."};
 }
@@ -47,12 +52,15 @@ inline ::DLContext as_dl_context(Device dev)
     return ::DLContext{as_dl_device(dev.kind()), static_cast<int>(dev.id())};
 }
 
+// The type code of bfloat16 (kDLBfloat) was added in DLPack 0.3; we
+// still build against older versions whose DLDataTypeCode cannot hold
+// it, so it is written straight into DLDataType::code.
+constexpr std::uint8_t dl_bfloat_code = 4U;
+
 template<Data_type dt>
-inline ::DLDataType as_dl_data_type(::DLDataTypeCode code)
+inline ::DLDataType as_dl_data_type(std::uint8_t code)
 {
-    auto uint_code = static_cast<std::uint8_t>(code);
-
-    return ::DLDataType{uint_code, CHAR_BIT * sizeof(data_type_t<dt>), 1};
+    return ::DLDataType{code, CHAR_BIT * sizeof(data_type_t<dt>), 1};
 }
 
 // clang-format off
@@ -87,6 +95,12 @@ as_dl_data_type(Data_type dt)
         return as_dl_data_type<Data_type::uint64> (::kDLUInt);
     case Data_type::string:
         throw Not_supported_error{"The string data type is not supported by DLPack."};
+    case Data_type::bfloat16:
+        return as_dl_data_type<Data_type::bfloat16>(dl_bfloat_code);
+    case Data_type::timestamp:
+        return as_dl_data_type<Data_type::timestamp>(::kDLInt);
+    case Data_type::date:
+        return as_dl_data_type<Data_type::date>(::kDLInt);
     }
 
     throw Not_supported_error{"The tensor has an unknown data type."};
@@ -169,6 +183,89 @@ void as_dlpack_op::visit(Dense_tensor &tensor)
     mt = &ctx.release()->mt;
 }
 
+// Keeps the tensor alive for a DLManagedTensor that wraps one of its
+// component arrays.
+struct dl_pack_component_context {
+    Intrusive_ptr<Tensor> tensor{};
+    std::int64_t shape{};
+    ::DLManagedTensor mt{};
+};
+
+struct Dlpack_deleter {
+    void operator()(::DLManagedTensor *mt) const noexcept
+    {
+        mt->deleter(mt);
+    }
+};
+
+using Dlpack_ptr = std::unique_ptr<::DLManagedTensor, Dlpack_deleter>;
+
+Dlpack_ptr wrap_component(Tensor &tensor, Device_array_view arr, bool is_index = false)
+{
+    auto ctx = std::make_unique<dl_pack_component_context>();
+
+    ctx->tensor = wrap_intrusive(&tensor, true);
+    ctx->shape = static_cast<std::int64_t>(arr.size());
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    ctx->mt.dl_tensor.data = const_cast<void *>(arr.data());
+    ctx->mt.dl_tensor.ctx = as_dl_context(arr.device());
+    ctx->mt.dl_tensor.dtype = as_dl_data_type(arr.data_type());
+    ctx->mt.dl_tensor.ndim = 1;
+
+    // Most frameworks expect signed indices and do not support unsigned
+    // 64-bit integers.
+    if (is_index && arr.data_type() == Data_type::size) {
+        ctx->mt.dl_tensor.dtype.code = static_cast<std::uint8_t>(::kDLInt);
+    }
+
+    ctx->mt.dl_tensor.shape = &ctx->shape;
+    ctx->mt.dl_tensor.strides = nullptr;
+    ctx->mt.dl_tensor.byte_offset = 0;
+
+    ctx->mt.manager_ctx = ctx.get();
+
+    ctx->mt.deleter = [](::DLManagedTensor *self) {
+        if (self->manager_ctx != nullptr) {
+            delete static_cast<dl_pack_component_context *>(self->manager_ctx);
+        }
+    };
+
+    return Dlpack_ptr{&ctx.release()->mt};
+}
+
+struct as_dlpack_components_op : public Tensor_visitor {
+    using Tensor_visitor::visit;
+
+    void visit(Tensor &) override
+    {
+        throw std::invalid_argument{
+            "DLPack components are only supported for COO and CSR tensors."};
+    }
+
+    void visit(Coo_tensor &tensor) override;
+
+    void visit(Csr_tensor &tensor) override;
+
+    std::vector<Dlpack_ptr> mts{};
+};
+
+void as_dlpack_components_op::visit(Coo_tensor &tensor)
+{
+    mts.emplace_back(wrap_component(tensor, tensor.data()));
+
+    for (std::size_t dim = 0; dim < tensor.shape().size(); dim++) {
+        mts.emplace_back(wrap_component(tensor, tensor.indices(dim), true));
+    }
+}
+
+void as_dlpack_components_op::visit(Csr_tensor &tensor)
+{
+    mts.emplace_back(wrap_component(tensor, tensor.data()));
+    mts.emplace_back(wrap_component(tensor, tensor.indices(), true));
+    mts.emplace_back(wrap_component(tensor, tensor.indptr(), true));
+}
+
 }  // namespace
 }  // namespace detail
 
@@ -189,5 +286,29 @@ void as_dlpack_op::visit(Dense_tensor &tensor)
 #endif
 }
 
+std::vector<::DLManagedTensor *> as_dlpack_components(Tensor &tensor, std::size_t version)
+{
+#if SIZE_MAX != UINT64_MAX
+    throw Not_supported_error{"DLPack is only supported on 64-bit platforms."};
+#else
+    if (version != DLPACK_VERSION) {
+        throw Not_supported_error{"The requested DLPack version is not supported."};
+    }
+
+    detail::as_dlpack_components_op op{};
+
+    tensor.accept(op);
+
+    std::vector<::DLManagedTensor *> mts{};
+    mts.reserve(op.mts.size());
+
+    for (detail::Dlpack_ptr &mt : op.mts) {
+        mts.emplace_back(mt.release());
+    }
+
+    return mts;
+#endif
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
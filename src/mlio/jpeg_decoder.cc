@@ -0,0 +1,296 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/jpeg_decoder.h"
+
+#ifdef MLIO_BUILD_JPEG_TURBO
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <jpeglib.h>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::size_t max_marker_size = 0xFFFF;
+
+struct Error_manager {
+    ::jpeg_error_mgr pub{};
+    std::jmp_buf jmp{};
+};
+
+// libjpeg calls std::exit() on errors by default; we jump back to the
+// decoder instead and report the failure to the caller.
+[[noreturn]] void error_exit(::j_common_ptr cinfo)
+{
+    auto *err = reinterpret_cast<Error_manager *>(cinfo->err);
+
+    std::longjmp(err->jmp, 1);
+}
+
+// Corrupt data warnings are handled by the caller via the return value
+// of the decoder; there is no need to write them to stderr.
+void output_message(::j_common_ptr)
+{}
+
+std::uint16_t read_uint16(const std::uint8_t *pos, bool big_endian) noexcept
+{
+    if (big_endian) {
+        return static_cast<std::uint16_t>((pos[0] << 8) | pos[1]);
+    }
+    return static_cast<std::uint16_t>((pos[1] << 8) | pos[0]);
+}
+
+std::uint32_t read_uint32(const std::uint8_t *pos, bool big_endian) noexcept
+{
+    if (big_endian) {
+        return (std::uint32_t{read_uint16(pos, true)} << 16) | read_uint16(pos + 2, true);
+    }
+    return (std::uint32_t{read_uint16(pos + 2, false)} << 16) | read_uint16(pos, false);
+}
+
+// Returns the value of the orientation tag in the 0th IFD of the
+// specified EXIF (APP1) marker, or 1 if it has no such tag.
+int read_exif_orientation(const std::uint8_t *data, std::size_t size) noexcept
+{
+    constexpr std::size_t exif_header_size = 6;
+    constexpr std::size_t tiff_header_size = 8;
+    constexpr std::size_t ifd_entry_size = 12;
+
+    constexpr std::uint16_t orientation_tag = 0x0112;
+    constexpr std::uint16_t short_type = 3;
+
+    if (size < exif_header_size + tiff_header_size ||
+        std::memcmp(data, "Exif\0\0", exif_header_size) != 0) {
+        return 1;
+    }
+
+    const std::uint8_t *tiff = data + exif_header_size;
+
+    std::size_t tiff_size = size - exif_header_size;
+
+    bool big_endian{};
+    if (std::memcmp(tiff, "MM\0*", 4) == 0) {
+        big_endian = true;
+    }
+    else if (std::memcmp(tiff, "II*\0", 4) != 0) {
+        return 1;
+    }
+
+    std::size_t ifd_offset = read_uint32(tiff + 4, big_endian);
+    if (ifd_offset > tiff_size - 2) {
+        return 1;
+    }
+
+    std::size_t num_entries = read_uint16(tiff + ifd_offset, big_endian);
+
+    const std::uint8_t *entry = tiff + ifd_offset + 2;
+
+    num_entries = std::min(num_entries,
+                           (tiff_size - ifd_offset - 2) / ifd_entry_size);
+
+    for (std::size_t i = 0; i < num_entries; i++, entry += ifd_entry_size) {
+        if (read_uint16(entry, big_endian) != orientation_tag) {
+            continue;
+        }
+
+        if (read_uint16(entry + 2, big_endian) != short_type) {
+            return 1;
+        }
+
+        // A single SHORT value is stored left-justified in the value
+        // offset field.
+        return read_uint16(entry + 8, big_endian);
+    }
+
+    return 1;
+}
+
+}  // namespace
+
+struct Jpeg_decoder::Impl {
+    ::jpeg_decompress_struct cinfo{};
+    Error_manager err{};
+    std::vector<std::uint8_t> row{};
+};
+
+Jpeg_decoder::Jpeg_decoder() : impl_{std::make_unique<Impl>()}
+{
+    ::jpeg_decompress_struct &cinfo = impl_->cinfo;
+
+    cinfo.err = ::jpeg_std_error(&impl_->err.pub);
+
+    impl_->err.pub.error_exit = error_exit;
+    impl_->err.pub.output_message = output_message;
+
+    ::jpeg_create_decompress(&cinfo);
+}
+
+Jpeg_decoder::~Jpeg_decoder()
+{
+    ::jpeg_destroy_decompress(&impl_->cinfo);
+}
+
+bool Jpeg_decoder::read_header(Memory_span bits, Jpeg_info &info)
+{
+    ::jpeg_decompress_struct &cinfo = impl_->cinfo;
+
+    // The previous image might have been read only up to its header; a
+    // decoder is reused across images.
+    ::jpeg_abort_decompress(&cinfo);
+
+    if (setjmp(impl_->err.jmp) != 0) {
+        ::jpeg_abort_decompress(&cinfo);
+
+        return false;
+    }
+
+    ::jpeg_mem_src(&cinfo,
+                   reinterpret_cast<const unsigned char *>(bits.data()),
+                   static_cast<unsigned long>(bits.size()));
+
+    ::jpeg_save_markers(&cinfo, JPEG_APP0 + 1, max_marker_size);
+
+    if (::jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        ::jpeg_abort_decompress(&cinfo);
+
+        return false;
+    }
+
+    info.width = cinfo.image_width;
+    info.height = cinfo.image_height;
+    info.num_components = static_cast<std::size_t>(cinfo.num_components);
+    info.orientation = 1;
+
+    for (::jpeg_saved_marker_ptr m = cinfo.marker_list; m != nullptr; m = m->next) {
+        if (m->marker == JPEG_APP0 + 1) {
+            info.orientation = read_exif_orientation(m->data, m->data_length);
+            if (info.orientation != 1) {
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Jpeg_decoder::decode(Jpeg_color_space color_space,
+                          unsigned int scale_denom,
+                          const Jpeg_region &region,
+                          stdx::span<std::uint8_t> destination,
+                          std::size_t row_stride)
+{
+    ::jpeg_decompress_struct &cinfo = impl_->cinfo;
+
+    if (setjmp(impl_->err.jmp) != 0) {
+        ::jpeg_abort_decompress(&cinfo);
+
+        return false;
+    }
+
+    switch (color_space) {
+    case Jpeg_color_space::grayscale:
+        cinfo.out_color_space = JCS_GRAYSCALE;
+        break;
+    case Jpeg_color_space::bgr:
+        cinfo.out_color_space = JCS_EXT_BGR;
+        break;
+    case Jpeg_color_space::rgb:
+        cinfo.out_color_space = JCS_RGB;
+        break;
+    }
+
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = scale_denom;
+
+    ::jpeg_start_decompress(&cinfo);
+
+    if (region.x + region.width > cinfo.output_width ||
+        region.y + region.height > cinfo.output_height) {
+        ::jpeg_abort_decompress(&cinfo);
+
+        return false;
+    }
+
+    auto num_components = static_cast<std::size_t>(cinfo.output_components);
+
+    // Fancy upsampling of the chroma components reads the neighbouring
+    // pixels; widen the crop by one pixel on each side so that the edge
+    // pixels of the region come out the same as in a full decode.
+    std::size_t crop_beg = region.x > 0 ? region.x - 1 : 0;
+    std::size_t crop_end = std::min(region.x + region.width + 1,
+                                    std::size_t{cinfo.output_width});
+
+    auto x_offset = static_cast<JDIMENSION>(crop_beg);
+    auto width = static_cast<JDIMENSION>(crop_end - crop_beg);
+
+    // jpeg_crop_scanline() aligns the left edge of the crop to the
+    // boundary of an iMCU, and widens it accordingly.
+    if (width != cinfo.output_width) {
+        ::jpeg_crop_scanline(&cinfo, &x_offset, &width);
+    }
+
+    if (region.y > 0) {
+        ::jpeg_skip_scanlines(&cinfo, static_cast<JDIMENSION>(region.y));
+    }
+
+    std::size_t row_offset = (region.x - x_offset) * num_components;
+    std::size_t row_size = region.width * num_components;
+
+    bool needs_row_buffer = width != region.width;
+    if (needs_row_buffer) {
+        impl_->row.resize(std::size_t{width} * num_components);
+    }
+
+    std::uint8_t *dst = destination.data();
+
+    for (std::size_t i = 0; i < region.height; i++, dst += row_stride) {
+        JSAMPROW row = needs_row_buffer ? impl_->row.data() : dst;
+
+        if (::jpeg_read_scanlines(&cinfo, &row, 1) != 1) {
+            ::jpeg_abort_decompress(&cinfo);
+
+            return false;
+        }
+
+        if (needs_row_buffer) {
+            std::copy_n(impl_->row.data() + row_offset, row_size, dst);
+        }
+    }
+
+    // We might not have read all the scanlines; jpeg_finish_decompress()
+    // would treat that as an error.
+    ::jpeg_abort_decompress(&cinfo);
+
+    return true;
+}
+
+bool is_jpeg(Memory_span bits) noexcept
+{
+    return bits.size() >= 3 && bits[0] == std::byte{0xFF} && bits[1] == std::byte{0xD8} &&
+           bits[2] == std::byte{0xFF};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+enum class Jpeg_color_space { grayscale, bgr, rgb };
+
+struct Jpeg_info {
+    std::size_t width{};
+    std::size_t height{};
+    std::size_t num_components{};
+    /// The EXIF orientation of the image; 1 if the image has no
+    /// orientation tag.
+    int orientation = 1;
+};
+
+/// Specifies a rectangular region of a decoded image.
+struct Jpeg_region {
+    std::size_t x{};
+    std::size_t y{};
+    std::size_t width{};
+    std::size_t height{};
+};
+
+/// Decodes JPEG images with libjpeg-turbo.
+///
+/// Unlike a generic image codec the decoder can perform the inverse
+/// DCT at a reduced scale, and can decode only a region of the image,
+/// skipping the entropy decoding and IDCT of the rows and most of the
+/// columns outside of that region.
+class Jpeg_decoder {
+public:
+    Jpeg_decoder();
+
+    Jpeg_decoder(const Jpeg_decoder &) = delete;
+
+    Jpeg_decoder &operator=(const Jpeg_decoder &) = delete;
+
+    Jpeg_decoder(Jpeg_decoder &&) = delete;
+
+    Jpeg_decoder &operator=(Jpeg_decoder &&) = delete;
+
+    ~Jpeg_decoder();
+
+    /// Reads the header of the specified JPEG image. Returns false if
+    /// @p bits does not contain a valid JPEG image. @p bits must stay
+    /// alive until the image is decoded.
+    bool read_header(Memory_span bits, Jpeg_info &info);
+
+    /// Decodes @p region of the image, scaled by 1/@p scale_denom, into
+    /// @p destination. The region is specified in the coordinates of
+    /// the scaled image. Returns false if the image cannot be decoded.
+    ///
+    /// @param scale_denom
+    ///     One of 1, 2, 4, or 8.
+    /// @param row_stride
+    ///     The number of bytes between two consecutive rows in
+    ///     @p destination.
+    bool decode(Jpeg_color_space color_space,
+                unsigned int scale_denom,
+                const Jpeg_region &region,
+                stdx::span<std::uint8_t> destination,
+                std::size_t row_stride);
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+/// Returns a boolean value indicating whether @p bits starts with a JPEG
+/// start-of-image marker.
+bool is_jpeg(Memory_span bits) noexcept;
+
+/// Returns the size of a dimension of length @p size after it has been
+/// scaled by 1/@p scale_denom during decoding.
+inline std::size_t scale_jpeg_dimension(std::size_t size, unsigned int scale_denom) noexcept
+{
+    return (size + scale_denom - 1) / scale_denom;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,916 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/json_lines_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/decode_warning_log.h"
+#include "mlio/detail/json_parser.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/logger.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/text_line_record_reader.h"
+#include "mlio/schema.h"
+#include "mlio/streams/utf8_input_stream.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/string.h"
+
+using mlio::detail::Json_kind;
+using mlio::detail::Json_parser;
+using mlio::detail::Text_line_record_reader;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// Returns the narrowest of the types returned by infer_data_type() that
+// can represent the values of both types.
+Data_type widen_data_type(Data_type lhs, Data_type rhs) noexcept
+{
+    if (lhs == rhs) {
+        return lhs;
+    }
+    if (lhs == Data_type::string || rhs == Data_type::string) {
+        return Data_type::string;
+    }
+    return Data_type::float64;
+}
+
+bool is_number_data_type(Data_type dt) noexcept
+{
+    return dt == Data_type::int64 || dt == Data_type::uint64 || dt == Data_type::float64;
+}
+
+template<Data_type dt>
+struct Reset_tail_op {
+    void operator()(Device_array_span arr, std::size_t offset) const
+    {
+        auto values = arr.as<data_type_t<dt>>();
+
+        std::fill(values.begin() + as_ssize(offset), values.end(), data_type_t<dt>{});
+    }
+};
+
+// Builds a COO tensor out of the elements of the good rows; the row
+// coordinates are the indices of the rows after the bad ones are left
+// out.
+template<Data_type dt>
+struct Make_coo_tensor_op {
+    Intrusive_ptr<Tensor> operator()(Size_vector shape,
+                                     Device_array &elements,
+                                     stdx::span<const std::size_t> lengths,
+                                     stdx::span<const Row_state> row_states) const
+    {
+        using T = data_type_t<dt>;
+
+        auto src = as_span<T>(elements);
+
+        std::size_t stride = shape[1];
+
+        std::size_t nnz = 0;
+        for (std::size_t i = 0; i < row_states.size(); i++) {
+            if (row_states[i] == Row_state::good) {
+                nnz += lengths[i];
+            }
+        }
+
+        std::vector<T> data{};
+        data.reserve(nnz);
+
+        std::vector<std::size_t> rows{};
+        rows.reserve(nnz);
+
+        std::vector<std::size_t> cols{};
+        cols.reserve(nnz);
+
+        std::size_t row_idx = 0;
+        for (std::size_t i = 0; i < row_states.size(); i++) {
+            if (row_states[i] != Row_state::good) {
+                continue;
+            }
+
+            for (std::size_t j = 0; j < lengths[i]; j++) {
+                data.emplace_back(std::move(src[i * stride + j]));
+
+                rows.emplace_back(row_idx);
+                cols.emplace_back(j);
+            }
+
+            row_idx++;
+        }
+
+        std::vector<std::unique_ptr<Device_array>> coords{};
+        coords.reserve(2);
+
+        coords.emplace_back(wrap_cpu_array<Data_type::size>(std::move(rows)));
+        coords.emplace_back(wrap_cpu_array<Data_type::size>(std::move(cols)));
+
+        return make_intrusive<Coo_tensor>(
+            std::move(shape), wrap_cpu_array<dt>(std::move(data)), std::move(coords));
+    }
+};
+
+}  // namespace
+}  // namespace detail
+
+// Holds what the type inference has seen of a field in the sampled rows.
+struct Json_lines_reader::Field_stats {
+    void add_data_type(std::optional<Data_type> dt) noexcept
+    {
+        if (dt) {
+            data_type = data_type ? detail::widen_data_type(*data_type, *dt) : *dt;
+        }
+    }
+
+    std::string name;
+    std::optional<Data_type> data_type{};
+    bool is_array{};
+    // Indicates whether the field holds an object or an array of arrays
+    // or objects.
+    bool is_nested{};
+    std::size_t array_length{};
+};
+
+class Json_lines_reader::Decoder {
+public:
+    explicit Decoder(const Json_lines_reader &reader,
+                     std::vector<Device_array *> &arrays,
+                     std::vector<std::vector<std::size_t>> &lengths,
+                     std::vector<Row_state> &row_states,
+                     detail::Decode_warning_log &warnings) noexcept
+        : reader_{&reader}
+        , arrays_{&arrays}
+        , lengths_{&lengths}
+        , row_states_{&row_states}
+        , warnings_{&warnings}
+    {}
+
+    // Decodes the row of the specified instance into the slot of the
+    // specified index.
+    bool decode(std::size_t row_idx, const Instance &instance);
+
+private:
+    bool decode_scalar(Json_parser &parser,
+                       std::size_t row_idx,
+                       std::size_t field_idx,
+                       const Instance &instance);
+
+    bool decode_array(Json_parser &parser,
+                      std::size_t row_idx,
+                      std::size_t field_idx,
+                      const Instance &instance);
+
+    // Reads a scalar value, or returns a null optional if the value is
+    // null. Booleans are read as one or zero.
+    std::optional<std::string_view> read_scalar(Json_parser &parser, Json_kind kind);
+
+    bool parse(std::string_view value,
+               Device_array &arr,
+               std::size_t index,
+               std::size_t field_idx,
+               const Instance &instance);
+
+    std::optional<std::size_t> find_field(std::string_view key) noexcept;
+
+    bool report_corrupt_row(const Instance &instance, std::size_t position);
+
+    bool report_schema_mismatch(const Instance &instance,
+                                std::size_t field_idx,
+                                const char *reason);
+
+    template<typename Format_fn>
+    bool report_bad_instance(detail::Decode_warning_kind kind,
+                             const Instance &instance,
+                             std::size_t field_idx,
+                             Format_fn &&format_message);
+
+    const Json_lines_reader *reader_;
+    std::vector<Device_array *> *arrays_;
+    std::vector<std::vector<std::size_t>> *lengths_;
+    std::vector<Row_state> *row_states_;
+    detail::Decode_warning_log *warnings_;
+    // The index of the last matched field; the fields of a row are most
+    // likely in the same order as the fields of the previous row.
+    std::size_t last_field_idx_ = std::numeric_limits<std::size_t>::max();
+    std::string key_scratch_{};
+    std::string value_scratch_{};
+};
+
+Json_lines_reader::Json_lines_reader(Data_reader_params params, Json_lines_params json_params)
+    : Parallel_data_reader{std::move(params)}, params_{std::move(json_params)}
+{
+    if (params_.num_type_inference_rows == 0) {
+        throw std::invalid_argument{
+            "The number of type inference rows must be greater than zero."};
+    }
+}
+
+Json_lines_reader::~Json_lines_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Json_lines_reader::make_record_reader(const Data_store &store)
+{
+    auto stream = make_utf8_stream(store.open_read());
+
+    return make_intrusive<Text_line_record_reader>(std::move(stream), true);
+}
+
+Intrusive_ptr<const Schema>
+Json_lines_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    std::vector<Memory_slice> rows{};
+    if (instance) {
+        rows.emplace_back(instance->bits());
+    }
+
+    if (params_.num_type_inference_rows > 1) {
+        std::vector<Memory_slice> sampled_rows = sample_rows();
+
+        std::move(sampled_rows.begin(), sampled_rows.end(), std::back_inserter(rows));
+    }
+
+    std::vector<Field_stats> stats{};
+
+    std::unordered_map<std::string, std::size_t> stats_indices{};
+
+    // If the fields are specified, only those are inspected.
+    for (const std::string &name : params_.fields) {
+        if (stats_indices.find(name) != stats_indices.end()) {
+            throw std::invalid_argument{
+                fmt::format("The field '{0}' is specified more than once.", name)};
+        }
+
+        stats_indices.emplace(name, stats.size());
+
+        stats.emplace_back(Field_stats{name});
+    }
+
+    std::string key_scratch{};
+    std::string value_scratch{};
+
+    // Infers the data type of a scalar value; returns a null optional
+    // for a null value.
+    auto infer_scalar = [&value_scratch](Json_parser &parser, Json_kind kind) {
+        std::optional<Data_type> dt{};
+
+        std::string_view value{};
+
+        switch (kind) {
+        case Json_kind::null:
+            parser.read_null();
+            break;
+        case Json_kind::boolean: {
+            bool b{};
+            if (parser.read_bool(b)) {
+                dt = Data_type::int64;
+            }
+            break;
+        }
+        case Json_kind::number:
+            if (parser.read_number(value)) {
+                dt = infer_data_type(value);
+            }
+            break;
+        case Json_kind::string:
+            if (parser.read_string(value, value_scratch)) {
+                dt = Data_type::string;
+            }
+            break;
+        case Json_kind::array:
+        case Json_kind::object:
+        case Json_kind::invalid:
+            parser.skip_value();
+            break;
+        }
+
+        return dt;
+    };
+
+    // The malformed rows are left to the decode operation to report.
+    for (const Memory_slice &row : rows) {
+        Json_parser parser{as_string_view(row)};
+        if (!parser.begin_object()) {
+            continue;
+        }
+
+        std::string_view key{};
+        while (parser.next_member(key, key_scratch)) {
+            auto pos = stats_indices.find(std::string{key});
+            if (pos == stats_indices.end()) {
+                if (!params_.fields.empty()) {
+                    parser.skip_value();
+
+                    continue;
+                }
+
+                pos = stats_indices.emplace(std::string{key}, stats.size()).first;
+
+                stats.emplace_back(Field_stats{std::string{key}});
+            }
+
+            Field_stats &field = stats[pos->second];
+
+            Json_kind kind = parser.peek();
+            if (kind == Json_kind::object) {
+                field.is_nested = true;
+
+                parser.skip_value();
+            }
+            else if (kind == Json_kind::array) {
+                field.is_array = true;
+
+                parser.begin_array();
+
+                std::size_t length = 0;
+                while (parser.next_element()) {
+                    length++;
+
+                    Json_kind element_kind = parser.peek();
+                    if (element_kind == Json_kind::object || element_kind == Json_kind::array) {
+                        field.is_nested = true;
+                    }
+
+                    field.add_data_type(infer_scalar(parser, element_kind));
+                }
+
+                field.array_length = std::max(field.array_length, length);
+            }
+            else {
+                field.add_data_type(infer_scalar(parser, kind));
+            }
+
+            if (parser.failed()) {
+                break;
+            }
+        }
+    }
+
+    fields_.clear();
+    fields_.reserve(stats.size());
+
+    for (Field_stats &field : stats) {
+        if (field.is_nested) {
+            // Nested values are only an error if the field is requested
+            // explicitly.
+            if (params_.fields.empty()) {
+                continue;
+            }
+
+            throw Schema_error{fmt::format(
+                "The field '{0}' holds nested JSON objects or arrays which cannot be read.",
+                field.name)};
+        }
+
+        Data_type dt{};
+
+        auto type_pos = params_.field_types.find(field.name);
+        if (type_pos != params_.field_types.end()) {
+            dt = type_pos->second;
+        }
+        else if (field.data_type == std::nullopt) {
+            dt = params_.number_data_type.value_or(Data_type::float64);
+        }
+        else if (params_.number_data_type && detail::is_number_data_type(*field.data_type)) {
+            dt = *params_.number_data_type;
+        }
+        else {
+            dt = *field.data_type;
+        }
+
+        std::size_t array_length = 0;
+
+        auto length_pos = params_.array_lengths.find(field.name);
+        if (length_pos != params_.array_lengths.end()) {
+            if (length_pos->second == 0) {
+                throw std::invalid_argument{fmt::format(
+                    "The length of the array field '{0}' must be greater than zero.", field.name)};
+            }
+            array_length = length_pos->second;
+        }
+        else if (field.is_array) {
+            array_length = std::max(field.array_length, std::size_t{1});
+        }
+
+        fields_.emplace_back(Field{std::move(field.name), dt, array_length});
+    }
+
+    if (fields_.empty()) {
+        throw Schema_error{"No field has been found in the sampled rows of the dataset."};
+    }
+
+    field_indices_.clear();
+
+    parsers_.clear();
+    parsers_.reserve(fields_.size());
+
+    std::vector<Attribute> attrs{};
+    attrs.reserve(fields_.size());
+
+    for (std::size_t i = 0; i < fields_.size(); i++) {
+        const Field &field = fields_[i];
+
+        field_indices_.emplace(field.name, i);
+
+        parsers_.emplace_back(make_parser(field.data_type, Parser_options{}));
+
+        if (field.array_length == 0) {
+            attrs.emplace_back(field.name, field.data_type, Size_vector{params().batch_size, 1});
+        }
+        else {
+            attrs.emplace_back(field.name,
+                               field.data_type,
+                               Size_vector{params().batch_size, field.array_length},
+                               Ssize_vector{},
+                               true);
+        }
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+std::vector<Memory_slice> Json_lines_reader::sample_rows()
+{
+    std::size_t num_rows = params_.num_type_inference_rows - 1;
+
+    std::vector<Memory_slice> rows{};
+    rows.reserve(num_rows);
+
+    // Read the rows from the beginning of the dataset; unless it is
+    // shuffled, this includes the row of the first instance, which
+    // does not affect the result.
+    const std::vector<Intrusive_ptr<Data_store>> &dataset = params().dataset;
+
+    for (auto pos = dataset.begin(); pos < dataset.end() && rows.size() < num_rows; ++pos) {
+        Text_line_record_reader reader{make_utf8_stream((*pos)->open_read()), true};
+
+        while (rows.size() < num_rows) {
+            std::optional<Record> record = reader.read_record();
+            if (record == std::nullopt) {
+                break;
+            }
+
+            rows.emplace_back(record->payload());
+        }
+    }
+
+    return rows;
+}
+
+Intrusive_ptr<Example> Json_lines_reader::decode(const Instance_batch &batch) const
+{
+    std::size_t batch_size = batch.size();
+
+    // Each row is decoded into its own slot; the slots of the bad rows
+    // are left out afterwards. For an array field the slots hold the
+    // elements and the lengths of the arrays.
+    std::vector<std::unique_ptr<Device_array>> arrays{};
+    arrays.reserve(fields_.size());
+
+    std::vector<Device_array *> array_ptrs{};
+    array_ptrs.reserve(fields_.size());
+
+    std::vector<std::vector<std::size_t>> lengths(fields_.size());
+
+    for (std::size_t i = 0; i < fields_.size(); i++) {
+        const Field &field = fields_[i];
+
+        std::size_t size = batch_size;
+        if (field.array_length > 0) {
+            size *= field.array_length;
+
+            lengths[i].resize(batch_size);
+        }
+
+        arrays.emplace_back(make_cpu_array(field.data_type, size));
+
+        array_ptrs.emplace_back(arrays.back().get());
+    }
+
+    stdx::span<const Instance> instances = batch.instances();
+
+    std::size_t num_instances = instances.size();
+
+    std::vector<Row_state> row_states(num_instances);
+
+    detail::Decode_warning_log warnings{};
+
+    bool skip_bad_example = params().bad_example_handling == Bad_example_handling::skip ||
+                            params().bad_example_handling == Bad_example_handling::skip_warn;
+
+    std::atomic_bool skip_example{};
+
+    auto worker = [&, skip_bad_example](const tbb::blocked_range<std::size_t> &range) {
+        Decoder decoder{*this, array_ptrs, lengths, row_states, warnings};
+
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            if (skip_example.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            if (!decoder.decode(i, instances[i]) && skip_bad_example) {
+                skip_example = true;
+            }
+        }
+    };
+
+    tbb::blocked_range<std::size_t> range{0, num_instances, decode_grain_size(fields_.size())};
+
+    if (should_decode_parallel(num_instances, fields_.size())) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(tbb::blocked_range<std::size_t>{0, num_instances});
+    }
+
+    report_decode_warnings(warnings);
+
+    std::size_t num_instances_read = static_cast<std::size_t>(
+        std::count(row_states.begin(), row_states.end(), Row_state::good));
+
+    if (skip_example) {
+        if (params().bad_example_handling == Bad_example_handling::skip_warn) {
+            logger::warn("The example #{0:n} has been skipped as it had at least one bad instance.",
+                         batch.index());
+        }
+
+        return nullptr;
+    }
+
+    if (num_instances != num_instances_read) {
+        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
+            logger::warn("The example #{0:n} has been padded as it had {1:n} bad instance(s).",
+                         batch.index(),
+                         num_instances - num_instances_read);
+        }
+    }
+
+    // The padded rows of a scalar field are left as zero or as an empty
+    // string.
+    row_states.resize(batch_size, Row_state::bad);
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.reserve(fields_.size());
+
+    for (std::size_t i = 0; i < fields_.size(); i++) {
+        const Field &field = fields_[i];
+
+        if (field.array_length == 0) {
+            if (num_instances_read != num_instances) {
+                make_column_parser(field.data_type).compact(*arrays[i], 0, row_states);
+
+                dispatch<detail::Reset_tail_op>(
+                    field.data_type, Device_array_span{*arrays[i]}, num_instances_read);
+            }
+
+            tensors.emplace_back(
+                make_intrusive<Dense_tensor>(Size_vector{batch_size, 1}, std::move(arrays[i])));
+        }
+        else {
+            lengths[i].resize(batch_size);
+
+            tensors.emplace_back(
+                dispatch<detail::Make_coo_tensor_op>(field.data_type,
+                                                     Size_vector{batch_size, field.array_length},
+                                                     *arrays[i],
+                                                     stdx::span<const std::size_t>{lengths[i]},
+                                                     stdx::span<const Row_state>{row_states}));
+        }
+    }
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch_size - num_instances_read;
+
+    return example;
+}
+
+bool Json_lines_reader::Decoder::decode(std::size_t row_idx, const Instance &instance)
+{
+    Row_state &row_state = (*row_states_)[row_idx];
+
+    row_state = Row_state::bad;
+
+    Json_parser parser{as_string_view(instance.bits())};
+
+    if (!parser.begin_object()) {
+        return report_corrupt_row(instance, parser.position());
+    }
+
+    std::string_view key{};
+    while (parser.next_member(key, key_scratch_)) {
+        std::optional<std::size_t> field_idx = find_field(key);
+        if (field_idx == std::nullopt) {
+            if (!parser.skip_value()) {
+                break;
+            }
+            continue;
+        }
+
+        bool ok{};
+        if (reader_->fields_[*field_idx].array_length == 0) {
+            ok = decode_scalar(parser, row_idx, *field_idx, instance);
+        }
+        else {
+            ok = decode_array(parser, row_idx, *field_idx, instance);
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+
+    if (parser.failed() || !parser.at_end()) {
+        return report_corrupt_row(instance, parser.position());
+    }
+
+    row_state = Row_state::good;
+
+    return true;
+}
+
+bool Json_lines_reader::Decoder::decode_scalar(Json_parser &parser,
+                                               std::size_t row_idx,
+                                               std::size_t field_idx,
+                                               const Instance &instance)
+{
+    Json_kind kind = parser.peek();
+    if (kind == Json_kind::object || kind == Json_kind::array) {
+        return report_schema_mismatch(instance, field_idx, "holds an object or an array");
+    }
+
+    std::optional<std::string_view> value = read_scalar(parser, kind);
+    if (parser.failed()) {
+        return report_corrupt_row(instance, parser.position());
+    }
+
+    if (value == std::nullopt) {
+        return true;
+    }
+
+    return parse(*value, *(*arrays_)[field_idx], row_idx, field_idx, instance);
+}
+
+bool Json_lines_reader::Decoder::decode_array(Json_parser &parser,
+                                              std::size_t row_idx,
+                                              std::size_t field_idx,
+                                              const Instance &instance)
+{
+    std::size_t array_length = reader_->fields_[field_idx].array_length;
+
+    std::size_t &length = (*lengths_)[field_idx][row_idx];
+
+    Device_array &arr = *(*arrays_)[field_idx];
+
+    std::size_t offset = row_idx * array_length;
+
+    Json_kind kind = parser.peek();
+    if (kind == Json_kind::object) {
+        return report_schema_mismatch(instance, field_idx, "holds an object");
+    }
+
+    // A scalar is read as an array of a single element.
+    if (kind != Json_kind::array) {
+        std::optional<std::string_view> value = read_scalar(parser, kind);
+        if (parser.failed()) {
+            return report_corrupt_row(instance, parser.position());
+        }
+
+        if (value == std::nullopt) {
+            length = 0;
+
+            return true;
+        }
+
+        length = 1;
+
+        return parse(*value, arr, offset, field_idx, instance);
+    }
+
+    parser.begin_array();
+
+    length = 0;
+    while (parser.next_element()) {
+        if (length == array_length) {
+            return report_schema_mismatch(
+                instance, field_idx, "holds a longer array than its maximum length");
+        }
+
+        Json_kind element_kind = parser.peek();
+        if (element_kind == Json_kind::object || element_kind == Json_kind::array) {
+            return report_schema_mismatch(instance, field_idx, "holds a nested object or array");
+        }
+
+        std::optional<std::string_view> value = read_scalar(parser, element_kind);
+        if (parser.failed()) {
+            break;
+        }
+
+        // A null element is read as zero or as an empty string.
+        if (value && !parse(*value, arr, offset + length, field_idx, instance)) {
+            return false;
+        }
+
+        length++;
+    }
+
+    if (parser.failed()) {
+        return report_corrupt_row(instance, parser.position());
+    }
+
+    return true;
+}
+
+std::optional<std::string_view>
+Json_lines_reader::Decoder::read_scalar(Json_parser &parser, Json_kind kind)
+{
+    std::string_view value{};
+
+    switch (kind) {
+    case Json_kind::null:
+        parser.read_null();
+        return {};
+    case Json_kind::boolean: {
+        bool b{};
+        if (!parser.read_bool(b)) {
+            return {};
+        }
+        return b ? "1" : "0";
+    }
+    case Json_kind::number:
+        parser.read_number(value);
+        return value;
+    case Json_kind::string:
+        parser.read_string(value, value_scratch_);
+        return value;
+    case Json_kind::array:
+    case Json_kind::object:
+    case Json_kind::invalid:
+        // Let the parser flag the invalid value.
+        parser.skip_value();
+        return {};
+    }
+
+    return {};
+}
+
+bool Json_lines_reader::Decoder::parse(std::string_view value,
+                                       Device_array &arr,
+                                       std::size_t index,
+                                       std::size_t field_idx,
+                                       const Instance &instance)
+{
+    Parse_result r = reader_->parsers_[field_idx](value, arr, index);
+    if (r == Parse_result::ok) {
+        return true;
+    }
+
+    const Field &field = reader_->fields_[field_idx];
+
+    if (r == Parse_result::overflowed) {
+        return report_bad_instance(
+            detail::Decode_warning_kind::overflow,
+            instance,
+            field_idx,
+            [i = &instance, f = &field, value = std::string{value}]() {
+                return fmt::format(
+                    "The field '{2}' of the row #{1:n} in the data store '{0}' cannot be parsed as {3} due to an overflow. Its string value is '{4:.64}'.",
+                    i->data_store().id(),
+                    i->index(),
+                    f->name,
+                    f->data_type,
+                    value);
+            });
+    }
+
+    return report_bad_instance(
+        detail::Decode_warning_kind::parse_error,
+        instance,
+        field_idx,
+        [i = &instance, f = &field, value = std::string{value}]() {
+            return fmt::format(
+                "The field '{2}' of the row #{1:n} in the data store '{0}' cannot be parsed as {3}. Its string value is '{4:.64}'.",
+                i->data_store().id(),
+                i->index(),
+                f->name,
+                f->data_type,
+                value);
+        });
+}
+
+std::optional<std::size_t> Json_lines_reader::Decoder::find_field(std::string_view key) noexcept
+{
+    const std::vector<Field> &fields = reader_->fields_;
+
+    std::size_t next_idx = last_field_idx_ + 1;
+    if (next_idx >= fields.size()) {
+        next_idx = 0;
+    }
+
+    if (fields[next_idx].name == key) {
+        last_field_idx_ = next_idx;
+
+        return next_idx;
+    }
+
+    auto pos = reader_->field_indices_.find(key);
+    if (pos == reader_->field_indices_.end()) {
+        return {};
+    }
+
+    last_field_idx_ = pos->second;
+
+    return pos->second;
+}
+
+bool Json_lines_reader::Decoder::report_corrupt_row(const Instance &instance, std::size_t position)
+{
+    return report_bad_instance(
+        detail::Decode_warning_kind::corrupt_record,
+        instance,
+        detail::Decode_warning::no_column,
+        [i = &instance, position]() {
+            return fmt::format(
+                "The row #{1:n} in the data store '{0}' is not a valid JSON object. The error is at offset {2:n}.",
+                i->data_store().id(),
+                i->index(),
+                position);
+        });
+}
+
+bool Json_lines_reader::Decoder::report_schema_mismatch(const Instance &instance,
+                                                        std::size_t field_idx,
+                                                        const char *reason)
+{
+    return report_bad_instance(
+        detail::Decode_warning_kind::schema_mismatch,
+        instance,
+        field_idx,
+        [i = &instance, f = &reader_->fields_[field_idx], reason]() {
+            return fmt::format("The field '{2}' of the row #{1:n} in the data store '{0}' {3}.",
+                               i->data_store().id(),
+                               i->index(),
+                               f->name,
+                               reason);
+        });
+}
+
+template<typename Format_fn>
+bool Json_lines_reader::Decoder::report_bad_instance(detail::Decode_warning_kind kind,
+                                                     const Instance &instance,
+                                                     std::size_t field_idx,
+                                                     Format_fn &&format_message)
+{
+    if (reader_->params().bad_example_handling == Bad_example_handling::error) {
+        throw Invalid_instance_error{format_message()};
+    }
+
+    // The message is formatted later, outside of the decode loop, and
+    // only if it gets logged.
+    detail::Decode_warning warning{kind, &instance, field_idx};
+    if (reader_->warn_bad_instances()) {
+        warning.format_message = std::forward<Format_fn>(format_message);
+    }
+
+    warnings_->add(std::move(warning));
+
+    return false;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
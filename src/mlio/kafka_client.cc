@@ -0,0 +1,711 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/kafka_client.h"
+
+#include "mlio/not_supported_error.h"
+
+#ifdef MLIO_BUILD_KAFKA
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+#include <fmt/format.h>
+#include <librdkafka/rdkafka.h>
+
+#include "mlio/detail/tracing.h"
+#include "mlio/logger.h"
+#include "mlio/streams/input_stream_base.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+static_assert(kafka_offset_beginning == RD_KAFKA_OFFSET_BEGINNING);
+static_assert(kafka_offset_end == RD_KAFKA_OFFSET_END);
+
+struct Kafka_conf_deleter {
+    void operator()(rd_kafka_conf_t *conf) const noexcept
+    {
+        ::rd_kafka_conf_destroy(conf);
+    }
+};
+
+struct Kafka_handle_deleter {
+    void operator()(rd_kafka_t *handle) const noexcept
+    {
+        ::rd_kafka_destroy(handle);
+    }
+};
+
+struct Kafka_topic_deleter {
+    void operator()(rd_kafka_topic_t *topic) const noexcept
+    {
+        ::rd_kafka_topic_destroy(topic);
+    }
+};
+
+struct Kafka_message_deleter {
+    void operator()(rd_kafka_message_t *message) const noexcept
+    {
+        ::rd_kafka_message_destroy(message);
+    }
+};
+
+struct Kafka_metadata_deleter {
+    void operator()(const rd_kafka_metadata_t *metadata) const noexcept
+    {
+        ::rd_kafka_metadata_destroy(metadata);
+    }
+};
+
+struct Kafka_partition_list_deleter {
+    void operator()(rd_kafka_topic_partition_list_t *list) const noexcept
+    {
+        ::rd_kafka_topic_partition_list_destroy(list);
+    }
+};
+
+using Kafka_conf_ptr = std::unique_ptr<rd_kafka_conf_t, Kafka_conf_deleter>;
+using Kafka_handle_ptr = std::unique_ptr<rd_kafka_t, Kafka_handle_deleter>;
+using Kafka_topic_ptr = std::unique_ptr<rd_kafka_topic_t, Kafka_topic_deleter>;
+using Kafka_message_ptr = std::unique_ptr<rd_kafka_message_t, Kafka_message_deleter>;
+using Kafka_metadata_ptr = std::unique_ptr<const rd_kafka_metadata_t, Kafka_metadata_deleter>;
+using Kafka_partition_list_ptr =
+    std::unique_ptr<rd_kafka_topic_partition_list_t, Kafka_partition_list_deleter>;
+
+// The number of messages taken from the prefetch queue of a partition
+// at once.
+constexpr std::size_t message_batch_size = 1024;
+
+[[noreturn]] void throw_kafka_error(rd_kafka_resp_err_t err, std::string_view what)
+{
+    std::error_code ec;
+
+    switch (err) {
+    case RD_KAFKA_RESP_ERR__TIMED_OUT:
+    case RD_KAFKA_RESP_ERR_REQUEST_TIMED_OUT:
+        ec = std::make_error_code(std::errc::timed_out);
+        break;
+    case RD_KAFKA_RESP_ERR__UNKNOWN_TOPIC:
+    case RD_KAFKA_RESP_ERR__UNKNOWN_PARTITION:
+    case RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART:
+        ec = std::make_error_code(std::errc::no_such_file_or_directory);
+        break;
+    case RD_KAFKA_RESP_ERR_TOPIC_AUTHORIZATION_FAILED:
+    case RD_KAFKA_RESP_ERR_GROUP_AUTHORIZATION_FAILED:
+    case RD_KAFKA_RESP_ERR__AUTHENTICATION:
+        ec = std::make_error_code(std::errc::permission_denied);
+        break;
+    case RD_KAFKA_RESP_ERR__TRANSPORT:
+    case RD_KAFKA_RESP_ERR__ALL_BROKERS_DOWN:
+        ec = std::make_error_code(std::errc::host_unreachable);
+        break;
+    case RD_KAFKA_RESP_ERR_OFFSET_OUT_OF_RANGE:
+        ec = std::make_error_code(std::errc::result_out_of_range);
+        break;
+    default:
+        ec = std::make_error_code(std::errc::io_error);
+        break;
+    }
+
+    throw std::system_error{ec, fmt::format("{0} {1}", what, ::rd_kafka_err2str(err))};
+}
+
+int as_timeout_ms(std::chrono::milliseconds value) noexcept
+{
+    auto count = std::clamp<std::chrono::milliseconds::rep>(
+        value.count(), 0, std::numeric_limits<int>::max());
+
+    return static_cast<int>(count);
+}
+
+Kafka_handle_ptr make_kafka_handle(const Kafka_client_options &opts)
+{
+    Kafka_conf_ptr conf{::rd_kafka_conf_new()};
+
+    std::array<char, 512> errstr{};
+
+    auto set = [&conf, &errstr](const std::string &name, const std::string &value) {
+        auto r = ::rd_kafka_conf_set(
+            conf.get(), name.c_str(), value.c_str(), errstr.data(), errstr.size());
+        if (r != RD_KAFKA_CONF_OK) {
+            throw std::invalid_argument{fmt::format(
+                "The Kafka configuration property '{0}' cannot be set. {1}", name, errstr.data())};
+        }
+    };
+
+    set("bootstrap.servers", opts.bootstrap_servers);
+
+    if (!opts.group_id.empty()) {
+        set("group.id", opts.group_id);
+    }
+
+    // Fetch large batches and keep a deep prefetch queue per partition;
+    // a response must fit into the receive buffer.
+    set("fetch.max.bytes", fmt::to_string(opts.fetch_max_bytes));
+    set("receive.message.max.bytes", fmt::to_string(opts.fetch_max_bytes + 512));
+    set("max.partition.fetch.bytes", fmt::to_string(opts.partition_fetch_max_bytes));
+    set("queued.max.messages.kbytes", fmt::to_string(std::max(opts.prefetch_bytes >> 10, std::size_t{1})));
+    set("fetch.wait.max.ms", fmt::to_string(opts.fetch_wait_max.count()));
+
+    // The offsets are assigned explicitly and only committed on request.
+    set("enable.partition.eof", "true");
+    set("enable.auto.commit", "false");
+    set("enable.auto.offset.store", "false");
+
+    for (auto &[name, value] : opts.config) {
+        set(name, value);
+    }
+
+    Kafka_handle_ptr handle{
+        ::rd_kafka_new(RD_KAFKA_CONSUMER, conf.get(), errstr.data(), errstr.size())};
+    if (handle == nullptr) {
+        throw std::invalid_argument{
+            fmt::format("The Kafka client cannot be created. {0}", errstr.data())};
+    }
+
+    // On success the handle takes over the configuration.
+    static_cast<void>(conf.release());
+
+    return handle;
+}
+
+class Kafka_input_stream final : public Input_stream_base {
+public:
+    explicit Kafka_input_stream(Kafka_handle_ptr handle,
+                                const std::string &topic,
+                                std::int32_t partition,
+                                std::int64_t start_offset,
+                                std::int64_t end_offset,
+                                std::string separator,
+                                std::chrono::milliseconds timeout,
+                                std::chrono::milliseconds poll_interval);
+
+    Kafka_input_stream(const Kafka_input_stream &) = delete;
+
+    Kafka_input_stream &operator=(const Kafka_input_stream &) = delete;
+
+    Kafka_input_stream(Kafka_input_stream &&) = delete;
+
+    Kafka_input_stream &operator=(Kafka_input_stream &&) = delete;
+
+    ~Kafka_input_stream() final;
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final;
+
+    void close() noexcept final;
+
+    bool closed() const noexcept final
+    {
+        return handle_ == nullptr;
+    }
+
+private:
+    bool next_message();
+
+    void fetch_batch();
+
+    Kafka_handle_ptr handle_;
+    Kafka_topic_ptr topic_{};
+    std::string name_;
+    std::int32_t partition_;
+    std::int64_t end_offset_;
+    std::string separator_;
+    std::chrono::milliseconds timeout_;
+    std::chrono::milliseconds poll_interval_;
+    std::vector<Kafka_message_ptr> batch_{};
+    std::size_t batch_pos_{};
+    Memory_span payload_{};
+    std::size_t separator_pos_{};
+    bool eof_{};
+};
+
+Kafka_input_stream::Kafka_input_stream(Kafka_handle_ptr handle,
+                                       const std::string &topic,
+                                       std::int32_t partition,
+                                       std::int64_t start_offset,
+                                       std::int64_t end_offset,
+                                       std::string separator,
+                                       std::chrono::milliseconds timeout,
+                                       std::chrono::milliseconds poll_interval)
+    : handle_{std::move(handle)}
+    , name_{fmt::format("{0}/{1}", topic, partition)}
+    , partition_{partition}
+    , end_offset_{end_offset}
+    , separator_{std::move(separator)}
+    , timeout_{timeout}
+    , poll_interval_{std::max(poll_interval, std::chrono::milliseconds{1})}
+{
+    separator_pos_ = separator_.size();
+
+    if (end_offset_ >= 0 && start_offset >= end_offset_) {
+        eof_ = true;
+    }
+
+    topic_.reset(::rd_kafka_topic_new(handle_.get(), topic.c_str(), nullptr));
+    if (topic_ == nullptr) {
+        throw_kafka_error(::rd_kafka_last_error(),
+                          fmt::format("The Kafka topic '{0}' cannot be opened.", topic));
+    }
+
+    if (::rd_kafka_consume_start(topic_.get(), partition_, start_offset) == -1) {
+        throw_kafka_error(::rd_kafka_last_error(),
+                          fmt::format("The Kafka partition '{0}' cannot be opened.", name_));
+    }
+}
+
+Kafka_input_stream::~Kafka_input_stream()
+{
+    close();
+}
+
+std::size_t Kafka_input_stream::read(Mutable_memory_span destination)
+{
+    if (closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+
+    std::size_t num_bytes_read = 0;
+
+    while (!destination.empty()) {
+        if (payload_.empty() && separator_pos_ == separator_.size()) {
+            // Return what we have instead of waiting for the broker.
+            if (num_bytes_read > 0 && batch_pos_ == batch_.size()) {
+                break;
+            }
+
+            if (!next_message()) {
+                break;
+            }
+        }
+
+        std::size_t n{};
+        if (payload_.empty()) {
+            n = std::min(destination.size(), separator_.size() - separator_pos_);
+
+            std::memcpy(destination.data(), separator_.data() + separator_pos_, n);
+
+            separator_pos_ += n;
+        }
+        else {
+            n = std::min(destination.size(), payload_.size());
+
+            std::copy_n(payload_.begin(), n, destination.begin());
+
+            payload_ = payload_.subspan(n);
+        }
+
+        destination = destination.subspan(n);
+
+        num_bytes_read += n;
+    }
+
+    return num_bytes_read;
+}
+
+bool Kafka_input_stream::next_message()
+{
+    while (batch_pos_ == batch_.size()) {
+        if (eof_) {
+            return false;
+        }
+
+        fetch_batch();
+    }
+
+    const rd_kafka_message_t &message = *batch_[batch_pos_++];
+
+    payload_ = Memory_span{static_cast<const std::byte *>(message.payload), message.len};
+
+    separator_pos_ = 0;
+
+    return true;
+}
+
+void Kafka_input_stream::fetch_batch()
+{
+    Trace_span span{"kafka_fetch"};
+
+    batch_.clear();
+
+    batch_pos_ = 0;
+
+    std::array<rd_kafka_message_t *, message_batch_size> messages{};
+
+    auto deadline = std::chrono::steady_clock::now() + timeout_;
+
+    while (batch_.empty() && !eof_) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+
+        if (remaining.count() <= 0) {
+            // A followed partition ends once it stays idle; a bounded
+            // one must deliver the messages up to its end offset.
+            if (end_offset_ < 0) {
+                logger::debug("The Kafka partition '{0}' has received no message within the "
+                              "timeout and is considered ended.",
+                              name_);
+
+                eof_ = true;
+
+                break;
+            }
+
+            throw std::system_error{
+                std::make_error_code(std::errc::timed_out),
+                fmt::format("The messages of the Kafka partition '{0}' cannot be fetched.", name_)};
+        }
+
+        // librdkafka waits for a full batch until the timeout expires;
+        // poll in short intervals so that a trickle is not held back.
+        int timeout_ms = as_timeout_ms(std::min(remaining, poll_interval_));
+
+        ssize_t num_messages = ::rd_kafka_consume_batch(
+            topic_.get(), partition_, timeout_ms, messages.data(), messages.size());
+        if (num_messages == -1) {
+            throw_kafka_error(
+                ::rd_kafka_last_error(),
+                fmt::format("The messages of the Kafka partition '{0}' cannot be fetched.", name_));
+        }
+
+        std::vector<Kafka_message_ptr> owned{};
+        owned.reserve(static_cast<std::size_t>(num_messages));
+        for (ssize_t i = 0; i < num_messages; i++) {
+            owned.emplace_back(messages[static_cast<std::size_t>(i)]);
+        }
+
+        for (Kafka_message_ptr &message : owned) {
+            if (message->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+                // The offset of the end-of-partition event is the high
+                // watermark; messages at the end of a compacted or
+                // transactional partition do not always reach the end
+                // offset.
+                if (end_offset_ >= 0 && message->offset >= end_offset_) {
+                    eof_ = true;
+                    break;
+                }
+                continue;
+            }
+
+            if (message->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                throw_kafka_error(
+                    message->err,
+                    fmt::format("The Kafka partition '{0}' cannot be read.", name_));
+            }
+
+            if (end_offset_ >= 0 && message->offset >= end_offset_) {
+                eof_ = true;
+                break;
+            }
+
+            if (end_offset_ >= 0 && message->offset + 1 >= end_offset_) {
+                eof_ = true;
+            }
+
+            batch_.emplace_back(std::move(message));
+
+            if (eof_) {
+                break;
+            }
+        }
+    }
+}
+
+void Kafka_input_stream::close() noexcept
+{
+    if (handle_ == nullptr) {
+        return;
+    }
+
+    // The messages must be released before the handle is destroyed.
+    batch_.clear();
+
+    batch_pos_ = 0;
+
+    payload_ = {};
+
+    if (topic_ != nullptr) {
+        ::rd_kafka_consume_stop(topic_.get(), partition_);
+    }
+
+    topic_ = nullptr;
+
+    handle_ = nullptr;
+}
+
+}  // namespace
+}  // namespace detail
+
+struct Kafka_client::Impl {
+    // The handle used for the metadata and offset requests; created on
+    // first use.
+    std::mutex mutex{};
+    detail::Kafka_handle_ptr handle{};
+};
+
+Kafka_client::Kafka_client(Kafka_client_options opts)
+    : opts_{std::move(opts)}, impl_{std::make_unique<Impl>()}
+{
+    if (opts_.bootstrap_servers.empty() && opts_.config.count("bootstrap.servers") == 0) {
+        throw std::invalid_argument{"The bootstrap servers must be specified."};
+    }
+}
+
+Kafka_client::~Kafka_client() = default;
+
+std::size_t Kafka_client::num_partitions(const std::string &topic) const
+{
+    std::unique_lock<std::mutex> lock{impl_->mutex};
+
+    if (impl_->handle == nullptr) {
+        impl_->handle = detail::make_kafka_handle(opts_);
+    }
+
+    detail::Kafka_topic_ptr t{::rd_kafka_topic_new(impl_->handle.get(), topic.c_str(), nullptr)};
+    if (t == nullptr) {
+        detail::throw_kafka_error(::rd_kafka_last_error(),
+                                  fmt::format("The Kafka topic '{0}' cannot be opened.", topic));
+    }
+
+    const rd_kafka_metadata_t *metadata{};
+
+    auto err = ::rd_kafka_metadata(
+        impl_->handle.get(), 0, t.get(), &metadata, detail::as_timeout_ms(opts_.timeout));
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        detail::throw_kafka_error(
+            err, fmt::format("The metadata of the Kafka topic '{0}' cannot be read.", topic));
+    }
+
+    detail::Kafka_metadata_ptr holder{metadata};
+
+    if (metadata->topic_cnt != 1) {
+        detail::throw_kafka_error(
+            RD_KAFKA_RESP_ERR__UNKNOWN_TOPIC,
+            fmt::format("The metadata of the Kafka topic '{0}' cannot be read.", topic));
+    }
+
+    const rd_kafka_metadata_topic_t &md = metadata->topics[0];
+    if (md.err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        detail::throw_kafka_error(
+            md.err, fmt::format("The metadata of the Kafka topic '{0}' cannot be read.", topic));
+    }
+
+    return static_cast<std::size_t>(md.partition_cnt);
+}
+
+std::pair<std::int64_t, std::int64_t>
+Kafka_client::watermark_offsets(const std::string &topic, std::int32_t partition) const
+{
+    std::unique_lock<std::mutex> lock{impl_->mutex};
+
+    if (impl_->handle == nullptr) {
+        impl_->handle = detail::make_kafka_handle(opts_);
+    }
+
+    std::int64_t low{};
+    std::int64_t high{};
+
+    auto err = ::rd_kafka_query_watermark_offsets(impl_->handle.get(),
+                                                  topic.c_str(),
+                                                  partition,
+                                                  &low,
+                                                  &high,
+                                                  detail::as_timeout_ms(opts_.timeout));
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        detail::throw_kafka_error(
+            err,
+            fmt::format(
+                "The offsets of the Kafka partition '{0}/{1}' cannot be read.", topic, partition));
+    }
+
+    return {low, high};
+}
+
+std::vector<std::int64_t> Kafka_client::committed_offsets(const std::string &topic) const
+{
+    if (opts_.group_id.empty()) {
+        throw std::invalid_argument{"The Kafka client has no consumer group."};
+    }
+
+    std::size_t size = num_partitions(topic);
+
+    detail::Kafka_partition_list_ptr list{
+        ::rd_kafka_topic_partition_list_new(static_cast<int>(size))};
+
+    for (std::size_t i = 0; i < size; i++) {
+        auto partition = static_cast<std::int32_t>(i);
+
+        ::rd_kafka_topic_partition_list_add(list.get(), topic.c_str(), partition);
+    }
+
+    std::unique_lock<std::mutex> lock{impl_->mutex};
+
+    auto err = ::rd_kafka_committed(
+        impl_->handle.get(), list.get(), detail::as_timeout_ms(opts_.timeout));
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        detail::throw_kafka_error(
+            err,
+            fmt::format("The committed offsets of the Kafka topic '{0}' cannot be read.", topic));
+    }
+
+    std::vector<std::int64_t> offsets(size, kafka_offset_beginning);
+
+    for (int i = 0; i < list->cnt; i++) {
+        const rd_kafka_topic_partition_t &elem = list->elems[i];
+        if (elem.err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            detail::throw_kafka_error(
+                elem.err,
+                fmt::format("The committed offset of the Kafka partition '{0}/{1}' cannot be "
+                            "read.",
+                            topic,
+                            elem.partition));
+        }
+
+        // Partitions without a committed offset report an invalid one.
+        if (elem.offset >= 0) {
+            offsets[static_cast<std::size_t>(elem.partition)] = elem.offset;
+        }
+    }
+
+    return offsets;
+}
+
+void Kafka_client::commit_offsets(const std::string &topic,
+                                  stdx::span<const Kafka_offset> offsets) const
+{
+    if (opts_.group_id.empty()) {
+        throw std::invalid_argument{"The Kafka client has no consumer group."};
+    }
+
+    if (offsets.empty()) {
+        return;
+    }
+
+    detail::Kafka_partition_list_ptr list{
+        ::rd_kafka_topic_partition_list_new(static_cast<int>(offsets.size()))};
+
+    for (const Kafka_offset &offset : offsets) {
+        ::rd_kafka_topic_partition_list_add(list.get(), topic.c_str(), offset.partition)->offset =
+            offset.offset;
+    }
+
+    std::unique_lock<std::mutex> lock{impl_->mutex};
+
+    if (impl_->handle == nullptr) {
+        impl_->handle = detail::make_kafka_handle(opts_);
+    }
+
+    auto err = ::rd_kafka_commit(impl_->handle.get(), list.get(), 0);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        detail::throw_kafka_error(
+            err, fmt::format("The offsets of the Kafka topic '{0}' cannot be committed.", topic));
+    }
+}
+
+Intrusive_ptr<Input_stream> Kafka_client::open_partition(const std::string &topic,
+                                                         std::int32_t partition,
+                                                         std::int64_t start_offset,
+                                                         std::int64_t end_offset,
+                                                         std::string separator) const
+{
+    // Each stream gets a handle of its own so that the partitions read
+    // by concurrent readers are fetched and queued independently.
+    return make_intrusive<detail::Kafka_input_stream>(detail::make_kafka_handle(opts_),
+                                                      topic,
+                                                      partition,
+                                                      start_offset,
+                                                      end_offset,
+                                                      std::move(separator),
+                                                      opts_.timeout,
+                                                      opts_.fetch_wait_max);
+}
+
+Intrusive_ptr<Kafka_client> make_kafka_client(Kafka_client_options opts)
+{
+    return make_intrusive<Kafka_client>(std::move(opts));
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+namespace mlio {
+inline namespace abi_v1 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+struct Kafka_client::Impl {};
+
+Kafka_client::Kafka_client(Kafka_client_options opts) : opts_{std::move(opts)}
+{
+    throw Not_supported_error{"MLIO was not built with Kafka support."};
+}
+
+Kafka_client::~Kafka_client() = default;
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::size_t Kafka_client::num_partitions(const std::string &) const
+{
+    return 0;
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::pair<std::int64_t, std::int64_t>
+Kafka_client::watermark_offsets(const std::string &, std::int32_t) const
+{
+    return {};
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+std::vector<std::int64_t> Kafka_client::committed_offsets(const std::string &) const
+{
+    return {};
+}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Kafka_client::commit_offsets(const std::string &, stdx::span<const Kafka_offset>) const
+{}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+Intrusive_ptr<Input_stream> Kafka_client::open_partition(
+    const std::string &, std::int32_t, std::int64_t, std::int64_t, std::string) const
+{
+    return {};
+}
+
+Intrusive_ptr<Kafka_client> make_kafka_client(Kafka_client_options)
+{
+    throw Not_supported_error{"MLIO was not built with Kafka support."};
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,539 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/libsvm_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/decode_warning_log.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/logger.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/text_line_record_reader.h"
+#include "mlio/schema.h"
+#include "mlio/sparse_tensor_builder.h"
+#include "mlio/streams/utf8_input_stream.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/number.h"
+#include "mlio/util/string.h"
+
+using mlio::detail::Sparse_tensor_builder;
+using mlio::detail::Sparse_tensor_builder_impl;
+using mlio::detail::Text_line_record_reader;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+thread_local std::vector<std::uint64_t> indices_{};  // NOLINT(cert-err58-cpp)
+
+template<typename T>
+thread_local std::vector<T> values_{};  // NOLINT(cert-err58-cpp)
+
+inline bool is_blank(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+}  // namespace
+}  // namespace detail
+
+// Holds the labels and the sparse tensor builder of a contiguous range
+// of rows that got decoded by a single task.
+struct Libsvm_reader::Row_range {
+    std::size_t first_row_idx{};
+    std::vector<double> labels{};
+    std::unique_ptr<Sparse_tensor_builder> builder{};
+};
+
+// Parses a single row. The parser does not allocate; the tokens are
+// views into the row.
+class Libsvm_reader::Decoder {
+public:
+    enum class Error { none, no_label, invalid_label, invalid_pair, invalid_index, invalid_value };
+
+    explicit Decoder(bool zero_based, std::size_t num_features) noexcept
+        : zero_based_{zero_based}, num_features_{num_features}
+    {}
+
+    template<typename T>
+    bool decode(std::string_view row, std::vector<std::uint64_t> &indices, std::vector<T> &values);
+
+    double label() const noexcept
+    {
+        return label_;
+    }
+
+    detail::Decode_warning_kind warning_kind() const noexcept;
+
+    std::string format_error(const Instance &instance) const;
+
+private:
+    std::string_view next_token() noexcept;
+
+    bool fail(Error error, std::string_view token) noexcept
+    {
+        error_ = error;
+
+        error_token_ = token;
+
+        return false;
+    }
+
+    bool zero_based_;
+    std::size_t num_features_;
+    std::string_view row_{};
+    double label_{};
+    Error error_{};
+    // A view into the row; the instance outlives the warning that
+    // refers to it.
+    std::string_view error_token_{};
+};
+
+Libsvm_reader::Libsvm_reader(Data_reader_params params, Libsvm_params libsvm_params)
+    : Parallel_data_reader{std::move(params)}, libsvm_params_{std::move(libsvm_params)}
+{
+    auto is_float = [](Data_type dt) {
+        return dt == Data_type::float32 || dt == Data_type::float64;
+    };
+
+    if (!is_float(libsvm_params_.label_data_type)) {
+        throw std::invalid_argument{"The data type of the labels must be float32 or float64."};
+    }
+
+    if (!is_float(libsvm_params_.data_type)) {
+        throw std::invalid_argument{"The data type of the values must be float32 or float64."};
+    }
+}
+
+Libsvm_reader::~Libsvm_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Libsvm_reader::make_record_reader(const Data_store &store)
+{
+    auto stream = make_utf8_stream(store.open_read());
+
+    return make_intrusive<Text_line_record_reader>(std::move(stream), true);
+}
+
+Intrusive_ptr<const Schema> Libsvm_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    num_features_ = libsvm_params_.num_features;
+
+    if (num_features_ == 0) {
+        if (instance == std::nullopt) {
+            return {};
+        }
+
+        std::vector<Memory_slice> rows{};
+        rows.emplace_back(instance->bits());
+
+        if (libsvm_params_.num_feature_inference_rows > 1) {
+            std::vector<Memory_slice> sampled_rows = sample_rows();
+
+            std::move(sampled_rows.begin(), sampled_rows.end(), std::back_inserter(rows));
+        }
+
+        Decoder decoder{libsvm_params_.zero_based, std::numeric_limits<std::size_t>::max()};
+
+        std::vector<std::uint64_t> indices{};
+        std::vector<double> values{};
+
+        // The bad rows are ignored here; they get reported while decoding.
+        for (const Memory_slice &row : rows) {
+            if (!decoder.decode(as_string_view(row), indices, values)) {
+                continue;
+            }
+
+            // The decoder rejects the indices that are not less than its
+            // feature count, so an index plus one always fits in size_t.
+            for (std::size_t idx : indices) {
+                num_features_ = std::max(num_features_, idx + 1);
+            }
+        }
+
+        if (num_features_ == 0) {
+            throw Schema_error{
+                "The number of features cannot be inferred as the sampled rows have no feature. "
+                "Specify it in the LibSVM parameters."};
+        }
+    }
+
+    std::vector<Attribute> attrs{};
+
+    attrs.emplace_back(
+        "label", libsvm_params_.label_data_type, Size_vector{params().batch_size, 1});
+
+    attrs.emplace_back("values",
+                       libsvm_params_.data_type,
+                       Size_vector{params().batch_size, num_features_},
+                       Ssize_vector{},
+                       true);
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+std::vector<Memory_slice> Libsvm_reader::sample_rows()
+{
+    std::size_t num_rows = libsvm_params_.num_feature_inference_rows - 1;
+
+    std::vector<Memory_slice> rows{};
+    rows.reserve(num_rows);
+
+    // Read the rows from the beginning of the dataset; unless it is
+    // shuffled, this includes the row of the first instance, which
+    // does not affect the result.
+    const std::vector<Intrusive_ptr<Data_store>> &dataset = params().dataset;
+
+    for (auto pos = dataset.begin(); pos < dataset.end() && rows.size() < num_rows; ++pos) {
+        Text_line_record_reader reader{make_utf8_stream((*pos)->open_read()), true};
+
+        while (rows.size() < num_rows) {
+            std::optional<Record> record = reader.read_record();
+            if (record == std::nullopt) {
+                break;
+            }
+
+            rows.emplace_back(record->payload());
+        }
+    }
+
+    return rows;
+}
+
+Intrusive_ptr<Example> Libsvm_reader::decode(const Instance_batch &batch) const
+{
+    if (libsvm_params_.data_type == Data_type::float32) {
+        return decode_batch<Data_type::float32>(batch);
+    }
+    return decode_batch<Data_type::float64>(batch);
+}
+
+template<Data_type dt>
+Intrusive_ptr<Example> Libsvm_reader::decode_batch(const Instance_batch &batch) const
+{
+    using T = data_type_t<dt>;
+
+    const Attribute &attr = schema()->attributes()[1];
+
+    Sparse_tensor_format format = params().sparse_tensor_format;
+
+    // Until a batch has been decoded, assume a single value per row.
+    std::size_t nnz_per_row =
+        std::max(nnz_per_row_estimate_.load(std::memory_order_relaxed), std::size_t{1});
+
+    bool error_bad_example = params().bad_example_handling == Bad_example_handling::error;
+
+    bool skip_bad_example = params().bad_example_handling == Bad_example_handling::skip ||
+                            params().bad_example_handling == Bad_example_handling::skip_warn;
+
+    bool warn_bad_instance = warn_bad_instances();
+
+    detail::Decode_warning_log warnings{};
+
+    std::atomic_bool skip_example{};
+
+    // Each task parses a contiguous range of rows into its own builder;
+    // a bad row is left out so that, in pad mode, the good rows that
+    // follow it move up once the ranges are concatenated.
+    tbb::concurrent_vector<Row_range> row_ranges{};
+
+    auto worker = [&](const tbb::blocked_range<std::size_t> &sub_range) {
+        Row_range row_range{sub_range.begin(),
+                            {},
+                            detail::make_sparse_tensor_builder(
+                                attr, sub_range.size(), format, nnz_per_row * sub_range.size())};
+
+        row_range.labels.reserve(sub_range.size());
+
+        auto &builder = static_cast<Sparse_tensor_builder_impl<dt> &>(*row_range.builder);
+
+        std::vector<std::uint64_t> &indices = detail::indices_;
+        std::vector<T> &values = detail::values_<T>;
+
+        Decoder decoder{libsvm_params_.zero_based, num_features_};
+
+        for (std::size_t i = sub_range.begin(); i < sub_range.end(); i++) {
+            if (decoder.decode(as_string_view(batch.bits(i)), indices, values)) {
+                // The indices have been validated by the decoder.
+                builder.append(values, indices);
+
+                row_range.labels.emplace_back(decoder.label());
+
+                continue;
+            }
+
+            const Instance &instance = batch.instances()[i];
+
+            if (error_bad_example) {
+                throw Invalid_instance_error{decoder.format_error(instance)};
+            }
+
+            // The message is formatted later, outside of the decode
+            // loop, and only if it gets logged.
+            detail::Decode_warning warning{decoder.warning_kind(), &instance};
+            if (warn_bad_instance) {
+                warning.format_message = [decoder, &instance]() {
+                    return decoder.format_error(instance);
+                };
+            }
+
+            warnings.add(std::move(warning));
+
+            if (skip_bad_example) {
+                skip_example = true;
+
+                return;
+            }
+        }
+
+        row_ranges.push_back(std::move(row_range));
+    };
+
+    std::size_t num_instances = batch.num_instances();
+
+    tbb::blocked_range<std::size_t> range{0, num_instances, decode_grain_size(nnz_per_row)};
+
+    if (should_decode_parallel(num_instances, nnz_per_row)) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(tbb::blocked_range<std::size_t>{0, num_instances});
+    }
+
+    report_decode_warnings(warnings);
+
+    if (skip_example) {
+        if (params().bad_example_handling == Bad_example_handling::skip_warn) {
+            logger::warn("The example #{0:n} has been skipped as it had at least one bad instance.",
+                         batch.index());
+        }
+
+        return nullptr;
+    }
+
+    std::sort(row_ranges.begin(), row_ranges.end(), [](const auto &a, const auto &b) {
+        return a.first_row_idx < b.first_row_idx;
+    });
+
+    // Concatenate the row ranges; the index pointers of each range get
+    // shifted by the number of values that precede it.
+    std::size_t nnz = 0;
+    for (Row_range &row_range : row_ranges) {
+        nnz += row_range.builder->nnz();
+    }
+
+    auto builder = detail::make_sparse_tensor_builder(attr, batch.size(), format, nnz);
+
+    std::unique_ptr<Device_array> labels =
+        make_pooled_cpu_array(libsvm_params_.label_data_type, batch.size());
+
+    auto copy_labels = [&row_ranges, &builder](auto destination) {
+        auto pos = destination.begin();
+        for (Row_range &row_range : row_ranges) {
+            for (double label : row_range.labels) {
+                *pos++ = static_cast<typename decltype(destination)::value_type>(label);
+            }
+
+            builder->merge(*row_range.builder);
+        }
+
+        // The padded rows have a label of zero.
+        std::fill(pos, destination.end(), 0);
+    };
+
+    if (libsvm_params_.label_data_type == Data_type::float32) {
+        copy_labels(as_span<float>(*labels));
+    }
+    else {
+        copy_labels(as_span<double>(*labels));
+    }
+
+    std::size_t num_rows = builder->num_rows();
+    if (num_rows > 0) {
+        nnz_per_row_estimate_.store((nnz + num_rows - 1) / num_rows, std::memory_order_relaxed);
+    }
+
+    if (num_rows != num_instances) {
+        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
+            logger::warn("The example #{0:n} has been padded as it had {1:n} bad instance(s).",
+                         batch.index(),
+                         num_instances - num_rows);
+        }
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.reserve(2);
+
+    tensors.emplace_back(
+        make_intrusive<Dense_tensor>(Size_vector{batch.size(), 1}, std::move(labels)));
+
+    tensors.emplace_back(builder->build(tensor_pool()));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - num_rows;
+
+    return example;
+}
+
+template<typename T>
+bool Libsvm_reader::Decoder::decode(std::string_view row,
+                                    std::vector<std::uint64_t> &indices,
+                                    std::vector<T> &values)
+{
+    indices.clear();
+    values.clear();
+
+    // Ignore the trailing comment.
+    row_ = row.substr(0, row.find('#'));
+
+    std::string_view token = next_token();
+    if (token.empty()) {
+        return fail(Error::no_label, token);
+    }
+
+    if (try_parse_float(token, label_) != Parse_result::ok) {
+        return fail(Error::invalid_label, token);
+    }
+
+    while (!(token = next_token()).empty()) {
+        std::size_t colon_pos = token.find(':');
+        if (colon_pos == std::string_view::npos) {
+            return fail(Error::invalid_pair, token);
+        }
+
+        std::string_view index_token = token.substr(0, colon_pos);
+        std::string_view value_token = token.substr(colon_pos + 1);
+
+        // The query ids of ranking datasets are not features.
+        if (index_token == "qid") {
+            continue;
+        }
+
+        std::uint64_t idx{};
+        if (try_parse_int(index_token, idx) != Parse_result::ok) {
+            return fail(Error::invalid_index, token);
+        }
+
+        if (!zero_based_) {
+            if (idx == 0) {
+                return fail(Error::invalid_index, token);
+            }
+            idx--;
+        }
+
+        if (idx >= num_features_) {
+            return fail(Error::invalid_index, token);
+        }
+
+        T value{};
+        if (try_parse_float(value_token, value) != Parse_result::ok) {
+            return fail(Error::invalid_value, token);
+        }
+
+        indices.emplace_back(idx);
+        values.emplace_back(value);
+    }
+
+    return true;
+}
+
+std::string_view Libsvm_reader::Decoder::next_token() noexcept
+{
+    auto pos = std::find_if_not(row_.begin(), row_.end(), detail::is_blank);
+    auto end = std::find_if(pos, row_.end(), detail::is_blank);
+
+    auto offset = static_cast<std::size_t>(pos - row_.begin());
+    auto size = static_cast<std::size_t>(end - pos);
+
+    std::string_view token = row_.substr(offset, size);
+
+    row_.remove_prefix(offset + size);
+
+    return token;
+}
+
+detail::Decode_warning_kind Libsvm_reader::Decoder::warning_kind() const noexcept
+{
+    if (error_ == Error::invalid_index) {
+        return detail::Decode_warning_kind::schema_mismatch;
+    }
+    return detail::Decode_warning_kind::parse_error;
+}
+
+std::string Libsvm_reader::Decoder::format_error(const Instance &instance) const
+{
+    switch (error_) {
+    case Error::no_label:
+        return fmt::format("The instance #{1:n} in the data store '{0}' does not have a label.",
+                           instance.data_store().id(),
+                           instance.index());
+    case Error::invalid_label:
+        return fmt::format(
+            "The label '{2}' of the instance #{1:n} in the data store '{0}' cannot be parsed as a number.",
+            instance.data_store().id(),
+            instance.index(),
+            error_token_);
+    case Error::invalid_pair:
+        return fmt::format(
+            "The token '{2}' of the instance #{1:n} in the data store '{0}' is not an index:value pair.",
+            instance.data_store().id(),
+            instance.index(),
+            error_token_);
+    case Error::invalid_index:
+        return fmt::format(
+            "The pair '{2}' of the instance #{1:n} in the data store '{0}' has an index that is not within the range of {3}{4:n} features.",
+            instance.data_store().id(),
+            instance.index(),
+            error_token_,
+            zero_based_ ? "0-based " : "1-based ",
+            num_features_);
+    case Error::invalid_value:
+    case Error::none:
+        break;
+    }
+
+    return fmt::format(
+        "The value of the pair '{2}' of the instance #{1:n} in the data store '{0}' cannot be parsed as a number.",
+        instance.data_store().id(),
+        instance.index(),
+        error_token_);
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
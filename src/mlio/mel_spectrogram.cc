@@ -0,0 +1,347 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/mel_spectrogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+// The mel scale of Slaney's Auditory Toolbox, which is linear below
+// 1 kHz and logarithmic above; the default of librosa.
+constexpr double min_log_hz = 1000.0;
+constexpr double min_log_mel = 15.0;
+constexpr double linear_step = 200.0 / 3.0;
+
+inline double get_log_step()
+{
+    return std::log(6.4) / 27.0;
+}
+
+double hz_to_mel(double hz)
+{
+    if (hz < min_log_hz) {
+        return hz / linear_step;
+    }
+    return min_log_mel + std::log(hz / min_log_hz) / get_log_step();
+}
+
+double mel_to_hz(double mel)
+{
+    if (mel < min_log_mel) {
+        return mel * linear_step;
+    }
+    return min_log_hz * std::exp((mel - min_log_mel) * get_log_step());
+}
+
+}  // namespace
+
+Mel_spectrogram::Mel_spectrogram(const Audio_reader_params &params)
+    : fft_size_{params.fft_size}, hop_size_{params.hop_size}, log_offset_{params.log_offset}
+{
+    if (fft_size_ < 2 || (fft_size_ & (fft_size_ - 1)) != 0) {
+        throw std::invalid_argument{"The FFT size must be a power of two greater than one."};
+    }
+
+    if (params.window_size == 0 || params.window_size > fft_size_) {
+        throw std::invalid_argument{
+            "The window size must be greater than zero and less than or equal to the FFT size."};
+    }
+
+    if (hop_size_ == 0) {
+        throw std::invalid_argument{"The hop size must be greater than zero."};
+    }
+
+    if (params.num_mels == 0) {
+        throw std::invalid_argument{"The number of mel bands must be greater than zero."};
+    }
+
+    auto sample_rate = static_cast<float>(params.sample_rate);
+
+    float max_frequency = params.max_frequency.value_or(sample_rate / 2.0F);
+
+    if (params.min_frequency < 0.0F || params.min_frequency >= max_frequency ||
+        max_frequency > sample_rate / 2.0F) {
+        throw std::invalid_argument{fmt::format(
+            "The frequency range of the mel filter bank ({0} Hz, {1} Hz) must be within 0 Hz and the Nyquist frequency ({2} Hz).",
+            params.min_frequency,
+            max_frequency,
+            sample_rate / 2.0F)};
+    }
+
+    init_window(params.window_size);
+
+    init_fft();
+
+    init_filter_bank(params.num_mels, sample_rate, params.min_frequency, max_frequency);
+}
+
+void Mel_spectrogram::init_window(std::size_t window_size)
+{
+    // A periodic Hann window that is centered in the frame.
+    window_.resize(fft_size_);
+
+    std::size_t offset = (fft_size_ - window_size) / 2;
+
+    for (std::size_t i = 0; i < window_size; i++) {
+        double phase = 2.0 * pi * static_cast<double>(i) / static_cast<double>(window_size);
+
+        window_[offset + i] = static_cast<float>(0.5 - 0.5 * std::cos(phase));
+    }
+}
+
+void Mel_spectrogram::init_fft()
+{
+    // The real frame of size N is packed into a complex sequence of size
+    // N / 2 whose FFT is then split into the FFT of the frame.
+    std::size_t size = fft_size_ / 2;
+
+    std::size_t num_bits = 0;
+    while ((std::size_t{1} << num_bits) < size) {
+        num_bits++;
+    }
+
+    bit_reversal_.resize(size);
+    for (std::size_t i = 0; i < size; i++) {
+        std::size_t r = 0;
+        for (std::size_t b = 0; b < num_bits; b++) {
+            r |= ((i >> b) & 1) << (num_bits - 1 - b);
+        }
+        bit_reversal_[i] = r;
+    }
+
+    // The stage that combines the FFTs of size h stores its h twiddle
+    // factors at the offset h - 1, so that the butterflies of a stage
+    // read them contiguously.
+    twiddle_re_.resize(size > 1 ? size - 1 : 0);
+    twiddle_im_.resize(twiddle_re_.size());
+
+    for (std::size_t half = 1; half < size; half *= 2) {
+        for (std::size_t k = 0; k < half; k++) {
+            double angle = pi * static_cast<double>(k) / static_cast<double>(half);
+
+            twiddle_re_[half - 1 + k] = static_cast<float>(std::cos(angle));
+            twiddle_im_[half - 1 + k] = static_cast<float>(-std::sin(angle));
+        }
+    }
+
+    split_re_.resize(size);
+    split_im_.resize(size);
+
+    for (std::size_t k = 0; k < size; k++) {
+        double angle = 2.0 * pi * static_cast<double>(k) / static_cast<double>(fft_size_);
+
+        split_re_[k] = static_cast<float>(std::cos(angle));
+        split_im_[k] = static_cast<float>(-std::sin(angle));
+    }
+}
+
+void Mel_spectrogram::init_filter_bank(std::size_t num_mels,
+                                       float sample_rate,
+                                       float min_frequency,
+                                       float max_frequency)
+{
+    std::size_t num_bins = fft_size_ / 2 + 1;
+
+    double min_mel = hz_to_mel(static_cast<double>(min_frequency));
+    double max_mel = hz_to_mel(static_cast<double>(max_frequency));
+
+    // The edges of the filters are equally spaced on the mel scale.
+    std::vector<double> edges(num_mels + 2);
+    for (std::size_t i = 0; i < edges.size(); i++) {
+        double mel = min_mel + (max_mel - min_mel) * static_cast<double>(i) /
+                                   static_cast<double>(num_mels + 1);
+
+        edges[i] = mel_to_hz(mel);
+    }
+
+    double bin_width = static_cast<double>(sample_rate) / static_cast<double>(fft_size_);
+
+    filters_.resize(num_mels);
+
+    for (std::size_t m = 0; m < num_mels; m++) {
+        double lower = edges[m];
+        double center = edges[m + 1];
+        double upper = edges[m + 2];
+
+        // Normalize the filters to have a constant energy per band.
+        double norm = 2.0 / (upper - lower);
+
+        Mel_filter &filter = filters_[m];
+
+        // Only store the non-zero weights of the filter; if the FFT is
+        // too coarse for the band, the filter stays empty.
+        for (std::size_t bin = 0; bin < num_bins; bin++) {
+            double freq = static_cast<double>(bin) * bin_width;
+
+            double weight = std::min((freq - lower) / (center - lower),
+                                     (upper - freq) / (upper - center));
+            if (weight <= 0.0) {
+                if (!filter.weights.empty()) {
+                    break;
+                }
+                continue;
+            }
+
+            if (filter.weights.empty()) {
+                filter.first_bin = bin;
+            }
+
+            filter.weights.emplace_back(static_cast<float>(weight * norm));
+        }
+    }
+}
+
+void Mel_spectrogram::compute(stdx::span<const float> samples, stdx::span<float> out) const
+{
+    std::size_t num_frames = this->num_frames(samples.size());
+
+    std::size_t size = fft_size_ / 2;
+
+    std::vector<float> re(size);
+    std::vector<float> im(size);
+    std::vector<float> power(size + 1);
+
+    for (std::size_t t = 0; t < num_frames; t++) {
+        compute_power(samples, t * hop_size_, re.data(), im.data(), power.data());
+
+        for (std::size_t m = 0; m < filters_.size(); m++) {
+            const Mel_filter &filter = filters_[m];
+
+            const float *bins = power.data() + filter.first_bin;
+
+            float energy = 0.0F;
+            for (std::size_t i = 0; i < filter.weights.size(); i++) {
+                energy += filter.weights[i] * bins[i];
+            }
+
+            out[m * num_frames + t] = std::log(energy + log_offset_);
+        }
+    }
+}
+
+void Mel_spectrogram::compute_power(stdx::span<const float> samples,
+                                    std::size_t center,
+                                    float *re,
+                                    float *im,
+                                    float *power) const noexcept
+{
+    std::size_t size = fft_size_ / 2;
+
+    const float *window = window_.data();
+
+    // The first sample of the frame might be before the start of the
+    // waveform.
+    auto start = as_ssize(center) - as_ssize(size);
+
+    if (start >= 0 && as_size(start) + fft_size_ <= samples.size()) {
+        const float *frame = samples.data() + start;
+
+        for (std::size_t j = 0; j < size; j++) {
+            std::size_t r = bit_reversal_[j];
+
+            re[r] = frame[2 * j] * window[2 * j];
+            im[r] = frame[2 * j + 1] * window[2 * j + 1];
+        }
+    }
+    else {
+        auto get_sample = [&samples, start](std::size_t i) {
+            auto pos = start + as_ssize(i);
+            if (pos < 0 || as_size(pos) >= samples.size()) {
+                return 0.0F;
+            }
+            return samples[as_size(pos)];
+        };
+
+        for (std::size_t j = 0; j < size; j++) {
+            std::size_t r = bit_reversal_[j];
+
+            re[r] = get_sample(2 * j) * window[2 * j];
+            im[r] = get_sample(2 * j + 1) * window[2 * j + 1];
+        }
+    }
+
+    fft(re, im);
+
+    // The DC and Nyquist bins are both real and are packed into the
+    // first element.
+    power[0] = (re[0] + im[0]) * (re[0] + im[0]);
+    power[size] = (re[0] - im[0]) * (re[0] - im[0]);
+
+    const float *split_re = split_re_.data();
+    const float *split_im = split_im_.data();
+
+    for (std::size_t k = 1; k < size; k++) {
+        float a = re[k];
+        float b = im[k];
+        float c = re[size - k];
+        float d = im[size - k];
+
+        // The FFTs of the even and odd samples of the frame.
+        float even_re = 0.5F * (a + c);
+        float even_im = 0.5F * (b - d);
+        float odd_re = 0.5F * (b + d);
+        float odd_im = 0.5F * (c - a);
+
+        float x_re = even_re + split_re[k] * odd_re - split_im[k] * odd_im;
+        float x_im = even_im + split_re[k] * odd_im + split_im[k] * odd_re;
+
+        power[k] = x_re * x_re + x_im * x_im;
+    }
+}
+
+void Mel_spectrogram::fft(float *re, float *im) const noexcept
+{
+    std::size_t size = fft_size_ / 2;
+
+    // The butterflies are laid out so that the inner loop runs over
+    // contiguous elements and can be vectorized by the compiler.
+    for (std::size_t half = 1; half < size; half *= 2) {
+        const float *tw_re = twiddle_re_.data() + half - 1;
+        const float *tw_im = twiddle_im_.data() + half - 1;
+
+        for (std::size_t start = 0; start < size; start += 2 * half) {
+            float *re0 = re + start;
+            float *im0 = im + start;
+            float *re1 = re0 + half;
+            float *im1 = im0 + half;
+
+            for (std::size_t k = 0; k < half; k++) {
+                float t_re = tw_re[k] * re1[k] - tw_im[k] * im1[k];
+                float t_im = tw_re[k] * im1[k] + tw_im[k] * re1[k];
+
+                re1[k] = re0[k] - t_re;
+                im1[k] = im0[k] - t_im;
+                re0[k] = re0[k] + t_re;
+                im0[k] = im0[k] + t_im;
+            }
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
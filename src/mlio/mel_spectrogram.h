@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mlio/audio_reader.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Computes the log-mel spectrogram of a waveform as specified by an
+// Audio_reader_params. The frames are centered on multiples of the hop
+// size and the waveform is padded with zeros at both ends.
+class Mel_spectrogram {
+    // A triangular filter of the mel filter bank.
+    struct Mel_filter {
+        std::size_t first_bin{};
+        std::vector<float> weights{};
+    };
+
+public:
+    explicit Mel_spectrogram(const Audio_reader_params &params);
+
+    // Returns the number of frames of the spectrogram of a waveform with
+    // the specified number of samples.
+    std::size_t num_frames(std::size_t num_samples) const noexcept
+    {
+        return 1 + num_samples / hop_size_;
+    }
+
+    // Writes the log-mel spectrogram of the samples to the output buffer
+    // in (mels, frames) layout.
+    void compute(stdx::span<const float> samples, stdx::span<float> out) const;
+
+private:
+    void init_window(std::size_t window_size);
+
+    void init_fft();
+
+    void init_filter_bank(std::size_t num_mels,
+                          float sample_rate,
+                          float min_frequency,
+                          float max_frequency);
+
+    // Computes the power spectrum of the windowed frame that is centered
+    // on the specified sample.
+    void compute_power(stdx::span<const float> samples,
+                       std::size_t center,
+                       float *re,
+                       float *im,
+                       float *power) const noexcept;
+
+    // Computes the in-place FFT of a bit-reversed complex sequence whose
+    // size is half of the FFT size.
+    void fft(float *re, float *im) const noexcept;
+
+    std::size_t fft_size_;
+    std::size_t hop_size_;
+    float log_offset_;
+    std::vector<float> window_{};
+    std::vector<std::size_t> bit_reversal_{};
+    // The twiddle factors of each stage of the FFT laid out back-to-back.
+    std::vector<float> twiddle_re_{};
+    std::vector<float> twiddle_im_{};
+    // The twiddle factors that split the FFT of the packed sequence into
+    // the FFT of the real frame.
+    std::vector<float> split_re_{};
+    std::vector<float> split_im_{};
+    std::vector<Mel_filter> filters_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,6 +16,7 @@
 #include "mlio/memory/file_backed_memory_allocator.h"
 
 #include <algorithm>
+#include <string>
 #include <utility>
 
 #include "mlio/detail/system_info.h"
@@ -34,7 +35,9 @@ namespace {
 // size exceeds the specified threshold.
 class Hybrid_memory_block final : public Mutable_memory_block {
 public:
-    explicit Hybrid_memory_block(size_type size, size_type oversize_threshold);
+    explicit Hybrid_memory_block(size_type size,
+                                 size_type oversize_threshold,
+                                 std::string directory);
 
     void resize(size_type size) final;
 
@@ -61,11 +64,14 @@ public:
 private:
     Intrusive_ptr<Mutable_memory_block> inner_;
     size_type oversize_threshold_;
+    std::string directory_;
     bool file_backed_{};
 };
 
-Hybrid_memory_block::Hybrid_memory_block(size_type size, size_type oversize_threshold)
-    : oversize_threshold_{oversize_threshold}
+Hybrid_memory_block::Hybrid_memory_block(size_type size,
+                                         size_type oversize_threshold,
+                                         std::string directory)
+    : oversize_threshold_{oversize_threshold}, directory_{std::move(directory)}
 {
     inner_ = make_intrusive<Heap_memory_block>(size);
 }
@@ -77,17 +83,17 @@ void Hybrid_memory_block::resize(size_type size)
     // not true. Once we have a file-backed memory block there is no
     // need to move back to the heap; once initialized accessing a
     // file-backed memory region has no extra latency.
-    if (!file_backed_ && inner_->size() > oversize_threshold_) {
+    if (!file_backed_ && size > oversize_threshold_) {
         logger::debug(
             "The data is being moved from heap to file-backed memory block. Old size was {0:n} byte(s); new size is {1:n} bytes.",
             inner_->size(),
             size);
 
-        auto block = make_intrusive<File_backed_memory_block>(size);
+        // The data is written straight to the backing file instead of
+        // being copied through the memory map page by page.
+        Memory_span data{inner_->data(), std::min(inner_->size(), size)};
 
-        std::copy(inner_->begin(), inner_->end(), block->begin());
-
-        inner_ = std::move(block);
+        inner_ = make_intrusive<File_backed_memory_block>(size, data, directory_);
 
         file_backed_ = true;
     }
@@ -116,8 +122,9 @@ std::size_t default_oversize_threshold() noexcept
 
 using mlio::detail::Hybrid_memory_block;
 
-File_backed_memory_allocator::File_backed_memory_allocator(std::size_t oversize_threshold) noexcept
-    : oversize_threshold_{oversize_threshold}
+File_backed_memory_allocator::File_backed_memory_allocator(std::size_t oversize_threshold,
+                                                           std::string directory) noexcept
+    : oversize_threshold_{oversize_threshold}, directory_{std::move(directory)}
 {
     if (oversize_threshold_ == 0) {
         oversize_threshold_ = detail::default_oversize_threshold();
@@ -127,9 +134,9 @@ File_backed_memory_allocator::File_backed_memory_allocator(std::size_t oversize_
 Intrusive_ptr<Mutable_memory_block> File_backed_memory_allocator::allocate(std::size_t size)
 {
     if (size > oversize_threshold_) {
-        return make_intrusive<File_backed_memory_block>(size);
+        return make_intrusive<File_backed_memory_block>(size, directory_);
     }
-    return make_intrusive<Hybrid_memory_block>(size, oversize_threshold_);
+    return make_intrusive<Hybrid_memory_block>(size, oversize_threshold_, directory_);
 }
 
 }  // namespace abi_v1
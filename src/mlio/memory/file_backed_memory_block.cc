@@ -15,10 +15,13 @@
 
 #include "mlio/memory/file_backed_memory_block.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdlib>
+#include <string>
 #include <system_error>
 
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -29,33 +32,49 @@ using mlio::detail::current_error_code;
 namespace mlio {
 inline namespace abi_v1 {
 
-File_backed_memory_block::File_backed_memory_block(size_type size) : size_{size}
+File_backed_memory_block::File_backed_memory_block(size_type size, const std::string &directory)
 {
-    make_temporary_file();
+    make_temporary_file(directory);
 
-    if (size_ == 0) {
-        data_ = nullptr;
+    if (size > 0) {
+        set_capacity(size);
     }
-    else {
-        data_ = init_memory_map(size_);
+
+    size_ = size;
+}
+
+File_backed_memory_block::File_backed_memory_block(size_type size,
+                                                   Memory_span data,
+                                                   const std::string &directory)
+{
+    make_temporary_file(directory);
+
+    if (size > 0) {
+        write_data(data.first(std::min(data.size(), size)));
+
+        set_capacity(size);
     }
+
+    size_ = size;
 }
 
 File_backed_memory_block::~File_backed_memory_block()
 {
     if (data_ != nullptr) {
-        ::munmap(data_, size_);
+        ::munmap(data_, capacity_);
     }
 }
 
-void File_backed_memory_block::make_temporary_file()
+void File_backed_memory_block::make_temporary_file(const std::string &directory)
 {
-    std::string path{"/tmp/mlio-XXXXXX"};
+    std::string path = directory.empty() ? "/tmp" : directory;
+    if (path.back() != '/') {
+        path += '/';
+    }
+    path += "mlio-XXXXXX";
 
     fd_ = ::mkstemp(&path.front());
-
-    auto off = static_cast<::off_t>(size_);
-    if (fd_ == -1 || ::ftruncate(fd_.get(), off) != 0) {
+    if (fd_ == -1) {
         throw std::system_error{current_error_code(),
                                 "The file-backed memory block cannot be allocated."};
     }
@@ -63,40 +82,83 @@ void File_backed_memory_block::make_temporary_file()
     ::unlink(&path.front());
 }
 
+void File_backed_memory_block::write_data(Memory_span data)
+{
+    while (!data.empty()) {
+        ::ssize_t num_bytes_written = ::write(fd_.get(), data.data(), data.size());
+        if (num_bytes_written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{current_error_code(),
+                                    "The file-backed memory block cannot be allocated."};
+        }
+        data = data.subspan(static_cast<std::size_t>(num_bytes_written));
+    }
+}
+
 void File_backed_memory_block::resize(size_type size)
 {
     if (size == size_) {
         return;
     }
 
-    auto off = static_cast<::off_t>(size);
-    if (::ftruncate(fd_.get(), off) != 0) {
-        throw std::system_error{current_error_code(),
-                                "The file-backed memory block cannot be resized."};
+    if (size == 0) {
+        if (data_ != nullptr) {
+            ::munmap(data_, capacity_);
+        }
+
+        data_ = nullptr;
+
+        // Give the disk space back.
+        if (::ftruncate(fd_.get(), 0) != 0) {
+            throw std::system_error{current_error_code(),
+                                    "The file-backed memory block cannot be resized."};
+        }
+
+        capacity_ = 0;
+    }
+    else if (size > capacity_) {
+        // Grow geometrically so that appending to the block remaps the
+        // file only a logarithmic number of times.
+        set_capacity(std::max(size, 2 * capacity_));
     }
+    else if (size < size_) {
+        // Truncate the file so that the region past the new size reads
+        // as zeros if the block grows again.
+        set_capacity(size);
+    }
+
+    size_ = size;
+}
 
-    if (size_ == 0) {
-        data_ = init_memory_map(size);
-        size_ = size;
+void File_backed_memory_block::set_capacity(std::size_t capacity)
+{
+    if (capacity > capacity_) {
+        extend_file(capacity);
+    }
+    else {
+        auto off = static_cast<::off_t>(capacity);
+        if (::ftruncate(fd_.get(), off) != 0) {
+            throw std::system_error{current_error_code(),
+                                    "The file-backed memory block cannot be resized."};
+        }
     }
-    else if (size == 0) {
-        ::munmap(data_, size_);
 
-        data_ = nullptr;
-        size_ = 0;
+    if (capacity_ == 0) {
+        data_ = init_memory_map(capacity);
     }
     else {
 #ifdef MLIO_PLATFORM_LINUX
-        void *addr = ::mremap(data_, size_, size, MREMAP_MAYMOVE);
+        void *addr = ::mremap(data_, capacity_, capacity, MREMAP_MAYMOVE);
 
         validate_mapped_address(addr);
 
         data_ = static_cast<std::byte *>(addr);
-        size_ = size;
 #else
         std::byte *data{};
         try {
-            data = init_memory_map(size);
+            data = init_memory_map(capacity);
         }
         catch (const std::system_error &) {
             // We already truncated the backing file, but cannot map it
@@ -104,19 +166,47 @@ void File_backed_memory_block::resize(size_type size)
             // this means we lost the data in the truncated region. In
             // such case we should abort the process as there is no way
             // to recover gracefully.
-            if (size_ > size) {
+            if (capacity_ > capacity) {
                 std::abort();
             }
 
             throw;
         }
 
-        ::munmap(data_, size_);
+        ::munmap(data_, capacity_);
 
         data_ = data;
-        size_ = size;
 #endif
     }
+
+    capacity_ = capacity;
+}
+
+void File_backed_memory_block::extend_file(std::size_t capacity)
+{
+#ifdef MLIO_PLATFORM_LINUX
+    // Reserve the disk space up front; otherwise a full disk surfaces
+    // as a SIGBUS on the first write to the new pages.
+    auto len = static_cast<::off_t>(capacity);
+    if (::fallocate(fd_.get(), 0, 0, len) == 0) {
+        return;
+    }
+
+    if (errno != EOPNOTSUPP && errno != ENOSYS) {
+        if (errno == ENOSPC) {
+            throw std::bad_alloc{};
+        }
+        throw std::system_error{current_error_code(),
+                                "The file-backed memory block cannot be resized."};
+    }
+#endif
+
+    // Fall back to a sparse file.
+    auto off = static_cast<::off_t>(capacity);
+    if (::ftruncate(fd_.get(), off) != 0) {
+        throw std::system_error{current_error_code(),
+                                "The file-backed memory block cannot be resized."};
+    }
 }
 
 std::byte *File_backed_memory_block::init_memory_map(std::size_t size)
@@ -16,6 +16,7 @@
 #include "mlio/memory/file_mapped_memory_block.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <system_error>
 #include <utility>
 
@@ -65,13 +66,70 @@ void File_mapped_memory_block::init_memory_map()
         return;
     }
 
-    void *address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    void *address = map_file(fd.get());
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
     if (address == MAP_FAILED) {
         throw std::system_error{current_error_code(), "The file cannot be memory mapped."};
     }
 
     data_ = static_cast<std::byte *>(address);
+
+    // The mapping is mostly read front to back by the record readers;
+    // let the kernel read ahead aggressively and drop pages early.
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+}
+
+void *File_mapped_memory_block::map_file(int fd) const noexcept
+{
+#ifdef MLIO_PLATFORM_LINUX
+    constexpr std::size_t huge_page_size = 0x20'0000;  // 2 MiB
+
+    // Place large mappings at a huge page boundary so that the kernel
+    // can back them with transparent huge pages where supported. Note
+    // that this requires reserving a slightly larger address range.
+    if (size_ >= huge_page_size) {
+        std::size_t reserve_size = size_ + huge_page_size;
+
+        void *reserve = ::mmap(
+            nullptr, reserve_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reserve != MAP_FAILED) {
+            auto beg = reinterpret_cast<std::uintptr_t>(reserve);
+            auto end = beg + reserve_size;
+
+            auto aligned_beg = (beg + huge_page_size - 1) & ~(huge_page_size - 1);
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            void *address = ::mmap(reinterpret_cast<void *>(aligned_beg),
+                                   size_,
+                                   PROT_READ,
+                                   MAP_PRIVATE | MAP_FIXED,
+                                   fd,
+                                   0);
+            if (address != MAP_FAILED) {
+                auto page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+
+                auto aligned_end = (aligned_beg + size_ + page_size - 1) & ~(page_size - 1);
+
+                // Release the unused head and tail of the reservation.
+                if (aligned_beg > beg) {
+                    ::munmap(reserve, aligned_beg - beg);
+                }
+                if (end > aligned_end) {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                    ::munmap(reinterpret_cast<void *>(aligned_end), end - aligned_end);
+                }
+
+                ::madvise(address, size_, MADV_HUGEPAGE);
+
+                return address;
+            }
+
+            ::munmap(reserve, reserve_size);
+        }
+    }
+#endif
+
+    return ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
 }
 
 }  // namespace abi_v1
@@ -15,8 +15,12 @@
 
 #include "mlio/memory/memory_allocator.h"
 
+#include <atomic>
 #include <utility>
 
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/memory/memory_block.h"
+
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
@@ -24,6 +28,20 @@ namespace {
 
 std::unique_ptr<Memory_allocator> memory_allocator_{};
 
+// Counts the allocations of the default allocator while an allocation
+// audit is running; see start_allocation_audit().
+class Auditing_memory_allocator final : public Memory_allocator {
+public:
+    Intrusive_ptr<Mutable_memory_block> allocate(std::size_t size) final
+    {
+        count_allocation(Allocation_source::memory_block, size);
+
+        return memory_allocator_->allocate(size);
+    }
+};
+
+Auditing_memory_allocator auditing_memory_allocator_{};
+
 }  // namespace
 }  // namespace detail
 
@@ -31,6 +49,9 @@ Memory_allocator::~Memory_allocator() = default;
 
 Memory_allocator &memory_allocator() noexcept
 {
+    if (detail::allocation_audit_enabled.load(std::memory_order_relaxed)) {
+        return detail::auditing_memory_allocator_;
+    }
     return *detail::memory_allocator_;
 }
 
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/memory/page_memory_block.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+std::size_t get_page_size() noexcept
+{
+    static const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+    return page_size;
+}
+
+#ifdef MLIO_PLATFORM_LINUX
+
+// Maps the region at a huge page boundary so that the kernel can back
+// it with transparent huge pages; see File_mapped_memory_block.
+void *map_huge_pages(std::size_t size) noexcept
+{
+    constexpr std::size_t huge_page_size = 0x20'0000;  // 2 MiB
+
+    if (size < huge_page_size) {
+        return MAP_FAILED;  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    }
+
+    std::size_t reserve_size = size + huge_page_size;
+
+    void *reserve =
+        ::mmap(nullptr, reserve_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    if (reserve == MAP_FAILED) {
+        return reserve;
+    }
+
+    auto beg = reinterpret_cast<std::uintptr_t>(reserve);
+    auto end = beg + reserve_size;
+
+    auto aligned_beg = (beg + huge_page_size - 1) & ~(huge_page_size - 1);
+
+    std::uintptr_t page_size = get_page_size();
+
+    auto aligned_end = (aligned_beg + size + page_size - 1) & ~(page_size - 1);
+
+    // Release the unused head and tail of the reservation.
+    if (aligned_beg > beg) {
+        ::munmap(reserve, aligned_beg - beg);
+    }
+    if (end > aligned_end) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        ::munmap(reinterpret_cast<void *>(aligned_end), end - aligned_end);
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto *address = reinterpret_cast<void *>(aligned_beg);
+
+    // The advice has to be given before the pages are faulted in.
+    ::madvise(address, size, MADV_HUGEPAGE);
+
+    return address;
+}
+
+#endif
+
+void prefault_pages(std::byte *data, std::size_t size) noexcept
+{
+#if defined(MLIO_PLATFORM_LINUX) && defined(MADV_POPULATE_WRITE)
+    if (::madvise(data, size, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+
+    // The pages of an anonymous mapping are zero-filled, so writing a
+    // zero to each of them leaves the block intact.
+    volatile std::byte *ptr = data;
+    for (std::size_t i = 0; i < size; i += get_page_size()) {
+        ptr[i] = std::byte{};
+    }
+}
+
+std::byte *map_pages(std::size_t size, bool huge_pages, bool prefault)
+{
+    void *address = MAP_FAILED;  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+
+#ifdef MLIO_PLATFORM_LINUX
+    if (huge_pages) {
+        address = map_huge_pages(size);
+    }
+#endif
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    if (address == MAP_FAILED) {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MLIO_PLATFORM_LINUX
+        if (prefault) {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+        if (address == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+
+#ifdef MLIO_PLATFORM_LINUX
+        // Already faulted in by the kernel.
+        prefault = false;
+#endif
+    }
+
+    auto *data = static_cast<std::byte *>(address);
+
+    if (prefault) {
+        prefault_pages(data, size);
+    }
+
+    return data;
+}
+
+}  // namespace
+}  // namespace detail
+
+Page_memory_block::Page_memory_block(size_type size, bool huge_pages, bool prefault)
+    : size_{size}, huge_pages_{huge_pages}, prefault_{prefault}
+{
+    if (size_ > 0) {
+        data_ = detail::map_pages(size_, huge_pages_, prefault_);
+    }
+}
+
+Page_memory_block::~Page_memory_block()
+{
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+}
+
+void Page_memory_block::resize(size_type size)
+{
+    if (size == size_) {
+        return;
+    }
+
+    std::byte *data = nullptr;
+    if (size > 0) {
+        data = detail::map_pages(size, huge_pages_, prefault_);
+
+        if (data_ != nullptr) {
+            std::memcpy(data, data_, std::min(size, size_));
+        }
+    }
+
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+
+    data_ = data;
+    size_ = size;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,416 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/memory/slab_memory_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef MLIO_PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
+#include "mlio/detail/error.h"
+#include "mlio/detail/system_info.h"
+#include "mlio/memory/memory_block.h"
+
+using mlio::detail::current_error_code;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::size_t min_class_size = 0x1000;    // 4 KiB
+constexpr std::size_t min_mapped_size = 0x10000;  // 64 KiB
+constexpr std::size_t huge_page_size = 0x200000;  // 2 MiB
+
+constexpr std::size_t max_num_numa_nodes = sizeof(unsigned long) * 8;
+
+std::size_t round_up_to_class(std::size_t size) noexcept
+{
+    std::size_t class_size = min_class_size;
+    while (class_size < size) {
+        class_size <<= 1;
+    }
+    return class_size;
+}
+
+std::size_t get_class_index(std::size_t class_size) noexcept
+{
+    std::size_t idx = 0;
+    for (std::size_t s = min_class_size; s < class_size; s <<= 1) {
+        idx++;
+    }
+    return idx;
+}
+
+void bind_to_numa_node([[maybe_unused]] void *addr,
+                       [[maybe_unused]] std::size_t size,
+                       [[maybe_unused]] std::size_t node) noexcept
+{
+#ifdef MLIO_PLATFORM_LINUX
+    // Same as MPOL_PREFERRED in <numaif.h>; we call mbind directly to
+    // avoid a dependency on libnuma.
+    constexpr int mpol_preferred = 1;
+
+    unsigned long mask = 1UL << node;
+
+    // This is only a hint; if it fails, the pages will be placed by
+    // the default policy on first touch.
+    ::syscall(SYS_mbind, addr, size, mpol_preferred, &mask, max_num_numa_nodes + 1, 0);
+#endif
+}
+
+}  // namespace
+
+struct Slab_region {
+    std::byte *data{};
+    std::size_t capacity{};
+    std::size_t node{};
+};
+
+// Holds the free lists of the size classes. It is shared between an
+// allocator and its blocks so that the blocks can outlive it.
+class Slab_pool {
+    struct Node {
+        std::mutex mutex{};
+        std::vector<std::vector<std::byte *>> free_lists{};
+        std::size_t num_bytes_cached{};
+    };
+
+public:
+    explicit Slab_pool(const Slab_memory_allocator_params &params)
+        : params_{params}, nodes_(params.numa_aware ? get_num_numa_nodes() : 1)
+    {
+        std::size_t num_classes = get_class_index(round_up_to_class(params_.max_class_size)) + 1;
+
+        for (Node &node : nodes_) {
+            node.free_lists.resize(num_classes);
+        }
+    }
+
+    Slab_pool(const Slab_pool &) = delete;
+
+    Slab_pool &operator=(const Slab_pool &) = delete;
+
+    Slab_pool(Slab_pool &&) = delete;
+
+    Slab_pool &operator=(Slab_pool &&) = delete;
+
+    ~Slab_pool()
+    {
+        trim();
+    }
+
+    Slab_region acquire(std::size_t size);
+
+    void release(const Slab_region &region) noexcept;
+
+    Slab_memory_allocator_stats stats() const noexcept;
+
+    void trim() noexcept;
+
+private:
+    std::byte *map(std::size_t capacity, std::size_t node);
+
+    void unmap(std::byte *data, std::size_t capacity) noexcept;
+
+    bool is_pooled(std::size_t capacity) const noexcept
+    {
+        return capacity <= params_.max_class_size;
+    }
+
+    bool should_map(std::size_t capacity) const noexcept
+    {
+        return params_.numa_aware || capacity >= min_mapped_size;
+    }
+
+    Slab_memory_allocator_params params_;
+    std::vector<Node> nodes_;
+    std::atomic_size_t num_allocations_{};
+    std::atomic_size_t num_recycled_{};
+    std::atomic_size_t num_bytes_in_use_{};
+    std::atomic_size_t num_bytes_cached_{};
+};
+
+Slab_region Slab_pool::acquire(std::size_t size)
+{
+    Slab_region region{};
+
+    if (size == 0) {
+        return region;
+    }
+
+    if (size <= params_.max_class_size) {
+        region.capacity = round_up_to_class(size);
+    }
+    else {
+        region.capacity = (size + min_class_size - 1) & ~(min_class_size - 1);
+    }
+
+    if (params_.numa_aware) {
+        region.node = std::min(get_current_numa_node(), nodes_.size() - 1);
+    }
+
+    num_allocations_.fetch_add(1, std::memory_order_relaxed);
+
+    if (is_pooled(region.capacity)) {
+        Node &node = nodes_[region.node];
+
+        std::unique_lock<std::mutex> lock{node.mutex};
+
+        auto &free_list = node.free_lists[get_class_index(region.capacity)];
+        if (!free_list.empty()) {
+            region.data = free_list.back();
+
+            free_list.pop_back();
+
+            node.num_bytes_cached -= region.capacity;
+
+            lock.unlock();
+
+            num_recycled_.fetch_add(1, std::memory_order_relaxed);
+            num_bytes_cached_.fetch_sub(region.capacity, std::memory_order_relaxed);
+            num_bytes_in_use_.fetch_add(region.capacity, std::memory_order_relaxed);
+
+            return region;
+        }
+    }
+
+    region.data = map(region.capacity, region.node);
+
+    num_bytes_in_use_.fetch_add(region.capacity, std::memory_order_relaxed);
+
+    return region;
+}
+
+void Slab_pool::release(const Slab_region &region) noexcept
+{
+    if (region.data == nullptr) {
+        return;
+    }
+
+    num_bytes_in_use_.fetch_sub(region.capacity, std::memory_order_relaxed);
+
+    if (is_pooled(region.capacity)) {
+        Node &node = nodes_[region.node];
+
+        std::unique_lock<std::mutex> lock{node.mutex};
+
+        if (node.num_bytes_cached + region.capacity <= params_.max_cached_size) {
+            try {
+                node.free_lists[get_class_index(region.capacity)].emplace_back(region.data);
+
+                node.num_bytes_cached += region.capacity;
+
+                num_bytes_cached_.fetch_add(region.capacity, std::memory_order_relaxed);
+
+                return;
+            }
+            catch (const std::bad_alloc &) {
+            }
+        }
+    }
+
+    unmap(region.data, region.capacity);
+}
+
+Slab_memory_allocator_stats Slab_pool::stats() const noexcept
+{
+    Slab_memory_allocator_stats stats{};
+
+    stats.num_allocations = num_allocations_.load(std::memory_order_relaxed);
+    stats.num_recycled = num_recycled_.load(std::memory_order_relaxed);
+    stats.num_bytes_in_use = num_bytes_in_use_.load(std::memory_order_relaxed);
+    stats.num_bytes_cached = num_bytes_cached_.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void Slab_pool::trim() noexcept
+{
+    for (Node &node : nodes_) {
+        std::unique_lock<std::mutex> lock{node.mutex};
+
+        std::size_t capacity = min_class_size;
+        for (auto &free_list : node.free_lists) {
+            for (std::byte *data : free_list) {
+                unmap(data, capacity);
+            }
+            free_list.clear();
+
+            capacity <<= 1;
+        }
+
+        num_bytes_cached_.fetch_sub(node.num_bytes_cached, std::memory_order_relaxed);
+
+        node.num_bytes_cached = 0;
+    }
+}
+
+std::byte *Slab_pool::map(std::size_t capacity, std::size_t node)
+{
+    if (!should_map(capacity)) {
+        void *data = std::malloc(capacity);  // NOLINT
+        if (data == nullptr) {
+            throw std::bad_alloc{};
+        }
+        return static_cast<std::byte *>(data);
+    }
+
+    void *addr = ::mmap(/*addr*/ nullptr,
+                        capacity,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS,
+                        /*fd*/ -1,
+                        /*offset*/ 0);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    if (addr == MAP_FAILED) {
+        if (errno == ENOMEM) {
+            throw std::bad_alloc{};
+        }
+        throw std::system_error{current_error_code(), "The slab memory block cannot be mapped."};
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (params_.use_huge_pages && capacity >= huge_page_size) {
+        ::madvise(addr, capacity, MADV_HUGEPAGE);
+    }
+#endif
+
+    if (params_.numa_aware) {
+        bind_to_numa_node(addr, capacity, node);
+    }
+
+    return static_cast<std::byte *>(addr);
+}
+
+void Slab_pool::unmap(std::byte *data, std::size_t capacity) noexcept
+{
+    if (should_map(capacity)) {
+        ::munmap(data, capacity);
+    }
+    else {
+        std::free(data);  // NOLINT
+    }
+}
+
+namespace {
+
+class Slab_memory_block final : public Mutable_memory_block {
+public:
+    explicit Slab_memory_block(std::shared_ptr<Slab_pool> pool, size_type size)
+        : pool_{std::move(pool)}, region_{pool_->acquire(size)}, size_{size}
+    {}
+
+    Slab_memory_block(const Slab_memory_block &) = delete;
+
+    Slab_memory_block &operator=(const Slab_memory_block &) = delete;
+
+    Slab_memory_block(Slab_memory_block &&) = delete;
+
+    Slab_memory_block &operator=(Slab_memory_block &&) = delete;
+
+    ~Slab_memory_block() override
+    {
+        pool_->release(region_);
+    }
+
+    void resize(size_type size) final
+    {
+        // The region is already large enough; there is nothing to do
+        // other than updating the size.
+        if (size <= region_.capacity) {
+            size_ = size;
+
+            return;
+        }
+
+        Slab_region region = pool_->acquire(size);
+
+        if (size_ > 0) {
+            std::copy_n(region_.data, size_, region.data);
+        }
+
+        pool_->release(std::exchange(region_, region));
+
+        size_ = size;
+    }
+
+    pointer data() noexcept final
+    {
+        return region_.data;
+    }
+
+    const_pointer data() const noexcept final
+    {
+        return region_.data;
+    }
+
+    size_type size() const noexcept final
+    {
+        return size_;
+    }
+
+    bool resizable() const noexcept final
+    {
+        return true;
+    }
+
+private:
+    std::shared_ptr<Slab_pool> pool_;
+    Slab_region region_;
+    size_type size_;
+};
+
+}  // namespace
+}  // namespace detail
+
+Slab_memory_allocator::Slab_memory_allocator(const Slab_memory_allocator_params &params)
+    : pool_{std::make_shared<detail::Slab_pool>(params)}
+{}
+
+Slab_memory_allocator::~Slab_memory_allocator() = default;
+
+Intrusive_ptr<Mutable_memory_block> Slab_memory_allocator::allocate(std::size_t size)
+{
+    return make_intrusive<detail::Slab_memory_block>(pool_, size);
+}
+
+Slab_memory_allocator_stats Slab_memory_allocator::stats() const noexcept
+{
+    return pool_->stats();
+}
+
+void Slab_memory_allocator::trim() noexcept
+{
+    pool_->trim();
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/object_store_client.h"
+
+#include <utility>
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Object_store_client::Object_store_client(const Range_read_params &range_read_params,
+                                         Intrusive_ptr<S3_object_cache> object_cache) noexcept
+    : range_read_params_{range_read_params}, object_cache_{std::move(object_cache)}
+{}
+
+Object_store_client::~Object_store_client() = default;
+
+std::size_t Object_store_client::read_object_size(std::string_view bucket,
+                                                  std::string_view key,
+                                                  std::string_view version_id) const
+{
+    return read_object_metadata(bucket, key, version_id).size;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,807 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/orc_reader.h"
+
+#ifdef MLIO_BUILD_ORC_READER
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <orc/OrcFile.hh>
+#include <tbb/tbb.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/record_readers/record_reader_base.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Orc_file_info {
+    // The serialized postscript, footer, and metadata of the file; passed
+    // to the ORC readers so that they do not read the tail again.
+    std::string file_tail{};
+    std::size_t file_size{};
+    // The column ids, names, and data types of the columns to read.
+    std::vector<std::uint64_t> column_ids{};
+    std::vector<std::string> column_names{};
+    std::vector<Data_type> column_types{};
+};
+
+namespace {
+
+// The streams that are at most this many bytes apart are fetched with a
+// single read.
+constexpr std::size_t max_range_gap = 0x2000;  // 8 KiB
+
+// "MLST"
+constexpr std::uint32_t stripe_record_magic = 0x54534C4D;
+
+// Each record read by the stripe reader starts with this header and an
+// array of byte ranges, followed by the contents of those ranges in the
+// order they are listed.
+struct Stripe_record_header {
+    std::uint32_t magic;
+    std::uint32_t stripe;
+    std::uint64_t offset;
+    std::uint64_t num_rows;
+    std::uint64_t num_ranges;
+};
+
+struct Byte_range {
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+void read_fully(Input_stream &stream, Mutable_memory_span destination)
+{
+    while (!destination.empty()) {
+        std::size_t num_bytes_read = stream.read(destination);
+        if (num_bytes_read == 0) {
+            throw Corrupt_record_error{"The ORC file ends unexpectedly."};
+        }
+
+        destination = destination.subspan(num_bytes_read);
+    }
+}
+
+// Exposes an Input_stream to the ORC library.
+class Orc_input_stream final : public orc::InputStream {
+public:
+    explicit Orc_input_stream(Intrusive_ptr<Input_stream> stream, std::string name)
+        : stream_{std::move(stream)}, name_{std::move(name)}
+    {}
+
+    std::uint64_t getLength() const final
+    {
+        return stream_->size();
+    }
+
+    std::uint64_t getNaturalReadSize() const final
+    {
+        return 0x100000;  // 1 MiB
+    }
+
+    void read(void *buf, std::uint64_t length, std::uint64_t offset) final
+    {
+        stream_->seek(offset);
+
+        read_fully(*stream_, Mutable_memory_span{static_cast<std::byte *>(buf), length});
+    }
+
+    const std::string &getName() const final
+    {
+        return name_;
+    }
+
+private:
+    Intrusive_ptr<Input_stream> stream_;
+    std::string name_;
+};
+
+std::optional<Data_type> get_data_type(const orc::Type &type) noexcept
+{
+    switch (type.getKind()) {
+    case orc::BOOLEAN:
+        return Data_type::uint8;
+    case orc::BYTE:
+        return Data_type::int8;
+    case orc::SHORT:
+        return Data_type::int16;
+    case orc::INT:
+        return Data_type::int32;
+    case orc::LONG:
+        return Data_type::int64;
+    case orc::FLOAT:
+        return Data_type::float32;
+    case orc::DOUBLE:
+        return Data_type::float64;
+    case orc::STRING:
+    case orc::VARCHAR:
+    case orc::CHAR:
+    case orc::BINARY:
+        return Data_type::string;
+    default:
+        return {};
+    }
+}
+
+// Reads the streams of the selected columns of an ORC file; each record
+// corresponds to a single stripe.
+class Orc_stripe_reader final : public Record_reader_base {
+public:
+    explicit Orc_stripe_reader(Intrusive_ptr<Input_stream> stream,
+                               std::string name,
+                               std::shared_ptr<const Orc_file_info> info);
+
+private:
+    std::optional<Record> read_record_core() final;
+
+    std::vector<Byte_range> get_byte_ranges(const orc::StripeInformation &stripe) const;
+
+    Intrusive_ptr<Input_stream> stream_;
+    std::shared_ptr<const Orc_file_info> info_;
+    std::unique_ptr<orc::Reader> reader_;
+    std::uint64_t stripe_idx_{};
+};
+
+Orc_stripe_reader::Orc_stripe_reader(Intrusive_ptr<Input_stream> stream,
+                                     std::string name,
+                                     std::shared_ptr<const Orc_file_info> info)
+    : stream_{std::move(stream)}, info_{std::move(info)}
+{
+    orc::ReaderOptions opts{};
+    opts.setSerializedFileTail(info_->file_tail);
+
+    reader_ = orc::createReader(std::make_unique<Orc_input_stream>(stream_, std::move(name)), opts);
+}
+
+std::optional<Record> Orc_stripe_reader::read_record_core()
+{
+    if (stripe_idx_ == reader_->getNumberOfStripes()) {
+        return {};
+    }
+
+    std::uint64_t stripe_idx = stripe_idx_++;
+
+    std::unique_ptr<orc::StripeInformation> stripe{};
+    std::vector<Byte_range> ranges{};
+    try {
+        stripe = reader_->getStripe(stripe_idx);
+
+        ranges = get_byte_ranges(*stripe);
+    }
+    catch (const orc::ParseError &e) {
+        throw Corrupt_record_error{
+            fmt::format("The footer of the stripe #{0:n} cannot be parsed: {1}", stripe_idx, e.what())};
+    }
+
+    std::size_t header_size = sizeof(Stripe_record_header) + ranges.size() * sizeof(Byte_range);
+
+    std::size_t size = header_size;
+    for (const Byte_range &range : ranges) {
+        size += range.size;
+    }
+
+    auto block = memory_allocator().allocate(size);
+
+    Mutable_memory_span bits{*block};
+
+    Stripe_record_header header{stripe_record_magic,
+                                static_cast<std::uint32_t>(stripe_idx),
+                                stripe->getOffset(),
+                                stripe->getNumberOfRows(),
+                                ranges.size()};
+
+    std::memcpy(bits.data(), &header, sizeof(header));
+    std::memcpy(bits.data() + sizeof(header), ranges.data(), ranges.size() * sizeof(Byte_range));
+
+    bits = bits.subspan(header_size);
+
+    for (const Byte_range &range : ranges) {
+        stream_->seek(range.offset);
+
+        read_fully(*stream_, bits.first(range.size));
+
+        bits = bits.subspan(range.size);
+    }
+
+    return Record{Memory_slice{std::move(block)}};
+}
+
+std::vector<Byte_range>
+Orc_stripe_reader::get_byte_ranges(const orc::StripeInformation &stripe) const
+{
+    std::vector<Byte_range> stream_ranges{};
+
+    // The stripe footer is needed to locate the streams.
+    stream_ranges.push_back({stripe.getOffset() + stripe.getIndexLength() + stripe.getDataLength(),
+                             stripe.getFooterLength()});
+
+    for (std::uint64_t i = 0; i < stripe.getNumberOfStreams(); i++) {
+        std::unique_ptr<orc::StreamInformation> stream = stripe.getStreamInformation(i);
+
+        orc::StreamKind kind = stream->getKind();
+        if (kind == orc::StreamKind_BLOOM_FILTER || kind == orc::StreamKind_BLOOM_FILTER_UTF8) {
+            continue;
+        }
+
+        // The root column might have a present stream.
+        std::uint64_t column_id = stream->getColumnId();
+        if (column_id != 0) {
+            auto pos = std::find(info_->column_ids.begin(), info_->column_ids.end(), column_id);
+            if (pos == info_->column_ids.end()) {
+                continue;
+            }
+        }
+
+        stream_ranges.push_back({stream->getOffset(), stream->getLength()});
+    }
+
+    std::sort(stream_ranges.begin(), stream_ranges.end(), [](const auto &a, const auto &b) {
+        return a.offset < b.offset;
+    });
+
+    // Coalesce the ranges that are close to each other.
+    std::vector<Byte_range> ranges{};
+    for (const Byte_range &range : stream_ranges) {
+        if (!ranges.empty()) {
+            Byte_range &last = ranges.back();
+
+            std::uint64_t last_end = last.offset + last.size;
+            if (range.offset <= last_end + max_range_gap) {
+                last.size = std::max(last_end, range.offset + range.size) - last.offset;
+
+                continue;
+            }
+        }
+
+        ranges.emplace_back(range);
+    }
+
+    return ranges;
+}
+
+// Exposes the byte ranges of a stripe record as a sparse ORC file to the
+// ORC library.
+class Stripe_file final : public orc::InputStream {
+public:
+    explicit Stripe_file(Memory_span bits, std::size_t file_size, std::string name)
+        : bits_{bits}, file_size_{file_size}, name_{std::move(name)}
+    {}
+
+    // Parses the header of the record. Returns false if the record is
+    // malformed.
+    bool init(Stripe_record_header &header);
+
+    std::uint64_t getLength() const final
+    {
+        return file_size_;
+    }
+
+    std::uint64_t getNaturalReadSize() const final
+    {
+        return 0x100000;  // 1 MiB
+    }
+
+    void read(void *buf, std::uint64_t length, std::uint64_t offset) final;
+
+    const std::string &getName() const final
+    {
+        return name_;
+    }
+
+private:
+    struct Fetched_range {
+        std::uint64_t offset;
+        Memory_span bits;
+    };
+
+    Memory_span bits_;
+    std::size_t file_size_;
+    std::string name_;
+    std::vector<Fetched_range> ranges_{};
+};
+
+bool Stripe_file::init(Stripe_record_header &header)
+{
+    Memory_span bits = bits_;
+
+    if (bits.size() < sizeof(header)) {
+        return false;
+    }
+
+    std::memcpy(&header, bits.data(), sizeof(header));
+    if (header.magic != stripe_record_magic) {
+        return false;
+    }
+
+    bits = bits.subspan(sizeof(header));
+
+    if (header.num_ranges > bits.size() / sizeof(Byte_range)) {
+        return false;
+    }
+
+    std::vector<Byte_range> ranges(header.num_ranges);
+
+    std::memcpy(ranges.data(), bits.data(), ranges.size() * sizeof(Byte_range));
+
+    bits = bits.subspan(ranges.size() * sizeof(Byte_range));
+
+    ranges_.reserve(ranges.size());
+
+    for (const Byte_range &range : ranges) {
+        if (range.size > bits.size()) {
+            return false;
+        }
+
+        ranges_.push_back({range.offset, bits.first(range.size)});
+
+        bits = bits.subspan(range.size);
+    }
+
+    return true;
+}
+
+void Stripe_file::read(void *buf, std::uint64_t length, std::uint64_t offset)
+{
+    for (const Fetched_range &range : ranges_) {
+        if (offset >= range.offset && offset + length <= range.offset + range.bits.size()) {
+            std::memcpy(buf, range.bits.data() + (offset - range.offset), length);
+
+            return;
+        }
+    }
+
+    throw std::runtime_error{fmt::format(
+        "The byte range [{0}, {1}) of the ORC file has not been fetched.", offset, offset + length)};
+}
+
+template<typename T>
+T get_null_value() noexcept
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    else {
+        return T{};
+    }
+}
+
+template<typename T, typename Batch, typename Convert>
+void copy_values(const orc::ColumnVectorBatch &column,
+                 Device_array_span arr,
+                 std::size_t row_offset,
+                 Convert convert)
+{
+    const auto &batch = dynamic_cast<const Batch &>(column);
+
+    auto destination = arr.as<T>().subspan(row_offset, batch.numElements);
+
+    for (std::size_t i = 0; i < destination.size(); i++) {
+        if (batch.hasNulls && batch.notNull.data()[i] == 0) {
+            destination[i] = get_null_value<T>();
+        }
+        else {
+            destination[i] = convert(batch, i);
+        }
+    }
+}
+
+template<typename T>
+void copy_long_values(const orc::ColumnVectorBatch &column,
+                      Device_array_span arr,
+                      std::size_t row_offset)
+{
+    copy_values<T, orc::LongVectorBatch>(
+        column, arr, row_offset, [](const orc::LongVectorBatch &batch, std::size_t i) {
+            return static_cast<T>(batch.data.data()[i]);
+        });
+}
+
+template<typename T>
+void copy_double_values(const orc::ColumnVectorBatch &column,
+                        Device_array_span arr,
+                        std::size_t row_offset)
+{
+    copy_values<T, orc::DoubleVectorBatch>(
+        column, arr, row_offset, [](const orc::DoubleVectorBatch &batch, std::size_t i) {
+            return static_cast<T>(batch.data.data()[i]);
+        });
+}
+
+void copy_column(const orc::ColumnVectorBatch &column,
+                 Data_type dt,
+                 Device_array_span arr,
+                 std::size_t row_offset)
+{
+    switch (dt) {
+    case Data_type::uint8:
+        copy_long_values<std::uint8_t>(column, arr, row_offset);
+        break;
+    case Data_type::int8:
+        copy_long_values<std::int8_t>(column, arr, row_offset);
+        break;
+    case Data_type::int16:
+        copy_long_values<std::int16_t>(column, arr, row_offset);
+        break;
+    case Data_type::int32:
+        copy_long_values<std::int32_t>(column, arr, row_offset);
+        break;
+    case Data_type::int64:
+        copy_long_values<std::int64_t>(column, arr, row_offset);
+        break;
+    case Data_type::float32:
+        copy_double_values<float>(column, arr, row_offset);
+        break;
+    case Data_type::float64:
+        copy_double_values<double>(column, arr, row_offset);
+        break;
+    case Data_type::string:
+        copy_values<std::string, orc::StringVectorBatch>(
+            column, arr, row_offset, [](const orc::StringVectorBatch &batch, std::size_t i) {
+                return std::string(batch.data.data()[i],
+                                   static_cast<std::size_t>(batch.length.data()[i]));
+            });
+        break;
+    default:
+        throw Not_supported_error{"The column has an unsupported type."};
+    }
+}
+
+struct Stripe {
+    std::shared_ptr<const Orc_file_info> info{};
+    Memory_span bits{};
+    std::size_t stripe_idx{};
+    std::uint64_t offset{};
+    std::size_t row_offset{};
+    std::size_t num_rows{};
+};
+
+void decode_stripe(const Stripe &stripe,
+                   const Data_store &store,
+                   std::vector<Intrusive_ptr<Dense_tensor>> &tensors)
+{
+    const Orc_file_info &info = *stripe.info;
+
+    auto file = std::make_unique<Stripe_file>(stripe.bits, info.file_size, store.id());
+
+    Stripe_record_header header{};
+    if (!file->init(header)) {
+        throw Corrupt_record_error{"The stripe record is malformed."};
+    }
+
+    orc::ReaderOptions opts{};
+    opts.setSerializedFileTail(info.file_tail);
+
+    std::unique_ptr<orc::Reader> reader = orc::createReader(std::move(file), opts);
+
+    orc::RowReaderOptions row_opts{};
+    row_opts.include(std::list<std::string>(info.column_names.begin(), info.column_names.end()));
+
+    // Selects the stripe that starts at the specified offset.
+    row_opts.range(stripe.offset, 1);
+
+    std::unique_ptr<orc::RowReader> row_reader = reader->createRowReader(row_opts);
+
+    std::unique_ptr<orc::ColumnVectorBatch> batch = row_reader->createRowBatch(stripe.num_rows);
+
+    if (stripe.num_rows > 0 && !row_reader->next(*batch)) {
+        throw Corrupt_record_error{"The stripe has no rows."};
+    }
+
+    if (batch->numElements != stripe.num_rows) {
+        throw Corrupt_record_error{"The stripe has fewer rows than its footer specifies."};
+    }
+
+    const auto &root = dynamic_cast<const orc::StructVectorBatch &>(*batch);
+
+    if (root.fields.size() != tensors.size()) {
+        throw Corrupt_record_error{"The stripe does not have the selected columns."};
+    }
+
+    for (std::size_t i = 0; i < tensors.size(); i++) {
+        copy_column(*root.fields[i], info.column_types[i], tensors[i]->data(), stripe.row_offset);
+    }
+}
+
+}  // namespace
+}  // namespace detail
+
+Orc_reader::Orc_reader(Data_reader_params params, Orc_reader_params orc_params)
+    : Parallel_data_reader{std::move(params)}, params_{std::move(orc_params)}
+{}
+
+Orc_reader::~Orc_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Orc_reader::make_record_reader(const Data_store &store)
+{
+    auto stream = store.open_read();
+
+    std::shared_ptr<const detail::Orc_file_info> info = read_file_info(store, stream);
+
+    return make_intrusive<detail::Orc_stripe_reader>(
+        std::move(stream), store.id(), std::move(info));
+}
+
+std::shared_ptr<const detail::Orc_file_info>
+Orc_reader::read_file_info(const Data_store &store, Intrusive_ptr<Input_stream> stream)
+{
+    if (!stream->seekable()) {
+        throw Not_supported_error{fmt::format(
+            "The data store '{0}' is not seekable. ORC files cannot be read from compressed or streamed data stores.",
+            store.id())};
+    }
+
+    auto info = std::make_shared<detail::Orc_file_info>();
+
+    info->file_size = stream->size();
+
+    std::unique_ptr<orc::Reader> reader{};
+    try {
+        reader = orc::createReader(
+            std::make_unique<detail::Orc_input_stream>(std::move(stream), store.id()),
+            orc::ReaderOptions{});
+    }
+    catch (const orc::ParseError &e) {
+        throw Corrupt_footer_error{fmt::format(
+            "The data store '{0}' is not a valid ORC file: {1}", store.id(), e.what())};
+    }
+
+    info->file_tail = reader->getSerializedFileTail();
+
+    const orc::Type &root = reader->getType();
+    if (root.getKind() != orc::STRUCT) {
+        throw Not_supported_error{fmt::format(
+            "The ORC file in the data store '{0}' does not have a struct schema.", store.id())};
+    }
+
+    for (std::uint64_t i = 0; i < root.getSubtypeCount(); i++) {
+        const orc::Type &type = *root.getSubtype(i);
+
+        const std::string &name = root.getFieldName(i);
+
+        if (!params_.use_columns.empty() && params_.use_columns.count(name) == 0) {
+            continue;
+        }
+
+        std::optional<Data_type> dt = detail::get_data_type(type);
+        if (dt == std::nullopt) {
+            if (params_.use_columns.empty()) {
+                continue;
+            }
+
+            throw Not_supported_error{fmt::format(
+                "The column '{0}' in the data store '{1}' is of an unsupported type.",
+                name,
+                store.id())};
+        }
+
+        info->column_ids.emplace_back(type.getColumnId());
+        info->column_names.emplace_back(name);
+        info->column_types.emplace_back(*dt);
+    }
+
+    if (!params_.use_columns.empty() && info->column_names.size() != params_.use_columns.size()) {
+        for (const std::string &name : params_.use_columns) {
+            auto pos = std::find(info->column_names.begin(), info->column_names.end(), name);
+            if (pos == info->column_names.end()) {
+                throw Schema_error{fmt::format(
+                    "The data store '{0}' does not have a column named '{1}'.", store.id(), name)};
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock{file_info_mutex_};
+
+    file_infos_[&store] = info;
+
+    return info;
+}
+
+std::shared_ptr<const detail::Orc_file_info>
+Orc_reader::get_file_info(const Data_store &store) const
+{
+    std::unique_lock<std::mutex> lock{file_info_mutex_};
+
+    auto pos = file_infos_.find(&store);
+    if (pos == file_infos_.end()) {
+        throw std::logic_error{"The file tail of the ORC file has not been read."};
+    }
+
+    return pos->second;
+}
+
+Intrusive_ptr<const Schema> Orc_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    std::vector<Attribute> attrs{};
+
+    if (instance) {
+        std::shared_ptr<const detail::Orc_file_info> info = get_file_info(instance->data_store());
+
+        // The number of rows in an example depends on the stripes it
+        // contains.
+        for (std::size_t i = 0; i < info->column_names.size(); i++) {
+            attrs.emplace_back(info->column_names[i], info->column_types[i], Size_vector{0, 1});
+        }
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Orc_reader::decode(const Instance_batch &batch) const
+{
+    const std::vector<Attribute> &attrs = schema()->attributes();
+
+    std::vector<detail::Stripe> stripes{};
+    stripes.reserve(batch.num_instances());
+
+    std::size_t num_rows = 0;
+
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        const Data_store &store = batch.data_store(i);
+
+        detail::Stripe &stripe = stripes.emplace_back();
+
+        stripe.info = get_file_info(store);
+        stripe.bits = batch.bits(i);
+
+        detail::Stripe_record_header header{};
+        if (stripe.bits.size() < sizeof(header)) {
+            throw Invalid_instance_error{fmt::format(
+                "The stripe #{1:n} in the data store '{0}' is malformed.",
+                store.id(),
+                batch.instance_index(i))};
+        }
+
+        std::memcpy(&header, stripe.bits.data(), sizeof(header));
+
+        const detail::Orc_file_info &info = *stripe.info;
+
+        bool matches_schema = info.column_names.size() == attrs.size();
+        for (std::size_t j = 0; j < attrs.size() && matches_schema; j++) {
+            matches_schema = info.column_names[j] == attrs[j].name() &&
+                             info.column_types[j] == attrs[j].data_type();
+        }
+
+        if (!matches_schema) {
+            throw Schema_error{fmt::format(
+                "The columns of the ORC file in the data store '{0}' do not match the schema of the dataset.",
+                store.id())};
+        }
+
+        stripe.stripe_idx = header.stripe;
+        stripe.offset = header.offset;
+        stripe.row_offset = num_rows;
+        stripe.num_rows = static_cast<std::size_t>(header.num_rows);
+
+        num_rows += stripe.num_rows;
+    }
+
+    std::vector<Intrusive_ptr<Dense_tensor>> tensors{};
+    tensors.reserve(attrs.size());
+
+    for (const Attribute &attr : attrs) {
+        auto arr = make_pooled_cpu_array(attr.data_type(), num_rows);
+
+        tensors.emplace_back(
+            make_intrusive<Dense_tensor>(Size_vector{num_rows, 1}, std::move(arr)));
+    }
+
+    // Each stripe of the batch is decoded by a separate task.
+    auto worker = [&](const tbb::blocked_range<std::size_t> &range) {
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            const Data_store &store = batch.data_store(i);
+
+            try {
+                detail::decode_stripe(stripes[i], store, tensors);
+            }
+            catch (const std::exception &e) {
+                throw Invalid_instance_error{
+                    fmt::format("The stripe #{1:n} in the data store '{0}' cannot be decoded: {2}",
+                                store.id(),
+                                stripes[i].stripe_idx,
+                                e.what())};
+            }
+        }
+    };
+
+    tbb::blocked_range<std::size_t> range{0, stripes.size()};
+
+    if (stripes.size() > 1 && should_decode_parallel(num_rows, attrs.size())) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(range);
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> features{tensors.begin(), tensors.end()};
+
+    return make_intrusive<Example>(schema(), std::move(features));
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+Orc_reader::Orc_reader(Data_reader_params params, Orc_reader_params)
+    : Parallel_data_reader{std::move(params)}
+{
+    throw Not_supported_error{"MLIO was not built with ORC reader support."};
+}
+
+Orc_reader::~Orc_reader() = default;
+
+Intrusive_ptr<Record_reader> Orc_reader::make_record_reader(const Data_store &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<const Schema> Orc_reader::infer_schema(const std::optional<Instance> &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<Example> Orc_reader::decode(const Instance_batch &) const
+{
+    return nullptr;
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -15,35 +15,379 @@
 
 #include "mlio/parallel_data_reader.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include <tbb/tbb.h>
 
+#include <fmt/format.h>
+
+#include "mlio/cpu_array.h"
 #include "mlio/data_reader.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/in_memory_store.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/array_group.h"
+#include "mlio/detail/cuda_transfer.h"
+#include "mlio/detail/decode_warning_log.h"
+#include "mlio/detail/reader_task_arena.h"
+#include "mlio/detail/ring_buffer.h"
+#include "mlio/detail/store_metrics.h"
 #include "mlio/detail/thread.h"
+#include "mlio/detail/tracing.h"
 #include "mlio/example.h"
+#include "mlio/example_transform.h"
+#include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/instance_batch_reader.h"
 #include "mlio/instance_readers/instance_reader.h"
+#include "mlio/logger.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record.h"
 #include "mlio/record_readers/record_reader.h"
+#include "mlio/record_readers/stream_record_reader.h"
+#include "mlio/recordio_index.h"
+#include "mlio/tensor.h"
 
 using mlio::detail::Instance_batch_reader;
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace {
+
+using Stats_clock = std::chrono::steady_clock;
+
+// Accumulates the number of calls to and the time spent in a pipeline
+// stage. The counters are updated by the flow graph tasks concurrently.
+class Stage_counter {
+public:
+    void add(Stats_clock::duration elapsed) noexcept
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+        num_calls_.fetch_add(1, std::memory_order_relaxed);
+
+        total_ns_.fetch_add(static_cast<std::uint64_t>(ns), std::memory_order_relaxed);
+    }
+
+    void snapshot(const Stage_stats &last, Stage_stats &stats) const noexcept
+    {
+        stats.num_calls = num_calls_.load(std::memory_order_relaxed);
+        stats.total_ns = total_ns_.load(std::memory_order_relaxed);
+
+        stats.window_num_calls = stats.num_calls - last.num_calls;
+        stats.window_ns = stats.total_ns - last.total_ns;
+    }
+
+    std::uint64_t total_ns() const noexcept
+    {
+        return total_ns_.load(std::memory_order_relaxed);
+    }
+
+    void reset() noexcept
+    {
+        num_calls_.store(0, std::memory_order_relaxed);
+        total_ns_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> num_calls_{};
+    std::atomic<std::uint64_t> total_ns_{};
+};
+
+// Adds the lifetime of the timer to the specified stage counter.
+class Stage_timer {
+public:
+    explicit Stage_timer(Stage_counter &counter) noexcept
+        : counter_{&counter}, start_{Stats_clock::now()}
+    {}
+
+    Stage_timer(const Stage_timer &) = delete;
+
+    Stage_timer &operator=(const Stage_timer &) = delete;
+
+    Stage_timer(Stage_timer &&) = delete;
+
+    Stage_timer &operator=(Stage_timer &&) = delete;
+
+    ~Stage_timer()
+    {
+        counter_->add(Stats_clock::now() - start_);
+    }
+
+private:
+    Stage_counter *counter_;
+    Stats_clock::time_point start_;
+};
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+// Returns the approximate memory footprint of the specified example;
+// only its dense tensors are taken into account.
+std::size_t get_size_bytes(const Example &example)
+{
+    // The footprint must not change as the features of a lazy example
+    // are materialized; it is charged to and released from the memory
+    // budget at different times.
+    if (example.feature_source() != nullptr) {
+        return example.feature_source()->size_bytes();
+    }
+
+    std::size_t num_bytes = 0;
+
+    for (const Intrusive_ptr<Tensor> &tensor : example.features()) {
+        auto *dense = dynamic_cast<const Dense_tensor *>(tensor.get());
+        if (dense != nullptr) {
+            num_bytes += dense->data().size() * dispatch<Element_size_op>(dense->data_type());
+        }
+    }
+
+    return num_bytes;
+}
+
+// The number of values that the current thread decodes serially in
+// the batch at hand; set by should_decode_parallel() and consumed by
+// the decode node to measure the per-value decode cost.
+thread_local std::size_t num_serial_decode_values_{};
+
+// Describes the position in the dataset right after the instances of
+// a batch.
+struct Checkpoint {
+    std::size_t num_examples{};
+    std::size_t num_instances{};
+    std::optional<std::vector<std::size_t>> position{};
+};
+
+// An estimate of the number of instances in a data store is
+// extrapolated from a chunk at the beginning of each of a few byte
+// ranges of the data store.
+constexpr std::size_t num_count_sample_chunks = 8;
+constexpr std::size_t count_sample_chunk_size = 0x4'0000;  // 256 KiB
+
+// In exact mode a data store is split into byte ranges of at least
+// this size that are counted in parallel.
+constexpr std::size_t count_shard_size = 0x200'0000;  // 32 MiB
+
+inline bool is_first_record_part(const Record &record) noexcept
+{
+    return record.kind() == Record_kind::complete || record.kind() == Record_kind::begin;
+}
+
+// Counts the remaining records of the specified reader; a record that
+// is split into several parts counts once.
+std::size_t count_records(Record_reader &reader)
+{
+    std::size_t num_records = 0;
+
+    std::optional<Record> record{};
+    while ((record = reader.read_record())) {
+        if (is_first_record_part(*record)) {
+            num_records++;
+        }
+    }
+
+    return num_records;
+}
+
+}  // namespace
 
 // Used as a message in the TBB flow graph.
 struct Batch_msg {
     std::shared_ptr<Instance_batch> batch{};
+    // The number of bytes charged to the memory budget for the batch.
+    std::size_t num_bytes{};
+    Checkpoint checkpoint{};
 };
 
 // Used as a message in the TBB flow graph.
 struct Example_msg {
     std::size_t idx{};
     Intrusive_ptr<Example> example{};
+    // The number of bytes charged to the memory budget for the example.
+    std::size_t num_bytes{};
+    // The time the example has left the decode or the last transform
+    // node.
+    Stats_clock::time_point decoded_at{};
+    Checkpoint checkpoint{};
+};
+
+// Orders the batches waiting to be decoded so that the one that the
+// sequencer needs first is decoded first.
+struct Sooner_batch_first {
+    bool operator()(const Batch_msg &a, const Batch_msg &b) const noexcept
+    {
+        return a.batch->index() > b.batch->index();
+    }
+};
+
+// Reads the instance batches of an epoch ahead of the flow graph on a
+// thread of its own. This way the reads that block on the data stores
+// do not hold the worker threads of the graph, which are then left to
+// the CPU-bound decode tasks; the source node only takes the batches
+// that have already been read.
+class Batch_read_ahead {
+public:
+    explicit Batch_read_ahead(std::function<bool(Batch_msg &)> read_batch,
+                              std::function<std::size_t()> get_capacity)
+        : read_batch_{std::move(read_batch)}, get_capacity_{std::move(get_capacity)}
+    {}
+
+    Batch_read_ahead(const Batch_read_ahead &) = delete;
+
+    Batch_read_ahead &operator=(const Batch_read_ahead &) = delete;
+
+    Batch_read_ahead(Batch_read_ahead &&) = delete;
+
+    Batch_read_ahead &operator=(Batch_read_ahead &&) = delete;
+
+    ~Batch_read_ahead()
+    {
+        stop();
+    }
+
+    // Pops the next batch of the epoch; returns false at the end of the
+    // epoch or once stopped. Rethrows the error of a failed read.
+    bool pop(Batch_msg &msg)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        if (!thread_.joinable()) {
+            thread_ = detail::start_thread(&Batch_read_ahead::run, this);
+        }
+
+        condition_.wait(lock, [this] {
+            return !batches_.empty() || done_ || stopped_;
+        });
+
+        if (!batches_.empty()) {
+            msg = std::move(batches_.front());
+
+            batches_.pop_front();
+
+            lock.unlock();
+
+            condition_.notify_all();
+
+            return true;
+        }
+
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+
+        return false;
+    }
+
+    void stop() noexcept
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            stopped_ = true;
+        }
+
+        condition_.notify_all();
+
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    // Discards the batches read so far so that the next call to pop()
+    // starts reading a new epoch.
+    void reset() noexcept
+    {
+        stop();
+
+        batches_.clear();
+
+        error_ = nullptr;
+
+        done_ = false;
+        stopped_ = false;
+    }
+
+private:
+    void run()
+    {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+
+                condition_.wait(lock, [this] {
+                    return batches_.size() < get_capacity_() || stopped_;
+                });
+
+                if (stopped_) {
+                    return;
+                }
+            }
+
+            Batch_msg msg{};
+
+            bool has_batch{};
+            std::exception_ptr error{};
+            try {
+                has_batch = read_batch_(msg);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+
+                if (has_batch) {
+                    batches_.push_back(std::move(msg));
+                }
+                else {
+                    error_ = std::move(error);
+
+                    done_ = true;
+                }
+            }
+
+            condition_.notify_all();
+
+            if (!has_batch) {
+                return;
+            }
+        }
+    }
+
+    std::function<bool(Batch_msg &)> read_batch_;
+    std::function<std::size_t()> get_capacity_;
+    std::thread thread_{};
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+    std::deque<Batch_msg> batches_{};
+    std::exception_ptr error_{};
+    bool done_{};
+    bool stopped_{};
 };
 
 // Holds the internal TBB flow graph objects.
@@ -52,6 +396,88 @@ struct Parallel_data_reader::Graph_data {
     tbb::flow::graph obj{ctx};
     tbb::flow::source_node<Batch_msg> *src_node{};
     std::vector<std::unique_ptr<tbb::flow::graph_node>> nodes{};
+    std::unique_ptr<detail::Ring_buffer<Intrusive_ptr<Example>>> ring{};
+    // Set if the batches are read on a dedicated I/O thread.
+    std::unique_ptr<Batch_read_ahead> read_ahead{};
+    // The epochs that the flow graph and the consumer are in if the
+    // epochs are pipelined. Guarded by queue_mutex_ along with the stop
+    // flag.
+    std::size_t source_epoch{};
+    std::size_t consumer_epoch{};
+    bool stop_requested{};
+    std::condition_variable epoch_condition{};
+    // Set once the consumer has popped the null example that marks the
+    // end of an epoch. Only accessed by the consumer.
+    bool end_of_epoch{};
+    // The number of instances the source node has read in its epoch.
+    // Only accessed by the source node.
+    std::size_t num_source_instances{};
+    // The checkpoints of the queued examples in the same order as the
+    // examples; the end-of-epoch markers have none.
+    std::mutex checkpoint_mutex{};
+    std::deque<Checkpoint> checkpoints{};
+    // The checkpoints of the last two examples popped by the consumer;
+    // the former one is saved if the last example has been peeked. Only
+    // accessed by the consumer.
+    Checkpoint last_checkpoint{};
+    Checkpoint prev_checkpoint{};
+};
+
+// Holds the runtime statistics of the reader.
+struct Parallel_data_reader::Stats_data {
+    explicit Stats_data(const Data_reader_params &params) : store_metrics{params}
+    {}
+
+    Stage_counter read{};
+    Stage_counter decode{};
+    Stage_counter transform{};
+    Stage_counter reorder{};
+    Stage_counter enqueue{};
+    Stage_counter consume{};
+    std::atomic<std::uint64_t> num_examples{};
+    std::atomic<std::uint64_t> num_instances{};
+    std::atomic<std::uint64_t> num_bad_instances{};
+    std::atomic<std::uint64_t> num_skipped_examples{};
+    std::atomic<std::uint64_t> num_filtered_instances{};
+    std::array<std::atomic<std::uint64_t>, detail::num_decode_warning_kinds> num_warnings{};
+    std::atomic<std::uint64_t> num_suppressed_warnings{};
+    std::atomic_size_t peak_memory_usage{};
+    // The cold-start timings; see Reader_stats::first_example_ns.
+    Stats_clock::time_point construction_time = Stats_clock::now();
+    std::atomic<std::uint64_t> schema_ns{};
+    std::atomic<std::uint64_t> first_example_ns{};
+    // Guards the rate limit of the decode warnings.
+    std::mutex warning_mutex{};
+    std::size_t num_logged_warnings{};
+    std::size_t num_pending_warnings{};
+    Stats_clock::time_point last_summary_time{};
+    detail::Store_metrics store_metrics;
+    // The statistics as of the previous call to stats(); used to
+    // compute the window values.
+    std::mutex window_mutex{};
+    Reader_stats last{};
+    Stats_clock::time_point last_time = Stats_clock::now();
+};
+
+// Holds the state of the runtime tuning of the flow graph.
+struct Parallel_data_reader::Tuning_data {
+    std::size_t max_parallel_reads{};
+    std::size_t max_prefetched_examples{};
+    std::atomic_size_t num_parallel_reads{};
+    std::atomic_size_t num_prefetched_examples{};
+    // The limiter node cannot change its threshold; instead the queue
+    // node holds back as many decrement messages as needed to keep the
+    // number of in-flight batches at num_parallel_reads. Only accessed
+    // by the queue node.
+    std::size_t num_withheld_reads{};
+    // The moving average of the size of the decoded examples.
+    std::atomic_size_t example_size{};
+    // The number of bytes held by the batches and examples between the
+    // source node and the consumer.
+    std::atomic_size_t num_bytes_in_flight{};
+    Stats_clock::time_point last_time{};
+    std::uint64_t last_consume_ns{};
+    std::uint64_t last_enqueue_ns{};
 };
 
 Parallel_data_reader::~Parallel_data_reader() = default;
@@ -61,14 +487,213 @@ std::size_t Parallel_data_reader::num_bytes_read() const noexcept
     return num_bytes_read_;
 }
 
+std::size_t Parallel_data_reader::shuffle_buffer_size() const noexcept
+{
+    return reader_->shuffle_buffer_size();
+}
+
+std::vector<Intrusive_ptr<Example>> Parallel_data_reader::read_device_examples()
+{
+    std::size_t num_devices = std::max(params().output_devices.size(), std::size_t{1});
+
+    std::vector<Intrusive_ptr<Example>> examples{};
+    examples.reserve(num_devices);
+
+    for (std::size_t i = 0; i < num_devices; i++) {
+        Intrusive_ptr<Example> example = read_example();
+        if (example == nullptr) {
+            break;
+        }
+
+        examples.emplace_back(std::move(example));
+    }
+
+    return examples;
+}
+
+Tensor_pool_stats Parallel_data_reader::tensor_pool_stats() const
+{
+    if (tensor_pool_ == nullptr) {
+        return {};
+    }
+    return tensor_pool_->stats();
+}
+
+Reader_stats Parallel_data_reader::stats() const
+{
+    Stats_data &data = *stats_;
+
+    Reader_stats stats{};
+
+    std::unique_lock<std::mutex> window_lock{data.window_mutex};
+
+    data.read.snapshot(data.last.read, stats.read);
+    data.decode.snapshot(data.last.decode, stats.decode);
+    data.transform.snapshot(data.last.transform, stats.transform);
+    data.reorder.snapshot(data.last.reorder, stats.reorder);
+    data.enqueue.snapshot(data.last.enqueue, stats.enqueue);
+    data.consume.snapshot(data.last.consume, stats.consume);
+
+    stats.num_examples = data.num_examples.load(std::memory_order_relaxed);
+    stats.num_instances = data.num_instances.load(std::memory_order_relaxed);
+    stats.num_bad_instances = data.num_bad_instances.load(std::memory_order_relaxed);
+    stats.num_skipped_examples = data.num_skipped_examples.load(std::memory_order_relaxed);
+    stats.num_filtered_instances = data.num_filtered_instances.load(std::memory_order_relaxed);
+
+    auto get_num_warnings = [&data](detail::Decode_warning_kind kind) {
+        return data.num_warnings[static_cast<std::size_t>(kind)].load(std::memory_order_relaxed);
+    };
+
+    stats.num_parse_errors = get_num_warnings(detail::Decode_warning_kind::parse_error);
+    stats.num_field_count_errors =
+        get_num_warnings(detail::Decode_warning_kind::field_count_mismatch);
+    stats.num_long_fields = get_num_warnings(detail::Decode_warning_kind::long_field);
+    stats.num_corrupt_records = get_num_warnings(detail::Decode_warning_kind::corrupt_record);
+    stats.num_schema_mismatches = get_num_warnings(detail::Decode_warning_kind::schema_mismatch);
+    stats.num_overflows = get_num_warnings(detail::Decode_warning_kind::overflow);
+    stats.num_suppressed_warnings = data.num_suppressed_warnings.load(std::memory_order_relaxed);
+
+    stats.schema_ns = data.schema_ns.load(std::memory_order_relaxed);
+    stats.first_example_ns = data.first_example_ns.load(std::memory_order_relaxed);
+
+    Stats_clock::time_point now = Stats_clock::now();
+
+    stats.window_seconds = std::chrono::duration<double>(now - data.last_time).count();
+    if (stats.window_seconds > 0) {
+        stats.examples_per_second =
+            static_cast<double>(stats.num_examples - data.last.num_examples) / stats.window_seconds;
+        stats.instances_per_second =
+            static_cast<double>(stats.num_instances - data.last.num_instances) /
+            stats.window_seconds;
+    }
+
+    data.last = stats;
+    data.last_time = now;
+
+    window_lock.unlock();
+
+    stats.num_parallel_reads = tuning_->num_parallel_reads.load(std::memory_order_relaxed);
+    stats.num_prefetched_examples =
+        tuning_->num_prefetched_examples.load(std::memory_order_relaxed);
+
+    stats.memory_usage = memory_usage();
+    stats.peak_memory_usage =
+        std::max(data.peak_memory_usage.load(std::memory_order_relaxed), stats.memory_usage);
+
+    stats.queue_capacity = get_queue_capacity(stats.num_prefetched_examples);
+
+    // The read queue is only accessed by the consumer which is also
+    // the caller of this function.
+    if (graph_->ring != nullptr) {
+        stats.num_queued_examples = graph_->ring->size();
+    }
+    else {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        stats.num_queued_examples = fill_queue_.size() + read_queue_.size();
+    }
+
+    stats.stores = data.store_metrics.stats();
+
+    return stats;
+}
+
 Parallel_data_reader::Parallel_data_reader(Data_reader_params &&params)
-    : Data_reader_base{std::move(params)}, graph_{std::make_unique<Graph_data>()}
+    : Data_reader_base{std::move(params)}
+    , arena_{detail::make_reader_task_arena(this->params())}
+    , stats_{std::make_unique<Stats_data>(this->params())}
+    , tuning_{std::make_unique<Tuning_data>()}
 {
-    reader_ = detail::make_instance_reader(this->params(), [this](const Data_store &store) {
-        return make_record_reader(store);
+    // The flow graph runs its tasks in the arena it is constructed in.
+    arena_->execute([this] {
+        graph_ = std::make_unique<Graph_data>();
     });
 
-    batch_reader_ = std::make_unique<Instance_batch_reader>(this->params(), *reader_);
+    for (const Intrusive_ptr<Example_transform> &transform : this->params().example_transforms) {
+        if (transform == nullptr) {
+            throw std::invalid_argument{"The example transforms must not be null."};
+        }
+    }
+
+    make_instance_readers();
+
+    if (this->params().tensor_pool_size > 0) {
+        tensor_pool_ = make_intrusive<Tensor_pool>(this->params().tensor_pool_size,
+                                                   this->params().tensor_pool_huge_pages);
+    }
+
+    const std::optional<Device> &output_device = this->params().output_device;
+    const std::vector<Device> &output_devices = this->params().output_devices;
+
+    if (output_device && !output_devices.empty()) {
+        throw std::invalid_argument{
+            "The output device and the output devices cannot be both specified."};
+    }
+
+    if (output_device && output_device->kind() != Device_kind::cpu()) {
+        transfers_.emplace_back(std::make_unique<detail::Cuda_transfer>(*output_device));
+    }
+
+    // Each device gets its own stream and staging buffers, so that the
+    // copies to one device do not wait for the ones to another.
+    for (const Device &device : output_devices) {
+        if (device.kind() == Device_kind::cpu()) {
+            transfers_.emplace_back();
+        }
+        else {
+            transfers_.emplace_back(std::make_unique<detail::Cuda_transfer>(device));
+        }
+    }
+}
+
+void Parallel_data_reader::make_instance_readers()
+{
+    detail::Store_metrics *metrics = &stats_->store_metrics;
+
+    auto factory = [this, metrics](const Data_store &store) {
+        auto start = Stats_clock::now();
+
+        Intrusive_ptr<Record_reader> reader = make_record_reader(store);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Stats_clock::now() -
+                                                                            start);
+
+        metrics->add_open(store, static_cast<std::uint64_t>(elapsed.count()));
+
+        return reader;
+    };
+
+    // The batch reader might read ahead of the instance reader on a
+    // thread of its own; stop it before replacing the instance reader.
+    batch_reader_ = nullptr;
+
+    reader_ = detail::make_instance_reader(params(), std::move(factory), metrics);
+
+    batch_reader_ = std::make_unique<Instance_batch_reader>(params(), *reader_);
+
+    if (params().size_bucketing_lookahead > 0) {
+        batch_reader_->set_bucketing(&detail::get_record_size_bucket,
+                                     params().size_bucketing_lookahead);
+    }
+
+    if (instance_filter_ != nullptr) {
+        batch_reader_->set_filter(instance_filter_);
+    }
+}
+
+void Parallel_data_reader::set_instance_bucketing(
+    std::function<std::size_t(const Instance &)> get_bucket, std::size_t lookahead)
+{
+    batch_reader_->set_bucketing(std::move(get_bucket), lookahead);
+}
+
+void Parallel_data_reader::set_instance_filter(std::function<bool(const Instance &)> filter)
+{
+    // Kept so that the instance readers made by restore_state() filter
+    // as well.
+    instance_filter_ = std::move(filter);
+
+    batch_reader_->set_filter(instance_filter_);
 }
 
 void Parallel_data_reader::stop()
@@ -77,6 +702,33 @@ void Parallel_data_reader::stop()
         return;
     }
 
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        graph_->stop_requested = true;
+    }
+
+    // Wake up the background thread in case it waits for the consumer
+    // to start the next epoch.
+    graph_->epoch_condition.notify_one();
+
+    // Wake up the source node in case it waits for the I/O thread.
+    if (graph_->read_ahead != nullptr) {
+        graph_->read_ahead->stop();
+    }
+
+    if (graph_->ring != nullptr) {
+        graph_->ctx.cancel_group_execution();
+
+        // Drain the buffer and wake up the background thread in case
+        // it is waiting for room.
+        graph_->ring->clear();
+
+        thread_.join();
+
+        return;
+    }
+
     read_queue_.clear();
 
     {
@@ -96,6 +748,43 @@ Intrusive_ptr<Example> Parallel_data_reader::read_example_core()
 {
     ensure_schema_inferred();
 
+    // If the epochs are pipelined, the examples queued after the end of
+    // the epoch belong to the next one.
+    if (graph_->end_of_epoch) {
+        return {};
+    }
+
+    Stage_timer timer{stats_->consume};
+
+    if (params().example_queue_handling == Example_queue_handling::lock_free) {
+        ensure_pipeline_running();
+
+        std::optional<Intrusive_ptr<Example>> example = graph_->ring->pop();
+        if (example != std::nullopt) {
+            if (*example == nullptr) {
+                graph_->end_of_epoch = true;
+            }
+            else {
+                pop_checkpoint();
+
+                release_memory(get_size_bytes(**example));
+
+                record_first_example();
+            }
+            return std::move(*example);
+        }
+
+        // The ring buffer gets closed only after the background thread
+        // has finished running the flow graph.
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        if (state_ == Run_state::faulted) {
+            std::rethrow_exception(exception_ptr_);
+        }
+
+        return {};
+    }
+
     //               ┌───< read_example_core() <───┐
     //               │                             │
     //               │                             │
@@ -141,37 +830,90 @@ Intrusive_ptr<Example> Parallel_data_reader::read_example_core()
 
     read_queue_.pop_front();
 
+    if (example == nullptr) {
+        graph_->end_of_epoch = true;
+    }
+    else {
+        pop_checkpoint();
+
+        release_memory(get_size_bytes(*example));
+
+        record_first_example();
+    }
+
     return example;
 }
 
-void Parallel_data_reader::ensure_pipeline_running()
+void Parallel_data_reader::record_first_example() noexcept
 {
-    if (state_ != Run_state::not_started) {
+    Stats_data &data = *stats_;
+
+    if (data.first_example_ns.load(std::memory_order_relaxed) != 0) {
         return;
     }
 
-    state_ = Run_state::running;
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Stats_clock::now() -
+                                                                        data.construction_time);
 
-    thread_ = detail::start_thread(&Parallel_data_reader::run_pipeline, this);
+    data.first_example_ns.store(std::max(static_cast<std::uint64_t>(elapsed.count()),
+                                         std::uint64_t{1}),
+                                std::memory_order_relaxed);
 }
 
-void Parallel_data_reader::run_pipeline()
+void Parallel_data_reader::pop_checkpoint()
 {
-    if (graph_->src_node == nullptr) {
-        init_graph();
-    }
+    Checkpoint checkpoint{};
+    {
+        std::unique_lock<std::mutex> lock{graph_->checkpoint_mutex};
 
-    graph_->src_node->activate();
+        checkpoint = std::move(graph_->checkpoints.front());
 
-    try {
-        graph_->obj.wait_for_all();
-    }
-    catch (const std::exception &) {
-        exception_ptr_ = std::current_exception();
+        graph_->checkpoints.pop_front();
     }
 
-    {
-        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+    checkpoint.num_examples = graph_->last_checkpoint.num_examples + 1;
+
+    graph_->prev_checkpoint = std::exchange(graph_->last_checkpoint, std::move(checkpoint));
+}
+
+void Parallel_data_reader::ensure_pipeline_running()
+{
+    if (state_ != Run_state::not_started) {
+        return;
+    }
+
+    if (graph_->src_node == nullptr) {
+        init_graph();
+    }
+
+    state_ = Run_state::running;
+
+    thread_ = detail::start_thread(&Parallel_data_reader::run_pipeline, this);
+}
+
+void Parallel_data_reader::run_pipeline()
+{
+    arena_->pin_current_thread();
+
+    for (;;) {
+        arena_->execute([this] {
+            graph_->src_node->activate();
+
+            try {
+                graph_->obj.wait_for_all();
+            }
+            catch (const std::exception &) {
+                exception_ptr_ = std::current_exception();
+            }
+        });
+
+        if (exception_ptr_ || !params().pipeline_epochs || !start_next_epoch()) {
+            break;
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
 
         if (exception_ptr_) {
             state_ = Run_state::faulted;
@@ -182,138 +924,1415 @@ void Parallel_data_reader::run_pipeline()
     }
 
     read_condition_.notify_one();
+
+    if (graph_->ring != nullptr) {
+        graph_->ring->close();
+    }
+}
+
+bool Parallel_data_reader::start_next_epoch()
+{
+    // The flow graph is idle at this point; all examples of the epoch
+    // have been queued. Mark the end of the epoch with a null example.
+    if (!push_example(nullptr)) {
+        return false;
+    }
+
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        // Do not get more than one epoch ahead of the consumer.
+        graph_->epoch_condition.wait(queue_lock, [this] {
+            return graph_->source_epoch == graph_->consumer_epoch || graph_->stop_requested;
+        });
+
+        if (graph_->stop_requested) {
+            return false;
+        }
+
+        graph_->source_epoch++;
+    }
+
+    if (graph_->read_ahead != nullptr) {
+        graph_->read_ahead->reset();
+    }
+
+    batch_reader_->reset();
+
+    graph_->num_source_instances = 0;
+
+    // Resetting the flow graph restarts the sequencer at the first batch
+    // of the new epoch, and the limiter at zero in-flight batches.
+    arena_->execute([this] {
+        graph_->obj.reset();
+    });
+
+    tuning_->num_withheld_reads = 0;
+
+    // The graph reset might have cleared a cancellation that raced with
+    // it; the stop flag tells us whether it did.
+    return !is_stop_requested();
+}
+
+bool Parallel_data_reader::push_example(Intrusive_ptr<Example> example)
+{
+    if (graph_->ring != nullptr) {
+        return graph_->ring->push(std::move(example), [this] {
+            return graph_->ctx.is_group_execution_cancelled();
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        // While over the memory budget, wait for the consumer to take
+        // the queued examples before adding more.
+        fill_condition_.wait(queue_lock, [this] {
+            if (fill_queue_.empty()) {
+                return true;
+            }
+            return fill_queue_.size() <
+                       tuning_->num_prefetched_examples.load(std::memory_order_relaxed) &&
+                   !is_over_memory_budget();
+        });
+
+        if (graph_->ctx.is_group_execution_cancelled()) {
+            return false;
+        }
+
+        fill_queue_.push_back(std::move(example));
+    }
+
+    read_condition_.notify_one();
+
+    return true;
+}
+
+Intrusive_ptr<Example>
+Parallel_data_reader::copy_to_output_device(Intrusive_ptr<Example> example, std::size_t batch_idx)
+{
+    if (transfers_.empty()) {
+        return example;
+    }
+
+    detail::Cuda_transfer *transfer = transfers_[batch_idx % transfers_.size()].get();
+    if (transfer == nullptr) {
+        return example;
+    }
+
+    return transfer->copy(*example);
+}
+
+bool Parallel_data_reader::is_stop_requested() const
+{
+    std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+    return graph_->stop_requested;
 }
 
 void Parallel_data_reader::init_graph()
 {
     namespace flw = tbb::flow;
 
+    std::size_t num_cores = arena_->max_concurrency();
+
     std::size_t num_prefetched_examples = params().num_prefetched_examples;
     if (num_prefetched_examples == 0) {
-        // Defaults to the number of processor cores.
-        num_prefetched_examples =
-            static_cast<std::size_t>(tbb::task_scheduler_init::default_num_threads());
+        // Defaults to the number of processor cores. The upper bound of
+        // the autotuner leaves room for deeper queues in case of small
+        // examples.
+        num_prefetched_examples = params().autotune ? 4 * num_cores : num_cores;
     }
 
     std::size_t num_parallel_reads = params().num_parallel_reads;
-    if (num_parallel_reads == 0 || num_parallel_reads > num_prefetched_examples) {
-        num_parallel_reads = num_prefetched_examples;
+    if (num_parallel_reads == 0) {
+        num_parallel_reads = params().autotune ? num_cores : num_prefetched_examples;
+    }
+    num_parallel_reads = std::min(num_parallel_reads, num_prefetched_examples);
+
+    Tuning_data &tuning = *tuning_;
+
+    tuning.max_parallel_reads = num_parallel_reads;
+    tuning.max_prefetched_examples = num_prefetched_examples;
+
+    if (params().autotune) {
+        // Start small and let the autotuner ramp up.
+        tuning.num_parallel_reads = std::min(num_parallel_reads, std::size_t{2});
+        tuning.num_prefetched_examples = std::min(num_prefetched_examples, std::size_t{2});
     }
+    else {
+        tuning.num_parallel_reads = num_parallel_reads;
+        tuning.num_prefetched_examples = num_prefetched_examples;
+    }
+
+    tuning.last_time = Stats_clock::now();
 
     flw::graph &g = graph_->obj;
 
     // Source
-    auto src_node = std::make_unique<flw::source_node<Batch_msg>>(
-        g,
-        [this](auto &msg) {
-            std::optional<Instance_batch> batch = batch_reader_->read_instance_batch();
-            if (batch == std::nullopt) {
-                return false;
-            }
+    auto read_batch = [this](Batch_msg &msg) {
+        std::optional<Instance_batch> batch{};
+        {
+            Stage_timer timer{stats_->read};
+            detail::Trace_span span{"read_instance_batch"};
+            detail::Allocation_scope scope{detail::Allocation_stage::framing};
 
-            msg = Batch_msg{std::make_shared<Instance_batch>(std::move(*batch))};
+            batch = batch_reader_->read_instance_batch();
+        }
 
-            return true;
-        },
-        false);
+        // The filtered instances count as read so that a restored
+        // state skips them as well.
+        std::size_t num_filtered = batch_reader_->take_num_filtered_instances();
+        if (num_filtered > 0) {
+            graph_->num_source_instances += num_filtered;
+
+            stats_->num_filtered_instances.fetch_add(num_filtered, std::memory_order_relaxed);
+        }
+
+        if (batch == std::nullopt) {
+            return false;
+        }
+
+        graph_->num_source_instances += batch->num_instances();
+
+        Checkpoint checkpoint{};
+        checkpoint.num_instances = graph_->num_source_instances;
+
+        // If the batch reader holds back an instance, the instance
+        // reader is already past the batch.
+        if (!batch_reader_->has_pending_instance()) {
+            checkpoint.position = reader_->position();
+        }
+
+        msg = Batch_msg{std::make_shared<Instance_batch>(std::move(*batch)),
+                        0,
+                        std::move(checkpoint)};
+
+        msg.num_bytes = msg.batch->size_bytes();
+
+        charge_memory(msg.num_bytes);
+
+        return true;
+    };
+
+    std::unique_ptr<flw::source_node<Batch_msg>> src_node{};
+    if (params().dedicated_io_thread) {
+        graph_->read_ahead = std::make_unique<Batch_read_ahead>(read_batch, [this]() {
+            return std::max(tuning_->num_parallel_reads.load(std::memory_order_relaxed),
+                            std::size_t{1});
+        });
+
+        src_node = std::make_unique<flw::source_node<Batch_msg>>(
+            g,
+            [this](auto &msg) {
+                return graph_->read_ahead->pop(msg);
+            },
+            false);
+    }
+    else {
+        src_node = std::make_unique<flw::source_node<Batch_msg>>(g, read_batch, false);
+    }
 
     // Limiter
     auto limit_node = std::make_unique<flw::limiter_node<Batch_msg>>(g, num_parallel_reads);
 
+    // Prioritize
+    //
+    // If the order is preserved, the batches wait in a priority queue
+    // instead of being decoded in the order the worker threads happen to
+    // pick up their tasks; whenever a worker thread frees up, it decodes
+    // the batch with the lowest index, which is the one the sequencer
+    // needs soonest.
+    std::unique_ptr<flw::priority_queue_node<Batch_msg, Sooner_batch_first>> priority_node{};
+
+    std::size_t decode_concurrency = flw::unlimited;
+    if (params().deterministic) {
+        priority_node =
+            std::make_unique<flw::priority_queue_node<Batch_msg, Sooner_batch_first>>(g);
+
+        decode_concurrency = num_cores;
+    }
+
     // Decode
-    auto decode_node =
-        std::make_unique<flw::multifunction_node<Batch_msg, std::tuple<Example_msg>>>(
-            g, flw::unlimited, [this](const auto &msg, auto &ports) {
+    //
+    // The node rejects the batches while all of its tasks are busy so
+    // that they stay in the priority queue.
+    auto decode_node = std::make_unique<
+        flw::multifunction_node<Batch_msg, std::tuple<Example_msg>, flw::rejecting>>(
+            g, decode_concurrency, [this](const auto &msg, auto &ports) {
                 // We send a message to the next node even if the decode
                 // function fails. This is needed to have correct
                 // sequential ordering of other batches.
+                detail::Trace_span span{"decode"};
+                detail::Allocation_scope scope{detail::Allocation_stage::decode};
+
+                Stats_clock::time_point start = Stats_clock::now();
+
+                num_serial_decode_values_ = 0;
+
                 Example_msg out{msg.batch->index(), this->decode(*msg.batch)};
 
+                out.decoded_at = Stats_clock::now();
+
+                if (out.example != nullptr && num_serial_decode_values_ != 0) {
+                    record_decode_cost(num_serial_decode_values_, out.decoded_at - start);
+                }
+
+                if (out.example != nullptr) {
+                    out.num_bytes = get_size_bytes(*out.example);
+
+                    charge_memory(out.num_bytes);
+                }
+
+                release_memory(msg.num_bytes);
+
+                out.checkpoint = msg.checkpoint;
+
+                stats_->decode.add(out.decoded_at - start);
+
                 if (out.example != nullptr) {
                     num_bytes_read_.fetch_add(msg.batch->size_bytes());
+
+                    if (params().column_statistics != nullptr) {
+                        params().column_statistics->add(*out.example);
+                    }
+
+                    if (params().autotune) {
+                        std::atomic_size_t &example_size = tuning_->example_size;
+
+                        std::size_t size = get_size_bytes(*out.example);
+                        std::size_t avg = example_size.load(std::memory_order_relaxed);
+
+                        example_size.store(avg == 0 ? size : (7 * avg + size) / 8,
+                                           std::memory_order_relaxed);
+                    }
                 }
 
+                record_decoded_batch(*msg.batch, out.example.get());
+
                 std::get<0>(ports).try_put(std::move(out));
             });
 
+    // Transform
+    std::vector<std::unique_ptr<flw::function_node<Example_msg, Example_msg>>> transform_nodes{};
+
+    for (const Intrusive_ptr<Example_transform> &transform : params().example_transforms) {
+        std::size_t concurrency = transform->max_concurrency();
+        if (concurrency == 0) {
+            concurrency = flw::unlimited;
+        }
+
+        transform_nodes.emplace_back(std::make_unique<flw::function_node<Example_msg, Example_msg>>(
+            g, concurrency, [this, transform](const auto &msg) {
+                Example_msg out = msg;
+
+                // Like the decode node, we pass on the examples that
+                // failed to decode to keep the sequential ordering.
+                if (out.example != nullptr) {
+                    Stage_timer timer{stats_->transform};
+                    detail::Trace_span span{"transform"};
+                    detail::Allocation_scope scope{detail::Allocation_stage::transform};
+
+                    out.example = transform->transform(std::move(out.example));
+
+                    release_memory(std::exchange(out.num_bytes, 0));
+
+                    if (out.example != nullptr) {
+                        out.num_bytes = get_size_bytes(*out.example);
+
+                        charge_memory(out.num_bytes);
+                    }
+                }
+
+                out.decoded_at = Stats_clock::now();
+
+                return out;
+            }));
+    }
+
     // Order
-    auto order_node = std::make_unique<flw::sequencer_node<Example_msg>>(g, [](const auto &msg) {
-        return msg.idx;
-    });
+    //
+    // Unless the order has to be preserved, the examples bypass the
+    // sequencer so that a slow batch does not block the ones after it.
+    std::unique_ptr<flw::sequencer_node<Example_msg>> order_node{};
+    if (params().deterministic) {
+        order_node = std::make_unique<flw::sequencer_node<Example_msg>>(g, [](const auto &msg) {
+            return msg.idx;
+        });
+    }
 
     // Queue
-    auto queue_node = std::make_unique<flw::function_node<Example_msg, flw::continue_msg>>(
-        g, flw::serial, [this, num_prefetched_examples](const auto &msg) {
-            // If the decode function has failed discard the message.
-            if (msg.example == nullptr) {
-                return;
-            }
+    auto enqueue = [this](const Example_msg &msg) {
+        stats_->reorder.add(Stats_clock::now() - msg.decoded_at);
 
-            {
-                std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+        // If the decode function has failed discard the message.
+        if (msg.example == nullptr) {
+            return;
+        }
 
-                fill_condition_.wait(queue_lock, [this, num_prefetched_examples] {
-                    return fill_queue_.size() < num_prefetched_examples;
-                });
+        Stage_timer timer{stats_->enqueue};
+        detail::Trace_span span{"enqueue"};
 
-                if (graph_->ctx.is_group_execution_cancelled()) {
-                    return;
+        // The checkpoint has to be queued before the example as the
+        // consumer pops it right after the example.
+        {
+            std::unique_lock<std::mutex> lock{graph_->checkpoint_mutex};
+
+            graph_->checkpoints.push_back(msg.checkpoint);
+        }
+
+        // The queue node is serial, so the examples are copied to the
+        // devices one at a time.
+        push_example(copy_to_output_device(msg.example, msg.idx));
+    };
+
+    auto queue_node =
+        std::make_unique<flw::multifunction_node<Example_msg, std::tuple<flw::continue_msg>>>(
+            g, flw::serial, [this, enqueue](const auto &msg, auto &ports) {
+                // While over the memory budget, the ring buffer takes no
+                // more examples than it already holds.
+                if (graph_->ring != nullptr && params().memory_budget > 0) {
+                    std::size_t limit =
+                        tuning_->num_prefetched_examples.load(std::memory_order_relaxed);
+
+                    if (is_over_memory_budget()) {
+                        limit = std::min(limit, graph_->ring->size());
+                    }
+
+                    graph_->ring->set_limit(limit);
                 }
 
-                fill_queue_.push_back(msg.example);
-            }
+                enqueue(msg);
 
-            read_condition_.notify_one();
-        });
+                if (params().autotune) {
+                    autotune();
+                }
+
+                std::size_t num_released = release_parallel_reads();
+                for (std::size_t i = 0; i < num_released; i++) {
+                    std::get<0>(ports).try_put(flw::continue_msg{});
+                }
+            });
+
+    if (params().example_queue_handling == Example_queue_handling::lock_free) {
+        graph_->ring = std::make_unique<detail::Ring_buffer<Intrusive_ptr<Example>>>(
+            num_prefetched_examples);
+
+        graph_->ring->set_limit(tuning.num_prefetched_examples);
+    }
 
     flw::make_edge(*src_node, *limit_node);
-    flw::make_edge(*limit_node, *decode_node);
-    flw::make_edge(flw::output_port<0>(*decode_node), *order_node);
-    flw::make_edge(*order_node, *queue_node);
-    flw::make_edge(*queue_node, limit_node->decrement);
+    if (priority_node != nullptr) {
+        flw::make_edge(*limit_node, *priority_node);
+        flw::make_edge(*priority_node, *decode_node);
+    }
+    else {
+        flw::make_edge(*limit_node, *decode_node);
+    }
+
+    flw::receiver<Example_msg> *sink{};
+    if (order_node != nullptr) {
+        sink = order_node.get();
+    }
+    else {
+        sink = queue_node.get();
+    }
+
+    if (transform_nodes.empty()) {
+        flw::make_edge(flw::output_port<0>(*decode_node), *sink);
+    }
+    else {
+        flw::make_edge(flw::output_port<0>(*decode_node), *transform_nodes.front());
+
+        for (std::size_t i = 1; i < transform_nodes.size(); i++) {
+            flw::make_edge(*transform_nodes[i - 1], *transform_nodes[i]);
+        }
+
+        flw::make_edge(*transform_nodes.back(), *sink);
+    }
+
+    if (order_node != nullptr) {
+        flw::make_edge(*order_node, *queue_node);
+    }
+    flw::make_edge(flw::output_port<0>(*queue_node), limit_node->decrement);
 
     graph_->src_node = src_node.get();
 
     graph_->nodes.emplace_back(std::move(src_node));
     graph_->nodes.emplace_back(std::move(limit_node));
+    if (priority_node != nullptr) {
+        graph_->nodes.emplace_back(std::move(priority_node));
+    }
     graph_->nodes.emplace_back(std::move(decode_node));
-    graph_->nodes.emplace_back(std::move(order_node));
+    for (auto &transform_node : transform_nodes) {
+        graph_->nodes.emplace_back(std::move(transform_node));
+    }
+    if (order_node != nullptr) {
+        graph_->nodes.emplace_back(std::move(order_node));
+    }
     graph_->nodes.emplace_back(std::move(queue_node));
 }
 
-void Parallel_data_reader::ensure_schema_inferred()
+void Parallel_data_reader::autotune()
 {
-    if (schema_) {
+    // How often the parallelism is reevaluated.
+    constexpr auto interval = std::chrono::milliseconds{100};
+
+    // The fraction of time the consumer can wait for examples before
+    // the parallelism is increased.
+    constexpr double max_consumer_wait = 0.05;
+
+    // The fraction of time the reader can wait for the consumer before
+    // the parallelism is decreased to free up processor cores.
+    constexpr double max_reader_wait = 0.5;
+
+    Tuning_data &tuning = *tuning_;
+
+    Stats_clock::time_point now = Stats_clock::now();
+    if (now - tuning.last_time < interval) {
         return;
     }
 
-    schema_ = infer_schema(reader_->peek_instance());
+    std::uint64_t consume_ns = stats_->consume.total_ns();
+    std::uint64_t enqueue_ns = stats_->enqueue.total_ns();
+
+    auto elapsed = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - tuning.last_time).count());
+
+    double consumer_wait = static_cast<double>(consume_ns - tuning.last_consume_ns) / elapsed;
+    double reader_wait = static_cast<double>(enqueue_ns - tuning.last_enqueue_ns) / elapsed;
+
+    tuning.last_time = now;
+    tuning.last_consume_ns = consume_ns;
+    tuning.last_enqueue_ns = enqueue_ns;
+
+    std::size_t num_parallel_reads = tuning.num_parallel_reads.load(std::memory_order_relaxed);
+    std::size_t num_prefetched_examples =
+        tuning.num_prefetched_examples.load(std::memory_order_relaxed);
+
+    if (consumer_wait > max_consumer_wait) {
+        // Grow the parallelism by half, but at least by one.
+        std::size_t step = std::max(num_parallel_reads / 2, std::size_t{1});
+
+        num_parallel_reads = std::min(num_parallel_reads + step, tuning.max_parallel_reads);
+
+        num_prefetched_examples = std::max(num_prefetched_examples + 1, num_parallel_reads);
+        num_prefetched_examples =
+            std::min(num_prefetched_examples, tuning.max_prefetched_examples);
+    }
+    else if (reader_wait > max_reader_wait && num_parallel_reads > 1) {
+        num_parallel_reads--;
+    }
+
+    std::size_t budget = params().autotune_memory_budget;
+    std::size_t example_size = tuning.example_size.load(std::memory_order_relaxed);
+
+    if (budget > 0 && example_size > 0) {
+        auto get_memory_usage = [&]() {
+            return (num_parallel_reads + get_queue_capacity(num_prefetched_examples)) *
+                   example_size;
+        };
+
+        while (get_memory_usage() > budget) {
+            if (num_prefetched_examples > 1) {
+                num_prefetched_examples--;
+            }
+            else if (num_parallel_reads > 1) {
+                num_parallel_reads--;
+            }
+            else {
+                break;
+            }
+        }
+    }
+
+    tuning.num_parallel_reads.store(num_parallel_reads, std::memory_order_relaxed);
+    tuning.num_prefetched_examples.store(num_prefetched_examples, std::memory_order_relaxed);
+
+    if (graph_->ring != nullptr) {
+        graph_->ring->set_limit(num_prefetched_examples);
+    }
 }
 
-Intrusive_ptr<const Schema> Parallel_data_reader::read_schema()
+std::size_t Parallel_data_reader::release_parallel_reads() noexcept
 {
-    ensure_schema_inferred();
+    Tuning_data &tuning = *tuning_;
+
+    std::size_t num_to_withhold =
+        tuning.max_parallel_reads - tuning.num_parallel_reads.load(std::memory_order_relaxed);
+
+    // While over the memory budget, keep a single batch in flight so
+    // that the pipeline still makes progress.
+    if (is_over_memory_budget()) {
+        num_to_withhold = tuning.max_parallel_reads - 1;
+    }
+
+    if (tuning.num_withheld_reads < num_to_withhold) {
+        tuning.num_withheld_reads++;
+
+        return 0;
+    }
+
+    // Release the decrement of the current batch along with the ones
+    // that are no longer needed to be withheld.
+    std::size_t num_released = 1 + tuning.num_withheld_reads - num_to_withhold;
+
+    tuning.num_withheld_reads = num_to_withhold;
 
-    return schema_;
+    return num_released;
 }
 
-void Parallel_data_reader::reset() noexcept
+void Parallel_data_reader::charge_memory(std::size_t num_bytes) noexcept
 {
-    stop();
+    tuning_->num_bytes_in_flight.fetch_add(num_bytes, std::memory_order_relaxed);
 
-    state_ = Run_state::not_started;
+    std::size_t usage = memory_usage();
 
-    batch_reader_->reset();
+    std::atomic_size_t &peak = stats_->peak_memory_usage;
 
-    graph_->ctx.reset();
+    std::size_t prev = peak.load(std::memory_order_relaxed);
+    while (prev < usage && !peak.compare_exchange_weak(prev, usage, std::memory_order_relaxed)) {
+    }
+}
 
-    graph_->obj.reset();
+void Parallel_data_reader::release_memory(std::size_t num_bytes) noexcept
+{
+    tuning_->num_bytes_in_flight.fetch_sub(num_bytes, std::memory_order_relaxed);
+}
 
-    exception_ptr_ = nullptr;
+std::size_t Parallel_data_reader::memory_usage() const noexcept
+{
+    return tuning_->num_bytes_in_flight.load(std::memory_order_relaxed) +
+           reader_->shuffle_buffer_size();
+}
 
-    num_bytes_read_ = 0;
+bool Parallel_data_reader::is_over_memory_budget() const noexcept
+{
+    std::size_t budget = params().memory_budget;
 
-    Data_reader_base::reset();
+    return budget > 0 && memory_usage() > budget;
+}
+
+std::size_t Parallel_data_reader::get_queue_capacity(std::size_t num_prefetched_examples) const
+    noexcept
+{
+    if (params().example_queue_handling == Example_queue_handling::lock_free) {
+        return num_prefetched_examples;
+    }
+
+    // The read queue can hold as many examples as the fill queue once
+    // they get swapped.
+    return 2 * num_prefetched_examples;
+}
+
+bool Parallel_data_reader::should_decode_parallel(
+    std::size_t num_instances, std::size_t num_values_per_instance) const noexcept
+{
+    if (params().decode_scheduling == Decode_scheduling::row_range) {
+        return num_instances >= 2 * decode_grain_size(num_values_per_instance);
+    }
+
+    std::size_t num_values = num_values_per_instance * num_instances;
+
+    bool parallel{};
+
+    std::uint64_t cost = decode_cost_ps_.load(std::memory_order_relaxed);
+    if (cost == 0) {
+        // Until we have measured the decode cost of the dataset, fall
+        // back to a fixed number of values (e.g. integers,
+        // floating-points) below which the threading overhead would
+        // potentially slow down the performance.
+        constexpr std::size_t cut_off = 10'000'000;
+
+        parallel = num_values >= cut_off;
+    }
+    else {
+        // The serial decode time, in picoseconds, above which splitting a
+        // batch into tasks pays off. Below it the scheduling overhead
+        // and the cores taken away from the decoding of the concurrent
+        // batches outweigh the shorter latency.
+        constexpr double min_parallel_decode_time = 5e9;  // 5 ms
+
+        parallel = arena_->max_concurrency() > 1 &&
+                   static_cast<double>(num_values) * static_cast<double>(cost) >=
+                       min_parallel_decode_time;
+    }
+
+    num_serial_decode_values_ = parallel ? 0 : num_values;
+
+    return parallel;
+}
+
+void Parallel_data_reader::record_decode_cost(std::size_t num_values,
+                                              std::chrono::nanoseconds elapsed) const noexcept
+{
+    auto ps = static_cast<std::uint64_t>(elapsed.count()) * 1000 / num_values;
+
+    ps = std::max(ps, std::uint64_t{1});
+
+    // Smooth the measurements as a batch can be slowed down by the
+    // contention with the other pipeline stages.
+    std::uint64_t avg = decode_cost_ps_.load(std::memory_order_relaxed);
+
+    decode_cost_ps_.store(avg == 0 ? ps : (7 * avg + ps) / 8, std::memory_order_relaxed);
+}
+
+std::size_t Parallel_data_reader::decode_grain_size(std::size_t num_values_per_instance) const
+    noexcept
+{
+    if (params().decode_scheduling == Decode_scheduling::per_batch) {
+        return 1;
+    }
+
+    // The number of values a row-range task should decode at minimum
+    // to keep the scheduling overhead negligible.
+    constexpr std::size_t min_values_per_task = 0x10000;
+
+    return std::max(min_values_per_task / std::max(num_values_per_instance, std::size_t{1}),
+                    std::size_t{1});
+}
+
+std::unique_ptr<Device_array>
+Parallel_data_reader::make_pooled_cpu_array(Data_type dt,
+                                            std::size_t size,
+                                            bool zero_fill) const
+{
+    if (should_back_by_file({&dt, 1}, size)) {
+        const std::string &directory = *params().file_backed_output_directory;
+
+        return std::move(make_file_backed_cpu_arrays({&dt, 1}, size, directory).front());
+    }
+
+    if (tensor_pool_ == nullptr) {
+        return make_cpu_array(dt, size);
+    }
+    return tensor_pool_->make_cpu_array(dt, size, zero_fill);
+}
+
+std::vector<std::unique_ptr<Device_array>>
+Parallel_data_reader::make_pooled_cpu_arrays(stdx::span<const Data_type> dts,
+                                             std::size_t size) const
+{
+    if (should_back_by_file(dts, size)) {
+        return make_file_backed_cpu_arrays(dts, size, *params().file_backed_output_directory);
+    }
+
+    if (tensor_pool_ == nullptr) {
+        return make_cpu_arrays(dts, size);
+    }
+    return tensor_pool_->make_cpu_arrays(dts, size);
+}
+
+bool Parallel_data_reader::should_back_by_file(stdx::span<const Data_type> dts,
+                                               std::size_t size) const
+{
+    if (params().file_backed_output_directory == std::nullopt) {
+        return false;
+    }
+
+    // The string arrays are not part of the layout and are never backed
+    // by a file.
+    std::size_t num_bytes = detail::layout_array_group(dts, size).back();
+
+    return num_bytes > 0 && num_bytes >= params().file_backed_output_threshold;
+}
+
+void Parallel_data_reader::record_decoded_batch(const Instance_batch &batch,
+                                                const Example *example)
+{
+    Stats_data &data = *stats_;
+
+    if (example == nullptr) {
+        data.num_skipped_examples.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        std::size_t num_instances = batch.num_instances();
+
+        // The padding of an example covers both its bad instances and,
+        // in the last batch, the instances missing from the dataset.
+        std::size_t num_instances_read =
+            std::min(batch.size() - std::min(example->padding, batch.size()), num_instances);
+
+        data.num_examples.fetch_add(1, std::memory_order_relaxed);
+        data.num_instances.fetch_add(num_instances_read, std::memory_order_relaxed);
+        data.num_bad_instances.fetch_add(num_instances - num_instances_read,
+                                         std::memory_order_relaxed);
+    }
+
+    data.store_metrics.add_decoded_batch(batch);
+}
+
+void Parallel_data_reader::report_decode_warnings(detail::Decode_warning_log &log) const
+{
+    // The number of warnings logged individually in an epoch, and the
+    // minimum interval between the summaries of the rest.
+    constexpr std::size_t max_logged_warnings = 10;
+    constexpr auto summary_interval = std::chrono::seconds{10};
+
+    std::vector<detail::Decode_warning> &warnings = log.warnings();
+    if (warnings.empty()) {
+        return;
+    }
+
+    Stats_data &data = *stats_;
+
+    for (const detail::Decode_warning &warning : warnings) {
+        data.num_warnings[static_cast<std::size_t>(warning.kind)].fetch_add(
+            1, std::memory_order_relaxed);
+    }
+
+    if (!logger::is_enabled_for(Log_level::warning)) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{data.warning_mutex};
+
+    for (const detail::Decode_warning &warning : warnings) {
+        if (!warning.format_message) {
+            continue;
+        }
+
+        if (data.num_logged_warnings < max_logged_warnings) {
+            logger::warn(warning.format_message());
+
+            data.num_logged_warnings++;
+        }
+        else {
+            data.num_pending_warnings++;
+
+            data.num_suppressed_warnings.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (data.num_pending_warnings == 0) {
+        return;
+    }
+
+    Stats_clock::time_point now = Stats_clock::now();
+    if (now - data.last_summary_time < summary_interval) {
+        return;
+    }
+
+    logger::warn("{0:n} more warning(s) about bad instances have been suppressed. See the "
+                 "statistics of the reader for the number of problems by kind.",
+                 data.num_pending_warnings);
+
+    data.num_pending_warnings = 0;
+
+    data.last_summary_time = now;
+}
+
+void Parallel_data_reader::ensure_schema_inferred(const std::optional<Instance> *instance)
+{
+    if (schema_) {
+        return;
+    }
+
+    if (!params().row_filters.empty() && instance_filter_ == nullptr) {
+        throw std::invalid_argument{"The data reader does not support row filters."};
+    }
+
+    if (!params().class_sample_ratios.empty() && instance_filter_ == nullptr) {
+        throw std::invalid_argument{"The data reader does not support class sampling."};
+    }
+
+    auto start = Stats_clock::now();
+
+    schema_ = restore_schema();
+    if (schema_ == nullptr) {
+        if (instance != nullptr) {
+            schema_ = infer_schema(*instance);
+        }
+        else {
+            schema_ = infer_schema(reader_->peek_instance());
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Stats_clock::now() -
+                                                                        start);
+
+    stats_->schema_ns.store(static_cast<std::uint64_t>(elapsed.count()),
+                            std::memory_order_relaxed);
+
+    output_schema_ = schema_;
+    for (const Intrusive_ptr<Example_transform> &transform : params().example_transforms) {
+        if (output_schema_ == nullptr) {
+            break;
+        }
+        output_schema_ = transform->transform_schema(std::move(output_schema_));
+    }
+}
+
+Intrusive_ptr<Example> Parallel_data_reader::decode_buffer(Memory_slice buffer)
+{
+    detail::Trace_span span{"decode_buffer"};
+    detail::Allocation_scope scope{detail::Allocation_stage::decode};
+
+    auto store = make_intrusive<In_memory_store>(std::move(buffer));
+
+    Intrusive_ptr<Example> example{};
+    try {
+        example = decode_store(*store);
+    }
+    catch (...) {
+        release_data_store(*store);
+
+        throw;
+    }
+
+    // The store is transient, so the derived class must not keep any
+    // state for it once its instances are decoded.
+    release_data_store(*store);
+
+    for (const Intrusive_ptr<Example_transform> &transform : params().example_transforms) {
+        if (example == nullptr) {
+            return {};
+        }
+        example = transform->transform(std::move(example));
+    }
+
+    if (example == nullptr) {
+        return {};
+    }
+
+    return copy_to_output_device(std::move(example), 0);
+}
+
+Intrusive_ptr<Example> Parallel_data_reader::decode_store(const Data_store &store)
+{
+    std::vector<Instance> instances = read_buffer_instances(store);
+    if (instances.empty()) {
+        return {};
+    }
+
+    std::optional<Instance> first_instance = instances.front();
+
+    ensure_schema_inferred(&first_instance);
+
+    if (instance_filter_ != nullptr) {
+        auto pos = std::remove_if(instances.begin(), instances.end(), [this](const Instance &i) {
+            return !instance_filter_(i);
+        });
+
+        instances.erase(pos, instances.end());
+
+        if (instances.empty()) {
+            return {};
+        }
+    }
+
+    std::size_t num_instances = instances.size();
+
+    Instance_batch batch{0, std::move(instances), num_instances};
+
+    Intrusive_ptr<Example> example{};
+
+    // The parallel decode tasks, if any, run in the arena of the reader
+    // as they do in the pipeline.
+    arena_->execute([this, &batch, &example] {
+        example = decode(batch);
+    });
+
+    return example;
+}
+
+std::vector<Instance> Parallel_data_reader::read_buffer_instances(const Data_store &store)
+{
+    std::vector<Instance> instances{};
+
+    Intrusive_ptr<Record_reader> record_reader = make_record_reader(store);
+
+    // Like the core instance reader, a data store without a record
+    // reader is an instance of its own (e.g. an image).
+    if (record_reader == nullptr) {
+        instances.emplace_back(store);
+
+        return instances;
+    }
+
+    auto throw_corrupt_error = [&store]() {
+        throw Data_reader_error{fmt::format(
+            "The buffer '{0}' contains a corrupt split record.", store.id())};
+    };
+
+    std::optional<Record> record{};
+    while ((record = record_reader->read_record())) {
+        if (record->kind() == Record_kind::complete) {
+            instances.emplace_back(store, instances.size(), std::move(*record).payload());
+
+            continue;
+        }
+
+        if (record->kind() != Record_kind::begin) {
+            throw_corrupt_error();
+        }
+
+        // Merge the payloads of a split record into a single buffer.
+        std::vector<Record> records{};
+
+        std::size_t payload_size = record->payload().size();
+
+        records.emplace_back(std::move(*record));
+
+        while ((record = record_reader->read_record()) && record->kind() == Record_kind::middle) {
+            payload_size += record->payload().size();
+
+            records.emplace_back(std::move(*record));
+        }
+
+        if (record == std::nullopt || record->kind() != Record_kind::end) {
+            throw_corrupt_error();
+        }
+
+        payload_size += record->payload().size();
+
+        records.emplace_back(std::move(*record));
+
+        auto payload = memory_allocator().allocate(payload_size);
+
+        auto pos = payload->begin();
+        for (const Record &r : records) {
+            pos = std::copy(r.payload().begin(), r.payload().end(), pos);
+        }
+
+        instances.emplace_back(store, instances.size(), Memory_slice{std::move(payload)});
+    }
+
+    return instances;
+}
+
+Intrusive_ptr<Record_reader>
+Parallel_data_reader::make_counting_record_reader(const Data_store &store, std::size_t)
+{
+    return make_record_reader(store);
+}
+
+void Parallel_data_reader::release_data_store(const Data_store &) noexcept
+{}
+
+Intrusive_ptr<const Schema> Parallel_data_reader::restore_schema()
+{
+    return {};
+}
+
+Intrusive_ptr<const Schema> Parallel_data_reader::read_schema()
+{
+    ensure_schema_inferred();
+
+    // Prefetch the first examples while the caller is busy with the
+    // schema.
+    if (params().start_on_schema && schema_ != nullptr && !graph_->end_of_epoch) {
+        ensure_pipeline_running();
+    }
+
+    return output_schema_;
+}
+
+void Parallel_data_reader::reset() noexcept
+{
+    // If the epochs are pipelined and the consumer has read the whole
+    // epoch, let the background thread carry on with the next one.
+    if (params().pipeline_epochs && graph_->end_of_epoch) {
+        bool running{};
+        {
+            std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+            running = state_ == Run_state::running;
+            if (running) {
+                graph_->consumer_epoch++;
+            }
+        }
+
+        if (running) {
+            graph_->epoch_condition.notify_one();
+
+            graph_->end_of_epoch = false;
+
+            graph_->last_checkpoint = {};
+            graph_->prev_checkpoint = {};
+
+            epoch_++;
+
+            reset_stats();
+
+            Data_reader_base::reset();
+
+            return;
+        }
+    }
+
+    // The background thread might have already started the epochs past
+    // the one read by the consumer; the instance reader is reset past
+    // them as well.
+    std::size_t num_epochs_ahead = reset_pipeline();
+
+    batch_reader_->reset();
+
+    graph_->num_source_instances = 0;
+
+    epoch_ += 1 + num_epochs_ahead;
+}
+
+std::size_t Parallel_data_reader::reset_pipeline() noexcept
+{
+    stop();
+
+    // The epoch counters can only be read once the background thread
+    // has been joined; it increments the source epoch when it starts
+    // the next epoch.
+    std::size_t num_epochs_ahead = graph_->source_epoch - graph_->consumer_epoch;
+
+    state_ = Run_state::not_started;
+
+    graph_->ctx.reset();
+
+    // Resetting the flow graph also reattaches it to the current arena.
+    arena_->execute([this] {
+        graph_->obj.reset();
+    });
+
+    if (graph_->ring != nullptr) {
+        graph_->ring->reset();
+    }
+
+    if (graph_->read_ahead != nullptr) {
+        graph_->read_ahead->reset();
+    }
+
+    exception_ptr_ = nullptr;
+
+    graph_->source_epoch = 0;
+    graph_->consumer_epoch = 0;
+    graph_->stop_requested = false;
+    graph_->end_of_epoch = false;
+
+    graph_->checkpoints.clear();
+
+    graph_->last_checkpoint = {};
+    graph_->prev_checkpoint = {};
+
+    // The queued examples have been dropped along with the in-flight
+    // batches.
+    tuning_->num_bytes_in_flight = 0;
+
+    reset_stats();
+
+    // The flow graph reset also resets the counter of the limiter node.
+    // The tuned parallelism is carried over to the next epoch.
+    Tuning_data &tuning = *tuning_;
+
+    tuning.num_withheld_reads = 0;
+    tuning.last_time = stats_->last_time;
+    tuning.last_consume_ns = 0;
+    tuning.last_enqueue_ns = 0;
+
+    Data_reader_base::reset();
+
+    return num_epochs_ahead;
+}
+
+Data_reader_state Parallel_data_reader::save_state() const
+{
+    check_state_supported();
+
+    // If the last example has been peeked, the caller has not read it
+    // yet.
+    const Checkpoint &checkpoint =
+        has_peeked_example() ? graph_->prev_checkpoint : graph_->last_checkpoint;
+
+    Data_reader_state state{};
+    state.epoch = epoch_;
+    state.num_examples_read = checkpoint.num_examples;
+    state.num_instances_read = checkpoint.num_instances;
+
+    if (checkpoint.position) {
+        state.position = *checkpoint.position;
+    }
+
+    return state;
+}
+
+void Parallel_data_reader::restore_state(const Data_reader_state &state)
+{
+    check_state_supported();
+
+    ensure_schema_inferred();
+
+    reset_pipeline();
+
+    // The shuffle and sample seeds of an epoch depend on the number of
+    // preceding epochs, so we replay them from a fresh instance reader.
+    auto replay_epochs = [this, &state]() {
+        make_instance_readers();
+
+        for (std::size_t i = 0; i < state.epoch; i++) {
+            batch_reader_->reset();
+        }
+    };
+
+    replay_epochs();
+
+    bool seeked = false;
+    if (!state.position.empty()) {
+        seeked = reader_->seek(state.position);
+        if (!seeked) {
+            replay_epochs();
+        }
+    }
+
+    if (!seeked && state.num_instances_read > 0) {
+        std::size_t num_skipped = reader_->skip_instances(state.num_instances_read);
+        if (num_skipped != state.num_instances_read) {
+            throw Data_reader_error{fmt::format(
+                "The dataset has only {0:n} instance(s) in epoch {1:n}, but the state has {2:n} instance(s) read.",
+                num_skipped,
+                state.epoch,
+                state.num_instances_read)};
+        }
+    }
+
+    epoch_ = state.epoch;
+
+    graph_->num_source_instances = state.num_instances_read;
+
+    Checkpoint checkpoint{};
+    checkpoint.num_examples = state.num_examples_read;
+    checkpoint.num_instances = state.num_instances_read;
+
+    if (!state.position.empty()) {
+        checkpoint.position = state.position;
+    }
+
+    graph_->last_checkpoint = checkpoint;
+    graph_->prev_checkpoint = std::move(checkpoint);
+}
+
+Instance_count Parallel_data_reader::estimate_num_instances(bool exact)
+{
+    detail::Trace_span span{"estimate_num_instances"};
+
+    std::vector<Instance_count> counts(params().dataset.size());
+
+    arena_->execute([this, exact, &counts] {
+        tbb::blocked_range<std::size_t> range{0, counts.size(), 1};
+
+        tbb::parallel_for(range, [this, exact, &counts](const auto &sub_range) {
+            for (std::size_t i = sub_range.begin(); i < sub_range.end(); i++) {
+                counts[i] = count_store_instances(i, exact);
+            }
+        });
+    });
+
+    Instance_count total{0, true};
+
+    for (const Instance_count &count : counts) {
+        total.num_instances += count.num_instances;
+
+        total.exact = total.exact && count.exact;
+    }
+
+    return total;
+}
+
+Instance_count Parallel_data_reader::count_store_instances(std::size_t store_index, bool exact)
+{
+    const Data_store &store = *params().dataset[store_index];
+
+    if (std::optional<std::size_t> num_instances = store.num_instances_hint()) {
+        return {*num_instances, true};
+    }
+
+    if (store_index < params().recordio_indexes.size()) {
+        std::vector<Recordio_index_entry> entries =
+            read_recordio_index(*params().recordio_indexes[store_index]);
+
+        return {entries.size(), true};
+    }
+
+    Intrusive_ptr<Record_reader> record_reader = make_counting_record_reader(store, store_index);
+
+    // Like the core instance reader, a data store without a record
+    // reader is an instance of its own (e.g. an image).
+    if (record_reader == nullptr) {
+        return {1, true};
+    }
+
+    auto *reader = dynamic_cast<Stream_record_reader *>(record_reader.get());
+
+    std::optional<std::size_t> stream_size{};
+    if (reader != nullptr) {
+        stream_size = reader->stream_size();
+    }
+
+    // Without a seekable stream we cannot tell how large the data
+    // store is (e.g. a compressed one); count all of its records.
+    if (stream_size == std::nullopt) {
+        return {count_records(*record_reader), true};
+    }
+
+    // The records before the current position (e.g. a CSV header) are
+    // not instances.
+    std::size_t first = reader->position().value_or(0);
+
+    std::size_t data_size = *stream_size - std::min(first, *stream_size);
+
+    if (exact) {
+        std::size_t num_shards = data_size / count_shard_size;
+        if (num_shards > 1 && reader->set_shard(0, num_shards)) {
+            return {count_shards_in_parallel(store_index, num_shards), true};
+        }
+
+        return {count_records(*reader), true};
+    }
+
+    std::size_t sample_size = num_count_sample_chunks * count_sample_chunk_size;
+    if (data_size <= sample_size) {
+        return {count_records(*reader), true};
+    }
+
+    // If the data store cannot be split into byte ranges, we sample its
+    // beginning only.
+    std::size_t num_chunks = num_count_sample_chunks;
+    if (!reader->set_shard(0, num_chunks)) {
+        num_chunks = 1;
+    }
+
+    std::size_t chunk_size = sample_size / num_chunks;
+
+    std::size_t num_sampled_records = 0;
+    std::size_t num_sampled_bytes = 0;
+
+    for (std::size_t chunk_idx = 0; chunk_idx < num_chunks; chunk_idx++) {
+        if (chunk_idx > 0) {
+            reader->set_shard(chunk_idx, num_chunks);
+        }
+
+        std::size_t chunk_begin = reader->position().value_or(0);
+        std::size_t chunk_end = chunk_begin;
+
+        while (chunk_end - chunk_begin < chunk_size) {
+            std::optional<Record> record = reader->read_record();
+            if (record == std::nullopt) {
+                break;
+            }
+
+            if (is_first_record_part(*record)) {
+                num_sampled_records++;
+            }
+
+            chunk_end = reader->position().value_or(chunk_end);
+        }
+
+        num_sampled_bytes += chunk_end - chunk_begin;
+    }
+
+    // The sampled chunks fell within a few very large records; we have
+    // no choice but to count them all.
+    if (num_sampled_bytes == 0) {
+        return {count_records(*make_counting_record_reader(store, store_index)), true};
+    }
+
+    double num_records = static_cast<double>(num_sampled_records) *
+                         static_cast<double>(data_size) / static_cast<double>(num_sampled_bytes);
+
+    return {static_cast<std::size_t>(num_records + 0.5), false};
+}
+
+std::size_t
+Parallel_data_reader::count_shards_in_parallel(std::size_t store_index, std::size_t num_shards)
+{
+    const Data_store &store = *params().dataset[store_index];
+
+    std::atomic_size_t num_records{};
+
+    tbb::blocked_range<std::size_t> range{0, num_shards, 1};
+
+    tbb::parallel_for(range, [this, &store, store_index, num_shards, &num_records](
+                                 const auto &sub_range) {
+        for (std::size_t i = sub_range.begin(); i < sub_range.end(); i++) {
+            Intrusive_ptr<Record_reader> record_reader =
+                make_counting_record_reader(store, store_index);
+
+            // The caller has already checked that the reader can be
+            // split into byte ranges.
+            auto &reader = static_cast<Stream_record_reader &>(*record_reader);
+
+            reader.set_shard(i, num_shards);
+
+            num_records += count_records(reader);
+        }
+    });
+
+    return num_records;
+}
+
+void Parallel_data_reader::check_state_supported() const
+{
+    if (params().shuffle_instances && params().shuffle_seed == std::nullopt) {
+        throw Not_supported_error{
+            "The state of a reader that shuffles its instances without a seed cannot be saved or restored."};
+    }
+
+    bool samples = params().sample_ratio || !params().class_sample_ratios.empty();
+    if (samples && params().sample_seed == std::nullopt) {
+        throw Not_supported_error{
+            "The state of a reader that samples its instances without a seed cannot be saved or restored."};
+    }
+
+    if (batch_reader_->has_bucketing()) {
+        throw Not_supported_error{
+            "The state of a reader that buckets its instances cannot be saved or restored."};
+    }
+
+    if (!params().deterministic) {
+        throw Not_supported_error{
+            "The state of a reader that does not preserve the order of its examples cannot be saved or restored."};
+    }
+}
+
+void Parallel_data_reader::reset_stats() noexcept
+{
+    num_bytes_read_ = 0;
+
+    Stats_data &data = *stats_;
+
+    data.read.reset();
+    data.decode.reset();
+    data.transform.reset();
+    data.reorder.reset();
+    data.enqueue.reset();
+    data.consume.reset();
+
+    data.num_examples = 0;
+    data.num_instances = 0;
+    data.num_bad_instances = 0;
+    data.num_skipped_examples = 0;
+    data.num_filtered_instances = 0;
+
+    for (auto &num_warnings : data.num_warnings) {
+        num_warnings = 0;
+    }
+
+    data.num_suppressed_warnings = 0;
+
+    data.peak_memory_usage = 0;
+
+    {
+        std::unique_lock<std::mutex> warning_lock{data.warning_mutex};
+
+        data.num_logged_warnings = 0;
+        data.num_pending_warnings = 0;
+        data.last_summary_time = {};
+    }
+
+    // The background thread might still be running if the epochs are
+    // pipelined.
+    data.store_metrics.reset();
+
+    std::unique_lock<std::mutex> window_lock{data.window_mutex};
+
+    data.last = {};
+    data.last_time = Stats_clock::now();
 }
 
 }  // namespace abi_v1
@@ -0,0 +1,977 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/parquet_reader.h"
+
+#ifdef MLIO_BUILD_PARQUET_READER
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/result.h>
+#include <arrow/status.h>
+#include <fmt/format.h>
+#include <parquet/api/reader.h>
+#include <tbb/tbb.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/data_type.h"
+#include "mlio/device_array.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/record_readers/record_reader_base.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Parquet_file_info {
+    std::shared_ptr<parquet::FileMetaData> metadata{};
+    std::size_t file_size{};
+    // The leaf indices, names, and data types of the columns to read.
+    std::vector<int> column_indices{};
+    std::vector<std::string> column_names{};
+    std::vector<Data_type> column_types{};
+    // The row groups that passed the row group filters.
+    std::vector<int> row_groups{};
+};
+
+namespace {
+
+// The length of the file metadata followed by the "PAR1" magic number.
+constexpr std::size_t footer_size = 8;
+
+// The column chunks that are at most this many bytes apart are fetched
+// with a single read; this considerably reduces the number of requests
+// made to remote data stores such as S3.
+constexpr std::size_t max_range_gap = 0x2000;  // 8 KiB
+
+// Older parquet-mr versions wrote column chunk sizes that do not account
+// for the dictionary page header; parquet-cpp reads up to this many
+// extra bytes past the end of such column chunks.
+constexpr std::size_t column_chunk_padding = 100;
+
+// "MLRG"
+constexpr std::uint32_t row_group_record_magic = 0x47524C4D;
+
+// Each record read by the row group reader starts with this header and
+// an array of byte ranges, followed by the contents of those ranges in
+// the order they are listed.
+struct Row_group_record_header {
+    std::uint32_t magic;
+    std::uint32_t row_group;
+    std::uint64_t num_ranges;
+};
+
+struct Byte_range {
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+void read_fully(Input_stream &stream, Mutable_memory_span destination)
+{
+    while (!destination.empty()) {
+        std::size_t num_bytes_read = stream.read(destination);
+        if (num_bytes_read == 0) {
+            throw Corrupt_record_error{"The Parquet file ends unexpectedly."};
+        }
+
+        destination = destination.subspan(num_bytes_read);
+    }
+}
+
+std::optional<Data_type> get_data_type(const parquet::ColumnDescriptor &descr) noexcept
+{
+    // Nested columns cannot be represented as dense tensors.
+    if (descr.max_repetition_level() > 0) {
+        return {};
+    }
+
+    switch (descr.physical_type()) {
+    case parquet::Type::BOOLEAN:
+        return Data_type::uint8;
+    case parquet::Type::INT32:
+        return Data_type::int32;
+    case parquet::Type::INT64:
+        return Data_type::int64;
+    case parquet::Type::FLOAT:
+        return Data_type::float32;
+    case parquet::Type::DOUBLE:
+        return Data_type::float64;
+    case parquet::Type::BYTE_ARRAY:
+    case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+        return Data_type::string;
+    default:
+        return {};
+    }
+}
+
+template<typename Statistics>
+bool overlaps(const parquet::Statistics &stats, const Parquet_row_group_filter &filter)
+{
+    const auto &typed_stats = static_cast<const Statistics &>(stats);
+
+    auto min = static_cast<double>(typed_stats.min());
+    auto max = static_cast<double>(typed_stats.max());
+
+    if (filter.min_value && max < *filter.min_value) {
+        return false;
+    }
+    if (filter.max_value && min > *filter.max_value) {
+        return false;
+    }
+    return true;
+}
+
+// Returns false only if the statistics of the column chunk prove that
+// none of its values pass the filter.
+bool may_match(const parquet::RowGroupMetaData &row_group,
+               int column_index,
+               const Parquet_row_group_filter &filter)
+{
+    std::unique_ptr<parquet::ColumnChunkMetaData> chunk = row_group.ColumnChunk(column_index);
+    if (!chunk->is_stats_set()) {
+        return true;
+    }
+
+    std::shared_ptr<parquet::Statistics> stats = chunk->statistics();
+    if (stats == nullptr || !stats->HasMinMax()) {
+        return true;
+    }
+
+    switch (stats->physical_type()) {
+    case parquet::Type::INT32:
+        return overlaps<parquet::Int32Statistics>(*stats, filter);
+    case parquet::Type::INT64:
+        return overlaps<parquet::Int64Statistics>(*stats, filter);
+    case parquet::Type::FLOAT:
+        return overlaps<parquet::FloatStatistics>(*stats, filter);
+    case parquet::Type::DOUBLE:
+        return overlaps<parquet::DoubleStatistics>(*stats, filter);
+    default:
+        return true;
+    }
+}
+
+Byte_range get_column_chunk_range(const parquet::ColumnChunkMetaData &chunk, std::size_t file_size)
+{
+    std::int64_t offset = chunk.data_page_offset();
+
+    // Some writers set the dictionary page offset to zero even if the
+    // column chunk has no dictionary page.
+    std::int64_t dict_offset = chunk.dictionary_page_offset();
+    if (chunk.has_dictionary_page() && dict_offset > 0 && dict_offset < offset) {
+        offset = dict_offset;
+    }
+
+    std::int64_t size = chunk.total_compressed_size();
+
+    if (offset < 0 || size < 0 || static_cast<std::size_t>(offset) > file_size) {
+        throw Corrupt_footer_error{"The Parquet file has a column chunk with an invalid range."};
+    }
+
+    auto end = std::min(static_cast<std::size_t>(offset + size) + column_chunk_padding, file_size);
+
+    return Byte_range{static_cast<std::uint64_t>(offset), end - static_cast<std::size_t>(offset)};
+}
+
+// Reads the projected column chunks of the selected row groups of a
+// Parquet file; each record corresponds to a single row group.
+class Parquet_row_group_reader final : public Record_reader_base {
+public:
+    explicit Parquet_row_group_reader(Intrusive_ptr<Input_stream> stream,
+                                      std::shared_ptr<const Parquet_file_info> info)
+        : stream_{std::move(stream)}, info_{std::move(info)}
+    {}
+
+private:
+    std::optional<Record> read_record_core() final;
+
+    std::vector<Byte_range> get_byte_ranges(const parquet::RowGroupMetaData &row_group) const;
+
+    Intrusive_ptr<Input_stream> stream_;
+    std::shared_ptr<const Parquet_file_info> info_;
+    std::size_t row_group_pos_{};
+};
+
+std::optional<Record> Parquet_row_group_reader::read_record_core()
+{
+    if (row_group_pos_ == info_->row_groups.size()) {
+        return {};
+    }
+
+    int row_group_idx = info_->row_groups[row_group_pos_++];
+
+    std::vector<Byte_range> ranges = get_byte_ranges(*info_->metadata->RowGroup(row_group_idx));
+
+    std::size_t header_size = sizeof(Row_group_record_header) + ranges.size() * sizeof(Byte_range);
+
+    std::size_t size = header_size;
+    for (const Byte_range &range : ranges) {
+        size += range.size;
+    }
+
+    auto block = memory_allocator().allocate(size);
+
+    Mutable_memory_span bits{*block};
+
+    Row_group_record_header header{
+        row_group_record_magic, static_cast<std::uint32_t>(row_group_idx), ranges.size()};
+
+    std::memcpy(bits.data(), &header, sizeof(header));
+    std::memcpy(bits.data() + sizeof(header), ranges.data(), ranges.size() * sizeof(Byte_range));
+
+    bits = bits.subspan(header_size);
+
+    for (const Byte_range &range : ranges) {
+        stream_->seek(range.offset);
+
+        read_fully(*stream_, bits.first(range.size));
+
+        bits = bits.subspan(range.size);
+    }
+
+    return Record{Memory_slice{std::move(block)}};
+}
+
+std::vector<Byte_range>
+Parquet_row_group_reader::get_byte_ranges(const parquet::RowGroupMetaData &row_group) const
+{
+    std::vector<Byte_range> chunk_ranges{};
+    chunk_ranges.reserve(info_->column_indices.size());
+
+    for (int column_idx : info_->column_indices) {
+        chunk_ranges.emplace_back(
+            get_column_chunk_range(*row_group.ColumnChunk(column_idx), info_->file_size));
+    }
+
+    std::sort(chunk_ranges.begin(), chunk_ranges.end(), [](const auto &a, const auto &b) {
+        return a.offset < b.offset;
+    });
+
+    // Coalesce the ranges that are close to each other.
+    std::vector<Byte_range> ranges{};
+    for (const Byte_range &range : chunk_ranges) {
+        if (!ranges.empty()) {
+            Byte_range &last = ranges.back();
+
+            std::uint64_t last_end = last.offset + last.size;
+            if (range.offset <= last_end + max_range_gap) {
+                last.size = std::max(last_end, range.offset + range.size) - last.offset;
+
+                continue;
+            }
+        }
+
+        ranges.emplace_back(range);
+    }
+
+    return ranges;
+}
+
+// Exposes the byte ranges of a row group record as a sparse Parquet
+// file to parquet-cpp. The reads are stateless and can be issued
+// concurrently by the column decode tasks.
+class Row_group_file final : public arrow::io::RandomAccessFile {
+public:
+    explicit Row_group_file(Memory_slice bits, std::size_t file_size)
+        : bits_{std::move(bits)}, file_size_{static_cast<std::int64_t>(file_size)}
+    {}
+
+    Row_group_file(const Row_group_file &) = delete;
+
+    Row_group_file(Row_group_file &&) = delete;
+
+    ~Row_group_file() final = default;
+
+public:
+    Row_group_file &operator=(const Row_group_file &) = delete;
+
+    Row_group_file &operator=(Row_group_file &&) = delete;
+
+public:
+    /// Parses the header of the record. Returns the index of the row
+    /// group, or std::nullopt if the record is malformed.
+    std::optional<int> init();
+
+    arrow::Result<std::int64_t>
+    ReadAt(std::int64_t position, std::int64_t nbytes, void *out) noexcept final;
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>>
+    ReadAt(std::int64_t position, std::int64_t nbytes) noexcept final;
+
+    arrow::Result<std::int64_t> Read(std::int64_t nbytes, void *out) noexcept final;
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(std::int64_t nbytes) noexcept final;
+
+    arrow::Status Seek(std::int64_t position) noexcept final;
+
+    arrow::Status Close() noexcept final;
+
+    arrow::Result<std::int64_t> Tell() const noexcept final;
+
+    arrow::Result<std::int64_t> GetSize() noexcept final;
+
+    bool supports_zero_copy() const noexcept final;
+
+    bool closed() const noexcept final;
+
+private:
+    struct Fetched_range {
+        std::int64_t offset;
+        Memory_span bits;
+    };
+
+    arrow::Result<Memory_span> find(std::int64_t position, std::int64_t nbytes) const noexcept;
+
+    Memory_slice bits_;
+    std::int64_t file_size_;
+    std::vector<Fetched_range> ranges_{};
+    std::int64_t position_{};
+    bool closed_{};
+};
+
+std::optional<int> Row_group_file::init()
+{
+    Memory_span bits{bits_};
+
+    Row_group_record_header header{};
+    if (bits.size() < sizeof(header)) {
+        return {};
+    }
+
+    std::memcpy(&header, bits.data(), sizeof(header));
+    if (header.magic != row_group_record_magic) {
+        return {};
+    }
+
+    bits = bits.subspan(sizeof(header));
+
+    if (header.num_ranges > bits.size() / sizeof(Byte_range)) {
+        return {};
+    }
+
+    std::vector<Byte_range> ranges(header.num_ranges);
+
+    std::memcpy(ranges.data(), bits.data(), ranges.size() * sizeof(Byte_range));
+
+    bits = bits.subspan(ranges.size() * sizeof(Byte_range));
+
+    ranges_.reserve(ranges.size());
+
+    for (const Byte_range &range : ranges) {
+        if (range.size > bits.size()) {
+            return {};
+        }
+
+        ranges_.push_back({static_cast<std::int64_t>(range.offset), bits.first(range.size)});
+
+        bits = bits.subspan(range.size);
+    }
+
+    return static_cast<int>(header.row_group);
+}
+
+arrow::Result<Memory_span>
+Row_group_file::find(std::int64_t position, std::int64_t nbytes) const noexcept
+{
+    for (const Fetched_range &range : ranges_) {
+        auto range_size = static_cast<std::int64_t>(range.bits.size());
+
+        if (position >= range.offset && position + nbytes <= range.offset + range_size) {
+            return range.bits.subspan(static_cast<std::size_t>(position - range.offset),
+                                      static_cast<std::size_t>(nbytes));
+        }
+    }
+
+    return arrow::Status::IOError(
+        fmt::format("The byte range [{0}, {1}) of the Parquet file has not been fetched.",
+                    position,
+                    position + nbytes));
+}
+
+arrow::Result<std::int64_t>
+Row_group_file::ReadAt(std::int64_t position, std::int64_t nbytes, void *out) noexcept
+{
+    ARROW_ASSIGN_OR_RAISE(Memory_span bits, find(position, nbytes));
+
+    std::memcpy(out, bits.data(), bits.size());
+
+    return nbytes;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+Row_group_file::ReadAt(std::int64_t position, std::int64_t nbytes) noexcept
+{
+    ARROW_ASSIGN_OR_RAISE(Memory_span bits, find(position, nbytes));
+
+    // The buffer does not own its data; the record outlives the column
+    // readers.
+    return std::make_shared<arrow::Buffer>(reinterpret_cast<const std::uint8_t *>(bits.data()),
+                                           nbytes);
+}
+
+arrow::Result<std::int64_t> Row_group_file::Read(std::int64_t nbytes, void *out) noexcept
+{
+    ARROW_ASSIGN_OR_RAISE(std::int64_t num_bytes_read, ReadAt(position_, nbytes, out));
+
+    position_ += num_bytes_read;
+
+    return num_bytes_read;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> Row_group_file::Read(std::int64_t nbytes) noexcept
+{
+    ARROW_ASSIGN_OR_RAISE(std::shared_ptr<arrow::Buffer> buffer, ReadAt(position_, nbytes));
+
+    position_ += buffer->size();
+
+    return buffer;
+}
+
+arrow::Status Row_group_file::Seek(std::int64_t position) noexcept
+{
+    position_ = position;
+
+    return arrow::Status::OK();
+}
+
+arrow::Status Row_group_file::Close() noexcept
+{
+    closed_ = true;
+
+    return arrow::Status::OK();
+}
+
+arrow::Result<std::int64_t> Row_group_file::Tell() const noexcept
+{
+    return position_;
+}
+
+arrow::Result<std::int64_t> Row_group_file::GetSize() noexcept
+{
+    return file_size_;
+}
+
+bool Row_group_file::supports_zero_copy() const noexcept
+{
+    return true;
+}
+
+bool Row_group_file::closed() const noexcept
+{
+    return closed_;
+}
+
+struct Row_group {
+    const Instance *instance{};
+    std::shared_ptr<const Parquet_file_info> info{};
+    std::unique_ptr<parquet::ParquetFileReader> file_reader{};
+    int index{};
+    std::size_t row_offset{};
+    std::size_t num_rows{};
+};
+
+template<typename T>
+T get_null_value() noexcept
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    else {
+        return T{};
+    }
+}
+
+// Reads the values of a flat column chunk into the specified span.
+template<typename Parquet_type, typename T, typename Convert>
+void read_column_chunk(parquet::ColumnReader &reader, stdx::span<T> destination, Convert convert)
+{
+    using Value_type = typename Parquet_type::c_type;
+
+    constexpr std::int64_t max_batch_size = 0x10000;
+
+    auto &typed_reader = static_cast<parquet::TypedColumnReader<Parquet_type> &>(reader);
+
+    std::int16_t max_def_level = reader.descr()->max_definition_level();
+
+    // Values of a required column can be read straight into the tensor
+    // if they do not need to be converted.
+    constexpr bool is_direct = std::is_same_v<Value_type, T>;
+
+    auto batch_size = std::min(max_batch_size, static_cast<std::int64_t>(destination.size()));
+
+    std::unique_ptr<Value_type[]> values{};
+    if (!is_direct || max_def_level > 0) {
+        values = std::make_unique<Value_type[]>(static_cast<std::size_t>(batch_size));
+    }
+
+    std::unique_ptr<std::int16_t[]> def_levels{};
+    if (max_def_level > 0) {
+        def_levels = std::make_unique<std::int16_t[]>(static_cast<std::size_t>(batch_size));
+    }
+
+    auto pos = destination.begin();
+
+    while (pos != destination.end() && typed_reader.HasNext()) {
+        auto num_rows = std::min(batch_size, static_cast<std::int64_t>(destination.end() - pos));
+
+        std::int64_t num_values{};
+
+        if constexpr (is_direct) {
+            if (max_def_level == 0) {
+                typed_reader.ReadBatch(num_rows, nullptr, nullptr, &*pos, &num_values);
+
+                pos += num_values;
+
+                continue;
+            }
+        }
+
+        std::int64_t num_levels = typed_reader.ReadBatch(
+            num_rows, def_levels.get(), nullptr, values.get(), &num_values);
+
+        if (max_def_level == 0) {
+            pos = std::transform(values.get(), values.get() + num_values, pos, convert);
+
+            continue;
+        }
+
+        const Value_type *value_pos = values.get();
+        for (std::int64_t i = 0; i < num_levels; i++) {
+            if (def_levels[static_cast<std::size_t>(i)] == max_def_level) {
+                *pos++ = convert(*value_pos++);
+            }
+            else {
+                *pos++ = get_null_value<T>();
+            }
+        }
+    }
+
+    if (pos != destination.end()) {
+        throw Corrupt_record_error{"The column chunk has fewer values than its row group."};
+    }
+}
+
+template<typename T>
+stdx::span<T> get_rows(Device_array &arr, const Row_group &row_group) noexcept
+{
+    return as_span<T>(arr).subspan(row_group.row_offset, row_group.num_rows);
+}
+
+void decode_column_chunk(const Row_group &row_group, std::size_t column, Device_array &arr)
+{
+    int column_idx = row_group.info->column_indices[column];
+
+    std::shared_ptr<parquet::ColumnReader> reader =
+        row_group.file_reader->RowGroup(row_group.index)->Column(column_idx);
+
+    auto identity = [](auto value) {
+        return value;
+    };
+
+    switch (reader->descr()->physical_type()) {
+    case parquet::Type::BOOLEAN:
+        read_column_chunk<parquet::BooleanType>(
+            *reader, get_rows<std::uint8_t>(arr, row_group), [](bool value) {
+                return static_cast<std::uint8_t>(value);
+            });
+        break;
+    case parquet::Type::INT32:
+        read_column_chunk<parquet::Int32Type>(
+            *reader, get_rows<std::int32_t>(arr, row_group), identity);
+        break;
+    case parquet::Type::INT64:
+        read_column_chunk<parquet::Int64Type>(
+            *reader, get_rows<std::int64_t>(arr, row_group), identity);
+        break;
+    case parquet::Type::FLOAT:
+        read_column_chunk<parquet::FloatType>(*reader, get_rows<float>(arr, row_group), identity);
+        break;
+    case parquet::Type::DOUBLE:
+        read_column_chunk<parquet::DoubleType>(*reader, get_rows<double>(arr, row_group), identity);
+        break;
+    case parquet::Type::BYTE_ARRAY:
+        read_column_chunk<parquet::ByteArrayType>(
+            *reader, get_rows<std::string>(arr, row_group), [](const parquet::ByteArray &value) {
+                return std::string(reinterpret_cast<const char *>(value.ptr), value.len);
+            });
+        break;
+    case parquet::Type::FIXED_LEN_BYTE_ARRAY: {
+        auto len = static_cast<std::size_t>(reader->descr()->type_length());
+
+        read_column_chunk<parquet::FLBAType>(
+            *reader,
+            get_rows<std::string>(arr, row_group),
+            [len](const parquet::FixedLenByteArray &value) {
+                return std::string(reinterpret_cast<const char *>(value.ptr), len);
+            });
+        break;
+    }
+    default:
+        throw Not_supported_error{"The column has an unsupported physical type."};
+    }
+}
+
+}  // namespace
+}  // namespace detail
+
+Parquet_reader::Parquet_reader(Data_reader_params params, Parquet_reader_params pq_params)
+    : Parallel_data_reader{std::move(params)}, params_{std::move(pq_params)}
+{
+    // The batch size counts row groups, not rows, so dropping or padding
+    // a short last example would depend on the row group layout.
+    if (this->params().last_example_handling != Last_example_handling::none) {
+        throw std::invalid_argument{
+            "The Parquet reader batches row groups; the last example handling must be none."};
+    }
+}
+
+Parquet_reader::~Parquet_reader()
+{
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Parquet_reader::make_record_reader(const Data_store &store)
+{
+    auto stream = store.open_read();
+
+    std::shared_ptr<const detail::Parquet_file_info> info = read_file_info(store, *stream);
+
+    return make_intrusive<detail::Parquet_row_group_reader>(std::move(stream), std::move(info));
+}
+
+std::shared_ptr<const detail::Parquet_file_info>
+Parquet_reader::read_file_info(const Data_store &store, Input_stream &stream)
+{
+    if (!stream.seekable()) {
+        throw Not_supported_error{fmt::format(
+            "The data store '{0}' is not seekable. Parquet files cannot be read from compressed or streamed data stores.",
+            store.id())};
+    }
+
+    std::size_t file_size = stream.size();
+    if (file_size < detail::footer_size + 4) {
+        throw Corrupt_footer_error{
+            fmt::format("The data store '{0}' is not a valid Parquet file.", store.id())};
+    }
+
+    std::array<std::byte, detail::footer_size> footer{};
+
+    stream.seek(file_size - detail::footer_size);
+
+    detail::read_fully(stream, footer);
+
+    if (std::memcmp(footer.data() + 4, "PAR1", 4) != 0) {
+        throw Corrupt_footer_error{
+            fmt::format("The data store '{0}' is not a valid Parquet file.", store.id())};
+    }
+
+    std::uint32_t metadata_size = 0;
+    for (std::size_t i = 4; i > 0; i--) {
+        metadata_size = (metadata_size << 8) | std::to_integer<std::uint32_t>(footer[i - 1]);
+    }
+
+    if (metadata_size > file_size - detail::footer_size - 4) {
+        throw Corrupt_footer_error{fmt::format(
+            "The Parquet file in the data store '{0}' has an invalid metadata size.", store.id())};
+    }
+
+    std::vector<std::byte> metadata_bits(metadata_size);
+
+    stream.seek(file_size - detail::footer_size - metadata_size);
+
+    detail::read_fully(stream, metadata_bits);
+
+    auto info = std::make_shared<detail::Parquet_file_info>();
+
+    info->file_size = file_size;
+
+    try {
+        info->metadata = parquet::FileMetaData::Make(metadata_bits.data(), &metadata_size);
+    }
+    catch (const parquet::ParquetException &e) {
+        throw Corrupt_footer_error{fmt::format(
+            "The metadata of the Parquet file in the data store '{0}' cannot be parsed: {1}",
+            store.id(),
+            e.what())};
+    }
+
+    const parquet::SchemaDescriptor *schema = info->metadata->schema();
+
+    for (int i = 0; i < schema->num_columns(); i++) {
+        const parquet::ColumnDescriptor *descr = schema->Column(i);
+
+        std::string name = descr->path()->ToDotString();
+
+        if (!params_.use_columns.empty() && params_.use_columns.count(name) == 0) {
+            continue;
+        }
+
+        std::optional<Data_type> dt = detail::get_data_type(*descr);
+        if (dt == std::nullopt) {
+            if (params_.use_columns.empty()) {
+                continue;
+            }
+
+            throw Not_supported_error{fmt::format(
+                "The column '{0}' in the data store '{1}' is of an unsupported type.",
+                name,
+                store.id())};
+        }
+
+        info->column_indices.emplace_back(i);
+        info->column_names.emplace_back(std::move(name));
+        info->column_types.emplace_back(*dt);
+    }
+
+    if (!params_.use_columns.empty() && info->column_names.size() != params_.use_columns.size()) {
+        for (const std::string &name : params_.use_columns) {
+            auto pos = std::find(info->column_names.begin(), info->column_names.end(), name);
+            if (pos == info->column_names.end()) {
+                throw Schema_error{fmt::format(
+                    "The data store '{0}' does not have a column named '{1}'.", store.id(), name)};
+            }
+        }
+    }
+
+    std::vector<int> filter_columns{};
+    filter_columns.reserve(params_.row_group_filters.size());
+
+    for (const Parquet_row_group_filter &filter : params_.row_group_filters) {
+        int idx = schema->ColumnIndex(filter.column);
+        if (idx < 0) {
+            throw Schema_error{fmt::format("The data store '{0}' does not have a column named '{1}'.",
+                                           store.id(),
+                                           filter.column)};
+        }
+
+        filter_columns.emplace_back(idx);
+    }
+
+    for (int i = 0; i < info->metadata->num_row_groups(); i++) {
+        std::unique_ptr<parquet::RowGroupMetaData> row_group = info->metadata->RowGroup(i);
+
+        bool may_match = true;
+        for (std::size_t j = 0; j < filter_columns.size() && may_match; j++) {
+            may_match = detail::may_match(*row_group, filter_columns[j], params_.row_group_filters[j]);
+        }
+
+        if (may_match) {
+            info->row_groups.emplace_back(i);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock{file_info_mutex_};
+
+    file_infos_[&store] = info;
+
+    return info;
+}
+
+std::shared_ptr<const detail::Parquet_file_info>
+Parquet_reader::get_file_info(const Data_store &store) const
+{
+    std::unique_lock<std::mutex> lock{file_info_mutex_};
+
+    auto pos = file_infos_.find(&store);
+    if (pos == file_infos_.end()) {
+        throw std::logic_error{"The metadata of the Parquet file has not been read."};
+    }
+
+    return pos->second;
+}
+
+Intrusive_ptr<const Schema> Parquet_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    std::vector<Attribute> attrs{};
+
+    if (instance) {
+        std::shared_ptr<const detail::Parquet_file_info> info =
+            get_file_info(instance->data_store());
+
+        // The number of rows in an example depends on the row groups it
+        // contains.
+        for (std::size_t i = 0; i < info->column_names.size(); i++) {
+            attrs.emplace_back(info->column_names[i], info->column_types[i], Size_vector{0, 1});
+        }
+    }
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Parquet_reader::decode(const Instance_batch &batch) const
+{
+    const std::vector<Attribute> &attrs = schema()->attributes();
+
+    std::vector<detail::Row_group> row_groups{};
+    row_groups.reserve(batch.instances().size());
+
+    std::size_t num_rows = 0;
+
+    for (const Instance &instance : batch.instances()) {
+        detail::Row_group &row_group = row_groups.emplace_back();
+
+        row_group.instance = &instance;
+        row_group.info = get_file_info(instance.data_store());
+
+        auto file = std::make_shared<detail::Row_group_file>(instance.bits(),
+                                                             row_group.info->file_size);
+
+        std::optional<int> index = file->init();
+        if (index == std::nullopt) {
+            throw Invalid_instance_error{fmt::format(
+                "The row group #{1:n} in the data store '{0}' is malformed.",
+                instance.data_store().id(),
+                instance.index())};
+        }
+
+        const detail::Parquet_file_info &info = *row_group.info;
+
+        bool matches_schema = info.column_names.size() == attrs.size();
+        for (std::size_t i = 0; i < attrs.size() && matches_schema; i++) {
+            matches_schema = info.column_names[i] == attrs[i].name() &&
+                             info.column_types[i] == attrs[i].data_type();
+        }
+
+        if (!matches_schema) {
+            throw Schema_error{fmt::format(
+                "The columns of the Parquet file in the data store '{0}' do not match the schema of the dataset.",
+                instance.data_store().id())};
+        }
+
+        row_group.file_reader = parquet::ParquetFileReader::Open(
+            std::move(file), parquet::default_reader_properties(), info.metadata);
+
+        row_group.index = *index;
+        row_group.row_offset = num_rows;
+        row_group.num_rows = as_size(info.metadata->RowGroup(*index)->num_rows());
+
+        num_rows += row_group.num_rows;
+    }
+
+    std::vector<Intrusive_ptr<Dense_tensor>> tensors{};
+    tensors.reserve(attrs.size());
+
+    for (const Attribute &attr : attrs) {
+        auto arr = make_pooled_cpu_array(attr.data_type(), num_rows);
+
+        tensors.emplace_back(
+            make_intrusive<Dense_tensor>(Size_vector{num_rows, 1}, std::move(arr)));
+    }
+
+    // Each column chunk of the batch is decoded by a separate task.
+    std::size_t num_tasks = row_groups.size() * attrs.size();
+
+    auto worker = [&](const tbb::blocked_range<std::size_t> &range) {
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            const detail::Row_group &row_group = row_groups[i / attrs.size()];
+
+            std::size_t column = i % attrs.size();
+
+            try {
+                detail::decode_column_chunk(row_group, column, tensors[column]->data());
+            }
+            catch (const std::exception &e) {
+                throw Invalid_instance_error{fmt::format(
+                    "The column '{2}' of the row group #{1:n} in the data store '{0}' cannot be decoded: {3}",
+                    row_group.instance->data_store().id(),
+                    row_group.index,
+                    attrs[column].name(),
+                    e.what())};
+            }
+        }
+    };
+
+    tbb::blocked_range<std::size_t> range{0, num_tasks};
+
+    if (num_tasks > 1 && should_decode_parallel(num_rows, attrs.size())) {
+        tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+    }
+    else {
+        worker(range);
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> features{tensors.begin(), tensors.end()};
+
+    return make_intrusive<Example>(schema(), std::move(features));
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record_reader.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+Parquet_reader::Parquet_reader(Data_reader_params params, Parquet_reader_params)
+    : Parallel_data_reader{std::move(params)}
+{
+    throw Not_supported_error{"MLIO was not built with Parquet reader support."};
+}
+
+Parquet_reader::~Parquet_reader() = default;
+
+Intrusive_ptr<Record_reader> Parquet_reader::make_record_reader(const Data_store &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<const Schema> Parquet_reader::infer_schema(const std::optional<Instance> &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<Example> Parquet_reader::decode(const Instance_batch &) const
+{
+    return nullptr;
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -15,8 +15,15 @@
 
 #include "mlio/parser.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "mlio/detail/half.h"
+#include "mlio/util/datetime.h"
 #include "mlio/util/number.h"
 
 namespace mlio {
@@ -41,11 +48,31 @@ Return_if<dt == Data_type::size> make_parser_core(const Parser_options &)
     };
 }
 
+// The half-precision types are parsed as single-precision values and
+// then narrowed.
+inline std::uint16_t narrow_float(Data_type dt, float value) noexcept
+{
+    if (dt == Data_type::float16) {
+        return float_to_half(value);
+    }
+    return float_to_bfloat16(value);
+}
+
 template<Data_type dt>
-Return_if<dt == Data_type::float16> make_parser_core(const Parser_options &)
+Return_if<dt == Data_type::float16 || dt == Data_type::bfloat16>
+make_parser_core(const Parser_options &opts)
 {
-    return [](std::string_view, Device_array_span, std::size_t) {
-        return Parse_result::failed;
+    auto matcher = std::make_shared<const Nan_value_matcher>(opts.nan_values);
+
+    return [matcher](std::string_view s, Device_array_span arr, std::size_t index) {
+        float value{};
+
+        Parse_result r = try_parse_float(s, value, {nullptr, matcher.get()});
+        if (r == Parse_result::ok) {
+            at<dt>(arr, index) = narrow_float(dt, value);
+        }
+
+        return r;
     };
 }
 
@@ -53,8 +80,10 @@ template<Data_type dt>
 Return_if<dt == Data_type::float32 || dt == Data_type::float64>
 make_parser_core(const Parser_options &opts)
 {
-    return [&opts](std::string_view s, Device_array_span arr, std::size_t index) {
-        return try_parse_float(s, at<dt>(arr, index), {&opts.nan_values});
+    auto matcher = std::make_shared<const Nan_value_matcher>(opts.nan_values);
+
+    return [matcher](std::string_view s, Device_array_span arr, std::size_t index) {
+        return try_parse_float(s, at<dt>(arr, index), {nullptr, matcher.get()});
     };
 }
 
@@ -72,6 +101,22 @@ make_parser_core(const Parser_options &opts)
     };
 }
 
+template<Data_type dt>
+Return_if<dt == Data_type::timestamp || dt == Data_type::date>
+make_parser_core(const Parser_options &opts)
+{
+    auto format = std::make_shared<const Datetime_format>(opts.datetime_format);
+
+    return [format](std::string_view s, Device_array_span arr, std::size_t index) {
+        if constexpr (dt == Data_type::timestamp) {
+            return try_parse_timestamp(s, at<dt>(arr, index), {format.get()});
+        }
+        else {
+            return try_parse_date(s, at<dt>(arr, index), {format.get()});
+        }
+    };
+}
+
 template<Data_type dt>
 Return_if<dt == Data_type::string> make_parser_core(const Parser_options &)
 {
@@ -90,6 +135,206 @@ struct make_parser_op {
     }
 };
 
+// Holds the parser options of a column parse operation; the NaN values
+// and the datetime format are compiled once per column instead of being
+// interpreted per field.
+struct Column_parse_options {
+    explicit Column_parse_options(const Parser_options &opts, Data_type dt) : base{opts.base}
+    {
+        if (dt == Data_type::float32 || dt == Data_type::float64) {
+            nan_matcher = Nan_value_matcher{opts.nan_values};
+        }
+        else if (dt == Data_type::timestamp || dt == Data_type::date) {
+            datetime_format = Datetime_format{opts.datetime_format};
+        }
+    }
+
+    Nan_value_matcher nan_matcher{};
+    Datetime_format datetime_format{};
+    int base;
+};
+
+template<Data_type dt>
+struct Field_parser;
+
+template<>
+struct Field_parser<Data_type::size> {
+    static Parse_result parse(std::string_view s, std::size_t &value, const Column_parse_options &)
+    {
+        return try_parse_size_t(s, value);
+    }
+};
+
+template<>
+struct Field_parser<Data_type::string> {
+    static Parse_result parse(std::string_view s, std::string &value, const Column_parse_options &)
+    {
+        value.assign(s.data(), s.size());
+
+        return Parse_result::ok;
+    }
+};
+
+template<>
+struct Field_parser<Data_type::timestamp> {
+    static Parse_result
+    parse(std::string_view s, std::int64_t &value, const Column_parse_options &opts)
+    {
+        return try_parse_timestamp(s, value, {&opts.datetime_format});
+    }
+};
+
+template<>
+struct Field_parser<Data_type::date> {
+    static Parse_result
+    parse(std::string_view s, std::int64_t &value, const Column_parse_options &opts)
+    {
+        return try_parse_date(s, value, {&opts.datetime_format});
+    }
+};
+
+template<Data_type dt>
+struct Field_parser {
+    using T = data_type_t<dt>;
+
+    static Parse_result parse(std::string_view s, T &value, const Column_parse_options &opts)
+    {
+        if constexpr (std::is_floating_point<T>::value) {
+            return try_parse_float(s, value, {nullptr, &opts.nan_matcher});
+        }
+        else {
+            return try_parse_int(s, value, {opts.base});
+        }
+    }
+};
+
+inline Row_state as_row_state(Parse_result r) noexcept
+{
+    if (r == Parse_result::overflowed) {
+        return Row_state::overflowed;
+    }
+    return Row_state::parse_failed;
+}
+
+template<Data_type dt>
+std::size_t parse_column(stdx::span<const std::string_view> fields,
+                         std::size_t stride,
+                         stdx::span<Row_state> row_states,
+                         Device_array_span arr,
+                         std::size_t offset,
+                         const Parser_options &opts)
+{
+    auto *values = arr.as<data_type_t<dt>>().data() + offset;
+
+    std::size_t num_failed = 0;
+
+    std::size_t field_idx = 0;
+
+    Column_parse_options column_opts{opts, dt};
+
+    for (Row_state &state : row_states) {
+        if (state == Row_state::good) {
+            Parse_result r = Field_parser<dt>::parse(fields[field_idx], *values, column_opts);
+            if (r != Parse_result::ok) {
+                state = as_row_state(r);
+
+                num_failed++;
+            }
+        }
+
+        field_idx += stride;
+
+        ++values;
+    }
+
+    return num_failed;
+}
+
+// Parses the fields into a single-precision buffer first so that the
+// whole column can be narrowed at once, using the F16C instructions
+// for float16 where available.
+template<Data_type dt>
+std::size_t parse_half_column(stdx::span<const std::string_view> fields,
+                              std::size_t stride,
+                              stdx::span<Row_state> row_states,
+                              Device_array_span arr,
+                              std::size_t offset,
+                              const Parser_options &opts)
+{
+    thread_local std::vector<float> buffer{};
+
+    buffer.resize(row_states.size());
+
+    std::size_t num_failed = 0;
+
+    std::size_t field_idx = 0;
+
+    Nan_value_matcher nan_matcher{opts.nan_values};
+
+    for (std::size_t row_idx = 0; row_idx < row_states.size(); row_idx++) {
+        Row_state &state = row_states[row_idx];
+
+        // The values of the bad rows are discarded when the column gets
+        // compacted; just make sure that they are initialized.
+        buffer[row_idx] = 0;
+
+        if (state == Row_state::good) {
+            Parse_result r =
+                try_parse_float(fields[field_idx], buffer[row_idx], {nullptr, &nan_matcher});
+            if (r != Parse_result::ok) {
+                state = as_row_state(r);
+
+                num_failed++;
+            }
+        }
+
+        field_idx += stride;
+    }
+
+    auto *values = arr.as<std::uint16_t>().data() + offset;
+
+    if constexpr (dt == Data_type::float16) {
+        float_to_half(buffer.data(), values, buffer.size());
+    }
+    else {
+        float_to_bfloat16(buffer.data(), values, buffer.size());
+    }
+
+    return num_failed;
+}
+
+template<Data_type dt>
+void compact_column(Device_array_span arr,
+                    std::size_t offset,
+                    stdx::span<const Row_state> row_states)
+{
+    auto *first = arr.as<data_type_t<dt>>().data() + offset;
+
+    auto *pos = first;
+    for (Row_state state : row_states) {
+        if (state == Row_state::good) {
+            if (pos != first) {
+                *pos = std::move(*first);
+            }
+            ++pos;
+        }
+        ++first;
+    }
+}
+
+template<Data_type dt>
+struct make_column_parser_op {
+    Column_parser operator()()
+    {
+        if constexpr (dt == Data_type::float16 || dt == Data_type::bfloat16) {
+            return Column_parser{&parse_half_column<dt>, &compact_column<dt>};
+        }
+        else {
+            return Column_parser{&parse_column<dt>, &compact_column<dt>};
+        }
+    }
+};
+
 }  // namespace
 }  // namespace detail
 
@@ -98,5 +343,10 @@ Parser make_parser(Data_type dt, const Parser_options &opts)
     return dispatch<detail::make_parser_op>(dt, opts);
 }
 
+Column_parser make_column_parser(Data_type dt)
+{
+    return dispatch<detail::make_column_parser_op>(dt);
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/record_readers/avro_record_reader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/avro.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The maximum size of the object count and the block size.
+constexpr std::size_t max_header_size = 20;
+
+}  // namespace
+
+std::optional<Record> Avro_record_reader::decode_record(Memory_slice &chunk, bool ignore_leftover)
+{
+    if (chunk.empty()) {
+        return {};
+    }
+
+    Avro_cursor cursor{chunk};
+
+    std::int64_t num_objects{};
+    std::int64_t size{};
+
+    if (!cursor.read_long(num_objects) || !cursor.read_long(size)) {
+        if (ignore_leftover && chunk.size() < max_header_size) {
+            return {};
+        }
+
+        throw Corrupt_header_error{"The Avro block header is malformed."};
+    }
+
+    if (num_objects < 0 || size < 0) {
+        throw Corrupt_header_error{"The Avro block header has a negative object count or size."};
+    }
+
+    std::size_t header_size = chunk.size() - cursor.remaining();
+
+    // Guard against a corrupt size making us read ahead a huge amount of
+    // data.
+    if (static_cast<std::uint64_t>(size) > std::numeric_limits<std::uint32_t>::max()) {
+        throw Corrupt_header_error{"The size in the Avro block header is too large."};
+    }
+
+    std::size_t payload_size = header_size + static_cast<std::size_t>(size);
+
+    std::size_t record_size = payload_size + sync_marker_.size();
+
+    if (record_size > chunk.size()) {
+        if (ignore_leftover) {
+            set_record_size_hint(record_size);
+
+            return {};
+        }
+
+        throw Corrupt_record_error{fmt::format(
+            "The Avro block has a size of {0:n} byte(s) while the size specified in its header is {1:n} byte(s) followed by a sync marker.",
+            chunk.size() - header_size,
+            size)};
+    }
+
+    if (std::memcmp(chunk.data() + payload_size, sync_marker_.data(), sync_marker_.size()) != 0) {
+        throw Corrupt_footer_error{
+            "The sync marker of the Avro block does not match the one in the file header."};
+    }
+
+    auto payload = chunk.subslice(0, payload_size);
+
+    chunk = chunk.subslice(record_size);
+
+    return Record{std::move(payload)};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
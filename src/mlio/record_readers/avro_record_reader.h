@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/stream_record_reader.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Reads the data blocks of an Avro object container file. The stream
+// must be positioned right after the file header. Each record holds the
+// object count, the size, and the data of a block; the sync marker that
+// follows the block is verified and left out.
+class Avro_record_reader final : public Stream_record_reader {
+public:
+    explicit Avro_record_reader(Intrusive_ptr<Input_stream> stream,
+                                const std::array<std::byte, 16> &sync_marker)
+        : Stream_record_reader{std::move(stream)}, sync_marker_{sync_marker}
+    {}
+
+private:
+    std::optional<Record> decode_record(Memory_slice &chunk, bool ignore_leftover) final;
+
+    std::array<std::byte, 16> sync_marker_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,11 +16,13 @@
 #include "mlio/record_readers/csv_record_reader.h"
 
 #include <cstddef>
+#include <utility>
 
 #include <fmt/format.h>
 
 #include "mlio/csv_reader.h"
 #include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/detail/csv_framing.h"
 #include "mlio/record_readers/detail/text_line.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/record_readers/record_error.h"
@@ -30,10 +32,25 @@
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
+
+// Chunks smaller than this are framed serially.
+constexpr std::size_t parallel_framing_threshold = 0x40'0000;  // 4 MiB
+
+}  // namespace
 
 std::optional<Record>
 Csv_record_reader::decode_text_record(Memory_slice &chunk, bool ignore_leftover)
 {
+    // Without quoted new lines every line terminator ends a record, so
+    // the lines of the chunk can be found and filtered in a single pass.
+    if (!params_->allow_quoted_new_lines) {
+        std::optional<Record> record = read_indexed_line(chunk);
+        if (record) {
+            return record;
+        }
+    }
+
     while (!chunk.empty()) {
         if (is_comment_line(chunk)) {
             if (detail::read_line(chunk, ignore_leftover) == std::nullopt) {
@@ -43,7 +60,7 @@ Csv_record_reader::decode_text_record(Memory_slice &chunk, bool ignore_leftover)
         else {
             std::optional<Record> record;
             if (params_->allow_quoted_new_lines) {
-                record = read_line(chunk, ignore_leftover);
+                record = read_framed_line(chunk, ignore_leftover);
             }
             else {
                 record = detail::read_line(chunk, ignore_leftover, params_->max_line_length);
@@ -62,6 +79,76 @@ Csv_record_reader::decode_text_record(Memory_slice &chunk, bool ignore_leftover)
     return {};
 }
 
+std::optional<Record> Csv_record_reader::read_indexed_line(Memory_slice &chunk)
+{
+    if (chunk.empty()) {
+        return {};
+    }
+
+    if (!is_indexed(chunk)) {
+        index_lines(chunk);
+    }
+
+    if (line_idx_ == lines_.size()) {
+        // Skip the comment and blank lines that follow the last line. The
+        // remainder of the chunk is a partial line, a line that exceeds
+        // the maximum length, or the last line of the stream if it does
+        // not end with a line terminator; it is read serially.
+        chunk.remove_prefix(num_indexed_chars_ - line_offset_);
+
+        indexed_chunk_ = {};
+
+        line_refs_.release();
+
+        return {};
+    }
+
+    const Line_span &line = lines_[line_idx_++];
+
+    // Skip the comment and blank lines that precede the line.
+    chunk.remove_prefix(line.begin - line_offset_);
+
+    Memory_slice payload{
+        line_refs_.take(), chunk.begin(), chunk.begin() + as_ssize(line.end - line.begin)};
+
+    chunk.remove_prefix(line.next - line.begin);
+
+    line_offset_ = line.next;
+
+    return Record{std::move(payload)};
+}
+
+inline bool Csv_record_reader::is_indexed(const Memory_slice &chunk) const noexcept
+{
+    // A chunk that starts right after the end of the indexed chunk, or
+    // that starts at its leftover (e.g. in a chunk ring), is a different
+    // one even if the addresses match.
+    return line_offset_ < indexed_chunk_.size() && chunk.end() == indexed_chunk_.end() &&
+           chunk.begin() == indexed_chunk_.begin() + as_ssize(line_offset_);
+}
+
+void Csv_record_reader::index_lines(const Memory_slice &chunk)
+{
+    lines_.clear();
+
+    Line_filter filter{};
+    filter.comment_char = params_->comment_char;
+    filter.skip_blank_lines = params_->skip_blank_lines;
+    filter.max_line_length = params_->max_line_length;
+
+    Line_scan_result result = find_lines(as_span<const char>(chunk), filter, lines_);
+
+    num_indexed_chars_ = result.num_chars_scanned;
+
+    indexed_chunk_ = chunk;
+
+    line_refs_ = Ref_batch<Memory_block>{chunk.block().get(), lines_.size()};
+
+    line_idx_ = 0;
+
+    line_offset_ = 0;
+}
+
 inline bool Csv_record_reader::is_comment_line(const Memory_slice &chunk)
 {
     if (params_->comment_char == std::nullopt) {
@@ -72,6 +159,57 @@ inline bool Csv_record_reader::is_comment_line(const Memory_slice &chunk)
     return !chars.empty() && chars[0] == *params_->comment_char;
 }
 
+std::optional<Record>
+Csv_record_reader::read_framed_line(Memory_slice &chunk, bool ignore_leftover)
+{
+    bool is_framed = !framed_chunk_.empty() && chunk.end() == framed_chunk_.end() &&
+                     chunk.begin() == framed_chunk_.begin() + as_ssize(frame_offset_);
+
+    if (!is_framed) {
+        framed_chunk_ = {};
+
+        frames_.clear();
+
+        // Comment lines are not quote-aware; they cannot be told apart
+        // without reading the chunk serially.
+        if (chunk.size() < parallel_framing_threshold || params_->comment_char) {
+            return read_line(chunk, ignore_leftover);
+        }
+
+        frames_ = frame_csv_records(
+            as_span<const char>(chunk), params_->delimiter, params_->quote_char);
+
+        framed_chunk_ = chunk;
+
+        frame_idx_ = 0;
+
+        frame_offset_ = 0;
+    }
+
+    // The remainder of the framed chunk is a partial record, or the last
+    // record of the stream if it does not end with a line terminator.
+    if (frame_idx_ == frames_.size()) {
+        return read_line(chunk, ignore_leftover);
+    }
+
+    const Csv_frame &frame = frames_[frame_idx_++];
+
+    std::size_t size = frame.next - frame_offset_;
+
+    if (params_->max_line_length && size >= *params_->max_line_length) {
+        throw Record_too_large_error{fmt::format(
+            "The text line exceeds the maximum length of {0:n}.", *params_->max_line_length)};
+    }
+
+    Memory_slice payload = chunk.first(frame.payload_end - frame_offset_);
+
+    chunk = chunk.subslice(size);
+
+    frame_offset_ = frame.next;
+
+    return Record{std::move(payload)};
+}
+
 std::optional<Record> Csv_record_reader::read_line(Memory_slice &chunk, bool ignore_leftover)
 {
     auto chars = as_span<const char>(chunk);
@@ -15,11 +15,19 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "mlio/csv_reader.h"
+#include "mlio/detail/ref_batch.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/detail/csv_framing.h"
+#include "mlio/record_readers/detail/text_line.h"
 #include "mlio/record_readers/text_record_reader.h"
 #include "mlio/streams/input_stream.h"
 
@@ -44,8 +52,24 @@ private:
 
     std::optional<Record> decode_text_record(Memory_slice &chunk, bool ignore_leftover) final;
 
+    // A quoted field can contain new-line characters; in such case we
+    // cannot tell where a record starts without reading from the
+    // beginning of the stream.
+    bool is_splittable() const noexcept final
+    {
+        return !params_->allow_quoted_new_lines;
+    }
+
+    std::optional<Record> read_indexed_line(Memory_slice &chunk);
+
+    bool is_indexed(const Memory_slice &chunk) const noexcept;
+
+    void index_lines(const Memory_slice &chunk);
+
     bool is_comment_line(const Memory_slice &chunk);
 
+    std::optional<Record> read_framed_line(Memory_slice &chunk, bool ignore_leftover);
+
     std::optional<Record> read_line(Memory_slice &chunk, bool ignore_leftover);
 
     static bool try_get_next_char(const stdx::span<const char> &chars,
@@ -57,6 +81,25 @@ private:
                                   std::size_t max_line_length);
 
     const Csv_params *params_;
+    // The lines found in a single pass over a chunk if quoted new lines
+    // are not allowed, without the comment lines and, if requested, the
+    // blank lines. The indexed chunk is kept alive so that its address
+    // cannot be reused by a later chunk.
+    Memory_slice indexed_chunk_{};
+    std::vector<Line_span> lines_{};
+    std::size_t num_indexed_chars_{};
+    Ref_batch<Memory_block> line_refs_{};
+    std::size_t line_idx_{};
+    // The offset of the next line within the indexed chunk.
+    std::size_t line_offset_{};
+    // The record boundaries found by the parallel framing of a chunk.
+    // The framed chunk is kept alive so that its address cannot be
+    // reused by a later chunk.
+    Memory_slice framed_chunk_{};
+    std::vector<Csv_frame> frames_{};
+    std::size_t frame_idx_{};
+    // The offset of the next record within the framed chunk.
+    std::size_t frame_offset_{};
 };
 
 }  // namespace detail
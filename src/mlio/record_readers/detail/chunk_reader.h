@@ -48,6 +48,20 @@ public:
     virtual std::size_t chunk_size_hint() const noexcept = 0;
 
     virtual void set_chunk_size_hint(std::size_t value) noexcept = 0;
+
+    // Indicates whether the reader supports the random access functions
+    // below.
+    virtual bool seekable() const noexcept = 0;
+
+    virtual std::size_t size() const = 0;
+
+    // Reads up to @p num_bytes bytes at the specified position. It might change the position of the reader; therefore
+    // it must be followed by a call to set_range().
+    virtual Memory_slice read_at(std::size_t position, std::size_t num_bytes) = 0;
+
+    // Restarts the reader at the specified position and makes it stop
+    // once it reaches @p last.
+    virtual void set_range(std::size_t first, std::size_t last) = 0;
 };
 
 std::unique_ptr<Chunk_reader> make_chunk_reader(Intrusive_ptr<Input_stream> stream);
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/record_readers/detail/chunk_ring.h"
+
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "mlio/config.h"
+#include "mlio/detail/file_descriptor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Intrusive_ptr<Chunk_ring> Chunk_ring::make(std::size_t capacity) noexcept
+{
+#ifdef MLIO_PLATFORM_LINUX
+    auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+    capacity = (capacity + page_size - 1) / page_size * page_size;
+
+    File_descriptor fd = ::memfd_create("mlio-chunk-ring", MFD_CLOEXEC);
+    if (fd.get() == -1) {
+        return {};
+    }
+
+    if (::ftruncate(fd.get(), static_cast<::off_t>(capacity)) != 0) {
+        return {};
+    }
+
+    // Reserve twice the capacity and map the same pages into both halves.
+    void *addr = ::mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    if (addr == MAP_FAILED) {
+        return {};
+    }
+
+    auto *data = static_cast<std::byte *>(addr);
+
+    for (std::byte *half : {data, data + capacity}) {
+        void *h = ::mmap(
+            half, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd.get(), 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+        if (h == MAP_FAILED) {
+            ::munmap(addr, capacity * 2);
+
+            return {};
+        }
+    }
+
+    auto *ring = new (std::nothrow) Chunk_ring{data, capacity};
+    if (ring == nullptr) {
+        ::munmap(addr, capacity * 2);
+
+        return {};
+    }
+
+    return Intrusive_ptr<Chunk_ring>{ring};
+#else
+    static_cast<void>(capacity);
+
+    return {};
+#endif
+}
+
+Chunk_ring::~Chunk_ring()
+{
+    ::munmap(data_, capacity_ * 2);
+}
+
+Ring_chunk_block::~Ring_chunk_block() = default;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "mlio/intrusive_ptr.h"
+#include "mlio/intrusive_ref_counter.h"
+#include "mlio/memory/memory_block.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Represents a ring buffer whose pages are mapped twice in a row, so
+// that a region of up to capacity() bytes is contiguous in memory even
+// if it wraps around the end of the ring. This lets a chunk start at the
+// leftover of the previous chunk without copying it.
+class Chunk_ring : public Intrusive_ref_counter<Chunk_ring> {
+public:
+    // Returns a null pointer if the platform does not support mirrored
+    // mappings or if the ring cannot be mapped.
+    static Intrusive_ptr<Chunk_ring> make(std::size_t capacity) noexcept;
+
+    Chunk_ring(const Chunk_ring &) = delete;
+
+    Chunk_ring &operator=(const Chunk_ring &) = delete;
+
+    Chunk_ring(Chunk_ring &&) = delete;
+
+    Chunk_ring &operator=(Chunk_ring &&) = delete;
+
+    ~Chunk_ring();
+
+    // Returns the address of the specified position; positions increase
+    // monotonically and wrap around the ring.
+    std::byte *at(std::uint64_t position) noexcept
+    {
+        return data_ + position % capacity_;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+private:
+    explicit Chunk_ring(std::byte *data, std::size_t capacity) noexcept
+        : data_{data}, capacity_{capacity}
+    {}
+
+    std::byte *data_;
+    std::size_t capacity_;
+};
+
+// Represents a chunk that was read into a Chunk_ring. The region of the
+// chunk cannot be overwritten as long as a record refers to it.
+class Ring_chunk_block final : public Memory_block {
+public:
+    explicit Ring_chunk_block(Intrusive_ptr<Chunk_ring> ring,
+                              std::uint64_t position,
+                              size_type size) noexcept
+        : ring_{std::move(ring)}, data_{ring_->at(position)}, position_{position}, size_{size}
+    {}
+
+    Ring_chunk_block(const Ring_chunk_block &) = delete;
+
+    Ring_chunk_block &operator=(const Ring_chunk_block &) = delete;
+
+    Ring_chunk_block(Ring_chunk_block &&) = delete;
+
+    Ring_chunk_block &operator=(Ring_chunk_block &&) = delete;
+
+    ~Ring_chunk_block() final;
+
+    const_pointer data() const noexcept final
+    {
+        return data_;
+    }
+
+    size_type size() const noexcept final
+    {
+        return size_;
+    }
+
+    std::uint64_t position() const noexcept
+    {
+        return position_;
+    }
+
+private:
+    Intrusive_ptr<Chunk_ring> ring_;
+    const std::byte *data_;
+    std::uint64_t position_;
+    size_type size_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
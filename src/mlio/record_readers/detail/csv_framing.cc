@@ -0,0 +1,219 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/record_readers/detail/csv_framing.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <tbb/tbb.h>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The states of Csv_record_reader::read_line().
+enum State : std::uint8_t {
+    new_field,
+    in_field,
+    in_quoted_field,
+    quote_in_quoted_field,
+    has_carriage,
+};
+
+constexpr std::size_t num_states = 5;
+
+enum Char_class : std::uint8_t {
+    other,
+    delimiter,
+    quote,
+    new_line,
+    carriage,
+};
+
+constexpr std::size_t num_char_classes = 5;
+
+// Indexed by state and then by character class.
+constexpr std::array<std::array<std::uint8_t, num_char_classes>, num_states> transitions{{
+    // new_field
+    {{in_field, new_field, in_quoted_field, new_field, has_carriage}},
+    // in_field
+    {{in_field, new_field, in_field, new_field, has_carriage}},
+    // in_quoted_field
+    {{in_quoted_field, in_quoted_field, quote_in_quoted_field, in_quoted_field, in_quoted_field}},
+    // quote_in_quoted_field
+    {{in_field, new_field, in_quoted_field, new_field, has_carriage}},
+    // has_carriage; the character following a lone carriage starts a
+    // new record.
+    {{in_field, new_field, in_quoted_field, new_field, has_carriage}},
+}};
+
+// A mapping from start states to end states is encoded as a base-5
+// number whose digit s holds the state reached from state s.
+constexpr std::size_t num_mappings = 5 * 5 * 5 * 5 * 5;
+
+constexpr std::uint16_t identity_mapping = 0 + 1 * 5 + 2 * 25 + 3 * 125 + 4 * 625;
+
+using Mapping_table = std::array<std::array<std::uint16_t, num_char_classes>, num_mappings>;
+
+// Returns the table that composes a mapping with the transition of a
+// character class; this lets the speculative pass advance all start
+// states at once with a single lookup per character.
+const Mapping_table &mapping_table()
+{
+    static const Mapping_table table = [] {
+        Mapping_table t{};
+
+        for (std::size_t m = 0; m < num_mappings; m++) {
+            for (std::size_t c = 0; c < num_char_classes; c++) {
+                std::size_t digits = m;
+                std::size_t result = 0;
+                std::size_t weight = 1;
+
+                for (std::size_t s = 0; s < num_states; s++) {
+                    result += transitions[digits % 5][c] * weight;
+
+                    digits /= 5;
+                    weight *= 5;
+                }
+
+                t[m][c] = static_cast<std::uint16_t>(result);
+            }
+        }
+
+        return t;
+    }();
+
+    return table;
+}
+
+std::uint8_t apply_mapping(std::uint16_t mapping, std::uint8_t state) noexcept
+{
+    for (std::uint8_t s = 0; s < state; s++) {
+        mapping /= 5;
+    }
+
+    return static_cast<std::uint8_t>(mapping % 5);
+}
+
+using Class_table = std::array<std::uint8_t, 256>;
+
+Class_table make_class_table(char delimiter_char, char quote_char) noexcept
+{
+    Class_table t{};
+
+    t[static_cast<unsigned char>('\n')] = new_line;
+    t[static_cast<unsigned char>('\r')] = carriage;
+    // Same precedence as in read_line(); the delimiter is checked first.
+    t[static_cast<unsigned char>(quote_char)] = quote;
+    t[static_cast<unsigned char>(delimiter_char)] = delimiter;
+
+    return t;
+}
+
+// Blocks smaller than this are not worth a task of their own.
+constexpr std::size_t min_block_size = 0x10'0000;  // 1 MiB
+
+}  // namespace
+
+std::vector<Csv_frame>
+frame_csv_records(stdx::span<const char> chars, char delimiter, char quote_char)
+{
+    Class_table classes = make_class_table(delimiter, quote_char);
+
+    std::size_t num_blocks = std::max(chars.size() / min_block_size, std::size_t{1});
+
+    auto block_begin = [&chars, num_blocks](std::size_t idx) {
+        return chars.size() * idx / num_blocks;
+    };
+
+    // First pass; for each block find the end state of every possible
+    // start state.
+    std::vector<std::uint16_t> mappings(num_blocks);
+
+    const Mapping_table &table = mapping_table();
+
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t idx) {
+        std::uint16_t mapping = identity_mapping;
+
+        for (std::size_t i = block_begin(idx); i < block_begin(idx + 1); i++) {
+            mapping = table[mapping][classes[static_cast<unsigned char>(chars[i])]];
+        }
+
+        mappings[idx] = mapping;
+    });
+
+    // Prefix pass; the chunk starts at the beginning of a record.
+    std::vector<std::uint8_t> start_states(num_blocks);
+
+    std::uint8_t state = new_field;
+    for (std::size_t idx = 0; idx < num_blocks; idx++) {
+        start_states[idx] = state;
+
+        state = apply_mapping(mappings[idx], state);
+    }
+
+    // Second pass; collect the record boundaries of each block.
+    std::vector<std::vector<Csv_frame>> block_frames(num_blocks);
+
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t idx) {
+        std::vector<Csv_frame> &frames = block_frames[idx];
+
+        std::uint8_t s = start_states[idx];
+
+        for (std::size_t i = block_begin(idx); i < block_begin(idx + 1); i++) {
+            std::uint8_t cls = classes[static_cast<unsigned char>(chars[i])];
+
+            if (s == has_carriage) {
+                if (cls == new_line) {
+                    frames.push_back(Csv_frame{i - 1, i + 1});
+
+                    s = new_field;
+
+                    continue;
+                }
+
+                // A carriage without a new-line character ends the record
+                // by itself.
+                frames.push_back(Csv_frame{i - 1, i});
+            }
+            else if (cls == new_line && s != in_quoted_field) {
+                frames.push_back(Csv_frame{i, i + 1});
+            }
+
+            s = transitions[s][cls];
+        }
+    });
+
+    std::size_t num_frames = 0;
+    for (const std::vector<Csv_frame> &frames : block_frames) {
+        num_frames += frames.size();
+    }
+
+    std::vector<Csv_frame> all_frames{};
+    all_frames.reserve(num_frames);
+
+    for (const std::vector<Csv_frame> &frames : block_frames) {
+        all_frames.insert(all_frames.end(), frames.begin(), frames.end());
+    }
+
+    return all_frames;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Represents the boundary of a CSV record within a chunk.
+struct Csv_frame {
+    /// The offset of the end of the record payload, excluding the
+    /// line terminator.
+    std::size_t payload_end;
+    /// The offset of the beginning of the next record.
+    std::size_t next;
+};
+
+/// Finds the boundaries of the complete CSV records in the specified
+/// chunk, which must start at the beginning of a record.
+///
+/// The chunk is split into blocks that are scanned in two parallel
+/// passes. The first pass speculatively runs the quote-aware parser
+/// state machine over each block from every possible start state; a
+/// serial prefix pass then resolves the actual start state of each
+/// block, and the second pass collects the record boundaries. Comment
+/// lines are not recognized; the caller is expected to fall back to
+/// serial framing if comments are enabled.
+std::vector<Csv_frame>
+frame_csv_records(stdx::span<const char> chars, char delimiter, char quote_char);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,15 +16,39 @@
 #include "mlio/record_readers/detail/default_chunk_reader.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
 
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/tracing.h"
 #include "mlio/memory/memory_allocator.h"
 #include "mlio/memory/util.h"
+#include "mlio/record_readers/detail/chunk_ring.h"
 #include "mlio/span.h"
 #include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
+
+// The chunks are sized so that filling one takes about this long; slow
+// streams get smaller chunks that reach the decoders sooner, and fast
+// streams get larger ones that amortize the per-chunk overhead.
+constexpr std::chrono::milliseconds target_fill_time{20};
+
+constexpr std::size_t min_chunk_size = 0x10'0000;   // 1 MiB
+constexpr std::size_t max_chunk_size = 0x400'0000;  // 64 MiB
+
+constexpr std::size_t ring_leftover_threshold = 0x4'0000;  // 256 KiB
+
+// The ring holds the chunks that are still referenced by records in
+// addition to the one being read.
+constexpr std::size_t ring_capacity_factor = 4;
+
+}  // namespace
 
 Memory_slice Default_chunk_reader::read_chunk(Memory_span leftover)
 {
@@ -32,46 +56,174 @@ Memory_slice Default_chunk_reader::read_chunk(Memory_span leftover)
         return {};
     }
 
-    bool reuse_buffer = false;
+    Trace_span span{"read_chunk"};
+    Allocation_scope scope{Allocation_stage::io};
 
-    if (chunk_ != nullptr) {
-        // If the whole chunk is leftover, it means it does not contain
-        // any records; in such case we should increase the size of the
-        // chunk to make sure that we fit at least one record into it.
-        if (chunk_->size() == leftover.size()) {
-            if (chunk_->size() == next_chunk_size_) {
-                next_chunk_size_ <<= 1;
-            }
+    // If the whole chunk is leftover, it means it does not contain any
+    // records; in such case we should increase the size of the chunk to
+    // make sure that we fit at least one record into it.
+    bool is_all_leftover = !leftover.empty() && leftover.size() == chunk_size_;
+    if (is_all_leftover) {
+        record_chunk_size_ = std::max(record_chunk_size_, chunk_size_ << 1);
+    }
 
-            reuse_buffer = true;
+    std::size_t size = chunk_size_hint();
+    while (size <= leftover.size()) {
+        size <<= 1;
+    }
 
-            // If the chunk is owned only by this Chunk_reader and its
-            // associated Stream_record_reader, we can safely re-use it
-            // for the next fill operation.
+    // Once the leftovers get large, copying them at every chunk boundary
+    // gets expensive; from then on the chunks are read into a ring.
+    if (ring_ == nullptr && !ring_unsupported_ && leftover.size() >= ring_leftover_threshold) {
+        ring_ = Chunk_ring::make(size * ring_capacity_factor);
+        if (ring_ == nullptr) {
+            ring_unsupported_ = true;
         }
-        else if (chunk_->use_count() <= 2) {
-            if (!leftover.empty()) {
-                std::copy(leftover.begin(), leftover.end(), chunk_->begin());
-            }
+    }
 
-            reuse_buffer = true;
+    if (ring_ != nullptr) {
+        std::optional<Memory_slice> chunk = read_ring_chunk(leftover, size);
+        if (chunk) {
+            return std::move(*chunk);
         }
     }
 
-    if (reuse_buffer) {
-        if (chunk_->size() != next_chunk_size_) {
-            chunk_ = resize_memory_block(chunk_, next_chunk_size_);
+    // If the chunk is owned only by this Chunk_reader and its associated
+    // Stream_record_reader, we can safely re-use it for the next fill
+    // operation.
+    bool is_in_place = is_all_leftover && chunk_ != nullptr && leftover.data() == chunk_->data();
+
+    if (chunk_ != nullptr && (is_in_place || chunk_->use_count() <= 2)) {
+        if (!is_in_place && !leftover.empty()) {
+            std::copy(leftover.begin(), leftover.end(), chunk_->begin());
+        }
+
+        if (chunk_->size() < size || chunk_->size() > size * 2) {
+            chunk_ = resize_memory_block(chunk_, size);
         }
     }
     else {
-        chunk_ = memory_allocator().allocate(next_chunk_size_);
+        acquire_chunk(size);
 
         if (!leftover.empty()) {
             std::copy(leftover.begin(), leftover.end(), chunk_->begin());
         }
     }
 
-    auto remaining = make_span(*chunk_).subspan(leftover.size());
+    chunk_size_ = leftover.size() + fill(make_span(*chunk_).first(size).subspan(leftover.size()));
+
+    Intrusive_ptr<Mutable_memory_block> chunk;
+    if (eof_) {
+        chunk = std::move(chunk_);
+    }
+    else {
+        chunk = chunk_;
+    }
+
+    return Memory_slice{chunk}.first(chunk_size_);
+}
+
+std::optional<Memory_slice>
+Default_chunk_reader::read_ring_chunk(Memory_span leftover, std::size_t size)
+{
+    // See if the leftover is the tail of the last chunk; in such case the
+    // next chunk starts right at it.
+    std::uint64_t position = ring_head_;
+
+    bool is_in_place = leftover.empty();
+
+    if (!leftover.empty() && !ring_chunks_.empty()) {
+        const Ring_chunk_block &last = *ring_chunks_.back();
+
+        if (leftover.data() >= last.data() && leftover.end() == last.end()) {
+            position = last.position() + as_size(leftover.data() - last.data());
+
+            is_in_place = true;
+        }
+    }
+
+    // Drop the chunks that are no longer referenced by any record.
+    while (!ring_chunks_.empty() && ring_chunks_.front()->use_count() == 1) {
+        ring_chunks_.pop_front();
+    }
+
+    // Keeps the ring alive until the leftover is copied into a new one.
+    Intrusive_ptr<Chunk_ring> old_ring{};
+
+    // If the chunks have outgrown the ring, replace it once it is free.
+    if (size * 2 > ring_->capacity()) {
+        if (!ring_chunks_.empty()) {
+            return {};
+        }
+
+        Intrusive_ptr<Chunk_ring> ring = Chunk_ring::make(size * ring_capacity_factor);
+        if (ring == nullptr) {
+            return {};
+        }
+
+        old_ring = std::exchange(ring_, std::move(ring));
+
+        position = ring_head_ = 0;
+
+        is_in_place = leftover.empty();
+    }
+
+    // The region up to the oldest chunk that is still referenced by a
+    // record is free to be overwritten.
+    std::uint64_t tail = position;
+    if (!ring_chunks_.empty()) {
+        tail = std::min(tail, ring_chunks_.front()->position());
+    }
+
+    std::size_t num_bytes_free = tail + ring_->capacity() - position;
+    if (num_bytes_free < size) {
+        // Rather than reading many small chunks while the ring is full,
+        // fall back to a separate buffer.
+        if (num_bytes_free < leftover.size() + size / 2) {
+            return {};
+        }
+
+        size = num_bytes_free;
+    }
+
+    std::byte *data = ring_->at(position);
+
+    if (!is_in_place) {
+        std::copy(leftover.begin(), leftover.end(), data);
+    }
+
+    old_ring = {};
+
+    // The chunk is read into a ring from now on; release the buffers.
+    chunk_ = {};
+
+    spare_chunks_ = {};
+
+    chunk_size_ = leftover.size() + fill(Mutable_memory_span{data, size}.subspan(leftover.size()));
+    if (chunk_size_ == 0) {
+        return Memory_slice{};
+    }
+
+    auto block = make_intrusive<Ring_chunk_block>(ring_, position, chunk_size_);
+
+    ring_chunks_.emplace_back(block);
+
+    ring_head_ = position + chunk_size_;
+
+    return Memory_slice{std::move(block)};
+}
+
+std::size_t Default_chunk_reader::fill(Mutable_memory_span destination)
+{
+    auto remaining = destination;
+    if (num_bytes_left_ && *num_bytes_left_ < remaining.size()) {
+        remaining = remaining.first(*num_bytes_left_);
+    }
+
+    std::size_t num_bytes_to_read = remaining.size();
+
+    auto start = std::chrono::steady_clock::now();
+
     while (!remaining.empty()) {
         std::size_t num_bytes_read = stream_->read(remaining);
         if (num_bytes_read == 0) {
@@ -81,23 +233,128 @@ Memory_slice Default_chunk_reader::read_chunk(Memory_span leftover)
         }
 
         remaining = remaining.subspan(num_bytes_read);
+
+        if (num_bytes_left_) {
+            *num_bytes_left_ -= num_bytes_read;
+        }
     }
 
-    Intrusive_ptr<Mutable_memory_block> chunk;
-    if (eof_) {
-        chunk = std::move(chunk_);
+    if (num_bytes_left_ && *num_bytes_left_ == 0) {
+        eof_ = true;
+    }
+
+    if (!eof_) {
+        update_chunk_size(num_bytes_to_read, std::chrono::steady_clock::now() - start);
+    }
+
+    return num_bytes_to_read - remaining.size();
+}
+
+void Default_chunk_reader::acquire_chunk(std::size_t size)
+{
+    Intrusive_ptr<Mutable_memory_block> retired = std::move(chunk_);
+
+    // Reuse a spare whose records have all been released.
+    for (Intrusive_ptr<Mutable_memory_block> &spare : spare_chunks_) {
+        if (spare != nullptr && spare->use_count() == 1) {
+            chunk_ = std::move(spare);
+
+            break;
+        }
+    }
+
+    // Keep the current chunk as a spare; it gets reused once the records
+    // that refer to it are released. If all slots are taken, it is freed
+    // along with its last record.
+    if (retired != nullptr) {
+        for (Intrusive_ptr<Mutable_memory_block> &spare : spare_chunks_) {
+            if (spare == nullptr) {
+                spare = std::move(retired);
+
+                break;
+            }
+        }
+    }
+
+    if (chunk_ == nullptr) {
+        chunk_ = memory_allocator().allocate(size);
+    }
+    else if (chunk_->size() < size || chunk_->size() > size * 2) {
+        chunk_ = resize_memory_block(chunk_, size);
+    }
+}
+
+void Default_chunk_reader::update_chunk_size(std::size_t num_bytes_read,
+                                             std::chrono::nanoseconds elapsed) noexcept
+{
+    if (elapsed.count() <= 0) {
+        return;
+    }
+
+    double bps = static_cast<double>(num_bytes_read) * 1e9 / static_cast<double>(elapsed.count());
+
+    // The throughput is positive once it has been measured.
+    if (bytes_per_second_ <= 0.0) {
+        bytes_per_second_ = bps;
     }
     else {
-        chunk = chunk_;
+        bytes_per_second_ = 0.75 * bytes_per_second_ + 0.25 * bps;
+    }
+
+    double target_size =
+        bytes_per_second_ * std::chrono::duration<double>(target_fill_time).count();
+
+    // Move a power of two at a time so that a single slow or fast read
+    // does not make the size swing.
+    if (target_size > static_cast<double>(next_chunk_size_ * 2)) {
+        if (next_chunk_size_ < max_chunk_size) {
+            next_chunk_size_ <<= 1;
+        }
+    }
+    else if (target_size < static_cast<double>(next_chunk_size_ / 2)) {
+        if (next_chunk_size_ > min_chunk_size) {
+            next_chunk_size_ >>= 1;
+        }
     }
+}
+
+Memory_slice Default_chunk_reader::read_at(std::size_t position, std::size_t num_bytes)
+{
+    position = std::min(position, stream_->size());
+
+    stream_->seek(position);
+
+    auto block = memory_allocator().allocate(std::min(num_bytes, stream_->size() - position));
+
+    auto remaining = make_span(*block);
+    while (!remaining.empty()) {
+        std::size_t num_bytes_read = stream_->read(remaining);
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        remaining = remaining.subspan(num_bytes_read);
+    }
+
+    return Memory_slice{block}.first(block->size() - remaining.size());
+}
+
+void Default_chunk_reader::set_range(std::size_t first, std::size_t last)
+{
+    last = std::min(last, stream_->size());
+    first = std::min(first, last);
+
+    stream_->seek(first);
+
+    num_bytes_left_ = last - first;
 
-    return Memory_slice{chunk}.first(chunk->end() - stdx::ssize(remaining));
+    eof_ = num_bytes_left_ == 0;
 }
 
 void Default_chunk_reader::set_chunk_size_hint(std::size_t value) noexcept
 {
-    while (value > next_chunk_size_) {
-        next_chunk_size_ <<= 1;
+    while (value > record_chunk_size_) {
+        record_chunk_size_ <<= 1;
     }
 }
 
@@ -15,13 +15,20 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
 #include <utility>
 
 #include "mlio/intrusive_ptr.h"
 #include "mlio/memory/memory_block.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/detail/chunk_reader.h"
+#include "mlio/record_readers/detail/chunk_ring.h"
 #include "mlio/span.h"
 #include "mlio/streams/input_stream.h"
 
@@ -44,15 +51,53 @@ public:
 
     std::size_t chunk_size_hint() const noexcept final
     {
-        return next_chunk_size_;
+        return std::max(next_chunk_size_, record_chunk_size_);
     }
 
     void set_chunk_size_hint(std::size_t value) noexcept final;
 
+    bool seekable() const noexcept final
+    {
+        return stream_->seekable();
+    }
+
+    std::size_t size() const final
+    {
+        return stream_->size();
+    }
+
+    Memory_slice read_at(std::size_t position, std::size_t num_bytes) final;
+
+    void set_range(std::size_t first, std::size_t last) final;
+
 private:
+    std::optional<Memory_slice> read_ring_chunk(Memory_span leftover, std::size_t size);
+
+    std::size_t fill(Mutable_memory_span destination);
+
+    void acquire_chunk(std::size_t size);
+
+    void update_chunk_size(std::size_t num_bytes_read, std::chrono::nanoseconds elapsed) noexcept;
+
     Intrusive_ptr<Input_stream> stream_;
-    std::size_t next_chunk_size_ = 0x200'0000;  // 32 MiB
+    std::optional<std::size_t> num_bytes_left_{};
+    // The chunk size that the observed read throughput calls for.
+    std::size_t next_chunk_size_ = 0x40'0000;  // 4 MiB
+    // The smallest chunk size that fits the largest record seen so far.
+    std::size_t record_chunk_size_ = 0x10'0000;  // 1 MiB
+    double bytes_per_second_{};
     Intrusive_ptr<Mutable_memory_block> chunk_{};
+    // The number of bytes of the last chunk.
+    std::size_t chunk_size_{};
+    // The buffers of the previous chunks that were still referenced by
+    // records when they got replaced; they are reused once released.
+    std::array<Intrusive_ptr<Mutable_memory_block>, 2> spare_chunks_{};
+    // Once the leftovers get large, the chunks are read into a ring so
+    // that a chunk can start at the leftover of the previous one.
+    Intrusive_ptr<Chunk_ring> ring_{};
+    std::deque<Intrusive_ptr<Ring_chunk_block>> ring_chunks_{};
+    std::uint64_t ring_head_{};
+    bool ring_unsupported_{};
     bool eof_{};
 };
 
@@ -15,15 +15,110 @@
 
 #include "mlio/record_readers/detail/in_memory_chunk_reader.h"
 
+#include <algorithm>
+#include <cstdint>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include "mlio/memory/memory_slice.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
+
+std::uintptr_t page_size() noexcept
+{
+    static const auto page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+
+    return page_size;
+}
+
+}  // namespace
+
+In_memory_chunk_reader::In_memory_chunk_reader(Memory_slice &&source) noexcept
+    : source_{std::move(source)}, pos_{source_.begin()}, end_{source_.end()}
+{
+    prefetch(pos_);
+}
 
-Memory_slice In_memory_chunk_reader::read_chunk(Memory_span)
+Memory_slice In_memory_chunk_reader::read_chunk(Memory_span leftover)
 {
-    return std::exchange(chunk_, {});
+    if (eof()) {
+        return {};
+    }
+
+    // If the whole chunk is leftover, it means it does not contain any
+    // records; in such case we should increase the size of the window
+    // to make sure that we fit at least one record into it.
+    if (!leftover.empty() && leftover.size() == last_chunk_size_) {
+        window_size_ <<= 1;
+    }
+
+    // The leftover is always the tail of the previous chunk; since both
+    // are slices of the same source, we can simply extend it instead of
+    // copying.
+    auto first = pos_ - as_ssize(leftover.size());
+
+    auto num_bytes_left = as_size(end_ - pos_);
+
+    pos_ += as_ssize(std::min(window_size_, num_bytes_left));
+
+    prefetch(pos_);
+
+    Memory_slice chunk = source_.subslice(first, pos_);
+
+    last_chunk_size_ = chunk.size();
+
+    return chunk;
+}
+
+void In_memory_chunk_reader::set_chunk_size_hint(std::size_t value) noexcept
+{
+    while (value > window_size_) {
+        window_size_ <<= 1;
+    }
+}
+
+Memory_slice In_memory_chunk_reader::read_at(std::size_t position, std::size_t num_bytes)
+{
+    position = std::min(position, source_.size());
+
+    return source_.subslice(position, std::min(num_bytes, source_.size() - position));
+}
+
+void In_memory_chunk_reader::set_range(std::size_t first, std::size_t last)
+{
+    last = std::min(last, source_.size());
+    first = std::min(first, last);
+
+    pos_ = source_.begin() + as_ssize(first);
+    end_ = source_.begin() + as_ssize(last);
+
+    last_chunk_size_ = 0;
+
+    prefetch(pos_);
+}
+
+void In_memory_chunk_reader::prefetch(Memory_block::iterator first) const noexcept
+{
+    auto num_bytes_left = as_size(end_ - first);
+    if (num_bytes_left == 0) {
+        return;
+    }
+
+    auto beg = reinterpret_cast<std::uintptr_t>(first);
+    auto end = beg + std::min(window_size_, num_bytes_left);
+
+    // madvise() expects a page-aligned address.
+    beg &= ~(page_size() - 1);
+
+    // This is only a hint; there is nothing to do if it fails (e.g. if
+    // the source is not a memory mapping).
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    ::madvise(reinterpret_cast<void *>(beg), end - beg, MADV_WILLNEED);
 }
 
 }  // namespace detail
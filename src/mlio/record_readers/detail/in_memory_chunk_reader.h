@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <utility>
 
+#include "mlio/memory/memory_block.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/detail/chunk_reader.h"
 #include "mlio/span.h"
@@ -26,28 +27,50 @@ namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
+// Hands out consecutive windows of an in-memory source (e.g. a memory-
+// mapped file) as zero-copy slices. As the reader moves forward, the
+// window ahead of its position is advised to the kernel so that the
+// pages are faulted in before they are accessed.
 class In_memory_chunk_reader : public Chunk_reader {
 public:
-    explicit In_memory_chunk_reader(Memory_slice &&chunk) noexcept : chunk_{std::move(chunk)}
-    {}
+    explicit In_memory_chunk_reader(Memory_slice &&source) noexcept;
 
     Memory_slice read_chunk(Memory_span leftover) final;
 
     bool eof() const noexcept final
     {
-        return chunk_.empty();
+        return pos_ == end_;
     }
 
     std::size_t chunk_size_hint() const noexcept final
     {
-        return 0;
+        return window_size_;
     }
 
-    void set_chunk_size_hint(std::size_t) noexcept final
-    {}
+    void set_chunk_size_hint(std::size_t value) noexcept final;
+
+    bool seekable() const noexcept final
+    {
+        return true;
+    }
+
+    std::size_t size() const noexcept final
+    {
+        return source_.size();
+    }
+
+    Memory_slice read_at(std::size_t position, std::size_t num_bytes) final;
+
+    void set_range(std::size_t first, std::size_t last) final;
 
 private:
-    Memory_slice chunk_;
+    void prefetch(Memory_block::iterator first) const noexcept;
+
+    Memory_slice source_;
+    Memory_block::iterator pos_;
+    Memory_block::iterator end_;
+    std::size_t window_size_ = 0x200'0000;  // 32 MiB
+    std::size_t last_chunk_size_{};
 };
 
 }  // namespace detail
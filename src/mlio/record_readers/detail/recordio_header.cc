@@ -15,13 +15,25 @@
 
 #include "mlio/record_readers/detail/recordio_header.h"
 
+#include <array>
+#include <cstring>
+
 #include "mlio/endian.h"
 #include "mlio/record_readers/record_error.h"
 #include "mlio/span.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
+
+// There is no formal specification about the correct byte order of the
+// RecordIO format. We assume that it is always little-endian.
+constexpr std::uint32_t magic =
+    (Byte_order::host == Byte_order::little ? 0xced7'230a : 0x0a23'd7ce);
+
+}  // namespace
 
 std::optional<Recordio_header> decode_recordio_header(Memory_span bits)
 {
@@ -30,11 +42,6 @@ std::optional<Recordio_header> decode_recordio_header(Memory_span bits)
         return {};
     }
 
-    // There is no formal specification about the correct byte order of
-    // the RecordIO format. We assume that it is always little-endian.
-    constexpr std::uint32_t magic =
-        (Byte_order::host == Byte_order::little ? 0xced7'230a : 0x0a23'd7ce);
-
     if (ints[0] != magic) {
         throw Corrupt_header_error{"The header does not start with the RecordIO magic number."};
     }
@@ -44,6 +51,67 @@ std::optional<Recordio_header> decode_recordio_header(Memory_span bits)
     return Recordio_header{data};
 }
 
+std::optional<Recordio_header> try_decode_recordio_header(Memory_span bits) noexcept
+{
+    std::array<std::uint32_t, 2> ints{};
+    if (bits.size() < sizeof(ints)) {
+        return {};
+    }
+
+    std::memcpy(ints.data(), bits.data(), sizeof(ints));
+
+    if (ints[0] != magic) {
+        return {};
+    }
+
+    return Recordio_header{little_to_host_order(ints[1])};
+}
+
+std::size_t find_recordio_magic(Memory_span bits, std::size_t offset) noexcept
+{
+    std::array<std::byte, sizeof(magic)> magic_bytes{};
+
+    std::memcpy(magic_bytes.data(), &magic, sizeof(magic));
+
+    // We look for the last byte of the magic number since unlike the
+    // first one (a line feed) it rarely occurs in text payloads; memchr
+    // is vectorized by the C runtime.
+    constexpr std::size_t last = sizeof(magic) - 1;
+
+    const std::byte *first = bits.data();
+
+    std::size_t idx = offset + last;
+    while (idx < bits.size()) {
+        const void *pos =
+            std::memchr(first + idx, static_cast<int>(magic_bytes[last]), bits.size() - idx);
+        if (pos == nullptr) {
+            break;
+        }
+
+        idx = as_size(static_cast<const std::byte *>(pos) - first);
+
+        if (std::memcmp(first + idx - last, magic_bytes.data(), last) == 0) {
+            return idx - last;
+        }
+
+        idx++;
+    }
+
+    return bits.size();
+}
+
+void encode_recordio_header(Record_kind kind,
+                            std::size_t payload_size,
+                            Mutable_memory_span bits) noexcept
+{
+    auto data = static_cast<std::uint32_t>(payload_size) |
+                (static_cast<std::uint32_t>(kind) << 29U);
+
+    std::array<std::uint32_t, 2> ints{magic, little_to_host_order(data)};
+
+    std::memcpy(bits.data(), ints.data(), sizeof(ints));
+}
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
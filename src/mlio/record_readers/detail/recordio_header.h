@@ -56,6 +56,22 @@ private:
 
 std::optional<Recordio_header> decode_recordio_header(Memory_span bits);
 
+// Tries to decode a RecordIO header at an arbitrary, possibly
+// unaligned, position; unlike decode_recordio_header() it does not
+// throw if the bits do not start with the magic number.
+std::optional<Recordio_header> try_decode_recordio_header(Memory_span bits) noexcept;
+
+// Returns the offset of the first occurrence of the RecordIO magic
+// number in @p bits at or after @p offset, at any alignment, or the size
+// of @p bits if there is none.
+std::size_t find_recordio_magic(Memory_span bits, std::size_t offset) noexcept;
+
+// Writes the header of a record with the specified payload size, which
+// must be less than 2^29 bytes, to the first eight bytes of @p bits.
+void encode_recordio_header(Record_kind kind,
+                            std::size_t payload_size,
+                            Mutable_memory_span bits) noexcept;
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
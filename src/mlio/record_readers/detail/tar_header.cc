@@ -0,0 +1,231 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#include "mlio/record_readers/detail/tar_header.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The offsets and sizes of the ustar header fields.
+constexpr std::size_t name_offset = 0;
+constexpr std::size_t name_size = 100;
+constexpr std::size_t mode_offset = 100;
+constexpr std::size_t uid_offset = 108;
+constexpr std::size_t gid_offset = 116;
+constexpr std::size_t size_offset = 124;
+constexpr std::size_t size_size = 12;
+constexpr std::size_t mtime_offset = 136;
+constexpr std::size_t checksum_offset = 148;
+constexpr std::size_t checksum_size = 8;
+constexpr std::size_t type_flag_offset = 156;
+constexpr std::size_t magic_offset = 257;
+constexpr std::size_t prefix_offset = 345;
+constexpr std::size_t prefix_size = 155;
+
+constexpr std::string_view ustar_magic = "ustar";
+
+inline std::string_view as_string_view(Memory_span bits) noexcept
+{
+    auto chars = as_span<const char>(bits);
+
+    return std::string_view{chars.data(), chars.size()};
+}
+
+// Returns the string stored in a NUL-terminated or NUL-padded field.
+std::string_view read_string_field(Memory_span block, std::size_t offset, std::size_t size)
+{
+    std::string_view s = as_string_view(block.subspan(offset, size));
+
+    return s.substr(0, s.find('\0'));
+}
+
+std::optional<std::uint64_t>
+read_number_field(Memory_span block, std::size_t offset, std::size_t size)
+{
+    Memory_span field = block.subspan(offset, size);
+
+    // GNU tar stores numbers that do not fit in the octal field in
+    // big-endian base-256 with the high bit of the first byte set.
+    if ((std::to_integer<unsigned>(field[0]) & 0x80U) != 0) {
+        std::uint64_t value = std::to_integer<unsigned>(field[0]) & 0x7FU;
+        for (std::byte b : field.subspan(1)) {
+            if (value > (UINT64_MAX >> 8U)) {
+                return {};
+            }
+            value = (value << 8U) | std::to_integer<unsigned>(b);
+        }
+        return value;
+    }
+
+    std::string_view s = as_string_view(field);
+
+    std::size_t pos = s.find_first_not_of(' ');
+    if (pos == std::string_view::npos) {
+        return {};
+    }
+
+    std::uint64_t value = 0;
+    bool has_digits = false;
+    for (; pos < s.size(); pos++) {
+        char chr = s[pos];
+        if (chr < '0' || chr > '7') {
+            if (chr == ' ' || chr == '\0') {
+                break;
+            }
+            return {};
+        }
+        value = (value << 3U) | static_cast<std::uint64_t>(chr - '0');
+
+        has_digits = true;
+    }
+
+    if (!has_digits) {
+        return {};
+    }
+    return value;
+}
+
+std::uint64_t compute_checksum(Memory_span block) noexcept
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < tar_block_size; i++) {
+        // The checksum field itself is treated as if it was filled with
+        // spaces.
+        if (i >= checksum_offset && i < checksum_offset + checksum_size) {
+            sum += ' ';
+        }
+        else {
+            sum += std::to_integer<unsigned>(block[i]);
+        }
+    }
+    return sum;
+}
+
+void write_octal_field(Mutable_memory_span block,
+                       std::size_t offset,
+                       std::size_t size,
+                       std::uint64_t value)
+{
+    // The field holds size - 1 octal digits followed by a NUL.
+    std::string s = fmt::format("{0:0{1}o}", value, size - 1);
+    if (s.size() > size - 1) {
+        throw std::invalid_argument{"The value does not fit in the tar header field."};
+    }
+
+    auto chars = as_span<char>(block.subspan(offset, size));
+
+    std::copy(s.begin(), s.end(), chars.begin());
+
+    chars[size - 1] = '\0';
+}
+
+}  // namespace
+
+bool is_zero_tar_block(Memory_span block) noexcept
+{
+    return std::all_of(block.begin(), block.end(), [](std::byte b) {
+        return b == std::byte{};
+    });
+}
+
+std::optional<Tar_header> try_decode_tar_header(Memory_span block, bool require_magic)
+{
+    if (block.size() < tar_block_size) {
+        return {};
+    }
+
+    std::string_view magic = as_string_view(block.subspan(magic_offset, ustar_magic.size()));
+    if (require_magic && magic != ustar_magic) {
+        return {};
+    }
+
+    auto checksum = read_number_field(block, checksum_offset, checksum_size);
+    if (checksum != compute_checksum(block)) {
+        return {};
+    }
+
+    auto size = read_number_field(block, size_offset, size_size);
+    if (size == std::nullopt) {
+        return {};
+    }
+
+    Tar_header header{};
+
+    std::string_view name = read_string_field(block, name_offset, name_size);
+    if (magic == ustar_magic) {
+        std::string_view prefix = read_string_field(block, prefix_offset, prefix_size);
+        if (!prefix.empty()) {
+            header.name = prefix;
+            header.name += '/';
+        }
+    }
+    header.name += name;
+
+    header.size = *size;
+
+    header.type_flag = as_string_view(block)[type_flag_offset];
+
+    return header;
+}
+
+void encode_tar_header(std::string_view name, std::size_t size, Mutable_memory_span block)
+{
+    if (name.size() > name_size) {
+        throw std::invalid_argument{fmt::format(
+            "The name '{0}' is longer than {1:n} characters and cannot be stored in a tar header.",
+            name,
+            name_size)};
+    }
+
+    std::fill(block.begin(), block.end(), std::byte{});
+
+    auto chars = as_span<char>(block);
+
+    std::copy(name.begin(), name.end(), chars.begin());
+
+    write_octal_field(block, mode_offset, 8, 0644);
+    write_octal_field(block, uid_offset, 8, 0);
+    write_octal_field(block, gid_offset, 8, 0);
+    write_octal_field(block, size_offset, size_size, size);
+    write_octal_field(block, mtime_offset, 12, 0);
+
+    chars[type_flag_offset] = '0';
+
+    // POSIX ustar magic and version.
+    std::copy(ustar_magic.begin(), ustar_magic.end(), chars.begin() + magic_offset);
+    chars[magic_offset + 6] = '0';
+    chars[magic_offset + 7] = '0';
+
+    // The checksum is stored as six octal digits followed by a NUL and
+    // a space.
+    std::string checksum = fmt::format("{0:06o}", compute_checksum(block));
+    std::copy(checksum.begin(), checksum.end(), chars.begin() + checksum_offset);
+
+    chars[checksum_offset + 6] = '\0';
+    chars[checksum_offset + 7] = ' ';
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+inline constexpr std::size_t tar_block_size = 512;
+
+struct Tar_header {
+    std::string name{};
+    std::size_t size{};
+    char type_flag{};
+};
+
+/// Returns a boolean value indicating whether the specified block is
+/// filled with zeros; two such blocks mark the end of an archive.
+bool is_zero_tar_block(Memory_span block) noexcept;
+
+/// Tries to decode the tar header stored in the specified block.
+///
+/// @param require_magic
+///     A boolean value indicating whether the header must have the
+///     'ustar' magic; used to reduce the number of false positives when
+///     searching for a header at an arbitrary position.
+std::optional<Tar_header> try_decode_tar_header(Memory_span block, bool require_magic = false);
+
+/// Encodes a ustar header for a regular file into the specified block.
+void encode_tar_header(std::string_view name, std::size_t size, Mutable_memory_span block);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -15,20 +15,198 @@
 
 #include "mlio/record_readers/detail/text_line.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
 #include <fmt/format.h>
+#include <tbb/tbb.h>
 
+#include "mlio/detail/cpu_features.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/record_readers/record_error.h"
 #include "mlio/span.h"
 #include "mlio/util/cast.h"
 
+#if defined(MLIO_X86_DISPATCH) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
+namespace {
+
+constexpr std::uint64_t low_bits = 0x0101'0101'0101'0101;
+constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080;
+
+// Returns a non-zero value if any byte of the word equals the byte
+// replicated in the pattern.
+inline std::uint64_t has_byte(std::uint64_t word, std::uint64_t pattern) noexcept
+{
+    std::uint64_t x = word ^ pattern;
+
+    return (x - low_bits) & ~x & high_bits;
+}
+
+inline std::uint64_t load_word(const char *data) noexcept
+{
+    std::uint64_t word{};
+    std::memcpy(&word, data, sizeof(word));
+
+    return word;
+}
+
+// The kernels below return the offset of the first vector or word of the
+// data that contains a line terminator, or at which too few characters
+// remain; the caller scans the rest one character at a time. They clear
+// is_ascii if a skipped character is not ASCII.
+using Skip_line_chars_fn = std::size_t (*)(const char *, std::size_t, bool &) noexcept;
+
+#if !defined(MLIO_X86_DISPATCH) && !defined(__SSE2__) && !defined(__ARM_NEON)
+
+std::size_t skip_line_chars_swar(const char *data, std::size_t size, bool &is_ascii) noexcept
+{
+    constexpr std::uint64_t new_line_pattern = low_bits * '\n';
+    constexpr std::uint64_t carriage_pattern = low_bits * '\r';
+
+    std::uint64_t non_ascii = 0;
+
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word = load_word(data + i);
+
+        if ((has_byte(word, new_line_pattern) | has_byte(word, carriage_pattern)) != 0) {
+            break;
+        }
+
+        non_ascii |= word;
+    }
+
+    if ((non_ascii & high_bits) != 0) {
+        is_ascii = false;
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(MLIO_X86_DISPATCH) || defined(__SSE2__)
+
+std::size_t skip_line_chars_sse2(const char *data, std::size_t size, bool &is_ascii) noexcept
+{
+    const __m128i new_line = _mm_set1_epi8('\n');
+    const __m128i carriage = _mm_set1_epi8('\r');
+
+    __m128i non_ascii = _mm_setzero_si128();
+
+    std::size_t i = 0;
+    for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, new_line), _mm_cmpeq_epi8(v, carriage));
+        if (_mm_movemask_epi8(eq) != 0) {
+            break;
+        }
+
+        non_ascii = _mm_or_si128(non_ascii, v);
+    }
+
+    if (_mm_movemask_epi8(non_ascii) != 0) {
+        is_ascii = false;
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(MLIO_X86_DISPATCH)
+
+MLIO_TARGET("avx2")
+std::size_t skip_line_chars_avx2(const char *data, std::size_t size, bool &is_ascii) noexcept
+{
+    const __m256i new_line = _mm256_set1_epi8('\n');
+    const __m256i carriage = _mm256_set1_epi8('\r');
+
+    __m256i non_ascii = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+
+        __m256i eq =
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, new_line), _mm256_cmpeq_epi8(v, carriage));
+        if (_mm256_movemask_epi8(eq) != 0) {
+            break;
+        }
+
+        non_ascii = _mm256_or_si256(non_ascii, v);
+    }
+
+    if (_mm256_movemask_epi8(non_ascii) != 0) {
+        is_ascii = false;
+    }
+
+    return i;
+}
+
+#elif defined(__ARM_NEON)
+
+std::size_t skip_line_chars_neon(const char *data, std::size_t size, bool &is_ascii) noexcept
+{
+    const uint8x16_t new_line = vdupq_n_u8('\n');
+    const uint8x16_t carriage = vdupq_n_u8('\r');
+
+    uint8x16_t non_ascii = vdupq_n_u8(0);
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(data + i));
+
+        uint8x16_t eq = vorrq_u8(vceqq_u8(v, new_line), vceqq_u8(v, carriage));
+        if (vmaxvq_u8(eq) != 0) {
+            break;
+        }
+
+        non_ascii = vorrq_u8(non_ascii, v);
+    }
+
+    if ((vmaxvq_u8(non_ascii) & 0x80) != 0) {
+        is_ascii = false;
+    }
+
+    return i;
+}
+
+#endif
+
+// Picks the widest kernel the processor supports; AVX2 is selected at
+// runtime so that a portable build does not have to target it.
+Skip_line_chars_fn select_skip_line_chars() noexcept
+{
+#if defined(MLIO_X86_DISPATCH)
+    if (cpu_features().avx2) {
+        return skip_line_chars_avx2;
+    }
+#endif
+
+#if defined(MLIO_X86_DISPATCH) || defined(__SSE2__)
+    return skip_line_chars_sse2;
+#elif defined(__ARM_NEON)
+    return skip_line_chars_neon;
+#else
+    return skip_line_chars_swar;
+#endif
+}
+
+}  // namespace
 
 std::optional<Record>
 read_line(Memory_slice &chunk, bool ignore_leftover, std::optional<std::size_t> max_line_length)
@@ -47,7 +225,8 @@ read_line(Memory_slice &chunk, bool ignore_leftover, std::optional<std::size_t>
 
     auto pos = chars.begin();
 
-    for (auto chr = *pos; pos < chars.end(); ++pos, chr = *pos) {
+    for (; pos < chars.end(); ++pos) {
+        char chr = *pos;
         if (chr == '\n') {
             break;
         }
@@ -103,6 +282,267 @@ read_line(Memory_slice &chunk, bool ignore_leftover, std::optional<std::size_t>
     return Record{std::move(payload)};
 }
 
+namespace {
+
+// Chunks smaller than this are scanned serially.
+constexpr std::size_t parallel_scan_threshold = 0x40'0000;  // 4 MiB
+
+// Blocks smaller than this are not worth a task of their own.
+constexpr std::size_t min_block_size = 0x10'0000;  // 1 MiB
+
+// Scans the lines in [begin, end) which must start at the beginning of a
+// line; the characters past end are only used to tell whether a carriage
+// is followed by a new-line character.
+Line_scan_result scan_lines(stdx::span<const char> chars,
+                            std::size_t begin,
+                            std::size_t end,
+                            const Line_filter &filter,
+                            std::vector<Line_span> &lines)
+{
+    static const Skip_line_chars_fn skip_line_chars = select_skip_line_chars();
+
+    Line_scan_result result{};
+    result.num_chars_scanned = begin;
+
+    std::size_t size = end;
+
+    std::size_t line_begin = begin;
+
+    // Most text is ASCII; only the lines that are not are validated.
+    bool is_ascii = true;
+
+    std::size_t i = begin;
+    while (i < size) {
+        // Skip a vector at a time as long as it contains no line
+        // terminator.
+        i += skip_line_chars(chars.data() + i, size - i, is_ascii);
+
+        for (; i < size; i++) {
+            char chr = chars[i];
+            if (chr == '\n' || chr == '\r') {
+                break;
+            }
+
+            if ((static_cast<unsigned char>(chr) & 0x80) != 0) {
+                is_ascii = false;
+            }
+        }
+
+        if (i == size) {
+            break;
+        }
+
+        char chr = chars[i];
+
+        std::size_t line_end = i;
+
+        if (chr == '\r') {
+            if (i + 1 == chars.size()) {
+                break;
+            }
+
+            if (chars[i + 1] == '\n') {
+                i++;
+            }
+        }
+
+        bool is_comment = filter.comment_char && line_end > line_begin &&
+                          chars[line_begin] == *filter.comment_char;
+
+        if (!is_comment) {
+            if (filter.max_line_length && i - line_begin >= *filter.max_line_length) {
+                return result;
+            }
+
+            if (filter.validate_utf8 && !is_ascii) {
+                if (!is_valid_utf8(chars.subspan(line_begin, line_end - line_begin))) {
+                    result.has_invalid_line = true;
+
+                    return result;
+                }
+            }
+        }
+
+        i++;
+
+        if (!is_comment && (!filter.skip_blank_lines || line_end > line_begin)) {
+            lines.push_back(Line_span{line_begin, line_end, i});
+        }
+
+        line_begin = i;
+
+        result.num_chars_scanned = i;
+
+        is_ascii = true;
+    }
+
+    return result;
+}
+
+// Returns the offset of the first line that starts at or after the
+// specified offset.
+std::size_t find_line_begin(stdx::span<const char> chars, std::size_t offset) noexcept
+{
+    std::size_t size = chars.size();
+
+    if (offset == 0 || offset >= size) {
+        return std::min(offset, size);
+    }
+
+    std::size_t i = offset;
+
+    // Do not split a "\r\n".
+    if (chars[i - 1] == '\r' && chars[i] == '\n') {
+        return i + 1;
+    }
+
+    if (chars[i - 1] == '\n' || chars[i - 1] == '\r') {
+        return i;
+    }
+
+    for (; i < size; i++) {
+        char chr = chars[i];
+        if (chr == '\n') {
+            return i + 1;
+        }
+
+        if (chr == '\r') {
+            if (i + 1 < size && chars[i + 1] == '\n') {
+                return i + 2;
+            }
+
+            return i + 1;
+        }
+    }
+
+    return size;
+}
+
+}  // namespace
+
+Line_scan_result
+find_lines(stdx::span<const char> chars, const Line_filter &filter, std::vector<Line_span> &lines)
+{
+    if (chars.size() < parallel_scan_threshold) {
+        return scan_lines(chars, 0, chars.size(), filter, lines);
+    }
+
+    // Split the chunk into blocks at approximate offsets and move each
+    // split point to the beginning of the next line so that the blocks
+    // can be scanned independently.
+    std::size_t num_blocks = chars.size() / min_block_size;
+
+    std::vector<std::size_t> block_begins(num_blocks + 1);
+    for (std::size_t idx = 1; idx < num_blocks; idx++) {
+        std::size_t offset = std::max(chars.size() * idx / num_blocks, block_begins[idx - 1]);
+
+        block_begins[idx] = find_line_begin(chars, offset);
+    }
+    block_begins[num_blocks] = chars.size();
+
+    std::vector<std::vector<Line_span>> block_lines(num_blocks);
+    std::vector<Line_scan_result> block_results(num_blocks);
+
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](std::size_t idx) {
+        block_results[idx] = scan_lines(
+            chars, block_begins[idx], block_begins[idx + 1], filter, block_lines[idx]);
+    });
+
+    // Concatenate the lines in order up to the first block that stopped
+    // before its end.
+    std::size_t num_lines = 0;
+    for (const std::vector<Line_span> &l : block_lines) {
+        num_lines += l.size();
+    }
+
+    lines.reserve(lines.size() + num_lines);
+
+    Line_scan_result result{};
+    for (std::size_t idx = 0; idx < num_blocks; idx++) {
+        lines.insert(lines.end(), block_lines[idx].begin(), block_lines[idx].end());
+
+        result = block_results[idx];
+        if (result.has_invalid_line || result.num_chars_scanned != block_begins[idx + 1]) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+bool is_valid_utf8(stdx::span<const char> chars) noexcept
+{
+    auto bytes = as_span<const unsigned char>(chars);
+
+    const unsigned char *pos = bytes.data();
+    const unsigned char *end = pos + bytes.size();
+
+    while (pos < end) {
+        if (end - pos >= static_cast<std::ptrdiff_t>(sizeof(std::uint64_t))) {
+            std::uint64_t word{};
+            std::memcpy(&word, pos, sizeof(word));
+
+            if ((word & high_bits) == 0) {
+                pos += sizeof(std::uint64_t);
+
+                continue;
+            }
+        }
+
+        unsigned chr = *pos;
+        if (chr < 0x80) {
+            ++pos;
+
+            continue;
+        }
+
+        std::ptrdiff_t num_bytes{};
+        std::uint32_t code_point{};
+        std::uint32_t min_code_point{};
+
+        if ((chr & 0xE0) == 0xC0) {
+            num_bytes = 2;
+            code_point = chr & 0x1F;
+            min_code_point = 0x80;
+        }
+        else if ((chr & 0xF0) == 0xE0) {
+            num_bytes = 3;
+            code_point = chr & 0x0F;
+            min_code_point = 0x800;
+        }
+        else if ((chr & 0xF8) == 0xF0) {
+            num_bytes = 4;
+            code_point = chr & 0x07;
+            min_code_point = 0x1'0000;
+        }
+        else {
+            return false;
+        }
+
+        if (end - pos < num_bytes) {
+            return false;
+        }
+
+        for (std::ptrdiff_t j = 1; j < num_bytes; j++) {
+            if ((pos[j] & 0xC0) != 0x80) {
+                return false;
+            }
+
+            code_point = (code_point << 6) | (pos[j] & 0x3FU);
+        }
+
+        // Reject overlong encodings, surrogates, and out-of-range values.
+        if (code_point < min_code_point || code_point > 0x10'FFFF ||
+            (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+            return false;
+        }
+
+        pos += num_bytes;
+    }
+
+    return true;
+}
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
@@ -17,8 +17,10 @@
 
 #include <cstddef>
 #include <optional>
+#include <vector>
 
 #include "mlio/fwd.h"
+#include "mlio/span.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -28,6 +30,60 @@ std::optional<Record> read_line(Memory_slice &chunk,
                                 bool ignore_leftover,
                                 std::optional<std::size_t> max_line_length = {});
 
+/// Describes a complete line found by find_lines().
+struct Line_span {
+    /// The offset of the first character of the line.
+    std::size_t begin;
+    /// The offset of the line terminator.
+    std::size_t end;
+    /// The offset following the line terminator.
+    std::size_t next;
+};
+
+/// Specifies the lines that find_lines() should leave out or stop at.
+struct Line_filter {
+    /// If specified, the lines starting with this character are left
+    /// out.
+    std::optional<char> comment_char{};
+    bool skip_blank_lines{};
+    /// If specified, the scan stops at the first line, other than a
+    /// comment line, whose length including its line terminator (but
+    /// not the new-line character of a "\r\n") is at least this value;
+    /// such line is left to read_line() to report.
+    std::optional<std::size_t> max_line_length{};
+    /// If true, the scan stops at the first line that is not valid
+    /// UTF-8.
+    bool validate_utf8{};
+};
+
+struct Line_scan_result {
+    /// The offset following the last complete line that was scanned,
+    /// including the lines that were left out.
+    std::size_t num_chars_scanned{};
+    /// Indicates whether the scan stopped at a line that is not valid
+    /// UTF-8.
+    bool has_invalid_line{};
+};
+
+/// Finds all complete lines in the specified characters in a single
+/// vectorized pass and appends the spans of those that pass the filter
+/// to @p lines. The comment, blank-line, and line-length checks are done
+/// once per line as its terminator is found, so the caller can emit the
+/// records without touching their characters again.
+///
+/// A large chunk is split into blocks at the line boundaries that follow
+/// approximate offsets; the blocks are scanned in parallel and their
+/// lines are concatenated in order.
+///
+/// A carriage at the very end of the characters does not end a line
+/// since it might be followed by a new-line character in the next
+/// chunk.
+Line_scan_result find_lines(stdx::span<const char> chars,
+                            const Line_filter &filter,
+                            std::vector<Line_span> &lines);
+
+bool is_valid_utf8(stdx::span<const char> chars) noexcept;
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
@@ -15,10 +15,14 @@
 
 #include "mlio/record_readers/recordio_record_reader.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <utility>
 
 #include <fmt/format.h>
 
+#include "mlio/logger.h"
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/detail/recordio_header.h"
 #include "mlio/record_readers/detail/util.h"
@@ -32,6 +36,10 @@ namespace detail {
 std::optional<Record>
 Recordio_record_reader::decode_record(Memory_slice &chunk, bool ignore_leftover)
 {
+    if (resync_) {
+        return decode_record_resync(chunk, ignore_leftover);
+    }
+
     if (chunk.empty()) {
         return {};
     }
@@ -74,6 +82,202 @@ Recordio_record_reader::decode_record(Memory_slice &chunk, bool ignore_leftover)
     return Record{std::move(payload), header->record_kind()};
 }
 
+std::optional<Record>
+Recordio_record_reader::decode_record_resync(Memory_slice &chunk, bool ignore_leftover)
+{
+    std::size_t chunk_size = chunk.size();
+
+    auto get_position = [this, &chunk, chunk_size]() {
+        return chunk_position() + chunk_size - chunk.size();
+    };
+
+    while (!chunk.empty()) {
+        // While skipping a corrupt region, we only stop at a header that
+        // starts a new instance.
+        std::optional<bool> is_valid =
+            check_record(chunk, ignore_leftover, corrupt_begin_.has_value());
+        if (is_valid == std::nullopt) {
+            return {};
+        }
+
+        if (*is_valid) {
+            if (corrupt_begin_) {
+                end_corrupt_region(get_position());
+            }
+
+            auto header = detail::try_decode_recordio_header(chunk);
+
+            std::size_t payload_size = header->payload_size();
+
+            auto payload = chunk.subslice(header->size(), payload_size);
+
+            chunk = chunk.subslice(header->size() +
+                                   detail::align(payload_size, detail::Recordio_header::alignment));
+
+            return Record{std::move(payload), header->record_kind()};
+        }
+
+        if (!corrupt_begin_) {
+            corrupt_begin_ = get_position();
+        }
+
+        skip_corrupt_bits(chunk, ignore_leftover);
+    }
+
+    if (!ignore_leftover && corrupt_begin_) {
+        end_corrupt_region(get_position());
+    }
+
+    return {};
+}
+
+std::optional<bool>
+Recordio_record_reader::check_record(Memory_span bits, bool ignore_leftover, bool resync)
+{
+    auto header = detail::try_decode_recordio_header(bits);
+    if (header == std::nullopt) {
+        if (ignore_leftover && bits.size() < sizeof(std::uint64_t)) {
+            return {};
+        }
+        return false;
+    }
+
+    if (resync) {
+        Record_kind kind = header->record_kind();
+        if (kind != Record_kind::complete && kind != Record_kind::begin) {
+            return false;
+        }
+    }
+
+    std::size_t record_size =
+        header->size() + detail::align(header->payload_size(), detail::Recordio_header::alignment);
+
+    if (record_size > bits.size()) {
+        if (ignore_leftover) {
+            set_record_size_hint(record_size);
+
+            return {};
+        }
+        return false;
+    }
+
+    // A corrupt payload size would make us read the next record from
+    // the middle of a payload; make sure the record is followed by
+    // another header or the end of the stream.
+    std::size_t num_remaining = bits.size() - record_size;
+    if (num_remaining == 0) {
+        return true;
+    }
+
+    // The bits after the last record of the stream are too few to hold a
+    // header; they get skipped on their own.
+    if (num_remaining < header->size()) {
+        if (ignore_leftover) {
+            return {};
+        }
+        return true;
+    }
+
+    if (detail::try_decode_recordio_header(bits.subspan(record_size))) {
+        return true;
+    }
+
+    // The record is followed by garbage; if its payload size overruns
+    // the next record, the magic number of that record falls within the
+    // payload.
+    std::size_t search_size = std::min(bits.size(), record_size + sizeof(std::uint32_t) - 1);
+
+    std::size_t idx = detail::find_recordio_magic(bits.first(search_size), header->size());
+
+    return idx >= record_size;
+}
+
+void Recordio_record_reader::skip_corrupt_bits(Memory_slice &chunk, bool ignore_leftover)
+{
+    // The first byte has been checked already.
+    std::size_t idx = detail::find_recordio_magic(chunk, 1);
+    if (idx < chunk.size()) {
+        chunk = chunk.subslice(idx);
+
+        return;
+    }
+
+    // Keep the bits that might be the beginning of a magic number split
+    // across chunks.
+    std::size_t num_kept = 0;
+    if (ignore_leftover) {
+        num_kept = std::min(chunk.size(), sizeof(std::uint32_t) - 1);
+    }
+
+    chunk = chunk.subslice(chunk.size() - num_kept);
+}
+
+void Recordio_record_reader::end_corrupt_region(std::size_t position)
+{
+    std::size_t begin = *std::exchange(corrupt_begin_, std::nullopt);
+
+    num_skipped_bytes_ += position - begin;
+
+    if (warn_) {
+        logger::warn(
+            "The corrupt byte range [{1:n}, {2:n}) of the data store '{0}' has been skipped as it does not contain a valid RecordIO record.",
+            id_,
+            begin,
+            position);
+    }
+}
+
+std::optional<std::size_t> Recordio_record_reader::find_record_boundary(Memory_span bits,
+                                                                        std::size_t position,
+                                                                        bool ignore_leftover)
+{
+    std::size_t base = position - 1;
+
+    // Records always start on a 4-byte boundary of the stream.
+    std::size_t idx = detail::align(position, detail::Recordio_header::alignment) - base;
+
+    for (; idx < bits.size(); idx += detail::Recordio_header::alignment) {
+        auto header = detail::try_decode_recordio_header(bits.subspan(idx));
+        if (header == std::nullopt) {
+            continue;
+        }
+
+        // A split record can only be read starting from its beginning.
+        Record_kind kind = header->record_kind();
+        if (kind != Record_kind::complete && kind != Record_kind::begin) {
+            continue;
+        }
+
+        // The magic number can also occur in a payload; make sure that
+        // the record is followed by another record or the end of the
+        // stream before treating it as a boundary.
+        std::size_t next_idx =
+            idx + header->size() +
+            detail::align(header->payload_size(), detail::Recordio_header::alignment);
+
+        if (next_idx == bits.size() && !ignore_leftover) {
+            return base + idx;
+        }
+
+        if (next_idx + header->size() > bits.size()) {
+            if (ignore_leftover) {
+                return {};
+            }
+            continue;
+        }
+
+        if (detail::try_decode_recordio_header(bits.subspan(next_idx))) {
+            return base + idx;
+        }
+    }
+
+    if (ignore_leftover) {
+        return {};
+    }
+
+    return base + bits.size();
+}
+
 }  // namespace detail
 }  // namespace abi_v1
 }  // namespace mlio
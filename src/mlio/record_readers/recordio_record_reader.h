@@ -15,12 +15,16 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <string>
 #include <utility>
 
+#include "mlio/data_reader.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
 #include "mlio/record_readers/stream_record_reader.h"
+#include "mlio/span.h"
 #include "mlio/streams/input_stream.h"
 
 namespace mlio {
@@ -29,12 +33,53 @@ namespace detail {
 
 class Recordio_record_reader final : public Stream_record_reader {
 public:
-    explicit Recordio_record_reader(Intrusive_ptr<Input_stream> stream)
+    // Unless @p handling is Bad_example_handling::error, a corrupt
+    // region of the stream is skipped by scanning forward to the next
+    // valid header instead of failing the read; with the *_warn modes
+    // the skipped byte range is logged along with @p id.
+    explicit Recordio_record_reader(Intrusive_ptr<Input_stream> stream,
+                                    Bad_example_handling handling = Bad_example_handling::error,
+                                    std::string id = {})
         : Stream_record_reader{std::move(stream)}
+        , resync_{handling != Bad_example_handling::error}
+        , warn_{handling == Bad_example_handling::skip_warn ||
+                handling == Bad_example_handling::pad_warn}
+        , id_{std::move(id)}
     {}
 
+    std::size_t num_skipped_bytes() const noexcept
+    {
+        return num_skipped_bytes_;
+    }
+
 private:
     std::optional<Record> decode_record(Memory_slice &chunk, bool ignore_leftover) final;
+
+    std::optional<Record> decode_record_resync(Memory_slice &chunk, bool ignore_leftover);
+
+    // Returns false if the record at the beginning of the chunk is
+    // corrupt, or nullopt if more bits are needed to tell.
+    std::optional<bool> check_record(Memory_span bits, bool ignore_leftover, bool resync);
+
+    void skip_corrupt_bits(Memory_slice &chunk, bool ignore_leftover);
+
+    void end_corrupt_region(std::size_t position);
+
+    bool is_splittable() const noexcept final
+    {
+        return true;
+    }
+
+    std::optional<std::size_t>
+    find_record_boundary(Memory_span bits, std::size_t position, bool ignore_leftover) final;
+
+    bool resync_;
+    bool warn_;
+    std::string id_;
+    // The stream position at which the corrupt region that is being
+    // skipped begins.
+    std::optional<std::size_t> corrupt_begin_{};
+    std::size_t num_skipped_bytes_{};
 };
 
 }  // namespace detail
@@ -15,9 +15,12 @@
 
 #include "mlio/record_readers/stream_record_reader.h"
 
+#include <algorithm>
+#include <stdexcept>
 #include <optional>
 #include <utility>
 
+#include "mlio/not_supported_error.h"
 #include "mlio/record_readers/detail/chunk_reader.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/streams/input_stream.h"
@@ -47,7 +50,12 @@ std::optional<Record> Stream_record_reader::read_record_core()
     std::optional<Record> record{};
 
     while (true) {
+        std::size_t size = chunk_.size();
+
         record = decode_record(chunk_, !chunk_reader_->eof());
+
+        position_ += size - chunk_.size();
+
         if (record) {
             break;
         }
@@ -61,5 +69,110 @@ std::optional<Record> Stream_record_reader::read_record_core()
     return record;
 }
 
+bool Stream_record_reader::set_shard(std::size_t shard_index, std::size_t num_shards)
+{
+    if (num_shards == 0 || shard_index >= num_shards) {
+        throw std::invalid_argument{"The shard index must be less than the number of shards."};
+    }
+
+    if (!is_splittable() || !chunk_reader_->seekable()) {
+        return false;
+    }
+
+    std::size_t size = chunk_reader_->size();
+
+    auto shard_begin = [size, num_shards](std::size_t index) {
+        return index * (size / num_shards) + std::min(index, size % num_shards);
+    };
+
+    std::size_t first = find_record_boundary_at(shard_begin(shard_index), size);
+    std::size_t last = find_record_boundary_at(shard_begin(shard_index + 1), size);
+
+    // The records before the current position have already been
+    // consumed (e.g. a header row); we should not read them again.
+    first = std::max(first, position_);
+    last = std::max(last, first);
+
+    chunk_reader_->set_range(first, last);
+
+    chunk_ = {};
+
+    position_ = first;
+
+    end_ = last;
+
+    return true;
+}
+
+std::optional<std::size_t> Stream_record_reader::stream_size() const
+{
+    if (!chunk_reader_->seekable()) {
+        return {};
+    }
+    return chunk_reader_->size();
+}
+
+std::optional<std::size_t> Stream_record_reader::position() const noexcept
+{
+    if (has_peeked_record()) {
+        return {};
+    }
+    return position_;
+}
+
+bool Stream_record_reader::seek(std::size_t position)
+{
+    if (!chunk_reader_->seekable()) {
+        return false;
+    }
+
+    std::size_t last = end_ ? *end_ : chunk_reader_->size();
+
+    chunk_reader_->set_range(position, last);
+
+    chunk_ = {};
+
+    position_ = std::min(position, last);
+
+    discard_peeked_record();
+
+    return true;
+}
+
+bool Stream_record_reader::is_splittable() const noexcept
+{
+    return false;
+}
+
+std::optional<std::size_t>
+Stream_record_reader::find_record_boundary(Memory_span, std::size_t, bool)
+{
+    throw Not_supported_error{"The record reader does not support splitting."};
+}
+
+std::size_t Stream_record_reader::find_record_boundary_at(std::size_t position, std::size_t size)
+{
+    if (position == 0 || position >= size) {
+        return std::min(position, size);
+    }
+
+    // Start with a small probe; a record boundary is usually found in
+    // the first few bytes, but a large record can span many of them.
+    std::size_t probe_size = 0x1'0000;  // 64 KiB
+
+    while (true) {
+        Memory_slice bits = chunk_reader_->read_at(position - 1, probe_size);
+
+        bool has_more = position - 1 + bits.size() < size;
+
+        std::optional<std::size_t> boundary = find_record_boundary(bits, position, has_more);
+        if (boundary) {
+            return std::min(*boundary, size);
+        }
+
+        probe_size <<= 1;
+    }
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#include "mlio/record_readers/tar_record_reader.h"
+
+#include <cstddef>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/detail/tar_header.h"
+#include "mlio/record_readers/detail/util.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+inline std::string_view as_string_view(Memory_span bits) noexcept
+{
+    auto chars = as_span<const char>(bits);
+
+    return std::string_view{chars.data(), chars.size()};
+}
+
+// Returns the value of the 'path' keyword of a POSIX extended header,
+// which consists of records in the form '<length> <keyword>=<value>\n'.
+std::optional<std::string> read_pax_path(std::string_view s)
+{
+    std::optional<std::string> path{};
+
+    while (!s.empty()) {
+        std::size_t space_pos = s.find(' ');
+        if (space_pos == std::string_view::npos) {
+            break;
+        }
+
+        std::size_t length = 0;
+        for (char chr : s.substr(0, space_pos)) {
+            if (chr < '0' || chr > '9') {
+                return path;
+            }
+            length = length * 10 + static_cast<std::size_t>(chr - '0');
+        }
+
+        if (length <= space_pos + 1 || length > s.size()) {
+            break;
+        }
+
+        std::string_view record = s.substr(space_pos + 1, length - space_pos - 1);
+        if (!record.empty() && record.back() == '\n') {
+            record.remove_suffix(1);
+        }
+
+        std::size_t eq_pos = record.find('=');
+        if (eq_pos != std::string_view::npos && record.substr(0, eq_pos) == "path") {
+            path = record.substr(eq_pos + 1);
+        }
+
+        s.remove_prefix(length);
+    }
+
+    return path;
+}
+
+}  // namespace
+
+std::optional<Record> Tar_record_reader::decode_record(Memory_slice &chunk, bool ignore_leftover)
+{
+    while (!chunk.empty()) {
+        if (chunk.size() < tar_block_size) {
+            if (ignore_leftover) {
+                return {};
+            }
+
+            throw Corrupt_header_error{"The tar archive ends with an incomplete header."};
+        }
+
+        Memory_span block = Memory_span{chunk}.first(tar_block_size);
+
+        // The end of the archive is marked by zero blocks.
+        if (is_zero_tar_block(block)) {
+            chunk = chunk.subslice(tar_block_size);
+
+            continue;
+        }
+
+        auto header = try_decode_tar_header(block);
+        if (header == std::nullopt) {
+            throw Corrupt_header_error{"The record does not have a valid tar header."};
+        }
+
+        std::size_t member_size = tar_block_size + align(header->size, tar_block_size);
+
+        if (member_size > chunk.size()) {
+            if (ignore_leftover) {
+                set_record_size_hint(member_size);
+
+                return {};
+            }
+
+            throw Corrupt_header_error{fmt::format(
+                "The tar member '{0}' has a size of {1:n} byte(s) while the size specified in its header is {2:n} byte(s).",
+                header->name,
+                chunk.size() - tar_block_size,
+                header->size)};
+        }
+
+        auto payload = chunk.subslice(tar_block_size, header->size);
+
+        chunk = chunk.subslice(member_size);
+
+        switch (header->type_flag) {
+        // Regular and contiguous files.
+        case '\0':
+        case '0':
+        case '7': {
+            std::string name = long_name_ ? std::move(*long_name_) : std::move(header->name);
+
+            long_name_ = {};
+
+            if (filter_ && !filter_(name)) {
+                continue;
+            }
+
+            return Record{std::move(payload)};
+        }
+
+        // GNU long name.
+        case 'L': {
+            std::string_view name = as_string_view(payload);
+
+            long_name_ = name.substr(0, name.find('\0'));
+
+            continue;
+        }
+
+        // POSIX extended header.
+        case 'x':
+            long_name_ = read_pax_path(as_string_view(payload));
+
+            continue;
+
+        default:
+            long_name_ = {};
+
+            continue;
+        }
+    }
+
+    return {};
+}
+
+std::optional<std::size_t> Tar_record_reader::find_record_boundary(Memory_span bits,
+                                                                   std::size_t position,
+                                                                   bool ignore_leftover)
+{
+    std::size_t base = position - 1;
+
+    // Headers always start on a block boundary of the stream.
+    std::size_t idx = align(position, tar_block_size) - base;
+
+    for (; idx < bits.size(); idx += tar_block_size) {
+        auto header = try_decode_tar_header(bits.subspan(idx), true);
+        if (header == std::nullopt) {
+            if (idx + tar_block_size > bits.size() && ignore_leftover) {
+                return {};
+            }
+            continue;
+        }
+
+        // A tar archive stored in a member has valid headers as well;
+        // make sure that the member is followed by another header or
+        // the end of the archive before treating it as a boundary.
+        std::size_t next_idx = idx + tar_block_size + align(header->size, tar_block_size);
+
+        if (next_idx == bits.size() && !ignore_leftover) {
+            return base + idx;
+        }
+
+        if (next_idx + tar_block_size > bits.size()) {
+            if (ignore_leftover) {
+                return {};
+            }
+            continue;
+        }
+
+        Memory_span next_block = bits.subspan(next_idx, tar_block_size);
+        if (is_zero_tar_block(next_block) || try_decode_tar_header(next_block)) {
+            return base + idx;
+        }
+    }
+
+    if (ignore_leftover) {
+        return {};
+    }
+
+    return base + bits.size();
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/stream_record_reader.h"
+#include "mlio/span.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Reads the regular files stored in a tar archive, such as a
+/// WebDataset shard, as records. Directories, links, and the metadata
+/// members of the GNU and POSIX formats are skipped.
+class Tar_record_reader final : public Stream_record_reader {
+public:
+    /// Called with the name of each regular file; returns a boolean
+    /// value indicating whether the file should be read as a record.
+    using Member_filter = std::function<bool(std::string_view name)>;
+
+    explicit Tar_record_reader(Intrusive_ptr<Input_stream> stream, Member_filter filter = {})
+        : Stream_record_reader{std::move(stream)}, filter_{std::move(filter)}
+    {}
+
+private:
+    std::optional<Record> decode_record(Memory_slice &chunk, bool ignore_leftover) final;
+
+    bool is_splittable() const noexcept final
+    {
+        return true;
+    }
+
+    std::optional<std::size_t>
+    find_record_boundary(Memory_span bits, std::size_t position, bool ignore_leftover) final;
+
+    Member_filter filter_;
+    // The name specified by a preceding GNU long name or POSIX extended
+    // header.
+    std::optional<std::string> long_name_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,12 +16,14 @@
 #include "mlio/record_readers/text_line_record_reader.h"
 
 #include <optional>
+#include <utility>
 
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/detail/text_line.h"
 #include "mlio/record_readers/record.h"
-
-using mlio::detail::read_line;
+#include "mlio/record_readers/record_error.h"
+#include "mlio/span.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -30,22 +32,114 @@ namespace detail {
 std::optional<Record>
 Text_line_record_reader::decode_text_record(Memory_slice &chunk, bool ignore_leftover)
 {
-    if (chunk.empty()) {
-        return {};
+    while (!chunk.empty()) {
+        std::optional<Record> record = read_line(chunk, ignore_leftover);
+        if (record == std::nullopt || !skip_blank_ || !record->payload().empty()) {
+            return record;
+        }
     }
 
-    if (skip_blank_) {
-        while (!chunk.empty()) {
-            std::optional<Record> record = read_line(chunk, ignore_leftover);
-            if (record == std::nullopt || !record->payload().empty()) {
-                return record;
-            }
+    return {};
+}
+
+std::optional<Record>
+Text_line_record_reader::read_line(Memory_slice &chunk, bool ignore_leftover)
+{
+    if (!is_indexed(chunk)) {
+        index_lines(chunk);
+    }
+
+    if (line_idx_ == lines_.size()) {
+        // Skip the blank lines that follow the last line.
+        chunk.remove_prefix(num_indexed_chars_ - line_offset_);
+
+        line_offset_ = num_indexed_chars_;
+
+        if (has_invalid_line_) {
+            throw Corrupt_record_error{"The text line is not a valid UTF-8 string."};
+        }
+
+        if (chunk.empty()) {
+            indexed_chunk_ = {};
+
+            line_refs_.release();
+
+            return {};
         }
 
-        return {};
+        // The remainder of the chunk is a partial line, or the last line
+        // of the stream if it does not end with a line terminator.
+        if (ignore_leftover) {
+            return {};
+        }
+
+        auto chars = as_span<const char>(chunk);
+
+        std::size_t size = chunk.size();
+        if (chars[size - 1] == '\r') {
+            size--;
+        }
+
+        if (validate_utf8_ && !is_valid_utf8(chars.first(size))) {
+            throw Corrupt_record_error{"The text line is not a valid UTF-8 string."};
+        }
+
+        Memory_slice payload = chunk.first(size);
+
+        chunk = {};
+
+        indexed_chunk_ = {};
+
+        line_refs_.release();
+
+        return Record{std::move(payload)};
     }
 
-    return detail::read_line(chunk, ignore_leftover);
+    const Line_span &line = lines_[line_idx_++];
+
+    // Skip the blank lines that precede the line.
+    chunk.remove_prefix(line.begin - line_offset_);
+
+    Memory_slice payload{
+        line_refs_.take(), chunk.begin(), chunk.begin() + as_ssize(line.end - line.begin)};
+
+    chunk.remove_prefix(line.next - line.begin);
+
+    line_offset_ = line.next;
+
+    return Record{std::move(payload)};
+}
+
+inline bool Text_line_record_reader::is_indexed(const Memory_slice &chunk) const noexcept
+{
+    // A chunk that starts right after the end of the indexed chunk, or
+    // that starts at its leftover (e.g. in a chunk ring), is a different
+    // one even if the addresses match.
+    return line_offset_ < indexed_chunk_.size() && chunk.end() == indexed_chunk_.end() &&
+           chunk.begin() == indexed_chunk_.begin() + as_ssize(line_offset_);
+}
+
+void Text_line_record_reader::index_lines(const Memory_slice &chunk)
+{
+    lines_.clear();
+
+    Line_filter filter{};
+    filter.skip_blank_lines = skip_blank_;
+    filter.validate_utf8 = validate_utf8_;
+
+    Line_scan_result result = find_lines(as_span<const char>(chunk), filter, lines_);
+
+    num_indexed_chars_ = result.num_chars_scanned;
+
+    has_invalid_line_ = result.has_invalid_line;
+
+    indexed_chunk_ = chunk;
+
+    line_refs_ = Ref_batch<Memory_block>{chunk.block().get(), lines_.size()};
+
+    line_idx_ = 0;
+
+    line_offset_ = 0;
 }
 
 }  // namespace detail
@@ -15,11 +15,17 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "mlio/detail/ref_batch.h"
 #include "mlio/fwd.h"
 #include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/detail/text_line.h"
 #include "mlio/record_readers/text_record_reader.h"
 #include "mlio/streams/input_stream.h"
 
@@ -29,14 +35,38 @@ namespace detail {
 
 class Text_line_record_reader final : public Text_record_reader {
 public:
-    explicit Text_line_record_reader(Intrusive_ptr<Input_stream> stream, bool skip_blank)
-        : Text_record_reader{std::move(stream)}, skip_blank_{skip_blank}
+    explicit Text_line_record_reader(Intrusive_ptr<Input_stream> stream,
+                                     bool skip_blank,
+                                     bool validate_utf8 = false)
+        : Text_record_reader{std::move(stream)}
+        , skip_blank_{skip_blank}
+        , validate_utf8_{validate_utf8}
     {}
 
 private:
     std::optional<Record> decode_text_record(Memory_slice &chunk, bool ignore_leftover) final;
 
+    std::optional<Record> read_line(Memory_slice &chunk, bool ignore_leftover);
+
+    bool is_indexed(const Memory_slice &chunk) const noexcept;
+
+    void index_lines(const Memory_slice &chunk);
+
     bool skip_blank_;
+    bool validate_utf8_;
+    // The lines found in a single pass over a chunk, without the blank
+    // lines if skip_blank_ is set. The indexed chunk is kept alive so
+    // that its address cannot be reused by a later chunk.
+    Memory_slice indexed_chunk_{};
+    std::vector<Line_span> lines_{};
+    std::size_t num_indexed_chars_{};
+    // The references to the block of the indexed chunk for the records
+    // of its lines, acquired at once when the chunk gets indexed.
+    Ref_batch<Memory_block> line_refs_{};
+    std::size_t line_idx_{};
+    // The offset of the next line within the indexed chunk.
+    std::size_t line_offset_{};
+    bool has_invalid_line_{};
 };
 
 }  // namespace detail
@@ -15,12 +15,14 @@
 
 #include "mlio/record_readers/text_record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mlio/memory/memory_slice.h"
 #include "mlio/record_readers/record.h"
 #include "mlio/span.h"
 #include "mlio/streams/input_stream.h"
+#include "mlio/util/cast.h"
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -42,6 +44,44 @@ std::optional<Record> Text_record_reader::decode_record(Memory_slice &chunk, boo
     return {};
 }
 
+bool Text_record_reader::is_splittable() const noexcept
+{
+    return true;
+}
+
+std::optional<std::size_t>
+Text_record_reader::find_record_boundary(Memory_span bits, std::size_t position, bool ignore_leftover)
+{
+    auto chars = as_span<const char>(bits);
+
+    // The first byte of the span precedes the position; if it ends a
+    // line, the next line starts right at the position.
+    auto pos = std::find_if(chars.begin(), chars.end(), [](char chr) {
+        return chr == '\n' || chr == '\r';
+    });
+
+    if (pos != chars.end() && *pos == '\r') {
+        auto next_pos = pos + 1;
+        if (next_pos == chars.end()) {
+            pos = next_pos;
+        }
+        else if (*next_pos == '\n') {
+            pos = next_pos;
+        }
+    }
+
+    if (pos == chars.end()) {
+        if (ignore_leftover) {
+            return {};
+        }
+    }
+    else {
+        ++pos;
+    }
+
+    return position - 1 + as_size(pos - chars.begin());
+}
+
 bool Text_record_reader::skip_utf8_bom(Memory_slice &chunk, bool ignore_leftover) noexcept
 {
     auto bits = as_span<const unsigned char>(chunk);
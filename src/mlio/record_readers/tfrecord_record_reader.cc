@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/record_readers/tfrecord_record_reader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/crc32c.h"
+#include "mlio/endian.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/record_readers/record_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The length and its checksum.
+constexpr std::size_t header_size = sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+// The checksum of the payload.
+constexpr std::size_t footer_size = sizeof(std::uint32_t);
+
+template<typename T>
+inline T load_little_endian(const std::byte *pos) noexcept
+{
+    T value{};
+    std::memcpy(&value, pos, sizeof(T));
+    return little_to_host_order(value);
+}
+
+}  // namespace
+
+std::optional<Record>
+Tfrecord_record_reader::decode_record(Memory_slice &chunk, bool ignore_leftover)
+{
+    if (chunk.empty()) {
+        return {};
+    }
+
+    if (chunk.size() < header_size) {
+        if (ignore_leftover) {
+            return {};
+        }
+
+        throw Corrupt_header_error{fmt::format(
+            "The TFRecord header has a size of {0:n} byte(s) while it should be {1:n} bytes.",
+            chunk.size(),
+            header_size)};
+    }
+
+    const std::byte *bits = chunk.data();
+
+    auto length = load_little_endian<std::uint64_t>(bits);
+
+    // Verifying the length before it is used keeps a corrupt header from
+    // making us read ahead a huge amount of data.
+    if (verify_checksums_) {
+        auto crc = load_little_endian<std::uint32_t>(bits + sizeof(std::uint64_t));
+        if (crc != masked_crc32c({bits, sizeof(std::uint64_t)})) {
+            throw Corrupt_header_error{
+                "The checksum of the record length does not match the one in the TFRecord header."};
+        }
+    }
+
+    if (length > std::numeric_limits<std::size_t>::max() - header_size - footer_size) {
+        throw Corrupt_header_error{"The record length in the TFRecord header is too large."};
+    }
+
+    std::size_t payload_size = length;
+
+    std::size_t record_size = header_size + payload_size + footer_size;
+
+    if (record_size > chunk.size()) {
+        if (ignore_leftover) {
+            set_record_size_hint(record_size);
+
+            return {};
+        }
+
+        throw Corrupt_record_error{fmt::format(
+            "The record has a size of {0:n} byte(s) while the size specified in the TFRecord header is {1:n} byte(s).",
+            chunk.size() - header_size,
+            payload_size + footer_size)};
+    }
+
+    auto payload = chunk.subslice(header_size, payload_size);
+
+    if (verify_checksums_) {
+        auto crc = load_little_endian<std::uint32_t>(bits + header_size + payload_size);
+        if (crc != masked_crc32c(payload)) {
+            throw Corrupt_footer_error{
+                "The checksum of the record payload does not match the one in the TFRecord footer."};
+        }
+    }
+
+    chunk = chunk.subslice(record_size);
+
+    return Record{std::move(payload)};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "mlio/fwd.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/record_readers/stream_record_reader.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Reads the records of a TFRecord file. Each record is framed by its
+// length and the masked CRC32C checksums of the length and the payload.
+class Tfrecord_record_reader final : public Stream_record_reader {
+public:
+    // The checksums are only verified if @p verify_checksums is true;
+    // skipping them is safe for trusted data and spares a pass over the
+    // payload.
+    explicit Tfrecord_record_reader(Intrusive_ptr<Input_stream> stream,
+                                    bool verify_checksums = true)
+        : Stream_record_reader{std::move(stream)}, verify_checksums_{verify_checksums}
+    {}
+
+private:
+    std::optional<Record> decode_record(Memory_slice &chunk, bool ignore_leftover) final;
+
+    bool verify_checksums_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
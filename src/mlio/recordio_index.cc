@@ -0,0 +1,288 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/recordio_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/error.h"
+#include "mlio/instance.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/detail/recordio_header.h"
+#include "mlio/record_readers/detail/util.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::current_error_code;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::uint32_t index_magic = 0x5844'4952;  // 'RIDX'
+constexpr std::uint32_t index_version = 1;
+
+constexpr std::size_t index_header_size = 16;
+constexpr std::size_t index_entry_size = 16;
+
+// Reads a RecordIO stream header by header without keeping the
+// payloads in memory.
+class Recordio_scanner {
+public:
+    explicit Recordio_scanner(Intrusive_ptr<Input_stream> stream) noexcept
+        : stream_{std::move(stream)}
+    {}
+
+    // Copies the next header into @p header. Returns false if the end
+    // of the stream is reached before the first byte of the header.
+    bool read_header(Mutable_memory_span header)
+    {
+        std::size_t num_bytes_copied = 0;
+
+        while (num_bytes_copied < header.size()) {
+            if (chunk_.empty() && !next_chunk()) {
+                if (num_bytes_copied == 0) {
+                    return false;
+                }
+
+                throw Data_reader_error{
+                    fmt::format("The record header at offset {0:n} is truncated.", position_)};
+            }
+
+            std::size_t size = std::min(chunk_.size(), header.size() - num_bytes_copied);
+
+            std::copy(chunk_.begin(),
+                      chunk_.begin() + as_ssize(size),
+                      header.begin() + as_ssize(num_bytes_copied));
+
+            chunk_ = chunk_.subslice(size);
+
+            num_bytes_copied += size;
+        }
+
+        position_ += header.size();
+
+        return true;
+    }
+
+    void skip(std::size_t size)
+    {
+        std::size_t offset = position_;
+
+        position_ += size;
+
+        while (size > 0) {
+            if (chunk_.empty() && !next_chunk()) {
+                throw Data_reader_error{
+                    fmt::format("The record payload at offset {0:n} is truncated.", offset)};
+            }
+
+            std::size_t num_bytes_skipped = std::min(chunk_.size(), size);
+
+            chunk_ = chunk_.subslice(num_bytes_skipped);
+
+            size -= num_bytes_skipped;
+        }
+    }
+
+    std::size_t position() const noexcept
+    {
+        return position_;
+    }
+
+private:
+    bool next_chunk()
+    {
+        chunk_ = stream_->read(0x10'0000);  // 1 MiB
+
+        return !chunk_.empty();
+    }
+
+    Intrusive_ptr<Input_stream> stream_;
+    Memory_slice chunk_{};
+    std::size_t position_{};
+};
+
+template<typename T>
+void store_le(std::byte *pos, T value) noexcept
+{
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        pos[i] = static_cast<std::byte>((value >> (i * 8)) & 0xff);
+    }
+}
+
+template<typename T>
+T load_le(const std::byte *pos) noexcept
+{
+    T value{};
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<T>(pos[i]) << (i * 8));
+    }
+    return value;
+}
+
+}  // namespace
+}  // namespace detail
+
+std::vector<Recordio_index_entry> build_recordio_index(const Data_store &store)
+{
+    detail::Recordio_scanner scanner{store.open_read()};
+
+    std::vector<Recordio_index_entry> entries{};
+
+    // The offset of the 'begin' record of the split record that we are
+    // in, if any.
+    std::optional<std::size_t> split_offset{};
+
+    std::array<std::byte, sizeof(std::uint32_t) * 2> bits{};
+
+    while (scanner.read_header(bits)) {
+        std::size_t offset = scanner.position() - bits.size();
+
+        auto header = detail::decode_recordio_header(bits);
+        if (header == std::nullopt) {
+            throw Data_reader_error{fmt::format(
+                "The record at offset {1:n} in the data store '{0}' does not have a valid RecordIO header.",
+                store.id(),
+                offset)};
+        }
+
+        // The MXNet RecordIO format requires records to be on 4-byte
+        // boundary.
+        scanner.skip(detail::align(header->payload_size(), detail::Recordio_header::alignment));
+
+        Record_kind kind = header->record_kind();
+
+        if ((kind == Record_kind::complete || kind == Record_kind::begin) == split_offset.has_value()) {
+            throw Data_reader_error{fmt::format(
+                "The data store '{0}' contains a corrupt split record at offset {1:n}.",
+                store.id(),
+                offset)};
+        }
+
+        switch (kind) {
+        case Record_kind::complete:
+            entries.push_back({offset, scanner.position() - offset});
+            break;
+
+        case Record_kind::begin:
+            split_offset = offset;
+            break;
+
+        case Record_kind::middle:
+            break;
+
+        case Record_kind::end:
+            entries.push_back({*split_offset, scanner.position() - *split_offset});
+
+            split_offset = {};
+            break;
+        }
+    }
+
+    if (split_offset) {
+        throw Data_reader_error{fmt::format(
+            "The data store '{0}' ends with an incomplete split record at offset {1:n}.",
+            store.id(),
+            *split_offset)};
+    }
+
+    return entries;
+}
+
+void write_recordio_index(const std::string &path, stdx::span<const Recordio_index_entry> entries)
+{
+    std::vector<std::byte> bits(detail::index_header_size + entries.size() * detail::index_entry_size);
+
+    std::byte *pos = bits.data();
+
+    detail::store_le(pos, detail::index_magic);
+    detail::store_le(pos + 4, detail::index_version);
+    detail::store_le<std::uint64_t>(pos + 8, entries.size());
+
+    pos += detail::index_header_size;
+
+    for (const Recordio_index_entry &entry : entries) {
+        detail::store_le<std::uint64_t>(pos, entry.offset);
+        detail::store_le<std::uint64_t>(pos + 8, entry.size);
+
+        pos += detail::index_entry_size;
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (file) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        file.write(reinterpret_cast<const char *>(bits.data()), as_ssize(bits.size()));
+    }
+
+    if (!file) {
+        throw std::system_error{current_error_code(), "The index file cannot be written."};
+    }
+}
+
+std::vector<Recordio_index_entry> read_recordio_index(const Data_store &store)
+{
+    Instance instance{store};
+
+    const Memory_slice &bits = instance.bits();
+
+    const std::byte *pos = bits.data();
+
+    if (bits.size() < detail::index_header_size ||
+        detail::load_le<std::uint32_t>(pos) != detail::index_magic) {
+        throw Data_reader_error{
+            fmt::format("The data store '{0}' does not contain a RecordIO index.", store.id())};
+    }
+
+    if (detail::load_le<std::uint32_t>(pos + 4) != detail::index_version) {
+        throw Data_reader_error{fmt::format(
+            "The RecordIO index in the data store '{0}' has an unsupported version.", store.id())};
+    }
+
+    auto num_entries = detail::load_le<std::uint64_t>(pos + 8);
+
+    if (bits.size() - detail::index_header_size != num_entries * detail::index_entry_size) {
+        throw Data_reader_error{fmt::format(
+            "The RecordIO index in the data store '{0}' is corrupt.", store.id())};
+    }
+
+    pos += detail::index_header_size;
+
+    std::vector<Recordio_index_entry> entries(num_entries);
+
+    for (Recordio_index_entry &entry : entries) {
+        entry.offset = detail::load_le<std::uint64_t>(pos);
+        entry.size = detail::load_le<std::uint64_t>(pos + 8);
+
+        pos += detail::index_entry_size;
+    }
+
+    return entries;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
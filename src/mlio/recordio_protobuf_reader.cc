@@ -16,30 +16,41 @@
 #include "mlio/recordio_protobuf_reader.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <limits>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <fmt/format.h>
 #include <tbb/tbb.h>
 
-#include "mlio/coo_tensor_builder.h"
+#include "mlio/sparse_tensor_builder.h"
 #include "mlio/cpu_array.h"
 #include "mlio/data_reader_error.h"
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/decode_warning_log.h"
+#include "mlio/detail/narrow.h"
 #include "mlio/detail/protobuf/recordio_protobuf.pb.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/logger.h"
 #include "mlio/not_supported_error.h"
 #include "mlio/record_readers/recordio_record_reader.h"
+#include "mlio/recordio_protobuf_scanner.h"
 #include "mlio/tensor.h"
 #include "mlio/util/cast.h"
 
-using mlio::detail::Coo_tensor_builder;
-using mlio::detail::Coo_tensor_builder_impl;
-using mlio::detail::make_coo_tensor_builder;
+using mlio::detail::Sparse_tensor_builder;
+using mlio::detail::Sparse_tensor_builder_impl;
+using mlio::detail::Protobuf_feature;
+using mlio::detail::Protobuf_tensor_view;
+using mlio::detail::Protobuf_value_type;
+using mlio::detail::Recordio_protobuf_scanner;
 
 namespace mlio {
 inline namespace abi_v1 {
@@ -50,38 +61,157 @@ namespace {
 // therefore we re-use a single instance per thread.
 thread_local aialgs::data::Record proto_msg_{};  // NOLINT(cert-err58-cpp)
 
+// The scratch buffers of the wire-format scanner.
+thread_local std::vector<Protobuf_feature> features_{};  // NOLINT(cert-err58-cpp)
+thread_local std::vector<std::size_t> attr_indices_{};   // NOLINT(cert-err58-cpp)
+thread_local std::vector<bool> seen_attrs_{};            // NOLINT(cert-err58-cpp)
+
+// Sparse tensor builders expect contiguous host-order arrays.
+thread_local std::vector<std::uint64_t> sparse_keys_{};  // NOLINT(cert-err58-cpp)
+
+template<typename T>
+thread_local std::vector<T> sparse_values_{};  // NOLINT(cert-err58-cpp)
+
+// Holds the values of a tensor view before they get narrowed.
+template<typename T>
+thread_local std::vector<T> narrow_buffer_{};  // NOLINT(cert-err58-cpp)
+
+// Copies the values of the specified tensor to the destination. If the
+// data type of the destination differs from the data type of the tensor,
+// narrows the values in bulk.
+//
+// @return
+//     false if one or more values do not fit into the destination.
+template<Data_type src, Data_type dst, typename Protobuf_tensor>
+bool copy_values(const Protobuf_tensor &tensor, data_type_t<dst> *destination)
+{
+    if constexpr (src == dst) {
+        if constexpr (std::is_same_v<Protobuf_tensor, Protobuf_tensor_view>) {
+            tensor.copy_values(destination);
+        }
+        else {
+            std::copy_n(tensor.values().begin(), tensor.values_size(), destination);
+        }
+
+        return true;
+    }
+    else {
+        auto size = as_size(tensor.values_size());
+
+        const data_type_t<src> *values{};
+        if constexpr (std::is_same_v<Protobuf_tensor, Protobuf_tensor_view>) {
+            auto &buffer = narrow_buffer_<data_type_t<src>>;
+            buffer.resize(size);
+            tensor.copy_values(buffer.data());
+
+            values = buffer.data();
+        }
+        else {
+            values = tensor.values().data();
+        }
+
+        return narrow_values<dst>(values, destination, size);
+    }
+}
+
 }  // namespace
 }  // namespace detail
 
+namespace {
+
+using Sparse_tensor_builder_list = std::vector<std::unique_ptr<Sparse_tensor_builder>>;
+
+// Holds the sparse tensor builders of a contiguous range of rows that got
+// decoded in parallel.
+struct Sparse_row_range {
+    std::size_t first_row_idx{};
+    Sparse_tensor_builder_list sparse_tensor_builders{};
+};
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+// Rolls back the rows that a bad instance appended to the builders of
+// its sparse features before one of its other features failed.
+void truncate_sparse_tensor_builders(Sparse_tensor_builder_list &builders, std::size_t num_rows)
+{
+    for (auto &builder : builders) {
+        if (builder != nullptr) {
+            builder->truncate(num_rows);
+        }
+    }
+}
+
+}  // namespace
+
 class Recordio_protobuf_reader::Decoder_state {
 public:
     explicit Decoder_state(const Recordio_protobuf_reader &r, std::size_t batch_size);
 
+    Sparse_tensor_builder_list make_sparse_tensor_builders(std::size_t num_rows) const;
+
+    std::unique_ptr<Sparse_tensor_builder>
+    make_sparse_tensor_builder(std::size_t attr_idx, std::size_t num_rows) const;
+
+    void merge_sparse_tensor_builders(tbb::concurrent_vector<Sparse_row_range> &row_ranges);
+
+    void compact_rows(const std::vector<char> &decoded);
+
+    void zero_fill_padding(std::size_t num_rows);
+
     const Recordio_protobuf_reader *reader;
     bool warn_bad_instance;
     bool error_bad_example;
+    detail::Decode_warning_log warnings{};
     std::vector<Intrusive_ptr<Tensor>> tensors{};
-    std::vector<std::unique_ptr<Coo_tensor_builder>> coo_tensor_builders{};
+    Sparse_tensor_builder_list sparse_tensor_builders{};
 
 private:
     void init_state(const Schema &schema, std::size_t batch_size);
 
     void init_tensor(const Attribute &attr, std::size_t batch_size);
 
-    void init_coo_tensor_builder(const Attribute &attr, std::size_t batch_size);
+    void init_sparse_tensor_builder(std::size_t attr_idx, std::size_t batch_size);
 };
 
 class Recordio_protobuf_reader::Decoder {
 public:
-    explicit Decoder(Decoder_state &state) : state_{&state}
+    explicit Decoder(Decoder_state &state)
+        : state_{&state}, sparse_tensor_builders_{&state.sparse_tensor_builders}
+    {}
+
+    explicit Decoder(Decoder_state &state, Sparse_tensor_builder_list &sparse_tensor_builders)
+        : state_{&state}, sparse_tensor_builders_{&sparse_tensor_builders}
     {}
 
     bool decode(std::size_t row_idx, const Instance &instance);
 
 private:
+    std::optional<bool> decode_features(const std::vector<Protobuf_feature> &features);
+
+    bool decode_feature(const Protobuf_feature &feature);
+
+    bool decode_message();
+
     const aialgs::data::Record *parse_proto(const Instance &instance) const;
 
-    bool decode_feature(const std::string &name, const aialgs::data::Value &value);
+    bool decode_feature(std::string_view name, bool label, const aialgs::data::Value &value);
+
+    std::optional<std::size_t> find_attribute(std::string_view name, bool label) const;
+
+    bool check_num_features(std::size_t num_features_read) const;
+
+    void report_unexpected_data_type() const;
+
+    template<typename Format_fn>
+    void report_bad_instance(detail::Decode_warning_kind kind,
+                             std::size_t attr_idx,
+                             Format_fn &&format_message) const;
 
     template<Data_type dt, typename Protobuf_tensor>
     bool decode_feature(const Protobuf_tensor &tensor);
@@ -92,22 +222,44 @@ private:
     template<typename Protobuf_tensor>
     bool shape_equals(const Protobuf_tensor &tensor) const;
 
-    template<Data_type dt, typename Protobuf_tensor>
+    template<Data_type src, Data_type dst, typename Protobuf_tensor>
+    bool store_values(const Protobuf_tensor &tensor) const;
+
+    template<Data_type src, Data_type dst, typename Protobuf_tensor>
     bool copy_to_tensor(const Protobuf_tensor &tensor) const;
 
-    template<Data_type dt, typename Protobuf_tensor>
+    template<Data_type src, Data_type dst, typename Protobuf_tensor>
     bool append_to_builder(const Protobuf_tensor &tensor) const;
 
+    bool report_overflow() const;
+
     Decoder_state *state_;
+    Sparse_tensor_builder_list *sparse_tensor_builders_;
     const Instance *instance_{};
     std::size_t row_idx_{};
     std::size_t attr_idx_{};
     const Attribute *attr_{};
 };
 
-Recordio_protobuf_reader::Recordio_protobuf_reader(Data_reader_params params)
-    : Parallel_data_reader{std::move(params)}
-{}
+Recordio_protobuf_reader::Recordio_protobuf_reader(Data_reader_params params,
+                                                   Recordio_protobuf_params rp_params)
+    : Parallel_data_reader{std::move(params)}, rp_params_{std::move(rp_params)}
+{
+    Data_type dt = rp_params_.float32_data_type;
+    if (dt != Data_type::float32 && !detail::can_narrow(Data_type::float32, dt)) {
+        throw std::invalid_argument{
+            "The float32 features can only be read as float32, float16, or bfloat16."};
+    }
+
+    constexpr std::size_t max_hash_dimension = 0x8000'0000;
+
+    for (auto &[name, dim] : rp_params_.hash_dimensions) {
+        if (dim == 0 || dim > max_hash_dimension) {
+            throw std::invalid_argument{fmt::format(
+                "The hash dimension of the feature '{0}' must be between 1 and 2^31.", name)};
+        }
+    }
+}
 
 Recordio_protobuf_reader::~Recordio_protobuf_reader()
 {
@@ -119,7 +271,8 @@ Recordio_protobuf_reader::~Recordio_protobuf_reader()
 
 Intrusive_ptr<Record_reader> Recordio_protobuf_reader::make_record_reader(const Data_store &store)
 {
-    return make_intrusive<detail::Recordio_record_reader>(store.open_read());
+    return make_intrusive<detail::Recordio_record_reader>(
+        store.open_read(), params().bad_example_handling, store.id());
 }
 
 Intrusive_ptr<const Schema>
@@ -139,6 +292,12 @@ Recordio_protobuf_reader::infer_schema(const std::optional<Instance> &instance)
 
     std::vector<Attribute> attrs{};
 
+    source_data_types_.clear();
+
+    hash_dimensions_.clear();
+
+    std::size_t num_labels = proto_msg->label().size();
+
     for (auto &[label, value] : proto_msg->label()) {
         // The label and feature maps of a RecordIO-protobuf message can
         // contain same-named features. In order to avoid name clashes
@@ -151,6 +310,36 @@ Recordio_protobuf_reader::infer_schema(const std::optional<Instance> &instance)
 
     auto schema = make_intrusive<Schema>(std::move(attrs));
 
+    // Throw an error if there are data types for unknown features.
+    std::vector<std::string> leftover_names{};
+    for (auto &pr : rp_params_.data_types) {
+        if (schema->get_index(pr.first) == std::nullopt) {
+            leftover_names.emplace_back(pr.first);
+        }
+    }
+
+    if (!leftover_names.empty()) {
+        throw std::invalid_argument{fmt::format(
+            "The data types cannot be set. The following features are not found in the dataset: {0}",
+            fmt::join(leftover_names, ", "))};
+    }
+
+    for (auto &pr : rp_params_.hash_dimensions) {
+        if (schema->get_index(pr.first) == std::nullopt) {
+            leftover_names.emplace_back(pr.first);
+        }
+    }
+
+    if (!leftover_names.empty()) {
+        throw std::invalid_argument{fmt::format(
+            "The hash dimensions cannot be set. The following features are not found in the dataset: {0}",
+            fmt::join(leftover_names, ", "))};
+    }
+
+    init_attribute_indices(*schema, num_labels);
+
+    nnz_per_row_estimates_ = std::vector<std::atomic_size_t>(schema->attributes().size());
+
     // We use this value in the decode function to decide whether the
     // amount of data we need to process is worth to parallelize.
     for (const Attribute &attr : schema->attributes()) {
@@ -200,7 +389,24 @@ Attribute Recordio_protobuf_reader::make_attribute(const Instance &instance,
 
     Size_vector shape{params().batch_size};
 
-    if (tensor.keys().empty()) {
+    std::size_t hash_dimension = 0;
+
+    auto hash_pos = rp_params_.hash_dimensions.find(name);
+    if (hash_pos != rp_params_.hash_dimensions.end()) {
+        if (tensor.keys().empty() && !tensor.values().empty()) {
+            throw std::invalid_argument{
+                fmt::format("The feature '{0}' is dense and cannot be hashed.", name)};
+        }
+
+        hash_dimension = hash_pos->second;
+
+        // The shape of the message is ignored; it might not even fit
+        // into 64 bits.
+        sparse = true;
+
+        shape.emplace_back(hash_dimension);
+    }
+    else if (tensor.keys().empty()) {
         if (tensor.shape().empty()) {
             // If both the shape and the key array are empty, we treat
             // the feature as a dense vector.
@@ -234,9 +440,36 @@ Attribute Recordio_protobuf_reader::make_attribute(const Instance &instance,
 
     if (sparse) {
         has_sparse_feature_ = true;
+
+        // We have no way to know the number of non-zero values of the
+        // subsequent instances; use the first one as an estimate when
+        // deciding whether to decode in parallel.
+        num_values_per_instance_ += static_cast<std::size_t>(tensor.keys_size());
     }
 
-    return Attribute{name, dt, std::move(shape), {}, sparse};
+    Data_type attr_dt = dt;
+
+    auto pos = rp_params_.data_types.find(name);
+    if (pos != rp_params_.data_types.end()) {
+        attr_dt = pos->second;
+    }
+    else if constexpr (dt == Data_type::float32) {
+        attr_dt = rp_params_.float32_data_type;
+    }
+
+    if (attr_dt != dt && !detail::can_narrow(dt, attr_dt)) {
+        throw std::invalid_argument{fmt::format(
+            "The feature '{0}' has the data type {1} which cannot be narrowed to {2}.",
+            name,
+            dt,
+            attr_dt)};
+    }
+
+    source_data_types_.emplace_back(dt);
+
+    hash_dimensions_.emplace_back(hash_dimension);
+
+    return Attribute{name, attr_dt, std::move(shape), {}, sparse};
 }
 
 template<typename Protobuf_tensor>
@@ -268,32 +501,16 @@ Intrusive_ptr<Example> Recordio_protobuf_reader::decode(const Instance_batch &ba
 
     std::size_t num_instances = batch.instances().size();
 
-    constexpr std::size_t cut_off = 10'000'000;
-
-    bool should_run_serial =
-        // If we have any sparse features, we cannot decode the example
-        // in parallel as we need to append each instance sequentially
-        // to the COO tensor.
-        has_sparse_feature_ ||
-        // If bad example handling mode is pad, we cannot parallelize
-        // decoding as good records must be stacked together without
-        // any gap in between.
-        params().bad_example_handling == Bad_example_handling::pad ||
-        params().bad_example_handling == Bad_example_handling::pad_warn ||
-        // If the number of values (e.g. integers, floating-points) we
-        // need to decode is below the cut-off threshold, avoid parallel
-        // execution; otherwise the threading overhead will potentially
-        // slow down the performance.
-        num_values_per_instance_ * num_instances < cut_off;
-
     std::optional<std::size_t> num_instances_read{};
-    if (should_run_serial) {
+    if (!should_decode_parallel(num_instances, num_values_per_instance_)) {
         num_instances_read = decode_serial(state, batch);
     }
     else {
         num_instances_read = decode_parallel(state, batch);
     }
 
+    report_decode_warnings(state.warnings);
+
     // Check if we failed to decode the example and return a null pointer
     // if that is the case.
     if (num_instances_read == std::nullopt) {
@@ -313,23 +530,22 @@ Intrusive_ptr<Example> Recordio_protobuf_reader::decode(const Instance_batch &ba
         }
     }
 
-    auto tsr_beg = state.tensors.begin();
-    auto tsr_end = state.tensors.end();
-
-    auto bld_beg = state.coo_tensor_builders.begin();
-    auto bld_end = state.coo_tensor_builders.end();
+    // The dense tensors are not zero-initialized; only the padding rows,
+    // including those of the bad instances, need to be zeroed.
+    state.zero_fill_padding(*num_instances_read);
 
-    auto ftr_beg = tbb::make_zip_iterator(tsr_beg, bld_beg);
-    auto ftr_end = tbb::make_zip_iterator(tsr_end, bld_end);
-
-    for (auto ftr_pos = ftr_beg; ftr_pos < ftr_end; ++ftr_pos) {
-        Intrusive_ptr<Tensor> &tensor = std::get<0>(*ftr_pos);
+    for (std::size_t i = 0; i < state.tensors.size(); i++) {
+        Intrusive_ptr<Tensor> &tensor = state.tensors[i];
 
         // If no tensor exists at the specified index, it means the
         // corresponding feature is sparse and we should build its
-        // COO tensor.
+        // sparse tensor.
         if (tensor == nullptr) {
-            tensor = std::get<1>(*ftr_pos)->build();
+            Sparse_tensor_builder &builder = *state.sparse_tensor_builders[i];
+
+            update_nnz_estimate(i, builder);
+
+            tensor = builder.build(tensor_pool());
         }
     }
 
@@ -361,6 +577,12 @@ Recordio_protobuf_reader::decode_serial(Decoder_state &state, const Instance_bat
                 params().bad_example_handling != Bad_example_handling::pad_warn) {
                 throw std::invalid_argument{"The specified bad example handling is invalid."};
             }
+
+            // The dense rows of the bad instance get overwritten by the
+            // next instance or zeroed as padding.
+            if (has_sparse_feature_) {
+                truncate_sparse_tensor_builders(state.sparse_tensor_builders, row_idx);
+            }
         }
     }
 
@@ -383,23 +605,81 @@ Recordio_protobuf_reader::decode_parallel(Decoder_state &state, const Instance_b
     auto range_beg = tbb::make_zip_iterator(instance_idx_beg, instance_beg);
     auto range_end = tbb::make_zip_iterator(instance_idx_end, instance_end);
 
-    tbb::blocked_range<decltype(range_beg)> range{range_beg, range_end};
+    tbb::blocked_range<decltype(range_beg)> range{
+        range_beg, range_end, decode_grain_size(num_values_per_instance_)};
+
+    // Sparse features cannot be appended to a shared sparse tensor builder
+    // out of order; therefore each task fills its own builders which we
+    // merge in row order once all tasks are done.
+    tbb::concurrent_vector<Sparse_row_range> sparse_row_ranges{};
+
+    bool pad = params().bad_example_handling == Bad_example_handling::pad ||
+               params().bad_example_handling == Bad_example_handling::pad_warn;
+
+    // In pad mode each instance is decoded into the row of its position;
+    // the rows of the bad instances are compacted away once all tasks are
+    // done.
+    std::vector<char> decoded{};
+    if (pad) {
+        decoded.resize(num_instances);
+    }
+
+    std::atomic_size_t num_bad_instances{};
+
+    auto worker = [this,
+                   &state,
+                   &skip_example,
+                   &sparse_row_ranges,
+                   pad,
+                   &decoded,
+                   &num_bad_instances](auto &sub_range) {
+        Sparse_tensor_builder_list sparse_tensor_builders{};
+        if (has_sparse_feature_) {
+            sparse_tensor_builders = state.make_sparse_tensor_builders(sub_range.size());
+        }
+
+        // The number of rows appended to the sparse tensor builders of
+        // the task.
+        std::size_t num_rows = 0;
 
-    auto worker = [this, &state, &skip_example](auto &sub_range) {
         for (auto instance_zip : sub_range) {
-            Decoder decoder{state};
-            if (!decoder.decode(std::get<0>(instance_zip), std::get<1>(instance_zip))) {
-                // If we failed to decode the instance, we can terminate
-                // the task right away and skip this example.
-                if (params().bad_example_handling == Bad_example_handling::skip ||
-                    params().bad_example_handling == Bad_example_handling::skip_warn) {
-                    skip_example = true;
-
-                    return;
+            std::size_t row_idx = std::get<0>(instance_zip);
+
+            Decoder decoder{state, sparse_tensor_builders};
+            if (decoder.decode(row_idx, std::get<1>(instance_zip))) {
+                if (pad) {
+                    decoded[row_idx] = 1;
                 }
 
+                num_rows++;
+
+                continue;
+            }
+
+            // If we failed to decode the instance, we can terminate the
+            // task right away and skip this example.
+            if (params().bad_example_handling == Bad_example_handling::skip ||
+                params().bad_example_handling == Bad_example_handling::skip_warn) {
+                skip_example = true;
+
+                return;
+            }
+
+            if (!pad) {
                 throw std::invalid_argument{"The specified bad example handling is invalid."};
             }
+
+            if (has_sparse_feature_) {
+                truncate_sparse_tensor_builders(sparse_tensor_builders, num_rows);
+            }
+
+            num_bad_instances.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (has_sparse_feature_) {
+            std::size_t first_row_idx = std::get<0>(*sub_range.begin());
+
+            sparse_row_ranges.push_back({first_row_idx, std::move(sparse_tensor_builders)});
         }
     };
 
@@ -409,7 +689,107 @@ Recordio_protobuf_reader::decode_parallel(Decoder_state &state, const Instance_b
         return {};
     }
 
-    return num_instances;
+    if (has_sparse_feature_) {
+        state.merge_sparse_tensor_builders(sparse_row_ranges);
+    }
+
+    if (num_bad_instances == 0) {
+        return num_instances;
+    }
+
+    // The sparse tensor builders of the tasks only hold the rows of the
+    // good instances, so only the dense tensors need to be compacted.
+    state.compact_rows(decoded);
+
+    return num_instances - num_bad_instances;
+}
+
+void Recordio_protobuf_reader::init_attribute_indices(const Schema &schema,
+                                                      std::size_t num_labels)
+{
+    const std::vector<Attribute> &attrs = schema.attributes();
+
+    // Keep the load factor at or below 1/2 so that the probes are short
+    // and always end at an empty slot.
+    std::size_t num_slots = 2;
+    while (num_slots < attrs.size() * 2) {
+        num_slots *= 2;
+    }
+
+    attr_slots_.assign(num_slots, Attribute_slot{});
+
+    std::size_t mask = num_slots - 1;
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        std::string_view name = attrs[i].name();
+
+        bool label = i < num_labels;
+        if (label) {
+            // Strip the "label_" prefix.
+            name = name.substr(6);
+        }
+
+        std::size_t h = hash_attribute_name(name, label);
+
+        std::size_t pos = h & mask;
+        while (attr_slots_[pos].index != 0) {
+            pos = (pos + 1) & mask;
+        }
+
+        attr_slots_[pos] = Attribute_slot{name, h, i + 1, label};
+    }
+}
+
+std::size_t
+Recordio_protobuf_reader::hash_attribute_name(std::string_view name, bool label) noexcept
+{
+    std::size_t h = std::hash<std::string_view>{}(name);
+
+    // Keep a label and a feature with the same name apart.
+    return label ? ~h : h;
+}
+
+std::optional<std::size_t>
+Recordio_protobuf_reader::get_attribute_index(std::string_view name, bool label) const
+{
+    if (attr_slots_.empty()) {
+        return {};
+    }
+
+    std::size_t h = hash_attribute_name(name, label);
+
+    std::size_t mask = attr_slots_.size() - 1;
+
+    for (std::size_t pos = h & mask;; pos = (pos + 1) & mask) {
+        const Attribute_slot &slot = attr_slots_[pos];
+        if (slot.index == 0) {
+            return {};
+        }
+
+        if (slot.hash == h && slot.label == label && slot.name == name) {
+            return slot.index - 1;
+        }
+    }
+}
+
+std::size_t Recordio_protobuf_reader::estimate_nnz(std::size_t attr_idx, std::size_t num_rows) const
+{
+    return nnz_per_row_estimates_[attr_idx].load(std::memory_order_relaxed) * num_rows;
+}
+
+void Recordio_protobuf_reader::update_nnz_estimate(std::size_t attr_idx,
+                                                   const Sparse_tensor_builder &builder) const
+{
+    std::size_t num_rows = builder.num_rows();
+    if (num_rows == 0) {
+        return;
+    }
+
+    // Round up so that a batch with the same density fits into the
+    // presized arrays without a reallocation.
+    std::size_t nnz_per_row = (builder.nnz() + num_rows - 1) / num_rows;
+
+    nnz_per_row_estimates_[attr_idx].store(nnz_per_row, std::memory_order_relaxed);
 }
 
 const aialgs::data::Record *Recordio_protobuf_reader::parse_proto(const Instance &instance)
@@ -429,19 +809,146 @@ Recordio_protobuf_reader::Decoder_state::Decoder_state(const Recordio_protobuf_r
     init_state(*r.schema(), batch_size);
 }
 
+Sparse_tensor_builder_list
+Recordio_protobuf_reader::Decoder_state::make_sparse_tensor_builders(std::size_t num_rows) const
+{
+    Sparse_tensor_builder_list builders{};
+    builders.reserve(sparse_tensor_builders.size());
+
+    const std::vector<Attribute> &attrs = reader->schema()->attributes();
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        if (attrs[i].sparse()) {
+            builders.emplace_back(make_sparse_tensor_builder(i, num_rows));
+        }
+        else {
+            builders.emplace_back(nullptr);
+        }
+    }
+
+    return builders;
+}
+
+std::unique_ptr<Sparse_tensor_builder>
+Recordio_protobuf_reader::Decoder_state::make_sparse_tensor_builder(std::size_t attr_idx,
+                                                                    std::size_t num_rows) const
+{
+    const Attribute &attr = reader->schema()->attributes()[attr_idx];
+
+    return detail::make_sparse_tensor_builder(attr,
+                                              num_rows,
+                                              reader->params().sparse_tensor_format,
+                                              reader->estimate_nnz(attr_idx, num_rows),
+                                              reader->hash_dimensions_[attr_idx]);
+}
+
+void Recordio_protobuf_reader::Decoder_state::merge_sparse_tensor_builders(
+    tbb::concurrent_vector<Sparse_row_range> &row_ranges)
+{
+    std::sort(row_ranges.begin(), row_ranges.end(), [](const auto &a, const auto &b) {
+        return a.first_row_idx < b.first_row_idx;
+    });
+
+    for (std::size_t i = 0; i < sparse_tensor_builders.size(); i++) {
+        Sparse_tensor_builder *builder = sparse_tensor_builders[i].get();
+        if (builder == nullptr) {
+            continue;
+        }
+
+        std::size_t nnz = builder->nnz();
+        for (Sparse_row_range &row_range : row_ranges) {
+            nnz += row_range.sparse_tensor_builders[i]->nnz();
+        }
+
+        builder->reserve(nnz);
+
+        for (Sparse_row_range &row_range : row_ranges) {
+            builder->merge(*row_range.sparse_tensor_builders[i]);
+        }
+    }
+}
+
+void Recordio_protobuf_reader::Decoder_state::compact_rows(const std::vector<char> &decoded)
+{
+    const std::vector<Attribute> &attrs = reader->schema()->attributes();
+
+    // The rows move towards the beginning of the tensor, so each tensor
+    // has to be compacted in order; the tensors are independent though.
+    auto compact_tensor = [this, &attrs, &decoded](std::size_t attr_idx) {
+        if (tensors[attr_idx] == nullptr) {
+            return;
+        }
+
+        auto &tensor = static_cast<Dense_tensor &>(*tensors[attr_idx]);
+
+        std::size_t element_size = dispatch<Element_size_op>(attrs[attr_idx].data_type());
+
+        std::size_t row_size = as_size(attrs[attr_idx].strides()[0]) * element_size;
+
+        auto *data = static_cast<std::byte *>(tensor.data().data());
+
+        std::size_t num_rows = 0;
+        for (std::size_t row_idx = 0; row_idx < decoded.size(); row_idx++) {
+            if (decoded[row_idx] == 0) {
+                continue;
+            }
+
+            if (row_idx != num_rows) {
+                std::memmove(data + num_rows * row_size, data + row_idx * row_size, row_size);
+            }
+
+            num_rows++;
+        }
+    };
+
+    if (tensors.size() > 1) {
+        tbb::parallel_for(std::size_t{0}, tensors.size(), compact_tensor);
+    }
+    else {
+        compact_tensor(0);
+    }
+}
+
+void Recordio_protobuf_reader::Decoder_state::zero_fill_padding(std::size_t num_rows)
+{
+    const std::vector<Attribute> &attrs = reader->schema()->attributes();
+
+    for (std::size_t i = 0; i < tensors.size(); i++) {
+        if (tensors[i] == nullptr) {
+            continue;
+        }
+
+        auto &tensor = static_cast<Dense_tensor &>(*tensors[i]);
+
+        std::size_t element_size = dispatch<Element_size_op>(attrs[i].data_type());
+
+        std::size_t row_size = as_size(attrs[i].strides()[0]) * element_size;
+
+        std::size_t size = tensor.data().size() * element_size;
+
+        std::size_t offset = std::min(num_rows * row_size, size);
+
+        auto *data = static_cast<std::byte *>(tensor.data().data());
+
+        std::fill(data + offset, data + size, std::byte{});
+    }
+}
+
 void Recordio_protobuf_reader::Decoder_state::init_state(const Schema &schema,
                                                          std::size_t batch_size)
 {
     tensors.reserve(schema.attributes().size());
 
-    coo_tensor_builders.reserve(schema.attributes().size());
+    sparse_tensor_builders.reserve(schema.attributes().size());
+
+    const std::vector<Attribute> &attrs = schema.attributes();
 
-    for (const Attribute &attr : schema.attributes()) {
-        if (attr.sparse()) {
-            init_coo_tensor_builder(attr, batch_size);
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        if (attrs[i].sparse()) {
+            init_sparse_tensor_builder(i, batch_size);
         }
         else {
-            init_tensor(attr, batch_size);
+            init_tensor(attrs[i], batch_size);
         }
     }
 }
@@ -451,7 +958,10 @@ void Recordio_protobuf_reader::Decoder_state::init_tensor(const Attribute &attr,
 {
     std::size_t data_size = batch_size * as_size(attr.strides()[0]);
 
-    std::unique_ptr<Device_array> arr = make_cpu_array(attr.data_type(), data_size);
+    // Every row is either overwritten by an instance or zeroed as padding;
+    // see zero_fill_padding().
+    std::unique_ptr<Device_array> arr =
+        reader->make_pooled_cpu_array(attr.data_type(), data_size, false);
 
     Size_vector shape = attr.shape();
 
@@ -463,26 +973,114 @@ void Recordio_protobuf_reader::Decoder_state::init_tensor(const Attribute &attr,
 
     tensors.emplace_back(std::move(tensor));
 
-    coo_tensor_builders.emplace_back(nullptr);
+    sparse_tensor_builders.emplace_back(nullptr);
 }
 
-void Recordio_protobuf_reader::Decoder_state::init_coo_tensor_builder(const Attribute &attr,
-                                                                      std::size_t batch_size)
+void Recordio_protobuf_reader::Decoder_state::init_sparse_tensor_builder(std::size_t attr_idx,
+                                                                         std::size_t batch_size)
 {
-    auto builder = make_coo_tensor_builder(attr, batch_size);
+    auto builder = make_sparse_tensor_builder(attr_idx, batch_size);
 
-    coo_tensor_builders.emplace_back(std::move(builder));
+    sparse_tensor_builders.emplace_back(std::move(builder));
 
     tensors.emplace_back(nullptr);
 }
 
 bool Recordio_protobuf_reader::Decoder::decode(std::size_t row_idx, const Instance &instance)
 {
+    detail::Allocation_scope scope{detail::Allocation_stage::protobuf};
+
     row_idx_ = row_idx;
 
     instance_ = &instance;
 
-    const aialgs::data::Record *proto_msg = parse_proto(instance);
+    // Try to decode the features straight from the wire representation
+    // of the message; this avoids allocating the feature maps and copying
+    // the tensor values into intermediate repeated fields.
+    std::vector<Protobuf_feature> &features = detail::features_;
+    if (Recordio_protobuf_scanner::scan(instance.bits(), features)) {
+        std::optional<bool> decoded = decode_features(features);
+        if (decoded) {
+            return *decoded;
+        }
+    }
+
+    // Otherwise fall back to the full protobuf parser, which also takes
+    // care of reporting corrupt messages.
+    return decode_message();
+}
+
+std::optional<bool>
+Recordio_protobuf_reader::Decoder::decode_features(const std::vector<Protobuf_feature> &features)
+{
+    std::vector<std::size_t> &attr_indices = detail::attr_indices_;
+    attr_indices.clear();
+
+    for (const Protobuf_feature &feature : features) {
+        std::optional<std::size_t> attr_idx = find_attribute(feature.name, feature.label);
+        if (attr_idx == std::nullopt) {
+            return false;
+        }
+
+        attr_indices.emplace_back(*attr_idx);
+    }
+
+    const auto &attrs = state_->reader->schema()->attributes();
+
+    std::vector<bool> &seen_attrs = detail::seen_attrs_;
+    seen_attrs.assign(attrs.size(), false);
+
+    for (std::size_t attr_idx : attr_indices) {
+        // If a feature occurs more than once, the last occurrence wins;
+        // let the full parser take care of merging them.
+        if (seen_attrs[attr_idx]) {
+            return {};
+        }
+
+        seen_attrs[attr_idx] = true;
+    }
+
+    auto ftr_beg = tbb::make_zip_iterator(features.begin(), attr_indices.begin());
+    auto ftr_end = tbb::make_zip_iterator(features.end(), attr_indices.end());
+
+    for (auto ftr_pos = ftr_beg; ftr_pos < ftr_end; ++ftr_pos) {
+        attr_idx_ = std::get<1>(*ftr_pos);
+
+        attr_ = &attrs[attr_idx_];
+
+        if (!decode_feature(std::get<0>(*ftr_pos))) {
+            return false;
+        }
+    }
+
+    return check_num_features(features.size());
+}
+
+bool Recordio_protobuf_reader::Decoder::decode_feature(const Protobuf_feature &feature)
+{
+    switch (feature.type) {
+    case Protobuf_value_type::float32:
+        return decode_feature<Data_type::float32>(feature.tensor);
+
+    case Protobuf_value_type::float64:
+        return decode_feature<Data_type::float64>(feature.tensor);
+
+    case Protobuf_value_type::int32:
+        return decode_feature<Data_type::int32>(feature.tensor);
+
+    case Protobuf_value_type::bytes:
+    case Protobuf_value_type::none:
+        break;
+    }
+
+    report_unexpected_data_type();
+
+    return false;
+}
+
+bool Recordio_protobuf_reader::Decoder::decode_message()
+{
+    const aialgs::data::Record *proto_msg = parse_proto(*instance_);
     if (proto_msg == nullptr) {
         return false;
     }
@@ -490,20 +1088,25 @@ bool Recordio_protobuf_reader::Decoder::decode(std::size_t row_idx, const Instan
     std::size_t num_features_read = 0;
 
     for (auto &[label, value] : proto_msg->label()) {
-        if (!decode_feature("label_" + label, value)) {
+        if (!decode_feature(label, true, value)) {
             return false;
         }
 
         num_features_read++;
     }
     for (auto &[label, value] : proto_msg->features()) {
-        if (!decode_feature(label, value)) {
+        if (!decode_feature(label, false, value)) {
             return false;
         }
 
         num_features_read++;
     }
 
+    return check_num_features(num_features_read);
+}
+
+bool Recordio_protobuf_reader::Decoder::check_num_features(std::size_t num_features_read) const
+{
     const auto &schema = state_->reader->schema();
 
     // Make sure that we read all features for which we have an
@@ -512,22 +1115,17 @@ bool Recordio_protobuf_reader::Decoder::decode(std::size_t row_idx, const Instan
         return true;
     }
 
-    if (state_->warn_bad_instance || state_->error_bad_example) {
-        auto msg = fmt::format(
-            "The instance #{1:n} in the data store '{0}' has {2:n} feature(s) while it is expected to have {3:n} features.",
-            instance_->data_store().id(),
-            instance_->index(),
-            num_features_read,
-            schema->attributes().size());
-
-        if (state_->warn_bad_instance) {
-            logger::warn(msg);
-        }
-
-        if (state_->error_bad_example) {
-            throw Invalid_instance_error{msg};
-        }
-    }
+    report_bad_instance(
+        detail::Decode_warning_kind::field_count_mismatch,
+        detail::Decode_warning::no_column,
+        [i = instance_, num_features_read, num_attrs = schema->attributes().size()]() {
+            return fmt::format(
+                "The instance #{1:n} in the data store '{0}' has {2:n} feature(s) while it is expected to have {3:n} features.",
+                i->data_store().id(),
+                i->index(),
+                num_features_read,
+                num_attrs);
+        });
 
     return false;
 }
@@ -540,53 +1138,31 @@ Recordio_protobuf_reader::Decoder::parse_proto(const Instance &instance) const
         return proto_msg;
     }
 
-    if (state_->warn_bad_instance || state_->error_bad_example) {
-        auto msg = fmt::format(
-            "The instance #{1:n} in the data store '{0}' contains a corrupt RecordIO-protobuf message.",
-            instance_->data_store().id(),
-            instance_->index());
-
-        if (state_->warn_bad_instance) {
-            logger::warn(msg);
-        }
-
-        if (state_->error_bad_example) {
-            throw Invalid_instance_error{msg};
-        }
-    }
+    report_bad_instance(
+        detail::Decode_warning_kind::corrupt_record,
+        detail::Decode_warning::no_column,
+        [i = instance_]() {
+            return fmt::format(
+                "The instance #{1:n} in the data store '{0}' contains a corrupt RecordIO-protobuf message.",
+                i->data_store().id(),
+                i->index());
+        });
 
     return nullptr;
 }
 
-bool Recordio_protobuf_reader::Decoder::decode_feature(const std::string &name,
+bool Recordio_protobuf_reader::Decoder::decode_feature(std::string_view name,
+                                                       bool label,
                                                        const aialgs::data::Value &value)
 {
-    const auto &schema = state_->reader->schema();
-
-    std::optional<std::size_t> attr_idx = schema->get_index(name);
+    std::optional<std::size_t> attr_idx = find_attribute(name, label);
     if (attr_idx == std::nullopt) {
-        if (state_->warn_bad_instance || state_->error_bad_example) {
-            auto msg = fmt::format(
-                "The instance #{1:n} in the data store '{0}' has an unknown feature named '{2}'.",
-                instance_->data_store().id(),
-                instance_->index(),
-                name);
-
-            if (state_->warn_bad_instance) {
-                logger::warn(msg);
-            }
-
-            if (state_->error_bad_example) {
-                throw Invalid_instance_error{msg};
-            }
-        }
-
         return false;
     }
 
     attr_idx_ = *attr_idx;
 
-    attr_ = &schema->attributes()[attr_idx_];
+    attr_ = &state_->reader->schema()->attributes()[attr_idx_];
 
     switch (value.value_case()) {
     case aialgs::data::Value::ValueCase::kFloat32Tensor:
@@ -603,113 +1179,188 @@ bool Recordio_protobuf_reader::Decoder::decode_feature(const std::string &name,
         break;
     }
 
+    report_unexpected_data_type();
+
+    return false;
+}
+
+std::optional<std::size_t>
+Recordio_protobuf_reader::Decoder::find_attribute(std::string_view name, bool label) const
+{
+    std::optional<std::size_t> attr_idx = state_->reader->get_attribute_index(name, label);
+    if (attr_idx != std::nullopt) {
+        return attr_idx;
+    }
+
+    // The name refers to the thread-local message; copy it.
+    std::string name_copy{};
     if (state_->warn_bad_instance || state_->error_bad_example) {
-        auto msg = fmt::format(
-            "The feature '{2}' of the instance #{1:n} in the data store '{0}' has an unexpected data type.",
-            instance_->data_store().id(),
-            instance_->index(),
-            attr_->name());
+        name_copy = name;
+    }
 
-        if (state_->warn_bad_instance) {
-            logger::warn(msg);
-        }
+    report_bad_instance(
+        detail::Decode_warning_kind::schema_mismatch,
+        detail::Decode_warning::no_column,
+        [i = instance_, label, name = std::move(name_copy)]() {
+            return fmt::format(
+                "The instance #{1:n} in the data store '{0}' has an unknown feature named '{2}{3}'.",
+                i->data_store().id(),
+                i->index(),
+                label ? "label_" : "",
+                name);
+        });
 
-        if (state_->error_bad_example) {
-            throw Invalid_instance_error{msg};
-        }
+    return {};
+}
+
+void Recordio_protobuf_reader::Decoder::report_unexpected_data_type() const
+{
+    report_bad_instance(
+        detail::Decode_warning_kind::schema_mismatch, attr_idx_, [i = instance_, a = attr_]() {
+            return fmt::format(
+                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has an unexpected data type.",
+                i->data_store().id(),
+                i->index(),
+                a->name());
+        });
+}
+
+template<typename Format_fn>
+void Recordio_protobuf_reader::Decoder::report_bad_instance(detail::Decode_warning_kind kind,
+                                                            std::size_t attr_idx,
+                                                            Format_fn &&format_message) const
+{
+    if (state_->error_bad_example) {
+        throw Invalid_instance_error{format_message()};
     }
 
-    return false;
+    // The message is formatted later, outside of the decode loop, and
+    // only if it gets logged.
+    detail::Decode_warning warning{kind, instance_, attr_idx};
+    if (state_->warn_bad_instance) {
+        warning.format_message = std::forward<Format_fn>(format_message);
+    }
+
+    state_->warnings.add(std::move(warning));
 }
 
 template<Data_type dt, typename Protobuf_tensor>
 bool Recordio_protobuf_reader::Decoder::decode_feature(const Protobuf_tensor &tensor)
 {
-    if (attr_->data_type() != dt) {
-        if (state_->warn_bad_instance || state_->error_bad_example) {
-            auto msg = fmt::format(
-                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has the data type {3} while it is expected to have the data type {4}.",
-                instance_->data_store().id(),
-                instance_->index(),
-                attr_->name(),
-                dt,
-                attr_->data_type());
-
-            if (state_->warn_bad_instance) {
-                logger::warn(msg);
-            }
-
-            if (state_->error_bad_example) {
-                throw Invalid_instance_error{msg};
-            }
-        }
+    Data_type source_dt = state_->reader->source_data_types_[attr_idx_];
+
+    if (source_dt != dt) {
+        report_bad_instance(
+            detail::Decode_warning_kind::schema_mismatch,
+            attr_idx_,
+            [i = instance_, a = attr_, source_dt]() {
+                return fmt::format(
+                    "The feature '{2}' of the instance #{1:n} in the data store '{0}' has the data type {3} while it is expected to have the data type {4}.",
+                    i->data_store().id(),
+                    i->index(),
+                    a->name(),
+                    dt,
+                    source_dt);
+            });
 
         return false;
     }
 
     if (is_sparse(tensor) != attr_->sparse()) {
-        if (state_->warn_bad_instance || state_->error_bad_example) {
-            const char *ft{};
-            if (attr_->sparse()) {
-                ft =
-                    "The feature '{2}' of the instance #{1:n} in the data store '{0}' is sparse while it is expected to be dense.";
-            }
-            else {
-                ft =
-                    "The feature '{2}' of the instance #{1:n} in the data store '{0}' is dense while it is expected to be sparse.";
-            }
-            auto msg =
-                fmt::format(ft, instance_->data_store().id(), instance_->index(), attr_->name());
-
-            if (state_->warn_bad_instance) {
-                logger::warn(msg);
-            }
-
-            if (state_->error_bad_example) {
-                throw Invalid_instance_error{msg};
-            }
-        }
+        report_bad_instance(
+            detail::Decode_warning_kind::schema_mismatch, attr_idx_, [i = instance_, a = attr_]() {
+                const char *ft{};
+                if (a->sparse()) {
+                    ft =
+                        "The feature '{2}' of the instance #{1:n} in the data store '{0}' is sparse while it is expected to be dense.";
+                }
+                else {
+                    ft =
+                        "The feature '{2}' of the instance #{1:n} in the data store '{0}' is dense while it is expected to be sparse.";
+                }
+                return fmt::format(ft, i->data_store().id(), i->index(), a->name());
+            });
 
         return false;
     }
 
     if (!shape_equals(tensor)) {
+        // The tensor refers to the thread-local message; copy its shape.
+        Size_vector tensor_shape{};
         if (state_->warn_bad_instance || state_->error_bad_example) {
-            std::string shape_str;
             if (tensor.shape().empty()) {
-                shape_str = fmt::to_string(tensor.values_size());
+                tensor_shape.emplace_back(as_size(tensor.values_size()));
             }
             else {
-                shape_str = fmt::format("{0}", fmt::join(tensor.shape(), ", "));
+                tensor_shape.assign(tensor.shape().begin(), tensor.shape().end());
             }
+        }
 
-            const Size_vector &shape = attr_->shape();
+        report_bad_instance(
+            detail::Decode_warning_kind::schema_mismatch,
+            attr_idx_,
+            [i = instance_, a = attr_, tensor_shape = std::move(tensor_shape)]() {
+                const Size_vector &shape = a->shape();
+
+                return fmt::format(
+                    "The feature '{2}' of the instance #{1:n} in the data store '{0}' has the shape ({3}) while it is expected to have the shape ({4}).",
+                    i->data_store().id(),
+                    i->index(),
+                    a->name(),
+                    fmt::join(tensor_shape, ", "),
+                    fmt::join(shape.begin() + 1, shape.end(), ", "));
+            });
 
-            auto msg = fmt::format(
-                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has the shape ({3}) while it is expected to have the shape ({4}).",
-                instance_->data_store().id(),
-                instance_->index(),
-                attr_->name(),
-                shape_str,
-                fmt::join(shape.begin() + 1, shape.end(), ", "));
+        return false;
+    }
 
-            if (state_->warn_bad_instance) {
-                logger::warn(msg);
-            }
+    // The schema only allows the combinations supported by can_narrow().
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
 
-            if (state_->error_bad_example) {
-                throw Invalid_instance_error{msg};
-            }
+    switch (attr_->data_type()) {
+    case Data_type::float32:
+        if constexpr (dt == Data_type::float64) {
+            return store_values<dt, Data_type::float32>(tensor);
         }
-
-        return false;
+        break;
+    case Data_type::float16:
+        if constexpr (dt == Data_type::float32 || dt == Data_type::float64) {
+            return store_values<dt, Data_type::float16>(tensor);
+        }
+        break;
+    case Data_type::bfloat16:
+        if constexpr (dt == Data_type::float32 || dt == Data_type::float64) {
+            return store_values<dt, Data_type::bfloat16>(tensor);
+        }
+        break;
+    case Data_type::int8:
+        if constexpr (dt == Data_type::int32) {
+            return store_values<dt, Data_type::int8>(tensor);
+        }
+        break;
+    case Data_type::int16:
+        if constexpr (dt == Data_type::int32) {
+            return store_values<dt, Data_type::int16>(tensor);
+        }
+        break;
+    default:
+        break;
     }
 
+#pragma GCC diagnostic pop
+
+    return store_values<dt, dt>(tensor);
+}
+
+template<Data_type src, Data_type dst, typename Protobuf_tensor>
+bool Recordio_protobuf_reader::Decoder::store_values(const Protobuf_tensor &tensor) const
+{
     if (attr_->sparse()) {
-        return append_to_builder<dt>(tensor);
+        return append_to_builder<src, dst>(tensor);
     }
 
-    return copy_to_tensor<dt>(tensor);
+    return copy_to_tensor<src, dst>(tensor);
 }
 
 template<typename Protobuf_tensor>
@@ -757,7 +1408,7 @@ bool Recordio_protobuf_reader::Decoder::shape_equals(const Protobuf_tensor &tens
     return true;
 }
 
-template<Data_type dt, typename Protobuf_tensor>
+template<Data_type src, Data_type dst, typename Protobuf_tensor>
 bool Recordio_protobuf_reader::Decoder::copy_to_tensor(const Protobuf_tensor &tensor) const
 {
     // The stride of the batch dimension.
@@ -789,16 +1440,18 @@ bool Recordio_protobuf_reader::Decoder::copy_to_tensor(const Protobuf_tensor &te
 
     auto &tsr = static_cast<Dense_tensor &>(*state_->tensors[attr_idx_]);
 
-    auto destination = tsr.data().as<data_type_t<dt>>();
+    auto destination = tsr.data().as<data_type_t<dst>>();
 
     std::ptrdiff_t offset = as_ssize(row_idx_) * num_values;
 
-    std::copy_n(tensor.values().begin(), num_values, destination.begin() + offset);
+    if (!detail::copy_values<src, dst>(tensor, destination.data() + offset)) {
+        return report_overflow();
+    }
 
     return true;
 }
 
-template<Data_type dt, typename Protobuf_tensor>
+template<Data_type src, Data_type dst, typename Protobuf_tensor>
 bool Recordio_protobuf_reader::Decoder::append_to_builder(const Protobuf_tensor &tensor) const
 {
     if (tensor.keys_size() != tensor.values_size()) {
@@ -824,9 +1477,36 @@ bool Recordio_protobuf_reader::Decoder::append_to_builder(const Protobuf_tensor
     }
 
     auto &builder =
-        static_cast<Coo_tensor_builder_impl<dt> &>(*state_->coo_tensor_builders[attr_idx_]);
+        static_cast<Sparse_tensor_builder_impl<dst> &>(*(*sparse_tensor_builders_)[attr_idx_]);
+
+    bool appended{};
+    if constexpr (std::is_same_v<Protobuf_tensor, Protobuf_tensor_view>) {
+        auto &values = detail::sparse_values_<data_type_t<dst>>;
+        values.resize(as_size(tensor.values_size()));
+        if (!detail::copy_values<src, dst>(tensor, values.data())) {
+            return report_overflow();
+        }
 
-    if (builder.append(tensor.values(), tensor.keys())) {
+        auto &keys = detail::sparse_keys_;
+        keys.resize(as_size(tensor.keys_size()));
+        tensor.copy_keys(keys.data());
+
+        appended = builder.append(values, keys);
+    }
+    else if constexpr (src != dst) {
+        auto &values = detail::sparse_values_<data_type_t<dst>>;
+        values.resize(as_size(tensor.values_size()));
+        if (!detail::copy_values<src, dst>(tensor, values.data())) {
+            return report_overflow();
+        }
+
+        appended = builder.append(values, tensor.keys());
+    }
+    else {
+        appended = builder.append(tensor.values(), tensor.keys());
+    }
+
+    if (appended) {
         return true;
     }
 
@@ -849,5 +1529,20 @@ bool Recordio_protobuf_reader::Decoder::append_to_builder(const Protobuf_tensor
     return false;
 }
 
+bool Recordio_protobuf_reader::Decoder::report_overflow() const
+{
+    report_bad_instance(
+        detail::Decode_warning_kind::overflow, attr_idx_, [i = instance_, a = attr_]() {
+            return fmt::format(
+                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has one or more values that do not fit into {3}.",
+                i->data_store().id(),
+                i->index(),
+                a->name(),
+                a->data_type());
+        });
+
+    return false;
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -0,0 +1,336 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/recordio_protobuf_scanner.h"
+
+#include "mlio/detail/protobuf_wire.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/string.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The field numbers as defined in recordio_protobuf.proto.
+constexpr std::uint32_t record_features = 1;
+constexpr std::uint32_t record_label = 2;
+
+constexpr std::uint32_t map_entry_key = 1;
+constexpr std::uint32_t map_entry_value = 2;
+
+constexpr std::uint32_t value_float32_tensor = 2;
+constexpr std::uint32_t value_float64_tensor = 3;
+constexpr std::uint32_t value_int32_tensor = 7;
+constexpr std::uint32_t value_bytes = 9;
+
+constexpr std::uint32_t tensor_values = 1;
+constexpr std::uint32_t tensor_keys = 2;
+constexpr std::uint32_t tensor_shape = 3;
+
+}  // namespace
+
+std::uint64_t Varint_iterator::operator*() const noexcept
+{
+    std::uint64_t value = 0;
+
+    const std::byte *pos = pos_;
+    for (std::size_t i = 0;; i++) {
+        std::byte b = *pos++;
+
+        value |= (std::to_integer<std::uint64_t>(b) & 0x7F) << (7 * i);
+
+        if (!has_continuation_bit(b)) {
+            return value;
+        }
+    }
+}
+
+Varint_iterator &Varint_iterator::operator++() noexcept
+{
+    while (has_continuation_bit(*pos_++)) {
+    }
+
+    return *this;
+}
+
+std::size_t Packed_varint_range::size() const noexcept
+{
+    std::size_t count = 0;
+    for (std::byte b : bits_) {
+        if (!has_continuation_bit(b)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool Recordio_protobuf_scanner::scan(Memory_span bits, std::vector<Protobuf_feature> &features)
+{
+    features.clear();
+
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        if (field_number != record_features && field_number != record_label) {
+            // Skip the uid, metadata, and configuration fields.
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span entry_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(entry_bits)) {
+            return false;
+        }
+
+        Protobuf_feature &feature = features.emplace_back();
+
+        feature.label = field_number == record_label;
+
+        if (!scan_map_entry(entry_bits, feature)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Recordio_protobuf_scanner::scan_map_entry(Memory_span bits, Protobuf_feature &feature)
+{
+    Wire_reader reader{bits};
+
+    bool has_value = false;
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        if (field_number != map_entry_key && field_number != map_entry_value) {
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span field_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(field_bits)) {
+            return false;
+        }
+
+        if (field_number == map_entry_key) {
+            feature.name = as_string_view(field_bits);
+        }
+        else {
+            // A repeated value would have to be merged into the former
+            // one; leave that to the full parser.
+            if (has_value) {
+                return false;
+            }
+
+            has_value = true;
+
+            if (!scan_value(field_bits, feature)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Recordio_protobuf_scanner::scan_value(Memory_span bits, Protobuf_feature &feature)
+{
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        Protobuf_value_type type{};
+        switch (field_number) {
+        case value_float32_tensor:
+            type = Protobuf_value_type::float32;
+            break;
+
+        case value_float64_tensor:
+            type = Protobuf_value_type::float64;
+            break;
+
+        case value_int32_tensor:
+            type = Protobuf_value_type::int32;
+            break;
+
+        case value_bytes:
+            type = Protobuf_value_type::bytes;
+            break;
+
+        default:
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        // The oneof field must be set exactly once.
+        if (feature.type != Protobuf_value_type::none) {
+            return false;
+        }
+
+        feature.type = type;
+
+        Memory_span field_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(field_bits)) {
+            return false;
+        }
+
+        // We do not support the binary data format; there is no need to
+        // scan it.
+        if (type == Protobuf_value_type::bytes) {
+            continue;
+        }
+
+        if (!scan_tensor(field_bits, feature)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Recordio_protobuf_scanner::scan_tensor(Memory_span bits, Protobuf_feature &feature)
+{
+    Protobuf_tensor_view &tensor = feature.tensor;
+
+    bool has_values = false;
+    bool has_keys = false;
+    bool has_shape = false;
+
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        bool *has_field{};
+        switch (field_number) {
+        case tensor_values:
+            has_field = &has_values;
+            break;
+
+        case tensor_keys:
+            has_field = &has_keys;
+            break;
+
+        case tensor_shape:
+            has_field = &has_shape;
+            break;
+
+        default:
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        // Unpacked or split repeated fields are valid, but are not
+        // emitted by any RecordIO-protobuf writer we know of.
+        if (*has_field || wire_type != Wire_type::length_delimited) {
+            return false;
+        }
+
+        *has_field = true;
+
+        Memory_span field_bits{};
+        if (!reader.read_length_delimited(field_bits)) {
+            return false;
+        }
+
+        std::ptrdiff_t num_shape_dims{};
+
+        switch (field_number) {
+        case tensor_values:
+            tensor.values_ = field_bits;
+
+            switch (feature.type) {
+            case Protobuf_value_type::float32:
+                if (field_bits.size() % sizeof(float) != 0) {
+                    return false;
+                }
+                tensor.num_values_ = as_ssize(field_bits.size() / sizeof(float));
+                break;
+
+            case Protobuf_value_type::float64:
+                if (field_bits.size() % sizeof(double) != 0) {
+                    return false;
+                }
+                tensor.num_values_ = as_ssize(field_bits.size() / sizeof(double));
+                break;
+
+            case Protobuf_value_type::int32:
+                if (!count_varints(field_bits, tensor.num_values_)) {
+                    return false;
+                }
+                break;
+
+            case Protobuf_value_type::none:
+            case Protobuf_value_type::bytes:
+                return false;
+            }
+            break;
+
+        case tensor_keys:
+            tensor.keys_ = field_bits;
+
+            if (!count_varints(field_bits, tensor.num_keys_)) {
+                return false;
+            }
+            break;
+
+        default:
+            tensor.shape_ = field_bits;
+
+            if (!count_varints(field_bits, num_shape_dims)) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "mlio/endian.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Iterates over the values of a packed repeated varint field. The
+/// field must have been validated beforehand.
+class Varint_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::uint64_t *;
+    using reference = std::uint64_t;
+
+    Varint_iterator() noexcept = default;
+
+    explicit Varint_iterator(const std::byte *pos) noexcept : pos_{pos}
+    {}
+
+    std::uint64_t operator*() const noexcept;
+
+    Varint_iterator &operator++() noexcept;
+
+    Varint_iterator operator++(int) noexcept
+    {
+        Varint_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const Varint_iterator &other) const noexcept
+    {
+        return pos_ == other.pos_;
+    }
+
+    bool operator!=(const Varint_iterator &other) const noexcept
+    {
+        return pos_ != other.pos_;
+    }
+
+private:
+    const std::byte *pos_{};
+};
+
+class Packed_varint_range {
+public:
+    Packed_varint_range() noexcept = default;
+
+    explicit Packed_varint_range(Memory_span bits) noexcept : bits_{bits}
+    {}
+
+    std::size_t size() const noexcept;
+
+    bool empty() const noexcept
+    {
+        return bits_.empty();
+    }
+
+    Varint_iterator begin() const noexcept
+    {
+        return Varint_iterator{bits_.data()};
+    }
+
+    Varint_iterator end() const noexcept
+    {
+        return Varint_iterator{bits_.data() + bits_.size()};
+    }
+
+private:
+    Memory_span bits_{};
+};
+
+enum class Protobuf_value_type { none, float32, float64, int32, bytes };
+
+/// Represents a Float32Tensor, Float64Tensor, or Int32Tensor message
+/// as views into the packed fields of its wire representation. Mirrors
+/// the accessors of the protoc-generated tensor messages that are used
+/// while decoding.
+class Protobuf_tensor_view {
+    friend class Recordio_protobuf_scanner;
+
+public:
+    /// Returns the raw little-endian or varint encoded values.
+    Memory_span values() const noexcept
+    {
+        return values_;
+    }
+
+    Packed_varint_range keys() const noexcept
+    {
+        return Packed_varint_range{keys_};
+    }
+
+    Packed_varint_range shape() const noexcept
+    {
+        return Packed_varint_range{shape_};
+    }
+
+    std::ptrdiff_t values_size() const noexcept
+    {
+        return num_values_;
+    }
+
+    std::ptrdiff_t keys_size() const noexcept
+    {
+        return num_keys_;
+    }
+
+    /// Copies the values to the specified destination, converting them
+    /// to the host byte order. @p T must match the type of the tensor.
+    template<typename T>
+    void copy_values(T *destination) const noexcept;
+
+    void copy_keys(std::uint64_t *destination) const noexcept
+    {
+        std::copy(keys().begin(), keys().end(), destination);
+    }
+
+private:
+    Memory_span values_{};
+    Memory_span keys_{};
+    Memory_span shape_{};
+    std::ptrdiff_t num_values_{};
+    std::ptrdiff_t num_keys_{};
+};
+
+template<typename T>
+void Protobuf_tensor_view::copy_values(T *destination) const noexcept
+{
+    if constexpr (std::is_integral_v<T>) {
+        for (std::uint64_t value : Packed_varint_range{values_}) {
+            // Negative int32 values are sign-extended to 64-bit on the
+            // wire; truncating restores the original value.
+            *destination++ = static_cast<T>(value);
+        }
+    }
+    else {
+        little_to_host_order(values_, stdx::span<T>{destination, values_.size() / sizeof(T)});
+    }
+}
+
+struct Protobuf_feature {
+    std::string_view name{};
+    bool label{};
+    Protobuf_value_type type{};
+    Protobuf_tensor_view tensor{};
+};
+
+/// Scans the wire representation of an aialgs.data.Record message and
+/// locates its features and labels without materializing the message.
+///
+/// The scanner only handles the encoding emitted by protobuf writers
+/// in practice; anything else (unpacked repeated fields, duplicated
+/// fields that would have to be merged, groups) as well as malformed
+/// input is rejected, in which case the caller should fall back to the
+/// protoc-generated parser.
+class Recordio_protobuf_scanner {
+public:
+    /// Returns false if the message cannot be handled by the scanner.
+    static bool scan(Memory_span bits, std::vector<Protobuf_feature> &features);
+
+private:
+    static bool scan_map_entry(Memory_span bits, Protobuf_feature &feature);
+
+    static bool scan_value(Memory_span bits, Protobuf_feature &feature);
+
+    static bool scan_tensor(Memory_span bits, Protobuf_feature &feature);
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,712 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/recordio_protobuf_writer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/data_type.h"
+#include "mlio/detail/error.h"
+#include "mlio/device_array.h"
+#include "mlio/endian.h"
+#include "mlio/example.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/detail/recordio_header.h"
+#include "mlio/record_readers/detail/util.h"
+#include "mlio/record_readers/record.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::string_view label_prefix = "label_";
+
+// The field numbers of the messages in recordio_protobuf.proto.
+constexpr std::uint32_t record_features_field = 1;
+constexpr std::uint32_t record_label_field = 2;
+constexpr std::uint32_t map_key_field = 1;
+constexpr std::uint32_t map_value_field = 2;
+constexpr std::uint32_t value_float32_tensor_field = 2;
+constexpr std::uint32_t value_float64_tensor_field = 3;
+constexpr std::uint32_t value_int32_tensor_field = 7;
+constexpr std::uint32_t tensor_values_field = 1;
+constexpr std::uint32_t tensor_keys_field = 2;
+constexpr std::uint32_t tensor_shape_field = 3;
+
+constexpr std::uint32_t length_delimited_wire_type = 2;
+
+// The maximum payload size of a RecordIO record.
+constexpr std::size_t max_payload_size = (1U << 29U) - 1U;
+
+// The minimum number of records encoded by a single task.
+constexpr std::size_t grain_size = 64;
+
+std::size_t varint_size(std::uint64_t value) noexcept
+{
+    std::size_t size = 1;
+    for (; value >= 0x80; value >>= 7U) {
+        size++;
+    }
+    return size;
+}
+
+std::byte *write_varint(std::byte *pos, std::uint64_t value) noexcept
+{
+    for (; value >= 0x80; value >>= 7U) {
+        *pos++ = static_cast<std::byte>((value & 0x7FU) | 0x80U);
+    }
+    *pos++ = static_cast<std::byte>(value);
+
+    return pos;
+}
+
+// Like protoc, int32 values are sign-extended to 64 bits; a negative
+// value therefore always takes ten bytes.
+inline std::uint64_t to_varint(std::int32_t value) noexcept
+{
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+}
+
+// Returns the size of a length-delimited field. All field numbers of the
+// RecordIO-protobuf messages are less than 16; their tags therefore take
+// a single byte.
+inline std::size_t field_size(std::size_t payload_size) noexcept
+{
+    return 1 + varint_size(payload_size) + payload_size;
+}
+
+inline std::byte *write_field_header(std::byte *pos,
+                                     std::uint32_t field,
+                                     std::size_t payload_size) noexcept
+{
+    *pos++ = static_cast<std::byte>((field << 3U) | length_delimited_wire_type);
+
+    return write_varint(pos, payload_size);
+}
+
+// Copies fixed-size values in little-endian byte order.
+inline std::byte *write_fixed(std::byte *pos, const void *data, std::size_t size, std::size_t n)
+{
+    Memory_span bits{static_cast<const std::byte *>(data), size * n};
+
+#if MLIO_BYTE_ORDER_HOST == MLIO_BYTE_ORDER_LITTLE
+    std::memcpy(pos, bits.data(), bits.size());
+#else
+    reverse_bytes(bits, Mutable_memory_span{pos, bits.size()}, size);
+#endif
+
+    return pos + bits.size();
+}
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+bool is_row_major(const Dense_tensor &tensor) noexcept
+{
+    const Size_vector &shape = tensor.shape();
+    const Ssize_vector &strides = tensor.strides();
+
+    std::ptrdiff_t stride = 1;
+    for (std::size_t i = shape.size(); i > 0; i--) {
+        if (shape[i - 1] > 1 && strides[i - 1] != stride) {
+            return false;
+        }
+        stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+    }
+    return true;
+}
+
+// Holds a feature of an example along with what is needed to encode
+// its rows as tensor messages.
+struct Feature {
+    std::string_view name{};
+    bool label{};
+    Data_type data_type{};
+    std::size_t element_size{};
+    std::uint32_t value_field{};
+    // The packed shape of a row; empty if the feature is a dense vector.
+    std::vector<std::byte> shape_bits{};
+    std::size_t shape_size{};
+    const std::byte *values{};
+    // The number of values per row of a dense feature.
+    std::size_t row_size{};
+    bool sparse{};
+    // The value indices of a sparse feature grouped by row; the values
+    // of row r are at order[row_offsets[r]] to order[row_offsets[r + 1]].
+    std::vector<std::size_t> row_offsets{};
+    std::vector<std::size_t> order{};
+    // The row-major keys of the values of a sparse feature.
+    std::vector<std::uint64_t> keys{};
+};
+
+// Encodes the rows of an example as RecordIO-protobuf records. The
+// encoding is done in two passes; the first computes the size of each
+// record so that the records can be encoded in parallel into a single
+// preallocated buffer.
+class Record_encoder {
+public:
+    explicit Record_encoder(const Example &example);
+
+    std::size_t num_rows() const noexcept
+    {
+        return num_rows_;
+    }
+
+    std::size_t payload_size(std::size_t row) const;
+
+    void encode(std::size_t row, std::size_t payload_size, std::byte *pos) const;
+
+private:
+    void init_dense(Feature &feature, const Dense_tensor &tensor);
+
+    void init_sparse(Feature &feature, const Coo_tensor &tensor);
+
+    std::size_t tensor_size(const Feature &feature, std::size_t row) const;
+
+    std::size_t entry_size(const Feature &feature, std::size_t row) const;
+
+    std::byte *write_tensor(const Feature &feature, std::size_t row, std::byte *pos) const;
+
+    std::size_t values_size(const Feature &feature, std::size_t row) const;
+
+    std::byte *write_values(const Feature &feature, std::size_t row, std::byte *pos) const;
+
+    std::size_t keys_size(const Feature &feature, std::size_t row) const;
+
+    std::byte *write_keys(const Feature &feature, std::size_t row, std::byte *pos) const;
+
+    std::vector<Feature> features_{};
+    std::size_t num_rows_{};
+};
+
+Record_encoder::Record_encoder(const Example &example)
+{
+    const std::vector<Attribute> &attrs = example.schema().attributes();
+
+    features_.resize(attrs.size());
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        Feature &feature = features_[i];
+
+        const Tensor &tensor = *example.features()[i];
+
+        feature.name = attrs[i].name();
+        if (feature.name.substr(0, label_prefix.size()) == label_prefix) {
+            feature.name.remove_prefix(label_prefix.size());
+
+            feature.label = true;
+        }
+
+        feature.data_type = tensor.data_type();
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+        switch (feature.data_type) {
+        case Data_type::float32:
+            feature.value_field = value_float32_tensor_field;
+            break;
+        case Data_type::float64:
+            feature.value_field = value_float64_tensor_field;
+            break;
+        case Data_type::int32:
+            feature.value_field = value_int32_tensor_field;
+            break;
+        default:
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be written as RecordIO-protobuf only supports the "
+                "float32, float64, and int32 data types.",
+                attrs[i].name())};
+        }
+
+#pragma GCC diagnostic pop
+
+        feature.element_size = dispatch<Element_size_op>(feature.data_type);
+
+        if (tensor.shape().empty()) {
+            throw std::invalid_argument{
+                fmt::format("The feature '{0}' has no batch dimension.", attrs[i].name())};
+        }
+
+        if (i == 0) {
+            num_rows_ = tensor.shape()[0] - example.padding;
+        }
+        else if (tensor.shape()[0] - example.padding != num_rows_) {
+            throw std::invalid_argument{fmt::format(
+                "The feature '{0}' has a batch size that differs from the other features.",
+                attrs[i].name())};
+        }
+
+        if (auto *dense = dynamic_cast<const Dense_tensor *>(&tensor)) {
+            init_dense(feature, *dense);
+        }
+        else if (auto *coo = dynamic_cast<const Coo_tensor *>(&tensor)) {
+            init_sparse(feature, *coo);
+        }
+        else {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be written as it is neither a dense nor a COO tensor.",
+                attrs[i].name())};
+        }
+    }
+}
+
+void Record_encoder::init_dense(Feature &feature, const Dense_tensor &tensor)
+{
+    if (!is_row_major(tensor)) {
+        throw Not_supported_error{fmt::format(
+            "The feature '{0}' cannot be written as it is not a contiguous dense tensor.",
+            feature.name)};
+    }
+
+    const Size_vector &shape = tensor.shape();
+
+    feature.values = static_cast<const std::byte *>(tensor.data().data());
+
+    feature.row_size = 1;
+    for (auto pos = shape.begin() + 1; pos < shape.end(); ++pos) {
+        feature.row_size *= *pos;
+    }
+
+    // A dense vector needs no shape; the number of its values is its
+    // size.
+    if (shape.size() <= 2) {
+        return;
+    }
+
+    feature.shape_size = 0;
+    for (auto pos = shape.begin() + 1; pos < shape.end(); ++pos) {
+        feature.shape_size += varint_size(*pos);
+    }
+
+    feature.shape_bits.resize(feature.shape_size);
+
+    std::byte *bits = feature.shape_bits.data();
+    for (auto pos = shape.begin() + 1; pos < shape.end(); ++pos) {
+        bits = write_varint(bits, *pos);
+    }
+}
+
+void Record_encoder::init_sparse(Feature &feature, const Coo_tensor &tensor)
+{
+    const Size_vector &shape = tensor.shape();
+
+    feature.sparse = true;
+
+    feature.values = static_cast<const std::byte *>(tensor.data().data());
+
+    std::size_t nnz = tensor.data().size();
+
+    std::vector<stdx::span<const std::size_t>> indices{};
+    indices.reserve(shape.size());
+
+    for (std::size_t dim = 0; dim < shape.size(); dim++) {
+        Device_array_view arr = tensor.indices(dim);
+        if (arr.data_type() != Data_type::size || arr.size() != nnz) {
+            throw std::invalid_argument{fmt::format(
+                "The feature '{0}' has invalid COO coordinates.", feature.name)};
+        }
+
+        indices.emplace_back(arr.as<std::size_t>());
+    }
+
+    // Group the values by row with a stable counting sort; the values of
+    // the padded rows are skipped.
+    feature.row_offsets.assign(num_rows_ + 1, 0);
+
+    for (std::size_t row : indices[0]) {
+        if (row < num_rows_) {
+            feature.row_offsets[row + 1]++;
+        }
+    }
+
+    for (std::size_t row = 0; row < num_rows_; row++) {
+        feature.row_offsets[row + 1] += feature.row_offsets[row];
+    }
+
+    feature.order.resize(feature.row_offsets[num_rows_]);
+    feature.keys.resize(nnz);
+
+    std::vector<std::size_t> pos{feature.row_offsets.begin(), feature.row_offsets.end() - 1};
+
+    for (std::size_t i = 0; i < nnz; i++) {
+        std::size_t row = indices[0][i];
+        if (row >= num_rows_) {
+            continue;
+        }
+
+        feature.order[pos[row]++] = i;
+
+        std::uint64_t key = 0;
+        for (std::size_t dim = 1; dim < shape.size(); dim++) {
+            if (indices[dim][i] >= shape[dim]) {
+                throw std::invalid_argument{fmt::format(
+                    "The feature '{0}' has a COO coordinate that is out of range.", feature.name)};
+            }
+
+            key = key * shape[dim] + indices[dim][i];
+        }
+
+        feature.keys[i] = key;
+    }
+
+    // The shape of a sparse row is required even if it is a vector.
+    for (auto dim_pos = shape.begin() + 1; dim_pos < shape.end(); ++dim_pos) {
+        feature.shape_size += varint_size(*dim_pos);
+    }
+
+    feature.shape_bits.resize(feature.shape_size);
+
+    std::byte *bits = feature.shape_bits.data();
+    for (auto dim_pos = shape.begin() + 1; dim_pos < shape.end(); ++dim_pos) {
+        bits = write_varint(bits, *dim_pos);
+    }
+}
+
+std::size_t Record_encoder::payload_size(std::size_t row) const
+{
+    std::size_t size = 0;
+    for (const Feature &feature : features_) {
+        size += field_size(entry_size(feature, row));
+    }
+
+    if (size > max_payload_size) {
+        throw std::invalid_argument{fmt::format(
+            "The instance #{0:n} of the example exceeds the maximum RecordIO record size.", row)};
+    }
+
+    return size;
+}
+
+std::size_t Record_encoder::entry_size(const Feature &feature, std::size_t row) const
+{
+    return field_size(feature.name.size()) + field_size(field_size(tensor_size(feature, row)));
+}
+
+std::size_t Record_encoder::tensor_size(const Feature &feature, std::size_t row) const
+{
+    std::size_t size = 0;
+
+    std::size_t num_bytes = values_size(feature, row);
+    if (num_bytes > 0) {
+        size += field_size(num_bytes);
+    }
+
+    num_bytes = keys_size(feature, row);
+    if (num_bytes > 0) {
+        size += field_size(num_bytes);
+    }
+
+    if (feature.shape_size > 0) {
+        size += field_size(feature.shape_size);
+    }
+
+    return size;
+}
+
+std::size_t Record_encoder::values_size(const Feature &feature, std::size_t row) const
+{
+    if (feature.data_type != Data_type::int32) {
+        std::size_t n{};
+        if (feature.sparse) {
+            n = feature.row_offsets[row + 1] - feature.row_offsets[row];
+        }
+        else {
+            n = feature.row_size;
+        }
+        return n * feature.element_size;
+    }
+
+    const auto *values = reinterpret_cast<const std::int32_t *>(feature.values);
+
+    std::size_t size = 0;
+    if (feature.sparse) {
+        for (std::size_t i = feature.row_offsets[row]; i < feature.row_offsets[row + 1]; i++) {
+            size += varint_size(to_varint(values[feature.order[i]]));
+        }
+    }
+    else {
+        const std::int32_t *pos = values + row * feature.row_size;
+        for (std::size_t i = 0; i < feature.row_size; i++) {
+            size += varint_size(to_varint(pos[i]));
+        }
+    }
+    return size;
+}
+
+std::size_t Record_encoder::keys_size(const Feature &feature, std::size_t row) const
+{
+    if (!feature.sparse) {
+        return 0;
+    }
+
+    std::size_t size = 0;
+    for (std::size_t i = feature.row_offsets[row]; i < feature.row_offsets[row + 1]; i++) {
+        size += varint_size(feature.keys[feature.order[i]]);
+    }
+    return size;
+}
+
+void Record_encoder::encode(std::size_t row, std::size_t payload_size, std::byte *pos) const
+{
+    encode_recordio_header(Record_kind::complete, payload_size, {pos, sizeof(std::uint64_t)});
+
+    pos += sizeof(std::uint64_t);
+
+    // The features come first as their field number is lower than the
+    // one of the labels.
+    for (bool label : {false, true}) {
+        for (const Feature &feature : features_) {
+            if (feature.label != label) {
+                continue;
+            }
+
+            std::uint32_t field = label ? record_label_field : record_features_field;
+
+            pos = write_field_header(pos, field, entry_size(feature, row));
+
+            pos = write_field_header(pos, map_key_field, feature.name.size());
+            pos = std::copy_n(reinterpret_cast<const std::byte *>(feature.name.data()),
+                              feature.name.size(),
+                              pos);
+
+            std::size_t size = tensor_size(feature, row);
+
+            pos = write_field_header(pos, map_value_field, field_size(size));
+            pos = write_field_header(pos, feature.value_field, size);
+
+            pos = write_tensor(feature, row, pos);
+        }
+    }
+}
+
+std::byte *
+Record_encoder::write_tensor(const Feature &feature, std::size_t row, std::byte *pos) const
+{
+    std::size_t num_bytes = values_size(feature, row);
+    if (num_bytes > 0) {
+        pos = write_field_header(pos, tensor_values_field, num_bytes);
+        pos = write_values(feature, row, pos);
+    }
+
+    num_bytes = keys_size(feature, row);
+    if (num_bytes > 0) {
+        pos = write_field_header(pos, tensor_keys_field, num_bytes);
+        pos = write_keys(feature, row, pos);
+    }
+
+    if (feature.shape_size > 0) {
+        pos = write_field_header(pos, tensor_shape_field, feature.shape_size);
+        pos = std::copy(feature.shape_bits.begin(), feature.shape_bits.end(), pos);
+    }
+
+    return pos;
+}
+
+std::byte *
+Record_encoder::write_values(const Feature &feature, std::size_t row, std::byte *pos) const
+{
+    std::size_t element_size = feature.element_size;
+
+    if (!feature.sparse) {
+        const std::byte *values = feature.values + row * feature.row_size * element_size;
+
+        if (feature.data_type != Data_type::int32) {
+            return write_fixed(pos, values, element_size, feature.row_size);
+        }
+
+        const auto *ints = reinterpret_cast<const std::int32_t *>(values);
+        for (std::size_t i = 0; i < feature.row_size; i++) {
+            pos = write_varint(pos, to_varint(ints[i]));
+        }
+        return pos;
+    }
+
+    for (std::size_t i = feature.row_offsets[row]; i < feature.row_offsets[row + 1]; i++) {
+        const std::byte *value = feature.values + feature.order[i] * element_size;
+
+        if (feature.data_type != Data_type::int32) {
+            pos = write_fixed(pos, value, element_size, 1);
+        }
+        else {
+            pos = write_varint(pos, to_varint(*reinterpret_cast<const std::int32_t *>(value)));
+        }
+    }
+    return pos;
+}
+
+std::byte *Record_encoder::write_keys(const Feature &feature, std::size_t row, std::byte *pos) const
+{
+    for (std::size_t i = feature.row_offsets[row]; i < feature.row_offsets[row + 1]; i++) {
+        pos = write_varint(pos, feature.keys[feature.order[i]]);
+    }
+    return pos;
+}
+
+}  // namespace
+}  // namespace detail
+
+Recordio_protobuf_writer::Recordio_protobuf_writer(std::string path,
+                                                   Recordio_protobuf_writer_params params)
+    : path_{std::move(path)}, tmp_path_{path_ + ".tmp"}, params_{params}
+{
+    file_.open(tmp_path_, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The RecordIO-protobuf file '{0}' cannot be created.", path_)};
+    }
+
+    buffer_.reserve(params_.write_buffer_size);
+}
+
+Recordio_protobuf_writer::~Recordio_protobuf_writer()
+{
+    if (!closed_) {
+        file_.close();
+
+        std::remove(tmp_path_.c_str());
+    }
+}
+
+void Recordio_protobuf_writer::write_example(const Example &example)
+{
+    if (closed_) {
+        throw std::logic_error{"The RecordIO-protobuf writer is already closed."};
+    }
+
+    detail::Record_encoder encoder{example};
+
+    std::size_t num_rows = encoder.num_rows();
+    if (num_rows == 0) {
+        return;
+    }
+
+    std::vector<std::size_t> payload_sizes(num_rows);
+
+    // The offset of each record within the buffer; each record consists
+    // of its header and its payload padded to the RecordIO alignment.
+    std::vector<std::size_t> offsets(num_rows + 1);
+
+    tbb::blocked_range<std::size_t> range{0, num_rows, detail::grain_size};
+
+    tbb::parallel_for(range, [&](const tbb::blocked_range<std::size_t> &r) {
+        for (std::size_t row = r.begin(); row < r.end(); row++) {
+            std::size_t size = encoder.payload_size(row);
+
+            payload_sizes[row] = size;
+
+            offsets[row + 1] = sizeof(std::uint64_t) +
+                               detail::align(size, detail::Recordio_header::alignment);
+        }
+    });
+
+    offsets[0] = buffer_.size();
+    for (std::size_t row = 0; row < num_rows; row++) {
+        offsets[row + 1] += offsets[row];
+    }
+
+    // Zero-initialized; this takes care of the padding.
+    buffer_.resize(offsets[num_rows]);
+
+    tbb::parallel_for(range, [&](const tbb::blocked_range<std::size_t> &r) {
+        for (std::size_t row = r.begin(); row < r.end(); row++) {
+            encoder.encode(row, payload_sizes[row], buffer_.data() + offsets[row]);
+        }
+    });
+
+    num_records_ += num_rows;
+
+    if (buffer_.size() >= params_.write_buffer_size) {
+        flush();
+    }
+}
+
+void Recordio_protobuf_writer::close()
+{
+    if (closed_) {
+        return;
+    }
+
+    flush();
+
+    file_.close();
+
+    check_file();
+
+    if (std::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The RecordIO-protobuf file '{0}' cannot be written.", path_)};
+    }
+
+    closed_ = true;
+}
+
+void Recordio_protobuf_writer::flush()
+{
+    file_.write(reinterpret_cast<const char *>(buffer_.data()), as_ssize(buffer_.size()));
+
+    check_file();
+
+    buffer_.clear();
+}
+
+void Recordio_protobuf_writer::check_file() const
+{
+    if (!file_) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The RecordIO-protobuf file '{0}' cannot be written.", path_)};
+    }
+}
+
+void write_recordio_protobuf_file(const std::string &path,
+                                  Data_reader &reader,
+                                  const Recordio_protobuf_writer_params &params)
+{
+    Recordio_protobuf_writer writer{path, params};
+
+    reader.reset();
+
+    Intrusive_ptr<Example> example{};
+    while ((example = reader.read_example()) != nullptr) {
+        writer.write_example(*example);
+    }
+
+    writer.close();
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
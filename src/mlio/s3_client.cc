@@ -17,64 +17,212 @@
 
 #ifdef MLIO_BUILD_S3
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <mutex>
+#include <stdexcept>
+#include <string>
 #include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <aws/core/Aws.h>
+#include <aws/core/VersionConfig.h>
 #include <aws/core/auth/AWSCredentials.h>
+#include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/core/client/AWSError.h>
+#include <aws/core/client/DefaultRetryStrategy.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/S3Errors.h>
+#include <aws/core/utils/DateTime.h>
 #include <aws/s3/model/GetObjectRequest.h>
+#include <aws/s3/model/HeadBucketRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/ListObjectsV2Request.h>
 #include <fmt/format.h>
 
+#if AWS_SDK_VERSION_MAJOR > 1 || AWS_SDK_VERSION_MINOR >= 9
+#define MLIO_HAS_AWS_RETRY_MODES
+#include <aws/core/client/AdaptiveRetryStrategy.h>
+#include <aws/core/client/StandardRetryStrategy.h>
+#endif
+
+#ifdef MLIO_BUILD_S3_CRT
+#include <aws/s3-crt/ClientConfiguration.h>
+#include <aws/s3-crt/S3CrtClient.h>
+#include <aws/s3-crt/S3CrtErrors.h>
+#include <aws/s3-crt/model/GetObjectRequest.h>
+#include <aws/s3-crt/model/HeadBucketRequest.h>
+#include <aws/s3-crt/model/HeadObjectRequest.h>
+#include <aws/s3-crt/model/ListObjectsV2Request.h>
+#endif
+
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/object_listing.h"
+#include "mlio/detail/tracing.h"
+#include "mlio/not_supported_error.h"
 #include "mlio/util/cast.h"
 
+#ifndef MLIO_BUILD_S3_CRT
+
+namespace Aws::S3Crt {
+
+class S3CrtClient {};
+
+}  // namespace Aws::S3Crt
+
+#endif
+
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 namespace {
 
-std::once_flag chain_initialized;
+// Serves the credentials of an underlying provider from a cache that a
+// background thread refreshes ahead of their expiration. The providers
+// of the default chain refresh temporary credentials, e.g. those of an
+// instance profile or of an assumed role, only when they are asked for
+// them; without the background thread a request that happens to come
+// along at that time waits for IMDS or STS.
+class Refreshing_credentials_provider final : public Aws::Auth::AWSCredentialsProvider {
+public:
+    explicit Refreshing_credentials_provider(
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> inner)
+        : inner_{std::move(inner)}, credentials_{inner_->GetAWSCredentials()}
+    {
+        thread_ = std::thread{&Refreshing_credentials_provider::run, this};
+    }
 
-Aws::Auth::AWSCredentials get_default_aws_credentials()
-{
-    std::unique_ptr<Aws::Auth::DefaultAWSCredentialsProviderChain> chain{};
+    Refreshing_credentials_provider(const Refreshing_credentials_provider &) = delete;
 
-    // Compilers are allowed to initialize local static variables before
-    // entering the main function. As the credentials provider chain has
-    // to be constructed after calling the Aws::InitAPI function here we
-    // initialize lazily.
-    std::call_once(chain_initialized, [&chain]() {
-        chain = std::make_unique<Aws::Auth::DefaultAWSCredentialsProviderChain>();
-    });
+    Refreshing_credentials_provider &operator=(const Refreshing_credentials_provider &) = delete;
 
-    return chain->GetAWSCredentials();
-}
+    Refreshing_credentials_provider(Refreshing_credentials_provider &&) = delete;
+
+    Refreshing_credentials_provider &operator=(Refreshing_credentials_provider &&) = delete;
+
+    ~Refreshing_credentials_provider() final
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            stop_ = true;
+        }
+
+        condition_.notify_one();
+
+        thread_.join();
+    }
+
+    Aws::Auth::AWSCredentials GetAWSCredentials() final
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        // The background refresh has failed or has not caught up yet.
+        if (credentials_.IsExpiredOrEmpty()) {
+            credentials_ = inner_->GetAWSCredentials();
+        }
+
+        return credentials_;
+    }
+
+private:
+    void run() noexcept
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        while (!condition_.wait_for(lock, next_refresh_delay(), [this]() {
+            return stop_;
+        })) {
+            lock.unlock();
+
+            Aws::Auth::AWSCredentials credentials{};
+            try {
+                credentials = inner_->GetAWSCredentials();
+            }
+            catch (...) {
+            }
+
+            lock.lock();
+
+            if (!credentials.IsExpiredOrEmpty()) {
+                credentials_ = std::move(credentials);
+            }
+        }
+    }
+
+    // Schedules the refresh a few minutes before the credentials expire,
+    // which is when the providers of the chain start renewing them.
+    std::chrono::milliseconds next_refresh_delay() const
+    {
+        constexpr std::chrono::milliseconds lead_time = std::chrono::minutes{5};
+        constexpr std::chrono::milliseconds min_delay = std::chrono::seconds{10};
+        constexpr std::chrono::milliseconds max_delay = std::chrono::minutes{15};
+
+        std::int64_t remaining_ms =
+            credentials_.GetExpiration().Millis() - Aws::Utils::DateTime::Now().Millis();
+
+        if (remaining_ms > max_delay.count() + lead_time.count()) {
+            return max_delay;
+        }
+
+        return std::max(std::chrono::milliseconds{remaining_ms} - lead_time, min_delay);
+    }
+
+    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> inner_;
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+    Aws::Auth::AWSCredentials credentials_;
+    bool stop_{};
+    std::thread thread_{};
+};
+
+// The classic and the CRT clients expose the same operations through
+// distinct, but identically shaped, model types.
+struct S3_api {
+    using Client = Aws::S3::S3Client;
+    using List_objects_request = Aws::S3::Model::ListObjectsV2Request;
+    using Get_object_request = Aws::S3::Model::GetObjectRequest;
+    using Head_object_request = Aws::S3::Model::HeadObjectRequest;
+    using Head_bucket_request = Aws::S3::Model::HeadBucketRequest;
+};
+
+#ifdef MLIO_BUILD_S3_CRT
+struct S3_crt_api {
+    using Client = Aws::S3Crt::S3CrtClient;
+    using List_objects_request = Aws::S3Crt::Model::ListObjectsV2Request;
+    using Get_object_request = Aws::S3Crt::Model::GetObjectRequest;
+    using Head_object_request = Aws::S3Crt::Model::HeadObjectRequest;
+    using Head_bucket_request = Aws::S3Crt::Model::HeadBucketRequest;
+};
+#endif
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wswitch-enum"
 
-[[noreturn]] void throw_s3_error(const Aws::Client::AWSError<Aws::S3::S3Errors> &err)
+template<typename Errors>
+[[noreturn]] void throw_s3_error(const Aws::Client::AWSError<Errors> &err)
 {
     std::error_code ec;
 
     switch (err.GetErrorType()) {
-    case Aws::S3::S3Errors::SERVICE_UNAVAILABLE:
+    case Errors::SERVICE_UNAVAILABLE:
         ec = std::make_error_code(std::errc::host_unreachable);
         break;
-    case Aws::S3::S3Errors::ACCESS_DENIED:
+    case Errors::ACCESS_DENIED:
         ec = std::make_error_code(std::errc::permission_denied);
         break;
-    case Aws::S3::S3Errors::RESOURCE_NOT_FOUND:
-    case Aws::S3::S3Errors::NO_SUCH_BUCKET:
-    case Aws::S3::S3Errors::NO_SUCH_KEY:
+    case Errors::RESOURCE_NOT_FOUND:
+    case Errors::NO_SUCH_BUCKET:
+    case Errors::NO_SUCH_KEY:
         ec = std::make_error_code(std::errc::no_such_file_or_directory);
         break;
-    case Aws::S3::S3Errors::REQUEST_TIMEOUT:
+    case Errors::REQUEST_TIMEOUT:
         ec = std::make_error_code(std::errc::timed_out);
         break;
     default:
@@ -95,55 +243,63 @@ inline void check_s3_error(const Outcome &outcome)
     }
 }
 
-}  // namespace
-}  // namespace detail
-
-S3_client::S3_client(std::unique_ptr<Aws::S3::S3Client> native_client) noexcept
-    : native_client_{std::move(native_client)}
-{}
-
-S3_client::~S3_client() = default;
-
-void S3_client::list_objects(std::string_view bucket,
-                             std::string_view prefix,
-                             const std::function<void(std::string uri)> &callback) const
+template<typename Api>
+void list_objects(const typename Api::Client &client,
+                  std::string_view bucket,
+                  std::string_view prefix,
+                  const Object_store_client::List_callback &callback)
 {
-    Aws::S3::Model::ListObjectsV2Request request{};
-    request.SetBucket(Aws::String{bucket});
-    request.SetMaxKeys(1000);
+    auto list_prefix = [&client, bucket](std::string_view pfx,
+                                         std::string_view delimiter,
+                                         Object_listing &listing) {
+        typename Api::List_objects_request request{};
+        request.SetBucket(Aws::String{bucket});
+        request.SetMaxKeys(1000);
+
+        if (!pfx.empty()) {
+            request.SetPrefix(Aws::String{pfx});
+        }
+        if (!delimiter.empty()) {
+            request.SetDelimiter(Aws::String{delimiter});
+        }
 
-    if (!prefix.empty()) {
-        request.SetPrefix(Aws::String{prefix});
-    }
+        while (true) {
+            auto outcome = client.ListObjectsV2(request);
+            check_s3_error(outcome);
 
-    std::string base_uri{"s3://" + std::string{bucket} + "/"};
+            const auto &result = outcome.GetResult();
 
-    while (true) {
-        auto outcome = native_client_->ListObjectsV2(request);
-        detail::check_s3_error(outcome);
+            for (const auto &obj : result.GetContents()) {
+                listing.objects.emplace_back(std::string{obj.GetKey()},
+                                             static_cast<std::size_t>(obj.GetSize()));
+            }
 
-        const auto &result = outcome.GetResult();
+            for (const auto &common_prefix : result.GetCommonPrefixes()) {
+                listing.common_prefixes.emplace_back(std::string{common_prefix.GetPrefix()});
+            }
 
-        for (const auto &obj : result.GetContents()) {
-            callback(base_uri + std::string{obj.GetKey()});
+            if (!result.GetIsTruncated()) {
+                break;
+            }
+            request.SetContinuationToken(result.GetNextContinuationToken());
         }
+    };
 
-        if (!result.GetIsTruncated()) {
-            break;
-        }
-        request.SetContinuationToken(result.GetNextContinuationToken());
-    }
+    list_objects_in_parallel(list_prefix, "s3", bucket, prefix, callback);
 }
 
-std::size_t S3_client::read_object(std::string_view bucket,
-                                   std::string_view key,
-                                   std::string_view version_id,
-                                   std::size_t offset,
-                                   Mutable_memory_span destination) const
+template<typename Api>
+std::size_t read_object(const typename Api::Client &client,
+                        std::string_view bucket,
+                        std::string_view key,
+                        std::string_view version_id,
+                        std::size_t offset,
+                        Mutable_memory_span destination)
 {
-    std::string range_str = fmt::format("bytes={0}-{1}", offset, offset + destination.size());
+    std::string range_str =
+        fmt::format("bytes={0}-{1}", offset, offset + destination.size() - 1);
 
-    Aws::S3::Model::GetObjectRequest request{};
+    typename Api::Get_object_request request{};
     request.SetBucket(Aws::String{bucket});
     request.SetKey(Aws::String{key});
     request.SetRange(Aws::String{range_str});
@@ -152,8 +308,8 @@ std::size_t S3_client::read_object(std::string_view bucket,
         request.SetVersionId(Aws::String{version_id});
     }
 
-    auto outcome = native_client_->GetObject(request);
-    detail::check_s3_error(outcome);
+    auto outcome = client.GetObject(request);
+    check_s3_error(outcome);
 
     auto chars = as_span<char>(destination);
 
@@ -163,11 +319,13 @@ std::size_t S3_client::read_object(std::string_view bucket,
     return static_cast<std::size_t>(body.gcount()) * sizeof(char);
 }
 
-std::size_t S3_client::read_object_size(std::string_view bucket,
+template<typename Api>
+S3_object_metadata read_object_metadata(const typename Api::Client &client,
+                                        std::string_view bucket,
                                         std::string_view key,
-                                        std::string_view version_id) const
+                                        std::string_view version_id)
 {
-    Aws::S3::Model::HeadObjectRequest request{};
+    typename Api::Head_object_request request{};
     request.SetBucket(Aws::String{bucket});
     request.SetKey(Aws::String{key});
 
@@ -175,24 +333,95 @@ std::size_t S3_client::read_object_size(std::string_view bucket,
         request.SetVersionId(Aws::String{version_id});
     }
 
-    auto outcome = native_client_->HeadObject(request);
-    detail::check_s3_error(outcome);
+    auto outcome = client.HeadObject(request);
+    check_s3_error(outcome);
 
-    return as_size(outcome.GetResult().GetContentLength());
+    const auto &result = outcome.GetResult();
+
+    return {as_size(result.GetContentLength()), std::string{result.GetETag()}};
 }
 
-Intrusive_ptr<S3_client> make_s3_client(const S3_client_options &opts)
+template<typename Api>
+void warm_up_connections(const typename Api::Client &client,
+                         std::string_view bucket,
+                         std::size_t num_connections)
 {
-    Aws::Auth::AWSCredentials credentials{};
-    if (opts.access_key_id.empty() && opts.secret_key.empty()) {
-        credentials = detail::get_default_aws_credentials();
+    // The requests have to be in flight at the same time for the client
+    // to open a connection for each of them.
+    auto head_bucket = [&client, bucket]() {
+        typename Api::Head_bucket_request request{};
+        request.SetBucket(Aws::String{bucket});
+
+        // Even an error response leaves an established connection in the
+        // pool of the client, so the outcome is of no interest.
+        static_cast<void>(client.HeadBucket(request));
+    };
+
+    std::vector<std::thread> threads{};
+    threads.reserve(num_connections);
+
+    std::exception_ptr exception_ptr{};
+    try {
+        for (std::size_t i = 0; i < num_connections; i++) {
+            threads.emplace_back(head_bucket);
+        }
     }
-    else {
-        credentials = Aws::Auth::AWSCredentials{Aws::String{opts.access_key_id},
-                                                Aws::String{opts.secret_key},
-                                                Aws::String{opts.session_token}};
+    catch (...) {
+        exception_ptr = std::current_exception();
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    if (exception_ptr) {
+        std::rethrow_exception(exception_ptr);
+    }
+}
+
+// The AWS SDK takes the timeouts as long integers, which is not the
+// representation of std::chrono::milliseconds on every platform.
+long as_aws_milliseconds(std::chrono::milliseconds value) noexcept
+{
+    return std::chrono::duration<long, std::milli>{value}.count();
+}
+
+std::shared_ptr<Aws::Client::RetryStrategy> make_retry_strategy(const S3_client_options &opts)
+{
+    auto max_attempts = static_cast<long>(opts.max_attempts);
+
+    switch (opts.retry_mode) {
+    case S3_retry_mode::legacy:
+        if (max_attempts == 0) {
+            return std::make_shared<Aws::Client::DefaultRetryStrategy>();
+        }
+        return std::make_shared<Aws::Client::DefaultRetryStrategy>(max_attempts - 1);
+
+#ifdef MLIO_HAS_AWS_RETRY_MODES
+    case S3_retry_mode::standard:
+        if (max_attempts == 0) {
+            return std::make_shared<Aws::Client::StandardRetryStrategy>();
+        }
+        return std::make_shared<Aws::Client::StandardRetryStrategy>(max_attempts);
+
+    case S3_retry_mode::adaptive:
+        if (max_attempts == 0) {
+            return std::make_shared<Aws::Client::AdaptiveRetryStrategy>();
+        }
+        return std::make_shared<Aws::Client::AdaptiveRetryStrategy>(max_attempts);
+#else
+    case S3_retry_mode::standard:
+    case S3_retry_mode::adaptive:
+        throw Not_supported_error{
+            "The standard and adaptive retry modes require AWS SDK for C++ 1.9 or later."};
+#endif
     }
 
+    throw std::invalid_argument{"The specified retry mode is not valid."};
+}
+
+Aws::Client::ClientConfiguration make_client_config(const S3_client_options &opts)
+{
     Aws::Client::ClientConfiguration config{};
     if (!opts.profile.empty()) {
         config = Aws::Client::ClientConfiguration{std::string{opts.profile}.c_str()};
@@ -203,10 +432,157 @@ Intrusive_ptr<S3_client> make_s3_client(const S3_client_options &opts)
     if (!opts.use_https) {
         config.scheme = Aws::Http::Scheme::HTTP;
     }
+    if (!opts.endpoint_override.empty()) {
+        config.endpointOverride = opts.endpoint_override;
+    }
+
+    if (opts.max_connections > 0) {
+        config.maxConnections = static_cast<unsigned>(opts.max_connections);
+    }
+    if (opts.connect_timeout.count() > 0) {
+        config.connectTimeoutMs = as_aws_milliseconds(opts.connect_timeout);
+    }
+    if (opts.request_timeout.count() > 0) {
+        config.requestTimeoutMs = as_aws_milliseconds(opts.request_timeout);
+    }
+
+    config.retryStrategy = make_retry_strategy(opts);
+
+    return config;
+}
+
+}  // namespace
+}  // namespace detail
+
+S3_client::S3_client(std::unique_ptr<Aws::S3::S3Client> native_client,
+                     const S3_range_read_params &range_read_params,
+                     Intrusive_ptr<S3_object_cache> object_cache) noexcept
+    : Object_store_client{range_read_params, std::move(object_cache)}
+    , native_client_{std::move(native_client)}
+{}
+
+S3_client::S3_client(std::unique_ptr<Aws::S3Crt::S3CrtClient> native_client,
+                     const S3_range_read_params &range_read_params,
+                     Intrusive_ptr<S3_object_cache> object_cache) noexcept
+    : Object_store_client{range_read_params, std::move(object_cache)}
+    , native_crt_client_{std::move(native_client)}
+{}
+
+S3_client::~S3_client() = default;
+
+void S3_client::list_objects(std::string_view bucket,
+                             std::string_view prefix,
+                             const List_callback &callback) const
+{
+#ifdef MLIO_BUILD_S3_CRT
+    if (native_crt_client_ != nullptr) {
+        detail::list_objects<detail::S3_crt_api>(*native_crt_client_, bucket, prefix, callback);
+
+        return;
+    }
+#endif
 
-    auto native_client = std::make_unique<Aws::S3::S3Client>(credentials, config);
+    detail::list_objects<detail::S3_api>(*native_client_, bucket, prefix, callback);
+}
 
-    return make_intrusive<S3_client>(std::move(native_client));
+std::size_t S3_client::read_object(std::string_view bucket,
+                                   std::string_view key,
+                                   std::string_view version_id,
+                                   std::size_t offset,
+                                   Mutable_memory_span destination) const
+{
+    detail::Trace_span span{"s3_read_object"};
+    detail::Allocation_scope scope{detail::Allocation_stage::io};
+
+#ifdef MLIO_BUILD_S3_CRT
+    if (native_crt_client_ != nullptr) {
+        return detail::read_object<detail::S3_crt_api>(
+            *native_crt_client_, bucket, key, version_id, offset, destination);
+    }
+#endif
+
+    return detail::read_object<detail::S3_api>(
+        *native_client_, bucket, key, version_id, offset, destination);
+}
+
+S3_object_metadata S3_client::read_object_metadata(std::string_view bucket,
+                                                   std::string_view key,
+                                                   std::string_view version_id) const
+{
+#ifdef MLIO_BUILD_S3_CRT
+    if (native_crt_client_ != nullptr) {
+        return detail::read_object_metadata<detail::S3_crt_api>(
+            *native_crt_client_, bucket, key, version_id);
+    }
+#endif
+
+    return detail::read_object_metadata<detail::S3_api>(*native_client_, bucket, key, version_id);
+}
+
+void S3_client::warm_up_connections(std::string_view bucket, std::size_t num_connections) const
+{
+    detail::Trace_span span{"s3_warm_up_connections"};
+
+#ifdef MLIO_BUILD_S3_CRT
+    if (native_crt_client_ != nullptr) {
+        detail::warm_up_connections<detail::S3_crt_api>(
+            *native_crt_client_, bucket, num_connections);
+
+        return;
+    }
+#endif
+
+    detail::warm_up_connections<detail::S3_api>(*native_client_, bucket, num_connections);
+}
+
+Intrusive_ptr<S3_client> make_s3_client(const S3_client_options &opts)
+{
+#ifndef MLIO_BUILD_S3_CRT
+    if (opts.use_crt) {
+        throw Not_supported_error{"MLIO was not built with S3 CRT support."};
+    }
+#endif
+
+    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials{};
+    if (opts.access_key_id.empty() && opts.secret_key.empty()) {
+        credentials = std::make_shared<detail::Refreshing_credentials_provider>(
+            std::make_shared<Aws::Auth::DefaultAWSCredentialsProviderChain>());
+    }
+    else {
+        credentials = std::make_shared<Aws::Auth::SimpleAWSCredentialsProvider>(
+            Aws::String{opts.access_key_id},
+            Aws::String{opts.secret_key},
+            Aws::String{opts.session_token});
+    }
+
+    Aws::Client::ClientConfiguration config = detail::make_client_config(opts);
+
+#ifdef MLIO_BUILD_S3_CRT
+    if (opts.use_crt) {
+        Aws::S3Crt::ClientConfiguration crt_config{};
+        static_cast<Aws::Client::ClientConfiguration &>(crt_config) = config;
+
+        crt_config.throughputTargetGbps = opts.target_throughput_gbps;
+
+        auto native_client = std::make_unique<Aws::S3Crt::S3CrtClient>(
+            credentials,
+            crt_config,
+            Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
+            opts.use_virtual_addressing);
+
+        return make_intrusive<S3_client>(
+            std::move(native_client), opts.range_read_params, opts.object_cache);
+    }
+#endif
+
+    auto native_client = std::make_unique<Aws::S3::S3Client>(
+        credentials,
+        config,
+        Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
+        opts.use_virtual_addressing);
+
+    return make_intrusive<S3_client>(
+        std::move(native_client), opts.range_read_params, opts.object_cache);
 }
 
 }  // namespace abi_v1
@@ -222,21 +598,34 @@ class S3Client {};
 
 }  // namespace Aws::S3
 
+namespace Aws::S3Crt {
+
+class S3CrtClient {};
+
+}  // namespace Aws::S3Crt
+
 namespace mlio {
 inline namespace abi_v1 {
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-noreturn"
 
-S3_client::S3_client(std::unique_ptr<Aws::S3::S3Client>) noexcept : native_client_{}
+S3_client::S3_client(std::unique_ptr<Aws::S3::S3Client>,
+                     const S3_range_read_params &,
+                     Intrusive_ptr<S3_object_cache>) noexcept
+    : Object_store_client{{}, {}}
+{}
+
+S3_client::S3_client(std::unique_ptr<Aws::S3Crt::S3CrtClient>,
+                     const S3_range_read_params &,
+                     Intrusive_ptr<S3_object_cache>) noexcept
+    : Object_store_client{{}, {}}
 {}
 
 S3_client::~S3_client() = default;
 
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
-void S3_client::list_objects(std::string_view,
-                             std::string_view,
-                             const std::function<void(std::string)> &) const
+void S3_client::list_objects(std::string_view, std::string_view, const List_callback &) const
 {}
 
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
@@ -250,11 +639,16 @@ std::size_t S3_client::read_object(std::string_view,
 }
 
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
-std::size_t S3_client::read_object_size(std::string_view, std::string_view, std::string_view) const
+S3_object_metadata
+S3_client::read_object_metadata(std::string_view, std::string_view, std::string_view) const
 {
-    return 0;
+    return {};
 }
 
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void S3_client::warm_up_connections(std::string_view, std::size_t) const
+{}
+
 Intrusive_ptr<S3_client> make_s3_client(const S3_client_options &)
 {
     throw Not_supported_error{"MLIO was not built with S3 support."};
@@ -0,0 +1,464 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/s3_object_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/error.h"
+#include "mlio/detail/file_descriptor.h"
+#include "mlio/detail/object_uri.h"
+#include "mlio/logger.h"
+#include "mlio/memory/file_mapped_memory_block.h"
+#include "mlio/object_store_client.h"
+#include "mlio/streams/input_stream_base.h"
+#include "mlio/streams/memory_input_stream.h"
+#include "mlio/streams/object_input_stream.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::string_view object_suffix = ".obj";
+constexpr std::string_view tmp_suffix = ".tmp";
+
+struct Dir_deleter {
+    void operator()(::DIR *dir)
+    {
+        if (dir != nullptr) {
+            ::closedir(dir);
+        }
+    }
+};
+
+bool ends_with(std::string_view s, std::string_view suffix) noexcept
+{
+    return s.size() >= suffix.size() && s.substr(s.size() - suffix.size()) == suffix;
+}
+
+// FNV-1a; unlike std::hash the value is stable across processes, which
+// is required to find the objects cached by a previous process.
+std::string make_object_name(std::string_view scheme,
+                             std::string_view bucket,
+                             std::string_view key,
+                             std::string_view version_id,
+                             std::string_view etag)
+{
+    std::uint64_t value = 0xcbf2'9ce4'8422'2325;
+
+    auto hash = [&value](std::string_view s) {
+        for (char chr : s) {
+            value ^= static_cast<unsigned char>(chr);
+            value *= 0x100'0000'01b3;
+        }
+
+        value ^= 0xFF;
+        value *= 0x100'0000'01b3;
+    };
+
+    // The names of the S3 objects predate the other services and are
+    // kept as is so that existing caches remain valid.
+    if (scheme != "s3") {
+        hash(scheme);
+    }
+
+    for (std::string_view s : {bucket, key, version_id, etag}) {
+        hash(s);
+    }
+
+    return fmt::format("{0:016x}", value);
+}
+
+}  // namespace
+
+// Writes the bytes read from an object to a temporary file in the
+// cache directory. The data store wraps the stream in a prefetching
+// stream; as a result the file is written by the prefetching thread and
+// not by the consumer of the stream.
+class S3_object_cache_fill final : public Input_stream_base {
+public:
+    explicit S3_object_cache_fill(Intrusive_ptr<Input_stream> inner,
+                                  Intrusive_ptr<S3_object_cache> cache,
+                                  std::string name)
+        : inner_{std::move(inner)}, cache_{std::move(cache)}, name_{std::move(name)}
+    {
+        tmp_path_ = cache_->get_path(name_) + std::string{tmp_suffix};
+
+        fd_ = ::open(tmp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_.get() == -1) {
+            abandon();
+        }
+    }
+
+    S3_object_cache_fill(const S3_object_cache_fill &) = delete;
+
+    S3_object_cache_fill &operator=(const S3_object_cache_fill &) = delete;
+
+    S3_object_cache_fill(S3_object_cache_fill &&) = delete;
+
+    S3_object_cache_fill &operator=(S3_object_cache_fill &&) = delete;
+
+    ~S3_object_cache_fill() final
+    {
+        abandon();
+    }
+
+    using Input_stream_base::read;
+
+    std::size_t read(Mutable_memory_span destination) final
+    {
+        std::size_t position = inner_->position();
+
+        std::size_t num_bytes_read = inner_->read(destination);
+
+        // Only the bytes that extend the file contiguously are written;
+        // an object that is not read from front to back is therefore
+        // cached only if it is eventually read in full.
+        if (fd_.is_open() && position <= num_bytes_written_ &&
+            num_bytes_written_ < position + num_bytes_read) {
+
+            std::size_t offset = num_bytes_written_ - position;
+
+            write(destination.subspan(offset, num_bytes_read - offset));
+
+            if (fd_.is_open() && num_bytes_written_ == inner_->size()) {
+                commit();
+            }
+        }
+
+        return num_bytes_read;
+    }
+
+    void seek(std::size_t position) final
+    {
+        inner_->seek(position);
+    }
+
+    void close() noexcept final
+    {
+        inner_->close();
+
+        abandon();
+    }
+
+    std::size_t size() const final
+    {
+        return inner_->size();
+    }
+
+    std::size_t position() const final
+    {
+        return inner_->position();
+    }
+
+    bool closed() const noexcept final
+    {
+        return inner_->closed();
+    }
+
+    bool seekable() const noexcept final
+    {
+        return inner_->seekable();
+    }
+
+private:
+    void write(Mutable_memory_span data) noexcept
+    {
+        while (!data.empty()) {
+            ::ssize_t num_bytes_written = ::write(fd_.get(), data.data(), data.size());
+            if (num_bytes_written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                logger::warn("The object cannot be written to the cache file '{0}'. The error "
+                             "code is {1:n}.",
+                             tmp_path_,
+                             errno);
+
+                abandon();
+
+                return;
+            }
+
+            auto size = as_size(num_bytes_written);
+
+            num_bytes_written_ += size;
+
+            data = data.subspan(size);
+        }
+    }
+
+    void commit() noexcept
+    {
+        fd_ = {};
+
+        try {
+            cache_->commit_fill(name_, tmp_path_, num_bytes_written_);
+        }
+        catch (const std::exception &e) {
+            logger::warn("The object cannot be added to the cache: {0}", e.what());
+
+            ::unlink(tmp_path_.c_str());
+
+            cache_->abandon_fill(name_);
+        }
+
+        cache_ = nullptr;
+    }
+
+    void abandon() noexcept
+    {
+        if (cache_ == nullptr) {
+            return;
+        }
+
+        if (fd_.is_open()) {
+            fd_ = {};
+
+            ::unlink(tmp_path_.c_str());
+        }
+
+        cache_->abandon_fill(name_);
+
+        cache_ = nullptr;
+    }
+
+    Intrusive_ptr<Input_stream> inner_;
+    Intrusive_ptr<S3_object_cache> cache_;
+    std::string name_;
+    std::string tmp_path_{};
+    File_descriptor fd_{};
+    std::size_t num_bytes_written_{};
+};
+
+}  // namespace detail
+
+S3_object_cache::S3_object_cache(std::string directory, std::size_t max_size)
+    : directory_{std::move(directory)}, max_size_{max_size}
+{
+    if (directory_.empty()) {
+        throw std::invalid_argument{"The cache directory must be specified."};
+    }
+
+    if (::mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The cache directory '{0}' cannot be created.", directory_)};
+    }
+
+    load_entries();
+}
+
+S3_object_cache::~S3_object_cache() = default;
+
+void S3_object_cache::load_entries()
+{
+    std::unique_ptr<::DIR, detail::Dir_deleter> dir{::opendir(directory_.c_str())};
+    if (dir == nullptr) {
+        throw std::system_error{
+            detail::current_error_code(),
+            fmt::format("The cache directory '{0}' cannot be opened.", directory_)};
+    }
+
+    // Order the objects cached by a previous process by their last
+    // access time, which we maintain through the modification time.
+    std::vector<std::tuple<::time_t, std::string, std::size_t>> objects{};
+
+    ::dirent *e{};
+    while ((e = ::readdir(dir.get())) != nullptr) {
+        std::string_view name = e->d_name;
+
+        if (detail::ends_with(name, detail::tmp_suffix)) {
+            // Left over by a process that did not complete filling.
+            ::unlink((directory_ + "/" + std::string{name}).c_str());
+
+            continue;
+        }
+
+        if (!detail::ends_with(name, detail::object_suffix)) {
+            continue;
+        }
+
+        name.remove_suffix(detail::object_suffix.size());
+
+        std::string path = get_path(std::string{name});
+
+        struct ::stat buf {};
+        if (::stat(path.c_str(), &buf) != 0 || !S_ISREG(buf.st_mode)) {
+            continue;
+        }
+
+        objects.emplace_back(buf.st_mtime, name, static_cast<std::size_t>(buf.st_size));
+    }
+
+    std::sort(objects.begin(), objects.end());
+
+    for (const auto &[mtime, name, size] : objects) {
+        insert_entry(name, size);
+    }
+
+    evict_entries();
+}
+
+Intrusive_ptr<Input_stream>
+S3_object_cache::open_read(const Intrusive_ptr<const Object_store_client> &client,
+                           const std::string &uri,
+                           const std::string &version_id,
+                           const Range_read_params &range_read_params)
+{
+    std::string_view scheme = client->uri_scheme();
+
+    auto [bucket, key] = detail::split_object_uri_to_bucket_and_key(uri, scheme);
+
+    Object_metadata metadata = client->read_object_metadata(bucket, key, version_id);
+
+    std::string name = detail::make_object_name(scheme, bucket, key, version_id, metadata.etag);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    auto pos = entries_.find(name);
+    if (pos != entries_.end() && pos->second.size == metadata.size) {
+        lru_.splice(lru_.begin(), lru_, pos->second.lru_pos);
+
+        lock.unlock();
+
+        std::string path = get_path(name);
+
+        // Persist the access order for the next process.
+        ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+
+        // An object that gets evicted at this point is unlinked, but its
+        // mapping remains valid; if it is already gone we fall back to
+        // reading from the service.
+        try {
+            auto block = make_intrusive<File_mapped_memory_block>(std::move(path));
+
+            logger::info("The object '{0}' is read from the cache.", uri);
+
+            return make_intrusive<Memory_input_stream>(std::move(block));
+        }
+        catch (const std::system_error &) {
+            lock.lock();
+        }
+    }
+
+    bool should_fill = metadata.size <= max_size_ && pending_.insert(name).second;
+
+    lock.unlock();
+
+    Intrusive_ptr<Input_stream> stream =
+        make_object_input_stream(client, uri, version_id, range_read_params, metadata.size);
+
+    if (!should_fill) {
+        return stream;
+    }
+
+    return make_intrusive<detail::S3_object_cache_fill>(
+        std::move(stream), wrap_intrusive(this), std::move(name));
+}
+
+void S3_object_cache::insert_entry(const std::string &name, std::size_t size)
+{
+    auto pos = entries_.find(name);
+    if (pos != entries_.end()) {
+        size_ -= pos->second.size;
+
+        lru_.erase(pos->second.lru_pos);
+
+        entries_.erase(pos);
+    }
+
+    lru_.push_front(name);
+
+    entries_.emplace(name, Entry{size, lru_.begin()});
+
+    size_ += size;
+}
+
+void S3_object_cache::evict_entries()
+{
+    while (size_ > max_size_ && !lru_.empty()) {
+        const std::string &name = lru_.back();
+
+        ::unlink(get_path(name).c_str());
+
+        auto pos = entries_.find(name);
+
+        size_ -= pos->second.size;
+
+        entries_.erase(pos);
+
+        lru_.pop_back();
+    }
+}
+
+void S3_object_cache::commit_fill(const std::string &name,
+                                  const std::string &tmp_path,
+                                  std::size_t size)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (::rename(tmp_path.c_str(), get_path(name).c_str()) != 0) {
+        throw std::system_error{detail::current_error_code(),
+                                "The cache file cannot be renamed."};
+    }
+
+    pending_.erase(name);
+
+    insert_entry(name, size);
+
+    evict_entries();
+}
+
+void S3_object_cache::abandon_fill(const std::string &name) noexcept
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    pending_.erase(name);
+}
+
+std::string S3_object_cache::get_path(const std::string &name) const
+{
+    return directory_ + "/" + name + std::string{detail::object_suffix};
+}
+
+std::size_t S3_object_cache::size() const
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    return size_;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -16,6 +16,7 @@
 #include "mlio/schema.h"
 
 #include <stdexcept>
+#include <string_view>
 #include <utility>
 
 #include <fmt/format.h>
@@ -68,27 +69,63 @@ bool operator==(const Attribute &lhs, const Attribute &rhs) noexcept
            lhs.strides() == rhs.strides();
 }
 
-Schema::Schema(std::vector<Attribute> attrs) : attributes_{std::move(attrs)}
+Schema::Schema(std::vector<Attribute> attrs)
+    : attributes_{std::move(attrs)}, hash_{detail::hash_range(attributes_)}
 {
-    std::size_t idx = 0;
-
-    for (auto &attr : attributes_) {
-        auto pr = name_index_map_.emplace(attr.name(), idx++);
-        if (!pr.second) {
-            throw std::invalid_argument{fmt::format(
-                "The attribute list contains more than one element with the name '{0}'.",
-                attr.name())};
+    init_name_slots();
+}
+
+void Schema::init_name_slots()
+{
+    std::size_t num_slots = 2;
+    while (num_slots < attributes_.size() * 2) {
+        num_slots *= 2;
+    }
+
+    name_slots_.resize(num_slots);
+
+    std::size_t mask = num_slots - 1;
+
+    for (std::size_t idx = 0; idx < attributes_.size(); idx++) {
+        const std::string &name = attributes_[idx].name();
+
+        std::size_t h = std::hash<std::string_view>{}(name);
+
+        std::size_t pos = h & mask;
+        for (;; pos = (pos + 1) & mask) {
+            Name_slot &slot = name_slots_[pos];
+            if (slot.index == 0) {
+                break;
+            }
+
+            if (slot.hash == h && attributes_[slot.index - 1].name() == name) {
+                throw std::invalid_argument{fmt::format(
+                    "The attribute list contains more than one element with the name '{0}'.",
+                    name)};
+            }
         }
+
+        name_slots_[pos] = Name_slot{h, idx + 1};
     }
 }
 
-std::optional<std::size_t> Schema::get_index(const std::string &name) const noexcept
+std::optional<std::size_t> Schema::get_index(std::string_view name) const noexcept
 {
-    auto pos = name_index_map_.find(name);
-    if (pos == name_index_map_.end()) {
-        return {};
+    std::size_t h = std::hash<std::string_view>{}(name);
+
+    std::size_t mask = name_slots_.size() - 1;
+
+    // The table is never full, so the probe ends at an empty slot.
+    for (std::size_t pos = h & mask;; pos = (pos + 1) & mask) {
+        const Name_slot &slot = name_slots_[pos];
+        if (slot.index == 0) {
+            return {};
+        }
+
+        if (slot.hash == h && attributes_[slot.index - 1].name() == name) {
+            return slot.index - 1;
+        }
     }
-    return pos->second;
 }
 
 std::string Schema::repr() const
@@ -98,6 +135,9 @@ std::string Schema::repr() const
 
 bool operator==(const Schema &lhs, const Schema &rhs) noexcept
 {
+    if (lhs.hash() != rhs.hash()) {
+        return false;
+    }
     return lhs.attributes() == rhs.attributes();
 }
 
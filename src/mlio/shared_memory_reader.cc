@@ -0,0 +1,834 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/shared_memory_reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/data_type.h"
+#include "mlio/detail/example_codec.h"
+#include "mlio/detail/shared_memory_segment.h"
+#include "mlio/detail/thread.h"
+#include "mlio/device.h"
+#include "mlio/example.h"
+#include "mlio/logger.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/tensor.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+using namespace std::chrono_literals;
+
+// How often a waiting server or client checks whether its peers are
+// still alive.
+constexpr auto poll_interval = 100ms;
+
+constexpr std::size_t page_size = 4096;
+
+// The tensor data in a slot is aligned to the cache line size.
+constexpr std::size_t data_alignment = 64;
+
+constexpr std::size_t align(std::size_t value, std::size_t alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template<Data_type dt>
+struct Element_size_op {
+    std::size_t operator()() const noexcept
+    {
+        return sizeof(data_type_t<dt>);
+    }
+};
+
+std::string make_segment_name(const std::string &name)
+{
+    std::string_view s = name;
+    if (!s.empty() && s.front() == '/') {
+        s.remove_prefix(1);
+    }
+
+    if (s.empty() || s.find('/') != std::string_view::npos) {
+        throw std::invalid_argument{
+            fmt::format("'{0}' is not a valid shared memory segment name.", name)};
+    }
+
+    return "/" + std::string{s};
+}
+
+void validate_schema(const Schema &schema)
+{
+    for (const Attribute &attr : schema.attributes()) {
+        if (attr.sparse() || attr.data_type() == Data_type::string) {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be published. Only dense features of numeric data types are supported.",
+                attr.name())};
+        }
+    }
+}
+
+// Describes where the data of a feature is stored in a slot.
+struct Feature_layout {
+    const Dense_tensor *tensor{};
+    std::size_t offset{};
+    std::size_t size{};
+};
+
+// A slot holds the number of features, the padding, the shape, offset,
+// and size of each feature, followed by the feature data.
+struct Payload_layout {
+    std::vector<std::uint64_t> words{};
+    std::vector<Feature_layout> features{};
+    std::size_t size{};
+};
+
+Payload_layout make_payload_layout(const Example &example)
+{
+    Payload_layout layout{};
+
+    const std::vector<Intrusive_ptr<Tensor>> &features = example.features();
+
+    std::size_t num_words = 2;
+    for (const Intrusive_ptr<Tensor> &feature : features) {
+        num_words += feature->shape().size() + 3;
+    }
+
+    std::size_t offset = align(num_words * sizeof(std::uint64_t), data_alignment);
+
+    Word_writer writer{};
+
+    writer.put(features.size());
+    writer.put(example.padding);
+
+    for (std::size_t i = 0; i < features.size(); i++) {
+        auto *tensor = dynamic_cast<const Dense_tensor *>(features[i].get());
+        if (tensor == nullptr || !is_row_major(*tensor) ||
+            tensor->data().device().kind() != Device_kind::cpu()) {
+            throw Not_supported_error{fmt::format(
+                "The feature '{0}' cannot be published as it is not a contiguous dense tensor in host memory.",
+                example.schema().attributes()[i].name())};
+        }
+
+        const Size_vector &shape = tensor->shape();
+
+        std::size_t num_elements =
+            std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{});
+
+        std::size_t size = num_elements * dispatch<Element_size_op>(tensor->data_type());
+
+        writer.put(shape.size());
+        for (std::size_t dim : shape) {
+            writer.put(dim);
+        }
+        writer.put(offset);
+        writer.put(size);
+
+        layout.features.emplace_back(Feature_layout{tensor, offset, size});
+
+        offset = align(offset + size, data_alignment);
+    }
+
+    layout.words = writer.words();
+    layout.size = offset;
+
+    return layout;
+}
+
+std::uint64_t min_attached_epoch(Shared_memory_segment &segment) noexcept
+{
+    std::uint64_t epoch = Client_state::no_epoch;
+
+    for (std::size_t i = 0; i < segment.header().num_clients; i++) {
+        const Client_state &client = segment.client(i);
+        if (client.attached) {
+            epoch = std::min(epoch, client.epoch);
+        }
+    }
+    return epoch;
+}
+
+bool is_slot_for_client(Shared_memory_segment &segment,
+                        const Slot_header &slot,
+                        std::size_t client_index) noexcept
+{
+    auto distribution = static_cast<Shared_memory_distribution>(segment.header().distribution);
+
+    return distribution == Shared_memory_distribution::first_available ||
+           slot.client == client_index;
+}
+
+// Frees the slots whose examples will never be read; this is the case
+// if their clients have moved on to a later epoch. If check_processes
+// is true, the clients and the slot owners that have exited without
+// detaching are released as well. Must be called with the segment
+// locked.
+void reclaim_slots(Shared_memory_segment &segment, bool check_processes)
+{
+    Segment_header &hdr = segment.header();
+
+    if (check_processes) {
+        for (std::size_t i = 0; i < hdr.num_clients; i++) {
+            Client_state &client = segment.client(i);
+            if (client.attached && !is_process_alive(client.pid)) {
+                client.attached = false;
+            }
+        }
+    }
+
+    auto distribution = static_cast<Shared_memory_distribution>(hdr.distribution);
+
+    std::uint64_t min_epoch = min_attached_epoch(segment);
+
+    bool any_freed = false;
+
+    for (std::size_t i = 0; i < hdr.num_slots; i++) {
+        Slot_header &slot = segment.slot(i);
+
+        bool stale = false;
+        if (slot.state == Slot_state::ready) {
+            if (distribution == Shared_memory_distribution::shard) {
+                const Client_state &client = segment.client(slot.client);
+
+                stale = client.attached && slot.epoch < client.epoch;
+            }
+            else {
+                stale = min_epoch != Client_state::no_epoch && slot.epoch < min_epoch;
+            }
+        }
+        else if (slot.state == Slot_state::in_use && check_processes) {
+            stale = !is_process_alive(slot.owner_pid);
+        }
+
+        if (stale) {
+            slot.state = Slot_state::free;
+
+            any_freed = true;
+        }
+    }
+
+    if (any_freed) {
+        segment.notify_all();
+    }
+}
+
+// Hands the slot back to the server once the last tensor that refers
+// to it gets destroyed.
+class Slot_lease : public Intrusive_ref_counter<Slot_lease> {
+public:
+    explicit Slot_lease(Intrusive_ptr<Shared_memory_segment> segment, std::size_t index) noexcept
+        : segment_{std::move(segment)}, index_{index}
+    {}
+
+    Slot_lease(const Slot_lease &) = delete;
+
+    Slot_lease &operator=(const Slot_lease &) = delete;
+
+    Slot_lease(Slot_lease &&) = delete;
+
+    Slot_lease &operator=(Slot_lease &&) = delete;
+
+    ~Slot_lease()
+    {
+        try {
+            std::unique_lock<Shared_memory_segment> lock{*segment_};
+
+            segment_->slot(index_).state = Slot_state::free;
+
+            segment_->notify_all();
+        }
+        catch (const std::system_error &e) {
+            logger::warn("The shared memory slot cannot be released: {0}", e.what());
+        }
+    }
+
+private:
+    Intrusive_ptr<Shared_memory_segment> segment_;
+    std::size_t index_;
+};
+
+// Exposes the data of a feature in a slot as a sequence container so
+// that it can be wrapped by a Cpu_array.
+template<typename T>
+class Slot_buffer {
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    explicit Slot_buffer(Intrusive_ptr<Slot_lease> lease, std::byte *data, std::size_t size)
+        : lease_{std::move(lease)}, data_{reinterpret_cast<T *>(data)}, size_{size}
+    {}
+
+    T *data() noexcept
+    {
+        return data_;
+    }
+
+    const T *data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    T *begin() noexcept
+    {
+        return data_;
+    }
+
+    T *end() noexcept
+    {
+        return data_ + size_;
+    }
+
+    const T *begin() const noexcept
+    {
+        return data_;
+    }
+
+    const T *end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+private:
+    Intrusive_ptr<Slot_lease> lease_;
+    T *data_;
+    std::size_t size_;
+};
+
+template<Data_type dt>
+struct Make_slot_array_op {
+    std::unique_ptr<Device_array>
+    operator()(const Intrusive_ptr<Slot_lease> &lease, std::byte *data, std::size_t size)
+    {
+        using T = data_type_t<dt>;
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            return Cpu_array_access::wrap(dt, Slot_buffer<T>{lease, data, size});
+        }
+        else {
+            Word_reader::throw_corrupt();
+        }
+    }
+};
+
+}  // namespace
+}  // namespace detail
+
+Shared_memory_reader_server::Shared_memory_reader_server(Intrusive_ptr<Data_reader> reader,
+                                                         std::string name,
+                                                         Shared_memory_server_params params)
+    : reader_{std::move(reader)}, name_{std::move(name)}, params_{params}
+{
+    if (params_.num_clients == 0) {
+        throw std::invalid_argument{"The number of clients must be greater than zero."};
+    }
+
+    std::string segment_name = detail::make_segment_name(name_);
+
+    Intrusive_ptr<const Schema> schema = reader_->read_schema();
+    if (schema == nullptr) {
+        throw Data_reader_error{"The schema of the dataset cannot be read."};
+    }
+
+    detail::validate_schema(*schema);
+
+    std::vector<std::uint64_t> schema_words = detail::encode_schema(*schema);
+
+    std::size_t schema_size = schema_words.size() * sizeof(std::uint64_t);
+
+    if (params_.num_slots == 0) {
+        params_.num_slots = 4 * params_.num_clients;
+    }
+
+    if (params_.slot_size == 0) {
+        Intrusive_ptr<Example> example = reader_->peek_example();
+        if (example != nullptr) {
+            params_.slot_size = 2 * detail::make_payload_layout(*example).size;
+        }
+    }
+
+    params_.slot_size = detail::align(std::max(params_.slot_size, std::size_t{1}), detail::page_size);
+
+    segment_ = detail::Shared_memory_segment::create(
+        segment_name, params_.num_clients, params_.num_slots, params_.slot_size, schema_size);
+
+    detail::Segment_header &hdr = segment_->header();
+
+    hdr.distribution = static_cast<std::uint64_t>(params_.distribution);
+
+    std::memcpy(segment_->schema_data(), schema_words.data(), schema_size);
+
+    segment_->publish();
+
+    thread_ = detail::start_thread(&Shared_memory_reader_server::run, this);
+}
+
+Shared_memory_reader_server::~Shared_memory_reader_server()
+{
+    stop();
+}
+
+void Shared_memory_reader_server::stop() noexcept
+{
+    try {
+        std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+        segment_->header().stopped = true;
+
+        segment_->notify_all();
+    }
+    catch (const std::system_error &e) {
+        logger::warn("The shared memory reader server cannot be stopped: {0}", e.what());
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Shared_memory_reader_server::run() noexcept
+{
+    detail::Segment_header &hdr = segment_->header();
+
+    try {
+        std::uint64_t epoch = 0;
+
+        while (true) {
+            bool completed = run_epoch(epoch);
+
+            std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+            if (completed) {
+                hdr.epoch_complete = true;
+
+                segment_->notify_all();
+            }
+
+            // Wait until every attached client has moved past the epoch.
+            std::uint64_t next_epoch{};
+            while (true) {
+                if (hdr.stopped) {
+                    return;
+                }
+
+                next_epoch = detail::min_attached_epoch(*segment_);
+                if (next_epoch != detail::Client_state::no_epoch && next_epoch > epoch) {
+                    break;
+                }
+
+                bool timed_out = !segment_->wait_for(lock, detail::poll_interval);
+
+                detail::reclaim_slots(*segment_, timed_out);
+            }
+
+            hdr.epoch = next_epoch;
+            hdr.epoch_complete = false;
+
+            lock.unlock();
+
+            reader_->reset();
+
+            epoch = next_epoch;
+        }
+    }
+    catch (const std::exception &e) {
+        try {
+            std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+            std::string_view msg = e.what();
+
+            msg = msg.substr(0, hdr.error.size() - 1);
+
+            std::copy(msg.begin(), msg.end(), hdr.error.begin());
+
+            segment_->notify_all();
+        }
+        catch (const std::system_error &) {
+        }
+
+        logger::warn("The shared memory reader server '{0}' has failed: {1}", name_, e.what());
+    }
+}
+
+bool Shared_memory_reader_server::run_epoch(std::uint64_t epoch)
+{
+    for (std::uint64_t sequence = 0;; sequence++) {
+        if (epoch_abandoned(epoch)) {
+            return false;
+        }
+
+        Intrusive_ptr<Example> example = reader_->read_example();
+        if (example == nullptr) {
+            return true;
+        }
+
+        if (!publish(*example, epoch, sequence)) {
+            return false;
+        }
+    }
+}
+
+bool Shared_memory_reader_server::epoch_abandoned(std::uint64_t epoch)
+{
+    std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+    if (segment_->header().stopped) {
+        return true;
+    }
+
+    // If every attached client has been reset, the rest of the epoch
+    // would be discarded anyways.
+    std::uint64_t min_epoch = detail::min_attached_epoch(*segment_);
+
+    return min_epoch != detail::Client_state::no_epoch && min_epoch > epoch;
+}
+
+bool Shared_memory_reader_server::publish(const Example &example,
+                                          std::uint64_t epoch,
+                                          std::uint64_t sequence)
+{
+    detail::Payload_layout layout = detail::make_payload_layout(example);
+
+    if (layout.size > params_.slot_size) {
+        throw Data_reader_error{fmt::format(
+            "The example has a size of {0:n} bytes and does not fit into a slot of {1:n} bytes. Increase the slot size of the server.",
+            layout.size,
+            params_.slot_size)};
+    }
+
+    std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+    std::optional<std::size_t> index = acquire_slot(lock);
+    if (!index) {
+        return false;
+    }
+
+    detail::Slot_header &slot = segment_->slot(*index);
+
+    slot.state = detail::Slot_state::writing;
+
+    lock.unlock();
+
+    // Copy the example while the segment is unlocked so that the
+    // clients can proceed in the meantime.
+    std::byte *data = segment_->slot_data(*index);
+
+    std::memcpy(data, layout.words.data(), layout.words.size() * sizeof(std::uint64_t));
+
+    for (const detail::Feature_layout &feature : layout.features) {
+        const auto *src = static_cast<const std::byte *>(feature.tensor->data().data());
+
+        std::copy_n(src, feature.size, data + feature.offset);
+    }
+
+    lock.lock();
+
+    slot.client = sequence % params_.num_clients;
+    slot.epoch = epoch;
+    slot.sequence = sequence;
+    slot.size = layout.size;
+    slot.state = detail::Slot_state::ready;
+
+    segment_->notify_all();
+
+    return true;
+}
+
+std::optional<std::size_t>
+Shared_memory_reader_server::acquire_slot(std::unique_lock<detail::Shared_memory_segment> &lock)
+{
+    detail::Segment_header &hdr = segment_->header();
+
+    bool timed_out = false;
+
+    while (true) {
+        if (hdr.stopped) {
+            return {};
+        }
+
+        detail::reclaim_slots(*segment_, timed_out);
+
+        for (std::size_t i = 0; i < hdr.num_slots; i++) {
+            if (segment_->slot(i).state == detail::Slot_state::free) {
+                return i;
+            }
+        }
+
+        timed_out = !segment_->wait_for(lock, detail::poll_interval);
+    }
+}
+
+Shared_memory_reader::Shared_memory_reader(std::string name, std::size_t client_index)
+    : client_index_{client_index}
+{
+    segment_ = detail::Shared_memory_segment::open(detail::make_segment_name(name));
+
+    detail::Segment_header &hdr = segment_->header();
+
+    if (client_index_ >= hdr.num_clients) {
+        throw std::invalid_argument{fmt::format(
+            "The client index must be less than {0:n}, the number of clients of the server.",
+            hdr.num_clients)};
+    }
+
+    schema_ = detail::decode_schema(segment_->schema_data(), hdr.schema_size);
+
+    std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+    detail::Client_state &client = segment_->client(client_index_);
+    if (client.attached && detail::is_process_alive(client.pid)) {
+        throw std::invalid_argument{fmt::format(
+            "The client index {0:n} is already in use by the process {1}.", client_index_, client.pid)};
+    }
+
+    // If the server has already published all examples of its current
+    // epoch and none are left for this client, for instance because a
+    // previous process with the same index has read them, start with the
+    // next epoch.
+    epoch_ = hdr.epoch;
+
+    if (hdr.epoch_complete) {
+        bool has_pending = false;
+        for (std::size_t i = 0; i < hdr.num_slots; i++) {
+            const detail::Slot_header &slot = segment_->slot(i);
+            if (slot.state == detail::Slot_state::ready && slot.epoch == epoch_ &&
+                detail::is_slot_for_client(*segment_, slot, client_index_)) {
+                has_pending = true;
+
+                break;
+            }
+        }
+
+        if (!has_pending) {
+            epoch_++;
+        }
+    }
+
+    client.pid = ::getpid();
+    client.attached = true;
+    client.epoch = epoch_;
+
+    segment_->notify_all();
+}
+
+Shared_memory_reader::~Shared_memory_reader()
+{
+    peeked_example_ = nullptr;
+
+    try {
+        std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+        segment_->client(client_index_).attached = false;
+
+        segment_->notify_all();
+    }
+    catch (const std::system_error &e) {
+        logger::warn("The shared memory reader cannot be detached: {0}", e.what());
+    }
+}
+
+Intrusive_ptr<const Schema> Shared_memory_reader::read_schema()
+{
+    return schema_;
+}
+
+Intrusive_ptr<Example> Shared_memory_reader::read_example()
+{
+    if (peeked_example_) {
+        return std::exchange(peeked_example_, nullptr);
+    }
+    return read_example_core();
+}
+
+Intrusive_ptr<Example> Shared_memory_reader::peek_example()
+{
+    if (peeked_example_ == nullptr) {
+        peeked_example_ = read_example_core();
+    }
+    return peeked_example_;
+}
+
+Intrusive_ptr<Example> Shared_memory_reader::read_example_core()
+{
+    detail::Segment_header &hdr = segment_->header();
+
+    std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+    while (true) {
+        if (hdr.error[0] != '\0') {
+            throw Data_reader_error{
+                fmt::format("The shared memory reader server has failed: {0}", hdr.error.data())};
+        }
+
+        if (hdr.stopped) {
+            throw Data_reader_error{"The shared memory reader server has been stopped."};
+        }
+
+        detail::reclaim_slots(*segment_, false);
+
+        // Take the ready example of the epoch that was published first.
+        std::optional<std::size_t> index{};
+        for (std::size_t i = 0; i < hdr.num_slots; i++) {
+            const detail::Slot_header &slot = segment_->slot(i);
+            if (slot.state != detail::Slot_state::ready || slot.epoch != epoch_ ||
+                !detail::is_slot_for_client(*segment_, slot, client_index_)) {
+                continue;
+            }
+
+            if (!index || slot.sequence < segment_->slot(*index).sequence) {
+                index = i;
+            }
+        }
+
+        if (index) {
+            detail::Slot_header &slot = segment_->slot(*index);
+
+            slot.state = detail::Slot_state::in_use;
+            slot.owner_pid = ::getpid();
+
+            std::size_t size = slot.size;
+
+            lock.unlock();
+
+            num_bytes_read_ += size;
+
+            return make_example(*index, size);
+        }
+
+        if (hdr.epoch == epoch_ && hdr.epoch_complete) {
+            return {};
+        }
+
+        if (!segment_->wait_for(lock, detail::poll_interval) &&
+            !detail::is_process_alive(hdr.server_pid)) {
+            throw Data_reader_error{"The shared memory reader server has exited."};
+        }
+    }
+}
+
+Intrusive_ptr<Example> Shared_memory_reader::make_example(std::size_t slot_index, std::size_t size)
+{
+    auto lease = make_intrusive<detail::Slot_lease>(segment_, slot_index);
+
+    std::byte *data = segment_->slot_data(slot_index);
+
+    detail::Word_reader reader{data, size};
+
+    const std::vector<Attribute> &attrs = schema_->attributes();
+
+    if (reader.get() != attrs.size()) {
+        detail::Word_reader::throw_corrupt();
+    }
+
+    std::size_t padding = reader.get();
+
+    std::vector<Intrusive_ptr<Tensor>> features{};
+    features.reserve(attrs.size());
+
+    for (const Attribute &attr : attrs) {
+        Size_vector shape(reader.get());
+        for (std::size_t &dim : shape) {
+            dim = reader.get();
+        }
+
+        std::size_t offset = reader.get();
+        std::size_t num_bytes = reader.get();
+
+        std::size_t num_elements =
+            std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>{});
+
+        std::size_t element_size = dispatch<detail::Element_size_op>(attr.data_type());
+
+        if (offset > size || num_bytes > size - offset || num_bytes != num_elements * element_size) {
+            detail::Word_reader::throw_corrupt();
+        }
+
+        auto arr = dispatch<detail::Make_slot_array_op>(
+            attr.data_type(), lease, data + offset, num_elements);
+
+        features.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(arr)));
+    }
+
+    auto example = make_intrusive<Example>(schema_, std::move(features));
+
+    example->padding = padding;
+
+    return example;
+}
+
+void Shared_memory_reader::reset() noexcept
+{
+    peeked_example_ = nullptr;
+
+    num_bytes_read_ = 0;
+
+    try {
+        std::unique_lock<detail::Shared_memory_segment> lock{*segment_};
+
+        // Skip the rest of the current epoch; its remaining examples are
+        // reclaimed by the server.
+        epoch_++;
+
+        segment_->client(client_index_).epoch = epoch_;
+
+        segment_->notify_all();
+    }
+    catch (const std::system_error &e) {
+        logger::warn("The shared memory reader cannot be reset: {0}", e.what());
+    }
+}
+
+std::size_t Shared_memory_reader::num_bytes_read() const noexcept
+{
+    return num_bytes_read_;
+}
+
+std::size_t Shared_memory_reader::shuffle_buffer_size() const noexcept
+{
+    return 0;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,428 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/sparse_tensor_builder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Sparse_tensor_builder::Sparse_tensor_builder(const Attribute &attr,
+                                             std::size_t batch_size,
+                                             Sparse_tensor_format format,
+                                             std::size_t nnz_hint,
+                                             std::size_t hash_dimension)
+    : attr_{&attr}
+    , batch_size_{batch_size}
+    // CSR can only represent features with a single dimension besides
+    // the batch dimension.
+    , csr_{format == Sparse_tensor_format::csr && attr.shape().size() == 2}
+    , hash_dimension_{hash_dimension}
+    , coordinates_(hash_dimension == 0 ? attr.shape().size() : 0)
+{
+    if (hash_dimension_ != 0) {
+        hashed_indices_ = take_scratch_vector<std::int32_t>();
+        hashed_indptr_ = take_scratch_vector<std::int32_t>();
+
+        hashed_indptr_.reserve(batch_size + 1);
+        hashed_indptr_.emplace_back(0);
+    }
+    else {
+        for (std::vector<std::size_t> &coordinates : coordinates_) {
+            coordinates = take_scratch_vector<std::size_t>();
+        }
+
+        if (csr_) {
+            indptr_ = take_scratch_vector<std::size_t>();
+
+            indptr_.reserve(batch_size + 1);
+            indptr_.emplace_back(0);
+        }
+    }
+
+    reserve_indices(nnz_hint);
+}
+
+Sparse_tensor_builder::~Sparse_tensor_builder()
+{
+    for (std::vector<std::size_t> &coordinates : coordinates_) {
+        recycle_scratch_vector(coordinates);
+    }
+
+    recycle_scratch_vector(indptr_);
+    recycle_scratch_vector(hashed_indices_);
+    recycle_scratch_vector(hashed_indptr_);
+}
+
+bool Sparse_tensor_builder::append_indices(stdx::span<const std::uint64_t> indices)
+{
+    if (hash_dimension_ != 0) {
+        return append_hashed_indices(indices);
+    }
+
+    // The first elements of the shape and the strides correspond to the
+    // batch dimension. We do not need them to compute the indices.
+
+    auto dim_beg = attr_->shape().begin() + 1;
+    auto dim_end = attr_->shape().end();
+
+    auto stride_beg = attr_->strides().begin() + 1;
+    auto stride_end = attr_->strides().end();
+
+    auto coordinates_beg = coordinates_.begin() + 1;
+    auto coordinates_end = coordinates_.end();
+
+    auto zip_beg = tbb::make_zip_iterator(dim_beg, stride_beg, coordinates_beg);
+    auto zip_end = tbb::make_zip_iterator(dim_end, stride_end, coordinates_end);
+
+    std::size_t old_nnz = nnz();
+
+    bool valid = std::all_of(indices.begin(), indices.end(), [&](std::uint64_t uint_idx) {
+        std::size_t idx{};
+        // On a 32-bit system we might not be able to convert the index
+        // from 64-bit to 32-bit without narrowing.
+        if (!try_narrow(uint_idx, idx)) {
+            return false;
+        }
+
+        for (auto zip_pos = zip_beg; zip_pos < zip_end; ++zip_pos) {
+            std::size_t stride = as_size(std::get<1>(*zip_pos));
+
+            std::size_t dim_idx = idx / stride;
+
+            // Make sure that the index is within the dimension.
+            if (dim_idx >= std::get<0>(*zip_pos)) {
+                return false;
+            }
+
+            // Put the index to the corresponding coordinate vector.
+            std::get<2>(*zip_pos).emplace_back(dim_idx);
+
+            // Use the remainder as the new index.
+            idx = idx % stride;
+        }
+
+        if (!csr_) {
+            coordinates_[0].emplace_back(row_idx_);
+        }
+
+        return true;
+    });
+
+    if (!valid) {
+        // Discard the partially appended row so that the builder stays
+        // consistent.
+        for (std::vector<std::size_t> &coordinates : coordinates_) {
+            coordinates.resize(std::min(coordinates.size(), old_nnz));
+        }
+
+        return false;
+    }
+
+    if (csr_) {
+        indptr_.emplace_back(nnz());
+    }
+
+    row_idx_++;
+
+    return true;
+}
+
+bool Sparse_tensor_builder::append_hashed_indices(stdx::span<const std::uint64_t> indices)
+{
+    // The index pointers are int32 as well; a batch cannot hold more
+    // non-zero values than they can address.
+    constexpr auto max_nnz = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+    if (indices.size() > max_nnz - hashed_indices_.size()) {
+        return false;
+    }
+
+    // Any key is valid; colliding keys of a row are kept as separate
+    // values, which the consumers of CSR tensors sum up.
+    for (std::uint64_t key : indices) {
+        hashed_indices_.emplace_back(static_cast<std::int32_t>(key % hash_dimension_));
+    }
+
+    hashed_indptr_.emplace_back(static_cast<std::int32_t>(hashed_indices_.size()));
+
+    row_idx_++;
+
+    return true;
+}
+
+void Sparse_tensor_builder::merge_indices(Sparse_tensor_builder &other)
+{
+    if (hash_dimension_ != 0) {
+        auto offset = static_cast<std::int32_t>(hashed_indices_.size());
+
+        auto pos = other.hashed_indptr_.begin() + 1;
+        for (; pos < other.hashed_indptr_.end(); ++pos) {
+            hashed_indptr_.emplace_back(offset + *pos);
+        }
+
+        hashed_indices_.insert(
+            hashed_indices_.end(), other.hashed_indices_.begin(), other.hashed_indices_.end());
+
+        row_idx_ += other.row_idx_;
+
+        return;
+    }
+
+    if (csr_) {
+        // Skip the leading zero of the other index pointer array and
+        // shift the rest by the number of values we already hold.
+        std::size_t offset = nnz();
+
+        auto pos = other.indptr_.begin() + 1;
+        for (; pos < other.indptr_.end(); ++pos) {
+            indptr_.emplace_back(offset + *pos);
+        }
+    }
+    else {
+        // The row indices of the other builder start from zero; shift
+        // them by the number of rows we already hold.
+        std::vector<std::size_t> &rows = coordinates_[0];
+
+        rows.reserve(rows.size() + other.coordinates_[0].size());
+
+        for (std::size_t row_idx : other.coordinates_[0]) {
+            rows.emplace_back(row_idx_ + row_idx);
+        }
+    }
+
+    auto coordinates_beg = coordinates_.begin() + 1;
+    auto coordinates_end = coordinates_.end();
+
+    auto other_coordinates_beg = other.coordinates_.begin() + 1;
+
+    for (auto pos = coordinates_beg; pos < coordinates_end; ++pos, ++other_coordinates_beg) {
+        pos->insert(pos->end(), other_coordinates_beg->begin(), other_coordinates_beg->end());
+    }
+
+    row_idx_ += other.row_idx_;
+}
+
+void Sparse_tensor_builder::reserve_indices(std::size_t nnz)
+{
+    if (hash_dimension_ != 0) {
+        hashed_indices_.reserve(nnz);
+
+        return;
+    }
+
+    auto coordinates_beg = coordinates_.begin();
+    if (csr_) {
+        ++coordinates_beg;
+    }
+
+    for (auto pos = coordinates_beg; pos < coordinates_.end(); ++pos) {
+        pos->reserve(nnz);
+    }
+}
+
+std::size_t Sparse_tensor_builder::truncate_indices(std::size_t num_rows)
+{
+    if (num_rows >= row_idx_) {
+        return nnz();
+    }
+
+    if (hash_dimension_ != 0) {
+        auto num_values = static_cast<std::size_t>(hashed_indptr_[num_rows]);
+
+        hashed_indptr_.resize(num_rows + 1);
+        hashed_indices_.resize(num_values);
+
+        row_idx_ = num_rows;
+
+        return num_values;
+    }
+
+    std::size_t num_values{};
+    if (csr_) {
+        num_values = indptr_[num_rows];
+
+        indptr_.resize(num_rows + 1);
+    }
+    else {
+        // The row indices are sorted.
+        const std::vector<std::size_t> &rows = coordinates_[0];
+
+        num_values = as_size(std::lower_bound(rows.begin(), rows.end(), num_rows) - rows.begin());
+    }
+
+    auto coordinates_beg = coordinates_.begin();
+    if (csr_) {
+        ++coordinates_beg;
+    }
+
+    for (auto pos = coordinates_beg; pos < coordinates_.end(); ++pos) {
+        pos->resize(num_values);
+    }
+
+    row_idx_ = num_rows;
+
+    return num_values;
+}
+
+std::size_t Sparse_tensor_builder::estimate_capacity(std::size_t nnz) const noexcept
+{
+    std::size_t num_rows = row_idx_ + 1;
+    if (num_rows >= batch_size_) {
+        return nnz;
+    }
+
+    // Assume that the remaining rows have the same average number of
+    // non-zero values as the ones we have seen so far.
+    return nnz / num_rows * batch_size_ + nnz % num_rows * batch_size_ / num_rows;
+}
+
+Intrusive_ptr<Tensor> Sparse_tensor_builder::build_core(std::unique_ptr<Device_array> &&data)
+{
+    Size_vector shape = attr_->shape();
+
+    // The provided batch size can be less than the actual batch size if
+    // there is padding.
+    shape[0] = batch_size_;
+
+    if (hash_dimension_ != 0) {
+        return build_hashed_csr(std::move(data), std::move(shape));
+    }
+    if (csr_) {
+        return build_csr(std::move(data), std::move(shape));
+    }
+    return build_coo(std::move(data), std::move(shape));
+}
+
+Intrusive_ptr<Tensor>
+Sparse_tensor_builder::build_pooled(Tensor_pool &pool,
+                                    Data_type dt,
+                                    const void *data,
+                                    std::size_t num_bytes)
+{
+    Size_vector shape = attr_->shape();
+
+    shape[0] = batch_size_;
+
+    std::size_t num_values = nnz();
+
+    // The padded rows have no values.
+    if (hash_dimension_ != 0) {
+        hashed_indptr_.resize(batch_size_ + 1, hashed_indptr_.back());
+    }
+    else if (csr_) {
+        indptr_.resize(batch_size_ + 1, indptr_.back());
+    }
+
+    // The values come first, followed by the index arrays in the order
+    // the tensor expects them.
+    std::vector<Data_type> dts{dt};
+    std::vector<std::size_t> sizes{num_values};
+    std::vector<stdx::span<const std::byte>> sources{
+        {static_cast<const std::byte *>(data), num_bytes}};
+
+    auto add_array = [&dts, &sizes, &sources](Data_type index_dt, const auto &vec) {
+        dts.emplace_back(index_dt);
+        sizes.emplace_back(vec.size());
+        sources.emplace_back(stdx::as_bytes(make_span(vec)));
+    };
+
+    if (hash_dimension_ != 0) {
+        add_array(Data_type::int32, hashed_indices_);
+        add_array(Data_type::int32, hashed_indptr_);
+    }
+    else if (csr_) {
+        add_array(Data_type::size, coordinates_[1]);
+        add_array(Data_type::size, indptr_);
+    }
+    else {
+        for (const std::vector<std::size_t> &coordinates : coordinates_) {
+            add_array(Data_type::size, coordinates);
+        }
+    }
+
+    std::vector<std::unique_ptr<Device_array>> arrays = pool.make_cpu_arrays(dts, sizes);
+
+    for (std::size_t i = 0; i < arrays.size(); i++) {
+        if (!sources[i].empty()) {
+            std::memcpy(arrays[i]->data(), sources[i].data(), sources[i].size());
+        }
+    }
+
+    std::unique_ptr<Device_array> values = std::move(arrays[0]);
+
+    if (hash_dimension_ != 0 || csr_) {
+        return make_intrusive<Csr_tensor>(
+            std::move(shape), std::move(values), std::move(arrays[1]), std::move(arrays[2]));
+    }
+
+    std::vector<std::unique_ptr<Device_array>> layout{};
+    layout.reserve(coordinates_.size());
+
+    std::move(arrays.begin() + 1, arrays.end(), std::back_inserter(layout));
+
+    return make_intrusive<Coo_tensor>(std::move(shape), std::move(values), std::move(layout));
+}
+
+Intrusive_ptr<Tensor>
+Sparse_tensor_builder::build_coo(std::unique_ptr<Device_array> &&data, Size_vector &&shape)
+{
+    // Wrap index lists into device arrays.
+    std::vector<std::unique_ptr<Device_array>> layout{};
+    layout.reserve(coordinates_.size());
+
+    for (std::vector<std::size_t> &indices : coordinates_) {
+        auto arr = wrap_cpu_array<Data_type::size>(std::move(indices));
+        layout.emplace_back(std::move(arr));
+    }
+
+    return make_intrusive<Coo_tensor>(std::move(shape), std::move(data), std::move(layout));
+}
+
+Intrusive_ptr<Tensor>
+Sparse_tensor_builder::build_csr(std::unique_ptr<Device_array> &&data, Size_vector &&shape)
+{
+    // The padded rows have no values.
+    indptr_.resize(batch_size_ + 1, indptr_.back());
+
+    auto indices = wrap_cpu_array<Data_type::size>(std::move(coordinates_[1]));
+    auto indptr = wrap_cpu_array<Data_type::size>(std::move(indptr_));
+
+    return make_intrusive<Csr_tensor>(
+        std::move(shape), std::move(data), std::move(indices), std::move(indptr));
+}
+
+Intrusive_ptr<Tensor>
+Sparse_tensor_builder::build_hashed_csr(std::unique_ptr<Device_array> &&data, Size_vector &&shape)
+{
+    hashed_indptr_.resize(batch_size_ + 1, hashed_indptr_.back());
+
+    auto indices = wrap_cpu_array<Data_type::int32>(std::move(hashed_indices_));
+    auto indptr = wrap_cpu_array<Data_type::int32>(std::move(hashed_indptr_));
+
+    return make_intrusive<Csr_tensor>(
+        std::move(shape), std::move(data), std::move(indices), std::move(indptr));
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
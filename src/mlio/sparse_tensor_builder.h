@@ -0,0 +1,326 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/iterators.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_reader.h"
+#include "mlio/data_type.h"
+#include "mlio/intrusive_ptr.h"
+#include "mlio/schema.h"
+#include "mlio/span.h"
+#include "mlio/tensor.h"
+#include "mlio/tensor_pool.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// The value and index vectors of the builders are recycled per thread so
+// that the builders of the next batches, and the builders of the tasks
+// that are merged into a batch builder, do not allocate them again. At
+// most a few vectors are kept per element type and thread.
+template<typename T>
+inline std::vector<std::vector<T>> &scratch_vectors() noexcept
+{
+    thread_local std::vector<std::vector<T>> vectors{};  // NOLINT(cert-err58-cpp)
+
+    return vectors;
+}
+
+template<typename T>
+inline std::vector<T> take_scratch_vector() noexcept
+{
+    std::vector<std::vector<T>> &vectors = scratch_vectors<T>();
+    if (vectors.empty()) {
+        return {};
+    }
+
+    std::vector<T> vec = std::move(vectors.back());
+
+    vectors.pop_back();
+
+    return vec;
+}
+
+template<typename T>
+inline void recycle_scratch_vector(std::vector<T> &vec) noexcept
+{
+    constexpr std::size_t max_num_vectors = 16;
+
+    // A vector that was moved into a tensor has nothing to recycle.
+    if (vec.capacity() == 0) {
+        return;
+    }
+
+    std::vector<std::vector<T>> &vectors = scratch_vectors<T>();
+    if (vectors.size() >= max_num_vectors) {
+        return;
+    }
+
+    vec.clear();
+
+    try {
+        vectors.emplace_back(std::move(vec));
+    }
+    catch (const std::bad_alloc &) {
+        return;
+    }
+}
+
+class Sparse_tensor_builder {
+public:
+    /// @param nnz_hint
+    ///     The expected number of non-zero values of the batch. Used to
+    ///     presize the value and index arrays.
+    /// @param hash_dimension
+    ///     If greater than zero, the keys are folded modulo @p
+    ///     hash_dimension, which must equal the second dimension of @p
+    ///     attr, and the tensor is built in CSR format with int32
+    ///     indices regardless of @p format.
+    explicit Sparse_tensor_builder(const Attribute &attr,
+                                   std::size_t batch_size,
+                                   Sparse_tensor_format format,
+                                   std::size_t nnz_hint,
+                                   std::size_t hash_dimension = 0);
+
+    Sparse_tensor_builder(const Sparse_tensor_builder &) = delete;
+
+    Sparse_tensor_builder &operator=(const Sparse_tensor_builder &) = delete;
+
+    Sparse_tensor_builder(Sparse_tensor_builder &&) = delete;
+
+    Sparse_tensor_builder &operator=(Sparse_tensor_builder &&) = delete;
+
+    virtual ~Sparse_tensor_builder();
+
+    /// Appends the rows of @p other, which must be a builder of the
+    /// same attribute, after the rows of this builder. This allows
+    /// builders that were filled in parallel for consecutive row ranges
+    /// to be combined.
+    virtual void merge(Sparse_tensor_builder &other) = 0;
+
+    virtual void reserve(std::size_t nnz) = 0;
+
+    /// Discards the rows after the first @p num_rows rows; used to roll
+    /// back the rows of a bad instance whose other features failed to
+    /// decode.
+    virtual void truncate(std::size_t num_rows) = 0;
+
+    /// @param pool
+    ///     If specified, the value and index arrays of the tensor are
+    ///     copied into a single buffer taken from @p pool, and the
+    ///     vectors of the builder are recycled for the next builders.
+    ///     Otherwise the vectors are moved into the tensor.
+    virtual Intrusive_ptr<Tensor> build(Tensor_pool *pool = nullptr) = 0;
+
+    std::size_t num_rows() const noexcept
+    {
+        return row_idx_;
+    }
+
+    std::size_t nnz() const noexcept
+    {
+        if (hash_dimension_ != 0) {
+            return hashed_indices_.size();
+        }
+        return coordinates_.back().size();
+    }
+
+protected:
+    bool append_indices(stdx::span<const std::uint64_t> indices);
+
+    bool append_hashed_indices(stdx::span<const std::uint64_t> indices);
+
+    void merge_indices(Sparse_tensor_builder &other);
+
+    void reserve_indices(std::size_t nnz);
+
+    /// Discards the indices of the rows after the first @p num_rows rows
+    /// and returns the number of remaining non-zero values.
+    std::size_t truncate_indices(std::size_t num_rows);
+
+    /// Extrapolates the number of non-zero values of the whole batch
+    /// from the rows appended so far, given that the current row brings
+    /// the total to @p nnz values.
+    std::size_t estimate_capacity(std::size_t nnz) const noexcept;
+
+    Intrusive_ptr<Tensor> build_core(std::unique_ptr<Device_array> &&data);
+
+    /// Builds the tensor from arrays carved out of a single pooled
+    /// buffer; @p data points to the @ref nnz() values of type @p dt.
+    Intrusive_ptr<Tensor>
+    build_pooled(Tensor_pool &pool, Data_type dt, const void *data, std::size_t num_bytes);
+
+private:
+    Intrusive_ptr<Tensor> build_coo(std::unique_ptr<Device_array> &&data, Size_vector &&shape);
+
+    Intrusive_ptr<Tensor> build_csr(std::unique_ptr<Device_array> &&data, Size_vector &&shape);
+
+    Intrusive_ptr<Tensor>
+    build_hashed_csr(std::unique_ptr<Device_array> &&data, Size_vector &&shape);
+
+    const Attribute *attr_;
+    std::size_t batch_size_;
+    bool csr_;
+    std::size_t hash_dimension_;
+    std::size_t row_idx_{};
+    // In COO format holds one index vector per dimension. In CSR format
+    // only the column indices are used; the row indices are implied by
+    // the index pointer array.
+    std::vector<std::vector<std::size_t>> coordinates_{};
+    std::vector<std::size_t> indptr_{};
+    // Hashed features keep their column indices and index pointers in
+    // int32 right away instead of narrowing them in build().
+    std::vector<std::int32_t> hashed_indices_{};
+    std::vector<std::int32_t> hashed_indptr_{};
+};
+
+template<Data_type dt>
+class Sparse_tensor_builder_impl final : public Sparse_tensor_builder {
+public:
+    using value_type = data_type_t<dt>;
+
+    explicit Sparse_tensor_builder_impl(const Attribute &attr,
+                                        std::size_t batch_size,
+                                        Sparse_tensor_format format,
+                                        std::size_t nnz_hint,
+                                        std::size_t hash_dimension)
+        : Sparse_tensor_builder{attr, batch_size, format, nnz_hint, hash_dimension}
+        , data_{take_scratch_vector<value_type>()}
+    {
+        data_.reserve(nnz_hint);
+    }
+
+    Sparse_tensor_builder_impl(const Sparse_tensor_builder_impl &) = delete;
+
+    Sparse_tensor_builder_impl &operator=(const Sparse_tensor_builder_impl &) = delete;
+
+    Sparse_tensor_builder_impl(Sparse_tensor_builder_impl &&) = delete;
+
+    Sparse_tensor_builder_impl &operator=(Sparse_tensor_builder_impl &&) = delete;
+
+    ~Sparse_tensor_builder_impl() final
+    {
+        recycle_scratch_vector(data_);
+    }
+
+    bool append(stdx::span<const value_type> values, stdx::span<const std::uint64_t> indices);
+
+    void merge(Sparse_tensor_builder &other) final;
+
+    void reserve(std::size_t nnz) final;
+
+    void truncate(std::size_t num_rows) final;
+
+    Intrusive_ptr<Tensor> build(Tensor_pool *pool) final;
+
+private:
+    std::vector<value_type> data_;
+};
+
+template<Data_type dt>
+bool Sparse_tensor_builder_impl<dt>::append(stdx::span<const value_type> values,
+                                            stdx::span<const std::uint64_t> indices)
+{
+    std::size_t size = data_.size() + values.size();
+    if (size > data_.capacity()) {
+        // Instead of growing geometrically on each overflow, presize
+        // the arrays for the whole batch in one go.
+        reserve(estimate_capacity(size));
+    }
+
+    if (!append_indices(indices)) {
+        return false;
+    }
+
+    data_.insert(data_.end(), values.begin(), values.end());
+
+    return true;
+}
+
+template<Data_type dt>
+void Sparse_tensor_builder_impl<dt>::merge(Sparse_tensor_builder &other)
+{
+    auto &other_data = static_cast<Sparse_tensor_builder_impl<dt> &>(other).data_;
+
+    data_.insert(data_.end(), other_data.begin(), other_data.end());
+
+    merge_indices(other);
+}
+
+template<Data_type dt>
+void Sparse_tensor_builder_impl<dt>::reserve(std::size_t nnz)
+{
+    data_.reserve(nnz);
+
+    reserve_indices(nnz);
+}
+
+template<Data_type dt>
+void Sparse_tensor_builder_impl<dt>::truncate(std::size_t num_rows)
+{
+    data_.resize(truncate_indices(num_rows));
+}
+
+template<Data_type dt>
+Intrusive_ptr<Tensor> Sparse_tensor_builder_impl<dt>::build(Tensor_pool *pool)
+{
+    if constexpr (std::is_trivially_copyable_v<value_type>) {
+        if (pool != nullptr) {
+            return build_pooled(*pool, dt, data_.data(), data_.size() * sizeof(value_type));
+        }
+    }
+
+    auto data = wrap_cpu_array<dt>(std::move(data_));
+
+    return build_core(std::move(data));
+}
+
+template<Data_type dt>
+struct make_sparse_tensor_builder_op {
+    std::unique_ptr<Sparse_tensor_builder> operator()(const Attribute &attr,
+                                                      std::size_t batch_size,
+                                                      Sparse_tensor_format format,
+                                                      std::size_t nnz_hint,
+                                                      std::size_t hash_dimension)
+    {
+        return std::make_unique<Sparse_tensor_builder_impl<dt>>(
+            attr, batch_size, format, nnz_hint, hash_dimension);
+    }
+};
+
+inline std::unique_ptr<Sparse_tensor_builder>
+make_sparse_tensor_builder(const Attribute &attr,
+                           std::size_t batch_size,
+                           Sparse_tensor_format format,
+                           std::size_t nnz_hint = 0,
+                           std::size_t hash_dimension = 0)
+{
+    return dispatch<make_sparse_tensor_builder_op>(
+        attr.data_type(), attr, batch_size, format, nnz_hint, hash_dimension);
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
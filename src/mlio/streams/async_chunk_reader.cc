@@ -0,0 +1,128 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/async_chunk_reader.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/streams/input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Async_chunk_reader::Async_chunk_reader(std::vector<Intrusive_ptr<Input_stream>> streams,
+                                       std::size_t chunk_size)
+    : streams_{std::move(streams)}, chunk_size_{chunk_size}, num_active_streams_{streams_.size()}
+{
+    if (chunk_size_ == 0) {
+        throw std::invalid_argument{"The chunk size must be greater than zero."};
+    }
+}
+
+Async_chunk_reader::~Async_chunk_reader()
+{
+    // The completion handlers refer to this instance.
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    condition_.wait(lock, [this] {
+        return num_in_flight_ == 0;
+    });
+}
+
+std::optional<Async_chunk> Async_chunk_reader::read_chunk()
+{
+    if (!started_) {
+        started_ = true;
+
+        for (std::size_t i = 0; i < streams_.size(); i++) {
+            start_read(i);
+        }
+    }
+
+    while (true) {
+        Completion completion{};
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            if (num_active_streams_ == 0) {
+                return {};
+            }
+
+            condition_.wait(lock, [this] {
+                return !completions_.empty();
+            });
+
+            completion = std::move(completions_.front());
+
+            completions_.pop_front();
+
+            if (completion.error || completion.num_bytes_read == 0) {
+                num_active_streams_--;
+            }
+        }
+
+        if (completion.error) {
+            std::rethrow_exception(completion.error);
+        }
+
+        if (completion.num_bytes_read == 0) {
+            continue;
+        }
+
+        // Keep the stream busy while the caller consumes the chunk.
+        start_read(completion.stream_idx);
+
+        Memory_slice data{std::move(completion.block)};
+
+        return Async_chunk{completion.stream_idx, data.first(completion.num_bytes_read)};
+    }
+}
+
+void Async_chunk_reader::start_read(std::size_t stream_idx)
+{
+    Intrusive_ptr<Mutable_memory_block> block = memory_allocator().allocate(chunk_size_);
+
+    Mutable_memory_span destination = *block;
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        num_in_flight_++;
+    }
+
+    // The handler might be called from within read_async(); the lock
+    // must therefore not be held while starting the read.
+    streams_[stream_idx]->read_async(
+        destination,
+        [this, stream_idx, block = std::move(block)](std::size_t num_bytes_read,
+                                                      std::exception_ptr error) mutable {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            completions_.push_back(
+                Completion{stream_idx, std::move(block), num_bytes_read, std::move(error)});
+
+            num_in_flight_--;
+
+            // Notify with the lock held; the destructor might otherwise
+            // return before we touch the condition variable.
+            condition_.notify_all();
+        });
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/bzip2_inflate_stream.h"
+
+#include <utility>
+
+#include "mlio/streams/detail/bzip2.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::Bzip2_inflater;
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Bzip2_inflate_stream::Bzip2_inflate_stream(Intrusive_ptr<Input_stream> inner)
+    : inner_{std::move(inner)}
+{
+    inflater_ = std::make_unique<Bzip2_inflater>();
+}
+
+Bzip2_inflate_stream::~Bzip2_inflate_stream() = default;
+
+std::size_t Bzip2_inflate_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    // bzip2 inflates a whole block at a time; unlike with zlib we might
+    // have to feed several buffers before we get any output.
+    for (;;) {
+        bool has_input = true;
+
+        if (buffer_pos_ == buffer_.end()) {
+            buffer_ = inner_->read(0x8'0000);  // 512 KiB
+
+            // Make sure to reset the position before checking whether
+            // we reached the end of the stream; otherwise the function
+            // won't behave correctly if called a second time.
+            buffer_pos_ = buffer_.begin();
+
+            if (buffer_.empty()) {
+                if (inflater_->eof()) {
+                    return 0;
+                }
+
+                // The inflater might still hold data that did not fit
+                // into the previous destination.
+                has_input = false;
+            }
+        }
+
+        Memory_span inp{buffer_pos_, buffer_.end()};
+
+        auto out = destination;
+
+        inflater_->inflate(inp, out);
+
+        buffer_pos_ = buffer_.end() - stdx::ssize(inp);
+
+        std::size_t num_bytes_inflated = destination.size() - out.size();
+        if (num_bytes_inflated > 0) {
+            return num_bytes_inflated;
+        }
+
+        if (!has_input) {
+            throw Inflate_error{"The bzip2 stream contains invalid or incomplete data."};
+        }
+    }
+}
+
+void Bzip2_inflate_stream::close() noexcept
+{
+    inner_->close();
+
+    inflater_ = nullptr;
+
+    buffer_ = {};
+}
+
+bool Bzip2_inflate_stream::closed() const noexcept
+{
+    return inner_->closed();
+}
+
+void Bzip2_inflate_stream::check_if_closed() const
+{
+    if (inner_->closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
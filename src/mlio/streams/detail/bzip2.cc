@@ -0,0 +1,388 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/bzip2.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Bzip2_marker find_bzip2_marker(Memory_span data, std::size_t first, std::size_t last) noexcept
+{
+    constexpr std::size_t marker_size = 48;
+    constexpr std::uint64_t marker_mask = (std::uint64_t{1} << marker_size) - 1;
+
+    auto bytes = as_span<const std::uint8_t>(data);
+
+    last = std::min(last, bytes.size() * 8);
+
+    std::uint64_t acc = 0;
+
+    std::size_t num_bits = 0;
+
+    // Shift in one byte at a time and test the eight windows that end
+    // within it, in order of their start positions.
+    for (std::size_t i = first / 8; i < bytes.size(); i++) {
+        acc = (acc << 8) | bytes[i];
+
+        num_bits += 8;
+
+        std::size_t end = (i + 1) * 8;
+
+        for (std::size_t k = 8; k-- > 0;) {
+            if (num_bits < marker_size + k) {
+                continue;
+            }
+
+            std::size_t start = end - k - marker_size;
+            if (start < first) {
+                continue;
+            }
+            if (start >= last) {
+                return {last, false};
+            }
+
+            std::uint64_t value = (acc >> k) & marker_mask;
+            if (value == bzip2_block_magic) {
+                return {start, false};
+            }
+            if (value == bzip2_eos_magic) {
+                return {start, true};
+            }
+        }
+    }
+
+    return {last, false};
+}
+
+std::uint64_t read_bits(Memory_span data, std::size_t bit_pos, std::size_t num_bits) noexcept
+{
+    auto bytes = as_span<const std::uint8_t>(data);
+
+    std::uint64_t value = 0;
+
+    for (std::size_t i = bit_pos; i < bit_pos + num_bits; i++) {
+        auto bit = (bytes[i / 8] >> (7 - i % 8)) & 1U;
+
+        value = (value << 1) | bit;
+    }
+
+    return value;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#ifdef MLIO_BUILD_BZIP2
+
+#include <new>
+#include <vector>
+
+#include <bzlib.h>
+
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/util.h"
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Bzip2_stream_state {
+    ::bz_stream stream{};
+};
+
+namespace {
+
+class Bit_writer {
+public:
+    void put(std::uint64_t value, std::size_t num_bits)
+    {
+        for (std::size_t i = num_bits; i-- > 0;) {
+            acc_ = static_cast<std::uint8_t>((acc_ << 1) | ((value >> i) & 1U));
+
+            if (++num_acc_bits_ == 8) {
+                flush_byte();
+            }
+        }
+    }
+
+    // Appends the bit range [first, last) of @p data.
+    void put_range(Memory_span data, std::size_t first, std::size_t last)
+    {
+        auto bytes = as_span<const std::uint8_t>(data);
+
+        // Copy whole bytes if we are byte-aligned; this is always the
+        // case for the first range we are given.
+        if (num_acc_bits_ == 0) {
+            std::size_t shift = first % 8;
+            std::size_t num_bytes = (last - first) / 8;
+
+            const std::uint8_t *src = bytes.data() + first / 8;
+
+            if (shift == 0) {
+                buffer_.insert(buffer_.end(), src, src + num_bytes);
+            }
+            else {
+                for (std::size_t i = 0; i < num_bytes; i++) {
+                    buffer_.push_back(
+                        static_cast<std::uint8_t>((src[i] << shift) | (src[i + 1] >> (8 - shift))));
+                }
+            }
+
+            first += num_bytes * 8;
+        }
+
+        put(read_bits(data, first, last - first), last - first);
+    }
+
+    std::vector<std::uint8_t> &finish()
+    {
+        if (num_acc_bits_ > 0) {
+            acc_ = static_cast<std::uint8_t>(acc_ << (8 - num_acc_bits_));
+
+            flush_byte();
+        }
+
+        return buffer_;
+    }
+
+private:
+    void flush_byte()
+    {
+        buffer_.push_back(acc_);
+
+        acc_ = 0;
+
+        num_acc_bits_ = 0;
+    }
+
+    std::vector<std::uint8_t> buffer_{};
+    std::uint8_t acc_{};
+    std::size_t num_acc_bits_{};
+};
+
+}  // namespace
+
+Bzip2_inflater::Bzip2_inflater() : state_{std::make_unique<Bzip2_stream_state>()}
+{
+    init();
+}
+
+Bzip2_inflater::~Bzip2_inflater()
+{
+    end();
+}
+
+void Bzip2_inflater::init()
+{
+    state_->stream = {};
+
+    int r = ::BZ2_bzDecompressInit(&state_->stream, 0, 0);
+    if (r == BZ_MEM_ERROR) {
+        throw std::bad_alloc{};
+    }
+    if (r != BZ_OK) {
+        throw Inflate_error{"The bzip2 decompressor cannot be initialized."};
+    }
+}
+
+void Bzip2_inflater::end() noexcept
+{
+    ::BZ2_bzDecompressEnd(&state_->stream);
+}
+
+void Bzip2_inflater::inflate(Memory_span &inp, Mutable_memory_span &out)
+{
+    ::bz_stream &stream = state_->stream;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    stream.next_in = const_cast<char *>(reinterpret_cast<const char *>(inp.data()));
+    stream.next_out = reinterpret_cast<char *>(out.data());
+
+    stream.avail_in = static_cast<unsigned>(std::min<std::size_t>(inp.size(), 0xFFFF'FFFF));
+    stream.avail_out = static_cast<unsigned>(std::min<std::size_t>(out.size(), 0xFFFF'FFFF));
+
+    std::size_t avail_in = stream.avail_in;
+    std::size_t avail_out = stream.avail_out;
+
+    int r = ::BZ2_bzDecompress(&stream);
+
+    inp = inp.subspan(avail_in - stream.avail_in);
+    out = out.subspan(avail_out - stream.avail_out);
+
+    switch (r) {
+    case BZ_OK:
+        eof_ = false;
+        break;
+
+    case BZ_STREAM_END:
+        end();
+        init();
+
+        eof_ = true;
+        break;
+
+    case BZ_MEM_ERROR:
+        throw std::bad_alloc{};
+
+    default:
+        throw Inflate_error{"The bzip2 stream contains invalid or incomplete data."};
+    }
+}
+
+bool inflate_bzip2_block(Memory_span data,
+                         std::size_t start,
+                         std::size_t stop,
+                         std::size_t max_output_size,
+                         Bzip2_block &block)
+{
+    constexpr std::size_t marker_size = 48;
+    constexpr std::size_t crc_size = 32;
+
+    if (stop < start + marker_size + crc_size) {
+        return false;
+    }
+
+    auto crc = static_cast<std::uint32_t>(read_bits(data, start + marker_size, crc_size));
+
+    // A single-block stream with the maximum block size; its combined
+    // CRC equals the CRC of its only block.
+    Bit_writer writer{};
+
+    writer.put(0x425A'6839, 32);  // "BZh9"
+
+    writer.put_range(data, start, stop);
+
+    writer.put(bzip2_eos_magic, marker_size);
+    writer.put(crc, crc_size);
+
+    std::vector<std::uint8_t> &inp = writer.finish();
+
+    ::bz_stream stream{};
+
+    int r = ::BZ2_bzDecompressInit(&stream, 0, 0);
+    if (r != BZ_OK) {
+        throw std::bad_alloc{};
+    }
+
+    stream.next_in = reinterpret_cast<char *>(inp.data());
+    stream.avail_in = static_cast<unsigned>(inp.size());
+
+    // bzip2 rarely compresses by more than a factor of eight.
+    std::size_t initial_size = std::min(max_output_size, std::max(inp.size() * 8, 0x10'0000UL));
+
+    auto out = memory_allocator().allocate(initial_size);
+
+    std::size_t num_bytes_written = 0;
+
+    bool ok = false;
+
+    for (;;) {
+        auto o_buf = make_span(*out).subspan(num_bytes_written);
+
+        stream.next_out = reinterpret_cast<char *>(o_buf.data());
+        stream.avail_out = static_cast<unsigned>(o_buf.size());
+
+        r = ::BZ2_bzDecompress(&stream);
+
+        num_bytes_written += o_buf.size() - stream.avail_out;
+
+        if (r == BZ_STREAM_END) {
+            ok = true;
+
+            break;
+        }
+
+        if (r == BZ_MEM_ERROR) {
+            ::BZ2_bzDecompressEnd(&stream);
+
+            throw std::bad_alloc{};
+        }
+
+        if (r != BZ_OK) {
+            break;
+        }
+
+        if (stream.avail_out == 0) {
+            if (out->size() >= max_output_size) {
+                break;
+            }
+
+            out = resize_memory_block(out, std::min(max_output_size, out->size() * 2));
+        }
+        else if (stream.avail_in == 0) {
+            // The block is truncated.
+            break;
+        }
+    }
+
+    ::BZ2_bzDecompressEnd(&stream);
+
+    if (!ok) {
+        return false;
+    }
+
+    block.output = Memory_slice{std::move(out)}.first(num_bytes_written);
+    block.crc = crc;
+
+    return true;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Bzip2_stream_state {};
+
+Bzip2_inflater::Bzip2_inflater()
+{
+    throw Not_supported_error{"MLIO was not built with bzip2 support."};
+}
+
+Bzip2_inflater::~Bzip2_inflater() = default;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Bzip2_inflater::inflate(Memory_span &, Mutable_memory_span &)
+{}
+
+#pragma GCC diagnostic pop
+
+bool inflate_bzip2_block(Memory_span, std::size_t, std::size_t, std::size_t, Bzip2_block &)
+{
+    throw Not_supported_error{"MLIO was not built with bzip2 support."};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
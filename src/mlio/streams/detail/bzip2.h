@@ -0,0 +1,102 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Wraps bz_stream, which bzlib.h declares as an anonymous struct that
+// cannot be forward declared.
+struct Bzip2_stream_state;
+
+class Bzip2_inflater {
+public:
+    explicit Bzip2_inflater();
+
+    Bzip2_inflater(const Bzip2_inflater &) = delete;
+
+    Bzip2_inflater &operator=(const Bzip2_inflater &) = delete;
+
+    Bzip2_inflater(Bzip2_inflater &&) = delete;
+
+    Bzip2_inflater &operator=(Bzip2_inflater &&) = delete;
+
+    ~Bzip2_inflater();
+
+    // Once a stream ends, the inflater starts over so that concatenated
+    // streams, as written by tools like pbzip2, are inflated as one.
+    void inflate(Memory_span &inp, Mutable_memory_span &out);
+
+    bool eof() const noexcept
+    {
+        return eof_;
+    }
+
+private:
+    void init();
+
+    void end() noexcept;
+
+    std::unique_ptr<Bzip2_stream_state> state_;
+    bool eof_ = true;
+};
+
+// The magic numbers that precede each block and the end of each stream;
+// neither is aligned to a byte boundary.
+inline constexpr std::uint64_t bzip2_block_magic = 0x3141'5926'5359;
+inline constexpr std::uint64_t bzip2_eos_magic = 0x1772'4538'5090;
+
+struct Bzip2_marker {
+    // The position of the marker in bits.
+    std::size_t bit_pos;
+    bool eos;
+};
+
+// Finds the first block or end-of-stream marker starting in the bit
+// range [first, last); returns a marker at @p last if there is none.
+Bzip2_marker find_bzip2_marker(Memory_span data, std::size_t first, std::size_t last) noexcept;
+
+// Reads @p num_bits bits at the specified bit position, most
+// significant bit first.
+std::uint64_t read_bits(Memory_span data, std::size_t bit_pos, std::size_t num_bits) noexcept;
+
+struct Bzip2_block {
+    Memory_slice output{};
+    std::uint32_t crc{};
+};
+
+// Inflates the block that spans the bit range [start, stop) by wrapping
+// it into a single-block stream. Returns false if the range does not
+// hold a valid block, for instance because one of its markers is a
+// false positive, or if the block inflates to more than
+// @p max_output_size bytes.
+bool inflate_bzip2_block(Memory_span data,
+                         std::size_t start,
+                         std::size_t stop,
+                         std::size_t max_output_size,
+                         Bzip2_block &block);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,356 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/gzip_decoder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <new>
+
+#include "mlio/not_supported_error.h"
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::uint8_t gzip_id1 = 0x1f;
+constexpr std::uint8_t gzip_id2 = 0x8b;
+constexpr std::uint8_t gzip_cm_deflate = 0x08;
+
+constexpr std::uint8_t gzip_fhcrc = 0x02;
+constexpr std::uint8_t gzip_fextra = 0x04;
+constexpr std::uint8_t gzip_fname = 0x08;
+constexpr std::uint8_t gzip_fcomment = 0x10;
+constexpr std::uint8_t gzip_freserved = 0xe0;
+
+inline const std::uint8_t *byte_ptr(Memory_span input) noexcept
+{
+    return as_span<const std::uint8_t>(input).data();
+}
+
+inline bool is_member_start(Memory_span input, std::size_t position) noexcept
+{
+    if (input.size() - position < 4) {
+        return false;
+    }
+
+    const std::uint8_t *p = byte_ptr(input) + position;
+
+    return p[0] == gzip_id1 && p[1] == gzip_id2 && p[2] == gzip_cm_deflate &&
+           (p[3] & gzip_freserved) == 0;
+}
+
+// A flush in deflate emits an empty stored block whose length fields
+// are encoded as these four bytes.
+inline bool ends_with_flush_marker(Memory_span input, std::size_t position) noexcept
+{
+    if (position < 4) {
+        return false;
+    }
+
+    const std::uint8_t *p = byte_ptr(input) + position - 4;
+
+    return p[0] == 0x00 && p[1] == 0x00 && p[2] == 0xff && p[3] == 0xff;
+}
+
+inline std::uint32_t read_uint32_le(const std::uint8_t *p) noexcept
+{
+    return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8U |
+           static_cast<std::uint32_t>(p[2]) << 16U | static_cast<std::uint32_t>(p[3]) << 24U;
+}
+
+[[noreturn]] void throw_invalid_data()
+{
+    throw Inflate_error{"The zlib stream contains invalid or incomplete deflate data."};
+}
+
+}  // namespace
+
+Gzip_decoder::Gzip_decoder(Memory_span input,
+                           std::size_t position,
+                           std::optional<Gzip_checksum> prefix,
+                           Memory_span dictionary)
+    : input_{input}, position_{position}, has_prefix_{prefix.has_value()}
+{
+    // We parse the gzip headers and trailers ourselves so that we can
+    // start in the middle of a member.
+    int r = ::inflateInit2(&stream_, -MAX_WBITS);
+    if (r != Z_OK) {
+        if (r == Z_MEM_ERROR) {
+            throw std::bad_alloc{};
+        }
+        if (r == Z_VERSION_ERROR) {
+            throw Not_supported_error{"The zlib library has an unsupported version."};
+        }
+        assert(false);
+    }
+
+    if (position_ == input_.size()) {
+        state_ = State::done;
+    }
+    else if (is_member_start(input_, position_)) {
+        state_ = State::header;
+    }
+    else {
+        state_ = State::deflate;
+
+        if (prefix) {
+            checksum_ = *prefix;
+        }
+
+        if (!dictionary.empty()) {
+            auto dict = as_span<const ::Bytef>(dictionary);
+
+            ::inflateSetDictionary(&stream_, dict.data(), static_cast<::uInt>(dict.size()));
+        }
+    }
+}
+
+Gzip_decoder::~Gzip_decoder()
+{
+    ::inflateEnd(&stream_);
+}
+
+void Gzip_decoder::decode(Mutable_memory_span &out, std::size_t stop)
+{
+    stopped_ = false;
+
+    for (;;) {
+        switch (state_) {
+        case State::header:
+            if (position_ >= stop) {
+                stopped_ = true;
+
+                return;
+            }
+
+            read_header();
+
+            break;
+
+        case State::deflate: {
+            if (out.empty()) {
+                return;
+            }
+
+            auto i_buf = as_span<const ::Bytef>(input_.subspan(position_));
+            auto o_buf = as_span<::Bytef>(out);
+
+            auto i_size = std::min<std::size_t>(i_buf.size(), std::numeric_limits<::uInt>::max());
+            auto o_size = std::min<std::size_t>(o_buf.size(), std::numeric_limits<::uInt>::max());
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            stream_.next_in = const_cast<::Bytef *>(i_buf.data());
+            stream_.next_out = o_buf.data();
+
+            stream_.avail_in = static_cast<::uInt>(i_size);
+            stream_.avail_out = static_cast<::uInt>(o_size);
+
+            // Z_BLOCK makes inflate() return at each block boundary so
+            // that we can detect the sync points.
+            int r = ::inflate(&stream_, Z_BLOCK);
+
+            std::size_t num_bytes_read = i_size - stream_.avail_in;
+            std::size_t num_bytes_written = o_size - stream_.avail_out;
+
+            checksum_.crc = static_cast<std::uint32_t>(
+                ::crc32(checksum_.crc, o_buf.data(), static_cast<::uInt>(num_bytes_written)));
+            checksum_.size += num_bytes_written;
+
+            position_ += num_bytes_read;
+
+            out = out.subspan(num_bytes_written);
+
+            switch (r) {
+            case Z_STREAM_END:
+                state_ = State::trailer;
+                break;
+
+            case Z_OK:
+                if (position_ >= stop && at_flush_boundary()) {
+                    stopped_ = true;
+
+                    return;
+                }
+                break;
+
+            case Z_BUF_ERROR:
+                // No progress was possible; since we always provide
+                // space for the output, the input must be incomplete.
+                if (num_bytes_read == 0 && num_bytes_written == 0) {
+                    throw_invalid_data();
+                }
+                break;
+
+            case Z_MEM_ERROR:
+                throw std::bad_alloc{};
+
+            default:
+                throw_invalid_data();
+            }
+
+            break;
+        }
+
+        case State::trailer:
+            read_trailer();
+
+            break;
+
+        case State::done:
+            stopped_ = true;
+
+            return;
+        }
+    }
+}
+
+void Gzip_decoder::read_header()
+{
+    std::size_t avail = input_.size() - position_;
+
+    const std::uint8_t *p = byte_ptr(input_) + position_;
+
+    if (avail < 10 || !is_member_start(input_, position_)) {
+        throw Inflate_error{"The gzip stream contains an invalid member header."};
+    }
+
+    std::uint8_t flags = p[3];
+
+    std::size_t offset = 10;
+
+    if ((flags & gzip_fextra) != 0) {
+        if (avail < offset + 2) {
+            throw Inflate_error{"The gzip stream contains an invalid member header."};
+        }
+
+        offset += 2 + (static_cast<std::size_t>(p[offset]) |
+                       static_cast<std::size_t>(p[offset + 1]) << 8U);
+    }
+
+    for (std::uint8_t flag : {gzip_fname, gzip_fcomment}) {
+        if ((flags & flag) == 0) {
+            continue;
+        }
+
+        // Skip the zero-terminated string.
+        const std::uint8_t *end = avail > offset ? std::find(p + offset, p + avail, 0) : p + avail;
+        if (end == p + avail) {
+            throw Inflate_error{"The gzip stream contains an invalid member header."};
+        }
+
+        offset = static_cast<std::size_t>(end - p) + 1;
+    }
+
+    if ((flags & gzip_fhcrc) != 0) {
+        offset += 2;
+    }
+
+    if (offset > avail) {
+        throw Inflate_error{"The gzip stream contains an invalid member header."};
+    }
+
+    position_ += offset;
+
+    ::inflateReset(&stream_);
+
+    state_ = State::deflate;
+
+    has_prefix_ = true;
+
+    checksum_ = {};
+}
+
+void Gzip_decoder::read_trailer()
+{
+    if (input_.size() - position_ < 8) {
+        throw_invalid_data();
+    }
+
+    const std::uint8_t *p = byte_ptr(input_) + position_;
+
+    Gzip_member_end end{checksum_, read_uint32_le(p), read_uint32_le(p + 4)};
+
+    if (has_prefix_) {
+        if (end.checksum.crc != end.trailer_crc ||
+            static_cast<std::uint32_t>(end.checksum.size) != end.trailer_size) {
+            throw Inflate_error{"The gzip stream contains a member with an invalid checksum."};
+        }
+    }
+    else {
+        head_ = end;
+    }
+
+    position_ += 8;
+
+    if (position_ == input_.size()) {
+        state_ = State::done;
+    }
+    else {
+        state_ = State::header;
+    }
+
+    has_prefix_ = true;
+
+    checksum_ = {};
+}
+
+bool Gzip_decoder::at_flush_boundary() const noexcept
+{
+    // See the documentation of the data_type field of z_stream. We are
+    // at a flush boundary if inflate() returned right after the end of
+    // a non-final block, no bits of the next byte were consumed, and
+    // the block was an empty stored block.
+    int data_type = stream_.data_type;
+
+    return (data_type & 128) != 0 && (data_type & 64) == 0 && (data_type & 7) == 0 &&
+           ends_with_flush_marker(input_, position_);
+}
+
+std::size_t find_gzip_sync_point(Memory_span input, std::size_t first, std::size_t last) noexcept
+{
+    const std::uint8_t *p = byte_ptr(input);
+
+    last = std::min(last, input.size());
+
+    for (std::size_t i = first; i < last; i++) {
+        if (p[i] == gzip_id1) {
+            if (is_member_start(input, i)) {
+                return i;
+            }
+        }
+        else if (p[i] == 0xff) {
+            if (i + 1 < last && ends_with_flush_marker(input, i + 1)) {
+                return i + 1;
+            }
+        }
+    }
+
+    return last;
+}
+
+Gzip_checksum combine(const Gzip_checksum &a, const Gzip_checksum &b) noexcept
+{
+    auto crc = ::crc32_combine(a.crc, b.crc, static_cast<::z_off_t>(b.size));
+
+    return {static_cast<std::uint32_t>(crc), a.size + b.size};
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <zlib.h>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Holds the running CRC-32 and the length of the inflated data of a
+// gzip member.
+struct Gzip_checksum {
+    std::uint32_t crc{};
+    std::uint64_t size{};
+};
+
+// Holds the checksum of the inflated data of a gzip member up to its
+// end, along with the values stored in its trailer.
+struct Gzip_member_end {
+    Gzip_checksum checksum{};
+    std::uint32_t trailer_crc{};
+    std::uint32_t trailer_size{};
+};
+
+// Inflates a gzip stream, or a part of it, that is held in memory. The
+// decoder can start either at the beginning of a gzip member or at a
+// byte-aligned deflate block, and stops at the first sync point (i.e.
+// a member boundary or a block following a flush) at or after a given
+// position. This allows splitting a stream into parts that can be
+// inflated independently.
+class Gzip_decoder {
+public:
+    // @param prefix
+    //     The checksum of the inflated data of the current member that
+    //     precedes @p position. If not specified, the first member end
+    //     cannot be verified by the decoder and is recorded instead;
+    //     see head().
+    // @param dictionary
+    //     The last 32 KiB of the inflated data preceding @p position.
+    explicit Gzip_decoder(Memory_span input,
+                          std::size_t position,
+                          std::optional<Gzip_checksum> prefix = {},
+                          Memory_span dictionary = {});
+
+    Gzip_decoder(const Gzip_decoder &) = delete;
+
+    Gzip_decoder &operator=(const Gzip_decoder &) = delete;
+
+    Gzip_decoder(Gzip_decoder &&) = delete;
+
+    Gzip_decoder &operator=(Gzip_decoder &&) = delete;
+
+    ~Gzip_decoder();
+
+    // Inflates into @p out until it is full, the end of the stream is
+    // reached, or a sync point at or after @p stop is reached.
+    void decode(Mutable_memory_span &out, std::size_t stop);
+
+    // Indicates whether the decoder has reached a sync point at or
+    // after the last stop position or the end of the stream.
+    bool stopped() const noexcept
+    {
+        return stopped_;
+    }
+
+    bool eof() const noexcept
+    {
+        return state_ == State::done;
+    }
+
+    std::size_t position() const noexcept
+    {
+        return position_;
+    }
+
+    bool at_member_start() const noexcept
+    {
+        return state_ == State::header || state_ == State::done;
+    }
+
+    // Gets the checksum of the data inflated since the start of the
+    // current member or, if it started before the decoder, since the
+    // decoder position.
+    const Gzip_checksum &checksum() const noexcept
+    {
+        return checksum_;
+    }
+
+    // Gets the end of the first member if the decoder started in the
+    // middle of it without a known prefix.
+    const std::optional<Gzip_member_end> &head() const noexcept
+    {
+        return head_;
+    }
+
+private:
+    enum class State { header, deflate, trailer, done };
+
+    void read_header();
+
+    void read_trailer();
+
+    bool at_flush_boundary() const noexcept;
+
+    Memory_span input_;
+    std::size_t position_;
+    ::z_stream stream_{};
+    State state_{};
+    bool stopped_{};
+    bool has_prefix_;
+    Gzip_checksum checksum_{};
+    std::optional<Gzip_member_end> head_{};
+};
+
+// Finds the first position in [@p first, @p last) of @p input that
+// looks like a sync point; that is either the start of a gzip member or
+// the deflate block following a flush marker. Returns @p last if there
+// is no such position.
+std::size_t find_gzip_sync_point(Memory_span input, std::size_t first, std::size_t last) noexcept;
+
+// Combines the checksum of two consecutive pieces of inflated data.
+Gzip_checksum combine(const Gzip_checksum &a, const Gzip_checksum &b) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
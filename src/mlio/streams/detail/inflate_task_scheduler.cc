@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/inflate_task_scheduler.h"
+
+#include <utility>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Inflate_task::~Inflate_task() = default;
+
+void Inflate_task_scheduler::schedule(std::shared_ptr<Inflate_task> task)
+{
+    group_.run([this, task = std::move(task)] {
+        run(*task);
+    });
+}
+
+void Inflate_task_scheduler::wait(Inflate_task &task)
+{
+    run(task);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    condition_.wait(lock, [&task] {
+        return task.state_ == Inflate_task::State::done;
+    });
+}
+
+void Inflate_task_scheduler::wait_all()
+{
+    group_.wait();
+}
+
+void Inflate_task_scheduler::run(Inflate_task &task)
+{
+    auto state = Inflate_task::State::pending;
+    if (!task.state_.compare_exchange_strong(state, Inflate_task::State::running)) {
+        return;
+    }
+
+    task.run();
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        task.state_ = Inflate_task::State::done;
+    }
+
+    condition_.notify_all();
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <tbb/tbb.h>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Represents a part of a compressed stream that a parallel inflate
+// stream inflates ahead of its reader.
+class Inflate_task {
+    friend class Inflate_task_scheduler;
+
+    enum class State { pending, running, done };
+
+public:
+    Inflate_task() noexcept = default;
+
+    Inflate_task(const Inflate_task &) = delete;
+
+    Inflate_task &operator=(const Inflate_task &) = delete;
+
+    Inflate_task(Inflate_task &&) = delete;
+
+    Inflate_task &operator=(Inflate_task &&) = delete;
+
+    virtual ~Inflate_task();
+
+    // Inflates the part; a failure is recorded in the task instead of
+    // being thrown so that the reader can decide how to recover.
+    virtual void run() = 0;
+
+    // Set by the reader when it is no longer interested in the output;
+    // a running task should check it periodically and return early.
+    std::atomic_bool cancelled{};
+
+private:
+    std::atomic<State> state_{State::pending};
+};
+
+// Runs the tasks of a parallel inflate stream on the thread pool. A
+// task is run at most once, either by the thread pool or, if the reader
+// needs it before a worker thread picks it up, on the reading thread.
+class Inflate_task_scheduler {
+public:
+    // Schedules the task to be run on the thread pool.
+    void schedule(std::shared_ptr<Inflate_task> task);
+
+    // Waits for the task to complete. If the task has not been picked up
+    // by the thread pool yet, it is run on the calling thread instead of
+    // blocking.
+    void wait(Inflate_task &task);
+
+    // Waits for all scheduled tasks to return.
+    void wait_all();
+
+private:
+    void run(Inflate_task &task);
+
+    tbb::task_group group_{};
+    std::mutex mutex_{};
+    std::condition_variable condition_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Represents a decompressor that inflates a stream in pieces; this way
+// a stream can choose its decompression library at runtime.
+class Inflater {
+public:
+    Inflater() noexcept = default;
+
+    Inflater(const Inflater &) = delete;
+
+    Inflater &operator=(const Inflater &) = delete;
+
+    Inflater(Inflater &&) = delete;
+
+    Inflater &operator=(Inflater &&) = delete;
+
+    virtual ~Inflater() = default;
+
+    // Inflates @p inp into @p out until either of them is exhausted or
+    // the end of the compressed stream is reached; both spans are
+    // updated to what remains of them.
+    virtual void inflate(Memory_span &inp, Mutable_memory_span &out) = 0;
+
+    // Indicates whether the inflater is at the boundary of two
+    // compressed streams; i.e. whether it is valid for the input to end.
+    virtual bool eof() const noexcept = 0;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
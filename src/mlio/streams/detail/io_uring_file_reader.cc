@@ -0,0 +1,777 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/io_uring_file_reader.h"
+
+#include <system_error>
+
+#ifdef MLIO_HAS_IO_URING
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mlio/detail/error.h"
+#include "mlio/detail/thread.h"
+#include "mlio/logger.h"
+#include "mlio/streams/stream_error.h"
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+#ifdef MLIO_HAS_IO_URING
+
+namespace {
+
+// O_DIRECT requires the file offsets, the lengths and the buffer
+// addresses to be aligned to the logical block size of the device.
+// The page size is a safe upper bound for that.
+constexpr std::size_t io_alignment = 0x1000;
+
+int io_uring_setup(unsigned entries, ::io_uring_params *params) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept
+{
+    return static_cast<int>(
+        ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template<typename T>
+T *ring_field(void *ring, std::uint32_t offset) noexcept
+{
+    return reinterpret_cast<T *>(static_cast<std::byte *>(ring) + offset);
+}
+
+// Waits on the io_uring instances of all readers that have an
+// asynchronous read pending; a ring file descriptor becomes readable
+// once its completion queue has entries. This way a single thread
+// serves any number of files.
+class Io_uring_poller {
+public:
+    static Io_uring_poller &instance()
+    {
+        static Io_uring_poller poller{};
+
+        return poller;
+    }
+
+    Io_uring_poller(const Io_uring_poller &) = delete;
+
+    Io_uring_poller &operator=(const Io_uring_poller &) = delete;
+
+    Io_uring_poller(Io_uring_poller &&) = delete;
+
+    Io_uring_poller &operator=(Io_uring_poller &&) = delete;
+
+    ~Io_uring_poller()
+    {
+        if (!thread_.joinable()) {
+            return;
+        }
+
+        std::uint64_t value = 1;
+        if (::write(stop_fd_.get(), &value, sizeof(value)) == -1) {
+            thread_.detach();
+
+            return;
+        }
+
+        thread_.join();
+    }
+
+    void add(int ring_fd, Io_uring_file_reader *reader)
+    {
+        std::unique_lock<std::recursive_mutex> lock{mutex_};
+
+        if (!thread_.joinable()) {
+            start();
+        }
+
+        ::epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = ring_fd;
+
+        if (::epoll_ctl(epoll_fd_.get(), EPOLL_CTL_ADD, ring_fd, &event) == -1) {
+            throw std::system_error{current_error_code(),
+                                    "The io_uring instance cannot be polled."};
+        }
+
+        readers_[ring_fd] = reader;
+    }
+
+    // Waits for the poller thread if it is dispatching the reader.
+    void remove(int ring_fd) noexcept
+    {
+        std::unique_lock<std::recursive_mutex> lock{mutex_};
+
+        if (readers_.erase(ring_fd) > 0) {
+            ::epoll_ctl(epoll_fd_.get(), EPOLL_CTL_DEL, ring_fd, nullptr);
+        }
+    }
+
+private:
+    Io_uring_poller() = default;
+
+    void start()
+    {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (!epoll_fd_.is_open()) {
+            throw std::system_error{current_error_code(), "The epoll instance cannot be created."};
+        }
+
+        stop_fd_ = ::eventfd(0, EFD_CLOEXEC);
+        if (!stop_fd_.is_open()) {
+            throw std::system_error{current_error_code(), "The eventfd cannot be created."};
+        }
+
+        ::epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = stop_fd_.get();
+
+        if (::epoll_ctl(epoll_fd_.get(), EPOLL_CTL_ADD, stop_fd_.get(), &event) == -1) {
+            throw std::system_error{current_error_code(), "The eventfd cannot be polled."};
+        }
+
+        thread_ = start_thread(&Io_uring_poller::run, this);
+    }
+
+    void run()
+    {
+        std::array<::epoll_event, 64> events{};
+
+        for (;;) {
+            int n = ::epoll_wait(epoll_fd_.get(), events.data(), events.size(), -1);
+            if (n == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                logger::warn("The io_uring poller has stopped. The error code is {0:n}.", errno);
+
+                return;
+            }
+
+            for (auto i = 0; i < n; i++) {
+                int fd = events[static_cast<std::size_t>(i)].data.fd;
+                if (fd == stop_fd_.get()) {
+                    return;
+                }
+
+                dispatch(fd);
+            }
+        }
+    }
+
+    void dispatch(int ring_fd)
+    {
+        // The lock is held while the handler runs so that a reader
+        // cannot be destroyed under us; it is recursive since the
+        // handler might start the next read right away.
+        std::unique_lock<std::recursive_mutex> lock{mutex_};
+
+        auto pos = readers_.find(ring_fd);
+        if (pos == readers_.end()) {
+            return;
+        }
+
+        Io_uring_file_reader *reader = pos->second;
+
+        if (!reader->poll_pending_read()) {
+            return;
+        }
+
+        remove(ring_fd);
+
+        reader->complete_pending_read();
+    }
+
+    File_descriptor epoll_fd_{};
+    File_descriptor stop_fd_{};
+    std::thread thread_{};
+    std::unordered_map<int, Io_uring_file_reader *> readers_{};
+    std::recursive_mutex mutex_{};
+};
+
+}  // namespace
+
+Io_uring_file_reader::Io_uring_file_reader(const std::string &path,
+                                           int fd,
+                                           std::size_t file_size,
+                                           const File_io_params &params)
+    : buffered_fd_{fd}, fd_{fd}, file_size_{file_size}
+{
+    std::size_t queue_depth = std::max(params.queue_depth, std::size_t{1});
+
+    block_size_ = std::max(params.block_size, io_alignment);
+    block_size_ = (block_size_ + io_alignment - 1) & ~(io_alignment - 1);
+
+    if (params.direct_io) {
+        direct_fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        if (direct_fd_.is_open()) {
+            fd_ = direct_fd_.get();
+        }
+        else {
+            logger::warn("The file '{0}' cannot be opened for direct I/O.", path);
+        }
+    }
+
+    try {
+        init_ring(queue_depth);
+
+        init_buffers(queue_depth);
+    }
+    catch (...) {
+        release();
+
+        throw;
+    }
+}
+
+Io_uring_file_reader::~Io_uring_file_reader()
+{
+    cancel_pending_read();
+
+    drain();
+
+    release();
+}
+
+void Io_uring_file_reader::init_ring(std::size_t queue_depth)
+{
+    ::io_uring_params params{};
+
+    int fd = io_uring_setup(static_cast<unsigned>(queue_depth), &params);
+    if (fd == -1) {
+        throw std::system_error{current_error_code(), "The io_uring instance cannot be set up."};
+    }
+
+    ring_fd_ = fd;
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+
+    void *ptr = ::mmap(nullptr,
+                       sq_size_,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       ring_fd_.get(),
+                       IORING_OFF_SQ_RING);
+    if (ptr == MAP_FAILED) {
+        throw std::system_error{current_error_code(), "The io_uring rings cannot be mapped."};
+    }
+
+    sq_ptr_ = ptr;
+
+    if (single_mmap) {
+        cq_ptr_ = sq_ptr_;
+    }
+    else {
+        ptr = ::mmap(nullptr,
+                     cq_size_,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE,
+                     ring_fd_.get(),
+                     IORING_OFF_CQ_RING);
+        if (ptr == MAP_FAILED) {
+            throw std::system_error{current_error_code(), "The io_uring rings cannot be mapped."};
+        }
+
+        cq_ptr_ = ptr;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(::io_uring_sqe);
+
+    ptr = ::mmap(nullptr,
+                 sqes_size_,
+                 PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE,
+                 ring_fd_.get(),
+                 IORING_OFF_SQES);
+    if (ptr == MAP_FAILED) {
+        throw std::system_error{current_error_code(), "The io_uring rings cannot be mapped."};
+    }
+
+    sqes_ = static_cast<::io_uring_sqe *>(ptr);
+
+    sq_tail_ = ring_field<unsigned>(sq_ptr_, params.sq_off.tail);
+    sq_mask_ = *ring_field<unsigned>(sq_ptr_, params.sq_off.ring_mask);
+    sq_array_ = ring_field<unsigned>(sq_ptr_, params.sq_off.array);
+
+    cq_head_ = ring_field<unsigned>(cq_ptr_, params.cq_off.head);
+    cq_tail_ = ring_field<unsigned>(cq_ptr_, params.cq_off.tail);
+    cq_mask_ = *ring_field<unsigned>(cq_ptr_, params.cq_off.ring_mask);
+    cqes_ = ring_field<::io_uring_cqe>(cq_ptr_, params.cq_off.cqes);
+}
+
+void Io_uring_file_reader::init_buffers(std::size_t queue_depth)
+{
+    buffer_memory_size_ = queue_depth * block_size_;
+
+    // Anonymous mappings are page-aligned as required by O_DIRECT.
+    void *ptr = ::mmap(nullptr,
+                       buffer_memory_size_,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+    if (ptr == MAP_FAILED) {
+        throw std::system_error{current_error_code(), "The read buffers cannot be allocated."};
+    }
+
+    buffer_memory_ = ptr;
+
+    buffers_.resize(queue_depth);
+    iovecs_.resize(queue_depth);
+
+    for (std::size_t i = 0; i < queue_depth; i++) {
+        buffers_[i].data = static_cast<std::byte *>(buffer_memory_) + i * block_size_;
+
+        iovecs_[i].iov_base = buffers_[i].data;
+        iovecs_[i].iov_len = block_size_;
+
+        free_buffers_.push_back(i);
+    }
+
+    // Registering the buffers saves the kernel from mapping them on
+    // every read. It can fail if the locked memory limit is too low in
+    // which case we fall back to vectored reads.
+    int r = io_uring_register(ring_fd_.get(),
+                              IORING_REGISTER_BUFFERS,
+                              iovecs_.data(),
+                              static_cast<unsigned>(iovecs_.size()));
+
+    has_fixed_buffers_ = r == 0;
+}
+
+std::size_t Io_uring_file_reader::read(Mutable_memory_span destination)
+{
+    if (destination.empty()) {
+        return 0;
+    }
+
+    issue_reads();
+
+    if (read_queue_.empty()) {
+        return 0;
+    }
+
+    wait(buffers_[read_queue_.front()]);
+
+    return consume_front(destination);
+}
+
+void Io_uring_file_reader::read_async(Mutable_memory_span destination,
+                                      Read_completion_handler handler)
+{
+    std::size_t num_bytes_read = 0;
+
+    std::exception_ptr error{};
+    try {
+        if (!destination.empty()) {
+            issue_reads();
+
+            if (!read_queue_.empty()) {
+                if (!poll_front()) {
+                    pending_destination_ = destination;
+                    pending_handler_ = std::move(handler);
+
+                    try {
+                        Io_uring_poller::instance().add(ring_fd_.get(), this);
+                    }
+                    catch (...) {
+                        handler = std::exchange(pending_handler_, nullptr);
+
+                        throw;
+                    }
+
+                    return;
+                }
+
+                num_bytes_read = consume_front(destination);
+            }
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    handler(num_bytes_read, std::move(error));
+}
+
+bool Io_uring_file_reader::poll_pending_read()
+{
+    if (pending_handler_ == nullptr) {
+        return true;
+    }
+
+    try {
+        return poll_front();
+    }
+    catch (...) {
+        // complete_pending_read() hits the same error again.
+        return true;
+    }
+}
+
+void Io_uring_file_reader::complete_pending_read()
+{
+    if (pending_handler_ == nullptr) {
+        return;
+    }
+
+    Read_completion_handler handler = std::exchange(pending_handler_, nullptr);
+
+    std::size_t num_bytes_read = 0;
+
+    std::exception_ptr error{};
+    try {
+        wait(buffers_[read_queue_.front()]);
+
+        num_bytes_read = consume_front(pending_destination_);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // The handler might start the next read on this reader.
+    handler(num_bytes_read, std::move(error));
+}
+
+void Io_uring_file_reader::cancel_pending_read() noexcept
+{
+    if (pending_handler_ == nullptr) {
+        return;
+    }
+
+    Io_uring_poller::instance().remove(ring_fd_.get());
+
+    Read_completion_handler handler = std::exchange(pending_handler_, nullptr);
+
+    handler(0, std::make_exception_ptr(Stream_error{"The input stream is closed."}));
+}
+
+bool Io_uring_file_reader::poll_front()
+{
+    if (num_pending_submissions_ > 0) {
+        submit_and_wait(0);
+    }
+
+    reap_completions();
+
+    // A completion might have resubmitted an interrupted read.
+    if (num_pending_submissions_ > 0) {
+        submit_and_wait(0);
+    }
+
+    return buffers_[read_queue_.front()].ready;
+}
+
+std::size_t Io_uring_file_reader::consume_front(Mutable_memory_span destination)
+{
+    std::size_t buffer_idx = read_queue_.front();
+
+    Buffer &buffer = buffers_[buffer_idx];
+
+    if (buffer.error != 0) {
+        throw std::system_error{buffer.error, std::generic_category(), "The file cannot be read."};
+    }
+
+    std::size_t num_bytes_avail = buffer.num_bytes_read - std::min(buffer_pos_, buffer.num_bytes_read);
+
+    std::size_t num_bytes_read = std::min(destination.size(), num_bytes_avail);
+
+    std::memcpy(destination.data(), buffer.data + buffer_pos_, num_bytes_read);
+
+    buffer_pos_ += num_bytes_read;
+
+    position_ += num_bytes_read;
+
+    if (buffer_pos_ >= buffer.num_bytes_read) {
+        // A short read means we have reached the end of the file.
+        if (buffer.num_bytes_read < buffer.size) {
+            next_offset_ = file_size_;
+        }
+
+        read_queue_.pop_front();
+
+        free_buffers_.push_back(buffer_idx);
+
+        buffer_pos_ = 0;
+    }
+
+    return num_bytes_read;
+}
+
+void Io_uring_file_reader::seek(std::size_t position)
+{
+    drain();
+
+    // Anything still queued has been read for the old position.
+    while (!read_queue_.empty()) {
+        free_buffers_.push_back(read_queue_.front());
+
+        read_queue_.pop_front();
+    }
+
+    position_ = position;
+
+    next_offset_ = position - position % block_size_;
+
+    buffer_pos_ = position % block_size_;
+}
+
+void Io_uring_file_reader::issue_reads()
+{
+    while (!free_buffers_.empty() && next_offset_ < file_size_) {
+        std::size_t buffer_idx = free_buffers_.front();
+
+        free_buffers_.pop_front();
+
+        Buffer &buffer = buffers_[buffer_idx];
+
+        buffer.offset = next_offset_;
+        buffer.size = block_size_;
+        buffer.num_bytes_read = 0;
+        buffer.error = 0;
+        buffer.ready = false;
+
+        next_offset_ += block_size_;
+
+        prepare_read(buffer_idx);
+
+        read_queue_.push_back(buffer_idx);
+
+        num_in_flight_++;
+    }
+}
+
+void Io_uring_file_reader::prepare_read(std::size_t buffer_idx)
+{
+    const Buffer &buffer = buffers_[buffer_idx];
+
+    // We are the only producer; no need to synchronize with ourselves.
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+
+    ::io_uring_sqe &sqe = sqes_[index];
+
+    std::memset(&sqe, 0, sizeof(sqe));
+
+    sqe.fd = fd_;
+    sqe.off = buffer.offset + buffer.num_bytes_read;
+    sqe.user_data = buffer_idx;
+
+    if (has_fixed_buffers_) {
+        sqe.opcode = IORING_OP_READ_FIXED;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(buffer.data + buffer.num_bytes_read);
+        sqe.len = static_cast<std::uint32_t>(buffer.size - buffer.num_bytes_read);
+        sqe.buf_index = static_cast<std::uint16_t>(buffer_idx);
+    }
+    else {
+        iovecs_[buffer_idx].iov_base = buffer.data + buffer.num_bytes_read;
+        iovecs_[buffer_idx].iov_len = buffer.size - buffer.num_bytes_read;
+
+        sqe.opcode = IORING_OP_READV;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(&iovecs_[buffer_idx]);
+        sqe.len = 1;
+    }
+
+    sq_array_[index] = index;
+
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+    num_pending_submissions_++;
+}
+
+void Io_uring_file_reader::wait(const Buffer &buffer)
+{
+    while (!buffer.ready) {
+        submit_and_wait(1);
+
+        reap_completions();
+    }
+}
+
+void Io_uring_file_reader::submit_and_wait(unsigned min_complete)
+{
+    for (;;) {
+        int r = io_uring_enter(ring_fd_.get(),
+                               num_pending_submissions_,
+                               min_complete,
+                               min_complete > 0 ? IORING_ENTER_GETEVENTS : 0U);
+        if (r >= 0) {
+            num_pending_submissions_ -= static_cast<unsigned>(r);
+
+            return;
+        }
+
+        if (errno != EINTR) {
+            throw std::system_error{current_error_code(), "The io_uring read cannot be submitted."};
+        }
+    }
+}
+
+void Io_uring_file_reader::reap_completions()
+{
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+        const ::io_uring_cqe &cqe = cqes_[head & cq_mask_];
+
+        complete_read(static_cast<std::size_t>(cqe.user_data), cqe.res);
+    }
+
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+
+void Io_uring_file_reader::complete_read(std::size_t buffer_idx, int result)
+{
+    Buffer &buffer = buffers_[buffer_idx];
+
+    if (result == -EAGAIN || result == -EINTR) {
+        prepare_read(buffer_idx);
+
+        return;
+    }
+
+    num_in_flight_--;
+
+    if (result < 0) {
+        buffer.error = -result;
+        buffer.ready = true;
+
+        return;
+    }
+
+    buffer.num_bytes_read += static_cast<std::size_t>(result);
+
+    // The kernel is allowed to return fewer bytes than requested even
+    // before the end of the file. Complete the block synchronously in
+    // such case; the unaligned remainder cannot be read with O_DIRECT.
+    while (result > 0 && buffer.num_bytes_read < buffer.size &&
+           buffer.offset + buffer.num_bytes_read < file_size_) {
+        ssize_t r = ::pread(buffered_fd_,
+                            buffer.data + buffer.num_bytes_read,
+                            buffer.size - buffer.num_bytes_read,
+                            static_cast<::off_t>(buffer.offset + buffer.num_bytes_read));
+        if (r == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            buffer.error = errno;
+
+            break;
+        }
+
+        result = static_cast<int>(r);
+
+        buffer.num_bytes_read += static_cast<std::size_t>(r);
+    }
+
+    buffer.ready = true;
+}
+
+void Io_uring_file_reader::drain() noexcept
+{
+    // The kernel might still write into the buffers; wait for all
+    // outstanding reads before touching them.
+    try {
+        while (num_in_flight_ > 0) {
+            submit_and_wait(1);
+
+            reap_completions();
+        }
+    }
+    catch (const std::system_error &) {
+        num_in_flight_ = 0;
+    }
+}
+
+void Io_uring_file_reader::release() noexcept
+{
+    if (buffer_memory_ != nullptr) {
+        ::munmap(buffer_memory_, buffer_memory_size_);
+    }
+    if (sqes_ != nullptr) {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+        ::munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != nullptr) {
+        ::munmap(sq_ptr_, sq_size_);
+    }
+}
+
+#else
+
+Io_uring_file_reader::Io_uring_file_reader(const std::string &,
+                                           int,
+                                           std::size_t,
+                                           const File_io_params &)
+{
+    throw std::system_error{std::make_error_code(std::errc::function_not_supported),
+                            "io_uring is not supported on this platform."};
+}
+
+Io_uring_file_reader::~Io_uring_file_reader() = default;
+
+std::size_t Io_uring_file_reader::read(Mutable_memory_span)
+{
+    return 0;
+}
+
+void Io_uring_file_reader::read_async(Mutable_memory_span, Read_completion_handler handler)
+{
+    handler(0, nullptr);
+}
+
+void Io_uring_file_reader::seek(std::size_t)
+{}
+
+#endif
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mlio/config.h"
+#include "mlio/detail/file_descriptor.h"
+#include "mlio/span.h"
+#include "mlio/streams/file_input_stream.h"
+#include "mlio/streams/input_stream.h"
+
+#if defined(MLIO_PLATFORM_LINUX) && __has_include(<linux/io_uring.h>)
+#define MLIO_HAS_IO_URING
+#endif
+
+#ifdef MLIO_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Reads a file sequentially by keeping multiple aligned reads in flight
+// through an io_uring instance. Throws std::system_error if io_uring
+// is not available.
+class Io_uring_file_reader {
+public:
+    explicit Io_uring_file_reader(const std::string &path,
+                                  int fd,
+                                  std::size_t file_size,
+                                  const File_io_params &params);
+
+    Io_uring_file_reader(const Io_uring_file_reader &) = delete;
+
+    Io_uring_file_reader &operator=(const Io_uring_file_reader &) = delete;
+
+    Io_uring_file_reader(Io_uring_file_reader &&) = delete;
+
+    Io_uring_file_reader &operator=(Io_uring_file_reader &&) = delete;
+
+    ~Io_uring_file_reader();
+
+    std::size_t read(Mutable_memory_span destination);
+
+    // Completes right away if the next block has already been read;
+    // otherwise registers the ring with the process-wide poller thread,
+    // which completes the read once the block arrives.
+    void read_async(Mutable_memory_span destination, Read_completion_handler handler);
+
+    void seek(std::size_t position);
+
+    std::size_t position() const noexcept
+    {
+        return position_;
+    }
+
+#ifdef MLIO_HAS_IO_URING
+    // Called by the poller thread when the completion queue has entries.
+    // Returns true if the pending read can be completed.
+    bool poll_pending_read();
+
+    // Called by the poller thread once the ring has been unregistered.
+    void complete_pending_read();
+
+private:
+    struct Buffer {
+        std::byte *data{};
+        std::size_t offset{};
+        std::size_t size{};
+        std::size_t num_bytes_read{};
+        int error{};
+        bool ready{};
+    };
+
+    void init_ring(std::size_t queue_depth);
+
+    void init_buffers(std::size_t queue_depth);
+
+    void issue_reads();
+
+    void prepare_read(std::size_t buffer_idx);
+
+    void wait(const Buffer &buffer);
+
+    bool poll_front();
+
+    std::size_t consume_front(Mutable_memory_span destination);
+
+    void cancel_pending_read() noexcept;
+
+    void submit_and_wait(unsigned min_complete);
+
+    void reap_completions();
+
+    void complete_read(std::size_t buffer_idx, int result);
+
+    void drain() noexcept;
+
+    void release() noexcept;
+
+    int buffered_fd_;
+    File_descriptor direct_fd_{};
+    int fd_;
+    std::size_t file_size_;
+    std::size_t block_size_;
+    std::size_t position_{};
+    std::size_t next_offset_{};
+    std::size_t buffer_pos_{};
+
+    File_descriptor ring_fd_{};
+    void *sq_ptr_{};
+    std::size_t sq_size_{};
+    void *cq_ptr_{};
+    std::size_t cq_size_{};
+    ::io_uring_sqe *sqes_{};
+    std::size_t sqes_size_{};
+    unsigned *sq_tail_{};
+    unsigned sq_mask_{};
+    unsigned *sq_array_{};
+    unsigned *cq_head_{};
+    unsigned *cq_tail_{};
+    unsigned cq_mask_{};
+    ::io_uring_cqe *cqes_{};
+    unsigned num_pending_submissions_{};
+
+    void *buffer_memory_{};
+    std::size_t buffer_memory_size_{};
+    std::vector<Buffer> buffers_{};
+    std::vector<::iovec> iovecs_{};
+    bool has_fixed_buffers_{};
+    std::deque<std::size_t> read_queue_{};
+    std::deque<std::size_t> free_buffers_{};
+    std::size_t num_in_flight_{};
+
+    Mutable_memory_span pending_destination_{};
+    Read_completion_handler pending_handler_{};
+#endif
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
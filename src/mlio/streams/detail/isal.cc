@@ -0,0 +1,125 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/isal.h"
+
+#include "mlio/not_supported_error.h"
+
+#ifdef MLIO_BUILD_ISAL
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <isa-l/igzip_lib.h>
+
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Isal_inflater::Isal_inflater() : state_{new ::inflate_state{}}
+{}
+
+Isal_inflater::~Isal_inflater()
+{
+    delete state_;
+}
+
+void Isal_inflater::inflate(Memory_span &inp, Mutable_memory_span &out)
+{
+    if (failed_) {
+        throw Inflate_error{"The zlib stream contains invalid or incomplete deflate data."};
+    }
+
+    if (inp.empty()) {
+        return;
+    }
+
+    // Like zlib, we inflate both gzip and zlib streams. A gzip member
+    // starts with the magic byte 0x1f, while the first byte of a zlib
+    // stream always denotes the deflate method in its low nibble.
+    if (eof_) {
+        ::isal_inflate_init(state_);
+
+        if (inp[0] == std::byte{0x1f}) {
+            state_->crc_flag = ISAL_GZIP;
+        }
+        else {
+            state_->crc_flag = ISAL_ZLIB;
+        }
+
+        eof_ = false;
+    }
+
+    constexpr std::size_t max_size = std::numeric_limits<std::uint32_t>::max();
+
+    auto i_buf = as_span<const std::uint8_t>(inp).first(std::min(inp.size(), max_size));
+    auto o_buf = as_span<std::uint8_t>(out).first(std::min(out.size(), max_size));
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    state_->next_in = const_cast<std::uint8_t *>(i_buf.data());
+    state_->next_out = o_buf.data();
+
+    state_->avail_in = static_cast<std::uint32_t>(i_buf.size());
+    state_->avail_out = static_cast<std::uint32_t>(o_buf.size());
+
+    int r = ::isal_inflate(state_);
+    if (r < 0 || r == ISAL_NEED_DICT) {
+        failed_ = true;
+
+        throw Inflate_error{"The zlib stream contains invalid or incomplete deflate data."};
+    }
+
+    // The trailer, and therefore the checksum, is verified before the
+    // state is marked as finished.
+    eof_ = state_->block_state == ISAL_BLOCK_FINISH;
+
+    inp = inp.subspan(i_buf.size() - state_->avail_in);
+    out = out.subspan(o_buf.size() - state_->avail_out);
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Isal_inflater::Isal_inflater()
+{
+    throw Not_supported_error{"MLIO was not built with ISA-L support."};
+}
+
+Isal_inflater::~Isal_inflater() = default;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Isal_inflater::inflate(Memory_span &, Mutable_memory_span &)
+{}
+
+#pragma GCC diagnostic pop
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "mlio/span.h"
+#include "mlio/streams/detail/inflater.h"
+
+// Defined in igzip_lib.h; forward declared so that the header can be
+// used without the ISA-L library.
+struct inflate_state;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Inflates gzip and zlib streams using the igzip implementation of
+// Intel ISA-L, which is several times faster than zlib on x86-64.
+class Isal_inflater final : public Inflater {
+public:
+    explicit Isal_inflater();
+
+    Isal_inflater(const Isal_inflater &) = delete;
+
+    Isal_inflater &operator=(const Isal_inflater &) = delete;
+
+    Isal_inflater(Isal_inflater &&) = delete;
+
+    Isal_inflater &operator=(Isal_inflater &&) = delete;
+
+    ~Isal_inflater() final;
+
+    void inflate(Memory_span &inp, Mutable_memory_span &out) final;
+
+    bool eof() const noexcept final
+    {
+        return eof_;
+    }
+
+private:
+    ::inflate_state *state_{};
+    bool eof_ = true;
+    bool failed_{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/lz4.h"
+
+#include "mlio/not_supported_error.h"
+
+#ifdef MLIO_BUILD_LZ4
+
+#include <new>
+
+#include <lz4frame.h>
+
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Lz4_inflater::Lz4_inflater()
+{
+    ::LZ4F_errorCode_t r = ::LZ4F_createDecompressionContext(&ctx_, LZ4F_VERSION);
+    if (::LZ4F_isError(r) == 0) {
+        return;
+    }
+
+    if (ctx_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    ::LZ4F_freeDecompressionContext(ctx_);
+
+    throw Not_supported_error{"The LZ4 library has an unsupported version."};
+}
+
+Lz4_inflater::~Lz4_inflater()
+{
+    ::LZ4F_freeDecompressionContext(ctx_);
+}
+
+void Lz4_inflater::inflate(Memory_span &inp, Mutable_memory_span &out)
+{
+    std::size_t i_size = inp.size();
+    std::size_t o_size = out.size();
+
+    std::size_t r = ::LZ4F_decompress(ctx_, out.data(), &o_size, inp.data(), &i_size, nullptr);
+    if (::LZ4F_isError(r) != 0) {
+        // The decompression context has to be reset before it can be
+        // used again.
+        ::LZ4F_resetDecompressionContext(ctx_);
+
+        throw Inflate_error{"The LZ4 stream contains invalid or incomplete data."};
+    }
+
+    // A return value of zero means that a frame has been fully decoded
+    // and flushed; the context is then ready for the next frame.
+    eof_ = r == 0;
+
+    inp = inp.subspan(i_size);
+    out = out.subspan(o_size);
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Lz4_inflater::Lz4_inflater()
+{
+    throw Not_supported_error{"MLIO was not built with LZ4 support."};
+}
+
+Lz4_inflater::~Lz4_inflater() = default;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Lz4_inflater::inflate(Memory_span &, Mutable_memory_span &)
+{}
+
+#pragma GCC diagnostic pop
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "mlio/span.h"
+
+// Defined in lz4frame.h; forward declared so that the header can be
+// used without the LZ4 library.
+struct LZ4F_dctx_s;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Lz4_inflater {
+public:
+    explicit Lz4_inflater();
+
+    Lz4_inflater(const Lz4_inflater &) = delete;
+
+    Lz4_inflater &operator=(const Lz4_inflater &) = delete;
+
+    Lz4_inflater(Lz4_inflater &&) = delete;
+
+    Lz4_inflater &operator=(Lz4_inflater &&) = delete;
+
+    ~Lz4_inflater();
+
+    void inflate(Memory_span &inp, Mutable_memory_span &out);
+
+    bool eof() const noexcept
+    {
+        return eof_;
+    }
+
+private:
+    ::LZ4F_dctx_s *ctx_{};
+    bool eof_ = true;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "mlio/streams/sagemaker_pipe_input_stream.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Shared by all streams opened from the same SageMaker pipe data store
+// since each stream only lives until the end of its epoch.
+struct Sagemaker_pipe_counters {
+    Sagemaker_pipe_stats load() const noexcept
+    {
+        Sagemaker_pipe_stats stats{};
+
+        stats.num_bytes_read = num_bytes_read.load(std::memory_order_relaxed);
+        stats.num_reads = num_reads.load(std::memory_order_relaxed);
+        stats.num_stalls = num_stalls.load(std::memory_order_relaxed);
+        stats.stall_ns = stall_ns.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    std::atomic_uint64_t num_bytes_read{};
+    std::atomic_uint64_t num_reads{};
+    std::atomic_uint64_t num_stalls{};
+    std::atomic_uint64_t stall_ns{};
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
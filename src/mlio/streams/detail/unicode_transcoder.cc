@@ -0,0 +1,287 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#include "mlio/streams/detail/unicode_transcoder.h"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "mlio/endian.h"
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// Upper-cases the name and strips the separators so that the common
+// spellings of an encoding name compare equal.
+std::string normalize_encoding_name(const std::string &name)
+{
+    std::string normalized{};
+    normalized.reserve(name.size());
+
+    for (char chr : name) {
+        if (chr != '-' && chr != '_') {
+            normalized.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(chr))));
+        }
+    }
+
+    return normalized;
+}
+
+// Loads eight bytes so that the byte at offset k occupies bits 8k to
+// 8k + 7 regardless of the host byte order.
+inline std::uint64_t load_word(const void *data) noexcept
+{
+    std::uint64_t word{};
+    std::memcpy(&word, data, sizeof(word));
+
+    return little_to_host_order(word);
+}
+
+// Writes the UTF-8 encoding of the code point and returns the number of
+// bytes written, or zero if the output is too small.
+inline std::size_t encode_utf8(std::uint32_t code_point, unsigned char *out, std::size_t size)
+{
+    if (code_point < 0x80) {
+        if (size < 1) {
+            return 0;
+        }
+
+        out[0] = static_cast<unsigned char>(code_point);
+
+        return 1;
+    }
+
+    if (code_point < 0x800) {
+        if (size < 2) {
+            return 0;
+        }
+
+        out[0] = static_cast<unsigned char>(0xC0 | (code_point >> 6));
+        out[1] = static_cast<unsigned char>(0x80 | (code_point & 0x3F));
+
+        return 2;
+    }
+
+    if (code_point < 0x1'0000) {
+        if (size < 3) {
+            return 0;
+        }
+
+        out[0] = static_cast<unsigned char>(0xE0 | (code_point >> 12));
+        out[1] = static_cast<unsigned char>(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = static_cast<unsigned char>(0x80 | (code_point & 0x3F));
+
+        return 3;
+    }
+
+    if (size < 4) {
+        return 0;
+    }
+
+    out[0] = static_cast<unsigned char>(0xF0 | (code_point >> 18));
+    out[1] = static_cast<unsigned char>(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = static_cast<unsigned char>(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = static_cast<unsigned char>(0x80 | (code_point & 0x3F));
+
+    return 4;
+}
+
+}  // namespace
+
+std::unique_ptr<Unicode_transcoder> Unicode_transcoder::make(const Text_encoding &encoding)
+{
+    std::string name = normalize_encoding_name(encoding.name());
+
+    Kind kind{};
+    if (name == "ISO88591" || name == "LATIN1" || name == "L1") {
+        kind = Kind::latin1;
+    }
+    else if (name == "UTF16LE") {
+        kind = Kind::utf16_le;
+    }
+    else if (name == "UTF16BE") {
+        kind = Kind::utf16_be;
+    }
+    else {
+        return nullptr;
+    }
+
+    return std::unique_ptr<Unicode_transcoder>{new Unicode_transcoder{encoding, kind}};
+}
+
+Iconv_status Unicode_transcoder::convert(Memory_span &inp, Mutable_memory_span &out) const
+{
+    switch (kind_) {
+    case Kind::latin1:
+        return convert_latin1(inp, out);
+    case Kind::utf16_le:
+        return convert_utf16<false>(inp, out);
+    case Kind::utf16_be:
+        return convert_utf16<true>(inp, out);
+    }
+
+    return Iconv_status::ok;
+}
+
+Iconv_status
+Unicode_transcoder::convert_latin1(Memory_span &inp, Mutable_memory_span &out) const noexcept
+{
+    constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080;
+
+    const std::byte *i_pos = inp.data();
+    const std::byte *i_end = i_pos + inp.size();
+
+    auto *o_pos = reinterpret_cast<unsigned char *>(out.data());
+    auto *o_end = o_pos + out.size();
+
+    Iconv_status status = Iconv_status::ok;
+
+    while (i_pos < i_end) {
+        // Copy eight ASCII characters at a time.
+        if (i_end - i_pos >= 8 && o_end - o_pos >= 8) {
+            std::uint64_t word = load_word(i_pos);
+            if ((word & high_bits) == 0) {
+                std::memcpy(o_pos, i_pos, sizeof(word));
+
+                i_pos += 8;
+                o_pos += 8;
+
+                continue;
+            }
+        }
+
+        auto chr = static_cast<std::uint32_t>(*i_pos);
+
+        std::size_t num_bytes = encode_utf8(chr, o_pos, static_cast<std::size_t>(o_end - o_pos));
+        if (num_bytes == 0) {
+            status = Iconv_status::leftover;
+
+            break;
+        }
+
+        i_pos++;
+
+        o_pos += num_bytes;
+    }
+
+    inp = inp.last(static_cast<std::size_t>(i_end - i_pos));
+    out = out.last(static_cast<std::size_t>(o_end - o_pos));
+
+    return status;
+}
+
+template<bool big_endian>
+Iconv_status Unicode_transcoder::convert_utf16(Memory_span &inp, Mutable_memory_span &out) const
+{
+    // Set in each 16-bit unit if the unit is not an ASCII character.
+    constexpr std::uint64_t non_ascii_bits = big_endian ? 0x80FF'80FF'80FF'80FF
+                                                        : 0xFF80'FF80'FF80'FF80;
+
+    auto *i_pos = reinterpret_cast<const unsigned char *>(inp.data());
+    auto *i_end = i_pos + inp.size();
+
+    auto *o_pos = reinterpret_cast<unsigned char *>(out.data());
+    auto *o_end = o_pos + out.size();
+
+    auto read_unit = [](const unsigned char *pos) {
+        if constexpr (big_endian) {
+            return static_cast<std::uint32_t>((pos[0] << 8) | pos[1]);
+        }
+        else {
+            return static_cast<std::uint32_t>((pos[1] << 8) | pos[0]);
+        }
+    };
+
+    Iconv_status status = Iconv_status::ok;
+
+    while (i_pos < i_end) {
+        // Narrow four ASCII characters at a time.
+        if (i_end - i_pos >= 8 && o_end - o_pos >= 4) {
+            std::uint64_t word = load_word(i_pos);
+            if ((word & non_ascii_bits) == 0) {
+                for (std::size_t i = 0; i < 4; i++) {
+                    o_pos[i] = i_pos[i * 2 + (big_endian ? 1 : 0)];
+                }
+
+                i_pos += 8;
+                o_pos += 4;
+
+                continue;
+            }
+        }
+
+        if (i_end - i_pos < 2) {
+            status = Iconv_status::incomplete_char;
+
+            break;
+        }
+
+        std::uint32_t code_point = read_unit(i_pos);
+
+        std::ptrdiff_t num_units = 1;
+
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+            if (i_end - i_pos < 4) {
+                status = Iconv_status::incomplete_char;
+
+                break;
+            }
+
+            std::uint32_t low = read_unit(i_pos + 2);
+            if (low < 0xDC00 || low > 0xDFFF) {
+                throw Stream_error{fmt::format(
+                    "An invalid byte sequence encountered while converting from {0} to UTF-8.",
+                    encoding_.name())};
+            }
+
+            code_point = 0x1'0000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+
+            num_units = 2;
+        }
+        else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+            throw Stream_error{fmt::format(
+                "An invalid byte sequence encountered while converting from {0} to UTF-8.",
+                encoding_.name())};
+        }
+
+        std::size_t num_bytes =
+            encode_utf8(code_point, o_pos, static_cast<std::size_t>(o_end - o_pos));
+        if (num_bytes == 0) {
+            status = Iconv_status::leftover;
+
+            break;
+        }
+
+        i_pos += num_units * 2;
+
+        o_pos += num_bytes;
+    }
+
+    inp = inp.last(static_cast<std::size_t>(i_end - i_pos));
+    out = out.last(static_cast<std::size_t>(o_end - o_pos));
+
+    return status;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
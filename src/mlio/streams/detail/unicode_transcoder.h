@@ -0,0 +1,62 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "mlio/span.h"
+#include "mlio/streams/detail/iconv.h"
+#include "mlio/text_encoding.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+/// Converts Latin-1 and UTF-16 text to UTF-8 without going through
+/// iconv. Runs of ASCII characters are converted a word at a time.
+class Unicode_transcoder {
+    enum class Kind { latin1, utf16_le, utf16_be };
+
+public:
+    /// Returns a transcoder for the specified encoding, or a null
+    /// pointer if the encoding is not handled natively.
+    static std::unique_ptr<Unicode_transcoder> make(const Text_encoding &encoding);
+
+    /// Has the same semantics as @ref Iconv_desc::convert().
+    Iconv_status convert(Memory_span &inp, Mutable_memory_span &out) const;
+
+    const Text_encoding &encoding() const noexcept
+    {
+        return encoding_;
+    }
+
+private:
+    explicit Unicode_transcoder(Text_encoding encoding, Kind kind) noexcept
+        : encoding_{std::move(encoding)}, kind_{kind}
+    {}
+
+    Iconv_status convert_latin1(Memory_span &inp, Mutable_memory_span &out) const noexcept;
+
+    template<bool big_endian>
+    Iconv_status convert_utf16(Memory_span &inp, Mutable_memory_span &out) const;
+
+    Text_encoding encoding_;
+    Kind kind_;
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,367 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/zip_archive.h"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include <fmt/format.h>
+#include <zlib.h>
+
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/not_supported_error.h"
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::uint32_t local_header_signature = 0x0403'4b50;
+constexpr std::uint32_t central_header_signature = 0x0201'4b50;
+constexpr std::uint32_t eocd_signature = 0x0605'4b50;
+constexpr std::uint32_t zip64_eocd_signature = 0x0606'4b50;
+constexpr std::uint32_t zip64_locator_signature = 0x0706'4b50;
+
+constexpr std::size_t local_header_size = 30;
+constexpr std::size_t central_header_size = 46;
+constexpr std::size_t eocd_size = 22;
+constexpr std::size_t zip64_eocd_size = 56;
+constexpr std::size_t zip64_locator_size = 20;
+
+constexpr std::uint16_t zip64_extra_id = 0x0001;
+
+constexpr std::uint16_t method_stored = 0;
+constexpr std::uint16_t method_deflate = 8;
+
+constexpr std::uint16_t flag_encrypted = 0x0001;
+
+// zlib takes 32-bit sizes.
+constexpr std::size_t max_zlib_size = std::numeric_limits<::uInt>::max();
+
+[[noreturn]] void throw_corrupt_archive()
+{
+    throw Inflate_error{"The zip archive is corrupt."};
+}
+
+// Reads little-endian integers with bounds checking.
+class Zip_reader {
+public:
+    explicit Zip_reader(Memory_span data) noexcept
+        : data_{as_span<const std::uint8_t>(data)}
+    {}
+
+    template<typename T>
+    T read(std::size_t offset) const
+    {
+        if (offset > data_.size() || data_.size() - offset < sizeof(T)) {
+            throw_corrupt_archive();
+        }
+
+        std::uint64_t value = 0;
+        for (std::size_t i = sizeof(T); i > 0; i--) {
+            value = (value << 8) | data_[offset + i - 1];
+        }
+        return static_cast<T>(value);
+    }
+
+    std::string read_string(std::size_t offset, std::size_t size) const
+    {
+        if (offset > data_.size() || data_.size() - offset < size) {
+            throw_corrupt_archive();
+        }
+
+        const auto *chars = reinterpret_cast<const char *>(data_.data() + offset);
+
+        return std::string(chars, size);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return data_.size();
+    }
+
+private:
+    stdx::span<const std::uint8_t> data_;
+};
+
+std::size_t find_eocd(const Zip_reader &reader)
+{
+    if (reader.size() < eocd_size) {
+        throw_corrupt_archive();
+    }
+
+    // The record ends with a variable-length comment of at most 64 KiB.
+    std::size_t last = reader.size() - eocd_size;
+    std::size_t first = last - std::min<std::size_t>(last, 0xFFFF);
+
+    for (std::size_t offset = last + 1; offset-- > first;) {
+        if (reader.read<std::uint32_t>(offset) == eocd_signature) {
+            return offset;
+        }
+    }
+
+    throw Inflate_error{"The data is not a zip archive."};
+}
+
+void read_zip64_extra(const Zip_reader &reader,
+                      std::size_t offset,
+                      std::size_t size,
+                      Zip_entry &entry,
+                      bool has_size,
+                      bool has_compressed_size,
+                      bool has_header_offset)
+{
+    std::size_t end = offset + size;
+
+    while (end - offset >= 4) {
+        auto id = reader.read<std::uint16_t>(offset);
+        auto field_size = reader.read<std::uint16_t>(offset + 2);
+
+        offset += 4;
+
+        if (id == zip64_extra_id) {
+            // The fields are only present if their 32-bit counterparts
+            // are saturated, in this order.
+            std::size_t pos = offset;
+            if (has_size) {
+                entry.size = reader.read<std::uint64_t>(pos);
+                pos += 8;
+            }
+            if (has_compressed_size) {
+                entry.compressed_size = reader.read<std::uint64_t>(pos);
+                pos += 8;
+            }
+            if (has_header_offset) {
+                entry.header_offset = reader.read<std::uint64_t>(pos);
+                pos += 8;
+            }
+            if (pos > offset + field_size) {
+                throw_corrupt_archive();
+            }
+            return;
+        }
+
+        offset += field_size;
+    }
+
+    if (has_size || has_compressed_size || has_header_offset) {
+        throw_corrupt_archive();
+    }
+}
+
+std::uint32_t compute_crc(Memory_span data) noexcept
+{
+    auto bytes = as_span<const ::Bytef>(data);
+
+    ::uLong crc = ::crc32(0, nullptr, 0);
+
+    while (!bytes.empty()) {
+        std::size_t size = std::min(bytes.size(), max_zlib_size);
+
+        crc = ::crc32(crc, bytes.data(), static_cast<::uInt>(size));
+
+        bytes = bytes.subspan(size);
+    }
+
+    return static_cast<std::uint32_t>(crc);
+}
+
+void inflate_raw(Memory_span inp, Mutable_memory_span out)
+{
+    ::z_stream stream{};
+
+    // A negative window size makes zlib expect raw deflate data.
+    int r = ::inflateInit2(&stream, -MAX_WBITS);
+    if (r == Z_MEM_ERROR) {
+        throw std::bad_alloc{};
+    }
+    if (r != Z_OK) {
+        throw Not_supported_error{"The zlib library has an unsupported version."};
+    }
+
+    auto i_buf = as_span<const ::Bytef>(inp);
+    auto o_buf = as_span<::Bytef>(out);
+
+    do {
+        std::size_t i_size = std::min(i_buf.size(), max_zlib_size);
+        std::size_t o_size = std::min(o_buf.size(), max_zlib_size);
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        stream.next_in = const_cast<::Bytef *>(i_buf.data());
+        stream.next_out = o_buf.data();
+
+        stream.avail_in = static_cast<::uInt>(i_size);
+        stream.avail_out = static_cast<::uInt>(o_size);
+
+        r = ::inflate(&stream, Z_NO_FLUSH);
+
+        i_buf = i_buf.subspan(i_size - stream.avail_in);
+        o_buf = o_buf.subspan(o_size - stream.avail_out);
+    } while (r == Z_OK && !(i_buf.empty() && o_buf.empty()));
+
+    ::inflateEnd(&stream);
+
+    if (r == Z_MEM_ERROR) {
+        throw std::bad_alloc{};
+    }
+    if (r != Z_STREAM_END || !o_buf.empty()) {
+        throw Inflate_error{"The zip archive contains invalid or incomplete deflate data."};
+    }
+}
+
+}  // namespace
+
+std::vector<Zip_entry> read_zip_entries(Memory_span archive)
+{
+    Zip_reader reader{archive};
+
+    std::size_t eocd_offset = find_eocd(reader);
+
+    std::size_t num_entries = reader.read<std::uint16_t>(eocd_offset + 10);
+    std::size_t cd_size = reader.read<std::uint32_t>(eocd_offset + 12);
+    std::size_t cd_offset = reader.read<std::uint32_t>(eocd_offset + 16);
+
+    // Saturated fields indicate a Zip64 archive whose actual values are
+    // stored in a separate record referenced by a locator.
+    if (eocd_offset >= zip64_locator_size &&
+        reader.read<std::uint32_t>(eocd_offset - zip64_locator_size) == zip64_locator_signature) {
+        auto zip64_offset = reader.read<std::uint64_t>(eocd_offset - zip64_locator_size + 8);
+
+        if (reader.read<std::uint32_t>(zip64_offset) != zip64_eocd_signature ||
+            reader.size() - zip64_offset < zip64_eocd_size) {
+            throw_corrupt_archive();
+        }
+
+        num_entries = reader.read<std::uint64_t>(zip64_offset + 32);
+        cd_size = reader.read<std::uint64_t>(zip64_offset + 40);
+        cd_offset = reader.read<std::uint64_t>(zip64_offset + 48);
+    }
+
+    if (cd_offset > reader.size() || reader.size() - cd_offset < cd_size) {
+        throw_corrupt_archive();
+    }
+
+    std::vector<Zip_entry> entries{};
+
+    std::size_t offset = cd_offset;
+
+    for (std::size_t i = 0; i < num_entries; i++) {
+        if (reader.read<std::uint32_t>(offset) != central_header_signature) {
+            throw_corrupt_archive();
+        }
+
+        Zip_entry entry{};
+
+        entry.flags = reader.read<std::uint16_t>(offset + 8);
+        entry.method = reader.read<std::uint16_t>(offset + 10);
+        entry.crc = reader.read<std::uint32_t>(offset + 16);
+        entry.compressed_size = reader.read<std::uint32_t>(offset + 20);
+        entry.size = reader.read<std::uint32_t>(offset + 24);
+
+        std::size_t name_size = reader.read<std::uint16_t>(offset + 28);
+        std::size_t extra_size = reader.read<std::uint16_t>(offset + 30);
+        std::size_t comment_size = reader.read<std::uint16_t>(offset + 32);
+
+        entry.header_offset = reader.read<std::uint32_t>(offset + 42);
+
+        entry.name = reader.read_string(offset + central_header_size, name_size);
+
+        constexpr std::size_t saturated = 0xFFFF'FFFF;
+
+        read_zip64_extra(reader,
+                         offset + central_header_size + name_size,
+                         extra_size,
+                         entry,
+                         entry.size == saturated,
+                         entry.compressed_size == saturated,
+                         entry.header_offset == saturated);
+
+        offset += central_header_size + name_size + extra_size + comment_size;
+
+        if (!entry.name.empty() && entry.name.back() == '/') {
+            continue;
+        }
+
+        entries.emplace_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+Memory_slice inflate_zip_entry(const Memory_slice &archive, const Zip_entry &entry)
+{
+    if ((entry.flags & flag_encrypted) != 0) {
+        throw Not_supported_error{
+            fmt::format("The zip member '{0}' is encrypted, which is not supported.", entry.name)};
+    }
+
+    if (entry.method != method_stored && entry.method != method_deflate) {
+        throw Not_supported_error{fmt::format(
+            "The zip member '{0}' uses the compression method {1}, which is not supported.",
+            entry.name,
+            entry.method)};
+    }
+
+    Zip_reader reader{archive};
+
+    if (reader.read<std::uint32_t>(entry.header_offset) != local_header_signature) {
+        throw_corrupt_archive();
+    }
+
+    // The local header has its own, possibly different, extra field; the
+    // sizes are taken from the central directory though.
+    std::size_t name_size = reader.read<std::uint16_t>(entry.header_offset + 26);
+    std::size_t extra_size = reader.read<std::uint16_t>(entry.header_offset + 28);
+
+    std::size_t data_offset = entry.header_offset + local_header_size + name_size + extra_size;
+    if (data_offset > archive.size() || archive.size() - data_offset < entry.compressed_size) {
+        throw_corrupt_archive();
+    }
+
+    Memory_slice output{};
+
+    if (entry.method == method_stored) {
+        if (entry.compressed_size != entry.size) {
+            throw_corrupt_archive();
+        }
+
+        // No need to copy a stored member; we can hand out the archive
+        // memory as is.
+        output = archive.subslice(data_offset, entry.size);
+    }
+    else {
+        auto block = memory_allocator().allocate(entry.size);
+
+        inflate_raw(archive.subslice(data_offset, entry.compressed_size), *block);
+
+        output = std::move(block);
+    }
+
+    if (compute_crc(output) != entry.crc) {
+        throw Inflate_error{
+            fmt::format("The zip member '{0}' has an invalid checksum.", entry.name)};
+    }
+
+    return output;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mlio/memory/memory_slice.h"
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Describes a file member of a zip archive as recorded in its central
+// directory.
+struct Zip_entry {
+    std::string name{};
+    std::uint16_t flags{};
+    std::uint16_t method{};
+    std::uint32_t crc{};
+    std::size_t compressed_size{};
+    std::size_t size{};
+    std::size_t header_offset{};
+};
+
+// Reads the central directory of the specified archive, including its
+// Zip64 extensions. Directory entries are skipped.
+std::vector<Zip_entry> read_zip_entries(Memory_span archive);
+
+// Inflates the specified member and verifies its checksum. Only the
+// stored and deflate methods are supported.
+Memory_slice inflate_zip_entry(const Memory_slice &archive, const Zip_entry &entry);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
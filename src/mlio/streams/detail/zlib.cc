@@ -25,10 +25,10 @@ namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
-Zlib_inflater::Zlib_inflater()
+Zlib_inflater::Zlib_inflater(bool raw)
 {
-    // Inflate both zlib and gzip.
-    int r = ::inflateInit2(&stream_, MAX_WBITS + 32);
+    // Inflate both zlib and gzip unless the stream is raw deflate.
+    int r = ::inflateInit2(&stream_, raw ? -MAX_WBITS : MAX_WBITS + 32);
     if (r == Z_OK) {
         return;
     }
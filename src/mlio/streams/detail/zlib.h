@@ -18,14 +18,17 @@
 #include <zlib.h>
 
 #include "mlio/span.h"
+#include "mlio/streams/detail/inflater.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 
-class Zlib_inflater {
+class Zlib_inflater final : public Inflater {
 public:
-    explicit Zlib_inflater();
+    // If raw is true, inflates a deflate stream without a zlib or gzip
+    // wrapper; otherwise detects the wrapper.
+    explicit Zlib_inflater(bool raw = false);
 
     Zlib_inflater(const Zlib_inflater &) = delete;
 
@@ -35,11 +38,11 @@ public:
 
     Zlib_inflater &operator=(Zlib_inflater &&) = delete;
 
-    ~Zlib_inflater();
+    ~Zlib_inflater() final;
 
-    void inflate(Memory_span &inp, Mutable_memory_span &out);
+    void inflate(Memory_span &inp, Mutable_memory_span &out) final;
 
-    bool eof() const noexcept
+    bool eof() const noexcept final
     {
         return state_ == Z_STREAM_END;
     }
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/detail/zstd.h"
+
+#ifdef MLIO_BUILD_ZSTD
+
+#include <new>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <zstd.h>
+#include <zstd_errors.h>
+
+#include "mlio/streams/stream_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Zstd_inflater::Zstd_inflater() : ctx_{::ZSTD_createDCtx()}
+{
+    if (ctx_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+}
+
+Zstd_inflater::~Zstd_inflater()
+{
+    ::ZSTD_freeDCtx(ctx_);
+}
+
+void Zstd_inflater::inflate(Memory_span &inp, Mutable_memory_span &out)
+{
+    ::ZSTD_inBuffer i_buf{inp.data(), inp.size(), 0};
+    ::ZSTD_outBuffer o_buf{out.data(), out.size(), 0};
+
+    std::size_t r = ::ZSTD_decompressStream(ctx_, &o_buf, &i_buf);
+    if (::ZSTD_isError(r) != 0) {
+        if (::ZSTD_getErrorCode(r) == ::ZSTD_error_memory_allocation) {
+            throw std::bad_alloc{};
+        }
+        throw Inflate_error{"The zstd stream contains invalid or incomplete data."};
+    }
+
+    // A return value of zero means that a frame has been fully decoded
+    // and flushed.
+    eof_ = r == 0;
+
+    inp = inp.subspan(i_buf.pos);
+    out = out.subspan(o_buf.pos);
+}
+
+void Zstd_inflater::reset() noexcept
+{
+    ::ZSTD_DCtx_reset(ctx_, ::ZSTD_reset_session_only);
+
+    eof_ = true;
+}
+
+std::size_t zstd_compress_bound(std::size_t size)
+{
+    return ::ZSTD_compressBound(size);
+}
+
+std::size_t zstd_compress(Memory_span inp, Mutable_memory_span out, int level)
+{
+    std::size_t r = ::ZSTD_compress(out.data(), out.size(), inp.data(), inp.size(), level);
+    if (::ZSTD_isError(r) != 0) {
+        if (::ZSTD_getErrorCode(r) == ::ZSTD_error_memory_allocation) {
+            throw std::bad_alloc{};
+        }
+        throw std::invalid_argument{
+            fmt::format("The data cannot be compressed: {0}", ::ZSTD_getErrorName(r))};
+    }
+    return r;
+}
+
+void zstd_decompress(Memory_span inp, Mutable_memory_span out)
+{
+    std::size_t r = ::ZSTD_decompress(out.data(), out.size(), inp.data(), inp.size());
+    if (::ZSTD_isError(r) != 0) {
+        if (::ZSTD_getErrorCode(r) == ::ZSTD_error_memory_allocation) {
+            throw std::bad_alloc{};
+        }
+        throw Inflate_error{"The zstd frame contains invalid or incomplete data."};
+    }
+
+    if (r != out.size()) {
+        throw Inflate_error{"The zstd frame has an unexpected decompressed size."};
+    }
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+Zstd_inflater::Zstd_inflater()
+{
+    throw Not_supported_error{"MLIO was not built with Zstandard support."};
+}
+
+Zstd_inflater::~Zstd_inflater() = default;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Zstd_inflater::inflate(Memory_span &, Mutable_memory_span &)
+{}
+
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+void Zstd_inflater::reset() noexcept
+{}
+
+std::size_t zstd_compress_bound(std::size_t)
+{
+    throw Not_supported_error{"MLIO was not built with Zstandard support."};
+}
+
+std::size_t zstd_compress(Memory_span, Mutable_memory_span, int)
+{
+    throw Not_supported_error{"MLIO was not built with Zstandard support."};
+}
+
+void zstd_decompress(Memory_span, Mutable_memory_span)
+{
+    throw Not_supported_error{"MLIO was not built with Zstandard support."};
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
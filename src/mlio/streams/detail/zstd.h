@@ -0,0 +1,73 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mlio/span.h"
+
+// Defined in zstd.h; forward declared so that the header can be used
+// without the Zstandard library.
+struct ZSTD_DCtx_s;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Zstd_inflater {
+public:
+    explicit Zstd_inflater();
+
+    Zstd_inflater(const Zstd_inflater &) = delete;
+
+    Zstd_inflater &operator=(const Zstd_inflater &) = delete;
+
+    Zstd_inflater(Zstd_inflater &&) = delete;
+
+    Zstd_inflater &operator=(Zstd_inflater &&) = delete;
+
+    ~Zstd_inflater();
+
+    void inflate(Memory_span &inp, Mutable_memory_span &out);
+
+    // Discards the state of the current frame.
+    void reset() noexcept;
+
+    bool eof() const noexcept
+    {
+        return eof_;
+    }
+
+private:
+    ::ZSTD_DCtx_s *ctx_{};
+    bool eof_ = true;
+};
+
+// Returns the maximum compressed size of a buffer of the specified size.
+std::size_t zstd_compress_bound(std::size_t size);
+
+// Compresses the input into a single frame and returns the number of
+// bytes written to the output, which must be at least as large as the
+// value returned by zstd_compress_bound.
+std::size_t zstd_compress(Memory_span inp, Mutable_memory_span out, int level);
+
+// Decompresses a single frame; the output must have the exact size of
+// the decompressed data.
+void zstd_decompress(Memory_span inp, Mutable_memory_span out);
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
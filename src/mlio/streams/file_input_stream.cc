@@ -26,14 +26,23 @@
 #include "mlio/detail/error.h"
 #include "mlio/detail/path.h"
 #include "mlio/logger.h"
+#include "mlio/streams/detail/io_uring_file_reader.h"
 #include "mlio/streams/stream_error.h"
 
 using mlio::detail::current_error_code;
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace detail {
+namespace {
 
-File_input_stream::File_input_stream(std::string path) : path_{std::move(path)}
+File_io_params file_io_params{};
+
+}  // namespace
+}  // namespace detail
+
+File_input_stream::File_input_stream(std::string path, const File_io_params &params)
+    : path_{std::move(path)}
 {
     detail::validate_file_path(path_);
 
@@ -48,8 +57,20 @@ File_input_stream::File_input_stream(std::string path) : path_{std::move(path)}
         logger::warn("The read-ahead size of the file '{0}' cannot be increased.", path_);
     }
 #endif
+
+    if (params.use_io_uring) {
+        try {
+            uring_reader_ = std::make_unique<detail::Io_uring_file_reader>(
+                path_, fd_.get(), size(), params);
+        }
+        catch (const std::system_error &e) {
+            logger::warn("The file '{0}' will be read without io_uring: {1}", path_, e.what());
+        }
+    }
 }
 
+File_input_stream::~File_input_stream() = default;
+
 std::size_t File_input_stream::read(Mutable_memory_span destination)
 {
     check_if_closed();
@@ -58,6 +79,10 @@ std::size_t File_input_stream::read(Mutable_memory_span destination)
         return 0;
     }
 
+    if (uring_reader_ != nullptr) {
+        return uring_reader_->read(destination);
+    }
+
     ssize_t num_bytes_read = ::read(fd_.get(), destination.data(), destination.size());
     if (num_bytes_read == -1) {
         throw std::system_error{current_error_code(), "The file cannot be read."};
@@ -65,10 +90,44 @@ std::size_t File_input_stream::read(Mutable_memory_span destination)
     return static_cast<std::size_t>(num_bytes_read);
 }
 
+void File_input_stream::read_async(Mutable_memory_span destination,
+                                   Read_completion_handler handler)
+{
+    if (uring_reader_ == nullptr || closed()) {
+        Input_stream_base::read_async(destination, std::move(handler));
+
+        return;
+    }
+
+    uring_reader_->read_async(destination, std::move(handler));
+}
+
+std::size_t File_input_stream::read_at(std::size_t offset, Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    ssize_t num_bytes_read = ::pread(
+        fd_.get(), destination.data(), destination.size(), static_cast<::off_t>(offset));
+    if (num_bytes_read == -1) {
+        throw std::system_error{current_error_code(), "The file cannot be read."};
+    }
+    return static_cast<std::size_t>(num_bytes_read);
+}
+
 void File_input_stream::seek(std::size_t position)
 {
     check_if_closed();
 
+    if (uring_reader_ != nullptr) {
+        uring_reader_->seek(std::min(position, size()));
+
+        return;
+    }
+
     auto offset = static_cast<::off_t>(std::min(position, size()));
 
     ::off_t o = ::lseek(fd_.get(), offset, SEEK_SET);
@@ -89,6 +148,8 @@ void File_input_stream::seek(std::size_t position)
 
 void File_input_stream::close() noexcept
 {
+    uring_reader_ = {};
+
     fd_ = {};
 }
 
@@ -112,6 +173,10 @@ std::size_t File_input_stream::position() const
 {
     check_if_closed();
 
+    if (uring_reader_ != nullptr) {
+        return uring_reader_->position();
+    }
+
     ::off_t o = ::lseek(fd_.get(), 0, SEEK_CUR);
     if (o == -1) {
         std::error_code err = current_error_code();
@@ -138,5 +203,15 @@ void File_input_stream::check_if_closed() const
     throw Stream_error{"The input stream is closed."};
 }
 
+const File_io_params &default_file_io_params() noexcept
+{
+    return detail::file_io_params;
+}
+
+void set_default_file_io_params(const File_io_params &params) noexcept
+{
+    detail::file_io_params = params;
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -17,20 +17,69 @@
 
 #include <utility>
 
+#include "mlio/config.h"
+#include "mlio/detail/allocation_audit.h"
+#include "mlio/detail/tracing.h"
+#include "mlio/streams/detail/inflater.h"
+#include "mlio/streams/detail/isal.h"
 #include "mlio/streams/detail/zlib.h"
 #include "mlio/streams/input_stream.h"
 #include "mlio/streams/stream_error.h"
 #include "mlio/util/cast.h"
 
+using mlio::detail::Isal_inflater;
 using mlio::detail::Zlib_inflater;
 
 namespace mlio {
 inline namespace abi_v1 {
+namespace detail {
+namespace {
 
-Gzip_inflate_stream::Gzip_inflate_stream(Intrusive_ptr<Input_stream> inner)
+Gzip_inflate_params gzip_inflate_params{};
+
+std::size_t get_input_buffer_size(const Input_stream &inner, const Gzip_inflate_params &params)
+{
+    if (params.input_buffer_size != 0) {
+        return params.input_buffer_size;
+    }
+
+    // A zero-copy read is merely a slice of the underlying memory, so
+    // it costs nothing to take a bigger one.
+    if (inner.supports_zero_copy()) {
+        return 0x40'0000;  // 4 MiB
+    }
+
+    // A larger read lets a stream that reads ahead keep more of its
+    // requests in flight.
+    if (inner.supports_async_read()) {
+        return 0x20'0000;  // 2 MiB
+    }
+
+    return 0x8'0000;  // 512 KiB
+}
+
+}  // namespace
+}  // namespace detail
+
+Gzip_inflate_stream::Gzip_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                         const Gzip_inflate_params &params)
     : inner_{std::move(inner)}
+    , input_buffer_size_{detail::get_input_buffer_size(*inner_, params)}
 {
-    inflater_ = std::make_unique<Zlib_inflater>();
+    bool use_isal{};
+    if (params.backend == Inflate_backend::automatic) {
+        use_isal = supports_isal();
+    }
+    else {
+        use_isal = params.backend == Inflate_backend::isal;
+    }
+
+    if (use_isal) {
+        inflater_ = std::make_unique<Isal_inflater>();
+    }
+    else {
+        inflater_ = std::make_unique<Zlib_inflater>();
+    }
 }
 
 Gzip_inflate_stream::~Gzip_inflate_stream() = default;
@@ -43,30 +92,39 @@ std::size_t Gzip_inflate_stream::read(Mutable_memory_span destination)
         return 0;
     }
 
-    if (buffer_pos_ == buffer_.end()) {
-        buffer_ = inner_->read(0x8'0000);  // 512 KiB
+    detail::Trace_span span{"gzip_inflate"};
+    detail::Allocation_scope scope{detail::Allocation_stage::io};
 
-        // Make sure to reset the position before checking whether we
-        // reached the end of the stream; otherwise the function won't
-        // behave correctly if called a second time.
-        buffer_pos_ = buffer_.begin();
+    auto out = destination;
 
-        if (buffer_.empty()) {
-            if (!inflater_->eof()) {
-                throw Inflate_error{"The zlib stream contains invalid or incomplete deflate data."};
+    // An inflate call can consume input without producing any output,
+    // e.g. a gzip header; since returning zero would signal the end of
+    // the stream, keep going until we have some output.
+    while (out.size() == destination.size()) {
+        if (buffer_pos_ == buffer_.end()) {
+            buffer_ = inner_->read(input_buffer_size_);
+
+            // Make sure to reset the position before checking whether
+            // we reached the end of the stream; otherwise the function
+            // won't behave correctly if called a second time.
+            buffer_pos_ = buffer_.begin();
+
+            if (buffer_.empty()) {
+                if (!inflater_->eof()) {
+                    throw Inflate_error{
+                        "The zlib stream contains invalid or incomplete deflate data."};
+                }
+
+                break;
             }
-
-            return 0;
         }
-    }
-
-    Memory_span inp{buffer_pos_, buffer_.end()};
 
-    auto out = destination;
+        Memory_span inp{buffer_pos_, buffer_.end()};
 
-    inflater_->inflate(inp, out);
+        inflater_->inflate(inp, out);
 
-    buffer_pos_ = buffer_.end() - stdx::ssize(inp);
+        buffer_pos_ = buffer_.end() - stdx::ssize(inp);
+    }
 
     return destination.size() - out.size();
 }
@@ -92,5 +150,15 @@ void Gzip_inflate_stream::check_if_closed() const
     }
 }
 
+const Gzip_inflate_params &default_gzip_inflate_params() noexcept
+{
+    return detail::gzip_inflate_params;
+}
+
+void set_default_gzip_inflate_params(const Gzip_inflate_params &params) noexcept
+{
+    detail::gzip_inflate_params = params;
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
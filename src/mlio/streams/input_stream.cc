@@ -15,10 +15,79 @@
 
 #include "mlio/streams/input_stream.h"
 
+#include <memory>
+#include <utility>
+
+#include "mlio/intrusive_ptr.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/not_supported_error.h"
+
 namespace mlio {
 inline namespace abi_v1 {
 
 Input_stream::~Input_stream() = default;
 
+void Input_stream::read_async(Mutable_memory_span destination, Read_completion_handler handler)
+{
+    std::size_t num_bytes_read{};
+
+    try {
+        num_bytes_read = read(destination);
+    }
+    catch (...) {
+        handler(0, std::current_exception());
+
+        return;
+    }
+
+    handler(num_bytes_read, nullptr);
+}
+
+std::size_t Input_stream::read_at(std::size_t, Mutable_memory_span)
+{
+    throw Not_supported_error{"The input stream does not support positional reads."};
+}
+
+Memory_slice Input_stream::read_at(std::size_t offset, std::size_t size)
+{
+    auto block = memory_allocator().allocate(size);
+
+    Mutable_memory_span remaining_bits{*block};
+    while (!remaining_bits.empty()) {
+        std::size_t num_bytes_read = read_at(offset, remaining_bits);
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        offset += num_bytes_read;
+
+        remaining_bits = remaining_bits.subspan(num_bytes_read);
+    }
+
+    return Memory_slice{std::move(block)}.first(size - remaining_bits.size());
+}
+
+std::future<std::size_t> read_async(Input_stream &stream, Mutable_memory_span destination)
+{
+    // std::function requires a copyable target.
+    auto promise = std::make_shared<std::promise<std::size_t>>();
+
+    std::future<std::size_t> future = promise->get_future();
+
+    stream.read_async(destination,
+                      [promise = std::move(promise)](std::size_t num_bytes_read,
+                                                     std::exception_ptr error) {
+                          if (error) {
+                              promise->set_exception(std::move(error));
+                          }
+                          else {
+                              promise->set_value(num_bytes_read);
+                          }
+                      });
+
+    return future;
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
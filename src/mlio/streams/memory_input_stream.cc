@@ -56,6 +56,24 @@ Memory_slice Memory_input_stream::read(std::size_t size)
     return source_.subslice(old_pos, pos_);
 }
 
+std::size_t Memory_input_stream::read_at(std::size_t offset, Mutable_memory_span destination)
+{
+    Memory_slice bits = read_at(offset, destination.size());
+
+    std::copy(bits.begin(), bits.end(), destination.begin());
+
+    return bits.size();
+}
+
+Memory_slice Memory_input_stream::read_at(std::size_t offset, std::size_t size)
+{
+    check_if_closed();
+
+    offset = std::min(offset, source_.size());
+
+    return source_.subslice(offset, std::min(size, source_.size() - offset));
+}
+
 void Memory_input_stream::seek(std::size_t position)
 {
     check_if_closed();
@@ -0,0 +1,670 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/object_input_stream.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "mlio/detail/object_uri.h"
+#include "mlio/detail/thread.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Object_input_stream::~Object_input_stream()
+{
+    stop();
+}
+
+std::size_t Object_input_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty() || position_ == size_) {
+        return 0;
+    }
+
+    if (num_parallel_ranges_ > 1) {
+        return read_ranges(destination);
+    }
+
+    destination = destination.first(std::min(size_ - position_, destination.size()));
+
+    auto num_bytes_read = client_->read_object(bucket_, key_, version_id_, position_, destination);
+
+    position_ += num_bytes_read;
+
+    return num_bytes_read;
+}
+
+void Object_input_stream::read_async(Mutable_memory_span destination,
+                                     Read_completion_handler handler)
+{
+    if (num_parallel_ranges_ <= 1 || closed_ || destination.empty() || position_ == size_) {
+        Input_stream_base::read_async(destination, std::move(handler));
+
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    try {
+        issue_ranges();
+    }
+    catch (...) {
+        lock.unlock();
+
+        handler(0, std::current_exception());
+
+        return;
+    }
+
+    if (window_.empty() || ranges_[window_.front()].ready) {
+        complete_read(lock, destination, handler);
+
+        return;
+    }
+
+    pending_read_ = Pending_read{destination, std::move(handler)};
+}
+
+std::size_t Object_input_stream::read_at(std::size_t offset, Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty() || offset >= size_) {
+        return 0;
+    }
+
+    destination = destination.first(std::min(size_ - offset, destination.size()));
+
+    return client_->read_object(bucket_, key_, version_id_, offset, destination);
+}
+
+void Object_input_stream::seek(std::size_t position)
+{
+    check_if_closed();
+
+    if (position > size_) {
+        throw std::system_error{std::make_error_code(std::errc::invalid_argument)};
+    }
+
+    if (num_parallel_ranges_ > 1) {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        // If the new position falls into the ranges that are already
+        // fetched or being fetched, keep them instead of starting over.
+        while (!window_.empty()) {
+            const Range &range = ranges_[window_.front()];
+            if (range.offset + range.size > position || !range.ready) {
+                break;
+            }
+
+            free_ranges_.push_back(window_.front());
+
+            window_.pop_front();
+        }
+
+        bool is_in_window = false;
+        if (!window_.empty()) {
+            const Range &front = ranges_[window_.front()];
+
+            is_in_window = front.offset <= position && position < front.offset + front.size;
+        }
+
+        if (!is_in_window) {
+            lock.unlock();
+
+            cancel_ranges();
+
+            next_range_offset_ = position;
+        }
+    }
+
+    position_ = position;
+}
+
+void Object_input_stream::close() noexcept
+{
+    stop();
+
+    closed_ = true;
+}
+
+Object_input_stream::Object_input_stream(Intrusive_ptr<const Object_store_client> client,
+                                         std::string bucket,
+                                         std::string key,
+                                         std::string version_id,
+                                         const Range_read_params &range_read_params)
+    : client_{std::move(client)}
+    , bucket_{std::move(bucket)}
+    , key_{std::move(key)}
+    , version_id_{std::move(version_id)}
+    , num_parallel_ranges_{range_read_params.num_parallel_ranges}
+    , range_size_{range_read_params.range_size}
+    , hedge_requests_{range_read_params.hedge_requests && num_parallel_ranges_ > 1}
+    , hedge_budget_{range_read_params.hedge_budget}
+{
+    if (num_parallel_ranges_ > 1) {
+        if (range_size_ == 0) {
+            throw std::invalid_argument{"The range size must be greater than zero."};
+        }
+
+        if (hedge_budget_ < 0 || hedge_budget_ > 1) {
+            throw std::invalid_argument{"The hedge budget must be between zero and one."};
+        }
+
+        ranges_.resize(num_parallel_ranges_);
+
+        for (std::size_t i = 0; i < num_parallel_ranges_; i++) {
+            free_ranges_.push_back(i);
+        }
+    }
+}
+
+void Object_input_stream::fetch_size()
+{
+    size_ = client_->read_object_size(bucket_, key_, version_id_);
+}
+
+std::size_t Object_input_stream::read_ranges(Mutable_memory_span destination)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    issue_ranges();
+
+    if (window_.empty()) {
+        return 0;
+    }
+
+    std::size_t range_idx = window_.front();
+
+    const Range &range = ranges_[range_idx];
+
+    read_condition_.wait(lock, [&range] {
+        return range.ready;
+    });
+
+    return consume_front_range(lock, destination);
+}
+
+std::size_t Object_input_stream::consume_front_range(std::unique_lock<std::mutex> &lock,
+                                                     Mutable_memory_span destination)
+{
+    std::size_t range_idx = window_.front();
+
+    const Range &range = ranges_[range_idx];
+
+    if (range.exception_ptr) {
+        std::rethrow_exception(range.exception_ptr);
+    }
+
+    // A ready range that is part of the window is not touched by the
+    // background threads; we can safely copy it without the lock.
+    lock.unlock();
+
+    std::size_t range_pos = position_ - range.offset;
+
+    std::size_t num_bytes_read = std::min(destination.size(), range.size - range_pos);
+
+    auto *data = range.data.get() + range_pos;
+
+    std::copy(data, data + num_bytes_read, destination.begin());
+
+    position_ += num_bytes_read;
+
+    if (position_ == range.offset + range.size) {
+        lock.lock();
+
+        window_.pop_front();
+
+        free_ranges_.push_back(range_idx);
+
+        issue_ranges();
+    }
+
+    return num_bytes_read;
+}
+
+void Object_input_stream::complete_read(std::unique_lock<std::mutex> &lock,
+                                        Mutable_memory_span destination,
+                                        const Read_completion_handler &handler)
+{
+    std::size_t num_bytes_read = 0;
+
+    std::exception_ptr error{};
+    try {
+        if (!window_.empty()) {
+            num_bytes_read = consume_front_range(lock, destination);
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    if (lock.owns_lock()) {
+        lock.unlock();
+    }
+
+    handler(num_bytes_read, std::move(error));
+}
+
+void Object_input_stream::issue_ranges()
+{
+    bool has_new_ranges = false;
+
+    while (!free_ranges_.empty() && next_range_offset_ < size_) {
+        std::size_t range_idx = free_ranges_.front();
+
+        free_ranges_.pop_front();
+
+        Range &range = ranges_[range_idx];
+
+        range.offset = next_range_offset_;
+        range.size = std::min(range_size_, size_ - next_range_offset_);
+        range.ready = false;
+        range.exception_ptr = nullptr;
+        range.generation++;
+        range.num_requests = 0;
+        range.hedged = false;
+        range.started_at = std::nullopt;
+
+        next_range_offset_ += range.size;
+
+        window_.push_back(range_idx);
+
+        fetch_queue_.push_back(range_idx);
+
+        num_in_flight_++;
+
+        has_new_ranges = true;
+    }
+
+    if (!has_new_ranges) {
+        return;
+    }
+
+    // The background threads are started lazily so that streams that
+    // are only probed for their size do not pay for them.
+    if (threads_.empty()) {
+        // Each range can have one hedge in flight; the hedges run on
+        // threads of their own so that they are not queued behind the
+        // slow requests they are meant to overtake.
+        std::size_t num_hedge_threads = hedge_requests_ ? num_parallel_ranges_ : 0;
+
+        threads_.reserve(num_parallel_ranges_ + num_hedge_threads);
+
+        for (std::size_t i = 0; i < num_parallel_ranges_; i++) {
+            threads_.emplace_back(detail::start_thread(&Object_input_stream::run_fetch, this));
+        }
+
+        for (std::size_t i = 0; i < num_hedge_threads; i++) {
+            threads_.emplace_back(detail::start_thread(&Object_input_stream::run_hedge, this));
+        }
+    }
+
+    fetch_condition_.notify_all();
+}
+
+void Object_input_stream::run_fetch()
+{
+    for (;;) {
+        Range_request request{};
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            fetch_condition_.wait(lock, [this] {
+                return stopping_ || !fetch_queue_.empty();
+            });
+
+            if (stopping_) {
+                return;
+            }
+
+            std::size_t range_idx = fetch_queue_.front();
+
+            fetch_queue_.pop_front();
+
+            request = make_request(range_idx, false);
+        }
+
+        std::exception_ptr exception_ptr = fetch_range(request);
+
+        complete_request(request, std::move(exception_ptr));
+    }
+}
+
+void Object_input_stream::run_hedge()
+{
+    for (;;) {
+        Range_request request{};
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            std::optional<std::size_t> range_idx{};
+            for (;;) {
+                if (stopping_) {
+                    return;
+                }
+
+                auto next_check = Fetch_clock::time_point::max();
+
+                range_idx = find_range_to_hedge(Fetch_clock::now(), next_check);
+                if (range_idx) {
+                    break;
+                }
+
+                if (next_check == Fetch_clock::time_point::max()) {
+                    hedge_condition_.wait(lock);
+                }
+                else {
+                    hedge_condition_.wait_until(lock, next_check);
+                }
+            }
+
+            request = make_request(*range_idx, true);
+        }
+
+        std::exception_ptr exception_ptr = fetch_range(request);
+
+        complete_request(request, std::move(exception_ptr));
+    }
+}
+
+std::optional<std::size_t>
+Object_input_stream::find_range_to_hedge(Fetch_clock::time_point now,
+                                         Fetch_clock::time_point &next_check)
+{
+    if (hedge_delay_ == std::nullopt) {
+        return {};
+    }
+
+    // Stay within the budget of the hedged requests; the ranges that
+    // are in flight count towards it as they will be fetched anyway.
+    auto num_ranges = static_cast<double>(num_fetched_ranges_ + num_in_flight_);
+    if (static_cast<double>(num_hedges_ + 1) > hedge_budget_ * num_ranges) {
+        return {};
+    }
+
+    for (std::size_t range_idx : window_) {
+        const Range &range = ranges_[range_idx];
+        if (range.ready || range.hedged || range.started_at == std::nullopt) {
+            continue;
+        }
+
+        Fetch_clock::time_point deadline = *range.started_at + *hedge_delay_;
+        if (deadline <= now) {
+            return range_idx;
+        }
+
+        next_check = std::min(next_check, deadline);
+    }
+
+    return {};
+}
+
+Object_input_stream::Range_request
+Object_input_stream::make_request(std::size_t range_idx, bool is_hedge)
+{
+    Range &range = ranges_[range_idx];
+
+    Range_request request{};
+    request.range_idx = range_idx;
+    request.generation = range.generation;
+    request.offset = range.offset;
+    request.size = range.size;
+    request.is_hedge = is_hedge;
+    request.started_at = Fetch_clock::now();
+
+    range.num_requests++;
+
+    if (is_hedge) {
+        range.hedged = true;
+
+        num_hedges_++;
+    }
+    else {
+        // The buffer of the range is reused by its first request; a
+        // hedge fetches into a buffer of its own that replaces it if
+        // the hedge wins.
+        request.data = std::move(range.data);
+
+        range.started_at = request.started_at;
+
+        hedge_condition_.notify_one();
+    }
+
+    return request;
+}
+
+std::exception_ptr Object_input_stream::fetch_range(Range_request &request)
+{
+    try {
+        if (request.data == nullptr) {
+            request.data.reset(new std::byte[range_size_]);
+        }
+
+        std::size_t num_bytes_read = 0;
+
+        while (num_bytes_read < request.size) {
+            Mutable_memory_span destination{request.data.get() + num_bytes_read,
+                                            request.size - num_bytes_read};
+
+            std::size_t n = client_->read_object(
+                bucket_, key_, version_id_, request.offset + num_bytes_read, destination);
+            if (n == 0) {
+                throw Stream_error{"The object has been truncated while being read."};
+            }
+
+            num_bytes_read += n;
+        }
+    }
+    catch (...) {
+        return std::current_exception();
+    }
+
+    return nullptr;
+}
+
+void Object_input_stream::complete_request(Range_request &request, std::exception_ptr exception_ptr)
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        if (hedge_requests_ && !request.is_hedge && exception_ptr == nullptr) {
+            record_latency(Fetch_clock::now() - request.started_at);
+        }
+
+        Range &range = ranges_[request.range_idx];
+
+        // Discard the request if the range has been completed by the
+        // other request, or reissued since.
+        if (range.generation != request.generation || range.ready) {
+            return;
+        }
+
+        range.num_requests--;
+
+        // A failed request leaves the range to the other one if there is
+        // one still in flight.
+        if (exception_ptr && range.num_requests > 0) {
+            return;
+        }
+
+        range.data = std::move(request.data);
+        range.ready = true;
+        range.exception_ptr = std::move(exception_ptr);
+
+        num_in_flight_--;
+
+        num_fetched_ranges_++;
+
+        if (pending_read_ && window_.front() == request.range_idx) {
+            Pending_read pending = std::move(*pending_read_);
+
+            pending_read_ = std::nullopt;
+
+            complete_read(lock, pending.destination, pending.handler);
+        }
+    }
+
+    read_condition_.notify_one();
+}
+
+void Object_input_stream::record_latency(Fetch_clock::duration latency)
+{
+    // The hedge delay is the 95th percentile of the most recent
+    // latencies; a handful of samples is required before the first
+    // hedge.
+    constexpr std::size_t max_num_latencies = 64;
+    constexpr std::size_t min_num_latencies = 8;
+
+    if (latencies_.size() < max_num_latencies) {
+        latencies_.push_back(latency);
+    }
+    else {
+        latencies_[latency_pos_] = latency;
+
+        latency_pos_ = (latency_pos_ + 1) % max_num_latencies;
+    }
+
+    if (latencies_.size() < min_num_latencies) {
+        return;
+    }
+
+    std::vector<Fetch_clock::duration> sorted = latencies_;
+
+    auto pos = sorted.begin() + as_ssize(sorted.size() * 95 / 100);
+
+    std::nth_element(sorted.begin(), pos, sorted.end());
+
+    hedge_delay_ = *pos;
+}
+
+void Object_input_stream::cancel_ranges()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // Ranges that are not picked up yet by a background thread can be
+    // dropped right away; the rest have to complete before their
+    // buffers can be reused.
+    num_in_flight_ -= fetch_queue_.size();
+
+    fetch_queue_.clear();
+
+    read_condition_.wait(lock, [this] {
+        return num_in_flight_ == 0;
+    });
+
+    free_ranges_.insert(free_ranges_.end(), window_.begin(), window_.end());
+
+    window_.clear();
+}
+
+void Object_input_stream::stop() noexcept
+{
+    if (threads_.empty()) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        stopping_ = true;
+    }
+
+    fetch_condition_.notify_all();
+
+    hedge_condition_.notify_all();
+
+    for (std::thread &thread : threads_) {
+        thread.join();
+    }
+
+    threads_.clear();
+
+    // The range that the pending read waits for will never be fetched.
+    if (pending_read_) {
+        Pending_read pending = std::move(*pending_read_);
+
+        pending_read_ = std::nullopt;
+
+        pending.handler(0, std::make_exception_ptr(Stream_error{"The input stream is closed."}));
+    }
+}
+
+void Object_input_stream::check_if_closed() const
+{
+    if (closed_) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+namespace detail {
+
+struct Object_input_stream_access {
+    static inline Intrusive_ptr<Object_input_stream>
+    make(Intrusive_ptr<const Object_store_client> client,
+         const std::string &uri,
+         std::string version_id,
+         const std::optional<Range_read_params> &range_read_params,
+         std::optional<std::size_t> size)
+    {
+        auto [bucket, key] = split_object_uri_to_bucket_and_key(uri, client->uri_scheme());
+
+        Range_read_params params = range_read_params.value_or(client->range_read_params());
+
+        auto *ptr = new Object_input_stream{std::move(client),
+                                            std::string{bucket},
+                                            std::string{key},
+                                            std::move(version_id),
+                                            params};
+
+        auto stream = wrap_intrusive(ptr);
+
+        if (size) {
+            stream->size_ = *size;
+        }
+        else {
+            stream->fetch_size();
+        }
+
+        return stream;
+    }
+};
+
+}  // namespace detail
+
+Intrusive_ptr<Object_input_stream>
+make_object_input_stream(Intrusive_ptr<const Object_store_client> client,
+                         const std::string &uri,
+                         std::string version_id,
+                         const std::optional<Range_read_params> &range_read_params,
+                         std::optional<std::size_t> size)
+{
+    return detail::Object_input_stream_access::make(
+        std::move(client), uri, std::move(version_id), range_read_params, size);
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
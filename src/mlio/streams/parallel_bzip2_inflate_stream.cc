@@ -0,0 +1,456 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/parallel_bzip2_inflate_stream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <tbb/tbb.h>
+
+#include "mlio/streams/detail/bzip2.h"
+#include "mlio/streams/detail/inflate_task_scheduler.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Bzip2_record {
+    Memory_slice output{};
+    // The checksum of the block or, at the end of a stream, the
+    // combined checksum of its blocks.
+    std::uint32_t crc{};
+    bool eos{};
+};
+
+struct Bzip2_blocks {
+    std::vector<Bzip2_record> records{};
+    std::size_t end{};
+    bool eof{};
+};
+
+struct Bzip2_task final : public Inflate_task {
+    explicit Bzip2_task(Memory_span input_,
+                        std::size_t start_,
+                        std::size_t stop_,
+                        std::size_t chunk_size_) noexcept
+        : input{input_}, start{start_}, stop{stop_}, chunk_size{chunk_size_}
+    {}
+
+    void run() final;
+
+    const Memory_span input;
+    const std::size_t start;
+    const std::size_t stop;
+    const std::size_t chunk_size;
+    bool failed{};
+    Bzip2_blocks blocks{};
+};
+
+namespace {
+
+constexpr std::size_t header_size = 4;
+constexpr std::size_t marker_size = 48;
+constexpr std::size_t crc_size = 32;
+
+// A compressed block holds at most 900 kB of data and is rarely larger
+// than that; if no marker that ends a block can be found within this
+// distance, the data is corrupt.
+constexpr std::size_t max_block_size = 0x20'0000 * 8;  // 2 MiB
+
+bool is_bzip2_header(Memory_span input, std::size_t offset) noexcept
+{
+    if (input.size() - offset < header_size) {
+        return false;
+    }
+
+    auto b = as_span<const std::uint8_t>(input.subspan(offset, header_size));
+
+    return b[0] == 'B' && b[1] == 'Z' && b[2] == 'h' && b[3] >= '1' && b[3] <= '9';
+}
+
+// Inflates the blocks starting at the bit position @p start until
+// reaching a block marker at or past @p stop, crossing the boundaries
+// of concatenated streams on the way.
+bool inflate_blocks(Memory_span input,
+                    std::size_t start,
+                    std::size_t stop,
+                    std::size_t max_block_output_size,
+                    const std::atomic_bool *cancelled,
+                    Bzip2_blocks &blocks)
+{
+    std::size_t num_bits = input.size() * 8;
+
+    std::size_t pos = start;
+
+    while (pos < stop) {
+        if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        if (num_bits - pos < marker_size) {
+            return false;
+        }
+
+        std::uint64_t magic = read_bits(input, pos, marker_size);
+
+        if (magic == bzip2_eos_magic) {
+            if (num_bits - pos < marker_size + crc_size) {
+                return false;
+            }
+
+            auto crc = static_cast<std::uint32_t>(read_bits(input, pos + marker_size, crc_size));
+
+            blocks.records.push_back(Bzip2_record{{}, crc, true});
+
+            // The next stream, if any, starts at the next byte boundary.
+            std::size_t offset = (pos + marker_size + crc_size + 7) / 8;
+            if (offset == input.size()) {
+                blocks.eof = true;
+
+                pos = num_bits;
+
+                break;
+            }
+
+            if (!is_bzip2_header(input, offset)) {
+                return false;
+            }
+
+            pos = (offset + header_size) * 8;
+
+            continue;
+        }
+
+        if (magic != bzip2_block_magic) {
+            return false;
+        }
+
+        Bzip2_block block{};
+
+        // A marker within the block is a false positive; in such case
+        // the block cannot be inflated up to it and we try the next one.
+        std::size_t block_stop = pos + marker_size;
+        for (;;) {
+            block_stop = find_bzip2_marker(input, block_stop, num_bits).bit_pos;
+            if (block_stop == num_bits || block_stop - pos > max_block_size) {
+                return false;
+            }
+
+            if (inflate_bzip2_block(input, pos, block_stop, max_block_output_size, block)) {
+                break;
+            }
+
+            block_stop++;
+        }
+
+        blocks.records.push_back(Bzip2_record{std::move(block.output), block.crc, false});
+
+        pos = block_stop;
+    }
+
+    blocks.end = pos;
+
+    return true;
+}
+
+}  // namespace
+
+void Bzip2_task::run()
+{
+    // A highly compressible block can inflate to tens of megabytes; in
+    // such case we leave it to the serial path that has no limit.
+    std::size_t max_block_output_size = chunk_size * 32;
+
+    try {
+        bool ok = inflate_blocks(input, start, stop, max_block_output_size, &cancelled, blocks);
+
+        failed = !ok;
+    }
+    catch (const std::exception &) {
+        // Either the task started at a false block marker or the data is
+        // corrupt; the stream will find out which when it inflates this
+        // part serially.
+        failed = true;
+    }
+}
+
+}  // namespace detail
+
+Parallel_bzip2_inflate_stream::Parallel_bzip2_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                                             const Parallel_inflate_params &params)
+    : inner_{std::move(inner)}
+    , chunk_size_{params.chunk_size}
+    , max_num_tasks_{params.max_num_tasks}
+    , scheduler_{std::make_unique<detail::Inflate_task_scheduler>()}
+{
+    if (!inner_->supports_zero_copy()) {
+        throw std::invalid_argument{"The underlying stream must support zero-copy reading."};
+    }
+
+    if (chunk_size_ == 0) {
+        throw std::invalid_argument{"The chunk size must be greater than zero."};
+    }
+
+    if (max_num_tasks_ == 0) {
+        max_num_tasks_ = as_size(tbb::this_task_arena::max_concurrency());
+    }
+
+    input_ = inner_->read(inner_->size());
+
+    if (input_.empty()) {
+        eof_ = true;
+
+        return;
+    }
+
+    if (!detail::is_bzip2_header(input_, 0)) {
+        throw Inflate_error{"The bzip2 stream has an invalid header."};
+    }
+
+    pos_ = detail::header_size * 8;
+}
+
+Parallel_bzip2_inflate_stream::~Parallel_bzip2_inflate_stream()
+{
+    cancel_tasks();
+}
+
+std::size_t Parallel_bzip2_inflate_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return 0;
+    }
+
+    std::size_t num_bytes_read = std::min(destination.size(), chunk_.size());
+
+    auto pos = chunk_.begin();
+
+    std::copy(pos, pos + as_ssize(num_bytes_read), destination.begin());
+
+    chunk_ = chunk_.subslice(num_bytes_read);
+
+    return num_bytes_read;
+}
+
+Memory_slice Parallel_bzip2_inflate_stream::read(std::size_t size)
+{
+    check_if_closed();
+
+    if (size == 0) {
+        return {};
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return {};
+    }
+
+    // If the request can be satisfied from the current chunk, avoid the
+    // copy and return a slice of it.
+    if (size <= chunk_.size()) {
+        Memory_slice slice = chunk_.subslice(0, size);
+
+        chunk_ = chunk_.subslice(size);
+
+        return slice;
+    }
+
+    return Input_stream_base::read(size);
+}
+
+void Parallel_bzip2_inflate_stream::close() noexcept
+{
+    cancel_tasks();
+
+    blocks_.clear();
+
+    chunk_ = {};
+
+    input_ = {};
+
+    inner_->close();
+}
+
+bool Parallel_bzip2_inflate_stream::closed() const noexcept
+{
+    return inner_->closed();
+}
+
+bool Parallel_bzip2_inflate_stream::next_chunk()
+{
+    for (;;) {
+        while (!blocks_.empty()) {
+            chunk_ = std::move(blocks_.front());
+
+            blocks_.pop_front();
+
+            if (!chunk_.empty()) {
+                return true;
+            }
+        }
+
+        if (eof_) {
+            return false;
+        }
+
+        if (!next_task_blocks()) {
+            next_serial_block();
+        }
+    }
+}
+
+bool Parallel_bzip2_inflate_stream::next_task_blocks()
+{
+    schedule_tasks();
+
+    // Drop the tasks that start before our position; their start was a
+    // false block marker.
+    while (!tasks_.empty() && tasks_.front()->start < pos_) {
+        tasks_.front()->cancelled = true;
+
+        tasks_.pop_front();
+    }
+
+    if (tasks_.empty() || tasks_.front()->start > pos_) {
+        return false;
+    }
+
+    detail::Bzip2_task &task = *tasks_.front();
+
+    scheduler_->wait(task);
+
+    bool failed = task.failed;
+    if (!failed) {
+        append_blocks(task.blocks);
+    }
+
+    tasks_.pop_front();
+
+    return !failed;
+}
+
+void Parallel_bzip2_inflate_stream::next_serial_block()
+{
+    detail::Bzip2_blocks blocks{};
+
+    if (!detail::inflate_blocks(make_span(input_),
+                                pos_,
+                                pos_ + 1,
+                                std::numeric_limits<std::size_t>::max(),
+                                nullptr,
+                                blocks)) {
+        throw Inflate_error{"The bzip2 stream contains invalid or incomplete data."};
+    }
+
+    append_blocks(blocks);
+}
+
+void Parallel_bzip2_inflate_stream::append_blocks(detail::Bzip2_blocks &blocks)
+{
+    for (detail::Bzip2_record &record : blocks.records) {
+        if (record.eos) {
+            if (record.crc != crc_) {
+                throw Inflate_error{"The bzip2 stream has an invalid checksum."};
+            }
+
+            crc_ = 0;
+        }
+        else {
+            crc_ = ((crc_ << 1) | (crc_ >> 31)) ^ record.crc;
+
+            blocks_.emplace_back(std::move(record.output));
+        }
+    }
+
+    pos_ = blocks.end;
+
+    eof_ = blocks.eof;
+}
+
+void Parallel_bzip2_inflate_stream::schedule_tasks()
+{
+    std::size_t num_bits = input_.size() * 8;
+
+    while (tasks_.size() < max_num_tasks_) {
+        std::size_t start = find_block(std::max(scan_pos_, pos_));
+        if (start == num_bits) {
+            scan_pos_ = num_bits;
+
+            return;
+        }
+
+        // The task stops at the first block after its chunk; that is
+        // where the next task starts.
+        std::size_t stop = find_block(std::min(num_bits, start + chunk_size_ * 8));
+
+        scan_pos_ = stop;
+
+        auto task =
+            std::make_shared<detail::Bzip2_task>(make_span(input_), start, stop, chunk_size_);
+
+        tasks_.emplace_back(task);
+
+        scheduler_->schedule(std::move(task));
+    }
+}
+
+std::size_t Parallel_bzip2_inflate_stream::find_block(std::size_t first) const noexcept
+{
+    std::size_t num_bits = input_.size() * 8;
+
+    for (;;) {
+        detail::Bzip2_marker marker = detail::find_bzip2_marker(input_, first, num_bits);
+        if (!marker.eos) {
+            return marker.bit_pos;
+        }
+
+        first = marker.bit_pos + 1;
+    }
+}
+
+void Parallel_bzip2_inflate_stream::cancel_tasks() noexcept
+{
+    for (auto &task : tasks_) {
+        task->cancelled = true;
+    }
+
+    scheduler_->wait_all();
+
+    tasks_.clear();
+}
+
+void Parallel_bzip2_inflate_stream::check_if_closed() const
+{
+    if (inner_->closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,480 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/parallel_gzip_inflate_stream.h"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include <tbb/tbb.h>
+
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/memory/util.h"
+#include "mlio/streams/detail/gzip_decoder.h"
+#include "mlio/streams/detail/inflate_task_scheduler.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Gzip_task final : public Inflate_task {
+    explicit Gzip_task(Memory_span input_,
+                       std::size_t start_,
+                       std::size_t stop_,
+                       std::size_t chunk_size_) noexcept
+        : input{input_}, start{start_}, stop{stop_}, chunk_size{chunk_size_}
+    {}
+
+    void run() final;
+
+    const Memory_span input;
+    const std::size_t start;
+    const std::size_t stop;
+    const std::size_t chunk_size;
+    bool failed{};
+    Memory_slice output{};
+    std::size_t end{};
+    bool eof{};
+    Gzip_checksum checksum{};
+    std::optional<Gzip_member_end> head{};
+};
+
+namespace {
+
+// The maximum distance that deflate allows for back-references.
+constexpr std::size_t window_size = 0x8000;  // 32 KiB
+
+// The size of the chunks inflated serially.
+constexpr std::size_t serial_chunk_size = 0x10'0000;  // 1 MiB
+
+// The number of consecutive failed speculations after which we give up
+// on inflating in parallel.
+constexpr std::size_t max_num_failures = 8;
+
+}  // namespace
+
+void Gzip_task::run()
+{
+    // A highly compressible part can inflate to an arbitrary size; in
+    // such case we leave it to the serial path that uses bounded memory.
+    std::size_t max_output_size = chunk_size * 32;
+
+    try {
+        Gzip_decoder decoder{input, start};
+
+        auto block = memory_allocator().allocate(chunk_size * 4);
+
+        std::size_t num_bytes_written = 0;
+
+        for (;;) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                failed = true;
+
+                return;
+            }
+
+            auto out = make_span(*block).subspan(num_bytes_written);
+
+            std::size_t out_size = out.size();
+
+            decoder.decode(out, stop);
+
+            num_bytes_written += out_size - out.size();
+
+            if (decoder.stopped()) {
+                break;
+            }
+
+            if (out.empty()) {
+                if (block->size() >= max_output_size) {
+                    failed = true;
+
+                    return;
+                }
+
+                block = resize_memory_block(block, block->size() * 2);
+            }
+        }
+
+        output = Memory_slice{std::move(block)}.first(num_bytes_written);
+
+        end = decoder.position();
+        eof = decoder.eof();
+
+        checksum = decoder.checksum();
+        head = decoder.head();
+    }
+    catch (const std::exception &) {
+        // Most likely we started at a false sync point, or the data
+        // references the bytes preceding the start position. Either way
+        // the stream will inflate this part serially.
+        failed = true;
+    }
+}
+
+}  // namespace detail
+
+Parallel_gzip_inflate_stream::Parallel_gzip_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                                           const Parallel_inflate_params &params)
+    : inner_{std::move(inner)}
+    , chunk_size_{params.chunk_size}
+    , max_num_tasks_{params.max_num_tasks}
+    , scheduler_{std::make_unique<detail::Inflate_task_scheduler>()}
+{
+    if (!inner_->supports_zero_copy()) {
+        throw std::invalid_argument{"The underlying stream must support zero-copy reading."};
+    }
+
+    if (chunk_size_ == 0) {
+        throw std::invalid_argument{"The chunk size must be greater than zero."};
+    }
+
+    if (max_num_tasks_ == 0) {
+        max_num_tasks_ = as_size(tbb::this_task_arena::max_concurrency());
+    }
+
+    input_ = inner_->read(inner_->size());
+
+    next_task_start_ = 0;
+
+    eof_ = input_.empty();
+}
+
+Parallel_gzip_inflate_stream::~Parallel_gzip_inflate_stream()
+{
+    cancel_tasks();
+}
+
+std::size_t Parallel_gzip_inflate_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return 0;
+    }
+
+    std::size_t num_bytes_read = std::min(destination.size(), chunk_.size());
+
+    auto pos = chunk_.begin();
+
+    std::copy(pos, pos + as_ssize(num_bytes_read), destination.begin());
+
+    chunk_ = chunk_.subslice(num_bytes_read);
+
+    return num_bytes_read;
+}
+
+Memory_slice Parallel_gzip_inflate_stream::read(std::size_t size)
+{
+    check_if_closed();
+
+    if (size == 0) {
+        return {};
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return {};
+    }
+
+    // If the request can be satisfied from the current chunk, avoid the
+    // copy and return a slice of it.
+    if (size <= chunk_.size()) {
+        Memory_slice slice = chunk_.subslice(0, size);
+
+        chunk_ = chunk_.subslice(size);
+
+        return slice;
+    }
+
+    return Input_stream_base::read(size);
+}
+
+void Parallel_gzip_inflate_stream::close() noexcept
+{
+    cancel_tasks();
+
+    decoder_ = {};
+
+    chunk_ = {};
+
+    input_ = {};
+
+    inner_->close();
+}
+
+bool Parallel_gzip_inflate_stream::closed() const noexcept
+{
+    return inner_->closed();
+}
+
+bool Parallel_gzip_inflate_stream::next_chunk()
+{
+    while (!eof_) {
+        bool has_chunk{};
+        if (decoder_ != nullptr) {
+            has_chunk = next_serial_chunk();
+        }
+        else {
+            has_chunk = next_task_chunk();
+        }
+
+        if (has_chunk) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Parallel_gzip_inflate_stream::next_task_chunk()
+{
+    schedule_tasks();
+
+    // Drop the tasks that start before our position; their start was a
+    // false sync point.
+    while (!tasks_.empty() && tasks_.front()->start < pos_) {
+        discard_task();
+    }
+
+    if (tasks_.empty() || tasks_.front()->start > pos_) {
+        decoder_ = std::make_unique<detail::Gzip_decoder>(
+            make_span(input_), pos_, detail::Gzip_checksum{crc_, crc_size_}, make_span(window_));
+
+        decoder_stop_ = tasks_.empty() ? input_.size() : tasks_.front()->start;
+        if (tasks_.empty() && speculate_) {
+            decoder_stop_ = std::max(pos_ + chunk_size_, scan_pos_);
+        }
+
+        return false;
+    }
+
+    detail::Gzip_task &task = *tasks_.front();
+
+    scheduler_->wait(task);
+
+    if (task.failed) {
+        discard_task();
+
+        return false;
+    }
+
+    detail::Gzip_checksum checksum{crc_, crc_size_};
+
+    // If the task started in the middle of a member, complete the
+    // verification of its checksum.
+    if (task.head) {
+        checksum = detail::combine(checksum, task.head->checksum);
+
+        if (checksum.crc != task.head->trailer_crc ||
+            static_cast<std::uint32_t>(checksum.size) != task.head->trailer_size) {
+            throw Inflate_error{"The gzip stream contains a member with an invalid checksum."};
+        }
+
+        checksum = task.checksum;
+    }
+    else {
+        checksum = detail::combine(checksum, task.checksum);
+    }
+
+    crc_ = checksum.crc;
+    crc_size_ = checksum.size;
+
+    pos_ = task.end;
+
+    eof_ = task.eof;
+
+    chunk_ = std::move(task.output);
+
+    append_to_window(chunk_);
+
+    tasks_.pop_front();
+
+    num_failures_ = 0;
+
+    return !chunk_.empty();
+}
+
+bool Parallel_gzip_inflate_stream::next_serial_chunk()
+{
+    auto block = memory_allocator().allocate(detail::serial_chunk_size);
+
+    auto out = make_span(*block);
+
+    decoder_->decode(out, decoder_stop_);
+
+    std::size_t num_bytes_written = block->size() - out.size();
+
+    chunk_ = Memory_slice{std::move(block)}.first(num_bytes_written);
+
+    append_to_window(chunk_);
+
+    if (decoder_->stopped()) {
+        pos_ = decoder_->position();
+
+        crc_ = decoder_->checksum().crc;
+        crc_size_ = decoder_->checksum().size;
+
+        if (decoder_->eof()) {
+            eof_ = true;
+        }
+        else {
+            schedule_tasks();
+
+            while (!tasks_.empty() && tasks_.front()->start < pos_) {
+                discard_task();
+            }
+
+            if (!tasks_.empty() && tasks_.front()->start == pos_) {
+                // Switch back to the tasks.
+                decoder_ = {};
+            }
+            else if (!tasks_.empty()) {
+                decoder_stop_ = tasks_.front()->start;
+            }
+            else if (speculate_) {
+                decoder_stop_ = std::max(pos_ + chunk_size_, scan_pos_);
+            }
+            else {
+                decoder_stop_ = input_.size();
+            }
+        }
+
+        if (eof_) {
+            decoder_ = {};
+        }
+    }
+
+    return !chunk_.empty();
+}
+
+void Parallel_gzip_inflate_stream::schedule_tasks()
+{
+    if (!speculate_) {
+        return;
+    }
+
+    std::size_t input_size = input_.size();
+
+    // Do not scan further than this in a single call for a sync point;
+    // a stream without any sync points should not pay for a full scan.
+    std::size_t max_scan_size = chunk_size_ * 8;
+
+    while (tasks_.size() < max_num_tasks_) {
+        if (!next_task_start_) {
+            std::size_t first = std::max(scan_pos_, pos_);
+            if (first >= input_size) {
+                return;
+            }
+
+            std::size_t last = std::min(input_size, first + max_scan_size);
+
+            scan_pos_ = detail::find_gzip_sync_point(make_span(input_), first, last);
+            if (scan_pos_ == last) {
+                return;
+            }
+
+            next_task_start_ = scan_pos_;
+        }
+
+        std::size_t start = *next_task_start_;
+
+        // The task stops at the first sync point after its chunk; that
+        // is where the next task starts.
+        std::size_t first = std::min(input_size, start + chunk_size_);
+        std::size_t last = std::min(input_size, first + max_scan_size);
+
+        std::size_t stop = detail::find_gzip_sync_point(make_span(input_), first, last);
+
+        scan_pos_ = stop;
+
+        if (stop == input_size || stop == last) {
+            next_task_start_ = {};
+        }
+        else {
+            next_task_start_ = stop;
+        }
+
+        auto task =
+            std::make_shared<detail::Gzip_task>(make_span(input_), start, stop, chunk_size_);
+
+        tasks_.emplace_back(task);
+
+        scheduler_->schedule(std::move(task));
+    }
+}
+
+void Parallel_gzip_inflate_stream::discard_task()
+{
+    tasks_.front()->cancelled = true;
+
+    tasks_.pop_front();
+
+    if (++num_failures_ == detail::max_num_failures) {
+        speculate_ = false;
+
+        for (auto &task : tasks_) {
+            task->cancelled = true;
+        }
+
+        tasks_.clear();
+    }
+}
+
+void Parallel_gzip_inflate_stream::append_to_window(Memory_span data)
+{
+    if (data.size() >= detail::window_size) {
+        window_.assign(data.end() - detail::window_size, data.end());
+
+        return;
+    }
+
+    window_.insert(window_.end(), data.begin(), data.end());
+
+    if (window_.size() > detail::window_size) {
+        window_.erase(window_.begin(), window_.end() - detail::window_size);
+    }
+}
+
+void Parallel_gzip_inflate_stream::cancel_tasks() noexcept
+{
+    for (auto &task : tasks_) {
+        task->cancelled = true;
+    }
+
+    scheduler_->wait_all();
+
+    tasks_.clear();
+}
+
+void Parallel_gzip_inflate_stream::check_if_closed() const
+{
+    if (inner_->closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,303 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/prefetching_input_stream.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/detail/thread.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+Prefetch_params default_prefetch_params_{};
+
+}  // namespace
+}  // namespace detail
+
+Prefetching_input_stream::Prefetching_input_stream(Intrusive_ptr<Input_stream> inner,
+                                                   const Prefetch_params &params)
+    : inner_{std::move(inner)}, chunk_size_{params.chunk_size}, depth_{params.depth}
+{
+    if (chunk_size_ == 0) {
+        throw std::invalid_argument{"The chunk size must be greater than zero."};
+    }
+
+    if (depth_ == 0) {
+        depth_ = 1;
+    }
+}
+
+Prefetching_input_stream::~Prefetching_input_stream()
+{
+    stop();
+}
+
+std::size_t Prefetching_input_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return 0;
+    }
+
+    std::size_t num_bytes_read = std::min(destination.size(), chunk_.size());
+
+    auto pos = chunk_.begin();
+
+    std::copy(pos, pos + as_ssize(num_bytes_read), destination.begin());
+
+    chunk_ = chunk_.subslice(num_bytes_read);
+
+    position_ += num_bytes_read;
+
+    return num_bytes_read;
+}
+
+Memory_slice Prefetching_input_stream::read(std::size_t size)
+{
+    check_if_closed();
+
+    if (size == 0) {
+        return {};
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return {};
+    }
+
+    // If the request can be satisfied from the current chunk, avoid the
+    // copy and return a slice of it.
+    if (size <= chunk_.size()) {
+        Memory_slice slice = chunk_.subslice(0, size);
+
+        chunk_ = chunk_.subslice(size);
+
+        position_ += size;
+
+        return slice;
+    }
+
+    return Input_stream_base::read(size);
+}
+
+std::size_t Prefetching_input_stream::read_at(std::size_t offset, Mutable_memory_span destination)
+{
+    return inner_->read_at(offset, destination);
+}
+
+Memory_slice Prefetching_input_stream::read_at(std::size_t offset, std::size_t size)
+{
+    return inner_->read_at(offset, size);
+}
+
+void Prefetching_input_stream::seek(std::size_t position)
+{
+    check_if_closed();
+
+    stop();
+
+    chunks_.clear();
+
+    chunk_ = {};
+
+    exception_ptr_ = nullptr;
+
+    eof_ = false;
+    stopping_ = false;
+
+    inner_->seek(position);
+
+    position_ = position;
+}
+
+void Prefetching_input_stream::close() noexcept
+{
+    stop();
+
+    chunks_.clear();
+
+    chunk_ = {};
+
+    inner_->close();
+}
+
+std::size_t Prefetching_input_stream::size() const
+{
+    return inner_->size();
+}
+
+std::size_t Prefetching_input_stream::position() const
+{
+    check_if_closed();
+
+    return position_;
+}
+
+bool Prefetching_input_stream::closed() const noexcept
+{
+    return inner_->closed();
+}
+
+bool Prefetching_input_stream::next_chunk()
+{
+    // The background thread is started lazily so that streams that are
+    // only probed (e.g. to infer the text encoding) and then seeked do
+    // not pay for it.
+    if (!thread_.joinable()) {
+        if (eof_ || exception_ptr_) {
+            return false;
+        }
+
+        thread_ = detail::start_thread(&Prefetching_input_stream::run_prefetch, this);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        read_condition_.wait(lock, [this] {
+            return !chunks_.empty() || eof_ || exception_ptr_;
+        });
+
+        if (chunks_.empty()) {
+            if (exception_ptr_) {
+                std::rethrow_exception(exception_ptr_);
+            }
+
+            return false;
+        }
+
+        chunk_ = std::move(chunks_.front());
+
+        chunks_.pop_front();
+    }
+
+    fill_condition_.notify_one();
+
+    return true;
+}
+
+void Prefetching_input_stream::run_prefetch()
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            fill_condition_.wait(lock, [this] {
+                return stopping_ || chunks_.size() < depth_;
+            });
+
+            if (stopping_) {
+                return;
+            }
+        }
+
+        Memory_slice chunk{};
+
+        bool has_more = false;
+
+        std::exception_ptr exception_ptr{};
+        try {
+            chunk = inner_->read(chunk_size_);
+        }
+        catch (...) {
+            exception_ptr = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            if (stopping_) {
+                return;
+            }
+
+            if (exception_ptr) {
+                exception_ptr_ = std::move(exception_ptr);
+            }
+            else if (chunk.empty()) {
+                eof_ = true;
+            }
+            else {
+                chunks_.emplace_back(std::move(chunk));
+
+                has_more = true;
+            }
+        }
+
+        read_condition_.notify_one();
+
+        if (!has_more) {
+            return;
+        }
+    }
+}
+
+void Prefetching_input_stream::stop() noexcept
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        stopping_ = true;
+    }
+
+    fill_condition_.notify_one();
+
+    thread_.join();
+}
+
+void Prefetching_input_stream::check_if_closed() const
+{
+    if (inner_->closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+Intrusive_ptr<Input_stream>
+make_prefetching_stream(Intrusive_ptr<Input_stream> &&stream, const Prefetch_params &params)
+{
+    if (params.depth == 0 || stream->supports_zero_copy()) {
+        return std::move(stream);
+    }
+
+    return make_intrusive<Prefetching_input_stream>(std::move(stream), params);
+}
+
+const Prefetch_params &default_prefetch_params() noexcept
+{
+    return detail::default_prefetch_params_;
+}
+
+void set_default_prefetch_params(const Prefetch_params &params) noexcept
+{
+    detail::default_prefetch_params_ = params;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -15,8 +15,13 @@
 
 #include "mlio/streams/sagemaker_pipe_input_stream.h"  // IWYU pragma: associated
 
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <system_error>
 #include <thread>
 #include <unordered_map>
@@ -33,6 +38,7 @@
 #include "mlio/detail/path.h"
 #include "mlio/detail/system_call.h"
 #include "mlio/logger.h"
+#include "mlio/streams/detail/sagemaker_pipe_counters.h"
 #include "mlio/streams/stream_error.h"
 #include "mlio/util/cast.h"
 
@@ -44,12 +50,34 @@ inline namespace abi_v1 {
 namespace detail {
 namespace {
 
+struct Channel_state {
+    std::ptrdiff_t fifo_id{};
+    // The FIFO opened in advance by the previous stream of the channel.
+    File_descriptor next_fifo_fd{};
+    std::ptrdiff_t next_fifo_id = -1;
+};
+
 // For each SageMaker pipe channel that gets opened in this process,
 // this container holds the path-to-FIFO mapping. If a new stream is
 // instantiated, it replaces the FIFO ID with -1 indicating that it
 // acquired the channel. Right before getting destructed, the stream
 // increments the original FIFO ID and puts it back to the container.
-std::unordered_map<std::string, std::atomic_ptrdiff_t> fifo_ids_{};
+// Streams of different channels might be opened concurrently, for
+// instance by an interleaved reader; the container is therefore
+// guarded by a mutex.
+std::unordered_map<std::string, Channel_state> channels_{};
+std::mutex channel_mutex_{};
+
+std::size_t read_pipe_max_size() noexcept
+{
+    std::ifstream strm{"/proc/sys/fs/pipe-max-size"};
+
+    std::size_t size{};
+    if (strm >> size) {
+        return size;
+    }
+    return 0;
+}
 
 }  // namespace
 }  // namespace detail
@@ -67,6 +95,8 @@ std::size_t Sagemaker_pipe_input_stream::read(Mutable_memory_span destination)
         return 0;
     }
 
+    std::chrono::steady_clock::time_point stall_start{};
+
     int attempt_count = 0;
     while (true) {
         // We do not want the read operation to block indefinitely in
@@ -92,6 +122,8 @@ std::size_t Sagemaker_pipe_input_stream::read(Mutable_memory_span destination)
                 }
 
                 if (attempt_count == 2) {
+                    stall_start = std::chrono::steady_clock::now();
+
                     wait_for_data();
                     continue;
                 }
@@ -103,6 +135,27 @@ std::size_t Sagemaker_pipe_input_stream::read(Mutable_memory_span destination)
                 fmt::format("FIFO {0:n} of the SageMaker pipe channel cannot be read.", fifo_id_)};
         }
 
+        if (attempt_count >= 2) {
+            auto stall_time = std::chrono::steady_clock::now() - stall_start;
+
+            counters_->num_stalls.fetch_add(1, std::memory_order_relaxed);
+            counters_->stall_ns.fetch_add(
+                static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(stall_time).count()),
+                std::memory_order_relaxed);
+        }
+
+        if (num_bytes_read == 0) {
+            if (open_next_fifo_ && !next_fifo_fd_.is_open()) {
+                open_next_fifo();
+            }
+        }
+        else {
+            counters_->num_bytes_read.fetch_add(static_cast<std::uint64_t>(num_bytes_read),
+                                                std::memory_order_relaxed);
+            counters_->num_reads.fetch_add(1, std::memory_order_relaxed);
+        }
+
         return static_cast<std::size_t>(num_bytes_read);
     }
 }
@@ -111,30 +164,93 @@ void Sagemaker_pipe_input_stream::close() noexcept
 {
     fifo_fd_ = {};
 
-    detail::fifo_ids_[path_].exchange(fifo_id_);
+    // The stream might be closed explicitly before it gets destructed;
+    // by then the channel might already be owned by a new stream.
+    if (!owns_channel_) {
+        return;
+    }
+
+    owns_channel_ = false;
+
+    std::unique_lock<std::mutex> lock{detail::channel_mutex_};
+
+    detail::Channel_state &channel = detail::channels_[path_];
+
+    channel.fifo_id = fifo_id_;
+
+    if (next_fifo_fd_.is_open()) {
+        channel.next_fifo_fd = std::move(next_fifo_fd_);
+        channel.next_fifo_id = fifo_id_;
+    }
+}
+
+Sagemaker_pipe_stats Sagemaker_pipe_input_stream::stats() const noexcept
+{
+    return counters_->load();
 }
 
-Sagemaker_pipe_input_stream::Sagemaker_pipe_input_stream(std::string &&path,
-                                                         std::chrono::seconds timeout,
-                                                         std::optional<std::size_t> fifo_id)
-    : path_{std::move(path)}, timeout_{timeout}
+Sagemaker_pipe_input_stream::Sagemaker_pipe_input_stream(
+    std::string &&path,
+    std::chrono::seconds timeout,
+    std::optional<std::size_t> fifo_id,
+    std::size_t pipe_buffer_size,
+    bool open_next_fifo,
+    std::shared_ptr<detail::Sagemaker_pipe_counters> counters)
+    : path_{std::move(path)}
+    , timeout_{timeout}
+    , pipe_buffer_size_{pipe_buffer_size}
+    , open_next_fifo_{open_next_fifo}
+    , counters_{std::move(counters)}
 {
     detail::validate_file_path(path_);
 
-    fifo_id_ = detail::fifo_ids_[path_].exchange(-1);
+    if (counters_ == nullptr) {
+        counters_ = std::make_shared<detail::Sagemaker_pipe_counters>();
+    }
+
+    std::unique_lock<std::mutex> lock{detail::channel_mutex_};
+
+    detail::Channel_state &channel = detail::channels_[path_];
+
+    fifo_id_ = std::exchange(channel.fifo_id, -1);
     if (fifo_id_ == -1) {
         auto err = std::make_error_code(std::errc::permission_denied);
         throw std::system_error{err, "The SageMaker pipe channel is already open."};
     }
 
+    owns_channel_ = true;
+
     // Overwrite the stored FIFO ID with the specified one.
     if (fifo_id) {
         fifo_id_ = as_ssize(*fifo_id);
     }
+
+    // Take over the FIFO opened by the previous stream unless the caller
+    // asked for a different one, in which case it is discarded.
+    if (channel.next_fifo_fd.is_open()) {
+        if (channel.next_fifo_id == fifo_id_) {
+            fifo_fd_ = std::move(channel.next_fifo_fd);
+        }
+        else {
+            channel.next_fifo_fd = {};
+        }
+    }
 }
 
 void Sagemaker_pipe_input_stream::open_fifo()
 {
+    if (fifo_fd_.is_open()) {
+        logger::debug("FIFO {0:n} of the SageMaker pipe channel '{1}' has been opened in advance.",
+                      fifo_id_,
+                      path_);
+
+        fifo_id_++;
+
+        wait_for_data();
+
+        return;
+    }
+
     std::string fifo_name = fmt::format("{0}_{1}", path_, fifo_id_);
 
     constexpr int max_num_attempts = 3;
@@ -153,6 +269,8 @@ void Sagemaker_pipe_input_stream::open_fifo()
             logger::debug(
                 "FIFO {0:n} of the SageMaker pipe channel '{1}' is opened.", fifo_id_, path_);
 
+            resize_fifo_buffer(fifo_fd_.get(), fifo_id_);
+
             fifo_id_++;
 
             // We make sure that the write end is opened by waiting for
@@ -176,6 +294,72 @@ void Sagemaker_pipe_input_stream::open_fifo()
         err, fmt::format("FIFO {0:n} of the SageMaker pipe channel cannot be opened.", fifo_id_)};
 }
 
+void Sagemaker_pipe_input_stream::open_next_fifo() noexcept
+{
+    // At this point fifo_id_ already refers to the next FIFO. Unlike in
+    // open_fifo() we do not retry; if SageMaker has not created the FIFO
+    // yet, the next stream opens it as usual.
+    std::string fifo_name = fmt::format("{0}_{1}", path_, fifo_id_);
+
+    next_fifo_fd_ = ::open(fifo_name.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (next_fifo_fd_.is_open()) {
+        logger::debug("FIFO {0:n} of the SageMaker pipe channel '{1}' is opened in advance.",
+                      fifo_id_,
+                      path_);
+
+        resize_fifo_buffer(next_fifo_fd_.get(), fifo_id_);
+    }
+    else {
+        logger::debug("FIFO {0:n} of the SageMaker pipe channel '{1}' cannot be opened in "
+                      "advance. The error code is {2:n}.",
+                      fifo_id_,
+                      path_,
+                      errno);
+    }
+}
+
+void Sagemaker_pipe_input_stream::resize_fifo_buffer(int fd, std::ptrdiff_t fifo_id) const noexcept
+{
+#ifdef F_SETPIPE_SZ
+    if (pipe_buffer_size_ == 0) {
+        return;
+    }
+
+    // The default capacity of 64 KiB forces SageMaker to block after
+    // writing 16 pages and the reader to wake up for every few records.
+    // A larger buffer lets both ends work in larger batches.
+    std::size_t size = std::min(pipe_buffer_size_,
+                                static_cast<std::size_t>(std::numeric_limits<int>::max()));
+
+    int r = ::fcntl(fd, F_SETPIPE_SZ, static_cast<int>(size));
+    if (r == -1 && errno == EPERM) {
+        // Unprivileged processes cannot exceed the system-wide limit.
+        std::size_t max_size = detail::read_pipe_max_size();
+        if (max_size != 0 && max_size < size) {
+            size = max_size;
+
+            r = ::fcntl(fd, F_SETPIPE_SZ, static_cast<int>(size));
+        }
+    }
+
+    if (r == -1) {
+        logger::debug("The buffer of FIFO {0:n} of the SageMaker pipe channel '{1}' cannot be "
+                      "resized to {2:n} bytes. The error code is {3:n}.",
+                      fifo_id,
+                      path_,
+                      size,
+                      errno);
+    }
+    else {
+        logger::debug("The buffer of FIFO {0:n} of the SageMaker pipe channel '{1}' is resized to "
+                      "{2:n} bytes.",
+                      fifo_id,
+                      path_,
+                      r);
+    }
+#endif
+}
+
 void Sagemaker_pipe_input_stream::sleep() noexcept
 {
     constexpr std::chrono::seconds attempt_pause{1};
@@ -244,9 +428,19 @@ namespace detail {
 
 struct Sagemaker_pipe_input_stream_access {
     static inline Intrusive_ptr<Sagemaker_pipe_input_stream>
-    make(std::string &&path, std::chrono::seconds timeout, std::optional<std::size_t> fifo_id)
+    make(std::string &&path,
+         std::chrono::seconds timeout,
+         std::optional<std::size_t> fifo_id,
+         std::size_t pipe_buffer_size,
+         bool open_next_fifo,
+         std::shared_ptr<Sagemaker_pipe_counters> &&counters)
     {
-        auto *ptr = new Sagemaker_pipe_input_stream{std::move(path), timeout, fifo_id};
+        auto *ptr = new Sagemaker_pipe_input_stream{std::move(path),
+                                                    timeout,
+                                                    fifo_id,
+                                                    pipe_buffer_size,
+                                                    open_next_fifo,
+                                                    std::move(counters)};
 
         auto stream = wrap_intrusive(ptr);
 
@@ -261,9 +455,17 @@ struct Sagemaker_pipe_input_stream_access {
 Intrusive_ptr<Sagemaker_pipe_input_stream>
 make_sagemaker_pipe_input_stream(std::string path,
                                  std::chrono::seconds timeout,
-                                 std::optional<std::size_t> fifo_id)
+                                 std::optional<std::size_t> fifo_id,
+                                 std::size_t pipe_buffer_size,
+                                 bool open_next_fifo,
+                                 std::shared_ptr<detail::Sagemaker_pipe_counters> counters)
 {
-    return Sagemaker_pipe_input_stream_access::make(std::move(path), timeout, fifo_id);
+    return Sagemaker_pipe_input_stream_access::make(std::move(path),
+                                                    timeout,
+                                                    fifo_id,
+                                                    pipe_buffer_size,
+                                                    open_next_fifo,
+                                                    std::move(counters));
 }
 
 }  // namespace abi_v1
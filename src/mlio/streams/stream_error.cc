@@ -22,5 +22,7 @@ Stream_error::~Stream_error() = default;
 
 Inflate_error::~Inflate_error() = default;
 
+Checksum_error::~Checksum_error() = default;
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -23,12 +23,14 @@
 #include "mlio/logger.h"
 #include "mlio/memory/memory_allocator.h"
 #include "mlio/streams/detail/iconv.h"
+#include "mlio/streams/detail/unicode_transcoder.h"
 #include "mlio/streams/input_stream.h"
 #include "mlio/streams/stream_error.h"
 #include "mlio/util/cast.h"
 
 using mlio::detail::Iconv_desc;
 using mlio::detail::Iconv_status;
+using mlio::detail::Unicode_transcoder;
 using mlio::detail::Utf8_input_stream_access;
 
 namespace mlio {
@@ -99,6 +101,8 @@ void Utf8_input_stream::close() noexcept
 
     converter_ = nullptr;
 
+    transcoder_ = nullptr;
+
     buffer_ = {};
 }
 
@@ -114,7 +118,10 @@ Utf8_input_stream::Utf8_input_stream(Intrusive_ptr<Input_stream> inner, Text_enc
         return;
     }
 
-    converter_ = std::make_unique<Iconv_desc>(std::move(encoding));
+    transcoder_ = Unicode_transcoder::make(encoding);
+    if (transcoder_ == nullptr) {
+        converter_ = std::make_unique<Iconv_desc>(std::move(encoding));
+    }
 
     buffer_ = memory_allocator().allocate(0x200'0000);  // 32 MiB
 
@@ -136,9 +143,13 @@ std::size_t Utf8_input_stream::convert(Mutable_memory_span destination)
                 // there are unconsumed bytes in the buffer that cannot
                 // be converted.
                 if (buffer_pos_ != buffer_->begin()) {
+                    const Text_encoding &encoding = transcoder_ != nullptr
+                                                        ? transcoder_->encoding()
+                                                        : converter_->encoding();
+
                     throw Stream_error{fmt::format(
                         "An invalid byte sequence encountered while converting from {0} to UTF-8.",
-                        converter_->encoding().name())};
+                        encoding.name())};
                 }
 
                 return 0;
@@ -154,7 +165,13 @@ std::size_t Utf8_input_stream::convert(Mutable_memory_span destination)
 
         Memory_span inp{buffer_pos_, buffer_end_};
 
-        Iconv_status s = converter_->convert(inp, out);
+        Iconv_status s{};
+        if (transcoder_ != nullptr) {
+            s = transcoder_->convert(inp, out);
+        }
+        else {
+            s = converter_->convert(inp, out);
+        }
 
         // If the buffer ends with a partial multi-byte character, we
         // have to move the leftover bits to the beginning of the
@@ -317,6 +334,14 @@ make_utf8_stream(Intrusive_ptr<Input_stream> stream, std::optional<Text_encoding
         }
         else {
             logger::debug("The stream starts with a {0} BOM.", encoding->name());
+
+            // The BOM is skipped by the record readers; there is nothing
+            // to convert.
+            if (*encoding == Text_encoding::utf8 && stream->seekable()) {
+                stream->seek(0);
+
+                return stream;
+            }
         }
     }
 
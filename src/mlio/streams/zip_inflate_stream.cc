@@ -0,0 +1,241 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/zip_inflate_stream.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include <tbb/tbb.h>
+
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/memory_block.h"
+#include "mlio/streams/detail/inflate_task_scheduler.h"
+#include "mlio/streams/detail/zip_archive.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Zip_task final : public Inflate_task {
+    explicit Zip_task(const Memory_slice &archive_, const Zip_entry &entry_) noexcept
+        : archive{&archive_}, entry{&entry_}
+    {}
+
+    void run() final;
+
+    const Memory_slice *archive;
+    const Zip_entry *entry;
+    Memory_slice output{};
+    std::exception_ptr error{};
+};
+
+namespace {
+
+Memory_slice read_archive(Input_stream &stream)
+{
+    std::size_t size = stream.size();
+
+    if (stream.supports_zero_copy()) {
+        return stream.read(size);
+    }
+
+    auto block = memory_allocator().allocate(size);
+
+    auto destination = make_span(*block);
+
+    while (!destination.empty()) {
+        std::size_t num_bytes_read = stream.read(destination);
+        if (num_bytes_read == 0) {
+            throw Stream_error{"The zip archive is shorter than its reported size."};
+        }
+
+        destination = destination.subspan(num_bytes_read);
+    }
+
+    return block;
+}
+
+}  // namespace
+
+void Zip_task::run()
+{
+    if (cancelled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Unlike a failed speculation in the parallel gzip and bzip2 streams,
+    // a failed member cannot be recovered from, so we hand the error over
+    // to the reader.
+    try {
+        output = inflate_zip_entry(*archive, *entry);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+}
+
+}  // namespace detail
+
+Zip_inflate_stream::Zip_inflate_stream(Intrusive_ptr<Input_stream> inner,
+                                       const Parallel_inflate_params &params)
+    : inner_{std::move(inner)}
+    , max_num_tasks_{params.max_num_tasks}
+    , scheduler_{std::make_unique<detail::Inflate_task_scheduler>()}
+{
+    if (!inner_->seekable()) {
+        throw std::invalid_argument{"The underlying stream must be seekable."};
+    }
+
+    if (max_num_tasks_ == 0) {
+        max_num_tasks_ = as_size(tbb::this_task_arena::max_concurrency());
+    }
+
+    archive_ = detail::read_archive(*inner_);
+
+    entries_ = std::make_unique<std::vector<detail::Zip_entry>>(
+        detail::read_zip_entries(archive_));
+}
+
+Zip_inflate_stream::~Zip_inflate_stream()
+{
+    cancel_tasks();
+}
+
+std::size_t Zip_inflate_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return 0;
+    }
+
+    std::size_t num_bytes_read = std::min(destination.size(), chunk_.size());
+
+    auto pos = chunk_.begin();
+
+    std::copy(pos, pos + as_ssize(num_bytes_read), destination.begin());
+
+    chunk_ = chunk_.subslice(num_bytes_read);
+
+    return num_bytes_read;
+}
+
+Memory_slice Zip_inflate_stream::read(std::size_t size)
+{
+    check_if_closed();
+
+    if (size == 0) {
+        return {};
+    }
+
+    if (chunk_.empty() && !next_chunk()) {
+        return {};
+    }
+
+    // If the request can be satisfied from the current chunk, avoid the
+    // copy and return a slice of it.
+    if (size <= chunk_.size()) {
+        Memory_slice slice = chunk_.subslice(0, size);
+
+        chunk_ = chunk_.subslice(size);
+
+        return slice;
+    }
+
+    return Input_stream_base::read(size);
+}
+
+void Zip_inflate_stream::close() noexcept
+{
+    cancel_tasks();
+
+    chunk_ = {};
+
+    archive_ = {};
+
+    inner_->close();
+}
+
+bool Zip_inflate_stream::closed() const noexcept
+{
+    return inner_->closed();
+}
+
+bool Zip_inflate_stream::next_chunk()
+{
+    while (chunk_.empty()) {
+        schedule_tasks();
+
+        if (tasks_.empty()) {
+            return false;
+        }
+
+        std::shared_ptr<detail::Zip_task> task = std::move(tasks_.front());
+
+        tasks_.pop_front();
+
+        scheduler_->wait(*task);
+
+        if (task->error) {
+            std::rethrow_exception(task->error);
+        }
+
+        chunk_ = std::move(task->output);
+    }
+
+    return true;
+}
+
+void Zip_inflate_stream::schedule_tasks()
+{
+    while (tasks_.size() < max_num_tasks_ && entry_idx_ < entries_->size()) {
+        auto task = std::make_shared<detail::Zip_task>(archive_, (*entries_)[entry_idx_++]);
+
+        tasks_.emplace_back(task);
+
+        scheduler_->schedule(std::move(task));
+    }
+}
+
+void Zip_inflate_stream::cancel_tasks() noexcept
+{
+    for (auto &task : tasks_) {
+        task->cancelled = true;
+    }
+
+    scheduler_->wait_all();
+
+    tasks_.clear();
+}
+
+void Zip_inflate_stream::check_if_closed() const
+{
+    if (inner_->closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
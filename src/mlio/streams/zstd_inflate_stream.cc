@@ -0,0 +1,298 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/streams/zstd_inflate_stream.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "mlio/streams/detail/zstd.h"
+#include "mlio/streams/input_stream.h"
+#include "mlio/streams/stream_error.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::Zstd_inflater;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+constexpr std::uint32_t skippable_frame_magic = 0x184D'2A5E;
+constexpr std::uint32_t seekable_magic = 0x8F92'EAB1;
+
+constexpr std::size_t skippable_frame_header_size = 8;
+constexpr std::size_t seek_table_footer_size = 9;
+
+std::uint32_t read_le32(Memory_span data, std::size_t offset) noexcept
+{
+    auto b = as_span<const std::uint8_t>(data.subspan(offset, 4));
+
+    return static_cast<std::uint32_t>(b[0]) | (static_cast<std::uint32_t>(b[1]) << 8) |
+           (static_cast<std::uint32_t>(b[2]) << 16) | (static_cast<std::uint32_t>(b[3]) << 24);
+}
+
+void read_exactly(Input_stream &stream, Mutable_memory_span destination)
+{
+    while (!destination.empty()) {
+        std::size_t num_bytes_read = stream.read(destination);
+        if (num_bytes_read == 0) {
+            throw Inflate_error{"The zstd seek table is truncated."};
+        }
+
+        destination = destination.subspan(num_bytes_read);
+    }
+}
+
+}  // namespace
+}  // namespace detail
+
+Zstd_inflate_stream::Zstd_inflate_stream(Intrusive_ptr<Input_stream> inner)
+    : inner_{std::move(inner)}
+{
+    inflater_ = std::make_unique<Zstd_inflater>();
+
+    if (inner_->seekable()) {
+        read_seek_table();
+    }
+}
+
+Zstd_inflate_stream::~Zstd_inflate_stream() = default;
+
+void Zstd_inflate_stream::read_seek_table()
+{
+    std::size_t inner_size = inner_->size();
+    if (inner_size < detail::skippable_frame_header_size + detail::seek_table_footer_size) {
+        return;
+    }
+
+    std::array<std::byte, detail::seek_table_footer_size> footer{};
+
+    inner_->seek(inner_size - footer.size());
+
+    detail::read_exactly(*inner_, footer);
+
+    // Make sure that we read the data from the beginning regardless of
+    // whether the stream has a seek table.
+    inner_->seek(0);
+
+    if (detail::read_le32(footer, 5) != detail::seekable_magic) {
+        return;
+    }
+
+    auto descriptor = static_cast<std::uint8_t>(footer[4]);
+
+    // Bits 2 to 6 are reserved and must be zero.
+    if ((descriptor & 0x7c) != 0) {
+        throw Inflate_error{"The zstd seek table has an unsupported descriptor."};
+    }
+
+    std::size_t entry_size = (descriptor & 0x80) != 0 ? 12 : 8;
+
+    std::size_t num_frames = detail::read_le32(footer, 0);
+
+    std::size_t table_size = num_frames * entry_size + detail::seek_table_footer_size;
+    if (table_size + detail::skippable_frame_header_size > inner_size) {
+        throw Inflate_error{"The zstd seek table is corrupt."};
+    }
+
+    std::size_t table_offset = inner_size - table_size - detail::skippable_frame_header_size;
+
+    std::vector<std::byte> table(table_size + detail::skippable_frame_header_size);
+
+    inner_->seek(table_offset);
+
+    detail::read_exactly(*inner_, table);
+
+    inner_->seek(0);
+
+    if (detail::read_le32(table, 0) != detail::skippable_frame_magic ||
+        detail::read_le32(table, 4) != table_size) {
+        throw Inflate_error{"The zstd seek table is corrupt."};
+    }
+
+    std::vector<Frame> frames{};
+    frames.reserve(num_frames);
+
+    std::size_t compressed_offset = 0;
+    std::size_t offset = 0;
+
+    auto entries = Memory_span{table}.subspan(detail::skippable_frame_header_size);
+
+    for (std::size_t i = 0; i < num_frames; i++) {
+        auto entry = entries.subspan(i * entry_size);
+
+        frames.push_back(Frame{compressed_offset, offset});
+
+        compressed_offset += detail::read_le32(entry, 0);
+        offset += detail::read_le32(entry, 4);
+    }
+
+    // The frames must be laid out back-to-back right before the seek
+    // table; otherwise we cannot trust the offsets.
+    if (compressed_offset != table_offset) {
+        throw Inflate_error{"The zstd seek table does not match the frames of the stream."};
+    }
+
+    frames_ = std::move(frames);
+
+    size_ = offset;
+}
+
+std::size_t Zstd_inflate_stream::read(Mutable_memory_span destination)
+{
+    check_if_closed();
+
+    if (destination.empty()) {
+        return 0;
+    }
+
+    // Inflate and discard the data between the start of the frame we
+    // sought to and the requested position.
+    while (num_bytes_to_skip_ > 0) {
+        std::size_t num_bytes_inflated =
+            inflate(destination.first(std::min(destination.size(), num_bytes_to_skip_)));
+        if (num_bytes_inflated == 0) {
+            throw Inflate_error{"The zstd stream is shorter than its seek table indicates."};
+        }
+
+        num_bytes_to_skip_ -= num_bytes_inflated;
+    }
+
+    std::size_t num_bytes_read = inflate(destination);
+
+    pos_ += num_bytes_read;
+
+    return num_bytes_read;
+}
+
+std::size_t Zstd_inflate_stream::inflate(Mutable_memory_span destination)
+{
+    for (;;) {
+        bool has_input = true;
+
+        if (buffer_pos_ == buffer_.end()) {
+            buffer_ = inner_->read(0x8'0000);  // 512 KiB
+
+            // Make sure to reset the position before checking whether
+            // we reached the end of the stream; otherwise the function
+            // won't behave correctly if called a second time.
+            buffer_pos_ = buffer_.begin();
+
+            if (buffer_.empty()) {
+                if (inflater_->eof()) {
+                    return 0;
+                }
+
+                // The inflater might still hold data that did not fit
+                // into the previous destination.
+                has_input = false;
+            }
+        }
+
+        Memory_span inp{buffer_pos_, buffer_.end()};
+
+        auto out = destination;
+
+        inflater_->inflate(inp, out);
+
+        buffer_pos_ = buffer_.end() - stdx::ssize(inp);
+
+        std::size_t num_bytes_inflated = destination.size() - out.size();
+        if (num_bytes_inflated > 0) {
+            return num_bytes_inflated;
+        }
+
+        if (!has_input) {
+            throw Inflate_error{"The zstd stream contains invalid or incomplete data."};
+        }
+    }
+}
+
+void Zstd_inflate_stream::seek(std::size_t position)
+{
+    check_if_closed();
+
+    if (frames_.empty()) {
+        Input_stream_base::seek(position);
+    }
+
+    position = std::min(position, size_);
+
+    auto pos = std::upper_bound(
+        frames_.begin(), frames_.end(), position, [](std::size_t offset, const Frame &frame) {
+            return offset < frame.offset;
+        });
+
+    const Frame &frame = *(pos - 1);
+
+    inner_->seek(frame.compressed_offset);
+
+    inflater_->reset();
+
+    buffer_ = {};
+
+    buffer_pos_ = buffer_.begin();
+
+    num_bytes_to_skip_ = position - frame.offset;
+
+    pos_ = position;
+}
+
+void Zstd_inflate_stream::close() noexcept
+{
+    inner_->close();
+
+    inflater_ = nullptr;
+
+    buffer_ = {};
+}
+
+std::size_t Zstd_inflate_stream::size() const
+{
+    check_if_closed();
+
+    if (frames_.empty()) {
+        return Input_stream_base::size();
+    }
+    return size_;
+}
+
+std::size_t Zstd_inflate_stream::position() const
+{
+    check_if_closed();
+
+    if (frames_.empty()) {
+        return Input_stream_base::position();
+    }
+    return pos_;
+}
+
+bool Zstd_inflate_stream::closed() const noexcept
+{
+    return inner_->closed();
+}
+
+void Zstd_inflate_stream::check_if_closed() const
+{
+    if (inner_->closed()) {
+        throw Stream_error{"The input stream is closed."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
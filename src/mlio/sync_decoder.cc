@@ -0,0 +1,70 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/sync_decoder.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "mlio/example.h"
+#include "mlio/schema.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Sync_decoder::Sync_decoder(Intrusive_ptr<Parallel_data_reader> reader) : reader_{std::move(reader)}
+{
+    if (reader_ == nullptr) {
+        throw std::invalid_argument{"The data reader must not be null."};
+    }
+}
+
+Sync_decoder::~Sync_decoder() = default;
+
+Intrusive_ptr<Example> Sync_decoder::decode(Memory_slice buffer)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    Intrusive_ptr<Example> example = reader_->decode_buffer(std::move(buffer));
+
+    // We keep a reference to the schema so that schema() never has to
+    // touch the dataset of the reader.
+    if (example != nullptr && schema_ == nullptr) {
+        schema_ = wrap_intrusive(&example->schema());
+    }
+
+    return example;
+}
+
+bool Sync_decoder::decode(Memory_slice buffer, Intrusive_ptr<Example> &example)
+{
+    // Returns the tensor buffers of the previous example to the tensor
+    // pool of the reader before they are requested again.
+    example = nullptr;
+
+    example = decode(std::move(buffer));
+
+    return example != nullptr;
+}
+
+Intrusive_ptr<const Schema> Sync_decoder::schema() const
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    return schema_;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+#include "mlio/tar_shard.h"
+
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/error.h"
+#include "mlio/instance.h"
+#include "mlio/memory/memory_slice.h"
+#include "mlio/record_readers/detail/tar_header.h"
+#include "mlio/record_readers/detail/util.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::current_error_code;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+std::string_view get_member_name(std::string_view id) noexcept
+{
+    std::size_t pos = id.rfind('/');
+    if (pos == std::string_view::npos) {
+        return id;
+    }
+    return id.substr(pos + 1);
+}
+
+}  // namespace
+}  // namespace detail
+
+void write_tar_shard(const std::string &path, stdx::span<const Intrusive_ptr<Data_store>> stores)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+    auto write = [&file](Memory_span bits) {
+        auto chars = as_span<const char>(bits);
+
+        file.write(chars.data(), as_ssize(chars.size()));
+    };
+
+    std::array<std::byte, detail::tar_block_size> block{};
+
+    for (const Intrusive_ptr<Data_store> &store : stores) {
+        if (!file) {
+            break;
+        }
+
+        Instance instance{*store};
+
+        const Memory_slice &bits = instance.bits();
+
+        detail::encode_tar_header(detail::get_member_name(store->id()), bits.size(), block);
+
+        write(block);
+        write(bits);
+
+        // Members are padded to a multiple of the block size.
+        std::size_t padding = detail::align(bits.size(), detail::tar_block_size) - bits.size();
+
+        block.fill({});
+
+        write(Memory_span{block}.first(padding));
+    }
+
+    // The end of the archive is marked by two zero blocks.
+    block.fill({});
+
+    write(block);
+    write(block);
+
+    if (!file) {
+        throw std::system_error{current_error_code(), "The tar shard cannot be written."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
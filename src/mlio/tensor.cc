@@ -15,6 +15,7 @@
 
 #include "mlio/tensor.h"
 
+#include <cstdint>
 #include <cstdlib>
 #include <stdexcept>
 
@@ -181,7 +182,7 @@ Csr_tensor::Csr_tensor(Size_vector shape,
         num_rows = shp[0];
     }
 
-    if (indptr->size() != num_rows + 1) {
+    if (indptr_->size() != num_rows + 1) {
         throw std::invalid_argument{
             "The size of the index pointer array does not match the size of the row dimension."};
     }
@@ -202,5 +203,67 @@ void Csr_tensor::accept(Tensor_visitor &visitor) const
     visitor.visit(*this);
 }
 
+String_tensor::String_tensor(Size_vector shape,
+                             std::unique_ptr<Device_array> &&data,
+                             std::unique_ptr<Device_array> &&offsets)
+    : Tensor{Data_type::string, std::move(shape), {}}
+    , data_{std::move(data)}
+    , offsets_{std::move(offsets)}
+{
+    if (data_->data_type() != Data_type::uint8) {
+        throw std::invalid_argument{"The data type of the data array must be uint8."};
+    }
+
+    if (offsets_->data_type() != Data_type::int64) {
+        throw std::invalid_argument{"The data type of the offset array must be int64."};
+    }
+
+    std::size_t num_elements = 1;
+    for (std::size_t dim : this->shape()) {
+        num_elements *= dim;
+    }
+
+    if (offsets_->size() != num_elements + 1) {
+        throw std::invalid_argument{
+            "The size of the offset array does not match the specified shape."};
+    }
+
+    auto ofs = as_span<const std::int64_t>(*offsets_);
+    if (ofs[0] < 0 || as_size(ofs[ofs.size() - 1]) > data_->size()) {
+        throw std::invalid_argument{"The offset array is out of the bounds of the data array."};
+    }
+    for (std::size_t i = 1; i < ofs.size(); i++) {
+        if (ofs[i] < ofs[i - 1]) {
+            throw std::invalid_argument{"The offset array must be monotonically increasing."};
+        }
+    }
+}
+
+std::string String_tensor::repr() const
+{
+    return detail::repr(*this, "String_tensor");
+}
+
+std::string_view String_tensor::value(std::size_t index) const noexcept
+{
+    auto ofs = as_span<const std::int64_t>(*offsets_);
+    auto chars = as_span<const char>(*data_);
+
+    auto begin = as_size(ofs[index]);
+    auto end = as_size(ofs[index + 1]);
+
+    return std::string_view{chars.data() + begin, end - begin};
+}
+
+void String_tensor::accept(Tensor_visitor &visitor)
+{
+    visitor.visit(*this);
+}
+
+void String_tensor::accept(Tensor_visitor &visitor) const
+{
+    visitor.visit(*this);
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/tensor_pool.h"
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+#include "mlio/cpu_array.h"
+#include "mlio/detail/array_group.h"
+#include "mlio/memory/memory_allocator.h"
+#include "mlio/memory/page_memory_block.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+// Exposes a pooled memory block as a sequence container so that it can
+// be wrapped by a Cpu_array. Returns the block to the pool when the
+// array gets destroyed.
+template<typename T>
+class Pooled_buffer {
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    explicit Pooled_buffer(Tensor_pool &pool, Data_type dt, std::size_t size, bool zero_fill)
+        : pool_{wrap_intrusive(&pool)}, data_type_{dt}, size_{size}
+    {
+        bool zero_filled{};
+
+        block_ = pool.acquire(dt, sizeof(T) * size, zero_filled);
+
+        // Match the behavior of make_cpu_array() which returns a
+        // zero-initialized array.
+        if (zero_fill && !zero_filled) {
+            std::fill(begin(), end(), T{});
+        }
+    }
+
+    Pooled_buffer(const Pooled_buffer &) = delete;
+
+    Pooled_buffer &operator=(const Pooled_buffer &) = delete;
+
+    Pooled_buffer(Pooled_buffer &&) noexcept = default;
+
+    Pooled_buffer &operator=(Pooled_buffer &&) = delete;
+
+    ~Pooled_buffer()
+    {
+        if (block_ != nullptr) {
+            pool_->release(data_type_, sizeof(T) * size_, std::move(block_));
+        }
+    }
+
+    T *data() noexcept
+    {
+        return reinterpret_cast<T *>(block_->data());
+    }
+
+    const T *data() const noexcept
+    {
+        return reinterpret_cast<const T *>(block_->data());
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    T *begin() noexcept
+    {
+        return data();
+    }
+
+    T *end() noexcept
+    {
+        return data() + size_;
+    }
+
+    const T *begin() const noexcept
+    {
+        return data();
+    }
+
+    const T *end() const noexcept
+    {
+        return data() + size_;
+    }
+
+private:
+    Intrusive_ptr<Tensor_pool> pool_;
+    Data_type data_type_;
+    std::size_t size_;
+    Intrusive_ptr<Mutable_memory_block> block_{};
+};
+
+namespace {
+
+// Rounds the specified size up to a multiple of an eighth of its
+// enclosing power of two; this wastes at most 12.5% of a buffer.
+std::size_t round_up_to_size_class(std::size_t num_bytes) noexcept
+{
+    constexpr std::size_t min_step = 64;
+
+    std::size_t step = min_step;
+    while (step * 16 <= num_bytes) {
+        step *= 2;
+    }
+
+    return (num_bytes + step - 1) / step * step;
+}
+
+template<Data_type dt>
+struct make_pooled_cpu_array_op {
+    std::unique_ptr<Device_array>
+    operator()(Tensor_pool &pool, std::size_t size, bool zero_fill)
+    {
+        using T = data_type_t<dt>;
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            return Cpu_array_access::wrap(dt, Pooled_buffer<T>{pool, dt, size, zero_fill});
+        }
+        else {
+            return make_cpu_array(dt, size);
+        }
+    }
+};
+
+}  // namespace
+}  // namespace detail
+
+Tensor_pool::Tensor_pool(std::size_t capacity, bool huge_pages) noexcept
+    : capacity_{capacity}, huge_pages_{huge_pages}
+{}
+
+Tensor_pool::~Tensor_pool() = default;
+
+std::unique_ptr<Device_array>
+Tensor_pool::make_cpu_array(Data_type dt, std::size_t size, bool zero_fill)
+{
+    if (size == 0) {
+        return mlio::make_cpu_array(dt, size);
+    }
+
+    return dispatch<detail::make_pooled_cpu_array_op>(dt, *this, size, zero_fill);
+}
+
+std::vector<std::unique_ptr<Device_array>>
+Tensor_pool::make_cpu_arrays(stdx::span<const Data_type> dts, std::size_t size)
+{
+    std::vector<std::size_t> offsets = detail::layout_array_group(dts, size);
+
+    if (offsets.back() == 0) {
+        return mlio::make_cpu_arrays(dts, size);
+    }
+
+    // The shared buffer is pooled as a byte array so that it can be
+    // reused by any group with the same total size.
+    auto buffer =
+        std::make_shared<detail::Pooled_buffer<std::byte>>(
+        *this, Data_type::uint8, offsets.back(), true);
+
+    return detail::carve_array_group(buffer, buffer->data(), dts, offsets, size);
+}
+
+std::vector<std::unique_ptr<Device_array>>
+Tensor_pool::make_cpu_arrays(stdx::span<const Data_type> dts, stdx::span<const std::size_t> sizes)
+{
+    std::vector<std::size_t> offsets = detail::layout_array_group(dts, sizes);
+
+    if (offsets.back() == 0) {
+        std::vector<std::unique_ptr<Device_array>> arrays{};
+        arrays.reserve(dts.size());
+
+        for (std::size_t i = 0; i < dts.size(); i++) {
+            arrays.emplace_back(mlio::make_cpu_array(dts[i], sizes[i]));
+        }
+
+        return arrays;
+    }
+
+    std::size_t num_bytes = detail::round_up_to_size_class(offsets.back());
+
+    auto buffer = std::make_shared<detail::Pooled_buffer<std::byte>>(
+        *this, Data_type::uint8, num_bytes, false);
+
+    return detail::carve_array_group(buffer, buffer->data(), dts, offsets, sizes);
+}
+
+Intrusive_ptr<Mutable_memory_block>
+Tensor_pool::acquire(Data_type dt, std::size_t num_bytes, bool &zero_filled)
+{
+    // The size above which the buffers are mapped from the operating
+    // system instead of the heap.
+    constexpr std::size_t min_page_block_size = 0x1'0000;  // 64 KiB
+
+    zero_filled = false;
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        auto pos = buffers_.find(std::make_pair(dt, num_bytes));
+        if (pos != buffers_.end() && !pos->second.empty()) {
+            Intrusive_ptr<Mutable_memory_block> block = std::move(pos->second.back());
+
+            pos->second.pop_back();
+
+            num_cached_bytes_ -= num_bytes;
+
+            num_hits_.fetch_add(1, std::memory_order_relaxed);
+
+            return block;
+        }
+    }
+
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+
+    if (num_bytes >= min_page_block_size) {
+        // A freshly mapped block is zero-filled by the kernel.
+        zero_filled = true;
+
+        return make_intrusive<Page_memory_block>(num_bytes, huge_pages_, true);
+    }
+
+    return memory_allocator().allocate(num_bytes);
+}
+
+void Tensor_pool::release(Data_type dt,
+                          std::size_t num_bytes,
+                          Intrusive_ptr<Mutable_memory_block> &&block) noexcept
+{
+    // The block is freed outside of the lock if the pool is full or if
+    // we fail to store it.
+    Intrusive_ptr<Mutable_memory_block> b = std::move(block);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (num_cached_bytes_ + num_bytes > capacity_) {
+        return;
+    }
+
+    try {
+        buffers_[std::make_pair(dt, num_bytes)].emplace_back(std::move(b));
+    }
+    catch (const std::bad_alloc &) {
+        return;
+    }
+
+    num_cached_bytes_ += num_bytes;
+}
+
+Tensor_pool_stats Tensor_pool::stats() const
+{
+    Tensor_pool_stats stats{};
+
+    stats.num_hits = num_hits_.load(std::memory_order_relaxed);
+    stats.num_misses = num_misses_.load(std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    stats.num_cached_bytes = num_cached_bytes_;
+
+    return stats;
+}
+
+void Tensor_pool::clear() noexcept
+{
+    decltype(buffers_) buffers{};
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    buffers_.swap(buffers);
+
+    num_cached_bytes_ = 0;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
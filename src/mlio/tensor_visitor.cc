@@ -63,5 +63,15 @@ void Tensor_visitor::visit(const Csr_tensor &tensor)
     visit(static_cast<const Tensor &>(tensor));
 }
 
+void Tensor_visitor::visit(String_tensor &tensor)
+{
+    visit(static_cast<Tensor &>(tensor));
+}
+
+void Tensor_visitor::visit(const String_tensor &tensor)
+{
+    visit(static_cast<const Tensor &>(tensor));
+}
+
 }  // namespace abi_v1
 }  // namespace mlio
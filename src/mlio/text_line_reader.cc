@@ -15,16 +15,27 @@
 
 #include "mlio/text_line_reader.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include <tbb/tbb.h>
 
 #include "mlio/cpu_array.h"
 #include "mlio/data_type.h"
+#include "mlio/detail/string_tensor.h"
+#include "mlio/detail/wordpiece_tokenizer.h"
 #include "mlio/example.h"
 #include "mlio/instance.h"
 #include "mlio/instance_batch.h"
 #include "mlio/record_readers/text_line_record_reader.h"
 #include "mlio/streams/utf8_input_stream.h"
 #include "mlio/tensor.h"
+#include "mlio/util/cast.h"
 #include "mlio/util/string.h"
 
 using mlio::detail::Text_line_record_reader;
@@ -32,9 +43,22 @@ using mlio::detail::Text_line_record_reader;
 namespace mlio {
 inline namespace abi_v1 {
 
-Text_line_reader::Text_line_reader(Data_reader_params params)
-    : Parallel_data_reader{std::move(params)}
-{}
+Text_line_reader::Text_line_reader(Data_reader_params params, Text_line_params text_params)
+    : Parallel_data_reader{std::move(params)}, text_params_{std::move(text_params)}
+{
+    if (text_params_.wordpiece) {
+        if (text_params_.pack_lines) {
+            throw std::invalid_argument{"The lines cannot be both packed and tokenized."};
+        }
+
+        tokenizer_ = std::make_unique<detail::Wordpiece_tokenizer>(*text_params_.wordpiece);
+    }
+
+    if (text_params_.arena_strings && (text_params_.pack_lines || text_params_.wordpiece)) {
+        throw std::invalid_argument{
+            "The lines cannot be returned as a string tensor if they are packed or tokenized."};
+    }
+}
 
 Text_line_reader::~Text_line_reader()
 {
@@ -44,24 +68,50 @@ Text_line_reader::~Text_line_reader()
 Intrusive_ptr<Record_reader> Text_line_reader::make_record_reader(const Data_store &store)
 {
     auto stream = make_utf8_stream(store.open_read());
-    return make_intrusive<Text_line_record_reader>(std::move(stream), false);
+    return make_intrusive<Text_line_record_reader>(
+        std::move(stream), false, text_params_.validate_utf8);
 }
 
 Intrusive_ptr<const Schema> Text_line_reader::infer_schema(const std::optional<Instance> &)
 {
     std::vector<Attribute> attrs{};
-    attrs.emplace_back("value", Data_type::string, Size_vector{params().batch_size, 1});
+    if (text_params_.wordpiece) {
+        Size_vector shape{params().batch_size, text_params_.wordpiece->max_sequence_length};
+
+        attrs.emplace_back("input_ids", Data_type::int32, shape);
+        attrs.emplace_back("attention_mask", Data_type::int32, shape);
+    }
+    else if (text_params_.pack_lines) {
+        attrs.emplace_back("value", Data_type::uint8, Size_vector{0});
+        attrs.emplace_back(
+            "value_offsets", Data_type::int64, Size_vector{params().batch_size + 1});
+    }
+    else {
+        attrs.emplace_back("value", Data_type::string, Size_vector{params().batch_size, 1});
+    }
 
     return make_intrusive<Schema>(std::move(attrs));
 }
 
 Intrusive_ptr<Example> Text_line_reader::decode(const Instance_batch &batch) const
 {
+    if (text_params_.wordpiece) {
+        return decode_tokenized(batch);
+    }
+
+    if (text_params_.pack_lines) {
+        return decode_packed(batch);
+    }
+
+    if (text_params_.arena_strings) {
+        return decode_arena(batch);
+    }
+
     Intrusive_ptr<Dense_tensor> tensor = make_tensor(batch.size());
 
     auto row_pos = tensor->data().as<std::string>().begin();
-    for (const Instance &instance : batch.instances()) {
-        *row_pos++ = as_string_view(instance.bits());
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        *row_pos++ = as_string_view(batch.bits(i));
     }
 
     std::vector<Intrusive_ptr<Tensor>> tensors{};
@@ -69,7 +119,148 @@ Intrusive_ptr<Example> Text_line_reader::decode(const Instance_batch &batch) con
 
     auto example = make_intrusive<Example>(schema(), std::move(tensors));
 
-    example->padding = batch.size() - batch.instances().size();
+    example->padding = batch.size() - batch.num_instances();
+
+    return example;
+}
+
+Intrusive_ptr<Example> Text_line_reader::decode_packed(const Instance_batch &batch) const
+{
+    std::size_t num_bytes = 0;
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        num_bytes += batch.bits(i).size();
+    }
+
+    std::vector<std::uint8_t> bytes(num_bytes);
+
+    // The offsets of the padding rows denote empty lines.
+    std::vector<std::int64_t> offsets(batch.size() + 1, as_ssize(num_bytes));
+
+    std::size_t offset = 0;
+
+    auto offset_pos = offsets.begin();
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        Memory_span bits = batch.bits(i);
+
+        *offset_pos++ = as_ssize(offset);
+
+        if (!bits.empty()) {
+            std::memcpy(bytes.data() + offset, bits.data(), bits.size());
+        }
+
+        offset += bits.size();
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.emplace_back(make_intrusive<Dense_tensor>(
+        Size_vector{num_bytes}, wrap_cpu_array<Data_type::uint8>(std::move(bytes))));
+    tensors.emplace_back(make_intrusive<Dense_tensor>(
+        Size_vector{batch.size() + 1}, wrap_cpu_array<Data_type::int64>(std::move(offsets))));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - batch.num_instances();
+
+    return example;
+}
+
+Intrusive_ptr<Example> Text_line_reader::decode_arena(const Instance_batch &batch) const
+{
+    // The padding rows are empty strings.
+    std::vector<std::string_view> lines(batch.size());
+    for (std::size_t i = 0; i < batch.num_instances(); i++) {
+        lines[i] = as_string_view(batch.bits(i));
+    }
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.emplace_back(detail::make_string_tensor(Size_vector{batch.size(), 1}, lines));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - batch.num_instances();
+
+    return example;
+}
+
+Intrusive_ptr<Example> Text_line_reader::decode_tokenized(const Instance_batch &batch) const
+{
+    const Wordpiece_params &wp = *text_params_.wordpiece;
+
+    std::size_t seq_len = wp.max_sequence_length;
+
+    std::vector<std::int32_t> ids(batch.size() * seq_len, tokenizer_->padding_id());
+    std::vector<std::int32_t> mask(batch.size() * seq_len);
+
+    // Without packing each line is tokenized right into its row;
+    // otherwise into a scratch row from which the sequences are packed.
+    std::vector<std::int32_t> scratch{};
+    if (wp.pack_sequences) {
+        scratch.resize(batch.num_instances() * seq_len);
+    }
+
+    std::vector<std::size_t> lengths(batch.num_instances());
+
+    std::int32_t *out = wp.pack_sequences ? scratch.data() : ids.data();
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>{0, batch.num_instances()}, [&](auto &range) {
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            stdx::span<std::int32_t> row{out + i * seq_len, seq_len};
+
+            lengths[i] = tokenizer_->encode(as_string_view(batch.bits(i)), row);
+        }
+    });
+
+    std::size_t num_rows{};
+
+    if (wp.pack_sequences) {
+        std::size_t row = 0;
+        std::size_t pos = 0;
+
+        std::int32_t segment = 0;
+
+        for (std::size_t i = 0; i < batch.num_instances(); i++) {
+            if (pos + lengths[i] > seq_len) {
+                row++;
+
+                pos = 0;
+
+                segment = 0;
+            }
+
+            segment++;
+
+            std::size_t offset = row * seq_len + pos;
+
+            std::copy_n(scratch.begin() + as_ssize(i * seq_len),
+                        lengths[i],
+                        ids.begin() + as_ssize(offset));
+
+            std::fill_n(mask.begin() + as_ssize(offset), lengths[i], segment);
+
+            pos += lengths[i];
+        }
+
+        num_rows = batch.num_instances() == 0 ? 0 : row + 1;
+    }
+    else {
+        for (std::size_t i = 0; i < batch.num_instances(); i++) {
+            std::fill_n(mask.begin() + as_ssize(i * seq_len), lengths[i], 1);
+        }
+
+        num_rows = batch.num_instances();
+    }
+
+    Size_vector shape{batch.size(), seq_len};
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.emplace_back(
+        make_intrusive<Dense_tensor>(shape, wrap_cpu_array<Data_type::int32>(std::move(ids))));
+    tensors.emplace_back(
+        make_intrusive<Dense_tensor>(shape, wrap_cpu_array<Data_type::int32>(std::move(mask))));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - num_rows;
 
     return example;
 }
@@ -0,0 +1,830 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/tf_example_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/tbb.h>
+
+#include "mlio/cpu_array.h"
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/detail/decode_warning_log.h"
+#include "mlio/example.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/logger.h"
+#include "mlio/record_readers/tfrecord_record_reader.h"
+#include "mlio/schema.h"
+#include "mlio/sparse_tensor_builder.h"
+#include "mlio/tensor.h"
+#include "mlio/tf_example_scanner.h"
+#include "mlio/util/cast.h"
+
+using mlio::detail::Sparse_tensor_builder;
+using mlio::detail::Sparse_tensor_builder_impl;
+using mlio::detail::Tf_example_scanner;
+using mlio::detail::Tf_feature;
+using mlio::detail::Tf_feature_kind;
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The scratch buffers of the wire-format scanner.
+thread_local std::vector<Tf_feature> features_{};             // NOLINT(cert-err58-cpp)
+thread_local std::vector<const Tf_feature *> attr_features_{};  // NOLINT(cert-err58-cpp)
+thread_local std::vector<std::size_t> num_values_{};          // NOLINT(cert-err58-cpp)
+
+// Sparse tensor builders expect contiguous arrays.
+thread_local std::vector<std::uint64_t> sparse_keys_{};  // NOLINT(cert-err58-cpp)
+
+template<typename T>
+thread_local std::vector<T> sparse_values_{};  // NOLINT(cert-err58-cpp)
+
+Data_type get_data_type(Tf_feature_kind kind) noexcept
+{
+    switch (kind) {
+    case Tf_feature_kind::bytes_list:
+        return Data_type::string;
+    case Tf_feature_kind::float_list:
+        return Data_type::float32;
+    case Tf_feature_kind::int64_list:
+        return Data_type::int64;
+    case Tf_feature_kind::none:
+        break;
+    }
+    return {};
+}
+
+}  // namespace
+}  // namespace detail
+
+namespace {
+
+using Sparse_tensor_builder_list = std::vector<std::unique_ptr<Sparse_tensor_builder>>;
+
+// Holds the sparse tensor builders of a contiguous range of rows that got
+// decoded in parallel.
+struct Sparse_row_range {
+    std::size_t first_row_idx{};
+    Sparse_tensor_builder_list sparse_tensor_builders{};
+};
+
+}  // namespace
+
+class Tf_example_reader::Decoder_state {
+public:
+    explicit Decoder_state(const Tf_example_reader &r, std::size_t batch_size);
+
+    Sparse_tensor_builder_list make_sparse_tensor_builders(std::size_t num_rows) const;
+
+    void merge_sparse_tensor_builders(tbb::concurrent_vector<Sparse_row_range> &row_ranges);
+
+    const Tf_example_reader *reader;
+    bool warn_bad_instance;
+    bool error_bad_example;
+    detail::Decode_warning_log warnings{};
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    Sparse_tensor_builder_list sparse_tensor_builders{};
+
+private:
+    std::unique_ptr<Sparse_tensor_builder>
+    make_sparse_tensor_builder(std::size_t attr_idx, std::size_t num_rows) const;
+};
+
+class Tf_example_reader::Decoder {
+public:
+    explicit Decoder(Decoder_state &state, Sparse_tensor_builder_list &sparse_tensor_builders)
+        : state_{&state}, sparse_tensor_builders_{&sparse_tensor_builders}
+    {}
+
+    bool decode(std::size_t row_idx, const Instance &instance);
+
+private:
+    std::optional<std::size_t> find_attribute(std::string_view name) noexcept;
+
+    bool validate_feature(const Tf_feature *feature, std::size_t &num_values);
+
+    template<Data_type dt>
+    void copy_feature(const Tf_feature &feature, std::size_t num_values);
+
+    template<typename Format_fn>
+    void report_bad_instance(detail::Decode_warning_kind kind, Format_fn &&format_message) const;
+
+    Decoder_state *state_;
+    Sparse_tensor_builder_list *sparse_tensor_builders_;
+    const Instance *instance_{};
+    std::size_t row_idx_{};
+    std::size_t attr_idx_{};
+    const Attribute *attr_{};
+    // The features of a message are most likely in the same order as
+    // the attributes of the schema.
+    std::size_t last_attr_idx_ = std::numeric_limits<std::size_t>::max();
+};
+
+Tf_example_reader::Tf_example_reader(Data_reader_params params, Tf_example_params tf_params)
+    : Parallel_data_reader{std::move(params)}, tf_params_{std::move(tf_params)}
+{
+    for (auto &[name, dt] : tf_params_.data_types) {
+        if (dt != Data_type::float32 && dt != Data_type::int64 && dt != Data_type::string) {
+            throw std::invalid_argument{fmt::format(
+                "The data type of the feature '{0}' must be float32, int64, or string.", name)};
+        }
+    }
+
+    for (auto &[name, max_num_values] : tf_params_.sparse_features) {
+        if (max_num_values == 0) {
+            throw std::invalid_argument{fmt::format(
+                "The maximum number of values of the sparse feature '{0}' must be greater than zero.",
+                name)};
+        }
+    }
+}
+
+Tf_example_reader::~Tf_example_reader()
+{
+    // Make sure that we stop parallel reading before the member objects
+    // get destructed; otherwise a background task might try to access
+    // an already destructed object.
+    stop();
+}
+
+Intrusive_ptr<Record_reader> Tf_example_reader::make_record_reader(const Data_store &store)
+{
+    return make_intrusive<detail::Tfrecord_record_reader>(store.open_read(),
+                                                          tf_params_.verify_checksums);
+}
+
+Intrusive_ptr<const Schema> Tf_example_reader::infer_schema(const std::optional<Instance> &instance)
+{
+    if (instance == std::nullopt) {
+        return {};
+    }
+
+    std::vector<Tf_feature> &features = detail::features_;
+    if (!Tf_example_scanner::scan(instance->bits(), features)) {
+        throw Schema_error{fmt::format(
+            "The instance #{1:n} in the data store '{0}' contains a corrupt tf.train.Example message.",
+            instance->data_store().id(),
+            instance->index())};
+    }
+
+    const std::unordered_set<std::string> &use_features = tf_params_.use_features;
+
+    std::vector<Attribute> attrs{};
+
+    std::unordered_set<std::string> names{};
+
+    for (const Tf_feature &feature : features) {
+        std::string name{feature.name};
+
+        if (!use_features.empty() && use_features.find(name) == use_features.end()) {
+            continue;
+        }
+
+        // If a feature occurs more than once, the last occurrence wins.
+        auto pos = std::find_if(features.rbegin(), features.rend(), [&feature](const auto &f) {
+            return f.name == feature.name;
+        });
+        if (&*pos != &feature) {
+            continue;
+        }
+
+        std::optional<Data_type> dt{};
+        if (feature.kind != Tf_feature_kind::none) {
+            dt = detail::get_data_type(feature.kind);
+        }
+        else if (use_features.empty() && tf_params_.data_types.count(name) == 0) {
+            // An empty feature has no data type to infer; unless it is
+            // requested explicitly, leave it out.
+            continue;
+        }
+
+        std::size_t num_values{};
+        if (!Tf_example_scanner::count_values(feature, num_values)) {
+            throw Schema_error{fmt::format(
+                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has a corrupt value list.",
+                instance->data_store().id(),
+                instance->index(),
+                name)};
+        }
+
+        attrs.emplace_back(make_attribute(name, dt, num_values));
+
+        names.emplace(std::move(name));
+    }
+
+    // The features that are not found in the first record are appended
+    // in lexicographical order.
+    std::vector<std::string> missing_names{};
+    for (const std::string &name : use_features) {
+        if (names.find(name) == names.end()) {
+            missing_names.emplace_back(name);
+        }
+    }
+    for (auto &pr : tf_params_.sparse_features) {
+        if (use_features.empty() && names.find(pr.first) == names.end()) {
+            missing_names.emplace_back(pr.first);
+        }
+    }
+
+    std::sort(missing_names.begin(), missing_names.end());
+
+    for (const std::string &name : missing_names) {
+        attrs.emplace_back(make_attribute(name, {}, 0));
+    }
+
+    if (attrs.empty()) {
+        throw Schema_error{fmt::format(
+            "The instance #{1:n} in the data store '{0}' has no feature to read.",
+            instance->data_store().id(),
+            instance->index())};
+    }
+
+    auto schema = make_intrusive<Schema>(std::move(attrs));
+
+    attr_indices_.clear();
+
+    has_sparse_feature_ = false;
+
+    num_values_per_instance_ = 0;
+
+    for (std::size_t i = 0; i < schema->attributes().size(); i++) {
+        const Attribute &attr = schema->attributes()[i];
+
+        attr_indices_.emplace(attr.name(), i);
+
+        if (attr.sparse()) {
+            has_sparse_feature_ = true;
+        }
+        else {
+            num_values_per_instance_ += as_size(attr.strides()[0]);
+        }
+    }
+
+    nnz_per_row_estimates_ = std::vector<std::atomic_size_t>(schema->attributes().size());
+
+    return std::move(schema);
+}
+
+Attribute Tf_example_reader::make_attribute(const std::string &name,
+                                            std::optional<Data_type> dt,
+                                            std::size_t num_values) const
+{
+    auto type_pos = tf_params_.data_types.find(name);
+    if (type_pos != tf_params_.data_types.end()) {
+        if (dt && *dt != type_pos->second) {
+            throw std::invalid_argument{fmt::format(
+                "The feature '{0}' cannot be read as {1} as it has values of type {2}.",
+                name,
+                type_pos->second,
+                *dt)};
+        }
+        dt = type_pos->second;
+    }
+
+    if (dt == std::nullopt) {
+        throw Schema_error{fmt::format(
+            "The data type of the feature '{0}' cannot be inferred from the first record. Specify it in the data types.",
+            name)};
+    }
+
+    Size_vector shape{params().batch_size, num_values};
+
+    auto sparse_pos = tf_params_.sparse_features.find(name);
+    if (sparse_pos != tf_params_.sparse_features.end()) {
+        shape[1] = sparse_pos->second;
+
+        return Attribute{name, *dt, std::move(shape), {}, true};
+    }
+
+    if (num_values == 0) {
+        throw Schema_error{fmt::format(
+            "The dense feature '{0}' has no value in the first record. Read it as a sparse feature instead.",
+            name)};
+    }
+
+    return Attribute{name, *dt, std::move(shape)};
+}
+
+Intrusive_ptr<Example> Tf_example_reader::decode(const Instance_batch &batch) const
+{
+    Decoder_state state{*this, batch.size()};
+
+    std::size_t num_instances = batch.instances().size();
+
+    bool should_run_serial =
+        // If bad example handling mode is pad, we cannot parallelize
+        // decoding as good records must be stacked together without
+        // any gap in between.
+        params().bad_example_handling == Bad_example_handling::pad ||
+        params().bad_example_handling == Bad_example_handling::pad_warn ||
+        !should_decode_parallel(num_instances, num_values_per_instance_);
+
+    std::optional<std::size_t> num_instances_read{};
+    if (should_run_serial) {
+        num_instances_read = decode_serial(state, batch);
+    }
+    else {
+        num_instances_read = decode_parallel(state, batch);
+    }
+
+    report_decode_warnings(state.warnings);
+
+    // Check if we failed to decode the example and return a null pointer
+    // if that is the case.
+    if (num_instances_read == std::nullopt) {
+        if (params().bad_example_handling == Bad_example_handling::skip_warn) {
+            logger::warn("The example #{0:n} has been skipped as it had at least one bad instance.",
+                         batch.index());
+        }
+
+        return nullptr;
+    }
+
+    if (num_instances != *num_instances_read) {
+        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
+            logger::warn("The example #{0:n} has been padded as it had {1:n} bad instance(s).",
+                         batch.index(),
+                         num_instances - *num_instances_read);
+        }
+    }
+
+    for (std::size_t i = 0; i < state.tensors.size(); i++) {
+        Intrusive_ptr<Tensor> &tensor = state.tensors[i];
+
+        // If no tensor exists at the specified index, it means the
+        // corresponding feature is sparse and we should build its
+        // sparse tensor.
+        if (tensor == nullptr) {
+            Sparse_tensor_builder &builder = *state.sparse_tensor_builders[i];
+
+            update_nnz_estimate(i, builder);
+
+            tensor = builder.build(tensor_pool());
+        }
+    }
+
+    auto example = make_intrusive<Example>(schema(), std::move(state.tensors));
+
+    example->padding = batch.size() - *num_instances_read;
+
+    return example;
+}
+
+std::optional<std::size_t>
+Tf_example_reader::decode_serial(Decoder_state &state, const Instance_batch &batch) const
+{
+    std::size_t row_idx = 0;
+
+    for (const Instance &instance : batch.instances()) {
+        Decoder decoder{state, state.sparse_tensor_builders};
+        if (decoder.decode(row_idx, instance)) {
+            row_idx++;
+        }
+        else {
+            // If the user requested to skip the example in case of an
+            // error, shortcut the loop and return immediately.
+            if (params().bad_example_handling == Bad_example_handling::skip ||
+                params().bad_example_handling == Bad_example_handling::skip_warn) {
+                return {};
+            }
+            if (params().bad_example_handling != Bad_example_handling::pad &&
+                params().bad_example_handling != Bad_example_handling::pad_warn) {
+                throw std::invalid_argument{"The specified bad example handling is invalid."};
+            }
+        }
+    }
+
+    return row_idx;
+}
+
+std::optional<std::size_t>
+Tf_example_reader::decode_parallel(Decoder_state &state, const Instance_batch &batch) const
+{
+    std::atomic_bool skip_example{};
+
+    stdx::span<const Instance> instances = batch.instances();
+
+    tbb::blocked_range<std::size_t> range{
+        0, instances.size(), decode_grain_size(num_values_per_instance_)};
+
+    // Sparse features cannot be appended to a shared sparse tensor builder
+    // out of order; therefore each task fills its own builders which we
+    // merge in row order once all tasks are done.
+    tbb::concurrent_vector<Sparse_row_range> sparse_row_ranges{};
+
+    auto worker = [this, &state, &instances, &skip_example, &sparse_row_ranges](
+                      const tbb::blocked_range<std::size_t> &sub_range) {
+        Sparse_tensor_builder_list sparse_tensor_builders{};
+        if (has_sparse_feature_) {
+            sparse_tensor_builders = state.make_sparse_tensor_builders(sub_range.size());
+        }
+
+        for (std::size_t i = sub_range.begin(); i < sub_range.end(); i++) {
+            Decoder decoder{state, sparse_tensor_builders};
+            if (!decoder.decode(i, instances[i])) {
+                // If we failed to decode the instance, we can terminate
+                // the task right away and skip this example.
+                if (params().bad_example_handling == Bad_example_handling::skip ||
+                    params().bad_example_handling == Bad_example_handling::skip_warn) {
+                    skip_example = true;
+
+                    return;
+                }
+
+                throw std::invalid_argument{"The specified bad example handling is invalid."};
+            }
+        }
+
+        if (has_sparse_feature_) {
+            sparse_row_ranges.push_back({sub_range.begin(), std::move(sparse_tensor_builders)});
+        }
+    };
+
+    tbb::parallel_for(range, worker, tbb::auto_partitioner{});
+
+    if (skip_example) {
+        return {};
+    }
+
+    if (has_sparse_feature_) {
+        state.merge_sparse_tensor_builders(sparse_row_ranges);
+    }
+
+    return instances.size();
+}
+
+std::optional<std::size_t> Tf_example_reader::get_attribute_index(std::string_view name) const
+{
+    auto pos = attr_indices_.find(name);
+    if (pos == attr_indices_.end()) {
+        return {};
+    }
+    return pos->second;
+}
+
+std::size_t Tf_example_reader::estimate_nnz(std::size_t attr_idx, std::size_t num_rows) const
+{
+    return nnz_per_row_estimates_[attr_idx].load(std::memory_order_relaxed) * num_rows;
+}
+
+void Tf_example_reader::update_nnz_estimate(std::size_t attr_idx,
+                                            const Sparse_tensor_builder &builder) const
+{
+    std::size_t num_rows = builder.num_rows();
+    if (num_rows == 0) {
+        return;
+    }
+
+    // Round up so that a batch with the same density fits into the
+    // presized arrays without a reallocation.
+    std::size_t nnz_per_row = (builder.nnz() + num_rows - 1) / num_rows;
+
+    nnz_per_row_estimates_[attr_idx].store(nnz_per_row, std::memory_order_relaxed);
+}
+
+Tf_example_reader::Decoder_state::Decoder_state(const Tf_example_reader &r,
+                                                std::size_t batch_size)
+    : reader{&r}
+    , warn_bad_instance{r.warn_bad_instances()}
+    , error_bad_example{r.params().bad_example_handling == Bad_example_handling::error}
+{
+    const std::vector<Attribute> &attrs = r.schema()->attributes();
+
+    tensors.reserve(attrs.size());
+
+    sparse_tensor_builders.reserve(attrs.size());
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        const Attribute &attr = attrs[i];
+
+        if (attr.sparse()) {
+            tensors.emplace_back(nullptr);
+
+            sparse_tensor_builders.emplace_back(make_sparse_tensor_builder(i, batch_size));
+
+            continue;
+        }
+
+        std::size_t data_size = batch_size * as_size(attr.strides()[0]);
+
+        std::unique_ptr<Device_array> arr = r.make_pooled_cpu_array(attr.data_type(), data_size);
+
+        Size_vector shape = attr.shape();
+
+        // The provided batch size can be less than the actual batch size
+        // if, for example, we are processing the last batch.
+        shape[0] = batch_size;
+
+        tensors.emplace_back(make_intrusive<Dense_tensor>(std::move(shape), std::move(arr)));
+
+        sparse_tensor_builders.emplace_back(nullptr);
+    }
+}
+
+Sparse_tensor_builder_list
+Tf_example_reader::Decoder_state::make_sparse_tensor_builders(std::size_t num_rows) const
+{
+    Sparse_tensor_builder_list builders{};
+    builders.reserve(sparse_tensor_builders.size());
+
+    const std::vector<Attribute> &attrs = reader->schema()->attributes();
+
+    for (std::size_t i = 0; i < attrs.size(); i++) {
+        if (attrs[i].sparse()) {
+            builders.emplace_back(make_sparse_tensor_builder(i, num_rows));
+        }
+        else {
+            builders.emplace_back(nullptr);
+        }
+    }
+
+    return builders;
+}
+
+std::unique_ptr<Sparse_tensor_builder>
+Tf_example_reader::Decoder_state::make_sparse_tensor_builder(std::size_t attr_idx,
+                                                             std::size_t num_rows) const
+{
+    const Attribute &attr = reader->schema()->attributes()[attr_idx];
+
+    return detail::make_sparse_tensor_builder(attr,
+                                              num_rows,
+                                              reader->params().sparse_tensor_format,
+                                              reader->estimate_nnz(attr_idx, num_rows));
+}
+
+void Tf_example_reader::Decoder_state::merge_sparse_tensor_builders(
+    tbb::concurrent_vector<Sparse_row_range> &row_ranges)
+{
+    std::sort(row_ranges.begin(), row_ranges.end(), [](const auto &a, const auto &b) {
+        return a.first_row_idx < b.first_row_idx;
+    });
+
+    for (std::size_t i = 0; i < sparse_tensor_builders.size(); i++) {
+        Sparse_tensor_builder *builder = sparse_tensor_builders[i].get();
+        if (builder == nullptr) {
+            continue;
+        }
+
+        std::size_t nnz = builder->nnz();
+        for (Sparse_row_range &row_range : row_ranges) {
+            nnz += row_range.sparse_tensor_builders[i]->nnz();
+        }
+
+        builder->reserve(nnz);
+
+        for (Sparse_row_range &row_range : row_ranges) {
+            builder->merge(*row_range.sparse_tensor_builders[i]);
+        }
+    }
+}
+
+bool Tf_example_reader::Decoder::decode(std::size_t row_idx, const Instance &instance)
+{
+    row_idx_ = row_idx;
+
+    instance_ = &instance;
+
+    std::vector<Tf_feature> &features = detail::features_;
+    if (!Tf_example_scanner::scan(instance.bits(), features)) {
+        report_bad_instance(detail::Decode_warning_kind::corrupt_record, [i = instance_]() {
+            return fmt::format(
+                "The instance #{1:n} in the data store '{0}' contains a corrupt tf.train.Example message.",
+                i->data_store().id(),
+                i->index());
+        });
+
+        return false;
+    }
+
+    const std::vector<Attribute> &attrs = state_->reader->schema()->attributes();
+
+    // Only the features in the schema get decoded; if a feature occurs
+    // more than once, the last occurrence wins.
+    std::vector<const Tf_feature *> &attr_features = detail::attr_features_;
+    attr_features.assign(attrs.size(), nullptr);
+
+    for (const Tf_feature &feature : features) {
+        std::optional<std::size_t> attr_idx = find_attribute(feature.name);
+        if (attr_idx) {
+            attr_features[*attr_idx] = &feature;
+        }
+    }
+
+    // Validate all features before copying any of them so that a bad
+    // instance does not leave a partial row in the sparse tensors.
+    std::vector<std::size_t> &num_values = detail::num_values_;
+    num_values.resize(attrs.size());
+
+    for (attr_idx_ = 0; attr_idx_ < attrs.size(); attr_idx_++) {
+        attr_ = &attrs[attr_idx_];
+
+        if (!validate_feature(attr_features[attr_idx_], num_values[attr_idx_])) {
+            return false;
+        }
+    }
+
+    for (attr_idx_ = 0; attr_idx_ < attrs.size(); attr_idx_++) {
+        attr_ = &attrs[attr_idx_];
+
+        const Tf_feature *feature = attr_features[attr_idx_];
+        if (feature == nullptr) {
+            // A missing sparse feature is an empty row.
+            static const Tf_feature empty_feature{};
+
+            feature = &empty_feature;
+        }
+
+        // The schema only has float32, int64, and string features.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+        switch (attr_->data_type()) {
+        case Data_type::float32:
+            copy_feature<Data_type::float32>(*feature, num_values[attr_idx_]);
+            break;
+        case Data_type::int64:
+            copy_feature<Data_type::int64>(*feature, num_values[attr_idx_]);
+            break;
+        default:
+            copy_feature<Data_type::string>(*feature, num_values[attr_idx_]);
+            break;
+        }
+
+#pragma GCC diagnostic pop
+    }
+
+    return true;
+}
+
+std::optional<std::size_t>
+Tf_example_reader::Decoder::find_attribute(std::string_view name) noexcept
+{
+    const std::vector<Attribute> &attrs = state_->reader->schema()->attributes();
+
+    std::size_t next_idx = last_attr_idx_ + 1;
+    if (next_idx >= attrs.size()) {
+        next_idx = 0;
+    }
+
+    if (attrs[next_idx].name() == name) {
+        last_attr_idx_ = next_idx;
+
+        return next_idx;
+    }
+
+    std::optional<std::size_t> attr_idx = state_->reader->get_attribute_index(name);
+    if (attr_idx) {
+        last_attr_idx_ = *attr_idx;
+    }
+
+    return attr_idx;
+}
+
+bool Tf_example_reader::Decoder::validate_feature(const Tf_feature *feature,
+                                                  std::size_t &num_values)
+{
+    num_values = 0;
+
+    if (feature == nullptr) {
+        if (attr_->sparse()) {
+            return true;
+        }
+
+        report_bad_instance(detail::Decode_warning_kind::schema_mismatch, [this]() {
+            return fmt::format(
+                "The instance #{1:n} in the data store '{0}' does not have the feature '{2}'.",
+                instance_->data_store().id(),
+                instance_->index(),
+                attr_->name());
+        });
+
+        return false;
+    }
+
+    if (feature->kind != Tf_feature_kind::none &&
+        detail::get_data_type(feature->kind) != attr_->data_type()) {
+        report_bad_instance(detail::Decode_warning_kind::schema_mismatch, [this, feature]() {
+            return fmt::format(
+                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has values of type {3} while it is expected to have values of type {4}.",
+                instance_->data_store().id(),
+                instance_->index(),
+                attr_->name(),
+                detail::get_data_type(feature->kind),
+                attr_->data_type());
+        });
+
+        return false;
+    }
+
+    if (!Tf_example_scanner::count_values(*feature, num_values)) {
+        report_bad_instance(detail::Decode_warning_kind::corrupt_record, [this]() {
+            return fmt::format(
+                "The feature '{2}' of the instance #{1:n} in the data store '{0}' has a corrupt value list.",
+                instance_->data_store().id(),
+                instance_->index(),
+                attr_->name());
+        });
+
+        return false;
+    }
+
+    std::size_t expected_num_values = attr_->shape()[1];
+
+    if (attr_->sparse() ? num_values <= expected_num_values : num_values == expected_num_values) {
+        return true;
+    }
+
+    report_bad_instance(detail::Decode_warning_kind::schema_mismatch, [this, num_values]() {
+        return fmt::format(
+            "The feature '{2}' of the instance #{1:n} in the data store '{0}' has {3:n} value(s) while it is expected to have {4}{5:n} value(s).",
+            instance_->data_store().id(),
+            instance_->index(),
+            attr_->name(),
+            num_values,
+            attr_->sparse() ? "at most " : "",
+            attr_->shape()[1]);
+    });
+
+    return false;
+}
+
+template<Data_type dt>
+void Tf_example_reader::Decoder::copy_feature(const Tf_feature &feature, std::size_t num_values)
+{
+    using T = data_type_t<dt>;
+
+    if (!attr_->sparse()) {
+        auto &tensor = static_cast<Dense_tensor &>(*state_->tensors[attr_idx_]);
+
+        T *destination = tensor.data().as<T>().data() + row_idx_ * num_values;
+
+        Tf_example_scanner::copy_values(feature, destination);
+
+        return;
+    }
+
+    std::vector<T> &values = detail::sparse_values_<T>;
+    values.resize(num_values);
+
+    Tf_example_scanner::copy_values(feature, values.data());
+
+    std::vector<std::uint64_t> &keys = detail::sparse_keys_;
+    keys.resize(num_values);
+
+    std::iota(keys.begin(), keys.end(), std::uint64_t{});
+
+    auto &builder =
+        static_cast<Sparse_tensor_builder_impl<dt> &>(*(*sparse_tensor_builders_)[attr_idx_]);
+
+    // The number of values has been validated against the shape of the
+    // attribute already.
+    builder.append(values, keys);
+}
+
+template<typename Format_fn>
+void Tf_example_reader::Decoder::report_bad_instance(detail::Decode_warning_kind kind,
+                                                     Format_fn &&format_message) const
+{
+    if (state_->error_bad_example) {
+        throw Invalid_instance_error{format_message()};
+    }
+
+    // The message is formatted later, outside of the decode loop, and
+    // only if it gets logged.
+    detail::Decode_warning warning{kind, instance_, attr_idx_};
+    if (state_->warn_bad_instance) {
+        warning.format_message = std::forward<Format_fn>(format_message);
+    }
+
+    state_->warnings.add(std::move(warning));
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
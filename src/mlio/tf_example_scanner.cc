@@ -0,0 +1,386 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/tf_example_scanner.h"
+
+#include <cstring>
+
+#include "mlio/detail/protobuf_wire.h"
+#include "mlio/endian.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/string.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The field numbers as defined in tensorflow/core/example/example.proto
+// and feature.proto.
+constexpr std::uint32_t example_features = 1;
+
+constexpr std::uint32_t features_feature = 1;
+
+constexpr std::uint32_t map_entry_key = 1;
+constexpr std::uint32_t map_entry_value = 2;
+
+constexpr std::uint32_t feature_bytes_list = 1;
+constexpr std::uint32_t feature_float_list = 2;
+constexpr std::uint32_t feature_int64_list = 3;
+
+constexpr std::uint32_t list_value = 1;
+
+// Calls @p fn with the wire type and the bits of each value field of the
+// specified list; the bits of a varint or fixed32 field are empty.
+template<typename Fn>
+bool for_each_value_field(Memory_span list, Fn &&fn)
+{
+    Wire_reader reader{list};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        if (field_number != list_value) {
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span bits{};
+
+        // The wire type comes from the data and can be any 3-bit value.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+
+        switch (wire_type) {
+        case Wire_type::length_delimited:
+            if (!reader.read_length_delimited(bits)) {
+                return false;
+            }
+            break;
+
+        case Wire_type::varint: {
+            std::uint64_t value{};
+            if (!reader.read_varint(value)) {
+                return false;
+            }
+            if (!fn(wire_type, bits, value)) {
+                return false;
+            }
+            continue;
+        }
+
+        case Wire_type::fixed32: {
+            std::uint32_t value{};
+            if (!reader.read_fixed32(value)) {
+                return false;
+            }
+            if (!fn(wire_type, bits, std::uint64_t{value})) {
+                return false;
+            }
+            continue;
+        }
+
+        default:
+            return false;
+        }
+
+#pragma GCC diagnostic pop
+
+        if (!fn(wire_type, bits, std::uint64_t{})) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+bool Tf_example_scanner::scan(Memory_span bits, std::vector<Tf_feature> &features)
+{
+    features.clear();
+
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        if (field_number != example_features) {
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span features_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(features_bits)) {
+            return false;
+        }
+
+        // A repeated message field gets merged into the former one; for
+        // a map this means appending its entries.
+        if (!scan_features(features_bits, features)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Tf_example_scanner::scan_features(Memory_span bits, std::vector<Tf_feature> &features)
+{
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        if (field_number != features_feature) {
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span entry_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(entry_bits)) {
+            return false;
+        }
+
+        if (!scan_map_entry(entry_bits, features.emplace_back())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Tf_example_scanner::scan_map_entry(Memory_span bits, Tf_feature &feature)
+{
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        if (field_number != map_entry_key && field_number != map_entry_value) {
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span field_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(field_bits)) {
+            return false;
+        }
+
+        if (field_number == map_entry_key) {
+            feature.name = as_string_view(field_bits);
+        }
+        else {
+            // A repeated value replaces the former one.
+            feature.kind = Tf_feature_kind::none;
+            feature.list = {};
+
+            if (!scan_feature(field_bits, feature)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Tf_example_scanner::scan_feature(Memory_span bits, Tf_feature &feature)
+{
+    Wire_reader reader{bits};
+
+    while (!reader.eof()) {
+        std::uint32_t field_number{};
+        Wire_type wire_type{};
+        if (!reader.read_tag(field_number, wire_type)) {
+            return false;
+        }
+
+        Tf_feature_kind kind{};
+        switch (field_number) {
+        case feature_bytes_list:
+            kind = Tf_feature_kind::bytes_list;
+            break;
+
+        case feature_float_list:
+            kind = Tf_feature_kind::float_list;
+            break;
+
+        case feature_int64_list:
+            kind = Tf_feature_kind::int64_list;
+            break;
+
+        default:
+            if (!reader.skip(wire_type)) {
+                return false;
+            }
+            continue;
+        }
+
+        Memory_span list_bits{};
+        if (wire_type != Wire_type::length_delimited ||
+            !reader.read_length_delimited(list_bits)) {
+            return false;
+        }
+
+        // The lists are members of a oneof; a repeated member would have
+        // to be merged into the former one, which writers never emit.
+        if (feature.kind != Tf_feature_kind::none) {
+            return false;
+        }
+
+        feature.kind = kind;
+        feature.list = list_bits;
+    }
+
+    return true;
+}
+
+bool Tf_example_scanner::count_values(const Tf_feature &feature, std::size_t &num_values) noexcept
+{
+    num_values = 0;
+
+    switch (feature.kind) {
+    case Tf_feature_kind::none:
+        return true;
+
+    case Tf_feature_kind::bytes_list:
+        return for_each_value_field(feature.list, [&num_values](Wire_type wt, Memory_span, auto) {
+            num_values++;
+
+            return wt == Wire_type::length_delimited;
+        });
+
+    case Tf_feature_kind::float_list:
+        return for_each_value_field(
+            feature.list, [&num_values](Wire_type wt, Memory_span bits, auto) {
+                if (wt == Wire_type::fixed32) {
+                    num_values++;
+
+                    return true;
+                }
+                if (wt != Wire_type::length_delimited || bits.size() % sizeof(float) != 0) {
+                    return false;
+                }
+
+                num_values += bits.size() / sizeof(float);
+
+                return true;
+            });
+
+    case Tf_feature_kind::int64_list:
+        return for_each_value_field(
+            feature.list, [&num_values](Wire_type wt, Memory_span bits, auto) {
+                if (wt == Wire_type::varint) {
+                    num_values++;
+
+                    return true;
+                }
+
+                std::ptrdiff_t count{};
+                if (wt != Wire_type::length_delimited || !count_varints(bits, count)) {
+                    return false;
+                }
+
+                num_values += as_size(count);
+
+                return true;
+            });
+    }
+
+    return false;
+}
+
+void Tf_example_scanner::copy_values(const Tf_feature &feature, float *destination) noexcept
+{
+    for_each_value_field(feature.list, [&destination](Wire_type wt, Memory_span bits, auto value) {
+        if (wt == Wire_type::fixed32) {
+            auto int_value = static_cast<std::uint32_t>(value);
+
+            std::memcpy(destination++, &int_value, sizeof(float));
+        }
+        else {
+            std::size_t size = bits.size() / sizeof(float);
+
+            little_to_host_order(bits, stdx::span<float>{destination, size});
+
+            destination += size;
+        }
+
+        return true;
+    });
+}
+
+void Tf_example_scanner::copy_values(const Tf_feature &feature, std::int64_t *destination) noexcept
+{
+    for_each_value_field(feature.list, [&destination](Wire_type wt, Memory_span bits, auto value) {
+        // Negative values are encoded as ten-byte varints in two's
+        // complement.
+        if (wt == Wire_type::varint) {
+            *destination++ = static_cast<std::int64_t>(value);
+
+            return true;
+        }
+
+        Wire_reader reader{bits};
+        while (!reader.eof()) {
+            std::uint64_t element{};
+            reader.read_varint(element);
+
+            *destination++ = static_cast<std::int64_t>(element);
+        }
+
+        return true;
+    });
+}
+
+void Tf_example_scanner::copy_values(const Tf_feature &feature, std::string *destination)
+{
+    for_each_value_field(feature.list, [&destination](Wire_type, Memory_span bits, auto) {
+        (destination++)->assign(as_string_view(bits));
+
+        return true;
+    });
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+enum class Tf_feature_kind { none, bytes_list, float_list, int64_list };
+
+/// Represents a feature of a tf.train.Example message as a view into
+/// the wire representation of its value list.
+struct Tf_feature {
+    std::string_view name{};
+    Tf_feature_kind kind{};
+    /// The wire representation of the BytesList, FloatList, or
+    /// Int64List message.
+    Memory_span list{};
+};
+
+/// Scans the wire representation of a tf.train.Example message and
+/// locates its features without materializing the message. The value
+/// lists are only validated and decoded on demand so that the features
+/// that are not read cost no more than skipping their bytes.
+///
+/// Both the packed and the unpacked encodings of the numeric lists are
+/// supported as the protobuf specification requires parsers to accept
+/// either of them.
+class Tf_example_scanner {
+public:
+    /// Returns false if the message is malformed.
+    static bool scan(Memory_span bits, std::vector<Tf_feature> &features);
+
+    /// Validates the value list of the specified feature and counts its
+    /// values. Returns false if the list is malformed.
+    static bool count_values(const Tf_feature &feature, std::size_t &num_values) noexcept;
+
+    /// Copies the values of the specified feature, which must have been
+    /// validated by count_values(), to the destination.
+    static void copy_values(const Tf_feature &feature, float *destination) noexcept;
+
+    static void copy_values(const Tf_feature &feature, std::int64_t *destination) noexcept;
+
+    static void copy_values(const Tf_feature &feature, std::string *destination);
+
+private:
+    static bool scan_features(Memory_span bits, std::vector<Tf_feature> &features);
+
+    static bool scan_map_entry(Memory_span bits, Tf_feature &feature);
+
+    static bool scan_feature(Memory_span bits, Tf_feature &feature);
+};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/thread_pool.h"
+
+#include <mutex>
+#include <utility>
+
+#include <tbb/global_control.h>
+
+#include "mlio/data_reader.h"
+#include "mlio/detail/reader_task_arena.h"
+#include "mlio/detail/system_info.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Thread_pool::Thread_pool(std::size_t num_threads,
+                         std::vector<std::size_t> cpu_affinity,
+                         std::optional<std::size_t> numa_node)
+{
+    // Unlike a reader, a pool always gets an arena of its own; otherwise
+    // it would not bound the number of threads of its readers.
+    if (num_threads == 0 && cpu_affinity.empty() && !numa_node) {
+        num_threads = detail::get_num_cpus();
+    }
+
+    Data_reader_params params{};
+    params.num_threads = num_threads;
+    params.cpu_affinity = std::move(cpu_affinity);
+    params.numa_node = numa_node;
+
+    arena_ = std::make_shared<detail::Reader_task_arena>(params);
+}
+
+Thread_pool::~Thread_pool() = default;
+
+void Thread_pool::execute(const std::function<void()> &func) const
+{
+    arena_->execute(func);
+}
+
+std::size_t Thread_pool::num_threads() const noexcept
+{
+    return arena_->max_concurrency();
+}
+
+void set_max_num_threads(std::size_t value)
+{
+    static std::mutex mutex{};
+    static std::unique_ptr<tbb::global_control> control{};
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    control.reset();
+    if (value > 0) {
+        control = std::make_unique<tbb::global_control>(
+            tbb::global_control::max_allowed_parallelism, value);
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mlio/detail/error.h"
+#include "mlio/detail/tracing.h"
+#include "mlio/util/cast.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+std::atomic_bool tracing_enabled{};
+
+namespace {
+
+// The fields are atomic so that a span can be overwritten while the
+// trace gets written; a torn span is detected and left out.
+struct Trace_event {
+    std::atomic<const char *> name{};
+    std::atomic<std::int64_t> start_ns{};
+    std::atomic<std::int64_t> end_ns{};
+};
+
+// A ring buffer that is written by a single thread.
+struct Thread_trace_buffer {
+    explicit Thread_trace_buffer(std::size_t capacity, std::size_t tid, std::uint64_t gen)
+        : events(capacity), thread_id{tid}, generation{gen}
+    {}
+
+    std::vector<Trace_event> events;
+    std::atomic_size_t num_events{};
+    std::size_t thread_id;
+    std::uint64_t generation;
+};
+
+struct Trace_registry {
+    std::mutex mutex{};
+    std::vector<std::shared_ptr<Thread_trace_buffer>> buffers{};
+    std::size_t capacity = 0x10000;
+    std::atomic<std::uint64_t> generation{};
+};
+
+Trace_registry &get_registry()
+{
+    static Trace_registry registry{};
+
+    return registry;
+}
+
+// The buffers are owned by the registry so that the spans of a thread
+// survive the thread itself.
+thread_local std::shared_ptr<Thread_trace_buffer> thread_buffer_{};  // NOLINT(cert-err58-cpp)
+
+Thread_trace_buffer *get_thread_buffer()
+{
+    Trace_registry &registry = get_registry();
+
+    std::uint64_t gen = registry.generation.load(std::memory_order_acquire);
+
+    if (thread_buffer_ == nullptr || thread_buffer_->generation != gen) {
+        std::unique_lock<std::mutex> lock{registry.mutex};
+
+        thread_buffer_ = std::make_shared<Thread_trace_buffer>(
+            registry.capacity, registry.buffers.size() + 1, gen);
+
+        registry.buffers.emplace_back(thread_buffer_);
+    }
+
+    return thread_buffer_.get();
+}
+
+struct Span {
+    const char *name;
+    std::int64_t start_ns;
+    std::int64_t end_ns;
+    std::size_t thread_id;
+};
+
+void copy_spans(const Thread_trace_buffer &buffer, std::vector<Span> &spans)
+{
+    const std::vector<Trace_event> &events = buffer.events;
+
+    std::size_t capacity = events.size();
+
+    std::size_t num_events = buffer.num_events.load(std::memory_order_acquire);
+
+    std::size_t first = num_events > capacity ? num_events - capacity : 0;
+
+    std::size_t offset = spans.size();
+
+    for (std::size_t i = first; i < num_events; i++) {
+        const Trace_event &event = events[i % capacity];
+
+        spans.push_back(Span{event.name.load(std::memory_order_relaxed),
+                             event.start_ns.load(std::memory_order_relaxed),
+                             event.end_ns.load(std::memory_order_relaxed),
+                             buffer.thread_id});
+    }
+
+    // Leave out the spans that might have been overwritten while they
+    // were copied.
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    std::size_t num_overwritten = buffer.num_events.load(std::memory_order_relaxed) - first;
+    if (num_overwritten > capacity) {
+        std::size_t num_torn = std::min(num_overwritten - capacity, num_events - first);
+
+        spans.erase(spans.begin() + as_ssize(offset),
+                    spans.begin() + as_ssize(offset + num_torn));
+    }
+}
+
+}  // namespace
+
+std::int64_t trace_clock_now() noexcept
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+void record_trace_span(const char *name, std::int64_t start_ns, std::int64_t end_ns) noexcept
+{
+    Thread_trace_buffer *buffer{};
+    try {
+        buffer = get_thread_buffer();
+    }
+    catch (...) {
+        return;
+    }
+
+    std::size_t idx = buffer->num_events.load(std::memory_order_relaxed);
+
+    Trace_event &event = buffer->events[idx % buffer->events.size()];
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.start_ns.store(start_ns, std::memory_order_relaxed);
+    event.end_ns.store(end_ns, std::memory_order_relaxed);
+
+    buffer->num_events.store(idx + 1, std::memory_order_release);
+}
+
+}  // namespace detail
+
+void start_tracing(std::size_t max_spans_per_thread)
+{
+    if (max_spans_per_thread == 0) {
+        throw std::invalid_argument{"The maximum number of spans per thread must be greater than zero."};
+    }
+
+    detail::Trace_registry &registry = detail::get_registry();
+
+    {
+        std::unique_lock<std::mutex> lock{registry.mutex};
+
+        registry.buffers.clear();
+
+        registry.capacity = max_spans_per_thread;
+
+        // Make the threads replace their existing buffers.
+        registry.generation.fetch_add(1, std::memory_order_release);
+    }
+
+    detail::tracing_enabled = true;
+}
+
+void stop_tracing() noexcept
+{
+    detail::tracing_enabled = false;
+}
+
+void write_trace(const std::string &path)
+{
+    std::vector<detail::Span> spans{};
+
+    {
+        detail::Trace_registry &registry = detail::get_registry();
+
+        std::unique_lock<std::mutex> lock{registry.mutex};
+
+        for (const auto &buffer : registry.buffers) {
+            detail::copy_spans(*buffer, spans);
+        }
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const auto &a, const auto &b) {
+        return a.start_ns < b.start_ns;
+    });
+
+    fmt::memory_buffer buf{};
+
+    fmt::format_to(std::back_inserter(buf), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    auto pid = ::getpid();
+
+    bool first = true;
+    for (const detail::Span &span : spans) {
+        if (!first) {
+            buf.push_back(',');
+        }
+        first = false;
+
+        // The timestamps are in microseconds.
+        fmt::format_to(
+            std::back_inserter(buf),
+            "\n{{\"name\":\"{0}\",\"cat\":\"mlio\",\"ph\":\"X\",\"ts\":{1:.3f},\"dur\":{2:.3f},\"pid\":{3},\"tid\":{4}}}",
+            span.name,
+            static_cast<double>(span.start_ns) / 1000.0,
+            static_cast<double>(span.end_ns - span.start_ns) / 1000.0,
+            pid,
+            span.thread_id);
+    }
+
+    fmt::format_to(std::back_inserter(buf), "\n]}}\n");
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (file) {
+        file.write(buf.data(), as_ssize(buf.size()));
+    }
+
+    if (!file) {
+        throw std::system_error{detail::current_error_code(), "The trace file cannot be written."};
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
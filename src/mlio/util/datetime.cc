@@ -0,0 +1,547 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/util/datetime.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "mlio/detail/whitespace.h"
+#include "mlio/endian.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+struct Datetime_fields {
+    int year = 1970;
+    int month = 1;
+    int day = 1;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    std::int64_t nanos = 0;
+    // The UTC offset in seconds.
+    std::int64_t offset = 0;
+};
+
+namespace {
+
+constexpr std::int64_t seconds_per_day = 86'400;
+
+inline bool is_digit(char chr) noexcept
+{
+    return chr >= '0' && chr <= '9';
+}
+
+inline bool is_leap_year(int year) noexcept
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+inline int get_days_in_month(int year, int month) noexcept
+{
+    constexpr int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if (month == 2 && is_leap_year(year)) {
+        return 29;
+    }
+    return days_in_month[month - 1];
+}
+
+// Returns the number of days since the Unix epoch; see the days_from_civil
+// algorithm of Howard Hinnant which needs no loops or tables.
+inline std::int64_t days_from_civil(int year, int month, int day) noexcept
+{
+    std::int64_t y = year - (month <= 2 ? 1 : 0);
+
+    std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+
+    auto yoe = static_cast<unsigned>(y - era * 400);
+    auto doy = static_cast<unsigned>((153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1);
+    auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146'097 + static_cast<std::int64_t>(doe) - 719'468;
+}
+
+inline bool is_valid(const Datetime_fields &fields) noexcept
+{
+    return fields.month >= 1 && fields.month <= 12 && fields.day >= 1 &&
+           fields.day <= get_days_in_month(fields.year, fields.month) && fields.hour <= 23 &&
+           fields.minute <= 59 && fields.second <= 59;
+}
+
+// Reads between min and max digits.
+inline bool read_digits(const char *&pos, const char *last, int min, int max, int &value) noexcept
+{
+    int v = 0;
+
+    int i = 0;
+    for (; i < max && pos != last && is_digit(*pos); i++, ++pos) {
+        v = v * 10 + (*pos - '0');
+    }
+
+    value = v;
+
+    return i >= min;
+}
+
+inline bool read_char(const char *&pos, const char *last, char chr) noexcept
+{
+    if (pos == last || *pos != chr) {
+        return false;
+    }
+    ++pos;
+
+    return true;
+}
+
+// Reads one to nine digits of a fractional second; the ones beyond the
+// nanosecond precision are truncated.
+inline bool read_fraction(const char *&pos, const char *last, std::int64_t &nanos) noexcept
+{
+    const char *first = pos;
+
+    std::int64_t v = 0;
+
+    int num_digits = 0;
+    for (; pos != last && is_digit(*pos); ++pos) {
+        if (num_digits < 9) {
+            v = v * 10 + (*pos - '0');
+
+            num_digits++;
+        }
+    }
+
+    for (; num_digits < 9; num_digits++) {
+        v *= 10;
+    }
+
+    nanos = v;
+
+    return pos != first;
+}
+
+// Reads "Z" or a UTC offset in the form of "(+|-)hh[[:]mm]".
+inline bool read_utc_offset(const char *&pos, const char *last, std::int64_t &offset) noexcept
+{
+    if (pos == last) {
+        return false;
+    }
+
+    char sign = *pos++;
+    if (sign == 'Z' || sign == 'z') {
+        offset = 0;
+
+        return true;
+    }
+    if (sign != '+' && sign != '-') {
+        return false;
+    }
+
+    int hours{};
+    if (!read_digits(pos, last, 2, 2, hours) || hours > 23) {
+        return false;
+    }
+
+    int minutes = 0;
+    if (pos != last) {
+        read_char(pos, last, ':');
+
+        if (!read_digits(pos, last, 2, 2, minutes) || minutes > 59) {
+            return false;
+        }
+    }
+
+    offset = (hours * 3600 + minutes * 60) * (sign == '-' ? -1 : 1);
+
+    return true;
+}
+
+#if MLIO_BYTE_ORDER_HOST == MLIO_BYTE_ORDER_LITTLE
+
+inline std::uint64_t load_word(const char *chars) noexcept
+{
+    std::uint64_t word{};
+    std::memcpy(&word, chars, sizeof(word));
+
+    return word;
+}
+
+// Describes an eight-character pattern in which 'D' stands for a digit
+// and any other character for itself.
+struct Word_pattern {
+    constexpr explicit Word_pattern(const char (&pattern)[9]) noexcept
+    {
+        for (std::size_t i = 0; i < 8; i++) {
+            auto chr = static_cast<std::uint64_t>(static_cast<unsigned char>(pattern[i]));
+            if (chr == 'D') {
+                digit_mask |= std::uint64_t{0xFF} << (8 * i);
+            }
+            else {
+                separators |= chr << (8 * i);
+            }
+        }
+    }
+
+    std::uint64_t digit_mask{};
+    std::uint64_t separators{};
+};
+
+// Checks a word against the pattern using SWAR ("SIMD within a register")
+// arithmetic and returns its digits as the two-digit numbers that start
+// at each byte.
+inline bool
+match_word(std::uint64_t word, const Word_pattern &pattern, std::uint64_t &pairs) noexcept
+{
+    std::uint64_t digits = (word ^ 0x3030303030303030) & pattern.digit_mask;
+
+    // A byte is greater than 9 if adding 0x76 to its lower seven bits, or
+    // the byte itself, sets its high bit.
+    std::uint64_t non_digits =
+        (((digits & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | digits) & 0x8080808080808080;
+
+    bool matches = (non_digits & pattern.digit_mask) == 0 &&
+                   (word & ~pattern.digit_mask) == pattern.separators;
+
+    // None of the bytes can overflow since the digits are at most 9.
+    pairs = digits * 10 + (digits >> 8);
+
+    return matches;
+}
+
+inline int get_pair(std::uint64_t pairs, int idx) noexcept
+{
+    return static_cast<int>((pairs >> (8 * idx)) & 0xFF);
+}
+
+constexpr Word_pattern date_head_pattern{"DDDD-DD-"};
+constexpr Word_pattern date_tail_pattern{"DD-DD-DD"};
+constexpr Word_pattern time_pattern{"DD:DD:DD"};
+
+// Reads "YYYY-MM-DD" with two overlapping word loads.
+inline bool read_iso_date(const char *&pos, const char *last, Datetime_fields &fields) noexcept
+{
+    if (last - pos < 10) {
+        return false;
+    }
+
+    std::uint64_t head{};
+    std::uint64_t tail{};
+    if (!match_word(load_word(pos), date_head_pattern, head) ||
+        !match_word(load_word(pos + 2), date_tail_pattern, tail)) {
+        return false;
+    }
+
+    fields.year = get_pair(head, 0) * 100 + get_pair(head, 2);
+    fields.month = get_pair(head, 5);
+    fields.day = get_pair(tail, 6);
+
+    pos += 10;
+
+    return true;
+}
+
+// Reads "hh:mm:ss" if the whole word is available.
+inline bool read_iso_full_time(const char *&pos, const char *last, Datetime_fields &fields) noexcept
+{
+    if (last - pos < 8) {
+        return false;
+    }
+
+    std::uint64_t pairs{};
+    if (!match_word(load_word(pos), time_pattern, pairs)) {
+        return false;
+    }
+
+    fields.hour = get_pair(pairs, 0);
+    fields.minute = get_pair(pairs, 3);
+    fields.second = get_pair(pairs, 6);
+
+    pos += 8;
+
+    return true;
+}
+
+#else
+
+inline bool read_iso_date(const char *&pos, const char *last, Datetime_fields &fields) noexcept
+{
+    return read_digits(pos, last, 4, 4, fields.year) && read_char(pos, last, '-') &&
+           read_digits(pos, last, 2, 2, fields.month) && read_char(pos, last, '-') &&
+           read_digits(pos, last, 2, 2, fields.day);
+}
+
+inline bool read_iso_full_time(const char *&, const char *, Datetime_fields &) noexcept
+{
+    return false;
+}
+
+#endif
+
+// Reads "hh:mm[:ss[.f...]]".
+inline bool read_iso_time(const char *&pos, const char *last, Datetime_fields &fields) noexcept
+{
+    if (!read_iso_full_time(pos, last, fields)) {
+        if (!read_digits(pos, last, 2, 2, fields.hour) || !read_char(pos, last, ':') ||
+            !read_digits(pos, last, 2, 2, fields.minute)) {
+            return false;
+        }
+
+        if (!read_char(pos, last, ':')) {
+            return true;
+        }
+
+        if (!read_digits(pos, last, 2, 2, fields.second)) {
+            return false;
+        }
+    }
+
+    if (pos != last && (*pos == '.' || *pos == ',')) {
+        ++pos;
+
+        return read_fraction(pos, last, fields.nanos);
+    }
+
+    return true;
+}
+
+bool parse_iso_timestamp(std::string_view s, Datetime_fields &fields) noexcept
+{
+    const char *pos = s.data();
+    const char *last = s.data() + s.size();
+
+    if (!read_iso_date(pos, last, fields)) {
+        return false;
+    }
+
+    // A date alone stands for its midnight.
+    if (pos == last) {
+        return true;
+    }
+
+    char sep = *pos++;
+    if (sep != 'T' && sep != 't' && sep != ' ') {
+        return false;
+    }
+
+    if (!read_iso_time(pos, last, fields)) {
+        return false;
+    }
+
+    if (pos != last && !read_utc_offset(pos, last, fields.offset)) {
+        return false;
+    }
+
+    return pos == last;
+}
+
+bool parse_iso_date(std::string_view s, Datetime_fields &fields) noexcept
+{
+    const char *pos = s.data();
+    const char *last = s.data() + s.size();
+
+    return read_iso_date(pos, last, fields) && pos == last;
+}
+
+inline bool read_month_name(const char *&pos, const char *last, int &month) noexcept
+{
+    constexpr const char *month_names[] = {
+        "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+
+    if (last - pos < 3) {
+        return false;
+    }
+
+    char name[3];
+    for (std::size_t i = 0; i < 3; i++) {
+        // Lower the case of ASCII letters.
+        name[i] = static_cast<char>(pos[i] | 0x20);
+    }
+
+    for (int i = 0; i < 12; i++) {
+        if (std::memcmp(name, month_names[i], 3) == 0) {
+            month = i + 1;
+
+            pos += 3;
+
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+}  // namespace detail
+
+Datetime_format::Datetime_format(std::string_view fmt)
+{
+    for (auto pos = fmt.begin(); pos != fmt.end(); ++pos) {
+        if (*pos != '%') {
+            tokens_.push_back(Token{'\0', *pos});
+
+            continue;
+        }
+
+        if (++pos == fmt.end()) {
+            throw std::invalid_argument{"The datetime format ends with an incomplete directive."};
+        }
+
+        switch (*pos) {
+        case 'Y':
+        case 'y':
+        case 'm':
+        case 'd':
+        case 'H':
+        case 'M':
+        case 'S':
+        case 'b':
+        case 'f':
+        case 'z':
+            tokens_.push_back(Token{*pos, '\0'});
+            break;
+        case '%':
+            tokens_.push_back(Token{'\0', '%'});
+            break;
+        default:
+            throw std::invalid_argument{"The datetime format has an unsupported directive '%" +
+                                        std::string(1, *pos) + "'."};
+        }
+    }
+}
+
+bool Datetime_format::parse_fields(std::string_view s,
+                                   detail::Datetime_fields &fields) const noexcept
+{
+    const char *pos = s.data();
+    const char *last = s.data() + s.size();
+
+    for (const Token &token : tokens_) {
+        bool ok{};
+
+        switch (token.directive) {
+        case 'Y':
+            ok = detail::read_digits(pos, last, 4, 4, fields.year);
+            break;
+        case 'y':
+            ok = detail::read_digits(pos, last, 2, 2, fields.year);
+            if (ok) {
+                fields.year += fields.year < 69 ? 2000 : 1900;
+            }
+            break;
+        case 'm':
+            ok = detail::read_digits(pos, last, 1, 2, fields.month);
+            break;
+        case 'd':
+            ok = detail::read_digits(pos, last, 1, 2, fields.day);
+            break;
+        case 'H':
+            ok = detail::read_digits(pos, last, 1, 2, fields.hour);
+            break;
+        case 'M':
+            ok = detail::read_digits(pos, last, 1, 2, fields.minute);
+            break;
+        case 'S':
+            ok = detail::read_digits(pos, last, 1, 2, fields.second);
+            break;
+        case 'b':
+            ok = detail::read_month_name(pos, last, fields.month);
+            break;
+        case 'f':
+            ok = detail::read_fraction(pos, last, fields.nanos);
+            break;
+        case 'z':
+            ok = detail::read_utc_offset(pos, last, fields.offset);
+            break;
+        default:
+            ok = detail::read_char(pos, last, token.literal);
+            break;
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return pos == last;
+}
+
+Parse_result try_parse_timestamp(std::string_view s,
+                                 std::int64_t &result,
+                                 const Datetime_parse_options &opts) noexcept
+{
+    s = detail::trim_ascii(s);
+
+    detail::Datetime_fields fields{};
+
+    bool ok{};
+    if (opts.format != nullptr && !opts.format->empty()) {
+        ok = opts.format->parse_fields(s, fields);
+    }
+    else {
+        ok = detail::parse_iso_timestamp(s, fields);
+    }
+
+    if (!ok || !detail::is_valid(fields)) {
+        return Parse_result::failed;
+    }
+
+    // The seconds cannot overflow for a four-digit year.
+    std::int64_t seconds =
+        detail::days_from_civil(fields.year, fields.month, fields.day) * detail::seconds_per_day +
+        fields.hour * 3600 + fields.minute * 60 + fields.second - fields.offset;
+
+    std::int64_t nanos{};
+    if (__builtin_mul_overflow(seconds, std::int64_t{1'000'000'000}, &nanos) ||
+        __builtin_add_overflow(nanos, fields.nanos, &nanos)) {
+        return Parse_result::overflowed;
+    }
+
+    result = nanos;
+
+    return Parse_result::ok;
+}
+
+Parse_result try_parse_date(std::string_view s,
+                            std::int64_t &result,
+                            const Datetime_parse_options &opts) noexcept
+{
+    s = detail::trim_ascii(s);
+
+    detail::Datetime_fields fields{};
+
+    bool ok{};
+    if (opts.format != nullptr && !opts.format->empty()) {
+        ok = opts.format->parse_fields(s, fields);
+    }
+    else {
+        ok = detail::parse_iso_date(s, fields);
+    }
+
+    if (!ok || !detail::is_valid(fields)) {
+        return Parse_result::failed;
+    }
+
+    std::int64_t days = detail::days_from_civil(fields.year, fields.month, fields.day);
+
+    result = days * detail::seconds_per_day * 1000;
+
+    return Parse_result::ok;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/util/frequent_values_sketch.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace mlio {
+inline namespace abi_v1 {
+
+Frequent_values_sketch::Frequent_values_sketch(std::size_t capacity) : capacity_{capacity}
+{
+    if (capacity_ == 0) {
+        throw std::invalid_argument{"The capacity of the sketch must be greater than zero."};
+    }
+
+    counters_.reserve(capacity_);
+
+    heap_.reserve(capacity_);
+}
+
+Frequent_values_sketch::Frequent_values_sketch(const Frequent_values_sketch &other)
+    : Frequent_values_sketch(other.capacity_)
+{
+    count_ = other.count_;
+
+    assign(other.top(other.counters_.size()));
+}
+
+Frequent_values_sketch &Frequent_values_sketch::operator=(const Frequent_values_sketch &other)
+{
+    if (this != &other) {
+        Frequent_values_sketch tmp{other};
+
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+// Moving the vector of counters keeps its buffer; the keys of the index
+// therefore remain valid.
+Frequent_values_sketch::Frequent_values_sketch(Frequent_values_sketch &&other) noexcept = default;
+
+Frequent_values_sketch &
+Frequent_values_sketch::operator=(Frequent_values_sketch &&other) noexcept = default;
+
+Frequent_values_sketch::~Frequent_values_sketch() = default;
+
+void Frequent_values_sketch::add(std::string_view value)
+{
+    count_++;
+
+    auto pos = index_.find(value);
+    if (pos != index_.end()) {
+        Counter &counter = counters_[pos->second];
+
+        counter.count++;
+
+        sift_down(counter.heap_pos);
+
+        return;
+    }
+
+    if (counters_.size() < capacity_) {
+        std::size_t idx = counters_.size();
+
+        Counter &counter = counters_.emplace_back();
+
+        counter.value = value;
+        counter.count = 1;
+        counter.heap_pos = heap_.size();
+
+        heap_.push_back(idx);
+
+        index_.emplace(counter.value, idx);
+
+        sift_up(counter.heap_pos);
+
+        return;
+    }
+
+    // Take over the counter with the lowest count.
+    std::size_t idx = heap_.front();
+
+    Counter &counter = counters_[idx];
+
+    index_.erase(counter.value);
+
+    counter.value = value;
+    counter.error = counter.count;
+    counter.count++;
+
+    index_.emplace(counter.value, idx);
+
+    sift_down(0);
+}
+
+void Frequent_values_sketch::merge(const Frequent_values_sketch &other)
+{
+    // The count of a value that is not tracked by a full sketch can be
+    // as high as the lowest count of that sketch.
+    std::size_t this_min = counters_.size() == capacity_ ? min_count() : 0;
+    std::size_t other_min = other.counters_.size() == other.capacity_ ? other.min_count() : 0;
+
+    std::vector<Entry> entries{};
+    entries.reserve(counters_.size() + other.counters_.size());
+
+    for (const Counter &counter : counters_) {
+        auto pos = other.index_.find(counter.value);
+        if (pos == other.index_.end()) {
+            entries.push_back(
+                {counter.value, counter.count + other_min, counter.error + other_min});
+        }
+        else {
+            const Counter &other_counter = other.counters_[pos->second];
+
+            entries.push_back({counter.value,
+                               counter.count + other_counter.count,
+                               counter.error + other_counter.error});
+        }
+    }
+
+    for (const Counter &other_counter : other.counters_) {
+        if (index_.find(other_counter.value) == index_.end()) {
+            entries.push_back({other_counter.value,
+                               other_counter.count + this_min,
+                               other_counter.error + this_min});
+        }
+    }
+
+    auto cmp = [](const Entry &a, const Entry &b) {
+        return a.count > b.count;
+    };
+
+    if (entries.size() > capacity_) {
+        std::nth_element(entries.begin(),
+                         entries.begin() + static_cast<std::ptrdiff_t>(capacity_),
+                         entries.end(),
+                         cmp);
+
+        entries.resize(capacity_);
+    }
+
+    count_ += other.count_;
+
+    assign(std::move(entries));
+}
+
+std::vector<Frequent_values_sketch::Entry> Frequent_values_sketch::top(std::size_t k) const
+{
+    std::vector<Entry> entries{};
+    entries.reserve(counters_.size());
+
+    for (const Counter &counter : counters_) {
+        entries.push_back({counter.value, counter.count, counter.error});
+    }
+
+    k = std::min(k, entries.size());
+
+    // Break the ties by value so that the result is deterministic.
+    std::partial_sort(entries.begin(),
+                      entries.begin() + static_cast<std::ptrdiff_t>(k),
+                      entries.end(),
+                      [](const Entry &a, const Entry &b) {
+                          return a.count > b.count || (a.count == b.count && a.value < b.value);
+                      });
+
+    entries.resize(k);
+
+    return entries;
+}
+
+void Frequent_values_sketch::assign(std::vector<Entry> &&entries)
+{
+    index_.clear();
+
+    heap_.clear();
+
+    counters_.clear();
+
+    for (Entry &entry : entries) {
+        std::size_t idx = counters_.size();
+
+        Counter &counter = counters_.emplace_back();
+
+        counter.value = std::move(entry.value);
+        counter.count = entry.count;
+        counter.error = entry.error;
+        counter.heap_pos = idx;
+
+        heap_.push_back(idx);
+
+        index_.emplace(counter.value, idx);
+    }
+
+    for (std::size_t pos = heap_.size() / 2; pos > 0; pos--) {
+        sift_down(pos - 1);
+    }
+}
+
+void Frequent_values_sketch::sift_up(std::size_t pos) noexcept
+{
+    while (pos > 0) {
+        std::size_t parent = (pos - 1) / 2;
+        if (counters_[heap_[parent]].count <= counters_[heap_[pos]].count) {
+            break;
+        }
+
+        swap_heap_entries(parent, pos);
+
+        pos = parent;
+    }
+}
+
+void Frequent_values_sketch::sift_down(std::size_t pos) noexcept
+{
+    while (true) {
+        std::size_t smallest = pos;
+
+        for (std::size_t child = 2 * pos + 1; child <= 2 * pos + 2; child++) {
+            if (child < heap_.size() &&
+                counters_[heap_[child]].count < counters_[heap_[smallest]].count) {
+                smallest = child;
+            }
+        }
+
+        if (smallest == pos) {
+            break;
+        }
+
+        swap_heap_entries(pos, smallest);
+
+        pos = smallest;
+    }
+}
+
+void Frequent_values_sketch::swap_heap_entries(std::size_t a, std::size_t b) noexcept
+{
+    std::swap(heap_[a], heap_[b]);
+
+    counters_[heap_[a]].heap_pos = a;
+    counters_[heap_[b]].heap_pos = b;
+}
+
+std::size_t Frequent_values_sketch::min_count() const noexcept
+{
+    if (heap_.empty()) {
+        return 0;
+    }
+    return counters_[heap_.front()].count;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -15,21 +15,28 @@
 
 #include "mlio/util/number.h"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <string>
+#include <system_error>
 #include <type_traits>
 
 #include <absl/strings/numbers.h>
 
-#include "mlio/util/string.h"
+#include "mlio/detail/whitespace.h"
+#include "mlio/endian.h"
 
 namespace mlio {
 inline namespace abi_v1 {
 namespace detail {
 namespace {
 
-template<typename T, typename = void>
+template<typename T>
 struct parser_traits;
 
 // clang-format off
@@ -37,30 +44,233 @@ struct parser_traits;
 template<>
 struct parser_traits<float> {
     static constexpr bool (*parse_func)(absl::string_view s, float  *result) = absl::SimpleAtof;
+
+    // The largest mantissa and power of ten that can be represented
+    // exactly by the type.
+    static constexpr std::uint64_t max_exact_mantissa = std::uint64_t{1} << 24;
+    static constexpr int max_exact_exponent = 10;
 };
 
 template<>
 struct parser_traits<double> {
     static constexpr bool (*parse_func)(absl::string_view s, double *result) = absl::SimpleAtod;
-};
 
-template<typename T>
-struct parser_traits<T, std::enable_if_t<std::is_integral_v<T>>> {
-    static constexpr bool (*parse_func)(absl::string_view s, T      *result) = absl::SimpleAtoi;
+    static constexpr std::uint64_t max_exact_mantissa = std::uint64_t{1} << 53;
+    static constexpr int max_exact_exponent = 22;
 };
 
 // clang-format on
 
+constexpr double exact_powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                          1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                          1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool is_digit(char chr) noexcept
+{
+    return chr >= '0' && chr <= '9';
+}
+
+#if MLIO_BYTE_ORDER_HOST == MLIO_BYTE_ORDER_LITTLE
+
+// Checks whether the next eight characters are all digits using SWAR
+// ("SIMD within a register") arithmetic.
+inline bool is_eight_digits(const char *chars) noexcept
+{
+    std::uint64_t val{};
+    std::memcpy(&val, chars, sizeof(val));
+
+    return ((val & 0xF0F0F0F0F0F0F0F0) |
+            (((val + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+// Converts eight digits to their numeric value with three multiplications
+// instead of eight.
+inline std::uint64_t parse_eight_digits(const char *chars) noexcept
+{
+    std::uint64_t val{};
+    std::memcpy(&val, chars, sizeof(val));
+
+    val = (val & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+    val = (val & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+
+    return (val & 0x0000FFFF0000FFFF) * 42949672960001 >> 32;
+}
+
+#else
+
+inline bool is_eight_digits(const char *) noexcept
+{
+    return false;
+}
+
+inline std::uint64_t parse_eight_digits(const char *) noexcept
+{
+    return 0;
+}
+
+#endif
+
+// Parses a sequence of decimal digits. Returns false if the result does
+// not fit into 64 bits.
+inline bool parse_decimal_digits(const char *&pos, const char *last, std::uint64_t &value) noexcept
+{
+    std::uint64_t v = 0;
+
+    while (last - pos >= 8 && is_eight_digits(pos)) {
+        if (__builtin_mul_overflow(v, std::uint64_t{100'000'000}, &v) ||
+            __builtin_add_overflow(v, parse_eight_digits(pos), &v)) {
+            return false;
+        }
+        pos += 8;
+    }
+
+    for (; pos != last && is_digit(*pos); ++pos) {
+        auto digit = static_cast<std::uint64_t>(*pos - '0');
+        if (__builtin_mul_overflow(v, std::uint64_t{10}, &v) ||
+            __builtin_add_overflow(v, digit, &v)) {
+            return false;
+        }
+    }
+
+    value = v;
+
+    return true;
+}
+
+// Handles the common case of a short decimal number (e.g. "-12.345e2")
+// whose mantissa and power of ten can be represented exactly in T; in
+// which case a single multiplication or division gives the correctly
+// rounded result (a.k.a. Clinger's fast path). Returns false if the
+// number does not match this pattern.
+template<typename T>
+bool try_parse_float_fast(std::string_view s, T &result) noexcept
+{
+    const char *pos = s.data();
+    const char *last = pos + s.size();
+
+    bool negative = false;
+    if (pos != last && (*pos == '-' || *pos == '+')) {
+        negative = *pos == '-';
+
+        ++pos;
+    }
+
+    std::uint64_t mantissa = 0;
+    std::size_t num_digits = 0;
+
+    int exponent = 0;
+
+    for (; pos != last && is_digit(*pos); ++pos, ++num_digits) {
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*pos - '0');
+    }
+
+    if (pos != last && *pos == '.') {
+        const char *frac_beg = ++pos;
+
+        for (; pos != last && is_digit(*pos); ++pos, ++num_digits) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*pos - '0');
+        }
+
+        exponent = -static_cast<int>(pos - frac_beg);
+    }
+
+    // More than 19 digits might have overflowed the mantissa.
+    if (num_digits == 0 || num_digits > 19) {
+        return false;
+    }
+
+    if (pos != last && (*pos == 'e' || *pos == 'E')) {
+        ++pos;
+
+        bool negative_exp = false;
+        if (pos != last && (*pos == '-' || *pos == '+')) {
+            negative_exp = *pos == '-';
+
+            ++pos;
+        }
+
+        if (pos == last) {
+            return false;
+        }
+
+        int exp = 0;
+        for (; pos != last && is_digit(*pos); ++pos) {
+            if (exp > 1000) {
+                return false;
+            }
+            exp = exp * 10 + (*pos - '0');
+        }
+
+        exponent += negative_exp ? -exp : exp;
+    }
+
+    if (pos != last) {
+        return false;
+    }
+
+    if (mantissa > parser_traits<T>::max_exact_mantissa) {
+        return false;
+    }
+    if (exponent < -parser_traits<T>::max_exact_exponent ||
+        exponent > parser_traits<T>::max_exact_exponent) {
+        return false;
+    }
+
+    auto v = static_cast<T>(mantissa);
+
+    // The powers of ten up to the max exact exponent of T are exactly
+    // representable in T as well.
+    auto pow = static_cast<T>(exact_powers_of_ten[exponent < 0 ? -exponent : exponent]);
+    if (exponent < 0) {
+        v /= pow;
+    }
+    else {
+        v *= pow;
+    }
+
+    result = negative ? -v : v;
+
+    return true;
+}
+
+bool is_nan_value(std::string_view s, const std::unordered_set<std::string> &nan_values)
+{
+    // We reuse a thread-local buffer; otherwise the lookup would allocate
+    // a new string for each value that is longer than the SSO capacity.
+    thread_local std::string key{};
+
+    key.assign(s.data(), s.size());
+
+    return nan_values.find(key) != nan_values.end();
+}
+
 template<typename T>
 Parse_result try_parse_float_core(std::string_view s, T &result, const Float_parse_options &opts)
 {
+    std::string_view trimmed = trim_ascii(s);
+
+    if (try_parse_float_fast(trimmed, result)) {
+        return Parse_result::ok;
+    }
+
+    // The matcher holds no value that the slow path would accept; so we
+    // can check it first and spare the slow path for the NaN markers.
+    if (opts.nan_matcher != nullptr) {
+        if (opts.nan_matcher->matches(trimmed)) {
+            result = std::numeric_limits<T>::quiet_NaN();
+
+            return Parse_result::ok;
+        }
+    }
+
     T v = 0.0;
 
-    if (!parser_traits<T>::parse_func(s, &v)) {
+    // Fall back to the slow path for everything else (e.g. numbers with
+    // many digits or large exponents, hexadecimal numbers, infinity).
+    if (!parser_traits<T>::parse_func(absl::string_view{trimmed.data(), trimmed.size()}, &v)) {
         auto *nan_values = opts.nan_values;
-        if (nan_values != nullptr && !nan_values->empty()) {
-            auto trimmed = static_cast<std::string>(trim(s));
-            if (nan_values->find(trimmed) != nan_values->end()) {
+        if (opts.nan_matcher == nullptr && nan_values != nullptr && !nan_values->empty()) {
+            if (is_nan_value(trimmed, *nan_values)) {
                 result = std::numeric_limits<T>::quiet_NaN();
 
                 return Parse_result::ok;
@@ -80,20 +290,75 @@ Parse_result try_parse_float_core(std::string_view s, T &result, const Float_par
 
 template<typename T>
 std::enable_if_t<sizeof(T) >= 4, Parse_result>
-try_parse_int_core(std::string_view s, T &result, const Int_parse_options &) noexcept
+try_parse_int_core(std::string_view s, T &result, const Int_parse_options &opts) noexcept
 {
-    // Do not use 0; otherwise we cannot distinguish between a failure
-    // and an overflow for unsigned types.
-    T v = 1;
+    using U = std::make_unsigned_t<T>;
+
+    s = trim_ascii(s);
+
+    const char *pos = s.data();
+    const char *last = pos + s.size();
+
+    bool negative = false;
+    if (pos != last && (*pos == '-' || *pos == '+')) {
+        negative = *pos == '-';
+
+        ++pos;
+    }
 
-    if (!parser_traits<T>::parse_func(s, &v)) {
-        if (v == std::numeric_limits<T>::max() || v == std::numeric_limits<T>::min()) {
+    if (pos == last) {
+        return Parse_result::failed;
+    }
+
+    if (negative && std::is_unsigned_v<T>) {
+        return Parse_result::failed;
+    }
+
+    std::uint64_t v = 0;
+
+    if (opts.base == 0 || opts.base == 10) {
+        if (!parse_decimal_digits(pos, last, v)) {
+            // Make sure that all remaining characters are digits before
+            // reporting an overflow.
+            while (pos != last && is_digit(*pos)) {
+                ++pos;
+            }
+            return pos == last ? Parse_result::overflowed : Parse_result::failed;
+        }
+        if (pos != last) {
+            return Parse_result::failed;
+        }
+    }
+    else {
+        std::from_chars_result r = std::from_chars(pos, last, v, opts.base);
+        if (r.ptr != last) {
+            return Parse_result::failed;
+        }
+        if (r.ec == std::errc::result_out_of_range) {
             return Parse_result::overflowed;
         }
-        return Parse_result::failed;
+        if (r.ec != std::errc{}) {
+            return Parse_result::failed;
+        }
     }
 
-    result = v;
+    // The magnitude of the minimum value of a signed type is one more
+    // than its maximum value.
+    auto max_magnitude = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    if (negative) {
+        max_magnitude++;
+    }
+
+    if (v > max_magnitude) {
+        return Parse_result::overflowed;
+    }
+
+    if (negative) {
+        result = static_cast<T>(U{0} - static_cast<U>(v));
+    }
+    else {
+        result = static_cast<T>(v);
+    }
 
     return Parse_result::ok;
 }
@@ -123,6 +388,81 @@ try_parse_int_core(std::string_view s, T &result, const Int_parse_options &opts)
 }  // namespace
 }  // namespace detail
 
+Nan_value_matcher::Nan_value_matcher(const std::unordered_set<std::string> &nan_values)
+{
+    std::vector<std::string_view> short_values{};
+
+    for (const std::string &value : nan_values) {
+        double v{};
+        if (absl::SimpleAtod(value, &v)) {
+            continue;
+        }
+
+        if (value.size() <= max_short_size) {
+            short_values.emplace_back(value);
+        }
+        else {
+            long_values_.emplace_back(value);
+        }
+    }
+
+    std::sort(short_values.begin(), short_values.end(), [](const auto &a, const auto &b) {
+        return a.size() < b.size();
+    });
+
+    short_values_.reserve(short_values.size());
+
+    std::size_t size = 0;
+    for (std::string_view value : short_values) {
+        while (size < value.size()) {
+            offsets_[++size] = static_cast<std::uint16_t>(short_values_.size());
+        }
+
+        short_values_.emplace_back(make_short_value(value));
+
+        length_mask_ |= std::uint32_t{1} << value.size();
+    }
+
+    while (size <= max_short_size) {
+        offsets_[++size] = static_cast<std::uint16_t>(short_values_.size());
+    }
+}
+
+bool Nan_value_matcher::matches(std::string_view s) const noexcept
+{
+    if (s.size() > max_short_size) {
+        return std::find(long_values_.begin(), long_values_.end(), s) != long_values_.end();
+    }
+
+    if ((length_mask_ & (std::uint32_t{1} << s.size())) == 0) {
+        return false;
+    }
+
+    Short_value key = make_short_value(s);
+
+    auto first = short_values_.begin() + offsets_[s.size()];
+    auto last = short_values_.begin() + offsets_[s.size() + 1];
+
+    return std::any_of(first, last, [&key](const Short_value &value) {
+        return ((value.lo ^ key.lo) | (value.hi ^ key.hi)) == 0;
+    });
+}
+
+Nan_value_matcher::Short_value Nan_value_matcher::make_short_value(std::string_view s) noexcept
+{
+    std::array<char, max_short_size> chars{};
+
+    if (!s.empty()) {
+        std::memcpy(chars.data(), s.data(), s.size());
+    }
+
+    Short_value value{};
+    std::memcpy(&value.lo, chars.data(), sizeof(value.lo));
+    std::memcpy(&value.hi, chars.data() + sizeof(value.lo), sizeof(value.hi));
+
+    return value;
+}
+
 template<typename T>
 inline Parse_result try_parse_float(std::string_view s, T &result, const Float_parse_options &opts)
 {
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/util/quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+namespace {
+
+// The ratio between the capacities of two adjacent compactors.
+constexpr double capacity_ratio = 2.0 / 3.0;
+
+}  // namespace
+}  // namespace detail
+
+Quantile_sketch::Quantile_sketch(std::size_t k) : k_{k}
+{
+    if (k_ < 8) {
+        throw std::invalid_argument{"The size of the quantile sketch must be at least 8."};
+    }
+
+    grow();
+}
+
+void Quantile_sketch::add(double value)
+{
+    if (std::isnan(value)) {
+        return;
+    }
+
+    if (count_ == 0) {
+        min_ = value;
+        max_ = value;
+    }
+    else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    count_++;
+
+    compactors_[0].push_back(value);
+
+    if (++num_retained_ >= max_retained_) {
+        compress();
+    }
+}
+
+void Quantile_sketch::merge(const Quantile_sketch &other)
+{
+    if (k_ != other.k_) {
+        throw std::invalid_argument{"The quantile sketches must have the same size."};
+    }
+
+    if (other.count_ == 0) {
+        return;
+    }
+
+    if (count_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    }
+    else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    count_ += other.count_;
+
+    while (compactors_.size() < other.compactors_.size()) {
+        grow();
+    }
+
+    for (std::size_t level = 0; level < other.compactors_.size(); level++) {
+        const std::vector<double> &items = other.compactors_[level];
+
+        compactors_[level].insert(compactors_[level].end(), items.begin(), items.end());
+
+        num_retained_ += items.size();
+    }
+
+    while (num_retained_ >= max_retained_) {
+        compress();
+    }
+}
+
+void Quantile_sketch::compress()
+{
+    for (std::size_t level = 0; level < compactors_.size(); level++) {
+        std::vector<double> &items = compactors_[level];
+        if (items.size() < capacity(level)) {
+            continue;
+        }
+
+        if (level + 1 == compactors_.size()) {
+            grow();
+        }
+
+        // grow() might have reallocated the compactors.
+        std::vector<double> &current = compactors_[level];
+        std::vector<double> &next = compactors_[level + 1];
+
+        std::sort(current.begin(), current.end());
+
+        // Keep the last item if the number of items is odd.
+        std::size_t num_pairs = current.size() / 2;
+
+        // A xorshift generator is good enough to pick the items that
+        // get promoted; a fixed seed keeps the sketch deterministic.
+        rng_state_ ^= rng_state_ << 13U;
+        rng_state_ ^= rng_state_ >> 17U;
+        rng_state_ ^= rng_state_ << 5U;
+
+        std::size_t offset = rng_state_ & 1U;
+
+        for (std::size_t i = 0; i < num_pairs; i++) {
+            next.push_back(current[2 * i + offset]);
+        }
+
+        double last = current.back();
+        bool has_last = current.size() % 2 != 0;
+
+        current.clear();
+        if (has_last) {
+            current.push_back(last);
+        }
+
+        num_retained_ -= num_pairs;
+
+        // Compacting a single level is enough to make room; see the lazy
+        // variant of the original paper.
+        break;
+    }
+}
+
+void Quantile_sketch::grow()
+{
+    compactors_.emplace_back();
+
+    max_retained_ = 0;
+    for (std::size_t level = 0; level < compactors_.size(); level++) {
+        max_retained_ += capacity(level);
+    }
+}
+
+std::size_t Quantile_sketch::capacity(std::size_t level) const noexcept
+{
+    std::size_t depth = compactors_.size() - level - 1;
+
+    auto cap = std::ceil(std::pow(detail::capacity_ratio, depth) * static_cast<double>(k_));
+
+    return static_cast<std::size_t>(cap) + 1;
+}
+
+double Quantile_sketch::quantile(double q) const
+{
+    if (q < 0.0 || q > 1.0) {
+        throw std::invalid_argument{"The quantile must be between 0 and 1."};
+    }
+
+    if (count_ == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // q is known to be within [0, 1] at this point.
+    if (q <= 0.0) {
+        return min_;
+    }
+    if (q >= 1.0) {
+        return max_;
+    }
+
+    std::vector<std::pair<double, std::size_t>> items{};
+    items.reserve(num_retained_);
+
+    std::size_t total_weight = 0;
+
+    for (std::size_t level = 0; level < compactors_.size(); level++) {
+        std::size_t weight = std::size_t{1} << level;
+
+        for (double item : compactors_[level]) {
+            items.emplace_back(item, weight);
+        }
+
+        total_weight += weight * compactors_[level].size();
+    }
+
+    std::sort(items.begin(), items.end());
+
+    auto rank = q * static_cast<double>(total_weight);
+
+    std::size_t cumulative_weight = 0;
+    for (auto [item, weight] : items) {
+        cumulative_weight += weight;
+
+        if (static_cast<double>(cumulative_weight) >= rank) {
+            return item;
+        }
+    }
+
+    return max_;
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
@@ -0,0 +1,692 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/video_reader.h"
+
+#ifdef MLIO_BUILD_VIDEO_READER
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <tbb/tbb.h>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libswscale/swscale.h>
+}
+
+#include "mlio/data_reader_error.h"
+#include "mlio/data_stores/data_store.h"
+#include "mlio/ffmpeg_input.h"
+#include "mlio/image_transformer.h"
+#include "mlio/instance.h"
+#include "mlio/instance_batch.h"
+#include "mlio/logger.h"
+#include "mlio/record_readers/record_reader.h"
+#include "mlio/schema.h"
+#include "mlio/tensor.h"
+#include "mlio/util/cast.h"
+#include "mlio/util/hash.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace {
+
+// Decodes the frames of a video clip held in memory with FFmpeg.
+class Clip_decoder {
+public:
+    explicit Clip_decoder(Memory_slice bits) noexcept : input_{std::move(bits)}
+    {}
+
+    Clip_decoder(const Clip_decoder &) = delete;
+
+    Clip_decoder &operator=(const Clip_decoder &) = delete;
+
+    Clip_decoder(Clip_decoder &&) = delete;
+
+    Clip_decoder &operator=(Clip_decoder &&) = delete;
+
+    ~Clip_decoder();
+
+    // Opens the clip and its best video stream. Returns false and sets
+    // the error message if the clip cannot be decoded.
+    bool open();
+
+    // Decodes the frame with the specified index and converts it to
+    // the specified pixel format. The frames should be requested in
+    // ascending order; going backwards requires a seek.
+    bool read_frame(std::size_t index, ::AVPixelFormat pix_fmt, int cv_type, cv::Mat &img);
+
+    std::size_t num_frames() const noexcept
+    {
+        return num_frames_;
+    }
+
+    const std::string &error() const noexcept
+    {
+        return input_.error();
+    }
+
+private:
+    bool needs_seek(std::int64_t target_ts) noexcept;
+
+    bool convert_frame(const ::AVFrame &frame, ::AVPixelFormat pix_fmt, int cv_type, cv::Mat &img);
+
+    detail::Ffmpeg_input input_;
+    ::AVFrame *frame_{};
+    // The most recently decoded frame.
+    ::AVFrame *last_frame_{};
+    ::SwsContext *sws_ctx_{};
+    ::AVRational frame_duration_{};
+    std::int64_t start_ts_{};
+    std::int64_t last_ts_ = AV_NOPTS_VALUE;
+    // The timestamp that was requested when the last frame was returned.
+    std::int64_t last_target_ts_ = AV_NOPTS_VALUE;
+    bool eof_{};
+    std::size_t num_frames_{};
+};
+
+Clip_decoder::~Clip_decoder()
+{
+    ::sws_freeContext(sws_ctx_);
+
+    ::av_frame_free(&last_frame_);
+    ::av_frame_free(&frame_);
+}
+
+bool Clip_decoder::open()
+{
+    if (!input_.open(AVMEDIA_TYPE_VIDEO)) {
+        return false;
+    }
+
+    frame_ = ::av_frame_alloc();
+    last_frame_ = ::av_frame_alloc();
+    if (frame_ == nullptr || last_frame_ == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    ::AVStream *stream = input_.stream();
+
+    ::AVRational frame_rate = stream->avg_frame_rate;
+    if (frame_rate.num <= 0 || frame_rate.den <= 0) {
+        frame_rate = stream->r_frame_rate;
+    }
+    if (frame_rate.num <= 0 || frame_rate.den <= 0) {
+        return input_.fail("The frame rate of the video stream is unknown.");
+    }
+
+    frame_duration_ = ::av_inv_q(frame_rate);
+
+    if (stream->start_time != AV_NOPTS_VALUE) {
+        start_ts_ = stream->start_time;
+    }
+
+    // Not all containers store the number of frames; estimate it from
+    // the duration otherwise.
+    std::int64_t num_frames = stream->nb_frames;
+    if (num_frames <= 0 && stream->duration > 0) {
+        num_frames = ::av_rescale_q(stream->duration, stream->time_base, frame_duration_);
+    }
+    if (num_frames <= 0 && input_.format_context()->duration > 0) {
+        num_frames = ::av_rescale_q(input_.format_context()->duration,
+                                    ::AVRational{1, AV_TIME_BASE},
+                                    frame_duration_);
+    }
+    if (num_frames <= 0) {
+        return input_.fail("The number of frames of the video stream cannot be determined.");
+    }
+
+    num_frames_ = static_cast<std::size_t>(num_frames);
+
+    return true;
+}
+
+bool Clip_decoder::read_frame(std::size_t index, ::AVPixelFormat pix_fmt, int cv_type, cv::Mat &img)
+{
+    std::int64_t target_ts =
+        start_ts_ + ::av_rescale_q(as_ssize(index), frame_duration_, input_.stream()->time_base);
+
+    // If the last frame was the first frame at or after the previous
+    // target, it is also the first frame at or after this one.
+    if (last_target_ts_ != AV_NOPTS_VALUE && target_ts >= last_target_ts_ &&
+        (eof_ || target_ts <= last_ts_)) {
+        last_target_ts_ = target_ts;
+
+        return convert_frame(*last_frame_, pix_fmt, cv_type, img);
+    }
+
+    if (needs_seek(target_ts)) {
+        int err = input_.seek(target_ts);
+        if (err < 0) {
+            return input_.fail("seek to the frame", err);
+        }
+
+        ::av_frame_unref(last_frame_);
+
+        last_ts_ = AV_NOPTS_VALUE;
+        last_target_ts_ = AV_NOPTS_VALUE;
+
+        eof_ = false;
+    }
+
+    while (true) {
+        int err = input_.read_frame(*frame_);
+        if (err == 0) {
+            std::int64_t ts = frame_->best_effort_timestamp;
+            if (ts == AV_NOPTS_VALUE) {
+                ts = frame_->pts;
+            }
+
+            ::av_frame_unref(last_frame_);
+            ::av_frame_move_ref(last_frame_, frame_);
+
+            last_ts_ = ts;
+
+            if (ts == AV_NOPTS_VALUE || ts >= target_ts) {
+                last_target_ts_ = target_ts;
+
+                return convert_frame(*last_frame_, pix_fmt, cv_type, img);
+            }
+
+            continue;
+        }
+
+        if (err == AVERROR_EOF) {
+            eof_ = true;
+
+            // The number of frames might have been overestimated; use the
+            // last frame of the clip.
+            if (last_frame_->buf[0] == nullptr) {
+                return input_.fail("The video stream does not contain any frames.");
+            }
+
+            last_target_ts_ = target_ts;
+
+            return convert_frame(*last_frame_, pix_fmt, cv_type, img);
+        }
+
+        return input_.fail("decode a frame", err);
+    }
+}
+
+bool Clip_decoder::needs_seek(std::int64_t target_ts) noexcept
+{
+    std::int64_t current_ts = last_ts_ == AV_NOPTS_VALUE ? start_ts_ : last_ts_;
+
+    if (target_ts <= last_ts_ && last_ts_ != AV_NOPTS_VALUE) {
+        return true;
+    }
+
+    ::AVStream *stream = input_.stream();
+
+    // Decoding forward is cheaper than seeking if we have already passed
+    // the keyframe preceding the target.
+    int idx = ::av_index_search_timestamp(stream, target_ts, AVSEEK_FLAG_BACKWARD);
+    if (idx < 0) {
+        return false;
+    }
+
+    const ::AVIndexEntry *entry = ::avformat_index_get_entry(stream, idx);
+
+    return entry != nullptr && entry->timestamp > current_ts;
+}
+
+bool Clip_decoder::convert_frame(const ::AVFrame &frame,
+                                 ::AVPixelFormat pix_fmt,
+                                 int cv_type,
+                                 cv::Mat &img)
+{
+    sws_ctx_ = ::sws_getCachedContext(sws_ctx_,
+                                      frame.width,
+                                      frame.height,
+                                      static_cast<::AVPixelFormat>(frame.format),
+                                      frame.width,
+                                      frame.height,
+                                      pix_fmt,
+                                      SWS_BILINEAR,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr);
+    if (sws_ctx_ == nullptr) {
+        return input_.fail("The pixel format of the video stream is not supported.");
+    }
+
+    // The frame is converted directly into the requested channel order
+    // so that no separate color conversion is needed.
+    img.create(frame.height, frame.width, cv_type);
+
+    std::array<std::uint8_t *, 1> dst{img.data};
+    std::array<int, 1> dst_stride{static_cast<int>(img.step)};
+
+    ::sws_scale(
+        sws_ctx_, frame.data, frame.linesize, 0, frame.height, dst.data(), dst_stride.data());
+
+    return true;
+}
+
+std::vector<std::size_t> sample_frames(std::size_t num_clip_frames,
+                                       const Video_reader_params &prm,
+                                       std::mt19937_64 &engine)
+{
+    std::vector<std::size_t> indices(prm.num_frames);
+
+    if (prm.frame_sampling == Frame_sampling::uniform) {
+        // Take the middle frame of each of the equally long segments.
+        for (std::size_t i = 0; i < prm.num_frames; i++) {
+            indices[i] = ((2 * i + 1) * num_clip_frames) / (2 * prm.num_frames);
+        }
+    }
+    else {
+        std::size_t window = (prm.num_frames - 1) * prm.frame_stride + 1;
+
+        std::size_t start = 0;
+        if (window < num_clip_frames) {
+            start = std::uniform_int_distribution<std::size_t>{0, num_clip_frames - window}(engine);
+        }
+
+        for (std::size_t i = 0; i < prm.num_frames; i++) {
+            indices[i] = std::min(start + i * prm.frame_stride, num_clip_frames - 1);
+        }
+    }
+
+    return indices;
+}
+
+}  // namespace
+
+Video_reader::Video_reader(Data_reader_params params, Video_reader_params video_params)
+    : Parallel_data_reader{std::move(params)}, params_{std::move(video_params)}
+{
+    const Image_reader_params &img_params = params_.image_params;
+
+    if (img_params.image_dimensions.size() != 3) {
+        throw std::invalid_argument{
+            "The dimensions of the output frames must be entered in (channels, height, width) format."};
+    }
+
+    std::size_t num_channels = img_params.image_dimensions[0];
+    if (num_channels != 1 && num_channels != 3 && num_channels != 4) {
+        throw std::invalid_argument{fmt::format(
+            "The specified image dimensions have an unsupported number of channels ({0:n}).",
+            num_channels)};
+    }
+
+    if (params_.num_frames == 0) {
+        throw std::invalid_argument{"The number of frames must be greater than zero."};
+    }
+
+    if (params_.frame_sampling == Frame_sampling::random && params_.frame_stride == 0) {
+        throw std::invalid_argument{"The frame stride must be greater than zero."};
+    }
+
+    if (img_params.image_frame != Image_frame::none || img_params.variable_size ||
+        img_params.bucketing_window > 0) {
+        throw std::invalid_argument{
+            "The video reader does not support the image frame, variable-size, and bucketing options."};
+    }
+
+    error_bad_example_ = this->params().bad_example_handling == Bad_example_handling::error;
+
+    transformer_ = std::make_unique<detail::Image_transformer>(
+        img_params, warn_bad_instances(), error_bad_example_);
+
+    if (img_params.augmentation_seed) {
+        augmentation_seed_ = *img_params.augmentation_seed;
+    }
+    else {
+        augmentation_seed_ = std::random_device{}();
+    }
+
+    if (img_params.opencv_num_threads) {
+        cv::setNumThreads(*img_params.opencv_num_threads);
+    }
+}
+
+Video_reader::~Video_reader()
+{
+    stop();
+}
+
+void Video_reader::reset() noexcept
+{
+    Parallel_data_reader::reset();
+
+    // Sample different frames and augmentations in the next epoch.
+    epoch_++;
+}
+
+Intrusive_ptr<Record_reader> Video_reader::make_record_reader(const Data_store &)
+{
+    // Each data store holds a single clip.
+    return nullptr;
+}
+
+Intrusive_ptr<const Schema> Video_reader::infer_schema(const std::optional<Instance> &)
+{
+    const Image_reader_params &img_params = params_.image_params;
+
+    const std::vector<std::size_t> &dims = img_params.image_dimensions;
+
+    Size_vector shape{};
+    if (img_params.image_layout == Image_layout::nchw) {
+        shape = {params().batch_size, params_.num_frames, dims[0], dims[1], dims[2]};
+    }
+    else {
+        shape = {params().batch_size, params_.num_frames, dims[1], dims[2], dims[0]};
+    }
+
+    std::vector<Attribute> attrs{};
+    attrs.emplace_back("value", img_params.data_type, std::move(shape));
+
+    return make_intrusive<Schema>(std::move(attrs));
+}
+
+Intrusive_ptr<Example> Video_reader::decode(const Instance_batch &batch) const
+{
+    const Attribute &attr = schema()->attributes()[0];
+
+    // The stride of the batch dimension corresponds to the number of
+    // elements in the frames of a clip.
+    auto batch_stride = as_size(attr.strides()[0]);
+
+    Size_vector shape = attr.shape();
+
+    shape[0] = batch.size();
+
+    auto arr = make_pooled_cpu_array(attr.data_type(), batch.size() * batch_stride);
+
+    auto tensor = make_intrusive<Dense_tensor>(std::move(shape), std::move(arr));
+
+    std::size_t element_size = detail::get_image_element_size(attr.data_type());
+
+    Mutable_memory_span bits{static_cast<std::byte *>(tensor->data().data()),
+                             tensor->data().size() * element_size};
+
+    std::size_t instance_size = batch_stride * element_size;
+
+    stdx::span<const Instance> instances = batch.instances();
+
+    std::size_t num_instances = instances.size();
+
+    // Each clip is decoded into its own slot in the tensor; the slots of
+    // the bad clips are compacted away afterwards.
+    std::vector<char> loaded(num_instances);
+
+    bool skip_bad_example = params().bad_example_handling == Bad_example_handling::skip ||
+                            params().bad_example_handling == Bad_example_handling::skip_warn;
+
+    std::atomic_bool skip_example{};
+
+    auto worker = [this,
+                   &batch,
+                   &bits,
+                   instance_size,
+                   &instances,
+                   &loaded,
+                   skip_bad_example,
+                   &skip_example](const tbb::blocked_range<std::size_t> &range) {
+        for (std::size_t i = range.begin(); i < range.end(); i++) {
+            if (skip_example.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            // Derive the seed of the random sampling and augmentations
+            // from the position of the clip so that they do not depend
+            // on which thread decodes the clip.
+            std::size_t seed = augmentation_seed_;
+            detail::hash_combine(seed, epoch_);
+            detail::hash_combine(seed, batch.index());
+            detail::hash_combine(seed, i);
+
+            Mutable_memory_span out = bits.subspan(i * instance_size, instance_size);
+
+            if (decode_clip(out, instances[i], seed)) {
+                loaded[i] = 1;
+            }
+            else if (skip_bad_example) {
+                skip_example = true;
+            }
+        }
+    };
+
+    // Decoding a clip is expensive enough for a task of its own.
+    tbb::parallel_for(tbb::blocked_range<std::size_t>{0, num_instances, 1}, worker);
+
+    std::size_t num_instances_read = 0;
+
+    for (std::size_t i = 0; i < num_instances; i++) {
+        if (loaded[i] == 0) {
+            continue;
+        }
+
+        if (i != num_instances_read) {
+            std::memmove(bits.data() + num_instances_read * instance_size,
+                         bits.data() + i * instance_size,
+                         instance_size);
+        }
+
+        num_instances_read++;
+    }
+
+    if (num_instances_read != num_instances) {
+        if (should_skip_example(batch)) {
+            return {};
+        }
+
+        // A bad clip might have been partially written to its slot.
+        std::fill(bits.data() + num_instances_read * instance_size,
+                  bits.data() + num_instances * instance_size,
+                  std::byte{});
+    }
+
+    warn_if_padded(batch, num_instances_read);
+
+    std::vector<Intrusive_ptr<Tensor>> tensors{};
+    tensors.emplace_back(std::move(tensor));
+
+    auto example = make_intrusive<Example>(schema(), std::move(tensors));
+
+    example->padding = batch.size() - num_instances_read;
+
+    return example;
+}
+
+bool Video_reader::decode_clip(Mutable_memory_span out,
+                               const Instance &instance,
+                               std::size_t seed) const
+{
+    const Image_reader_params &img_params = params_.image_params;
+
+    ::AVPixelFormat pix_fmt{};
+    int cv_type{};
+
+    switch (img_params.image_dimensions[0]) {
+    case 1:
+        pix_fmt = AV_PIX_FMT_GRAY8;
+        cv_type = CV_8UC1;
+        break;
+    case 4:
+        pix_fmt = img_params.to_rgb ? AV_PIX_FMT_RGBA : AV_PIX_FMT_BGRA;
+        cv_type = CV_8UC4;
+        break;
+    default:
+        pix_fmt = img_params.to_rgb ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_BGR24;
+        cv_type = CV_8UC3;
+        break;
+    }
+
+    Clip_decoder decoder{instance.bits()};
+
+    if (!decoder.open()) {
+        return report_bad_clip(instance, decoder.error());
+    }
+
+    std::mt19937_64 engine{seed};
+
+    std::vector<std::size_t> indices = sample_frames(decoder.num_frames(), params_, engine);
+
+    // Apply the same random augmentations to all frames of the clip.
+    auto frame_seed = static_cast<std::size_t>(engine());
+
+    std::size_t frame_size = out.size() / params_.num_frames;
+
+    cv::Mat img{};
+
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        if (!decoder.read_frame(indices[i], pix_fmt, cv_type, img)) {
+            return report_bad_clip(instance, decoder.error());
+        }
+
+        if (img_params.resize) {
+            if (!transformer_->resize(img, img, instance)) {
+                return false;
+            }
+        }
+
+        Mutable_memory_span frame_out = out.subspan(i * frame_size, frame_size);
+
+        if (!transformer_->apply(img, img_params.to_rgb, frame_out, frame_seed, instance)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Video_reader::report_bad_clip(const Instance &instance, const std::string &error) const
+{
+    if (warn_bad_instances() || error_bad_example_) {
+        auto msg = fmt::format(
+            "The video decode operation failed for the clip #{1:n} in the data store '{0}' with the following error: {2}",
+            instance.data_store().id(),
+            instance.index(),
+            error);
+
+        if (warn_bad_instances()) {
+            logger::warn(msg);
+        }
+
+        if (error_bad_example_) {
+            throw Invalid_instance_error{msg};
+        }
+    }
+
+    return false;
+}
+
+bool Video_reader::should_skip_example(const Instance_batch &batch) const
+{
+    if (params().bad_example_handling == Bad_example_handling::skip) {
+        return true;
+    }
+    if (params().bad_example_handling == Bad_example_handling::skip_warn) {
+        logger::warn("The example #{0:n} has been skipped as it had at least one bad clip.",
+                     batch.index());
+
+        return true;
+    }
+    if (params().bad_example_handling != Bad_example_handling::pad &&
+        params().bad_example_handling != Bad_example_handling::pad_warn) {
+        throw std::invalid_argument{"The specified bad example handling is invalid."};
+    }
+
+    return false;
+}
+
+void Video_reader::warn_if_padded(const Instance_batch &batch, std::size_t num_instances_read) const
+{
+    if (batch.instances().size() != num_instances_read) {
+        if (params().bad_example_handling == Bad_example_handling::pad_warn) {
+            logger::warn("The example #{0:n} has been padded as it had {1:n} bad clip(s).",
+                         batch.index(),
+                         batch.instances().size() - num_instances_read);
+        }
+    }
+}
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#else
+
+#include "mlio/not_supported_error.h"
+#include "mlio/record_readers/record_reader.h"
+
+#ifdef MLIO_BUILD_IMAGE_READER
+#include "mlio/image_transformer.h"
+#else
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+class Image_transformer {};
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+#endif
+
+namespace mlio {
+inline namespace abi_v1 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-noreturn"
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+Video_reader::Video_reader(Data_reader_params params, Video_reader_params)
+    : Parallel_data_reader{std::move(params)}, params_{}, error_bad_example_{}
+{
+    throw Not_supported_error{"MLIO was not built with video reader support."};
+}
+
+Video_reader::~Video_reader() = default;
+
+void Video_reader::reset() noexcept
+{}
+
+Intrusive_ptr<Record_reader> Video_reader::make_record_reader(const Data_store &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<const Schema> Video_reader::infer_schema(const std::optional<Instance> &)
+{
+    return nullptr;
+}
+
+Intrusive_ptr<Example> Video_reader::decode(const Instance_batch &) const
+{
+    return nullptr;
+}
+
+#pragma GCC diagnostic pop
+
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
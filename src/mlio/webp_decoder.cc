@@ -0,0 +1,81 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "mlio/webp_decoder.h"
+
+#ifdef MLIO_BUILD_WEBP
+
+#include <webp/decode.h>
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+bool read_webp_header(Memory_span bits, Webp_info &info) noexcept
+{
+    ::WebPBitstreamFeatures features{};
+
+    auto *data = reinterpret_cast<const std::uint8_t *>(bits.data());
+
+    if (::WebPGetFeatures(data, bits.size(), &features) != VP8_STATUS_OK) {
+        return false;
+    }
+
+    info.width = static_cast<std::size_t>(features.width);
+    info.height = static_cast<std::size_t>(features.height);
+    info.has_alpha = features.has_alpha != 0;
+    info.is_animated = features.has_animation != 0;
+
+    return true;
+}
+
+bool decode_webp(Memory_span bits,
+                 Webp_color_space color_space,
+                 stdx::span<std::uint8_t> destination,
+                 std::size_t row_stride) noexcept
+{
+    auto *data = reinterpret_cast<const std::uint8_t *>(bits.data());
+
+    auto stride = static_cast<int>(row_stride);
+
+    std::uint8_t *result{};
+
+    switch (color_space) {
+    case Webp_color_space::bgr:
+        result = ::WebPDecodeBGRInto(
+            data, bits.size(), destination.data(), destination.size(), stride);
+        break;
+    case Webp_color_space::rgb:
+        result = ::WebPDecodeRGBInto(
+            data, bits.size(), destination.data(), destination.size(), stride);
+        break;
+    case Webp_color_space::bgra:
+        result = ::WebPDecodeBGRAInto(
+            data, bits.size(), destination.data(), destination.size(), stride);
+        break;
+    case Webp_color_space::rgba:
+        result = ::WebPDecodeRGBAInto(
+            data, bits.size(), destination.data(), destination.size(), stride);
+        break;
+    }
+
+    return result != nullptr;
+}
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mlio/span.h"
+
+namespace mlio {
+inline namespace abi_v1 {
+namespace detail {
+
+enum class Webp_color_space { bgr, rgb, bgra, rgba };
+
+struct Webp_info {
+    std::size_t width{};
+    std::size_t height{};
+    bool has_alpha{};
+    bool is_animated{};
+};
+
+/// Reads the header of the specified WebP image. Returns false if
+/// @p bits does not contain a valid WebP image.
+bool read_webp_header(Memory_span bits, Webp_info &info) noexcept;
+
+/// Decodes the specified WebP image with libwebp directly into
+/// @p destination in the requested channel order. Returns false if
+/// the image cannot be decoded.
+///
+/// @param row_stride
+///     The number of bytes between two consecutive rows in
+///     @p destination.
+bool decode_webp(Memory_span bits,
+                 Webp_color_space color_space,
+                 stdx::span<std::uint8_t> destination,
+                 std::size_t row_stride) noexcept;
+
+}  // namespace detail
+}  // namespace abi_v1
+}  // namespace mlio
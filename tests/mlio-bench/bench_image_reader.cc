@@ -0,0 +1,81 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <mlio.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "datasets.h"
+#include "readers.h"
+
+namespace mlio_bench {
+namespace {
+
+constexpr std::uint64_t seed = 42;
+
+// Returns a RecordIO dataset of JPEG images. The images are smoothed
+// random noise, which compresses closer to natural images than plain
+// noise does.
+std::string make_jpeg_recordio(std::size_t num_images, int width, int height)
+{
+    cv::RNG rng{seed};
+
+    std::vector<std::string> images{};
+    images.reserve(num_images);
+
+    std::vector<unsigned char> buf{};
+
+    for (std::size_t i = 0; i < num_images; i++) {
+        cv::Mat img{height, width, CV_8UC3};
+
+        rng.fill(img, cv::RNG::UNIFORM, 0, 256);
+
+        cv::GaussianBlur(img, img, cv::Size{9, 9}, 0);
+
+        cv::imencode(".jpg", img, buf);
+
+        images.emplace_back(buf.begin(), buf.end());
+    }
+
+    return make_recordio_images(images);
+}
+
+void BM_image_reader_jpeg_recordio(benchmark::State &state)
+{
+    static const std::string recordio = make_jpeg_recordio(512, 500, 375);
+
+    mlio::Image_reader_params img_params{};
+    img_params.image_frame = mlio::Image_frame::recordio;
+    img_params.resize = 256;
+    img_params.image_dimensions = {3, 224, 224};
+
+    mlio::Image_reader reader{make_params(state, recordio), img_params};
+
+    read_epochs(state, reader, recordio.size() * num_stores);
+}
+
+}  // namespace
+
+// The argument is the number of parallel reads.
+BENCHMARK(BM_image_reader_jpeg_recordio)->Apply(apply_thread_counts)->UseRealTime();
+
+}  // namespace mlio_bench
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <mlio.h>
+
+#include "datasets.h"
+#include "mlio/csv_record_tokenizer.h"
+
+namespace mlio_bench {
+namespace {
+
+constexpr std::size_t num_rows = 10'000;
+
+// Splits the specified CSV dataset into its records, skipping the header.
+std::vector<std::string_view> split_records(std::string_view csv)
+{
+    std::vector<std::string_view> records{};
+
+    std::size_t pos = csv.find('\n') + 1;
+    while (pos < csv.size()) {
+        std::size_t end = csv.find('\n', pos);
+        records.emplace_back(csv.substr(pos, end - pos));
+        pos = end + 1;
+    }
+
+    return records;
+}
+
+template<typename Tokenizer>
+void tokenize(benchmark::State &state, const std::string &csv)
+{
+    std::vector<std::string_view> records = split_records(csv);
+
+    mlio::Csv_params params{};
+
+    Tokenizer tokenizer{params};
+
+    std::size_t num_fields = 0;
+
+    for (auto _ : state) {
+        for (std::string_view record : records) {
+            tokenizer.reset(mlio::stdx::as_bytes(mlio::stdx::span<const char>{record}));
+
+            while (tokenizer.next()) {
+                benchmark::DoNotOptimize(tokenizer.value());
+
+                num_fields++;
+            }
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * csv.size()));
+
+    state.counters["fields/s"] =
+        benchmark::Counter(static_cast<double>(num_fields), benchmark::Counter::kIsRate);
+}
+
+// The generic tokenizer is benchmarked against the one that Csv_reader
+// uses for the default comma dialect.
+template<typename Tokenizer>
+void BM_csv_record_tokenizer_numeric(benchmark::State &state)
+{
+    static const std::string csv = make_numeric_csv(num_rows, 100);
+
+    tokenize<Tokenizer>(state, csv);
+}
+
+template<typename Tokenizer>
+void BM_csv_record_tokenizer_string(benchmark::State &state)
+{
+    static const std::string csv = make_string_csv(num_rows, 100);
+
+    tokenize<Tokenizer>(state, csv);
+}
+
+template<typename T>
+void BM_try_parse_float(benchmark::State &state)
+{
+    static const std::string csv = make_numeric_csv(num_rows, 10);
+
+    // Collect the values of all fields; the dataset has no quoted fields.
+    std::vector<std::string_view> values{};
+    for (std::string_view record : split_records(csv)) {
+        std::size_t pos = 0;
+        for (std::size_t end = 0; end != std::string_view::npos; pos = end + 1) {
+            end = record.find(',', pos);
+            values.emplace_back(record.substr(pos, end - pos));
+        }
+    }
+
+    T result{};
+
+    for (auto _ : state) {
+        for (std::string_view value : values) {
+            if (mlio::try_parse_float(value, result) != mlio::Parse_result::ok) {
+                state.SkipWithError("The value cannot be parsed.");
+                return;
+            }
+
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_csv_record_tokenizer_numeric, mlio::detail::Csv_record_tokenizer);
+BENCHMARK_TEMPLATE(BM_csv_record_tokenizer_numeric, mlio::detail::Comma_csv_record_tokenizer);
+BENCHMARK_TEMPLATE(BM_csv_record_tokenizer_string, mlio::detail::Csv_record_tokenizer);
+BENCHMARK_TEMPLATE(BM_csv_record_tokenizer_string, mlio::detail::Comma_csv_record_tokenizer);
+
+BENCHMARK_TEMPLATE(BM_try_parse_float, float);
+BENCHMARK_TEMPLATE(BM_try_parse_float, double);
+
+}  // namespace mlio_bench
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+#include <mlio.h>
+
+#include "datasets.h"
+#include "readers.h"
+
+namespace mlio_bench {
+namespace {
+
+std::uint64_t count_allocations(const mlio::Allocation_stats &stats)
+{
+    return stats.num_memory_blocks + stats.num_cpu_arrays + stats.num_heap_allocations;
+}
+
+// Reads one more epoch with the allocation audit running and reports the
+// allocations per batch of the steady-state decode and framing stages;
+// if the MLIO_BENCH_MAX_DECODE_ALLOCATIONS environment variable is set,
+// fails the benchmark when the decode stage makes more allocations per
+// batch than its value.
+void audit_epoch(benchmark::State &state, mlio::Data_reader &reader)
+{
+    mlio::start_allocation_audit();
+
+    std::size_t num_batches = 0;
+    while (reader.read_example() != nullptr) {
+        num_batches++;
+    }
+
+    mlio::stop_allocation_audit();
+
+    reader.reset();
+
+    if (num_batches == 0) {
+        return;
+    }
+
+    mlio::Allocation_audit audit = mlio::allocation_audit();
+
+    // The tokenization and the protobuf parsing are part of decoding.
+    std::uint64_t num_decode_allocations = count_allocations(audit.decode) +
+                                           count_allocations(audit.tokenize) +
+                                           count_allocations(audit.protobuf);
+
+    double decode_per_batch =
+        static_cast<double>(num_decode_allocations) / static_cast<double>(num_batches);
+
+    double framing_per_batch = static_cast<double>(count_allocations(audit.framing)) /
+                               static_cast<double>(num_batches);
+
+    state.counters["decode allocs/batch"] = decode_per_batch;
+    state.counters["framing allocs/batch"] = framing_per_batch;
+
+    const char *max_allocations = std::getenv("MLIO_BENCH_MAX_DECODE_ALLOCATIONS");
+    if (max_allocations != nullptr && decode_per_batch > std::strtod(max_allocations, nullptr)) {
+        state.SkipWithError("The decode stage exceeds the allocation budget per batch.");
+    }
+}
+
+}  // namespace
+
+void read_epochs(benchmark::State &state, mlio::Data_reader &reader, std::size_t num_bytes)
+{
+    std::size_t num_examples = 0;
+
+    for (auto _ : state) {
+        mlio::Intrusive_ptr<mlio::Example> example{};
+        while ((example = reader.read_example()) != nullptr) {
+            benchmark::DoNotOptimize(example.get());
+
+            num_examples++;
+        }
+
+        reader.reset();
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * num_bytes));
+
+    state.counters["examples/s"] =
+        benchmark::Counter(static_cast<double>(num_examples), benchmark::Counter::kIsRate);
+
+    audit_epoch(state, reader);
+}
+
+mlio::Data_reader_params make_params(const benchmark::State &state, std::string_view bits)
+{
+    mlio::Data_reader_params params{};
+    params.dataset = make_dataset(bits, num_stores);
+    params.batch_size = batch_size;
+    params.num_parallel_reads = static_cast<std::size_t>(state.range(0));
+
+    return params;
+}
+
+namespace {
+
+void BM_csv_reader_numeric(benchmark::State &state)
+{
+    static const std::string csv = make_numeric_csv(20'000, 100);
+
+    mlio::Csv_reader reader{make_params(state, csv)};
+
+    read_epochs(state, reader, csv.size() * num_stores);
+}
+
+void BM_csv_reader_string(benchmark::State &state)
+{
+    static const std::string csv = make_string_csv(20'000, 20);
+
+    mlio::Csv_reader reader{make_params(state, csv)};
+
+    read_epochs(state, reader, csv.size() * num_stores);
+}
+
+void BM_recordio_protobuf_reader_dense(benchmark::State &state)
+{
+    static const std::string recordio = make_recordio_protobuf(20'000, 100, false);
+
+    mlio::Recordio_protobuf_reader reader{make_params(state, recordio)};
+
+    read_epochs(state, reader, recordio.size() * num_stores);
+}
+
+void BM_recordio_protobuf_reader_sparse(benchmark::State &state)
+{
+    static const std::string recordio = make_recordio_protobuf(20'000, 1'000, true);
+
+    mlio::Recordio_protobuf_reader reader{make_params(state, recordio)};
+
+    read_epochs(state, reader, recordio.size() * num_stores);
+}
+
+}  // namespace
+
+// The argument is the number of parallel reads.
+BENCHMARK(BM_csv_reader_numeric)->Apply(apply_thread_counts)->UseRealTime();
+BENCHMARK(BM_csv_reader_string)->Apply(apply_thread_counts)->UseRealTime();
+
+BENCHMARK(BM_recordio_protobuf_reader_dense)->Apply(apply_thread_counts)->UseRealTime();
+BENCHMARK(BM_recordio_protobuf_reader_sparse)->Apply(apply_thread_counts)->UseRealTime();
+
+}  // namespace mlio_bench
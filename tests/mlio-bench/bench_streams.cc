@@ -0,0 +1,134 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <mlio.h>
+
+#include "datasets.h"
+#include "mlio/record_readers/detail/default_chunk_reader.h"
+
+namespace mlio_bench {
+namespace {
+
+constexpr std::size_t num_rows = 20'000;
+
+// Reads the specified stream to its end and returns the number of bytes
+// read.
+std::size_t drain(mlio::Input_stream &stream, std::vector<std::byte> &buffer)
+{
+    std::size_t total = 0;
+
+    std::size_t num_bytes_read{};
+    while ((num_bytes_read = stream.read(mlio::Mutable_memory_span{buffer})) > 0) {
+        benchmark::DoNotOptimize(buffer.data());
+
+        total += num_bytes_read;
+    }
+
+    return total;
+}
+
+void BM_utf8_input_stream(benchmark::State &state)
+{
+    static const mlio::Memory_slice bits =
+        to_memory(make_utf16(make_string_csv(num_rows, 20)));
+
+    std::vector<std::byte> buffer(0x10'0000);
+
+    std::size_t total = 0;
+
+    for (auto _ : state) {
+        auto inner = mlio::make_intrusive<mlio::Memory_input_stream>(bits);
+
+        auto stream = mlio::make_utf8_stream(std::move(inner), mlio::Text_encoding::utf16_le);
+
+        total += drain(*stream, buffer);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bits.size()));
+
+    state.counters["output_bytes/s"] =
+        benchmark::Counter(static_cast<double>(total), benchmark::Counter::kIsRate);
+}
+
+void BM_gzip_inflate_stream(benchmark::State &state)
+{
+    static const mlio::Memory_slice bits = to_memory(gzip(make_numeric_csv(num_rows, 20)));
+
+    std::vector<std::byte> buffer(0x10'0000);
+
+    std::size_t total = 0;
+
+    for (auto _ : state) {
+        auto inner = mlio::make_intrusive<mlio::Memory_input_stream>(bits);
+
+        mlio::Gzip_inflate_stream stream{std::move(inner)};
+
+        total += drain(stream, buffer);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bits.size()));
+
+    state.counters["output_bytes/s"] =
+        benchmark::Counter(static_cast<double>(total), benchmark::Counter::kIsRate);
+}
+
+// The argument is the chunk size hint in KiB.
+void BM_default_chunk_reader(benchmark::State &state)
+{
+    static const mlio::Memory_slice bits = to_memory(make_numeric_csv(num_rows, 20));
+
+    auto chunk_size = static_cast<std::size_t>(state.range(0)) * 1024;
+
+    for (auto _ : state) {
+        auto stream = mlio::make_intrusive<mlio::Memory_input_stream>(bits);
+
+        mlio::detail::Default_chunk_reader reader{std::move(stream)};
+
+        reader.set_chunk_size_hint(chunk_size);
+
+        // Carry over the last partial line of each chunk as a record
+        // reader would.
+        mlio::Memory_slice leftover{};
+        while (!reader.eof()) {
+            mlio::Memory_slice chunk = reader.read_chunk(leftover);
+
+            auto pos = chunk.size();
+            while (pos > 0 && chunk.data()[pos - 1] != std::byte{'\n'}) {
+                pos--;
+            }
+
+            leftover = chunk.subslice(pos);
+
+            benchmark::DoNotOptimize(chunk.data());
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bits.size()));
+}
+
+}  // namespace
+
+BENCHMARK(BM_utf8_input_stream);
+BENCHMARK(BM_gzip_inflate_stream);
+
+BENCHMARK(BM_default_chunk_reader)->Arg(64)->Arg(1024)->Arg(8192);
+
+}  // namespace mlio_bench
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include "datasets.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include <zlib.h>
+
+namespace mlio_bench {
+namespace {
+
+constexpr std::uint64_t seed = 42;
+
+constexpr std::uint32_t recordio_magic = 0xced7'230a;
+
+// Protobuf wire types.
+constexpr std::uint32_t length_delimited = 2;
+constexpr std::uint32_t fixed32 = 5;
+
+void append_uint32(std::string &s, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++, value >>= 8U) {
+        s.push_back(static_cast<char>(value & 0xFFU));
+    }
+}
+
+void append_varint(std::string &s, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        s.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+        value >>= 7U;
+    }
+    s.push_back(static_cast<char>(value));
+}
+
+void append_tag(std::string &s, std::uint32_t field, std::uint32_t wire_type)
+{
+    append_varint(s, (field << 3U) | wire_type);
+}
+
+void append_bytes_field(std::string &s, std::uint32_t field, std::string_view bits)
+{
+    append_tag(s, field, length_delimited);
+    append_varint(s, bits.size());
+    s.append(bits);
+}
+
+void append_float(std::string &s, float value)
+{
+    std::uint32_t bits{};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    append_uint32(s, bits);
+}
+
+// Encodes a Float32Tensor message.
+std::string encode_float32_tensor(const std::vector<float> &values,
+                                  const std::vector<std::uint64_t> &keys,
+                                  const std::vector<std::uint64_t> &shape)
+{
+    std::string tensor{};
+
+    std::string packed{};
+    for (float value : values) {
+        append_float(packed, value);
+    }
+    append_bytes_field(tensor, 1, packed);
+
+    if (!keys.empty()) {
+        packed.clear();
+        for (std::uint64_t key : keys) {
+            append_varint(packed, key);
+        }
+        append_bytes_field(tensor, 2, packed);
+    }
+
+    if (!shape.empty()) {
+        packed.clear();
+        for (std::uint64_t dim : shape) {
+            append_varint(packed, dim);
+        }
+        append_bytes_field(tensor, 3, packed);
+    }
+
+    return tensor;
+}
+
+// Encodes an entry of a map<string, Value> field whose value holds the
+// specified Float32Tensor message.
+std::string encode_map_entry(std::string_view key, std::string_view tensor)
+{
+    std::string value{};
+    append_bytes_field(value, 2, tensor);
+
+    std::string entry{};
+    append_bytes_field(entry, 1, key);
+    append_bytes_field(entry, 2, value);
+
+    return entry;
+}
+
+void append_recordio_record(std::string &s, std::string_view payload)
+{
+    append_uint32(s, recordio_magic);
+    append_uint32(s, static_cast<std::uint32_t>(payload.size()));
+
+    s.append(payload);
+
+    // Records are padded to a multiple of four bytes.
+    s.append((4 - (payload.size() % 4)) % 4, '\0');
+}
+
+}  // namespace
+
+std::string make_numeric_csv(std::size_t num_rows, std::size_t num_cols)
+{
+    std::mt19937_64 engine{seed};
+
+    std::uniform_real_distribution<float> dist{-1000.0F, 1000.0F};
+
+    std::string csv{};
+
+    for (std::size_t i = 0; i < num_cols; i++) {
+        if (i > 0) {
+            csv += ',';
+        }
+        csv += "col" + std::to_string(i);
+    }
+    csv += '\n';
+
+    for (std::size_t r = 0; r < num_rows; r++) {
+        for (std::size_t i = 0; i < num_cols; i++) {
+            if (i > 0) {
+                csv += ',';
+            }
+            csv += std::to_string(dist(engine));
+        }
+        csv += '\n';
+    }
+
+    return csv;
+}
+
+std::string make_string_csv(std::size_t num_rows, std::size_t num_cols)
+{
+    static constexpr std::string_view alphabet = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+    std::mt19937_64 engine{seed};
+
+    std::uniform_int_distribution<std::size_t> len_dist{1, 24};
+    std::uniform_int_distribution<std::size_t> chr_dist{0, alphabet.size() - 1};
+
+    std::string csv{};
+
+    for (std::size_t i = 0; i < num_cols; i++) {
+        if (i > 0) {
+            csv += ',';
+        }
+        csv += "col" + std::to_string(i);
+    }
+    csv += '\n';
+
+    for (std::size_t r = 0; r < num_rows; r++) {
+        for (std::size_t i = 0; i < num_cols; i++) {
+            if (i > 0) {
+                csv += ',';
+            }
+
+            std::string value{};
+            for (std::size_t len = len_dist(engine); len > 0; len--) {
+                value += alphabet[chr_dist(engine)];
+            }
+
+            if ((r + i) % 4 == 0) {
+                csv += "\"" + value + ",\"\"" + value + "\"";
+            }
+            else {
+                csv += value;
+            }
+        }
+        csv += '\n';
+    }
+
+    return csv;
+}
+
+std::string
+make_recordio_protobuf(std::size_t num_records, std::size_t num_features, bool sparse)
+{
+    std::mt19937_64 engine{seed};
+
+    std::uniform_real_distribution<float> dist{-1.0F, 1.0F};
+    std::bernoulli_distribution nnz_dist{0.1};
+
+    std::string recordio{};
+
+    std::vector<float> values{};
+    std::vector<std::uint64_t> keys{};
+
+    for (std::size_t r = 0; r < num_records; r++) {
+        values.clear();
+        keys.clear();
+
+        for (std::size_t i = 0; i < num_features; i++) {
+            if (sparse) {
+                if (nnz_dist(engine)) {
+                    values.emplace_back(dist(engine));
+                    keys.emplace_back(i);
+                }
+            }
+            else {
+                values.emplace_back(dist(engine));
+            }
+        }
+
+        std::string features{};
+        if (sparse) {
+            features = encode_float32_tensor(values, keys, {num_features});
+        }
+        else {
+            features = encode_float32_tensor(values, {}, {});
+        }
+
+        std::string label = encode_float32_tensor({dist(engine)}, {}, {});
+
+        std::string record{};
+        append_bytes_field(record, 1, encode_map_entry("values", features));
+        append_bytes_field(record, 2, encode_map_entry("values", label));
+
+        append_recordio_record(recordio, record);
+    }
+
+    return recordio;
+}
+
+std::string make_utf16(std::string_view text)
+{
+    std::string utf16{"\xFF\xFE"};
+
+    utf16.reserve(2 + text.size() * 2);
+
+    // The generated datasets are ASCII; every character maps to a single
+    // UTF-16 code unit.
+    for (char chr : text) {
+        utf16 += chr;
+        utf16 += '\0';
+    }
+
+    return utf16;
+}
+
+std::string gzip(std::string_view bits)
+{
+    constexpr int window_bits = 15 + 16;  // Emit a gzip header.
+    constexpr int mem_level = 8;
+
+    ::z_stream strm{};
+    if (::deflateInit2(&strm,
+                       Z_DEFAULT_COMPRESSION,
+                       Z_DEFLATED,
+                       window_bits,
+                       mem_level,
+                       Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error{"The zlib stream cannot be initialized."};
+    }
+
+    std::string out(::deflateBound(&strm, static_cast<::uLong>(bits.size())), '\0');
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    strm.next_in = reinterpret_cast<::Bytef *>(const_cast<char *>(bits.data()));
+    strm.avail_in = static_cast<::uInt>(bits.size());
+    strm.next_out = reinterpret_cast<::Bytef *>(out.data());
+    strm.avail_out = static_cast<::uInt>(out.size());
+
+    int r = ::deflate(&strm, Z_FINISH);
+
+    ::deflateEnd(&strm);
+
+    if (r != Z_STREAM_END) {
+        throw std::runtime_error{"The data cannot be compressed."};
+    }
+
+    out.resize(strm.total_out);
+
+    return out;
+}
+
+std::string make_recordio_images(const std::vector<std::string> &images)
+{
+    std::string recordio{};
+
+    std::uint64_t id = 0;
+    for (const std::string &image : images) {
+        // The MXNet image header: flag, label, and two ids; 24 bytes.
+        std::string record{};
+        append_uint32(record, 0);
+        append_float(record, static_cast<float>(id % 10));
+        append_uint32(record, static_cast<std::uint32_t>(id));
+        append_uint32(record, 0);
+        append_uint32(record, 0);
+        append_uint32(record, 0);
+
+        record += image;
+
+        append_recordio_record(recordio, record);
+
+        id++;
+    }
+
+    return recordio;
+}
+
+mlio::Memory_slice to_memory(std::string_view bits)
+{
+    auto block = mlio::memory_allocator().allocate(bits.size());
+
+    std::copy_n(reinterpret_cast<const std::byte *>(bits.data()), bits.size(), block->data());
+
+    return mlio::Memory_slice{std::move(block)};
+}
+
+std::vector<mlio::Intrusive_ptr<mlio::Data_store>>
+make_dataset(std::string_view bits, std::size_t num_stores)
+{
+    std::vector<mlio::Intrusive_ptr<mlio::Data_store>> dataset{};
+
+    dataset.reserve(num_stores);
+
+    for (std::size_t i = 0; i < num_stores; i++) {
+        dataset.emplace_back(mlio::make_intrusive<mlio::In_memory_store>(to_memory(bits)));
+    }
+
+    return dataset;
+}
+
+}  // namespace mlio_bench
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <mlio.h>
+
+// The generators below are seeded with a fixed value; they return the
+// same bytes on every run so that the results of different builds can be
+// compared with each other.
+namespace mlio_bench {
+
+/// Returns a CSV dataset with a header row and @p num_cols columns of
+/// floating-point values.
+std::string make_numeric_csv(std::size_t num_rows, std::size_t num_cols);
+
+/// Returns a CSV dataset with a header row and @p num_cols columns of
+/// strings. Every fourth field is quoted and contains a delimiter and an
+/// escaped quote.
+std::string make_string_csv(std::size_t num_rows, std::size_t num_cols);
+
+/// Returns a RecordIO-protobuf dataset with a float32 feature tensor of
+/// @p num_features values and a scalar label per record. If @p sparse is
+/// true, roughly one in ten of the values are stored as a sparse tensor.
+std::string
+make_recordio_protobuf(std::size_t num_records, std::size_t num_features, bool sparse);
+
+/// Returns @p text encoded in UTF-16LE with a byte order mark.
+std::string make_utf16(std::string_view text);
+
+/// Returns @p bits compressed in the gzip format.
+std::string gzip(std::string_view bits);
+
+/// Wraps each of the specified images in a RecordIO record with an
+/// MXNet image header.
+std::string make_recordio_images(const std::vector<std::string> &images);
+
+/// Copies @p bits into a memory block allocated by the library.
+mlio::Memory_slice to_memory(std::string_view bits);
+
+/// Returns a dataset of @p num_stores in-memory data stores that each
+/// hold a copy of @p bits.
+std::vector<mlio::Intrusive_ptr<mlio::Data_store>>
+make_dataset(std::string_view bits, std::size_t num_stores = 1);
+
+}  // namespace mlio_bench
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2019-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You
+ * may not use this file except in compliance with the License. A copy of
+ * the License is located at
+ *
+ *      http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+ * ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <mlio.h>
+
+namespace mlio_bench {
+
+// The end-to-end benchmarks split each dataset into several data stores
+// so that the reader can interleave their reads.
+inline constexpr std::size_t num_stores = 4;
+
+inline constexpr std::size_t batch_size = 256;
+
+/// Registers the thread counts 1, 2, 4, ... up to the number of
+/// hardware threads as the arguments of the specified benchmark.
+inline void apply_thread_counts(benchmark::internal::Benchmark *bench)
+{
+    std::size_t max_num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    for (std::size_t i = 1; i <= max_num_threads; i <<= 1U) {
+        bench->Arg(static_cast<std::int64_t>(i));
+    }
+}
+
+/// Reads one epoch from @p reader per benchmark iteration and reports
+/// the number of examples read per second, and the allocations made per
+/// batch in one more epoch read with the allocation audit running.
+void read_epochs(benchmark::State &state, mlio::Data_reader &reader, std::size_t num_bytes);
+
+/// Returns reader parameters for the end-to-end benchmarks whose number
+/// of parallel reads is the first argument of @p state.
+mlio::Data_reader_params make_params(const benchmark::State &state, std::string_view bits);
+
+}  // namespace mlio_bench
@@ -0,0 +1,349 @@
+#!/usr/bin/env python3
+"""
+Measures the end-to-end throughput of the data readers on synthetic
+datasets that are made by repeating the fixtures in tests/resources up to
+the requested size.
+
+Each reader is run in a fresh process for every combination of batch
+size, number of parallel reads, shuffling, and compression so that the
+peak RSS of a run is not inflated by the previous ones. The results are
+written as JSON so that the numbers of two releases can be compared:
+
+    $ python3 tests/mlio-py-bench/bench_throughput.py --size-gb 4 \\
+          --output mlio-1.2.json
+
+The generated datasets are kept in the work directory and reused by the
+later runs of the same size.
+"""
+
+import argparse
+import gzip
+import itertools
+import json
+import multiprocessing
+import os
+import platform
+import resource
+import sys
+import time
+
+import mlio
+
+resources_dir = os.path.join(
+    os.path.dirname(os.path.realpath(__file__)), '../resources')
+
+_block_size = 0x400000  # 4 MiB
+
+
+class Fixture:
+    """
+    Describes how a fixture is scaled into a dataset and read back.
+    """
+
+    def __init__(self, path, make_reader, has_header=False):
+        self.path = os.path.join(resources_dir, path)
+        self.make_reader = make_reader
+        self.has_header = has_header
+
+    def split(self):
+        with open(self.path, 'rb') as f:
+            bits = f.read()
+
+        header = b''
+        if self.has_header:
+            pos = bits.index(b'\n') + 1
+
+            header, bits = bits[:pos], bits[pos:]
+
+        # The body gets repeated; make sure that the last record of a copy
+        # does not run into the first record of the next one.
+        if self.has_header or self.path.endswith('.txt'):
+            if not bits.endswith(b'\n'):
+                bits += b'\n'
+
+        return header, bits
+
+
+def _make_image_reader(prm):
+    img_prm = mlio.ImageReaderParams(image_frame=mlio.ImageFrame.RECORDIO,
+                                     resize=100,
+                                     image_dimensions=[3, 100, 100],
+                                     to_rgb=1)
+
+    return mlio.ImageReader(prm, img_prm)
+
+
+fixtures = {
+    'csv': Fixture('test.csv', mlio.CsvReader, has_header=True),
+    'recordio_protobuf': Fixture('test.pbr', mlio.RecordIOProtobufReader),
+    'image': Fixture('images/test_image_0.rec', _make_image_reader),
+    'text_line': Fixture('test.txt', mlio.TextLineReader),
+}
+
+
+def _write_dataset_file(path, fixture, num_bytes, compression):
+    header, body = fixture.split()
+
+    # Repeat the body into a larger block to keep the number of writes
+    # low; the block only holds whole copies of the body.
+    block = body * max(1, _block_size // len(body))
+
+    tmp_path = path + '.tmp'
+
+    open_file = gzip.open if compression == 'gzip' else open
+
+    kwargs = {'compresslevel': 1} if compression == 'gzip' else {}
+
+    with open_file(tmp_path, 'wb', **kwargs) as f:
+        f.write(header)
+
+        size = len(header)
+        while size < num_bytes:
+            num_copies = min(len(block), num_bytes - size) // len(body)
+            if num_copies == 0:
+                num_copies = 1
+
+            f.write(block[:num_copies * len(body)])
+
+            size += num_copies * len(body)
+
+    os.replace(tmp_path, path)
+
+    return size
+
+
+def make_dataset(work_dir, name, size_gb, num_files, compression):
+    """
+    Returns the paths of the files of the specified dataset and its
+    uncompressed size; generates the files if they do not exist yet.
+    """
+    fixture = fixtures[name]
+
+    num_bytes = int(size_gb * 2**30) // num_files
+
+    ext = '.gz' if compression == 'gzip' else ''
+
+    paths = []
+
+    total_size = 0
+    for i in range(num_files):
+        path = os.path.join(
+            work_dir,
+            '{}-{}gb-{}of{}{}{}'.format(name, size_gb, i + 1, num_files,
+                                        os.path.splitext(fixture.path)[1], ext))
+
+        size_path = path + '.size'
+
+        if os.path.exists(path) and os.path.exists(size_path):
+            with open(size_path) as f:
+                size = int(f.read())
+        else:
+            size = _write_dataset_file(path, fixture, num_bytes, compression)
+
+            with open(size_path, 'w') as f:
+                f.write(str(size))
+
+        paths.append(path)
+
+        total_size += size
+
+    return paths, total_size
+
+
+def _run(config, paths, num_bytes, queue):
+    fixture = fixtures[config['reader']]
+
+    compression = mlio.Compression.GZIP \
+        if config['compression'] == 'gzip' else mlio.Compression.NONE
+
+    dataset = [mlio.File(path, compression=compression) for path in paths]
+
+    prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=config['batch_size'],
+        num_parallel_reads=config['num_parallel_reads'],
+        shuffle_instances=config['shuffle'],
+        shuffle_window=config['shuffle_window'])
+
+    reader = fixture.make_reader(prm)
+
+    start_usage = resource.getrusage(resource.RUSAGE_SELF)
+    start_time = time.perf_counter()
+
+    num_examples = 0
+    num_instances = 0
+    for _ in range(config['epochs']):
+        while reader.read_example() is not None:
+            num_examples += 1
+
+        num_instances += reader.stats().num_instances
+
+        reader.reset()
+
+    seconds = time.perf_counter() - start_time
+
+    end_usage = resource.getrusage(resource.RUSAGE_SELF)
+
+    cpu_seconds = (end_usage.ru_utime - start_usage.ru_utime) + \
+                  (end_usage.ru_stime - start_usage.ru_stime)
+
+    num_gb = num_bytes * config['epochs'] / 2**30
+
+    # The maximum resident set size is in kilobytes on Linux, but in
+    # bytes on macOS.
+    peak_rss = end_usage.ru_maxrss
+    if sys.platform != 'darwin':
+        peak_rss *= 1024
+
+    queue.put(dict(config,
+                   dataset_bytes=num_bytes,
+                   num_examples=num_examples,
+                   num_instances=num_instances,
+                   seconds=seconds,
+                   examples_per_second=num_examples / seconds,
+                   instances_per_second=num_instances / seconds,
+                   mb_per_second=num_bytes * config['epochs'] / 2**20 / seconds,
+                   cpu_seconds=cpu_seconds,
+                   cpu_seconds_per_gb=cpu_seconds / num_gb,
+                   peak_rss_mb=peak_rss / 2**20))
+
+
+def run_config(config, paths, num_bytes):
+    """
+    Runs the specified configuration in a fresh process.
+    """
+    ctx = multiprocessing.get_context('spawn')
+
+    queue = ctx.Queue()
+
+    proc = ctx.Process(target=_run, args=(config, paths, num_bytes, queue))
+    proc.start()
+
+    # Read the result before joining; a full queue would otherwise keep
+    # the process from exiting.
+    try:
+        result = queue.get()
+    finally:
+        proc.join()
+
+    if proc.exitcode != 0:
+        raise RuntimeError(
+            'The run {} has failed with exit code {}.'.format(
+                config, proc.exitcode))
+
+    return result
+
+
+def _parse_list(convert):
+    def parse(s):
+        return [convert(v) for v in s.split(',')]
+
+    return parse
+
+
+def _parse_bool(s):
+    if s in ('on', 'true', '1'):
+        return True
+    if s in ('off', 'false', '0'):
+        return False
+
+    raise argparse.ArgumentTypeError('{} is not a boolean value.'.format(s))
+
+
+def parse_args(args):
+    parser = argparse.ArgumentParser(
+        description='Measures the end-to-end throughput of the data readers.')
+
+    parser.add_argument('--readers', type=_parse_list(str),
+                        default=list(fixtures),
+                        help='The readers to run; any of {}.'.format(
+                            ', '.join(fixtures)))
+    parser.add_argument('--size-gb', type=float, default=1.0,
+                        help='The uncompressed size of each dataset.')
+    parser.add_argument('--num-files', type=int, default=4,
+                        help='The number of files to split a dataset into.')
+    parser.add_argument('--batch-sizes', type=_parse_list(int),
+                        default=[64, 1024])
+    parser.add_argument('--num-parallel-reads', type=_parse_list(int),
+                        default=[1, 0],
+                        help='Zero means the number of CPUs.')
+    parser.add_argument('--shuffle', type=_parse_list(_parse_bool),
+                        default=[False, True])
+    parser.add_argument('--shuffle-window', type=int, default=10000)
+    parser.add_argument('--compression', type=_parse_list(str),
+                        default=['none', 'gzip'],
+                        help='Any of none, gzip.')
+    parser.add_argument('--epochs', type=int, default=1)
+    parser.add_argument('--work-dir', default='mlio-bench-data',
+                        help='The directory of the generated datasets.')
+    parser.add_argument('--output', default='-',
+                        help='The JSON file to write; - means stdout.')
+
+    opts = parser.parse_args(args)
+
+    for name in opts.readers:
+        if name not in fixtures:
+            parser.error('{} is not a known reader.'.format(name))
+
+    for compression in opts.compression:
+        if compression not in ('none', 'gzip'):
+            parser.error('{} is not a supported compression.'.format(
+                compression))
+
+    return opts
+
+
+def main(args):
+    opts = parse_args(args)
+
+    os.makedirs(opts.work_dir, exist_ok=True)
+
+    results = []
+
+    for name, compression in itertools.product(opts.readers,
+                                               opts.compression):
+        paths, num_bytes = make_dataset(opts.work_dir, name, opts.size_gb,
+                                        opts.num_files, compression)
+
+        for batch_size, num_parallel_reads, shuffle in itertools.product(
+                opts.batch_sizes, opts.num_parallel_reads, opts.shuffle):
+            config = {
+                'reader': name,
+                'batch_size': batch_size,
+                'num_parallel_reads': num_parallel_reads,
+                'shuffle': shuffle,
+                'shuffle_window': opts.shuffle_window if shuffle else 0,
+                'compression': compression,
+                'epochs': opts.epochs,
+            }
+
+            result = run_config(config, paths, num_bytes)
+
+            print('{reader} batch_size={batch_size} '
+                  'num_parallel_reads={num_parallel_reads} shuffle={shuffle} '
+                  'compression={compression}: {examples_per_second:.1f} '
+                  'examples/s, {mb_per_second:.1f} MB/s'.format(**result),
+                  file=sys.stderr)
+
+            results.append(result)
+
+    report = {
+        'mlio_version': mlio.__version__,
+        'python_version': platform.python_version(),
+        'platform': platform.platform(),
+        'num_cpus': os.cpu_count(),
+        'size_gb': opts.size_gb,
+        'results': results,
+    }
+
+    if opts.output == '-':
+        json.dump(report, sys.stdout, indent=2)
+
+        sys.stdout.write('\n')
+    else:
+        with open(opts.output, 'w') as f:
+            json.dump(report, f, indent=2)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -159,3 +159,423 @@ def test_csv_nonutf_encoding_with_encoding_param():
         feature_np = as_numpy(nonutf_feature)
     except SystemError as err:
         pytest.fail("Unexpected exception thrown")
+
+
+@pytest.mark.parametrize('encoding, data', [
+    ('ISO-8859-1', 'a,b\ncafé,1\nna\xefve,2\n'.encode('latin-1')),
+    (None, '\ufeffa,b\ncafé,1\nna\xefve,2\n'.encode('utf-16-le')),
+    ('UTF-16BE', 'a,b\ncafé,1\nna\xefve,2\n'.encode('utf-16-be')),
+])
+def test_csv_transcoded_encodings(tmpdir, encoding, data):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write_binary(data)
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2)
+    csv_params = mlio.CsvParams(encoding=encoding,
+                                column_types={'a': mlio.DataType.STRING})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+    example = reader.read_example()
+
+    assert as_numpy(example['a']).ravel().tolist() == ['café', 'na\xefve']
+    assert as_numpy(example['b']).ravel().tolist() == [1, 2]
+
+
+def test_csv_bad_instance_stats(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\n1,2\nx,3\n4\n5,y\n6,7\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=5,
+        bad_example_handling=mlio.BadExampleHandling.PAD_WARN,
+        warn_bad_instances=True)
+    csv_params = mlio.CsvParams(default_data_type=mlio.DataType.INT64)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+    assert as_numpy(example['a']).ravel().tolist()[:2] == [1, 6]
+    assert example.padding == 3
+
+    stats = reader.stats()
+    assert stats.num_bad_instances == 3
+    assert stats.num_parse_errors == 2
+    assert stats.num_field_count_errors == 1
+    assert stats.num_corrupt_records == 0
+    assert stats.num_suppressed_warnings == 0
+
+    reader.reset()
+    assert reader.stats().num_parse_errors == 0
+
+
+def test_csv_dictionary_encoded_columns(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('color,size,price\nred,1,2.5\nblue,2,3.5\nred,3,4.5\nred,4,5.5\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2)
+    csv_params = mlio.CsvParams(dictionary_encoded_columns={'color'},
+                                dictionary_encoded_columns_by_index={1})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    schema = reader.read_schema()
+    assert schema.attributes[0].data_type == mlio.DataType.INT32
+    assert schema.attributes[1].data_type == mlio.DataType.INT32
+    assert schema.attributes[2].data_type == mlio.DataType.FLOAT64
+
+    colors = []
+    sizes = []
+    for example in reader:
+        colors += as_numpy(example['color']).ravel().tolist()
+        sizes += as_numpy(example['size']).ravel().tolist()
+
+    dictionary = reader.dictionary('color')
+    assert sorted(dictionary) == ['blue', 'red']
+    assert [dictionary[code] for code in colors] == ['red', 'blue', 'red', 'red']
+    assert [reader.dictionary('size')[code] for code in sizes] == ['1', '2', '3', '4']
+
+    with pytest.raises(ValueError):
+        reader.dictionary('price')
+
+
+def test_csv_dictionary_encoded_columns_unknown_column(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\n1,2\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1)
+    csv_params = mlio.CsvParams(dictionary_encoded_columns={'c'})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    with pytest.raises(ValueError):
+        reader.read_schema()
+
+
+def test_csv_hashed_columns(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\nhello,1\n,2\nhello,3\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=3)
+    csv_params = mlio.CsvParams(hashed_columns={'a'}, num_hash_buckets=1000)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    schema = reader.read_schema()
+    assert schema.attributes[0].data_type == mlio.DataType.INT64
+
+    example = reader.read_example()
+
+    # The 32-bit MurmurHash3 of 'hello' is 613153351 and of '' is 0.
+    assert as_numpy(example['a']).ravel().tolist() == [351, 0, 351]
+    assert as_numpy(example['b']).ravel().tolist() == [1, 2, 3]
+
+
+def test_csv_hashed_columns_zero_buckets(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\nhello,1\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1)
+    csv_params = mlio.CsvParams(hashed_columns_by_index={0}, num_hash_buckets=0)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    with pytest.raises(ValueError):
+        reader.read_schema()
+
+
+def test_csv_use_columns_skips_ignored_fields(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b,c,d\n"x,""y",1,"z",2\n"x",3,z,4\n5,6,7\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=3,
+        bad_example_handling=mlio.BadExampleHandling.PAD)
+    csv_params = mlio.CsvParams(use_columns={'b'},
+                                default_data_type=mlio.DataType.INT64)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+    assert [attr.name for attr in example.schema.attributes] == ['b']
+    assert as_numpy(example['b']).ravel().tolist()[:2] == [1, 3]
+
+    # The last row has fewer columns than expected.
+    assert example.padding == 1
+    assert reader.stats().num_field_count_errors == 1
+
+
+def test_csv_pad_in_large_batch_keeps_row_order(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+
+    # Large enough to be decoded in parallel; the bad rows must be
+    # dropped without reordering the good ones.
+    num_rows = 20000
+    rows = ['x,{0}\n'.format(i) if i % 97 == 0 else '{0},{0}\n'.format(i)
+            for i in range(num_rows)]
+    csv_file.write('a,b\n' + ''.join(rows))
+
+    good = [i for i in range(num_rows) if i % 97 != 0]
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=num_rows,
+        bad_example_handling=mlio.BadExampleHandling.PAD)
+    csv_params = mlio.CsvParams(default_data_type=mlio.DataType.INT64)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+    assert example.padding == num_rows - len(good)
+
+    pad = [0] * example.padding
+    assert as_numpy(example['a']).ravel().tolist() == good + pad
+    assert as_numpy(example['b']).ravel().tolist() == good + pad
+
+
+def test_csv_quoted_new_lines_in_large_chunk(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+
+    # Large enough to be framed in parallel; the quoted new lines and
+    # the carriages must not be mistaken for record boundaries.
+    num_rows = 200000
+    rows = ['{0},"line {0}\n""quoted""\r\nend",{0}\r\n'.format(i)
+            for i in range(num_rows)]
+    csv_file.write('a,b,c\n' + ''.join(rows))
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=num_rows)
+    csv_params = mlio.CsvParams(allow_quoted_new_lines=True,
+                                default_data_type=mlio.DataType.INT64,
+                                column_types={'b': mlio.DataType.STRING})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+    assert example.padding == 0
+
+    assert as_numpy(example['a']).ravel().tolist() == list(range(num_rows))
+    assert as_numpy(example['c']).ravel().tolist() == list(range(num_rows))
+
+    assert reader.read_example() is None
+
+
+def test_csv_half_precision_columns(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\n1.5,1.5\n-0.1,-0.1\n65504,3e38\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=3)
+    csv_params = mlio.CsvParams(column_types={'a': mlio.DataType.FLOAT16,
+                                              'b': mlio.DataType.BFLOAT16})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+
+    a = as_numpy(example['a']).ravel()
+    assert a.dtype == np.float16
+    assert a.tolist() == [1.5, np.float16(-0.1), 65504.0]
+
+    # NumPy has no bfloat16 type; widen the raw bits to float32.
+    b = as_numpy(example['b']).ravel()
+    assert b.dtype == np.uint16
+    b = (b.astype(np.uint32) << 16).view(np.float32)
+    assert b.tolist()[:2] == [1.5, -0.10009765625]
+    assert b[2] == pytest.approx(3e38, rel=1e-2)
+
+
+def test_csv_datetime_columns(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b,c\n'
+                   '2020-03-15T08:30:00.125Z,2020-03-15,15/03/2020 08:30\n'
+                   '2020-03-15 10:30+02:00,1969-12-31,01/01/1970 00:00\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2)
+    csv_params = mlio.CsvParams(column_types={'a': mlio.DataType.TIMESTAMP,
+                                              'b': mlio.DataType.DATE})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+
+    a = as_numpy(example['a']).ravel()
+    assert a.dtype == np.dtype('datetime64[ns]')
+    assert a.tolist() == [1584261000125000000, 1584261000000000000]
+    assert a[0] == np.datetime64('2020-03-15T08:30:00.125')
+
+    b = as_numpy(example['b']).ravel()
+    assert b.dtype == np.dtype('datetime64[ms]')
+    assert list(b.astype('datetime64[D]').astype(str)) == ['2020-03-15',
+                                                           '1969-12-31']
+
+    csv_params = mlio.CsvParams(
+        column_types={'c': mlio.DataType.TIMESTAMP},
+        parser_options=mlio.ParserParams(datetime_format='%d/%m/%Y %H:%M'))
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+
+    c = as_numpy(example['c']).ravel()
+    assert c.tolist() == [1584261000000000000, 0]
+
+    csv_params.parser_options = mlio.ParserParams(datetime_format='%Q')
+
+    with pytest.raises(ValueError):
+        mlio.CsvReader(rdr_prm, csv_params)
+
+
+def test_csv_narrowed_types(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b,c\n1,0.5,x\n-300,1.5,y\n40000,2.5,z\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=3,
+        bad_example_handling=mlio.BadExampleHandling.PAD)
+    csv_params = mlio.CsvParams(
+        narrowed_types={mlio.DataType.INT64: mlio.DataType.INT16,
+                        mlio.DataType.FLOAT64: mlio.DataType.FLOAT32})
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    schema = reader.read_schema()
+    assert [attr.data_type for attr in schema.attributes] == [
+        mlio.DataType.INT16, mlio.DataType.FLOAT32, mlio.DataType.STRING]
+
+    example = reader.read_example()
+    assert as_numpy(example['a']).ravel().tolist()[:2] == [1, -300]
+    assert as_numpy(example['b']).ravel().tolist()[:2] == [0.5, 1.5]
+
+    # 40000 does not fit into int16.
+    assert example.padding == 1
+
+    stats = reader.stats()
+    assert stats.num_overflows == 1
+    assert stats.num_parse_errors == 0
+
+
+def test_csv_map_columns_by_header(tmpdir):
+    csv_file1 = tmpdir.join("test1.csv")
+    csv_file1.write('a,b,c\n1,2,x\n')
+
+    # Reordered columns; 'b' is missing and 'd' is not in the schema.
+    csv_file2 = tmpdir.join("test2.csv")
+    csv_file2.write('c,a,d\ny,3,9\n')
+
+    dataset = [mlio.File(str(csv_file1)), mlio.File(str(csv_file2))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2)
+    csv_params = mlio.CsvParams(map_columns_by_header=True,
+                                default_data_type=mlio.DataType.STRING)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    example = reader.read_example()
+    assert [attr.name for attr in example.schema.attributes] == ['a', 'b', 'c']
+    assert example.padding == 0
+
+    assert as_numpy(example['a']).ravel().tolist() == ['1', '3']
+    assert as_numpy(example['b']).ravel().tolist() == ['2', '']
+    assert as_numpy(example['c']).ravel().tolist() == ['x', 'y']
+
+
+def test_csv_map_columns_by_header_single_header(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\n1,2\n')
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1)
+    csv_params = mlio.CsvParams(map_columns_by_header=True,
+                                has_single_header=True)
+
+    with pytest.raises(ValueError):
+        mlio.CsvReader(rdr_prm, csv_params)
+
+
+def test_csv_row_filters(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('label,date,x\n'
+                   '1,2020-01-02,a\n'
+                   '-1,2020-01-03,b\n'
+                   '0,2019-12-31,c\n'
+                   '1,2020-02-01,d\n'
+                   '-1,2020-02-02,e\n'
+                   '0,2020-03-01,f\n'
+                   '2,2020-04-01,g\n')
+
+    filters = [mlio.RowFilter('label', mlio.FilterOp.NOT_EQUAL, '-1'),
+               mlio.RowFilter('date', mlio.FilterOp.GREATER_EQUAL, '2020-01-01')]
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2,
+                                    row_filters=filters)
+    csv_params = mlio.CsvParams(default_data_type=mlio.DataType.STRING)
+
+    reader = mlio.CsvReader(rdr_prm, csv_params)
+
+    examples = list(reader)
+    assert len(examples) == 2
+    for example in examples:
+        assert example.padding == 0
+
+    values = [v for e in examples for v in as_numpy(e['x']).ravel().tolist()]
+    assert values == ['a', 'd', 'f', 'g']
+
+    assert reader.stats().num_filtered_instances == 3
+
+
+def test_csv_class_sampling(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('label,x\n' + ''.join(
+        '{},{}\n'.format(1 if i % 10 == 0 else 0, i) for i in range(2000)))
+
+    def read_labels(seed):
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(csv_file))],
+                                        batch_size=100,
+                                        class_column='label',
+                                        class_sample_ratios={'0': 0.1},
+                                        sample_seed=seed)
+
+        reader = mlio.CsvReader(rdr_prm)
+
+        labels = [v for e in reader for v in as_numpy(e['label']).ravel().tolist()]
+
+        assert reader.stats().num_filtered_instances == 2000 - len(labels)
+
+        return labels
+
+    labels = read_labels(seed=4)
+
+    # All 200 positives are kept and roughly 180 of the 1800 negatives.
+    assert labels.count(1) == 200
+    assert 120 < labels.count(0) < 240
+
+    assert read_labels(seed=4) == labels
+
+
+def test_csv_row_filters_unknown_column(tmpdir):
+    csv_file = tmpdir.join("test.csv")
+    csv_file.write('a,b\n1,2\n')
+
+    filters = [mlio.RowFilter('c', mlio.FilterOp.EQUAL, '1')]
+
+    dataset = [mlio.File(str(csv_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1,
+                                    row_filters=filters)
+
+    reader = mlio.CsvReader(rdr_prm)
+
+    with pytest.raises(ValueError):
+        reader.read_example()
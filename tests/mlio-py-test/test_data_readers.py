@@ -1,6 +1,17 @@
+import hashlib
+import io
+import json
 import os
+import pickle
+import struct
+import threading
+import zlib
+
+import numpy as np
+import pytest
 
 import mlio
+from mlio.integ.dlpack import iter_dlpack
 from mlio.integ.numpy import as_numpy
 
 resources_dir = os.path.join(
@@ -19,3 +30,1938 @@ def test_text_line_reader_params():
     record = [as_numpy(feature) for feature in example]
 
     assert record[0] == expected_string
+
+
+def test_materialized_epochs(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b''.join(b'line %d\n' % i for i in range(100)))
+
+    def read_lines(reader):
+        lines = []
+        for example in reader:
+            lines.extend(as_numpy(example[0]).ravel().tolist())
+        reader.reset()
+        return lines
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(txt_file))],
+                                    batch_size=8,
+                                    shuffle_instances=True,
+                                    shuffle_window=10,
+                                    shuffle_seed=3,
+                                    materialize_memory_budget=0x10000)
+
+    reader = mlio.TextLineReader(rdr_prm)
+
+    first = read_lines(reader)
+
+    # The later epochs are served from memory.
+    txt_file.remove()
+
+    second = read_lines(reader)
+
+    assert sorted(second) == sorted(first)
+    assert second != first
+
+    # A dataset that does not fit into the budget is streamed.
+    txt_file.write_binary(b'a\nb\n')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(txt_file))],
+                                    batch_size=8,
+                                    materialize_memory_budget=1)
+
+    reader = mlio.TextLineReader(rdr_prm)
+
+    assert read_lines(reader) == ['a', 'b']
+
+    txt_file.write_binary(b'c\n')
+
+    assert read_lines(reader) == ['c']
+
+
+def test_text_line_reader_line_ends(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b'a\nbb\r\nccc\rdddd\r\n\neeeee')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=6)
+
+    reader = mlio.TextLineReader(rdr_prm, validate_utf8=True)
+    example = reader.read_example()
+
+    lines = as_numpy(example['value']).ravel().tolist()
+    assert lines == ['a', 'bb', 'ccc', 'dddd', '', 'eeeee']
+
+
+def test_text_line_reader_pack_lines(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b'ab\n\ncde\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=4,
+        last_example_handling=mlio.LastExampleHandling.PAD)
+
+    reader = mlio.TextLineReader(rdr_prm, pack_lines=True)
+    example = reader.read_example()
+
+    assert example.padding == 1
+    assert as_numpy(example['value']).tobytes() == b'abcde'
+    assert as_numpy(example['value_offsets']).tolist() == [0, 2, 2, 5, 5]
+
+
+def test_text_line_reader_arena_strings(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b'ab\n\ncde\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=4,
+        last_example_handling=mlio.LastExampleHandling.PAD)
+
+    reader = mlio.TextLineReader(rdr_prm, arena_strings=True)
+    example = reader.read_example()
+
+    tensor = example['value']
+    assert isinstance(tensor, mlio.StringTensor)
+    assert tensor.shape == (4, 1)
+    assert example.padding == 1
+    assert [tensor[i] for i in range(len(tensor))] == ['ab', '', 'cde', '']
+    assert as_numpy(tensor).ravel().tolist() == ['ab', '', 'cde', '']
+
+
+def test_text_line_reader_max_batch_bytes(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b'aaaa\nbb\ncc\ndddddd\ne\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=8,
+        max_batch_bytes=4,
+        last_example_handling=mlio.LastExampleHandling.DROP)
+
+    reader = mlio.TextLineReader(rdr_prm)
+
+    batches = []
+    for example in reader:
+        batches.append(as_numpy(example['value']).ravel().tolist())
+
+    assert batches == [['aaaa'], ['bb', 'cc'], ['dddddd']]
+
+
+def test_text_line_reader_size_bucketing(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b'a\n' + b'b' * 32 + b'\nc\n' + b'd' * 32 + b'\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2,
+                                    size_bucketing_lookahead=4)
+
+    reader = mlio.TextLineReader(rdr_prm)
+
+    batches = []
+    for example in reader:
+        batches.append(as_numpy(example['value']).ravel().tolist())
+
+    assert batches == [['a', 'c'], ['b' * 32, 'd' * 32]]
+
+
+def test_text_line_reader_wordpiece(tmpdir):
+    vocab_file = tmpdir.join("vocab.txt")
+    vocab_file.write('[PAD]\n[UNK]\n[CLS]\n[SEP]\nhello\nworld\n,\nun\n##aff\n')
+
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write('Hello, world!\nunaff\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=3,
+        last_example_handling=mlio.LastExampleHandling.PAD)
+    wordpiece = mlio.WordpieceParams(str(vocab_file), max_sequence_length=6)
+
+    reader = mlio.TextLineReader(rdr_prm, wordpiece=wordpiece)
+    example = reader.read_example()
+
+    # "!" is not in the vocabulary.
+    assert as_numpy(example['input_ids']).tolist() == [
+        [2, 4, 6, 5, 1, 3], [2, 7, 8, 3, 0, 0], [0] * 6]
+    assert as_numpy(example['attention_mask']).tolist() == [
+        [1, 1, 1, 1, 1, 1], [1, 1, 1, 1, 0, 0], [0] * 6]
+    assert example.padding == 1
+
+
+def test_text_line_reader_wordpiece_packs_sequences(tmpdir):
+    vocab_file = tmpdir.join("vocab.txt")
+    vocab_file.write('[PAD]\n[UNK]\n[CLS]\n[SEP]\na\nb\n')
+
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write('a\nb\na b\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=3)
+    wordpiece = mlio.WordpieceParams(str(vocab_file),
+                                     max_sequence_length=6,
+                                     pack_sequences=True)
+
+    reader = mlio.TextLineReader(rdr_prm, wordpiece=wordpiece)
+    example = reader.read_example()
+
+    assert as_numpy(example['input_ids']).tolist() == [
+        [2, 4, 3, 2, 5, 3], [2, 4, 5, 3, 0, 0], [0] * 6]
+    assert as_numpy(example['attention_mask']).tolist() == [
+        [1, 1, 1, 2, 2, 2], [1, 1, 1, 1, 0, 0], [0] * 6]
+    assert example.padding == 1
+
+
+def test_text_line_reader_invalid_utf8(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write_binary(b'caf\xc3\xa9\nab\xc3\n')
+
+    dataset = [mlio.File(str(txt_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2)
+
+    reader = mlio.TextLineReader(rdr_prm, validate_utf8=True)
+    with pytest.raises(mlio.CorruptRecordError):
+        reader.read_example()
+
+
+def test_json_lines_reader(tmpdir):
+    from mlio.integ.scipy import to_coo_matrix
+
+    json_file = tmpdir.join("test.jsonl")
+    json_file.write_binary(b'{"a": 1, "b": "x\\u00e9", "c": [1.5, 2]}\n'
+                           b'{"c": [], "a": true, "d": {"e": 1}}\n'
+                           b'{"a": null, "b": "y", "c": [3]}\n')
+
+    dataset = [mlio.File(str(json_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=3)
+
+    reader = mlio.JsonLinesReader(rdr_prm)
+
+    attrs = reader.read_schema().attributes
+    assert [a.name for a in attrs] == ['a', 'b', 'c']
+    assert [a.data_type for a in attrs] == \
+        [mlio.DataType.INT64, mlio.DataType.STRING, mlio.DataType.FLOAT64]
+    assert attrs[2].sparse
+
+    example = reader.read_example()
+    assert as_numpy(example['a']).ravel().tolist() == [1, 1, 0]
+    assert as_numpy(example['b']).ravel().tolist() == ['x\u00e9', '', 'y']
+
+    mtx = to_coo_matrix(example['c']).toarray()
+    assert mtx.tolist() == [[1.5, 2.0], [0.0, 0.0], [3.0, 0.0]]
+
+
+def test_json_lines_reader_bad_instance(tmpdir):
+    json_file = tmpdir.join("test.jsonl")
+    json_file.write_binary(b'{"a": 1, "b": [1]}\n'
+                           b'{"a": 2, "b": [1, 2]\n'
+                           b'{"a": 3, "b": [1, 2, 3]}\n')
+
+    dataset = [mlio.File(str(json_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=3,
+        bad_example_handling=mlio.BadExampleHandling.PAD)
+
+    json_prm = mlio.JsonLinesParams(array_lengths={'b': 2})
+
+    reader = mlio.JsonLinesReader(rdr_prm, json_prm)
+
+    example = reader.read_example()
+    assert example.padding == 2
+    assert as_numpy(example['a']).ravel().tolist() == [1, 0, 0]
+
+
+def test_libsvm_reader(tmpdir):
+    from mlio.integ.scipy import to_csr_matrix
+
+    svm_file = tmpdir.join("test.svm")
+    svm_file.write_binary(b'1 1:0.5 3:2\n'
+                          b'-1 qid:4 2:1.5  # comment\n'
+                          b'0\n'
+                          b'x 1:1\n'
+                          b'2 9:0.25\n')
+
+    dataset = [mlio.File(str(svm_file))]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=5,
+        sparse_tensor_format=mlio.SparseTensorFormat.CSR,
+        bad_example_handling=mlio.BadExampleHandling.PAD)
+
+    reader = mlio.LibsvmReader(rdr_prm)
+
+    attrs = reader.read_schema().attributes
+    assert [a.name for a in attrs] == ['label', 'values']
+    assert list(attrs[1].shape) == [5, 9]
+
+    example = reader.read_example()
+    assert example.padding == 1
+    assert as_numpy(example['label']).ravel().tolist() == [1.0, -1.0, 0.0, 2.0, 0.0]
+
+    mtx = to_csr_matrix(example['values']).toarray()
+    assert mtx.sum() == 4.25
+    assert mtx[0, 0] == 0.5 and mtx[0, 2] == 2.0
+    assert mtx[1, 1] == 1.5
+    assert mtx[3, 8] == 0.25
+
+
+@pytest.mark.parametrize('sparse_tensor_format', [mlio.SparseTensorFormat.COO,
+                                                  mlio.SparseTensorFormat.CSR])
+def test_sparse_tensors_with_tensor_pool(tmpdir, sparse_tensor_format):
+    from mlio.integ.scipy import to_coo_matrix, to_csr_matrix
+
+    to_matrix = to_csr_matrix
+    if sparse_tensor_format == mlio.SparseTensorFormat.COO:
+        to_matrix = to_coo_matrix
+
+    svm_file = tmpdir.join("test.svm")
+    svm_file.write_binary(b'1 1:0.5 3:2\n'
+                          b'0 2:1.5\n'
+                          b'2 1:0.25 2:1 3:4\n'
+                          b'1 3:3\n'
+                          b'0 1:1\n')
+
+    def read_epochs(tensor_pool_size):
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(svm_file))],
+                                        batch_size=2,
+                                        sparse_tensor_format=sparse_tensor_format,
+                                        tensor_pool_size=tensor_pool_size)
+        reader = mlio.LibsvmReader(rdr_prm)
+
+        epochs = []
+        for _ in range(2):
+            epochs.append([to_matrix(example['values']).toarray().tolist()
+                           for example in reader])
+            reader.reset()
+        return epochs
+
+    # The sparse tensors of the second epoch reuse the pooled buffers of
+    # the first one.
+    expected = read_epochs(0)
+    assert read_epochs(1024 * 1024) == expected
+    assert expected[0] == expected[1]
+
+
+def _crc32c(data):
+    crc = 0xffffffff
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0x82f63b78 if crc & 1 else 0)
+    crc ^= 0xffffffff
+    return ((((crc >> 15) | (crc << 17)) & 0xffffffff) + 0xa282ead8) & 0xffffffff
+
+
+def _pb_varint(value):
+    bits = b''
+    while value >= 0x80:
+        bits += bytes([(value & 0x7f) | 0x80])
+        value >>= 7
+    return bits + bytes([value])
+
+
+def _pb_field(num, payload):
+    return _pb_varint(num << 3 | 2) + _pb_varint(len(payload)) + payload
+
+
+def _tf_example(features):
+    entries = b''
+    for name, values in features.items():
+        if isinstance(values[0], float):
+            lst = _pb_field(2, _pb_field(1, struct.pack('<%df' % len(values), *values)))
+        elif isinstance(values[0], int):
+            lst = _pb_field(3, _pb_field(1, b''.join(_pb_varint(v) for v in values)))
+        else:
+            lst = _pb_field(1, b''.join(_pb_field(1, v) for v in values))
+        entries += _pb_field(1, _pb_field(1, name.encode()) + _pb_field(2, lst))
+    return _pb_field(1, entries)
+
+
+def _tfrecord(messages):
+    bits = b''
+    for msg in messages:
+        length = struct.pack('<Q', len(msg))
+        bits += length + struct.pack('<I', _crc32c(length))
+        bits += msg + struct.pack('<I', _crc32c(msg))
+    return bits
+
+
+def test_tf_example_reader(tmpdir):
+    from mlio.integ.scipy import to_coo_matrix
+
+    tf_file = tmpdir.join("test.tfrecord")
+    tf_file.write_binary(_tfrecord([
+        _tf_example({'x': [1.0, 2.0], 'id': [7], 'tags': [b'a', b'b']}),
+        _tf_example({'id': [8], 'x': [3.0, 4.0]}),
+    ]))
+
+    dataset = [mlio.File(str(tf_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=2)
+
+    tf_prm = mlio.TfExampleParams(sparse_features={'tags': 3})
+
+    reader = mlio.TfExampleReader(rdr_prm, tf_prm)
+
+    attrs = reader.read_schema().attributes
+    assert [a.name for a in attrs] == ['x', 'id', 'tags']
+    assert [a.data_type for a in attrs] == \
+        [mlio.DataType.FLOAT32, mlio.DataType.INT64, mlio.DataType.STRING]
+    assert attrs[2].sparse
+
+    example = reader.read_example()
+    assert as_numpy(example['x']).tolist() == [[1.0, 2.0], [3.0, 4.0]]
+    assert as_numpy(example['id']).ravel().tolist() == [7, 8]
+    assert to_coo_matrix(example['tags']).nnz == 2
+
+
+def test_tf_example_reader_corrupt_checksum(tmpdir):
+    bits = bytearray(_tfrecord([_tf_example({'x': [1.0]})]))
+    bits[-5] ^= 0xff
+
+    tf_file = tmpdir.join("test.tfrecord")
+    tf_file.write_binary(bytes(bits))
+
+    dataset = [mlio.File(str(tf_file))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1)
+
+    reader = mlio.TfExampleReader(rdr_prm)
+    with pytest.raises(mlio.CorruptRecordError):
+        reader.read_example()
+
+    tf_prm = mlio.TfExampleParams(verify_checksums=False)
+
+    reader = mlio.TfExampleReader(rdr_prm, tf_prm)
+    assert reader.read_example() is not None
+
+
+def _avro_long(value):
+    return _pb_varint(((value << 1) ^ (value >> 63)) & 0xffffffffffffffff)
+
+
+def _avro_bytes(data):
+    return _avro_long(len(data)) + data
+
+
+def _avro_file(schema, blocks, codec=b'deflate'):
+    sync = bytes(range(16))
+
+    meta = {b'avro.schema': json.dumps(schema).encode(), b'avro.codec': codec}
+
+    bits = b'Obj\x01' + _avro_long(len(meta))
+    for key, value in meta.items():
+        bits += _avro_bytes(key) + _avro_bytes(value)
+    bits += _avro_long(0) + sync
+
+    for objects in blocks:
+        data = b''.join(objects)
+        if codec == b'deflate':
+            compressor = zlib.compressobj(wbits=-15)
+            data = compressor.compress(data) + compressor.flush()
+        bits += _avro_long(len(objects)) + _avro_long(len(data)) + data + sync
+
+    return bits
+
+
+def test_avro_reader(tmpdir):
+    schema = {'type': 'record', 'name': 'Row', 'fields': [
+        {'name': 'id', 'type': 'long'},
+        {'name': 'score', 'type': ['null', 'double']},
+        {'name': 'tags', 'type': {'type': 'array', 'items': 'string'}},
+        {'name': 'color', 'type': {'type': 'enum', 'name': 'Color',
+                                   'symbols': ['RED', 'GREEN']}}]}
+
+    def row(id, score, tags, color):
+        bits = _avro_long(id)
+        if score is None:
+            bits += _avro_long(0)
+        else:
+            bits += _avro_long(1) + struct.pack('<d', score)
+        if tags:
+            bits += _avro_long(len(tags)) + b''.join(_avro_bytes(t) for t in tags)
+        return bits + _avro_long(0) + _avro_long(color)
+
+    avro_file = tmpdir.join("test.avro")
+    avro_file.write_binary(_avro_file(schema, [
+        [row(1, 0.5, [b'a', b'b'], 0), row(-2, None, [], 1)],
+        [row(300, 2.0, [b'c'], 1)]]))
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(avro_file))],
+                                    batch_size=2)
+
+    reader = mlio.AvroReader(rdr_prm)
+
+    attrs = reader.read_schema().attributes
+    assert [a.name for a in attrs] == ['id', 'score', 'color']
+
+    example = reader.read_example()
+    assert as_numpy(example['id']).ravel().tolist() == [1, -2, 300]
+
+    score = as_numpy(example['score']).ravel()
+    assert score[0] == 0.5 and score[2] == 2.0
+    assert score[1] != score[1]
+
+    assert as_numpy(example['color']).ravel().tolist() == ['RED', 'GREEN', 'GREEN']
+
+    avro_prm = mlio.AvroReaderParams(use_columns={'tags'})
+    with pytest.raises(mlio.NotSupportedError):
+        mlio.AvroReader(rdr_prm, avro_prm).read_example()
+
+
+def test_iter_dlpack():
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2)
+
+    reader = mlio.CsvReader(rdr_prm)
+    schema = reader.read_schema()
+    names = [attr.name for attr in schema.attributes]
+
+    num_examples = 0
+    for capsules in iter_dlpack(reader):
+        assert list(capsules.keys()) == names
+        num_examples += 1
+
+    reader.reset()
+    assert num_examples == sum(1 for _ in reader)
+
+    reader.reset()
+    with pytest.raises(ValueError):
+        next(iter_dlpack(reader, features=['unknown']))
+
+
+def test_reader_stats():
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2)
+
+    reader = mlio.CsvReader(rdr_prm)
+
+    num_examples = sum(1 for _ in reader)
+
+    stats = reader.stats()
+    assert stats.num_examples == num_examples
+    assert stats.decode.num_calls == num_examples
+    assert stats.decode.window_num_calls == num_examples
+    assert stats.num_queued_examples == 0
+    assert [store.id for store in stats.stores] == [dataset[0].id]
+    assert stats.stores[0].num_bytes_read > 0
+    assert stats.stores[0].num_records > 0
+    assert stats.stores[0].num_record_bytes >= stats.stores[0].num_bytes_read
+    assert stats.stores[0].num_opens >= 1
+    assert stats.stores[0].read_ns > 0
+    assert stats.stores[0].bytes_per_second > 0
+
+    stats = reader.stats()
+    assert stats.decode.num_calls == num_examples
+    assert stats.decode.window_num_calls == 0
+
+    reader.reset()
+    assert reader.stats().num_examples == 0
+
+
+def test_decode_buffer():
+    filename = os.path.join(resources_dir, 'test.csv')
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=2)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.INT64)
+
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+
+    example = reader.decode_buffer(b'1,2,3,4\n5,6,7,8\n9,10,11,12\n')
+    assert as_numpy(example[0]).ravel().tolist() == [1, 5, 9]
+
+    assert reader.decode_buffer(b'') is None
+
+    # The pipeline of the reader is not affected.
+    assert sum(1 for _ in reader) > 0
+
+
+def test_sync_decoder():
+    rdr_prm = mlio.DataReaderParams(dataset=[],
+                                    batch_size=1,
+                                    tensor_pool_size=1024 * 1024)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.INT64)
+
+    decoder = mlio.SyncDecoder(mlio.CsvReader(rdr_prm, csv_prm))
+    assert decoder.schema is None
+
+    example = decoder.decode(b'1,2\n3,4\n')
+    assert as_numpy(example[1]).ravel().tolist() == [2, 4]
+    assert [attr.name for attr in decoder.schema.attributes] == \
+        [attr.name for attr in example.schema.attributes]
+
+    example = decoder.decode(b'5,6\n')
+    assert as_numpy(example[0]).ravel().tolist() == [5]
+
+
+@pytest.mark.parametrize('example_queue_handling', [mlio.ExampleQueueHandling.LOCKED,
+                                                    mlio.ExampleQueueHandling.LOCK_FREE])
+def test_memory_budget(tmpdir, example_queue_handling):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a,b\n')
+        for i in range(1000):
+            f.write('{},{}\n'.format(i, i * 2))
+
+    def make_reader(memory_budget):
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                        batch_size=10,
+                                        num_prefetched_examples=8,
+                                        example_queue_handling=example_queue_handling,
+                                        memory_budget=memory_budget)
+        csv_prm = mlio.CsvParams(default_data_type=mlio.DataType.INT64)
+        return mlio.CsvReader(rdr_prm, csv_prm)
+
+    def read_values(reader):
+        return [as_numpy(example[0]).ravel().tolist() for example in reader]
+
+    # The budget is smaller than a single batch; the reader still makes
+    # progress one batch at a time.
+    reader = make_reader(memory_budget=1)
+
+    assert read_values(reader) == read_values(make_reader(memory_budget=0))
+
+    stats = reader.stats()
+    assert stats.memory_usage == 0
+    assert stats.peak_memory_usage > 0
+
+
+def test_autotune():
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=1,
+                                    num_prefetched_examples=8,
+                                    num_parallel_reads=4,
+                                    autotune=True,
+                                    autotune_memory_budget=1024)
+
+    reader = mlio.CsvReader(rdr_prm)
+
+    expected = mlio.CsvReader(mlio.DataReaderParams(dataset=dataset,
+                                                    batch_size=1))
+
+    for example, expected_example in zip(reader, expected):
+        for a, b in zip(example, expected_example):
+            assert as_numpy(a).tolist() == as_numpy(b).tolist()
+
+    stats = reader.stats()
+    assert 1 <= stats.num_parallel_reads <= 4
+    assert 1 <= stats.num_prefetched_examples <= 8
+
+
+def test_dedicated_task_arena():
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+
+    cpu_affinity = []
+    if hasattr(os, 'sched_getaffinity'):
+        cpu_affinity = sorted(os.sched_getaffinity(0))[:2]
+
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=1,
+                                    num_threads=2,
+                                    cpu_affinity=cpu_affinity)
+
+    reader = mlio.CsvReader(rdr_prm)
+
+    expected = mlio.CsvReader(mlio.DataReaderParams(dataset=dataset,
+                                                    batch_size=1))
+
+    for _ in range(2):
+        for example, expected_example in zip(reader, expected):
+            for a, b in zip(example, expected_example):
+                assert as_numpy(a).tolist() == as_numpy(b).tolist()
+
+        reader.reset()
+        expected.reset()
+
+
+def test_dedicated_io_thread(tmpdir):
+    for i in range(3):
+        tmpdir.join('{}.txt'.format(i)).write(
+            ''.join('{}-{}\n'.format(i, j) for j in range(500)))
+
+    dataset = mlio.list_files(str(tmpdir), pattern='*.txt')
+
+    def read_epoch(reader):
+        return [as_numpy(example['value']).ravel().tolist() for example in reader]
+
+    expected = read_epoch(mlio.TextLineReader(mlio.DataReaderParams(dataset=dataset,
+                                                                    batch_size=7)))
+
+    for pipeline_epochs in [False, True]:
+        rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                        batch_size=7,
+                                        num_parallel_reads=3,
+                                        dedicated_io_thread=True,
+                                        pipeline_epochs=pipeline_epochs)
+
+        reader = mlio.TextLineReader(rdr_prm)
+
+        for _ in range(2):
+            assert read_epoch(reader) == expected
+
+            reader.reset()
+
+        # Reset in the middle of an epoch while the I/O thread reads
+        # ahead.
+        reader.read_example()
+        reader.reset()
+
+        assert read_epoch(reader) == expected
+
+
+def test_deferred_reclamation(tmpdir):
+    tmpdir.join('test.txt').write(''.join('{}\n'.format(i) for i in range(1000)))
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(tmpdir.join('test.txt')))],
+                                    batch_size=10,
+                                    deferred_reclamation=True)
+
+    reader = mlio.TextLineReader(rdr_prm, arena_strings=True)
+
+    # The examples are dropped right away; their tensors are freed in
+    # the background, possibly after the reader is gone.
+    lines = []
+    for example in reader:
+        lines.extend(as_numpy(example['value']).ravel().tolist())
+
+    del reader
+
+    assert lines == [str(i) for i in range(1000)]
+
+
+def test_file_backed_output(tmpdir):
+    tmpdir.join('test.csv').write('a,b\n' + ''.join('{0},{0}\n'.format(i) for i in range(1000)))
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(tmpdir.join('test.csv')))],
+                                    batch_size=1000,
+                                    file_backed_output_directory=str(tmpdir),
+                                    file_backed_output_threshold=0)
+
+    reader = mlio.CsvReader(rdr_prm, mlio.CsvParams(default_data_type=mlio.DataType.INT64))
+
+    example = reader.read_example()
+
+    a = as_numpy(example['a']).ravel()
+    b = as_numpy(example['b']).ravel()
+
+    del example
+    del reader
+
+    # The arrays keep the memory map alive after the example is gone.
+    assert a.tolist() == list(range(1000))
+    assert b.tolist() == list(range(1000))
+
+
+def test_max_batch_latency():
+    filename = os.path.join(resources_dir, 'test.csv')
+
+    def read(**kwargs):
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)] * 3,
+                                        batch_size=4,
+                                        **kwargs)
+        reader = mlio.CsvReader(rdr_prm, mlio.CsvParams(header_row_index=None))
+        return [as_numpy(example[0]).ravel().tolist() for example in reader]
+
+    # A local file fills up the batches well before the deadline.
+    assert read(max_batch_latency_ms=10000) == read()
+
+    with pytest.raises(ValueError):
+        read(max_batch_latency_ms=100, size_bucketing_lookahead=8)
+
+
+def test_start_on_schema():
+    filename = os.path.join(resources_dir, 'test.csv')
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=1,
+                                    start_on_schema=True)
+
+    reader = mlio.CsvReader(rdr_prm, mlio.CsvParams(header_row_index=None))
+
+    assert reader.stats().first_example_ns == 0
+
+    # The pipeline is started by read_schema() already.
+    schema = reader.read_schema()
+    assert schema is not None
+    assert reader.stats().schema_ns > 0
+
+    examples = list(reader)
+    assert len(examples) == 3
+    assert reader.stats().first_example_ns >= reader.stats().schema_ns
+
+
+def test_cpu_affinity_and_numa_node_are_exclusive():
+    filename = os.path.join(resources_dir, 'test.csv')
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=1,
+                                    cpu_affinity=[0],
+                                    numa_node=0)
+
+    with pytest.raises(ValueError):
+        mlio.CsvReader(rdr_prm)
+
+
+def test_thread_pool():
+    filename = os.path.join(resources_dir, 'test.csv')
+    pool = mlio.ThreadPool(2)
+    assert pool.num_threads == 2
+
+    def make_reader(thread_pool):
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                        batch_size=1,
+                                        thread_pool=thread_pool)
+        return mlio.CsvReader(rdr_prm)
+
+    def to_list(example):
+        return [as_numpy(t).tolist() for t in example]
+
+    expected = [to_list(example) for example in make_reader(None)]
+
+    # Two readers sharing the threads of the pool.
+    reader1 = make_reader(pool)
+    reader2 = make_reader(pool)
+    for example in expected:
+        assert to_list(reader1.read_example()) == example
+        assert to_list(reader2.read_example()) == example
+
+    results = []
+    pool.execute(lambda: results.append(1))
+    assert results == [1]
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=1,
+                                    num_threads=2,
+                                    thread_pool=pool)
+    with pytest.raises(ValueError):
+        mlio.CsvReader(rdr_prm)
+
+
+@pytest.mark.parametrize('example_queue_handling', [mlio.ExampleQueueHandling.LOCKED,
+                                                    mlio.ExampleQueueHandling.LOCK_FREE])
+def test_pipeline_epochs(example_queue_handling):
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+
+    def make_reader(pipeline_epochs):
+        rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                        batch_size=1,
+                                        num_prefetched_examples=2,
+                                        example_queue_handling=example_queue_handling,
+                                        shuffle_instances=True,
+                                        shuffle_seed=1,
+                                        pipeline_epochs=pipeline_epochs)
+        return mlio.CsvReader(rdr_prm)
+
+    def read_epoch(reader):
+        epoch = [[as_numpy(t).tolist() for t in example] for example in reader]
+        assert reader.read_example() is None
+        reader.reset()
+        return epoch
+
+    reader = make_reader(pipeline_epochs=True)
+    expected = make_reader(pipeline_epochs=False)
+
+    for _ in range(3):
+        assert read_epoch(reader) == read_epoch(expected)
+
+    # Resetting in the middle of an epoch restarts the pipeline.
+    reader.read_example()
+    reader.reset()
+
+    assert len(read_epoch(reader)) == len(read_epoch(expected))
+
+
+def test_unordered_delivery(tmpdir):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a\n')
+        for i in range(100):
+            f.write('{}\n'.format(i))
+
+    def make_reader(deterministic):
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                        batch_size=3,
+                                        num_parallel_reads=4,
+                                        deterministic=deterministic)
+        csv_prm = mlio.CsvParams(default_data_type=mlio.DataType.INT64)
+        return mlio.CsvReader(rdr_prm, csv_prm)
+
+    def read_values(reader):
+        return [v for example in reader for v in as_numpy(example[0]).ravel().tolist()]
+
+    reader = make_reader(deterministic=False)
+
+    for _ in range(2):
+        assert sorted(read_values(reader)) == list(range(100))
+        reader.reset()
+
+    with pytest.raises(mlio.NotSupportedError):
+        reader.save_state()
+
+
+def test_estimate_num_instances(tmpdir):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a,b\n')
+        for i in range(300000):
+            f.write('{0},{0}\n'.format(i))
+
+    dataset = [mlio.File(filename), mlio.File(filename, num_instances_hint=5)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1)
+
+    reader = mlio.CsvReader(rdr_prm)
+
+    count = reader.estimate_num_instances(exact=True)
+    assert count.exact
+    assert count.num_instances == 300005
+
+    count = reader.estimate_num_instances()
+    assert not count.exact
+    assert abs(count.num_instances - 300005) < 300005 * 0.05
+
+
+def test_csv_reader_lazy_decode(tmpdir):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a,b,c\n')
+        f.write('1,"x""y",3.5\n')
+        f.write('2,z,abc\n')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=2)
+    csv_prm = mlio.CsvParams(column_types={'b': mlio.DataType.STRING},
+                             default_data_type=mlio.DataType.INT64,
+                             lazy_decode=True)
+
+    example = next(iter(mlio.CsvReader(rdr_prm, csv_prm)))
+
+    # The columns are parsed on access; c has unparseable values.
+    assert as_numpy(example['a']).ravel().tolist() == [1, 2]
+    assert as_numpy(example['b']).ravel().tolist() == ['x"y', 'z']
+
+    with pytest.raises(mlio.InvalidInstanceError):
+        example['c']
+
+    with pytest.raises(ValueError):
+        mlio.CsvReader(mlio.DataReaderParams(dataset=[], batch_size=1),
+                       mlio.CsvParams(lazy_decode=True, stack_columns=True))
+
+
+def test_csv_reader_arena_strings(tmpdir):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a,b\n')
+        f.write('1,"x""y"\n')
+        f.write('x,bad\n')
+        f.write('2,z\n')
+
+    rdr_prm = mlio.DataReaderParams(
+        dataset=[mlio.File(filename)],
+        batch_size=3,
+        bad_example_handling=mlio.BadExampleHandling.PAD)
+    csv_prm = mlio.CsvParams(column_types={'a': mlio.DataType.INT64,
+                                           'b': mlio.DataType.STRING},
+                             arena_strings=True)
+
+    example = next(iter(mlio.CsvReader(rdr_prm, csv_prm)))
+
+    # The bad row is compacted out of the string column as well.
+    assert example.padding == 1
+    assert as_numpy(example['a']).ravel().tolist()[:2] == [1, 2]
+
+    tensor = example['b']
+    assert isinstance(tensor, mlio.StringTensor)
+    assert as_numpy(tensor).ravel().tolist() == ['x"y', 'z', '']
+
+
+@pytest.mark.parametrize('in_memory', [True, False])
+def test_caching_data_reader(tmpdir, in_memory):
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.FLOAT32)
+
+    path = '' if in_memory else str(tmpdir.join('test.cache'))
+
+    def make_reader():
+        cache_prm = mlio.CachingParams(path=path,
+                                       batch_size=1)
+        return mlio.CachingDataReader(mlio.CsvReader(rdr_prm, csv_prm), cache_prm)
+
+    def read_epoch(reader):
+        epoch = [[as_numpy(t).tolist() for t in example] for example in reader]
+        reader.reset()
+        return epoch
+
+    reader = make_reader()
+
+    first = read_epoch(reader)
+
+    assert reader.cached
+    assert reader.num_cached_instances == 3
+
+    # The later epochs are read from the cache one instance at a time.
+    second = read_epoch(reader)
+
+    assert len(second) == 3
+    def columns(epoch):
+        return [[row for e in epoch for row in e[i]] for i in range(4)]
+
+    assert columns(first) == columns(second)
+
+    # A new reader picks up the existing cache file.
+    if not in_memory:
+        assert make_reader().cached
+
+
+@pytest.mark.parametrize('distribution', [mlio.SharedMemoryDistribution.SHARD,
+                                          mlio.SharedMemoryDistribution.FIRST_AVAILABLE])
+def test_shared_memory_reader(distribution):
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=1)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.FLOAT32)
+
+    expected = [[as_numpy(t).tolist() for t in example]
+                for example in mlio.CsvReader(rdr_prm, csv_prm)]
+
+    name = 'mlio-test-{}'.format(os.getpid())
+
+    srv_prm = mlio.SharedMemoryServerParams(num_clients=2,
+                                            distribution=distribution)
+
+    with mlio.SharedMemoryReaderServer(mlio.CsvReader(rdr_prm, csv_prm), name, srv_prm):
+        clients = [mlio.SharedMemoryReader(name, client_index=i) for i in range(2)]
+
+        assert clients[0].read_schema() == mlio.CsvReader(rdr_prm, csv_prm).read_schema()
+
+        for _ in range(2):
+            epochs = []
+            for client in clients:
+                epochs.append([[as_numpy(t).tolist() for t in example]
+                               for example in client])
+                client.reset()
+
+            if distribution == mlio.SharedMemoryDistribution.SHARD:
+                assert epochs == [expected[0::2], expected[1::2]]
+            else:
+                assert epochs[0] + epochs[1] == expected
+
+
+def test_data_service_reader():
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.FLOAT32)
+
+    def make_reader(split_index=0, num_splits=1):
+        rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                        batch_size=1,
+                                        shard_index=split_index,
+                                        num_shards=num_splits)
+        return mlio.CsvReader(rdr_prm, csv_prm)
+
+    expected = sorted([as_numpy(t).tolist() for t in example]
+                      for example in make_reader())
+
+    with mlio.DataServiceWorker(make_reader, host='127.0.0.1') as worker:
+        address = '127.0.0.1:{}'.format(worker.port)
+
+        reader = mlio.DataServiceReader(
+            mlio.DataServiceParams(workers=[address, address], num_splits=3))
+
+        assert reader.read_schema() == make_reader().read_schema()
+
+        for _ in range(2):
+            actual = sorted([as_numpy(t).tolist() for t in example]
+                            for example in reader)
+
+            assert actual == expected
+
+            reader.reset()
+
+
+def test_shuffle_spill_directory(tmpdir):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a\n')
+        for i in range(10000):
+            f.write('{}\n'.format(i))
+
+    spill_dir = tmpdir.mkdir('spill')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=100,
+                                    shuffle_instances=True,
+                                    shuffle_seed=7,
+                                    shuffle_spill_directory=str(spill_dir),
+                                    num_shuffle_spill_buckets=4)
+    csv_prm = mlio.CsvParams(default_data_type=mlio.DataType.INT64)
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+
+    epochs = []
+    for _ in range(3):
+        epochs.append([v for example in reader for v in as_numpy(example[0]).ravel().tolist()])
+        reader.reset()
+
+    for epoch in epochs:
+        assert sorted(epoch) == list(range(10000))
+        assert epoch != list(range(10000))
+
+    assert epochs[1] != epochs[2]
+
+    # The bucket files are unlinked right after they are created.
+    assert spill_dir.listdir() == []
+
+
+@pytest.mark.parametrize('shuffle', [False, True])
+def test_save_and_restore_state(tmpdir, shuffle):
+    filename = str(tmpdir.join('test.csv'))
+    with open(filename, 'w') as f:
+        f.write('a,b\n')
+        for i in range(20):
+            f.write('{},{}\n'.format(i, i * 2))
+
+    def make_reader():
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                        batch_size=3,
+                                        shuffle_instances=shuffle,
+                                        shuffle_seed=42)
+        csv_prm = mlio.CsvParams(default_data_type=mlio.DataType.FLOAT32)
+        return mlio.CsvReader(rdr_prm, csv_prm)
+
+    def read_rest(reader):
+        return [as_numpy(example[0]).tolist() for example in reader]
+
+    reader = make_reader()
+
+    reader.read_example()
+    reader.reset()
+
+    head = [as_numpy(reader.read_example()[0]).tolist() for _ in range(2)]
+
+    # The peeked example is not considered read.
+    reader.peek_example()
+
+    state = reader.save_state()
+
+    assert state.epoch == 1
+    assert state.num_examples_read == 2
+    assert state.num_instances_read == 6
+
+    expected = read_rest(reader)
+
+    assert len(head) + len(expected) == 7
+
+    restored = make_reader()
+    restored.restore_state(pickle.loads(pickle.dumps(state)))
+
+    assert read_rest(restored) == expected
+
+
+def test_csv_reader_schema_path(tmpdir):
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=1)
+
+    reader = mlio.CsvReader(rdr_prm)
+
+    path = str(tmpdir.join('test.schema'))
+
+    reader.save_schema(path)
+
+    csv_prm = mlio.CsvParams(schema_path=path,
+                             column_types_by_index={0: mlio.DataType.STRING})
+
+    restored = mlio.CsvReader(rdr_prm, csv_prm)
+
+    expected = reader.read_schema()
+    actual = restored.read_schema()
+
+    assert [a.name for a in actual.attributes] == [a.name for a in expected.attributes]
+    assert actual.attributes[0].data_type == mlio.DataType.STRING
+    assert [a.data_type for a in actual.attributes[1:]] == \
+        [a.data_type for a in expected.attributes[1:]]
+
+    assert len(list(restored)) == len(list(reader))
+
+
+def test_csv_reader_schema_path_invalid_file(tmpdir):
+    path = tmpdir.join('test.schema')
+    path.write('invalid')
+
+    filename = os.path.join(resources_dir, 'test.csv')
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(filename)],
+                                    batch_size=1)
+
+    with pytest.raises(mlio.SchemaError):
+        mlio.CsvReader(rdr_prm, mlio.CsvParams(schema_path=str(path)))
+
+
+@pytest.mark.parametrize('num_type_inference_rows, expected_types',
+                         [(1, [mlio.DataType.INT64, mlio.DataType.INT64]),
+                          (10, [mlio.DataType.FLOAT64, mlio.DataType.STRING])])
+def test_csv_reader_num_type_inference_rows(tmpdir,
+                                            num_type_inference_rows,
+                                            expected_types):
+    first = tmpdir.join('test1.csv')
+    first.write('a,b\n1,2\n3,4\n')
+
+    second = tmpdir.join('test2.csv')
+    second.write('a,b\n5.5,6\n7,x\n')
+
+    dataset = [mlio.File(str(first)), mlio.File(str(second))]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=1)
+    csv_prm = mlio.CsvParams(num_type_inference_rows=num_type_inference_rows)
+
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+
+    schema = reader.read_schema()
+
+    assert [a.data_type for a in schema.attributes] == expected_types
+
+
+@pytest.mark.parametrize('has_single_header', [False, True])
+def test_csv_reader_num_prefetched_data_stores(tmpdir, has_single_header):
+    dataset = []
+    for i in range(5):
+        rows = '{0},{1}\n{2},{3}\n'.format(4 * i, 4 * i + 1, 4 * i + 2, 4 * i + 3)
+        if i == 0 or not has_single_header:
+            rows = 'a,b\n' + rows
+
+        path = tmpdir.join('test{}.csv'.format(i))
+        path.write(rows)
+        dataset.append(mlio.File(str(path)))
+
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2,
+                                    num_prefetched_data_stores=2)
+    csv_prm = mlio.CsvParams(has_single_header=has_single_header,
+                             default_data_type=mlio.DataType.INT64)
+
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+
+    for _ in range(2):
+        values = []
+        for example in reader:
+            values += as_numpy(example['a']).ravel().tolist()
+
+        assert values == list(range(0, 20, 2))
+
+        reader.reset()
+
+
+def test_csv_reader_stack_columns(tmpdir):
+    path = tmpdir.join('test.csv')
+    path.write('a,b,c\n1,2.5,3\n4,x,6\n7,8,9.5\n')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(path))],
+                                    batch_size=2)
+    csv_prm = mlio.CsvParams(use_columns={'a', 'c'},
+                             stack_columns=True)
+
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+
+    schema = reader.read_schema()
+
+    assert [a.name for a in schema.attributes] == ['values']
+    assert schema.attributes[0].data_type == mlio.DataType.FLOAT32
+    assert schema.attributes[0].shape == (2, 2)
+
+    example = reader.read_example()
+
+    assert as_numpy(example['values']).tolist() == [[1, 3], [4, 6]]
+
+    example = reader.read_example()
+
+    assert as_numpy(example['values']).tolist() == [[7, 9.5]]
+
+
+def test_csv_reader_stack_columns_non_numeric(tmpdir):
+    path = tmpdir.join('test.csv')
+    path.write('a,b\n1,x\n')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(path))],
+                                    batch_size=1)
+    csv_prm = mlio.CsvParams(stack_columns=True)
+
+    with pytest.raises(mlio.SchemaError):
+        mlio.CsvReader(rdr_prm, csv_prm)
+
+
+@pytest.mark.skipif(mlio.supports_cuda(), reason="built with CUDA support")
+def test_output_device_requires_cuda_support():
+    filename = os.path.join(resources_dir, 'test.txt')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(
+        dataset=dataset,
+        batch_size=1,
+        output_device=mlio.Device(mlio.DeviceKind.cuda, 0))
+
+    with pytest.raises(mlio.NotSupportedError):
+        mlio.TextLineReader(rdr_prm)
+
+
+def test_read_device_examples(tmpdir):
+    tmpdir.join('test.txt').write(''.join('{}\n'.format(i) for i in range(10)))
+
+    cpu = mlio.Device(mlio.DeviceKind.cpu, 0)
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(tmpdir.join('test.txt')))],
+                                    batch_size=2,
+                                    output_devices=[cpu, cpu])
+
+    reader = mlio.TextLineReader(rdr_prm)
+
+    groups = []
+    while True:
+        examples = reader.read_device_examples()
+        if not examples:
+            break
+        groups.append([as_numpy(e['value']).ravel().tolist() for e in examples])
+
+    assert groups == [[['0', '1'], ['2', '3']],
+                      [['4', '5'], ['6', '7']],
+                      [['8', '9']]]
+
+    with pytest.raises(ValueError):
+        mlio.TextLineReader(mlio.DataReaderParams(dataset=[],
+                                                  batch_size=1,
+                                                  output_device=cpu,
+                                                  output_devices=[cpu]))
+
+
+def test_as_dlpack_components():
+    np = pytest.importorskip('numpy')
+    pytest.importorskip('scipy')
+
+    from mlio.integ.dlpack import as_dlpack_components
+    from mlio.integ.scipy import to_coo_matrix
+
+    data = np.array([1.0, 2.0], dtype=np.float32)
+    rows = np.array([0, 1], dtype=np.int64)
+    cols = np.array([2, 0], dtype=np.int64)
+
+    tensor = mlio.CooTensor((2, 3), data, [rows, cols], copy=False)
+
+    assert len(as_dlpack_components(tensor)) == 3
+
+    mtx = to_coo_matrix(tensor, copy=False)
+    assert mtx.toarray().tolist() == [[0.0, 0.0, 1.0], [2.0, 0.0, 0.0]]
+
+
+def test_list_files_natural_order(tmpdir):
+    for name in ['b/x10.txt', 'b/x9.txt', 'a10/y.txt', 'a2/z.txt', 'c.csv', 'a.txt']:
+        f = tmpdir.join(name)
+        f.dirpath().ensure(dir=True)
+        f.write('1')
+
+    stores = mlio.list_files([str(tmpdir)], pattern='*.txt')
+
+    expected = ['a.txt', 'a2/z.txt', 'a10/y.txt', 'b/x9.txt', 'b/x10.txt']
+
+    assert [s.id for s in stores] == [str(tmpdir.join(n)) for n in expected]
+
+
+def test_file_manifest(tmpdir):
+    for name in ['a/1.txt', 'a/2.txt', 'b/3.csv']:
+        f = tmpdir.join('data', name)
+        f.dirpath().ensure(dir=True)
+        f.write(name)
+
+    stores = mlio.list_files([str(tmpdir.join('data'))])
+
+    manifest = str(tmpdir.join('manifest.txt'))
+
+    mlio.write_file_manifest(manifest, stores)
+
+    assert [s.id for s in mlio.read_file_manifest(manifest)] == [s.id for s in stores]
+    assert [s.size_hint for s in mlio.read_file_manifest(manifest)] == [7, 7, 7]
+
+    stores = mlio.read_file_manifest(manifest, pattern='*.csv')
+
+    assert [s.id for s in stores] == [str(tmpdir.join('data', 'b/3.csv'))]
+
+
+def test_checksum_verification(tmpdir):
+    for name in ['1.txt', '2.txt']:
+        tmpdir.join(name).write(''.join('{}{}\n'.format(name[0], j) for j in range(10000)))
+
+    stores = mlio.list_files(str(tmpdir), pattern='*.txt')
+
+    digest = hashlib.sha256(tmpdir.join('1.txt').read_binary()).hexdigest()
+
+    assert mlio.compute_checksum(stores[0], mlio.ChecksumAlgorithm.SHA256).value == digest
+
+    manifest = str(tmpdir.join('manifest.sha256'))
+
+    mlio.write_checksum_manifest(manifest, stores, mlio.ChecksumAlgorithm.SHA256)
+
+    checksums = mlio.read_checksum_manifest(manifest)
+
+    assert checksums[stores[0].id].value == digest
+
+    rdr_prm = mlio.DataReaderParams(dataset=mlio.verify_checksums(stores, checksums),
+                                    batch_size=1000)
+    reader = mlio.TextLineReader(rdr_prm)
+
+    assert sum(as_numpy(example['value']).shape[0] for example in reader) == 20000
+
+    # Change the second file after its checksum has been recorded.
+    tmpdir.join('2.txt').write('2x\n', mode='a')
+
+    reader.reset()
+
+    with pytest.raises(mlio.ChecksumError, match='2.txt'):
+        for example in reader:
+            pass
+
+    dataset = mlio.verify_checksums(stores, checksums, mlio.ChecksumMismatchHandling.WARN)
+
+    rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=1000)
+    reader = mlio.TextLineReader(rdr_prm)
+
+    assert sum(as_numpy(example['value']).shape[0] for example in reader) == 20001
+
+
+def test_skip_data_stores_by_instance_count(tmpdir):
+    names = ['1.txt', '2.txt', '3.txt']
+    for i, name in enumerate(names):
+        tmpdir.join(name).write(''.join('{}{}\n'.format(name[0], j) for j in range(i + 2)))
+
+    stores = [mlio.File(str(tmpdir.join(name)), num_instances_hint=i + 2)
+              for i, name in enumerate(names)]
+
+    manifest = str(tmpdir.join('manifest.txt'))
+
+    mlio.write_file_manifest(manifest, stores)
+
+    assert [s.num_instances_hint for s in mlio.read_file_manifest(manifest)] == [2, 3, 4]
+
+    # The skipped files are never opened.
+    tmpdir.join('1.txt').remove()
+
+    rdr_prm = mlio.DataReaderParams(dataset=mlio.read_file_manifest(manifest),
+                                    batch_size=10,
+                                    num_instances_to_skip=3)
+    reader = mlio.TextLineReader(rdr_prm)
+
+    lines = as_numpy(reader.read_example()['value']).ravel().tolist()
+
+    assert lines == ['21', '22', '30', '31', '32', '33']
+
+
+def test_zip_members(tmpdir):
+    import zipfile
+
+    archive = str(tmpdir.join('data.zip'))
+    with zipfile.ZipFile(archive, 'w') as zf:
+        zf.writestr('a.txt', 'a\nb\n', compress_type=zipfile.ZIP_DEFLATED)
+        zf.writestr('dir/', '')
+        zf.writestr('dir/b.txt', 'c\n', compress_type=zipfile.ZIP_STORED)
+
+    stores = mlio.list_zip_members(archive)
+
+    assert [s.name for s in stores] == ['a.txt', 'dir/b.txt']
+    assert [s.size_hint for s in stores] == [4, 2]
+
+    reader = mlio.TextLineReader(mlio.DataReaderParams(dataset=stores, batch_size=3))
+    lines = as_numpy(reader.read_example()['value']).ravel().tolist()
+
+    assert lines == ['a', 'b', 'c']
+
+    # Read as a single compressed file, the members are concatenated.
+    dataset = [mlio.File(archive)]
+
+    reader = mlio.TextLineReader(mlio.DataReaderParams(dataset=dataset, batch_size=3))
+    lines = as_numpy(reader.read_example()['value']).ravel().tolist()
+
+    assert lines == ['a', 'b', 'c']
+
+
+@pytest.mark.skipif(not mlio.supports_bzip2(), reason='requires bzip2 support')
+def test_bzip2_concatenated_streams(tmpdir):
+    import bz2
+
+    bz2_file = tmpdir.join('data.txt.bz2')
+    bz2_file.write_binary(bz2.compress(b'a\nb\n') + bz2.compress(b'c\n'))
+
+    dataset = [mlio.File(str(bz2_file))]
+
+    reader = mlio.TextLineReader(mlio.DataReaderParams(dataset=dataset, batch_size=3))
+    lines = as_numpy(reader.read_example()['value']).ravel().tolist()
+
+    assert lines == ['a', 'b', 'c']
+
+
+@pytest.mark.parametrize('compression', [mlio.ColumnarCompression.NONE,
+                                         mlio.ColumnarCompression.ZSTD])
+def test_columnar_writer_and_reader(tmpdir, compression):
+    if compression == mlio.ColumnarCompression.ZSTD and not mlio.supports_zstd():
+        pytest.skip('requires Zstandard support')
+
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.FLOAT32)
+
+    path = str(tmpdir.join('test.col'))
+
+    col_prm = mlio.ColumnarWriterParams(compression=compression)
+
+    mlio.write_columnar_file(path, mlio.CsvReader(rdr_prm, csv_prm), col_prm)
+
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+    expected = [[as_numpy(t).tolist() for t in example] for example in reader]
+
+    reader = mlio.ColumnarReader(mlio.DataReaderParams(dataset=[mlio.File(path)],
+                                                       batch_size=1))
+
+    # Each block holds the instances of one written example.
+    actual = [[as_numpy(t).tolist() for t in example] for example in reader]
+
+    assert actual == expected
+
+    # A larger batch size concatenates the blocks.
+    reader = mlio.ColumnarReader(mlio.DataReaderParams(dataset=[mlio.File(path)],
+                                                       batch_size=2))
+
+    example = reader.read_example()
+
+    assert as_numpy(example[0]).shape == (3, 1)
+    assert reader.read_example() is None
+
+
+def test_recordio_protobuf_writer_and_reader(tmpdir):
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.FLOAT32)
+
+    path = str(tmpdir.join('test.rec'))
+
+    mlio.write_recordio_protobuf_file(path, mlio.CsvReader(rdr_prm, csv_prm))
+
+    reader = mlio.CsvReader(mlio.DataReaderParams(dataset=dataset,
+                                                  batch_size=3), csv_prm)
+    example = reader.read_example()
+    expected = {attr.name: as_numpy(example[attr.name]).tolist()
+                for attr in example.schema.attributes}
+
+    reader = mlio.RecordIOProtobufReader(
+        mlio.DataReaderParams(dataset=[mlio.File(path)], batch_size=3))
+
+    # Each instance becomes a record; the examples of the writer are not
+    # visible to the reader.
+    example = reader.read_example()
+    actual = {attr.name: as_numpy(example[attr.name]).tolist()
+              for attr in example.schema.attributes}
+
+    assert actual == expected
+    assert reader.read_example() is None
+
+
+def test_recordio_protobuf_reader_hash_dimensions(tmpdir):
+    from mlio.integ.scipy import to_csr_matrix
+
+    svm_file = tmpdir.join("test.svm")
+    svm_file.write_binary(b'1 1:0.5 3:2\n'
+                          b'0 2:1.5\n'
+                          b'2 9:0.25\n')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(svm_file))],
+                                    batch_size=3)
+
+    path = str(tmpdir.join('test.rec'))
+
+    mlio.write_recordio_protobuf_file(path, mlio.LibsvmReader(rdr_prm))
+
+    reader = mlio.RecordIOProtobufReader(
+        mlio.DataReaderParams(dataset=[mlio.File(path)], batch_size=3),
+        hash_dimensions={'values': 4})
+
+    schema = reader.read_schema()
+    attr = schema.attributes[schema.get_index('values')]
+    assert list(attr.shape) == [3, 4]
+
+    example = reader.read_example()
+
+    tensor = example['values']
+    assert isinstance(tensor, mlio.CsrTensor)
+    assert np.array(tensor.indices, copy=False).dtype == np.int32
+    assert np.array(tensor.indptr, copy=False).dtype == np.int32
+
+    # The key of 9:0.25 is 8, which folds into the first column.
+    assert to_csr_matrix(tensor).toarray().tolist() == [[0.5, 0, 2, 0],
+                                                        [0, 1.5, 0, 0],
+                                                        [0.25, 0, 0, 0]]
+
+    with pytest.raises(ValueError):
+        mlio.RecordIOProtobufReader(rdr_prm, hash_dimensions={'values': 0})
+
+
+def test_column_statistics_collector():
+    filename = os.path.join(resources_dir, 'test.csv')
+    dataset = [mlio.File(filename)]
+
+    collector = mlio.ColumnStatisticsCollector()
+
+    rdr_prm = mlio.DataReaderParams(dataset=dataset,
+                                    batch_size=2,
+                                    column_statistics=collector)
+    csv_prm = mlio.CsvParams(header_row_index=None,
+                             default_data_type=mlio.DataType.FLOAT32)
+
+    # The statistics are computed in the decode stage of the reader.
+    for _ in mlio.CsvReader(rdr_prm, csv_prm):
+        pass
+
+    stats = collector.statistics()
+
+    assert len(stats) == 4
+    assert stats[0].num_values == 3
+    assert stats[0].num_finite == 3
+    assert stats[0].min == 0
+    assert stats[0].max == 1
+    assert stats[0].mean == pytest.approx(2 / 3)
+    assert stats[0].variance == pytest.approx(2 / 9)
+    assert stats[0].approx_distinct_count == 2
+    assert stats[0].quantile(0.0) == 0
+    assert stats[0].quantile(0.5) == 1
+    assert stats[1].quantile(1.0) == 1
+
+    collector = mlio.ColumnStatisticsCollector(
+        mlio.ColumnStatisticsParams(null_like_values=['NA'],
+                                    frequent_values_sketch_size=2))
+
+    txt_file = os.path.join(resources_dir, 'test.txt')
+
+    reader = mlio.TextLineReader(mlio.DataReaderParams(dataset=[mlio.File(txt_file)],
+                                                       batch_size=10))
+    for example in reader:
+        collector.add(example)
+
+    stats = collector.statistics()[0]
+
+    assert stats.data_type == mlio.DataType.STRING
+    assert stats.num_values == 3
+    assert stats.num_nulls == 0
+    assert stats.num_numeric == 0
+    assert stats.min_length == stats.max_length == 14
+    assert stats.num_words == 12
+    assert stats.approx_distinct_count == 3
+    assert stats.approx_distinct_word_count == 5
+
+    # With two counters the last line takes over the counter of the first.
+    assert stats.top_values(1) == [('this is line 3', 2, 1)]
+
+
+def test_column_chunks(tmpdir):
+    tmpdir.join('test.csv').write('a,b\n1,x\n2,y y\n3,NA\n')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(tmpdir.join('test.csv')))],
+                                    batch_size=2,
+                                    last_example_handling=mlio.LastExampleHandling.PAD)
+    csv_prm = mlio.CsvParams(column_types={'a': mlio.DataType.INT64,
+                                           'b': mlio.DataType.STRING},
+                             arena_strings=True)
+
+    reader = mlio.CsvReader(rdr_prm, csv_prm)
+
+    collector = mlio.ColumnStatisticsCollector(
+        mlio.ColumnStatisticsParams(null_like_values=['NA']))
+
+    num_rows = []
+    while True:
+        chunks = reader.read_column_chunks()
+        if not chunks:
+            break
+
+        assert [chunk.name for chunk in chunks] == ['a', 'b']
+        assert isinstance(chunks[1].values, mlio.StringTensor)
+
+        num_rows.append(chunks[0].num_rows)
+
+        collector.add(chunks)
+
+    # The padding row of the last batch is not part of the chunk.
+    assert num_rows == [2, 1]
+
+    a, b = collector.statistics()
+
+    assert a.num_values == 3
+    assert a.mean == pytest.approx(2)
+    assert b.num_values == 3
+    assert b.num_nulls == 1
+    assert b.num_words == 3
+
+
+def test_tracing(tmpdir):
+    txt_file = os.path.join(resources_dir, 'test.txt')
+
+    mlio.start_tracing()
+    try:
+        reader = mlio.TextLineReader(mlio.DataReaderParams(dataset=[mlio.File(txt_file)],
+                                                           batch_size=1))
+        for _ in reader:
+            pass
+    finally:
+        mlio.stop_tracing()
+
+    trace_file = str(tmpdir.join("trace.json"))
+
+    mlio.write_trace(trace_file)
+
+    with open(trace_file) as f:
+        trace = json.load(f)
+
+    names = {event['name'] for event in trace['traceEvents']}
+
+    assert {'read_chunk', 'read_instance_batch', 'decode'} <= names
+    assert all(event['ph'] == 'X' for event in trace['traceEvents'])
+
+
+def test_composite_readers(tmpdir):
+    num_files = [0]
+
+    def make_reader(name, values):
+        num_files[0] += 1
+
+        csv_file = tmpdir.join("test{}.csv".format(num_files[0]))
+        csv_file.write(name + '\n' + '\n'.join(str(v) for v in values) + '\n')
+
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(csv_file))],
+                                        batch_size=1)
+        csv_prm = mlio.CsvParams(default_data_type=mlio.DataType.INT64)
+
+        return mlio.CsvReader(rdr_prm, csv_prm)
+
+    def read_values(reader, name):
+        return [as_numpy(example[name]).item() for example in reader]
+
+    zipped = mlio.ZipReader([make_reader('a', [1, 2, 3]),
+                             make_reader('b', [4, 5])])
+
+    assert [attr.name for attr in zipped.read_schema().attributes] == ['a', 'b']
+    assert read_values(zipped, 'b') == [4, 5]
+
+    concat = mlio.ConcatReader([make_reader('a', [1, 2]), make_reader('a', [3])])
+
+    assert read_values(concat, 'a') == [1, 2, 3]
+
+    mixture_prm = mlio.MixtureParams(weights=[0.7, 0.3], seed=1)
+
+    def make_mixture():
+        return mlio.MixtureReader([make_reader('a', range(100)),
+                                   make_reader('a', range(100, 200))],
+                                  mixture_prm)
+
+    values = read_values(make_mixture(), 'a')
+
+    assert sorted(values) == list(range(200))
+    assert values == read_values(make_mixture(), 'a')
+
+    with pytest.raises(mlio.SchemaError):
+        mlio.ConcatReader([make_reader('a', [1]), make_reader('b', [2])]).read_schema()
+
+
+def test_file_object_store():
+    data = b''.join(b'%d\n' % i for i in range(10000))
+
+    def read_values(store):
+        rdr_prm = mlio.DataReaderParams(dataset=[store], batch_size=10000)
+
+        csv_prm = mlio.CsvParams(header_row_index=None)
+
+        example = mlio.CsvReader(rdr_prm, csv_prm).read_example()
+
+        return as_numpy(example[0]).ravel().tolist()
+
+    for prefetch_depth in [0, 2]:
+        store = mlio.FileObjectStore('file-object',
+                                     lambda: io.BytesIO(data),
+                                     block_size=1000,
+                                     prefetch_depth=prefetch_depth)
+
+        assert read_values(store) == list(range(10000))
+
+    with mlio.wrap_file_object(io.BytesIO(data), block_size=7) as strm:
+        buf = bytearray(20)
+
+        assert strm.read(buf) == 20
+        assert bytes(buf) == data[:20]
+
+        strm.seek(len(data) - 5)
+
+        assert strm.read(buf) == 5
+
+
+def test_slice_and_concat_examples(tmpdir):
+    from mlio.integ.scipy import to_csr_matrix
+
+    svm_file = tmpdir.join("test.svm")
+    svm_file.write_binary(b'1 1:0.5 3:2\n'
+                          b'2 2:1.5\n'
+                          b'3\n'
+                          b'4 1:1 2:3\n')
+
+    rdr_prm = mlio.DataReaderParams(
+        dataset=[mlio.File(str(svm_file))],
+        batch_size=5,
+        sparse_tensor_format=mlio.SparseTensorFormat.CSR,
+        last_example_handling=mlio.LastExampleHandling.PAD)
+
+    example = mlio.LibsvmReader(rdr_prm).read_example()
+    assert example.padding == 1
+
+    head = mlio.slice_example(example, 0, 3)
+    tail = mlio.slice_example(example, 3, 5)
+    assert head.padding == 0 and tail.padding == 1
+    assert as_numpy(tail['label']).ravel().tolist() == [4.0, 0.0]
+    assert to_csr_matrix(tail['values']).toarray()[0].tolist() == [1.0, 3.0, 0.0]
+
+    pool = mlio.TensorPool(1 << 20)
+
+    example2 = mlio.concat_examples([head, tail], pool)
+    assert example2.padding == 1
+    assert list(example2.schema.attributes[0].shape) == [5, 1]
+    assert as_numpy(example2['label']).ravel().tolist() == [1.0, 2.0, 3.0, 4.0, 0.0]
+    assert (to_csr_matrix(example2['values']).toarray() ==
+            to_csr_matrix(example['values']).toarray()).all()
+
+    with pytest.raises(ValueError):
+        mlio.concat_examples([tail, head])
+
+
+def test_convert_example(tmpdir):
+    from mlio.integ.scipy import to_coo_matrix, to_csr_matrix
+
+    svm_file = tmpdir.join("test.svm")
+    svm_file.write_binary(b'1 1:0.5 3:2\n'
+                          b'2 2:1.5\n'
+                          b'3\n'
+                          b'4 1:1 2:3\n')
+
+    rdr_prm = mlio.DataReaderParams(
+        dataset=[mlio.File(str(svm_file))],
+        batch_size=4,
+        sparse_tensor_format=mlio.SparseTensorFormat.CSR)
+
+    example = mlio.LibsvmReader(rdr_prm).read_example()
+
+    prm = mlio.ExampleConversionParams(
+        features=['values', 'label'],
+        data_types={'label': mlio.DataType.INT64},
+        default_data_type=mlio.DataType.FLOAT64,
+        column_major=True,
+        sparse_tensor_format=mlio.SparseTensorFormat.COO)
+
+    example2 = mlio.convert_example(example, prm)
+
+    assert [attr.name for attr in example2.schema.attributes] == ['values', 'label']
+    assert example2['label'].data_type == mlio.DataType.INT64
+    assert as_numpy(example2['label']).ravel().tolist() == [1, 2, 3, 4]
+    assert isinstance(example2['values'], mlio.CooTensor)
+    assert example2['values'].data_type == mlio.DataType.FLOAT64
+    assert (to_coo_matrix(example2['values']).toarray() ==
+            to_csr_matrix(example['values']).toarray()).all()
+
+    # Features that need no conversion are shared with the source example.
+    example3 = mlio.convert_example(example, mlio.ExampleConversionParams())
+    assert np.shares_memory(as_numpy(example3['label']), as_numpy(example['label']))
+
+    with pytest.raises(ValueError):
+        mlio.convert_example(example, mlio.ExampleConversionParams(features=['foo']))
+
+
+def test_deduplicate_instances(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write(''.join('line {}\n'.format(i % 100) for i in range(1000)))
+
+    for budget in [0, 1 << 16]:
+        rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(str(txt_file))],
+                                        batch_size=1000,
+                                        deduplicate_instances=True,
+                                        dedup_memory_budget=budget)
+
+        reader = mlio.TextLineReader(rdr_prm)
+
+        for _ in range(2):
+            example = reader.read_example()
+
+            assert as_numpy(example[0]).ravel().tolist() == \
+                ['line {}'.format(i) for i in range(100)]
+
+            reader.reset()
+
+
+def test_shared_read_group(tmpdir):
+    txt_file = tmpdir.join("test.txt")
+    txt_file.write(''.join('line {}\n'.format(i) for i in range(10000)))
+
+    group = mlio.SharedReadGroup(num_consumers=2, chunk_size=4096, max_buffer_size=16384)
+
+    dataset = group.share([mlio.File(str(txt_file), memory_map=False)])
+
+    assert dataset[0].id == mlio.File(str(txt_file)).id
+
+    results = [None, None]
+
+    def read_all(idx, batch_size):
+        rdr_prm = mlio.DataReaderParams(dataset=dataset, batch_size=batch_size)
+
+        reader = mlio.TextLineReader(rdr_prm)
+
+        lines = []
+        for example in reader:
+            lines.extend(as_numpy(example[0]).ravel().tolist())
+
+        results[idx] = lines
+
+    threads = [threading.Thread(target=read_all, args=(i, bs)) for i, bs in enumerate([7, 1000])]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    expected = ['line {}'.format(i) for i in range(10000)]
+
+    assert results[0] == expected
+    assert results[1] == expected
+
+
+def test_bench_reports_time_split():
+    import mlio.bench
+
+    args = mlio.bench.parse_args([os.path.join(resources_dir, 'test.csv'),
+                                  '--batch-size', '2',
+                                  '--num-batches', '1'])
+
+    report = mlio.bench.run(args)
+
+    assert report['num_batches'] == 1
+    assert report['num_instances'] >= 2
+    assert report['gil_wait_seconds'] >= 0
+    assert report['bottleneck'] in ('mlio', 'consumer')
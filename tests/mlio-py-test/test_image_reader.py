@@ -70,3 +70,35 @@ def test_image_reader_recordio():
 
     assert tensor.shape == (1, 100, 100, 3)
     assert tensor.strides == (30000, 300, 3, 1)
+
+
+def test_image_reader_tar(tmpdir):
+    import tarfile
+
+    dataset = [mlio.File(os.path.join(resources_dir, name))
+               for name in ['test_image_0.jpg', 'test_image_0.png']]
+
+    shard = str(tmpdir.join('shard.tar'))
+
+    mlio.write_tar_shard(shard, dataset)
+
+    with tarfile.open(shard) as tar:
+        assert tar.getnames() == ['test_image_0.jpg', 'test_image_0.png']
+
+    # Add a WebDataset-style label member that must be skipped.
+    label = tmpdir.join('test_image_0.cls')
+    label.write('1')
+    with tarfile.open(shard, 'a', format=tarfile.GNU_FORMAT) as tar:
+        tar.add(str(label), arcname='test_image_0.cls')
+
+    rdr_prm = mlio.DataReaderParams(dataset=[mlio.File(shard)],
+                                    batch_size=2)
+    img_prm = mlio.ImageReaderParams(image_frame=mlio.ImageFrame.TAR, resize=100, image_dimensions=[3,100,100],
+                                     to_rgb=1)
+
+    reader = mlio.ImageReader(rdr_prm, img_prm)
+    example = reader.read_example()
+    tensor = example['value']
+
+    assert tensor.shape == (2, 100, 100, 3)
+    assert reader.read_example() is None
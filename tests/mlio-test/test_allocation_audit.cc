@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <mlio.h>
+
+namespace mlio {
+
+class Test_allocation_audit : public ::testing::Test {
+protected:
+    Test_allocation_audit() = default;
+
+    ~Test_allocation_audit() override;
+};
+
+Test_allocation_audit::~Test_allocation_audit() = default;
+
+TEST_F(Test_allocation_audit, test_count_allocations)
+{
+    start_allocation_audit();
+
+    auto arr = make_cpu_array(Data_type::float32, 10);
+
+    auto block = memory_allocator().allocate(100);
+
+    stop_allocation_audit();
+
+    // Not counted since the audit is stopped.
+    auto other_arr = make_cpu_array(Data_type::float32, 10);
+
+    Allocation_audit audit = allocation_audit();
+
+    EXPECT_EQ(audit.other.num_cpu_arrays, 1);
+    EXPECT_EQ(audit.other.cpu_array_bytes, 40);
+    EXPECT_EQ(audit.other.num_memory_blocks, 1);
+    EXPECT_EQ(audit.other.memory_block_bytes, 100);
+
+    EXPECT_EQ(audit.decode.num_cpu_arrays, 0);
+    EXPECT_EQ(audit.framing.num_memory_blocks, 0);
+
+    start_allocation_audit();
+
+    EXPECT_EQ(allocation_audit().other.num_cpu_arrays, 0);
+
+    stop_allocation_audit();
+}
+
+}  // namespace mlio
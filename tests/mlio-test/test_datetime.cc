@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+#include <mlio/util/datetime.h>
+
+namespace mlio {
+
+class Test_datetime : public ::testing::Test {
+protected:
+    Test_datetime() = default;
+
+    ~Test_datetime() override;
+};
+
+Test_datetime::~Test_datetime() = default;
+
+TEST_F(Test_datetime, test_parse_timestamp)
+{
+    std::int64_t t{};
+
+    EXPECT_EQ(try_parse_timestamp("1970-01-01", t), Parse_result::ok);
+    EXPECT_EQ(t, 0);
+
+    EXPECT_EQ(try_parse_timestamp("2020-03-15T08:30:00.125Z", t), Parse_result::ok);
+    EXPECT_EQ(t, 1584261000125000000);
+
+    EXPECT_EQ(try_parse_timestamp("2020-03-15 10:30+02:00", t), Parse_result::ok);
+    EXPECT_EQ(t, 1584261000000000000);
+
+    EXPECT_EQ(try_parse_timestamp(" 2020-03-15t08:30:00,5 ", t), Parse_result::ok);
+    EXPECT_EQ(t, 1584261000500000000);
+
+    EXPECT_EQ(try_parse_timestamp("1969-12-31T23:59:59.999999999-0000", t), Parse_result::ok);
+    EXPECT_EQ(t, -1);
+
+    EXPECT_EQ(try_parse_timestamp("2000-02-29", t), Parse_result::ok);
+
+    EXPECT_EQ(try_parse_timestamp("1600-01-01", t), Parse_result::overflowed);
+
+    EXPECT_EQ(try_parse_timestamp("1900-02-29", t), Parse_result::failed);
+    EXPECT_EQ(try_parse_timestamp("2020-13-01", t), Parse_result::failed);
+    EXPECT_EQ(try_parse_timestamp("2020-03-15T24:00", t), Parse_result::failed);
+    EXPECT_EQ(try_parse_timestamp("2020-03-15X08:30", t), Parse_result::failed);
+    EXPECT_EQ(try_parse_timestamp("2020-03-15T08", t), Parse_result::failed);
+    EXPECT_EQ(try_parse_timestamp("2020/03/15", t), Parse_result::failed);
+    EXPECT_EQ(try_parse_timestamp("", t), Parse_result::failed);
+}
+
+TEST_F(Test_datetime, test_parse_date)
+{
+    std::int64_t d{};
+
+    EXPECT_EQ(try_parse_date("2020-03-15", d), Parse_result::ok);
+    EXPECT_EQ(d, 1584230400000);
+
+    EXPECT_EQ(try_parse_date("1969-12-31", d), Parse_result::ok);
+    EXPECT_EQ(d, -86400000);
+
+    EXPECT_EQ(try_parse_date("2020-03-15T00:00", d), Parse_result::failed);
+    EXPECT_EQ(try_parse_date("2020-3-15", d), Parse_result::failed);
+}
+
+TEST_F(Test_datetime, test_parse_custom_format)
+{
+    std::int64_t v{};
+
+    Datetime_format fmt{"%d/%m/%Y %H:%M:%S.%f%z"};
+
+    EXPECT_EQ(try_parse_timestamp("15/3/2020 8:30:00.125Z", v, {&fmt}), Parse_result::ok);
+    EXPECT_EQ(v, 1584261000125000000);
+
+    EXPECT_EQ(try_parse_timestamp("2020-03-15", v, {&fmt}), Parse_result::failed);
+
+    Datetime_format date_fmt{"%d %b %y"};
+
+    EXPECT_EQ(try_parse_date("15 MAR 20", v, {&date_fmt}), Parse_result::ok);
+    EXPECT_EQ(v, 1584230400000);
+
+    EXPECT_THROW(Datetime_format{"%Q"}, std::invalid_argument);
+    EXPECT_THROW(Datetime_format{"%Y%"}, std::invalid_argument);
+}
+
+}  // namespace mlio
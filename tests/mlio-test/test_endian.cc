@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+
+namespace mlio {
+
+class Test_endian : public ::testing::Test {
+protected:
+    Test_endian() = default;
+
+    ~Test_endian() override;
+};
+
+Test_endian::~Test_endian() = default;
+
+TEST_F(Test_endian, test_reverse_bytes_span)
+{
+    // Use an odd number of elements to exercise the scalar tail.
+    std::vector<std::uint32_t> values(37);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<std::uint32_t>(i * 0x0102'0304);
+    }
+
+    std::vector<std::uint32_t> reversed(values.size());
+
+    detail::reverse_bytes(as_span<const std::byte>(make_span(values)),
+                          as_span<std::byte>(make_span(reversed)),
+                          sizeof(std::uint32_t));
+
+    for (std::size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(reversed[i], detail::reverse_bytes(values[i]));
+    }
+
+    // Reverse in place.
+    detail::reverse_bytes(as_span<const std::byte>(make_span(reversed)),
+                          as_span<std::byte>(make_span(reversed)),
+                          sizeof(std::uint32_t));
+
+    EXPECT_EQ(reversed, values);
+}
+
+TEST_F(Test_endian, test_to_host_order)
+{
+    std::vector<std::uint8_t> bits{};
+    for (std::size_t i = 0; i < 19; i++) {
+        bits.insert(bits.end(), {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08});
+    }
+
+    std::vector<std::uint64_t> little(19);
+    std::vector<std::uint64_t> big(19);
+
+    little_to_host_order(as_span<const std::byte>(make_span(bits)), make_span(little));
+    big_to_host_order(as_span<const std::byte>(make_span(bits)), make_span(big));
+
+    for (std::size_t i = 0; i < little.size(); i++) {
+        EXPECT_EQ(little[i], 0x0807'0605'0403'0201);
+        EXPECT_EQ(big[i], 0x0102'0304'0506'0708);
+    }
+}
+
+}  // namespace mlio
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+
+namespace mlio {
+namespace {
+
+std::string make_data(std::size_t size)
+{
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; i++) {
+        data[i] = static_cast<char>(i * 7 % 251);
+    }
+    return data;
+}
+
+std::string write_temp_file(const std::string &name, const std::string &data)
+{
+    std::string path = ::testing::TempDir() + name;
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    return path;
+}
+
+// Reads the stream with destination buffers of varying sizes so that
+// the reads straddle the block boundaries.
+std::string read_all(Input_stream &stream)
+{
+    std::string data{};
+
+    std::vector<std::byte> buffer(0x6001);
+
+    std::size_t size = 1;
+    for (;;) {
+        std::size_t num_bytes_read = stream.read(make_span(buffer).first(size));
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        data.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+
+        size = size * 7 % buffer.size() + 1;
+    }
+
+    return data;
+}
+
+std::string read_all_async(Input_stream &stream)
+{
+    std::string data{};
+
+    std::vector<std::byte> buffer(0x2345);
+    for (;;) {
+        std::promise<std::size_t> promise{};
+
+        stream.read_async(buffer, [&promise](std::size_t num_bytes_read, std::exception_ptr ex) {
+            if (ex) {
+                promise.set_exception(std::move(ex));
+            }
+            else {
+                promise.set_value(num_bytes_read);
+            }
+        });
+
+        std::size_t num_bytes_read = promise.get_future().get();
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        data.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+    }
+
+    return data;
+}
+
+File_io_params make_io_uring_params(bool direct_io)
+{
+    File_io_params params{};
+    params.use_io_uring = true;
+    params.queue_depth = 4;
+    params.block_size = 0x4000;
+    params.direct_io = direct_io;
+
+    return params;
+}
+
+}  // namespace
+
+class Test_file_input_stream : public ::testing::Test {
+protected:
+    Test_file_input_stream() = default;
+
+    ~Test_file_input_stream() override;
+
+protected:
+    // Spans a number of blocks and ends with a tail that is not aligned
+    // to the O_DIRECT alignment.
+    std::string const data_ = make_data(0x4'0000 + 0x123);
+    std::string const path_ = write_temp_file("file_input_stream.bin", data_);
+};
+
+Test_file_input_stream::~Test_file_input_stream() = default;
+
+TEST_F(Test_file_input_stream, test_read)
+{
+    File_input_stream buffered_stream{path_, File_io_params{}};
+
+    std::string expected = read_all(buffered_stream);
+
+    ASSERT_EQ(expected, data_);
+
+    for (bool direct_io : {false, true}) {
+        File_input_stream stream{path_, make_io_uring_params(direct_io)};
+
+        // The stream falls back to regular reads if the kernel does not
+        // support io_uring.
+        if (!stream.supports_async_read()) {
+            GTEST_SKIP() << "io_uring is not supported.";
+        }
+
+        EXPECT_EQ(stream.size(), data_.size());
+
+        EXPECT_EQ(read_all(stream), expected) << "direct_io: " << direct_io;
+
+        EXPECT_EQ(stream.position(), data_.size());
+    }
+}
+
+TEST_F(Test_file_input_stream, test_read_async)
+{
+    for (bool direct_io : {false, true}) {
+        File_input_stream stream{path_, make_io_uring_params(direct_io)};
+
+        EXPECT_EQ(read_all_async(stream), data_) << "direct_io: " << direct_io;
+    }
+}
+
+TEST_F(Test_file_input_stream, test_seek)
+{
+    File_io_params params[] = {File_io_params{},
+                               make_io_uring_params(false),
+                               make_io_uring_params(true)};
+
+    // Seek to an unaligned offset, into the tail, past the end, and
+    // back to the start.
+    std::size_t positions[] = {0x5001, data_.size() - 0x10, data_.size() + 1, 0};
+
+    for (const File_io_params &prm : params) {
+        File_input_stream stream{path_, prm};
+
+        std::vector<std::byte> buffer(0x10);
+
+        stream.read(buffer);
+
+        for (std::size_t position : positions) {
+            stream.seek(position);
+
+            std::size_t expected_position = std::min(position, data_.size());
+
+            EXPECT_EQ(stream.position(), expected_position);
+
+            EXPECT_EQ(read_all(stream), data_.substr(expected_position))
+                << "use_io_uring: " << prm.use_io_uring << " direct_io: " << prm.direct_io
+                << " position: " << position;
+        }
+    }
+}
+
+TEST_F(Test_file_input_stream, test_small_files)
+{
+    // Files that are smaller than a single O_DIRECT block.
+    for (std::size_t size : {std::size_t{0}, std::size_t{1}, std::size_t{0xFFF}}) {
+        std::string data = make_data(size);
+
+        std::string path = write_temp_file("file_input_stream_small.bin", data);
+
+        for (bool direct_io : {false, true}) {
+            File_input_stream stream{path, make_io_uring_params(direct_io)};
+
+            EXPECT_EQ(read_all(stream), data) << "size: " << size << " direct_io: " << direct_io;
+        }
+    }
+}
+
+}  // namespace mlio
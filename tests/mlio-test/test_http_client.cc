@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+
+namespace mlio {
+namespace {
+
+std::string make_data(std::size_t size)
+{
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; i++) {
+        data[i] = static_cast<char>(i * 7 % 251);
+    }
+    return data;
+}
+
+std::string to_lower(std::string_view s)
+{
+    std::string lower{s};
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char chr) {
+        return static_cast<char>(std::tolower(chr));
+    });
+    return lower;
+}
+
+// Serves a single object over HTTP/1.1 on a loopback port. "/object"
+// honors the Range and If-Match headers, while "/no-range" ignores them
+// and always returns the whole object. Each connection is served by a
+// thread of its own and kept alive between requests.
+class Http_test_server {
+public:
+    explicit Http_test_server(std::string data) : data_{std::move(data)}
+    {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ == -1) {
+            throw std::system_error{errno, std::generic_category()};
+        }
+
+        ::sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+
+        auto *sock_addr = reinterpret_cast<::sockaddr *>(&addr);
+
+        ::socklen_t addr_len = sizeof(addr);
+        if (::bind(fd_, sock_addr, addr_len) == -1 || ::listen(fd_, 64) == -1 ||
+            ::getsockname(fd_, sock_addr, &addr_len) == -1) {
+            ::close(fd_);
+
+            throw std::system_error{errno, std::generic_category()};
+        }
+
+        port_ = ntohs(addr.sin_port);
+
+        accept_thread_ = std::thread{&Http_test_server::run_accept, this};
+    }
+
+    Http_test_server(const Http_test_server &) = delete;
+
+    Http_test_server &operator=(const Http_test_server &) = delete;
+
+    Http_test_server(Http_test_server &&) = delete;
+
+    Http_test_server &operator=(Http_test_server &&) = delete;
+
+    ~Http_test_server()
+    {
+        stopping_ = true;
+
+        accept_thread_.join();
+
+        for (std::thread &thread : connection_threads_) {
+            thread.join();
+        }
+
+        ::close(fd_);
+    }
+
+    std::string uri(std::string_view path) const
+    {
+        return "http://127.0.0.1:" + std::to_string(port_) + std::string{path};
+    }
+
+    // Makes the next requests fail with the specified status.
+    void fail_next_requests(std::size_t num_requests, int status = 503)
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        num_failures_ = num_requests;
+        failure_status_ = status;
+    }
+
+    std::size_t num_connections() const noexcept
+    {
+        return num_connections_;
+    }
+
+    std::size_t num_requests() const noexcept
+    {
+        return num_requests_;
+    }
+
+    std::string const etag = "\"v1\"";
+
+private:
+    bool wait_readable(int fd) const noexcept
+    {
+        ::pollfd pfd{fd, POLLIN, 0};
+        while (!stopping_) {
+            int r = ::poll(&pfd, 1, 20);
+            if (r > 0) {
+                return true;
+            }
+            if (r == -1 && errno != EINTR) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void run_accept()
+    {
+        while (wait_readable(fd_)) {
+            int conn_fd = ::accept(fd_, nullptr, nullptr);
+            if (conn_fd == -1) {
+                continue;
+            }
+
+            num_connections_++;
+
+            connection_threads_.emplace_back(&Http_test_server::run_connection, this, conn_fd);
+        }
+    }
+
+    void run_connection(int fd)
+    {
+        std::string buffer{};
+
+        while (wait_readable(fd)) {
+            char chunk[4096];
+
+            ::ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                break;
+            }
+
+            buffer.append(chunk, static_cast<std::size_t>(n));
+
+            std::size_t end;
+            while ((end = buffer.find("\r\n\r\n")) != std::string::npos) {
+                std::string request = buffer.substr(0, end + 2);
+
+                buffer.erase(0, end + 4);
+
+                std::string response = handle_request(request);
+
+                if (::send(fd, response.data(), response.size(), MSG_NOSIGNAL) == -1) {
+                    ::close(fd);
+
+                    return;
+                }
+            }
+        }
+
+        ::close(fd);
+    }
+
+    std::string handle_request(const std::string &request)
+    {
+        num_requests_++;
+
+        std::string path = request.substr(request.find(' ') + 1);
+        path = path.substr(0, path.find(' '));
+
+        std::optional<std::string> range{};
+        std::optional<std::string> if_match{};
+
+        for (std::size_t pos = request.find("\r\n"); pos + 2 < request.size();) {
+            std::size_t next = request.find("\r\n", pos + 2);
+
+            std::string line = request.substr(pos + 2, next - pos - 2);
+
+            std::size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                std::string name = to_lower(line.substr(0, colon));
+                std::string value = line.substr(line.find_first_not_of(' ', colon + 1));
+
+                if (name == "range") {
+                    range = value;
+                }
+                else if (name == "if-match") {
+                    if_match = value;
+                }
+            }
+
+            pos = next;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            if (num_failures_ > 0) {
+                num_failures_--;
+
+                return make_response(failure_status_, {}, {});
+            }
+        }
+
+        if (path == "/no-range") {
+            return make_response(200, {}, data_);
+        }
+
+        if (path != "/object") {
+            return make_response(404, {}, {});
+        }
+
+        if (if_match && *if_match != etag) {
+            return make_response(412, {}, {});
+        }
+
+        if (!range) {
+            return make_response(200, {}, data_);
+        }
+
+        // Only "bytes=<first>-<last>" is used by the client.
+        std::size_t first = std::stoul(range->substr(6));
+        std::size_t last = std::stoul(range->substr(range->find('-') + 1));
+
+        std::string total = std::to_string(data_.size());
+
+        if (first >= data_.size()) {
+            return make_response(416, "Content-Range: bytes */" + total + "\r\n", {});
+        }
+
+        last = std::min(last, data_.size() - 1);
+
+        std::string content_range = "Content-Range: bytes " + std::to_string(first) + "-" +
+                                    std::to_string(last) + "/" + total + "\r\n";
+
+        return make_response(206, content_range, data_.substr(first, last - first + 1));
+    }
+
+    std::string make_response(int status, const std::string &headers, const std::string &body)
+    {
+        return "HTTP/1.1 " + std::to_string(status) + " Status\r\n" + "ETag: " + etag + "\r\n" +
+               headers + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+
+    std::string data_;
+    int fd_;
+    std::uint16_t port_{};
+    std::atomic_bool stopping_{};
+    std::thread accept_thread_{};
+    std::vector<std::thread> connection_threads_{};
+    std::atomic_size_t num_connections_{};
+    std::atomic_size_t num_requests_{};
+    std::mutex mutex_{};
+    std::size_t num_failures_{};
+    int failure_status_{};
+};
+
+Intrusive_ptr<Http_client> make_client(std::size_t max_attempts = 3)
+{
+    Http_client_options opts{};
+    opts.use_https = false;
+    opts.max_attempts = max_attempts;
+
+    return make_http_client(opts);
+}
+
+std::string read_object(const Http_client &client,
+                        std::string_view host,
+                        std::string_view key,
+                        std::string_view etag,
+                        std::size_t offset,
+                        std::size_t size)
+{
+    std::string data(size, '\0');
+
+    auto *ptr = reinterpret_cast<std::byte *>(data.data());
+
+    std::size_t num_bytes_read =
+        client.read_object(host, key, etag, offset, Mutable_memory_span{ptr, size});
+
+    data.resize(num_bytes_read);
+
+    return data;
+}
+
+}  // namespace
+
+class Test_http_client : public ::testing::Test {
+protected:
+    Test_http_client() = default;
+
+    ~Test_http_client() override;
+
+protected:
+    std::string const data_ = make_data(0x1'0000 + 0x123);
+    Http_test_server server_{data_};
+    std::string const host_ = server_.uri("").substr(7);
+};
+
+Test_http_client::~Test_http_client() = default;
+
+TEST_F(Test_http_client, test_read_object_metadata)
+{
+    auto client = make_client();
+
+    // The size is taken from the Content-Range header of a ranged
+    // request, or from the Content-Length header if the server ignores
+    // the range.
+    for (const char *key : {"object", "no-range"}) {
+        Object_metadata metadata = client->read_object_metadata(host_, key, {});
+
+        EXPECT_EQ(metadata.size, data_.size()) << key;
+        EXPECT_EQ(metadata.etag, server_.etag) << key;
+    }
+
+    EXPECT_THROW(client->read_object_metadata(host_, "missing", {}), std::system_error);
+}
+
+TEST_F(Test_http_client, test_read_object)
+{
+    auto client = make_client();
+
+    for (const char *key : {"object", "no-range"}) {
+        for (std::size_t offset : {std::size_t{0}, std::size_t{0x1234}, data_.size() - 0x10}) {
+            std::string data = read_object(*client, host_, key, {}, offset, 0x100);
+
+            EXPECT_EQ(data, data_.substr(offset, 0x100)) << key << " at " << offset;
+        }
+    }
+
+    // A request past the end of the object returns no data.
+    EXPECT_EQ(read_object(*client, host_, "object", {}, data_.size(), 0x10), std::string{});
+}
+
+TEST_F(Test_http_client, test_connection_reuse)
+{
+    auto client = make_client();
+
+    for (std::size_t offset = 0; offset < 0x1000; offset += 0x100) {
+        read_object(*client, host_, "object", {}, offset, 0x100);
+    }
+
+    EXPECT_EQ(server_.num_requests(), 16U);
+    EXPECT_EQ(server_.num_connections(), 1U);
+}
+
+TEST_F(Test_http_client, test_etag_mismatch)
+{
+    auto client = make_client();
+
+    EXPECT_EQ(read_object(*client, host_, "object", server_.etag, 0x10, 0x10),
+              data_.substr(0x10, 0x10));
+
+    try {
+        read_object(*client, host_, "object", "\"v0\"", 0x10, 0x10);
+
+        FAIL() << "Expected the request to fail due to the ETag mismatch.";
+    }
+    catch (const std::system_error &e) {
+        EXPECT_NE(std::string{e.what()}.find("modified"), std::string::npos) << e.what();
+    }
+}
+
+TEST_F(Test_http_client, test_retry)
+{
+    auto client = make_client(3);
+
+    // Transient errors are retried up to the maximum number of attempts.
+    server_.fail_next_requests(2);
+
+    EXPECT_EQ(read_object(*client, host_, "object", {}, 0, 0x10), data_.substr(0, 0x10));
+
+    EXPECT_EQ(server_.num_requests(), 3U);
+
+    server_.fail_next_requests(3);
+
+    EXPECT_THROW(read_object(*client, host_, "object", {}, 0, 0x10), std::system_error);
+
+    // Other errors are not retried.
+    server_.fail_next_requests(1, 403);
+
+    EXPECT_THROW(read_object(*client, host_, "object", {}, 0, 0x10), std::system_error);
+
+    EXPECT_EQ(server_.num_requests(), 7U);
+}
+
+TEST_F(Test_http_client, test_object_input_stream)
+{
+    auto client = make_client();
+
+    Range_read_params params{};
+    params.range_size = 0x1000;
+
+    for (std::size_t num_parallel_ranges : {std::size_t{0}, std::size_t{4}}) {
+        params.num_parallel_ranges = num_parallel_ranges;
+
+        auto stream =
+            make_object_input_stream(client, server_.uri("/object"), server_.etag, params);
+
+        ASSERT_EQ(stream->size(), data_.size());
+
+        std::string data(data_.size(), '\0');
+
+        std::size_t num_bytes_read = 0;
+        while (num_bytes_read < data.size()) {
+            auto *ptr = reinterpret_cast<std::byte *>(data.data()) + num_bytes_read;
+
+            std::size_t n = stream->read(Mutable_memory_span{ptr, data.size() - num_bytes_read});
+            if (n == 0) {
+                break;
+            }
+
+            num_bytes_read += n;
+        }
+
+        EXPECT_EQ(num_bytes_read, data_.size());
+
+        EXPECT_EQ(data, data_);
+    }
+}
+
+}  // namespace mlio
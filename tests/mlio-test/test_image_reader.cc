@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include <mlio.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <utility>
 
@@ -410,4 +412,150 @@ TEST_F(Test_image_reader, test_bad_example_handling_skip)
     ASSERT_TRUE(true);
 }
 
+TEST_F(Test_image_reader, test_normalize_to_nchw_float32)
+{
+    size_t batch_size = 1;
+    mlio::Data_reader_params prm{png_dataset_, batch_size};
+    mlio::Image_reader_params img_prm{Image_frame::none, {}, image_dimensions_std_, true};
+    img_prm.mean = {120.0F, 110.0F, 100.0F};
+    img_prm.stddev = {60.0F, 50.0F, 40.0F};
+    img_prm.image_layout = Image_layout::nchw;
+    img_prm.data_type = Data_type::float32;
+    auto reader = mlio::make_intrusive<mlio::Image_reader>(prm, img_prm);
+
+    auto exm = reader->read_example();
+    auto lbl = static_cast<Dense_tensor *>(exm->find_feature("value").get());
+    ASSERT_EQ(lbl->data().data_type(), Data_type::float32);
+    ASSERT_EQ(lbl->shape()[1], ret_img_3channel_);
+    ASSERT_EQ(lbl->shape()[2], ret_img_height_);
+    ASSERT_EQ(lbl->shape()[3], ret_img_width_);
+
+    auto image_buffer = lbl->data().as<float>();
+
+    cv::Mat expected_image{get_expected_image(img0_path_png_)};
+    cv::cvtColor(expected_image, expected_image, cv::COLOR_BGR2RGB);
+
+    for (int c = 0; c < ret_img_3channel_; c++) {
+        for (int y = 0; y < ret_img_height_; y++) {
+            for (int x = 0; x < ret_img_width_; x++) {
+                float expected_value = (expected_image.at<cv::Vec3b>(y, x)[c] - img_prm.mean[c]) /
+                                       img_prm.stddev[c];
+                auto idx = static_cast<std::size_t>((c * ret_img_height_ + y) * ret_img_width_ + x);
+                ASSERT_NEAR(image_buffer[idx], expected_value, 1e-5);
+            }
+        }
+    }
+}
+
+TEST_F(Test_image_reader, test_random_resized_crop_is_reproducible)
+{
+    size_t batch_size = 2;
+    mlio::Data_reader_params prm{jpeg_dataset_, batch_size};
+    mlio::Image_reader_params img_prm{Image_frame::none, {}, image_dimensions_std_, false};
+    img_prm.random_resized_crop = true;
+    img_prm.random_horizontal_flip = true;
+    img_prm.augmentation_seed = 42;
+
+    auto reader_0 = mlio::make_intrusive<mlio::Image_reader>(prm, img_prm);
+    auto reader_1 = mlio::make_intrusive<mlio::Image_reader>(prm, img_prm);
+
+    auto exm_0 = reader_0->read_example();
+    auto exm_1 = reader_1->read_example();
+
+    auto lbl_0 = static_cast<Dense_tensor *>(exm_0->find_feature("value").get());
+    auto lbl_1 = static_cast<Dense_tensor *>(exm_1->find_feature("value").get());
+
+    assert_tensor_shape(lbl_0, batch_size, ret_img_3channel_);
+
+    auto bits_0 = lbl_0->data().as<std::uint8_t>();
+    auto bits_1 = lbl_1->data().as<std::uint8_t>();
+    ASSERT_TRUE(std::equal(bits_0.begin(), bits_0.end(), bits_1.begin(), bits_1.end()));
+
+    // The next epoch must use different augmentations.
+    reader_0->reset();
+
+    exm_0 = reader_0->read_example();
+    lbl_0 = static_cast<Dense_tensor *>(exm_0->find_feature("value").get());
+    bits_0 = lbl_0->data().as<std::uint8_t>();
+    ASSERT_FALSE(std::equal(bits_0.begin(), bits_0.end(), bits_1.begin(), bits_1.end()));
+}
+
+TEST_F(Test_image_reader, test_normalize_requires_float_data_type)
+{
+    mlio::Data_reader_params prm{png_dataset_, 1};
+    mlio::Image_reader_params img_prm{Image_frame::none, {}, image_dimensions_std_, false};
+    img_prm.mean = {120.0F, 110.0F, 100.0F};
+    ASSERT_THROW(mlio::make_intrusive<mlio::Image_reader>(prm, img_prm), std::invalid_argument);
+
+    img_prm.data_type = Data_type::float16;
+    img_prm.stddev = {1.0F, 0.0F, 1.0F};
+    ASSERT_THROW(mlio::make_intrusive<mlio::Image_reader>(prm, img_prm), std::invalid_argument);
+}
+
+TEST_F(Test_image_reader, test_variable_size)
+{
+    size_t batch_size = 3;
+    mlio::Data_reader_params prm{jpeg_dataset_, batch_size};
+    mlio::Image_reader_params img_prm{Image_frame::none, {}, {3}, false};
+    img_prm.variable_size = true;
+    auto reader = mlio::make_intrusive<mlio::Image_reader>(prm, img_prm);
+
+    auto exm = reader->read_example();
+    auto val = static_cast<Dense_tensor *>(exm->find_feature("value").get());
+    auto shp = static_cast<Dense_tensor *>(exm->find_feature("shape").get());
+    ASSERT_EQ(shp->shape()[0], batch_size);
+    ASSERT_EQ(shp->shape()[1], 3);
+
+    auto bits = val->data().as<std::uint8_t>();
+    auto shapes = shp->data().as<std::int64_t>();
+
+    std::size_t offset = 0;
+
+    std::size_t i = 0;
+    for (const std::string &path : {img0_path_jpg_, img1_path_jpg_, img2_path_jpg_}) {
+        cv::Mat expected_image = cv::imread(path, cv::IMREAD_COLOR);
+        ASSERT_EQ(shapes[i * 3], expected_image.rows);
+        ASSERT_EQ(shapes[i * 3 + 1], expected_image.cols);
+        ASSERT_EQ(shapes[i * 3 + 2], ret_img_3channel_);
+
+        std::size_t size = expected_image.total() * expected_image.elemSize();
+        ASSERT_TRUE(std::equal(bits.data() + offset, bits.data() + offset + size, expected_image.data));
+
+        offset += size;
+        i++;
+    }
+    ASSERT_EQ(offset, bits.size());
+}
+
+TEST_F(Test_image_reader, test_aspect_ratio_bucketing)
+{
+    size_t batch_size = 2;
+    mlio::Data_reader_params prm{jpeg_dataset_, batch_size};
+    mlio::Image_reader_params img_prm{Image_frame::none, {}, {3}, false};
+    img_prm.variable_size = true;
+    img_prm.bucketing_window = 3;
+    auto reader = mlio::make_intrusive<mlio::Image_reader>(prm, img_prm);
+
+    // The first and the third images are landscape; the second one is
+    // portrait.
+    auto exm = reader->read_example();
+    auto shp = static_cast<Dense_tensor *>(exm->find_feature("shape").get());
+    auto shapes = shp->data().as<std::int64_t>();
+    ASSERT_EQ(shapes[0], 166);
+    ASSERT_EQ(shapes[1], 190);
+    ASSERT_EQ(shapes[3], 166);
+    ASSERT_EQ(shapes[4], 190);
+
+    exm = reader->read_example();
+    shp = static_cast<Dense_tensor *>(exm->find_feature("shape").get());
+    shapes = shp->data().as<std::int64_t>();
+    ASSERT_EQ(shapes[0], 108);
+    ASSERT_EQ(shapes[1], 103);
+
+    ASSERT_EQ(reader->read_example(), nullptr);
+
+    img_prm.bucketing_window = 1;
+    ASSERT_THROW(mlio::make_intrusive<mlio::Image_reader>(prm, img_prm), std::invalid_argument);
+}
+
 }  // namespace mlio
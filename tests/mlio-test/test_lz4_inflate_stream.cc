@@ -0,0 +1,178 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <lz4frame.h>
+#include <mlio.h>
+
+namespace mlio {
+namespace {
+
+std::string make_text(std::size_t size, std::uint32_t seed)
+{
+    static const char *const words[] = {
+        "alpha", "bravo", "charlie", "delta", "echo",
+        "foxtrot", "golf", "hotel", "india", "juliet",
+    };
+
+    std::mt19937 engine{seed};
+    std::uniform_int_distribution<std::size_t> dist{0, std::size(words) - 1};
+
+    std::string text{};
+    while (text.size() < size) {
+        text += words[dist(engine)];
+        text += (text.size() % 64 < 8) ? '\n' : ' ';
+    }
+    text.resize(size);
+
+    return text;
+}
+
+// Compresses the text as a single LZ4 frame with content checksum so
+// that corrupt data is detected even if the blocks still decode.
+std::vector<std::byte> compress(const std::string &text)
+{
+    ::LZ4F_preferences_t prefs{};
+    prefs.frameInfo.contentChecksumFlag = ::LZ4F_contentChecksumEnabled;
+
+    std::vector<std::byte> output(::LZ4F_compressFrameBound(text.size(), &prefs));
+
+    std::size_t size =
+        ::LZ4F_compressFrame(output.data(), output.size(), text.data(), text.size(), &prefs);
+    if (::LZ4F_isError(size) != 0) {
+        throw std::runtime_error{"LZ4F_compressFrame() has failed."};
+    }
+    output.resize(size);
+
+    return output;
+}
+
+void append(std::vector<std::byte> &lhs, const std::vector<std::byte> &rhs)
+{
+    lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+}
+
+Intrusive_ptr<Input_stream> make_stream(const std::vector<std::byte> &compressed)
+{
+    auto block = memory_allocator().allocate(compressed.size());
+
+    std::memcpy(block->data(), compressed.data(), compressed.size());
+
+    return make_intrusive<Lz4_inflate_stream>(
+        make_intrusive<Memory_input_stream>(std::move(block)));
+}
+
+// Reads the stream with destination buffers of varying sizes so that
+// the reads straddle the frame boundaries.
+std::string read_all(Input_stream &stream)
+{
+    std::string text{};
+
+    std::vector<std::byte> buffer(0x3001);
+
+    std::size_t size = 1;
+    for (;;) {
+        std::size_t num_bytes_read = stream.read(make_span(buffer).first(size));
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        text.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+
+        size = size * 7 % buffer.size() + 1;
+    }
+
+    return text;
+}
+
+}  // namespace
+
+class Test_lz4_inflate_stream : public ::testing::Test {
+protected:
+    Test_lz4_inflate_stream() = default;
+
+    ~Test_lz4_inflate_stream() override;
+};
+
+Test_lz4_inflate_stream::~Test_lz4_inflate_stream() = default;
+
+TEST_F(Test_lz4_inflate_stream, test_single_frame)
+{
+    // Spans several of the 64 KiB blocks of the default frame.
+    std::string text = make_text(0x4'0000, 1);
+
+    auto stream = make_stream(compress(text));
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_lz4_inflate_stream, test_empty_frame)
+{
+    auto stream = make_stream(compress({}));
+
+    EXPECT_EQ(read_all(*stream), std::string{});
+}
+
+TEST_F(Test_lz4_inflate_stream, test_multi_frame)
+{
+    std::string text{};
+    std::vector<std::byte> compressed{};
+
+    for (std::uint32_t i = 0; i < 12; i++) {
+        std::string frame_text = make_text(0x2000 + i * 0x321, i);
+
+        append(compressed, compress(frame_text));
+
+        text += frame_text;
+    }
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_lz4_inflate_stream, test_truncated)
+{
+    std::vector<std::byte> compressed = compress(make_text(0x1'0000, 2));
+
+    compressed.resize(compressed.size() - 16);
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+TEST_F(Test_lz4_inflate_stream, test_truncated_multi_frame)
+{
+    std::vector<std::byte> compressed = compress(make_text(0x2000, 3));
+
+    std::vector<std::byte> frame = compress(make_text(0x2000, 4));
+
+    // Keep only the header of the second frame.
+    frame.resize(11);
+
+    append(compressed, frame);
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+TEST_F(Test_lz4_inflate_stream, test_corrupt_checksum)
+{
+    std::vector<std::byte> compressed = compress(make_text(0x1'0000, 5));
+
+    // The content checksum is the last four bytes of the frame.
+    compressed[compressed.size() - 1] ^= std::byte{0x01};
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+}  // namespace mlio
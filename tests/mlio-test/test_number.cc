@@ -0,0 +1,142 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+#include <mlio/util/number.h>
+
+namespace mlio {
+
+class Test_number : public ::testing::Test {
+protected:
+    Test_number() = default;
+
+    ~Test_number() override;
+};
+
+Test_number::~Test_number() = default;
+
+TEST_F(Test_number, test_parse_float)
+{
+    double d{};
+
+    EXPECT_EQ(try_parse_float("12.5", d), Parse_result::ok);
+    EXPECT_EQ(d, 12.5);
+
+    EXPECT_EQ(try_parse_float(" -0.125e2 ", d), Parse_result::ok);
+    EXPECT_EQ(d, -12.5);
+
+    EXPECT_EQ(try_parse_float("+.5", d), Parse_result::ok);
+    EXPECT_EQ(d, 0.5);
+
+    // Falls back to the slow path.
+    EXPECT_EQ(try_parse_float("1.7976931348623157e308", d), Parse_result::ok);
+    EXPECT_EQ(d, std::numeric_limits<double>::max());
+
+    EXPECT_EQ(try_parse_float("0.1000000000000000055511151231257827", d), Parse_result::ok);
+    EXPECT_EQ(d, 0.1);
+
+    EXPECT_EQ(try_parse_float("1e400", d), Parse_result::overflowed);
+
+    EXPECT_EQ(try_parse_float("1e", d), Parse_result::failed);
+    EXPECT_EQ(try_parse_float("1.2.3", d), Parse_result::failed);
+    EXPECT_EQ(try_parse_float("", d), Parse_result::failed);
+
+    float f{};
+
+    EXPECT_EQ(try_parse_float("3.25", f), Parse_result::ok);
+    EXPECT_EQ(f, 3.25F);
+
+    EXPECT_EQ(try_parse_float("16777217", f), Parse_result::ok);
+    EXPECT_EQ(f, 16777216.0F);
+}
+
+TEST_F(Test_number, test_parse_float_nan_values)
+{
+    std::unordered_set<std::string> nan_values{"NA", "a-long-missing-value-marker"};
+
+    double d{};
+
+    EXPECT_EQ(try_parse_float(" NA ", d, {&nan_values}), Parse_result::ok);
+    EXPECT_TRUE(std::isnan(d));
+
+    EXPECT_EQ(try_parse_float("a-long-missing-value-marker", d, {&nan_values}), Parse_result::ok);
+    EXPECT_TRUE(std::isnan(d));
+
+    EXPECT_EQ(try_parse_float("N/A", d, {&nan_values}), Parse_result::failed);
+}
+
+TEST_F(Test_number, test_nan_value_matcher)
+{
+    std::unordered_set<std::string> nan_values{
+        "", "NA", "null", "N/A", "inf", "a-long-missing-value-marker"};
+
+    Nan_value_matcher matcher{nan_values};
+
+    EXPECT_TRUE(matcher.matches(""));
+    EXPECT_TRUE(matcher.matches("NA"));
+    EXPECT_TRUE(matcher.matches("null"));
+    EXPECT_TRUE(matcher.matches("a-long-missing-value-marker"));
+
+    EXPECT_FALSE(matcher.matches("N"));
+    EXPECT_FALSE(matcher.matches("NA "));
+    EXPECT_FALSE(matcher.matches("nul"));
+    EXPECT_FALSE(matcher.matches("a-long-missing-value-markers"));
+
+    // A value that parses as a number is never treated as NaN.
+    EXPECT_FALSE(matcher.matches("inf"));
+
+    double d{};
+
+    EXPECT_EQ(try_parse_float("        NA", d, {nullptr, &matcher}), Parse_result::ok);
+    EXPECT_TRUE(std::isnan(d));
+
+    EXPECT_EQ(try_parse_float("          ", d, {nullptr, &matcher}), Parse_result::ok);
+    EXPECT_TRUE(std::isnan(d));
+
+    EXPECT_EQ(try_parse_float("         12.5 ", d, {nullptr, &matcher}), Parse_result::ok);
+    EXPECT_EQ(d, 12.5);
+
+    EXPECT_EQ(try_parse_float("inf", d, {nullptr, &matcher}), Parse_result::overflowed);
+}
+
+TEST_F(Test_number, test_parse_int)
+{
+    std::int64_t i{};
+
+    EXPECT_EQ(try_parse_int(" 1234567890123456789 ", i), Parse_result::ok);
+    EXPECT_EQ(i, 1234567890123456789);
+
+    EXPECT_EQ(try_parse_int("-9223372036854775808", i), Parse_result::ok);
+    EXPECT_EQ(i, std::numeric_limits<std::int64_t>::min());
+
+    EXPECT_EQ(try_parse_int("9223372036854775808", i), Parse_result::overflowed);
+
+    EXPECT_EQ(try_parse_int("12a", i), Parse_result::failed);
+    EXPECT_EQ(try_parse_int("-", i), Parse_result::failed);
+
+    std::uint64_t u{};
+
+    EXPECT_EQ(try_parse_int("18446744073709551615", u), Parse_result::ok);
+    EXPECT_EQ(u, std::numeric_limits<std::uint64_t>::max());
+
+    EXPECT_EQ(try_parse_int("18446744073709551616", u), Parse_result::overflowed);
+    EXPECT_EQ(try_parse_int("-1", u), Parse_result::failed);
+
+    std::int16_t s{};
+
+    EXPECT_EQ(try_parse_int("-32768", s), Parse_result::ok);
+    EXPECT_EQ(s, -32768);
+
+    EXPECT_EQ(try_parse_int("32768", s), Parse_result::overflowed);
+
+    std::int32_t h{};
+
+    EXPECT_EQ(try_parse_int("ff", h, {16}), Parse_result::ok);
+    EXPECT_EQ(h, 255);
+}
+
+}  // namespace mlio
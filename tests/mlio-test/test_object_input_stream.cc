@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+
+namespace mlio {
+namespace {
+
+std::string make_data(std::size_t size)
+{
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; i++) {
+        data[i] = static_cast<char>(i * 7 % 251);
+    }
+    return data;
+}
+
+// Serves a single object from memory and records the requests made to
+// it; the requests can be delayed, stalled, or failed by offset.
+class Fake_object_store_client final : public Object_store_client {
+public:
+    explicit Fake_object_store_client(std::string data)
+        : Object_store_client{Range_read_params{}, {}}, data_{std::move(data)}
+    {}
+
+    void list_objects(std::string_view, std::string_view, const List_callback &) const final
+    {}
+
+    std::size_t read_object(std::string_view bucket,
+                            std::string_view key,
+                            std::string_view version_id,
+                            std::size_t offset,
+                            Mutable_memory_span destination) const final
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        bucket_ = bucket;
+        key_ = key;
+        version_id_ = version_id;
+
+        std::size_t num_requests = ++num_requests_by_offset_[offset];
+
+        if (offset == fail_offset) {
+            throw std::runtime_error{"The request has failed."};
+        }
+
+        // Lets the first request for the offset hang until another one
+        // for the same offset has completed.
+        if (offset == stall_offset && num_requests == 1) {
+            condition_.wait_for(lock, std::chrono::seconds{10}, [this] {
+                return num_completed_stalls_ > 0;
+            });
+        }
+
+        auto delay = delays_by_offset.find(offset);
+        if (delay != delays_by_offset.end()) {
+            lock.unlock();
+
+            std::this_thread::sleep_for(delay->second);
+
+            lock.lock();
+        }
+
+        if (offset == stall_offset && num_requests > 1) {
+            num_completed_stalls_++;
+
+            condition_.notify_all();
+        }
+
+        if (offset >= data_.size()) {
+            return 0;
+        }
+
+        // Return short reads so that the callers have to loop.
+        std::size_t size = std::min({destination.size(), data_.size() - offset, max_read_size});
+
+        std::memcpy(destination.data(), data_.data() + offset, size);
+
+        return size;
+    }
+
+    Object_metadata read_object_metadata(std::string_view, std::string_view, std::string_view)
+        const final
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        num_metadata_requests_++;
+
+        return Object_metadata{data_.size(), "etag"};
+    }
+
+    std::string_view uri_scheme() const noexcept final
+    {
+        return "fake";
+    }
+
+    std::size_t num_requests(std::size_t offset) const
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        auto pos = num_requests_by_offset_.find(offset);
+        if (pos == num_requests_by_offset_.end()) {
+            return 0;
+        }
+        return pos->second;
+    }
+
+    std::size_t num_metadata_requests() const
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        return num_metadata_requests_;
+    }
+
+    std::string bucket() const
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        return bucket_;
+    }
+
+    std::string key() const
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        return key_;
+    }
+
+    std::string version_id() const
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        return version_id_;
+    }
+
+    std::size_t max_read_size = 0x300;
+    std::optional<std::size_t> fail_offset{};
+    std::optional<std::size_t> stall_offset{};
+    std::map<std::size_t, std::chrono::milliseconds> delays_by_offset{};
+
+private:
+    std::string data_;
+    mutable std::mutex mutex_{};
+    mutable std::condition_variable condition_{};
+    mutable std::map<std::size_t, std::size_t> num_requests_by_offset_{};
+    mutable std::size_t num_completed_stalls_{};
+    mutable std::size_t num_metadata_requests_{};
+    mutable std::string bucket_{};
+    mutable std::string key_{};
+    mutable std::string version_id_{};
+};
+
+Range_read_params make_range_read_params(std::size_t num_parallel_ranges)
+{
+    Range_read_params params{};
+    params.num_parallel_ranges = num_parallel_ranges;
+    params.range_size = 0x1000;
+
+    return params;
+}
+
+// Reads the stream with destination buffers of varying sizes so that
+// the reads straddle the range boundaries.
+std::string read_all(Input_stream &stream)
+{
+    std::string data{};
+
+    std::vector<std::byte> buffer(0x1801);
+
+    std::size_t size = 1;
+    for (;;) {
+        std::size_t num_bytes_read = stream.read(make_span(buffer).first(size));
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        data.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+
+        size = size * 7 % buffer.size() + 1;
+    }
+
+    return data;
+}
+
+}  // namespace
+
+class Test_object_input_stream : public ::testing::Test {
+protected:
+    Test_object_input_stream() = default;
+
+    ~Test_object_input_stream() override;
+
+protected:
+    // Spans a number of ranges and ends with a partial one.
+    std::string const data_ = make_data(0x1'0000 + 0x123);
+};
+
+Test_object_input_stream::~Test_object_input_stream() = default;
+
+TEST_F(Test_object_input_stream, test_read)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    auto stream = make_object_input_stream(client, "fake://bucket/dir/key", "1");
+
+    EXPECT_FALSE(stream->supports_async_read());
+
+    EXPECT_EQ(client->num_metadata_requests(), 1U);
+
+    EXPECT_EQ(stream->size(), data_.size());
+
+    EXPECT_EQ(read_all(*stream), data_);
+
+    EXPECT_EQ(client->bucket(), "bucket");
+    EXPECT_EQ(client->key(), "dir/key");
+    EXPECT_EQ(client->version_id(), "1");
+}
+
+TEST_F(Test_object_input_stream, test_known_size)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    auto stream =
+        make_object_input_stream(client, "fake://bucket/key", {}, {}, std::size_t{0x2000});
+
+    EXPECT_EQ(client->num_metadata_requests(), 0U);
+
+    EXPECT_EQ(read_all(*stream), data_.substr(0, 0x2000));
+}
+
+TEST_F(Test_object_input_stream, test_parallel_ranges_in_order)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    // Make the earlier ranges complete after the later ones.
+    for (int i = 0; i < 4; i++) {
+        std::size_t offset = static_cast<std::size_t>(i) * 0x1000;
+
+        client->delays_by_offset[offset] = std::chrono::milliseconds{(4 - i) * 20};
+    }
+
+    auto stream =
+        make_object_input_stream(client, "fake://bucket/key", {}, make_range_read_params(4));
+
+    EXPECT_TRUE(stream->supports_async_read());
+
+    EXPECT_EQ(read_all(*stream), data_);
+
+    for (std::size_t offset = 0; offset < data_.size(); offset += 0x1000) {
+        EXPECT_EQ(client->num_requests(offset), 1U) << "The range at " << offset;
+    }
+}
+
+TEST_F(Test_object_input_stream, test_parallel_ranges_async)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    auto stream =
+        make_object_input_stream(client, "fake://bucket/key", {}, make_range_read_params(3));
+
+    std::string data{};
+
+    std::vector<std::byte> buffer(0x700);
+    for (;;) {
+        std::promise<std::size_t> promise{};
+
+        stream->read_async(buffer, [&promise](std::size_t num_bytes_read, std::exception_ptr ex) {
+            if (ex) {
+                promise.set_exception(std::move(ex));
+            }
+            else {
+                promise.set_value(num_bytes_read);
+            }
+        });
+
+        std::size_t num_bytes_read = promise.get_future().get();
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        data.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+    }
+
+    EXPECT_EQ(data, data_);
+}
+
+TEST_F(Test_object_input_stream, test_parallel_ranges_seek)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    auto stream =
+        make_object_input_stream(client, "fake://bucket/key", {}, make_range_read_params(4));
+
+    std::vector<std::byte> buffer(0x10);
+
+    stream->read(buffer);
+
+    // Seek within the fetched ranges, past them, and back to the start.
+    for (std::size_t position : {std::size_t{0x1800}, std::size_t{0xA010}, std::size_t{0}}) {
+        stream->seek(position);
+
+        EXPECT_EQ(stream->position(), position);
+
+        EXPECT_EQ(read_all(*stream), data_.substr(position));
+    }
+
+    EXPECT_THROW(stream->seek(data_.size() + 1), std::system_error);
+}
+
+TEST_F(Test_object_input_stream, test_read_at)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    for (std::size_t num_parallel_ranges : {std::size_t{0}, std::size_t{4}}) {
+        auto stream = make_object_input_stream(
+            client, "fake://bucket/key", {}, make_range_read_params(num_parallel_ranges));
+
+        std::vector<std::byte> buffer(0x100);
+
+        stream->read(buffer);
+
+        // Reads at an offset do not move the position of the stream.
+        for (std::size_t offset : {std::size_t{0x3456}, std::size_t{0}, data_.size() - 0x10}) {
+            std::size_t num_bytes_read = stream->read_at(offset, buffer);
+
+            std::size_t size =
+                std::min({buffer.size(), data_.size() - offset, client->max_read_size});
+
+            ASSERT_EQ(num_bytes_read, size);
+
+            EXPECT_EQ(std::string(reinterpret_cast<const char *>(buffer.data()), num_bytes_read),
+                      data_.substr(offset, size));
+        }
+
+        EXPECT_EQ(stream->read_at(data_.size(), buffer), 0U);
+
+        EXPECT_EQ(stream->position(), 0x100U);
+
+        EXPECT_EQ(read_all(*stream), data_.substr(0x100));
+    }
+}
+
+TEST_F(Test_object_input_stream, test_hedge)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    // The first request for the range is only answered once a duplicate
+    // request has been made for it.
+    client->stall_offset = 0xC000;
+
+    // Give the ranges before it a latency to derive the hedge delay from.
+    for (std::size_t offset = 0; offset < 0xC000; offset += 0x1000) {
+        client->delays_by_offset[offset] = std::chrono::milliseconds{5};
+    }
+
+    Range_read_params params = make_range_read_params(4);
+    params.hedge_requests = true;
+    params.hedge_budget = 1.0;
+
+    auto stream = make_object_input_stream(client, "fake://bucket/key", {}, params);
+
+    auto start = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(read_all(*stream), data_);
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{5});
+
+    EXPECT_EQ(client->num_requests(0xC000), 2U);
+}
+
+TEST_F(Test_object_input_stream, test_range_error)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    client->fail_offset = 0x3000;
+
+    auto stream =
+        make_object_input_stream(client, "fake://bucket/key", {}, make_range_read_params(4));
+
+    std::vector<std::byte> buffer(0x1000);
+
+    for (std::size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(stream->read(buffer), buffer.size());
+    }
+
+    EXPECT_THROW(stream->read(buffer), std::runtime_error);
+}
+
+TEST_F(Test_object_input_stream, test_truncated_object)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    // The object is shorter than its reported size.
+    auto stream = make_object_input_stream(
+        client, "fake://bucket/key", {}, make_range_read_params(2), data_.size() + 0x10);
+
+    EXPECT_THROW(read_all(*stream), Stream_error);
+}
+
+TEST_F(Test_object_input_stream, test_invalid_uri)
+{
+    auto client = make_intrusive<Fake_object_store_client>(data_);
+
+    for (const char *uri : {"",
+                            "fake",
+                            "fake:/bucket/key",
+                            "s3://bucket/key",
+                            "fake://",
+                            "fake:///key",
+                            "fake://bucket",
+                            "fake://bucket/"}) {
+        EXPECT_THROW(make_object_input_stream(client, uri), std::invalid_argument) << uri;
+    }
+
+    EXPECT_EQ(client->num_metadata_requests(), 0U);
+}
+
+}  // namespace mlio
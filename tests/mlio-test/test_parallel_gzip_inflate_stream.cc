@@ -0,0 +1,299 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+#include <zlib.h>
+
+namespace mlio {
+namespace {
+
+// Returns compressible text whose words repeat often enough for deflate
+// to emit back-references across the flush points.
+std::string make_text(std::size_t size, std::uint32_t seed)
+{
+    static const char *const words[] = {
+        "alpha", "bravo", "charlie", "delta", "echo",
+        "foxtrot", "golf", "hotel", "india", "juliet",
+    };
+
+    std::mt19937 engine{seed};
+    std::uniform_int_distribution<std::size_t> dist{0, std::size(words) - 1};
+
+    std::string text{};
+    while (text.size() < size) {
+        text += words[dist(engine)];
+        text += (text.size() % 64 < 8) ? '\n' : ' ';
+    }
+    text.resize(size);
+
+    return text;
+}
+
+// Compresses the text as a single gzip member, calling deflate() with
+// @p flush after every @p flush_interval bytes of input.
+std::vector<std::byte> gzip(const std::string &text,
+                            int flush = Z_NO_FLUSH,
+                            std::size_t flush_interval = 0,
+                            const std::vector<std::uint8_t> &extra = {})
+{
+    ::z_stream strm{};
+    if (::deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY) !=
+        Z_OK) {
+        throw std::runtime_error{"deflateInit2() has failed."};
+    }
+
+    std::vector<std::uint8_t> extra_copy = extra;
+
+    ::gz_header header{};
+    if (!extra_copy.empty()) {
+        header.extra = extra_copy.data();
+        header.extra_len = static_cast<::uInt>(extra_copy.size());
+
+        ::deflateSetHeader(&strm, &header);
+    }
+
+    std::vector<std::byte> output(::deflateBound(&strm, text.size()) + text.size() / 16 + 64);
+
+    strm.next_out = reinterpret_cast<::Bytef *>(output.data());
+    strm.avail_out = static_cast<::uInt>(output.size());
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto *next_in = reinterpret_cast<::Bytef *>(const_cast<char *>(text.data()));
+
+    std::size_t remaining = text.size();
+    while (remaining > 0) {
+        std::size_t size = remaining;
+        if (flush_interval > 0 && flush_interval < size) {
+            size = flush_interval;
+        }
+
+        strm.next_in = next_in;
+        strm.avail_in = static_cast<::uInt>(size);
+
+        remaining -= size;
+        next_in += size;
+
+        int f = remaining == 0 ? Z_FINISH : flush;
+        if (::deflate(&strm, f) == Z_STREAM_ERROR) {
+            throw std::runtime_error{"deflate() has failed."};
+        }
+    }
+    if (text.empty()) {
+        ::deflate(&strm, Z_FINISH);
+    }
+
+    output.resize(strm.total_out);
+
+    ::deflateEnd(&strm);
+
+    return output;
+}
+
+void append(std::vector<std::byte> &lhs, const std::vector<std::byte> &rhs)
+{
+    lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+}
+
+Intrusive_ptr<Input_stream> make_stream(const std::vector<std::byte> &compressed)
+{
+    auto block = memory_allocator().allocate(compressed.size());
+
+    std::memcpy(block->data(), compressed.data(), compressed.size());
+
+    Parallel_inflate_params params{};
+    params.chunk_size = 0x1000;  // 4 KiB
+    params.max_num_tasks = 4;
+
+    return make_intrusive<Parallel_gzip_inflate_stream>(
+        make_intrusive<Memory_input_stream>(std::move(block)), params);
+}
+
+// Reads the stream with destination buffers of varying sizes so that
+// the reads straddle the boundaries of the inflated parts.
+std::string read_all(Input_stream &stream)
+{
+    std::string text{};
+
+    std::vector<std::byte> buffer(0x3001);
+
+    std::size_t size = 1;
+    for (;;) {
+        std::size_t num_bytes_read = stream.read(make_span(buffer).first(size));
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        text.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+
+        size = size * 7 % buffer.size() + 1;
+    }
+
+    return text;
+}
+
+}  // namespace
+
+class Test_parallel_gzip_inflate_stream : public ::testing::Test {
+protected:
+    Test_parallel_gzip_inflate_stream() = default;
+
+    ~Test_parallel_gzip_inflate_stream() override;
+};
+
+Test_parallel_gzip_inflate_stream::~Test_parallel_gzip_inflate_stream() = default;
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_multi_member)
+{
+    std::string text{};
+    std::vector<std::byte> compressed{};
+
+    for (std::uint32_t i = 0; i < 16; i++) {
+        std::string member_text = make_text(0x2000 + i * 0x321, i);
+
+        append(compressed, gzip(member_text));
+
+        text += member_text;
+    }
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_bgzf)
+{
+    std::string text{};
+    std::vector<std::byte> compressed{};
+
+    for (std::uint32_t i = 0; i < 32; i++) {
+        std::string block_text = make_text(0xff00, i);
+
+        // The BGZF extra field whose BSIZE holds the member size minus
+        // one; the header has no CRC, so it can be patched afterwards.
+        std::vector<std::byte> member = gzip(block_text, Z_NO_FLUSH, 0, {'B', 'C', 2, 0, 0, 0});
+
+        auto bsize = static_cast<std::uint16_t>(member.size() - 1);
+        member[16] = static_cast<std::byte>(bsize & 0xff);
+        member[17] = static_cast<std::byte>(bsize >> 8);
+
+        append(compressed, member);
+
+        text += block_text;
+    }
+
+    // The BGZF end-of-file marker is an empty member.
+    append(compressed, gzip({}, Z_NO_FLUSH, 0, {'B', 'C', 2, 0, 27, 0}));
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_full_flush)
+{
+    std::string text = make_text(0x8'0000, 1);
+
+    // Like pigz, each flushed block starts with an empty dictionary.
+    auto stream = make_stream(gzip(text, Z_FULL_FLUSH, 0x4000));
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_sync_flush)
+{
+    std::string text = make_text(0x8'0000, 2);
+
+    // The blocks reference the data before the flush points, so every
+    // speculation fails and the stream falls back to serial inflation.
+    auto stream = make_stream(gzip(text, Z_SYNC_FLUSH, 0x4000));
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_mixed)
+{
+    std::string text{};
+    std::vector<std::byte> compressed{};
+
+    for (std::uint32_t i = 0; i < 9; i++) {
+        std::string member_text = make_text(0x1'0000 + i * 0x777, 10 + i);
+
+        switch (i % 3) {
+        case 0:
+            append(compressed, gzip(member_text));
+            break;
+        case 1:
+            append(compressed, gzip(member_text, Z_FULL_FLUSH, 0x3000));
+            break;
+        default:
+            append(compressed, gzip(member_text, Z_SYNC_FLUSH, 0x3000));
+            break;
+        }
+
+        text += member_text;
+    }
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_read_slices)
+{
+    std::string text = make_text(0x4'0000, 3);
+
+    auto stream = make_stream(gzip(text, Z_FULL_FLUSH, 0x2000));
+
+    std::string output{};
+    for (;;) {
+        Memory_slice slice = stream->read(0x1234);
+        if (slice.empty()) {
+            break;
+        }
+
+        output.append(reinterpret_cast<const char *>(slice.data()), slice.size());
+    }
+
+    EXPECT_EQ(output, text);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_corrupt_member_checksum)
+{
+    std::vector<std::byte> compressed{};
+
+    for (std::uint32_t i = 0; i < 8; i++) {
+        std::vector<std::byte> member = gzip(make_text(0x2000, i));
+
+        // The CRC-32 precedes the size in the member trailer.
+        if (i == 5) {
+            member[member.size() - 8] ^= std::byte{0x01};
+        }
+
+        append(compressed, member);
+    }
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+TEST_F(Test_parallel_gzip_inflate_stream, test_corrupt_flushed_checksum)
+{
+    std::vector<std::byte> compressed = gzip(make_text(0x4'0000, 4), Z_FULL_FLUSH, 0x2000);
+
+    // The checksum of a member that is inflated in parallel parts is
+    // stitched together from the checksums of the parts.
+    compressed[compressed.size() - 8] ^= std::byte{0x80};
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+}  // namespace mlio
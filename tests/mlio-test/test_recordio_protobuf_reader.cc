@@ -1,3 +1,9 @@
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <mlio.h>
 
@@ -18,6 +24,72 @@ protected:
 
 Test_recordio_protobuf_reader::~Test_recordio_protobuf_reader() = default;
 
+namespace {
+
+// Returns the bytes of the float32 dense tensors of the example; enough
+// to tell the instances apart.
+std::string get_dense_bits(const mlio::Example &exm)
+{
+    std::string bits{};
+    for (const auto &tensor : exm.features()) {
+        auto *dense = dynamic_cast<const mlio::Dense_tensor *>(tensor.get());
+        if (dense == nullptr || dense->data_type() != mlio::Data_type::float32) {
+            continue;
+        }
+
+        auto values = dense->data().as<float>();
+
+        bits.append(reinterpret_cast<const char *>(values.data()), values.size_bytes());
+    }
+    return bits;
+}
+
+// Each record of the complete records file consists of an 8-byte header
+// followed by a 48-byte payload.
+constexpr std::size_t complete_record_size = 0x38;
+
+std::string read_file(const std::string &path)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+std::string write_temp_file(const std::string &name, const std::string &data)
+{
+    std::string path = ::testing::TempDir() + name;
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    return path;
+}
+
+std::vector<std::string>
+read_all_dense_bits(const std::string &path,
+                    Bad_example_handling handling = Bad_example_handling::skip)
+{
+    mlio::Data_reader_params prm{};
+    // Do not memory map the file so that it gets read in chunks.
+    prm.dataset.emplace_back(mlio::make_intrusive<mlio::File>(path, false));
+    prm.batch_size = 1;
+    prm.bad_example_handling = handling;
+
+    auto reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+
+    std::vector<std::string> examples{};
+
+    mlio::Intrusive_ptr<mlio::Example> exm;
+    while ((exm = reader->read_example()) != nullptr) {
+        examples.emplace_back(get_dense_bits(*exm));
+    }
+
+    return examples;
+}
+
+}  // namespace
+
 TEST_F(Test_recordio_protobuf_reader, test_complete_records_path)
 {
     mlio::Data_reader_params prm{};
@@ -53,6 +125,171 @@ TEST_F(Test_recordio_protobuf_reader, test_split_records_path)
     EXPECT_TRUE(true);
 }
 
+TEST_F(Test_recordio_protobuf_reader, test_indexed_split_records_path)
+{
+    mlio::initialize();
+
+    auto store = mlio::make_intrusive<mlio::File>(split_records_path_);
+
+    std::vector<mlio::Recordio_index_entry> entries = mlio::build_recordio_index(*store);
+
+    std::string index_path = ::testing::TempDir() + "split_records.pr.idx";
+
+    mlio::write_recordio_index(index_path, entries);
+
+    mlio::Data_reader_params prm{};
+    prm.dataset.emplace_back(store);
+    prm.batch_size = 1;
+
+    auto reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+
+    std::size_t num_examples = 0;
+    while (reader->read_example() != nullptr) {
+        num_examples++;
+    }
+
+    EXPECT_EQ(entries.size(), num_examples);
+
+    prm.recordio_indexes.emplace_back(mlio::make_intrusive<mlio::File>(index_path));
+    prm.shuffle_instances = true;
+    prm.shuffle_seed = 1;
+
+    auto indexed_reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+    for (int i = 0; i < 2; i++) {
+        std::size_t num_indexed_examples = 0;
+        while (indexed_reader->read_example() != nullptr) {
+            num_indexed_examples++;
+        }
+
+        EXPECT_EQ(num_examples, num_indexed_examples);
+
+        indexed_reader->reset();
+    }
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_indexed_sharded_split_records_path)
+{
+    mlio::initialize();
+
+    auto store = mlio::make_intrusive<mlio::File>(split_records_path_);
+
+    std::vector<mlio::Recordio_index_entry> entries = mlio::build_recordio_index(*store);
+
+    std::string index_path = ::testing::TempDir() + "split_records_sharded.pr.idx";
+
+    mlio::write_recordio_index(index_path, entries);
+
+    mlio::Data_reader_params prm{};
+    prm.dataset.emplace_back(store);
+    prm.recordio_indexes.emplace_back(mlio::make_intrusive<mlio::File>(index_path));
+    prm.batch_size = 1;
+    prm.shuffle_instances = true;
+    prm.shuffle_seed = 1;
+    prm.num_shards = 3;
+
+    std::vector<mlio::Intrusive_ptr<mlio::Recordio_protobuf_reader>> readers{};
+    for (std::size_t i = 0; i < prm.num_shards; i++) {
+        prm.shard_index = i;
+
+        readers.emplace_back(mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm));
+    }
+
+    // The shards read disjoint slices of the same permutation in every
+    // epoch.
+    for (int i = 0; i < 2; i++) {
+        std::size_t num_sharded_examples = 0;
+        for (auto &reader : readers) {
+            while (reader->read_example() != nullptr) {
+                num_sharded_examples++;
+            }
+
+            reader->reset();
+        }
+
+        EXPECT_EQ(entries.size(), num_sharded_examples);
+    }
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_indexed_read_ahead_split_records_path)
+{
+    mlio::initialize();
+
+    auto store = mlio::make_intrusive<mlio::File>(split_records_path_);
+
+    std::vector<mlio::Recordio_index_entry> entries = mlio::build_recordio_index(*store);
+
+    std::string index_path = ::testing::TempDir() + "split_records_read_ahead.pr.idx";
+
+    mlio::write_recordio_index(index_path, entries);
+
+    mlio::Data_reader_params prm{};
+    prm.dataset.emplace_back(store);
+    prm.recordio_indexes.emplace_back(mlio::make_intrusive<mlio::File>(index_path));
+    prm.batch_size = 1;
+    prm.shuffle_instances = true;
+    prm.shuffle_seed = 1;
+
+    auto read_all = [](mlio::Data_reader &reader) {
+        std::vector<std::string> examples{};
+
+        mlio::Intrusive_ptr<mlio::Example> exm;
+        while ((exm = reader.read_example()) != nullptr) {
+            examples.emplace_back(get_dense_bits(*exm));
+        }
+
+        reader.reset();
+
+        return examples;
+    };
+
+    auto reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+
+    prm.indexed_read_ahead = 3;
+    prm.num_parallel_reads = 2;
+
+    auto read_ahead_reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+
+    // The records fetched concurrently are put back into the planned
+    // order.
+    for (int i = 0; i < 2; i++) {
+        std::vector<std::string> examples = read_all(*reader);
+
+        EXPECT_EQ(entries.size(), examples.size());
+
+        EXPECT_EQ(examples, read_all(*read_ahead_reader));
+    }
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_byte_range_sharded_split_records_path)
+{
+    mlio::initialize();
+    mlio::Data_reader_params prm{};
+    prm.dataset.emplace_back(mlio::make_intrusive<mlio::File>(split_records_path_));
+    prm.batch_size = 1;
+
+    auto reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+
+    std::size_t num_examples = 0;
+    while (reader->read_example() != nullptr) {
+        num_examples++;
+    }
+
+    prm.num_shards = 3;
+    prm.sharding_strategy = mlio::Sharding_strategy::byte_range;
+
+    std::size_t num_sharded_examples = 0;
+    for (std::size_t i = 0; i < prm.num_shards; i++) {
+        prm.shard_index = i;
+
+        auto sharded_reader = mlio::make_intrusive<mlio::Recordio_protobuf_reader>(prm);
+        while (sharded_reader->read_example() != nullptr) {
+            num_sharded_examples++;
+        }
+    }
+
+    EXPECT_EQ(num_examples, num_sharded_examples);
+}
+
 TEST_F(Test_recordio_protobuf_reader, test_corrupt_split_records_patH)
 {
     mlio::initialize();
@@ -113,4 +350,102 @@ TEST_F(Test_recordio_protobuf_reader, test_corrupt_split_records_patH)
     }
 }
 
+TEST_F(Test_recordio_protobuf_reader, test_resync_garbage_between_records)
+{
+    mlio::initialize();
+
+    std::string records = read_file(complete_records_path_);
+
+    std::vector<std::string> expected = read_all_dense_bits(complete_records_path_);
+
+    ASSERT_EQ(records.size(), complete_record_size * expected.size());
+
+    // An odd number of bytes so that the following records are no longer
+    // aligned; it also contains a partial magic number.
+    std::string garbage = "\x0a\x23\xd7garbage\xce\x0a\x23";
+
+    std::string data = records.substr(0, 2 * complete_record_size) + garbage +
+                       records.substr(2 * complete_record_size);
+
+    std::string path = write_temp_file("resync_garbage.pr", data);
+
+    EXPECT_EQ(read_all_dense_bits(path), expected);
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_resync_magic_split_across_chunks)
+{
+    mlio::initialize();
+
+    std::string records = read_file(complete_records_path_);
+
+    std::vector<std::string> expected = read_all_dense_bits(complete_records_path_);
+
+    // The first chunk read from a file that is not memory mapped is
+    // 4 MiB; place the header of the second record so that its magic
+    // number straddles the chunk boundary.
+    constexpr std::size_t chunk_size = 0x40'0000;
+
+    std::string data = records.substr(0, complete_record_size);
+
+    data.resize(chunk_size - 2, '\0');
+
+    data += records.substr(complete_record_size);
+
+    std::string path = write_temp_file("resync_split_magic.pr", data);
+
+    EXPECT_EQ(read_all_dense_bits(path), expected);
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_resync_corrupt_payload_size)
+{
+    mlio::initialize();
+
+    std::string records = read_file(complete_records_path_);
+
+    std::vector<std::string> expected = read_all_dense_bits(complete_records_path_);
+
+    // Grow the payload size of the second record by four bytes; the
+    // record then ends in the middle of the header of the third record,
+    // which must still be read.
+    records[complete_record_size + 4] = '\x34';
+
+    std::string path = write_temp_file("resync_payload_size.pr", records);
+
+    expected.erase(expected.begin() + 1);
+
+    EXPECT_EQ(read_all_dense_bits(path), expected);
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_resync_short_trailing_bytes)
+{
+    mlio::initialize();
+
+    std::vector<std::string> expected = read_all_dense_bits(complete_records_path_);
+
+    // Fewer bytes than a header, starting with a partial magic number.
+    std::string data = read_file(complete_records_path_) + "\x0a\x23\xd7\xce\x01";
+
+    std::string path = write_temp_file("resync_trailing_bytes.pr", data);
+
+    EXPECT_EQ(read_all_dense_bits(path), expected);
+}
+
+TEST_F(Test_recordio_protobuf_reader, test_no_resync_in_error_mode)
+{
+    mlio::initialize();
+
+    std::string records = read_file(complete_records_path_);
+
+    std::string data = records.substr(0, complete_record_size) + "garbage" +
+                       records.substr(complete_record_size);
+
+    std::string path = write_temp_file("no_resync_garbage.pr", data);
+
+    EXPECT_THROW(read_all_dense_bits(path, Bad_example_handling::error), Data_reader_error);
+
+    path = write_temp_file("no_resync_trailing_bytes.pr", records + "\x0a\x23\xd7");
+
+    EXPECT_THROW(read_all_dense_bits(path, Bad_example_handling::error), Data_reader_error);
+}
+
 }  // namespace mlio
@@ -1,5 +1,13 @@
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <mlio.h>
+#include <zlib.h>
 
 namespace mlio {
 
@@ -91,4 +99,152 @@ TEST_F(Test_text_line_reader, test_text_line_reader_batch_less_than_features)
     EXPECT_TRUE(true);
 }
 
+namespace {
+
+// Drops the examples that hold the specified line.
+class Drop_line_transform final : public Example_transform {
+public:
+    explicit Drop_line_transform(std::string line) : line_{std::move(line)}
+    {}
+
+    Intrusive_ptr<Example> transform(Intrusive_ptr<Example> example) override
+    {
+        auto lbl = static_cast<Dense_tensor *>(example->find_feature("value").get());
+        if (lbl->data().as<std::string>()[0] == line_) {
+            return {};
+        }
+        return example;
+    }
+
+private:
+    std::string line_;
+};
+
+}  // namespace
+
+TEST_F(Test_text_line_reader, test_text_line_reader_example_transforms)
+{
+    mlio::Data_reader_params prm{};
+    prm.dataset.emplace_back(mlio::make_intrusive<mlio::File>(file_path_));
+    prm.batch_size = 1;
+    prm.example_transforms.emplace_back(make_intrusive<Drop_line_transform>(expected_line_2_));
+
+    auto reader = mlio::make_intrusive<mlio::Text_line_reader>(prm);
+
+    std::vector<std::string> lines{};
+
+    mlio::Intrusive_ptr<mlio::Example> exm;
+    while ((exm = reader->read_example()) != nullptr) {
+        auto lbl = static_cast<Dense_tensor *>(exm->find_feature("value").get());
+        lines.emplace_back(lbl->data().as<std::string>()[0]);
+    }
+
+    std::vector<std::string> expected_lines{expected_line_1_, expected_line_3_};
+
+    EXPECT_EQ(lines, expected_lines);
+    EXPECT_EQ(reader->stats().transform.num_calls, 3U);
+}
+
+namespace {
+
+// Generates lines of up to a few MiB, interleaved with short ones, so
+// that the chunk boundaries fall at varying offsets within the lines.
+std::vector<std::string> make_long_lines()
+{
+    std::mt19937 engine{1};
+
+    std::uniform_int_distribution<std::size_t> long_dist{0x4'0000, 0x20'0000};
+    std::uniform_int_distribution<std::size_t> short_dist{1, 100};
+    std::uniform_int_distribution<int> char_dist{'a', 'z'};
+
+    std::vector<std::string> lines{};
+    for (std::size_t i = 0; i < 40; i++) {
+        std::size_t size = long_dist(engine);
+
+        // A few lines exceed the initial chunk size so that the chunks,
+        // and with them the ring, have to grow.
+        if (i % 16 == 15) {
+            size = 0x60'0000 + size;
+        }
+
+        for (std::size_t j = 0; j < 2; j++) {
+            std::string line(size, '\0');
+            for (char &chr : line) {
+                chr = static_cast<char>(char_dist(engine));
+            }
+            lines.emplace_back(std::move(line));
+
+            size = short_dist(engine);
+        }
+    }
+    return lines;
+}
+
+std::vector<std::string> read_lines(const std::string &path, bool memory_map)
+{
+    mlio::Data_reader_params prm{};
+    prm.dataset.emplace_back(mlio::make_intrusive<mlio::File>(path, memory_map));
+    prm.batch_size = 1;
+
+    auto reader = mlio::make_intrusive<mlio::Text_line_reader>(prm);
+
+    std::vector<std::string> lines{};
+
+    mlio::Intrusive_ptr<mlio::Example> exm;
+    while ((exm = reader->read_example()) != nullptr) {
+        auto lbl = static_cast<Dense_tensor *>(exm->find_feature("value").get());
+        lines.emplace_back(lbl->data().as<std::string>()[0]);
+    }
+    return lines;
+}
+
+}  // namespace
+
+TEST_F(Test_text_line_reader, test_text_line_reader_long_lines)
+{
+    mlio::initialize();
+
+    std::vector<std::string> expected_lines = make_long_lines();
+
+    std::string path = ::testing::TempDir() + "long_lines.txt";
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        for (const std::string &line : expected_lines) {
+            file << line << '\n';
+        }
+    }
+
+    std::string gzip_path = path + ".gz";
+    {
+        ::gzFile file = ::gzopen(gzip_path.c_str(), "wb1");
+        ASSERT_NE(file, nullptr);
+        for (const std::string &line : expected_lines) {
+            ::gzwrite(file, line.data(), static_cast<unsigned>(line.size()));
+            ::gzputc(file, '\n');
+        }
+        ASSERT_EQ(::gzclose(file), Z_OK);
+    }
+
+    // A file that is not memory mapped is read in chunks; once the part
+    // of a line left over at the end of a chunk is large, the chunks are
+    // read into a ring buffer instead of being copied. The chunks grow
+    // with the read throughput, so the compressed file, which is read
+    // slower, crosses many more chunk boundaries. A memory mapped file is
+    // read as a single buffer.
+    std::vector<std::string> mapped_lines = read_lines(path, true);
+
+    ASSERT_EQ(mapped_lines.size(), expected_lines.size());
+
+    for (const std::string &store_path : {path, gzip_path}) {
+        std::vector<std::string> chunked_lines = read_lines(store_path, false);
+
+        ASSERT_EQ(chunked_lines.size(), expected_lines.size()) << store_path;
+
+        for (std::size_t i = 0; i < expected_lines.size(); i++) {
+            EXPECT_EQ(chunked_lines[i], mapped_lines[i]) << "The line #" << i << " differs.";
+            EXPECT_EQ(chunked_lines[i], expected_lines[i]) << "The line #" << i << " differs.";
+        }
+    }
+}
+
 }  // namespace mlio
@@ -0,0 +1,224 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mlio.h>
+#include <zstd.h>
+
+namespace mlio {
+namespace {
+
+std::string make_text(std::size_t size, std::uint32_t seed)
+{
+    static const char *const words[] = {
+        "alpha", "bravo", "charlie", "delta", "echo",
+        "foxtrot", "golf", "hotel", "india", "juliet",
+    };
+
+    std::mt19937 engine{seed};
+    std::uniform_int_distribution<std::size_t> dist{0, std::size(words) - 1};
+
+    std::string text{};
+    while (text.size() < size) {
+        text += words[dist(engine)];
+        text += (text.size() % 64 < 8) ? '\n' : ' ';
+    }
+    text.resize(size);
+
+    return text;
+}
+
+// Compresses the text as a single Zstandard frame.
+std::vector<std::byte> compress(const std::string &text)
+{
+    std::vector<std::byte> output(::ZSTD_compressBound(text.size()));
+
+    std::size_t size = ::ZSTD_compress(output.data(), output.size(), text.data(), text.size(), 3);
+    if (::ZSTD_isError(size) != 0) {
+        throw std::runtime_error{"ZSTD_compress() has failed."};
+    }
+    output.resize(size);
+
+    return output;
+}
+
+void append(std::vector<std::byte> &lhs, const std::vector<std::byte> &rhs)
+{
+    lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+}
+
+void append_le32(std::vector<std::byte> &lhs, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        lhs.push_back(static_cast<std::byte>(value >> (i * 8)));
+    }
+}
+
+// Compresses each part as a separate frame and, if requested, appends
+// a seek table as described in the Zstandard seekable format.
+std::vector<std::byte> compress_frames(const std::vector<std::string> &parts, bool seek_table)
+{
+    std::vector<std::byte> compressed{};
+    std::vector<std::byte> entries{};
+
+    for (const std::string &part : parts) {
+        std::vector<std::byte> frame = compress(part);
+
+        append(compressed, frame);
+
+        append_le32(entries, static_cast<std::uint32_t>(frame.size()));
+        append_le32(entries, static_cast<std::uint32_t>(part.size()));
+    }
+
+    if (seek_table) {
+        append_le32(compressed, 0x184D'2A5E);
+        append_le32(compressed, static_cast<std::uint32_t>(entries.size() + 9));
+
+        append(compressed, entries);
+
+        append_le32(compressed, static_cast<std::uint32_t>(parts.size()));
+        compressed.push_back(std::byte{0x00});
+        append_le32(compressed, 0x8F92'EAB1);
+    }
+
+    return compressed;
+}
+
+Intrusive_ptr<Input_stream> make_stream(const std::vector<std::byte> &compressed)
+{
+    auto block = memory_allocator().allocate(compressed.size());
+
+    std::memcpy(block->data(), compressed.data(), compressed.size());
+
+    return make_intrusive<Zstd_inflate_stream>(
+        make_intrusive<Memory_input_stream>(std::move(block)));
+}
+
+// Reads the stream with destination buffers of varying sizes so that
+// the reads straddle the frame boundaries.
+std::string read_all(Input_stream &stream)
+{
+    std::string text{};
+
+    std::vector<std::byte> buffer(0x3001);
+
+    std::size_t size = 1;
+    for (;;) {
+        std::size_t num_bytes_read = stream.read(make_span(buffer).first(size));
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        text.append(reinterpret_cast<const char *>(buffer.data()), num_bytes_read);
+
+        size = size * 7 % buffer.size() + 1;
+    }
+
+    return text;
+}
+
+}  // namespace
+
+class Test_zstd_inflate_stream : public ::testing::Test {
+protected:
+    Test_zstd_inflate_stream() = default;
+
+    ~Test_zstd_inflate_stream() override;
+};
+
+Test_zstd_inflate_stream::~Test_zstd_inflate_stream() = default;
+
+TEST_F(Test_zstd_inflate_stream, test_single_frame)
+{
+    std::string text = make_text(0x4'0000, 1);
+
+    auto stream = make_stream(compress(text));
+
+    EXPECT_FALSE(stream->seekable());
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_zstd_inflate_stream, test_empty_frame)
+{
+    auto stream = make_stream(compress({}));
+
+    EXPECT_EQ(read_all(*stream), std::string{});
+}
+
+TEST_F(Test_zstd_inflate_stream, test_multi_frame)
+{
+    std::string text{};
+    std::vector<std::string> parts{};
+
+    for (std::uint32_t i = 0; i < 12; i++) {
+        parts.emplace_back(make_text(0x2000 + i * 0x321, i));
+
+        text += parts.back();
+    }
+
+    auto stream = make_stream(compress_frames(parts, false));
+
+    EXPECT_EQ(read_all(*stream), text);
+}
+
+TEST_F(Test_zstd_inflate_stream, test_truncated)
+{
+    std::vector<std::byte> compressed = compress(make_text(0x1'0000, 2));
+
+    compressed.resize(compressed.size() - 16);
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+TEST_F(Test_zstd_inflate_stream, test_truncated_multi_frame)
+{
+    std::vector<std::byte> compressed =
+        compress_frames({make_text(0x2000, 3), make_text(0x2000, 4)}, false);
+
+    // Cut the second frame right after its header.
+    compressed.resize(compressed.size() - compress(make_text(0x2000, 4)).size() + 8);
+
+    auto stream = make_stream(compressed);
+
+    EXPECT_THROW(read_all(*stream), Inflate_error);
+}
+
+TEST_F(Test_zstd_inflate_stream, test_seek_table)
+{
+    std::string text{};
+    std::vector<std::string> parts{};
+
+    for (std::uint32_t i = 0; i < 8; i++) {
+        parts.emplace_back(make_text(0x1000 + i * 0x100, 20 + i));
+
+        text += parts.back();
+    }
+
+    auto stream = make_stream(compress_frames(parts, true));
+
+    ASSERT_TRUE(stream->seekable());
+
+    EXPECT_EQ(stream->size(), text.size());
+
+    EXPECT_EQ(read_all(*stream), text);
+
+    // Seek into the middle of a frame, and then back to a position
+    // within an earlier frame.
+    for (std::size_t position : {std::size_t{0x3456}, std::size_t{0x800}, text.size()}) {
+        stream->seek(position);
+
+        EXPECT_EQ(stream->position(), position);
+
+        EXPECT_EQ(read_all(*stream), text.substr(position));
+    }
+}
+
+}  // namespace mlio